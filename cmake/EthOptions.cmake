@@ -127,6 +127,7 @@ macro(print_config NAME)
     message("-- EasyLog          Enable easyLog               ${EASYLOG}")
     message("-- ARCH_NATIVE      Enable native code           ${ARCH_NATIVE}")
     message("-- PROF                                          ${PROF}")
+    message("-- ALLOCATOR        The allocator of malloc      ${ALLOCATOR}")
 if (BUILD_GM)
     message("-- GM               Build GM                     ${BUILD_GM}")
 endif()
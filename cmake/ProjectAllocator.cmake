@@ -0,0 +1,61 @@
+# The allocator replacing malloc: -DALLOCATOR=system (the default), jemalloc, tcmalloc or mimalloc.
+# jemalloc is built as the other dependencies, tcmalloc and mimalloc are the ones installed.
+# The imported target Allocator defines FISCO_ALLOCATOR_<NAME> for libdevcore/Allocator.cpp.
+include(ExternalProject)
+
+if (NOT ALLOCATOR)
+    set(ALLOCATOR "system")
+endif()
+
+if (ALLOCATOR STREQUAL "jemalloc")
+    ExternalProject_Add(jemalloc
+        PREFIX ${CMAKE_SOURCE_DIR}/deps
+        DOWNLOAD_NAME jemalloc-5.2.1.tar.bz2
+        DOWNLOAD_NO_PROGRESS 1
+        URL https://github.com/jemalloc/jemalloc/releases/download/5.2.1/jemalloc-5.2.1.tar.bz2
+        URL_HASH SHA256=34330e5ce276099e2e8950d9335db5a875689a4c6a56751ef3b1d8c537f887f6
+        BUILD_IN_SOURCE 1
+        LOG_CONFIGURE 1
+        LOG_BUILD 1
+        LOG_INSTALL 1
+        CONFIGURE_COMMAND ./configure --prefix=<INSTALL_DIR> --disable-shared --disable-cxx
+            CC=${CMAKE_C_COMPILER}
+        BUILD_COMMAND make build_lib_static
+        INSTALL_COMMAND make install_lib_static install_include
+        BUILD_BYPRODUCTS <INSTALL_DIR>/lib/libjemalloc.a
+    )
+
+    ExternalProject_Get_Property(jemalloc INSTALL_DIR)
+    add_library(Allocator STATIC IMPORTED)
+    set(ALLOCATOR_INCLUDE_DIR ${INSTALL_DIR}/include)
+    set(ALLOCATOR_LIBRARY ${INSTALL_DIR}/lib/libjemalloc.a)
+    file(MAKE_DIRECTORY ${ALLOCATOR_INCLUDE_DIR})  # Must exist.
+    set_property(TARGET Allocator PROPERTY IMPORTED_LOCATION ${ALLOCATOR_LIBRARY})
+    set_property(TARGET Allocator PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${ALLOCATOR_INCLUDE_DIR})
+    set_property(TARGET Allocator PROPERTY INTERFACE_LINK_LIBRARIES pthread dl)
+    set_property(TARGET Allocator PROPERTY INTERFACE_COMPILE_DEFINITIONS FISCO_ALLOCATOR_JEMALLOC)
+    add_dependencies(Allocator jemalloc)
+    unset(INSTALL_DIR)
+elseif (ALLOCATOR STREQUAL "tcmalloc")
+    find_library(ALLOCATOR_LIBRARY NAMES tcmalloc_minimal tcmalloc)
+    find_path(ALLOCATOR_INCLUDE_DIR gperftools/malloc_extension.h)
+    if (NOT ALLOCATOR_LIBRARY OR NOT ALLOCATOR_INCLUDE_DIR)
+        message(FATAL_ERROR "tcmalloc not found, please install gperftools")
+    endif()
+    add_library(Allocator UNKNOWN IMPORTED)
+    set_property(TARGET Allocator PROPERTY IMPORTED_LOCATION ${ALLOCATOR_LIBRARY})
+    set_property(TARGET Allocator PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${ALLOCATOR_INCLUDE_DIR})
+    set_property(TARGET Allocator PROPERTY INTERFACE_COMPILE_DEFINITIONS FISCO_ALLOCATOR_TCMALLOC)
+elseif (ALLOCATOR STREQUAL "mimalloc")
+    find_library(ALLOCATOR_LIBRARY NAMES mimalloc)
+    find_path(ALLOCATOR_INCLUDE_DIR mimalloc.h PATH_SUFFIXES mimalloc)
+    if (NOT ALLOCATOR_LIBRARY OR NOT ALLOCATOR_INCLUDE_DIR)
+        message(FATAL_ERROR "mimalloc not found, please install mimalloc")
+    endif()
+    add_library(Allocator UNKNOWN IMPORTED)
+    set_property(TARGET Allocator PROPERTY IMPORTED_LOCATION ${ALLOCATOR_LIBRARY})
+    set_property(TARGET Allocator PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${ALLOCATOR_INCLUDE_DIR})
+    set_property(TARGET Allocator PROPERTY INTERFACE_COMPILE_DEFINITIONS FISCO_ALLOCATOR_MIMALLOC)
+elseif (NOT ALLOCATOR STREQUAL "system")
+    message(FATAL_ERROR "Unknown ALLOCATOR ${ALLOCATOR}, please choose system, jemalloc, tcmalloc or mimalloc")
+endif()
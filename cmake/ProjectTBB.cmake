@@ -26,10 +26,12 @@ ExternalProject_Get_Property(tbb SOURCE_DIR)
 add_library(TBB STATIC IMPORTED)
 set(TBB_INCLUDE_DIR ${SOURCE_DIR}/include)
 set(TBB_LIBRARY ${CMAKE_SOURCE_DIR}/deps/lib/libtbb.${TBB_LIB_SUFFIX})
+set(TBB_MALLOC_LIBRARY ${CMAKE_SOURCE_DIR}/deps/lib/libtbbmalloc.${TBB_LIB_SUFFIX})
 file(MAKE_DIRECTORY ${TBB_INCLUDE_DIR})  # Must exist.
 file(MAKE_DIRECTORY ${CMAKE_SOURCE_DIR}/deps/lib/)  # Must exist.
 
 set_property(TARGET TBB PROPERTY IMPORTED_LOCATION ${TBB_LIBRARY})
 set_property(TARGET TBB PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${TBB_INCLUDE_DIR})
+set_property(TARGET TBB PROPERTY INTERFACE_LINK_LIBRARIES ${TBB_MALLOC_LIBRARY})
 add_dependencies(TBB tbb)
 unset(SOURCE_DIR)
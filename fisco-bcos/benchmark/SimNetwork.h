@@ -0,0 +1,319 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the nodes of a process connected through a simulated network: the messages between
+ * two nodes are delayed by the latency, queued behind each other by the bandwidth and dropped
+ * by the loss, the random draws come from one seed
+ *
+ * @file: SimNetwork.h
+ */
+
+#pragma once
+#include <libdevcore/Guards.h>
+#include <libp2p/P2PMessage.h>
+#include <libp2p/P2PMessageFactory.h>
+#include <libp2p/P2PSession.h>
+#include <libp2p/Service.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <queue>
+#include <random>
+#include <thread>
+
+namespace dev
+{
+namespace sim
+{
+struct LinkParams
+{
+    /// one way delay of a message, ms
+    unsigned latency = 0;
+    /// the delay varies uniformly by up to jitter, ms
+    unsigned jitter = 0;
+    /// megabits per second of each direction of a link, 0 for no limit
+    double bandwidth = 0;
+    /// the share of the messages dropped
+    double loss = 0;
+};
+
+class SimService;
+
+class SimNetwork : public std::enable_shared_from_this<SimNetwork>
+{
+public:
+    typedef std::shared_ptr<SimNetwork> Ptr;
+    typedef std::chrono::steady_clock Clock;
+
+    SimNetwork(LinkParams const& _params, uint64_t _seed) : m_params(_params), m_random(_seed) {}
+    ~SimNetwork() { stop(); }
+
+    void start()
+    {
+        m_running = true;
+        m_deliverThread = std::thread([this]() { deliverLoop(); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> l(x_queue);
+            m_running = false;
+        }
+        cv_queue.notify_all();
+        if (m_deliverThread.joinable())
+        {
+            m_deliverThread.join();
+        }
+    }
+
+    void addNode(NodeID const& _id, std::weak_ptr<SimService> _service)
+    {
+        WriteGuard l(x_nodes);
+        m_nodes[_id] = _service;
+    }
+
+    NodeIDs peers(NodeID const& _id) const
+    {
+        ReadGuard l(x_nodes);
+        NodeIDs peers;
+        for (auto const& node : m_nodes)
+        {
+            if (node.first != _id)
+            {
+                peers.push_back(node.first);
+            }
+        }
+        return peers;
+    }
+
+    bool hasNode(NodeID const& _id) const
+    {
+        ReadGuard l(x_nodes);
+        return m_nodes.count(_id);
+    }
+
+    /// drop the messages from and to _id for _ms
+    void isolate(NodeID const& _id, unsigned _ms)
+    {
+        std::lock_guard<std::mutex> l(x_queue);
+        m_isolated[_id] = Clock::now() + std::chrono::milliseconds(_ms);
+    }
+
+    void send(NodeID const& _from, NodeID const& _to, std::shared_ptr<dev::p2p::P2PMessage> _msg);
+
+    uint64_t messages() const { return m_messages; }
+    uint64_t bytes() const { return m_bytes; }
+    uint64_t dropped() const { return m_dropped; }
+
+private:
+    struct Delivery
+    {
+        Clock::time_point time;
+        uint64_t sequence;
+        NodeID from;
+        NodeID to;
+        std::shared_ptr<dev::p2p::P2PMessage> message;
+        bool operator>(Delivery const& _other) const
+        {
+            return time != _other.time ? time > _other.time : sequence > _other.sequence;
+        }
+    };
+
+    bool isolated(NodeID const& _id, Clock::time_point const& _now) const
+    {
+        auto it = m_isolated.find(_id);
+        return it != m_isolated.end() && it->second > _now;
+    }
+
+    void deliverLoop();
+
+    LinkParams m_params;
+    std::mt19937_64 m_random;
+
+    mutable SharedMutex x_nodes;
+    std::map<NodeID, std::weak_ptr<SimService>> m_nodes;
+
+    std::mutex x_queue;
+    std::condition_variable cv_queue;
+    std::priority_queue<Delivery, std::vector<Delivery>, std::greater<Delivery>> m_queue;
+    uint64_t m_sequence = 0;
+    /// the time each direction of a link is busy sending until, and its last delivery so that
+    /// the messages of a link are delivered in order
+    std::map<std::pair<NodeID, NodeID>, Clock::time_point> m_busyUntil;
+    std::map<std::pair<NodeID, NodeID>, Clock::time_point> m_lastDelivery;
+    std::map<NodeID, Clock::time_point> m_isolated;
+    bool m_running = false;
+    std::thread m_deliverThread;
+
+    std::atomic<uint64_t> m_messages = {0};
+    std::atomic<uint64_t> m_bytes = {0};
+    std::atomic<uint64_t> m_dropped = {0};
+};
+
+/// the P2P service of a node, every other node of the network is a connected session
+class SimService : public dev::p2p::Service
+{
+public:
+    SimService(SimNetwork::Ptr _network, NodeID const& _id) : m_network(_network), m_id(_id)
+    {
+        setP2PMessageFactory(std::make_shared<dev::p2p::P2PMessageFactory>());
+    }
+
+    NodeID id() const override { return m_id; }
+
+    void asyncSendMessageByNodeID(NodeID nodeID, std::shared_ptr<dev::p2p::P2PMessage> message,
+        CallbackFuncWithSession, dev::network::Options) override
+    {
+        m_network->send(m_id, nodeID, message);
+    }
+
+    void asyncMulticastMessageByNodeIDList(
+        NodeIDs nodeIDs, std::shared_ptr<dev::p2p::P2PMessage> message) override
+    {
+        for (auto const& nodeID : nodeIDs)
+        {
+            m_network->send(m_id, nodeID, message);
+        }
+    }
+
+    void asyncBroadcastMessage(
+        std::shared_ptr<dev::p2p::P2PMessage> message, dev::network::Options) override
+    {
+        asyncMulticastMessageByNodeIDList(m_network->peers(m_id), message);
+    }
+
+    void registerHandlerByProtoclID(
+        PROTOCOL_ID protocolID, CallbackFuncWithSession handler) override
+    {
+        WriteGuard l(x_handlers);
+        m_handlers[protocolID] = handler;
+    }
+
+    dev::p2p::P2PSessionInfos sessionInfos() override { return sessionInfosByProtocolID(0); }
+
+    dev::p2p::P2PSessionInfos sessionInfosByProtocolID(PROTOCOL_ID) const override
+    {
+        dev::p2p::P2PSessionInfos sessions;
+        for (auto const& peer : m_network->peers(m_id))
+        {
+            sessions.emplace_back(dev::network::NodeInfo{peer, "", ""},
+                dev::network::NodeIPEndpoint(), std::set<std::string>());
+        }
+        return sessions;
+    }
+
+    bool isConnected(NodeID const& nodeID) const override
+    {
+        return nodeID != m_id && m_network->hasNode(nodeID);
+    }
+
+    size_t writeQueueBytes(NodeID const&) const override { return 0; }
+
+    void deliver(NodeID const& _from, std::shared_ptr<dev::p2p::P2PMessage> _message)
+    {
+        CallbackFuncWithSession handler;
+        {
+            ReadGuard l(x_handlers);
+            auto it = m_handlers.find(_message->protocolID());
+            if (it == m_handlers.end())
+            {
+                return;
+            }
+            handler = it->second;
+        }
+        auto session = std::make_shared<dev::p2p::P2PSession>();
+        session->setNodeInfo(dev::network::NodeInfo{_from, "", ""});
+        handler(dev::network::NetworkException(), session, _message);
+    }
+
+private:
+    SimNetwork::Ptr m_network;
+    NodeID m_id;
+    mutable SharedMutex x_handlers;
+    std::map<PROTOCOL_ID, CallbackFuncWithSession> m_handlers;
+};
+
+inline void SimNetwork::send(
+    NodeID const& _from, NodeID const& _to, std::shared_ptr<dev::p2p::P2PMessage> _msg)
+{
+    auto size = _msg->buffer()->size();
+    std::lock_guard<std::mutex> l(x_queue);
+    auto now = Clock::now();
+    if (!m_running || isolated(_from, now) || isolated(_to, now) ||
+        std::uniform_real_distribution<double>(0, 1)(m_random) < m_params.loss)
+    {
+        ++m_dropped;
+        return;
+    }
+    ++m_messages;
+    m_bytes += size;
+
+    auto link = std::make_pair(_from, _to);
+    auto sent = std::max(now, m_busyUntil[link]);
+    if (m_params.bandwidth > 0)
+    {
+        sent += std::chrono::microseconds((uint64_t)(size * 8 / m_params.bandwidth));
+    }
+    m_busyUntil[link] = sent;
+    auto delay = m_params.latency * 1000;
+    if (m_params.jitter > 0)
+    {
+        delay += m_random() % (m_params.jitter * 1000);
+    }
+    auto time = std::max(sent + std::chrono::microseconds(delay), m_lastDelivery[link]);
+    m_lastDelivery[link] = time;
+    m_queue.push(Delivery{time, m_sequence++, _from, _to, _msg});
+    cv_queue.notify_one();
+}
+
+inline void SimNetwork::deliverLoop()
+{
+    std::unique_lock<std::mutex> l(x_queue);
+    while (m_running)
+    {
+        if (m_queue.empty())
+        {
+            cv_queue.wait(l);
+            continue;
+        }
+        auto time = m_queue.top().time;
+        if (Clock::now() < time)
+        {
+            cv_queue.wait_until(l, time);
+            continue;
+        }
+        auto delivery = m_queue.top();
+        m_queue.pop();
+        l.unlock();
+        std::shared_ptr<SimService> service;
+        {
+            ReadGuard nodes(x_nodes);
+            auto it = m_nodes.find(delivery.to);
+            if (it != m_nodes.end())
+            {
+                service = it->second.lock();
+            }
+        }
+        if (service)
+        {
+            service->deliver(delivery.from, delivery.message);
+        }
+        l.lock();
+    }
+}
+}  // namespace sim
+}  // namespace dev
@@ -0,0 +1,218 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the ops per second of the abi encoding and decoding of the params of the precompiled
+ * calls, decoded into strings or into views of the data, printed as JSON
+ *
+ * @file: abi_benchmark.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/easylog.h>
+#include <libethcore/ABI.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+/// the ops between two checks of the clock
+const size_t c_checkEvery = 64;
+
+struct Options
+{
+    vector<string> cases;
+    size_t batch;
+    size_t length;
+    double seconds;
+    string output;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// the ops of _op done in _seconds
+Json::Value runCase(function<void()> const& _op, size_t _bytes, double _seconds)
+{
+    uint64_t ops = 0;
+    auto start = nowUs();
+    auto end = start + (uint64_t)(_seconds * 1e6);
+    while (nowUs() < end)
+    {
+        for (size_t i = 0; i < c_checkEvery; ++i)
+        {
+            _op();
+        }
+        ops += c_checkEvery;
+    }
+    auto elapsed = (nowUs() - start) / 1e6;
+
+    Json::Value result;
+    result["bytes"] = (Json::UInt64)_bytes;
+    result["ops"] = (Json::UInt64)ops;
+    result["opsPerSecond"] = ops / elapsed;
+    result["MBPerSecond"] = ops * _bytes / 1e6 / elapsed;
+    return result;
+}
+
+/// the encoding and the decodings of the params of one call
+Json::Value runCall(string const& _name, Options const& _options)
+{
+    string user(_options.length, 'u');
+    string value(_options.length, 'v');
+    u256 amount = 123456789;
+    vector<string> users(_options.batch, user);
+    vector<u256> amounts(_options.batch, amount);
+
+    ContractABI abi;
+    function<bytes()> encode;
+    function<void(bytesConstRef)> decode;
+    function<void(bytesConstRef)> decodeViews;
+    if (_name == "transfer")
+    {  // userTransfer(string,string,uint256)
+        encode = [&]() { return abi.abiIn("", user, user, amount); };
+        decode = [&](bytesConstRef _data) {
+            string from, to;
+            u256 out;
+            abi.abiOut(_data, from, to, out);
+        };
+        decodeViews = [&](bytesConstRef _data) {
+            bytesConstRef from, to;
+            u256 out;
+            abi.abiOut(_data, from, to, out);
+        };
+    }
+    else if (_name == "crud")
+    {  // insert(string,string,string,string)
+        encode = [&]() { return abi.abiIn("", user, user, value, value); };
+        decode = [&](bytesConstRef _data) {
+            string table, key, entry, optional;
+            abi.abiOut(_data, table, key, entry, optional);
+        };
+        decodeViews = [&](bytesConstRef _data) {
+            bytesConstRef table, key, entry, optional;
+            abi.abiOut(_data, table, key, entry, optional);
+        };
+    }
+    else
+    {  // userBatchTransfer(string[],string[],uint256[])
+        encode = [&]() { return abi.abiIn("", users, users, amounts); };
+        decode = [&](bytesConstRef _data) {
+            vector<string> from, to;
+            vector<u256> out;
+            abi.abiOut(_data, from, to, out);
+        };
+        decodeViews = [&](bytesConstRef _data) {
+            vector<bytesConstRef> from, to;
+            vector<u256> out;
+            abi.abiOut(_data, from, to, out);
+        };
+    }
+
+    auto data = encode();
+    Json::Value result;
+    result["encode"] = runCase([&]() { encode(); }, data.size(), _options.seconds);
+    result["decode"] =
+        runCase([&]() { decode(bytesConstRef(&data)); }, data.size(), _options.seconds);
+    result["decodeViews"] =
+        runCase([&]() { decodeViews(bytesConstRef(&data)); }, data.size(), _options.seconds);
+    return result;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the ops per second of the abi codec of this build");
+    description.add_options()("cases",
+        boost::program_options::value<string>()->default_value("transfer,crud,batch"),
+        "the calls whose params are encoded and decoded, comma separated")("batch,b",
+        boost::program_options::value<size_t>()->default_value(100),
+        "the transfers of a batch")("length,l",
+        boost::program_options::value<size_t>()->default_value(16),
+        "bytes of the strings")("seconds",
+        boost::program_options::value<double>()->default_value(1), "seconds of each case")(
+        "output,o", boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        boost::split(options.cases, vm["cases"].as<string>(), boost::is_any_of(","));
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.batch = vm["batch"].as<size_t>();
+    options.length = vm["length"].as<size_t>();
+    options.seconds = vm["seconds"].as<double>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["batch"] = (Json::UInt64)options.batch;
+    report["length"] = (Json::UInt64)options.length;
+    report["results"] = Json::Value(Json::objectValue);
+    for (auto const& name : options.cases)
+    {
+        if (name != "transfer" && name != "crud" && name != "batch")
+        {
+            cout << "unknown case " << name << endl;
+            return 1;
+        }
+        report["results"][name] = runCall(name, options);
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
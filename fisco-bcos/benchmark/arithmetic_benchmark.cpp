@@ -0,0 +1,229 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file arithmetic_benchmark.cpp
+ * @author: ancelmo
+ * @date 2019-09-17
+ *
+ * microbenchmark of the u256 arithmetic of the interpreter against 4x64 limbs
+ */
+#include <libdevcore/Common.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+// fixed width 256 bits integer, least significant limb first
+struct Limbs
+{
+    uint64_t w[4];
+};
+
+inline Limbs fromU256(u256 const& _v)
+{
+    Limbs r;
+    auto const& backend = _v.backend();
+    for (unsigned i = 0; i < 4; ++i)
+        r.w[i] = i < backend.size() ? backend.limbs()[i] : 0;
+    return r;
+}
+
+inline u256 toU256(Limbs const& _v)
+{
+    u256 r;
+    auto& backend = r.backend();
+    backend.resize(4, 4);
+    for (unsigned i = 0; i < 4; ++i)
+        backend.limbs()[i] = _v.w[i];
+    backend.normalize();
+    return r;
+}
+
+inline Limbs add(Limbs const& _a, Limbs const& _b)
+{
+    Limbs r;
+    unsigned __int128 carry = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        carry += (unsigned __int128)_a.w[i] + _b.w[i];
+        r.w[i] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    return r;
+}
+
+inline Limbs sub(Limbs const& _a, Limbs const& _b)
+{
+    Limbs r;
+    uint64_t borrow = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        unsigned __int128 d = (unsigned __int128)_a.w[i] - _b.w[i] - borrow;
+        r.w[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    return r;
+}
+
+inline Limbs mul(Limbs const& _a, Limbs const& _b)
+{
+    Limbs r{{0, 0, 0, 0}};
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        uint64_t carry = 0;
+        for (unsigned j = 0; i + j < 4; ++j)
+        {
+            unsigned __int128 t = (unsigned __int128)_a.w[i] * _b.w[j] + r.w[i + j] + carry;
+            r.w[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+    }
+    return r;
+}
+
+inline bool lt(Limbs const& _a, Limbs const& _b)
+{
+    for (int i = 3; i >= 0; --i)
+    {
+        if (_a.w[i] != _b.w[i])
+            return _a.w[i] < _b.w[i];
+    }
+    return false;
+}
+
+inline bool eq(Limbs const& _a, Limbs const& _b)
+{
+    return ((_a.w[0] ^ _b.w[0]) | (_a.w[1] ^ _b.w[1]) | (_a.w[2] ^ _b.w[2]) |
+               (_a.w[3] ^ _b.w[3])) == 0;
+}
+
+// operands of the sizes contracts mostly compute with: small counters, 64 bits values, hashes
+u256 randomOperand(mt19937_64& _gen, size_t _i)
+{
+    switch (_i % 3)
+    {
+    case 0:
+        return u256(_gen() % 1000);
+    case 1:
+        return u256(_gen());
+    default:
+        return (u256(_gen()) << 192) | (u256(_gen()) << 128) | (u256(_gen()) << 64) | _gen();
+    }
+}
+
+void run(string const& _name, size_t _ops, function<void()> const& _f)
+{
+    auto start = chrono::steady_clock::now();
+    _f();
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    cout << _name << ": " << (double)ns.count() / _ops << " ns/op" << endl;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    size_t count = 4096;
+    size_t round = argc > 1 ? stoul(argv[1]) : 1000;
+
+    mt19937_64 gen(0);
+    vector<u256> a(count);
+    vector<u256> b(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        a[i] = randomOperand(gen, i);
+        b[i] = randomOperand(gen, i / 3);
+    }
+    vector<Limbs> la(count);
+    vector<Limbs> lb(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        la[i] = fromU256(a[i]);
+        lb[i] = fromU256(b[i]);
+    }
+
+    size_t ops = count * round;
+    vector<u256> r(count);
+    vector<Limbs> lr(count);
+    size_t truth = 0;
+
+    typedef function<u256(u256 const&, u256 const&)> U256Op;
+    typedef function<Limbs(Limbs const&, Limbs const&)> LimbsOp;
+    auto compare = [&](string const& _name, U256Op const& _u256Op, LimbsOp const& _limbsOp) {
+        run(_name + " u256", ops, [&]() {
+            for (size_t n = 0; n < round; ++n)
+                for (size_t i = 0; i < count; ++i)
+                    r[i] = _u256Op(a[i], b[i]);
+        });
+        run(_name + " limbs", ops, [&]() {
+            for (size_t n = 0; n < round; ++n)
+                for (size_t i = 0; i < count; ++i)
+                    lr[i] = _limbsOp(la[i], lb[i]);
+        });
+        // the interpreter stack stays u256, so every operation converts on both sides
+        run(_name + " limbs converted", ops, [&]() {
+            for (size_t n = 0; n < round; ++n)
+                for (size_t i = 0; i < count; ++i)
+                    r[i] = toU256(_limbsOp(fromU256(a[i]), fromU256(b[i])));
+        });
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (toU256(lr[i]) != _u256Op(a[i], b[i]))
+            {
+                cout << _name << " mismatch at " << i << endl;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    bool ok = true;
+    ok &= compare(
+        "ADD", [](u256 const& _a, u256 const& _b) { return _a + _b; }, add);
+    ok &= compare(
+        "SUB", [](u256 const& _a, u256 const& _b) { return _a - _b; }, sub);
+    ok &= compare(
+        "MUL", [](u256 const& _a, u256 const& _b) { return _a * _b; }, mul);
+
+    run("LT u256", ops, [&]() {
+        for (size_t n = 0; n < round; ++n)
+            for (size_t i = 0; i < count; ++i)
+                truth += a[i] < b[i];
+    });
+    run("LT limbs", ops, [&]() {
+        for (size_t n = 0; n < round; ++n)
+            for (size_t i = 0; i < count; ++i)
+                truth += lt(la[i], lb[i]);
+    });
+    run("EQ u256", ops, [&]() {
+        for (size_t n = 0; n < round; ++n)
+            for (size_t i = 0; i < count; ++i)
+                truth += a[i] == b[i];
+    });
+    run("EQ limbs", ops, [&]() {
+        for (size_t n = 0; n < round; ++n)
+            for (size_t i = 0; i < count; ++i)
+                truth += eq(la[i], lb[i]);
+    });
+
+    cout << "checksum: " << truth << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,419 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the phases of the life of a block timed in process, from the decode of its
+ * transactions to its commit, for the workloads transfer, dag, crud and storage, printed as
+ * JSON so that the releases can be compared
+ *
+ * @file: block_benchmark.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libblockchain/BlockChainImp.h>
+#include <libblockverifier/BlockVerifier.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/easylog.h>
+#include <libethcore/ABI.h>
+#include <libethcore/Protocol.h>
+#include <libinitializer/Initializer.h>
+#include <libledger/DBInitializer.h>
+#include <libledger/LedgerParam.h>
+#include <libp2p/Service.h>
+#include <libtxpool/TxPool.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::initializer;
+using namespace dev::txpool;
+using namespace dev::blockverifier;
+using namespace dev::blockchain;
+
+namespace
+{
+/// the contract of the storage workload: writes calldata[0] to the 16 slots from calldata[0]
+const char* const c_storageContract =
+    "601b80600b6000396000f3"
+    "60003560005b806010111560195781818201556001016005565b00";
+const char* const c_crudTable = "bench";
+
+struct Options
+{
+    vector<string> workloads;
+    size_t txs;
+    size_t blocks;
+    size_t users;
+    string path;
+    string output;
+};
+
+/// a chain of its own for a workload
+struct Chain
+{
+    shared_ptr<DBInitializer> dbInitializer;
+    shared_ptr<BlockChainImp> blockChain;
+    shared_ptr<BlockVerifier> blockVerifier;
+    shared_ptr<dev::txpool::TxPool> txPool;
+};
+
+KeyPair const& keyPair()
+{
+    static KeyPair s_keyPair = KeyPair::create();
+    return s_keyPair;
+}
+
+Transaction newTransaction(Chain& _chain, Address const& _dest, bytes const& _data)
+{
+    static u256 s_nonce = u256(utcTimeUs());
+    Transaction tx(0, 0, 100000000, _dest, _data, ++s_nonce);
+    tx.setBlockLimit(_chain.blockChain->number() + 500);
+    Signature sig = sign(keyPair().secret(), tx.sha3(WithoutSignature));
+    tx.updateSignature(SignatureStruct(sig));
+    return tx;
+}
+
+Transaction newCreation(Chain& _chain, bytes const& _code)
+{
+    static u256 s_nonce = u256(utcTimeUs()) << 32;
+    Transaction tx(0, 0, 100000000, _code, ++s_nonce);
+    tx.setBlockLimit(_chain.blockChain->number() + 500);
+    Signature sig = sign(keyPair().secret(), tx.sha3(WithoutSignature));
+    tx.updateSignature(SignatureStruct(sig));
+    return tx;
+}
+
+BlockInfo parentInfo(Chain& _chain)
+{
+    auto parent = _chain.blockChain->getBlockByNumber(_chain.blockChain->number());
+    return BlockInfo{parent->header().hash(), parent->header().number(),
+        parent->header().stateRoot()};
+}
+
+Block newBlock(Chain& _chain, Transactions const& _txs)
+{
+    auto parent = parentInfo(_chain);
+    Block block;
+    block.header().setNumber(parent.number + 1);
+    block.header().setParentHash(parent.hash);
+    block.header().setTimestamp(utcTime());
+    block.header().setGasLimit(u256(1) << 62);
+    block.setTransactions(_txs);
+    return block;
+}
+
+/// execute and commit the transactions outside of the timed rounds
+Block setUp(Chain& _chain, Transactions const& _txs)
+{
+    auto block = newBlock(_chain, _txs);
+    auto context = _chain.blockVerifier->executeBlock(block, parentInfo(_chain));
+    _chain.blockChain->commitBlock(block, context);
+    return block;
+}
+
+Chain newChain(string const& _path)
+{
+    boost::filesystem::remove_all(_path);
+    Chain chain;
+    auto params = make_shared<LedgerParam>();
+    params->mutableStorageParam().type = "RocksDB";
+    params->mutableStorageParam().path = _path + "/block";
+    params->mutableStateParam().type = "storage";
+    chain.dbInitializer = make_shared<DBInitializer>(params);
+    chain.dbInitializer->initStorageDB();
+
+    chain.blockChain = make_shared<BlockChainImp>();
+    chain.blockChain->setStateStorage(chain.dbInitializer->storage());
+    chain.blockChain->setTableFactoryFactory(chain.dbInitializer->tableFactoryFactory());
+    GenesisBlockParam genesis = {"", h512s(), h512s(), "pbft", "RocksDB", "storage", 1000000,
+        300000000, 0};
+    chain.blockChain->checkAndBuildGenesisBlock(genesis);
+    chain.dbInitializer->initState(chain.blockChain->getBlockByNumber(0)->headerHash());
+
+    chain.blockVerifier = make_shared<BlockVerifier>(true);
+    chain.blockVerifier->setExecutiveContextFactory(
+        chain.dbInitializer->executiveContextFactory());
+    chain.blockVerifier->setNumberHash(
+        boost::bind(&BlockChainImp::numberHash, chain.blockChain, _1));
+
+    /// the transactions are imported locally, the service is never started
+    chain.txPool = make_shared<dev::txpool::TxPool>(make_shared<dev::p2p::Service>(),
+        chain.blockChain, getGroupProtoclID(1, ProtocolID::TxPool), 10000000);
+    return chain;
+}
+
+/// the transactions of a timed round, the set up of the workload is committed by the first call
+class Workload
+{
+public:
+    Workload(Chain& _chain, string const& _name, size_t _users)
+      : m_chain(_chain), m_name(_name), m_users(max(_users, (size_t)2))
+    {}
+
+    Transactions round(size_t _txs)
+    {
+        if (!m_ready)
+        {
+            setUpWorkload();
+            m_ready = true;
+        }
+        Transactions txs;
+        ContractABI abi;
+        for (size_t i = 0; i < _txs; ++i, ++m_sequence)
+        {
+            if (m_name == "transfer")
+            {
+                auto to = right160(sha3(to_string(m_sequence % m_users)));
+                txs.push_back(newTransaction(m_chain, to, bytes()));
+            }
+            else if (m_name == "dag")
+            {
+                /// disjoint pairs of users, so that the transfers are parallel
+                auto from = to_string((2 * m_sequence) % m_users);
+                auto to = to_string((2 * m_sequence + 1) % m_users);
+                txs.push_back(newTransaction(m_chain, Address(0x5002),
+                    abi.abiIn("userTransfer(string,string,uint256)", from, to, u256(1))));
+            }
+            else if (m_name == "crud")
+            {
+                auto key = to_string(m_sequence);
+                txs.push_back(newTransaction(m_chain, Address(0x1002),
+                    abi.abiIn("insert(string,string,string,string)", string(c_crudTable), key,
+                        "{\"key\":\"" + key + "\",\"value\":\"" + key + "\"}", string(""))));
+            }
+            else
+            {
+                txs.push_back(
+                    newTransaction(m_chain, m_contract, h256(u256(m_sequence) << 8).asBytes()));
+            }
+        }
+        return txs;
+    }
+
+private:
+    void setUpWorkload()
+    {
+        ContractABI abi;
+        Transactions txs;
+        if (m_name == "dag")
+        {
+            for (size_t i = 0; i < m_users; ++i)
+            {
+                txs.push_back(newTransaction(m_chain, Address(0x5002),
+                    abi.abiIn("userSave(string,uint256)", to_string(i), u256(1000000000))));
+            }
+        }
+        else if (m_name == "crud")
+        {
+            txs.push_back(newTransaction(m_chain, Address(0x1001),
+                abi.abiIn("createTable(string,string,string)", string(c_crudTable),
+                    string("key"), string("value"))));
+        }
+        else if (m_name == "storage")
+        {
+            txs.push_back(newCreation(m_chain, fromHex(c_storageContract)));
+        }
+        if (txs.empty())
+        {
+            return;
+        }
+        auto block = setUp(m_chain, txs);
+        if (m_name == "storage")
+        {
+            m_contract = block.transactionReceipts()[0].contractAddress();
+        }
+    }
+
+    Chain& m_chain;
+    string m_name;
+    size_t m_users;
+    bool m_ready = false;
+    uint64_t m_sequence = 0;
+    Address m_contract;
+};
+
+/// the us of _f
+template <typename F>
+uint64_t timed(F _f)
+{
+    auto start = utcTimeUs();
+    _f();
+    return utcTimeUs() - start;
+}
+
+Json::Value runWorkload(string const& _name, Options const& _options)
+{
+    auto chain = newChain(_options.path + "/" + _name);
+    Workload workload(chain, _name, _options.users);
+    map<string, uint64_t> phases;
+    size_t executed = 0;
+    for (size_t i = 0; i < _options.blocks; ++i)
+    {
+        auto txs = workload.round(_options.txs);
+        vector<bytes> encoded(txs.size());
+        for (size_t j = 0; j < txs.size(); ++j)
+        {
+            txs[j].encode(encoded[j]);
+        }
+
+        Transactions decoded(encoded.size());
+        phases["decode"] += timed([&]() {
+            for (size_t j = 0; j < encoded.size(); ++j)
+            {
+                decoded[j].decode(ref(encoded[j]), CheckTransaction::None);
+            }
+        });
+        phases["recoverSender"] += timed([&]() {
+            for (auto& tx : decoded)
+            {
+                tx.sender();
+            }
+        });
+        phases["txPoolImport"] += timed([&]() { chain.txPool->batchImport(decoded); });
+
+        Block block;
+        phases["seal"] += timed([&]() {
+            block = newBlock(chain, chain.txPool->topTransactions(_options.txs));
+        });
+        executed += block.getTransactionSize();
+        auto parent = parentInfo(chain);
+
+        /// the serial execution is thrown away, the parallel one is committed
+        Block serialBlock = block;
+        phases["executeSerial"] += timed(
+            [&]() { chain.blockVerifier->serialExecuteBlock(serialBlock, parent); });
+        ExecutiveContext::Ptr context;
+        phases["executeParallel"] += timed(
+            [&]() { context = chain.blockVerifier->parallelExecuteBlock(block, parent); });
+
+        phases["tableHash"] += timed([&]() { context->getMemoryTableFactory()->hash(); });
+        Block receiptBlock = block;
+        receiptBlock.setTransactionReceipts(block.transactionReceipts());
+        phases["receiptRoot"] += timed([&]() { receiptBlock.calReceiptRoot(false); });
+
+        phases["commitBlock"] += timed([&]() { chain.blockChain->commitBlock(block, context); });
+        chain.txPool->dropBlockTrans(block);
+    }
+
+    Json::Value result(Json::arrayValue);
+    for (auto const& it : phases)
+    {
+        Json::Value phase;
+        phase["workload"] = _name;
+        phase["phase"] = it.first;
+        phase["blocks"] = (Json::UInt64)_options.blocks;
+        phase["txs"] = (Json::UInt64)executed;
+        phase["totalUs"] = (Json::UInt64)it.second;
+        phase["avgBlockMs"] = _options.blocks > 0 ? it.second / 1000.0 / _options.blocks : 0.0;
+        phase["tps"] = it.second > 0 ? executed * 1000000.0 / it.second : 0.0;
+        result.append(phase);
+    }
+    return result;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the phases of the life of a block timed for a set of workloads");
+    description.add_options()("workloads,w",
+        boost::program_options::value<string>()->default_value("transfer,dag,crud,storage"),
+        "the workloads run, among transfer, dag, crud and storage")("txs,t",
+        boost::program_options::value<size_t>()->default_value(1000),
+        "the transactions of a block")("blocks,b",
+        boost::program_options::value<size_t>()->default_value(10), "the blocks of a workload")(
+        "users,u", boost::program_options::value<size_t>()->default_value(1000),
+        "the users of the transfer and dag workloads")("path,p",
+        boost::program_options::value<string>()->default_value("./block_benchmark"),
+        "the directory of the chains, cleared before each workload")("output,o",
+        boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    if (vm.count("help"))
+    {
+        cout << description << endl;
+        exit(0);
+    }
+    Options options;
+    boost::split(options.workloads, vm["workloads"].as<string>(), boost::is_any_of(","));
+    options.txs = vm["txs"].as<size_t>();
+    options.blocks = vm["blocks"].as<size_t>();
+    options.users = vm["users"].as<size_t>();
+    options.path = vm["path"].as<string>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    for (auto const& workload : options.workloads)
+    {
+        if (workload != "transfer" && workload != "dag" && workload != "crud" &&
+            workload != "storage")
+        {
+            cout << "unknown workload " << workload << endl;
+            return 1;
+        }
+    }
+
+    boost::property_tree::ptree pt;
+    pt.put("log.level", "error");
+    LogInitializer log;
+    log.initLog(pt);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["txsPerBlock"] = (Json::UInt64)options.txs;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto const& workload : options.workloads)
+    {
+        for (auto const& phase : runWorkload(workload, options))
+        {
+            report["results"].append(phase);
+        }
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
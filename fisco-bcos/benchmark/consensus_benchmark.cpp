@@ -0,0 +1,465 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the nodes of a group run in one process over a simulated network, the commit latency
+ * and the throughput printed as JSON for each number of nodes, block size and view change
+ * interval
+ *
+ * @file: consensus_benchmark.cpp
+ */
+
+#include "../Fake.h"
+#include "SimNetwork.h"
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libblockchain/BlockChainImp.h>
+#include <libblockverifier/BlockVerifier.h>
+#include <libconsensus/pbft/PBFTEngine.h>
+#include <libconsensus/pbft/PBFTSealer.h>
+#include <libconsensus/raft/RaftEngine.h>
+#include <libconsensus/raft/RaftSealer.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/easylog.h>
+#include <libethcore/Protocol.h>
+#include <libinitializer/Initializer.h>
+#include <libledger/DBInitializer.h>
+#include <libsync/SyncMaster.h>
+#include <libtxpool/TxPool.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::initializer;
+using namespace dev::consensus;
+using namespace dev::sim;
+
+namespace
+{
+struct Options
+{
+    vector<size_t> nodes;
+    vector<size_t> blockSizes;
+    vector<unsigned> viewChangeIntervals;
+    unsigned isolateMs;
+    LinkParams link;
+    unsigned duration;
+    size_t tps;
+    string consensus;
+    string verifier;
+    uint64_t seed;
+    string path;
+    string output;
+};
+
+/// the chain of the fake verifier, its sealers and block size are the ones of the run
+class SimBlockChain : public FakeBlockChain
+{
+public:
+    SimBlockChain(h512s const& _sealers, size_t _blockSize)
+      : m_sealers(_sealers), m_blockSize(_blockSize)
+    {}
+
+    h512s sealerList() override { return m_sealers; }
+    string getSystemConfigByKey(string const& _key, int64_t _num = -1) override
+    {
+        if (_key == "tx_count_limit")
+        {
+            return to_string(m_blockSize);
+        }
+        return FakeBlockChain::getSystemConfigByKey(_key, _num);
+    }
+
+private:
+    h512s m_sealers;
+    size_t m_blockSize;
+};
+
+struct Node
+{
+    KeyPair keyPair = KeyPair::create();
+    shared_ptr<SimService> service;
+    shared_ptr<DBInitializer> dbInitializer;
+    shared_ptr<BlockChainInterface> blockChain;
+    shared_ptr<BlockVerifierInterface> blockVerifier;
+    shared_ptr<dev::txpool::TxPool> txPool;
+    shared_ptr<dev::sync::SyncMaster> sync;
+    shared_ptr<Sealer> sealer;
+};
+
+void newChain(Node& _node, h512s const& _sealers, size_t _blockSize, string const& _path)
+{
+    auto params = make_shared<LedgerParam>();
+    params->mutableStorageParam().type = "RocksDB";
+    params->mutableStorageParam().path = _path + "/block";
+    params->mutableStateParam().type = "storage";
+    _node.dbInitializer = make_shared<DBInitializer>(params);
+    _node.dbInitializer->initStorageDB();
+
+    auto blockChain = make_shared<BlockChainImp>();
+    blockChain->setStateStorage(_node.dbInitializer->storage());
+    blockChain->setTableFactoryFactory(_node.dbInitializer->tableFactoryFactory());
+    GenesisBlockParam genesis = {"", _sealers, h512s(), "pbft", "RocksDB", "storage",
+        (int64_t)_blockSize, 300000000, 0};
+    blockChain->checkAndBuildGenesisBlock(genesis);
+    _node.dbInitializer->initState(blockChain->getBlockByNumber(0)->headerHash());
+
+    auto blockVerifier = make_shared<BlockVerifier>(true);
+    blockVerifier->setExecutiveContextFactory(_node.dbInitializer->executiveContextFactory());
+    blockVerifier->setNumberHash(boost::bind(&BlockChainImp::numberHash, blockChain, _1));
+    _node.blockChain = blockChain;
+    _node.blockVerifier = blockVerifier;
+}
+
+/// the index of the leader, or -1 if there is none yet
+int leader(vector<Node> const& _nodes, Options const& _options)
+{
+    for (size_t i = 0; i < _nodes.size(); ++i)
+    {
+        auto engine = _nodes[i].sealer->consensusEngine();
+        if (_options.consensus == "raft")
+        {
+            if (dynamic_pointer_cast<RaftEngine>(engine)->getState() ==
+                RaftRole::EN_STATE_LEADER)
+            {
+                return i;
+            }
+            continue;
+        }
+        auto pbft = dynamic_pointer_cast<PBFTEngine>(engine);
+        auto leader = pbft->getLeader();
+        if (leader.first && leader.second == pbft->nodeIdx())
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/// the views changed, or the elections after the first for raft, seen by the first node
+uint64_t viewChanges(Node const& _node, Options const& _options)
+{
+    auto engine = _node.sealer->consensusEngine();
+    if (_options.consensus == "raft")
+    {
+        auto term = dynamic_pointer_cast<RaftEngine>(engine)->getTerm();
+        return term > 0 ? term - 1 : 0;
+    }
+    return dynamic_pointer_cast<PBFTEngine>(engine)->view();
+}
+
+Json::Value runCase(
+    Options const& _options, size_t _nodeCount, size_t _blockSize, unsigned _viewChangeInterval)
+{
+    auto path = _options.path + "/" + to_string(_nodeCount) + "_" + to_string(_blockSize) + "_" +
+                to_string(_viewChangeInterval);
+    boost::filesystem::remove_all(path);
+
+    auto network = make_shared<SimNetwork>(_options.link, _options.seed);
+    vector<Node> nodes(_nodeCount);
+    h512s sealers;
+    for (auto const& node : nodes)
+    {
+        sealers.push_back(node.keyPair.pub());
+    }
+    sort(sealers.begin(), sealers.end());
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        auto& node = nodes[i];
+        auto nodePath = path + "/node" + to_string(i);
+        boost::filesystem::create_directories(nodePath);
+        node.service = make_shared<SimService>(network, node.keyPair.pub());
+        network->addNode(node.keyPair.pub(), node.service);
+        if (_options.verifier == "real")
+        {
+            newChain(node, sealers, _blockSize, nodePath);
+        }
+        else
+        {
+            node.blockChain = make_shared<SimBlockChain>(sealers, _blockSize);
+            node.blockVerifier = make_shared<FakeBlockVerifier>();
+        }
+        node.txPool = make_shared<dev::txpool::TxPool>(node.service, node.blockChain,
+            getGroupProtoclID(1, ProtocolID::TxPool), 10000000);
+        node.sync = make_shared<dev::sync::SyncMaster>(node.service, node.txPool, node.blockChain,
+            node.blockVerifier, getGroupProtoclID(1, ProtocolID::BlockSync),
+            node.keyPair.pub(), node.blockChain->getBlockByNumber(0)->headerHash());
+        if (_options.consensus == "raft")
+        {
+            node.sealer = make_shared<RaftSealer>(node.service, node.txPool, node.blockChain,
+                node.sync, node.blockVerifier, node.keyPair, 1000, 2000,
+                getGroupProtoclID(1, ProtocolID::Raft), sealers);
+        }
+        else
+        {
+            node.sealer = make_shared<PBFTSealer>(node.service, node.txPool, node.blockChain,
+                node.sync, node.blockVerifier, getGroupProtoclID(1, ProtocolID::PBFT), nodePath,
+                node.keyPair, sealers);
+        }
+    }
+
+    /// the time each block is committed by the first node
+    mutex commitLock;
+    map<int64_t, uint64_t> commitTimes;
+    auto observed = nodes[0].blockChain;
+    auto handler = nodes[0].blockChain->onReady([&commitLock, &commitTimes, observed](int64_t) {
+        auto now = utcTimeUs();
+        auto number = observed->number();
+        lock_guard<mutex> l(commitLock);
+        commitTimes.emplace(number, now);
+    });
+
+    network->start();
+    for (auto& node : nodes)
+    {
+        node.sync->start();
+        node.sealer->start();
+    }
+
+    /// the transactions are sent to the nodes in turn, the sync broadcasts them to the others
+    unordered_map<h256, uint64_t> submitTimes;
+    u256 nonce = u256(utcTimeUs());
+    auto keyPair = KeyPair::create();
+    auto start = utcTimeUs();
+    auto end = start + _options.duration * 1000000;
+    auto nextViewChange = start + _viewChangeInterval * 1000;
+    size_t submitted = 0;
+    size_t refused = 0;
+    for (auto now = start; now < end; now = utcTimeUs())
+    {
+        auto due = (size_t)((now - start) * _options.tps / 1000000);
+        for (; submitted < due; ++submitted)
+        {
+            Transaction tx(0, 0, 100000000, right160(sha3(to_string(submitted))), bytes(), ++nonce);
+            tx.setBlockLimit(nodes[0].blockChain->number() + 500);
+            Signature sig = sign(keyPair.secret(), tx.sha3(WithoutSignature));
+            tx.updateSignature(SignatureStruct(sig));
+            try
+            {
+                submitTimes[tx.sha3()] = utcTimeUs();
+                nodes[submitted % nodes.size()].txPool->submit(tx);
+            }
+            catch (std::exception const&)
+            {
+                ++refused;
+            }
+        }
+        if (_viewChangeInterval > 0 && now >= nextViewChange)
+        {
+            auto index = leader(nodes, _options);
+            if (index >= 0)
+            {
+                network->isolate(nodes[index].keyPair.pub(), _options.isolateMs);
+            }
+            nextViewChange += _viewChangeInterval * 1000;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    auto elapsed = utcTimeUs() - start;
+
+    for (auto& node : nodes)
+    {
+        node.sealer->stop();
+        node.sync->stop();
+    }
+    network->stop();
+    handler.reset();
+
+    Histogram latency;
+    uint64_t committed = 0;
+    auto number = nodes[0].blockChain->number();
+    for (int64_t i = 1; i <= number; ++i)
+    {
+        auto block = nodes[0].blockChain->getBlockByNumber(i);
+        auto commitTime = commitTimes.find(i);
+        if (!block || commitTime == commitTimes.end())
+        {
+            continue;
+        }
+        for (auto const& tx : block->transactions())
+        {
+            auto submitTime = submitTimes.find(tx.sha3());
+            if (submitTime != submitTimes.end() && commitTime->second >= submitTime->second)
+            {
+                latency.observe(commitTime->second - submitTime->second);
+                ++committed;
+            }
+        }
+    }
+
+    auto snapshot = latency.snapshot();
+    Json::Value result;
+    result["nodes"] = (Json::UInt64)_nodeCount;
+    result["blockSize"] = (Json::UInt64)_blockSize;
+    result["viewChangeInterval(ms)"] = _viewChangeInterval;
+    result["submitted"] = (Json::UInt64)submitted;
+    result["refused"] = (Json::UInt64)refused;
+    result["committed"] = (Json::UInt64)committed;
+    result["blocks"] = (Json::Int64)number;
+    result["tps"] = elapsed > 0 ? committed * 1000000.0 / elapsed : 0.0;
+    result["viewChanges"] = (Json::UInt64)viewChanges(nodes[0], _options);
+    result["p50(us)"] = (Json::UInt64)snapshot.quantile(0.5);
+    result["p99(us)"] = (Json::UInt64)snapshot.quantile(0.99);
+    result["p999(us)"] = (Json::UInt64)snapshot.quantile(0.999);
+    result["messages"] = (Json::UInt64)network->messages();
+    result["bytes"] = (Json::UInt64)network->bytes();
+    result["dropped"] = (Json::UInt64)network->dropped();
+    return result;
+}
+
+template <typename T>
+vector<T> parseList(string const& _value)
+{
+    vector<string> items;
+    boost::split(items, _value, boost::is_any_of(","));
+    vector<T> values;
+    for (auto const& item : items)
+    {
+        values.push_back(boost::lexical_cast<T>(item));
+    }
+    return values;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the commit latency and the throughput of a group in one process over a simulated "
+        "network");
+    description.add_options()("nodes,n",
+        boost::program_options::value<string>()->default_value("4"),
+        "the numbers of nodes run, comma separated")("block-size,b",
+        boost::program_options::value<string>()->default_value("1000"),
+        "the most transactions of a block, comma separated")("view-change-interval,v",
+        boost::program_options::value<string>()->default_value("0"),
+        "ms between isolating the leader to force a view change, 0 for none, comma separated")(
+        "isolate-ms", boost::program_options::value<unsigned>()->default_value(5000),
+        "ms the leader is isolated for")("latency,l",
+        boost::program_options::value<unsigned>()->default_value(10),
+        "one way delay of a message in ms")("jitter,j",
+        boost::program_options::value<unsigned>()->default_value(0),
+        "the delay varies by up to jitter ms")("bandwidth",
+        boost::program_options::value<double>()->default_value(0),
+        "Mbps of each direction of a link, 0 for no limit")("loss",
+        boost::program_options::value<double>()->default_value(0),
+        "the share of the messages dropped")("duration,d",
+        boost::program_options::value<unsigned>()->default_value(30), "seconds of each run")(
+        "tps,t", boost::program_options::value<size_t>()->default_value(1000),
+        "the transactions sent per second")("consensus,c",
+        boost::program_options::value<string>()->default_value("pbft"), "pbft or raft")(
+        "verifier", boost::program_options::value<string>()->default_value("fake"),
+        "fake to skip the execution, real to execute and store the blocks in RocksDB")("seed",
+        boost::program_options::value<uint64_t>()->default_value(0),
+        "the seed of the latency and the loss")("path,p",
+        boost::program_options::value<string>()->default_value("./consensus_benchmark"),
+        "the directory of the nodes, cleared before each run")("output,o",
+        boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        options.nodes = parseList<size_t>(vm["nodes"].as<string>());
+        options.blockSizes = parseList<size_t>(vm["block-size"].as<string>());
+        options.viewChangeIntervals = parseList<unsigned>(vm["view-change-interval"].as<string>());
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.isolateMs = vm["isolate-ms"].as<unsigned>();
+    options.link.latency = vm["latency"].as<unsigned>();
+    options.link.jitter = vm["jitter"].as<unsigned>();
+    options.link.bandwidth = vm["bandwidth"].as<double>();
+    options.link.loss = vm["loss"].as<double>();
+    options.duration = vm["duration"].as<unsigned>();
+    options.tps = vm["tps"].as<size_t>();
+    options.consensus = vm["consensus"].as<string>();
+    options.verifier = vm["verifier"].as<string>();
+    options.seed = vm["seed"].as<uint64_t>();
+    options.path = vm["path"].as<string>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    if ((options.consensus != "pbft" && options.consensus != "raft") ||
+        (options.verifier != "fake" && options.verifier != "real"))
+    {
+        cout << "unknown consensus or verifier" << endl;
+        return 1;
+    }
+
+    boost::property_tree::ptree pt;
+    pt.put("log.level", "error");
+    LogInitializer log;
+    log.initLog(pt);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["consensus"] = options.consensus;
+    report["verifier"] = options.verifier;
+    report["latency(ms)"] = options.link.latency;
+    report["jitter(ms)"] = options.link.jitter;
+    report["bandwidth(Mbps)"] = options.link.bandwidth;
+    report["loss"] = options.link.loss;
+    report["tps"] = (Json::UInt64)options.tps;
+    report["seed"] = (Json::UInt64)options.seed;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto nodes : options.nodes)
+    {
+        for (auto blockSize : options.blockSizes)
+        {
+            for (auto interval : options.viewChangeIntervals)
+            {
+                report["results"].append(runCase(options, nodes, blockSize, interval));
+            }
+        }
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
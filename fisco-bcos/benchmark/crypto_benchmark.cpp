@@ -0,0 +1,352 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the ops per second of the hash, the signature and the cipher of the build, keccak256,
+ * secp256k1 and AES or SM3, SM2 and SM4 with FISCO_GM, one at a time on each thread or in batches
+ * spread over the threads as the node verifies a block, printed as JSON
+ *
+ * @file: crypto_benchmark.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/easylog.h>
+#include <libdevcrypto/AES.h>
+#include <libdevcrypto/Common.h>
+#include <libdevcrypto/Exceptions.h>
+#include <libdevcrypto/Hash.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+/// the inputs an operation cycles through
+const size_t c_inputs = 1024;
+/// the ops between two checks of the clock
+const size_t c_checkEvery = 16;
+/// the size of the signed hashes
+const size_t c_hashSize = 32;
+
+struct Options
+{
+    vector<string> ops;
+    vector<size_t> sizes;
+    vector<size_t> threads;
+    vector<size_t> batches;
+    double seconds;
+    string output;
+};
+
+/// an operation over the inputs of one size, [_begin, _end) of them in a batch
+class Operation
+{
+public:
+    Operation(string const& _name, size_t _size)
+      : m_name(_name), m_keyPair(KeyPair::create()), m_key(32, 0x5a)
+    {
+        mt19937_64 random(_size);
+        for (size_t i = 0; i < c_inputs; ++i)
+        {
+            bytes data(_size);
+            for (auto& b : data)
+            {
+                b = (byte)random();
+            }
+            m_hashes.push_back(sha3(data));
+            m_data.push_back(move(data));
+        }
+        for (auto const& data : m_data)
+        {
+            m_refs.push_back(ref(data));
+        }
+        if (m_name == "verify" || m_name == "recover")
+        {
+            for (auto const& hash : m_hashes)
+            {
+                m_signatures.push_back(sign(m_keyPair.secret(), hash));
+            }
+        }
+        if (m_name == "decrypt")
+        {
+            for (auto const& data : m_data)
+            {
+                m_ciphers.push_back(aesCBCEncrypt(ref(data), ref(m_key)));
+            }
+        }
+    }
+
+    static bool known(string const& _name)
+    {
+        return _name == "sha3" || !sized(_name) || _name == "encrypt" || _name == "decrypt";
+    }
+
+    /// the signatures are of hashes, whatever the size of the messages
+    static bool sized(string const& _name)
+    {
+        return _name != "sign" && _name != "verify" && _name != "recover";
+    }
+
+    void run(size_t _begin, size_t _end)
+    {
+        if (m_name == "sha3" && _end - _begin > 1)
+        {
+            // the multi-buffer hash of the lanes the cpu has
+            h256 outputs[c_checkEvery];
+            for (size_t i = _begin; i < _end; i += c_checkEvery)
+            {
+                vector<bytesConstRef> inputs;
+                for (size_t j = i; j < min(_end, i + c_checkEvery); ++j)
+                {
+                    inputs.push_back(m_refs[j % c_inputs]);
+                }
+                sha3Batch(inputs, outputs);
+            }
+            return;
+        }
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            runOne(i % c_inputs);
+        }
+    }
+
+private:
+    void runOne(size_t _i)
+    {
+        if (m_name == "sha3")
+        {
+            sha3(m_refs[_i]);
+        }
+        else if (m_name == "sign")
+        {
+            sign(m_keyPair.secret(), m_hashes[_i]);
+        }
+        else if (m_name == "verify")
+        {
+            if (!verify(m_keyPair.pub(), m_signatures[_i], m_hashes[_i]))
+            {
+                BOOST_THROW_EXCEPTION(crypto::CryptoException() << errinfo_comment("verify failed"));
+            }
+        }
+        else if (m_name == "recover")
+        {
+            recover(m_signatures[_i], m_hashes[_i]);
+        }
+        else if (m_name == "encrypt")
+        {
+            aesCBCEncrypt(m_refs[_i], ref(m_key));
+        }
+        else
+        {
+            aesCBCDecrypt(ref(m_ciphers[_i]), ref(m_key));
+        }
+    }
+
+    string m_name;
+    KeyPair m_keyPair;
+    bytes m_key;
+    vector<bytes> m_data;
+    vector<bytesConstRef> m_refs;
+    vector<h256> m_hashes;
+    vector<Signature> m_signatures;
+    vector<bytes> m_ciphers;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// the ops done in _seconds: one at a time on each of _threads threads if _batch is 1, else
+/// batches of _batch spread over an arena of _threads threads one after the other
+Json::Value runCase(
+    Operation& _operation, size_t _size, size_t _threads, size_t _batch, double _seconds)
+{
+    atomic<uint64_t> ops = {0};
+    auto start = nowUs();
+    auto end = start + (uint64_t)(_seconds * 1e6);
+    if (_batch <= 1)
+    {
+        vector<thread> threads;
+        for (size_t t = 0; t < _threads; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                uint64_t done = 0;
+                for (size_t i = t * c_inputs / _threads; nowUs() < end; i += c_checkEvery)
+                {
+                    for (size_t j = 0; j < c_checkEvery; ++j)
+                    {
+                        _operation.run(i + j, i + j + 1);
+                    }
+                    done += c_checkEvery;
+                }
+                ops += done;
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+    }
+    else
+    {
+        tbb::task_arena arena(_threads);
+        for (size_t offset = 0; nowUs() < end; offset += _batch)
+        {
+            arena.execute([&]() {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, _batch, c_checkEvery),
+                    [&](tbb::blocked_range<size_t> const& _range) {
+                        _operation.run(offset + _range.begin(), offset + _range.end());
+                    });
+            });
+            ops += _batch;
+        }
+    }
+    auto elapsed = (nowUs() - start) / 1e6;
+
+    Json::Value result;
+    result["size"] = (Json::UInt64)_size;
+    result["threads"] = (Json::UInt64)_threads;
+    result["batch"] = (Json::UInt64)_batch;
+    result["ops"] = (Json::UInt64)ops.load();
+    result["opsPerSecond"] = ops.load() / elapsed;
+    result["MBPerSecond"] = ops.load() * _size / 1e6 / elapsed;
+    return result;
+}
+
+template <typename T>
+vector<T> parseList(string const& _list)
+{
+    vector<string> items;
+    boost::split(items, _list, boost::is_any_of(","));
+    vector<T> result;
+    for (auto const& item : items)
+    {
+        result.push_back(boost::lexical_cast<T>(item));
+    }
+    return result;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the ops per second of the crypto of this build");
+    description.add_options()("ops",
+        boost::program_options::value<string>()->default_value(
+            "sha3,sign,verify,recover,encrypt,decrypt"),
+        "the operations run, comma separated")("sizes,s",
+        boost::program_options::value<string>()->default_value("32,256,1024,4096"),
+        "bytes of the messages hashed and encrypted, comma separated, the signatures are of 32 "
+        "bytes hashes")("threads,t", boost::program_options::value<string>()->default_value("1,4"),
+        "the threads, comma separated")("batch,b",
+        boost::program_options::value<string>()->default_value("1,1000"),
+        "ops of a batch, 1 for one at a time on each thread, comma separated")("seconds",
+        boost::program_options::value<double>()->default_value(1), "seconds of each case")(
+        "output,o", boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        options.ops = parseList<string>(vm["ops"].as<string>());
+        options.sizes = parseList<size_t>(vm["sizes"].as<string>());
+        options.threads = parseList<size_t>(vm["threads"].as<string>());
+        options.batches = parseList<size_t>(vm["batch"].as<string>());
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.seconds = vm["seconds"].as<double>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+#ifdef FISCO_GM
+    report["hash"] = "sm3";
+    report["signature"] = "sm2";
+    report["cipher"] = "sm4-cbc";
+#else
+    report["hash"] = "keccak256";
+    report["signature"] = "secp256k1";
+    report["cipher"] = "aes-256-cbc";
+#endif
+    report["cores"] = thread::hardware_concurrency();
+    report["results"] = Json::Value(Json::objectValue);
+    for (auto const& op : options.ops)
+    {
+        if (!Operation::known(op))
+        {
+            cout << "unknown operation " << op << endl;
+            return 1;
+        }
+        auto sizes = Operation::sized(op) ? options.sizes : vector<size_t>{c_hashSize};
+        for (auto size : sizes)
+        {
+            Operation operation(op, size);
+            for (auto threads : options.threads)
+            {
+                for (auto batch : options.batches)
+                {
+                    report["results"][op].append(
+                        runCase(operation, size, max(threads, (size_t)1), batch, options.seconds));
+                }
+            }
+        }
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the ops per second of the maps of the transaction hashes, std::unordered_map against
+ * FixedHashMap, and one behind a lock against ConcurrentFixedHashMap on several threads,
+ * printed as JSON
+ *
+ * @file: hashmap_benchmark.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/FixedHashMap.h>
+#include <libdevcore/easylog.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+struct Options
+{
+    vector<size_t> sizes;
+    size_t threads;
+    double seconds;
+    string output;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// _ops ops per call of _op, repeated for _seconds
+Json::Value runCase(function<void()> const& _op, size_t _ops, double _seconds)
+{
+    uint64_t ops = 0;
+    auto start = nowUs();
+    auto end = start + (uint64_t)(_seconds * 1e6);
+    while (nowUs() < end)
+    {
+        _op();
+        ops += _ops;
+    }
+    auto elapsed = (nowUs() - start) / 1e6;
+
+    Json::Value result;
+    result["ops"] = (Json::UInt64)ops;
+    result["opsPerSecond"] = ops / elapsed;
+    return result;
+}
+
+/// inserts, finds of present and absent keys and erases of a map of _size, as the pool does
+template <class Map>
+Json::Value runMap(vector<h256> const& _keys, vector<h256> const& _absent, double _seconds)
+{
+    Map map;
+    Json::Value result;
+    result["insert"] = runCase(
+        [&]() {
+            map.clear();
+            for (auto const& key : _keys)
+            {
+                map[key] = 1;
+            }
+        },
+        _keys.size(), _seconds);
+    size_t found = 0;
+    result["find"] = runCase(
+        [&]() {
+            for (auto const& key : _keys)
+            {
+                found += map.count(key);
+            }
+        },
+        _keys.size(), _seconds);
+    result["findAbsent"] = runCase(
+        [&]() {
+            for (auto const& key : _absent)
+            {
+                found += map.count(key);
+            }
+        },
+        _absent.size(), _seconds);
+    result["insertErase"] = runCase(
+        [&]() {
+            for (auto const& key : _keys)
+            {
+                map.erase(key);
+            }
+            for (auto const& key : _keys)
+            {
+                map[key] = 1;
+            }
+        },
+        2 * _keys.size(), _seconds);
+    result["found"] = (Json::UInt64)found;
+    return result;
+}
+
+/// a map behind a shared lock as the pool keeps it
+struct LockedMap
+{
+    mutable SharedMutex lock;
+    unordered_map<h256, size_t> map;
+
+    void insert(h256 const& _key, size_t _value)
+    {
+        WriteGuard l(lock);
+        map.emplace(_key, _value);
+    }
+    void erase(h256 const& _key)
+    {
+        WriteGuard l(lock);
+        map.erase(_key);
+    }
+    bool count(h256 const& _key) const
+    {
+        ReadGuard l(lock);
+        return map.count(_key);
+    }
+};
+
+/// _threads threads, each inserting its keys, finding them and erasing them
+template <class Map>
+Json::Value runShared(vector<vector<h256>> const& _keys, double _seconds)
+{
+    Map map;
+    atomic<uint64_t> ops = {0};
+    auto start = nowUs();
+    auto end = start + (uint64_t)(_seconds * 1e6);
+    vector<thread> threads;
+    for (size_t t = 0; t < _keys.size(); ++t)
+    {
+        threads.emplace_back([&, t]() {
+            uint64_t done = 0;
+            while (nowUs() < end)
+            {
+                for (auto const& key : _keys[t])
+                {
+                    map.insert(key, 1);
+                }
+                for (auto const& key : _keys[t])
+                {
+                    done += map.count(key);
+                }
+                for (auto const& key : _keys[t])
+                {
+                    map.erase(key);
+                }
+                done += 2 * _keys[t].size();
+            }
+            ops += done;
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    auto elapsed = (nowUs() - start) / 1e6;
+
+    Json::Value result;
+    result["ops"] = (Json::UInt64)ops.load();
+    result["opsPerSecond"] = ops.load() / elapsed;
+    return result;
+}
+
+vector<h256> randomKeys(size_t _size)
+{
+    vector<h256> keys;
+    for (size_t i = 0; i < _size; ++i)
+    {
+        keys.push_back(h256::random());
+    }
+    return keys;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the ops per second of the maps of the hashes of this build");
+    description.add_options()("sizes,s",
+        boost::program_options::value<string>()->default_value("1000,100000,1000000"),
+        "the keys of a map, comma separated")("threads,t",
+        boost::program_options::value<size_t>()->default_value(4),
+        "the threads sharing a map")("seconds",
+        boost::program_options::value<double>()->default_value(1), "seconds of each case")(
+        "output,o", boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        vector<string> sizes;
+        boost::split(sizes, vm["sizes"].as<string>(), boost::is_any_of(","));
+        for (auto const& size : sizes)
+        {
+            options.sizes.push_back(boost::lexical_cast<size_t>(size));
+        }
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.threads = max(vm["threads"].as<size_t>(), (size_t)1);
+    options.seconds = vm["seconds"].as<double>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["threads"] = (Json::UInt64)options.threads;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto size : options.sizes)
+    {
+        auto keys = randomKeys(size);
+        auto absent = randomKeys(size);
+        vector<vector<h256>> threadKeys;
+        for (size_t t = 0; t < options.threads; ++t)
+        {
+            threadKeys.push_back(randomKeys(size / options.threads + 1));
+        }
+
+        Json::Value result;
+        result["size"] = (Json::UInt64)size;
+        result["unorderedMap"] =
+            runMap<unordered_map<h256, size_t>>(keys, absent, options.seconds);
+        result["fixedHashMap"] = runMap<FixedHashMap<h256, size_t>>(keys, absent, options.seconds);
+        result["lockedUnorderedMap"] = runShared<LockedMap>(threadKeys, options.seconds);
+        result["concurrentFixedHashMap"] =
+            runShared<ConcurrentFixedHashMap<h256, size_t>>(threadKeys, options.seconds);
+        report["results"].append(result);
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
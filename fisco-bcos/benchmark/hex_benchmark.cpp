@@ -0,0 +1,203 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the MB per second of toHex and fromHex against a byte at a time as they were, from
+ * a hash to a block, printed as JSON
+ *
+ * @file: hex_benchmark.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/CommonData.h>
+#include <libdevcore/easylog.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+struct Options
+{
+    vector<size_t> sizes;
+    double seconds;
+    string output;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// _op converting _bytes bytes, repeated for _seconds
+Json::Value runCase(function<size_t()> const& _op, size_t _bytes, double _seconds)
+{
+    uint64_t calls = 0;
+    size_t check = 0;
+    auto start = nowUs();
+    auto end = start + (uint64_t)(_seconds * 1e6);
+    while (nowUs() < end)
+    {
+        check += _op();
+        ++calls;
+    }
+    auto elapsed = (nowUs() - start) / 1e6;
+
+    Json::Value result;
+    result["calls"] = (Json::UInt64)calls;
+    result["MBPerSecond"] = calls * _bytes / elapsed / 1e6;
+    result["check"] = (Json::UInt64)check;
+    return result;
+}
+
+/// toHex before the conversion was vectorized
+string legacyToHex(bytes const& _data)
+{
+    static char const* hexdigits = "0123456789abcdef";
+    string hex(_data.size() * 2, '0');
+    size_t off = 0;
+    for (auto it = _data.begin(); it != _data.end(); it++)
+    {
+        hex[off++] = hexdigits[(*it >> 4) & 0x0f];
+        hex[off++] = hexdigits[*it & 0x0f];
+    }
+    return hex;
+}
+
+int legacyFromHexChar(char _i)
+{
+    if (_i >= '0' && _i <= '9')
+        return _i - '0';
+    if (_i >= 'a' && _i <= 'f')
+        return _i - 'a' + 10;
+    if (_i >= 'A' && _i <= 'F')
+        return _i - 'A' + 10;
+    return -1;
+}
+
+/// fromHex before the conversion was vectorized
+bytes legacyFromHex(string const& _s)
+{
+    bytes ret;
+    ret.reserve(_s.size() / 2);
+    for (size_t i = 0; i + 1 < _s.size(); i += 2)
+    {
+        int h = legacyFromHexChar(_s[i]);
+        int l = legacyFromHexChar(_s[i + 1]);
+        if (h == -1 || l == -1)
+        {
+            return bytes();
+        }
+        ret.push_back((byte)(h * 16 + l));
+    }
+    return ret;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the MB per second of the hex conversion of this build");
+    description.add_options()("sizes,s",
+        boost::program_options::value<string>()->default_value("32,1024,5242880"),
+        "the bytes converted by a call, comma separated")("seconds",
+        boost::program_options::value<double>()->default_value(1), "seconds of each case")(
+        "output,o", boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        vector<string> sizes;
+        boost::split(sizes, vm["sizes"].as<string>(), boost::is_any_of(","));
+        for (auto const& size : sizes)
+        {
+            options.sizes.push_back(boost::lexical_cast<size_t>(size));
+        }
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.seconds = vm["seconds"].as<double>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["results"] = Json::Value(Json::arrayValue);
+    mt19937 random(7);
+    for (auto size : options.sizes)
+    {
+        bytes data(size);
+        for (auto& b : data)
+        {
+            b = (byte)random();
+        }
+        auto hex = toHex(data);
+        if (legacyToHex(data) != hex || legacyFromHex(hex) != data || fromHex(hex) != data)
+        {
+            cout << "the conversions differ" << endl;
+            return 1;
+        }
+
+        Json::Value result;
+        result["size"] = (Json::UInt64)size;
+        result["legacyToHex"] =
+            runCase([&]() { return legacyToHex(data).size(); }, size, options.seconds);
+        result["toHex"] = runCase([&]() { return toHex(data).size(); }, size, options.seconds);
+        result["legacyFromHex"] =
+            runCase([&]() { return legacyFromHex(hex).size(); }, size, options.seconds);
+        result["fromHex"] = runCase([&]() { return fromHex(hex).size(); }, size, options.seconds);
+        report["results"].append(result);
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
@@ -0,0 +1,615 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: a sustained load on a live chain through the channel port of a node, the transactions
+ * of the workloads transfer, dag, crud or of any method are signed ahead on all cores, sent at a
+ * rate with a bound on those in flight, and timed from their sending to their receipt, printed as
+ * JSON
+ *
+ * @file: load_generator.cpp
+ */
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libchannelserver/ChannelMessage.h>
+#include <libchannelserver/ChannelSession.h>
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/easylog.h>
+#include <libethcore/ABI.h>
+#include <libethcore/ABIParser.h>
+#include <libethcore/Transaction.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::channel;
+
+namespace
+{
+const char* const c_crudTable = "load";
+/// the blocks a pre-signed transaction stays valid for, below the 1000 the txpool accepts
+const int64_t c_blockLimitRange = 900;
+/// the channel message types of a JSON-RPC request and of a receipt pushed to the sdk
+const uint16_t c_rpcRequest = 0x12;
+const uint16_t c_receiptPush = 0x1000;
+
+struct Options
+{
+    string endpoint;
+    string ca;
+    string cert;
+    string key;
+    int group;
+    string workload;
+    size_t txs;
+    size_t users;
+    size_t concurrency;
+    double rate;
+    string to;
+    string method;
+    string args;
+    double timeout;
+    string output;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// the calldata of a method given by its signature, e.g. "set(string,uint256)", and its comma
+/// separated arguments, "$i" in an argument is replaced by the index of the transaction
+bytes encodeCall(eth::abi::ABIFunc const& _method, vector<string> const& _args, size_t _index)
+{
+    auto types = _method.getParamsType();
+    if (types.size() != _args.size())
+    {
+        BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment(
+                                  "the arguments don't match " + _method.getSignature()));
+    }
+    bytes head;
+    bytes tail;
+    for (size_t i = 0; i < types.size(); ++i)
+    {
+        auto arg = boost::replace_all_copy(_args[i], "$i", to_string(_index));
+        if (types[i] == "string" || types[i] == "bytes")
+        {
+            bytes data = types[i] == "string" ? asBytes(arg) : fromHex(arg);
+            head += h256(u256(32 * types.size() + tail.size())).asBytes();
+            tail += h256(u256(data.size())).asBytes();
+            data.resize((data.size() + 31) / 32 * 32);
+            tail += data;
+        }
+        else if (types[i] == "address")
+        {
+            head += h256(Address(arg), h256::AlignRight).asBytes();
+        }
+        else if (types[i] == "bool")
+        {
+            head += h256(u256(arg == "true" ? 1 : 0)).asBytes();
+        }
+        else if (boost::starts_with(types[i], "uint") || boost::starts_with(types[i], "int"))
+        {
+            head += h256(u256(s2u(s256(arg)))).asBytes();
+        }
+        else if (boost::starts_with(types[i], "bytes"))
+        {
+            head += h256(fromHex(arg), h256::AlignLeft).asBytes();
+        }
+        else
+        {
+            BOOST_THROW_EXCEPTION(
+                WrongFieldType() << errinfo_comment("unsupported type " + types[i]));
+        }
+    }
+    bytes call = sha3(_method.getSignature()).ref().cropped(0, 4).toBytes();
+    return call + head + tail;
+}
+
+/// a session on the channel port of a node, sending the transactions and waiting for their
+/// receipts
+class Client
+{
+public:
+    Client(Options const& _options) : m_options(_options) {}
+
+    ~Client()
+    {
+        if (m_session)
+        {
+            m_session->disconnectByQuit();
+        }
+        m_ioService->stop();
+        if (m_ioThread.joinable())
+        {
+            m_ioThread.join();
+        }
+    }
+
+    void connect()
+    {
+        auto context =
+            make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tlsv12);
+        context->load_verify_file(m_options.ca);
+        context->use_certificate_chain_file(m_options.cert);
+        context->use_private_key_file(m_options.key, boost::asio::ssl::context::pem);
+        context->set_verify_mode(boost::asio::ssl::verify_peer);
+
+        vector<string> endpoint;
+        boost::split(endpoint, m_options.endpoint, boost::is_any_of(":"));
+        if (endpoint.size() != 2)
+        {
+            BOOST_THROW_EXCEPTION(
+                WrongFieldType() << errinfo_comment("endpoint is ip:port, " + m_options.endpoint));
+        }
+        auto socket = make_shared<boost::asio::ssl::stream<boost::asio::ip::tcp::socket>>(
+            *m_ioService, *context);
+        socket->lowest_layer().connect(boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::address::from_string(endpoint[0]),
+            boost::lexical_cast<unsigned short>(endpoint[1])));
+        socket->handshake(boost::asio::ssl::stream_base::client);
+        m_context = context;
+
+        m_session = make_shared<ChannelSession>();
+        m_session->setThreadPool(make_shared<ThreadPool>("loadRequest", 1),
+            make_shared<ThreadPool>("loadResponse", 4));
+        m_session->setIOService(m_ioService);
+        m_session->setEnableSSL(true);
+        m_session->setMessageFactory(make_shared<ChannelMessageFactory>());
+        m_session->setSSLSocket(socket);
+        m_session->setHost(endpoint[0]);
+        m_session->setPort(boost::lexical_cast<int>(endpoint[1]));
+        m_session->setMessageHandler(
+            [this](ChannelSession::Ptr, ChannelException _e, Message::Ptr _message) {
+                if (_e.errorCode() == 0 && _message && _message->type() == c_receiptPush)
+                {
+                    onReceipt(_message);
+                }
+            });
+        m_session->run();
+        m_ioThread = thread([this]() {
+            boost::asio::io_service::work work(*m_ioService);
+            m_ioService->run();
+        });
+    }
+
+    /// the result of a JSON-RPC call, throw if the node returns an error
+    Json::Value call(string const& _method, Json::Value const& _params)
+    {
+        auto response = m_session->sendMessage(
+            newRequest(nextSeq(), _method, _params), m_options.timeout * 1000);
+        Json::Value json;
+        Json::Reader().parse(
+            string((char const*)response->data(), response->dataSize()), json);
+        if (json.isMember("error") || !json.isMember("result"))
+        {
+            BOOST_THROW_EXCEPTION(ExternalFunctionFailure() << errinfo_comment(
+                                      _method + " failed: " + Json::FastWriter().write(json)));
+        }
+        return json["result"];
+    }
+
+    /// send the transactions, at most _concurrency of them waiting for their receipts, at _rate
+    /// transactions per second if it's positive, timed into _latency
+    Json::Value send(vector<bytes> const& _txs, size_t _concurrency, double _rate,
+        shared_ptr<Histogram> _latency = nullptr)
+    {
+        {
+            lock_guard<mutex> l(x_pending);
+            m_pending.clear();
+            m_latency = _latency;
+            m_receipts = 0;
+            m_reverted = 0;
+            m_rejected = 0;
+        }
+        auto start = nowUs();
+        uint64_t sent = 0;
+        for (size_t i = 0; i < _txs.size(); ++i)
+        {
+            if (_rate > 0)
+            {
+                auto due = start + (uint64_t)(i * 1e6 / _rate);
+                auto now = nowUs();
+                if (due > now)
+                {
+                    this_thread::sleep_for(chrono::microseconds(due - now));
+                }
+            }
+            auto seq = nextSeq();
+            {
+                unique_lock<mutex> l(x_pending);
+                m_signal.wait(l, [&]() { return m_pending.size() < max(_concurrency, (size_t)1); });
+                m_pending[seq] = nowUs();
+            }
+            Json::Value params(Json::arrayValue);
+            params.append(m_options.group);
+            params.append(toHexPrefixed(_txs[i]));
+            m_session->asyncSendMessage(newRequest(seq, "sendRawTransaction", params),
+                [this, seq](ChannelException _e, Message::Ptr _response) {
+                    onResponse(seq, _e, _response);
+                },
+                m_options.timeout * 1000);
+            ++sent;
+        }
+        auto sentUs = nowUs();
+
+        unique_lock<mutex> l(x_pending);
+        m_signal.wait_for(l, chrono::microseconds((uint64_t)(m_options.timeout * 1e6)),
+            [&]() { return m_pending.empty(); });
+        auto elapsed = (max(m_lastReceipt, sentUs) - start) / 1e6;
+
+        Json::Value result;
+        result["sent"] = (Json::UInt64)sent;
+        result["receipts"] = (Json::UInt64)m_receipts;
+        result["reverted"] = (Json::UInt64)m_reverted;
+        result["rejected"] = (Json::UInt64)m_rejected;
+        result["lost"] = (Json::UInt64)m_pending.size();
+        result["sendTps"] = sent / ((sentUs - start) / 1e6);
+        result["tps"] = m_receipts / elapsed;
+        m_latency.reset();
+        return result;
+    }
+
+private:
+    Message::Ptr newRequest(string const& _seq, string const& _method, Json::Value const& _params)
+    {
+        Json::Value request;
+        request["jsonrpc"] = "2.0";
+        request["method"] = _method;
+        request["params"] = _params;
+        request["id"] = 1;
+        auto body = Json::FastWriter().write(request);
+        auto message = m_session->messageFactory()->buildMessage();
+        message->setType(c_rpcRequest);
+        message->setSeq(_seq);
+        message->setResult(0);
+        message->setData((byte const*)body.data(), body.size());
+        return message;
+    }
+
+    string nextSeq() { return toHex(h256(u256(++m_seq))).substr(32); }
+
+    /// the node rejected the transaction, e.g. for its nonce, or the session failed
+    void onResponse(string const& _seq, ChannelException _e, Message::Ptr _response)
+    {
+        Json::Value json;
+        if (_e.errorCode() == 0 && _response &&
+            Json::Reader().parse(
+                string((char const*)_response->data(), _response->dataSize()), json) &&
+            !json.isMember("error"))
+        {
+            return;
+        }
+        lock_guard<mutex> l(x_pending);
+        if (m_pending.erase(_seq))
+        {
+            ++m_rejected;
+            m_signal.notify_all();
+        }
+    }
+
+    void onReceipt(Message::Ptr _message)
+    {
+        Json::Value receipt;
+        Json::Reader().parse(
+            string((char const*)_message->data(), _message->dataSize()), receipt);
+        auto now = nowUs();
+        lock_guard<mutex> l(x_pending);
+        auto it = m_pending.find(_message->seq());
+        if (it == m_pending.end())
+        {
+            return;
+        }
+        if (m_latency)
+        {
+            m_latency->observe(now - it->second);
+        }
+        m_pending.erase(it);
+        ++m_receipts;
+        if (receipt["status"].asString() != "0x0")
+        {
+            ++m_reverted;
+        }
+        m_lastReceipt = now;
+        m_signal.notify_all();
+    }
+
+    Options const& m_options;
+    shared_ptr<boost::asio::io_service> m_ioService = make_shared<boost::asio::io_service>();
+    shared_ptr<boost::asio::ssl::context> m_context;
+    ChannelSession::Ptr m_session;
+    thread m_ioThread;
+    atomic<uint64_t> m_seq = {0};
+
+    mutex x_pending;
+    condition_variable m_signal;
+    /// the seq of the transactions waiting for their receipts and the us they were sent at
+    map<string, uint64_t> m_pending;
+    shared_ptr<Histogram> m_latency;
+    uint64_t m_receipts = 0;
+    uint64_t m_reverted = 0;
+    uint64_t m_rejected = 0;
+    uint64_t m_lastReceipt = 0;
+};
+
+/// the transactions of a workload signed on all cores
+class Workload
+{
+public:
+    Workload(Options const& _options, int64_t _blockNumber)
+      : m_options(_options),
+        m_keyPair(KeyPair::create()),
+        m_blockLimit(_blockNumber + c_blockLimitRange),
+        m_nonce(u256(utcTimeUs()) << 64),
+        m_users(max(_options.users, (size_t)2))
+    {
+        if (m_options.workload == "abi" && !m_method.parser(m_options.method))
+        {
+            BOOST_THROW_EXCEPTION(
+                WrongFieldType() << errinfo_comment("invalid method " + m_options.method));
+        }
+        if (!m_options.args.empty())
+        {
+            boost::split(m_args, m_options.args, boost::is_any_of(","));
+        }
+    }
+
+    static bool known(string const& _name)
+    {
+        return _name == "transfer" || _name == "dag" || _name == "crud" || _name == "abi";
+    }
+
+    /// the transactions committed before the timed run, e.g. the accounts of the transfers
+    vector<bytes> setUp()
+    {
+        ContractABI abi;
+        vector<bytes> txs;
+        if (m_options.workload == "dag")
+        {
+            for (size_t i = 0; i < m_users; ++i)
+            {
+                txs.push_back(signedTransaction(Address(0x5002),
+                    abi.abiIn("userSave(string,uint256)", to_string(i), u256(1000000000)),
+                    m_options.txs + i));
+            }
+        }
+        else if (m_options.workload == "crud")
+        {
+            txs.push_back(signedTransaction(Address(0x1001),
+                abi.abiIn("createTable(string,string,string)", string(c_crudTable),
+                    string("key"), string("value")),
+                m_options.txs));
+        }
+        return txs;
+    }
+
+    vector<bytes> sign()
+    {
+        vector<bytes> txs(m_options.txs);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, txs.size()),
+            [&](tbb::blocked_range<size_t> const& _range) {
+                for (size_t i = _range.begin(); i < _range.end(); ++i)
+                {
+                    txs[i] = transaction(i);
+                }
+            });
+        return txs;
+    }
+
+private:
+    bytes transaction(size_t _i)
+    {
+        ContractABI abi;
+        if (m_options.workload == "transfer")
+        {
+            return signedTransaction(right160(sha3(to_string(_i % m_users))), bytes(), _i);
+        }
+        else if (m_options.workload == "dag")
+        {
+            /// disjoint pairs of users, so that the transfers are parallel
+            auto from = to_string((2 * _i) % m_users);
+            auto to = to_string((2 * _i + 1) % m_users);
+            return signedTransaction(Address(0x5002),
+                abi.abiIn("userTransfer(string,string,uint256)", from, to, u256(1)), _i);
+        }
+        else if (m_options.workload == "crud")
+        {
+            auto key = to_string(_i);
+            return signedTransaction(Address(0x1002),
+                abi.abiIn("insert(string,string,string,string)", string(c_crudTable), key,
+                    "{\"key\":\"" + key + "\",\"value\":\"" + key + "\"}", string("")),
+                _i);
+        }
+        return signedTransaction(
+            Address(m_options.to), encodeCall(m_method, m_args, _i), _i);
+    }
+
+    bytes signedTransaction(Address const& _dest, bytes const& _data, size_t _i)
+    {
+        Transaction tx(0, 0, 100000000, _dest, _data, m_nonce + _i);
+        tx.setBlockLimit(m_blockLimit);
+        Signature sig = dev::sign(m_keyPair.secret(), tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        return tx.rlp();
+    }
+
+    Options const& m_options;
+    KeyPair m_keyPair;
+    u256 m_blockLimit;
+    u256 m_nonce;
+    size_t m_users;
+    eth::abi::ABIFunc m_method;
+    vector<string> m_args;
+};
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "a sustained load on a live chain through the channel port of a node");
+    description.add_options()("endpoint,e",
+        boost::program_options::value<string>()->default_value("127.0.0.1:20200"),
+        "the channel ip:port of the node")("ca",
+        boost::program_options::value<string>()->default_value("conf/ca.crt"),
+        "the ca of the chain")("cert",
+        boost::program_options::value<string>()->default_value("conf/sdk.crt"),
+        "the certificate of the sdk")("key",
+        boost::program_options::value<string>()->default_value("conf/sdk.key"),
+        "the key of the sdk")("group,g", boost::program_options::value<int>()->default_value(1),
+        "the group the transactions are sent to")("workload,w",
+        boost::program_options::value<string>()->default_value("transfer"),
+        "transfer, dag, crud or abi, the method given by --to, --method and --args")("txs,t",
+        boost::program_options::value<size_t>()->default_value(100000),
+        "the transactions sent")("users,u",
+        boost::program_options::value<size_t>()->default_value(10000),
+        "the users of the transfer and dag workloads")("concurrency,c",
+        boost::program_options::value<size_t>()->default_value(10000),
+        "the transactions waiting for their receipts at most")("rate,r",
+        boost::program_options::value<double>()->default_value(0),
+        "the transactions sent per second, 0 for as fast as the concurrency allows")("to",
+        boost::program_options::value<string>()->default_value(""),
+        "the contract called by the abi workload")("method",
+        boost::program_options::value<string>()->default_value(""),
+        "the signature of the method called by the abi workload, e.g. set(string,uint256)")(
+        "args", boost::program_options::value<string>()->default_value(""),
+        "the arguments of the method, comma separated, $i is replaced by the index of the "
+        "transaction")("timeout", boost::program_options::value<double>()->default_value(60),
+        "the seconds a receipt is waited for after the last transaction is sent")("output,o",
+        boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    if (vm.count("help"))
+    {
+        cout << description << endl;
+        exit(0);
+    }
+    Options options;
+    options.endpoint = vm["endpoint"].as<string>();
+    options.ca = vm["ca"].as<string>();
+    options.cert = vm["cert"].as<string>();
+    options.key = vm["key"].as<string>();
+    options.group = vm["group"].as<int>();
+    options.workload = vm["workload"].as<string>();
+    options.txs = vm["txs"].as<size_t>();
+    options.users = vm["users"].as<size_t>();
+    options.concurrency = vm["concurrency"].as<size_t>();
+    options.rate = vm["rate"].as<double>();
+    options.to = vm["to"].as<string>();
+    options.method = vm["method"].as<string>();
+    options.args = vm["args"].as<string>();
+    options.timeout = vm["timeout"].as<double>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    if (!Workload::known(options.workload))
+    {
+        cout << "unknown workload " << options.workload << endl;
+        return 1;
+    }
+    if (options.workload == "abi" && (options.to.empty() || options.method.empty()))
+    {
+        cout << "the abi workload needs --to and --method" << endl;
+        return 1;
+    }
+
+    Json::Value report;
+    try
+    {
+        Client client(options);
+        client.connect();
+        Json::Value params(Json::arrayValue);
+        params.append(options.group);
+        auto blockNumber = jsToInt(client.call("getBlockNumber", params).asString());
+
+        Workload workload(options, blockNumber);
+        auto setUp = workload.setUp();
+        if (!setUp.empty())
+        {
+            auto result = client.send(setUp, options.concurrency, 0);
+            if (result["receipts"].asUInt64() != setUp.size())
+            {
+                cout << "set up failed " << Json::FastWriter().write(result) << endl;
+                return 1;
+            }
+        }
+        auto start = nowUs();
+        auto txs = workload.sign();
+        auto signSeconds = (nowUs() - start) / 1e6;
+
+        auto latency = make_shared<Histogram>();
+        report = client.send(txs, options.concurrency, options.rate, latency);
+        auto snapshot = latency->snapshot();
+        report["p50(ms)"] = snapshot.quantile(0.5) / 1e3;
+        report["p99(ms)"] = snapshot.quantile(0.99) / 1e3;
+        report["p999(ms)"] = snapshot.quantile(0.999) / 1e3;
+        report["signSeconds"] = signSeconds;
+        report["startBlock"] = (Json::Int64)blockNumber;
+        report["endBlock"] =
+            (Json::Int64)jsToInt(client.call("getBlockNumber", params).asString());
+    }
+    catch (std::exception const& e)
+    {
+        cout << "load failed " << boost::diagnostic_information(e) << endl;
+        return 1;
+    }
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["workload"] = options.workload;
+    report["group"] = options.group;
+    report["concurrency"] = (Json::UInt64)options.concurrency;
+    report["rate"] = options.rate;
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
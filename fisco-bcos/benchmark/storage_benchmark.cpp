@@ -14,228 +14,533 @@
  * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
  * (c) 2016-2018 fisco-dev contributors.
  *
- * @file storage_main.cpp
+ * @brief: the reads, writes and commits of the storage backends with and without the cache,
+ * for a key distribution, a read ratio, a value size, the concurrency levels and the cache
+ * sizes, printed as JSON with the throughput and the latency percentiles of each run
+ *
+ * @file storage_benchmark.cpp
  * @author: xingqiangbai
  * @date 2018-11-14
  */
 #include "libinitializer/Initializer.h"
-#include "libstorage/MemoryTableFactory.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
+#include <json/json.h>
 #include <leveldb/db.h>
 #include <libdevcore/BasicLevelDB.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/Metrics.h>
 #include <libdevcore/easylog.h>
 #include <libstorage/CachedStorage.h>
-#include <libstorage/MemoryTable2.h>
-#include <libstorage/MemoryTableFactoryFactory2.h>
+#include <libstorage/LevelDBStorage2.h>
 #include <libstorage/RocksDBStorage.h>
-#include <tbb/parallel_for.h>
+#include <libstorage/SQLBasicAccess.h>
+#include <libstorage/SQLConnectionPool.h>
+#include <libstorage/SQLStorage.h>
+#include <libstorage/ZdbStorage.h>
 #include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/format.hpp>
-#include <boost/log/support/date_time.hpp>
-#include <boost/log/utility/setup/common_attributes.hpp>
-#include <boost/log/utility/setup/from_stream.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
 
 INITIALIZE_EASYLOGGINGPP
 
 using namespace std;
 using namespace dev;
-using namespace boost;
 using namespace dev::storage;
 using namespace dev::initializer;
 
-void testMemoryTable2(size_t round, size_t count, bool verify)
+namespace
 {
-    boost::filesystem::create_directories("./RocksDB");
-    rocksdb::Options options;
-    rocksdb::DB* db = nullptr;
-    options.IncreaseParallelism();
-    options.OptimizeLevelStyleCompaction();
-    options.create_if_missing = true;
-    options.max_open_files = 1000;
-    options.compression = rocksdb::kSnappyCompression;
-    rocksdb::Status status;
-
-    status = rocksdb::DB::Open(options, "./RocksDB", &db);
+const char* const c_benchTable = "bench";
+/// the keys of a commit while the table is loaded
+const size_t c_loadBatch = 10000;
+/// the skew of the zipfian distribution, as in YCSB
+const double c_zipfianTheta = 0.99;
 
-    if (!status.ok())
+struct Options
+{
+    vector<string> backends;
+    vector<string> caches;
+    vector<size_t> threads;
+    vector<size_t> cacheSizes;
+    string distribution;
+    double readRatio;
+    size_t valueSize;
+    size_t keys;
+    size_t ops;
+    size_t blockOps;
+    string path;
+    string config;
+    string topic;
+    ZDBConfig mysql;
+    string output;
+};
+
+/// a backend with the table loaded, the blocks committed to it are numbered from 1
+struct Backend
+{
+    string name;
+    Storage::Ptr storage;
+    int64_t number = 0;
+};
+
+/// the rank of a key drawn uniformly or in a zipfian distribution, the most frequent ranks
+/// hashed over the key space so that the hot keys aren't neighbours
+class KeyGenerator
+{
+public:
+    KeyGenerator(size_t _keys, bool _zipfian) : m_keys(_keys), m_zipfian(_zipfian && _keys > 2)
     {
-        throw std::runtime_error("open RocksDB failed");
+        if (!m_zipfian)
+        {
+            return;
+        }
+        for (size_t i = 1; i <= m_keys; ++i)
+        {
+            m_zetan += 1 / pow(i, c_zipfianTheta);
+        }
+        double zeta2 = 1 + 1 / pow(2, c_zipfianTheta);
+        m_alpha = 1 / (1 - c_zipfianTheta);
+        m_eta = (1 - pow(2.0 / m_keys, 1 - c_zipfianTheta)) / (1 - zeta2 / m_zetan);
     }
-    std::shared_ptr<RocksDBStorage> rocksdbStorage = std::make_shared<RocksDBStorage>();
-    std::shared_ptr<rocksdb::DB> rocksDB;
-    rocksDB.reset(db);
-
-    rocksdbStorage->setDB(rocksDB);
-
 
-    CachedStorage::Ptr cachedStorage = std::make_shared<CachedStorage>();
-    cachedStorage->setBackend(rocksdbStorage);
-    // cachedStorage->startClearThread();
-    cachedStorage->init();
-    cachedStorage->setMaxCapacity(32 * 1024 * 1024);
-    cachedStorage->setMaxForwardBlock(5);
+    size_t next(mt19937_64& _random) const
+    {
+        if (!m_zipfian)
+        {
+            return _random() % m_keys;
+        }
+        double u = uniform_real_distribution<double>(0, 1)(_random);
+        double uz = u * m_zetan;
+        size_t rank = 0;
+        if (uz >= 1 + pow(0.5, c_zipfianTheta))
+        {
+            rank = (size_t)(m_keys * pow(m_eta * u - m_eta + 1, m_alpha));
+        }
+        else if (uz >= 1)
+        {
+            rank = 1;
+        }
+        // FNV-1a of the rank
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < sizeof(rank); ++i)
+        {
+            hash = (hash ^ ((rank >> (8 * i)) & 0xff)) * 1099511628211ULL;
+        }
+        return hash % m_keys;
+    }
 
-    auto factoryFactory = std::make_shared<MemoryTableFactoryFactory2>();
-    factoryFactory->setStorage(cachedStorage);
+private:
+    size_t m_keys;
+    bool m_zipfian;
+    double m_zetan = 0;
+    double m_alpha = 0;
+    double m_eta = 0;
+};
 
-    auto createFactory = factoryFactory->newTableFactory(dev::h256(0), 0);
-    createFactory->createTable("test_data", "key", "value", 1, Address(0x0));
-    createFactory->createTable("tx_hash_2_block", "tx_hash", "block_hash", 1, Address(0x0));
+string keyOf(size_t _rank)
+{
+    char key[16];
+    snprintf(key, sizeof(key), "k%010zu", _rank);
+    return key;
+}
 
-    createFactory->commitDB(dev::h256(0), 1);
+TableInfo::Ptr benchTableInfo()
+{
+    auto tableInfo = make_shared<TableInfo>();
+    tableInfo->name = c_benchTable;
+    tableInfo->key = "key";
+    tableInfo->fields = {"value"};
+    return tableInfo;
+}
 
-    std::set<std::string> accounts;
-    for (size_t i = 0; i < count; ++i)
+Storage::Ptr newBackend(string const& _name, Options const& _options)
+{
+    auto path = _options.path + "/" + _name;
+    if (_name == "leveldb")
+    {
+        boost::filesystem::remove_all(path);
+        boost::filesystem::create_directories(path);
+        leveldb::Options options;
+        options.create_if_missing = true;
+        options.max_open_files = 1000;
+        options.compression = leveldb::kSnappyCompression;
+        dev::db::BasicLevelDB* db = nullptr;
+        auto status = dev::db::BasicLevelDB::Open(options, path, &db);
+        if (!status.ok())
+        {
+            throw runtime_error("open LevelDB failed: " + status.ToString());
+        }
+        auto storage = make_shared<LevelDBStorage2>();
+        storage->setDB(shared_ptr<dev::db::BasicLevelDB>(db));
+        return storage;
+    }
+    if (_name == "rocksdb")
+    {
+        boost::filesystem::remove_all(path);
+        boost::filesystem::create_directories(path);
+        rocksdb::Options options;
+        options.IncreaseParallelism();
+        options.OptimizeLevelStyleCompaction();
+        options.create_if_missing = true;
+        options.max_open_files = 1000;
+        options.compression = rocksdb::kSnappyCompression;
+        rocksdb::DB* db = nullptr;
+        auto status = rocksdb::DB::Open(options, path, &db);
+        if (!status.ok())
+        {
+            throw runtime_error("open RocksDB failed: " + status.ToString());
+        }
+        auto storage = make_shared<RocksDBStorage>();
+        storage->setDB(shared_ptr<rocksdb::DB>(db));
+        return storage;
+    }
+    if (_name == "mysql")
     {
-        auto dataTable = createFactory->openTable("test_data");
-        auto entry = dataTable->newEntry();
-        auto key = (boost::format("[%08d]") % i).str();
-        entry->setField("key", key);
-        entry->setField("value", "0");
-        entry->setForce(true);
+        auto mysql = _options.mysql;
+        auto storage = make_shared<ZdbStorage>();
+        auto pool = make_shared<SQLConnectionPool>();
+        pool->createDataBase(mysql);
+        pool->InitConnectionPool(mysql);
+        storage->SetSqlAccess(make_shared<SQLBasicAccess>());
+        storage->setConnPool(pool);
+        return storage;
+    }
+    if (_name == "amdb")
+    {
+        /// the channel of the node config, the amdb-proxy is reached through it
+        boost::property_tree::ptree pt;
+        boost::property_tree::read_ini(_options.config, pt);
+        initGlobalConfig(pt);
+        static auto secureInitializer = make_shared<SecureInitializer>();
+        secureInitializer->initConfig(pt);
+        static auto p2pInitializer = make_shared<P2PInitializer>();
+        p2pInitializer->setSSLContext(
+            secureInitializer->SSLContext(SecureInitializer::Usage::ForP2P));
+        p2pInitializer->setKeyPair(secureInitializer->keyPair());
+        p2pInitializer->initConfig(pt);
+        static auto rpcInitializer = make_shared<RPCInitializer>();
+        rpcInitializer->setP2PService(p2pInitializer->p2pService());
+        rpcInitializer->setSSLContext(
+            secureInitializer->SSLContext(SecureInitializer::Usage::ForRPC));
+        rpcInitializer->initChannelRPCServer(pt);
+
+        auto storage = make_shared<SQLStorage>();
+        storage->setChannelRPCServer(rpcInitializer->channelRPCServer());
+        storage->setTopic(_options.topic);
+        storage->setMaxRetry(10);
+        return storage;
+    }
+    throw runtime_error("unknown backend " + _name);
+}
 
-        dataTable->insert(key, entry);
+/// create the table and insert its keys, in blocks of c_loadBatch keys
+void load(Backend& _backend, Options const& _options)
+{
+    auto sysTable = make_shared<TableData>();
+    sysTable->info->name = SYS_TABLES;
+    sysTable->info->key = "table_name";
+    sysTable->info->fields = {"key_field", "value_field"};
+    auto tableEntry = make_shared<Entry>();
+    tableEntry->setField("table_name", c_benchTable);
+    tableEntry->setField("key_field", "key");
+    tableEntry->setField("value_field", "value");
+    sysTable->newEntries->addEntry(tableEntry);
+    _backend.storage->commit(h256(0), ++_backend.number, {sysTable});
+
+    string value(_options.valueSize, '0');
+    for (size_t begin = 0; begin < _options.keys; begin += c_loadBatch)
+    {
+        auto data = make_shared<TableData>();
+        data->info = benchTableInfo();
+        for (size_t i = begin; i < min(begin + c_loadBatch, _options.keys); ++i)
+        {
+            auto entry = make_shared<Entry>();
+            entry->setID(i + 1);
+            entry->setField("key", keyOf(i));
+            entry->setField("value", value);
+            data->newEntries->addEntry(entry);
+        }
+        _backend.storage->commit(h256(0), ++_backend.number, {data});
     }
+}
 
-    createFactory->commitDB(dev::h256(0), 1);
+uint64_t sinceUs(chrono::steady_clock::time_point const& _start)
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - _start)
+        .count();
+}
 
-    auto start = std::chrono::system_clock::now();
+Json::Value latency(Histogram const& _histogram)
+{
+    auto snapshot = _histogram.snapshot();
+    Json::Value result;
+    result["count"] = (Json::UInt64)snapshot.count;
+    result["p50(us)"] = (Json::UInt64)snapshot.quantile(0.5);
+    result["p99(us)"] = (Json::UInt64)snapshot.quantile(0.99);
+    result["p999(us)"] = (Json::UInt64)snapshot.quantile(0.999);
+    return result;
+}
 
-    for (size_t i = 0; i < round; ++i)
+/// the ops of a run in blocks of blockOps ops, the threads read and write the keys of a block
+/// concurrently and its writes are committed once they are all done
+Json::Value run(Backend& _backend, Options const& _options, KeyGenerator const& _generator,
+    bool _cached, size_t _cacheSize, size_t _threads)
+{
+    auto storage = _backend.storage;
+    shared_ptr<CachedStorage> cachedStorage;
+    if (_cached)
     {
-        auto roundStart = std::chrono::system_clock::now();
-        auto factory = factoryFactory->newTableFactory(dev::h256(0), i + 2);
+        cachedStorage = make_shared<CachedStorage>();
+        cachedStorage->setBackend(_backend.storage);
+        cachedStorage->setMaxCapacity(_cacheSize * 1024 * 1024);
+        cachedStorage->init();
+        storage = cachedStorage;
+    }
 
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
-                for (size_t j = range.begin(); j < range.end(); ++j)
+    auto tableInfo = benchTableInfo();
+    Histogram reads;
+    Histogram writes;
+    Histogram commits;
+    string value(_options.valueSize, '1');
+    auto start = chrono::steady_clock::now();
+    for (size_t done = 0; done < _options.ops; done += _options.blockOps)
+    {
+        auto number = ++_backend.number;
+        auto blockOps = min(_options.blockOps, _options.ops - done);
+        vector<map<string, Entry::Ptr>> written(_threads);
+        vector<thread> workers;
+        for (size_t t = 0; t < _threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                mt19937_64 random(number * _threads + t);
+                for (size_t i = t; i < blockOps; i += _threads)
                 {
-                    for (int k = 0; k < 50; ++k)
+                    auto key = keyOf(_generator.next(random));
+                    bool read =
+                        uniform_real_distribution<double>(0, 1)(random) < _options.readRatio;
+                    auto opStart = chrono::steady_clock::now();
+                    auto entries =
+                        storage->select(h256(0), number, tableInfo, key, make_shared<Condition>());
+                    if (read)
                     {
-                        auto dataTable = factory->openTable("test_data");
-                        auto txTable = factory->openTable("tx_hash_2_block");
-
-                        auto key = (boost::format("[%08d]") % j).str();
-                        auto condition = dataTable->newCondition();
-                        auto dataEntries = dataTable->select(key, condition);
-
-                        auto dataEntry = dataEntries->get(0);
-
-                        auto newDataEntry = dataTable->newEntry();
-                        newDataEntry->setField("value",
-                            boost::lexical_cast<std::string>(
-                                boost::lexical_cast<size_t>(dataEntry->getField("value")) + 1));
-
-                        dataTable->update(key, newDataEntry, condition);
-
-                        std::string txKey = (boost::format("[%32d]-[%32d]") % j % k).str();
-                        auto txEntry = txTable->newEntry();
-                        txEntry->setField("tx_hash", txKey);
-                        txEntry->setField("block_hash", txKey);
-                        txEntry->setForce(true);
-
-                        txTable->insert(txKey, txEntry);
+                        reads.observe(sinceUs(opStart));
+                        continue;
                     }
+                    auto entry = make_shared<Entry>();
+                    if (entries && entries->size() > 0)
+                    {
+                        entry->copyFrom(entries->get(0));
+                    }
+                    entry->setField("key", key);
+                    entry->setField("value", value);
+                    written[t][key] = entry;
+                    writes.observe(sinceUs(opStart));
                 }
             });
-
-        factory->commitDB(dev::h256(0), i + 2);
-
-        auto roundEnd = std::chrono::system_clock::now();
-        std::chrono::duration<double> roundElapsed = roundEnd - roundStart;
-        std::cout << "Round " << i << " elapsed: " << roundElapsed.count() << std::endl;
-
-        if (verify)
+        }
+        for (auto& worker : workers)
         {
-            std::cout << "Checking round " << i << " ...";
-
-            auto factory = factoryFactory->newTableFactory(dev::h256(0), round + 2);
-            tbb::parallel_for(
-                tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
-                    for (size_t j = range.begin(); j < range.end(); ++j)
-                    {
-                        auto dataTable = factory->openTable("test_data");
-                        auto txTable = factory->openTable("tx_hash_2_block");
-
-                        auto key = (boost::format("[%08d]") % j).str();
-                        auto condition = dataTable->newCondition();
-                        auto dataEntries = dataTable->select(key, condition);
-
-                        auto dataEntry = dataEntries->get(0);
-
-                        size_t value = boost::lexical_cast<size_t>(dataEntry->getField("value"));
-                        if (value != 50 * (i + 1))
-                        {
-                            std::cout << "Verify failed, value: " << value
-                                      << " != " << (i + 1) * 50;
-                        }
-                    }
-                });
+            worker.join();
+        }
 
-            std::cout << "Check round " << i << " finshed";
+        auto data = make_shared<TableData>();
+        data->info = tableInfo;
+        map<string, Entry::Ptr> merged;
+        for (auto& entries : written)
+        {
+            merged.insert(entries.begin(), entries.end());
         }
+        for (auto& keyAndEntry : merged)
+        {
+            if (keyAndEntry.second->getID() != 0)
+            {
+                data->dirtyEntries->addEntry(keyAndEntry.second);
+            }
+            else
+            {
+                data->newEntries->addEntry(keyAndEntry.second);
+            }
+        }
+        auto commitStart = chrono::steady_clock::now();
+        storage->commit(h256(0), number, {data});
+        commits.observe(sinceUs(commitStart));
+    }
+    auto seconds = sinceUs(start) / 1e6;
+    if (cachedStorage)
+    {
+        cachedStorage->stop();
     }
 
-    auto end = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
-
-    std::cout << "Execute time elapsed " << std::setiosflags(std::ios::fixed)
-              << std::setprecision(4) << elapsed.count() << std::endl;
+    Json::Value result;
+    result["backend"] = _backend.name;
+    result["cache"] = _cached;
+    result["cacheSize(MB)"] = (Json::UInt64)(_cached ? _cacheSize : 0);
+    result["threads"] = (Json::UInt64)_threads;
+    result["distribution"] = _options.distribution;
+    result["readRatio"] = _options.readRatio;
+    result["valueSize"] = (Json::UInt64)_options.valueSize;
+    result["keys"] = (Json::UInt64)_options.keys;
+    result["ops"] = (Json::UInt64)_options.ops;
+    result["seconds"] = seconds;
+    result["opsPerSecond"] = seconds > 0 ? _options.ops / seconds : 0;
+    result["read"] = latency(reads);
+    result["write"] = latency(writes);
+    result["commit"] = latency(commits);
+    return result;
 }
 
-int main(int argc, char* argv[])
+template <typename T>
+vector<T> parseList(string const& _list)
 {
-    (void)argc;
-    (void)argv;
-
-    boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string> > > > >
-        m_mru;
-    m_mru.push_back(std::make_pair("a", "b"));
-    m_mru.push_back(std::make_pair("b", "c"));
-    m_mru.push_back(std::make_pair("a", "b"));
-
-    for (auto it = m_mru.begin(); it != m_mru.end();)
+    vector<string> items;
+    boost::split(items, _list, boost::is_any_of(","));
+    vector<T> result;
+    for (auto const& item : items)
     {
-        std::cout << "item: " << it->first << ", " << it->second;
+        result.push_back(boost::lexical_cast<T>(item));
+    }
+    return result;
+}
 
-        it = m_mru.erase(it);
+Options parseOptions(int argc, const char* argv[])
+{
+    namespace po = boost::program_options;
+    po::options_description description(
+        "the reads, writes and commits of the storage backends with and without the cache");
+    description.add_options()("backends,b", po::value<string>()->default_value("leveldb,rocksdb"),
+        "the backends run, among leveldb, rocksdb, mysql and amdb")("cache,c",
+        po::value<string>()->default_value("on,off"), "with the cache on, off or both")(
+        "distribution,d", po::value<string>()->default_value("zipfian"),
+        "the distribution of the keys accessed, zipfian or uniform")("read-ratio,r",
+        po::value<double>()->default_value(0.9), "the share of the ops that are reads")(
+        "value-size,v", po::value<size_t>()->default_value(128), "the bytes of a value")(
+        "threads,t", po::value<string>()->default_value("1,4,16"), "the concurrency levels")(
+        "cache-sizes,s", po::value<string>()->default_value("256"),
+        "the megabytes of the cache of the runs with the cache")("keys,k",
+        po::value<size_t>()->default_value(100000), "the keys of the table")("ops,n",
+        po::value<size_t>()->default_value(1000000), "the reads and writes of a run")(
+        "block-ops", po::value<size_t>()->default_value(10000),
+        "the ops of a block, its writes are committed together")("path,p",
+        po::value<string>()->default_value("./storage_benchmark"),
+        "the directory of leveldb and rocksdb, cleared before the table is loaded")("config",
+        po::value<string>()->default_value("config.ini"),
+        "the node config of the channel to the amdb-proxy")("topic",
+        po::value<string>()->default_value("DB"), "the topic of the amdb-proxy")("db-ip",
+        po::value<string>()->default_value("127.0.0.1"), "the mysql host")("db-port",
+        po::value<uint32_t>()->default_value(3306), "the mysql port")("db-username",
+        po::value<string>()->default_value("root"), "the mysql user")("db-passwd",
+        po::value<string>()->default_value(""), "the mysql password")("db-name",
+        po::value<string>()->default_value("bcos_storage_benchmark"),
+        "the mysql database, it should be empty")("output,o",
+        po::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    po::variables_map vm;
+    Options options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        boost::split(options.backends, vm["backends"].as<string>(), boost::is_any_of(","));
+        boost::split(options.caches, vm["cache"].as<string>(), boost::is_any_of(","));
+        options.threads = parseList<size_t>(vm["threads"].as<string>());
+        options.cacheSizes = parseList<size_t>(vm["cache-sizes"].as<string>());
     }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.distribution = vm["distribution"].as<string>();
+    options.readRatio = vm["read-ratio"].as<double>();
+    options.valueSize = vm["value-size"].as<size_t>();
+    options.keys = max(vm["keys"].as<size_t>(), (size_t)1);
+    options.ops = vm["ops"].as<size_t>();
+    options.blockOps = max(vm["block-ops"].as<size_t>(), (size_t)1);
+    options.path = vm["path"].as<string>();
+    options.config = vm["config"].as<string>();
+    options.topic = vm["topic"].as<string>();
+    options.mysql = ZDBConfig{"mysql", vm["db-ip"].as<string>(), vm["db-port"].as<uint32_t>(),
+        vm["db-username"].as<string>(), vm["db-passwd"].as<string>(),
+        vm["db-name"].as<string>(), "utf8mb4", 15, 50};
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
 
-#if 0
-    if (argc < 3)
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    for (auto const& backend : options.backends)
     {
-        std::cout << "Usage: " << argv[0] << " [round] [count] [verify]" << std::endl;
+        if (backend != "leveldb" && backend != "rocksdb" && backend != "mysql" &&
+            backend != "amdb")
+        {
+            cout << "unknown backend " << backend << endl;
+            return 1;
+        }
+    }
+    for (auto const& cache : options.caches)
+    {
+        if (cache != "on" && cache != "off")
+        {
+            cout << "unknown cache mode " << cache << endl;
+            return 1;
+        }
+    }
+    if (options.distribution != "zipfian" && options.distribution != "uniform")
+    {
+        cout << "unknown distribution " << options.distribution << endl;
         return 1;
     }
 
-#if 1
     boost::property_tree::ptree pt;
-
-    boost::property_tree::read_ini("config.ini", pt);
-
-    /// init log
-    auto logInitializer = std::make_shared<LogInitializer>();
-    logInitializer->initLog(pt);
-#endif
-
-    size_t round = boost::lexical_cast<size_t>(argv[1]);
-    size_t count = boost::lexical_cast<size_t>(argv[2]);
-    bool verify = false;
-    if (argc > 3)
+    pt.put("log.level", "error");
+    LogInitializer log;
+    log.initLog(pt);
+
+    KeyGenerator generator(options.keys, options.distribution == "zipfian");
+    Json::Value report;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto const& name : options.backends)
     {
-        verify = boost::lexical_cast<bool>(argv[3]);
+        Backend backend;
+        backend.name = name;
+        backend.storage = newBackend(name, options);
+        load(backend, options);
+        for (auto const& cache : options.caches)
+        {
+            bool cached = cache == "on";
+            for (auto cacheSize : cached ? options.cacheSizes : vector<size_t>{0})
+            {
+                for (auto threads : options.threads)
+                {
+                    report["results"].append(run(backend, options, generator, cached,
+                        cacheSize, max(threads, (size_t)1)));
+                }
+            }
+        }
     }
 
-    testMemoryTable2(round, count, verify);
-#endif
-
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
     return 0;
 }
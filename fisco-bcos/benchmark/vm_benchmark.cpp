@@ -0,0 +1,446 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: the interpreter timed on the loops of common contracts run against an in memory host,
+ * the ns of an op and the time of each opcode category printed as JSON
+ *
+ * @file: vm_benchmark.cpp
+ */
+
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/CommonData.h>
+#include <libdevcrypto/Hash.h>
+#include <libethcore/Instruction.h>
+#include <libinterpreter/VMProfile.h>
+#include <libinterpreter/interpreter.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+struct Options
+{
+    vector<string> workloads;
+    size_t iterations;
+    size_t runs;
+    size_t sortSize;
+    bool profile;
+    string output;
+};
+
+evmc_address toEvmC(Address const& _addr)
+{
+    return reinterpret_cast<evmc_address const&>(_addr);
+}
+
+evmc_uint256be toEvmC(h256 const& _h)
+{
+    return reinterpret_cast<evmc_uint256be const&>(_h);
+}
+
+Address fromEvmC(evmc_address const& _addr)
+{
+    return reinterpret_cast<Address const&>(_addr);
+}
+
+const Address c_caller("1000000000000000000000000000000000000001");
+const int64_t c_gas = 1000000000000000;
+
+/// bytecode with the jumps to labels resolved by code()
+class Program
+{
+public:
+    Program& op(Instruction _op)
+    {
+        m_code.push_back((byte)_op);
+        return *this;
+    }
+
+    Program& push(u256 const& _value)
+    {
+        auto value = toCompactBigEndian(_value, 1);
+        m_code.push_back((byte)Instruction::PUSH1 + value.size() - 1);
+        m_code += value;
+        return *this;
+    }
+
+    Program& pushLabel(string const& _label)
+    {
+        op(Instruction::PUSH2);
+        m_fixups.emplace_back(m_code.size(), _label);
+        m_code += bytes(2);
+        return *this;
+    }
+
+    Program& label(string const& _label)
+    {
+        m_labels[_label] = m_code.size();
+        return op(Instruction::JUMPDEST);
+    }
+
+    /// decrement the counter on the top of the stack and jump to _label
+    Program& loop(string const& _label)
+    {
+        return push(1).op(Instruction::SWAP1).op(Instruction::SUB).pushLabel(_label).op(
+            Instruction::JUMP);
+    }
+
+    bytes code() const
+    {
+        auto code = m_code;
+        for (auto const& fixup : m_fixups)
+        {
+            auto target = m_labels.at(fixup.second);
+            code[fixup.first] = (byte)(target >> 8);
+            code[fixup.first + 1] = (byte)target;
+        }
+        return code;
+    }
+
+private:
+    bytes m_code;
+    map<string, size_t> m_labels;
+    vector<pair<size_t, string>> m_fixups;
+};
+
+/// the storage slot of the balance of _owner in a mapping at slot 0, as solidity lays it out
+h256 balanceSlot(Address const& _owner)
+{
+    return sha3(h256(_owner, h256::AlignRight).asBytes() + h256().asBytes());
+}
+
+/// _ops transfers of 1 from the caller to the accounts _ops to 1, the balances are a mapping
+Program erc20(size_t _ops)
+{
+    Program p;
+    p.push(_ops).label("loop");
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("end").op(Instruction::JUMPI);
+    // the slot of the caller: sha3(caller . 0)
+    p.op(Instruction::CALLER).push(0).op(Instruction::MSTORE);
+    p.push(0).push(32).op(Instruction::MSTORE);
+    p.push(64).push(0).op(Instruction::SHA3);
+    // require(balance >= 1), balance -= 1
+    p.op(Instruction::DUP1).op(Instruction::SLOAD);
+    p.push(1).op(Instruction::DUP2).op(Instruction::LT).pushLabel("fail").op(Instruction::JUMPI);
+    p.push(1).op(Instruction::SWAP1).op(Instruction::SUB);
+    p.op(Instruction::SWAP1).op(Instruction::SSTORE);
+    // the slot of the receiver: sha3(counter . 0), balance += 1
+    p.op(Instruction::DUP1).push(0).op(Instruction::MSTORE);
+    p.push(64).push(0).op(Instruction::SHA3);
+    p.op(Instruction::DUP1).op(Instruction::SLOAD).push(1).op(Instruction::ADD);
+    p.op(Instruction::SWAP1).op(Instruction::SSTORE);
+    p.loop("loop");
+    p.label("fail").push(0).op(Instruction::DUP1).op(Instruction::REVERT);
+    p.label("end").op(Instruction::STOP);
+    return p;
+}
+
+/// _ops hashes of the previous hash
+Program sha3Loop(size_t _ops)
+{
+    Program p;
+    p.push(_ops).label("loop");
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("end").op(Instruction::JUMPI);
+    p.push(32).push(0).op(Instruction::SHA3).push(0).op(Instruction::MSTORE);
+    p.loop("loop");
+    p.label("end").op(Instruction::STOP);
+    return p;
+}
+
+/// slot i += i for the _ops slots
+Program storageLoop(size_t _ops)
+{
+    Program p;
+    p.push(_ops).label("loop");
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("end").op(Instruction::JUMPI);
+    p.op(Instruction::DUP1).op(Instruction::DUP1).op(Instruction::SLOAD).op(Instruction::ADD);
+    p.op(Instruction::DUP2).op(Instruction::SSTORE);
+    p.loop("loop");
+    p.label("end").op(Instruction::STOP);
+    return p;
+}
+
+/// _ops insertion sorts of _size pseudo random words in memory
+Program sort(size_t _ops, size_t _size)
+{
+    Program p;
+    p.push(_ops).label("sort");  // [r]
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("end").op(Instruction::JUMPI);
+    // mem[k - 1] = (k * C1 + r) * C2 % P for k = size to 1
+    p.push(_size).label("fill");  // [r, k]
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("filled").op(Instruction::JUMPI);
+    p.op(Instruction::DUP2).push(u256("0x9e3779b97f4a7c15")).op(Instruction::DUP3);
+    p.op(Instruction::MUL).op(Instruction::ADD);
+    p.push(u256("0xbf58476d1ce4e5b9")).op(Instruction::MUL);
+    p.push(u256("0xffffffffffffffc5")).op(Instruction::SWAP1).op(Instruction::MOD);  // [r, k, v]
+    p.push(32).op(Instruction::DUP3).push(1).op(Instruction::SWAP1).op(Instruction::SUB);
+    p.op(Instruction::MUL).op(Instruction::MSTORE);  // [r, k]
+    p.loop("fill");
+    p.label("filled").op(Instruction::POP);
+    // for i = 1 to size - 1: key = mem[i], shift the greater words right, mem[j] = key
+    p.push(1).label("outer");  // [r, i]
+    p.push(_size).op(Instruction::DUP2).op(Instruction::LT).op(Instruction::ISZERO);
+    p.pushLabel("sorted").op(Instruction::JUMPI);
+    p.op(Instruction::DUP1).push(32).op(Instruction::MUL).op(Instruction::MLOAD);
+    p.op(Instruction::DUP2).label("inner");  // [r, i, key, j]
+    p.op(Instruction::DUP1).op(Instruction::ISZERO).pushLabel("place").op(Instruction::JUMPI);
+    p.push(32).push(1).op(Instruction::DUP3).op(Instruction::SUB).op(Instruction::MUL);
+    p.op(Instruction::MLOAD);  // [r, i, key, j, prev]
+    p.op(Instruction::DUP3).op(Instruction::DUP2).op(Instruction::GT).op(Instruction::ISZERO);
+    p.pushLabel("placePrev").op(Instruction::JUMPI);
+    p.op(Instruction::DUP2).push(32).op(Instruction::MUL).op(Instruction::MSTORE);
+    p.loop("inner");
+    p.label("placePrev").op(Instruction::POP);
+    p.label("place").push(32).op(Instruction::MUL).op(Instruction::MSTORE);  // [r, i]
+    p.push(1).op(Instruction::ADD).pushLabel("outer").op(Instruction::JUMP);
+    p.label("sorted").op(Instruction::POP);
+    p.loop("sort");
+    p.label("end").op(Instruction::STOP);
+    return p;
+}
+
+/// the state of the accounts in memory, calls out are not supported
+struct Host : evmc_context
+{
+    map<pair<Address, h256>, h256> storage;
+
+    static Host& of(evmc_context* _context) { return *static_cast<Host*>(_context); }
+
+    static int accountExists(evmc_context*, evmc_address const*) { return 1; }
+    static void getStorage(evmc_uint256be* o_result, evmc_context* _context,
+        evmc_address const* _addr, evmc_uint256be const* _key)
+    {
+        auto key = make_pair(fromEvmC(*_addr), h256(_key->bytes, h256::ConstructFromPointer));
+        auto& storage = of(_context).storage;
+        auto it = storage.find(key);
+        *o_result = toEvmC(it != storage.end() ? it->second : h256());
+    }
+    static evmc_storage_status setStorage(evmc_context* _context, evmc_address const* _addr,
+        evmc_uint256be const* _key, evmc_uint256be const* _value)
+    {
+        auto key = make_pair(fromEvmC(*_addr), h256(_key->bytes, h256::ConstructFromPointer));
+        auto& value = of(_context).storage[key];
+        bool added = !value;
+        value = h256(_value->bytes, h256::ConstructFromPointer);
+        return added ? EVMC_STORAGE_ADDED : EVMC_STORAGE_MODIFIED;
+    }
+    static void getBalance(evmc_uint256be* o_result, evmc_context*, evmc_address const*)
+    {
+        *o_result = toEvmC(h256());
+    }
+    static size_t getCodeSize(evmc_context*, evmc_address const*) { return 0; }
+    static void getCodeHash(evmc_uint256be* o_result, evmc_context*, evmc_address const*)
+    {
+        *o_result = toEvmC(h256());
+    }
+    static size_t copyCode(evmc_context*, evmc_address const*, size_t, byte*, size_t) { return 0; }
+    static void selfdestruct(evmc_context*, evmc_address const*, evmc_address const*) {}
+    static void call(evmc_result* o_result, evmc_context*, evmc_message const*)
+    {
+        *o_result = evmc_result();
+        o_result->status_code = EVMC_FAILURE;
+    }
+    static void getTxContext(evmc_tx_context* o_result, evmc_context*)
+    {
+        *o_result = evmc_tx_context();
+        o_result->tx_origin = toEvmC(c_caller);
+        o_result->block_number = 1;
+        o_result->block_gas_limit = c_gas;
+    }
+    static void getBlockHash(evmc_uint256be* o_hash, evmc_context*, int64_t)
+    {
+        *o_hash = toEvmC(h256());
+    }
+    static void emitLog(evmc_context*, evmc_address const*, uint8_t const*, size_t,
+        evmc_uint256be const[], size_t)
+    {}
+
+    Host()
+    {
+        static evmc_context_fn_table const s_fnTable = {accountExists, getStorage, setStorage,
+            getBalance, getCodeSize, getCodeHash, copyCode, selfdestruct, call, getTxContext,
+            getBlockHash, emitLog};
+        fn_table = &s_fnTable;
+    }
+};
+
+Json::Value runWorkload(string const& _name, Options const& _options)
+{
+    Program program;
+    size_t ops = _options.iterations;
+    if (_name == "erc20")
+    {
+        program = erc20(ops);
+    }
+    else if (_name == "sha3")
+    {
+        program = sha3Loop(ops);
+    }
+    else if (_name == "storage")
+    {
+        program = storageLoop(ops);
+    }
+    else
+    {
+        /// an op of sort is the sort of sortSize words
+        ops = max(ops / _options.sortSize, (size_t)1);
+        program = sort(ops, _options.sortSize);
+    }
+    auto code = program.code();
+    auto codeHash = sha3(code);
+    auto destination = right160(sha3(_name));
+
+    Host host;
+    host.storage[make_pair(destination, balanceSlot(c_caller))] = h256(u256(1) << 200);
+    evmc_message message = {toEvmC(destination), toEvmC(c_caller), toEvmC(h256()), nullptr, 0,
+        toEvmC(codeHash), toEvmC(h256()), c_gas, 0, EVMC_CALL, 0};
+    auto vm = evmc_create_interpreter();
+
+    VMProfiler::instance().reset();
+    uint64_t gas = 0;
+    uint64_t elapsed = 0;
+    Json::Value result;
+    result["workload"] = _name;
+    for (size_t i = 0; i < _options.runs; ++i)
+    {
+        auto start = chrono::steady_clock::now();
+        auto r = vm->execute(vm, &host, EVMC_CONSTANTINOPLE, &message, code.data(), code.size());
+        elapsed += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start)
+                       .count();
+        gas += c_gas - r.gas_left;
+        auto status = r.status_code;
+        if (r.release)
+        {
+            r.release(&r);
+        }
+        if (status != EVMC_SUCCESS)
+        {
+            result["error"] = "status " + to_string(status);
+            return result;
+        }
+    }
+
+    result["runs"] = (Json::UInt64)_options.runs;
+    result["opsPerRun"] = (Json::UInt64)ops;
+    result["nsPerOp"] = (double)elapsed / (_options.runs * ops);
+    result["gasPerOp"] = (double)gas / (_options.runs * ops);
+    result["mgasPerSecond"] = elapsed > 0 ? gas * 1000.0 / elapsed : 0.0;
+    if (_options.profile)
+    {
+        auto contracts = VMProfiler::instance().contracts();
+        auto const& profile = contracts[destination];
+        for (size_t i = 0; i < c_opCategories; ++i)
+        {
+            if (profile.categoryOps[i] == 0)
+            {
+                continue;
+            }
+            Json::Value category;
+            category["ops"] = (Json::UInt64)profile.categoryOps[i];
+            category["timeNs"] = (Json::UInt64)profile.categoryTime[i];
+            result["profile"][opCategoryName(static_cast<OpCategory>(i))] = category;
+        }
+    }
+    return result;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the interpreter timed on the loops of common contracts");
+    description.add_options()("workloads,w",
+        boost::program_options::value<string>()->default_value("erc20,sha3,storage,sort"),
+        "the workloads run, among erc20, sha3, storage and sort")("iterations,i",
+        boost::program_options::value<size_t>()->default_value(1000),
+        "the ops of a run, the sorts of a run are iterations / sort-size")("runs,r",
+        boost::program_options::value<size_t>()->default_value(100), "the runs of a workload")(
+        "sort-size", boost::program_options::value<size_t>()->default_value(64),
+        "the words of a sort")("profile",
+        "count the opcodes and time the opcode categories, which slows the runs down")("output,o",
+        boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    if (vm.count("help"))
+    {
+        cout << description << endl;
+        exit(0);
+    }
+    Options options;
+    boost::split(options.workloads, vm["workloads"].as<string>(), boost::is_any_of(","));
+    options.iterations = max(vm["iterations"].as<size_t>(), (size_t)1);
+    options.runs = max(vm["runs"].as<size_t>(), (size_t)1);
+    options.sortSize = max(vm["sort-size"].as<size_t>(), (size_t)2);
+    options.profile = vm.count("profile");
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    for (auto const& workload : options.workloads)
+    {
+        if (workload != "erc20" && workload != "sha3" && workload != "storage" &&
+            workload != "sort")
+        {
+            cout << "unknown workload " << workload << endl;
+            return 1;
+        }
+    }
+    VMProfiler::instance().setEnabled(options.profile);
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["profile"] = options.profile;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto const& workload : options.workloads)
+    {
+        report["results"].append(runWorkload(workload, options));
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    return 0;
+}
@@ -0,0 +1,385 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: replay the exported blocks into the storage of a group offline
+ *
+ * @file: import_main.cpp
+ */
+#include <libblockchain/BlockChainImp.h>
+#include <libblockverifier/BlockVerifier.h>
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/easylog.h>
+#include <libdevcrypto/Common.h>
+#include <libinitializer/GlobalConfigureInitializer.h>
+#include <libinitializer/Initializer.h>
+#include <libledger/DBInitializer.h>
+#include <libstorage/CachedStorage.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::initializer;
+using namespace dev::blockverifier;
+using namespace dev::blockchain;
+using namespace dev::storage;
+namespace po = boost::program_options;
+INITIALIZE_EASYLOGGINGPP
+
+/// blocks decoded ahead of the execution
+static const size_t c_maxPreparedBlocks = 64;
+
+po::options_description main_options("Main for mini-import");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of mini-import")("path,p",
+        po::value<string>()->default_value("data/group1/block"), "[block path of the group]")(
+        "type,t", po::value<string>()->default_value("RocksDB"), "[LevelDB|RocksDB]")("config,c",
+        po::value<string>()->default_value("config.ini"), "[config.ini of the node]")("files,f",
+        po::value<vector<string>>()->multitoken(), "[block file] ... [block file]")(
+        "trust", "skip the check of the consensus signatures")(
+        "batch,b", po::value<int>()->default_value(100), "[blocks merged into one backend commit]")(
+        "parallel", "execute the transactions in parallel");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    /// help information
+    if (vm.count("help") || vm.count("h") || !vm.count("files"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+
+    return vm;
+}
+
+/// a decoded block and the sealers its signatures were checked against
+struct PreparedBlock
+{
+    shared_ptr<Block> block;
+    h512s sealers;
+    bool end = false;
+};
+
+/// Blocks decoded and with their senders recovered by the reader thread, bounded to keep the
+/// reader from running far ahead of the execution.
+class PreparedQueue
+{
+public:
+    void push(PreparedBlock _block)
+    {
+        unique_lock<mutex> l(x_queue);
+        m_notFull.wait(l, [&]() { return m_queue.size() < c_maxPreparedBlocks; });
+        m_queue.push_back(std::move(_block));
+        m_notEmpty.notify_one();
+    }
+
+    PreparedBlock pop()
+    {
+        unique_lock<mutex> l(x_queue);
+        m_notEmpty.wait(l, [&]() { return !m_queue.empty(); });
+        PreparedBlock block = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_notFull.notify_one();
+        return block;
+    }
+
+private:
+    mutex x_queue;
+    condition_variable m_notFull;
+    condition_variable m_notEmpty;
+    deque<PreparedBlock> m_queue;
+};
+
+/// the block is signed by a quorum of the sealers
+static bool checkSigList(Block const& _block, h512s const& _sealers)
+{
+    if (_sealers.empty())
+    {
+        return false;
+    }
+    size_t quorum = _sealers.size() - (_sealers.size() - 1) / 3;
+    if (_block.sigList().size() < quorum)
+    {
+        return false;
+    }
+    for (auto const& sig : _block.sigList())
+    {
+        if (sig.first >= _sealers.size())
+        {
+            return false;
+        }
+        Public pub = jsToPublic(toJS(_sealers[sig.first.convert_to<size_t>()].hex()));
+        if (!dev::verify(pub, sig.second, _block.header().hash()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// walk the block RLPs concatenated in the file until _onBlock returns false, the file is mapped
+/// instead of read so that the blocks are decoded straight from the page cache
+static bool readBlockFile(string const& _file, std::function<bool(bytesConstRef)> const& _onBlock)
+{
+    int fd = open(_file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        cout << "open " << _file << " failed" << endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return st.st_size == 0;
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        cout << "mmap " << _file << " failed" << endl;
+        return false;
+    }
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    bool ret = true;
+    bytesConstRef data((byte const*)addr, st.st_size);
+    try
+    {
+        while (!data.empty())
+        {
+            RLP rlp(data, RLP::ThrowOnFail | RLP::FailIfTooSmall);
+            size_t size = rlp.actualSize();
+            if (!_onBlock(data.cropped(0, size)))
+            {
+                break;
+            }
+            data = data.cropped(size);
+        }
+    }
+    catch (std::exception& e)
+    {
+        cout << "invalid block in " << _file << ": " << boost::diagnostic_information(e) << endl;
+        ret = false;
+    }
+    munmap(addr, st.st_size);
+    return ret;
+}
+
+int main(int argc, const char* argv[])
+{
+    po::variables_map vm = initCommandLine(argc, argv);
+    bool trust = vm.count("trust");
+
+    boost::property_tree::ptree pt;
+    try
+    {
+        boost::property_tree::read_ini(vm["config"].as<string>(), pt);
+        initGlobalConfig(pt);
+    }
+    catch (std::exception& e)
+    {
+        cout << "load " << vm["config"].as<string>()
+             << " failed: " << boost::diagnostic_information(e) << endl;
+        return 1;
+    }
+    LogInitializer log;
+    log.initLog(pt);
+
+    std::shared_ptr<LedgerParamInterface> params = std::make_shared<LedgerParam>();
+    auto& storageParam = params->mutableStorageParam();
+    storageParam.type = vm["type"].as<string>();
+    storageParam.path = vm["path"].as<string>();
+    storageParam.maxCapacity = 256;
+    /// the blocks are merged into large write batches of the backend, no block is read back
+    /// from the backend before it's committed so they can run far ahead of it
+    storageParam.maxMergeBlock = vm["batch"].as<int>();
+    storageParam.maxForwardBlock = storageParam.maxMergeBlock * 2;
+    storageParam.maxForwardCapacity = 0;
+    storageParam.cacheShards = 0;
+    storageParam.cachePolicy = "clock";
+    storageParam.columnFamily = false;
+    storageParam.cacheAdmission = true;
+    storageParam.blockTableCapacity = 0;
+    storageParam.wal = false;
+    storageParam.stats = false;
+    storageParam.slowThreshold = 0;
+    params->mutableStateParam().type = "storage";
+
+    auto dbInitializer = std::make_shared<dev::ledger::DBInitializer>(params);
+    dbInitializer->initStorageDB();
+    std::shared_ptr<BlockChainImp> blockChain = std::make_shared<BlockChainImp>();
+    blockChain->setStateStorage(dbInitializer->storage());
+    blockChain->setTableFactoryFactory(dbInitializer->tableFactoryFactory());
+
+    /// the genesis block isn't exported, it's built by starting the node once
+    auto genesis = blockChain->getBlockByNumber(0);
+    if (!genesis)
+    {
+        cout << "no genesis block in " << storageParam.path
+             << ", start the node of the group once to build it" << endl;
+        return 1;
+    }
+    dbInitializer->initState(genesis->headerHash());
+
+    std::shared_ptr<BlockVerifier> blockVerifier =
+        std::make_shared<BlockVerifier>(vm.count("parallel"));
+    blockVerifier->setExecutiveContextFactory(dbInitializer->executiveContextFactory());
+    blockVerifier->setNumberHash(boost::bind(&BlockChainImp::numberHash, blockChain, _1));
+
+    auto parentBlock = blockChain->getBlockByNumber(blockChain->number());
+    BlockInfo parentBlockInfo = {parentBlock->header().hash(), parentBlock->header().number(),
+        parentBlock->header().stateRoot()};
+    int64_t startNumber = parentBlockInfo.number;
+    cout << "import from block " << startNumber + 1 << endl;
+
+    /// the reader decodes the next blocks and recovers their senders while a block is executed,
+    /// and the backend writes the merged blocks behind both of them
+    PreparedQueue queue;
+    bool readOK = true;
+    std::atomic<bool> importOK = {true};
+    std::thread reader([&]() {
+        h512s sealers = blockChain->sealerList();
+        for (auto const& file : vm["files"].as<vector<string>>())
+        {
+            readOK = readBlockFile(file, [&](bytesConstRef _data) {
+                auto block = make_shared<Block>(_data, CheckTransaction::None, false);
+                if (block->header().number() <= startNumber)
+                {
+                    return true;
+                }
+                block->recoverSenders();
+                /// the sealers may change with the blocks executed meanwhile, the block is
+                /// checked again if they have when it's executed
+                if (!trust && !checkSigList(*block, sealers))
+                {
+                    sealers = blockChain->sealerList();
+                }
+                queue.push(PreparedBlock{block, sealers, false});
+                return importOK.load();
+            });
+            if (!readOK || !importOK)
+            {
+                break;
+            }
+        }
+        queue.push(PreparedBlock{nullptr, h512s(), true});
+    });
+
+    auto start = chrono::steady_clock::now();
+    size_t imported = 0;
+    size_t txs = 0;
+    while (true)
+    {
+        PreparedBlock prepared = queue.pop();
+        if (prepared.end)
+        {
+            break;
+        }
+        if (!importOK)
+        {
+            continue;
+        }
+        Block& block = *prepared.block;
+        if (block.header().number() != parentBlockInfo.number + 1 ||
+            block.header().parentHash() != parentBlockInfo.hash)
+        {
+            cout << "block " << block.header().number() << " doesn't link to block "
+                 << parentBlockInfo.number << endl;
+            importOK = false;
+            continue;
+        }
+        if (!trust)
+        {
+            h512s sealers = blockChain->sealerList();
+            if (!checkSigList(block, sealers == prepared.sealers ? prepared.sealers : sealers))
+            {
+                cout << "block " << block.header().number() << " isn't signed by the sealers"
+                     << endl;
+                importOK = false;
+                continue;
+            }
+        }
+        try
+        {
+            auto exeCtx = blockVerifier->executeBlock(block, parentBlockInfo);
+            if (blockChain->commitBlock(block, exeCtx) != CommitResult::OK)
+            {
+                cout << "commit block " << block.header().number() << " failed" << endl;
+                importOK = false;
+                continue;
+            }
+        }
+        catch (std::exception& e)
+        {
+            cout << "execute block " << block.header().number()
+                 << " failed: " << boost::diagnostic_information(e) << endl;
+            importOK = false;
+            continue;
+        }
+        parentBlockInfo = {
+            block.header().hash(), block.header().number(), block.header().stateRoot()};
+        ++imported;
+        txs += block.transactions().size();
+        if (imported % 1000 == 0)
+        {
+            auto elapsed =
+                chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+            cout << "imported " << imported << " blocks, " << txs << " txs, now block "
+                 << parentBlockInfo.number << ", " << txs * 1000 / (elapsed.count() + 1)
+                 << " tx/s" << endl;
+        }
+    }
+    reader.join();
+
+    /// the merged blocks still waiting for the backend are written before it's stopped
+    auto cachedStorage = std::dynamic_pointer_cast<CachedStorage>(dbInitializer->storage());
+    if (cachedStorage)
+    {
+        while (cachedStorage->syncNum() < parentBlockInfo.number)
+        {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+    }
+    dbInitializer->storage()->stop();
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    cout << "imported " << imported << " blocks, " << txs << " txs in " << elapsed.count()
+         << " ms, the block number is " << parentBlockInfo.number << endl;
+    return (readOK && importOK) ? 0 : 1;
+}
@@ -14,46 +14,377 @@
  * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
  * (c) 2016-2018 fisco-dev contributors.
  *
- * @brief: empty framework for main of FISCO-BCOS
+ * @brief: the throughput and the round trip latency of the p2p network between the nodes of a
+ * chain. Every node echoes the messages it receives, the nodes given a rate also send them by
+ * unicast, multicast or broadcast through Service and print the results as JSON
  *
  * @file: p2p_main.cpp
  * @author: yujiechen
  * @date 2018-09-10
  */
 
+#include <include/BuildInfo.h>
+#include <json/json.h>
+#include <libdevcore/Metrics.h>
 #include <libdevcore/easylog.h>
+#include <libethcore/Protocol.h>
+#include <libinitializer/GlobalConfigureInitializer.h>
 #include <libinitializer/Initializer.h>
 #include <libinitializer/P2PInitializer.h>
-#include <stdlib.h>
+#include <libp2p/Service.h>
+#include <sys/resource.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
 
 INITIALIZE_EASYLOGGINGPP
 
 using namespace std;
 using namespace dev;
+using namespace dev::p2p;
 using namespace dev::initializer;
 
-int main()
+namespace
 {
-    auto initialize = std::make_shared<Initializer>();
-    initialize->init("./config.ini");
+/// the modules of the messages sent and echoed, unused by the nodes
+const MODULE_ID c_pingModule = 0x70;
+const MODULE_ID c_pongModule = 0x71;
+/// a message starts with the us it was sent at
+const size_t c_headerSize = sizeof(uint64_t);
 
-    auto p2pInitializer = initialize->p2pInitializer();
-    auto p2pService = p2pInitializer->p2pService();
-    /// p2pService->setMessageFactory(std::make_shared<P2PMessageFactory>());
+struct Options
+{
+    string config;
+    string tls;
+    vector<size_t> sizes;
+    size_t rate;
+    string pattern;
+    size_t fanout;
+    unsigned duration;
+    size_t peers;
+    GROUP_ID group;
+    string output;
+};
+
+uint64_t nowUs()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// the cpu seconds of the process, both user and system
+double cpuSeconds()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+           usage.ru_stime.tv_usec / 1e6;
+}
+
+class Bench
+{
+public:
+    Bench(shared_ptr<Service> _service, GROUP_ID _group)
+      : m_service(_service),
+        m_ping(eth::getGroupProtoclID(_group, c_pingModule)),
+        m_pong(eth::getGroupProtoclID(_group, c_pongModule))
+    {
+        m_service->registerHandlerByProtoclID(m_ping,
+            [this](network::NetworkException _e, shared_ptr<P2PSession> _session,
+                P2PMessage::Ptr _message) { onPing(_e, _session, _message); });
+        m_service->registerHandlerByProtoclID(m_pong,
+            [this](network::NetworkException _e, shared_ptr<P2PSession>,
+                P2PMessage::Ptr _message) { onPong(_e, _message); });
+    }
+
+    NodeIDs peers()
+    {
+        NodeIDs peers;
+        for (auto const& info : m_service->sessionInfos())
+        {
+            peers.push_back(info.nodeInfo.nodeID);
+        }
+        return peers;
+    }
+
+    Json::Value run(Options const& _options, size_t _size);
 
-    uint32_t counter = 0;
-    while (true)
+private:
+    P2PMessage::Ptr newMessage(PROTOCOL_ID _protocol, size_t _size, uint64_t _sent)
     {
-        std::shared_ptr<std::vector<std::string>> p_topics =
-            std::shared_ptr<std::vector<std::string>>();
-        std::string topic = "Topic" + to_string(counter++);
-        p_topics->push_back(topic);
-        P2PMSG_LOG(TRACE) << "Add topic periodically, now Topics[" << p_topics->size() - 1
-                          << "]:" << topic;
-        p2pService->setTopics(p_topics);
-        LogInitializer::logRotateByTime();
-        this_thread::sleep_for(chrono::milliseconds((rand() % 50) * 100));
+        auto buffer = make_shared<bytes>(max(_size, c_headerSize));
+        memcpy(buffer->data(), &_sent, c_headerSize);
+        auto message = dynamic_pointer_cast<P2PMessage>(
+            m_service->p2pMessageFactory()->buildMessage());
+        message->setBuffer(buffer);
+        message->setProtocolID(_protocol);
+        message->setPacketType(0);
+        return message;
     }
 
+    /// send back the time of the message, so that the sender measures the round trip on its
+    /// own clock
+    void onPing(network::NetworkException _e, shared_ptr<P2PSession> _session,
+        P2PMessage::Ptr _message)
+    {
+        if (_e.errorCode() || _message->buffer()->size() < c_headerSize)
+        {
+            return;
+        }
+        m_receivedBytes += _message->buffer()->size();
+        uint64_t sent;
+        memcpy(&sent, _message->buffer()->data(), c_headerSize);
+        m_service->asyncSendMessageByNodeID(_session->nodeID(),
+            newMessage(m_pong, c_headerSize, sent), CallbackFuncWithSession(),
+            network::Options());
+    }
+
+    void onPong(network::NetworkException _e, P2PMessage::Ptr _message)
+    {
+        if (_e.errorCode() || _message->buffer()->size() < c_headerSize)
+        {
+            return;
+        }
+        m_receivedBytes += _message->buffer()->size();
+        uint64_t sent;
+        memcpy(&sent, _message->buffer()->data(), c_headerSize);
+        if (sent < m_runStart)
+        {
+            return;  // a late echo of the previous run
+        }
+        atomic_load(&m_rtt)->observe(nowUs() - sent);
+        ++m_echoes;
+    }
+
+    shared_ptr<Service> m_service;
+    PROTOCOL_ID m_ping;
+    PROTOCOL_ID m_pong;
+    atomic<uint64_t> m_runStart = {0};
+    atomic<uint64_t> m_echoes = {0};
+    atomic<uint64_t> m_receivedBytes = {0};
+    shared_ptr<Histogram> m_rtt = make_shared<Histogram>();
+};
+
+Json::Value Bench::run(Options const& _options, size_t _size)
+{
+    Json::Value result;
+    result["size"] = (Json::UInt64)_size;
+    auto peers = this->peers();
+    if (peers.empty())
+    {
+        result["error"] = "no peer connected";
+        return result;
+    }
+    auto rtt = make_shared<Histogram>();
+    atomic_store(&m_rtt, rtt);
+    m_echoes = 0;
+    m_receivedBytes = 0;
+    m_runStart = nowUs();
+
+    auto cpuStart = cpuSeconds();
+    auto interval = 1e6 / _options.rate;
+    uint64_t messages = 0;
+    uint64_t deliveries = 0;
+    size_t next = 0;
+    auto fanout = _options.fanout == 0 ? peers.size() : min(_options.fanout, peers.size());
+    auto end = m_runStart + _options.duration * 1000000ull;
+    for (auto now = nowUs(); now < end; now = nowUs())
+    {
+        /// send at a fixed rate, catching up after a slow send
+        auto due = m_runStart + (uint64_t)(messages * interval);
+        if (due > now)
+        {
+            this_thread::sleep_for(chrono::microseconds(due - now));
+            continue;
+        }
+        auto message = newMessage(m_ping, _size, nowUs());
+        if (_options.pattern == "unicast")
+        {
+            m_service->asyncSendMessageByNodeID(peers[next++ % peers.size()], message,
+                CallbackFuncWithSession(), network::Options());
+            deliveries += 1;
+        }
+        else if (_options.pattern == "multicast")
+        {
+            NodeIDs targets;
+            for (size_t i = 0; i < fanout; ++i)
+            {
+                targets.push_back(peers[next++ % peers.size()]);
+            }
+            m_service->asyncMulticastMessageByNodeIDList(targets, message);
+            deliveries += targets.size();
+        }
+        else
+        {
+            m_service->asyncBroadcastMessage(message, network::Options());
+            deliveries += peers.size();
+        }
+        ++messages;
+    }
+    auto elapsed = (nowUs() - m_runStart) / 1e6;
+    /// the echoes of the last messages
+    this_thread::sleep_for(chrono::seconds(1));
+    auto cpu = cpuSeconds() - cpuStart;
+
+    auto sentBytes = deliveries * max(_size, c_headerSize);
+    auto mb = (sentBytes + m_receivedBytes) / 1e6;
+    auto snapshot = rtt->snapshot();
+    result["peers"] = (Json::UInt64)peers.size();
+    result["messages"] = (Json::UInt64)messages;
+    result["deliveries"] = (Json::UInt64)deliveries;
+    result["echoes"] = (Json::UInt64)m_echoes.load();
+    result["lost"] = (Json::UInt64)(deliveries - min<uint64_t>(deliveries, m_echoes));
+    result["msgPerSecond"] = deliveries / elapsed;
+    result["MBPerSecond"] = sentBytes / 1e6 / elapsed;
+    result["rttP50(us)"] = (Json::UInt64)snapshot.quantile(0.5);
+    result["rttP99(us)"] = (Json::UInt64)snapshot.quantile(0.99);
+    result["rttP999(us)"] = (Json::UInt64)snapshot.quantile(0.999);
+    result["cpuSeconds"] = cpu;
+    result["cpuMsPerMB"] = mb > 0 ? cpu * 1000 / mb : 0;
+    return result;
+}
+
+Options parseOptions(int argc, const char* argv[])
+{
+    boost::program_options::options_description description(
+        "the throughput and the round trip latency of the p2p network, every node echoes the "
+        "messages, the nodes with a rate send them");
+    description.add_options()("config,c",
+        boost::program_options::value<string>()->default_value("./config.ini"),
+        "the config of the node, its p2p section and certificates are used")("tls",
+        boost::program_options::value<string>()->default_value("standard"),
+        "standard or gm, must match the build")("size,s",
+        boost::program_options::value<string>()->default_value("1024"),
+        "bytes of a message, comma separated for a run of each")("rate,r",
+        boost::program_options::value<size_t>()->default_value(0),
+        "messages sent per second, 0 to only echo")("pattern,p",
+        boost::program_options::value<string>()->default_value("unicast"),
+        "unicast to a peer after another, multicast to fanout peers or broadcast to all")(
+        "fanout,f", boost::program_options::value<size_t>()->default_value(0),
+        "the peers of a multicast, 0 for all")("duration,d",
+        boost::program_options::value<unsigned>()->default_value(30), "seconds of each run")(
+        "peers", boost::program_options::value<size_t>()->default_value(1),
+        "the peers connected before sending")("group,g",
+        boost::program_options::value<int>()->default_value(1),
+        "the group of the protocol the messages are sent on")("output,o",
+        boost::program_options::value<string>()->default_value(""),
+        "the file the results are written to, stdout if empty")("help,h", "help");
+
+    boost::program_options::variables_map vm;
+    Options options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, description), vm);
+        if (vm.count("help"))
+        {
+            cout << description << endl;
+            exit(0);
+        }
+        vector<string> sizes;
+        boost::split(sizes, vm["size"].as<string>(), boost::is_any_of(","));
+        for (auto const& size : sizes)
+        {
+            options.sizes.push_back(boost::lexical_cast<size_t>(size));
+        }
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        exit(1);
+    }
+    options.config = vm["config"].as<string>();
+    options.tls = vm["tls"].as<string>();
+    options.rate = vm["rate"].as<size_t>();
+    options.pattern = vm["pattern"].as<string>();
+    options.fanout = vm["fanout"].as<size_t>();
+    options.duration = vm["duration"].as<unsigned>();
+    options.peers = max(vm["peers"].as<size_t>(), (size_t)1);
+    options.group = vm["group"].as<int>();
+    options.output = vm["output"].as<string>();
+    return options;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto options = parseOptions(argc, argv);
+    if (options.pattern != "unicast" && options.pattern != "multicast" &&
+        options.pattern != "broadcast")
+    {
+        cout << "unknown pattern " << options.pattern << endl;
+        return 1;
+    }
+#ifdef FISCO_GM
+    string tls = "gm";
+#else
+    string tls = "standard";
+#endif
+    if (options.tls != tls)
+    {
+        cout << "the tls of this build is " << tls << endl;
+        return 1;
+    }
+
+    /// only the p2p part of the node is started
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_ini(options.config, pt);
+    LogInitializer log;
+    log.initLog(pt);
+    initGlobalConfig(pt);
+    KeyCenterInitializer::init();
+    auto secureInitializer = make_shared<SecureInitializer>();
+    secureInitializer->initConfig(pt);
+    auto p2pInitializer = make_shared<P2PInitializer>();
+    p2pInitializer->setSSLContext(
+        secureInitializer->SSLContext(SecureInitializer::Usage::ForP2P));
+    p2pInitializer->setKeyPair(secureInitializer->keyPair());
+    p2pInitializer->initConfig(pt);
+    Bench bench(p2pInitializer->p2pService(), options.group);
+
+    if (options.rate == 0)
+    {
+        cout << "echoing the messages of group " << options.group << endl;
+        while (true)
+        {
+            this_thread::sleep_for(chrono::seconds(1));
+        }
+    }
+
+    while (bench.peers().size() < options.peers)
+    {
+        cout << "waiting for " << options.peers << " peers, connected "
+             << bench.peers().size() << endl;
+        this_thread::sleep_for(chrono::seconds(1));
+    }
+
+    Json::Value report;
+    report["version"] = FISCO_BCOS_PROJECT_VERSION;
+    report["commit"] = DEV_QUOTED(FISCO_BCOS_COMMIT_HASH);
+    report["tls"] = tls;
+    report["pattern"] = options.pattern;
+    report["fanout"] = (Json::UInt64)options.fanout;
+    report["rate"] = (Json::UInt64)options.rate;
+    report["duration"] = options.duration;
+    report["results"] = Json::Value(Json::arrayValue);
+    for (auto size : options.sizes)
+    {
+        report["results"].append(bench.run(options, size));
+    }
+
+    auto text = Json::StyledWriter().write(report);
+    if (options.output.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream(options.output) << text;
+    }
+    p2pInitializer->stop();
     return 0;
 }
@@ -75,6 +75,15 @@ class session : public std::enable_shared_from_this<session>
         m_mapRpc.insert(
             std::make_pair("getSyncStatus", std::bind(&dev::rpc::RpcFace::getSyncStatusI, m_rpcFace,
                                                 std::placeholders::_1, std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair(
+            "getStorageStats", std::bind(&dev::rpc::RpcFace::getStorageStatsI, m_rpcFace,
+                                   std::placeholders::_1, std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair(
+            "getGroupResources", std::bind(&dev::rpc::RpcFace::getGroupResourcesI, m_rpcFace,
+                                     std::placeholders::_1, std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair(
+            "getCompressStats", std::bind(&dev::rpc::RpcFace::getCompressStatsI, m_rpcFace,
+                                    std::placeholders::_1, std::placeholders::_2)));
         m_mapRpc.insert(std::make_pair(
             "getClientVersion", std::bind(&dev::rpc::RpcFace::getClientVersionI, m_rpcFace,
                                     std::placeholders::_1, std::placeholders::_2)));
@@ -122,6 +131,15 @@ class session : public std::enable_shared_from_this<session>
         m_mapRpc.insert(std::make_pair(
             "sendRawTransaction", std::bind(&dev::rpc::RpcFace::sendRawTransactionI, m_rpcFace,
                                       std::placeholders::_1, std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair(
+            "sendRawTransactions", std::bind(&dev::rpc::RpcFace::sendRawTransactionsI, m_rpcFace,
+                                       std::placeholders::_1, std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair("getLogs", std::bind(&dev::rpc::RpcFace::getLogsI,
+                                                      m_rpcFace, std::placeholders::_1,
+                                                      std::placeholders::_2)));
+        m_mapRpc.insert(std::make_pair("getPendingTransactionsPage",
+            std::bind(&dev::rpc::RpcFace::getPendingTransactionsPageI, m_rpcFace,
+                std::placeholders::_1, std::placeholders::_2)));
     }
 
 public:
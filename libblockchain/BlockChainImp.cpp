@@ -23,19 +23,25 @@
 
 #include "BlockChainImp.h"
 #include <libblockverifier/ExecutiveContext.h>
+#include <libdevcore/Allocator.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
 #include <libethcore/CommonJS.h>
 #include <libethcore/Transaction.h>
 #include <libprecompiled/ConsensusPrecompiled.h>
+#include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/StateDiff.h>
 #include <libstorage/StorageException.h>
 #include <libstorage/Table.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/lexical_cast.hpp>
 #include <csignal>
+#include <iomanip>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,50 +57,136 @@ using namespace dev::precompiled;
 
 using boost::lexical_cast;
 
-std::shared_ptr<Block> BlockCache::add(Block const& _block)
+namespace
 {
-    {
-        WriteGuard guard(m_sharedMutex);
-        if (m_blockCache.size() > c_blockCacheSize)
-        {
-            BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[add]Block cache full, start to remove old item...");
-            auto firstHash = m_blockCacheFIFO.front();
-            m_blockCacheFIFO.pop_front();
-            m_blockCache.erase(firstHash);
-            // in case something unexcept error
-            if (m_blockCache.size() > c_blockCacheSize)
-            {
-                // meet error, cache and cacheFIFO not sync, clear the cache
-                m_blockCache.clear();
-                m_blockCacheFIFO.clear();
-            }
-        }
+/// the key of the first indexed block in the log index table, outside the range of the log keys
+const std::string c_logIndexStartKey = "start";
 
-        auto blockHash = _block.blockHeader().hash();
-        auto block = std::make_shared<Block>(std::move(_block));
-        m_blockCache.insert(std::make_pair(blockHash, block));
-        // add hashindex to the blockCache queue, use to remove first element when the cache is full
-        m_blockCacheFIFO.push_back(blockHash);
+/// the bytes of a value of the block tables, raw on the chains of 2.3.0 on and hex before
+std::string encodeBlockField(bytesConstRef _data)
+{
+    if (g_BCOSConfig.version() >= V2_3_0)
+    {
+        return std::string((char const*)_data.data(), _data.size());
+    }
+    return toHexPrefixed(_data);
+}
 
-        return block;
+bytes decodeBlockField(std::string const& _value)
+{
+    if (g_BCOSConfig.version() >= V2_3_0)
+    {
+        return bytes(_value.begin(), _value.end());
     }
+    return fromHex(_value);
 }
 
-std::pair<std::shared_ptr<Block>, h256> BlockCache::get(h256 const& _hash)
+/// the hex of a block number, of a fixed width so that the keys of a table sort by the number
+std::string blockKey(int64_t _number)
 {
+    std::stringstream ss;
+    ss << std::setw(16) << std::setfill('0') << std::hex << _number;
+    return ss.str();
+}
+
+/// the log index keeps the logs of a block by their addresses and first topics
+std::string logKey(Address const& _address, h256 const& _topic0)
+{
+    return _address.hex() + _topic0.hex();
+}
+
+TableInfo::Ptr sysTableInfo(std::string const& _name, std::string const& _key)
+{
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = _name;
+    tableInfo->key = _key;
+    tableInfo->fields = std::vector<std::string>{SYS_VALUE};
+    return tableInfo;
+}
+}  // namespace
+
+std::shared_ptr<Block> BlockCache::add(Block const& _block, std::shared_ptr<bytes> _rlp)
+{
+    Entry entry{std::make_shared<Block>(_block), _rlp};
+    // kept by the cached block, which is served encoded as long as it's cached
+    if (!_rlp)
+    {
+        _rlp = entry.rlp = entry.block->rlpP();
+    }
+    else
     {
-        ReadGuard guard(m_sharedMutex);
+        entry.block->keepEncoded(_rlp);
+    }
+    auto blockHash = _block.blockHeader().hash();
+    size_t blockBytes = 2 * _rlp->size();
+    // on huge pages if the caches use them, a large block stays cached long
+    adviseHugePages(_rlp->data(), _rlp->size());
 
-        auto it = m_blockCache.find(_hash);
-        if (it == m_blockCache.end())
+    WriteGuard guard(m_sharedMutex);
+    if (m_blocks.count(blockHash))
+    {
+        return m_blocks[blockHash].block;
+    }
+    while (!m_fifo.empty() && m_bytes + blockBytes > m_maxBytes)
+    {
+        auto it = m_blocks.find(m_fifo.front());
+        m_fifo.pop_front();
+        if (it == m_blocks.end())
+        {
+            continue;
+        }
+        auto number = it->second.block->blockHeader().number();
+        auto numberIt = m_numberHash.find(number);
+        if (numberIt != m_numberHash.end() && numberIt->second == it->first)
         {
-            return std::make_pair(nullptr, h256(0));
+            m_numberHash.erase(numberIt);
         }
+        m_bytes -= 2 * it->second.rlp->size();
+        m_blocks.erase(it);
+    }
+    m_blocks[blockHash] = entry;
+    m_numberHash[_block.blockHeader().number()] = blockHash;
+    m_fifo.push_back(blockHash);
+    m_bytes += blockBytes;
+    return entry.block;
+}
+
+BlockCache::Entry BlockCache::get(h256 const& _hash) const
+{
+    ReadGuard guard(m_sharedMutex);
+    auto it = m_blocks.find(_hash);
+    return count(it == m_blocks.end() ? Entry() : it->second);
+}
 
-        return std::make_pair(it->second, _hash);
+BlockCache::Entry BlockCache::get(int64_t _number) const
+{
+    ReadGuard guard(m_sharedMutex);
+    auto numberIt = m_numberHash.find(_number);
+    if (numberIt == m_numberHash.end())
+    {
+        return count(Entry());
     }
+    auto it = m_blocks.find(numberIt->second);
+    return count(it == m_blocks.end() ? Entry() : it->second);
+}
+
+size_t BlockCache::cachedBytes() const
+{
+    ReadGuard guard(m_sharedMutex);
+    return m_bytes;
+}
 
-    return std::make_pair(nullptr, h256(0));  // just make compiler happy
+BlockCache::Entry BlockCache::count(Entry _entry) const
+{
+    if (_entry.block)
+    {
+        ++m_hits;
+    }
+    else
+    {
+        ++m_misses;
+    }
+    return _entry;
 }
 
 void BlockChainImp::setStateStorage(Storage::Ptr stateStorage)
@@ -126,6 +218,19 @@ std::shared_ptr<Block> BlockChainImp::getBlock(int64_t _i)
     {
         return nullptr;
     }
+    auto cachedBlock = m_blockCache.get(_i);
+    if (cachedBlock.block)
+    {
+        return cachedBlock.block;
+    }
+    if (m_blockStore)
+    {
+        auto blockRLP = m_blockStore->get(_i);
+        if (blockRLP)
+        {
+            return m_blockCache.add(Block(blockRLP, CheckTransaction::None), blockRLP);
+        }
+    }
     string blockHash = "";
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_NUMBER_2_HASH);
     if (tb)
@@ -155,13 +260,21 @@ std::shared_ptr<Block> BlockChainImp::getBlock(dev::h256 const& _blockHash)
     auto getCache_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
-    if (bool(cachedBlock.first))
+    if (cachedBlock.block)
     {
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlock]Cache hit, read from cache");
-        return cachedBlock.first;
+        return cachedBlock.block;
     }
     else
     {
+        if (m_blockStore)
+        {
+            auto blockRLP = m_blockStore->get(_blockHash);
+            if (blockRLP)
+            {
+                return m_blockCache.add(Block(blockRLP, CheckTransaction::None), blockRLP);
+            }
+        }
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlock]Cache missed, read from storage");
         string strBlock = "";
         Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_HASH_2_BLOCK);
@@ -179,12 +292,13 @@ std::shared_ptr<Block> BlockChainImp::getBlock(dev::h256 const& _blockHash)
                 auto getField_time_cost = utcTime() - record_time;
                 record_time = utcTime();
 
-                auto block = Block(fromHex(strBlock.c_str()), CheckTransaction::None);
+                auto blockRLP = std::make_shared<bytes>(decodeBlockField(strBlock));
+                auto block = Block(blockRLP, CheckTransaction::None);
                 auto constructBlock_time_cost = utcTime() - record_time;
                 record_time = utcTime();
 
                 BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlock]Write to cache");
-                auto blockPtr = m_blockCache.add(block);
+                auto blockPtr = m_blockCache.add(block, blockRLP);
                 auto addCache_time_cost = utcTime() - record_time;
                 BLOCKCHAIN_LOG(DEBUG) << LOG_DESC("Get block from leveldb")
                                       << LOG_KV("getCacheTimeCost", getCache_time_cost)
@@ -211,6 +325,19 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(int64_t _i)
     {
         return nullptr;
     }
+    auto cachedBlock = m_blockCache.get(_i);
+    if (cachedBlock.rlp)
+    {
+        return cachedBlock.rlp;
+    }
+    if (m_blockStore)
+    {
+        auto blockRLP = m_blockStore->get(_i);
+        if (blockRLP)
+        {
+            return blockRLP;
+        }
+    }
     string blockHash = "";
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_NUMBER_2_HASH);
     if (tb)
@@ -236,17 +363,24 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(dev::h256 const& _blockHash)
     auto getCache_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
-    if (bool(cachedBlock.first))
+    if (cachedBlock.rlp)
     {
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlockRLP]Cache hit, read from cache");
-        std::shared_ptr<bytes> blockRLP = cachedBlock.first->rlpP();
         BLOCKCHAIN_LOG(DEBUG) << LOG_DESC("Get block RLP from cache")
                               << LOG_KV("getCacheTimeCost", getCache_time_cost)
                               << LOG_KV("totalTimeCost", utcTime() - start_time);
-        return blockRLP;
+        return cachedBlock.rlp;
     }
     else
     {
+        if (m_blockStore)
+        {
+            auto blockRLP = m_blockStore->get(_blockHash);
+            if (blockRLP)
+            {
+                return blockRLP;
+            }
+        }
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlockRLP]Cache missed, read from storage");
         string strBlock = "";
         Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_HASH_2_BLOCK);
@@ -264,7 +398,7 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(dev::h256 const& _blockHash)
                 auto getField_time_cost = utcTime() - record_time;
                 record_time = utcTime();
 
-                auto blockRLP = std::make_shared<bytes>(fromHex(strBlock.c_str()));
+                auto blockRLP = std::make_shared<bytes>(decodeBlockField(strBlock));
                 auto blockRLP_time_cost = utcTime() - record_time;
 
                 BLOCKCHAIN_LOG(DEBUG) << LOG_DESC("Get block RLP from leveldb")
@@ -286,14 +420,40 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(dev::h256 const& _blockHash)
 
 int64_t BlockChainImp::number()
 {
-    UpgradableGuard ul(m_blockNumberMutex);
-    if (m_blockNumber == -1)
+    return chainHead()->number;
+}
+
+std::shared_ptr<ChainHead const> BlockChainImp::chainHead()
+{
+    auto head = std::atomic_load(&m_chainHead);
+    if (head)
+    {
+        return head;
+    }
+    int64_t num = obtainNumber();
+    head = buildChainHead(num, numberHash(num), getMemoryTableFactory());
+    /// a head published meanwhile by a commit is newer
+    std::shared_ptr<ChainHead const> expected;
+    if (!std::atomic_compare_exchange_strong(&m_chainHead, &expected, head))
+    {
+        return expected;
+    }
+    return head;
+}
+
+std::shared_ptr<ChainHead const> BlockChainImp::buildChainHead(
+    int64_t _number, h256 const& _hash, std::shared_ptr<TableFactory> _tableFactory)
+{
+    auto head = std::make_shared<ChainHead>();
+    head->number = _number;
+    head->hash = _hash;
+    head->sealerList = getNodeListByType(_tableFactory, _number, NODE_TYPE_SEALER);
+    head->observerList = getNodeListByType(_tableFactory, _number, NODE_TYPE_OBSERVER);
+    for (auto key : {SYSTEM_KEY_TX_COUNT_LIMIT, SYSTEM_KEY_TX_GAS_LIMIT})
     {
-        int64_t num = obtainNumber();
-        UpgradeGuard l(ul);
-        m_blockNumber = num;
+        head->systemConfigs[key] = getSystemConfig(_tableFactory, key, _number + 1);
     }
-    return m_blockNumber;
+    return head;
 }
 
 int64_t BlockChainImp::obtainNumber()
@@ -320,7 +480,7 @@ void BlockChainImp::getNonces(
     {
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("getNonces failed for invalid block number")
                               << LOG_KV("invalidNumber", _blockNumber)
-                              << LOG_KV("blockNumber", m_blockNumber);
+                              << LOG_KV("blockNumber", number());
         return;
     }
     BLOCKCHAIN_LOG(DEBUG) << LOG_DESC("getNonces") << LOG_KV("blkNumber", _blockNumber);
@@ -332,7 +492,7 @@ void BlockChainImp::getNonces(
         {
             auto entry = entries->get(0);
             std::string nonce_vector_str = entry->getField(SYS_VALUE);
-            bytes ret = fromHex(nonce_vector_str);
+            bytes ret = decodeBlockField(nonce_vector_str);
             RLP rlp(ret);
             _nonceVector = rlp.toVector<dev::eth::NonceKeyType>();
         }
@@ -385,6 +545,11 @@ bytes BlockChainImp::getCode(Address _address)
 
 h256 BlockChainImp::numberHash(int64_t _i)
 {
+    auto head = std::atomic_load(&m_chainHead);
+    if (head && head->number == _i)
+    {
+        return head->hash;
+    }
     string numberHash = "";
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_NUMBER_2_HASH, false);
     if (tb)
@@ -495,15 +660,13 @@ bool BlockChainImp::checkAndBuildGenesisBlock(GenesisBlockParam& initParam)
             Entry::Ptr entry = std::make_shared<Entry>();
             bytes out;
             block->encode(out);
-            entry->setField(SYS_VALUE, toHexPrefixed(out));
+            entry->setField(SYS_VALUE, encodeBlockField(ref(out)));
             tb->insert(block->blockHeader().hash().hex(), entry);
         }
 
         mtb->commitDB(block->blockHeader().hash(), block->blockHeader().number());
-        {
-            WriteGuard l(m_blockNumberMutex);
-            m_blockNumber = 0;
-        }
+        /// read again with the genesis block
+        std::atomic_store(&m_chainHead, std::shared_ptr<ChainHead const>());
         BLOCKCHAIN_LOG(INFO) << LOG_DESC("[#checkAndBuildGenesisBlock]Insert the 0th block");
     }
     else
@@ -555,11 +718,17 @@ bool BlockChainImp::checkAndBuildGenesisBlock(GenesisBlockParam& initParam)
 }
 
 dev::h512s BlockChainImp::getNodeListByType(int64_t blockNumber, std::string const& type)
+{
+    return getNodeListByType(getMemoryTableFactory(), blockNumber, type);
+}
+
+dev::h512s BlockChainImp::getNodeListByType(
+    std::shared_ptr<TableFactory> _tableFactory, int64_t blockNumber, std::string const& type)
 {
     dev::h512s list;
     try
     {
-        Table::Ptr tb = getMemoryTableFactory()->openTable(storage::SYS_CONSENSUS);
+        Table::Ptr tb = _tableFactory->openTable(storage::SYS_CONSENSUS);
         if (!tb)
         {
             BLOCKCHAIN_LOG(ERROR) << LOG_DESC("[#getNodeListByType]Open table error");
@@ -601,38 +770,12 @@ dev::h512s BlockChainImp::getNodeListByType(int64_t blockNumber, std::string con
 
 dev::h512s BlockChainImp::sealerList()
 {
-    int64_t blockNumber = number();
-    UpgradableGuard l(m_nodeListMutex);
-    if (m_cacheNumBySealer == blockNumber)
-    {
-        BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#sealerList]Get sealer list by cache")
-                              << LOG_KV("size", m_sealerList.size());
-        return m_sealerList;
-    }
-    dev::h512s list = getNodeListByType(blockNumber, NODE_TYPE_SEALER);
-    UpgradeGuard ul(l);
-    m_cacheNumBySealer = blockNumber;
-    m_sealerList = list;
-
-    return list;
+    return chainHead()->sealerList;
 }
 
 dev::h512s BlockChainImp::observerList()
 {
-    int64_t blockNumber = number();
-    UpgradableGuard l(m_nodeListMutex);
-    if (m_cacheNumByObserver == blockNumber)
-    {
-        BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#observerList]Get observer list by cache")
-                              << LOG_KV("size", m_observerList.size());
-        return m_observerList;
-    }
-    dev::h512s list = getNodeListByType(blockNumber, NODE_TYPE_OBSERVER);
-    UpgradeGuard ul(l);
-    m_cacheNumByObserver = blockNumber;
-    m_observerList = list;
-
-    return list;
+    return chainHead()->observerList;
 }
 
 std::string BlockChainImp::getSystemConfigByKey(std::string const& key, int64_t num)
@@ -641,7 +784,16 @@ std::string BlockChainImp::getSystemConfigByKey(std::string const& key, int64_t
     // -1 means that the parameter is invalid and to obtain current block height
     // The param was reset at height number(), and takes effect in next block.
     // So we query the status of number() + 1.
-    int64_t blockNumber = (-1 == num) ? number() + 1 : num;
+    auto head = chainHead();
+    if (-1 == num || num == head->number + 1)
+    {
+        auto config = head->systemConfigs.find(key);
+        if (config != head->systemConfigs.end())
+        {
+            return config->second;
+        }
+    }
+    int64_t blockNumber = (-1 == num) ? head->number + 1 : num;
 
     UpgradableGuard l(m_systemConfigMutex);
     auto it = m_systemConfigRecord.find(key);
@@ -651,12 +803,34 @@ std::string BlockChainImp::getSystemConfigByKey(std::string const& key, int64_t
         return it->second.value;
     }
 
-    std::string ret;
     // cannot find the system config key or need to update the value with different block height
     // get value from db
+    std::string ret = getSystemConfig(getMemoryTableFactory(), key, blockNumber);
+
+    // update cache
+    {
+        UpgradeGuard ul(l);
+        SystemConfigRecord systemConfigRecord(ret, blockNumber);
+        if (it != m_systemConfigRecord.end())
+        {
+            it->second = systemConfigRecord;
+        }
+        else
+        {
+            m_systemConfigRecord.insert(
+                std::pair<std::string, SystemConfigRecord>(key, systemConfigRecord));
+        }
+    }
+    return ret;
+}
+
+std::string BlockChainImp::getSystemConfig(
+    std::shared_ptr<TableFactory> _tableFactory, std::string const& key, int64_t blockNumber)
+{
+    std::string ret;
     try
     {
-        Table::Ptr tb = getMemoryTableFactory()->openTable(storage::SYS_CONFIG);
+        Table::Ptr tb = _tableFactory->openTable(storage::SYS_CONFIG);
         if (!tb)
         {
             BLOCKCHAIN_LOG(ERROR) << LOG_DESC("[#getSystemConfigByKey]Open table error");
@@ -687,26 +861,30 @@ std::string BlockChainImp::getSystemConfigByKey(std::string const& key, int64_t
                               << LOG_KV("EINFO", boost::diagnostic_information(e));
     }
 
-    // update cache
-    {
-        UpgradeGuard ul(l);
-        SystemConfigRecord systemConfigRecord(ret, blockNumber);
-        if (it != m_systemConfigRecord.end())
-        {
-            it->second = systemConfigRecord;
-        }
-        else
-        {
-            m_systemConfigRecord.insert(
-                std::pair<std::string, SystemConfigRecord>(key, systemConfigRecord));
-        }
-    }
-
     BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getSystemConfigByKey]Data in db") << LOG_KV("key", key)
                           << LOG_KV("value", ret);
     return ret;
 }
 
+void BlockChainImp::withCommitLock(std::function<void(int64_t)> const& _f)
+{
+    std::lock_guard<std::mutex> l(commitMutex);
+    _f(number());
+}
+
+void BlockChainImp::reload()
+{
+    std::lock_guard<std::mutex> l(commitMutex);
+    std::atomic_store(&m_chainHead, std::shared_ptr<ChainHead const>());
+    {
+        WriteGuard ll(m_systemConfigMutex);
+        m_systemConfigRecord.clear();
+    }
+    m_logIndexStart = -2;
+    BLOCKCHAIN_LOG(INFO) << LOG_DESC("[#reload]Reload the block number")
+                         << LOG_KV("number", number());
+}
+
 std::shared_ptr<Block> BlockChainImp::getBlockByNumber(int64_t _i)
 {
     /// return directly if the blocknumber is invalid
@@ -726,6 +904,41 @@ std::shared_ptr<Block> BlockChainImp::getBlockByNumber(int64_t _i)
     }
 }
 
+std::shared_ptr<Block> BlockChainImp::getBlockByHashNoReceipts(h256 const& _blockHash)
+{
+    auto cachedBlock = m_blockCache.get(_blockHash);
+    if (cachedBlock.block)
+    {
+        return cachedBlock.block;
+    }
+    auto blockRLP = getBlockRLP(_blockHash);
+    if (!blockRLP)
+    {
+        return nullptr;
+    }
+    /// the transactions are hashed while they are decoded in parallel
+    return std::make_shared<Block>(blockRLP, CheckTransaction::None, false, true);
+}
+
+std::shared_ptr<Block> BlockChainImp::getBlockByNumberNoReceipts(int64_t _i)
+{
+    if (_i > number())
+    {
+        return nullptr;
+    }
+    auto cachedBlock = m_blockCache.get(_i);
+    if (cachedBlock.block)
+    {
+        return cachedBlock.block;
+    }
+    auto blockRLP = getBlockRLP(_i);
+    if (!blockRLP)
+    {
+        return nullptr;
+    }
+    return std::make_shared<Block>(blockRLP, CheckTransaction::None, false, true);
+}
+
 std::shared_ptr<bytes> BlockChainImp::getBlockRLPByNumber(int64_t _i)
 {
     /// return directly if the blocknumber is invalid
@@ -745,10 +958,9 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLPByNumber(int64_t _i)
     }
 }
 
-Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
+bool BlockChainImp::getTxIndex(
+    dev::h256 const& _txHash, int64_t& _blockNumber, size_t& _txIndex)
 {
-    string strblock = "";
-    string txIndex = "";
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (tb)
     {
@@ -756,19 +968,75 @@ Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
         if (entries->size() > 0)
         {
             auto entry = entries->get(0);
-            strblock = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblock));
-            if (!pblock)
-            {
-                return Transaction();
-            }
-            const std::vector<Transaction>& txs = pblock->transactions();
-            if (txs.size() > lexical_cast<uint>(txIndex))
-            {
-                return txs[lexical_cast<uint>(txIndex)];
-            }
+            _blockNumber = lexical_cast<int64_t>(entry->getField(SYS_VALUE));
+            _txIndex = lexical_cast<size_t>(entry->getField("index"));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BlockChainImp::getTxInBlock(int64_t _blockNumber, size_t _txIndex, BlockHeader* _header,
+    Transaction* _tx, TransactionReceipt* _receipt)
+{
+    if (_blockNumber > number())
+    {
+        return false;
+    }
+    auto cachedBlock = m_blockCache.get(_blockNumber);
+    if (cachedBlock.block)
+    {
+        auto const& block = *cachedBlock.block;
+        if (_txIndex >= block.transactions().size() ||
+            (_receipt && _txIndex >= block.transactionReceipts().size()))
+        {
+            return false;
+        }
+        if (_header)
+        {
+            *_header = block.blockHeader();
+        }
+        if (_tx)
+        {
+            *_tx = block.transactions()[_txIndex];
+        }
+        if (_receipt)
+        {
+            *_receipt = block.transactionReceipts()[_txIndex];
         }
+        return true;
+    }
+
+    // the stored block is not decoded as a whole, only the header and the requested objects
+    auto blockRLP = getBlockRLP(_blockNumber);
+    if (!blockRLP)
+    {
+        return false;
+    }
+    if (_tx && !Block::decodeTransaction(ref(*blockRLP), _txIndex, *_tx))
+    {
+        return false;
+    }
+    if (_receipt && !Block::decodeReceipt(ref(*blockRLP), _txIndex, *_receipt))
+    {
+        return false;
+    }
+    if (_header)
+    {
+        _header->populate(BlockHeader::extractBlock(ref(*blockRLP))[0]);
+    }
+    return true;
+}
+
+Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
+{
+    int64_t blockNumber = 0;
+    size_t txIndex = 0;
+    Transaction tx;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxInBlock(blockNumber, txIndex, nullptr, &tx, nullptr))
+    {
+        return tx;
     }
     BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getTxByHash]Can't find tx, return empty tx");
     return Transaction();
@@ -776,29 +1044,14 @@ Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
 
 LocalisedTransaction BlockChainImp::getLocalisedTxByHash(dev::h256 const& _txHash)
 {
-    string strblockhash = "";
-    string txIndex = "";
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
-    if (tb)
+    int64_t blockNumber = 0;
+    size_t txIndex = 0;
+    BlockHeader header;
+    Transaction tx;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxInBlock(blockNumber, txIndex, &header, &tx, nullptr))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            strblockhash = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblockhash));
-            if (!pblock)
-            {
-                return LocalisedTransaction(Transaction(), h256(0), -1, -1);
-            }
-            const std::vector<Transaction>& txs = pblock->transactions();
-            if (txs.size() > lexical_cast<uint>(txIndex))
-            {
-                return LocalisedTransaction(txs[lexical_cast<uint>(txIndex)], pblock->headerHash(),
-                    lexical_cast<unsigned>(txIndex), pblock->blockHeader().number());
-            }
-        }
+        return LocalisedTransaction(tx, header.hash(), txIndex, header.number());
     }
     BLOCKCHAIN_LOG(TRACE) << LOG_DESC(
         "[#getLocalisedTxByHash]Can't find tx, return empty localised tx");
@@ -807,28 +1060,13 @@ LocalisedTransaction BlockChainImp::getLocalisedTxByHash(dev::h256 const& _txHas
 
 TransactionReceipt BlockChainImp::getTransactionReceiptByHash(dev::h256 const& _txHash)
 {
-    string strblock = "";
-    string txIndex = "";
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
-    if (tb)
+    int64_t blockNumber = 0;
+    size_t txIndex = 0;
+    TransactionReceipt receipt;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxInBlock(blockNumber, txIndex, nullptr, nullptr, &receipt))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            strblock = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblock));
-            if (!pblock)
-            {
-                return TransactionReceipt();
-            }
-            std::vector<TransactionReceipt> receipts = pblock->transactionReceipts();
-            if (receipts.size() > lexical_cast<uint>(txIndex))
-            {
-                return receipts[lexical_cast<uint>(txIndex)];
-            }
-        }
+        return receipt;
     }
     BLOCKCHAIN_LOG(TRACE) << LOG_DESC(
         "[#getTransactionReceiptByHash]Can't find tx, return empty localised tx receipt");
@@ -837,34 +1075,16 @@ TransactionReceipt BlockChainImp::getTransactionReceiptByHash(dev::h256 const& _
 
 LocalisedTransactionReceipt BlockChainImp::getLocalisedTxReceiptByHash(dev::h256 const& _txHash)
 {
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
-    if (tb)
+    int64_t blockNumber = 0;
+    size_t txIndex = 0;
+    BlockHeader header;
+    Transaction tx;
+    TransactionReceipt receipt;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxInBlock(blockNumber, txIndex, &header, &tx, &receipt))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            auto blockNum = lexical_cast<int64_t>(entry->getField(SYS_VALUE));
-            auto txIndex = lexical_cast<uint>(entry->getField("index"));
-
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(blockNum));
-            if (!pblock)
-            {
-                return LocalisedTransactionReceipt(
-                    TransactionReceipt(), h256(0), h256(0), -1, Address(), Address(), -1, 0);
-            }
-            const Transactions& txs = pblock->transactions();
-            const TransactionReceipts& receipts = pblock->transactionReceipts();
-            if (receipts.size() > txIndex && txs.size() > txIndex)
-            {
-                auto& tx = txs[txIndex];
-                auto& receipt = receipts[txIndex];
-
-                return LocalisedTransactionReceipt(receipt, _txHash, pblock->headerHash(),
-                    pblock->header().number(), tx.from(), tx.to(), txIndex, receipt.gasUsed(),
-                    receipt.contractAddress());
-            }
-        }
+        return LocalisedTransactionReceipt(receipt, _txHash, header.hash(), header.number(),
+            tx.from(), tx.to(), txIndex, receipt.gasUsed(), receipt.contractAddress());
     }
     BLOCKCHAIN_LOG(TRACE) << LOG_DESC(
         "[#getLocalisedTxReceiptByHash]Can't find tx, return empty localised tx receipt");
@@ -966,7 +1186,7 @@ void BlockChainImp::writeTxToBlock(const Block& block, std::shared_ptr<Executive
         record_time = utcTime();
 
         Entry::Ptr entry_tb2nonces = std::make_shared<Entry>();
-        entry_tb2nonces->setField(SYS_VALUE, toHexPrefixed(rs.out()));
+        entry_tb2nonces->setField(SYS_VALUE, encodeBlockField(ref(rs.out())));
         entry_tb2nonces->setForce(true);
         tb_nonces->insert(lexical_cast<std::string>(block.blockHeader().number()), entry_tb2nonces);
         auto insertNonceVector_time_cost = utcTime() - record_time;
@@ -1001,15 +1221,15 @@ void BlockChainImp::writeNumber2Hash(const Block& block, std::shared_ptr<Executi
     }
 }
 
-void BlockChainImp::writeHash2Block(Block& block, std::shared_ptr<ExecutiveContext> context)
+void BlockChainImp::writeHash2Block(
+    Block& block, bytes& _out, std::shared_ptr<ExecutiveContext> context)
 {
     Table::Ptr tb = context->getMemoryTableFactory()->openTable(SYS_HASH_2_BLOCK, false);
     if (tb)
     {
         Entry::Ptr entry = std::make_shared<Entry>();
-        bytes out;
-        block.encode(out);
-        entry->setField(SYS_VALUE, toHexPrefixed(out));
+        block.encode(_out);
+        entry->setField(SYS_VALUE, encodeBlockField(ref(_out)));
         entry->setForce(true);
         tb->insert(block.blockHeader().hash().hex(), entry);
     }
@@ -1019,12 +1239,106 @@ void BlockChainImp::writeHash2Block(Block& block, std::shared_ptr<ExecutiveConte
     }
 }
 
+void BlockChainImp::writeLogIndex(const Block& block, std::shared_ptr<ExecutiveContext> context)
+{
+    Table::Ptr tb = context->getMemoryTableFactory()->openTable(SYS_LOG_INDEX, false);
+    Table::Ptr tb_bloom = context->getMemoryTableFactory()->openTable(SYS_BLOCK_2_BLOOM, false);
+    if (!tb || !tb_bloom)
+    {
+        BOOST_THROW_EXCEPTION(OpenSysTableFailed() << errinfo_comment(SYS_LOG_INDEX));
+    }
+
+    int64_t number = block.blockHeader().number();
+    auto const& txs = block.transactions();
+    auto const& receipts = block.transactionReceipts();
+    /// the transaction and the log index of the logs of each address and first topic
+    std::map<std::string, std::vector<std::pair<size_t, size_t>>> positions;
+    for (size_t i = 0; i < receipts.size() && i < txs.size(); ++i)
+    {
+        auto const& logs = receipts[i].log();
+        for (size_t j = 0; j < logs.size(); ++j)
+        {
+            h256 topic0 = logs[j].topics.empty() ? h256() : logs[j].topics[0];
+            positions[logKey(logs[j].address, topic0)].push_back(std::make_pair(i, j));
+        }
+    }
+
+    /// [blockHash, [[txHash, txIndex, logIndex, log], ...]], served without decoding the block
+    for (auto const& it : positions)
+    {
+        RLPStream s;
+        s.appendList(2) << block.headerHash();
+        s.appendList(it.second.size());
+        for (auto const& position : it.second)
+        {
+            s.appendList(4) << txs[position.first].sha3() << u256(position.first)
+                            << u256(position.second);
+            receipts[position.first].log()[position.second].streamRLP(s);
+        }
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField(SYS_VALUE, encodeBlockField(ref(s.out())));
+        entry->setForce(true);
+        tb->insert(it.first + blockKey(number), entry);
+    }
+    /// the blocks without logs have no bloom
+    LogBloom bloom = dev::eth::bloom(receipts);
+    if (bloom != LogBloom())
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField(SYS_VALUE, encodeBlockField(bloom.ref()));
+        entry->setForce(true);
+        tb_bloom->insert(blockKey(number), entry);
+    }
+    if (logIndexStart() < 0)
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField(SYS_VALUE, lexical_cast<std::string>(number));
+        entry->setForce(true);
+        tb->insert(c_logIndexStartKey, entry);
+        m_logIndexStart = number;
+    }
+}
+
 void BlockChainImp::writeBlockInfo(Block& block, std::shared_ptr<ExecutiveContext> context)
 {
-    writeHash2Block(block, context);
+    bytes out;
+    writeHash2Block(block, out, context);
     writeNumber2Hash(block, context);
 }
 
+std::shared_ptr<bytes const> BlockChainImp::dumpStateDiff(
+    const Block& block, std::shared_ptr<ExecutiveContext> context)
+{
+    auto tableFactory =
+        std::dynamic_pointer_cast<MemoryTableFactory2>(context->getMemoryTableFactory());
+    if (!tableFactory)
+    {
+        return nullptr;
+    }
+    try
+    {
+        StateDiff diff;
+        diff.blockHash = block.blockHeader().hash();
+        diff.number = block.blockHeader().number();
+        diff.datas = tableFactory->dump(true);
+        return std::make_shared<bytes const>(diff.encode());
+    }
+    catch (std::exception const& e)
+    {
+        BLOCKCHAIN_LOG(WARNING) << LOG_DESC("[commitBlock]dump the state diff failed")
+                                << LOG_KV("number", block.blockHeader().number())
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return nullptr;
+    }
+}
+
+std::shared_ptr<bytes const> BlockChainImp::getStateDiff(int64_t _number)
+{
+    std::lock_guard<std::mutex> l(x_stateDiffs);
+    auto it = m_stateDiffs.find(_number);
+    return it == m_stateDiffs.end() ? nullptr : it->second;
+}
+
 bool BlockChainImp::isBlockShouldCommit(int64_t const& _blockNumber)
 {
     if (_blockNumber != number() + 1)
@@ -1040,6 +1354,8 @@ bool BlockChainImp::isBlockShouldCommit(int64_t const& _blockNumber)
 
 CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveContext> context)
 {
+    BlockSpan span("blockchain.commitBlock", m_stateStorage ? m_stateStorage->groupID() : 0,
+        block.blockHeader().number(), block.blockHeader().hash());
     auto start_time = utcTime();
     auto record_time = utcTime();
     if (!isBlockShouldCommit(block.blockHeader().number()))
@@ -1061,6 +1377,67 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
     {
         auto before_write_time_cost = utcTime() - record_time;
         record_time = utcTime();
+        /// the RLP written is cached along with the block
+        auto blockRLP = std::make_shared<bytes>();
+        // The block tables are independent of each other, they are written concurrently to the
+        // tables of the context. Only the commit to the storage and the swap of the number are
+        // serialized, a block committed meanwhile fails the check under the lock.
+        uint64_t writeHash2Block_time_cost = 0;
+        uint64_t writeNumber2Hash_time_cost = 0;
+        uint64_t writeNumber_time_cost = 0;
+        uint64_t writeTotalTransactionCount_time_cost = 0;
+        uint64_t writeTxToBlock_time_cost = 0;
+        uint64_t writeLogIndex_time_cost = 0;
+        uint64_t buildChainHead_time_cost = 0;
+        // dumped before the block tables are written to the tables of the context
+        std::shared_ptr<bytes const> stateDiff;
+        if (m_stateDiffCapacity > 0)
+        {
+            stateDiff = dumpStateDiff(block, context);
+        }
+        std::shared_ptr<ChainHead const> head;
+        tbb::parallel_invoke(
+            [&]() {
+                auto writeStart = utcTime();
+                writeHash2Block(block, *blockRLP, context);
+                writeHash2Block_time_cost = utcTime() - writeStart;
+            },
+            [&]() {
+                auto writeStart = utcTime();
+                writeNumber2Hash(block, context);
+                writeNumber2Hash_time_cost = utcTime() - writeStart;
+            },
+            [&]() {
+                // both are rows of the current state table
+                auto writeStart = utcTime();
+                writeNumber(block, context);
+                writeNumber_time_cost = utcTime() - writeStart;
+                writeStart = utcTime();
+                writeTotalTransactionCount(block, context);
+                writeTotalTransactionCount_time_cost = utcTime() - writeStart;
+            },
+            [&]() {
+                auto writeStart = utcTime();
+                writeTxToBlock(block, context);
+                writeTxToBlock_time_cost = utcTime() - writeStart;
+            },
+            [&]() {
+                if (m_logIndex)
+                {
+                    auto writeStart = utcTime();
+                    writeLogIndex(block, context);
+                    writeLogIndex_time_cost = utcTime() - writeStart;
+                }
+            },
+            [&]() {
+                // the system tables of the context hold the changes of the block
+                auto writeStart = utcTime();
+                head = buildChainHead(block.blockHeader().number(), block.blockHeader().hash(),
+                    context->getMemoryTableFactory());
+                buildChainHead_time_cost = utcTime() - writeStart;
+            });
+        uint64_t dbCommit_time_cost = 0;
+        uint64_t updateBlockNumber_time_cost = 0;
         {
             std::lock_guard<std::mutex> l(commitMutex);
             if (!isBlockShouldCommit(block.blockHeader().number()))
@@ -1068,55 +1445,62 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
                 return CommitResult::ERROR_PARENT_HASH;
             }
             auto write_record_time = utcTime();
-            // writeBlockInfo(block, context);
-            writeHash2Block(block, context);
-            auto writeHash2Block_time_cost = utcTime() - write_record_time;
-            write_record_time = utcTime();
 
-            writeNumber2Hash(block, context);
-            auto writeNumber2Hash_time_cost = utcTime() - write_record_time;
-            write_record_time = utcTime();
-
-            writeNumber(block, context);
-            auto writeNumber_time_cost = utcTime() - write_record_time;
-            write_record_time = utcTime();
-
-            writeTotalTransactionCount(block, context);
-            auto writeTotalTransactionCount_time_cost = utcTime() - write_record_time;
-            write_record_time = utcTime();
-
-            writeTxToBlock(block, context);
-            auto writeTxToBlock_time_cost = utcTime() - write_record_time;
-            write_record_time = utcTime();
-
-            context->dbCommit(block);
-            auto dbCommit_time_cost = utcTime() - write_record_time;
+            {
+                BlockSpan dbCommitSpan("blockchain.dbCommit",
+                    m_stateStorage ? m_stateStorage->groupID() : 0, block.blockHeader().number(),
+                    block.blockHeader().hash());
+                context->dbCommit(block);
+            }
+            dbCommit_time_cost = utcTime() - write_record_time;
             write_record_time = utcTime();
+            std::atomic_store(&m_chainHead, head);
+            updateBlockNumber_time_cost = utcTime() - write_record_time;
+            if (stateDiff)
+            {
+                std::lock_guard<std::mutex> diffLock(x_stateDiffs);
+                m_stateDiffs[block.blockHeader().number()] = stateDiff;
+                while (m_stateDiffs.size() > m_stateDiffCapacity)
+                {
+                    m_stateDiffs.erase(m_stateDiffs.begin());
+                }
+            }
+            if (m_blockStore)
             {
-                WriteGuard ll(m_blockNumberMutex);
-                m_blockNumber = block.blockHeader().number();
+                /// appended in the order of the blocks, a block failed is read from the storage
+                try
+                {
+                    m_blockStore->append(
+                        block.blockHeader().number(), block.blockHeader().hash(), ref(*blockRLP));
+                }
+                catch (std::exception const& e)
+                {
+                    BLOCKCHAIN_LOG(WARNING)
+                        << LOG_DESC("[commitBlock]append to the block store failed")
+                        << LOG_KV("EINFO", boost::diagnostic_information(e));
+                }
             }
-            auto updateBlockNumber_time_cost = utcTime() - write_record_time;
-
-            BLOCKCHAIN_LOG(DEBUG) << LOG_BADGE("Commit")
-                                  << LOG_DESC("Commit block time record(write)")
-                                  << LOG_KV("writeHash2BlockTimeCost", writeHash2Block_time_cost)
-                                  << LOG_KV("writeNumber2HashTimeCost", writeNumber2Hash_time_cost)
-                                  << LOG_KV("writeNumberTimeCost", writeNumber_time_cost)
-                                  << LOG_KV("writeTotalTransactionCountTimeCost",
-                                         writeTotalTransactionCount_time_cost)
-                                  << LOG_KV("writeTxToBlockTimeCost", writeTxToBlock_time_cost)
-                                  << LOG_KV("dbCommitTimeCost", dbCommit_time_cost)
-                                  << LOG_KV(
-                                         "updateBlockNumberTimeCost", updateBlockNumber_time_cost);
         }
+        BLOCKCHAIN_LOG(DEBUG) << LOG_BADGE("Commit")
+                              << LOG_DESC("Commit block time record(write)")
+                              << LOG_KV("writeHash2BlockTimeCost", writeHash2Block_time_cost)
+                              << LOG_KV("writeNumber2HashTimeCost", writeNumber2Hash_time_cost)
+                              << LOG_KV("writeNumberTimeCost", writeNumber_time_cost)
+                              << LOG_KV("writeTotalTransactionCountTimeCost",
+                                     writeTotalTransactionCount_time_cost)
+                              << LOG_KV("writeTxToBlockTimeCost", writeTxToBlock_time_cost)
+                              << LOG_KV("writeLogIndexTimeCost", writeLogIndex_time_cost)
+                              << LOG_KV("buildChainHeadTimeCost", buildChainHead_time_cost)
+                              << LOG_KV("dbCommitTimeCost", dbCommit_time_cost)
+                              << LOG_KV(
+                                     "updateBlockNumberTimeCost", updateBlockNumber_time_cost);
         auto writeBlock_time_cost = utcTime() - record_time;
         record_time = utcTime();
 
-        m_blockCache.add(block);
+        m_blockCache.add(block, blockRLP);
         auto addBlockCache_time_cost = utcTime() - record_time;
         record_time = utcTime();
-        m_onReady(m_blockNumber);
+        m_onReady(block.blockHeader().number());
         auto noteReady_time_cost = utcTime() - record_time;
         record_time = utcTime();
 
@@ -1124,6 +1508,9 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
                               << LOG_KV("beforeTimeCost", before_write_time_cost)
                               << LOG_KV("writeBlockTimeCost", writeBlock_time_cost)
                               << LOG_KV("addBlockCacheTimeCost", addBlockCache_time_cost)
+                              << LOG_KV("blockCacheBytes", m_blockCache.cachedBytes())
+                              << LOG_KV("blockCacheHits", m_blockCache.hits())
+                              << LOG_KV("blockCacheMisses", m_blockCache.misses())
                               << LOG_KV("noteReadyTimeCost", noteReady_time_cost)
                               << LOG_KV("totalTimeCost", utcTime() - start_time);
     }
@@ -1147,3 +1534,148 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
     }
     return CommitResult::OK;
 }
+
+int64_t BlockChainImp::logIndexStart()
+{
+    if (m_logIndexStart == -2)
+    {
+        int64_t start = -1;
+        Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_LOG_INDEX, false);
+        if (tb)
+        {
+            auto entries = tb->select(c_logIndexStartKey, tb->newCondition());
+            if (entries->size() > 0)
+            {
+                start = lexical_cast<int64_t>(entries->get(0)->getField(SYS_VALUE));
+            }
+        }
+        m_logIndexStart = start;
+    }
+    return m_logIndexStart;
+}
+
+LocalisedLogEntries BlockChainImp::getLogs(LogFilter const& _filter, int64_t _from, int64_t _to)
+{
+    _from = std::max<int64_t>(_from, 0);
+    _to = std::min(_to, number());
+    int64_t start = m_logIndex ? logIndexStart() : -1;
+    if (start < 0 || start > _to)
+    {
+        return BlockChainInterface::getLogs(_filter, _from, _to);
+    }
+
+    LocalisedLogEntries logs;
+    /// the blocks committed before the index was enabled are decoded
+    if (_from < start)
+    {
+        logs = BlockChainInterface::getLogs(_filter, _from, start - 1);
+        _from = start;
+    }
+    size_t decoded = logs.size();
+    try
+    {
+        if (_filter.addresses.empty())
+        {
+            getBloomedLogs(_filter, _from, _to, logs);
+        }
+        else
+        {
+            getIndexedLogs(_filter, _from, _to, logs);
+        }
+    }
+    catch (StorageException& e)
+    {
+        /// the backend can't scan the index
+        BLOCKCHAIN_LOG(WARNING) << LOG_DESC("[#getLogs]Scan log index failed")
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        logs.resize(decoded);
+        auto scanned = BlockChainInterface::getLogs(_filter, _from, _to);
+        logs.insert(logs.end(), scanned.begin(), scanned.end());
+    }
+    return logs;
+}
+
+void BlockChainImp::getIndexedLogs(
+    LogFilter const& _filter, int64_t _from, int64_t _to, LocalisedLogEntries& _logs)
+{
+    auto tableInfo = sysTableInfo(SYS_LOG_INDEX, SYS_KEY);
+    /// the keys of an address and a first topic are scanned over the blocks, the keys of all the
+    /// first topics of an address if the filter doesn't name them
+    std::vector<std::pair<std::string, std::string>> ranges;
+    bool anyTopic0 = _filter.topics.empty() || _filter.topics[0].empty();
+    for (auto const& address : _filter.addresses)
+    {
+        if (anyTopic0)
+        {
+            ranges.push_back(std::make_pair(address.hex(), address.hex() + "g"));
+            continue;
+        }
+        for (auto const& topic0 : _filter.topics[0])
+        {
+            auto prefix = logKey(address, topic0);
+            ranges.push_back(std::make_pair(prefix + blockKey(_from), prefix + blockKey(_to + 1)));
+        }
+    }
+
+    size_t first = _logs.size();
+    for (auto const& range : ranges)
+    {
+        auto it = m_stateStorage->scan(tableInfo, range.first, range.second);
+        StorageIterator::Batch batch;
+        while (it->next(batch))
+        {
+            for (auto const& row : batch)
+            {
+                int64_t number = std::stoll(row.first.substr(row.first.size() - 16), nullptr, 16);
+                if (number < _from || number > _to || row.second->size() == 0)
+                {
+                    continue;
+                }
+                bytes value = decodeBlockField(row.second->get(0)->getField(SYS_VALUE));
+                RLP rlp(value);
+                h256 blockHash = rlp[0].toHash<h256>();
+                for (auto const& item : rlp[1])
+                {
+                    LogEntry log(item[3]);
+                    if (_filter.matches(log))
+                    {
+                        _logs.push_back(LocalisedLogEntry(log, blockHash, number,
+                            item[0].toHash<h256>(), item[1].toInt<unsigned>(),
+                            item[2].toInt<unsigned>()));
+                    }
+                }
+            }
+        }
+    }
+    std::sort(_logs.begin() + first, _logs.end(),
+        [](LocalisedLogEntry const& _a, LocalisedLogEntry const& _b) {
+            return std::make_tuple(_a.blockNumber, _a.transactionIndex, _a.logIndex) <
+                   std::make_tuple(_b.blockNumber, _b.transactionIndex, _b.logIndex);
+        });
+}
+
+void BlockChainImp::getBloomedLogs(
+    LogFilter const& _filter, int64_t _from, int64_t _to, LocalisedLogEntries& _logs)
+{
+    auto it = m_stateStorage->scan(
+        sysTableInfo(SYS_BLOCK_2_BLOOM, "number"), blockKey(_from), blockKey(_to + 1));
+    auto blooms = _filter.blooms();
+    StorageIterator::Batch batch;
+    while (it->next(batch))
+    {
+        for (auto const& row : batch)
+        {
+            if (row.second->size() == 0 ||
+                !blooms.mayMatch(
+                    LogBloom(decodeBlockField(row.second->get(0)->getField(SYS_VALUE)))))
+            {
+                continue;
+            }
+            auto block = getBlockByNumber(std::stoll(row.first, nullptr, 16));
+            if (block)
+            {
+                _filter.match(blooms, *block, _logs);
+            }
+        }
+    }
+}
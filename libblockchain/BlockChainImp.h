@@ -23,7 +23,9 @@
 #pragma once
 
 #include "BlockChainInterface.h"
+#include "BlockStore.h"
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/FixedHashMap.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
 #include <libethcore/Common.h>
@@ -37,6 +39,7 @@
 #include <libstorage/Table.h>
 #include <libstoragestate/StorageStateFactory.h>
 #include <boost/thread/shared_mutex.hpp>
+#include <atomic>
 #include <deque>
 #include <map>
 #include <memory>
@@ -59,18 +62,55 @@ namespace blockchain
 {
 class BlockChainImp;
 
+/// the bytes of the blocks cached, a decoded block is charged twice its RLP
+static const size_t c_blockCacheBytes = 256 * 1024 * 1024;
+
+/// The latest blocks, both decoded and in RLP, looked up by hash or by number. The oldest blocks
+/// cached are dropped once their bytes go beyond the limit.
 class BlockCache
 {
 public:
-    BlockCache(){};
-    std::shared_ptr<dev::eth::Block> add(dev::eth::Block const& _block);
-    std::pair<std::shared_ptr<dev::eth::Block>, dev::h256> get(h256 const& _hash);
+    struct Entry
+    {
+        std::shared_ptr<dev::eth::Block> block;
+        std::shared_ptr<dev::bytes> rlp;
+    };
+
+    BlockCache(size_t _maxBytes = c_blockCacheBytes) : m_maxBytes(_maxBytes) {}
+    /// cache _block, _rlp its encoding or null to encode it here
+    std::shared_ptr<dev::eth::Block> add(
+        dev::eth::Block const& _block, std::shared_ptr<dev::bytes> _rlp = nullptr);
+    /// the block cached, an empty entry on a miss
+    Entry get(h256 const& _hash) const;
+    Entry get(int64_t _number) const;
+
+    size_t cachedBytes() const;
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
 
 private:
+    Entry count(Entry _entry) const;
+
+    size_t m_maxBytes;
     mutable boost::shared_mutex m_sharedMutex;
-    mutable std::map<dev::h256, std::shared_ptr<dev::eth::Block>> m_blockCache;
-    mutable std::deque<dev::h256> m_blockCacheFIFO;  // insert queue log for m_blockCache
-    const unsigned c_blockCacheSize = 10;            // m_blockCache size, default set 10
+    dev::FixedHashMap<dev::h256, Entry> m_blocks;
+    std::map<int64_t, dev::h256> m_numberHash;
+    std::deque<dev::h256> m_fifo;  // insert order of m_blocks
+    size_t m_bytes = 0;
+    mutable std::atomic<uint64_t> m_hits = {0};
+    mutable std::atomic<uint64_t> m_misses = {0};
+};
+
+/// The head of the chain as of the last block committed. A new head is published as a whole on
+/// commit, so that its readers take no lock.
+struct ChainHead
+{
+    int64_t number = 0;
+    dev::h256 hash;
+    dev::h512s sealerList;
+    dev::h512s observerList;
+    /// the system configs in effect for the next block
+    std::map<std::string, std::string> systemConfigs;
 };
 DEV_SIMPLE_EXCEPTION(OpenSysTableFailed);
 
@@ -90,6 +130,9 @@ public:
     std::shared_ptr<dev::eth::Block> getBlockByNumber(int64_t _i) override;
     std::shared_ptr<dev::bytes> getBlockRLPByHash(dev::h256 const& _blockHash) override;
     std::shared_ptr<dev::bytes> getBlockRLPByNumber(int64_t _i) override;
+    std::shared_ptr<dev::eth::Block> getBlockByHashNoReceipts(
+        dev::h256 const& _blockHash) override;
+    std::shared_ptr<dev::eth::Block> getBlockByNumberNoReceipts(int64_t _i) override;
     CommitResult commitBlock(dev::eth::Block& block,
         std::shared_ptr<dev::blockverifier::ExecutiveContext> context) override;
 
@@ -103,19 +146,41 @@ public:
     dev::h512s sealerList() override;
     dev::h512s observerList() override;
     std::string getSystemConfigByKey(std::string const& key, int64_t num = -1) override;
+    void withCommitLock(std::function<void(int64_t)> const& _f) override;
+    void reload() override;
     void getNonces(
         std::vector<dev::eth::NonceKeyType>& _nonceVector, int64_t _blockNumber) override;
+    /// the indexed blocks are looked up by the addresses and the first topics of the filter, or
+    /// pruned by their blooms if it has no address
+    dev::eth::LocalisedLogEntries getLogs(
+        dev::eth::LogFilter const& _filter, int64_t _from, int64_t _to) override;
+
+    /// index the logs of the blocks committed from now on
+    void setLogIndex(bool _logIndex) { m_logIndex = _logIndex; }
 
     void setTableFactoryFactory(dev::storage::TableFactoryFactory::Ptr tableFactoryFactory)
     {
         m_tableFactoryFactory = tableFactoryFactory;
     }
 
+    /// append the blocks committed from now on to _blockStore and read the blocks from it first
+    void setBlockStore(BlockStore::Ptr _blockStore) { m_blockStore = _blockStore; }
+
+    /// keep the state diffs of the latest _capacity blocks committed, served to the observers
+    void setStateDiffCapacity(size_t _capacity) { m_stateDiffCapacity = _capacity; }
+    std::shared_ptr<dev::bytes const> getStateDiff(int64_t _number) override;
+
 private:
     std::shared_ptr<dev::eth::Block> getBlock(int64_t _i);
     std::shared_ptr<dev::eth::Block> getBlock(dev::h256 const& _blockHash);
     std::shared_ptr<dev::bytes> getBlockRLP(int64_t _i);
     std::shared_ptr<dev::bytes> getBlockRLP(dev::h256 const& _blockHash);
+    /// @returns false if _txHash is not committed
+    bool getTxIndex(dev::h256 const& _txHash, int64_t& _blockNumber, size_t& _txIndex);
+    /// get the header, the _txIndex-th transaction and receipt of a block, the null ones are
+    /// skipped. They are copied from the cached block or decoded alone from the stored one.
+    bool getTxInBlock(int64_t _blockNumber, size_t _txIndex, dev::eth::BlockHeader* _header,
+        dev::eth::Transaction* _tx, dev::eth::TransactionReceipt* _receipt);
     int64_t obtainNumber();
     void writeNumber(const dev::eth::Block& block,
         std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
@@ -127,10 +192,22 @@ private:
         dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
     void writeNumber2Hash(const dev::eth::Block& block,
         std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
-    void writeHash2Block(
-        dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
+    /// _out the RLP of block written, cached along with it
+    void writeHash2Block(dev::eth::Block& block, dev::bytes& _out,
+        std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
+    void writeLogIndex(const dev::eth::Block& block,
+        std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
+    /// the first block whose logs are indexed, -1 if none is
+    int64_t logIndexStart();
+    void getIndexedLogs(dev::eth::LogFilter const& _filter, int64_t _from, int64_t _to,
+        dev::eth::LocalisedLogEntries& _logs);
+    void getBloomedLogs(dev::eth::LogFilter const& _filter, int64_t _from, int64_t _to,
+        dev::eth::LocalisedLogEntries& _logs);
 
     bool isBlockShouldCommit(int64_t const& _blockNumber);
+    /// the encoded tables the execution of block changed, null if they can't be dumped
+    std::shared_ptr<dev::bytes const> dumpStateDiff(const dev::eth::Block& block,
+        std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
 
     dev::storage::Storage::Ptr m_stateStorage;
     std::mutex commitMutex;
@@ -139,11 +216,16 @@ private:
     std::shared_ptr<dev::executive::StateFactoryInterface> m_stateFactory;
 
     dev::h512s getNodeListByType(int64_t num, std::string const& type);
-    mutable SharedMutex m_nodeListMutex;
-    dev::h512s m_sealerList;
-    dev::h512s m_observerList;
-    int64_t m_cacheNumBySealer = -1;
-    int64_t m_cacheNumByObserver = -1;
+    dev::h512s getNodeListByType(std::shared_ptr<dev::storage::TableFactory> _tableFactory,
+        int64_t num, std::string const& type);
+    std::string getSystemConfig(std::shared_ptr<dev::storage::TableFactory> _tableFactory,
+        std::string const& key, int64_t blockNumber);
+
+    /// the head published, read from the storage if there is none
+    std::shared_ptr<ChainHead const> chainHead();
+    /// the head of the block _number, _tableFactory holding its system tables
+    std::shared_ptr<ChainHead const> buildChainHead(int64_t _number, dev::h256 const& _hash,
+        std::shared_ptr<dev::storage::TableFactory> _tableFactory);
 
     struct SystemConfigRecord
     {
@@ -152,15 +234,24 @@ private:
         SystemConfigRecord(std::string const& _value, int64_t _num)
           : value(_value), curBlockNum(_num){};
     };
+    /// the system configs of the past blocks and of the keys not in the chain head
     std::map<std::string, SystemConfigRecord> m_systemConfigRecord;
     mutable SharedMutex m_systemConfigMutex;
     BlockCache m_blockCache;
 
-    /// cache the block number
-    mutable SharedMutex m_blockNumberMutex;
-    int64_t m_blockNumber = -1;
+    /// loaded and swapped by std::atomic_load and std::atomic_store, null until it's read
+    std::shared_ptr<ChainHead const> m_chainHead;
+
+    bool m_logIndex = false;
+    /// -2 until it's read from the storage
+    std::atomic<int64_t> m_logIndexStart = {-2};
 
     dev::storage::TableFactoryFactory::Ptr m_tableFactoryFactory;
+    BlockStore::Ptr m_blockStore;
+
+    size_t m_stateDiffCapacity = 0;
+    std::map<int64_t, std::shared_ptr<dev::bytes const>> m_stateDiffs;
+    mutable std::mutex x_stateDiffs;
 };
 }  // namespace blockchain
 }  // namespace dev
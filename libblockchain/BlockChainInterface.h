@@ -25,8 +25,10 @@
 #include <libdevcore/FixedHash.h>
 #include <libethcore/Block.h>
 #include <libethcore/Common.h>
+#include <libethcore/LogFilter.h>
 #include <libethcore/Transaction.h>
 #include <libethcore/TransactionReceipt.h>
+#include <functional>
 namespace dev
 {
 namespace blockverifier
@@ -74,6 +76,16 @@ public:
     virtual std::shared_ptr<dev::eth::Block> getBlockByNumber(int64_t _i) = 0;
     virtual std::shared_ptr<dev::bytes> getBlockRLPByHash(dev::h256 const& _blockHash) = 0;
     virtual std::shared_ptr<dev::bytes> getBlockRLPByNumber(int64_t _i) = 0;
+    /// the block for the queries serializing only its header and transactions, the receipts of
+    /// a block that isn't cached are left undecoded and the block isn't cached
+    virtual std::shared_ptr<dev::eth::Block> getBlockByHashNoReceipts(dev::h256 const& _blockHash)
+    {
+        return getBlockByHash(_blockHash);
+    }
+    virtual std::shared_ptr<dev::eth::Block> getBlockByNumberNoReceipts(int64_t _i)
+    {
+        return getBlockByNumber(_i);
+    }
     virtual CommitResult commitBlock(
         dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext>) = 0;
     virtual std::pair<int64_t, int64_t> totalTransactionCount() = 0;
@@ -91,6 +103,32 @@ public:
     /// get system config
     virtual std::string getSystemConfigByKey(std::string const& key, int64_t number = -1) = 0;
 
+    /// run _f with the latest block number while no block can be committed, so the state read by
+    /// _f is the state of that block
+    virtual void withCommitLock(std::function<void(int64_t)> const& _f) { _f(number()); }
+    /// drop the cached number, node lists and configs after the storage is restored
+    virtual void reload() {}
+    /// the encoded state diff of the block _number, null if it isn't kept
+    virtual std::shared_ptr<dev::bytes const> getStateDiff(int64_t) { return nullptr; }
+
+    /// the logs of the blocks _from to _to matching _filter, in the order of the blocks, the
+    /// transactions and the logs; the blocks are decoded one by one unless they're indexed
+    virtual dev::eth::LocalisedLogEntries getLogs(
+        dev::eth::LogFilter const& _filter, int64_t _from, int64_t _to)
+    {
+        dev::eth::LocalisedLogEntries logs;
+        auto blooms = _filter.blooms();
+        for (int64_t i = std::max<int64_t>(_from, 0); i <= std::min(_to, number()); ++i)
+        {
+            auto block = getBlockByNumber(i);
+            if (block)
+            {
+                _filter.match(blooms, *block, logs);
+            }
+        }
+        return logs;
+    }
+
     /// Register a handler that will be called once there is a new transaction imported
     template <class T>
     dev::eth::Handler<int64_t> onReady(T const& _t)
@@ -0,0 +1,654 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file BlockStore.cpp
+ *  @brief the RLP of the committed blocks in append-only segment files
+ */
+
+#include "BlockStore.h"
+#include <fcntl.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/SnappyCompress.h>
+#include <libdevcore/easylog.h>
+#include <libstorage/StorageException.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#define BLOCKSTORE_LOG(LEVEL) LOG(LEVEL) << LOG_BADGE("BLOCKSTORE")
+
+using namespace dev;
+using namespace dev::blockchain;
+using namespace dev::storage;
+
+namespace
+{
+/// number, offset, length, crc32 and hash of a block in the index file of a segment not sealed
+const size_t c_indexEntrySize = 56;
+/// magic, slots and blocks of a sealed segment
+const size_t c_sealedHeaderSize = 16;
+/// offset and length of each slot of a sealed segment
+const size_t c_numberEntrySize = 12;
+/// hash and slot of each block of a sealed segment, sorted by hash
+const size_t c_hashEntrySize = 36;
+const char c_sealedMagic[8] = {'B', 'C', 'O', 'S', 'B', 'L', 'K', '1'};
+
+uint32_t crc32(bytesConstRef _data)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(_data.data(), _data.size());
+    return crc.checksum();
+}
+
+void putUint32(byte* _out, uint32_t _value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        _out[i] = (byte)(_value >> (i * 8));
+    }
+}
+
+uint32_t getUint32(const byte* _in)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        value |= (uint32_t)_in[i] << (i * 8);
+    }
+    return value;
+}
+
+void putUint64(byte* _out, uint64_t _value)
+{
+    putUint32(_out, (uint32_t)_value);
+    putUint32(_out + 4, (uint32_t)(_value >> 32));
+}
+
+uint64_t getUint64(const byte* _in)
+{
+    return (uint64_t)getUint32(_in) | ((uint64_t)getUint32(_in + 4) << 32);
+}
+
+void writeAll(int _fd, const byte* _data, size_t _size, uint64_t _offset, std::string const& _path)
+{
+    size_t written = 0;
+    while (written < _size)
+    {
+        auto size = ::pwrite(_fd, _data + written, _size - written, _offset + written);
+        if (size < 0)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Write block store failed: " + _path));
+        }
+        written += size;
+    }
+}
+
+bool readAll(int _fd, byte* _data, size_t _size, uint64_t _offset)
+{
+    size_t read = 0;
+    while (read < _size)
+    {
+        auto size = ::pread(_fd, _data + read, _size - read, _offset + read);
+        if (size <= 0)
+        {
+            return false;
+        }
+        read += size;
+    }
+    return true;
+}
+
+void syncDirectory(std::string const& _path)
+{
+    auto dir = ::open(_path.c_str(), O_RDONLY);
+    if (dir >= 0)
+    {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+}  // namespace
+
+struct BlockStore::Segment
+{
+    struct Location
+    {
+        uint64_t offset;
+        uint32_t length;
+        h256 hash;
+    };
+
+    ~Segment()
+    {
+        if (map)
+        {
+            ::munmap(map, mapSize);
+        }
+        if (dataFd >= 0)
+        {
+            ::close(dataFd);
+        }
+        if (indexFd >= 0)
+        {
+            ::close(indexFd);
+        }
+    }
+
+    bool sealed() const { return map != nullptr; }
+
+    int64_t first = 0;
+
+    /// the file of a sealed segment mapped
+    byte* map = nullptr;
+    size_t mapSize = 0;
+    uint32_t count = 0;
+
+    /// the files of the segment appended, and its blocks
+    int dataFd = -1;
+    int indexFd = -1;
+    uint64_t dataSize = 0;
+    std::map<int64_t, Location> blocks;
+    std::map<h256, int64_t> hashes;
+};
+
+BlockStore::BlockStore(std::string const& _path, int64_t _segmentBlocks)
+  : m_path(_path), m_segmentBlocks(std::max<int64_t>(_segmentBlocks, 1))
+{}
+
+BlockStore::~BlockStore()
+{
+    waitSealed();
+}
+
+void BlockStore::open()
+{
+    std::lock_guard<std::mutex> l(x_append);
+    boost::filesystem::create_directories(m_path);
+
+    std::map<int64_t, bool> files;
+    for (boost::filesystem::directory_iterator it(m_path);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        auto extension = it->path().extension();
+        if (extension == ".tmp")
+        {
+            /// a segment whose sealing was interrupted
+            boost::filesystem::remove(it->path());
+            continue;
+        }
+        int64_t segment = 0;
+        if ((extension == ".sealed" || extension == ".blocks") &&
+            boost::conversion::try_lexical_convert(it->path().stem().string(), segment))
+        {
+            files[segment] |= (extension == ".sealed");
+        }
+    }
+
+    std::vector<int64_t> toSeal;
+    for (auto const& file : files)
+    {
+        std::shared_ptr<Segment> segment;
+        if (file.second)
+        {
+            /// the files it was sealed from are left if the node stopped right after sealing
+            boost::system::error_code error;
+            boost::filesystem::remove(segmentPath(file.first, ".blocks"), error);
+            boost::filesystem::remove(segmentPath(file.first, ".index"), error);
+            segment = openSealed(file.first);
+        }
+        else
+        {
+            segment = openActive(file.first);
+            if (file.first != files.rbegin()->first)
+            {
+                toSeal.push_back(file.first);
+            }
+        }
+        WriteGuard ll(x_segments);
+        m_segments[file.first] = segment;
+    }
+
+    for (auto it = m_segments.rbegin(); it != m_segments.rend() && m_number < 0; ++it)
+    {
+        auto const& segment = *it->second;
+        if (!segment.sealed())
+        {
+            m_number = segment.blocks.empty() ? -1 : segment.blocks.rbegin()->first;
+            continue;
+        }
+        for (int64_t slot = m_segmentBlocks - 1; slot >= 0 && m_number < 0; --slot)
+        {
+            if (getUint32(segment.map + c_sealedHeaderSize + slot * c_numberEntrySize + 8) > 0)
+            {
+                m_number = segment.first + slot;
+            }
+        }
+    }
+
+    for (auto segment : toSeal)
+    {
+        seal(segment);
+    }
+
+    BLOCKSTORE_LOG(INFO) << LOG_DESC("open") << LOG_KV("path", m_path)
+                         << LOG_KV("segments", m_segments.size())
+                         << LOG_KV("sealed", sealedSegments()) << LOG_KV("number", m_number);
+}
+
+void BlockStore::append(int64_t _number, h256 const& _hash, bytesConstRef _rlp)
+{
+    std::lock_guard<std::mutex> l(x_append);
+    if (_number <= m_number || _rlp.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return;
+    }
+
+    int64_t first = _number / m_segmentBlocks * m_segmentBlocks;
+    std::shared_ptr<Segment> segment;
+    std::vector<int64_t> toSeal;
+    {
+        ReadGuard ll(x_segments);
+        auto it = m_segments.find(first);
+        if (it != m_segments.end())
+        {
+            segment = it->second;
+        }
+    }
+    if (!segment)
+    {
+        /// the segments before are appended no more
+        segment = openActive(first);
+        WriteGuard ll(x_segments);
+        for (auto const& it : m_segments)
+        {
+            if (!it.second->sealed())
+            {
+                toSeal.push_back(it.first);
+            }
+        }
+        m_segments[first] = segment;
+    }
+    if (segment->sealed())
+    {
+        return;
+    }
+
+    /// a record torn by a crash is cut off at open by the index entry missing or the crc
+    auto dataPath = segmentPath(first, ".blocks");
+    writeAll(segment->dataFd, _rlp.data(), _rlp.size(), segment->dataSize, dataPath);
+    byte entry[c_indexEntrySize];
+    putUint64(entry, (uint64_t)_number);
+    putUint64(entry + 8, segment->dataSize);
+    putUint32(entry + 16, (uint32_t)_rlp.size());
+    putUint32(entry + 20, crc32(_rlp));
+    memcpy(entry + 24, _hash.data(), h256::size);
+    writeAll(segment->indexFd, entry, c_indexEntrySize, segment->blocks.size() * c_indexEntrySize,
+        segmentPath(first, ".index"));
+    {
+        WriteGuard ll(x_segments);
+        segment->blocks[_number] =
+            Segment::Location{segment->dataSize, (uint32_t)_rlp.size(), _hash};
+        segment->hashes[_hash] = _number;
+        segment->dataSize += _rlp.size();
+        m_number = _number;
+    }
+
+    if (!toSeal.empty())
+    {
+        /// a segment is sealed at a time, normally long before the next one is full
+        if (m_sealing.valid())
+        {
+            m_sealing.wait();
+        }
+        m_sealing = std::async(std::launch::async, [this, toSeal]() {
+            for (auto segment : toSeal)
+            {
+                seal(segment);
+            }
+        });
+    }
+}
+
+std::shared_ptr<bytes> BlockStore::get(int64_t _number) const
+{
+    if (_number < 0)
+    {
+        return nullptr;
+    }
+    ReadGuard l(x_segments);
+    auto it = m_segments.find(_number / m_segmentBlocks * m_segmentBlocks);
+    if (it == m_segments.end())
+    {
+        return nullptr;
+    }
+    return read(*it->second, _number);
+}
+
+std::shared_ptr<bytes> BlockStore::get(h256 const& _hash) const
+{
+    ReadGuard l(x_segments);
+    /// the latest blocks are looked up the most
+    for (auto it = m_segments.rbegin(); it != m_segments.rend(); ++it)
+    {
+        auto const& segment = *it->second;
+        if (!segment.sealed())
+        {
+            auto hashIt = segment.hashes.find(_hash);
+            if (hashIt != segment.hashes.end())
+            {
+                return read(segment, hashIt->second);
+            }
+            continue;
+        }
+
+        const byte* hashes = segment.map + c_sealedHeaderSize + m_segmentBlocks * c_numberEntrySize;
+        size_t low = 0;
+        size_t high = segment.count;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            int compare = memcmp(hashes + middle * c_hashEntrySize, _hash.data(), h256::size);
+            if (compare == 0)
+            {
+                auto slot = getUint32(hashes + middle * c_hashEntrySize + h256::size);
+                return read(segment, segment.first + slot);
+            }
+            if (compare < 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+    }
+    return nullptr;
+}
+
+int64_t BlockStore::number() const
+{
+    ReadGuard l(x_segments);
+    return m_number;
+}
+
+size_t BlockStore::segments() const
+{
+    ReadGuard l(x_segments);
+    return m_segments.size();
+}
+
+size_t BlockStore::sealedSegments() const
+{
+    ReadGuard l(x_segments);
+    size_t sealed = 0;
+    for (auto const& it : m_segments)
+    {
+        sealed += it.second->sealed() ? 1 : 0;
+    }
+    return sealed;
+}
+
+void BlockStore::waitSealed()
+{
+    std::lock_guard<std::mutex> l(x_append);
+    if (m_sealing.valid())
+    {
+        m_sealing.wait();
+    }
+}
+
+std::string BlockStore::segmentPath(int64_t _segment, std::string const& _extension) const
+{
+    std::stringstream ss;
+    ss << m_path << "/" << std::setw(20) << std::setfill('0') << _segment << _extension;
+    return ss.str();
+}
+
+std::shared_ptr<BlockStore::Segment> BlockStore::openActive(int64_t _segment)
+{
+    auto segment = std::make_shared<Segment>();
+    segment->first = _segment;
+    auto dataPath = segmentPath(_segment, ".blocks");
+    auto indexPath = segmentPath(_segment, ".index");
+    segment->dataFd = ::open(dataPath.c_str(), O_RDWR | O_CREAT, 0644);
+    segment->indexFd = ::open(indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (segment->dataFd < 0 || segment->indexFd < 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Open block store failed: " + dataPath));
+    }
+
+    struct stat dataStat;
+    struct stat indexStat;
+    ::fstat(segment->dataFd, &dataStat);
+    ::fstat(segment->indexFd, &indexStat);
+    bytes index(indexStat.st_size / c_indexEntrySize * c_indexEntrySize);
+    if (!readAll(segment->indexFd, index.data(), index.size(), 0))
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Read block store failed: " + indexPath));
+    }
+
+    bytes payload;
+    for (size_t offset = 0; offset < index.size(); offset += c_indexEntrySize)
+    {
+        auto number = (int64_t)getUint64(&index[offset]);
+        Segment::Location location{getUint64(&index[offset + 8]), getUint32(&index[offset + 16]),
+            h256(bytesConstRef(&index[offset + 24], h256::size))};
+        auto crc = getUint32(&index[offset + 20]);
+        payload.resize(location.length);
+        if (number < _segment || number >= _segment + m_segmentBlocks ||
+            (!segment->blocks.empty() && number <= segment->blocks.rbegin()->first) ||
+            location.offset != segment->dataSize ||
+            location.offset + location.length > (uint64_t)dataStat.st_size ||
+            !readAll(segment->dataFd, payload.data(), payload.size(), location.offset) ||
+            crc32(ref(payload)) != crc)
+        {
+            BLOCKSTORE_LOG(WARNING) << LOG_DESC("Cut off torn block") << LOG_KV("segment", dataPath)
+                                    << LOG_KV("number", number);
+            break;
+        }
+        segment->blocks[number] = location;
+        segment->hashes[location.hash] = number;
+        segment->dataSize += location.length;
+    }
+    if (::ftruncate(segment->dataFd, segment->dataSize) != 0 ||
+        ::ftruncate(segment->indexFd, segment->blocks.size() * c_indexEntrySize) != 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Truncate block store failed: " + dataPath));
+    }
+    syncDirectory(m_path);
+    return segment;
+}
+
+std::shared_ptr<BlockStore::Segment> BlockStore::openSealed(int64_t _segment)
+{
+    auto path = segmentPath(_segment, ".sealed");
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Open block store failed: " + path));
+    }
+    struct stat fileStat;
+    ::fstat(fd, &fileStat);
+    auto segment = std::make_shared<Segment>();
+    segment->first = _segment;
+    segment->mapSize = fileStat.st_size;
+    size_t indexSize = c_sealedHeaderSize + m_segmentBlocks * c_numberEntrySize;
+    if (segment->mapSize >= indexSize)
+    {
+        auto map = ::mmap(nullptr, segment->mapSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            segment->map = (byte*)map;
+            /// the blocks are read at random
+            ::madvise(map, segment->mapSize, MADV_RANDOM);
+        }
+    }
+    ::close(fd);
+    if (!segment->map || memcmp(segment->map, c_sealedMagic, sizeof(c_sealedMagic)) != 0 ||
+        getUint32(segment->map + 8) != (uint32_t)m_segmentBlocks ||
+        indexSize + getUint32(segment->map + 12) * c_hashEntrySize > segment->mapSize)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Invalid sealed block store: " + path));
+    }
+    segment->count = getUint32(segment->map + 12);
+    return segment;
+}
+
+void BlockStore::seal(int64_t _segment)
+{
+    std::shared_ptr<Segment> active;
+    {
+        ReadGuard l(x_segments);
+        auto it = m_segments.find(_segment);
+        if (it == m_segments.end() || it->second->sealed())
+        {
+            return;
+        }
+        active = it->second;
+    }
+
+    auto startTime = utcTime();
+    auto path = segmentPath(_segment, ".sealed");
+    auto tmpPath = path + ".tmp";
+    try
+    {
+        /// the segment is appended no more, its blocks are read without the lock
+        size_t count = active->blocks.size();
+        uint64_t offset = c_sealedHeaderSize + m_segmentBlocks * c_numberEntrySize +
+                          count * c_hashEntrySize;
+        bytes index(offset);
+        memcpy(index.data(), c_sealedMagic, sizeof(c_sealedMagic));
+        putUint32(&index[8], (uint32_t)m_segmentBlocks);
+        putUint32(&index[12], (uint32_t)count);
+
+        auto fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Open block store failed: " + tmpPath));
+        }
+        std::shared_ptr<void> closer(nullptr, [fd](void*) { ::close(fd); });
+
+        uint64_t rawBytes = 0;
+        bytes payload;
+        bytes compressed;
+        std::vector<std::pair<h256, uint32_t>> hashes;
+        for (auto const& block : active->blocks)
+        {
+            auto const& location = block.second;
+            payload.resize(location.length);
+            if (!readAll(active->dataFd, payload.data(), payload.size(), location.offset) ||
+                compress::SnappyCompress::compress(ref(payload), compressed) == 0)
+            {
+                BOOST_THROW_EXCEPTION(StorageException(-1, "Compress block store failed: " + path));
+            }
+            writeAll(fd, compressed.data(), compressed.size(), offset, tmpPath);
+            auto slot = (uint32_t)(block.first - _segment);
+            putUint64(&index[c_sealedHeaderSize + slot * c_numberEntrySize], offset);
+            putUint32(
+                &index[c_sealedHeaderSize + slot * c_numberEntrySize + 8], compressed.size());
+            hashes.push_back(std::make_pair(location.hash, slot));
+            offset += compressed.size();
+            rawBytes += payload.size();
+        }
+        std::sort(hashes.begin(), hashes.end());
+        byte* hashIndex = &index[c_sealedHeaderSize + m_segmentBlocks * c_numberEntrySize];
+        for (size_t i = 0; i < hashes.size(); ++i)
+        {
+            memcpy(hashIndex + i * c_hashEntrySize, hashes[i].first.data(), h256::size);
+            putUint32(hashIndex + i * c_hashEntrySize + h256::size, hashes[i].second);
+        }
+        writeAll(fd, index.data(), index.size(), 0, tmpPath);
+        if (::fsync(fd) != 0)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Sync block store failed: " + tmpPath));
+        }
+        boost::filesystem::rename(tmpPath, path);
+        syncDirectory(m_path);
+
+        auto sealed = openSealed(_segment);
+        {
+            WriteGuard l(x_segments);
+            m_segments[_segment] = sealed;
+        }
+        /// the readers of the old segment still hold its files open
+        boost::system::error_code error;
+        boost::filesystem::remove(segmentPath(_segment, ".blocks"), error);
+        boost::filesystem::remove(segmentPath(_segment, ".index"), error);
+
+        BLOCKSTORE_LOG(INFO) << LOG_DESC("seal") << LOG_KV("segment", _segment)
+                             << LOG_KV("blocks", count) << LOG_KV("rawBytes", rawBytes)
+                             << LOG_KV("sealedBytes", offset)
+                             << LOG_KV("timeCost", utcTime() - startTime);
+    }
+    catch (std::exception const& e)
+    {
+        /// the segment is served from its files appended until it is sealed at the next open
+        BLOCKSTORE_LOG(ERROR) << LOG_DESC("seal failed") << LOG_KV("segment", _segment)
+                              << LOG_KV("what", boost::diagnostic_information(e));
+        boost::system::error_code error;
+        boost::filesystem::remove(tmpPath, error);
+    }
+}
+
+std::shared_ptr<bytes> BlockStore::read(Segment const& _segment, int64_t _number) const
+{
+    if (!_segment.sealed())
+    {
+        auto it = _segment.blocks.find(_number);
+        if (it == _segment.blocks.end())
+        {
+            return nullptr;
+        }
+        auto rlp = std::make_shared<bytes>(it->second.length);
+        if (!readAll(_segment.dataFd, rlp->data(), rlp->size(), it->second.offset))
+        {
+            BLOCKSTORE_LOG(ERROR) << LOG_DESC("read failed") << LOG_KV("number", _number);
+            return nullptr;
+        }
+        return rlp;
+    }
+
+    auto slot = _number - _segment.first;
+    if (slot < 0 || slot >= m_segmentBlocks)
+    {
+        return nullptr;
+    }
+    const byte* entry = _segment.map + c_sealedHeaderSize + slot * c_numberEntrySize;
+    auto offset = getUint64(entry);
+    auto length = getUint32(entry + 8);
+    if (length == 0)
+    {
+        return nullptr;
+    }
+    auto rlp = std::make_shared<bytes>();
+    if (offset + length > _segment.mapSize ||
+        compress::SnappyCompress::uncompress(bytesConstRef(_segment.map + offset, length), *rlp) ==
+            0)
+    {
+        BLOCKSTORE_LOG(ERROR) << LOG_DESC("uncompress failed") << LOG_KV("number", _number);
+        return nullptr;
+    }
+    return rlp;
+}
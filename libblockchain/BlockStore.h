@@ -0,0 +1,90 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file BlockStore.h
+ *  @brief the RLP of the committed blocks in append-only segment files
+ */
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dev
+{
+namespace blockchain
+{
+/// the blocks of a segment
+static const int64_t c_blockStoreSegmentBlocks = 10000;
+
+/// The RLP of the committed blocks, read without going through the storage. The segment k holds
+/// the blocks k*segmentBlocks to (k+1)*segmentBlocks-1. The blocks are appended to the data file
+/// of the last segment and their offsets, lengths, crc32 and hashes to its index file. A segment
+/// full is sealed in the background: its blocks are compressed by snappy one by one into a file
+/// holding an index by number and an index sorted by hash, which is mapped into memory and read
+/// in place. The store is filled after the storage, a block missing from it is read from the
+/// storage.
+class BlockStore
+{
+public:
+    typedef std::shared_ptr<BlockStore> Ptr;
+
+    BlockStore(std::string const& _path, int64_t _segmentBlocks = c_blockStoreSegmentBlocks);
+    ~BlockStore();
+
+    /// must be called before the first append, the torn records left by a crash are cut off and
+    /// the segments full but not sealed are sealed
+    void open();
+    /// append the RLP of the block _number, ignored unless it is after the last block appended
+    void append(int64_t _number, dev::h256 const& _hash, dev::bytesConstRef _rlp);
+    /// null if the block is not in the store
+    std::shared_ptr<dev::bytes> get(int64_t _number) const;
+    std::shared_ptr<dev::bytes> get(dev::h256 const& _hash) const;
+
+    /// the last block appended, -1 if none is
+    int64_t number() const;
+    size_t segments() const;
+    size_t sealedSegments() const;
+    /// wait for the segment being sealed
+    void waitSealed();
+
+private:
+    struct Segment;
+
+    std::string segmentPath(int64_t _segment, std::string const& _extension) const;
+    std::shared_ptr<Segment> openActive(int64_t _segment);
+    std::shared_ptr<Segment> openSealed(int64_t _segment);
+    /// write the sealed file of the full segment _segment and swap it in
+    void seal(int64_t _segment);
+    std::shared_ptr<dev::bytes> read(Segment const& _segment, int64_t _number) const;
+
+    std::string m_path;
+    int64_t m_segmentBlocks;
+
+    mutable SharedMutex x_segments;
+    std::map<int64_t, std::shared_ptr<Segment>> m_segments;
+    int64_t m_number = -1;
+
+    /// orders the appends and the launch of sealing
+    std::mutex x_append;
+    std::future<void> m_sealing;
+};
+}  // namespace blockchain
+}  // namespace dev
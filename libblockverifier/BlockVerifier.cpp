@@ -21,14 +21,25 @@
 #include "BlockVerifier.h"
 #include "ExecutiveContext.h"
 #include "TxDAG.h"
+#include <libdevcore/CommonIO.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/PrecompiledContract.h>
 #include <libethcore/TransactionReceipt.h>
 #include <libexecutive/ExecutionResult.h>
 #include <libexecutive/Executive.h>
+#include <libstorage/AccessSet.h>
+#include <libstorage/CachedStorage.h>
+#include <libstorage/ChangeLog.h>
+#include <libstorage/MemoryTableFactory2.h>
 #include <libstorage/Table.h>
+#include <tbb/concurrent_unordered_map.h>
+#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
 #include <exception>
+#include <set>
+#include <sstream>
 #include <thread>
 
 using namespace dev;
@@ -39,6 +50,34 @@ using namespace dev::executive;
 using namespace dev::storage;
 
 ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const& parentBlockInfo)
+{
+    if (!m_arena)
+    {
+        return executeBlockInArena(block, parentBlockInfo);
+    }
+    ExecutiveContext::Ptr executiveContext;
+    m_arena->execute(
+        [&]() { executiveContext = executeBlockInArena(block, parentBlockInfo); });
+    return executiveContext;
+}
+
+BlockVerifier::NumberHashCallBackFunction BlockVerifier::parentNumberHash(
+    BlockInfo const& parentBlockInfo) const
+{
+    if (!parentBlockInfo.stateStorage)
+    {
+        return m_pNumberHash;
+    }
+    auto numberHash = m_pNumberHash;
+    auto parentHash = parentBlockInfo.hash;
+    auto parentNumber = parentBlockInfo.number;
+    return [numberHash, parentHash, parentNumber](int64_t _number) {
+        return _number == parentNumber ? parentHash : numberHash(_number);
+    };
+}
+
+ExecutiveContext::Ptr BlockVerifier::executeBlockInArena(
+    Block& block, BlockInfo const& parentBlockInfo)
 {
     if (g_BCOSConfig.version() >= RC2_VERSION && m_enableParallel)
     {
@@ -50,6 +89,51 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
     }
 }
 
+ExecutiveContext::Ptr BlockVerifier::applyStateDiff(
+    Block& block, BlockInfo const& parentBlockInfo, StateDiff const& stateDiff)
+{
+    uint64_t startTime = utcTime();
+    BlockHeader tmpHeader = block.blockHeader();
+    // the receipts aren't produced, the ones of the block are checked against the header
+    block.calReceiptRoot();
+    h256 dbHash = stateDiff.dbHash();
+    if (stateDiff.blockHash != tmpHeader.hash() || dbHash != tmpHeader.dbHash() ||
+        dbHash != tmpHeader.stateRoot() || tmpHeader != block.blockHeader())
+    {
+        BLOCKVERIFIER_LOG(ERROR) << LOG_BADGE("applyStateDiff") << LOG_DESC("Invalid state diff")
+                                 << LOG_KV("blkNum", tmpHeader.number())
+                                 << LOG_KV("hash", tmpHeader.hash().abridged())
+                                 << LOG_KV("diffHash", stateDiff.blockHash.abridged())
+                                 << LOG_KV("orgDBHash", tmpHeader.dbHash().abridged())
+                                 << LOG_KV("curDBHash", dbHash.abridged())
+                                 << LOG_KV("orgReceipt", tmpHeader.receiptsRoot().abridged())
+                                 << LOG_KV("curReceipt", block.header().receiptsRoot().abridged());
+        // the block may be executed instead
+        block.header().setReceiptsRoot(tmpHeader.receiptsRoot());
+        BOOST_THROW_EXCEPTION(
+            InvalidBlockWithBadStateOrReceipt() << errinfo_comment("Invalid state diff"));
+    }
+
+    ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
+    m_executiveContextFactory->initExecutiveContext(
+        parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+    auto tableFactory =
+        dynamic_pointer_cast<MemoryTableFactory2>(executiveContext->getMemoryTableFactory());
+    if (!tableFactory)
+    {
+        BOOST_THROW_EXCEPTION(InvalidBlockWithBadStateOrReceipt()
+                              << errinfo_comment("State diff without MemoryTableFactory2"));
+    }
+    // throws if a dirty entry of the diff isn't a row of the parent state, the ids aren't hashed
+    tableFactory->applyDiff(stateDiff.datas);
+
+    BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("applyStateDiff") << LOG_DESC("Apply state diff takes")
+                             << LOG_KV("time(ms)", utcTime() - startTime)
+                             << LOG_KV("tables", stateDiff.datas.size())
+                             << LOG_KV("num", tmpHeader.number());
+    return executiveContext;
+}
+
 ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     Block& block, BlockInfo const& parentBlockInfo)
 {
@@ -94,13 +178,15 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
                              << LOG_KV("num", block.blockHeader().number());
     uint64_t pastTime = utcTime();
 
+    auto numberHash = parentNumberHash(parentBlockInfo);
     try
     {
         for (size_t i = 0; i < block.transactions().size(); i++)
         {
             auto& tx = block.transactions()[i];
-            EnvInfo envInfo(block.blockHeader(), m_pNumberHash, 0);
+            EnvInfo envInfo(block.blockHeader(), numberHash, 0);
             envInfo.setPrecompiledEngine(executiveContext);
+            envInfo.setEVMCCreateFn(m_evmcCreateFn);
             std::pair<ExecutionResult, TransactionReceipt> resultReceipt =
                 execute(envInfo, tx, OnOpFunc(), executiveContext);
             block.setTransactionReceipt(i, resultReceipt.second);
@@ -205,14 +291,64 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
     auto perpareBlock_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
+    DAGProfile::Ptr profile;
+    if (m_profile)
+    {
+        profile = make_shared<DAGProfile>();
+        profile->blockNumber = block.blockHeader().number();
+    }
     shared_ptr<TxDAG> txDag = make_shared<TxDAG>();
-    txDag->init(executiveContext, block.transactions(), block.blockHeader().number());
+    txDag->setProfile(profile);
+    std::pair<size_t, size_t> prefetchResult;
+    uint64_t prefetch_time_cost = 0;
+    tbb::parallel_invoke(
+        [&]() {
+            txDag->init(executiveContext, block.transactions(), block.blockHeader().number());
+        },
+        [&]() {
+            auto prefetchStart = utcTime();
+            prefetchResult =
+                prefetchTxCriticals(executiveContext, block.transactions(), parentBlockInfo);
+            prefetch_time_cost = utcTime() - prefetchStart;
+        });
+
+    // Normal transactions conflict with all transactions in the DAG of the parallel tags. They
+    // are executed along the keys they accessed in a speculative run instead, the block is
+    // executed in serial if a transaction accesses a key it did not access in that run.
+    std::vector<AccessSet::Ptr> predictedAccesses;
+    uint64_t speculate_time_cost = 0;
+    if (m_optimistic && txDag->normalTxsNumber() > 0 &&
+        std::dynamic_pointer_cast<MemoryTableFactory2>(memoryTableFactory))
+    {
+        auto speculateStart = utcTime();
+        predictedAccesses = speculateTxAccesses(block, parentBlockInfo);
+        txDag = make_shared<TxDAG>();
+        if (profile)
+        {
+            profile = make_shared<DAGProfile>();
+            profile->blockNumber = block.blockHeader().number();
+        }
+        txDag->setProfile(profile);
+        txDag->init(block.transactions(), predictedAccesses, block.blockHeader().number());
+        speculate_time_cost = utcTime() - speculateStart;
+    }
 
+    auto numberHash = parentNumberHash(parentBlockInfo);
     txDag->setTxExecuteFunc([&](Transaction const& _tr, ID _txId) {
-        EnvInfo envInfo(block.blockHeader(), m_pNumberHash, 0);
+        EnvInfo envInfo(block.blockHeader(), numberHash, 0);
         envInfo.setPrecompiledEngine(executiveContext);
+        envInfo.setEVMCCreateFn(m_evmcCreateFn);
+        AccessSet accessSet;
+        AccessSet::Scope accessSetScope(predictedAccesses.empty() ? nullptr : &accessSet);
         std::pair<ExecutionResult, TransactionReceipt> resultReceipt =
             execute(envInfo, _tr, OnOpFunc(), executiveContext);
+        if (!predictedAccesses.empty() && predictedAccesses[_txId] &&
+            !accessSet.coveredBy(*predictedAccesses[_txId]))
+        {
+            BOOST_THROW_EXCEPTION(MispredictedTxAccess() << errinfo_comment(
+                                      "transaction " + std::to_string(_txId) +
+                                      " accessed keys out of its speculative execution"));
+        }
         block.setTransactionReceipt(_txId, resultReceipt.second);
         executiveContext->getState()->commit();
         return true;
@@ -220,31 +356,19 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
     auto initDag_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
-    auto parallelTimeOut = utcTime() + 30000;  // 30 timeout
-
+    DAGScheduler::Stats dagStats;
     try
     {
-        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_threadNum),
-            [&](const tbb::blocked_range<unsigned int>& _r) {
-                (void)_r;
-                while (!txDag->hasFinished())
-                {
-                    if (utcTime() >= parallelTimeOut)
-                    {
-                        BLOCKVERIFIER_LOG(WARNING)
-                            << LOG_BADGE("executeBlock") << LOG_DESC("Para execute block timeout")
-                            << LOG_KV("txNum", block.transactions().size())
-                            << LOG_KV("blockNumber", block.blockHeader().number());
-
-#if 0
-                        BOOST_THROW_EXCEPTION(BlockExecutionFailed()
-                                              << errinfo_comment("Para execute block timeout"));
-#endif
-                    }
-
-                    txDag->executeUnit();
-                }
-            });
+        dagStats = txDag->executeAll(
+            m_arena ? (unsigned int)m_arena->max_concurrency() : m_threadNum);
+    }
+    catch (MispredictedTxAccess& e)
+    {
+        BLOCKVERIFIER_LOG(INFO) << LOG_BADGE("executeBlock")
+                                << LOG_DESC("Mispredicted transaction access, execute in serial")
+                                << LOG_KV("num", block.blockHeader().number())
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return serialExecuteBlock(block, parentBlockInfo);
     }
     catch (exception& e)
     {
@@ -308,14 +432,307 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
                              << LOG_KV("initExeCtxTimeCost", initExeCtx_time_cost)
                              << LOG_KV("perpareBlockTimeCost", perpareBlock_time_cost)
                              << LOG_KV("initDagTimeCost", initDag_time_cost)
+                             << LOG_KV("prefetchTimeCost", prefetch_time_cost)
+                             << LOG_KV("prefetchKeys", prefetchResult.first)
+                             << LOG_KV("prefetchHitKeys", prefetchResult.second)
+                             << LOG_KV("speculateTimeCost", speculate_time_cost)
                              << LOG_KV("exeTimeCost", exe_time_cost)
+                             << LOG_KV("dagWidth", dagStats.width)
+                             << LOG_KV("criticalPath", dagStats.criticalPath)
+                             << LOG_KV("steals", dagStats.steals)
+                             << LOG_KV("idleTime(us)", dagStats.idleTime)
                              << LOG_KV("getRootHashTimeCost", getRootHash_time_cost)
                              << LOG_KV("setAllReceiptTimeCost", setAllReceipt_time_cost)
                              << LOG_KV("getReceiptRootTimeCost", getReceiptRoot_time_cost)
                              << LOG_KV("setStateRootTimeCost", setStateRoot_time_cost);
+    if (profile)
+    {
+        reportProfile(*profile, block);
+    }
     return executiveContext;
 }
 
+void BlockVerifier::reportProfile(DAGProfile const& _profile, Block const& block)
+{
+    // the transactions listed at most, the others are only counted
+    static const size_t c_maxListed = 10;
+    auto hashes = [&](IDs const& _ids) {
+        std::stringstream ss;
+        for (size_t i = 0; i < _ids.size() && i < c_maxListed; ++i)
+        {
+            ss << (i > 0 ? "," : "") << block.transactions()[_ids[i]].sha3().abridged();
+        }
+        if (_ids.size() > c_maxListed)
+        {
+            ss << ",...";
+        }
+        return ss.str();
+    };
+
+    std::stringstream widths;
+    for (auto const& widthAndLevels : _profile.widthHistogram())
+    {
+        widths << widthAndLevels.first << ":" << widthAndLevels.second << " ";
+    }
+    std::stringstream fields;
+    for (auto const& fieldAndEdges : _profile.topFields(5))
+    {
+        fields << fieldAndEdges.first << ":" << fieldAndEdges.second << " ";
+    }
+    std::stringstream workers;
+    for (size_t i = 0; i < _profile.busyTime.size(); ++i)
+    {
+        workers << _profile.busyTime[i] << "/" << _profile.idleTime[i] << " ";
+    }
+
+    BLOCKVERIFIER_LOG(INFO) << LOG_BADGE("DAGProfile") << LOG_KV("num", _profile.blockNumber)
+                            << LOG_KV("txNum", block.transactions().size())
+                            << LOG_KV("levels", _profile.levelWidths.size())
+                            << LOG_KV("widthHistogram(width:levels)", widths.str())
+                            << LOG_KV("criticalPath", _profile.criticalPath.size())
+                            << LOG_KV("criticalPathTxs", hashes(_profile.criticalPath))
+                            << LOG_KV("topFields(field:edges)", fields.str())
+                            << LOG_KV("barriers", _profile.barriers.size())
+                            << LOG_KV("barrierTxs", hashes(_profile.barriers))
+                            << LOG_KV("workers(busy/idle us)", workers.str());
+
+    if (m_profileTracePath.empty())
+    {
+        return;
+    }
+    auto path = boost::filesystem::path(m_profileTracePath) /
+                ("block_" + std::to_string(_profile.blockNumber) + ".trace.json");
+    try
+    {
+        auto trace = _profile.chromeTrace(block.transactions());
+        writeFile(path, bytesConstRef(&trace));
+    }
+    catch (std::exception& e)
+    {
+        BLOCKVERIFIER_LOG(WARNING) << LOG_BADGE("DAGProfile") << LOG_DESC("Write trace failed")
+                                   << LOG_KV("path", path.string())
+                                   << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
+std::pair<size_t, size_t> BlockVerifier::prefetchTxCriticals(
+    ExecutiveContext::Ptr executiveContext, Transactions const& _txs, BlockInfo const& blockInfo)
+{
+    auto memoryTableFactory = std::dynamic_pointer_cast<dev::storage::MemoryTableFactory2>(
+        executiveContext->getMemoryTableFactory());
+    if (!memoryTableFactory)
+    {
+        return std::make_pair(0, 0);
+    }
+
+    auto cachedStorage =
+        std::dynamic_pointer_cast<dev::storage::CachedStorage>(memoryTableFactory->stateStorage());
+    if (!cachedStorage)
+    {
+        return std::make_pair(0, 0);
+    }
+
+    // table -> parallel tags of the transactions
+    tbb::concurrent_unordered_map<std::string,
+        std::shared_ptr<tbb::concurrent_vector<std::string>>>
+        table2Keys;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _txs.size()),
+        [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i < _r.end(); ++i)
+            {
+                auto& tx = _txs[i];
+                if (tx.isCreation())
+                {
+                    continue;
+                }
+
+                auto precompiled = executiveContext->getPrecompiled(tx.receiveAddress());
+                if (!precompiled || !precompiled->isParallelPrecompiled())
+                {
+                    continue;
+                }
+
+                auto tableName = precompiled->getParallelTable();
+                if (tableName.empty())
+                {
+                    continue;
+                }
+
+                auto it = table2Keys.find(tableName);
+                if (it == table2Keys.end())
+                {
+                    it = table2Keys
+                             .insert(std::make_pair(tableName,
+                                 std::make_shared<tbb::concurrent_vector<std::string>>()))
+                             .first;
+                }
+
+                for (auto& tag : precompiled->getParallelTag(ref(tx.data())))
+                {
+                    it->second->push_back(tag);
+                }
+            }
+        });
+
+    tbb::atomic<size_t> total = 0;
+    tbb::atomic<size_t> hit = 0;
+    for (auto& it : table2Keys)
+    {
+        // opened the same way as the precompiled does, so the table is reused by the execution
+        auto table = memoryTableFactory->openTable(it.first);
+        if (!table)
+        {
+            continue;
+        }
+
+        std::set<std::string> keySet(it.second->begin(), it.second->end());
+        std::vector<std::string> keys(keySet.begin(), keySet.end());
+        auto batches = (keys.size() + m_prefetchBatchSize - 1) / m_prefetchBatchSize;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, batches),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i < _r.end(); ++i)
+                {
+                    auto begin = keys.begin() + i * m_prefetchBatchSize;
+                    auto end = (i + 1) * m_prefetchBatchSize < keys.size() ?
+                                   begin + m_prefetchBatchSize :
+                                   keys.end();
+                    std::vector<std::string> batch(begin, end);
+                    hit.fetch_and_add(cachedStorage->prefetch(
+                        blockInfo.hash, blockInfo.number, table->tableInfo(), batch));
+                    total.fetch_and_add(batch.size());
+                }
+            });
+    }
+
+    return std::make_pair(total.load(), hit.load());
+}
+
+std::vector<AccessSet::Ptr> BlockVerifier::speculateTxAccesses(
+    Block& block, BlockInfo const& parentBlockInfo)
+{
+    auto& txs = block.transactions();
+    std::vector<AccessSet::Ptr> accessSets(txs.size());
+    auto numberHash = parentNumberHash(parentBlockInfo);
+
+    // every thread executes on a context of its own, a transaction is undone before the next
+    // one starts, so they all run on the parent state
+    tbb::enumerable_thread_specific<ExecutiveContext::Ptr> executiveContexts;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, txs.size()), [&](const tbb::blocked_range<size_t>& _r) {
+            auto& executiveContext = executiveContexts.local();
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                try
+                {
+                    if (!executiveContext)
+                    {
+                        auto context = std::make_shared<ExecutiveContext>();
+                        m_executiveContextFactory->initExecutiveContext(
+                            parentBlockInfo, parentBlockInfo.stateRoot, context);
+                        executiveContext = context;
+                    }
+
+                    auto accessSet = std::make_shared<AccessSet>();
+                    EnvInfo envInfo(block.blockHeader(), numberHash, 0);
+                    envInfo.setPrecompiledEngine(executiveContext);
+                    envInfo.setEVMCCreateFn(m_evmcCreateFn);
+                    ChangeLog changeLog;
+                    {
+                        AccessSet::Scope accessSetScope(accessSet.get());
+                        execute(envInfo, txs[i], OnOpFunc(), executiveContext, changeLog);
+                    }
+                    changeLog.rollback(0);
+                    accessSets[i] = accessSet;
+                }
+                catch (exception& e)
+                {
+                    // the transaction conflicts with all transactions
+                    BLOCKVERIFIER_LOG(WARNING)
+                        << LOG_BADGE("speculateTxAccesses")
+                        << LOG_DESC("Speculative execution failed") << LOG_KV("tx", i)
+                        << LOG_KV("EINFO", boost::diagnostic_information(e));
+                    executiveContext = nullptr;
+                }
+            }
+        });
+
+    return accessSets;
+}
+
+std::vector<std::shared_ptr<std::vector<std::string>>> BlockVerifier::getTxsCriticals(
+    Transactions const& _txs, BlockInfo const& parentBlockInfo)
+{
+    std::vector<std::shared_ptr<std::vector<std::string>>> criticals;
+    ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
+    try
+    {
+        m_executiveContextFactory->initExecutiveContext(
+            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        // the parallel configs are read from a snapshot, like executeTransaction does
+        auto memoryTableFactory = std::dynamic_pointer_cast<dev::storage::MemoryTableFactory2>(
+            executiveContext->getMemoryTableFactory());
+        if (memoryTableFactory)
+        {
+            auto cachedStorage = std::dynamic_pointer_cast<dev::storage::CachedStorage>(
+                memoryTableFactory->stateStorage());
+            if (cachedStorage)
+            {
+                memoryTableFactory->setStateStorage(cachedStorage->snapshot());
+            }
+        }
+        for (auto const& tx : _txs)
+        {
+            criticals.push_back(executiveContext->getTxCriticals(tx));
+        }
+    }
+    catch (exception& e)
+    {
+        BLOCKVERIFIER_LOG(WARNING) << LOG_DESC("[getTxsCriticals] Error during getTxCriticals")
+                                   << LOG_KV("errorMsg", boost::diagnostic_information(e));
+        criticals.clear();
+    }
+    return criticals;
+}
+
+void BlockVerifier::preloadTransactions(Transactions const& _txs, BlockInfo const& parentBlockInfo)
+{
+    // only the parallel execution reads the parallel tags ahead
+    if (!m_enableParallel || _txs.empty())
+    {
+        return;
+    }
+    auto start = utcTime();
+    try
+    {
+        ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
+        m_executiveContextFactory->initExecutiveContext(
+            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        // the critical fields of the normal transactions read the parallel configs
+        size_t parallelTxs = 0;
+        for (auto const& tx : _txs)
+        {
+            if (executiveContext->getTxCriticals(tx))
+            {
+                ++parallelTxs;
+            }
+        }
+        auto prefetched = prefetchTxCriticals(executiveContext, _txs, parentBlockInfo);
+        BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("preloadTransactions")
+                                 << LOG_KV("parentNum", parentBlockInfo.number)
+                                 << LOG_KV("txNum", _txs.size())
+                                 << LOG_KV("parallelTxs", parallelTxs)
+                                 << LOG_KV("prefetchKeys", prefetched.first)
+                                 << LOG_KV("prefetchHit", prefetched.second)
+                                 << LOG_KV("timecost", utcTime() - start);
+    }
+    catch (exception& e)
+    {
+        BLOCKVERIFIER_LOG(WARNING) << LOG_BADGE("preloadTransactions")
+                                   << LOG_DESC("Error during preloading")
+                                   << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
 std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction(
     const BlockHeader& blockHeader, dev::eth::Transaction const& _t)
 {
@@ -325,6 +742,19 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction
     {
         m_executiveContextFactory->initExecutiveContext(
             blockInfo, blockHeader.stateRoot(), executiveContext);
+
+        // read from a snapshot of the cache, so the query doesn't contend with block commit
+        auto memoryTableFactory = std::dynamic_pointer_cast<dev::storage::MemoryTableFactory2>(
+            executiveContext->getMemoryTableFactory());
+        if (memoryTableFactory)
+        {
+            auto cachedStorage = std::dynamic_pointer_cast<dev::storage::CachedStorage>(
+                memoryTableFactory->stateStorage());
+            if (cachedStorage)
+            {
+                memoryTableFactory->setStateStorage(cachedStorage->snapshot());
+            }
+        }
     }
     catch (exception& e)
     {
@@ -335,11 +765,22 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction
 
     EnvInfo envInfo(blockHeader, m_pNumberHash, 0);
     envInfo.setPrecompiledEngine(executiveContext);
+    envInfo.setEVMCCreateFn(m_evmcCreateFn);
     return execute(envInfo, _t, OnOpFunc(), executiveContext);
 }
 
 std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo const& _envInfo,
     Transaction const& _t, OnOpFunc const& _onOp, ExecutiveContext::Ptr executiveContext)
+{
+    // The undo log belongs to this transaction, rolling back never touches the writes of
+    // another transaction even if it runs on the same thread
+    ChangeLog changeLog;
+    return execute(_envInfo, _t, _onOp, executiveContext, changeLog);
+}
+
+std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo const& _envInfo,
+    Transaction const& _t, OnOpFunc const& _onOp, ExecutiveContext::Ptr executiveContext,
+    ChangeLog& _changeLog)
 {
     auto onOp = _onOp;
 #if ETH_VMTRACE
@@ -347,6 +788,8 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo co
         onOp = Executive::simpleTrace();  // override tracer
 #endif
 
+    ChangeLog::Scope changeLogScope(_changeLog);
+
     // Create and initialize the executive. This will throw fairly cheaply and quickly if the
     // transaction is bad in any way.
     Executive e(executiveContext->getState(), _envInfo);
@@ -370,6 +813,8 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo co
     {
         BLOCKVERIFIER_LOG(ERROR) << _e.what();
     }
+    // the cached writes are recorded in the log and the access set of this transaction
+    executiveContext->getState()->flush();
     /// mptstate calculates every transactions
     /// storagestate ignore hash calculation
     return make_pair(
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "BlockVerifierInterface.h"
+#include "DAGProfile.h"
 #include "ExecutiveContext.h"
 #include "ExecutiveContextFactory.h"
 #include "Precompiled.h"
@@ -34,6 +35,10 @@
 #include <libevm/ExtVMFace.h>
 #include <libexecutive/ExecutionResult.h>
 #include <libmptstate/State.h>
+#include <libstorage/AccessSet.h>
+#include <libstorage/ChangeLog.h>
+#include <libstorage/StateDiff.h>
+#include <tbb/task_arena.h>
 #include <boost/function.hpp>
 #include <algorithm>
 #include <memory>
@@ -75,10 +80,20 @@ public:
         dev::eth::Block& block, BlockInfo const& parentBlockInfo);
     ExecutiveContext::Ptr parallelExecuteBlock(
         dev::eth::Block& block, BlockInfo const& parentBlockInfo);
+    // the context committing the tables the execution of the block changed instead of executing
+    // it, throws if they aren't the state signed by the header of the block
+    ExecutiveContext::Ptr applyStateDiff(dev::eth::Block& block, BlockInfo const& parentBlockInfo,
+        dev::storage::StateDiff const& stateDiff);
 
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t);
 
+    std::vector<std::shared_ptr<std::vector<std::string>>> getTxsCriticals(
+        dev::eth::Transactions const& _txs, BlockInfo const& parentBlockInfo) override;
+    // read the parallel configs of the contracts and the rows of the parallel tags into the cache
+    void preloadTransactions(
+        dev::eth::Transactions const& _txs, BlockInfo const& parentBlockInfo) override;
+
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> execute(
         dev::eth::EnvInfo const& _envInfo, dev::eth::Transaction const& _t,
         dev::eth::OnOpFunc const& _onOp,
@@ -94,11 +109,59 @@ public:
         m_pNumberHash = _pNumberHash;
     }
 
+    // execute blocks with transactions of no parallel tags along the keys they accessed in a
+    // speculative execution
+    void setOptimisticExecution(bool _optimistic) { m_optimistic = _optimistic; }
+
+    // execute the code of transactions on an EVMC VM, nullptr for the default VM
+    void setEVMCCreateFn(dev::eth::EVMCCreateFn _evmcCreateFn) { m_evmcCreateFn = _evmcCreateFn; }
+
+    // execute blocks in the arena of the group, its concurrency bounds the workers of a parallel
+    // block, nullptr for the default arena of the calling thread
+    void setTaskArena(std::shared_ptr<tbb::task_arena> _arena) { m_arena = _arena; }
+
+    // log what limited the parallelism of each parallel block, and write its trace to
+    // _tracePath/block_<number>.trace.json when _tracePath is not empty
+    void setProfile(bool _profile, std::string const& _tracePath = "")
+    {
+        m_profile = _profile;
+        m_profileTracePath = _tracePath;
+    }
+
 private:
+    // the parent of a block executed on a storage of its own isn't saved yet, its hash is taken
+    // from parentBlockInfo
+    NumberHashCallBackFunction parentNumberHash(BlockInfo const& parentBlockInfo) const;
+    ExecutiveContext::Ptr executeBlockInArena(
+        dev::eth::Block& block, BlockInfo const& parentBlockInfo);
+    std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> execute(
+        dev::eth::EnvInfo const& _envInfo, dev::eth::Transaction const& _t,
+        dev::eth::OnOpFunc const& _onOp, dev::blockverifier::ExecutiveContext::Ptr executiveContext,
+        dev::storage::ChangeLog& _changeLog);
+
+    // execute every transaction on the parent state and undo it, returns the keys each one
+    // accessed, nullptr for a transaction whose execution failed
+    std::vector<dev::storage::AccessSet::Ptr> speculateTxAccesses(
+        dev::eth::Block& block, BlockInfo const& parentBlockInfo);
+
+    // warm the state cache with the rows of the parallel tags, returns the prefetched keys and the
+    // keys already in the cache
+    std::pair<size_t, size_t> prefetchTxCriticals(ExecutiveContext::Ptr executiveContext,
+        dev::eth::Transactions const& _txs, BlockInfo const& blockInfo);
+
+    void reportProfile(DAGProfile const& _profile, dev::eth::Block const& block);
+
     ExecutiveContextFactory::Ptr m_executiveContextFactory;
     NumberHashCallBackFunction m_pNumberHash;
     bool m_enableParallel;
+    bool m_optimistic = false;
+    dev::eth::EVMCCreateFn m_evmcCreateFn = nullptr;
     unsigned int m_threadNum = -1;
+    std::shared_ptr<tbb::task_arena> m_arena;
+    // keys prefetched by one batch select
+    size_t m_prefetchBatchSize = 1000;
+    bool m_profile = false;
+    std::string m_profileTracePath;
 };
 
 }  // namespace blockverifier
@@ -40,6 +40,10 @@ namespace eth
 class PrecompiledContract;
 
 }  // namespace eth
+namespace storage
+{
+class StateDiff;
+}  // namespace storage
 namespace blockverifier
 {
 class BlockVerifierInterface
@@ -54,6 +58,23 @@ public:
     virtual std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt>
     executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t) = 0;
+    /// the critical fields of the transactions on the state of the parent block, nullptr for a
+    /// transaction without parallel tags, empty if not supported
+    virtual std::vector<std::shared_ptr<std::vector<std::string>>> getTxsCriticals(
+        dev::eth::Transactions const&, BlockInfo const&)
+    {
+        return std::vector<std::shared_ptr<std::vector<std::string>>>();
+    }
+    /// warm the state of the parent block for the transactions likely sealed next, so that their
+    /// execution misses the cache less, nothing if not supported
+    virtual void preloadTransactions(dev::eth::Transactions const&, BlockInfo const&) {}
+    /// the context committing the state diff of the block instead of executing it, nullptr if
+    /// not supported, throws if the diff isn't the state signed by the header of the block
+    virtual ExecutiveContext::Ptr applyStateDiff(
+        dev::eth::Block&, BlockInfo const&, dev::storage::StateDiff const&)
+    {
+        return nullptr;
+    }
 };
 }  // namespace blockverifier
 }  // namespace dev
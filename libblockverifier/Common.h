@@ -33,13 +33,26 @@
 
 namespace dev
 {
+namespace storage
+{
+class Storage;
+}  // namespace storage
 namespace blockverifier
 {
 struct BlockInfo
 {
+    BlockInfo() = default;
+    BlockInfo(dev::h256 const& _hash, int64_t _number, dev::h256 const& _stateRoot,
+        std::shared_ptr<dev::storage::Storage> _stateStorage = nullptr)
+      : hash(_hash), number(_number), stateRoot(_stateRoot), stateStorage(_stateStorage)
+    {}
+
     dev::h256 hash;
     int64_t number;
     dev::h256 stateRoot;
+    /// the storage the state is read from instead of the storage of the node, e.g. for a block
+    /// executed on a parent not saved yet, null for the storage of the node
+    std::shared_ptr<dev::storage::Storage> stateStorage;
 };
 }  // namespace blockverifier
 }  // namespace dev
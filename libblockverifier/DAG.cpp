@@ -21,6 +21,8 @@
  */
 
 #include "DAG.h"
+#include <tbb/parallel_for.h>
+#include <algorithm>
 
 using namespace std;
 using namespace dev;
@@ -34,36 +36,129 @@ DAG::~DAG()
 void DAG::init(ID _maxSize)
 {
     clear();
+    m_inDegrees.reset(new std::atomic<ID>[_maxSize]);
     for (ID i = 0; i < _maxSize; ++i)
-        m_vtxs.emplace_back(make_shared<Vertex>());
+        m_inDegrees[i] = 0;
+    m_offsets.assign(_maxSize + 1, 0);
     m_totalVtxs = _maxSize;
     m_totalConsume = 0;
 }
 
 void DAG::addEdge(ID _f, ID _t)
 {
-    if (_f >= m_vtxs.size() && _t >= m_vtxs.size())
+    if (_f >= m_totalVtxs || _t >= m_totalVtxs)
         return;
-    m_vtxs[_f]->outEdge.emplace_back(_t);
-    m_vtxs[_t]->inDegree += 1;
-    // PARA_LOG(TRACE) << LOG_BADGE("DAG") << LOG_DESC("Add edge") << LOG_KV("from", _f)
-    //                << LOG_KV("to", _t);
+    m_edgeList.emplace_back(_f, _t);
+}
+
+void DAG::addEdges(std::vector<std::pair<ID, ID>> const& _edges)
+{
+    m_edgeList.reserve(m_edgeList.size() + _edges.size());
+    for (auto const& edge : _edges)
+        addEdge(edge.first, edge.second);
 }
 
 void DAG::generate()
 {
-    for (ID id = 0; id < m_vtxs.size(); ++id)
+    // counting sort of the edges by their source
+    m_offsets.assign(m_totalVtxs + 1, 0);
+    for (auto const& edge : m_edgeList)
+        ++m_offsets[edge.first + 1];
+    for (ID id = 0; id < m_totalVtxs; ++id)
+        m_offsets[id + 1] += m_offsets[id];
+    m_edges.resize(m_edgeList.size());
+    IDs cursors(m_offsets.begin(), m_offsets.end() - 1);
+    for (auto const& edge : m_edgeList)
+        m_edges[cursors[edge.first]++] = edge.second;
+    std::vector<std::pair<ID, ID>>().swap(m_edgeList);
+
+    // the edges of a vertex are sorted and deduplicated, then packed
+    IDs uniqueEdges(m_totalVtxs);
+    tbb::parallel_for(
+        tbb::blocked_range<ID>(0, m_totalVtxs), [&](tbb::blocked_range<ID> const& _r) {
+            for (ID id = _r.begin(); id != _r.end(); ++id)
+            {
+                auto begin = m_edges.begin() + m_offsets[id];
+                auto end = m_edges.begin() + m_offsets[id + 1];
+                std::sort(begin, end);
+                uniqueEdges[id] = std::unique(begin, end) - begin;
+            }
+        });
+    ID packed = 0;
+    for (ID id = 0; id < m_totalVtxs; ++id)
     {
-        if (m_vtxs[id]->inDegree == 0)
+        auto begin = m_offsets[id];
+        m_offsets[id] = packed;
+        for (ID i = 0; i < uniqueEdges[id]; ++i)
+        {
+            m_edges[packed] = m_edges[begin + i];
+            m_inDegrees[m_edges[packed]] += 1;
+            ++packed;
+        }
+    }
+    m_offsets[m_totalVtxs] = packed;
+    m_edges.resize(packed);
+
+    m_roots.clear();
+    for (ID id = 0; id < m_totalVtxs; ++id)
+    {
+        if (m_inDegrees[id] == 0)
+        {
             m_topLevel.push(id);
+            m_roots.push_back(id);
+        }
     }
 
+    // level of a vertex is the longest path from a root to it
+    std::vector<ID> inDegrees(m_totalVtxs);
+    for (ID id = 0; id < m_totalVtxs; ++id)
+        inDegrees[id] = m_inDegrees[id];
+    std::vector<ID> levels(m_totalVtxs, 0);
+    m_levelWidths.clear();
+    m_longestFrom.assign(m_totalVtxs, INVALID_ID);
+    IDs queue(m_roots);
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        ID id = queue[i];
+        if (levels[id] >= m_levelWidths.size())
+            m_levelWidths.resize(levels[id] + 1, 0);
+        ++m_levelWidths[levels[id]];
+        for (ID next : outEdges(id))
+        {
+            if (levels[id] + 1 > levels[next])
+            {
+                levels[next] = levels[id] + 1;
+                m_longestFrom[next] = id;
+            }
+            if (--inDegrees[next] == 0)
+                queue.push_back(next);
+        }
+    }
+    m_criticalPath = m_levelWidths.size();
+    m_longestEnd = INVALID_ID;
+    for (ID id = 0; id < levels.size() && m_longestEnd == INVALID_ID; ++id)
+    {
+        if (levels[id] + 1 == m_criticalPath)
+            m_longestEnd = id;
+    }
+    m_width =
+        m_levelWidths.empty() ? 0 : *std::max_element(m_levelWidths.begin(), m_levelWidths.end());
+
     // PARA_LOG(TRACE) << LOG_BADGE("DAG") << LOG_DESC("generate")
     //                << LOG_KV("queueSize", m_topLevel.size());
-    // for (ID id = 0; id < m_vtxs.size(); id++)
+    // for (ID id = 0; id < m_totalVtxs; id++)
     // printVtx(id);
 }
 
+IDs DAG::longestPath() const
+{
+    IDs path;
+    for (ID id = m_longestEnd; id != INVALID_ID; id = m_longestFrom[id])
+        path.push_back(id);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
 /*
 ID DAG::waitPop(bool _needWait)
 {
@@ -121,11 +216,10 @@ ID DAG::consume(ID _id)
     ID producedNum = 0;
     ID nextId = INVALID_ID;
     ID lastDegree = INVALID_ID;
-    for (ID id : m_vtxs[_id]->outEdge)
+    for (ID id : outEdges(_id))
     {
-        auto vtx = m_vtxs[id];
         {
-            lastDegree = vtx->inDegree.fetch_sub(1);
+            lastDegree = m_inDegrees[id].fetch_sub(1);
         }
         if (lastDegree == 1)
         {
@@ -148,22 +242,31 @@ ID DAG::consume(ID _id)
     }
     // PARA_LOG(TRACE) << LOG_BADGE("TbbCqDAG") << LOG_DESC("consumed")
     //                << LOG_KV("queueSize", m_topLevel.size());
-    // for (ID id = 0; id < m_vtxs.size(); id++)
+    // for (ID id = 0; id < m_totalVtxs; id++)
     // printVtx(id);
     return nextId;
 }
 
 void DAG::clear()
 {
-    m_vtxs = std::vector<std::shared_ptr<Vertex>>();
+    std::vector<std::pair<ID, ID>>().swap(m_edgeList);
+    m_offsets.clear();
+    m_edges.clear();
+    m_inDegrees.reset();
+    m_roots.clear();
+    m_width = 0;
+    m_criticalPath = 0;
+    m_levelWidths.clear();
+    m_longestFrom.clear();
+    m_longestEnd = INVALID_ID;
     // XXXX m_topLevel.clear();
 }
 
 void DAG::printVtx(ID _id)
 {
-    for (ID id : m_vtxs[_id]->outEdge)
+    for (ID id : outEdges(_id))
     {
         PARA_LOG(TRACE) << LOG_BADGE("DAG") << LOG_DESC("VertexEdge") << LOG_KV("ID", _id)
-                        << LOG_KV("inDegree", m_vtxs[_id]->inDegree) << LOG_KV("edge", id);
+                        << LOG_KV("inDegree", m_inDegrees[_id]) << LOG_KV("edge", id);
     }
 }
\ No newline at end of file
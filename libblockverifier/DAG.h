@@ -27,8 +27,10 @@
 #include <tbb/concurrent_queue.h>
 #include <condition_variable>
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace dev
@@ -39,10 +41,14 @@ using ID = uint32_t;
 using IDs = std::vector<ID>;
 static const ID INVALID_ID = (ID(0) - 1);
 
-struct Vertex
+// The out edges of a vertex, a range of the edges of the DAG
+struct EdgeRange
 {
-    std::atomic<ID> inDegree;
-    std::vector<ID> outEdge;
+    ID const* first;
+    ID const* last;
+    ID const* begin() const { return first; }
+    ID const* end() const { return last; }
+    size_t size() const { return last - first; }
 };
 
 class DAG
@@ -56,10 +62,13 @@ public:
     // _maxSize is max ID + 1
     void init(ID _maxSize);
 
-    // Add edge between vertex
+    // Add edge between vertex, an edge added twice is kept once
     void addEdge(ID _f, ID _t);
 
-    // Generate DAG
+    // Add the edges built apart, as addEdge
+    void addEdges(std::vector<std::pair<ID, ID>> const& _edges);
+
+    // Generate DAG, the edges added are laid out by their source
     void generate();
 
     // Wait until topLevel is not empty, return INVALID_ID if DAG reach the end
@@ -71,9 +80,44 @@ public:
     // Clear all data of this class (thread safe)
     void clear();
 
+    ID size() const { return m_totalVtxs; }
+
+    // Vertices without in edge, valid after generate
+    IDs const& roots() const { return m_roots; }
+
+    // Vertices the edges from _id go to in ascending order, valid after generate
+    EdgeRange outEdges(ID _id) const
+    {
+        return EdgeRange{m_edges.data() + m_offsets[_id], m_edges.data() + m_offsets[_id + 1]};
+    }
+
+    // Remove an in edge of the vertex, true if it's the last one (thread safe)
+    bool release(ID _id) { return m_inDegrees[_id].fetch_sub(1) == 1; }
+
+    // Vertices of the widest level and vertices of the longest path, valid after generate
+    ID width() const { return m_width; }
+    ID criticalPath() const { return m_criticalPath; }
+    // Vertices of each level, the level of a vertex being the longest path from a root to it,
+    // valid after generate
+    IDs const& levelWidths() const { return m_levelWidths; }
+    // Vertices of a longest path from a root, valid after generate
+    IDs longestPath() const;
+
 private:
-    std::vector<std::shared_ptr<Vertex>> m_vtxs;
+    // edges added and not generated yet
+    std::vector<std::pair<ID, ID>> m_edgeList;
+    // the out edges of vertex id are m_edges[m_offsets[id], m_offsets[id + 1])
+    IDs m_offsets;
+    IDs m_edges;
+    std::unique_ptr<std::atomic<ID>[]> m_inDegrees;
     tbb::concurrent_queue<ID> m_topLevel;
+    IDs m_roots;
+    ID m_width = 0;
+    ID m_criticalPath = 0;
+    IDs m_levelWidths;
+    // the predecessor of a vertex on its longest path from a root, INVALID_ID for a root
+    IDs m_longestFrom;
+    ID m_longestEnd = INVALID_ID;
 
     ID m_totalVtxs = 0;
     std::atomic<ID> m_totalConsume;
@@ -0,0 +1,66 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : what limited the parallelism of a block, recorded when profiling is on
+ * @author: ancelmo
+ * @date: 2019-11-20
+ */
+
+#include "DAGProfile.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::blockverifier;
+
+map<ID, ID> DAGProfile::widthHistogram() const
+{
+    map<ID, ID> histogram;
+    for (ID width : levelWidths)
+        ++histogram[width];
+    return histogram;
+}
+
+vector<pair<string, uint64_t>> DAGProfile::topFields(size_t _n) const
+{
+    vector<pair<string, uint64_t>> fields(fieldEdges.begin(), fieldEdges.end());
+    auto end = fields.begin() + min(_n, fields.size());
+    partial_sort(fields.begin(), end, fields.end(),
+        [](pair<string, uint64_t> const& _a, pair<string, uint64_t> const& _b) {
+            return _a.second > _b.second;
+        });
+    fields.erase(end, fields.end());
+    return fields;
+}
+
+string DAGProfile::chromeTrace(eth::Transactions const& _txs) const
+{
+    ostringstream trace;
+    trace << "{\"traceEvents\":[";
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        auto const& span = spans[i];
+        trace << (i > 0 ? "," : "") << "{\"name\":\"tx " << span.id
+              << "\",\"ph\":\"X\",\"pid\":" << blockNumber << ",\"tid\":" << span.worker
+              << ",\"ts\":" << span.start << ",\"dur\":" << span.end - span.start
+              << ",\"args\":{\"hash\":\""
+              << (span.id < _txs.size() ? "0x" + _txs[span.id].sha3().hex() : "") << "\"}}";
+    }
+    trace << "]}";
+    return trace.str();
+}
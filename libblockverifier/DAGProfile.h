@@ -0,0 +1,73 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : what limited the parallelism of a block, recorded when profiling is on
+ * @author: ancelmo
+ * @date: 2019-11-20
+ */
+
+#pragma once
+#include "DAG.h"
+#include <libethcore/Transaction.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace blockverifier
+{
+// the field of the edges added for a transaction conflicting with all others
+static const char* const c_profileFieldAll = "*";
+
+struct DAGProfile
+{
+    typedef std::shared_ptr<DAGProfile> Ptr;
+
+    // a transaction executed, us since the start of the scheduling
+    struct Span
+    {
+        ID id;
+        unsigned worker;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    int64_t blockNumber = 0;
+    // transactions of each level of the DAG
+    IDs levelWidths;
+    // transactions of a longest path, executed one after the other whatever the workers
+    IDs criticalPath;
+    // edges added because of each critical field or key
+    std::map<std::string, uint64_t> fieldEdges;
+    // transactions conflicting with all others
+    IDs barriers;
+    std::vector<Span> spans;
+    // us each worker executed transactions and waited for one
+    std::vector<uint64_t> busyTime;
+    std::vector<uint64_t> idleTime;
+
+    // levels by their width
+    std::map<ID, ID> widthHistogram() const;
+    // the _n fields of the most edges, the most first
+    std::vector<std::pair<std::string, uint64_t>> topFields(size_t _n) const;
+    // the spans in the trace event format of chrome://tracing, a thread for each worker
+    std::string chromeTrace(dev::eth::Transactions const& _txs) const;
+};
+}  // namespace blockverifier
+}  // namespace dev
@@ -0,0 +1,224 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : work stealing scheduler of DAG vertices
+ * @author: ancelmo
+ * @date: 2019-09-09
+ */
+
+#include "DAGScheduler.h"
+#include <tbb/parallel_for.h>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::blockverifier;
+
+// rounds an idle worker looks for a vertex before it yields, and before it parks
+static const unsigned c_spinRounds = 64;
+static const unsigned c_yieldRounds = 16;
+
+DAGScheduler::Stats DAGScheduler::run(DAG& _dag, RunFunc const& _f)
+{
+    m_dag = &_dag;
+    m_f = _f;
+    m_remaining = _dag.size();
+    m_ready = 0;
+    m_stopped = false;
+    m_steals = 0;
+    m_idleTime = 0;
+    m_parked = 0;
+    m_error = nullptr;
+    m_start = chrono::steady_clock::now();
+
+    m_readyQueues.clear();
+    for (unsigned i = 0; i < m_workers; ++i)
+        m_readyQueues.push_back(make_shared<Worker>());
+
+    // roots are dealt round robin, so every worker starts with work of its own
+    auto& roots = _dag.roots();
+    for (size_t i = 0; i < roots.size(); ++i)
+        push(i % m_workers, roots[i]);
+
+    if (m_remaining > 0)
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(0, m_workers, 1),
+            [&](const tbb::blocked_range<unsigned>& _r) {
+                for (unsigned i = _r.begin(); i != _r.end(); ++i)
+                    work(i);
+            },
+            tbb::simple_partitioner());
+    }
+
+    if (m_profile)
+    {
+        for (auto const& worker : m_readyQueues)
+        {
+            m_profile->spans.insert(
+                m_profile->spans.end(), worker->spans.begin(), worker->spans.end());
+            m_profile->busyTime.push_back(worker->busyTime);
+            m_profile->idleTime.push_back(worker->idleTime);
+        }
+    }
+    m_readyQueues.clear();
+    m_f = nullptr;
+    m_dag = nullptr;
+    if (m_error)
+        rethrow_exception(m_error);
+
+    Stats stats;
+    stats.workers = m_workers;
+    stats.width = _dag.width();
+    stats.criticalPath = _dag.criticalPath();
+    stats.steals = m_steals;
+    stats.idleTime = m_idleTime;
+    return stats;
+}
+
+void DAGScheduler::work(unsigned _index)
+{
+    while (!finished())
+    {
+        ID id = INVALID_ID;
+        if (!pop(_index, id))
+        {
+            auto idleStart = chrono::steady_clock::now();
+            for (unsigned round = 0; !finished(); ++round)
+            {
+                if (steal(_index, id) || pop(_index, id))
+                    break;
+
+                if (round < c_spinRounds)
+                    continue;
+                else if (round < c_spinRounds + c_yieldRounds)
+                    this_thread::yield();
+                else
+                    park();
+            }
+            auto idleTime = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - idleStart)
+                                .count();
+            m_idleTime += idleTime;
+            if (m_profile)
+                m_readyQueues[_index]->idleTime += idleTime;
+            if (id == INVALID_ID)
+                return;
+        }
+
+        try
+        {
+            if (m_profile)
+            {
+                auto start = sinceStart();
+                m_f(id);
+                auto end = sinceStart();
+                auto& worker = *m_readyQueues[_index];
+                worker.spans.push_back(DAGProfile::Span{id, _index, start, end});
+                worker.busyTime += end - start;
+            }
+            else
+            {
+                m_f(id);
+            }
+        }
+        catch (...)
+        {
+            {
+                lock_guard<mutex> l(x_error);
+                if (!m_error)
+                    m_error = current_exception();
+            }
+            m_stopped = true;
+            lock_guard<mutex> l(x_park);
+            cv_park.notify_all();
+            return;
+        }
+
+        for (ID next : m_dag->outEdges(id))
+        {
+            if (m_dag->release(next))
+                push(_index, next);
+        }
+
+        if (m_remaining.fetch_sub(1) == 1)
+        {
+            lock_guard<mutex> l(x_park);
+            cv_park.notify_all();
+        }
+    }
+}
+
+void DAGScheduler::push(unsigned _index, ID _id)
+{
+    {
+        tbb::spin_mutex::scoped_lock l(m_readyQueues[_index]->mutex);
+        m_readyQueues[_index]->ready.push_back(_id);
+    }
+
+    // the pushing worker takes one vertex itself, the others are for parked workers
+    if (m_ready.fetch_add(1) > 0 && m_parked.load() > 0)
+    {
+        lock_guard<mutex> l(x_park);
+        cv_park.notify_one();
+    }
+}
+
+bool DAGScheduler::pop(unsigned _index, ID& _id)
+{
+    auto& worker = *m_readyQueues[_index];
+    tbb::spin_mutex::scoped_lock l(worker.mutex);
+    if (worker.ready.empty())
+        return false;
+
+    _id = worker.ready.back();
+    worker.ready.pop_back();
+    --m_ready;
+    return true;
+}
+
+bool DAGScheduler::steal(unsigned _index, ID& _id)
+{
+    if (m_ready.load() <= 0)
+        return false;
+
+    for (unsigned i = 1; i < m_workers; ++i)
+    {
+        auto& victim = *m_readyQueues[(_index + i) % m_workers];
+        tbb::spin_mutex::scoped_lock l(victim.mutex);
+        if (!victim.ready.empty())
+        {
+            _id = victim.ready.front();
+            victim.ready.pop_front();
+            --m_ready;
+            ++m_steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DAGScheduler::park()
+{
+    unique_lock<mutex> l(x_park);
+    ++m_parked;
+    // the timeout only guards against a missed notify
+    cv_park.wait_for(
+        l, chrono::milliseconds(10), [&]() { return m_ready.load() > 0 || finished(); });
+    --m_parked;
+}
@@ -0,0 +1,115 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : work stealing scheduler of DAG vertices
+ * @author: ancelmo
+ * @date: 2019-09-09
+ */
+
+#pragma once
+#include "DAG.h"
+#include "DAGProfile.h"
+#include <tbb/spin_mutex.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace dev
+{
+namespace blockverifier
+{
+// Runs the vertices of a DAG on a fixed number of workers. Each worker owns a deque of ready
+// vertices, it takes the newest vertex of its own deque and steals the oldest vertex of the
+// others when its own is empty. A finished vertex pushes the successors it unblocks to the
+// deque of its worker. Idle workers spin, then yield, then park until a vertex is ready.
+class DAGScheduler
+{
+public:
+    using RunFunc = std::function<void(ID)>;
+
+    struct Stats
+    {
+        unsigned workers = 0;
+        ID width = 0;
+        ID criticalPath = 0;
+        uint64_t steals = 0;
+        // sum of the time workers waited for a ready vertex, us
+        uint64_t idleTime = 0;
+    };
+
+    DAGScheduler(unsigned _workers) : m_workers(std::max(_workers, 1u)) {}
+
+    // Run every vertex of a generated DAG once, the first exception thrown by _f stops the
+    // scheduling and is rethrown once all workers returned
+    Stats run(DAG& _dag, RunFunc const& _f);
+
+    // record the spans and the busy and idle time of the workers of the next runs in _profile
+    void setProfile(DAGProfile::Ptr _profile) { m_profile = _profile; }
+
+private:
+    struct Worker
+    {
+        tbb::spin_mutex mutex;
+        std::deque<ID> ready;
+        // only with a profile, the worker's own so they are recorded without a lock
+        std::vector<DAGProfile::Span> spans;
+        uint64_t busyTime = 0;
+        uint64_t idleTime = 0;
+    };
+
+    void work(unsigned _index);
+    void push(unsigned _index, ID _id);
+    bool pop(unsigned _index, ID& _id);
+    bool steal(unsigned _index, ID& _id);
+    bool finished() { return m_remaining.load() == 0 || m_stopped.load(); }
+    void park();
+    uint64_t sinceStart() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start)
+            .count();
+    }
+
+    unsigned m_workers;
+    DAG* m_dag = nullptr;
+    RunFunc m_f;
+    std::vector<std::shared_ptr<Worker>> m_readyQueues;
+
+    std::atomic<ID> m_remaining;
+    std::atomic<int64_t> m_ready;
+    std::atomic<bool> m_stopped;
+    std::atomic<uint64_t> m_steals;
+    std::atomic<uint64_t> m_idleTime;
+
+    std::mutex x_error;
+    std::exception_ptr m_error;
+
+    std::mutex x_park;
+    std::condition_variable cv_park;
+    std::atomic<unsigned> m_parked;
+
+    DAGProfile::Ptr m_profile;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace blockverifier
+}  // namespace dev
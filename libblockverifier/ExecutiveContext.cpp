@@ -25,6 +25,7 @@
 #include <libethcore/Exceptions.h>
 #include <libexecutive/ExecutionResult.h>
 #include <libprecompiled/ParallelConfigPrecompiled.h>
+#include <libstorage/AccessSet.h>
 #include <libstorage/StorageException.h>
 #include <libstorage/Table.h>
 
@@ -88,6 +89,15 @@ bool ExecutiveContext::isPrecompiled(Address address) const
 
 Precompiled::Ptr ExecutiveContext::getPrecompiled(Address address) const
 {
+    if (m_sharedPrecompiled)
+    {
+        auto itShared = m_sharedPrecompiled->find(address);
+        if (itShared != m_sharedPrecompiled->end())
+        {
+            return itShared->second;
+        }
+    }
+
     auto itPrecompiled = m_address2Precompiled.find(address);
 
     if (itPrecompiled != m_address2Precompiled.end())
@@ -160,62 +170,127 @@ std::shared_ptr<std::vector<std::string>> ExecutiveContext::getTxCriticals(const
 
         uint32_t selector = parallelConfigPrecompiled->getParamFunc(ref(_tx.data()));
 
-        auto config = parallelConfigPrecompiled->getParallelConfig(
-            shared_from_this(), _tx.receiveAddress(), selector, _tx.sender());
+        auto criticalTypes = getCriticalTypes(_tx, selector);
+        if (!criticalTypes)
+        {
+            return nullptr;
+        }
 
-        if (config == nullptr)
+        auto res = make_shared<vector<string>>();
+        ContractABI abi;
+        bool isOk = abi.abiOutByFuncSelector(ref(_tx.data()).cropped(4), *criticalTypes, *res);
+        if (!isOk)
         {
+            EXECUTIVECONTEXT_LOG(DEBUG) << LOG_DESC("[getTxCriticals] abiout failed, ")
+                                        << LOG_KV("input data", toHex(_tx.data()));
+
             return nullptr;
         }
+
+        for (string& critical : *res)
+        {
+            critical += _tx.receiveAddress().hex();
+        }
+
+        return res;
+    }
+}
+
+std::shared_ptr<std::vector<std::string> const> ExecutiveContext::getCriticalTypes(
+    const Transaction& _tx, uint32_t _selector)
+{
+    auto key = std::make_pair(_tx.receiveAddress(), _selector);
+    {
+        std::lock_guard<std::mutex> l(x_criticalTypes);
+        auto it = m_criticalTypes.find(key);
+        if (it != m_criticalTypes.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<std::vector<std::string> const> criticalTypes;
+    auto parallelConfigPrecompiled =
+        std::dynamic_pointer_cast<dev::precompiled::ParallelConfigPrecompiled>(
+            getPrecompiled(Address(0x1006)));
+    auto config = parallelConfigPrecompiled->getParallelConfig(
+        shared_from_this(), _tx.receiveAddress(), _selector, _tx.sender());
+    if (config)
+    {
+        ABIFunc af;
+        bool isOk = af.parser(config->functionName);
+        auto paramTypes = af.getParamsType();
+        if (!isOk)
+        {
+            EXECUTIVECONTEXT_LOG(DEBUG)
+                << LOG_DESC("[getTxCriticals] parser function signature failed, ")
+                << LOG_KV("func signature", config->functionName);
+        }
+        else if (paramTypes.size() < (size_t)config->criticalSize)
+        {
+            EXECUTIVECONTEXT_LOG(DEBUG)
+                << LOG_DESC("[getTxCriticals] params type less than  criticalSize")
+                << LOG_KV("func signature", config->functionName)
+                << LOG_KV("func criticalSize", config->criticalSize);
+        }
+        else
+        {
+            // the critical params are the leading ones, each in a 32 bytes slot of the head
+            paramTypes.resize((size_t)config->criticalSize);
+            criticalTypes = make_shared<vector<string> const>(paramTypes);
+        }
+    }
+
+    std::lock_guard<std::mutex> l(x_criticalTypes);
+    m_criticalTypes.insert(std::make_pair(key, criticalTypes));
+    return criticalTypes;
+}
+
+bool ExecutiveContext::getSystemRead(
+    std::string const& _table, std::string const& _key, std::string const& _query, bytes& _out)
+{
+    {
+        std::lock_guard<std::mutex> l(x_systemReads);
+        auto it = m_systemReads.find(std::make_tuple(_table, _key, _query));
+        if (it == m_systemReads.end())
+        {
+            return false;
+        }
+        _out = it->second;
+    }
+
+    auto accessSet = storage::AccessSet::current();
+    if (accessSet)
+    {
+        accessSet->read(_table, _key);
+    }
+    return true;
+}
+
+void ExecutiveContext::cacheSystemRead(std::string const& _table, std::string const& _key,
+    std::string const& _query, bytes const& _out)
+{
+    std::lock_guard<std::mutex> l(x_systemReads);
+    if (m_writtenSystemTables.count(_table))
+    {
+        return;
+    }
+    m_systemReads[std::make_tuple(_table, _key, _query)] = _out;
+}
+
+void ExecutiveContext::invalidateSystemReads(std::string const& _table)
+{
+    std::lock_guard<std::mutex> l(x_systemReads);
+    m_writtenSystemTables.insert(_table);
+    for (auto it = m_systemReads.begin(); it != m_systemReads.end();)
+    {
+        if (std::get<0>(it->first) == _table)
+        {
+            it = m_systemReads.erase(it);
+        }
         else
         {
-            {  // Testing code
-                // bytesConstRef data = parallelConfigPrecompiled->getParamData(ref(_tx.data()));
-                auto res = make_shared<vector<string>>();
-
-                ABIFunc af;
-                bool isOk = af.parser(config->functionName);
-                if (!isOk)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG)
-                        << LOG_DESC("[getTxCriticals] parser function signature failed, ")
-                        << LOG_KV("func signature", config->functionName);
-
-                    return nullptr;
-                }
-
-                auto paramTypes = af.getParamsType();
-                if (paramTypes.size() < (size_t)config->criticalSize)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG)
-                        << LOG_DESC("[getTxCriticals] params type less than  criticalSize")
-                        << LOG_KV("func signature", config->functionName)
-                        << LOG_KV("func criticalSize", config->criticalSize)
-                        << LOG_KV("input data", toHex(_tx.data()));
-
-                    return nullptr;
-                }
-
-                paramTypes.resize((size_t)config->criticalSize);
-
-                ContractABI abi;
-                isOk = abi.abiOutByFuncSelector(ref(_tx.data()).cropped(4), paramTypes, *res);
-                if (!isOk)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG) << LOG_DESC("[getTxCriticals] abiout failed, ")
-                                                << LOG_KV("func signature", config->functionName)
-                                                << LOG_KV("input data", toHex(_tx.data()));
-
-                    return nullptr;
-                }
-
-                for (string& critical : *res)
-                {
-                    critical += _tx.receiveAddress().hex();
-                }
-
-                return res;
-            }
+            ++it;
         }
     }
 }
@@ -35,7 +35,12 @@
 #include <tbb/concurrent_unordered_map.h>
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 
 namespace dev
 {
@@ -79,6 +84,14 @@ public:
         m_address2Precompiled.insert(std::make_pair(address, precompiled));
     }
 
+    // Precompiled contracts without state of their own, shared by the contexts of a factory and
+    // looked up before the ones registered to this context
+    void setSharedPrecompiled(
+        std::shared_ptr<std::unordered_map<Address, Precompiled::Ptr> const> sharedPrecompiled)
+    {
+        m_sharedPrecompiled = sharedPrecompiled;
+    }
+
     BlockInfo blockInfo() { return m_blockInfo; }
     void setBlockInfo(BlockInfo blockInfo) { m_blockInfo = blockInfo; }
 
@@ -111,15 +124,43 @@ public:
     // Get transaction criticals, return nullptr if critical to all
     std::shared_ptr<std::vector<std::string>> getTxCriticals(const dev::eth::Transaction& _tx);
 
+    // The result of a query of a rarely written system table for the rows of _key, cached for
+    // the block until the table is written, false if it is not cached. A hit is recorded as a
+    // read of _key in the access set of the calling thread, as the select it replaces would be.
+    bool getSystemRead(std::string const& _table, std::string const& _key,
+        std::string const& _query, bytes& _out);
+    void cacheSystemRead(std::string const& _table, std::string const& _key,
+        std::string const& _query, bytes const& _out);
+    // called before the table is written, no query of it is cached for the rest of the block,
+    // so a reverted write never leaves a stale result behind
+    void invalidateSystemReads(std::string const& _table);
+
 private:
+    // Get the types of the critical params of a parallel function, return nullptr if the
+    // function is not parallel
+    std::shared_ptr<std::vector<std::string> const> getCriticalTypes(
+        const dev::eth::Transaction& _tx, uint32_t _selector);
+
     tbb::concurrent_unordered_map<Address, Precompiled::Ptr, std::hash<Address>>
         m_address2Precompiled;
+    std::shared_ptr<std::unordered_map<Address, Precompiled::Ptr> const> m_sharedPrecompiled;
     std::atomic<int> m_addressCount;
     BlockInfo m_blockInfo;
     std::shared_ptr<dev::executive::StateFace> m_stateFace;
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
     uint64_t m_txGasLimit = 300000000;
+
+    // parallel configs are read from the state of the parent block, so they are cached for the
+    // whole block, keyed by contract address and function selector
+    std::map<std::pair<Address, uint32_t>, std::shared_ptr<std::vector<std::string> const>>
+        m_criticalTypes;
+    std::mutex x_criticalTypes;
+
+    // keyed by table, key and query
+    std::map<std::tuple<std::string, std::string, std::string>, bytes> m_systemReads;
+    std::set<std::string> m_writtenSystemTables;
+    std::mutex x_systemReads;
 };
 
 }  // namespace blockverifier
@@ -47,25 +47,17 @@ void ExecutiveContextFactory::initExecutiveContext(
     memoryTableFactory->setBlockHash(blockInfo.hash);
     memoryTableFactory->setBlockNum(blockInfo.number);
 #endif
-    auto memoryTableFactory =
-        m_tableFactoryFactory->newTableFactory(blockInfo.hash, blockInfo.number);
+    auto memoryTableFactory = blockInfo.stateStorage ?
+                                  m_tableFactoryFactory->newTableFactory(
+                                      blockInfo.hash, blockInfo.number, blockInfo.stateStorage) :
+                                  m_tableFactoryFactory->newTableFactory(
+                                      blockInfo.hash, blockInfo.number);
 
     auto tableFactoryPrecompiled = std::make_shared<dev::blockverifier::TableFactoryPrecompiled>();
     tableFactoryPrecompiled->setMemoryTableFactory(memoryTableFactory);
 
-    context->setAddress2Precompiled(
-        Address(0x1000), std::make_shared<dev::precompiled::SystemConfigPrecompiled>());
+    context->setSharedPrecompiled(m_sharedPrecompiled);
     context->setAddress2Precompiled(Address(0x1001), tableFactoryPrecompiled);
-    context->setAddress2Precompiled(
-        Address(0x1002), std::make_shared<dev::precompiled::CRUDPrecompiled>());
-    context->setAddress2Precompiled(
-        Address(0x1003), std::make_shared<dev::precompiled::ConsensusPrecompiled>());
-    context->setAddress2Precompiled(
-        Address(0x1004), std::make_shared<dev::precompiled::CNSPrecompiled>());
-    context->setAddress2Precompiled(
-        Address(0x1005), std::make_shared<dev::precompiled::PermissionPrecompiled>());
-    context->setAddress2Precompiled(
-        Address(0x1006), std::make_shared<dev::precompiled::ParallelConfigPrecompiled>());
     // register User developed Precompiled contract
     registerUserPrecompiled(context);
     context->setMemoryTableFactory(memoryTableFactory);
@@ -75,6 +67,22 @@ void ExecutiveContextFactory::initExecutiveContext(
     setTxGasLimitToContext(context);
 }
 
+void ExecutiveContextFactory::initSharedPrecompiled()
+{
+    auto sharedPrecompiled = std::make_shared<std::unordered_map<Address, Precompiled::Ptr>>();
+    sharedPrecompiled->insert(
+        std::make_pair(Address(0x1000), std::make_shared<SystemConfigPrecompiled>()));
+    sharedPrecompiled->insert(std::make_pair(Address(0x1002), std::make_shared<CRUDPrecompiled>()));
+    sharedPrecompiled->insert(
+        std::make_pair(Address(0x1003), std::make_shared<ConsensusPrecompiled>()));
+    sharedPrecompiled->insert(std::make_pair(Address(0x1004), std::make_shared<CNSPrecompiled>()));
+    sharedPrecompiled->insert(
+        std::make_pair(Address(0x1005), std::make_shared<PermissionPrecompiled>()));
+    sharedPrecompiled->insert(
+        std::make_pair(Address(0x1006), std::make_shared<ParallelConfigPrecompiled>()));
+    m_sharedPrecompiled = sharedPrecompiled;
+}
+
 void ExecutiveContextFactory::setStateStorage(dev::storage::Storage::Ptr stateStorage)
 {
     m_stateStorage = stateStorage;
@@ -95,6 +103,19 @@ void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr conte
         BlockInfo blockInfo = context->blockInfo();
         std::string ret;
 
+        // the limit read from a storage of its own isn't cached
+        auto stateStorage = blockInfo.stateStorage ? blockInfo.stateStorage : m_stateStorage;
+        bool cached = !blockInfo.stateStorage;
+        if (cached)
+        {
+            std::lock_guard<std::mutex> l(x_txGasLimit);
+            if (m_txGasLimitNumber == blockInfo.number && m_txGasLimitHash == blockInfo.hash)
+            {
+                context->setTxGasLimit(m_txGasLimit);
+                return;
+            }
+        }
+
         auto tableInfo = std::make_shared<storage::TableInfo>();
         tableInfo->name = storage::SYS_CONFIG;
         tableInfo->key = storage::SYS_KEY;
@@ -103,7 +124,7 @@ void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr conte
         auto condition = std::make_shared<dev::storage::Condition>();
         condition->EQ("key", key);
         auto values =
-            m_stateStorage->select(blockInfo.hash, blockInfo.number, tableInfo, key, condition);
+            stateStorage->select(blockInfo.hash, blockInfo.number, tableInfo, key, condition);
         if (!values || values->size() != 1)
         {
             EXECUTIVECONTEXT_LOG(ERROR) << LOG_DESC("[setTxGasLimitToContext]Select error");
@@ -125,6 +146,13 @@ void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr conte
         if (ret != "")
         {
             context->setTxGasLimit(boost::lexical_cast<uint64_t>(ret));
+            if (cached)
+            {
+                std::lock_guard<std::mutex> l(x_txGasLimit);
+                m_txGasLimitHash = blockInfo.hash;
+                m_txGasLimitNumber = blockInfo.number;
+                m_txGasLimit = context->txGasLimit();
+            }
             EXECUTIVECONTEXT_LOG(TRACE) << LOG_DESC("[setTxGasLimitToContext]")
                                         << LOG_KV("txGasLimit", context->txGasLimit());
         }
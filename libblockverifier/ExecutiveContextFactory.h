@@ -25,6 +25,7 @@
 #include <libexecutive/StateFactoryInterface.h>
 #include <libstorage/Storage.h>
 #include <libstorage/Table.h>
+#include <mutex>
 
 namespace dev
 {
@@ -48,6 +49,7 @@ public:
         m_precompiledContract.insert(std::make_pair(
             dev::Address(4), dev::eth::PrecompiledContract(
                                  15, 3, dev::eth::PrecompiledRegistrar::executor("identity"))));
+        initSharedPrecompiled();
     };
     virtual ~ExecutiveContextFactory(){};
 
@@ -69,7 +71,16 @@ private:
     dev::storage::Storage::Ptr m_stateStorage;
     std::shared_ptr<dev::executive::StateFactoryInterface> m_stateFactoryInterface;
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
+    // system precompiled contracts keep no state, they are built once and shared by all contexts
+    std::shared_ptr<std::unordered_map<Address, Precompiled::Ptr> const> m_sharedPrecompiled;
 
+    // tx gas limit of the last block a context was initialized on
+    std::mutex x_txGasLimit;
+    h256 m_txGasLimitHash;
+    int64_t m_txGasLimitNumber = -1;
+    uint64_t m_txGasLimit = 0;
+
+    void initSharedPrecompiled();
     void setTxGasLimitToContext(ExecutiveContext::Ptr context);
     void registerUserPrecompiled(ExecutiveContext::Ptr context);
 };
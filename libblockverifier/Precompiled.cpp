@@ -25,6 +25,7 @@
 #include <libdevcrypto/Hash.h>
 #include <libstorage/MemoryTableFactory.h>
 #include <libstorage/TableFactoryPrecompiled.h>
+#include <algorithm>
 
 using namespace dev;
 using namespace blockverifier;
@@ -36,6 +37,42 @@ uint32_t Precompiled::getFuncSelector(std::string const& _functionName)
            ((func & 0xFF000000) >> 24);
 }
 
+namespace
+{
+bool selectorLess(std::pair<uint32_t, Precompiled::Handler> const& _handler, uint32_t _selector)
+{
+    return _handler.first < _selector;
+}
+}  // namespace
+
+void Precompiled::registerMethod(std::string const& _functionName, Handler _handler)
+{
+    auto selector = getFuncSelector(_functionName);
+    name2Selector[_functionName] = selector;
+    auto it = std::lower_bound(m_handlers.begin(), m_handlers.end(), selector, selectorLess);
+    if (it != m_handlers.end() && it->first == selector)
+    {
+        it->second = _handler;
+    }
+    else
+    {
+        m_handlers.insert(it, std::make_pair(selector, _handler));
+    }
+}
+
+bool Precompiled::dispatch(
+    ExecutiveContext::Ptr _context, bytesConstRef _param, Address const& _origin, bytes& _out)
+{
+    auto selector = getParamFunc(_param);
+    auto it = std::lower_bound(m_handlers.begin(), m_handlers.end(), selector, selectorLess);
+    if (it == m_handlers.end() || it->first != selector)
+    {
+        return false;
+    }
+    it->second(_context, getParamData(_param), _origin, _out);
+    return true;
+}
+
 storage::Table::Ptr Precompiled::openTable(
     ExecutiveContext::Ptr context, const std::string& tableName)
 {
@@ -22,8 +22,10 @@
 
 #include <libdevcore/Address.h>
 #include <libstorage/Table.h>
+#include <functional>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace dev
 {
@@ -39,6 +41,10 @@ class Precompiled : public std::enable_shared_from_this<Precompiled>
 {
 public:
     typedef std::shared_ptr<Precompiled> Ptr;
+    // the handler of a method, called with the abi encoded params after the selector
+    typedef std::function<void(std::shared_ptr<dev::blockverifier::ExecutiveContext>,
+        bytesConstRef, Address const&, bytes&)>
+        Handler;
 
     virtual ~Precompiled(){};
 
@@ -53,6 +59,8 @@ public:
     {
         return std::vector<std::string>();
     }
+    // the table keyed by the parallel tags, its rows are prefetched before the block is executed
+    virtual std::string getParallelTable() { return std::string(); }
 
     virtual uint32_t getParamFunc(bytesConstRef _param)
     {
@@ -67,6 +75,23 @@ public:
     virtual bytesConstRef getParamData(bytesConstRef _param) { return _param.cropped(4); }
 
 protected:
+    // registers the handler of a method, its selector is computed once here
+    void registerMethod(std::string const& _functionName, Handler _handler);
+    template <class T>
+    void registerMethod(std::string const& _functionName,
+        void (T::*_method)(std::shared_ptr<dev::blockverifier::ExecutiveContext>, bytesConstRef,
+            Address const&, bytes&))
+    {
+        auto self = static_cast<T*>(this);
+        registerMethod(_functionName,
+            [self, _method](std::shared_ptr<dev::blockverifier::ExecutiveContext> _context,
+                bytesConstRef _data, Address const& _origin,
+                bytes& _out) { (self->*_method)(_context, _data, _origin, _out); });
+    }
+    // calls the handler registered for the selector of _param, false if there is none
+    bool dispatch(std::shared_ptr<dev::blockverifier::ExecutiveContext> _context,
+        bytesConstRef _param, Address const& _origin, bytes& _out);
+
     std::map<std::string, uint32_t> name2Selector;
     std::shared_ptr<dev::storage::Table> openTable(
         std::shared_ptr<dev::blockverifier::ExecutiveContext> _context,
@@ -75,6 +100,10 @@ protected:
         std::shared_ptr<dev::blockverifier::ExecutiveContext> _context,
         const std::string& _tableName, const std::string& _keyField, const std::string& _valueField,
         Address const& origin);
+
+private:
+    // sorted by selector, the few methods of a precompiled are found by a binary search
+    std::vector<std::pair<uint32_t, Handler>> m_handlers;
 };
 
 }  // namespace blockverifier
@@ -22,7 +22,12 @@
 
 #include "TxDAG.h"
 #include "Common.h"
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <algorithm>
 #include <map>
+#include <set>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -40,57 +45,223 @@ void TxDAG::init(ExecutiveContext::Ptr _ctx, Transactions const& _txs, int64_t _
     m_txs = make_shared<Transactions const>(_txs);
     m_dag.init(_txs.size());
 
-    CriticalField<string> latestCriticals;
+    ID txNum = _txs.size();
+    vector<shared_ptr<vector<string>>> criticals(txNum);
+    tbb::parallel_for(
+        tbb::blocked_range<ID>(0, txNum), [&](tbb::blocked_range<ID> const& _r) {
+            for (ID id = _r.begin(); id != _r.end(); ++id)
+                criticals[id] = _ctx->getTxCriticals(_txs[id]);
+        });
+
+    // Normal transaction: Conflict with all transaction, a barrier of the ones around it
+    IDs lastBarriers(txNum);
+    IDs nextBarriers(txNum);
+    ID barrier = INVALID_ID;
+    for (ID id = 0; id < txNum; ++id)
+    {
+        lastBarriers[id] = barrier;
+        if (!criticals[id])
+        {
+            barrier = id;
+            ++m_normalTxs;
+            if (m_profile)
+                m_profile->barriers.push_back(id);
+        }
+    }
+    barrier = INVALID_ID;
+    for (ID id = txNum; id-- > 0;)
+    {
+        nextBarriers[id] = barrier;
+        if (!criticals[id])
+            barrier = id;
+    }
+
+    // the critical fields of the DAG transactions, by field and then by transaction
+    vector<pair<string const*, ID>> fields;
+    for (ID id = 0; id < txNum; ++id)
+    {
+        if (criticals[id])
+        {
+            for (string const& c : *criticals[id])
+                fields.emplace_back(&c, id);
+        }
+    }
+    tbb::parallel_sort(fields.begin(), fields.end(),
+        [](pair<string const*, ID> const& _a, pair<string const*, ID> const& _b) {
+            int cmp = _a.first->compare(*_b.first);
+            return cmp < 0 || (cmp == 0 && _a.second < _b.second);
+        });
+    fields.erase(unique(fields.begin(), fields.end(),
+                     [](pair<string const*, ID> const& _a, pair<string const*, ID> const& _b) {
+                         return _a.second == _b.second && *_a.first == *_b.first;
+                     }),
+        fields.end());
+
+    // A transaction follows the last one sharing a field with it since the last barrier, or the
+    // barrier, and the last one of a field before a barrier is followed by the barrier
+    auto sameSegment = [&](size_t _k, size_t _other) {
+        return *fields[_k].first == *fields[_other].first &&
+               lastBarriers[fields[_k].second] == lastBarriers[fields[_other].second];
+    };
+    vector<pair<ID, ID>> fromEdges(fields.size(), make_pair(INVALID_ID, INVALID_ID));
+    vector<pair<ID, ID>> toEdges(fields.size(), make_pair(INVALID_ID, INVALID_ID));
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, fields.size()), [&](tbb::blocked_range<size_t> const& _r) {
+            for (size_t k = _r.begin(); k != _r.end(); ++k)
+            {
+                ID id = fields[k].second;
+                ID from = (k > 0 && sameSegment(k, k - 1)) ? fields[k - 1].second :
+                                                             lastBarriers[id];
+                if (from != INVALID_ID)
+                    fromEdges[k] = make_pair(from, id);
+                if ((k + 1 == fields.size() || !sameSegment(k, k + 1)) &&
+                    nextBarriers[id] != INVALID_ID)
+                    toEdges[k] = make_pair(id, nextBarriers[id]);
+            }
+        });
+
+    vector<pair<ID, ID>> edges;
+    edges.reserve(fields.size() + m_normalTxs);
+    for (size_t k = 0; k < fields.size(); ++k)
+    {
+        if (fromEdges[k].first != INVALID_ID)
+        {
+            edges.push_back(fromEdges[k]);
+            if (m_profile)
+                ++m_profile->fieldEdges[*fields[k].first];
+        }
+        if (toEdges[k].first != INVALID_ID)
+        {
+            edges.push_back(toEdges[k]);
+            if (m_profile)
+                ++m_profile->fieldEdges[c_profileFieldAll];
+        }
+    }
+    for (ID id = 0; id < txNum; ++id)
+    {
+        if (!criticals[id] && lastBarriers[id] != INVALID_ID)
+        {
+            edges.emplace_back(lastBarriers[id], id);
+            if (m_profile)
+                ++m_profile->fieldEdges[c_profileFieldAll];
+        }
+    }
+    DAG_LOG(TRACE) << LOG_DESC("Add edges") << LOG_KV("edgeNum", edges.size());
+    m_dag.addEdges(edges);
+
+    // Generate DAG
+    m_dag.generate();
+    profileDAG();
+
+    m_totalParaTxs = _txs.size();
+
+    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG") << LOG_KV("blockHeight", _blockHeight);
+}
+
+// Generate DAG according with the accessed keys of given transactions
+void TxDAG::init(Transactions const& _txs, std::vector<storage::AccessSet::Ptr> const& _accessSets,
+    int64_t _blockHeight)
+{
+    DAG_LOG(TRACE) << LOG_DESC("Begin init transaction DAG by access sets")
+                   << LOG_KV("blockHeight", _blockHeight) << LOG_KV("transactionNum", _txs.size());
+
+    m_txs = make_shared<Transactions const>(_txs);
+    m_dag.init(_txs.size());
+
+    // the last writer of a key, and the readers of the key since it was written
+    unordered_map<string, ID> writers;
+    unordered_map<string, vector<ID>> readers;
+    // the last transaction of unknown accesses, and the transactions after it
+    ID barrier = INVALID_ID;
+    vector<ID> sinceBarrier;
 
     for (ID id = 0; id < _txs.size(); ++id)
     {
-        auto& tx = _txs[id];
+        // the transactions depended on, and the key of the dependency
+        map<ID, string> dependencies;
+        auto& accessSet = _accessSets[id];
+        if (!accessSet)
+        {
+            // Normal transaction: Conflict with all transaction
+            if (sinceBarrier.empty() && barrier != INVALID_ID)
+            {
+                dependencies.emplace(barrier, c_profileFieldAll);
+            }
+            for (ID pId : sinceBarrier)
+            {
+                dependencies.emplace(pId, c_profileFieldAll);
+            }
 
-        // Is para transaction?
-        auto criticals = _ctx->getTxCriticals(tx);
-        if (criticals)
+            barrier = id;
+            sinceBarrier.clear();
+            writers.clear();
+            readers.clear();
+            ++m_normalTxs;
+            if (m_profile)
+                m_profile->barriers.push_back(id);
+        }
+        else
         {
-            // DAG transaction: Conflict with certain critical fields
-            // Get critical field
+            if (barrier != INVALID_ID)
+            {
+                dependencies.emplace(barrier, c_profileFieldAll);
+            }
 
-            // Add edge between critical transaction
-            for (string const& c : *criticals)
+            // a read follows the last write
+            for (auto& key : accessSet->reads())
             {
-                ID pId = latestCriticals.get(c);
-                if (pId != INVALID_ID)
+                auto it = writers.find(key);
+                if (it != writers.end())
                 {
-                    DAG_LOG(TRACE)
-                        << LOG_DESC("Add edge") << LOG_KV("from", pId) << LOG_KV("to", id);
-                    m_dag.addEdge(pId, id);  // add DAG edge
+                    dependencies.emplace(it->second, key);
                 }
+                readers[key].push_back(id);
             }
 
-            for (string const& c : *criticals)
+            // a write follows the last write and the reads since then
+            for (auto& key : accessSet->writes())
             {
-                latestCriticals.update(c, id);
+                auto it = writers.find(key);
+                if (it != writers.end())
+                {
+                    dependencies.emplace(it->second, key);
+                }
+                auto readersIt = readers.find(key);
+                if (readersIt != readers.end())
+                {
+                    for (ID pId : readersIt->second)
+                    {
+                        dependencies.emplace(pId, key);
+                    }
+                    readers.erase(readersIt);
+                }
+                writers[key] = id;
             }
+            sinceBarrier.push_back(id);
         }
-        else
+
+        for (auto const& dependency : dependencies)
         {
-            // Normal transaction: Conflict with all transaction
-            latestCriticals.foreachField([&](std::pair<string, ID> _fieldAndId) {
-                ID pId = _fieldAndId.second;
-                // Add edge from all critical transaction
-                m_dag.addEdge(pId, id);
-                return true;
-            });
-
-            // set all critical to my id
-            latestCriticals.setCriticalAll(id);
+            DAG_LOG(TRACE) << LOG_DESC("Add edge") << LOG_KV("from", dependency.first)
+                           << LOG_KV("to", id);
+            m_dag.addEdge(dependency.first, id);
+            if (m_profile)
+            {
+                // the table and the key of a field are separated by '\0'
+                auto field = dependency.second;
+                std::replace(field.begin(), field.end(), '\0', '.');
+                ++m_profile->fieldEdges[field];
+            }
         }
     }
 
-    // Generate DAG
     m_dag.generate();
+    profileDAG();
 
     m_totalParaTxs = _txs.size();
 
-    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG") << LOG_KV("blockHeight", _blockHeight);
+    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG by access sets")
+                   << LOG_KV("blockHeight", _blockHeight);
 }
 
 // Set transaction execution function
@@ -99,6 +270,25 @@ void TxDAG::setTxExecuteFunc(ExecuteTxFunc const& _f)
     f_executeTx = _f;
 }
 
+DAGScheduler::Stats TxDAG::executeAll(unsigned _threadNum)
+{
+    DAGScheduler scheduler(_threadNum);
+    scheduler.setProfile(m_profile);
+    auto stats = scheduler.run(m_dag, [&](ID _id) { f_executeTx((*m_txs)[_id], _id); });
+
+    Guard l(x_exeCnt);
+    m_exeCnt = m_totalParaTxs;
+    return stats;
+}
+
+void TxDAG::profileDAG()
+{
+    if (!m_profile)
+        return;
+    m_profile->levelWidths = m_dag.levelWidths();
+    m_profile->criticalPath = m_dag.longestPath();
+}
+
 int TxDAG::executeUnit()
 {
     // PARA_LOG(TRACE) << LOG_DESC("executeUnit") << LOG_KV("exeCnt", m_exeCnt)
@@ -22,9 +22,11 @@
 
 #pragma once
 #include "DAG.h"
+#include "DAGScheduler.h"
 #include "ExecutiveContext.h"
 #include <libethcore/Block.h>
 #include <libethcore/Transaction.h>
+#include <libstorage/AccessSet.h>
 #include <map>
 #include <memory>
 #include <queue>
@@ -59,6 +61,11 @@ public:
     // Generate DAG according with given transactions
     void init(ExecutiveContext::Ptr _ctx, dev::eth::Transactions const& _txs, int64_t _blockHeight);
 
+    // Generate DAG according with the keys each transaction accesses, a transaction of unknown
+    // accesses(nullptr) conflicts with all transactions
+    void init(dev::eth::Transactions const& _txs,
+        std::vector<dev::storage::AccessSet::Ptr> const& _accessSets, int64_t _blockHeight);
+
     // Set transaction execution function
     void setTxExecuteFunc(ExecuteTxFunc const& _f);
 
@@ -71,11 +78,22 @@ public:
     // This function can be parallel
     int executeUnit() override;
 
+    // Execute all transactions with _threadNum workers stealing from each other
+    DAGScheduler::Stats executeAll(unsigned _threadNum);
+
     ID paraTxsNumber() { return m_totalParaTxs; }
 
+    // transactions conflicting with all transactions
+    ID normalTxsNumber() { return m_normalTxs; }
+
     ID haveExecuteNumber() { return m_exeCnt; }
 
+    // record what limits the parallelism of the transactions in _profile, set before init
+    void setProfile(DAGProfile::Ptr _profile) { m_profile = _profile; }
+
 private:
+    void profileDAG();
+
     ExecuteTxFunc f_executeTx;
     std::shared_ptr<dev::eth::Transactions const> m_txs;
 
@@ -83,49 +101,11 @@ private:
 
     ID m_exeCnt = 0;
     ID m_totalParaTxs = 0;
+    ID m_normalTxs = 0;
 
-    mutable std::mutex x_exeCnt;
-};
-
-template <typename T>
-class CriticalField
-{
-public:
-    ID get(T const& _c)
-    {
-        auto it = m_criticals.find(_c);
-        if (it == m_criticals.end())
-        {
-            if (m_criticalAll != INVALID_ID)
-                return m_criticalAll;
-            return INVALID_ID;
-        }
-        return it->second;
-    }
-
-    void update(T const& _c, ID _txId) { m_criticals[_c] = _txId; }
-
-    void foreachField(std::function<bool(std::pair<T, ID>)> const& _f)
-    {
-        for (auto _fieldAndId : m_criticals)
-        {
-            if (!_f(_fieldAndId))
-                break;
-        }
-
-        if (m_criticalAll != INVALID_ID)
-            _f(std::pair<T, ID>(T(), m_criticalAll));
-    }
-
-    void setCriticalAll(ID _id)
-    {
-        m_criticalAll = _id;
-        m_criticals.clear();
-    }
+    DAGProfile::Ptr m_profile;
 
-private:
-    std::map<T, ID> m_criticals;
-    ID m_criticalAll = INVALID_ID;
+    mutable std::mutex x_exeCnt;
 };
 
 }  // namespace blockverifier
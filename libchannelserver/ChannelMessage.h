@@ -53,6 +53,7 @@ public:
         uint16_t typeN = htons(_type);
         int32_t resultN = htonl(_result);
 
+        buffer.reserve(buffer.size() + HEADER_LENGTH + _data->size());
         buffer.insert(buffer.end(), (byte*)&lengthN, (byte*)&lengthN + sizeof(lengthN));
         buffer.insert(buffer.end(), (byte*)&typeN, (byte*)&typeN + sizeof(typeN));
         buffer.insert(buffer.end(), _seq.data(), _seq.data() + _seq.size());
@@ -128,30 +129,8 @@ public:
 
     virtual std::string topic()
     {
-        if (!(_type == 0x30 || _type == 0x31 || _type == 0x1001))
-        {
-            throw(ChannelException(
-                -1, "type: " + boost::lexical_cast<std::string>(_type) +
-                        " Not ChannelMessage, ChannelMessage type must be 0x30, 0x31 or 0x1001"));
-        }
-
-        if (_data->size() < 1)
-        {
-            throw(ChannelException(-1, "ERROR, message length: 0"));
-        }
-
-        uint8_t topicLen = *((uint8_t*)_data->data());
-
-        if (_data->size() < topicLen)
-        {
-            throw(ChannelException(
-                -1, "ERROR, topic length topicLen: " + boost::lexical_cast<std::string>(topicLen) +
-                        " size:" + boost::lexical_cast<std::string>(_data->size())));
-        }
-
-        std::string topic((char*)_data->data() + 1, topicLen - 1);
-
-        return topic;
+        size_t topicLen = topicLength();
+        return std::string((char*)_data->data() + 1, topicLen - 1);
     }
 
     virtual void setTopic(const std::string& topic)
@@ -165,19 +144,9 @@ public:
         _data->insert(_data->end(), topic.begin(), topic.end());
     }
 
-    virtual byte* data() override
-    {
-        std::string topic = this->topic();
-
-        return _data->data() + 1 + topic.size();
-    }
+    virtual byte* data() override { return _data->data() + topicLength(); }
 
-    virtual size_t dataSize() override
-    {
-        std::string topic = this->topic();
-
-        return _data->size() - 1 - topic.size();
-    }
+    virtual size_t dataSize() override { return _data->size() - topicLength(); }
 
     virtual void setData(const byte* p, size_t size) override
     {
@@ -188,6 +157,35 @@ public:
 
         _data->insert(_data->end(), p, p + size);
     }
+
+protected:
+    /// the bytes of the length and the topic ahead of the data, checked without copying the
+    /// topic out
+    size_t topicLength()
+    {
+        if (!(_type == 0x30 || _type == 0x31 || _type == 0x1001))
+        {
+            throw(ChannelException(
+                -1, "type: " + boost::lexical_cast<std::string>(_type) +
+                        " Not ChannelMessage, ChannelMessage type must be 0x30, 0x31 or 0x1001"));
+        }
+
+        if (_data->size() < 1)
+        {
+            throw(ChannelException(-1, "ERROR, message length: 0"));
+        }
+
+        uint8_t topicLen = *((uint8_t*)_data->data());
+
+        if (topicLen < 1 || _data->size() < topicLen)
+        {
+            throw(ChannelException(
+                -1, "ERROR, topic length topicLen: " + boost::lexical_cast<std::string>(topicLen) +
+                        " size:" + boost::lexical_cast<std::string>(_data->size())));
+        }
+
+        return topicLen;
+    }
 };
 
 }  // namespace channel
@@ -28,8 +28,11 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <json/json.h>
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/CommonJS.h>
 #include <libdevcore/easylog.h>
 #include <libp2p/P2PMessage.h>
+#include <librpc/JsonHelper.h>
 #include <libp2p/Service.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
@@ -150,8 +153,6 @@ bool ChannelRPCServer::SendResponse(const std::string& _response, void* _addInfo
                            << LOG_KV("seq", it->first.substr(0, c_seqAbridgedLen))
                            << LOG_KV("response", _response);
 
-        std::shared_ptr<bytes> resp(new bytes());
-
         auto message = it->second->messageFactory()->buildMessage();
         message->setSeq(it->first);
         message->setResult(0);
@@ -240,6 +241,8 @@ void ChannelRPCServer::onDisconnect(
             }
         }
     }
+    m_topicIndex.remove(session);
+    m_eventSubscription.remove(session);
 
     updateHostTopics();
 }
@@ -277,6 +280,16 @@ void dev::ChannelRPCServer::onClientRequest(dev::channel::ChannelSession::Ptr se
         case 0x32:
             onClientTopicRequest(session, message);
             break;
+        case 0x35:
+            onClientStreamRequest(session, message);
+            break;
+        case 0x40:
+        case 0x41:
+            onClientSubscribeRequest(session, message);
+            break;
+        case 0x43:
+            onClientBlockRangeRequest(session, message);
+            break;
         default:
             CHANNEL_LOG(ERROR) << "unknown client message" << LOG_KV("type", message->type());
             break;
@@ -313,12 +326,22 @@ void dev::ChannelRPCServer::onClientEthereumRequest(
             auto sessionRef = std::weak_ptr<dev::channel::ChannelSession>(session);
             auto serverRef = std::weak_ptr<dev::channel::ChannelServer>(_server);
 
-            m_callbackSetter(new std::function<void(const std::string& receiptContext)>(
-                [serverRef, sessionRef, seq](const std::string& receiptContext) {
-                    auto server = serverRef.lock();
+            m_callbackSetter(new dev::eth::RPCCallback(
+                [serverRef, sessionRef, seq](dev::eth::LocalisedTransactionReceipt::Ptr receipt) {
                     auto session = sessionRef.lock();
-                    if (server && session)
+                    if (!session)
                     {
+                        return;
+                    }
+                    /// the receipt is encoded on the response thread pool together with the
+                    /// others of the block pushed to the session
+                    session->asyncPushMessage([serverRef, seq, receipt]() {
+                        auto server = serverRef.lock();
+                        if (!server)
+                        {
+                            return Message::Ptr();
+                        }
+                        auto receiptContext = Json::FastWriter().write(rpc::toJson(*receipt));
                         auto channelMessage = server->messageFactory()->buildMessage();
                         channelMessage->setType(0x1000);
                         channelMessage->setSeq(seq);
@@ -327,9 +350,8 @@ void dev::ChannelRPCServer::onClientEthereumRequest(
                             (const byte*)receiptContext.c_str(), receiptContext.size());
 
                         LOG(TRACE) << "Push transaction notify: " << seq;
-                        session->asyncSendMessage(channelMessage,
-                            std::function<void(dev::channel::ChannelException, Message::Ptr)>(), 0);
-                    }
+                        return channelMessage;
+                    });
                 }));
         }
     }
@@ -448,6 +470,10 @@ void dev::ChannelRPCServer::onNodeChannelRequest(
                     s->nodeID(), p2pResponse, CallbackFuncWithSession(), dev::network::Options());
             }
         }
+        else if (channelMessage->type() == 0x35)
+        {
+            onNodeStreamRequest(s->nodeID(), msg, channelMessage, topic);
+        }
     }
     catch (std::exception& e)
     {
@@ -489,6 +515,11 @@ void dev::ChannelRPCServer::onClientTopicRequest(
         }
 
         session->setTopics(topics);
+        /// a session disconnected meanwhile isn't indexed again
+        if (session->actived())
+        {
+            m_topicIndex.update(session, *topics);
+        }
 
         updateHostTopics();
     }
@@ -499,6 +530,179 @@ void dev::ChannelRPCServer::onClientTopicRequest(
     }
 }
 
+void dev::ChannelRPCServer::onClientSubscribeRequest(
+    dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message)
+{
+    std::string body(message->data(), message->data() + message->dataSize());
+
+    CHANNEL_LOG(DEBUG) << "SDK subscribe message" << LOG_KV("type", message->type())
+                       << LOG_KV("seq", message->seq().substr(0, c_seqAbridgedLen))
+                       << LOG_KV("message", body);
+
+    Json::Value response;
+    int result = 0;
+    try
+    {
+        Json::Value root;
+        Json::Reader reader;
+        if (!reader.parse(body, root))
+        {
+            BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("invalid json"));
+        }
+
+        if (message->type() == 0x40)
+        {
+            auto filter = dev::channel::EventFilter::fromJson(root);
+            /// a session disconnected meanwhile doesn't subscribe
+            uint64_t filterID =
+                session->actived() ? m_eventSubscription.subscribe(session, filter) : 0;
+            if (filterID == 0)
+            {
+                BOOST_THROW_EXCEPTION(
+                    ValueTooLarge() << errinfo_comment("too many subscriptions"));
+            }
+            response["filterID"] = Json::UInt64(filterID);
+        }
+        else
+        {
+            uint64_t filterID = root["filterID"].asUInt64();
+            response["filterID"] = Json::UInt64(filterID);
+            response["removed"] = m_eventSubscription.unsubscribe(session, filterID);
+        }
+    }
+    catch (std::exception& e)
+    {
+        CHANNEL_LOG(WARNING) << "onClientSubscribeRequest error"
+                             << LOG_KV("what", boost::diagnostic_information(e));
+        result = 1;
+        response["error"] = boost::diagnostic_information(e);
+    }
+
+    auto responseMessage = _server->messageFactory()->buildMessage();
+    responseMessage->setType(message->type());
+    responseMessage->setSeq(message->seq());
+    responseMessage->setResult(result);
+    std::string data = Json::FastWriter().write(response);
+    responseMessage->setData((const byte*)data.data(), data.size());
+    session->asyncSendMessage(responseMessage, dev::channel::ChannelSession::CallbackType(), 0);
+}
+
+void dev::ChannelRPCServer::onClientBlockRangeRequest(
+    dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message)
+{
+    std::string body(message->data(), message->data() + message->dataSize());
+
+    CHANNEL_LOG(DEBUG) << "SDK block range request"
+                       << LOG_KV("seq", message->seq().substr(0, c_seqAbridgedLen))
+                       << LOG_KV("message", body);
+
+    Json::Value response;
+    int result = 0;
+    std::shared_ptr<blockchain::BlockChainInterface> blockChain;
+    BlockRange range;
+    try
+    {
+        Json::Value root;
+        Json::Reader reader;
+        if (!reader.parse(body, root) || !root["groupID"].isIntegral())
+        {
+            BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("invalid request"));
+        }
+        range.groupID = root["groupID"].asInt();
+        blockChain = m_blockChainGetter ? m_blockChainGetter(range.groupID) : nullptr;
+        if (!blockChain)
+        {
+            BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("unknown group"));
+        }
+        range.seq = message->seq();
+        range.next = root.get("from", 0).asInt64();
+        range.to = std::min<int64_t>(
+            root.get("to", Json::Int64(blockChain->number())).asInt64(), blockChain->number());
+        range.blocksPerChunk = std::min<size_t>(
+            root.get("blocksPerChunk", Json::UInt64(c_blocksPerChunk)).asUInt64(),
+            c_maxBlocksPerChunk);
+        if (range.next < 0 || range.next > range.to || range.blocksPerChunk == 0)
+        {
+            BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("invalid range"));
+        }
+        response["from"] = Json::Int64(range.next);
+        response["to"] = Json::Int64(range.to);
+    }
+    catch (std::exception& e)
+    {
+        CHANNEL_LOG(WARNING) << "onClientBlockRangeRequest error"
+                             << LOG_KV("what", boost::diagnostic_information(e));
+        result = 1;
+        response["error"] = boost::diagnostic_information(e);
+    }
+
+    auto responseMessage = _server->messageFactory()->buildMessage();
+    responseMessage->setType(message->type());
+    responseMessage->setSeq(message->seq());
+    responseMessage->setResult(result);
+    std::string data = Json::FastWriter().write(response);
+    responseMessage->setData((const byte*)data.data(), data.size());
+    session->asyncSendMessage(responseMessage, dev::channel::ChannelSession::CallbackType(), 0);
+
+    if (result == 0)
+    {
+        sendBlockChunk(session, blockChain, range);
+    }
+}
+
+void dev::ChannelRPCServer::sendBlockChunk(std::weak_ptr<dev::channel::ChannelSession> _session,
+    std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain, BlockRange _range)
+{
+    auto session = _session.lock();
+    if (!session || !session->actived())
+    {
+        return;
+    }
+    Json::Value chunk;
+    chunk["seq"] = _range.seq;
+    chunk["groupID"] = _range.groupID;
+    chunk["from"] = Json::Int64(_range.next);
+    chunk["blocks"] = Json::Value(Json::arrayValue);
+    for (size_t i = 0; i < _range.blocksPerChunk && _range.next <= _range.to; ++i, ++_range.next)
+    {
+        auto block = _blockChain->getBlockRLPByNumber(_range.next);
+        chunk["blocks"].append(block ? toJS(*block) : Json::Value());
+    }
+    chunk["last"] = (_range.next > _range.to);
+
+    auto message = _server->messageFactory()->buildMessage();
+    message->setType(0x44);
+    message->setSeq(newSeq());
+    message->setResult(0);
+    std::string data = Json::FastWriter().write(chunk);
+    message->setData((const byte*)data.data(), data.size());
+    if (_range.next > _range.to)
+    {
+        session->asyncSendMessage(message, dev::channel::ChannelSession::CallbackType(), 0);
+        return;
+    }
+    /// the next chunk is read only once the sdk has taken this one
+    auto self = std::weak_ptr<ChannelRPCServer>(shared_from_this());
+    session->asyncSendMessage(message,
+        [self, _session, _blockChain, _range](
+            dev::channel::ChannelException _e, dev::channel::Message::Ptr) {
+            auto server = self.lock();
+            if (!server)
+            {
+                return;
+            }
+            if (_e.errorCode() != 0)
+            {
+                CHANNEL_LOG(WARNING) << LOG_DESC("block range stream stopped")
+                                     << LOG_KV("seq", _range.seq.substr(0, c_seqAbridgedLen))
+                                     << LOG_KV("next", _range.next) << LOG_KV("what", _e.what());
+                return;
+            }
+            server->sendBlockChunk(_session, _blockChain, _range);
+        },
+        c_chunkAckTimeout);
+}
+
 void dev::ChannelRPCServer::onClientChannelRequest(
     dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message)
 {
@@ -576,6 +780,248 @@ void dev::ChannelRPCServer::onClientChannelRequest(
     }
 }
 
+void dev::ChannelRPCServer::onClientStreamRequest(
+    dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message)
+{
+    auto reply = [session, message](int _result) {
+        message->setType(0x36);
+        message->setResult(_result);
+        message->clearData();
+        session->asyncSendMessage(message, dev::channel::ChannelSession::CallbackType(), 0);
+    };
+    h256 id;
+    if (!streamID(message, id))
+    {
+        CHANNEL_LOG(ERROR) << "invalid stream chunk too short";
+        return;
+    }
+    uint8_t topicLen = *((uint8_t*)message->data());
+    std::string topic((char*)message->data() + 1, topicLen - 1);
+    size_t chunkBytes = message->dataSize();
+    if (!acquireStreamBytes(chunkBytes))
+    {
+        CHANNEL_LOG(DEBUG) << LOG_DESC("stream chunk refused, too many in flight")
+                           << LOG_KV("stream", id.abridged()) << LOG_KV("bytes", m_streamBytes);
+        reply(STREAM_BUSY);
+        return;
+    }
+
+    try
+    {
+        auto buffer = std::make_shared<bytes>();
+        message->encode(*buffer);
+        auto p2pMessage = std::dynamic_pointer_cast<p2p::P2PMessage>(
+            m_service->p2pMessageFactory()->buildMessage());
+        p2pMessage->setBuffer(buffer);
+        p2pMessage->setProtocolID(dev::eth::ProtocolID::AMOP);
+        p2pMessage->setPacketType(0u);
+        dev::network::Options options;
+        options.timeout = c_chunkAckTimeout;
+
+        auto self = std::weak_ptr<ChannelRPCServer>(shared_from_this());
+        auto callback = [self, session, message, id, chunkBytes, reply](
+                            dev::network::NetworkException e,
+                            std::shared_ptr<dev::p2p::P2PSession> s,
+                            dev::p2p::P2PMessage::Ptr response) {
+            auto server = self.lock();
+            if (!server)
+            {
+                return;
+            }
+            server->m_streamBytes -= chunkBytes;
+            if (e.errorCode())
+            {
+                CHANNEL_LOG(WARNING) << LOG_DESC("stream chunk failed")
+                                     << LOG_KV("stream", id.abridged())
+                                     << LOG_KV("errorCode", e.errorCode())
+                                     << LOG_KV("what", e.what());
+                server->eraseStreamRoute(id);
+                reply(REMOTE_PEER_UNAVAILIBLE);
+                return;
+            }
+            message->decode(response->buffer()->data(), response->buffer()->size());
+            if (message->result() != 0 || !s)
+            {
+                server->eraseStreamRoute(id);
+            }
+            else
+            {
+                auto route = server->streamRoute(id);
+                route.nodeID = s->nodeID();
+                server->updateStreamRoute(id, route);
+            }
+            session->asyncSendMessage(message, dev::channel::ChannelSession::CallbackType(), 0);
+        };
+
+        /// the first chunks go to any node of the topic, the others follow the first acked
+        auto route = streamRoute(id);
+        if (route.nodeID && m_service->isConnected(route.nodeID))
+        {
+            m_service->asyncSendMessageByNodeID(route.nodeID, p2pMessage, callback, options);
+        }
+        else
+        {
+            m_service->asyncSendMessageByTopic(topic, p2pMessage, callback, options);
+        }
+    }
+    catch (exception& e)
+    {
+        CHANNEL_LOG(ERROR) << "send stream chunk error"
+                           << LOG_KV("what", boost::diagnostic_information(e));
+        m_streamBytes -= chunkBytes;
+        reply(REMOTE_PEER_UNAVAILIBLE);
+    }
+}
+
+void dev::ChannelRPCServer::onNodeStreamRequest(h512 const& _nodeID,
+    std::shared_ptr<p2p::P2PMessage> _p2pMessage, dev::channel::Message::Ptr _message,
+    std::string const& _topic)
+{
+    auto service = m_service;
+    auto respond = [service, _nodeID, _p2pMessage](dev::channel::Message::Ptr _response) {
+        auto buffer = std::make_shared<bytes>();
+        _response->encode(*buffer);
+        auto p2pResponse = std::dynamic_pointer_cast<dev::p2p::P2PMessage>(
+            service->p2pMessageFactory()->buildMessage());
+        p2pResponse->setBuffer(buffer);
+        p2pResponse->setProtocolID(-dev::eth::ProtocolID::AMOP);
+        p2pResponse->setPacketType(0u);
+        p2pResponse->setSeq(_p2pMessage->seq());
+        service->asyncSendMessageByNodeID(
+            _nodeID, p2pResponse, CallbackFuncWithSession(), dev::network::Options());
+    };
+    auto fail = [respond, _message](int _result) {
+        _message->setType(0x36);
+        _message->setResult(_result);
+        _message->clearData();
+        respond(_message);
+    };
+    h256 id;
+    if (!streamID(_message, id))
+    {
+        CHANNEL_LOG(ERROR) << "invalid stream chunk too short";
+        return;
+    }
+    size_t chunkBytes = _message->dataSize();
+    if (!acquireStreamBytes(chunkBytes))
+    {
+        fail(STREAM_BUSY);
+        return;
+    }
+
+    /// the chunks of a stream go to the same sdk while it subscribes the topic
+    auto sessions = getSessionByTopic(_topic);
+    auto route = streamRoute(id);
+    auto session = route.session.lock();
+    if (!session || std::find(sessions.begin(), sessions.end(), session) == sessions.end())
+    {
+        session = sessions.empty() ? dev::channel::ChannelSession::Ptr() :
+                                     sessions[utcTimeUs() % sessions.size()];
+    }
+    if (!session)
+    {
+        CHANNEL_LOG(WARNING) << LOG_DESC("no session for the stream") << LOG_KV("topic", _topic)
+                             << LOG_KV("stream", id.abridged());
+        m_streamBytes -= chunkBytes;
+        eraseStreamRoute(id);
+        fail(REMOTE_CLIENT_PEER_UNAVAILBLE);
+        return;
+    }
+    route.session = session;
+    updateStreamRoute(id, route);
+
+    auto self = std::weak_ptr<ChannelRPCServer>(shared_from_this());
+    session->asyncSendMessage(_message,
+        [self, id, chunkBytes, respond, fail](
+            dev::channel::ChannelException e, dev::channel::Message::Ptr response) {
+            auto server = self.lock();
+            if (server)
+            {
+                server->m_streamBytes -= chunkBytes;
+            }
+            if (e.errorCode() != 0)
+            {
+                CHANNEL_LOG(WARNING) << LOG_DESC("push stream chunk failed")
+                                     << LOG_KV("stream", id.abridged())
+                                     << LOG_KV("errorCode", e.errorCode())
+                                     << LOG_KV("what", e.what());
+                if (server)
+                {
+                    server->eraseStreamRoute(id);
+                }
+                fail(REMOTE_CLIENT_PEER_UNAVAILBLE);
+                return;
+            }
+            respond(response);
+        },
+        c_chunkAckTimeout);
+}
+
+bool ChannelRPCServer::streamID(dev::channel::Message::Ptr _message, h256& _id)
+{
+    if (_message->dataSize() < 1)
+    {
+        return false;
+    }
+    uint8_t topicLen = *((uint8_t*)_message->data());
+    if (topicLen < 1 || _message->dataSize() < topicLen + h256::size)
+    {
+        return false;
+    }
+    _id = h256(bytesConstRef(_message->data() + topicLen, h256::size));
+    return true;
+}
+
+bool ChannelRPCServer::acquireStreamBytes(size_t _bytes)
+{
+    auto current = m_streamBytes.load();
+    do
+    {
+        if (current + _bytes > c_maxStreamBytes)
+        {
+            return false;
+        }
+    } while (!m_streamBytes.compare_exchange_weak(current, current + _bytes));
+    return true;
+}
+
+ChannelRPCServer::StreamRoute ChannelRPCServer::streamRoute(h256 const& _id)
+{
+    auto now = utcTime();
+    std::lock_guard<std::mutex> lock(x_streamRoutes);
+    auto it = m_streamRoutes.find(_id);
+    if (it != m_streamRoutes.end() && now - it->second.lastTime <= c_streamIdleTimeout)
+    {
+        return it->second;
+    }
+    for (it = m_streamRoutes.begin(); it != m_streamRoutes.end();)
+    {
+        if (now - it->second.lastTime > c_streamIdleTimeout)
+        {
+            it = m_streamRoutes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return StreamRoute();
+}
+
+void ChannelRPCServer::updateStreamRoute(h256 const& _id, StreamRoute const& _route)
+{
+    std::lock_guard<std::mutex> lock(x_streamRoutes);
+    auto& route = m_streamRoutes[_id];
+    route = _route;
+    route.lastTime = utcTime();
+}
+
+void ChannelRPCServer::eraseStreamRoute(h256 const& _id)
+{
+    std::lock_guard<std::mutex> lock(x_streamRoutes);
+    m_streamRoutes.erase(_id);
+}
+
 void ChannelRPCServer::setListenAddr(const std::string& listenAddr)
 {
     _listenAddr = listenAddr;
@@ -608,7 +1054,8 @@ void ChannelRPCServer::setChannelServer(std::shared_ptr<dev::channel::ChannelSer
 
 void ChannelRPCServer::asyncPushChannelMessage(std::string topic,
     dev::channel::Message::Ptr message,
-    std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> callback)
+    std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> callback,
+    uint32_t timeout)
 {
     try
     {
@@ -620,8 +1067,13 @@ void ChannelRPCServer::asyncPushChannelMessage(std::string topic,
             Callback(std::string topic, dev::channel::Message::Ptr message,
                 ChannelRPCServer::Ptr server,
                 std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)>
-                    callback)
-              : _topic(topic), _message(message), _server(server), _callback(callback){};
+                    callback,
+                uint32_t timeout)
+              : _topic(topic),
+                _message(message),
+                _server(server),
+                _callback(callback),
+                _timeout(timeout){};
 
             void onResponse(dev::channel::ChannelException e, dev::channel::Message::Ptr message)
             {
@@ -712,7 +1164,7 @@ void ChannelRPCServer::asyncPushChannelMessage(std::string topic,
                 std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> fp =
                     std::bind(&Callback::onResponse, shared_from_this(), std::placeholders::_1,
                         std::placeholders::_2);
-                session->asyncSendMessage(_message, fp, 5000);
+                session->asyncSendMessage(_message, fp, _timeout);
 
                 CHANNEL_LOG(INFO) << "Push channel message success"
                                   << LOG_KV("seq", _message->seq().substr(0, c_seqAbridgedLen))
@@ -728,10 +1180,11 @@ void ChannelRPCServer::asyncPushChannelMessage(std::string topic,
             std::set<dev::channel::ChannelSession::Ptr> _exclude;
             std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)>
                 _callback;
+            uint32_t _timeout;
         };
 
         Callback::Ptr pushCallback =
-            std::make_shared<Callback>(topic, message, shared_from_this(), callback);
+            std::make_shared<Callback>(topic, message, shared_from_this(), callback, timeout);
         pushCallback->sendMessage();
     }
     catch (dev::channel::ChannelException& ex)
@@ -766,6 +1219,28 @@ void ChannelRPCServer::asyncBroadcastChannelMessage(
     }
 }
 
+void ChannelRPCServer::pushEvents(
+    int _groupID, dev::eth::Block const& _block, dev::eth::TransactionReceipts const& _receipts)
+{
+    auto events = m_eventSubscription.events(_groupID, _block, _receipts);
+    for (auto const& it : events)
+    {
+        auto message = _server->messageFactory()->buildMessage();
+        message->setType(0x42);
+        message->setSeq(std::string(32, '0'));
+        message->setResult(0);
+        std::string data = Json::FastWriter().write(it.second);
+        message->setData((const byte*)data.data(), data.size());
+        it.first->asyncSendMessage(
+            message, std::function<void(dev::channel::ChannelException, Message::Ptr)>(), 0);
+
+        CHANNEL_LOG(TRACE) << "Push events" << LOG_KV("groupID", _groupID)
+                           << LOG_KV("number", _block.blockHeader().number())
+                           << LOG_KV("events", it.second.size())
+                           << LOG_KV("session", it.first->host()) << ":" << it.first->port();
+    }
+}
+
 dev::channel::TopicChannelMessage::Ptr ChannelRPCServer::pushChannelMessage(
     dev::channel::TopicChannelMessage::Ptr message, size_t timeout)
 {
@@ -829,14 +1304,8 @@ std::string ChannelRPCServer::newSeq()
 
 void ChannelRPCServer::updateHostTopics()
 {
-    auto allTopics = std::make_shared<std::vector<std::string> >();
-
-    std::lock_guard<std::mutex> lock(_sessionMutex);
-    for (auto& it : _sessions)
-    {
-        auto topics = it.second->topics();
-        allTopics->insert(allTopics->end(), topics.begin(), topics.end());
-    }
+    auto topics = m_topicIndex.topics();
+    auto allTopics = std::make_shared<std::vector<std::string> >(topics.begin(), topics.end());
 
     m_service->setTopics(allTopics);
 }
@@ -846,19 +1315,11 @@ std::vector<dev::channel::ChannelSession::Ptr> ChannelRPCServer::getSessionByTop
 {
     std::vector<dev::channel::ChannelSession::Ptr> activedSessions;
 
-    std::lock_guard<std::mutex> lock(_sessionMutex);
-    for (auto& it : _sessions)
+    for (auto const& session : m_topicIndex.find(topic))
     {
-        if (it.second->topics().empty() || !it.second->actived())
-        {
-            continue;
-        }
-
-        auto topics = it.second->topics();
-        auto topicIt = topics.find(topic);
-        if (topicIt != topics.end())
+        if (session->actived())
         {
-            activedSessions.push_back(it.second);
+            activedSessions.push_back(session);
         }
     }
 
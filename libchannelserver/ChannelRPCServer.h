@@ -30,11 +30,14 @@
 #include "ChannelMessage.h"
 #include "ChannelServer.h"
 #include "ChannelSession.h"
+#include "EventSubscription.h"
 #include "libdevcore/ThreadPool.h"
 #include <jsonrpccpp/server/abstractserverconnector.h>
 #include <libdevcore/FixedHash.h>
 #include <libethcore/Common.h>
+#include <libethcore/Transaction.h>
 #include <libp2p/Service.h>
+#include <libp2p/TopicIndex.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -50,6 +53,20 @@ namespace p2p
 {
 class P2PInterface;
 }
+namespace blockchain
+{
+class BlockChainInterface;
+}
+
+/// the blocks of a chunk of a block range stream by default, and at most
+static const size_t c_blocksPerChunk = 16;
+static const size_t c_maxBlocksPerChunk = 128;
+/// a stream whose chunk is not acknowledged in time stops
+static const uint32_t c_chunkAckTimeout = 30000;
+/// the bytes of the amop stream chunks a node relays and waits the acks of, at most
+static const uint64_t c_maxStreamBytes = 64 * 1024 * 1024;
+/// the route of an amop stream idle for longer is forgotten
+static const uint64_t c_streamIdleTimeout = 60 * 1000;
 
 class ChannelRPCServer : public jsonrpc::AbstractServerConnector,
                          public std::enable_shared_from_this<ChannelRPCServer>
@@ -59,7 +76,9 @@ public:
     {
         REMOTE_PEER_UNAVAILIBLE = 100,
         REMOTE_CLIENT_PEER_UNAVAILBLE = 101,
-        TIMEOUT = 102
+        TIMEOUT = 102,
+        /// the node relays too many stream chunks, sent again after an ack
+        STREAM_BUSY = 103
     };
 
     typedef std::shared_ptr<ChannelRPCServer> Ptr;
@@ -92,6 +111,25 @@ public:
     virtual void onClientChannelRequest(
         dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
 
+    /// relay a chunk (0x35) of an amop stream, acknowledged by the receiver with 0x36. The data of
+    /// a chunk is the topic as in 0x30, the 32 bytes id of the stream, then whatever the sdks put
+    /// in it, the offset of the chunk for example. The chunks of a stream go to the same node and
+    /// the same sdk while they are connected, and are relayed as they come, a node holds
+    /// c_maxStreamBytes of them at most and refuses the others with STREAM_BUSY, so the sender
+    /// keeps a window of chunks waiting for their acks. A chunk failed drops the route, the next
+    /// one reaches another receiver whose ack tells the sender where to resume.
+    virtual void onClientStreamRequest(
+        dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
+
+    /// subscribe (0x40) or unsubscribe (0x41) the events of the committed blocks
+    virtual void onClientSubscribeRequest(
+        dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
+
+    /// stream the blocks of a range (0x43) in chunks (0x44), each sent once the sdk has
+    /// acknowledged the last one
+    virtual void onClientBlockRangeRequest(
+        dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
+
     void setListenAddr(const std::string& listenAddr);
 
     void setListenPort(int listenPort);
@@ -110,8 +148,11 @@ public:
     std::shared_ptr<dev::channel::ChannelServer> channelServer() { return _server; }
     void setChannelServer(std::shared_ptr<dev::channel::ChannelServer> server);
 
-    void asyncPushChannelMessage(std::string topic, dev::channel::Message::Ptr message,
-        std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> callback);
+    /// push a message to an sdk of topic, the others are tried in turn if it fails or doesn't
+    /// respond in timeout ms
+    virtual void asyncPushChannelMessage(std::string topic, dev::channel::Message::Ptr message,
+        std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> callback,
+        uint32_t timeout = 5000);
 
     void asyncBroadcastChannelMessage(std::string topic, dev::channel::Message::Ptr message);
 
@@ -120,15 +161,63 @@ public:
 
     virtual std::string newSeq();
 
-    void setCallbackSetter(
-        std::function<void(std::function<void(const std::string& receiptContext)>*)> callbackSetter)
+    void setCallbackSetter(std::function<void(dev::eth::RPCCallback*)> callbackSetter)
     {
         m_callbackSetter = callbackSetter;
     };
 
     void addHandler(const dev::eth::Handler<int64_t>& handler) { m_handlers.push_back(handler); }
 
+    /// the blockchain of a group, null if the node is not in the group
+    void setBlockChainGetter(
+        std::function<std::shared_ptr<dev::blockchain::BlockChainInterface>(int)> _getter)
+    {
+        m_blockChainGetter = _getter;
+    }
+
+    /// whether any sdk subscribes the blocks or, with _logs, the logs of _groupID
+    bool eventSubscribed(int _groupID, bool _logs) const
+    {
+        return m_eventSubscription.subscribed(_groupID, _logs);
+    }
+    /// push the events of a committed block to their subscribers, one message (0x42) each
+    void pushEvents(int _groupID, dev::eth::Block const& _block,
+        dev::eth::TransactionReceipts const& _receipts);
+
 private:
+    struct BlockRange
+    {
+        int groupID;
+        /// the seq of the request, the chunks refer to it
+        std::string seq;
+        int64_t next;
+        int64_t to;
+        size_t blocksPerChunk;
+    };
+    /// read and send the chunk of the blocks from _range.next only, nothing more is held
+    void sendBlockChunk(std::weak_ptr<dev::channel::ChannelSession> _session,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain, BlockRange _range);
+
+    /// where the chunks of an amop stream go, the node on the sender side and the sdk on the
+    /// receiver side
+    struct StreamRoute
+    {
+        dev::h512 nodeID;
+        std::weak_ptr<dev::channel::ChannelSession> session;
+        uint64_t lastTime = 0;
+    };
+    /// the stream id of a chunk, false if it is too short
+    static bool streamID(dev::channel::Message::Ptr _message, h256& _id);
+    /// take _bytes of the relay budget, false if it is used up
+    bool acquireStreamBytes(size_t _bytes);
+    /// the route of _id, and the routes idle too long are forgotten
+    StreamRoute streamRoute(h256 const& _id);
+    void updateStreamRoute(h256 const& _id, StreamRoute const& _route);
+    void eraseStreamRoute(h256 const& _id);
+    /// push a chunk from a node to the sdk receiving its stream
+    void onNodeStreamRequest(h512 const& _nodeID, std::shared_ptr<p2p::P2PMessage> _p2pMessage,
+        dev::channel::Message::Ptr _message, std::string const& _topic);
+
     void initSSLContext();
 
     dev::channel::ChannelSession::Ptr sendChannelMessageToSession(std::string topic,
@@ -149,6 +238,8 @@ private:
     std::shared_ptr<dev::channel::ChannelServer> _server;
 
     std::map<int, dev::channel::ChannelSession::Ptr> _sessions;
+    /// the sdks subscribing each topic
+    dev::p2p::TopicIndex<dev::channel::ChannelSession::Ptr> m_topicIndex;
     std::mutex _sessionMutex;
 
     std::map<std::string, dev::channel::ChannelSession::Ptr> _seq2session;
@@ -161,8 +252,15 @@ private:
 
     std::shared_ptr<dev::p2p::P2PInterface> m_service;
 
-    std::function<void(std::function<void(const std::string& receiptContext)>*)> m_callbackSetter;
+    std::function<void(dev::eth::RPCCallback*)> m_callbackSetter;
+    std::function<std::shared_ptr<dev::blockchain::BlockChainInterface>(int)> m_blockChainGetter;
     std::vector<dev::eth::Handler<int64_t> > m_handlers;
+    dev::channel::EventSubscription<dev::channel::ChannelSession::Ptr> m_eventSubscription;
+
+    std::map<h256, StreamRoute> m_streamRoutes;
+    std::mutex x_streamRoutes;
+    /// the bytes of the chunks relayed and not acknowledged yet
+    std::atomic<uint64_t> m_streamBytes = {0};
 };
 
 }  // namespace dev
@@ -95,7 +95,7 @@ void dev::channel::ChannelServer::onAccept(
             CHANNEL_LOG(TRACE) << LOG_DESC("Start SSL handshake");
             session->sslSocket()->async_handshake(boost::asio::ssl::stream_base::server,
                 boost::bind(&ChannelServer::onHandshake, shared_from_this(),
-                    boost::asio::placeholders::error, session));
+                    boost::asio::placeholders::error, session, utcTimeUs()));
         }
         else
         {
@@ -182,13 +182,20 @@ void dev::channel::ChannelServer::stop()
 }
 
 void dev::channel::ChannelServer::onHandshake(
-    const boost::system::error_code& error, ChannelSession::Ptr session)
+    const boost::system::error_code& error, ChannelSession::Ptr session, uint64_t startTime)
 {
     try
     {
         if (!error)
         {
-            CHANNEL_LOG(TRACE) << LOG_DESC("SSL handshake success");
+            /// the sdks reconnecting with a session ticket skip the key exchange
+            bool resumed = SSL_session_reused(session->sslSocket()->native_handle());
+            m_handshakeStat.record(utcTimeUs() - startTime, resumed);
+            CHANNEL_LOG(TRACE) << LOG_DESC("SSL handshake success") << LOG_KV("resumed", resumed)
+                               << LOG_KV("timeCost(us)", utcTimeUs() - startTime)
+                               << LOG_KV("handshakes", m_handshakeStat.count())
+                               << LOG_KV("resumedHandshakes", m_handshakeStat.resumed())
+                               << LOG_KV("avgTimeCost(us)", m_handshakeStat.averageTimeCost());
             if (m_connectionHandler)
             {
                 m_connectionHandler(ChannelException(), session);
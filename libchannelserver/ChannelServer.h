@@ -38,6 +38,7 @@
 #include "ChannelSession.h"
 #include "Message.h"
 #include "libdevcore/ThreadPool.h"
+#include <libnetwork/Common.h>
 
 namespace dev
 {
@@ -85,8 +86,12 @@ public:
 
     virtual void stop();
 
+    /// the ssl handshakes of the sdk connections
+    dev::network::HandshakeStat const& handshakeStat() const { return m_handshakeStat; }
+
 private:
-    void onHandshake(const boost::system::error_code& error, ChannelSession::Ptr session);
+    void onHandshake(
+        const boost::system::error_code& error, ChannelSession::Ptr session, uint64_t startTime);
 
     std::shared_ptr<boost::asio::io_service> m_ioService;
     std::shared_ptr<boost::asio::ssl::context> m_sslContext;
@@ -99,6 +104,7 @@ private:
 
     std::function<void(dev::channel::ChannelException, ChannelSession::Ptr)> m_connectionHandler;
     MessageFactory::Ptr m_messageFactory;
+    dev::network::HandshakeStat m_handshakeStat;
 
     std::string m_listenHost = "";
     int m_listenPort = 0;
@@ -125,7 +125,7 @@ void ChannelSession::asyncSendMessage(Message::Ptr request,
             insertResponseCallback(request->seq(), responseCallback);
         }
 
-        std::shared_ptr<bytes> p_buffer = std::make_shared<bytes>();
+        std::shared_ptr<bytes> p_buffer = acquireBuffer();
         request->encode(*p_buffer);
         writeBuffer(p_buffer);
     }
@@ -136,6 +136,71 @@ void ChannelSession::asyncSendMessage(Message::Ptr request,
     }
 }
 
+void ChannelSession::asyncPushMessage(std::function<Message::Ptr()> const& _build)
+{
+    if (!_actived)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(x_pushes);
+        m_pushes.push_back(_build);
+        if (m_pushScheduled)
+        {
+            return;
+        }
+        m_pushScheduled = true;
+    }
+    auto session = std::weak_ptr<ChannelSession>(shared_from_this());
+    m_responseThreadPool->enqueue([session]() {
+        auto s = session.lock();
+        if (s)
+        {
+            s->flushPushes();
+        }
+    });
+}
+
+void ChannelSession::flushPushes()
+{
+    /// the task drains the pushes until none is left, so that they are written in order
+    while (true)
+    {
+        std::vector<std::function<Message::Ptr()> > pushes;
+        {
+            std::lock_guard<std::mutex> lock(x_pushes);
+            if (m_pushes.empty() || !_actived)
+            {
+                m_pushes.clear();
+                m_pushScheduled = false;
+                return;
+            }
+            pushes.swap(m_pushes);
+        }
+        auto buffer = acquireBuffer();
+        for (auto const& build : pushes)
+        {
+            try
+            {
+                auto message = build();
+                if (message)
+                {
+                    message->encode(*buffer);
+                }
+            }
+            catch (std::exception& e)
+            {
+                CHANNEL_SESSION_LOG(ERROR) << LOG_DESC("build pushed message error")
+                                           << LOG_KV("what", boost::diagnostic_information(e));
+            }
+        }
+        if (!buffer->empty())
+        {
+            writeBuffer(buffer);
+        }
+    }
+}
+
 void ChannelSession::run()
 {
     try
@@ -171,10 +236,15 @@ void ChannelSession::startRead()
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
 
+            /// read straight behind the bytes received, onRead trims the unread tail
+            size_t received = _recvProtocolBuffer.size();
+            _recvProtocolBuffer.resize(received + bufferLength);
+            auto buffer = boost::asio::buffer(_recvProtocolBuffer.data() + received, bufferLength);
+
             auto session = shared_from_this();
             if (_enableSSL)
             {
-                _sslSocket->async_read_some(boost::asio::buffer(_recvBuffer, bufferLength),
+                _sslSocket->async_read_some(buffer,
                     [session](const boost::system::error_code& error, size_t bytesTransferred) {
                         auto s = session;
                         if (s)
@@ -185,8 +255,7 @@ void ChannelSession::startRead()
             }
             else
             {
-                _sslSocket->next_layer().async_read_some(
-                    boost::asio::buffer(_recvBuffer, bufferLength),
+                _sslSocket->next_layer().async_read_some(buffer,
                     [session](const boost::system::error_code& error, size_t bytesTransferred) {
                         auto s = session;
                         if (s)
@@ -222,27 +291,29 @@ void ChannelSession::onRead(const boost::system::error_code& error, size_t bytes
 
         updateIdleTimer();
 
+        _recvProtocolBuffer.resize(_recvProtocolBuffer.size() - bufferLength + bytesTransferred);
         if (!error)
         {
-            _recvProtocolBuffer.insert(
-                _recvProtocolBuffer.end(), _recvBuffer, _recvBuffer + bytesTransferred);
-
             while (true)
             {
                 auto message = _messageFactory->buildMessage();
 
-                ssize_t result =
-                    message->decode(_recvProtocolBuffer.data(), _recvProtocolBuffer.size());
+                ssize_t result = message->decode(_recvProtocolBuffer.data() + _recvOffset,
+                    _recvProtocolBuffer.size() - _recvOffset);
 
                 if (result > 0)
                 {
                     onMessage(ChannelException(0, ""), message);
 
-                    _recvProtocolBuffer.erase(
-                        _recvProtocolBuffer.begin(), _recvProtocolBuffer.begin() + result);
+                    _recvOffset += result;
                 }
                 else if (result == 0)
                 {
+                    /// the decoded messages are dropped at once rather than one by one
+                    _recvProtocolBuffer.erase(
+                        _recvProtocolBuffer.begin(), _recvProtocolBuffer.begin() + _recvOffset);
+                    _recvOffset = 0;
+
                     startRead();
 
                     break;
@@ -294,36 +365,48 @@ void ChannelSession::startWrite()
     {
         _writing = true;
 
-        auto buffer = _sendBufferList.front();
-        _sendBufferList.pop();
+        /// the messages queued while writing, e.g. the receipts of a block, go out in one
+        /// gathered write without being copied together
+        auto buffers = std::make_shared<Buffers>();
+        size_t size = 0;
+        while (!_sendBufferList.empty() && size < c_maxWriteBytes)
+        {
+            buffers->push_back(_sendBufferList.front());
+            size += _sendBufferList.front()->size();
+            _sendBufferList.pop();
+        }
 
         auto session = std::weak_ptr<ChannelSession>(shared_from_this());
 
-        _sslSocket->get_io_service().post([session, buffer] {
+        _sslSocket->get_io_service().post([session, buffers] {
             auto s = session.lock();
             if (s)
             {
+                std::vector<boost::asio::const_buffer> gathered;
+                gathered.reserve(buffers->size());
+                for (auto const& buffer : *buffers)
+                {
+                    gathered.push_back(boost::asio::buffer(buffer->data(), buffer->size()));
+                }
                 if (s->enableSSL())
                 {
-                    boost::asio::async_write(*s->sslSocket(),
-                        boost::asio::buffer(buffer->data(), buffer->size()),
+                    boost::asio::async_write(*s->sslSocket(), gathered,
                         [=](const boost::system::error_code& error, size_t bytesTransferred) {
                             auto s = session.lock();
                             if (s)
                             {
-                                s->onWrite(error, buffer, bytesTransferred);
+                                s->onWrite(error, buffers, bytesTransferred);
                             }
                         });
                 }
                 else
                 {
-                    boost::asio::async_write(s->sslSocket()->next_layer(),
-                        boost::asio::buffer(buffer->data(), buffer->size()),
+                    boost::asio::async_write(s->sslSocket()->next_layer(), gathered,
                         [=](const boost::system::error_code& error, size_t bytesTransferred) {
                             auto s = session.lock();
                             if (s)
                             {
-                                s->onWrite(error, buffer, bytesTransferred);
+                                s->onWrite(error, buffers, bytesTransferred);
                             }
                         });
                 }
@@ -353,7 +436,35 @@ void ChannelSession::writeBuffer(std::shared_ptr<bytes> buffer)
     }
 }
 
-void ChannelSession::onWrite(const boost::system::error_code& error, std::shared_ptr<bytes>, size_t)
+std::shared_ptr<dev::bytes> ChannelSession::acquireBuffer()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (_bufferPool.empty())
+    {
+        return std::make_shared<bytes>();
+    }
+    auto buffer = _bufferPool.back();
+    _bufferPool.pop_back();
+    return buffer;
+}
+
+void ChannelSession::releaseBuffers(Buffers const& buffers)
+{
+    for (auto const& buffer : buffers)
+    {
+        /// a buffer still held elsewhere is left alone
+        if (_bufferPool.size() >= c_maxPooledBuffers || !buffer.unique() ||
+            buffer->capacity() > c_maxPooledBufferBytes)
+        {
+            continue;
+        }
+        buffer->clear();
+        _bufferPool.push_back(buffer);
+    }
+}
+
+void ChannelSession::onWrite(
+    const boost::system::error_code& error, std::shared_ptr<Buffers> buffers, size_t)
 {
     try
     {
@@ -367,6 +478,7 @@ void ChannelSession::onWrite(const boost::system::error_code& error, std::shared
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
         updateIdleTimer();
+        releaseBuffers(*buffers);
 
         if (error)
         {
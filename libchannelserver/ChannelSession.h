@@ -28,6 +28,7 @@
 #include <queue>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
@@ -54,13 +55,19 @@ public:
     typedef std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)>
         CallbackType;
 
-    const size_t bufferLength = 1024;
+    /// the bytes read at most by a read, decoded in place
+    const size_t bufferLength = 16 * 1024;
 
     virtual Message::Ptr sendMessage(Message::Ptr request, size_t timeout = 0);
     virtual void asyncSendMessage(Message::Ptr request,
         std::function<void(dev::channel::ChannelException, Message::Ptr)> callback,
         uint32_t timeout = 0);
 
+    /// Push a message needing no response, built by _build on the response thread pool. The
+    /// messages pushed while one is being built, e.g. the receipts of a block, are built by the
+    /// same task and go out in a single write.
+    virtual void asyncPushMessage(std::function<Message::Ptr()> const& _build);
+
     virtual void run();
 
     virtual bool actived() { return _actived; };
@@ -121,11 +128,19 @@ private:
     void startRead();
     void onRead(const boost::system::error_code& error, size_t bytesTransferred);
 
+    typedef std::vector<std::shared_ptr<bytes> > Buffers;
+
     void startWrite();
-    void onWrite(const boost::system::error_code& error, std::shared_ptr<bytes> buffer,
+    void onWrite(const boost::system::error_code& error, std::shared_ptr<Buffers> buffers,
         size_t bytesTransferred);
     void writeBuffer(std::shared_ptr<bytes> buffer);
 
+    /// a buffer of the pool, or a new one if the pool is empty
+    std::shared_ptr<bytes> acquireBuffer();
+    void releaseBuffers(Buffers const& buffers);
+
+    void flushPushes();
+
     void onMessage(dev::channel::ChannelException e, Message::Ptr message);
     void onTimeout(const boost::system::error_code& error, std::string seq);
 
@@ -144,16 +159,24 @@ private:
         std::shared_ptr<boost::asio::deadline_timer> timeoutHandler;
     };
 
+    /// the 32 bytes of the seq on the wire, so that looking a callback up allocates nothing
+    static h256 seqKey(std::string const& seq)
+    {
+        h256 key;
+        memcpy(key.data(), seq.data(), std::min<size_t>(seq.size(), h256::size));
+        return key;
+    }
+
     void insertResponseCallback(std::string const& seq, ResponseCallback::Ptr callback_ptr)
     {
         WriteGuard l(x_responseCallbacks);
-        m_responseCallbacks.insert(std::make_pair(seq, callback_ptr));
+        m_responseCallbacks.insert(std::make_pair(seqKey(seq), callback_ptr));
     }
 
     ResponseCallback::Ptr findResponseCallbackBySeq(std::string const& seq)
     {
         ReadGuard l(x_responseCallbacks);
-        auto it = m_responseCallbacks.find(seq);
+        auto it = m_responseCallbacks.find(seqKey(seq));
         if (it != m_responseCallbacks.end())
         {
             return it->second;
@@ -164,7 +187,7 @@ private:
     void eraseResponseCallbackBySeq(std::string const& seq)
     {
         WriteGuard l(x_responseCallbacks);
-        m_responseCallbacks.erase(seq);
+        m_responseCallbacks.erase(seqKey(seq));
     }
 
     void clearResponseCallbacks()
@@ -174,7 +197,7 @@ private:
     }
 
     mutable SharedMutex x_responseCallbacks;
-    std::map<std::string, ResponseCallback::Ptr> m_responseCallbacks;
+    std::unordered_map<h256, ResponseCallback::Ptr> m_responseCallbacks;
 
 
     MessageFactory::Ptr _messageFactory;
@@ -187,12 +210,25 @@ private:
     std::string _host;
     int _port = 0;
 
-    byte _recvBuffer[1024];
+    /// the bytes received, the messages before _recvOffset are decoded already
     bytes _recvProtocolBuffer;
+    size_t _recvOffset = 0;
 
     std::queue<std::shared_ptr<bytes> > _sendBufferList;
+    /// the queued messages are gathered into a write up to this size
+    static const size_t c_maxWriteBytes = 1024 * 1024;
     bool _writing = false;
 
+    std::mutex x_pushes;
+    std::vector<std::function<Message::Ptr()> > m_pushes;
+    bool m_pushScheduled = false;
+
+    /// the encode buffers written already, reused by the next messages
+    Buffers _bufferPool;
+    static const size_t c_maxPooledBuffers = 256;
+    /// larger buffers are freed rather than pooled
+    static const size_t c_maxPooledBufferBytes = 64 * 1024;
+
     std::shared_ptr<boost::asio::deadline_timer> _idleTimer;
     std::recursive_mutex _mutex;
 
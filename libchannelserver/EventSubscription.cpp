@@ -0,0 +1,100 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file EventSubscription.cpp
+ *  @brief the blocks and the logs pushed to the sdks subscribing them
+ */
+
+#include "EventSubscription.h"
+#include <libdevcore/CommonJS.h>
+#include <libethcore/CommonJS.h>
+#include <librpc/JsonHelper.h>
+
+using namespace dev;
+using namespace dev::channel;
+using namespace dev::eth;
+
+EventFilter EventFilter::fromJson(Json::Value const& _filter)
+{
+    if (!_filter.isObject() || !_filter["groupID"].isIntegral())
+    {
+        BOOST_THROW_EXCEPTION(MissingField() << errinfo_comment("groupID"));
+    }
+    EventFilter filter;
+    filter.groupID = _filter["groupID"].asInt();
+    std::string type = _filter.get("type", "block").asString();
+    if (type != "block" && type != "log")
+    {
+        BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("type " + type));
+    }
+    filter.logs = (type == "log");
+    if (!filter.logs)
+    {
+        return filter;
+    }
+
+    static_cast<LogFilter&>(filter) = rpc::toLogFilter(_filter);
+    return filter;
+}
+
+Json::Value dev::channel::blockEvent(int _groupID, Block const& _block)
+{
+    auto const& header = _block.blockHeader();
+    Json::Value event;
+    event["type"] = "block";
+    event["groupID"] = _groupID;
+    event["number"] = toJS(header.number());
+    event["hash"] = toJS(_block.headerHash());
+    event["parentHash"] = toJS(header.parentHash());
+    event["timestamp"] = toJS(header.timestamp());
+    event["gasUsed"] = toJS(header.gasUsed());
+    event["sealer"] = toJS(header.sealer());
+    event["transactionCount"] = toJS(_block.transactions().size());
+    return event;
+}
+
+void dev::channel::appendLogEvents(Json::Value& _events, EventFilter const& _filter,
+    Block const& _block, TransactionReceipts const& _receipts, LogBloom const& _bloom)
+{
+    auto blooms = _filter.blooms();
+    if (!blooms.mayMatch(_bloom))
+    {
+        return;
+    }
+    auto const& transactions = _block.transactions();
+    for (size_t i = 0; i < _receipts.size() && i < transactions.size(); ++i)
+    {
+        auto const& receipt = _receipts[i];
+        /// most receipts are skipped by their blooms without looking at their logs
+        if (!blooms.mayMatch(receipt.bloom()))
+        {
+            continue;
+        }
+        for (size_t j = 0; j < receipt.log().size(); ++j)
+        {
+            auto const& log = receipt.log()[j];
+            if (!_filter.matches(log))
+            {
+                continue;
+            }
+            Json::Value event = rpc::toJson(LocalisedLogEntry(log, _block.headerHash(),
+                _block.blockHeader().number(), transactions[i].sha3(), i, j));
+            event["type"] = "log";
+            event["groupID"] = _filter.groupID;
+            _events.append(event);
+        }
+    }
+}
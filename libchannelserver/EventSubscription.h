@@ -0,0 +1,161 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file EventSubscription.h
+ *  @brief the blocks and the logs pushed to the sdks subscribing them
+ */
+
+#pragma once
+
+#include <json/json.h>
+#include <libdevcore/Guards.h>
+#include <libethcore/Block.h>
+#include <libethcore/LogFilter.h>
+#include <libethcore/TransactionReceipt.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace channel
+{
+/// the subscriptions an sdk may hold
+static const size_t c_maxSubscriptions = 64;
+
+/// The events a subscription asks for, the headers of the new blocks of a group or the logs of
+/// their receipts.
+struct EventFilter : public eth::LogFilter
+{
+    int groupID = 0;
+    bool logs = false;
+
+    /// {"groupID": 1, "type": "block" or "log", "addresses": [...], "topics": [[...], ...]}, a
+    /// single topic may stand for a set of one, throws on a malformed filter
+    static EventFilter fromJson(Json::Value const& _filter);
+};
+
+/// the header of a new block
+Json::Value blockEvent(int _groupID, eth::Block const& _block);
+/// append the logs of _receipts matching _filter to _events, none if _bloom, the bloom of all
+/// the receipts, doesn't match
+void appendLogEvents(Json::Value& _events, EventFilter const& _filter, eth::Block const& _block,
+    eth::TransactionReceipts const& _receipts, eth::LogBloom const& _bloom);
+
+/// The subscriptions of the sdks, the events of a committed block are matched against them and
+/// gathered by subscriber, so that each sdk gets one message per block.
+template <typename Key>
+class EventSubscription
+{
+public:
+    /// the id of the subscription, 0 if _key holds too many
+    uint64_t subscribe(Key const& _key, EventFilter const& _filter)
+    {
+        WriteGuard l(x_subscriptions);
+        auto& subscriptions = m_subscriptions[_key];
+        if (subscriptions.size() >= c_maxSubscriptions)
+        {
+            return 0;
+        }
+        subscriptions[++m_lastID] = _filter;
+        return m_lastID;
+    }
+    bool unsubscribe(Key const& _key, uint64_t _id)
+    {
+        WriteGuard l(x_subscriptions);
+        auto it = m_subscriptions.find(_key);
+        if (it == m_subscriptions.end() || !it->second.erase(_id))
+        {
+            return false;
+        }
+        if (it->second.empty())
+        {
+            m_subscriptions.erase(it);
+        }
+        return true;
+    }
+    void remove(Key const& _key)
+    {
+        WriteGuard l(x_subscriptions);
+        m_subscriptions.erase(_key);
+    }
+
+    /// whether any subscription of _groupID asks for blocks or, with _logs, for logs
+    bool subscribed(int _groupID, bool _logs) const
+    {
+        ReadGuard l(x_subscriptions);
+        for (auto const& subscriptions : m_subscriptions)
+        {
+            for (auto const& it : subscriptions.second)
+            {
+                if (it.second.groupID == _groupID && it.second.logs == _logs)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// the events of the block by subscriber, a JSON array each, _receipts in the order of the
+    /// transactions or empty if no log is subscribed
+    std::map<Key, Json::Value> events(
+        int _groupID, eth::Block const& _block, eth::TransactionReceipts const& _receipts) const
+    {
+        std::map<Key, Json::Value> events;
+        Json::Value block;
+        auto bloom = eth::bloom(_receipts);
+        ReadGuard l(x_subscriptions);
+        for (auto const& subscriptions : m_subscriptions)
+        {
+            for (auto const& it : subscriptions.second)
+            {
+                auto const& filter = it.second;
+                if (filter.groupID != _groupID)
+                {
+                    continue;
+                }
+                Json::Value matched(Json::arrayValue);
+                if (!filter.logs)
+                {
+                    if (block.isNull())
+                    {
+                        block = blockEvent(_groupID, _block);
+                    }
+                    matched.append(block);
+                }
+                else
+                {
+                    appendLogEvents(matched, filter, _block, _receipts, bloom);
+                }
+                for (auto& event : matched)
+                {
+                    event["filterID"] = Json::UInt64(it.first);
+                    events[subscriptions.first].append(event);
+                }
+            }
+        }
+        return events;
+    }
+
+private:
+    mutable SharedMutex x_subscriptions;
+    std::map<Key, std::map<uint64_t, EventFilter>> m_subscriptions;
+    uint64_t m_lastID = 0;
+};
+
+}  // namespace channel
+}  // namespace dev
@@ -30,7 +30,14 @@ enum VERSION : uint32_t
 {
     RC1_VERSION = 1,
     RC2_VERSION = 2,
-    RC3_VERSION = 3
+    RC3_VERSION = 3,
+    // tables are hashed incrementally since 2.1.0
+    V2_1_0 = 0x02010000,
+    // blocks index their receipts by offset since 2.2.0
+    V2_2_0 = 0x02020000,
+    // the blocks, nonces, blooms and log indices are stored as raw bytes rather than hex since
+    // 2.3.0
+    V2_3_0 = 0x02030000
 };
 class GlobalConfigure
 {
@@ -62,6 +69,8 @@ public:
         std::string keyCenterIP;
         int keyCenterPort;
         std::string cipherDataKey;
+        /// ms the data keys are cached for, 0 for the lifetime of the node
+        uint64_t keyCacheTTL = 0;
     } diskEncryption;
 
     /// default block time
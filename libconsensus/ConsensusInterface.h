@@ -57,6 +57,8 @@ public:
     /// update the context of PBFT after commit a block into the block-chain
     virtual void reportBlock(dev::eth::Block const& block) = 0;
     virtual uint64_t maxBlockTransactions() { return 1000; }
+    /// copy the messages the consensus backs up to recover from a restart into the directory
+    virtual void exportBackup(std::string const&) {}
 };
 }  // namespace consensus
 }  // namespace dev
@@ -27,6 +27,7 @@
  * @ modification: rename Consensus.cpp to Sealer.cpp
  */
 #include "Sealer.h"
+#include <libdevcore/Tracing.h>
 #include <libethcore/LogEntry.h>
 #include <libsync/SyncStatus.h>
 using namespace std;
@@ -123,19 +124,21 @@ void Sealer::doWork(bool wait)
             /// check enough or reach block interval
             if (!checkTxsEnough(maxTxsPerBlock))
             {
-                ///< 10 milliseconds to next loop
-                unique_lock<mutex> l(x_signalled);
-                m_signalled.wait_for(l, chrono::milliseconds(1));
+                /// new transactions wake the wait, 1 millisecond is the block interval timer
+                waitForWork(1);
                 return;
             }
             if (shouldHandleBlock())
                 handleBlock();
         }
     }
+    else
+    {
+        preloadTransactions();
+    }
     if (shouldWait(wait))
     {
-        unique_lock<mutex> l(x_blocksignalled);
-        m_blockSignalled.wait_for(l, chrono::milliseconds(10));
+        waitForWork(10);
     }
 }
 
@@ -145,6 +148,8 @@ void Sealer::doWork(bool wait)
  */
 void Sealer::loadTransactions(uint64_t const& transToFetch)
 {
+    BlockSpan span("txpool.fetch", m_consensusEngine ? m_consensusEngine->groupId() : 0,
+        m_sealing.block.blockHeader().number());
     /// fetch transactions and update m_transactionSet
     m_sealing.block.appendTransactions(
         m_txPool->topTransactions(transToFetch, m_sealing.m_transactionSet, true));
@@ -172,6 +177,7 @@ void Sealer::resetSealingBlock(Sealing& sealing, h256Hash const& filter, bool re
 {
     resetBlock(sealing.block, resetNextLeader);
     sealing.m_transactionSet = filter;
+    m_txPool->resetSealingCursor();
     sealing.p_execContext = nullptr;
 }
 
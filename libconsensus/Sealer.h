@@ -80,14 +80,12 @@ public:
     virtual void onTransactionQueueReady()
     {
         m_syncTxPool = true;
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
     virtual void onBlockChanged()
     {
         m_syncBlock = true;
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
 
     void setExtraData(std::vector<bytes> const& _extra) { m_extraData = _extra; }
@@ -136,6 +134,8 @@ protected:
     virtual void handleBlock() {}
     virtual bool shouldHandleBlock() { return true; }
     virtual void doWork(bool wait);
+    /// called while the sealed block is in consensus, to prepare the transactions to seal next
+    virtual void preloadTransactions() {}
     void doWork() override { doWork(true); }
     bool isBlockSyncing();
 
@@ -184,12 +184,6 @@ protected:
     std::vector<bytes> m_extraData;
 
     /// atomic value represents that whether is calling syncTransactionQueue now
-    /// signal to notify all thread to work
-    std::condition_variable m_signalled;
-    std::condition_variable m_blockSignalled;
-    /// mutex to access m_signalled
-    Mutex x_signalled;
-    Mutex x_blocksignalled;
     std::atomic<bool> m_syncTxPool = {false};
     /// a new block has been submitted to the blockchain
     std::atomic<bool> m_syncBlock = {false};
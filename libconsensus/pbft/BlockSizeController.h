@@ -0,0 +1,127 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : block size and sealing interval tuned to a target block latency
+ * @file: BlockSizeController.h
+ */
+#pragma once
+#include <json/json.h>
+#include <libdevcore/Guards.h>
+#include <algorithm>
+#include <atomic>
+
+namespace dev
+{
+namespace consensus
+{
+/// Tracks the moving averages of the execution time per transaction, the time collecting the
+/// signatures and the time from the commit to the saved block. The block latency is modelled as
+/// txs * execPerTx + signTime + commitTime, the block size is the most transactions within the
+/// target latency.
+class BlockSizeController
+{
+public:
+    /// latency from the prepare to the saved block to reach in ms, 0 to disable the controller
+    void setTargetLatency(uint64_t _targetLatency) { m_targetLatency = _targetLatency; }
+    bool enabled() const { return m_targetLatency > 0; }
+
+    void onExecuted(uint64_t _txs, uint64_t _execTime)
+    {
+        if (_txs == 0)
+        {
+            return;
+        }
+        Guard l(x_averages);
+        update(m_execPerTx, (double)_execTime / _txs);
+    }
+    void onSigned(uint64_t _signTime)
+    {
+        Guard l(x_averages);
+        update(m_signTime, _signTime);
+    }
+    void onCommitted(uint64_t _commitTime)
+    {
+        Guard l(x_averages);
+        update(m_commitTime, _commitTime);
+    }
+
+    /// the most transactions of a block within the target latency, at least one
+    uint64_t maxBlockTxs(uint64_t _limit) const
+    {
+        if (!enabled())
+        {
+            return _limit;
+        }
+        Guard l(x_averages);
+        if (m_execPerTx <= 0)
+        {
+            return _limit;
+        }
+        double budget = m_targetLatency - m_signTime - m_commitTime;
+        if (budget <= m_execPerTx)
+        {
+            return 1;
+        }
+        return std::min(_limit, (uint64_t)(budget / m_execPerTx));
+    }
+
+    /// the sealer waits no longer for transactions than the latency left by the consensus, the
+    /// configured interval when the controller is disabled
+    uint64_t sealingInterval(uint64_t _configured) const
+    {
+        if (!enabled())
+        {
+            return _configured;
+        }
+        Guard l(x_averages);
+        double left = m_targetLatency - m_signTime - m_commitTime;
+        if (left <= 0)
+        {
+            return 0;
+        }
+        return std::min(_configured, (uint64_t)left);
+    }
+
+    void status(Json::Value& _status, uint64_t _limit, uint64_t _configuredInterval) const
+    {
+        _status["targetLatency"] = Json::UInt64(m_targetLatency);
+        _status["maxBlockTxs"] = Json::UInt64(maxBlockTxs(_limit));
+        _status["sealingInterval"] = Json::UInt64(sealingInterval(_configuredInterval));
+        Guard l(x_averages);
+        _status["execPerTx"] = m_execPerTx;
+        _status["signTime"] = m_signTime;
+        _status["commitTime"] = m_commitTime;
+    }
+
+private:
+    void update(double& _average, double _sample)
+    {
+        _average = _average <= 0 ? _sample : (1 - c_weight) * _average + c_weight * _sample;
+    }
+
+    /// weight of the latest sample in the moving averages
+    static constexpr double c_weight = 0.2;
+
+    std::atomic<uint64_t> m_targetLatency = {0};
+    mutable Mutex x_averages;
+    double m_execPerTx = 0;
+    double m_signTime = 0;
+    double m_commitTime = 0;
+};
+}  // namespace consensus
+}  // namespace dev
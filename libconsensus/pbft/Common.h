@@ -42,6 +42,11 @@ enum PBFTPacketType : byte
     SignReqPacket = 0x01,
     CommitReqPacket = 0x02,
     ViewChangeReqPacket = 0x03,
+    /// prepare whose block carries the header and the transaction hashes only
+    CompactPrepareReqPacket = 0x04,
+    /// the transactions of a compact prepare missed in the txpool of a follower
+    PrepareTxsRequestPacket = 0x05,
+    PrepareTxsResponsePacket = 0x06,
     PBFTPacketCount
 };
 
@@ -80,11 +85,9 @@ struct PBFTMsgPacket
      */
     virtual void encode(bytes& encodedBytes) const
     {
-        RLPStream tmp;
-        streamRLPFields(tmp);
-        RLPStream list_rlp;
-        list_rlp.appendList(1).append(tmp.out());
-        list_rlp.swapOut(encodedBytes);
+        bytes fields;
+        rlpEncode(fields, [this](RLPStream& _s) { streamRLPFields(_s); });
+        rlpEncode(encodedBytes, [&](RLPStream& _s) { _s.appendList(1).append(fields); });
     }
     /**
      * @brief : decode the network-receive part of PBFTMsgPacket into PBFTMsgPacket object
@@ -174,11 +177,9 @@ struct PBFTMsg
      */
     virtual void encode(bytes& encodedBytes) const
     {
-        RLPStream tmp;
-        streamRLPFields(tmp);
-        RLPStream list_rlp;
-        list_rlp.appendList(1).append(tmp.out());
-        list_rlp.swapOut(encodedBytes);
+        bytes fields;
+        rlpEncode(fields, [this](RLPStream& _s) { streamRLPFields(_s); });
+        rlpEncode(encodedBytes, [&](RLPStream& _s) { _s.appendList(1).append(fields); });
     }
 
     /**
@@ -320,10 +321,11 @@ struct PrepareReq : public PBFTMsg
     /**
      * @brief : update the PrepareReq with specified block and block-execution-result
      *
-     * @param sealing : object contains both block and block-execution-result
+     * @param sealing : object contains both block and block-execution-result, the block is
+     * moved into the PrepareReq instead of copied
      * @param keyPair : keypair used to sign for the PrepareReq
      */
-    PrepareReq(PrepareReq const& req, Sealing const& sealing, KeyPair const& keyPair)
+    PrepareReq(PrepareReq const& req, Sealing& sealing, KeyPair const& keyPair)
     {
         height = req.height;
         view = req.view;
@@ -343,6 +345,28 @@ struct PrepareReq : public PBFTMsg
     {
         return PBFTMsg::operator==(req) && req.block == block;
     }
+
+    /// the header and the transaction hashes of _block, the block of a CompactPrepareReqPacket
+    static bytes encodeCompactBlock(dev::eth::Block const& _block)
+    {
+        bytes header;
+        _block.blockHeader().encode(header);
+        h256s hashes;
+        for (auto const& tx : _block.transactions())
+            hashes.push_back(tx.sha3());
+        RLPStream s(2);
+        s.appendRaw(header);
+        s.appendVector(hashes);
+        return s.out();
+    }
+    static void decodeCompactBlock(
+        bytesConstRef _data, dev::eth::BlockHeader& _header, h256s& _hashes)
+    {
+        RLP rlp(_data);
+        auto header = rlp[0].data();
+        _header.decode(header);
+        _hashes = rlp[1].toVector<h256>();
+    }
     bool operator!=(PrepareReq const& req) const { return !(operator==(req)); }
 
     /// trans PrepareReq from object to RLPStream
@@ -24,10 +24,13 @@
 #include "PBFTEngine.h"
 #include <libconfig/GlobalConfigure.h>
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/CommonJS.h>
 #include <libsecurity/EncryptedLevelDB.h>
 #include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/SpeculativeStorage.h>
 #include <libstorage/Storage.h>
 #include <libtxpool/TxPool.h>
 using namespace dev::eth;
@@ -47,10 +50,29 @@ const std::string PBFTEngine::c_backupMsgDirName = "pbftMsgBackup";
 void PBFTEngine::start()
 {
     initPBFTEnv(3 * getEmptyBlockGenTime());
+    /// the blocks are executed aside, the PBFT worker keeps handling the other messages
+    m_execPool = std::make_shared<dev::ThreadPool>(
+        "pbftExec-" + std::to_string(m_groupId), 1, dev::TaskPriority::High);
+    /// the committed prepares are backed up in order aside
+    m_backupPool =
+        std::make_shared<dev::ThreadPool>("pbftBackup-" + std::to_string(m_groupId), 1);
     ConsensusEngineBase::start();
     PBFTENGINE_LOG(INFO) << "[Start PBFTEngine...]";
 }
 
+void PBFTEngine::stop()
+{
+    ConsensusEngineBase::stop();
+    if (m_execPool)
+    {
+        m_execPool->stop();
+    }
+    if (m_backupPool)
+    {
+        m_backupPool->stop();
+    }
+}
+
 void PBFTEngine::initPBFTEnv(unsigned view_timeout)
 {
     Guard l(m_mutex);
@@ -75,6 +97,11 @@ bool PBFTEngine::shouldSeal()
     {
         return false;
     }
+    /// the block of this height has been proposed ahead
+    if (m_pipelinedNumber == m_consensusBlockNumber && m_view == 0)
+    {
+        return false;
+    }
     if (ret.second != nodeIdx())
     {
         /// if current node is the next leader
@@ -96,6 +123,23 @@ bool PBFTEngine::shouldSeal()
     return true;
 }
 
+/**
+ * @brief: the next leader of a view seals the next block ahead once the block of this height is
+ *         committed by 2/3 sealers. The other sealers cache the prepare as a future one and
+ *         execute it after the committed block is saved, so the execution stays ordered. The
+ *         depth of the pipeline is one block
+ */
+bool PBFTEngine::canPipelineSeal() const
+{
+    if (!m_enablePipeline || m_view != 0 || m_consensusBlockNumber == 0 ||
+        getNextLeader() != nodeIdx())
+    {
+        return false;
+    }
+    Guard l(x_pipelineParent);
+    return m_pipelineParent.number() == m_consensusBlockNumber;
+}
+
 /**
  * @brief: rehandle the unsubmitted committedPrepare
  * @param req: the unsubmitted committed prepareReq
@@ -156,33 +200,63 @@ void PBFTEngine::initBackupDB()
     /// try-catch has already been considered by libdevcore/LevelDB.*
     std::string path = getBackupMsgPath();
     boost::filesystem::path path_handler = boost::filesystem::path(path);
-    if (!boost::filesystem::exists(path_handler))
+    m_backupDB = openBackupDB(path_handler);
+
+    if (!isDiskSpaceEnough(path))
+    {
+        PBFTENGINE_LOG(ERROR) << LOG_DESC(
+            "initBackupDB: Disk space is insufficient, less than 100MB. Release disk space and try "
+            "again");
+        BOOST_THROW_EXCEPTION(NotEnoughAvailableSpace());
+    }
+    // reload msg from db to commited-prepare-cache
+    reloadMsg(c_backupKeyCommitted, m_reqCache->mutableCommittedPrepareCache());
+}
+
+std::shared_ptr<dev::db::LevelDB> PBFTEngine::openBackupDB(boost::filesystem::path const& _path)
+{
+    if (!boost::filesystem::exists(_path))
     {
-        boost::filesystem::create_directories(path_handler);
+        boost::filesystem::create_directories(_path);
     }
 
     db::BasicLevelDB* basicDB = NULL;
     leveldb::Status status;
 
     if (g_BCOSConfig.diskEncryption.enable)
-        status = EncryptedLevelDB::Open(LevelDB::defaultDBOptions(), path_handler.string(),
-            &basicDB, g_BCOSConfig.diskEncryption.cipherDataKey);
+        status = EncryptedLevelDB::Open(LevelDB::defaultDBOptions(), _path.string(), &basicDB,
+            g_BCOSConfig.diskEncryption.cipherDataKey);
     else
-        status = BasicLevelDB::Open(LevelDB::defaultDBOptions(), path_handler.string(), &basicDB);
+        status = BasicLevelDB::Open(LevelDB::defaultDBOptions(), _path.string(), &basicDB);
 
-    LevelDB::checkStatus(status, path_handler);
+    LevelDB::checkStatus(status, _path);
 
-    m_backupDB = std::make_shared<LevelDB>(basicDB);
+    /// the committed prepare must survive a crash of the machine
+    leveldb::WriteOptions writeOptions = LevelDB::defaultWriteOptions();
+    writeOptions.sync = true;
+    return std::make_shared<LevelDB>(basicDB, LevelDB::defaultReadOptions(), writeOptions);
+}
 
-    if (!isDiskSpaceEnough(path))
+/**
+ * @brief: copy the backed up messages into a new backup db under the given directory
+ * @param _path: the directory the backup db is created in, as the base dir of a node
+ */
+void PBFTEngine::exportBackup(std::string const& _path)
+{
+    if (!m_backupDB)
     {
-        PBFTENGINE_LOG(ERROR) << LOG_DESC(
-            "initBackupDB: Disk space is insufficient, less than 100MB. Release disk space and try "
-            "again");
-        BOOST_THROW_EXCEPTION(NotEnoughAvailableSpace());
+        return;
     }
-    // reload msg from db to commited-prepare-cache
-    reloadMsg(c_backupKeyCommitted, m_reqCache->mutableCommittedPrepareCache());
+    auto path = boost::filesystem::path(_path) / c_backupMsgDirName;
+    auto backupDB = openBackupDB(path);
+    /// the value is copied as stored, hex of the encoded message
+    auto committed = m_backupDB->lookup(c_backupKeyCommitted);
+    if (!committed.empty())
+    {
+        backupDB->insert(c_backupKeyCommitted, committed);
+    }
+    PBFTENGINE_LOG(INFO) << LOG_DESC("exportBackup") << LOG_KV("path", path.string())
+                         << LOG_KV("committed", !committed.empty());
 }
 
 /**
@@ -262,11 +336,28 @@ bool PBFTEngine::generatePrepare(Block const& block)
     Guard l(m_mutex);
     m_notifyNextLeaderSeal = false;
     PrepareReq prepare_req(block, m_keyPair, m_view, nodeIdx());
+    if (prepare_req.height > m_consensusBlockNumber)
+    {
+        m_pipelinedNumber = prepare_req.height;
+    }
     bytes prepare_data;
-    prepare_req.encode(prepare_data);
-
-    /// broadcast the generated preparePacket
-    bool succ = broadcastMsg(PrepareReqPacket, prepare_req.uniqueKey(), ref(prepare_data));
+    bool succ = false;
+    /// broadcast the generated preparePacket, the local prepare keeps the full block to serve the
+    /// followers missing transactions
+    if (m_compactPrepare && !m_fullPrepareFallback && block.getTransactionSize() > 0)
+    {
+        PrepareReq compact_req(prepare_req);
+        compact_req.block = PrepareReq::encodeCompactBlock(*prepare_req.pBlock);
+        compact_req.pBlock = nullptr;
+        compact_req.encode(prepare_data);
+        succ = broadcastMsg(CompactPrepareReqPacket, prepare_req.uniqueKey(), ref(prepare_data));
+    }
+    else
+    {
+        prepare_req.encode(prepare_data);
+        succ = broadcastMsg(PrepareReqPacket, prepare_req.uniqueKey(), ref(prepare_data));
+    }
+    m_fullPrepareFallback = false;
     if (succ)
     {
         if (prepare_req.pBlock->getTransactionSize() == 0 && m_omitEmptyBlock)
@@ -277,13 +368,18 @@ bool PBFTEngine::generatePrepare(Block const& block)
             return true;
         }
         handlePrepareMsg(prepare_req);
+        /// the block proposed ahead is executed while its parent is committed
+        if (m_speculativeExecution && prepare_req.height == m_consensusBlockNumber + 1)
+        {
+            speculateNextBlock(prepare_req);
+        }
     }
     /// reset the block according to broadcast result
     PBFTENGINE_LOG(INFO) << LOG_DESC("generateLocalPrepare")
                          << LOG_KV("hash", prepare_req.block_hash.abridged())
                          << LOG_KV("H", prepare_req.height) << LOG_KV("nodeIdx", nodeIdx())
                          << LOG_KV("myNode", m_keyPair.pub().abridged());
-    m_signalled.notify_all();
+    notifyWork();
     return succ;
 }
 
@@ -319,6 +415,11 @@ bool PBFTEngine::checkSign(PBFTMsg const& req) const
     h512 node_id;
     if (getNodeIDByIndex(node_id, req.idx))
     {
+        /// verified in batch by the workLoop
+        if (takeVerifiedSign(signatureKey(node_id, req)))
+        {
+            return true;
+        }
         Public pub_id = jsToPublic(toJS(node_id.hex()));
         return dev::verify(pub_id, req.sig, req.block_hash) &&
                dev::verify(pub_id, req.sig2, req.fieldsWithoutBlock());
@@ -326,6 +427,81 @@ bool PBFTEngine::checkSign(PBFTMsg const& req) const
     return false;
 }
 
+/// key of a verified signature, bound to the signer and the signed hashes
+h256 PBFTEngine::signatureKey(h512 const& nodeId, PBFTMsg const& req) const
+{
+    RLPStream ts;
+    ts.appendList(5) << nodeId << req.block_hash << req.fieldsWithoutBlock() << req.sig
+                     << req.sig2;
+    return dev::sha3(ts.out());
+}
+
+bool PBFTEngine::takeVerifiedSign(h256 const& key) const
+{
+    return m_verifiedSigns.erase(key);
+}
+
+/**
+ * @brief: verify the signatures of the sign and commit requests of the popped messages in
+ *         parallel, checkSign takes the verified ones instead of verifying them one by one
+ * @param packets: the messages popped from the message queue
+ */
+void PBFTEngine::verifySignsInBatch(std::vector<PBFTMsgPacket> const& packets)
+{
+    std::vector<PBFTMsg> reqs;
+    for (auto const& packet : packets)
+    {
+        if (packet.packet_id != SignReqPacket && packet.packet_id != CommitReqPacket)
+        {
+            continue;
+        }
+        PBFTMsg req;
+        if (decodeToRequests(req, ref(packet.data)))
+        {
+            reqs.push_back(std::move(req));
+        }
+    }
+    /// no gain to verify a single signature aside
+    if (reqs.size() < 2)
+    {
+        return;
+    }
+    Timer t;
+    auto sealers = sealerList();
+    std::vector<h256> keys(reqs.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, reqs.size()), [&](tbb::blocked_range<size_t> const& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                if (reqs[i].idx >= sealers.size())
+                {
+                    continue;
+                }
+                h512 const& node_id = sealers[reqs[i].idx];
+                Public pub_id = jsToPublic(toJS(node_id.hex()));
+                if (dev::verify(pub_id, reqs[i].sig, reqs[i].block_hash) &&
+                    dev::verify(pub_id, reqs[i].sig2, reqs[i].fieldsWithoutBlock()))
+                {
+                    keys[i] = signatureKey(node_id, reqs[i]);
+                }
+            }
+        });
+    /// the signatures of the dropped messages are never taken
+    if (m_verifiedSigns.size() > c_maxVerifiedSigns)
+    {
+        m_verifiedSigns.clear();
+    }
+    for (auto const& key : keys)
+    {
+        if (key != h256())
+        {
+            m_verifiedSigns.insert(key);
+        }
+    }
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("verifySignsInBatch") << LOG_KV("signs", reqs.size())
+                          << LOG_KV("timecost", 1000 * t.elapsed());
+}
+
 /**
  * @brief: 1. generate commitReq according to prepare req
  *         2. broadcast the commitReq
@@ -437,6 +613,10 @@ bool PBFTEngine::sendMsg(dev::network::NodeID const& nodeId, unsigned const& pac
 bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key,
     bytesConstRef data, std::unordered_set<h512> const& filter, unsigned const& ttl)
 {
+    if (isRelayPacket(packetType) && filter.empty())
+    {
+        return relayMsg(packetType, key, data, nodeIdx(), ttl);
+    }
     auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
     m_connectedNode = sessions.size();
     NodeIDs nodeIdList;
@@ -469,6 +649,73 @@ bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key
     return true;
 }
 
+/**
+ * @brief: the sealers form a tree rooted at the generator of the message, the i-th sealer
+ *         counted from the root relays the message to the (width*i+1)-th to (width*i+width)-th
+ *         ones. The children not connected are skipped, their children are sent to instead
+ * @param root: index of the sealer generating the message
+ * @param connected: the sealers connected to this node
+ */
+dev::h512s PBFTEngine::relayTargets(
+    IDXTYPE const& root, std::unordered_set<h512> const& connected) const
+{
+    dev::h512s targets;
+    auto sealers = sealerList();
+    size_t sealerNum = sealers.size();
+    if (root >= sealerNum || nodeIdx() >= sealerNum)
+    {
+        return targets;
+    }
+    size_t width = m_broadcastTreeWidth;
+    std::vector<size_t> positions{(nodeIdx() + sealerNum - root) % sealerNum};
+    while (!positions.empty())
+    {
+        auto position = positions.back();
+        positions.pop_back();
+        for (size_t child = width * position + 1;
+             child <= width * position + width && child < sealerNum; ++child)
+        {
+            auto const& nodeId = sealers[(root + child) % sealerNum];
+            if (connected.count(nodeId))
+            {
+                targets.push_back(nodeId);
+            }
+            else
+            {
+                positions.push_back(child);
+            }
+        }
+    }
+    return targets;
+}
+
+bool PBFTEngine::relayMsg(unsigned const& packetType, std::string const& key,
+    bytesConstRef data, IDXTYPE const& root, unsigned const& ttl)
+{
+    auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
+    m_connectedNode = sessions.size();
+    std::unordered_set<h512> connected;
+    for (auto const& session : sessions)
+    {
+        connected.insert(session.nodeID());
+    }
+    NodeIDs nodeIdList;
+    for (auto const& nodeId : relayTargets(root, connected))
+    {
+        /// packet has been broadcasted?
+        if (broadcastFilter(nodeId, packetType, key))
+            continue;
+        PBFTENGINE_LOG(TRACE) << LOG_DESC("relayMsg") << LOG_KV("packetType", packetType)
+                              << LOG_KV("root", root) << LOG_KV("nodeIdx", nodeIdx())
+                              << LOG_KV("toNode", nodeId.abridged());
+        nodeIdList.push_back(nodeId);
+        broadcastMark(nodeId, packetType, key);
+    }
+    m_service->asyncMulticastMessageByNodeIDList(
+        nodeIdList, transDataToMessage(data, packetType, ttl));
+    return true;
+}
+
 /**
  * @brief: check the specified prepareReq is valid or not
  *       1. should not be existed in the prepareCache
@@ -647,6 +894,16 @@ void PBFTEngine::notifySealing(dev::eth::Block const& block)
 
 void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostringstream&)
 {
+    if (checkPrepareBlock(sealing, req))
+    {
+        executeSealing(sealing, req);
+    }
+}
+
+/// decode and check the block of the prepare, return false if it's an omitted empty block
+bool PBFTEngine::checkPrepareBlock(Sealing& sealing, PrepareReq const& req)
+{
+    BlockSpan span("pbft.checkPrepare", m_groupId, req.height, req.block_hash);
     /// no need to decode the local generated prepare packet
     auto start_time = utcTime();
     auto record_time = utcTime();
@@ -669,7 +926,7 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
     if (sealing.block.getTransactionSize() == 0 && m_omitEmptyBlock)
     {
         sealing.p_execContext = nullptr;
-        return;
+        return false;
     }
 
     checkBlockValid(sealing.block);
@@ -688,8 +945,24 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
 
     m_blockSync->noteSealingBlockNumber(sealing.block.header().number());
     auto noteSealing_time_cost = utcTime() - record_time;
-    record_time = utcTime();
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("checkPrepareBlock")
+                          << LOG_KV("blkNum", sealing.block.header().number())
+                          << LOG_KV("reqIdx", req.idx)
+                          << LOG_KV("hash", sealing.block.header().hash().abridged())
+                          << LOG_KV("nodeIdx", nodeIdx())
+                          << LOG_KV("decodeCost", decode_time_cost)
+                          << LOG_KV("checkCost", check_time_cost)
+                          << LOG_KV("notifyCost", notify_time_cost)
+                          << LOG_KV("noteSealingCost", noteSealing_time_cost)
+                          << LOG_KV("totalCost", utcTime() - start_time);
+    return true;
+}
 
+void PBFTEngine::executeSealing(Sealing& sealing, PrepareReq const& req)
+{
+    BlockSpan span("pbft.execBlock", m_groupId, req.height, req.block_hash);
+    auto start_time = utcTime();
+    auto record_time = utcTime();
     /// ignore the signature verification of the transactions have already been verified in
     /// transation pool
     /// the transactions that has not been verified by the txpool should be verified
@@ -699,13 +972,15 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
 
     sealing.p_execContext = executeBlock(sealing.block);
     auto exec_time_cost = utcTime() - record_time;
+    m_blockSizeController.onExecuted(sealing.block.getTransactionSize(), exec_time_cost);
+    g_metrics
+        .histogram("bcos_block_execute_ms", "the ms a block is executed in by the consensus",
+            {{"group", std::to_string(m_groupId)}})
+        .observe(exec_time_cost);
     PBFTENGINE_LOG(INFO)
         << LOG_DESC("execBlock") << LOG_KV("blkNum", sealing.block.header().number())
         << LOG_KV("reqIdx", req.idx) << LOG_KV("hash", sealing.block.header().hash().abridged())
         << LOG_KV("nodeIdx", nodeIdx()) << LOG_KV("myNode", m_keyPair.pub().abridged())
-        << LOG_KV("decodeCost", decode_time_cost) << LOG_KV("checkCost", check_time_cost)
-        << LOG_KV("notifyCost", notify_time_cost)
-        << LOG_KV("noteSealingCost", noteSealing_time_cost)
         << LOG_KV("currentCycle", m_timeManager.m_changeCycle)
         << LOG_KV("verifyAndSetSenderCost", verifyAndSetSender_time_cost)
         << LOG_KV("execCost", exec_time_cost)
@@ -713,6 +988,186 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
         << LOG_KV("totalCost", utcTime() - start_time);
 }
 
+/**
+ * @brief: reuse the execution result of the block re-proposed after a view change, the
+ *         committed prepare carried over by the new leader has the hash of the raw prepare
+ *         executed in the previous view, and its parent block is unchanged while the height
+ *         is the same
+ * @return true if the executed block and context have been set to sealing
+ */
+bool PBFTEngine::reuseExecutedBlock(Sealing& sealing, PrepareReq const& req)
+{
+    if (!m_executedPrepare || m_executedRawHash != req.block_hash ||
+        m_executedPrepare->height != req.height || m_highestBlock.number() + 1 != req.height ||
+        !m_executedPrepare->pBlock || !m_executedPrepare->p_execContext)
+    {
+        return false;
+    }
+    sealing.block = *m_executedPrepare->pBlock;
+    sealing.p_execContext = m_executedPrepare->p_execContext;
+    PBFTENGINE_LOG(INFO) << LOG_DESC("reuseExecutedBlock") << LOG_KV("reqNum", req.height)
+                         << LOG_KV("reqIdx", req.idx) << LOG_KV("view", req.view)
+                         << LOG_KV("hash", req.block_hash.abridged())
+                         << LOG_KV("execHash", m_executedPrepare->block_hash.abridged())
+                         << LOG_KV("nodeIdx", nodeIdx());
+    return true;
+}
+
+static Counter& speculatedBlocks(GROUP_ID _groupId, std::string const& _result)
+{
+    return g_metrics.counter("bcos_pbft_speculated_blocks",
+        "the blocks the leader executed before their parents were saved",
+        {{"group", std::to_string(_groupId)}, {"result", _result}});
+}
+
+/**
+ * @brief: execute the pipelined block of the leader on the executor before its parent is saved,
+ *         the parent's writes laid over the storage, so that the signReq follows the prepare as
+ *         soon as the parent is saved. The result is dropped if the block read a row the parent
+ *         inserted, whose id is only known once the parent is committed
+ * @param req: the local prepare of the block proposed ahead
+ */
+void PBFTEngine::speculateNextBlock(PrepareReq const& req)
+{
+    auto const& parent = m_reqCache->prepareCache();
+    if (!m_execPool || !req.pBlock || !parent.pBlock || !parent.p_execContext ||
+        parent.height + 1 != req.height ||
+        parent.block_hash != m_reqCache->committedPrepareCache().block_hash ||
+        parent.block_hash != req.pBlock->header().parentHash())
+    {
+        return;
+    }
+    auto tableFactory = std::dynamic_pointer_cast<MemoryTableFactory2>(
+        parent.p_execContext->getMemoryTableFactory());
+    if (!tableFactory)
+    {
+        return;
+    }
+    /// dumped here, the same thread commits the parent
+    auto storage =
+        std::make_shared<SpeculativeStorage>(tableFactory->stateStorage(), tableFactory->dump());
+    BlockInfo parentInfo(
+        parent.block_hash, parent.height, parent.pBlock->header().stateRoot(), storage);
+    auto sealing = std::make_shared<Sealing>();
+    sealing->block = *req.pBlock;
+    auto rawHash = req.block_hash;
+    {
+        Guard l(x_speculated);
+        m_speculatedRawHash = h256();
+        m_speculated = nullptr;
+    }
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("speculateNextBlock") << LOG_KV("reqNum", req.height)
+                          << LOG_KV("hash", rawHash.abridged())
+                          << LOG_KV("parent", parent.block_hash.abridged());
+    m_execPool->enqueue([this, sealing, parentInfo, storage, rawHash]() {
+        auto start = utcTime();
+        try
+        {
+            m_txPool->verifyAndSetSenderForBlock(sealing->block);
+            sealing->p_execContext = m_blockVerifier->executeBlock(sealing->block, parentInfo);
+        }
+        catch (std::exception const& e)
+        {
+            PBFTENGINE_LOG(WARNING) << LOG_DESC("speculateNextBlock: execute failed")
+                                    << LOG_KV("hash", rawHash.abridged())
+                                    << LOG_KV("EINFO", boost::diagnostic_information(e));
+            speculatedBlocks(m_groupId, "failed").inc();
+            return;
+        }
+        bool conflicted = storage->conflicted();
+        PBFTENGINE_LOG(INFO) << LOG_DESC("speculateNextBlock: executed")
+                             << LOG_KV("blkNum", sealing->block.header().number())
+                             << LOG_KV("hash", rawHash.abridged())
+                             << LOG_KV("conflicted", conflicted)
+                             << LOG_KV("execCost", utcTime() - start);
+        speculatedBlocks(m_groupId, conflicted ? "conflicted" : "executed").inc();
+        if (conflicted)
+        {
+            return;
+        }
+        Guard l(x_speculated);
+        m_speculatedRawHash = rawHash;
+        m_speculated = sealing;
+    });
+}
+
+/**
+ * @brief: take the result of the speculative execution of the prepare, the parent it was executed
+ *         on is the saved one as the parent hash of the block has been checked
+ * @return true if the executed block and context have been set to sealing
+ */
+bool PBFTEngine::reuseSpeculatedBlock(Sealing& sealing, PrepareReq const& req)
+{
+    std::shared_ptr<Sealing> speculated;
+    {
+        Guard l(x_speculated);
+        if (!m_speculated || m_speculatedRawHash != req.block_hash ||
+            m_speculated->block.header().number() != req.height)
+        {
+            return false;
+        }
+        speculated.swap(m_speculated);
+        m_speculatedRawHash = h256();
+    }
+    sealing.block = std::move(speculated->block);
+    sealing.p_execContext = speculated->p_execContext;
+    speculatedBlocks(m_groupId, "reused").inc();
+    PBFTENGINE_LOG(INFO) << LOG_DESC("reuseSpeculatedBlock") << LOG_KV("reqNum", req.height)
+                         << LOG_KV("hash", req.block_hash.abridged())
+                         << LOG_KV("execHash", sealing.block.header().hash().abridged())
+                         << LOG_KV("nodeIdx", nodeIdx());
+    return true;
+}
+
+/**
+ * @brief: execute the block of the prepare on the executor, the PBFT worker keeps handling the
+ *         sign, commit and viewchange messages meanwhile. The signReq is broadcasted once the
+ *         execution finished if the prepare is still the one in consensus
+ */
+void PBFTEngine::executePrepareAsync(PrepareReq const& prepareReq,
+    std::shared_ptr<Sealing> sealing, std::string const& info, Timer const& timer)
+{
+    m_executingPrepare = prepareReq.block_hash;
+    /// the executor is stopped before the engine is destroyed
+    m_execPool->enqueue([this, prepareReq, sealing, info, timer]() {
+        try
+        {
+            /// the speculative execution queued before may have finished meanwhile
+            if (!reuseSpeculatedBlock(*sealing, prepareReq))
+            {
+                executeSealing(*sealing, prepareReq);
+            }
+        }
+        catch (std::exception& e)
+        {
+            PBFTENGINE_LOG(WARNING) << LOG_DESC("Block execute failed") << LOG_KV("INFO", info)
+                                    << LOG_KV("EINFO", boost::diagnostic_information(e));
+            Guard l(m_mutex);
+            if (m_executingPrepare == prepareReq.block_hash)
+            {
+                m_executingPrepare = h256();
+            }
+            return;
+        }
+        Guard l(m_mutex);
+        if (m_executingPrepare == prepareReq.block_hash)
+        {
+            m_executingPrepare = h256();
+        }
+        /// the view changed or the prepare has been replaced during the execution
+        if (prepareReq.view != m_view ||
+            m_reqCache->rawPrepareCache().block_hash != prepareReq.block_hash)
+        {
+            PBFTENGINE_LOG(INFO) << LOG_DESC("executePrepareAsync: drop the outdated execution")
+                                 << LOG_KV("view", m_view) << LOG_KV("INFO", info);
+            return;
+        }
+        /// the time spent executing doesn't count towards the view timeout
+        m_timeManager.m_lastSignTime = utcTime();
+        onPrepareExecuted(prepareReq, *sealing, info, timer);
+    });
+}
+
 /// check whether the block is empty
 bool PBFTEngine::needOmit(Sealing const& sealing)
 {
@@ -754,11 +1209,22 @@ void PBFTEngine::onRecvPBFTMessage(
     {
         return;
     }
-    if (pbft_msg.packet_id <= ViewChangeReqPacket)
+    if (pbft_msg.packet_id < PBFTPacketCount)
     {
-        m_msgQueue.push(pbft_msg);
+        if (isCommittedHeightMsg(pbft_msg))
+        {
+            m_msgQueue.onDiscard(pbft_msg.packet_id);
+            return;
+        }
+        if (!m_msgQueue.push(pbft_msg))
+        {
+            PBFTENGINE_LOG(WARNING) << LOG_DESC("onRecvPBFTMessage: msgQueue full, drop the msg")
+                                    << LOG_KV("type", std::to_string(pbft_msg.packet_id))
+                                    << LOG_KV("fromIdx", pbft_msg.node_idx);
+            return;
+        }
         /// notify to handleMsg after push new PBFTMsgPacket into m_msgQueue
-        m_signalled.notify_all();
+        notifyWork();
     }
     else
     {
@@ -769,6 +1235,26 @@ void PBFTEngine::onRecvPBFTMessage(
     }
 }
 
+/// peek the height of the consensus message without decoding it, the messages of the committed
+/// heights are dropped before queued
+bool PBFTEngine::isCommittedHeightMsg(PBFTMsgPacket const& pbftMsg)
+{
+    if (pbftMsg.packet_id != PrepareReqPacket && pbftMsg.packet_id != CompactPrepareReqPacket &&
+        pbftMsg.packet_id != SignReqPacket && pbftMsg.packet_id != CommitReqPacket)
+    {
+        return false;
+    }
+    try
+    {
+        return RLP(ref(pbftMsg.data))[0].toInt<int64_t>() < m_consensusBlockNumber;
+    }
+    catch (std::exception const&)
+    {
+        /// the invalid message is dropped when decoded
+        return false;
+    }
+}
+
 bool PBFTEngine::handlePrepareMsg(PrepareReq& prepare_req, PBFTMsgPacket const& pbftMsg)
 {
     bool valid = decodeToRequests(prepare_req, ref(pbftMsg.data));
@@ -809,6 +1295,11 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
     }
     /// update the view for given idx
     updateViewMap(prepareReq.idx, prepareReq.view);
+    /// the full block of a compact prepare may come instead of its missed transactions
+    if (m_pendingCompactPrepare && m_pendingCompactPrepare->req.block_hash == prepareReq.block_hash)
+    {
+        m_pendingCompactPrepare = nullptr;
+    }
 
     if (valid_ret == CheckResult::FUTURE)
     {
@@ -817,10 +1308,21 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
     /// add raw prepare request
     m_reqCache->addRawPrepare(prepareReq);
 
-    Sealing workingSealing;
+    auto workingSealing = std::make_shared<Sealing>();
+    bool needExecute = false;
     try
     {
-        execBlock(workingSealing, prepareReq, oss);
+        needExecute = checkPrepareBlock(*workingSealing, prepareReq);
+        if (needExecute && (reuseExecutedBlock(*workingSealing, prepareReq) ||
+                               reuseSpeculatedBlock(*workingSealing, prepareReq)))
+        {
+            needExecute = false;
+        }
+        if (needExecute && !m_execPool)
+        {
+            executeSealing(*workingSealing, prepareReq);
+            needExecute = false;
+        }
     }
     catch (std::exception& e)
     {
@@ -828,18 +1330,33 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
                                 << LOG_KV("EINFO", boost::diagnostic_information(e));
         return true;
     }
+    if (needExecute)
+    {
+        executePrepareAsync(prepareReq, workingSealing, oss.str(), t);
+        return true;
+    }
+    onPrepareExecuted(prepareReq, *workingSealing, oss.str(), t);
+    return true;
+}
+
+/// sign and broadcast the executed prepare, then check whether the block can be committed
+void PBFTEngine::onPrepareExecuted(PrepareReq const& prepareReq, Sealing& workingSealing,
+    std::string const& info, Timer const& timer)
+{
     /// whether to omit empty block
     if (needOmit(workingSealing))
     {
         changeViewForFastViewChange();
         m_timeManager.m_changeCycle = 0;
-        return true;
+        return;
     }
 
     /// generate prepare request with signature of this node to broadcast
     /// (can't change prepareReq since it may be broadcasted-forwarded to other nodes)
     PrepareReq sign_prepare(prepareReq, workingSealing, m_keyPair);
     m_reqCache->addPrepareReq(sign_prepare);
+    m_executedRawHash = prepareReq.block_hash;
+    m_executedPrepare = std::make_shared<PrepareReq>(sign_prepare);
     PBFTENGINE_LOG(DEBUG) << LOG_DESC("handlePrepareMsg: add prepare cache and broadcastSignReq")
                           << LOG_KV("reqNum", sign_prepare.height)
                           << LOG_KV("hash", sign_prepare.block_hash.abridged())
@@ -849,14 +1366,199 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
     /// broadcast the re-generated signReq(add the signReq to cache)
     if (!broadcastSignReq(sign_prepare))
     {
-        PBFTENGINE_LOG(WARNING) << LOG_DESC("broadcastSignReq failed") << LOG_KV("INFO", oss.str());
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("broadcastSignReq failed") << LOG_KV("INFO", info);
     }
+    m_executedTime = utcTime();
+    m_signWaitStart = g_tracer.enabled() ? utcTimeUs() : 0;
     checkAndCommit();
     PBFTENGINE_LOG(INFO) << LOG_DESC("handlePrepareMsg Succ")
-                         << LOG_KV("Timecost", 1000 * t.elapsed()) << LOG_KV("INFO", oss.str());
-    return true;
+                         << LOG_KV("Timecost", 1000 * timer.elapsed()) << LOG_KV("INFO", info);
+}
+
+bool PBFTEngine::handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg)
+{
+    if (!decodeToRequests(prepareReq, ref(pbftMsg.data)))
+    {
+        return false;
+    }
+    /// the other checks are made on the rebuilt prepare by handlePrepareMsg
+    if (m_reqCache->isExistPrepare(prepareReq) || hasConsensused(prepareReq) ||
+        !checkSign(prepareReq))
+    {
+        return false;
+    }
+    auto pending = std::make_shared<PendingCompactPrepare>();
+    try
+    {
+        PrepareReq::decodeCompactBlock(ref(prepareReq.block), pending->header, pending->hashes);
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleCompactPrepareMsg: invalid compact block")
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return false;
+    }
+    pending->missed = m_txPool->fetchTransactions(pending->hashes, pending->txs);
+    if (pending->missed.empty())
+    {
+        return handleRebuiltPrepare(prepareReq, pending->header, pending->txs, pbftMsg.endpoint);
+    }
+    /// ask the sender for the missed transactions, or the full block when most are missed
+    bool full = pending->missed.size() * 100 > pending->hashes.size() * c_maxCompactMissPercent;
+    std::vector<unsigned> indexes;
+    if (!full)
+    {
+        indexes.assign(pending->missed.begin(), pending->missed.end());
+    }
+    RLPStream s(3);
+    s << prepareReq.block_hash << (unsigned)full;
+    s.appendVector(indexes);
+    m_service->asyncSendMessageByNodeID(
+        pbftMsg.node_id, transDataToMessage(ref(s.out()), PrepareTxsRequestPacket, 1), nullptr);
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("handleCompactPrepareMsg: request missed transactions")
+                          << LOG_KV("reqNum", prepareReq.height)
+                          << LOG_KV("hash", prepareReq.block_hash.abridged())
+                          << LOG_KV("txs", pending->hashes.size())
+                          << LOG_KV("missed", pending->missed.size()) << LOG_KV("full", full)
+                          << LOG_KV("fromIp", pbftMsg.endpoint);
+    pending->req = prepareReq;
+    pending->packet = pbftMsg;
+    m_pendingCompactPrepare = pending;
+    return false;
+}
+
+void PBFTEngine::handlePrepareTxsRequest(PBFTMsgPacket const& pbftMsg)
+{
+    auto const& prepare = m_reqCache->rawPrepareCache();
+    try
+    {
+        RLP rlp(ref(pbftMsg.data));
+        auto hash = rlp[0].toHash<h256>();
+        bool full = rlp[1].toInt<unsigned>() != 0;
+        auto indexes = rlp[2].toVector<unsigned>();
+        if (prepare.block_hash != hash || prepare.block.empty())
+        {
+            PBFTENGINE_LOG(DEBUG) << LOG_DESC("handlePrepareTxsRequest: prepare not cached")
+                                  << LOG_KV("hash", hash.abridged())
+                                  << LOG_KV("fromIp", pbftMsg.endpoint);
+            return;
+        }
+        bytes data;
+        PACKET_TYPE packetType = PrepareReqPacket;
+        if (full)
+        {
+            if (prepare.idx == nodeIdx())
+            {
+                m_fullPrepareFallback = true;
+            }
+            prepare.encode(data);
+        }
+        else
+        {
+            RLPStream s(2);
+            s << hash;
+            s.appendList(indexes.size());
+            for (auto index : indexes)
+            {
+                Transaction tx;
+                if (prepare.pBlock && index < prepare.pBlock->getTransactionSize())
+                {
+                    tx = prepare.pBlock->transaction(index);
+                }
+                else if (!Block::decodeTransaction(ref(prepare.block), index, tx))
+                {
+                    return;
+                }
+                s.appendRaw(tx.rlp());
+            }
+            s.swapOut(data);
+            packetType = PrepareTxsResponsePacket;
+        }
+        m_service->asyncSendMessageByNodeID(
+            pbftMsg.node_id, transDataToMessage(ref(data), packetType, 1), nullptr);
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("handlePrepareTxsRequest") << LOG_KV("full", full)
+                              << LOG_KV("txs", indexes.size()) << LOG_KV("hash", hash.abridged())
+                              << LOG_KV("toIp", pbftMsg.endpoint);
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handlePrepareTxsRequest failed")
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
+void PBFTEngine::handlePrepareTxsResponse(PBFTMsgPacket const& pbftMsg)
+{
+    auto pending = m_pendingCompactPrepare;
+    if (!pending)
+    {
+        return;
+    }
+    try
+    {
+        RLP rlp(ref(pbftMsg.data));
+        if (rlp[0].toHash<h256>() != pending->req.block_hash)
+        {
+            return;
+        }
+        auto txsRLP = rlp[1];
+        if (txsRLP.itemCount() != pending->missed.size())
+        {
+            PBFTENGINE_LOG(WARNING) << LOG_DESC("handlePrepareTxsResponse: transactions missed")
+                                    << LOG_KV("expected", pending->missed.size())
+                                    << LOG_KV("received", txsRLP.itemCount());
+            return;
+        }
+        for (size_t i = 0; i < pending->missed.size(); i++)
+        {
+            auto index = pending->missed[i];
+            /// the senders are recovered by verifyAndSetSenderForBlock
+            pending->txs[index].decode(txsRLP[i], CheckTransaction::None);
+            if (pending->txs[index].sha3() != pending->hashes[index])
+            {
+                PBFTENGINE_LOG(WARNING) << LOG_DESC("handlePrepareTxsResponse: invalid transaction")
+                                        << LOG_KV("index", index)
+                                        << LOG_KV("fromIp", pbftMsg.endpoint);
+                return;
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handlePrepareTxsResponse failed")
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return;
+    }
+    m_pendingCompactPrepare = nullptr;
+    if (handleRebuiltPrepare(
+            pending->req, pending->header, pending->txs, pending->packet.endpoint))
+    {
+        forwardMsg(pending->packet, pending->req, pending->req.uniqueKey());
+    }
 }
 
+bool PBFTEngine::handleRebuiltPrepare(PrepareReq& prepareReq, BlockHeader const& header,
+    Transactions const& txs, std::string const& endpoint)
+{
+    auto block = std::make_shared<Block>();
+    block->setBlockHeader(header);
+    block->setTransactions(txs);
+    if (block->blockHeader().hash() != prepareReq.block_hash)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleRebuiltPrepare: invalid block header")
+                                << LOG_KV("hash", prepareReq.block_hash.abridged())
+                                << LOG_KV("fromIp", endpoint);
+        return false;
+    }
+    /// the cached prepare carries the full block, to be served and backed up like the others
+    prepareReq.block.clear();
+    block->encode(prepareReq.block);
+    prepareReq.pBlock = block;
+    return handlePrepareMsg(prepareReq, endpoint);
+}
 
 void PBFTEngine::checkAndCommit()
 {
@@ -881,7 +1583,28 @@ void PBFTEngine::checkAndCommit()
                                   << LOG_KV("prepH", m_reqCache->prepareCache().height);
             return;
         }
+        BlockSpan span("pbft.checkAndCommit", m_groupId, m_reqCache->prepareCache().height,
+            m_reqCache->prepareCache().block_hash);
+        /// the signatures of the other nodes since this node executed the prepare
+        g_tracer.recordSince("pbft.waitSign", m_groupId, m_reqCache->prepareCache().height,
+            m_reqCache->prepareCache().block_hash, m_signWaitStart);
+        m_signWaitStart = 0;
         m_reqCache->updateCommittedPrepare();
+        uint64_t committedTime = utcTime();
+        m_committedTime = committedTime;
+        m_commitWaitStart = g_tracer.enabled() ? utcTimeUs() : 0;
+        uint64_t executedTime = m_executedTime.exchange(0);
+        if (executedTime > 0)
+        {
+            m_blockSizeController.onSigned(committedTime - executedTime);
+        }
+        if (m_enablePipeline)
+        {
+            auto const& committed = m_reqCache->committedPrepareCache();
+            Guard pipelineLock(x_pipelineParent);
+            m_pipelineParent = committed.pBlock ? committed.pBlock->header() :
+                                                  BlockHeader(ref(committed.block));
+        }
         /// update and backup the commit cache
         PBFTENGINE_LOG(INFO) << LOG_DESC("checkAndCommit: backup/updateCommittedPrepare")
                              << LOG_KV("reqNum", m_reqCache->committedPrepareCache().height)
@@ -889,19 +1612,69 @@ void PBFTEngine::checkAndCommit()
                                     m_reqCache->committedPrepareCache().block_hash.abridged())
                              << LOG_KV("nodeIdx", nodeIdx())
                              << LOG_KV("myNode", m_keyPair.pub().abridged());
+        if (m_backupPool)
+        {
+            backupCommittedPrepareAsync(m_reqCache->committedPrepareCache());
+            return;
+        }
         backupMsg(c_backupKeyCommitted, m_reqCache->committedPrepareCache());
-        PBFTENGINE_LOG(DEBUG) << LOG_DESC("checkAndCommit: broadcastCommitReq")
-                              << LOG_KV("prepareHeight", m_reqCache->prepareCache().height)
-                              << LOG_KV("hash", m_reqCache->prepareCache().block_hash.abridged())
-                              << LOG_KV("nodeIdx", nodeIdx())
-                              << LOG_KV("myNode", m_keyPair.pub().abridged());
-        if (!broadcastCommitReq(m_reqCache->prepareCache()))
+        commitAfterBackup();
+    }
+}
+
+/**
+ * @brief: backup the committed prepare on the backup thread, the commitReq is broadcasted once
+ *         the backup is synced to disk so that a restarted node never forgets the prepare it
+ *         committed, the PBFT worker keeps handling the other messages meanwhile
+ * @param committed: the committed prepare to backup
+ */
+void PBFTEngine::backupCommittedPrepareAsync(PrepareReq const& committed)
+{
+    /// the backup thread is stopped before the engine is destroyed
+    m_backupPool->enqueue([this, committed]() {
+        Timer t;
+        try
         {
-            PBFTENGINE_LOG(WARNING) << LOG_DESC("checkAndCommit: broadcastCommitReq failed");
+            backupMsg(c_backupKeyCommitted, committed);
         }
-        m_timeManager.m_lastSignTime = utcTime();
-        checkAndSave();
+        catch (std::exception const&)
+        {
+            /// logged by backupMsg, the node is terminating
+            return;
+        }
+        auto backupTime = 1000 * t.elapsed();
+        Guard l(m_mutex);
+        /// the prepare has been replaced or the view changed during the backup
+        if (m_reqCache->prepareCache().block_hash != committed.block_hash ||
+            m_reqCache->prepareCache().view != m_view)
+        {
+            PBFTENGINE_LOG(INFO) << LOG_DESC("backupCommittedPrepare: drop the outdated prepare")
+                                 << LOG_KV("hash", committed.block_hash.abridged())
+                                 << LOG_KV("view", m_view);
+            return;
+        }
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("backupCommittedPrepare")
+                              << LOG_KV("reqNum", committed.height)
+                              << LOG_KV("hash", committed.block_hash.abridged())
+                              << LOG_KV("backupTime", backupTime);
+        commitAfterBackup();
+    });
+}
+
+/// broadcast the commitReq of the backed up prepare and check whether the block can be saved
+void PBFTEngine::commitAfterBackup()
+{
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("checkAndCommit: broadcastCommitReq")
+                          << LOG_KV("prepareHeight", m_reqCache->prepareCache().height)
+                          << LOG_KV("hash", m_reqCache->prepareCache().block_hash.abridged())
+                          << LOG_KV("nodeIdx", nodeIdx())
+                          << LOG_KV("myNode", m_keyPair.pub().abridged());
+    if (!broadcastCommitReq(m_reqCache->prepareCache()))
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("checkAndCommit: broadcastCommitReq failed");
     }
+    m_timeManager.m_lastSignTime = utcTime();
+    checkAndSave();
 }
 
 /// if collect >= 2/3 SignReq and CommitReq, then callback this function to commit block
@@ -937,6 +1710,14 @@ void PBFTEngine::checkAndSave()
         {
             /// Block block(m_reqCache->prepareCache().block);
             std::shared_ptr<dev::eth::Block> p_block = m_reqCache->prepareCache().pBlock;
+            /// the commits of the other nodes since this node broadcasted its own
+            g_tracer.recordSince("pbft.waitCommit", m_groupId, m_reqCache->prepareCache().height,
+                m_reqCache->prepareCache().block_hash, m_commitWaitStart);
+            m_commitWaitStart = 0;
+            BlockSpan span("pbft.checkAndSave", m_groupId, m_reqCache->prepareCache().height,
+                m_reqCache->prepareCache().block_hash);
+            /// the context is consumed by the commit
+            m_executedPrepare = nullptr;
             m_reqCache->generateAndSetSigList(*p_block, minValidNodes());
             auto genSig_time_cost = utcTime() - record_time;
             record_time = utcTime();
@@ -955,6 +1736,19 @@ void PBFTEngine::checkAndSave()
                 m_blockSync->noteSealingBlockNumber(m_reqCache->prepareCache().height);
                 auto noteSealing_time_cost = utcTime() - record_time;
                 record_time = utcTime();
+                MetricsRegistry::Labels labels = {{"group", std::to_string(m_groupId)}};
+                g_metrics
+                    .histogram("bcos_block_commit_ms",
+                        "the ms a block agreed is committed in by the consensus", labels)
+                    .observe(commitBlock_time_cost);
+                g_metrics
+                    .counter("bcos_blocks_committed", "the blocks committed by the consensus",
+                        labels)
+                    .inc();
+                g_metrics
+                    .counter("bcos_txs_committed",
+                        "the transactions committed by the consensus", labels)
+                    .inc(p_block->getTransactionSize());
                 PBFTENGINE_LOG(INFO)
                     << LOG_DESC("CommitBlock Succ")
                     << LOG_KV("prepareHeight", m_reqCache->prepareCache().height)
@@ -1018,6 +1812,11 @@ void PBFTEngine::reportBlockWithoutLock(Block const& block)
         }
         /// remove invalid future block
         m_reqCache->removeInvalidFutureCache(m_highestBlock);
+        uint64_t committedTime = m_committedTime.exchange(0);
+        if (committedTime > 0)
+        {
+            m_blockSizeController.onCommitted(utcTime() - committedTime);
+        }
         /// update the highest block
         m_highestBlock = block.blockHeader();
         if (m_highestBlock.number() >= m_consensusBlockNumber)
@@ -1372,7 +2171,8 @@ void PBFTEngine::checkTimeout()
     bool flag = false;
     {
         Guard l(m_mutex);
-        if (m_timeManager.isTimeout())
+        /// the view timeout is suspended while the block of the prepare is executing
+        if (m_executingPrepare == h256() && m_timeManager.isTimeout())
         {
             /// timeout not triggered by fast view change
             if (m_timeManager.m_lastConsensusTime != 0)
@@ -1450,6 +2250,21 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
         pbft_msg = req;
         break;
     }
+    case CompactPrepareReqPacket:
+    {
+        PrepareReq prepare_req;
+        succ = handleCompactPrepareMsg(prepare_req, pbftMsg);
+        key = prepare_req.uniqueKey();
+        pbft_msg = prepare_req;
+        break;
+    }
+    /// the transactions of the compact prepares are exchanged between two nodes, not forwarded
+    case PrepareTxsRequestPacket:
+        handlePrepareTxsRequest(pbftMsg);
+        return;
+    case PrepareTxsResponsePacket:
+        handlePrepareTxsResponse(pbftMsg);
+        return;
     default:
     {
         PBFTENGINE_LOG(DEBUG) << LOG_DESC("handleMsg:  Err pbft message")
@@ -1459,13 +2274,32 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
     }
     }
 
-    if (pbftMsg.ttl == 1)
+    if (succ)
     {
-        return;
+        forwardMsg(pbftMsg, pbft_msg, key);
     }
+}
+
+void PBFTEngine::forwardMsg(
+    PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbft_msg, std::string const& key)
+{
     bool height_flag = (pbft_msg.height > m_highestBlock.number()) ||
                        (m_highestBlock.number() - pbft_msg.height < 10);
-    if (succ && key.size() > 0 && height_flag)
+    /// the relay tree reaches every sealer, no ttl is needed
+    if (isRelayPacket(pbftMsg.packet_id))
+    {
+        if (key.size() > 0 && height_flag)
+        {
+            broadcastMark(pbftMsg.node_id, pbftMsg.packet_id, key);
+            relayMsg(pbftMsg.packet_id, key, ref(pbftMsg.data), pbft_msg.idx, pbftMsg.ttl);
+        }
+        return;
+    }
+    if (pbftMsg.ttl == 1)
+    {
+        return;
+    }
+    if (key.size() > 0 && height_flag)
     {
         std::unordered_set<h512> filter;
         filter.insert(pbftMsg.node_id);
@@ -1490,18 +2324,24 @@ void PBFTEngine::workLoop()
             std::pair<bool, PBFTMsgPacket> ret = m_msgQueue.tryPop(c_PopWaitSeconds);
             if (ret.first)
             {
-                PBFTENGINE_LOG(TRACE)
-                    << LOG_DESC("workLoop: handleMsg")
-                    << LOG_KV("type", std::to_string(ret.second.packet_id))
-                    << LOG_KV("fromIdx", ret.second.node_idx) << LOG_KV("nodeIdx", nodeIdx())
-                    << LOG_KV("myNode", m_keyPair.pub().abridged());
-                handleMsg(ret.second);
+                /// pop the queued messages together to verify their signatures in batch
+                std::vector<PBFTMsgPacket> packets{std::move(ret.second)};
+                m_msgQueue.popBatch(packets, c_maxMsgBatchSize - 1);
+                verifySignsInBatch(packets);
+                for (auto const& packet : packets)
+                {
+                    PBFTENGINE_LOG(TRACE)
+                        << LOG_DESC("workLoop: handleMsg")
+                        << LOG_KV("type", std::to_string(packet.packet_id))
+                        << LOG_KV("fromIdx", packet.node_idx) << LOG_KV("nodeIdx", nodeIdx())
+                        << LOG_KV("myNode", m_keyPair.pub().abridged());
+                    handleMsg(packet);
+                }
             }
-            /// to avoid of cpu problem
+            /// to avoid of cpu problem, the messages and view changes wake the wait at once
             else if (m_reqCache->futurePrepareCacheSize() == 0)
             {
-                std::unique_lock<std::mutex> l(x_signalled);
-                m_signalled.wait_for(l, std::chrono::milliseconds(5));
+                waitForWork(5);
             }
             if (nodeIdx() != MAXIDX)
             {
@@ -1552,6 +2392,16 @@ const std::string PBFTEngine::consensusStatus()
     statusObj["toView"] = m_toView;
     /// get leader failed or not
     statusObj["leaderFailed"] = bool(m_leaderFailed);
+    if (m_blockSizeController.enabled())
+    {
+        Json::Value controller;
+        m_blockSizeController.status(
+            controller, maxBlockTransactions(), m_timeManager.m_minBlockGenTime);
+        statusObj["blockSizeController"] = controller;
+    }
+    Json::Value msgQueue(Json::arrayValue);
+    m_msgQueue.status(msgQueue);
+    statusObj["msgQueue"] = msgQueue;
     status.append(statusObj);
     /// get view of node id
     getAllNodesViewStatus(status);
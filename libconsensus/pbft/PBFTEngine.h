@@ -22,14 +22,17 @@
  * @date: 2018-09-28
  */
 #pragma once
+#include "BlockSizeController.h"
 #include "Common.h"
 #include "PBFTMsgCache.h"
+#include "PBFTMsgQueue.h"
 #include "PBFTReqCache.h"
 #include "TimeManager.h"
 #include <libconsensus/ConsensusEngineBase.h>
 #include <libdevcore/FileSystem.h>
+#include <libdevcore/FixedHashMap.h>
 #include <libdevcore/LevelDB.h>
-#include <libdevcore/concurrent_queue.h>
+#include <libdevcore/ThreadPool.h>
 #include <libstorage/Storage.h>
 #include <libsync/SyncStatus.h>
 #include <sstream>
@@ -50,7 +53,6 @@ enum CheckResult
     INVALID = 1,
     FUTURE = 2
 };
-using PBFTMsgQueue = dev::concurrent_queue<PBFTMsgPacket>;
 class PBFTEngine : public ConsensusEngineBase
 {
 public:
@@ -107,6 +109,7 @@ public:
     }
 
     void start() override;
+    void stop() override;
 
     /// reach the minimum block generation time
     virtual bool reachMinBlockGenTime()
@@ -114,9 +117,13 @@ public:
         /// since canHandleBlockForNextLeader has enforced the  next leader sealed block can't be
         /// handled before the current leader generate a new block, it's no need to add other
         /// conditions to enforce this striction
-        return (utcTime() - m_timeManager.m_lastConsensusTime) >= m_timeManager.m_minBlockGenTime;
+        return (utcTime() - m_timeManager.m_lastConsensusTime) >=
+               m_blockSizeController.sealingInterval(m_timeManager.m_minBlockGenTime);
     }
 
+    /// tunes the block size and the sealing interval to the target block latency
+    BlockSizeController& blockSizeController() { return m_blockSizeController; }
+
     virtual bool reachBlockIntervalTime()
     {
         /// since canHandleBlockForNextLeader has enforced the  next leader sealed block can't be
@@ -143,10 +150,24 @@ public:
         }
         if (m_notifyNextLeaderSeal && getNextLeader() == nodeIdx())
         {
-            return false;
+            return canPipelineSeal();
         }
         return true;
     }
+    /// the next leader seals the next block once the current one is committed by 2/3 sealers
+    bool canPipelineSeal() const;
+    /// header of the block committed by 2/3 sealers, parent of the pipelined block
+    dev::eth::BlockHeader pipelineParent() const
+    {
+        Guard l(x_pipelineParent);
+        return m_pipelineParent;
+    }
+    void setEnablePipeline(bool _enablePipeline) { m_enablePipeline = _enablePipeline; }
+    /// the leader executes its pipelined block on the writes of the block being committed
+    void setSpeculativeExecution(bool _speculativeExecution)
+    {
+        m_speculativeExecution = _speculativeExecution;
+    }
     void rehandleCommitedPrepareCache(PrepareReq const& req);
     bool shouldSeal();
     /// broadcast prepare message
@@ -179,7 +200,13 @@ public:
         return block.getTransactionSize() == 0 && m_omitEmptyBlock;
     }
     const std::string consensusStatus() override;
+    void exportBackup(std::string const& _path) override;
     void setOmitEmptyBlock(bool setter) { m_omitEmptyBlock = setter; }
+    /// broadcast the prepare with the transaction hashes, the followers rebuild the block from
+    /// their txpool
+    void setCompactPrepare(bool _compactPrepare) { m_compactPrepare = _compactPrepare; }
+    /// relay the prepare, sign and commit messages along a tree of the given width
+    void setBroadcastTreeWidth(unsigned _width) { m_broadcastTreeWidth = _width; }
 
     void setMaxTTL(uint8_t const& ttl) { maxTTL = ttl; }
 
@@ -194,6 +221,8 @@ public:
         return std::make_pair(true, (m_view + m_highestBlock.number()) % m_nodeNum);
     }
 
+    VIEWTYPE view() const { return m_view; }
+
     uint64_t sealingTxNumber() const { return m_sealingNumber; }
 
 protected:
@@ -218,6 +247,17 @@ protected:
             std::unordered_set<dev::network::NodeID>(),
         unsigned const& ttl = 0);
 
+    /// send the message generated by the root to the children of this node in the relay tree
+    bool relayMsg(unsigned const& packetType, std::string const& key, bytesConstRef data,
+        IDXTYPE const& root, unsigned const& ttl = 0);
+    dev::h512s relayTargets(IDXTYPE const& root, std::unordered_set<h512> const& connected) const;
+    bool isRelayPacket(unsigned const& packetType) const
+    {
+        return m_broadcastTreeWidth > 0 &&
+               (packetType == PrepareReqPacket || packetType == CompactPrepareReqPacket ||
+                   packetType == SignReqPacket || packetType == CommitReqPacket);
+    }
+
     void sendViewChangeMsg(dev::network::NodeID const& nodeId);
     bool sendMsg(dev::network::NodeID const& nodeId, unsigned const& packetType,
         std::string const& key, bytesConstRef data, unsigned const& ttl = 1);
@@ -243,7 +283,17 @@ protected:
     bool handleSignMsg(SignReq& signReq, PBFTMsgPacket const& pbftMsg);
     bool handleCommitMsg(CommitReq& commitReq, PBFTMsgPacket const& pbftMsg);
     bool handleViewChangeMsg(ViewChangeReq& viewChangeReq, PBFTMsgPacket const& pbftMsg);
+    /// rebuild the block of a compact prepare from the txpool, request the missed transactions
+    /// from the sender of the prepare
+    bool handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg);
+    void handlePrepareTxsRequest(PBFTMsgPacket const& pbftMsg);
+    void handlePrepareTxsResponse(PBFTMsgPacket const& pbftMsg);
+    /// handle the compact prepare once all its transactions are found
+    bool handleRebuiltPrepare(PrepareReq& prepareReq, dev::eth::BlockHeader const& header,
+        dev::eth::Transactions const& txs, std::string const& endpoint);
     void handleMsg(PBFTMsgPacket const& pbftMsg);
+    /// forward a handled message to the other sealers
+    void forwardMsg(PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbftReq, std::string const& key);
     void catchupView(ViewChangeReq const& req, std::ostringstream& oss);
     void checkAndCommit();
 
@@ -256,11 +306,17 @@ protected:
     /// recalculate m_nodeNum && m_f && m_cfgErr(must called after setSigList)
     void resetConfig() override;
     virtual void initBackupDB();
+    static std::shared_ptr<dev::db::LevelDB> openBackupDB(boost::filesystem::path const& _path);
     void reloadMsg(std::string const& _key, PBFTMsg* _msg);
     void backupMsg(std::string const& _key, PBFTMsg const& _msg);
+    void backupCommittedPrepareAsync(PrepareReq const& committed);
+    void commitAfterBackup();
     inline std::string getBackupMsgPath() { return m_baseDir + "/" + c_backupMsgDirName; }
 
     bool checkSign(PBFTMsg const& req) const;
+    h256 signatureKey(h512 const& nodeId, PBFTMsg const& req) const;
+    bool takeVerifiedSign(h256 const& key) const;
+    void verifySignsInBatch(std::vector<PBFTMsgPacket> const& packets);
     inline bool broadcastFilter(
         dev::network::NodeID const& nodeId, unsigned const& packetType, std::string const& key)
     {
@@ -536,11 +592,21 @@ protected:
     /// check block
     bool checkBlock(dev::eth::Block const& block);
     void execBlock(Sealing& sealing, PrepareReq const& req, std::ostringstream& oss);
+    bool checkPrepareBlock(Sealing& sealing, PrepareReq const& req);
+    void executeSealing(Sealing& sealing, PrepareReq const& req);
+    bool reuseExecutedBlock(Sealing& sealing, PrepareReq const& req);
+    void speculateNextBlock(PrepareReq const& req);
+    bool reuseSpeculatedBlock(Sealing& sealing, PrepareReq const& req);
+    bool isCommittedHeightMsg(PBFTMsgPacket const& pbftMsg);
+    void executePrepareAsync(PrepareReq const& prepareReq, std::shared_ptr<Sealing> sealing,
+        std::string const& info, Timer const& timer);
+    void onPrepareExecuted(PrepareReq const& prepareReq, Sealing& workingSealing,
+        std::string const& info, Timer const& timer);
     void changeViewForFastViewChange()
     {
         m_timeManager.changeView();
         m_fastViewChange = true;
-        m_signalled.notify_all();
+        notifyWork();
     }
     void notifySealing(dev::eth::Block const& block);
     /// to ensure at least 100MB available disk space
@@ -570,6 +636,10 @@ protected:
     static const std::string c_backupKeyCommitted;
     static const std::string c_backupMsgDirName;
     static const unsigned c_PopWaitSeconds = 5;
+    /// messages popped at most once from the message queue
+    static const size_t c_maxMsgBatchSize = 64;
+    /// verified signatures kept at most for checkSign
+    static const size_t c_maxVerifiedSigns = 4096;
 
     std::shared_ptr<PBFTBroadcastCache> m_broadCastCache;
     std::shared_ptr<PBFTReqCache> m_reqCache;
@@ -577,8 +647,6 @@ protected:
     PBFTMsgQueue m_msgQueue;
     mutable Mutex m_mutex;
 
-    std::condition_variable m_signalled;
-    Mutex x_signalled;
 
 
     std::function<void()> m_onViewChange = nullptr;
@@ -599,6 +667,62 @@ protected:
     std::map<IDXTYPE, VIEWTYPE> m_viewMap;
 
     std::atomic<uint64_t> m_sealingNumber = {0};
+
+    bool m_compactPrepare = false;
+    /// children of each sealer in the relay tree, 0 to broadcast to all the sealers
+    unsigned m_broadcastTreeWidth = 0;
+
+    /// propose the next block while the current one is in its commit phase
+    bool m_enablePipeline = false;
+    mutable Mutex x_pipelineParent;
+    dev::eth::BlockHeader m_pipelineParent;
+    /// number of the block proposed by this node ahead of its height
+    std::atomic<int64_t> m_pipelinedNumber = {0};
+    bool m_speculativeExecution = false;
+    /// the pipelined block executed by the leader before its parent is saved, and the hash of
+    /// its raw prepare
+    mutable Mutex x_speculated;
+    h256 m_speculatedRawHash;
+    std::shared_ptr<Sealing> m_speculated;
+
+    BlockSizeController m_blockSizeController;
+    /// the time the prepare of this round was executed and committed, set by the executor and the
+    /// commit of the block
+    std::atomic<uint64_t> m_executedTime = {0};
+    std::atomic<uint64_t> m_committedTime = {0};
+    /// us the prepare of this round started waiting for the signatures and the commits, traced
+    uint64_t m_signWaitStart = 0;
+    uint64_t m_commitWaitStart = 0;
+    /// the followers missed most transactions of the last compact prepare of this node, send
+    /// the full block in the next one
+    bool m_fullPrepareFallback = false;
+    /// a follower asks for the full block once it misses more than this part of the transactions
+    static const unsigned c_maxCompactMissPercent = 25;
+    /// the compact prepare waiting for the missed transactions
+    struct PendingCompactPrepare
+    {
+        PrepareReq req;
+        PBFTMsgPacket packet;
+        dev::eth::BlockHeader header;
+        h256s hashes;
+        dev::eth::Transactions txs;
+        std::vector<size_t> missed;
+    };
+    std::shared_ptr<PendingCompactPrepare> m_pendingCompactPrepare;
+
+    /// executor of the prepared blocks, created on start
+    dev::ThreadPool::Ptr m_execPool;
+    /// writer of the committed prepare backups, created on start
+    dev::ThreadPool::Ptr m_backupPool;
+    /// hash of the prepare in execution, the view timeout waits for it
+    h256 m_executingPrepare;
+    /// the latest executed prepare and the hash of its raw prepare, the block re-proposed after
+    /// a view change reuses the execution result
+    h256 m_executedRawHash;
+    std::shared_ptr<PrepareReq> m_executedPrepare;
+
+    /// keys of the signatures verified in batch and not checked yet
+    mutable ConcurrentFixedHashSet<h256> m_verifiedSigns;
 };
 }  // namespace consensus
 }  // namespace dev
@@ -51,16 +51,18 @@ public:
         switch (type)
         {
         case PrepareReqPacket:
-            insertMessage(x_knownPrepare, m_knownPrepare, c_knownPrepare, key);
+        case CompactPrepareReqPacket:
+            insertMessage(x_knownPrepare, m_knownPrepare, c_knownPrepare, digest(key));
             return true;
         case SignReqPacket:
-            insertMessage(x_knownSign, m_knownSign, c_knownSign, key);
+            insertMessage(x_knownSign, m_knownSign, c_knownSign, digest(key));
             return true;
         case CommitReqPacket:
-            insertMessage(x_knownCommit, m_knownCommit, c_knownCommit, key);
+            insertMessage(x_knownCommit, m_knownCommit, c_knownCommit, digest(key));
             return true;
         case ViewChangeReqPacket:
-            insertMessage(x_knownViewChange, m_knownViewChange, c_knownViewChange, key);
+            insertMessage(
+                x_knownViewChange, m_knownViewChange, c_knownViewChange, digest(key));
             return true;
         default:
             LOG(DEBUG) << "Invalid packet type:" << type;
@@ -81,20 +83,25 @@ public:
         switch (type)
         {
         case PrepareReqPacket:
-            return exists(x_knownPrepare, m_knownPrepare, key);
+        case CompactPrepareReqPacket:
+            return exists(x_knownPrepare, m_knownPrepare, digest(key));
         case SignReqPacket:
-            return exists(x_knownSign, m_knownSign, key);
+            return exists(x_knownSign, m_knownSign, digest(key));
         case CommitReqPacket:
-            return exists(x_knownCommit, m_knownCommit, key);
+            return exists(x_knownCommit, m_knownCommit, digest(key));
         case ViewChangeReqPacket:
-            return exists(x_knownViewChange, m_knownViewChange, key);
+            return exists(x_knownViewChange, m_knownViewChange, digest(key));
         default:
             LOG(DEBUG) << "Invalid packet type:" << type;
             return false;
         }
     }
 
-    inline bool exists(SharedMutex& lock, QueueSet<std::string>& queue, std::string const& key)
+    /// the keys are the hex of the two signatures of a packet, 260 chars, a 64 bits digest of
+    /// them is kept instead
+    static inline uint64_t digest(std::string const& key) { return std::hash<std::string>()(key); }
+
+    inline bool exists(SharedMutex& lock, QueueSet<uint64_t>& queue, uint64_t key)
     {
         /// lock succ
         ReadGuard l(lock);
@@ -102,8 +109,8 @@ public:
         return exist;
     }
 
-    inline void insertMessage(SharedMutex& lock, QueueSet<std::string>& queue,
-        size_t const& maxCacheSize, std::string const& key)
+    inline void insertMessage(
+        SharedMutex& lock, QueueSet<uint64_t>& queue, size_t const& maxCacheSize, uint64_t key)
     {
         WriteGuard l(lock);
         if (queue.size() > maxCacheSize)
@@ -135,19 +142,19 @@ private:
     /// mutex for m_knownPrepare
     mutable SharedMutex x_knownPrepare;
     /// cache for the prepare packet
-    QueueSet<std::string> m_knownPrepare;
+    QueueSet<uint64_t> m_knownPrepare;
     /// mutex for m_knownSign
     mutable SharedMutex x_knownSign;
     /// cache for the sign packet
-    QueueSet<std::string> m_knownSign;
+    QueueSet<uint64_t> m_knownSign;
     /// mutex for m_knownCommit
     mutable SharedMutex x_knownCommit;
     /// cache for the commit packet
-    QueueSet<std::string> m_knownCommit;
+    QueueSet<uint64_t> m_knownCommit;
     /// mutex for m_knownViewChange
     mutable SharedMutex x_knownViewChange;
     /// cache for the viewchange packet
-    QueueSet<std::string> m_knownViewChange;
+    QueueSet<uint64_t> m_knownViewChange;
 
     /// the limit size for prepare packet cache
     static const unsigned c_knownPrepare = 1024;
@@ -0,0 +1,160 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : queue of the PBFT messages popped by priority of their types
+ * @file: PBFTMsgQueue.h
+ */
+#pragma once
+#include "Common.h"
+#include <libdevcore/concurrent_queue.h>
+#include <json/json.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace dev
+{
+namespace consensus
+{
+/// The messages are queued by priority, commit > sign > prepare > viewchange, so that a flood of
+/// viewchange requests never delays the commit of a block. Each priority is a bounded lock-free
+/// ring, the worker spins a while on the empty rings before it parks, and a message arriving
+/// when its ring is full is discarded.
+class PBFTMsgQueue
+{
+public:
+    /// the messages each priority holds
+    static const size_t c_capacity = 4096;
+
+    PBFTMsgQueue()
+    {
+        for (auto& queue : m_queues)
+        {
+            queue.reset(new MPMCQueue<PBFTMsgPacket>(c_capacity));
+        }
+    }
+
+    /// false and counted as discarded if the queue of its priority is full
+    bool push(PBFTMsgPacket const& _msg)
+    {
+        auto packetId = _msg.packet_id % PBFTPacketCount;
+        m_typeSizes[packetId]++;
+        m_size++;
+        if (!m_queues[priority(_msg.packet_id)]->tryPush(_msg))
+        {
+            m_typeSizes[packetId]--;
+            m_size--;
+            onDiscard(_msg.packet_id);
+            return false;
+        }
+        m_parking.unpark();
+        return true;
+    }
+
+    /// pop the message of the highest priority, wait at most _milliseconds if there is none
+    std::pair<bool, PBFTMsgPacket> tryPop(int _milliseconds)
+    {
+        std::pair<bool, PBFTMsgPacket> ret;
+        ret.first = popByPriority(ret.second);
+        if (ret.first || _milliseconds <= 0)
+        {
+            return ret;
+        }
+        ret.first = m_parking.await([&]() { return popByPriority(ret.second); }, _milliseconds);
+        return ret;
+    }
+
+    /// append at most _max messages to _msgs by priority without waiting, returns how many
+    size_t popBatch(std::vector<PBFTMsgPacket>& _msgs, size_t _max)
+    {
+        size_t popped = 0;
+        for (auto& queue : m_queues)
+        {
+            auto begin = _msgs.size();
+            popped += queue->tryPopBatch(std::back_inserter(_msgs), _max - popped);
+            for (auto i = begin; i < _msgs.size(); i++)
+            {
+                m_typeSizes[_msgs[i].packet_id % PBFTPacketCount]--;
+            }
+            if (popped == _max)
+            {
+                break;
+            }
+        }
+        m_size -= popped;
+        return popped;
+    }
+
+    /// count the message of the given type dropped before it's queued
+    void onDiscard(uint8_t _packetId) { m_typeDiscarded[_packetId % PBFTPacketCount]++; }
+
+    size_t size() const { return m_size; }
+    size_t size(uint8_t _packetId) const { return m_typeSizes[_packetId % PBFTPacketCount]; }
+
+    void status(Json::Value& _status) const
+    {
+        for (uint8_t packetId = 0; packetId < PBFTPacketCount; packetId++)
+        {
+            Json::Value typeStatus;
+            typeStatus["packetId"] = packetId;
+            typeStatus["queued"] = Json::UInt64(m_typeSizes[packetId]);
+            typeStatus["discarded"] = Json::UInt64(m_typeDiscarded[packetId]);
+            _status.append(typeStatus);
+        }
+    }
+
+private:
+    static size_t priority(uint8_t _packetId)
+    {
+        switch (_packetId)
+        {
+        case CommitReqPacket:
+            return 0;
+        case SignReqPacket:
+            return 1;
+        case ViewChangeReqPacket:
+            return 3;
+        default:
+            return 2;
+        }
+    }
+
+    bool popByPriority(PBFTMsgPacket& _msg)
+    {
+        for (auto& queue : m_queues)
+        {
+            if (queue->tryPop(_msg))
+            {
+                m_typeSizes[_msg.packet_id % PBFTPacketCount]--;
+                m_size--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static const size_t c_priorityCount = 4;
+    std::array<std::unique_ptr<MPMCQueue<PBFTMsgPacket>>, c_priorityCount> m_queues;
+    std::array<std::atomic<uint64_t>, PBFTPacketCount> m_typeSizes = {};
+    std::array<std::atomic<uint64_t>, PBFTPacketCount> m_typeDiscarded = {};
+    std::atomic<size_t> m_size = {0};
+    /// the worker waiting for a message of any priority
+    detail::Parking m_parking;
+};
+}  // namespace consensus
+}  // namespace dev
@@ -57,20 +57,15 @@ void PBFTReqCache::delCache(h256 const& hash)
  */
 bool PBFTReqCache::generateAndSetSigList(dev::eth::Block& block, IDXTYPE const& minSigSize)
 {
-    std::vector<std::pair<u256, Signature>> sig_list;
-    if (m_commitCache.count(m_prepareCache.block_hash) > 0)
+    auto it = m_commitCache.find(m_prepareCache.block_hash);
+    if (it != m_commitCache.end())
     {
-        for (auto const& item : m_commitCache[m_prepareCache.block_hash])
-        {
-            sig_list.push_back(
-                std::make_pair(u256(item.second.idx), Signature(item.first.c_str())));
-        }
-        if (sig_list.size() < minSigSize)
+        if (it->second.size() < minSigSize)
         {
             return false;
         }
         /// set siglist for prepare cache
-        block.setSigList(sig_list);
+        block.setSigList(it->second.sigList());
         return true;
     }
     return false;
@@ -166,14 +161,8 @@ void PBFTReqCache::removeInvalidSignCache(h256 const& blockHash, VIEWTYPE const&
     auto it = m_signCache.find(blockHash);
     if (it == m_signCache.end())
         return;
-    for (auto pcache = it->second.begin(); pcache != it->second.end();)
-    {
-        /// erase invalid view
-        if (pcache->second.view != view)
-            pcache = it->second.erase(pcache);
-        else
-            pcache++;
-    }
+    /// erase invalid view
+    it->second.eraseIf([&](VoteCache::Vote const& vote) { return vote.view != view; });
 }
 /// remove commit cache according to block hash and view
 void PBFTReqCache::removeInvalidCommitCache(h256 const& blockHash, VIEWTYPE const& view)
@@ -181,13 +170,7 @@ void PBFTReqCache::removeInvalidCommitCache(h256 const& blockHash, VIEWTYPE cons
     auto it = m_commitCache.find(blockHash);
     if (it == m_commitCache.end())
         return;
-    for (auto pcache = it->second.begin(); pcache != it->second.end();)
-    {
-        if (pcache->second.view != view)
-            pcache = it->second.erase(pcache);
-        else
-            pcache++;
-    }
+    it->second.eraseIf([&](VoteCache::Vote const& vote) { return vote.view != view; });
 }
 
 /// clear the cache of future block to solve the memory leak problems
@@ -31,6 +31,82 @@ namespace dev
 {
 namespace consensus
 {
+/// The sign or commit requests of one block hash, flat by the index of their sealer: only the
+/// signature, the height and the view of each request are kept, with a bitmap of the sealers
+/// whose request is held and their count, so that a sealer counts once towards the quorum and
+/// a later request of it replaces the former.
+class VoteCache
+{
+public:
+    struct Vote
+    {
+        Signature sig;
+        int64_t height;
+        VIEWTYPE view;
+    };
+
+    inline void add(PBFTMsg const& req)
+    {
+        if (req.idx >= m_votes.size())
+        {
+            m_votes.resize(req.idx + 1);
+            m_voted.resize(req.idx / 64 + 1, 0);
+        }
+        if (!voted(req.idx))
+        {
+            m_voted[req.idx / 64] |= bit(req.idx);
+            ++m_size;
+        }
+        m_votes[req.idx] = Vote{req.sig, req.height, req.view};
+    }
+
+    /// the request of the sealer with the same signature is held
+    inline bool exists(PBFTMsg const& req) const
+    {
+        return req.idx < m_votes.size() && voted(req.idx) && m_votes[req.idx].sig == req.sig;
+    }
+
+    /// the sealers whose request is held
+    inline size_t size() const { return m_size; }
+
+    /// erase the requests _pred(vote) holds for
+    template <typename P>
+    inline void eraseIf(P _pred)
+    {
+        for (size_t idx = 0; idx < m_votes.size(); ++idx)
+        {
+            if (voted(idx) && _pred(m_votes[idx]))
+            {
+                m_voted[idx / 64] &= ~bit(idx);
+                --m_size;
+            }
+        }
+    }
+
+    /// the index and the signature of the requests held, by index
+    std::vector<std::pair<u256, Signature>> sigList() const
+    {
+        std::vector<std::pair<u256, Signature>> sigList;
+        sigList.reserve(m_size);
+        for (size_t idx = 0; idx < m_votes.size(); ++idx)
+        {
+            if (voted(idx))
+            {
+                sigList.push_back(std::make_pair(u256(idx), m_votes[idx].sig));
+            }
+        }
+        return sigList;
+    }
+
+private:
+    static inline uint64_t bit(size_t _idx) { return (uint64_t)1 << (_idx % 64); }
+    inline bool voted(size_t _idx) const { return m_voted[_idx / 64] & bit(_idx); }
+
+    std::vector<Vote> m_votes;
+    std::vector<uint64_t> m_voted;
+    size_t m_size = 0;
+};
+
 class PBFTReqCache : public std::enable_shared_from_this<PBFTReqCache>
 {
 public:
@@ -47,13 +123,13 @@ public:
     /// specified SignReq exists in the sign-cache or not?
     inline bool isExistSign(SignReq const& req)
     {
-        return cacheExists(m_signCache, req.block_hash, req.sig.hex());
+        return voteExists(m_signCache, req);
     }
 
     /// specified commitReq exists in the commit-cache or not?
     inline bool isExistCommit(CommitReq const& req)
     {
-        return cacheExists(m_commitCache, req.block_hash, req.sig.hex());
+        return voteExists(m_commitCache, req);
     }
 
     /// specified viewchangeReq exists in the viewchang-cache or not?
@@ -124,12 +200,9 @@ public:
         removeInvalidCommitCache(req.block_hash, req.view);
     }
     /// add specified signReq to the sign-cache
-    inline void addSignReq(SignReq const& req) { m_signCache[req.block_hash][req.sig.hex()] = req; }
+    inline void addSignReq(SignReq const& req) { m_signCache[req.block_hash].add(req); }
     /// add specified commit cache to the commit-cache
-    inline void addCommitReq(CommitReq const& req)
-    {
-        m_commitCache[req.block_hash][req.sig.hex()] = req;
-    }
+    inline void addCommitReq(CommitReq const& req) { m_commitCache[req.block_hash].add(req); }
     /// add specified viewchange cache to the viewchange-cache
     inline void addViewChangeReq(ViewChangeReq const& req)
     {
@@ -157,10 +230,10 @@ public:
         // m_recvViewChangeReq[req.view][req.idx] = req;
     }
 
-    template <typename T, typename S>
-    inline void addReq(T const& req, S& cache)
+    template <typename T>
+    inline void addReq(T const& req, std::unordered_map<h256, VoteCache>& cache)
     {
-        cache[req.block_hash][req.sig.hex()] = req;
+        cache[req.block_hash].add(req);
     }
 
     /// add future-prepare cache
@@ -249,14 +322,8 @@ public:
         }
     }
     /// complemented functions for UTs
-    std::unordered_map<h256, std::unordered_map<std::string, SignReq>>& mutableSignCache()
-    {
-        return m_signCache;
-    }
-    std::unordered_map<h256, std::unordered_map<std::string, CommitReq>>& mutableCommitCache()
-    {
-        return m_commitCache;
-    }
+    std::unordered_map<h256, VoteCache>& mutableSignCache() { return m_signCache; }
+    std::unordered_map<h256, VoteCache>& mutableCommitCache() { return m_commitCache; }
     std::unordered_map<VIEWTYPE, std::unordered_map<IDXTYPE, ViewChangeReq>>&
     mutableViewChangeCache()
     {
@@ -291,6 +358,24 @@ private:
         }
     }
 
+    void inline removeInvalidEntryFromCache(dev::eth::BlockHeader const& highestBlockHeader,
+        std::unordered_map<h256, VoteCache>& cache)
+    {
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            /// delete expired requests, and those of a faked block hash
+            it->second.eraseIf([&](VoteCache::Vote const& vote) {
+                return vote.height < highestBlockHeader.number() ||
+                       (vote.height == highestBlockHeader.number() &&
+                           it->first != highestBlockHeader.hash());
+            });
+            if (it->second.size() == 0)
+                it = cache.erase(it);
+            else
+                it++;
+        }
+    }
+
     inline void removeInvalidViewChange(VIEWTYPE const& curView)
     {
         for (auto it = m_recvViewChangeReq.begin(); it != m_recvViewChangeReq.end();)
@@ -315,6 +400,12 @@ private:
         return (it->second.find(key)) != (it->second.end());
     }
 
+    inline bool voteExists(std::unordered_map<h256, VoteCache> const& cache, PBFTMsg const& req)
+    {
+        auto it = cache.find(req.block_hash);
+        return it != cache.end() && it->second.exists(req);
+    }
+
     /// get the status of specified cache into the json object
     /// (maily for prepareCache, m_committedPrepareCache, m_futurePrepareCache and rawPrepareCache)
     template <typename T>
@@ -352,11 +443,11 @@ private:
     /// cache for raw prepare request
     PrepareReq m_rawPrepareCache;
     /// cache for signReq(maps between hash and sign requests)
-    std::unordered_map<h256, std::unordered_map<std::string, SignReq>> m_signCache;
+    std::unordered_map<h256, VoteCache> m_signCache;
     /// cache for received-viewChange requests(maps between view and view change requests)
     std::unordered_map<VIEWTYPE, std::unordered_map<IDXTYPE, ViewChangeReq>> m_recvViewChangeReq;
     /// cache for commited requests(maps between hash and commited requests)
-    std::unordered_map<h256, std::unordered_map<std::string, CommitReq>> m_commitCache;
+    std::unordered_map<h256, VoteCache> m_commitCache;
     /// cache for prepare request need to be backup and saved
     PrepareReq m_committedPrepareCache;
     /// cache for the future prepare cache
@@ -28,6 +28,7 @@
  */
 #include "PBFTSealer.h"
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/CommonJS.h>
 using namespace dev::eth;
@@ -52,11 +53,17 @@ void PBFTSealer::handleBlock()
             << LOG_KV("maxTransactionLimit", m_pbftEngine->maxBlockTransactions());
         resetSealingBlock();
         /// notify to re-generate the block
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
         return;
     }
+    if (m_maxTxsPerCritical > 0)
+    {
+        deferConflictingTransactions();
+    }
+    BlockSpan span("pbft.handleBlock", m_pbftEngine->groupId(),
+        m_sealing.block.blockHeader().number());
     setBlock();
+    span.setBlock(m_sealing.block.header().number(), m_sealing.block.header().hash());
     PBFTSEALER_LOG(INFO) << LOG_DESC("++++++++++++++++ Generating seal on")
                          << LOG_KV("blkNum", m_sealing.block.header().number())
                          << LOG_KV("tx", m_sealing.block.getTransactionSize())
@@ -66,14 +73,67 @@ void PBFTSealer::handleBlock()
     if (m_pbftEngine->shouldReset(m_sealing.block))
     {
         resetSealingBlock();
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
 }
+/// the transactions of a critical field are a chain of the DAG, keeping the chains short keeps the
+/// DAG wide. The deferred transactions stay in the pool and the avoid set of this block
+void PBFTSealer::deferConflictingTransactions()
+{
+    auto const& txs = m_sealing.block.transactions();
+    auto parent = m_blockChain->getBlockByNumber(m_blockChain->number())->header();
+    auto criticals = m_blockVerifier->getTxsCriticals(
+        txs, dev::blockverifier::BlockInfo{parent.hash(), parent.number(), parent.stateRoot()});
+    if (criticals.size() != txs.size())
+    {
+        return;
+    }
+    std::unordered_map<std::string, uint64_t> txsPerCritical;
+    Transactions packed;
+    for (size_t i = 0; i < txs.size(); ++i)
+    {
+        /// the transactions without parallel tags are executed serially anyway
+        if (criticals[i])
+        {
+            bool full = false;
+            for (auto const& critical : *criticals[i])
+            {
+                auto it = txsPerCritical.find(critical);
+                full = full || (it != txsPerCritical.end() && it->second >= m_maxTxsPerCritical);
+            }
+            if (full)
+            {
+                continue;
+            }
+            for (auto const& critical : *criticals[i])
+            {
+                txsPerCritical[critical]++;
+            }
+        }
+        packed.push_back(txs[i]);
+    }
+    if (packed.size() < txs.size())
+    {
+        PBFTSEALER_LOG(DEBUG) << LOG_DESC("defer the conflicting transactions to the next block")
+                              << LOG_KV("blkNum", m_sealing.block.blockHeader().number())
+                              << LOG_KV("tx", txs.size()) << LOG_KV("deferred",
+                                                                 txs.size() - packed.size());
+        m_sealing.block.setTransactions(packed);
+    }
+}
+
 void PBFTSealer::setBlock()
 {
-    m_sealing.block.header().populateFromParent(
-        m_blockChain->getBlockByNumber(m_blockChain->number())->header());
+    /// the parent of a pipelined block is committed but not saved yet
+    if (m_sealing.block.blockHeader().number() == (m_blockChain->number() + 2))
+    {
+        m_sealing.block.header().populateFromParent(m_pbftEngine->pipelineParent());
+    }
+    else
+    {
+        m_sealing.block.header().populateFromParent(
+            m_blockChain->getBlockByNumber(m_blockChain->number())->header());
+    }
     resetSealingHeader(m_sealing.block.header());
     m_sealing.block.calTransactionRoot();
 }
@@ -87,6 +147,37 @@ bool PBFTSealer::shouldSeal()
 {
     return Sealer::shouldSeal() && m_pbftEngine->shouldSeal();
 }
+void PBFTSealer::preloadTransactions()
+{
+    if (m_preloading)
+        return;
+    h256Hash avoid;
+    {
+        ReadGuard l(x_sealing);
+        auto number = m_sealing.block.blockHeader().number();
+        if (!m_sealing.block.isSealed() || number == m_preloadedNumber)
+            return;
+        m_preloadedNumber = number;
+        avoid = m_sealing.m_transactionSet;
+    }
+    /// the rows the sealed block changes are updated in the cache by its commit, the others are
+    /// read on the latest saved state
+    auto parentBlock = m_blockChain->getBlockByNumber(m_blockChain->number());
+    if (!parentBlock)
+        return;
+    auto const& parent = parentBlock->header();
+    BlockInfo parentInfo{parent.hash(), parent.number(), parent.stateRoot()};
+    auto txPool = m_txPool;
+    auto blockVerifier = m_blockVerifier;
+    auto limit = maxBlockCanSeal();
+    m_preloading = true;
+    m_preloadPool.enqueue([this, txPool, blockVerifier, parentInfo, avoid, limit]() mutable {
+        auto txs = txPool->topTransactions(limit, avoid);
+        blockVerifier->preloadTransactions(txs, parentInfo);
+        m_preloading = false;
+    });
+}
+
 void PBFTSealer::start()
 {
     if (m_enableDynamicBlockSize)
@@ -189,6 +280,14 @@ void PBFTSealer::onCommitBlock(
         return;
     }
     m_lastBlockNumber = m_blockChain->number();
+    /// the controller sizes the block to the target latency
+    if (m_pbftEngine->blockSizeController().enabled())
+    {
+        WriteGuard l(x_maxBlockCanSeal);
+        m_maxBlockCanSeal =
+            m_pbftEngine->blockSizeController().maxBlockTxs(m_pbftEngine->maxBlockTransactions());
+        return;
+    }
     /// sealing more transactions when no timeout
     if (m_timeoutCount > 0)
     {
@@ -30,6 +30,7 @@
 #pragma once
 #include "PBFTEngine.h"
 #include <libconsensus/Sealer.h>
+#include <libdevcore/ThreadPool.h>
 #include <sstream>
 namespace dev
 {
@@ -45,7 +46,7 @@ public:
         std::shared_ptr<dev::blockverifier::BlockVerifierInterface> _blockVerifier,
         dev::PROTOCOL_ID const& _protocolId, std::string const& _baseDir, KeyPair const& _key_pair,
         h512s const& _sealerList = h512s())
-      : Sealer(_txPool, _blockChain, _blockSync)
+      : Sealer(_txPool, _blockChain, _blockSync), m_blockVerifier(_blockVerifier)
     {
         m_consensusEngine = std::make_shared<PBFTEngine>(_service, _txPool, _blockChain, _blockSync,
             _blockVerifier, _protocolId, _baseDir, _key_pair, _sealerList);
@@ -76,6 +77,12 @@ public:
         m_enableDynamicBlockSize = enableDynamicBlockSize;
     }
 
+    /// the most transactions of a block sharing a critical field, 0 for no limit
+    void setMaxTxsPerCritical(uint64_t _maxTxsPerCritical)
+    {
+        m_maxTxsPerCritical = _maxTxsPerCritical;
+    }
+
     void setBlockSizeIncreaseRatio(bool blockSizeIncreaseRatio)
     {
         m_blockSizeIncreaseRatio = blockSizeIncreaseRatio;
@@ -84,9 +91,18 @@ public:
 protected:
     void handleBlock() override;
     bool shouldSeal() override;
+    /// read the state of the top transactions of the pool, once a sealed block, off the sealing
+    /// thread
+    void preloadTransactions() override;
     // only the leader can generate the latest block
     bool shouldHandleBlock() override
     {
+        /// the next leader proposes ahead while the current block is in its commit phase
+        if (m_sealing.block.blockHeader().number() == (m_blockChain->number() + 2) &&
+            m_pbftEngine->canPipelineSeal())
+        {
+            return true;
+        }
         return m_sealing.block.blockHeader().number() == (m_blockChain->number() + 1) &&
                (m_pbftEngine->getLeader().first &&
                    m_pbftEngine->getLeader().second == m_pbftEngine->nodeIdx());
@@ -137,8 +153,7 @@ private:
                                   << LOG_KV("curNum", m_blockChain->number());
             resetSealingBlock();
         }
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
 
     /// reset block for the next leader
@@ -151,11 +166,13 @@ private:
                                   << LOG_KV("curNum", m_blockChain->number());
             resetSealingBlock(filter, true);
         }
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
 
 protected:
+    /// leave the transactions over m_maxTxsPerCritical on a critical field to the next block
+    void deferConflictingTransactions();
+
     std::shared_ptr<PBFTEngine> m_pbftEngine;
     /// the minimum number of transactions that caused timeout
     uint64_t m_lastTimeoutTx = 0;
@@ -166,6 +183,13 @@ protected:
     uint64_t m_lastBlockNumber = 0;
     bool m_enableDynamicBlockSize = true;
     float m_blockSizeIncreaseRatio = 0.5;
+    std::shared_ptr<dev::blockverifier::BlockVerifierInterface> m_blockVerifier;
+    uint64_t m_maxTxsPerCritical = 0;
+    /// the sealed block whose next block has been preloaded
+    int64_t m_preloadedNumber = -1;
+    std::atomic_bool m_preloading = {false};
+    /// destroyed first, the running preload is waited for
+    dev::ThreadPool m_preloadPool{"preload", 1};
 };
 }  // namespace consensus
 }  // namespace dev
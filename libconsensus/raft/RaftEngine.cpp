@@ -349,7 +349,8 @@ void RaftEngine::tryCommitUncommitedBlock(RaftHeartBeatResp& _resp)
             }
             else
             {
-                if (_resp.uncommitedBlockHash == h256())
+                /// a follower answering a heartbeat without the block acks nothing
+                if (_resp.uncommitedBlockHash == h256() && m_nodeNum == 1)
                 {
                     // I'm the only one in sealer list, commit block without any ack
                     if (m_waitingForCommitting)
@@ -808,7 +809,7 @@ bool RaftEngine::checkHeartbeatTimeout()
     return interval >= m_heartbeatTimeout;
 }
 
-P2PMessage::Ptr RaftEngine::generateHeartbeat()
+P2PMessage::Ptr RaftEngine::generateHeartbeat(bool _withBlock)
 {
     RaftHeartBeat hb;
     hb.idx = m_idx;
@@ -818,7 +819,7 @@ P2PMessage::Ptr RaftEngine::generateHeartbeat()
     hb.leader = m_idx;
     {
         Guard guard(m_commitMutex);
-        if (bool(m_uncommittedBlock))
+        if (bool(m_uncommittedBlock) && _withBlock)
         {
             m_uncommittedBlock.encode(hb.uncommitedBlock);
             hb.uncommitedBlockNumber = m_consensusBlockNumber;
@@ -852,11 +853,42 @@ void RaftEngine::broadcastHeartbeat()
     auto interval =
         std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - m_lastHeartbeatTime)
             .count();
-    if (interval >= m_heartbeatInterval)
+    /// the uncommitted block is appended at once instead of waiting for the next heartbeat
+    bool appendPending = m_appendPending.exchange(false);
+    if (interval >= m_heartbeatInterval || appendPending)
     {
         m_lastHeartbeatTime = nowTime;
         auto heartbeatMsg = generateHeartbeat();
-        broadcastMsg(heartbeatMsg);
+        /// the followers acked the uncommitted block get the heartbeat without it
+        std::unordered_set<IDXTYPE> acked;
+        {
+            Guard guard(m_commitMutex);
+            auto iter = m_commitFingerPrint.find(m_uncommittedBlock.header().hash());
+            if (bool(m_uncommittedBlock) && iter != m_commitFingerPrint.end())
+            {
+                acked = iter->second;
+            }
+        }
+        if (acked.size() > 1)
+        {
+            auto lightMsg = generateHeartbeat(false);
+            auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
+            m_connectedNode = sessions.size();
+            for (auto const& session : sessions)
+            {
+                auto index = getIndexBySealer(session.nodeID());
+                if (index < 0)
+                {
+                    continue;
+                }
+                m_service->asyncSendMessageByNodeID(session.nodeID(),
+                    acked.count((IDXTYPE)index) ? lightMsg : heartbeatMsg, nullptr);
+            }
+        }
+        else
+        {
+            broadcastMsg(heartbeatMsg);
+        }
         clearFirstVoteCache();
         RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#broadcastHeartbeat]Heartbeat broadcasted");
     }
@@ -1442,6 +1474,7 @@ bool RaftEngine::commit(Block const& _block)
     m_uncommittedBlockNumber = m_consensusBlockNumber;
     m_waitingForCommitting = true;
     m_commitReady = false;
+    m_appendPending = true;
     RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#commit]Wait to commit block")
                           << LOG_KV("nextHeight", m_uncommittedBlockNumber);
     m_commitCV.wait(ul, [this]() { return m_commitReady; });
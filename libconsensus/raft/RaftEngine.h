@@ -98,6 +98,12 @@ public:
         return m_lastLeaderTerm;
     }
 
+    RaftRole getState() const
+    {
+        Guard l(m_mutex);
+        return m_state;
+    }
+
     void start() override;
     void reportBlock(dev::eth::Block const& _block) override;
     bool shouldSeal();
@@ -123,7 +129,7 @@ protected:
     bool isMajorityVote(u256 const& _votes) { return _votes >= m_nodeNum - m_f; }
 
     dev::p2p::P2PMessage::Ptr generateVoteReq();
-    dev::p2p::P2PMessage::Ptr generateHeartbeat();
+    dev::p2p::P2PMessage::Ptr generateHeartbeat(bool _withBlock = true);
 
     void broadcastVoteReq();
     void broadcastHeartbeat();
@@ -155,12 +161,6 @@ protected:
     dev::p2p::P2PMessage::Ptr transDataToMessage(
         bytesConstRef data, RaftPacketType const& packetType, PROTOCOL_ID const& protocolId);
 
-    RaftRole getState() const
-    {
-        Guard l(m_mutex);
-        return m_state;
-    }
-
     void setLeader(raft::NodeIndex const& _leader)
     {
         Guard l(m_mutex);
@@ -237,6 +237,8 @@ protected:
     bool m_commitReady;
     bool m_waitingForCommitting;
     std::unordered_map<h256, std::unordered_set<dev::consensus::IDXTYPE>> m_commitFingerPrint;
+    /// a new uncommitted block waits to be sent to the followers
+    std::atomic_bool m_appendPending = {false};
 
 private:
     static typename raft::NodeIndex InvalidIndex;
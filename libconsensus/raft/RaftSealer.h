@@ -60,8 +60,7 @@ protected:
     void reset()
     {
         resetSealingBlock();
-        m_signalled.notify_all();
-        m_blockSignalled.notify_all();
+        notifyWork();
     }
 
     bool reachBlockIntervalTime() override;
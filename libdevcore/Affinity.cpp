@@ -0,0 +1,312 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Affinity.cpp
+ *  @brief the cores the threads of the node are bound to, by the names of the threads
+ */
+#include "Affinity.h"
+#include "Exceptions.h"
+#include "easylog.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <thread>
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define AFFINITY_LOG(LEVEL) LOG(LEVEL) << LOG_BADGE("CPUAffinity")
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+unsigned hardwareCores()
+{
+    return max<unsigned>(thread::hardware_concurrency(), 1);
+}
+
+string coreList(vector<unsigned> const& _cores)
+{
+    string cores;
+    for (auto core : _cores)
+    {
+        cores += (cores.empty() ? "" : ",") + to_string(core);
+    }
+    return cores;
+}
+
+bool isStorageThread(string const& _name)
+{
+    return boost::starts_with(_name, "rocksdb") || _name == "CacheClear";
+}
+}  // namespace
+
+CPUAffinity& CPUAffinity::instance()
+{
+    // never destroyed, the detached thread rebinding the storage threads may outlive main
+    static CPUAffinity* s_affinity = new CPUAffinity();
+    return *s_affinity;
+}
+
+vector<unsigned> CPUAffinity::parseCores(string const& _cores)
+{
+    set<unsigned> cores;
+    vector<string> ranges;
+    boost::split(ranges, _cores, boost::is_any_of(","));
+    for (auto range : ranges)
+    {
+        boost::trim(range);
+        if (range.empty())
+        {
+            continue;
+        }
+        try
+        {
+            unsigned first = 0;
+            unsigned last = 0;
+            auto dash = range.find('-');
+            if (dash == string::npos)
+            {
+                first = last = boost::lexical_cast<unsigned>(range);
+            }
+            else
+            {
+                first = boost::lexical_cast<unsigned>(boost::trim_copy(range.substr(0, dash)));
+                last = boost::lexical_cast<unsigned>(boost::trim_copy(range.substr(dash + 1)));
+            }
+            if (first > last || last >= hardwareCores())
+            {
+                BOOST_THROW_EXCEPTION(InvalidCoreList() << errinfo_comment(
+                                          _cores + ": the cores are 0-" +
+                                          to_string(hardwareCores() - 1)));
+            }
+            for (auto core = first; core <= last; ++core)
+            {
+                cores.insert(core);
+            }
+        }
+        catch (boost::bad_lexical_cast const&)
+        {
+            BOOST_THROW_EXCEPTION(InvalidCoreList() << errinfo_comment(_cores));
+        }
+    }
+    return vector<unsigned>(cores.begin(), cores.end());
+}
+
+void CPUAffinity::configure(map<int, vector<unsigned>> const& _groupCores,
+    vector<unsigned> const& _networkCores, vector<unsigned> const& _storageCores)
+{
+    bool rebind = false;
+    {
+        WriteGuard l(x_cores);
+        m_groupCores.clear();
+        for (auto const& it : _groupCores)
+        {
+            if (!it.second.empty())
+            {
+                m_groupCores.insert(it);
+            }
+        }
+        m_networkCores = _networkCores;
+        m_storageCores = _storageCores;
+        m_freeCores.clear();
+        if (m_groupCores.empty() && m_networkCores.empty() && m_storageCores.empty())
+        {
+            AFFINITY_LOG(INFO) << LOG_DESC("no cores reserved");
+            return;
+        }
+
+        set<unsigned> reserved(m_networkCores.begin(), m_networkCores.end());
+        for (auto const& it : m_groupCores)
+        {
+            reserved.insert(it.second.begin(), it.second.end());
+        }
+        for (unsigned core = 0; core < hardwareCores(); ++core)
+        {
+            if (!reserved.count(core))
+            {
+                m_freeCores.push_back(core);
+            }
+        }
+        if (m_freeCores.empty())
+        {
+            // nothing left to the other threads, they share the reserved cores then
+            AFFINITY_LOG(WARNING) << LOG_DESC("all cores reserved, the other threads take all");
+            for (unsigned core = 0; core < hardwareCores(); ++core)
+            {
+                m_freeCores.push_back(core);
+            }
+        }
+        for (auto const& it : m_groupCores)
+        {
+            AFFINITY_LOG(INFO) << LOG_DESC("group cores") << LOG_KV("groupID", it.first)
+                               << LOG_KV("cores", coreList(it.second));
+        }
+        AFFINITY_LOG(INFO) << LOG_DESC("configure")
+                           << LOG_KV("networkCores", coreList(m_networkCores))
+                           << LOG_KV("storageCores", coreList(m_storageCores))
+                           << LOG_KV("freeCores", coreList(m_freeCores));
+        rebind = !m_storageCores.empty() && !m_rebinding;
+        m_rebinding = m_rebinding || rebind;
+    }
+
+    bindThread(freeCores());
+    if (rebind)
+    {
+        // rocksdb starts its background threads on demand, from any thread writing to it
+        thread([this]() {
+            pthread_setThreadName("Affinity");
+            while (true)
+            {
+                this_thread::sleep_for(chrono::seconds(c_storageRebindSeconds));
+                bindStorageThreads();
+            }
+        }).detach();
+    }
+}
+
+bool CPUAffinity::enabled() const
+{
+    ReadGuard l(x_cores);
+    return !m_freeCores.empty();
+}
+
+vector<unsigned> CPUAffinity::groupCores(int _groupID) const
+{
+    ReadGuard l(x_cores);
+    auto it = m_groupCores.find(_groupID);
+    return it != m_groupCores.end() ? it->second : vector<unsigned>();
+}
+
+vector<unsigned> CPUAffinity::networkCores() const
+{
+    ReadGuard l(x_cores);
+    return m_networkCores;
+}
+
+vector<unsigned> CPUAffinity::storageCores() const
+{
+    ReadGuard l(x_cores);
+    return m_storageCores.empty() ? m_freeCores : m_storageCores;
+}
+
+vector<unsigned> CPUAffinity::freeCores() const
+{
+    ReadGuard l(x_cores);
+    return m_freeCores;
+}
+
+vector<unsigned> CPUAffinity::coresOf(string const& _name) const
+{
+    if (_name == "io_service" || _name == "io_session")
+    {
+        return networkCores();
+    }
+    if (isStorageThread(_name))
+    {
+        return storageCores();
+    }
+    // the workers of a group are named <module>-<group>
+    auto dash = _name.rfind('-');
+    if (dash != string::npos && dash + 1 < _name.size() &&
+        all_of(_name.begin() + dash + 1, _name.end(), [](char _c) { return isdigit(_c); }))
+    {
+        try
+        {
+            return groupCores(boost::lexical_cast<int>(_name.substr(dash + 1)));
+        }
+        catch (boost::bad_lexical_cast const&)
+        {
+        }
+    }
+    return vector<unsigned>();
+}
+
+bool CPUAffinity::bindThread(string const& _name)
+{
+    auto cores = coresOf(_name);
+    if (cores.empty())
+    {
+        return false;
+    }
+    AFFINITY_LOG(DEBUG) << LOG_DESC("bindThread") << LOG_KV("name", _name)
+                        << LOG_KV("cores", coreList(cores));
+    return bindThread(cores);
+}
+
+bool CPUAffinity::bindThread(vector<unsigned> const& _cores, int _tid)
+{
+#if defined(__linux__)
+    if (_cores.empty())
+    {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto core : _cores)
+    {
+        CPU_SET(core, &cpus);
+    }
+    if (_tid == 0)
+    {
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+    }
+    return sched_setaffinity(_tid, sizeof(cpus), &cpus) == 0;
+#else
+    (void)_cores;
+    (void)_tid;
+    return false;
+#endif
+}
+
+size_t CPUAffinity::bindStorageThreads()
+{
+    size_t bound = 0;
+#if defined(__linux__)
+    auto cores = storageCores();
+    if (cores.empty())
+    {
+        return 0;
+    }
+    DIR* tasks = opendir("/proc/self/task");
+    if (!tasks)
+    {
+        return 0;
+    }
+    while (auto task = readdir(tasks))
+    {
+        if (!isdigit(task->d_name[0]))
+        {
+            continue;
+        }
+        string name;
+        ifstream comm(string("/proc/self/task/") + task->d_name + "/comm");
+        if (getline(comm, name) && isStorageThread(name) && bindThread(cores, atoi(task->d_name)))
+        {
+            ++bound;
+        }
+    }
+    closedir(tasks);
+#endif
+    return bound;
+}
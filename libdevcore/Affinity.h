@@ -0,0 +1,83 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Affinity.h
+ *  @brief the cores the threads of the node are bound to, by the names of the threads
+ */
+#pragma once
+
+#include "Guards.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+/// seconds between two bindings of the storage threads started meanwhile
+static const unsigned c_storageRebindSeconds = 10;
+
+/**
+ * @brief The cores reserved for the threads of each group, named <module>-<group> as PBFT-1,
+ * PBFTSeal-1 or Sync-1, and for its execution arena, the cores reserved for the network I/O
+ * threads, and the cores of the storage background threads, the rocksdb and the cache clear
+ * threads, the free cores by default. The free cores are those reserved for neither a group nor
+ * the network, where the other threads, the workers of the Executor among them, run. Nothing is
+ * bound without a reservation. Only on linux.
+ */
+class CPUAffinity
+{
+public:
+    static CPUAffinity& instance();
+
+    /// "0-3,6" as {0, 1, 2, 3, 6}, empty for "", throws InvalidCoreList for a core beyond the
+    /// cores of the machine or a malformed list
+    static std::vector<unsigned> parseCores(std::string const& _cores);
+
+    /// called once before the groups are started: binds the calling thread, whose later threads
+    /// inherit it, to the free cores, and rebinds the storage threads periodically if they have
+    /// cores of their own
+    void configure(std::map<int, std::vector<unsigned>> const& _groupCores,
+        std::vector<unsigned> const& _networkCores, std::vector<unsigned> const& _storageCores);
+    bool enabled() const;
+
+    std::vector<unsigned> groupCores(int _groupID) const;
+    std::vector<unsigned> networkCores() const;
+    std::vector<unsigned> storageCores() const;
+    std::vector<unsigned> freeCores() const;
+    /// the cores of the thread named _name, empty if it isn't bound
+    std::vector<unsigned> coresOf(std::string const& _name) const;
+
+    /// bind the calling thread to the cores of the thread named _name, false if there are none
+    bool bindThread(std::string const& _name);
+    /// bind the thread _tid, 0 for the calling one, to _cores
+    static bool bindThread(std::vector<unsigned> const& _cores, int _tid = 0);
+    /// bind the storage threads of the process, found by their names, to the storage cores,
+    /// return the threads bound
+    size_t bindStorageThreads();
+
+private:
+    CPUAffinity() = default;
+
+    mutable SharedMutex x_cores;
+    std::map<int, std::vector<unsigned>> m_groupCores;
+    std::vector<unsigned> m_networkCores;
+    std::vector<unsigned> m_storageCores;
+    std::vector<unsigned> m_freeCores;
+    bool m_rebinding = false;
+};
+}  // namespace dev
+
+#define g_cpuAffinity dev::CPUAffinity::instance()
@@ -0,0 +1,247 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Allocator.cpp
+ *  @brief the allocator chosen by the ALLOCATOR build option, its stats, and the transparent huge
+ *  pages of the long-lived caches
+ */
+#include "Allocator.h"
+#include "Metrics.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#if defined(FISCO_ALLOCATOR_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(FISCO_ALLOCATOR_TCMALLOC)
+#include <gperftools/malloc_extension.h>
+#elif defined(FISCO_ALLOCATOR_MIMALLOC)
+#include <mimalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace dev;
+
+#if defined(FISCO_ALLOCATOR_JEMALLOC)
+/// the pages freed are returned by a background thread instead of the threads freeing, and the
+/// metadata of the allocator takes huge pages when the kernel uses them, MALLOC_CONF overrides it
+extern "C" char const* malloc_conf = "background_thread:true,metadata_thp:auto";
+#endif
+
+namespace
+{
+std::atomic<bool> s_cacheHugePages = {false};
+
+Counter& hugePageBytes()
+{
+    static Counter& bytes = g_metrics.counter("bcos_allocator_huge_page_advised_bytes",
+        "the bytes advised to transparent huge pages since the start");
+    return bytes;
+}
+
+#if defined(FISCO_ALLOCATOR_JEMALLOC)
+uint64_t jemallocStat(char const* _name)
+{
+    size_t value = 0;
+    size_t size = sizeof(value);
+    return mallctl(_name, &value, &size, nullptr, 0) == 0 ? value : 0;
+}
+#elif defined(FISCO_ALLOCATOR_TCMALLOC)
+uint64_t tcmallocStat(char const* _name)
+{
+    size_t value = 0;
+    return MallocExtension::instance()->GetNumericProperty(_name, &value) ? value : 0;
+}
+#endif
+}  // namespace
+
+char const* dev::allocatorName()
+{
+#if defined(FISCO_ALLOCATOR_JEMALLOC)
+    return "jemalloc";
+#elif defined(FISCO_ALLOCATOR_TCMALLOC)
+    return "tcmalloc";
+#elif defined(FISCO_ALLOCATOR_MIMALLOC)
+    return "mimalloc";
+#else
+    return "system";
+#endif
+}
+
+AllocatorStats dev::allocatorStats()
+{
+    AllocatorStats stats;
+#if defined(FISCO_ALLOCATOR_JEMALLOC)
+    // the stats are a snapshot refreshed by advancing the epoch
+    uint64_t epoch = 1;
+    size_t size = sizeof(epoch);
+    mallctl("epoch", &epoch, &size, &epoch, size);
+    stats.allocated = jemallocStat("stats.allocated");
+    stats.active = jemallocStat("stats.active");
+    stats.resident = jemallocStat("stats.resident");
+    stats.mapped = jemallocStat("stats.mapped");
+#elif defined(FISCO_ALLOCATOR_TCMALLOC)
+    auto heap = tcmallocStat("generic.heap_size");
+    auto unmapped = tcmallocStat("tcmalloc.pageheap_unmapped_bytes");
+    stats.allocated = tcmallocStat("generic.current_allocated_bytes");
+    stats.active = heap - tcmallocStat("tcmalloc.pageheap_free_bytes") - unmapped;
+    stats.resident = heap - unmapped;
+    stats.mapped = heap;
+#elif defined(FISCO_ALLOCATOR_MIMALLOC)
+    // mimalloc tells the memory committed, not the bytes allocated in it
+    size_t elapsed, user, system, resident, peakResident, committed, peakCommitted, faults;
+    mi_process_info(&elapsed, &user, &system, &resident, &peakResident, &committed,
+        &peakCommitted, &faults);
+    stats.active = committed;
+    stats.resident = resident;
+    stats.mapped = committed;
+#elif defined(__GLIBC__)
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    auto info = mallinfo2();
+#else
+    auto info = mallinfo();
+#endif
+    stats.allocated = (uint64_t)info.uordblks + (uint64_t)info.hblkhd;
+    stats.mapped = (uint64_t)info.arena + (uint64_t)info.hblkhd;
+    stats.resident = processResidentBytes();
+#else
+    stats.resident = processResidentBytes();
+#endif
+    return stats;
+}
+
+void dev::updateAllocatorMetrics()
+{
+    MetricsRegistry::Labels labels = {{"allocator", allocatorName()}};
+    static Gauge& allocated = g_metrics.gauge(
+        "bcos_allocator_allocated_bytes", "the bytes allocated by the process", labels);
+    static Gauge& active = g_metrics.gauge("bcos_allocator_active_bytes",
+        "the bytes of the pages holding allocations, fragmentation included", labels);
+    static Gauge& resident = g_metrics.gauge("bcos_allocator_resident_bytes",
+        "the bytes of physical memory the allocator holds", labels);
+    static Gauge& mapped = g_metrics.gauge(
+        "bcos_allocator_mapped_bytes", "the bytes of address space the allocator mapped", labels);
+    auto stats = allocatorStats();
+    allocated.set(stats.allocated);
+    active.set(stats.active);
+    resident.set(stats.resident);
+    mapped.set(stats.mapped);
+}
+
+uint64_t dev::processResidentBytes()
+{
+#if defined(__linux__)
+    uint64_t pages = 0;
+    uint64_t resident = 0;
+    ifstream statm("/proc/self/statm");
+    if (statm >> pages >> resident)
+    {
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+uint64_t dev::processMemoryLimit()
+{
+    uint64_t limit = 0;
+#if defined(__linux__)
+    auto pages = sysconf(_SC_PHYS_PAGES);
+    if (pages > 0)
+    {
+        limit = (uint64_t)pages * sysconf(_SC_PAGESIZE);
+    }
+    // v2 writes "max" without a limit, v1 a number beyond the physical memory
+    for (auto path : {"/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory/memory.limit_in_bytes"})
+    {
+        uint64_t cgroupLimit = 0;
+        ifstream file(path);
+        if (file >> cgroupLimit && cgroupLimit > 0 && (limit == 0 || cgroupLimit < limit))
+        {
+            limit = cgroupLimit;
+        }
+    }
+#endif
+    return limit;
+}
+
+void dev::setCacheHugePages(bool _enable)
+{
+    s_cacheHugePages = _enable;
+}
+
+bool dev::cacheHugePages()
+{
+    return s_cacheHugePages;
+}
+
+size_t dev::adviseHugePages(void const* _data, size_t _size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (!s_cacheHugePages || !_data)
+    {
+        return 0;
+    }
+    auto begin = ((uintptr_t)_data + c_hugePageSize - 1) & ~(uintptr_t)(c_hugePageSize - 1);
+    auto end = ((uintptr_t)_data + _size) & ~(uintptr_t)(c_hugePageSize - 1);
+    if (begin >= end || madvise((void*)begin, end - begin, MADV_HUGEPAGE) != 0)
+    {
+        return 0;
+    }
+    hugePageBytes().inc(end - begin);
+    return end - begin;
+#else
+    (void)_data;
+    (void)_size;
+    return 0;
+#endif
+}
+
+void* dev::allocateHugePages(size_t _bytes)
+{
+    if (_bytes < c_hugePageSize / 2)
+    {
+        return ::operator new(_bytes);
+    }
+    // freed by free() whether advised or not, the flag may change meanwhile
+    bool huge = s_cacheHugePages;
+    size_t bytes = huge ? (_bytes + c_hugePageSize - 1) & ~(c_hugePageSize - 1) : _bytes;
+    void* p = nullptr;
+    if (posix_memalign(&p, huge ? c_hugePageSize : 64, bytes) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    if (huge)
+    {
+        adviseHugePages(p, bytes);
+    }
+    return p;
+}
+
+void dev::deallocateHugePages(void* _p, size_t _bytes)
+{
+    if (_bytes < c_hugePageSize / 2)
+    {
+        ::operator delete(_p);
+        return;
+    }
+    free(_p);
+}
@@ -0,0 +1,105 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Allocator.h
+ *  @brief the allocator chosen by the ALLOCATOR build option, its stats, and the transparent huge
+ *  pages of the long-lived caches
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace dev
+{
+/// system, jemalloc, tcmalloc or mimalloc
+char const* allocatorName();
+
+struct AllocatorStats
+{
+    /// the bytes allocated by the process
+    uint64_t allocated = 0;
+    /// the bytes of the pages holding allocations, allocated and fragmented
+    uint64_t active = 0;
+    /// the bytes of physical memory the allocator holds
+    uint64_t resident = 0;
+    /// the bytes of address space the allocator mapped
+    uint64_t mapped = 0;
+};
+/// 0 for the stats the allocator doesn't report
+AllocatorStats allocatorStats();
+/// set the bcos_allocator_* gauges to the current stats, called on each scrape of the metrics
+void updateAllocatorMetrics();
+
+/// the resident set of the process, 0 where it isn't known
+uint64_t processResidentBytes();
+/// the memory the process may take, the least of the physical memory and the limits of the
+/// cgroup v1 or v2 it runs in, 0 where it isn't known
+uint64_t processMemoryLimit();
+
+/// the size of a transparent huge page
+static const size_t c_hugePageSize = 2 * 1024 * 1024;
+
+/// whether the caches ask for transparent huge pages, off by default
+void setCacheHugePages(bool _enable);
+bool cacheHugePages();
+
+/// advise the kernel to back the huge pages lying entirely in [_data, _data + _size) with
+/// transparent huge pages if cacheHugePages(), returns the bytes advised
+size_t adviseHugePages(void const* _data, size_t _size);
+
+/// From half a huge page on, _bytes rounded up to huge pages on a huge page boundary, advised to
+/// transparent huge pages, if cacheHugePages(). The smaller ones from operator new.
+void* allocateHugePages(size_t _bytes);
+void deallocateHugePages(void* _p, size_t _bytes);
+
+/// The allocator of the tables of the long-lived caches read at random, where the huge pages save
+/// the misses of the TLB.
+template <class T>
+class HugePageAllocator
+{
+public:
+    typedef T value_type;
+
+    HugePageAllocator() = default;
+    template <class U>
+    HugePageAllocator(HugePageAllocator<U> const&)
+    {}
+
+    T* allocate(size_t _n)
+    {
+        if (_n > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocateHugePages(_n * sizeof(T)));
+    }
+    void deallocate(T* _p, size_t _n) { deallocateHugePages(_p, _n * sizeof(T)); }
+
+    template <class U>
+    bool operator==(HugePageAllocator<U> const&) const
+    {
+        return true;
+    }
+    template <class U>
+    bool operator!=(HugePageAllocator<U> const&) const
+    {
+        return false;
+    }
+};
+}  // namespace dev
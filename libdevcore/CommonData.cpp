@@ -23,6 +23,9 @@
 #include <random>
 
 #include "Exceptions.h"
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 using namespace dev;
@@ -44,6 +47,194 @@ int fromHexChar(char _i) noexcept
         return _i - 'A' + 10;
     return -1;
 }
+
+/// the digits of each byte and the value of each digit, 0xff for the other chars
+struct HexTables
+{
+    char digits[256][2];
+    uint8_t values[256];
+    HexTables()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            digits[i][0] = "0123456789abcdef"[i >> 4];
+            digits[i][1] = "0123456789abcdef"[i & 0x0f];
+            int value = fromHexChar((char)i);
+            values[i] = value == -1 ? 0xff : (uint8_t)value;
+        }
+    }
+};
+/// built on the first use, the hashes of the static initializers of other files are decoded
+HexTables const& hexTables()
+{
+    static HexTables const s_tables;
+    return s_tables;
+}
+
+void hexEncodeScalar(byte const* _data, size_t _size, char* _out)
+{
+    auto const& tables = hexTables();
+    for (size_t i = 0; i < _size; ++i)
+    {
+        memcpy(_out + 2 * i, tables.digits[_data[i]], 2);
+    }
+}
+
+bool hexDecodeScalar(char const* _hex, size_t _size, byte* _out)
+{
+    auto const& tables = hexTables();
+    for (size_t i = 0; i < _size; ++i)
+    {
+        uint8_t h = tables.values[(uint8_t)_hex[2 * i]];
+        uint8_t l = tables.values[(uint8_t)_hex[2 * i + 1]];
+        if ((h | l) == 0xff)
+        {
+            return false;
+        }
+        _out[i] = (byte)(h << 4 | l);
+    }
+    return true;
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+/// the chars of the nibbles 0-15: '0' + n, and 39 more past '9' to reach 'a'
+inline __m128i nibblesToHex(__m128i _nibbles)
+{
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(_nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(39));
+    return _mm_add_epi8(_mm_add_epi8(_nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/// the values of 16 hex digits, or false if one isn't
+inline bool hexToNibbles(__m128i _chars, __m128i& o_nibbles)
+{
+    // the chars from 0x80 are negative and fail both ranges
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(_chars, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(_chars, _mm_set1_epi8('9' + 1)));
+    __m128i lower = _mm_or_si128(_chars, _mm_set1_epi8(0x20));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xffff)
+    {
+        return false;
+    }
+    o_nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(_chars, _mm_set1_epi8('0'))),
+        _mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+/// the bytes of the pairs of nibbles, in the low bytes of the 16 bit lanes
+inline __m128i pairNibbles(__m128i _nibbles)
+{
+    return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(_nibbles, 4), _mm_set1_epi16(0x00f0)),
+        _mm_srli_epi16(_nibbles, 8));
+}
+
+/// 16 bytes a round, SSE2 is in every x86-64 CPU
+void hexEncodeSSE2(byte const* _data, size_t _size, char* _out)
+{
+    size_t i = 0;
+    for (; i + 16 <= _size; i += 16)
+    {
+        __m128i in = _mm_loadu_si128((__m128i const*)(_data + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0f));
+        __m128i low = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+        _mm_storeu_si128((__m128i*)(_out + 2 * i), nibblesToHex(_mm_unpacklo_epi8(high, low)));
+        _mm_storeu_si128(
+            (__m128i*)(_out + 2 * i + 16), nibblesToHex(_mm_unpackhi_epi8(high, low)));
+    }
+    hexEncodeScalar(_data + i, _size - i, _out + 2 * i);
+}
+
+bool hexDecodeSSE2(char const* _hex, size_t _size, byte* _out)
+{
+    size_t i = 0;
+    for (; i + 16 <= _size; i += 16)
+    {
+        __m128i first;
+        __m128i second;
+        if (!hexToNibbles(_mm_loadu_si128((__m128i const*)(_hex + 2 * i)), first) ||
+            !hexToNibbles(_mm_loadu_si128((__m128i const*)(_hex + 2 * i + 16)), second))
+        {
+            return false;
+        }
+        _mm_storeu_si128(
+            (__m128i*)(_out + i), _mm_packus_epi16(pairNibbles(first), pairNibbles(second)));
+    }
+    return hexDecodeScalar(_hex + 2 * i, _size - i, _out + i);
+}
+
+__attribute__((target("avx2"))) inline __m256i nibblesToHexAVX2(__m256i _nibbles)
+{
+    __m256i letters =
+        _mm256_and_si256(_mm256_cmpgt_epi8(_nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8(39));
+    return _mm256_add_epi8(_mm256_add_epi8(_nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+__attribute__((target("avx2"))) inline bool hexToNibblesAVX2(__m256i _chars, __m256i& o_nibbles)
+{
+    __m256i digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(_chars, _mm256_set1_epi8('9')),
+        _mm256_cmpgt_epi8(_chars, _mm256_set1_epi8('0' - 1)));
+    __m256i lower = _mm256_or_si256(_chars, _mm256_set1_epi8(0x20));
+    __m256i letter = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+        _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+    if (_mm256_movemask_epi8(_mm256_or_si256(digit, letter)) != -1)
+    {
+        return false;
+    }
+    o_nibbles =
+        _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(_chars, _mm256_set1_epi8('0'))),
+            _mm256_and_si256(letter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+    return true;
+}
+
+/// 32 bytes a round, the 128 bit lanes are put back in order after unpacking and packing
+__attribute__((target("avx2"))) void hexEncodeAVX2(byte const* _data, size_t _size, char* _out)
+{
+    size_t i = 0;
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256((__m256i const*)(_data + i));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0f));
+        __m256i low = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256((__m256i*)(_out + 2 * i),
+            nibblesToHexAVX2(_mm256_permute2x128_si256(first, second, 0x20)));
+        _mm256_storeu_si256((__m256i*)(_out + 2 * i + 32),
+            nibblesToHexAVX2(_mm256_permute2x128_si256(first, second, 0x31)));
+    }
+    hexEncodeSSE2(_data + i, _size - i, _out + 2 * i);
+}
+
+__attribute__((target("avx2"))) bool hexDecodeAVX2(char const* _hex, size_t _size, byte* _out)
+{
+    size_t i = 0;
+    for (; i + 32 <= _size; i += 32)
+    {
+        __m256i first;
+        __m256i second;
+        if (!hexToNibblesAVX2(_mm256_loadu_si256((__m256i const*)(_hex + 2 * i)), first) ||
+            !hexToNibblesAVX2(_mm256_loadu_si256((__m256i const*)(_hex + 2 * i + 32)), second))
+        {
+            return false;
+        }
+        __m256i mask = _mm256_set1_epi16(0x00f0);
+        first = _mm256_or_si256(
+            _mm256_and_si256(_mm256_slli_epi16(first, 4), mask), _mm256_srli_epi16(first, 8));
+        second = _mm256_or_si256(
+            _mm256_and_si256(_mm256_slli_epi16(second, 4), mask), _mm256_srli_epi16(second, 8));
+        _mm256_storeu_si256((__m256i*)(_out + i),
+            _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xd8));
+    }
+    return hexDecodeSSE2(_hex + 2 * i, _size - i, _out + i);
+}
+
+bool hasAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
 }  // namespace
 
 bool dev::isHex(string const& _s) noexcept
@@ -83,32 +274,55 @@ std::string dev::escaped(std::string const& _s, bool _all)
 }
 
 
+void dev::hexEncode(byte const* _data, size_t _size, char* _out)
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    static const bool avx2 = hasAVX2();
+    if (avx2)
+    {
+        hexEncodeAVX2(_data, _size, _out);
+        return;
+    }
+    hexEncodeSSE2(_data, _size, _out);
+#else
+    hexEncodeScalar(_data, _size, _out);
+#endif
+}
+
+bool dev::hexDecode(char const* _hex, size_t _size, byte* _out)
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    static const bool avx2 = hasAVX2();
+    if (avx2)
+    {
+        return hexDecodeAVX2(_hex, _size, _out);
+    }
+    return hexDecodeSSE2(_hex, _size, _out);
+#else
+    return hexDecodeScalar(_hex, _size, _out);
+#endif
+}
+
 bytes dev::fromHex(std::string const& _s, WhenError _throw)
 {
     unsigned s = (_s.size() >= 2 && _s[0] == '0' && _s[1] == 'x') ? 2 : 0;
-    std::vector<uint8_t> ret;
-    ret.reserve((_s.size() - s + 1) / 2);
-
+    bytes ret((_s.size() - s + 1) / 2);
+    size_t odd = 0;
     if (_s.size() % 2)
     {
         int h = fromHexChar(_s[s++]);
         if (h != -1)
-            ret.push_back(h);
+            ret[odd++] = (byte)h;
         else if (_throw == WhenError::Throw)
             BOOST_THROW_EXCEPTION(BadHexCharacter());
         else
             return bytes();
     }
-    for (unsigned i = s; i < _s.size(); i += 2)
+    if (!hexDecode(_s.data() + s, ret.size() - odd, ret.data() + odd))
     {
-        int h = fromHexChar(_s[i]);
-        int l = fromHexChar(_s[i + 1]);
-        if (h != -1 && l != -1)
-            ret.push_back((byte)(h * 16 + l));
-        else if (_throw == WhenError::Throw)
+        if (_throw == WhenError::Throw)
             BOOST_THROW_EXCEPTION(BadHexCharacter());
-        else
-            return bytes();
+        return bytes();
     }
     return ret;
 }
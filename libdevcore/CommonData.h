@@ -41,16 +41,43 @@ enum class WhenError
     Throw = 1,
 };
 
-/**
- * @brief: Trans given hex numbers to string
- * @tparam Iterator: Iterator type of given hex number
- * @param _it : Point to the first hex number to be transformed into hex string
- * @param _end: Point to the last hex number to be transformed into hex string
- * @param _prefix : Prefix of the outputed hex string
- * @return std::string : Transformed hex string of given hex numbers
- */
+/// write the 2 * _size lower case hex digits of _data to _out, vectorized on x86-64
+void hexEncode(byte const* _data, size_t _size, char* _out);
+
+/// decode the 2 * _size hex digits of _hex into _out, vectorized on x86-64
+/// @returns false if one of them isn't a hex digit, _out is then partly written
+bool hexDecode(char const* _hex, size_t _size, byte* _out);
+
+namespace detail
+{
+/// the types holding their bytes contiguously, e.g. bytes, bytesConstRef and std::string
+template <class T, class = void>
+struct IsContiguousBytes : std::false_type
+{
+};
+template <class T>
+struct IsContiguousBytes<T,
+    decltype((void)std::declval<T const&>().data(), (void)std::declval<T const&>().size())>
+  : std::integral_constant<bool, sizeof(*std::declval<T const&>().data()) == 1>
+{
+};
+
+inline std::string toHex(byte const* _data, size_t _size, std::string const& _prefix)
+{
+    std::string hex(_size * 2 + _prefix.size(), '0');
+    hex.replace(0, _prefix.size(), _prefix);
+    hexEncode(_data, _size, &hex[_prefix.size()]);
+    return hex;
+}
+
 template <class Iterator>
-std::string toHex(Iterator _it, Iterator _end, std::string const& _prefix)
+std::string toHex(Iterator _it, Iterator _end, std::string const& _prefix, std::true_type)
+{
+    return toHex(reinterpret_cast<byte const*>(_it), _end - _it, _prefix);
+}
+
+template <class Iterator>
+std::string toHex(Iterator _it, Iterator _end, std::string const& _prefix, std::false_type)
 {
     typedef std::iterator_traits<Iterator> traits;
     static_assert(sizeof(typename traits::value_type) == 1, "toHex needs byte-sized element type");
@@ -67,12 +94,40 @@ std::string toHex(Iterator _it, Iterator _end, std::string const& _prefix)
     return hex;
 }
 
+template <class T>
+std::string toHex(T const& _data, std::string const& _prefix, std::true_type)
+{
+    return toHex(reinterpret_cast<byte const*>(_data.data()), _data.size(), _prefix);
+}
+
+template <class T>
+std::string toHex(T const& _data, std::string const& _prefix, std::false_type)
+{
+    return toHex(_data.begin(), _data.end(), _prefix, std::false_type());
+}
+}  // namespace detail
+
+/**
+ * @brief: Trans given hex numbers to string
+ * @tparam Iterator: Iterator type of given hex number
+ * @param _it : Point to the first hex number to be transformed into hex string
+ * @param _end: Point to the last hex number to be transformed into hex string
+ * @param _prefix : Prefix of the outputed hex string
+ * @return std::string : Transformed hex string of given hex numbers
+ */
+template <class Iterator>
+std::string toHex(Iterator _it, Iterator _end, std::string const& _prefix)
+{
+    /// the bytes between two pointers are encoded at once
+    return detail::toHex(_it, _end, _prefix, std::is_pointer<Iterator>());
+}
+
 /// Convert a series of bytes to the corresponding hex string.
 /// @example toHex("A\x69") == "4169"
 template <class T>
 std::string toHex(T const& _data)
 {
-    return toHex(_data.begin(), _data.end(), "");
+    return detail::toHex(_data, "", detail::IsContiguousBytes<T>());
 }
 
 /// Convert a series of bytes to the corresponding hex string with 0x prefix.
@@ -80,7 +135,7 @@ std::string toHex(T const& _data)
 template <class T>
 std::string toHexPrefixed(T const& _data)
 {
-    return toHex(_data.begin(), _data.end(), "0x");
+    return detail::toHex(_data, "0x", detail::IsContiguousBytes<T>());
 }
 
 /// Converts a (printable) ASCII hex string into the corresponding byte stream.
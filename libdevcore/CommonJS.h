@@ -28,6 +28,7 @@
 #include "FixedHash.h"
 #include <libexecutive/ExecutionResult.h>
 #include <string>
+#include <type_traits>
 
 namespace dev
 {
@@ -54,10 +55,14 @@ std::string toJS(boost::multiprecision::number<boost::multiprecision::cpp_int_ba
         boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void>> const&
         _n)
 {
-    std::string h = toHex(toCompactBigEndian(_n, 1));
+    bytes compact = toCompactBigEndian(_n, 1);
+    std::string res = toHex(compact.begin(), compact.end(), "0x");
     // remove first 0, if it is necessary;
-    std::string res = h[0] != '0' ? h : h.substr(1);
-    return "0x" + res;
+    if (res[2] == '0')
+    {
+        res.erase(2, 1);
+    }
+    return res;
 }
 
 inline std::string toJS(bytes const& _n, std::size_t _padding = 0)
@@ -75,14 +80,43 @@ std::string toJS(SecureFixedHash<T> const& _i)
     return stream.str();
 }
 
+namespace detail
+{
 template <typename T>
-std::string toJS(T const& _i)
+std::string toJS(T const& _i, std::false_type)
 {
     std::stringstream stream;
     stream << "0x" << std::hex << _i;
     return stream.str();
 }
 
+/// the integers are written without a stream, the same as the stream writes them
+template <typename T>
+std::string toJS(T _i, std::true_type)
+{
+    static char const* hexdigits = "0123456789abcdef";
+    auto n = static_cast<typename std::make_unsigned<T>::type>(_i);
+    char hex[2 + sizeof(T) * 2];
+    size_t off = sizeof(hex);
+    do
+    {
+        hex[--off] = hexdigits[n & 0x0f];
+        n >>= 4;
+    } while (n);
+    hex[--off] = 'x';
+    hex[--off] = '0';
+    return std::string(hex + off, sizeof(hex) - off);
+}
+}  // namespace detail
+
+template <typename T>
+std::string toJS(T const& _i)
+{
+    /// the characters and bool are left to the stream
+    return detail::toJS(
+        _i, std::integral_constant<bool, std::is_integral<T>::value && (sizeof(T) > 1)>());
+}
+
 enum class OnFailed
 {
     InterpretRaw,
@@ -101,6 +101,7 @@ DEV_SIMPLE_EXCEPTION(LevelDBNotOpened);
 DEV_SIMPLE_EXCEPTION(UnsupportedInParallelMode);
 DEV_SIMPLE_EXCEPTION(ForbidNegativeValue);
 DEV_SIMPLE_EXCEPTION(InvalidPort);
+DEV_SIMPLE_EXCEPTION(InvalidCoreList);
 /**
  * @brief : error information to be added to exceptions
  */
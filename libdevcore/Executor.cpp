@@ -0,0 +1,318 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Executor.cpp
+ *  @brief the workers of the process shared by the named task queues of all modules and groups
+ */
+#include "Executor.h"
+#include "Affinity.h"
+#include "Common.h"
+#include "easylog.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+/// the queue of the task run by the calling worker
+thread_local TaskQueue* t_current = nullptr;
+
+MetricsRegistry::Labels queueLabels(string const& _name)
+{
+    return {{"queue", _name}};
+}
+
+/// two at least, so that a normal task never holds the only worker
+size_t defaultThreads()
+{
+    return max<size_t>(thread::hardware_concurrency(), 2);
+}
+}  // namespace
+
+TaskQueue::TaskQueue(
+    Executor& _executor, string const& _name, TaskPriority _priority, size_t _concurrency)
+  : m_executor(_executor),
+    m_name(_name),
+    m_priority(_priority),
+    m_concurrency(max<size_t>(_concurrency, 1)),
+    m_executed(g_metrics.counter(
+        "bcos_executor_tasks", "the tasks run by the queue", queueLabels(_name))),
+    m_pending(g_metrics.gauge(
+        "bcos_executor_pending", "the tasks waiting in the queue", queueLabels(_name))),
+    m_waitUs(g_metrics.histogram("bcos_executor_wait_us",
+        "the us a task waits in the queue before it runs", queueLabels(_name))),
+    m_runUs(g_metrics.histogram(
+        "bcos_executor_run_us", "the us a task of the queue runs", queueLabels(_name)))
+{}
+
+TaskQueue::~TaskQueue()
+{
+    // neither scheduled nor running, which hold the queue
+    m_pending.add(-(int64_t)m_tasks.size());
+}
+
+void TaskQueue::post(std::function<void()> _task)
+{
+    Task task;
+    task.run = std::move(_task);
+    task.posted = utcTimeUs();
+    {
+        Guard l(m_executor.x_executor);
+        if (m_stopped)
+        {
+            return;
+        }
+        m_tasks.push_back(std::move(task));
+        if (!m_scheduled && m_running < m_concurrency)
+        {
+            m_executor.schedule(shared_from_this());
+            m_executor.m_taskAvailable.notify_one();
+        }
+    }
+    m_pending.add(1);
+}
+
+void TaskQueue::stop()
+{
+    deque<Task> dropped;
+    {
+        std::unique_lock<Mutex> l(m_executor.x_executor);
+        m_stopped = true;
+        dropped.swap(m_tasks);
+        if (m_scheduled)
+        {
+            auto& ready = m_executor.m_ready[(size_t)m_priority];
+            ready.erase(remove_if(ready.begin(), ready.end(),
+                            [this](TaskQueue::Ptr const& _queue) { return _queue.get() == this; }),
+                ready.end());
+            m_scheduled = false;
+        }
+        size_t self = t_current == this ? 1 : 0;
+        m_executor.m_taskDone.wait(l, [&]() { return m_running <= self; });
+    }
+    // the tasks dropped are destroyed out of the lock, they may post others
+    m_pending.add(-(int64_t)dropped.size());
+}
+
+Executor& Executor::instance()
+{
+    // never destroyed, the detached workers may still run tasks while the process exits
+    static Executor* s_executor = new Executor();
+    return *s_executor;
+}
+
+void Executor::configure(size_t _threads, bool _pinThreads)
+{
+    Guard l(x_executor);
+    m_threads = max(m_threads, _threads > 0 ? _threads : defaultThreads());
+    m_pinThreads = _pinThreads;
+    if (m_spawned > 0)
+    {
+        start();
+    }
+}
+
+size_t Executor::threads() const
+{
+    Guard l(x_executor);
+    return m_threads;
+}
+
+TaskQueue::Ptr Executor::queue(string const& _name, TaskPriority _priority, size_t _concurrency)
+{
+    auto queue = make_shared<TaskQueue>(*this, _name, _priority, _concurrency);
+    Guard l(x_executor);
+    start();
+    return queue;
+}
+
+void Executor::start()
+{
+    if (m_threads == 0)
+    {
+        m_threads = defaultThreads();
+    }
+    while (m_live < m_threads + m_blocked)
+    {
+        spawn();
+    }
+}
+
+void Executor::spawn()
+{
+    size_t ordinal = m_spawned++;
+    ++m_live;
+    thread([this, ordinal]() { work(ordinal); }).detach();
+}
+
+bool Executor::mayRun(TaskPriority _priority) const
+{
+    switch (_priority)
+    {
+    case TaskPriority::High:
+        return true;
+    case TaskPriority::Normal:
+        return m_running[1] + m_running[2] + 1 < m_threads;
+    default:
+        return m_running[1] + m_running[2] + 1 < m_threads &&
+               m_running[2] < max<size_t>(m_threads / 2, 1);
+    }
+}
+
+void Executor::schedule(TaskQueue::Ptr const& _queue)
+{
+    _queue->m_scheduled = true;
+    m_ready[(size_t)_queue->m_priority].push_back(_queue);
+}
+
+TaskQueue::Ptr Executor::next(TaskQueue::Task& _task)
+{
+    for (size_t priority = 0; priority < 3; ++priority)
+    {
+        auto& ready = m_ready[priority];
+        if (ready.empty() || !mayRun((TaskPriority)priority))
+        {
+            continue;
+        }
+        auto queue = std::move(ready.front());
+        ready.pop_front();
+        queue->m_scheduled = false;
+        _task = std::move(queue->m_tasks.front());
+        queue->m_tasks.pop_front();
+        ++queue->m_running;
+        ++m_running[priority];
+        if (!queue->m_tasks.empty() && queue->m_running < queue->m_concurrency)
+        {
+            schedule(queue);
+        }
+        return queue;
+    }
+    return nullptr;
+}
+
+void Executor::work(size_t _ordinal)
+{
+    pthread_setThreadName("Executor");
+#if defined(__linux__)
+    bool pin;
+    {
+        Guard l(x_executor);
+        pin = m_pinThreads;
+    }
+    if (pin)
+    {
+        // on the free cores only when some are reserved for the groups or the network
+        auto cores = g_cpuAffinity.freeCores();
+        if (cores.empty())
+        {
+            cores.push_back(_ordinal % max<unsigned>(thread::hardware_concurrency(), 1));
+        }
+        else
+        {
+            cores = {cores[_ordinal % cores.size()]};
+        }
+        CPUAffinity::bindThread(cores);
+    }
+#else
+    (void)_ordinal;
+#endif
+
+    TaskQueue::Ptr queue;
+    while (true)
+    {
+        // released out of the lock, the last reference destroys the queue and its tasks
+        TaskQueue::Ptr finished;
+        TaskQueue::Task task;
+        {
+            std::unique_lock<Mutex> l(x_executor);
+            if (queue)
+            {
+                --queue->m_running;
+                --m_running[(size_t)queue->m_priority];
+                if (!queue->m_stopped && !queue->m_scheduled && !queue->m_tasks.empty() &&
+                    queue->m_running < queue->m_concurrency)
+                {
+                    schedule(queue);
+                }
+                m_taskDone.notify_all();
+                finished.swap(queue);
+            }
+            while (!(queue = next(task)))
+            {
+                // a spare worker stops when the tasks it stood in for don't wait any more
+                if (m_live > m_threads + m_blocked)
+                {
+                    --m_live;
+                    m_taskDone.notify_all();
+                    return;
+                }
+                ++m_idle;
+                m_taskAvailable.wait(l);
+                --m_idle;
+            }
+        }
+        finished.reset();
+
+        auto start = utcTimeUs();
+        queue->m_pending.add(-1);
+        queue->m_waitUs.observe(start - min(start, task.posted));
+        t_current = queue.get();
+        try
+        {
+            task.run();
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR) << LOG_BADGE("Executor") << LOG_DESC("task failed")
+                       << LOG_KV("queue", queue->m_name) << LOG_KV("what", e.what());
+        }
+        t_current = nullptr;
+        queue->m_runUs.observe(utcTimeUs() - start);
+        queue->m_executed.inc();
+    }
+}
+
+Executor::Blocking::Blocking() : m_queue(t_current)
+{
+    if (!m_queue)
+    {
+        return;
+    }
+    auto& executor = m_queue->m_executor;
+    Guard l(executor.x_executor);
+    --executor.m_running[(size_t)m_queue->priority()];
+    ++executor.m_blocked;
+    if (executor.m_idle == 0)
+    {
+        executor.spawn();
+    }
+    // the class of the task may run another one meanwhile
+    executor.m_taskAvailable.notify_one();
+}
+
+Executor::Blocking::~Blocking()
+{
+    if (!m_queue)
+    {
+        return;
+    }
+    auto& executor = m_queue->m_executor;
+    Guard l(executor.x_executor);
+    ++executor.m_running[(size_t)m_queue->priority()];
+    --executor.m_blocked;
+}
@@ -0,0 +1,157 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Executor.h
+ *  @brief the workers of the process shared by the named task queues of all modules and groups
+ */
+#pragma once
+
+#include "Guards.h"
+#include "Metrics.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace dev
+{
+/// the class of a queue, the workers run the tasks of the higher classes first
+enum class TaskPriority
+{
+    /// the consensus and the network, may take every worker
+    High = 0,
+    /// the sync, the storage and the channel, leave a worker to the high queues
+    Normal = 1,
+    /// the RPC and the background jobs, take at most half of the workers
+    Low = 2
+};
+
+class Executor;
+
+/// A named queue of tasks run by the workers of the Executor, at most concurrency of them at a
+/// time and in the order they are posted, so that a queue of concurrency 1 runs its tasks one
+/// after another as a thread of its own would.
+class TaskQueue : public std::enable_shared_from_this<TaskQueue>
+{
+public:
+    typedef std::shared_ptr<TaskQueue> Ptr;
+
+    TaskQueue(Executor& _executor, std::string const& _name, TaskPriority _priority,
+        size_t _concurrency);
+    ~TaskQueue();
+
+    /// ignored once the queue is stopped
+    void post(std::function<void()> _task);
+    /// drop the pending tasks and wait for the running ones but the one calling it
+    void stop();
+
+    std::string const& name() const { return m_name; }
+    TaskPriority priority() const { return m_priority; }
+    size_t concurrency() const { return m_concurrency; }
+
+private:
+    friend class Executor;
+    struct Task
+    {
+        std::function<void()> run;
+        /// us since the epoch
+        uint64_t posted = 0;
+    };
+
+    Executor& m_executor;
+    std::string m_name;
+    TaskPriority m_priority;
+    size_t m_concurrency;
+
+    /// guarded by the lock of the executor
+    std::deque<Task> m_tasks;
+    size_t m_running = 0;
+    /// in the ready queues of the executor
+    bool m_scheduled = false;
+    bool m_stopped = false;
+
+    Counter& m_executed;
+    Gauge& m_pending;
+    Histogram& m_waitUs;
+    Histogram& m_runUs;
+};
+
+/**
+ * @brief The workers of the process, one per core by default, instead of the threads of a pool
+ * for each module and group. A worker takes the next task of the first ready queue of the highest
+ * class it may run, and moves the queue to the back of the ready queues of its class, so that the
+ * queues of a class share the workers in turn.
+ */
+class Executor
+{
+public:
+    static Executor& instance();
+
+    /// _threads workers, 0 for one per core, the worker i bound to the core i if _pinThreads,
+    /// to the i-th free core of the CPUAffinity if cores are reserved.
+    /// The workers are started by the first queue, configuring them later only adds workers.
+    void configure(size_t _threads, bool _pinThreads);
+    size_t threads() const;
+
+    TaskQueue::Ptr queue(
+        std::string const& _name, TaskPriority _priority, size_t _concurrency = 1);
+
+    /// The task constructing it waits for other tasks, e.g. on a future, while it lives: its
+    /// worker doesn't count and a spare worker is started if none is idle, so that the waiting
+    /// tasks don't hold the workers the awaited ones need. Nothing on the other threads.
+    class Blocking
+    {
+    public:
+        Blocking();
+        ~Blocking();
+
+    private:
+        TaskQueue* m_queue;
+    };
+
+private:
+    friend class TaskQueue;
+    Executor() = default;
+
+    /// the following are called with x_executor held
+    void start();
+    void spawn();
+    bool mayRun(TaskPriority _priority) const;
+    void schedule(TaskQueue::Ptr const& _queue);
+    /// the next queue to run a task of, which is taken from it, or null
+    TaskQueue::Ptr next(TaskQueue::Task& _task);
+
+    void work(size_t _ordinal);
+
+    mutable Mutex x_executor;
+    std::condition_variable m_taskAvailable;
+    /// a task is finished
+    std::condition_variable m_taskDone;
+    /// the queues with pending tasks below their concurrency, by class
+    std::deque<TaskQueue::Ptr> m_ready[3];
+    size_t m_running[3] = {0, 0, 0};
+
+    size_t m_threads = 0;
+    bool m_pinThreads = false;
+    /// the workers started so far, spares included
+    size_t m_spawned = 0;
+    size_t m_live = 0;
+    size_t m_idle = 0;
+    size_t m_blocked = 0;
+};
+
+#define g_executor dev::Executor::instance()
+}  // namespace dev
@@ -0,0 +1,429 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : open addressing hash map and set keyed by FixedHash
+ *
+ * @file: FixedHashMap.h
+ */
+
+#pragma once
+
+#include "FixedHash.h"
+#include "Guards.h"
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+namespace detail
+{
+/// the salt of the slots of the process, so that the slots of the hashes of a peer can't be
+/// chosen by the peer
+inline uint64_t fixedHashSalt()
+{
+    static const uint64_t salt = []() {
+        std::random_device random;
+        return ((uint64_t)random() << 32) | random();
+    }();
+    return salt;
+}
+
+template <class Key>
+struct MapKeyOf
+{
+    template <class Slot>
+    Key const& operator()(Slot const& _slot) const
+    {
+        return _slot.first;
+    }
+};
+
+template <class Key>
+struct SetKeyOf
+{
+    Key const& operator()(Key const& _slot) const { return _slot; }
+};
+
+/**
+ * @brief Hash table of the slots of a single vector, probed linearly. The keys are hashes
+ * already, the slot of a key is its first word salted and spread by a multiplication, no
+ * hash of the bytes. An erased slot is filled by shifting back the slots after it, so no
+ * tombstones are left. Inserting or erasing invalidates the iterators.
+ */
+template <class Key, class Slot, class KeyOf>
+class FixedHashTable
+{
+    static_assert(Key::size >= sizeof(uint64_t), "the key must hold a word");
+
+public:
+    template <class Table, class Value>
+    class Iterator : public std::iterator<std::forward_iterator_tag, Value>
+    {
+    public:
+        Iterator() = default;
+        Iterator(Table* _table, size_t _index) : m_table(_table), m_index(_index) { skip(); }
+        /// the const iterator of an iterator
+        template <class OtherTable, class OtherValue>
+        Iterator(Iterator<OtherTable, OtherValue> const& _other)
+          : m_table(_other.m_table), m_index(_other.m_index)
+        {}
+
+        Value& operator*() const { return m_table->m_slots[m_index]; }
+        Value* operator->() const { return &m_table->m_slots[m_index]; }
+        Iterator& operator++()
+        {
+            ++m_index;
+            skip();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(Iterator const& _other) const { return m_index == _other.m_index; }
+        bool operator!=(Iterator const& _other) const { return m_index != _other.m_index; }
+
+    private:
+        template <class, class>
+        friend class Iterator;
+        friend class FixedHashTable;
+
+        void skip()
+        {
+            while (m_index < m_table->m_used.size() && !m_table->m_used[m_index])
+                ++m_index;
+        }
+
+        Table* m_table = nullptr;
+        size_t m_index = 0;
+    };
+
+    typedef Iterator<FixedHashTable, Slot> iterator;
+    typedef Iterator<FixedHashTable const, Slot const> const_iterator;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_used.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_used.size()); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator find(Key const& _key) { return iterator(this, indexOf(_key)); }
+    const_iterator find(Key const& _key) const { return const_iterator(this, indexOf(_key)); }
+    size_t count(Key const& _key) const { return indexOf(_key) == m_used.size() ? 0 : 1; }
+
+    size_t erase(Key const& _key)
+    {
+        auto index = indexOf(_key);
+        if (index == m_used.size())
+            return 0;
+        eraseAt(index);
+        return 1;
+    }
+    void erase(const_iterator _it) { eraseAt(_it.m_index); }
+
+    /// drops the slots but keeps their memory, the table is refilled to about the same size
+    void clear()
+    {
+        for (size_t i = 0; i < m_used.size(); ++i)
+        {
+            if (m_used[i])
+            {
+                m_slots[i] = Slot();
+                m_used[i] = 0;
+            }
+        }
+        m_size = 0;
+    }
+
+    void reserve(size_t _size)
+    {
+        size_t capacity = c_minCapacity;
+        while (capacity * c_maxLoad < _size * c_loadDivisor)
+            capacity *= 2;
+        if (capacity > m_used.size())
+            rehash(capacity);
+    }
+
+    /// bytes of the slots, to account for the memory of a table
+    size_t memory() const { return m_used.size() * (sizeof(Slot) + 1); }
+
+protected:
+    /// the slot of _key and whether it was inserted, _slot is moved in only if it is
+    std::pair<iterator, bool> insertSlot(Key const& _key, Slot&& _slot)
+    {
+        auto index = indexOf(_key);
+        if (index != m_used.size())
+            return std::make_pair(iterator(this, index), false);
+
+        if ((m_size + 1) * c_loadDivisor > m_used.size() * c_maxLoad)
+            rehash(m_used.empty() ? c_minCapacity : m_used.size() * 2);
+        index = place(std::move(_slot));
+        ++m_size;
+        return std::make_pair(iterator(this, index), true);
+    }
+
+private:
+    static const size_t c_minCapacity = 16;
+    /// the slots used are at most 3/4 of the slots
+    static const size_t c_maxLoad = 3;
+    static const size_t c_loadDivisor = 4;
+
+    size_t home(Key const& _key) const
+    {
+        uint64_t word;
+        memcpy(&word, _key.data(), sizeof(word));
+        return (size_t)(((word ^ fixedHashSalt()) * 0x9e3779b97f4a7c15ULL) >> m_shift);
+    }
+
+    /// the index of _key, the number of slots if it is absent
+    size_t indexOf(Key const& _key) const
+    {
+        if (m_size == 0)
+            return m_used.size();
+        size_t mask = m_used.size() - 1;
+        for (size_t i = home(_key);; i = (i + 1) & mask)
+        {
+            if (!m_used[i])
+                return m_used.size();
+            if (KeyOf()(m_slots[i]) == _key)
+                return i;
+        }
+    }
+
+    size_t place(Slot&& _slot)
+    {
+        size_t mask = m_used.size() - 1;
+        size_t i = home(KeyOf()(_slot));
+        while (m_used[i])
+            i = (i + 1) & mask;
+        m_slots[i] = std::move(_slot);
+        m_used[i] = 1;
+        return i;
+    }
+
+    void eraseAt(size_t _hole)
+    {
+        size_t mask = m_used.size() - 1;
+        for (size_t i = (_hole + 1) & mask; m_used[i]; i = (i + 1) & mask)
+        {
+            // a slot stays unless the hole lies between its home and itself
+            size_t slotHome = home(KeyOf()(m_slots[i]));
+            if (((i - slotHome) & mask) >= ((i - _hole) & mask))
+            {
+                m_slots[_hole] = std::move(m_slots[i]);
+                _hole = i;
+            }
+        }
+        m_slots[_hole] = Slot();
+        m_used[_hole] = 0;
+        --m_size;
+    }
+
+    void rehash(size_t _capacity)
+    {
+        std::vector<Slot> slots(_capacity);
+        std::vector<uint8_t> used(_capacity, 0);
+        slots.swap(m_slots);
+        used.swap(m_used);
+        m_shift = 64;
+        for (size_t capacity = _capacity; capacity > 1; capacity /= 2)
+            --m_shift;
+        for (size_t i = 0; i < used.size(); ++i)
+        {
+            if (used[i])
+                place(std::move(slots[i]));
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_used;
+    size_t m_size = 0;
+    unsigned m_shift = 64;
+};
+}  // namespace detail
+
+/**
+ * @brief Map from a FixedHash to _Value with the interface of std::unordered_map that the node
+ * uses, on a single vector of slots instead of a node per entry. Inserting or erasing
+ * invalidates the iterators and the references to the values.
+ */
+template <class Key, class Value>
+class FixedHashMap
+  : public detail::FixedHashTable<Key, std::pair<Key, Value>, detail::MapKeyOf<Key>>
+{
+public:
+    typedef std::pair<Key, Value> value_type;
+    typedef typename FixedHashMap::iterator iterator;
+
+    std::pair<iterator, bool> emplace(Key const& _key, Value const& _value)
+    {
+        return this->insertSlot(_key, value_type(_key, _value));
+    }
+    std::pair<iterator, bool> insert(value_type const& _value)
+    {
+        return emplace(_value.first, _value.second);
+    }
+    Value& operator[](Key const& _key)
+    {
+        return this->insertSlot(_key, value_type(_key, Value())).first->second;
+    }
+};
+
+/// Set of FixedHash, see FixedHashMap
+template <class Key>
+class FixedHashSet : public detail::FixedHashTable<Key, Key, detail::SetKeyOf<Key>>
+{
+public:
+    typedef Key value_type;
+    typedef typename FixedHashSet::iterator iterator;
+
+    std::pair<iterator, bool> insert(Key const& _key) { return this->insertSlot(_key, Key(_key)); }
+};
+
+/**
+ * @brief FixedHashMap split into shards of their own lock, for the maps shared by the threads
+ * of the node. The values are copied out, no reference outlives the lock of its shard.
+ */
+template <class Key, class Value, size_t Shards = 16>
+class ConcurrentFixedHashMap
+{
+public:
+    bool get(Key const& _key, Value& _value) const
+    {
+        auto& shard = shardOf(_key);
+        ReadGuard l(shard.lock);
+        auto it = shard.map.find(_key);
+        if (it == shard.map.end())
+            return false;
+        _value = it->second;
+        return true;
+    }
+    bool count(Key const& _key) const
+    {
+        auto& shard = shardOf(_key);
+        ReadGuard l(shard.lock);
+        return shard.map.count(_key);
+    }
+    /// @returns false if _key was there already, its value is kept
+    bool insert(Key const& _key, Value const& _value)
+    {
+        auto& shard = shardOf(_key);
+        WriteGuard l(shard.lock);
+        return shard.map.emplace(_key, _value).second;
+    }
+    bool erase(Key const& _key)
+    {
+        auto& shard = shardOf(_key);
+        WriteGuard l(shard.lock);
+        return shard.map.erase(_key) > 0;
+    }
+    size_t size() const
+    {
+        size_t size = 0;
+        for (auto& shard : m_shards)
+        {
+            ReadGuard l(shard.lock);
+            size += shard.map.size();
+        }
+        return size;
+    }
+    void clear()
+    {
+        for (auto& shard : m_shards)
+        {
+            WriteGuard l(shard.lock);
+            shard.map.clear();
+        }
+    }
+
+private:
+    struct Shard
+    {
+        mutable SharedMutex lock;
+        FixedHashMap<Key, Value> map;
+    };
+
+    // the table of a shard hashes the first word, the shard is chosen by the last byte
+    Shard& shardOf(Key const& _key) const { return m_shards[_key[Key::size - 1] % Shards]; }
+
+    mutable std::array<Shard, Shards> m_shards;
+};
+
+/// Set of FixedHash split into shards of their own lock, see ConcurrentFixedHashMap
+template <class Key, size_t Shards = 16>
+class ConcurrentFixedHashSet
+{
+public:
+    bool count(Key const& _key) const
+    {
+        auto& shard = shardOf(_key);
+        ReadGuard l(shard.lock);
+        return shard.set.count(_key);
+    }
+    /// @returns false if _key was there already
+    bool insert(Key const& _key)
+    {
+        auto& shard = shardOf(_key);
+        WriteGuard l(shard.lock);
+        return shard.set.insert(_key).second;
+    }
+    bool erase(Key const& _key)
+    {
+        auto& shard = shardOf(_key);
+        WriteGuard l(shard.lock);
+        return shard.set.erase(_key) > 0;
+    }
+    size_t size() const
+    {
+        size_t size = 0;
+        for (auto& shard : m_shards)
+        {
+            ReadGuard l(shard.lock);
+            size += shard.set.size();
+        }
+        return size;
+    }
+    void clear()
+    {
+        for (auto& shard : m_shards)
+        {
+            WriteGuard l(shard.lock);
+            shard.set.clear();
+        }
+    }
+
+private:
+    struct Shard
+    {
+        mutable SharedMutex lock;
+        FixedHashSet<Key> set;
+    };
+
+    Shard& shardOf(Key const& _key) const { return m_shards[_key[Key::size - 1] % Shards]; }
+
+    mutable std::array<Shard, Shards> m_shards;
+};
+
+}  // namespace dev
@@ -28,4 +28,16 @@ namespace dev
 std::string const FileLogger = "FileLogger";
 boost::log::sources::severity_channel_logger_mt<boost::log::trivial::severity_level, std::string>
     FileLoggerHandler(boost::log::keywords::channel = FileLogger);
+
+boost::log::sources::severity_channel_logger<boost::log::trivial::severity_level, std::string>&
+threadFileLogger()
+{
+    thread_local boost::log::sources::severity_channel_logger<boost::log::trivial::severity_level,
+        std::string>
+        t_logger(boost::log::keywords::channel = FileLogger);
+    return t_logger;
+}
+
+/// everything is logged until the log is initialized
+std::atomic<int> g_fileLogLevel = {boost::log::trivial::trace};
 }  // namespace dev
\ No newline at end of file
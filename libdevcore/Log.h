@@ -26,6 +26,7 @@
 #include <boost/log/attributes/scoped_attribute.hpp>
 #include <boost/log/sources/severity_channel_logger.hpp>
 #include <boost/log/trivial.hpp>
+#include <atomic>
 
 namespace dev
 {
@@ -34,6 +35,13 @@ extern std::string const FileLogger;
 extern boost::log::sources::severity_channel_logger_mt<boost::log::trivial::severity_level,
     std::string>
     FileLoggerHandler;
+/// the file logger of the calling thread, so that the threads don't contend for the lock of
+/// FileLoggerHandler
+boost::log::sources::severity_channel_logger<boost::log::trivial::severity_level, std::string>&
+threadFileLogger();
+/// the lowest level logged to the file, the records below are skipped by LOG without evaluating
+/// their arguments nor going through the filters of boost log
+extern std::atomic<int> g_fileLogLevel;
 
 enum LogLevel
 {
@@ -48,7 +56,11 @@ enum LogLevel
 #define INITIALIZE_EASYLOGGINGPP \
     void Empty() {}
 
-#define LOG(level)                        \
-    BOOST_LOG_SEV(dev::FileLoggerHandler, \
+/// a loop rather than an if, so that an else following LOG isn't taken by it
+#define LOG(level)                                                                            \
+    for (bool _dev_log_enabled =                                                              \
+             dev::LogLevel::level >= dev::g_fileLogLevel.load(std::memory_order_relaxed);     \
+         _dev_log_enabled; _dev_log_enabled = false)                                          \
+    BOOST_LOG_SEV(dev::threadFileLogger(),                                                    \
         (boost::log::v2s_mt_posix::trivial::severity_level)(dev::LogLevel::level))
 }  // namespace dev
@@ -100,7 +100,7 @@ void MemoryDB::insert(h256 const& _h, bytesConstRef _v)
 bool MemoryDB::kill(h256 const& _h)
 {
 #if DEV_GUARDED_DB
-    ReadGuard l(x_this);
+    WriteGuard l(x_this);
 #endif
     if (m_main.count(_h))
     {
@@ -21,9 +21,15 @@
 
 #pragma once
 
+#include "Guards.h"
 #include "RLP.h"
 #include <unordered_map>
 
+// the state trie writes the storage tries of the accounts concurrently into one db
+#ifndef DEV_GUARDED_DB
+#define DEV_GUARDED_DB 1
+#endif
+
 namespace dev
 {
 class MemoryDB
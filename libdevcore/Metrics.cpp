@@ -0,0 +1,308 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Metrics.cpp
+ *  @brief the counters, gauges and histograms of the process, exported in the Prometheus format
+ */
+#include "Metrics.h"
+#include "Common.h"
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+
+size_t dev::detail::metricShard()
+{
+    static std::atomic<size_t> s_next = {0};
+    thread_local size_t t_shard = s_next.fetch_add(1, std::memory_order_relaxed) % c_metricShards;
+    return t_shard;
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t value = 0;
+    for (auto const& shard : m_shards)
+    {
+        value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+Histogram::Shard::Shard()
+{
+    for (auto& bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t Histogram::bucket(uint64_t _value)
+{
+    if (_value < 4)
+    {
+        return _value;
+    }
+    /// the 4 buckets of [2^e, 2^(e+1)) are told apart by the 2 bits after the highest one
+    size_t e = 63 - __builtin_clzll(_value);
+    return 4 * (e - 1) + ((_value >> (e - 2)) & 3);
+}
+
+uint64_t Histogram::upperBound(size_t _bucket)
+{
+    if (_bucket < 4)
+    {
+        return _bucket;
+    }
+    size_t e = _bucket / 4 + 1;
+    uint64_t width = (uint64_t)1 << (e - 2);
+    return (4 + _bucket % 4) * width + width - 1;
+}
+
+void Histogram::observe(uint64_t _value)
+{
+    auto& shard = m_shards[detail::metricShard()];
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(_value, std::memory_order_relaxed);
+    shard.buckets[bucket(_value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.buckets.resize(c_histogramBuckets, 0);
+    for (auto const& shard : m_shards)
+    {
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < c_histogramBuckets; ++i)
+        {
+            snapshot.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    /// counted from the buckets, so that the quantiles are consistent with the count
+    for (auto count : snapshot.buckets)
+    {
+        snapshot.count += count;
+    }
+    return snapshot;
+}
+
+uint64_t Histogram::Snapshot::quantile(double _q) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = std::max((uint64_t)std::ceil(_q * count), (uint64_t)1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            return upperBound(i);
+        }
+    }
+    return upperBound(buckets.size() - 1);
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry s_registry;
+    return s_registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(
+    std::string const& _name, std::string const& _help, std::string const& _type)
+{
+    auto it = m_families.find(_name);
+    if (it == m_families.end())
+    {
+        it = m_families.emplace(_name, Family()).first;
+        it->second.help = _help;
+        it->second.type = _type;
+    }
+    else if (it->second.type != _type)
+    {
+        BOOST_THROW_EXCEPTION(MetricTypeMismatch() << errinfo_comment(
+                                  _name + " is a " + it->second.type + ", not a " + _type));
+    }
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(
+    std::string const& _name, std::string const& _help, Labels const& _labels)
+{
+    std::lock_guard<std::mutex> l(x_families);
+    auto& metric = family(_name, _help, "counter").counters[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<Counter>();
+    }
+    return *metric;
+}
+
+Gauge& MetricsRegistry::gauge(
+    std::string const& _name, std::string const& _help, Labels const& _labels)
+{
+    std::lock_guard<std::mutex> l(x_families);
+    auto& metric = family(_name, _help, "gauge").gauges[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<Gauge>();
+    }
+    return *metric;
+}
+
+Histogram& MetricsRegistry::histogram(
+    std::string const& _name, std::string const& _help, Labels const& _labels)
+{
+    std::lock_guard<std::mutex> l(x_families);
+    auto& metric = family(_name, _help, "histogram").histograms[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<Histogram>();
+    }
+    return *metric;
+}
+
+std::vector<MetricsRegistry::Sample> MetricsRegistry::samples() const
+{
+    static const double c_quantiles[] = {0.5, 0.9, 0.99};
+    std::vector<Sample> samples;
+    std::lock_guard<std::mutex> l(x_families);
+    for (auto const& it : m_families)
+    {
+        Sample sample;
+        sample.name = it.first;
+        sample.type = it.second.type;
+        for (auto const& counter : it.second.counters)
+        {
+            sample.labels = counter.first;
+            sample.value = counter.second->value();
+            samples.push_back(sample);
+        }
+        for (auto const& gauge : it.second.gauges)
+        {
+            sample.labels = gauge.first;
+            sample.value = gauge.second->value();
+            samples.push_back(sample);
+        }
+        for (auto const& histogram : it.second.histograms)
+        {
+            auto snapshot = histogram.second->snapshot();
+            sample.labels = histogram.first;
+            sample.value = snapshot.sum;
+            sample.count = snapshot.count;
+            sample.quantiles.clear();
+            for (auto q : c_quantiles)
+            {
+                sample.quantiles[q] = snapshot.quantile(q);
+            }
+            samples.push_back(sample);
+        }
+    }
+    return samples;
+}
+
+namespace
+{
+std::string escapeLabel(std::string const& _value)
+{
+    std::string escaped;
+    for (auto c : _value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (c == '\n')
+        {
+            escaped += "\\n";
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// {a="1",b="2"} with _extra appended, empty without labels
+std::string formatLabels(MetricsRegistry::Labels const& _labels, std::string const& _extra = "")
+{
+    std::string formatted;
+    for (auto const& it : _labels)
+    {
+        formatted += (formatted.empty() ? "" : ",") + it.first + "=\"" + escapeLabel(it.second) +
+                     "\"";
+    }
+    if (!_extra.empty())
+    {
+        formatted += (formatted.empty() ? "" : ",") + _extra;
+    }
+    return formatted.empty() ? formatted : "{" + formatted + "}";
+}
+}  // namespace
+
+std::string MetricsRegistry::prometheus() const
+{
+    auto all = samples();
+    std::ostringstream out;
+    std::string lastName;
+    for (auto const& sample : all)
+    {
+        if (sample.name != lastName)
+        {
+            std::string help;
+            {
+                std::lock_guard<std::mutex> l(x_families);
+                help = m_families.at(sample.name).help;
+            }
+            out << "# HELP " << sample.name << " " << help << "\n";
+            out << "# TYPE " << sample.name << " "
+                << (sample.type == "histogram" ? "summary" : sample.type) << "\n";
+            lastName = sample.name;
+        }
+        if (sample.type != "histogram")
+        {
+            out << sample.name << formatLabels(sample.labels) << " " << (int64_t)sample.value
+                << "\n";
+            continue;
+        }
+        for (auto const& q : sample.quantiles)
+        {
+            std::ostringstream quantile;
+            quantile << "quantile=\"" << q.first << "\"";
+            out << sample.name << formatLabels(sample.labels, quantile.str()) << " " << q.second
+                << "\n";
+        }
+        out << sample.name << "_sum" << formatLabels(sample.labels) << " "
+            << (uint64_t)sample.value << "\n";
+        out << sample.name << "_count" << formatLabels(sample.labels) << " " << sample.count
+            << "\n";
+    }
+    return out.str();
+}
+
+ScopedTimer::ScopedTimer(Histogram& _histogram) : m_histogram(_histogram), m_start(utcTime()) {}
+
+ScopedTimer::~ScopedTimer()
+{
+    auto now = utcTime();
+    m_histogram.observe(now > m_start ? now - m_start : 0);
+}
@@ -0,0 +1,170 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Metrics.h
+ *  @brief the counters, gauges and histograms of the process, exported in the Prometheus format
+ */
+#pragma once
+
+#include "Exceptions.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+/// the shards of a metric, a thread updates one of them
+static const size_t c_metricShards = 8;
+/// the buckets of a histogram: 4 for each power of 2, so that a value is within 25% of its
+/// bucket
+static const size_t c_histogramBuckets = 256;
+
+DEV_SIMPLE_EXCEPTION(MetricTypeMismatch);
+
+namespace detail
+{
+/// the shard of the calling thread
+size_t metricShard();
+
+/// a cache line of its own, so that the threads of different shards don't contend
+struct PaddedCounter
+{
+    std::atomic<uint64_t> value = {0};
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+};
+}  // namespace detail
+
+/// a count only increased, e.g. the blocks committed
+class Counter
+{
+public:
+    void inc(uint64_t _n = 1)
+    {
+        m_shards[detail::metricShard()].value.fetch_add(_n, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+
+private:
+    detail::PaddedCounter m_shards[c_metricShards];
+};
+
+/// a value set, e.g. the bytes cached
+class Gauge
+{
+public:
+    void set(int64_t _value) { m_value.store(_value, std::memory_order_relaxed); }
+    void add(int64_t _delta) { m_value.fetch_add(_delta, std::memory_order_relaxed); }
+    int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value = {0};
+};
+
+/// the distribution of a value, e.g. the ms a block is executed in, in log-linear buckets
+class Histogram
+{
+public:
+    struct Snapshot
+    {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        std::vector<uint64_t> buckets;
+        /// the upper bound of the bucket holding the _q quantile, 0 < _q <= 1
+        uint64_t quantile(double _q) const;
+    };
+
+    void observe(uint64_t _value);
+    Snapshot snapshot() const;
+
+    static size_t bucket(uint64_t _value);
+    /// the largest value of the bucket
+    static uint64_t upperBound(size_t _bucket);
+
+private:
+    struct Shard
+    {
+        std::atomic<uint64_t> count = {0};
+        std::atomic<uint64_t> sum = {0};
+        std::atomic<uint64_t> buckets[c_histogramBuckets];
+        Shard();
+    };
+    Shard m_shards[c_metricShards];
+};
+
+/// The metrics of the process by name and labels. A metric is registered once and updated
+/// without a lock through the reference returned, which stays valid as long as the process.
+class MetricsRegistry
+{
+public:
+    typedef std::map<std::string, std::string> Labels;
+
+    static MetricsRegistry& instance();
+
+    /// throw MetricTypeMismatch if _name is registered as a metric of another type
+    Counter& counter(
+        std::string const& _name, std::string const& _help, Labels const& _labels = {});
+    Gauge& gauge(std::string const& _name, std::string const& _help, Labels const& _labels = {});
+    Histogram& histogram(
+        std::string const& _name, std::string const& _help, Labels const& _labels = {});
+
+    struct Sample
+    {
+        std::string name;
+        std::string type;
+        Labels labels;
+        /// the value of a counter or a gauge, the sum of a histogram
+        double value = 0;
+        /// only for histograms
+        uint64_t count = 0;
+        std::map<double, uint64_t> quantiles;
+    };
+    std::vector<Sample> samples() const;
+    /// the text exposition format of Prometheus, the histograms as summaries
+    std::string prometheus() const;
+
+private:
+    struct Family
+    {
+        std::string help;
+        std::string type;
+        std::map<Labels, std::shared_ptr<Counter>> counters;
+        std::map<Labels, std::shared_ptr<Gauge>> gauges;
+        std::map<Labels, std::shared_ptr<Histogram>> histograms;
+    };
+
+    Family& family(std::string const& _name, std::string const& _help, std::string const& _type);
+
+    mutable std::mutex x_families;
+    std::map<std::string, Family> m_families;
+};
+
+#define g_metrics dev::MetricsRegistry::instance()
+
+/// observe the ms from its construction to its destruction in a histogram
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram& _histogram);
+    ~ScopedTimer();
+
+private:
+    Histogram& m_histogram;
+    uint64_t m_start;
+};
+}  // namespace dev
@@ -0,0 +1,107 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : a notifier waking a thread waiting for work
+ *
+ * @file: Notifier.h
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include "Guards.h"
+#endif
+
+namespace dev
+{
+/**
+ * @brief Wakes the threads waiting for work. A notification bumps a sequence, a waiter passes the
+ * sequence it saw before looking for work, so that a notification arriving while it works is
+ * never lost. On linux the waiter sleeps on the sequence itself with a futex and a notification
+ * costs no syscall while nobody waits.
+ */
+class Notifier
+{
+public:
+    Notifier() = default;
+    Notifier(Notifier const&) = delete;
+    Notifier& operator=(Notifier const&) = delete;
+
+    uint32_t sequence() const { return m_sequence.load(); }
+
+    void notify()
+    {
+#if defined(__linux__)
+        m_sequence.fetch_add(1);
+        if (m_waiters.load() > 0)
+        {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_sequence), FUTEX_WAKE_PRIVATE,
+                INT32_MAX, nullptr, nullptr, 0);
+        }
+#else
+        {
+            Guard l(x_sequence);
+            m_sequence.fetch_add(1);
+        }
+        m_sequenceChanged.notify_all();
+#endif
+    }
+
+    /// wait until the sequence moves past _seen or _waitMs elapsed, returns whether it moved
+    bool wait(uint32_t _seen, unsigned _waitMs)
+    {
+        if (m_sequence.load() != _seen || _waitMs == 0)
+        {
+            return m_sequence.load() != _seen;
+        }
+#if defined(__linux__)
+        timespec timeout;
+        timeout.tv_sec = _waitMs / 1000;
+        timeout.tv_nsec = (_waitMs % 1000) * 1000000;
+        m_waiters.fetch_add(1);
+        // returns at once if the sequence moved since, an interrupted wait looks like a timeout
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_sequence), FUTEX_WAIT_PRIVATE, _seen,
+            &timeout, nullptr, 0);
+        m_waiters.fetch_sub(1);
+#else
+        std::unique_lock<Mutex> l(x_sequence);
+        m_sequenceChanged.wait_for(l, std::chrono::milliseconds(_waitMs),
+            [&]() { return m_sequence.load() != _seen; });
+#endif
+        return m_sequence.load() != _seen;
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+        "the futex waits on the sequence itself");
+    std::atomic<uint32_t> m_sequence = {0};
+#if defined(__linux__)
+    std::atomic<uint32_t> m_waiters = {0};
+#else
+    Mutex x_sequence;
+    std::condition_variable m_sequenceChanged;
+#endif
+};
+
+}  // namespace dev
@@ -25,6 +25,16 @@ namespace dev
 {
 namespace
 {
+// the suffixes of the keys of the reference count of a node and of the nodes unreferenced by
+// the state of a block
+const byte c_referencesSuffix = 254;
+const byte c_unreferencedSuffix = 253;
+// written before the first block of a db whose nodes are reference counted
+const std::string c_countedKey = "countedReferences";
+// the prefix of the keys of the flat entries, and the root of the state they are of
+const char c_flatPrefix = (char)251;
+const std::string c_flatRootKey = "flatStateRoot";
+
 inline db::Slice toSlice(h256 const& _h)
 {
     return db::Slice(reinterpret_cast<char const*>(_h.data()), _h.size);
@@ -40,15 +50,150 @@ inline db::Slice toSlice(bytes const& _b)
     return db::Slice(reinterpret_cast<char const*>(&_b[0]), _b.size());
 }
 
+inline bytes suffixed(h256 const& _h, byte _suffix)
+{
+    bytes b = _h.asBytes();
+    b.push_back(_suffix);
+    return b;
+}
+
+/// the references to _h and the block they dropped to 0 at, false if _h is not counted
+bool references(db::DatabaseFace const& _db, h256 const& _h, uint64_t& _count, uint64_t& _zeroAt)
+{
+    std::string const v = _db.lookup(toSlice(suffixed(_h, c_referencesSuffix)));
+    if (v.empty())
+        return false;
+    RLP r(v);
+    _count = r[0].toInt<uint64_t>();
+    _zeroAt = r[1].toInt<uint64_t>();
+    return true;
+}
+
 }  // namespace
 
 OverlayDB::~OverlayDB() = default;
 
-void OverlayDB::commit()
+void OverlayDB::setRetainBlocks(int64_t _retainBlocks)
+{
+    m_retainBlocks = 0;
+    if (!m_db)
+        return;
+    bool counted = m_db->exists(toSlice(c_countedKey));
+    if (_retainBlocks <= 0)
+    {
+        // the references of the next blocks are not counted, so the db is never pruned again
+        if (counted)
+            m_db->kill(toSlice(c_countedKey));
+        return;
+    }
+    if (!counted)
+    {
+        if (!emptyDB())
+        {
+            LOG(WARNING) << "The state db was written without reference counts, it is not pruned";
+            return;
+        }
+        m_db->insert(toSlice(c_countedKey), toSlice(std::string("1")));
+    }
+    m_retainBlocks = _retainBlocks;
+}
+
+bool OverlayDB::emptyDB() const
+{
+    bool empty = true;
+    m_db->forEach([&](db::Slice _key, db::Slice) {
+        auto const key = _key.toString();
+        empty = (key == c_countedKey || key == c_flatRootKey);
+        return empty;
+    });
+    return empty;
+}
+
+void OverlayDB::setFlatState(bool _enable)
+{
+    m_flatSnapshot.reset();
+    if (!m_db)
+        return;
+    std::string const root = m_db->lookup(toSlice(c_flatRootKey));
+    if (!_enable)
+    {
+        // the entries of the next blocks are not written, so they are never read again
+        if (!root.empty())
+            m_db->kill(toSlice(c_flatRootKey));
+        return;
+    }
+    auto snapshot = std::make_shared<FlatSnapshot>();
+    if (!root.empty())
+        snapshot->root = h256((byte const*)root.data(), h256::ConstructFromPointer);
+    else if (emptyDB())
+    {
+        snapshot->root = EmptyTrie;
+        m_db->insert(toSlice(c_flatRootKey), toSlice(snapshot->root));
+    }
+    else
+    {
+        LOG(WARNING) << "The state db was written without the flat state, the trie is read";
+        return;
+    }
+    m_flatSnapshot = snapshot;
+}
+
+void OverlayDB::openFlat(h256 const& _root)
+{
+#if DEV_GUARDED_DB
+    WriteGuard l(x_this);
+#endif
+    m_flat.clear();
+    m_flatBase = _root;
+    m_flatRoot = _root;
+}
+
+void OverlayDB::insertFlat(std::string const& _key, std::string const& _value)
+{
+#if DEV_GUARDED_DB
+    WriteGuard l(x_this);
+#endif
+    m_flat[_key] = _value;
+}
+
+bool OverlayDB::lookupFlat(std::string const& _key, std::string& _value) const
+{
+    if (!m_flatSnapshot)
+        return false;
+    {
+#if DEV_GUARDED_DB
+        ReadGuard l(x_this);
+#endif
+        auto it = m_flat.find(_key);
+        if (it != m_flat.end())
+        {
+            _value = it->second;
+            return true;
+        }
+    }
+    ReadGuard l(m_flatSnapshot->x_root);
+    if (m_flatSnapshot->root != m_flatBase)
+        return false;
+    _value = m_db->lookup(toSlice(c_flatPrefix + _key));
+    return true;
+}
+
+void OverlayDB::commit(int64_t _blockNumber)
 {
     if (m_db)
     {
         auto writeBatch = m_db->createWriteBatch();
+        h256s pruned;
+        // the flat entries are only read after the commit of the nodes of their state
+        WriteGuard flatGuard;
+        bool flat = false;
+        if (m_flatSnapshot)
+        {
+            flatGuard = WriteGuard(m_flatSnapshot->x_root);
+            flat = m_flatSnapshot->root == m_flatBase;
+            if (!flat && m_flatBase != m_flatRoot)
+                LOG(WARNING) << "The flat state is not of " << m_flatBase << ", it is not updated";
+        }
 //      cnote << "Committing nodes to disk DB:";
 #if DEV_GUARDED_DB
         DEV_READ_GUARDED(x_this)
@@ -67,6 +212,17 @@ void OverlayDB::commit()
                     b.push_back(255);  // for aux
                     writeBatch->insert(toSlice(b), toSlice(i.second.first));
                 }
+            if (m_retainBlocks > 0)
+                commitReferences(*writeBatch, _blockNumber, pruned);
+            if (flat)
+            {
+                for (auto const& i : m_flat)
+                    if (i.second.empty())
+                        writeBatch->kill(toSlice(c_flatPrefix + i.first));
+                    else
+                        writeBatch->insert(toSlice(c_flatPrefix + i.first), toSlice(i.second));
+                writeBatch->insert(toSlice(c_flatRootKey), toSlice(m_flatRoot));
+            }
         }
 
         for (unsigned i = 0; i < 10; ++i)
@@ -89,16 +245,87 @@ void OverlayDB::commit()
                 std::this_thread::sleep_for(std::chrono::seconds(i + 1));
             }
         }
+        if (flat)
+            m_flatSnapshot->root = m_flatRoot;
+        if (flatGuard.owns_lock())
+            flatGuard.unlock();
 #if DEV_GUARDED_DB
         DEV_WRITE_GUARDED(x_this)
 #endif
         {
+            // the nodes just written are those of the latest state, read by the next block
+            for (auto const& i : m_main)
+                if (i.second.second)
+                    m_nodeCache->store(i.first, i.second.first);
+            for (auto const& h : pruned)
+                m_nodeCache->remove(h);
             m_aux.clear();
             m_main.clear();
+            m_killed.clear();
+            m_flat.clear();
+            m_flatBase = m_flatRoot;
         }
     }
 }
 
+void OverlayDB::commitReferences(db::WriteBatchFace& _batch, int64_t _blockNumber, h256s& _pruned)
+{
+    // every insert of a node is a reference to it, every kill drops one
+    std::unordered_map<h256, int64_t> changes;
+    for (auto const& i : m_main)
+        if (i.second.second)
+            changes[i.first] += i.second.second;
+    for (auto const& h : m_killed)
+        --changes[h];
+
+    std::unordered_map<h256, uint64_t> counts;
+    h256s unreferenced;
+    for (auto const& change : changes)
+    {
+        uint64_t count = 0;
+        uint64_t zeroAt = 0;
+        if (change.second == 0 ||
+            (!references(*m_db, change.first, count, zeroAt) && change.second < 0))
+            continue;
+        count = (uint64_t)std::max<int64_t>((int64_t)count + change.second, 0);
+        RLPStream s(2);
+        s << count << (count == 0 ? (uint64_t)_blockNumber : 0);
+        _batch.insert(toSlice(suffixed(change.first, c_referencesSuffix)), toSlice(s.out()));
+        counts[change.first] = count;
+        if (count == 0)
+            unreferenced.push_back(change.first);
+    }
+    if (!unreferenced.empty())
+    {
+        RLPStream s;
+        s.appendVector(unreferenced);
+        _batch.insert(
+            toSlice(suffixed(h256(_blockNumber), c_unreferencedSuffix)), toSlice(s.out()));
+    }
+
+    // the nodes unreferenced since retainBlocks ago are read by no state kept
+    int64_t pruneNumber = _blockNumber - m_retainBlocks;
+    if (pruneNumber < 0)
+        return;
+    auto const key = suffixed(h256(pruneNumber), c_unreferencedSuffix);
+    std::string const journal = m_db->lookup(toSlice(key));
+    if (journal.empty())
+        return;
+    for (auto const& h : RLP(journal).toVector<h256>())
+    {
+        uint64_t count = 0;
+        uint64_t zeroAt = 0;
+        // referenced again, or unreferenced again in this block
+        if (counts.count(h) || !references(*m_db, h, count, zeroAt) || count > 0 ||
+            zeroAt > (uint64_t)pruneNumber)
+            continue;
+        _batch.kill(toSlice(h));
+        _batch.kill(toSlice(suffixed(h, c_referencesSuffix)));
+        _pruned.push_back(h);
+    }
+    _batch.kill(toSlice(key));
+}
+
 bytes OverlayDB::lookupAux(h256 const& _h) const
 {
     bytes ret = MemoryDB::lookupAux(_h);
@@ -120,6 +347,9 @@ void OverlayDB::rollback()
     WriteGuard l(x_this);
 #endif
     m_main.clear();
+    m_killed.clear();
+    m_flat.clear();
+    m_flatRoot = m_flatBase;
 }
 
 std::string OverlayDB::lookup(h256 const& _h) const
@@ -127,8 +357,13 @@ std::string OverlayDB::lookup(h256 const& _h) const
     std::string ret = MemoryDB::lookup(_h);
     if (!ret.empty() || !m_db)
         return ret;
+    if (m_nodeCache->get(_h, ret))
+        return ret;
 
-    return m_db->lookup(toSlice(_h));
+    ret = m_db->lookup(toSlice(_h));
+    if (!ret.empty())
+        m_nodeCache->store(_h, ret);
+    return ret;
 }
 
 bool OverlayDB::exists(h256 const& _h) const
@@ -144,6 +379,13 @@ void OverlayDB::kill(h256 const& _h)
     {
         if (m_db)
         {
+            if (m_retainBlocks > 0)
+            {
+#if DEV_GUARDED_DB
+                WriteGuard l(x_this);
+#endif
+                m_killed.push_back(_h);
+            }
             if (!m_db->exists(toSlice(_h)))
             {
                 // No point node ref decreasing for EmptyTrie since we never bother incrementing it
@@ -153,7 +395,6 @@ void OverlayDB::kill(h256 const& _h)
                         << "Decreasing DB node ref count below zero with no DB node. Probably "
                            "have a corrupt Trie."
                         << _h;
-                // TODO: for 1.1: ref-counted triedb.
             }
         }
     }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "MemoryDB.h"
+#include "TrieNodeCache.h"
 #include "dbfwd.h"
 #include <memory>
 
@@ -30,7 +31,9 @@ namespace dev
 class OverlayDB : public MemoryDB
 {
 public:
-    explicit OverlayDB(std::shared_ptr<db::DatabaseFace> _db = nullptr) { m_db = _db; }
+    explicit OverlayDB(std::shared_ptr<db::DatabaseFace> _db = nullptr)
+      : m_db(_db), m_nodeCache(std::make_shared<TrieNodeCache>())
+    {}
 
 
     ~OverlayDB();
@@ -42,7 +45,9 @@ public:
     OverlayDB(OverlayDB&&) = default;
     OverlayDB& operator=(OverlayDB&&) = default;
 
-    void commit();
+    /// writes the nodes to the db, with pruning the reference counts of the nodes too, the
+    /// nodes no longer referenced by the state of _blockNumber are deleted retainBlocks later
+    void commit(int64_t _blockNumber = 0);
     void rollback();
 
     std::string lookup(h256 const& _h) const;
@@ -51,10 +56,56 @@ public:
 
     bytes lookupAux(h256 const& _h) const;
 
+    /// bytes of the nodes read from the db kept in memory, shared by the copies made after it
+    void setNodeCacheCapacity(size_t _capacity)
+    {
+        m_nodeCache = std::make_shared<TrieNodeCache>(_capacity);
+    }
+    /// prunes the nodes unreferenced for _retainBlocks blocks, 0 keeps all. The reference counts
+    /// are kept from the first block on, so a db written without them is never pruned
+    void setRetainBlocks(int64_t _retainBlocks);
+    int64_t retainBlocks() const { return m_retainBlocks; }
+
+    /// keeps the accounts and the storage of the latest state as flat entries next to the trie,
+    /// from the first block on, so a db written without them keeps none
+    void setFlatState(bool _enable);
+    bool flatState() const { return m_flatSnapshot != nullptr; }
+    /// the flat entries are read for the state of _root, the entries changed are dropped
+    void openFlat(h256 const& _root);
+    /// an entry of the state changed, written with the nodes, an empty value removes it
+    void insertFlat(std::string const& _key, std::string const& _value);
+    /// the root of the state the entries changed bring the flat entries to
+    void setFlatRoot(h256 const& _root) { m_flatRoot = _root; }
+    /// false if the entries of the state opened are not kept, read the trie instead
+    bool lookupFlat(std::string const& _key, std::string& _value) const;
+
 private:
     using MemoryDB::clear;
 
+    /// adds the reference counts of the nodes of this commit to _batch, the pruned nodes are
+    /// appended to _pruned
+    void commitReferences(db::WriteBatchFace& _batch, int64_t _blockNumber, h256s& _pruned);
+    /// true if the db holds no more than the marks of the reference counts and the flat state
+    bool emptyDB() const;
+
+    /// the root of the state of the flat entries in the db, shared by the copies of the db
+    struct FlatSnapshot
+    {
+        SharedMutex x_root;
+        h256 root;
+    };
+
     std::shared_ptr<db::DatabaseFace> m_db;
+    std::shared_ptr<TrieNodeCache> m_nodeCache;
+    int64_t m_retainBlocks = 0;
+    // the nodes of the db killed since the last commit
+    h256s m_killed;
+    // null if the flat state is not kept
+    std::shared_ptr<FlatSnapshot> m_flatSnapshot;
+    // the flat entries changed since the last commit, from the state of m_flatBase to m_flatRoot
+    std::unordered_map<std::string, std::string> m_flat;
+    h256 m_flatBase;
+    h256 m_flatRoot;
 };
 
 }  // namespace dev
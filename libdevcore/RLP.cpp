@@ -241,11 +241,26 @@ size_t RLP::items() const
 
 RLPStream& RLPStream::appendRaw(bytesConstRef _s, size_t _itemCount)
 {
-    m_out.insert(m_out.end(), _s.begin(), _s.end());
+    if (m_measuring)
+        m_measured += _s.size();
+    else
+        m_out.insert(m_out.end(), _s.begin(), _s.end());
     noteAppended(_itemCount);
     return *this;
 }
 
+void RLPStream::startWriting()
+{
+    if (!m_measuring || !m_listStack.empty())
+        BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("nothing measured to write"));
+    m_out.clear();
+    m_out.reserve(m_measured);
+    m_measuring = false;
+    m_measured = 0;
+    m_presized = true;
+    m_nextList = 0;
+}
+
 void RLPStream::noteAppended(size_t _itemCount)
 {
     if (!_itemCount)
@@ -253,59 +268,89 @@ void RLPStream::noteAppended(size_t _itemCount)
     //	cdebug << "noteAppended(" << _itemCount << ")";
     while (m_listStack.size())
     {
-        if (m_listStack.back().first < _itemCount)
+        if (m_listStack.back().items < _itemCount)
             BOOST_THROW_EXCEPTION(RLPException()
                                   << errinfo_comment("itemCount too large")
                                   << RequirementError(
-                                         (bigint)m_listStack.back().first, (bigint)_itemCount));
-        m_listStack.back().first -= _itemCount;
-        if (m_listStack.back().first)
+                                         (bigint)m_listStack.back().items, (bigint)_itemCount));
+        m_listStack.back().items -= _itemCount;
+        if (m_listStack.back().items)
             break;
-        else
-        {
-            auto p = m_listStack.back().second;
-            m_listStack.pop_back();
-            size_t s = m_out.size() - p;  // list size
-            auto brs = bytesRequired(s);
-            unsigned encodeSize = s < c_rlpListImmLenCount ? 1 : (1 + brs);
-            //			cdebug << "s: " << s << ", p: " << p << ", m_out.size(): " << m_out.size()
-            //<<
-            //", encodeSize: " << encodeSize << " (br: " << brs << ")";
-            auto os = m_out.size();
-            m_out.resize(os + encodeSize);
-            memmove(m_out.data() + p + encodeSize, m_out.data() + p, os - p);
-            if (s < c_rlpListImmLenCount)
-                m_out[p] = (byte)(c_rlpListStart + s);
-            else if (c_rlpListIndLenZero + brs <= 0xff)
-            {
-                m_out[p] = (byte)(c_rlpListIndLenZero + brs);
-                byte* b = &(m_out[p + brs]);
-                for (; s; s >>= 8)
-                    *(b--) = (byte)s;
-            }
-            else
-                BOOST_THROW_EXCEPTION(
-                    RLPException() << errinfo_comment("itemCount too large for RLP"));
-        }
+        auto list = m_listStack.back();
+        m_listStack.pop_back();
+        closeList(list);
         _itemCount = 1;  // for all following iterations, we've effectively appended a single item
                          // only since we completed a list.
     }
 }
 
+void RLPStream::closeList(OpenList const& _list)
+{
+    size_t s = size() - _list.start;  // list size
+    auto brs = bytesRequired(s);
+    unsigned encodeSize = s < c_rlpListImmLenCount ? 1 : (1 + brs);
+    if (c_rlpListIndLenZero + brs > 0xff)
+        BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("itemCount too large for RLP"));
+    if (m_measuring)
+    {
+        m_listSizes[_list.index] = s;
+        m_measured += encodeSize;
+        return;
+    }
+    if (m_presized)
+    {
+        // the header is written already
+        if (s != m_listSizes[_list.index])
+            BOOST_THROW_EXCEPTION(
+                RLPException() << errinfo_comment("the list differs from the one measured"));
+        return;
+    }
+    auto p = _list.start;
+    auto os = m_out.size();
+    m_out.resize(os + encodeSize);
+    memmove(m_out.data() + p + encodeSize, m_out.data() + p, os - p);
+    if (s < c_rlpListImmLenCount)
+        m_out[p] = (byte)(c_rlpListStart + s);
+    else
+    {
+        m_out[p] = (byte)(c_rlpListIndLenZero + brs);
+        byte* b = &(m_out[p + brs]);
+        for (; s; s >>= 8)
+            *(b--) = (byte)s;
+    }
+}
+
 RLPStream& RLPStream::appendList(size_t _items)
 {
     //	cdebug << "appendList(" << _items << ")";
-    if (_items)
-        m_listStack.push_back(std::make_pair(_items, m_out.size()));
-    else
-        appendList(bytes());
+    if (!_items)
+        return appendList(bytes());
+    OpenList list{_items, size(), m_nextList};
+    if (m_measuring)
+    {
+        m_listSizes.push_back(0);
+        ++m_nextList;
+    }
+    else if (m_presized)
+    {
+        if (m_nextList == m_listSizes.size())
+            BOOST_THROW_EXCEPTION(
+                RLPException() << errinfo_comment("more lists than the ones measured"));
+        auto s = m_listSizes[m_nextList++];
+        if (s < c_rlpListImmLenCount)
+            pushByte((byte)(c_rlpListStart + s));
+        else
+            pushCount(s, c_rlpListIndLenZero);
+        list.start = size();
+    }
+    m_listStack.push_back(list);
     return *this;
 }
 
 RLPStream& RLPStream::appendList(bytesConstRef _rlp)
 {
     if (_rlp.size() < c_rlpListImmLenCount)
-        m_out.push_back((byte)(_rlp.size() + c_rlpListStart));
+        pushByte((byte)(_rlp.size() + c_rlpListStart));
     else
         pushCount(_rlp.size(), c_rlpListIndLenZero);
     appendRaw(_rlp, 1);
@@ -322,11 +367,11 @@ RLPStream& RLPStream::append(bytesConstRef _s, bool _compact)
         }
 
     if (s == 1 && *d < c_rlpDataImmLenStart)
-        m_out.push_back(*d);
+        pushByte(*d);
     else
     {
         if (s < c_rlpDataImmLenCount)
-            m_out.push_back((byte)(s + c_rlpDataImmLenStart));
+            pushByte((byte)(s + c_rlpDataImmLenStart));
         else
             pushCount(s, c_rlpDataIndLenZero);
         appendRaw(bytesConstRef(d, s), 0);
@@ -338,21 +383,21 @@ RLPStream& RLPStream::append(bytesConstRef _s, bool _compact)
 RLPStream& RLPStream::append(bigint _i)
 {
     if (!_i)
-        m_out.push_back(c_rlpDataImmLenStart);
+        pushByte(c_rlpDataImmLenStart);
     else if (_i < c_rlpDataImmLenStart)
-        m_out.push_back((byte)_i);
+        pushByte((byte)_i);
     else
     {
         unsigned br = bytesRequired(_i);
         if (br < c_rlpDataImmLenCount)
-            m_out.push_back((byte)(br + c_rlpDataImmLenStart));
+            pushByte((byte)(br + c_rlpDataImmLenStart));
         else
         {
             auto brbr = bytesRequired(br);
             if (c_rlpDataIndLenZero + brbr > 0xff)
                 BOOST_THROW_EXCEPTION(
                     RLPException() << errinfo_comment("Number too large for RLP"));
-            m_out.push_back((byte)(c_rlpDataIndLenZero + brbr));
+            pushByte((byte)(c_rlpDataIndLenZero + brbr));
             pushInt(br, brbr);
         }
         pushInt(_i, br);
@@ -366,7 +411,7 @@ void RLPStream::pushCount(size_t _count, byte _base)
     auto br = bytesRequired(_count);
     if (int(br) + _base > 0xff)
         BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("Count too large for RLP"));
-    m_out.push_back((byte)(br + _base));  // max 8 bytes.
+    pushByte((byte)(br + _base));  // max 8 bytes.
     pushInt(_count, br);
 }
 
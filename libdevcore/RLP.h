@@ -690,34 +690,77 @@ public:
     {
         m_out.clear();
         m_listStack.clear();
+        m_measuring = false;
+        m_measured = 0;
+        m_listSizes.clear();
+        m_presized = false;
+        m_nextList = 0;
     }
 
+    /// Measure the items appended from now on instead of writing them, see rlpEncode.
+    void startMeasuring()
+    {
+        clear();
+        m_measuring = true;
+    }
+    /// Write the items appended from now on, which must be the ones measured, into a buffer of
+    /// their exact size, each list header written before its items.
+    void startWriting();
+
+    /// The bytes written, or measured, so far.
+    size_t size() const { return m_measuring ? m_measured : m_out.size(); }
+
     /// Read the byte stream.
     bytes const& out() const
     {
-        if (!m_listStack.empty())
-            BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("listStack is not empty"));
+        checkComplete();
         return m_out;
     }
 
     /// Invalidate the object and steal the output byte stream.
     bytes&& invalidate()
     {
-        if (!m_listStack.empty())
-            BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("listStack is not empty"));
+        checkComplete();
         return std::move(m_out);
     }
 
     /// Swap the contents of the output stream out for some other byte array.
     void swapOut(bytes& _dest)
     {
-        if (!m_listStack.empty())
-            BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("listStack is not empty"));
+        checkComplete();
         swap(m_out, _dest);
     }
 
 private:
+    struct OpenList
+    {
+        /// the items still to be appended
+        size_t items;
+        /// where the items start
+        size_t start;
+        /// the index of the list in m_listSizes
+        size_t index;
+    };
+
+    void checkComplete() const
+    {
+        if (!m_listStack.empty())
+            BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("listStack is not empty"));
+        if (m_measuring)
+            BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("the stream only measures"));
+    }
+
     void noteAppended(size_t _itemCount = 1);
+    /// _list got all of its items, which start at _list.start
+    void closeList(OpenList const& _list);
+
+    void pushByte(byte _b)
+    {
+        if (m_measuring)
+            ++m_measured;
+        else
+            m_out.push_back(_b);
+    }
 
     /// Push the node-type byte (using @a _base) along with the item count @a _count.
     /// @arg _count is number of characters for strings, data-bytes for ints, or items for lists.
@@ -727,6 +770,11 @@ private:
     template <class _T>
     void pushInt(_T _i, size_t _br)
     {
+        if (m_measuring)
+        {
+            m_measured += _br;
+            return;
+        }
         m_out.resize(m_out.size() + _br);
         byte* b = &m_out.back();
         for (; _i; _i >>= 8)
@@ -736,9 +784,32 @@ private:
     /// Our output byte stream.
     bytes m_out;
 
-    std::vector<std::pair<size_t, size_t>> m_listStack;
+    std::vector<OpenList> m_listStack;
+
+    bool m_measuring = false;
+    size_t m_measured = 0;
+    /// the payload size of each list measured, in the order they are opened
+    std::vector<size_t> m_listSizes;
+    /// writing the lists of m_listSizes, their headers before their items
+    bool m_presized = false;
+    size_t m_nextList = 0;
 };
 
+/// Encode the items _encode(RLPStream&) appends into _out in two passes: the first measures them
+/// and the size of every list, the second writes them into a buffer of their exact size, so that
+/// closing a list moves nothing and the buffer never grows. _encode must append the same items
+/// both times.
+template <class Encode>
+void rlpEncode(bytes& _out, Encode const& _encode)
+{
+    RLPStream s;
+    s.startMeasuring();
+    _encode(s);
+    s.startWriting();
+    _encode(s);
+    s.swapOut(_out);
+}
+
 template <class _T>
 void rlpListAux(RLPStream& _out, _T _t)
 {
@@ -16,7 +16,8 @@
  */
 
 /**
- * @brief: threadpool obtained from libchannelserver/ThreadPool.h of FISCO-BCOS
+ * @brief: threadpool obtained from libchannelserver/ThreadPool.h of FISCO-BCOS, now a queue of
+ * the executor of the process
  *
  * @file ThreadPool.h
  * @author: yujiechen
@@ -24,6 +25,7 @@
  */
 
 #pragma once
+#include "Executor.h"
 #include "easylog.h"
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
@@ -33,46 +35,32 @@
 
 namespace dev
 {
+/// a queue of the tasks of a module on the workers of the process, running at most size of them
+/// at a time, instead of size threads of its own
 class ThreadPool
 {
 public:
     typedef std::shared_ptr<ThreadPool> Ptr;
 
-    explicit ThreadPool(const std::string& threadName, size_t size) : m_work(_ioService)
-    {
-        _threadName = threadName;
-
-        for (size_t i = 0; i < size; ++i)
-        {
-            _workers.create_thread([&] {
-                dev::pthread_setThreadName(_threadName);
-                _ioService.run();
-            });
-        }
-    }
-    void stop()
-    {
-        _ioService.stop();
-        if (!_workers.is_this_thread_in())
-        {
-            _workers.join_all();
-        }
-    }
+    explicit ThreadPool(const std::string& threadName, size_t size,
+        TaskPriority priority = TaskPriority::Normal)
+      : m_queue(g_executor.queue(threadName, priority, size))
+    {}
+    /// drop the pending tasks and wait for the running ones
+    void stop() { m_queue->stop(); }
+    /// the tasks run at a time
+    size_t size() const { return m_queue->concurrency(); }
     ~ThreadPool() { stop(); }
 
     // Add new work item to the pool.
     template <class F>
     void enqueue(F f)
     {
-        _ioService.post(f);
+        m_queue->post(std::move(f));
     }
 
 private:
-    std::string _threadName;
-    boost::thread_group _workers;
-    boost::asio::io_service _ioService;
-    // m_work ensures that io_service's run() function will not exit while work is underway
-    boost::asio::io_service::work m_work;
+    TaskQueue::Ptr m_queue;
 };
 
 }  // namespace dev
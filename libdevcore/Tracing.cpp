@@ -0,0 +1,168 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Tracing.cpp
+ *  @brief the time a block spends in each module, kept in a ring buffer and written in the trace
+ *  event format of chrome://tracing on demand
+ */
+#include "Tracing.h"
+#include "Common.h"
+#include "CommonIO.h"
+#include <boost/filesystem.hpp>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+
+Tracer& Tracer::instance()
+{
+    static Tracer s_tracer;
+    return s_tracer;
+}
+
+void Tracer::configure(bool _enabled, size_t _capacity, string const& _path)
+{
+    lock_guard<mutex> l(x_spans);
+    m_path = _path;
+    m_spans.assign(max(_capacity, (size_t)1), TraceSpan());
+    m_next = 0;
+    m_size = 0;
+    m_enabled = _enabled;
+}
+
+void Tracer::record(TraceSpan const& _span)
+{
+    lock_guard<mutex> l(x_spans);
+    if (m_spans.empty())
+    {
+        return;
+    }
+    m_spans[m_next] = _span;
+    m_next = (m_next + 1) % m_spans.size();
+    m_size = min(m_size + 1, m_spans.size());
+}
+
+void Tracer::recordSince(
+    char const* _name, int _groupId, int64_t _blockNumber, h256 const& _blockHash, uint64_t _start)
+{
+    if (!enabled() || _start == 0)
+    {
+        return;
+    }
+    TraceSpan span;
+    span.name = _name;
+    span.groupId = _groupId;
+    span.blockNumber = _blockNumber;
+    span.blockHash = _blockHash;
+    span.start = _start;
+    span.duration = utcTimeUs() - _start;
+    span.thread = threadId();
+    record(span);
+}
+
+vector<TraceSpan> Tracer::spans(int _groupId) const
+{
+    vector<TraceSpan> spans;
+    lock_guard<mutex> l(x_spans);
+    spans.reserve(m_size);
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        auto const& span = m_spans[(m_next + m_spans.size() - m_size + i) % m_spans.size()];
+        if (_groupId < 0 || span.groupId == _groupId)
+        {
+            spans.push_back(span);
+        }
+    }
+    return spans;
+}
+
+void Tracer::clear()
+{
+    lock_guard<mutex> l(x_spans);
+    m_next = 0;
+    m_size = 0;
+}
+
+string Tracer::chromeTrace(vector<TraceSpan> const& _spans)
+{
+    ostringstream trace;
+    trace << "{\"traceEvents\":[";
+    for (size_t i = 0; i < _spans.size(); ++i)
+    {
+        auto const& span = _spans[i];
+        trace << (i > 0 ? "," : "") << "{\"name\":\"" << span.name
+              << "\",\"ph\":\"X\",\"pid\":" << span.groupId << ",\"tid\":" << span.blockNumber
+              << ",\"ts\":" << span.start << ",\"dur\":" << span.duration
+              << ",\"args\":{\"hash\":\""
+              << (span.blockHash ? "0x" + span.blockHash.hex() : string()) << "\",\"thread\":"
+              << span.thread << "}}";
+    }
+    trace << "]}";
+    return trace.str();
+}
+
+string Tracer::exportTrace(int _groupId)
+{
+    string path;
+    {
+        lock_guard<mutex> l(x_spans);
+        path = m_path;
+    }
+    auto file = boost::filesystem::path(path) /
+                ("trace_g" + to_string(_groupId) + "_" + to_string(utcTime()) + ".json");
+    auto trace = chromeTrace(spans(_groupId));
+    writeFile(file, bytesConstRef((byte const*)trace.data(), trace.size()));
+    return file.string();
+}
+
+uint64_t Tracer::threadId()
+{
+    static std::atomic<uint64_t> s_next = {0};
+    thread_local uint64_t t_id = ++s_next;
+    return t_id;
+}
+
+BlockSpan::BlockSpan(
+    char const* _name, int _groupId, int64_t _blockNumber, h256 const& _blockHash)
+  : m_enabled(g_tracer.enabled())
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    m_span.name = _name;
+    m_span.groupId = _groupId;
+    m_span.blockNumber = _blockNumber;
+    m_span.blockHash = _blockHash;
+    m_span.start = utcTimeUs();
+}
+
+BlockSpan::~BlockSpan()
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    m_span.duration = utcTimeUs() - m_span.start;
+    m_span.thread = Tracer::threadId();
+    g_tracer.record(m_span);
+}
+
+void BlockSpan::setBlock(int64_t _blockNumber, h256 const& _blockHash)
+{
+    m_span.blockNumber = _blockNumber;
+    m_span.blockHash = _blockHash;
+}
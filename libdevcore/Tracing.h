@@ -0,0 +1,104 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file Tracing.h
+ *  @brief the time a block spends in each module, kept in a ring buffer and written in the trace
+ *  event format of chrome://tracing on demand
+ */
+#pragma once
+
+#include "FixedHash.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+/// the spans kept by default, the oldest are overwritten
+static const size_t c_traceCapacity = 65536;
+
+/// a phase of a block, e.g. its execution
+struct TraceSpan
+{
+    /// a literal, e.g. "pbft.execBlock"
+    char const* name = "";
+    int groupId = 0;
+    int64_t blockNumber = 0;
+    /// zero if unknown to the module, e.g. the transactions fetched before the block is sealed
+    h256 blockHash;
+    /// us since the epoch
+    uint64_t start = 0;
+    uint64_t duration = 0;
+    uint64_t thread = 0;
+};
+
+/// The spans of the blocks of all groups of the process. Recording takes a lock only to copy the
+/// span into the ring, and nothing when tracing is off.
+class Tracer
+{
+public:
+    static Tracer& instance();
+
+    /// keep the last _capacity spans, exportTrace writes the files under _path
+    void configure(bool _enabled, size_t _capacity, std::string const& _path);
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void record(TraceSpan const& _span);
+    /// record a span from _start us to now, e.g. the wait between two messages
+    void recordSince(char const* _name, int _groupId, int64_t _blockNumber,
+        h256 const& _blockHash, uint64_t _start);
+    /// the spans of the group, or of all groups if _groupId < 0, the oldest first
+    std::vector<TraceSpan> spans(int _groupId = -1) const;
+    void clear();
+
+    /// a process for each group and a thread for each block, so that a block reads on one line
+    static std::string chromeTrace(std::vector<TraceSpan> const& _spans);
+    /// write the spans of the group to a new file under the configured path and return the file,
+    /// throw FileError if it can't be written
+    std::string exportTrace(int _groupId);
+
+    /// an id of the calling thread
+    static uint64_t threadId();
+
+private:
+    std::atomic<bool> m_enabled = {false};
+    std::string m_path;
+    mutable std::mutex x_spans;
+    std::vector<TraceSpan> m_spans;
+    /// the slot written next and the slots written
+    size_t m_next = 0;
+    size_t m_size = 0;
+};
+
+#define g_tracer dev::Tracer::instance()
+
+/// record a span from its construction to its destruction if tracing is on
+class BlockSpan
+{
+public:
+    BlockSpan(char const* _name, int _groupId, int64_t _blockNumber,
+        h256 const& _blockHash = h256());
+    ~BlockSpan();
+
+    /// e.g. the hash of a block known once it is sealed
+    void setBlock(int64_t _blockNumber, h256 const& _blockHash);
+
+private:
+    bool m_enabled;
+    TraceSpan m_span;
+};
+}  // namespace dev
@@ -18,9 +18,14 @@
 #include "TrieHash.h"
 #include "TrieCommon.h"
 #include "TrieDB.h"  // @TODO replace ASAP!
+#include <tbb/parallel_for.h>
+#include <array>
 
 namespace dev
 {
+// branch nodes of at least this many items build their 16 subtrees concurrently
+static const size_t c_parallelTrieItems = 1024;
+
 void hash256aux(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
     unsigned _preLen, RLPStream& _rlp);
 
@@ -64,17 +69,45 @@ void hash256rlp(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_i
             auto b = _begin;
             if (_preLen == b->first.size())
                 ++b;
+            std::array<HexMap::const_iterator, 17> bounds;
+            size_t items = 0;
+            bounds[0] = b;
             for (auto i = 0; i < 16; ++i)
             {
-                auto n = b;
-                for (; n != _end && n->first[_preLen] == i; ++n)
+                auto n = bounds[i];
+                for (; n != _end && n->first[_preLen] == i; ++n, ++items)
+                {
+                }
+                bounds[i + 1] = n;
+            }
+
+            if (items >= c_parallelTrieItems)
+            {
+                // every branch is one item, the encoded branches are appended in order, so the
+                // node is the same as the sequential one
+                std::array<RLPStream, 16> branches;
+                tbb::parallel_for(
+                    tbb::blocked_range<int>(0, 16, 1), [&](const tbb::blocked_range<int>& _r) {
+                        for (int i = _r.begin(); i != _r.end(); ++i)
+                        {
+                            if (bounds[i] == bounds[i + 1])
+                                branches[i] << "";
+                            else
+                                hash256aux(_s, bounds[i], bounds[i + 1], _preLen + 1, branches[i]);
+                        }
+                    });
+                for (auto i = 0; i < 16; ++i)
+                    _rlp.appendRaw(branches[i].out());
+            }
+            else
+            {
+                for (auto i = 0; i < 16; ++i)
                 {
+                    if (bounds[i] == bounds[i + 1])
+                        _rlp << "";
+                    else
+                        hash256aux(_s, bounds[i], bounds[i + 1], _preLen + 1, _rlp);
                 }
-                if (b == n)
-                    _rlp << "";
-                else
-                    hash256aux(_s, b, n, _preLen + 1, _rlp);
-                b = n;
             }
             if (_preLen == _begin->first.size())
                 _rlp << _begin->second;
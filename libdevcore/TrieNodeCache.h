@@ -0,0 +1,110 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the trie nodes read from the state db
+ *
+ * @file: TrieNodeCache.h
+ */
+
+#pragma once
+
+#include "FixedHash.h"
+#include "Guards.h"
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace dev
+{
+/**
+ * @brief Thread-safe cache from the hash of a trie node to its rlp. A node never changes under
+ * its hash, so a cached node stays valid until it is pruned from the db. Once the cached nodes
+ * exceed the capacity, the least recently used node is removed, a capacity of 0 disables it.
+ */
+class TrieNodeCache
+{
+public:
+    typedef std::shared_ptr<TrieNodeCache> Ptr;
+
+    TrieNodeCache(size_t _capacity = c_defaultCapacity) : m_capacity(_capacity) {}
+
+    bool get(h256 const& _hash, std::string& _node)
+    {
+        Guard g(x_cache);
+        auto it = m_index.find(_hash);
+        if (it == m_index.end())
+            return false;
+
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        _node = it->second->second;
+        return true;
+    }
+
+    void store(h256 const& _hash, std::string const& _node)
+    {
+        if (m_capacity == 0 || _node.size() > m_capacity)
+            return;
+        Guard g(x_cache);
+        auto it = m_index.find(_hash);
+        if (it != m_index.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return;
+        }
+
+        m_lru.emplace_front(_hash, _node);
+        m_index[_hash] = m_lru.begin();
+        m_size += _node.size();
+
+        while (m_size > m_capacity)
+        {
+            auto& last = m_lru.back();
+            m_size -= last.second.size();
+            m_index.erase(last.first);
+            m_lru.pop_back();
+        }
+    }
+
+    void remove(h256 const& _hash)
+    {
+        Guard g(x_cache);
+        auto it = m_index.find(_hash);
+        if (it == m_index.end())
+            return;
+        m_size -= it->second->second.size();
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    size_t size() const
+    {
+        Guard g(x_cache);
+        return m_lru.size();
+    }
+
+    // bytes of the cached nodes
+    static const size_t c_defaultCapacity = 64 * 1024 * 1024;
+
+private:
+    size_t m_capacity;
+    size_t m_size = 0;
+    mutable Mutex x_cache;
+    std::list<std::pair<h256, std::string>> m_lru;
+    std::unordered_map<h256, std::list<std::pair<h256, std::string>>::iterator> m_index;
+};
+
+}  // namespace dev
@@ -19,6 +19,7 @@
  * @date 2014
  */
 #include "Worker.h"
+#include "Affinity.h"
 #include "Common.h"
 #include "easylog.h"
 #include <pthread.h>
@@ -66,6 +67,7 @@ void Worker::startWorking()
             }
 #endif
             setThreadName(m_name.c_str());
+            g_cpuAffinity.bindThread(m_name);
             while (m_state != WorkerState::Killing)
             {
                 WorkerState ex = WorkerState::Starting;
@@ -122,6 +124,7 @@ void Worker::stopWorking()
         if (!m_state.compare_exchange_strong(ex, WorkerState::Stopping))
             return;
         m_state_notifier.notify_all();
+        m_workNotifier.notify();
 
         DEV_TIMED_ABOVE("Stop worker", 100)
         while (m_state != WorkerState::Stopped)
@@ -140,6 +143,7 @@ void Worker::terminate()
             return;  // Somebody else is doing this
         l.unlock();
         m_state_notifier.notify_all();
+        m_workNotifier.notify();
         DEV_TIMED_ABOVE("Terminate worker", 100)
         m_work->join();
 
@@ -153,7 +157,7 @@ void Worker::workLoop()
     while (m_state == WorkerState::Started)
     {
         if (m_idleWaitMs)
-            this_thread::sleep_for(chrono::milliseconds(m_idleWaitMs));
+            waitForWork(m_idleWaitMs);
         doWork();
     }
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Guards.h"
+#include "Notifier.h"
 #include <atomic>
 #include <string>
 #include <thread>
@@ -91,9 +92,20 @@ protected:
     /// Called after thread is started from startWorking().
     virtual void startedWorking() {}
 
-    /// Called continuously following sleep for m_idleWaitMs.
+    /// Called continuously following a wait of up to m_idleWaitMs, notifyWork() ends the wait.
     virtual void doWork() {}
 
+    /// Wakes the worker thread waiting in workLoop() or in waitForWork(), callable from any thread.
+    void notifyWork() { m_workNotifier.notify(); }
+
+    /// Waits for notifyWork() since the last wait, _waitMs is the fallback for the timers.
+    /// Only called by the worker thread.
+    void waitForWork(unsigned _waitMs)
+    {
+        m_workNotifier.wait(m_workSeen, _waitMs);
+        m_workSeen = m_workNotifier.sequence();
+    }
+
     /// Overrides doWork(); should call shouldStop() often and exit when true.
     virtual void workLoop();
     bool shouldStop() const { return m_state != WorkerState::Started; }
@@ -122,6 +134,10 @@ private:
     std::unique_ptr<std::thread> m_work;  ///< The network thread.
     mutable std::condition_variable m_state_notifier;  //< Notification when m_state changes.
     std::atomic<WorkerState> m_state = {WorkerState::Starting};
+
+    Notifier m_workNotifier;
+    /// the sequence of m_workNotifier seen by the last wait of the worker thread
+    uint32_t m_workSeen = 0;
 };
 
 }  // namespace dev
@@ -15,9 +15,19 @@
     along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include "Notifier.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <queue>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
 
@@ -70,4 +80,428 @@ private:
     std::condition_variable m_cv;
 };
 
+namespace detail
+{
+/// the cache line the indices of a ring are alone on, so that producers and consumers don't
+/// invalidate each other's
+static const size_t c_cacheLine = 64;
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/// wait for the slot of a ring claimed by another thread, which is writing or reading it
+inline void spinUntil(std::atomic<size_t> const& _sequence, size_t _value)
+{
+    for (unsigned i = 0; _sequence.load(std::memory_order_acquire) != _value; ++i)
+    {
+        if (i < 64)
+        {
+            cpuRelax();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/// The consumers of a ring spin for a while, then park on a notifier. A producer only wakes them,
+/// with a syscall, if one is parked.
+class Parking
+{
+public:
+    /// called by the producers after the items are published
+    void unpark()
+    {
+        // pairs with the increment of m_parked before a consumer looks at the ring once more
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_parked.load(std::memory_order_relaxed) > 0)
+        {
+            m_notifier.notify();
+        }
+    }
+
+    /// wait until _ready() or _waitMs elapsed, returns the last _ready()
+    template <class Ready>
+    bool await(Ready _ready, unsigned _waitMs)
+    {
+        for (unsigned i = 0; i < c_spins; ++i)
+        {
+            if (_ready())
+            {
+                return true;
+            }
+            cpuRelax();
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_waitMs);
+        while (true)
+        {
+            auto seen = m_notifier.sequence();
+            m_parked.fetch_add(1);
+            if (_ready())
+            {
+                m_parked.fetch_sub(1);
+                return true;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                m_parked.fetch_sub(1);
+                return false;
+            }
+            auto left =
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            m_notifier.wait(seen, (unsigned)left + 1);
+            m_parked.fetch_sub(1);
+        }
+    }
+
+private:
+    static const unsigned c_spins = 128;
+    Notifier m_notifier;
+    std::atomic<uint32_t> m_parked = {0};
+};
+
+inline size_t roundUpPowerOfTwo(size_t _n)
+{
+    size_t capacity = 2;
+    while (capacity < _n)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+}  // namespace detail
+
+/**
+ * @brief A bounded ring of one producer and one consumer, which push and pop without a lock and
+ * without an atomic read-modify-write: each side owns its index and reads the other's only when
+ * its cached copy says the ring is full or empty.
+ */
+template <typename _T>
+class SPSCQueue
+{
+public:
+    /// _capacity rounded up to a power of 2
+    explicit SPSCQueue(size_t _capacity)
+      : m_capacity(detail::roundUpPowerOfTwo(_capacity)),
+        m_mask(m_capacity - 1),
+        m_slots(new Slot[m_capacity])
+    {}
+    SPSCQueue(SPSCQueue const&) = delete;
+    SPSCQueue& operator=(SPSCQueue const&) = delete;
+    ~SPSCQueue()
+    {
+        for (auto pos = m_head.load(); pos != m_tail.load(); ++pos)
+        {
+            reinterpret_cast<_T*>(&m_slots[pos & m_mask])->~_T();
+        }
+    }
+
+    /// false if the ring is full
+    template <typename _U>
+    bool tryPush(_U&& _item)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == m_capacity)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == m_capacity)
+            {
+                return false;
+            }
+        }
+        new (&m_slots[tail & m_mask]) _T(std::forward<_U>(_item));
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_parking.unpark();
+        return true;
+    }
+
+    /// move the items of [_begin, _end) the ring has room for, returns how many
+    template <typename _It>
+    size_t tryPushBatch(_It _begin, _It _end)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        size_t count = std::distance(_begin, _end);
+        if (m_capacity - (tail - m_headCache) < count)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+        }
+        count = std::min(count, m_capacity - (tail - m_headCache));
+        for (size_t i = 0; i < count; ++i, ++_begin)
+        {
+            new (&m_slots[(tail + i) & m_mask]) _T(std::move(*_begin));
+        }
+        if (count > 0)
+        {
+            m_tail.store(tail + count, std::memory_order_release);
+            m_parking.unpark();
+        }
+        return count;
+    }
+
+    /// false if the ring is empty
+    bool tryPop(_T& _item) { return tryPopBatch(&_item, 1) == 1; }
+
+    /// move at most _max items to _out, returns how many
+    template <typename _Out>
+    size_t tryPopBatch(_Out _out, size_t _max)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (m_tailCache - head < _max)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+        }
+        auto count = std::min(_max, m_tailCache - head);
+        for (size_t i = 0; i < count; ++i, ++_out)
+        {
+            auto item = reinterpret_cast<_T*>(&m_slots[(head + i) & m_mask]);
+            *_out = std::move(*item);
+            item->~_T();
+        }
+        if (count > 0)
+        {
+            m_head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// spin, then park until an item is pushed or _waitMs elapsed
+    bool pop(_T& _item, unsigned _waitMs)
+    {
+        return m_parking.await([&]() { return tryPop(_item); }, _waitMs);
+    }
+
+    size_t size() const
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    typedef typename std::aligned_storage<sizeof(_T), alignof(_T)>::type Slot;
+
+    size_t const m_capacity;
+    size_t const m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    detail::Parking m_parking;
+
+    char m_padding0[detail::c_cacheLine];
+    /// written by the consumer
+    std::atomic<size_t> m_head = {0};
+    size_t m_tailCache = 0;
+    char m_padding1[detail::c_cacheLine];
+    /// written by the producer
+    std::atomic<size_t> m_tail = {0};
+    size_t m_headCache = 0;
+    char m_padding2[detail::c_cacheLine];
+};
+
+/**
+ * @brief A bounded ring of any producers and consumers. Each slot carries a sequence telling the
+ * lap it's free or full for, so that a thread claims a slot, or a batch of them, with a single
+ * compare-and-swap of the index of its side, and the two sides contend only when the ring is
+ * nearly empty or full (D. Vyukov's bounded MPMC queue).
+ */
+template <typename _T>
+class MPMCQueue
+{
+public:
+    /// _capacity rounded up to a power of 2
+    explicit MPMCQueue(size_t _capacity)
+      : m_capacity(detail::roundUpPowerOfTwo(_capacity)),
+        m_mask(m_capacity - 1),
+        m_cells(new Cell[m_capacity])
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MPMCQueue(MPMCQueue const&) = delete;
+    MPMCQueue& operator=(MPMCQueue const&) = delete;
+    ~MPMCQueue()
+    {
+        for (auto pos = m_dequeuePos.load(); pos != m_enqueuePos.load(); ++pos)
+        {
+            reinterpret_cast<_T*>(&m_cells[pos & m_mask].storage)->~_T();
+        }
+    }
+
+    /// false if the ring is full
+    template <typename _U>
+    bool tryPush(_U&& _item)
+    {
+        auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            auto diff = (intptr_t)cell->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) _T(std::forward<_U>(_item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        m_parking.unpark();
+        return true;
+    }
+
+    /// move the items of [_begin, _end) the ring has room for, returns how many
+    template <typename _It>
+    size_t tryPushBatch(_It _begin, _It _end)
+    {
+        size_t wanted = std::distance(_begin, _end);
+        size_t pos;
+        size_t count;
+        while (true)
+        {
+            // the consumers never pass the producers, read in this order dequeue <= pos
+            auto dequeue = m_dequeuePos.load(std::memory_order_acquire);
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+            if (pos - dequeue > m_capacity)
+            {
+                // the consumers and then the producers moved on between the two loads
+                continue;
+            }
+            count = std::min(wanted, m_capacity - (pos - dequeue));
+            if (count == 0)
+            {
+                return 0;
+            }
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i, ++_begin)
+        {
+            auto& cell = m_cells[(pos + i) & m_mask];
+            // a consumer of the last lap may still be moving the item out
+            detail::spinUntil(cell.sequence, pos + i);
+            new (&cell.storage) _T(std::move(*_begin));
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        m_parking.unpark();
+        return count;
+    }
+
+    /// false if the ring is empty
+    bool tryPop(_T& _item)
+    {
+        auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            auto diff =
+                (intptr_t)cell->sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        release(*cell, pos, _item);
+        return true;
+    }
+
+    /// move at most _max items to _out, returns how many
+    template <typename _Out>
+    size_t tryPopBatch(_Out _out, size_t _max)
+    {
+        size_t pos;
+        size_t count;
+        do
+        {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+            count = std::min(_max, m_enqueuePos.load(std::memory_order_acquire) - pos);
+            if (count == 0)
+            {
+                return 0;
+            }
+        } while (!m_dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed));
+        for (size_t i = 0; i < count; ++i, ++_out)
+        {
+            auto& cell = m_cells[(pos + i) & m_mask];
+            // the producer of the slot may still be writing it
+            detail::spinUntil(cell.sequence, pos + i + 1);
+            release(cell, pos + i, *_out);
+        }
+        return count;
+    }
+
+    /// spin, then park until an item is pushed or _waitMs elapsed
+    bool pop(_T& _item, unsigned _waitMs)
+    {
+        return m_parking.await([&]() { return tryPop(_item); }, _waitMs);
+    }
+
+    /// the items claimed by the producers and not yet by the consumers
+    size_t size() const
+    {
+        auto dequeue = m_dequeuePos.load(std::memory_order_acquire);
+        return m_enqueuePos.load(std::memory_order_acquire) - dequeue;
+    }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(_T), alignof(_T)>::type storage;
+    };
+
+    /// move the item of the slot _pos out and free the slot for the next lap
+    template <typename _Item>
+    void release(Cell& _cell, size_t _pos, _Item&& _item)
+    {
+        auto item = reinterpret_cast<_T*>(&_cell.storage);
+        _item = std::move(*item);
+        item->~_T();
+        _cell.sequence.store(_pos + m_capacity, std::memory_order_release);
+    }
+
+    size_t const m_capacity;
+    size_t const m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    detail::Parking m_parking;
+
+    char m_padding0[detail::c_cacheLine];
+    std::atomic<size_t> m_enqueuePos = {0};
+    char m_padding1[detail::c_cacheLine];
+    std::atomic<size_t> m_dequeuePos = {0};
+    char m_padding2[detail::c_cacheLine];
+};
+
 }  // namespace dev
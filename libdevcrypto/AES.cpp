@@ -28,6 +28,8 @@
 #include <cryptopp/sha.h>
 #include <libdevcore/easylog.h>
 #include <stdlib.h>
+#include <string.h>
+#include <memory>
 #include <string>
 
 
@@ -37,33 +39,63 @@ using namespace dev::crypto;
 using namespace std;
 
 
+namespace
+{
+/// the key schedules of the last key used by the thread, set up once for the values encrypted
+/// with the data key of the disk encryption, the block cipher uses AES-NI where the cpu has it
+struct AESSchedule
+{
+    bytes key;
+    unique_ptr<CryptoPP::AES::Encryption> encryption;
+    unique_ptr<CryptoPP::AES::Decryption> decryption;
+};
+
+AESSchedule& aesSchedule(bytesConstRef _key)
+{
+    thread_local AESSchedule t_schedule;
+    if (!t_schedule.encryption || t_schedule.key != _key.toBytes())
+    {
+        t_schedule.key = _key.toBytes();
+        t_schedule.encryption.reset(new CryptoPP::AES::Encryption(_key.data(), _key.size()));
+        t_schedule.decryption.reset(new CryptoPP::AES::Decryption(_key.data(), _key.size()));
+    }
+    return t_schedule;
+}
+}  // namespace
+
 bytes dev::aesCBCEncrypt(bytesConstRef _plainData, bytesConstRef _key)
 {
     bytesConstRef ivData = _key.cropped(0, 16);
-    string cipherData;
-    CryptoPP::AES::Encryption aesEncryption(_key.data(), _key.size());
-    CryptoPP::CBC_Mode_ExternalCipher::Encryption cbcEncryption(aesEncryption, ivData.data());
-    CryptoPP::StreamTransformationFilter stfEncryptor(
-        cbcEncryption, new CryptoPP::StringSink(cipherData));
-    stfEncryptor.Put(_plainData.data(), _plainData.size());
-    stfEncryptor.MessageEnd();
-    return asBytes(cipherData);
+    auto& schedule = aesSchedule(_key);
+    // PKCS#7 padding, as the StreamTransformationFilter did
+    size_t padding = 16 - _plainData.size() % 16;
+    bytes cipherData(_plainData.size() + padding, (byte)padding);
+    memcpy(cipherData.data(), _plainData.data(), _plainData.size());
+    CryptoPP::CBC_Mode_ExternalCipher::Encryption cbcEncryption(
+        *schedule.encryption, ivData.data());
+    cbcEncryption.ProcessData(cipherData.data(), cipherData.data(), cipherData.size());
+    return cipherData;
 }
 
 bytes dev::aesCBCDecrypt(bytesConstRef _cypherData, bytesConstRef _key)
 {
-    bytes ivData = _key.cropped(0, 16).toBytes();
-    // bytesConstRef ivData = _key.cropped(0, 16);
-    // LOG(DEBUG)<<"AES DE TYPE....................";
-    string decryptedData;
-    CryptoPP::AES::Decryption aesDecryption(_key.data(), _key.size());
-    CryptoPP::CBC_Mode_ExternalCipher::Decryption cbcDecryption(aesDecryption, ref(ivData).data());
-    CryptoPP::StreamTransformationFilter stfDecryptor(
-        cbcDecryption, new CryptoPP::StringSink(decryptedData));
-    // stfDecryptor.Put( reinterpret_cast<const unsigned char*>( cipherData.c_str() ),cipherLen);
-    stfDecryptor.Put(_cypherData.data(), _cypherData.size());
-    stfDecryptor.MessageEnd();
-    return asBytes(decryptedData);
+    if (_cypherData.empty() || _cypherData.size() % 16 != 0)
+    {
+        BOOST_THROW_EXCEPTION(CryptoException() << errinfo_comment("invalid AES cipher length"));
+    }
+    bytesConstRef ivData = _key.cropped(0, 16);
+    auto& schedule = aesSchedule(_key);
+    bytes decryptedData(_cypherData.size());
+    CryptoPP::CBC_Mode_ExternalCipher::Decryption cbcDecryption(
+        *schedule.decryption, ivData.data());
+    cbcDecryption.ProcessData(decryptedData.data(), _cypherData.data(), _cypherData.size());
+    size_t padding = decryptedData.back();
+    if (padding == 0 || padding > 16)
+    {
+        BOOST_THROW_EXCEPTION(CryptoException() << errinfo_comment("invalid AES padding"));
+    }
+    decryptedData.resize(decryptedData.size() - padding);
+    return decryptedData;
 }
 
 bytes dev::readableKeyBytes(const std::string& _readableKey)
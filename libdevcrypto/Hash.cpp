@@ -23,6 +23,7 @@
 #include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
 #include <secp256k1_sha256.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -186,6 +187,176 @@ bool sha3(bytesConstRef _input, bytesRef o_output)
     return true;
 }
 
+namespace
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+const size_t c_rate = 200 - 256 / 4;
+
+typedef uint64_t Lanes4 __attribute__((vector_size(32)));
+typedef uint64_t Lanes8 __attribute__((vector_size(64)));
+
+#define rolLanes(x, s) (((x) << (s)) | ((x) >> (64 - (s))))
+#define thetaLanes(x)                                \
+    t = b[(x + 4) % 5] ^ rolLanes(b[(x + 1) % 5], 1); \
+    a[x] ^= t;                                        \
+    a[x + 5] ^= t;                                    \
+    a[x + 10] ^= t;                                   \
+    a[x + 15] ^= t;                                   \
+    a[x + 20] ^= t;
+#define rhoPi(j, s)        \
+    c = a[j];              \
+    a[j] = rolLanes(t, s); \
+    t = c;
+#define chiLanes(y)                      \
+    b[0] = a[y];                         \
+    b[1] = a[y + 1];                     \
+    b[2] = a[y + 2];                     \
+    b[3] = a[y + 3];                     \
+    b[4] = a[y + 4];                     \
+    a[y] = b[0] ^ ((~b[1]) & b[2]);      \
+    a[y + 1] = b[1] ^ ((~b[2]) & b[3]);  \
+    a[y + 2] = b[2] ^ ((~b[3]) & b[4]);  \
+    a[y + 3] = b[3] ^ ((~b[4]) & b[0]);  \
+    a[y + 4] = b[4] ^ ((~b[0]) & b[1]);
+
+/// Keccak-f[1600] over the states of several inputs, lane l of each word belongs to input l
+template <typename V>
+inline __attribute__((always_inline)) void keccakfLanes(V* a)
+{
+    V b[5];
+    V c;
+    V t;
+    for (int i = 0; i < 24; i++)
+    {
+        // Theta
+        for (size_t x = 0; x < 5; ++x)
+            b[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        thetaLanes(0) thetaLanes(1) thetaLanes(2) thetaLanes(3) thetaLanes(4)
+        // Rho and pi, the unrolled keccak::pi and keccak::rho
+        t = a[1];
+        rhoPi(10, 1) rhoPi(7, 3) rhoPi(11, 6) rhoPi(17, 10) rhoPi(18, 15) rhoPi(3, 21)
+            rhoPi(5, 28) rhoPi(16, 36) rhoPi(8, 45) rhoPi(21, 55) rhoPi(24, 2) rhoPi(4, 14)
+                rhoPi(15, 27) rhoPi(23, 41) rhoPi(19, 56) rhoPi(13, 8) rhoPi(12, 25)
+                    rhoPi(2, 43) rhoPi(20, 62) rhoPi(14, 18) rhoPi(22, 39) rhoPi(9, 61)
+                        rhoPi(6, 20) rhoPi(1, 44)
+        // Chi
+        chiLanes(0) chiLanes(5) chiLanes(10) chiLanes(15) chiLanes(20)
+        // Iota
+        a[0] ^= keccak::RC[i];
+    }
+}
+
+/// the sponge of keccak::hash over up to W inputs, the shorter ones stop absorbing early
+template <typename V, size_t W>
+inline __attribute__((always_inline)) void sha3Lanes(
+    bytesConstRef const* _inputs, h256* o_outputs, size_t _size)
+{
+    V a[25] = {};
+    size_t blocks[W] = {0};
+    size_t maxBlocks = 0;
+    for (size_t l = 0; l < _size; ++l)
+    {
+        blocks[l] = _inputs[l].size() / c_rate + 1;
+        maxBlocks = std::max(maxBlocks, blocks[l]);
+    }
+    for (size_t j = 0; j < maxBlocks; ++j)
+    {
+        for (size_t l = 0; l < _size; ++l)
+        {
+            if (j >= blocks[l])
+                continue;
+            byte const* block = _inputs[l].data() + j * c_rate;
+            byte last[c_rate];
+            if (j + 1 == blocks[l])
+            {
+                // the last block carries the padding
+                size_t remain = _inputs[l].size() - j * c_rate;
+                memset(last, 0, c_rate);
+                if (remain > 0)
+                    memcpy(last, block, remain);
+                last[remain] ^= 0x01;
+                last[c_rate - 1] ^= 0x80;
+                block = last;
+            }
+            for (size_t k = 0; k < c_rate / 8; ++k)
+            {
+                uint64_t word;
+                memcpy(&word, block + 8 * k, 8);
+                a[k][l] ^= word;
+            }
+        }
+        keccakfLanes(a);
+        for (size_t l = 0; l < _size; ++l)
+        {
+            if (j + 1 == blocks[l])
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    uint64_t word = a[k][l];
+                    memcpy(o_outputs[l].data() + 8 * k, &word, 8);
+                }
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void sha3LanesAVX2(
+    bytesConstRef const* _inputs, h256* o_outputs, size_t _size)
+{
+    sha3Lanes<Lanes4, 4>(_inputs, o_outputs, _size);
+}
+
+__attribute__((target("avx512f"))) void sha3LanesAVX512(
+    bytesConstRef const* _inputs, h256* o_outputs, size_t _size)
+{
+    sha3Lanes<Lanes8, 8>(_inputs, o_outputs, _size);
+}
+
+/// @return how many inputs one call hashes together, 1 if the CPU has no wide vectors
+size_t sha3LaneCount()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return 8;
+    if (__builtin_cpu_supports("avx2"))
+        return 4;
+    return 1;
+}
+#endif
+}  // namespace
+
+void sha3Batch(std::vector<bytesConstRef> const& _inputs, h256* o_outputs)
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    static const size_t lanes = sha3LaneCount();
+    if (lanes > 1 && _inputs.size() > 1)
+    {
+        // hash inputs of the same number of blocks together, no lane idles for long
+        std::vector<size_t> order(_inputs.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t _a, size_t _b) {
+            return _inputs[_a].size() / c_rate < _inputs[_b].size() / c_rate;
+        });
+        bytesConstRef inputs[8];
+        h256 outputs[8];
+        for (size_t i = 0; i < order.size(); i += lanes)
+        {
+            size_t size = std::min(lanes, order.size() - i);
+            for (size_t l = 0; l < size; ++l)
+                inputs[l] = _inputs[order[i + l]];
+            if (lanes == 8)
+                sha3LanesAVX512(inputs, outputs, size);
+            else
+                sha3LanesAVX2(inputs, outputs, size);
+            for (size_t l = 0; l < size; ++l)
+                o_outputs[order[i + l]] = outputs[l];
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < _inputs.size(); ++i)
+        sha3(_inputs[i], o_outputs[i].ref());
+}
+
 // add sha2 -- sha256 to this file begin
 h256 sha256(bytesConstRef _input) noexcept
 {
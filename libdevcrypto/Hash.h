@@ -26,6 +26,7 @@
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/vector_ref.h>
 #include <string>
+#include <vector>
 
 namespace dev
 {
@@ -35,6 +36,11 @@ namespace dev
 /// @returns false if o_output.size() != 32.
 bool sha3(bytesConstRef _input, bytesRef o_output);
 
+/// Calculate the SHA3-256 hashes of many independent inputs at once and load them into
+/// o_outputs, which must hold _inputs.size() hashes. The inputs are hashed in SIMD lanes when
+/// the CPU supports it.
+void sha3Batch(std::vector<bytesConstRef> const& _inputs, h256* o_outputs);
+
 // sha2 - sha256 replace Hash.h begin
 h256 sha256(bytesConstRef _input) noexcept;
 // sha2 - sha256 replace Hash.h end
@@ -65,6 +71,13 @@ inline SecureFixedHash<32> sha3Secure(bytes const& _input)
     return sha3Secure(bytesConstRef(&_input));
 }
 
+inline std::vector<h256> sha3Batch(std::vector<bytesConstRef> const& _inputs)
+{
+    std::vector<h256> ret(_inputs.size());
+    sha3Batch(_inputs, ret.data());
+    return ret;
+}
+
 /// Calculate SHA3-256 hash of the given input (presented as a binary-filled string), returning as a
 /// 256-bit hash.
 inline h256 sha3(std::string const& _input)
@@ -32,31 +32,50 @@ using namespace dev::crypto;
 using namespace std;
 
 
+namespace
+{
+/// the key schedule of the last key used by the thread, set up once for the values encrypted
+/// with the data key of the disk encryption, a schedule shared by the threads would be
+/// overwritten by another key
+SM4& sm4(bytesConstRef _key)
+{
+    thread_local SM4 t_sm4;
+    thread_local bytes t_key;
+    if (t_key != _key.toBytes())
+    {
+        t_key = _key.toBytes();
+        t_sm4.setKey((unsigned char*)_key.data(), _key.size());
+    }
+    return t_sm4;
+}
+}  // namespace
+
 bytes dev::aesCBCEncrypt(bytesConstRef _plainData, bytesConstRef _key)
 {
-    bytesConstRef ivData = _key.cropped(0, 16);
+    bytes ivData = _key.cropped(0, 16).toBytes();
     int padding = _plainData.size() % 16;
     int nSize = 16 - padding;
     int inDataVLen = _plainData.size() + nSize;
-    bytes inDataV(inDataVLen);
-    memcpy(inDataV.data(), (unsigned char*)_plainData.data(), _plainData.size());
-    memset(inDataV.data() + _plainData.size(), nSize, nSize);
-
-    bytes enData(inDataVLen);
-    SM4::getInstance().setKey((unsigned char*)_key.data(), _key.size());
-    SM4::getInstance().cbcEncrypt(
-        inDataV.data(), enData.data(), inDataVLen, (unsigned char*)ivData.data(), 1);
-    // LOG(DEBUG)<<"ivData:"<<ascii2hex((const char*)ivData.data(),ivData.size());
+    bytes enData(inDataVLen, (byte)nSize);
+    memcpy(enData.data(), (unsigned char*)_plainData.data(), _plainData.size());
+    sm4(_key).cbcEncrypt(enData.data(), enData.data(), inDataVLen, ivData.data(), 1);
     return enData;
 }
 bytes dev::aesCBCDecrypt(bytesConstRef _cypherData, bytesConstRef _key)
 {
-    bytesConstRef ivData = _key.cropped(0, 16);
+    if (_cypherData.empty() || _cypherData.size() % 16 != 0)
+    {
+        BOOST_THROW_EXCEPTION(CryptoException() << errinfo_comment("invalid SM4 cipher length"));
+    }
+    bytes ivData = _key.cropped(0, 16).toBytes();
     bytes deData(_cypherData.size());
-    SM4::getInstance().setKey((unsigned char*)_key.data(), _key.size());
-    SM4::getInstance().cbcEncrypt((unsigned char*)_cypherData.data(), deData.data(),
-        _cypherData.size(), (unsigned char*)ivData.data(), 0);
+    sm4(_key).cbcEncrypt((unsigned char*)_cypherData.data(), deData.data(), _cypherData.size(),
+        ivData.data(), 0);
     int padding = deData.at(_cypherData.size() - 1);
+    if (padding == 0 || padding > 16)
+    {
+        BOOST_THROW_EXCEPTION(CryptoException() << errinfo_comment("invalid SM4 padding"));
+    }
     int deLen = _cypherData.size() - padding;
     deData.resize(deLen);
     return deData;
@@ -191,6 +191,13 @@ bool sha3(bytesConstRef _input, bytesRef o_output)
     return true;
 }
 
+void sha3Batch(std::vector<bytesConstRef> const& _inputs, h256* o_outputs)
+{
+    // sm3 has no multi-buffer implementation
+    for (size_t i = 0; i < _inputs.size(); ++i)
+        sha3(_inputs[i], o_outputs[i].ref());
+}
+
 // add sha2 -- sha256 to this file begin
 h256 sha256(bytesConstRef _input) noexcept
 {
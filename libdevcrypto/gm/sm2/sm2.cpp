@@ -22,9 +22,49 @@
  */
 #include "sm2.h"
 #include <libdevcore/easylog.h>
+#include <memory>
 #define SM3_DIGEST_LENGTH 32
 using namespace std;
 
+namespace
+{
+EC_GROUP* createSM2Group()
+{
+    EC_GROUP* sm2Group = EC_GROUP_new_by_curve_name(NID_sm2);
+    // the multiples of the generator make k*G of signing and s*G of verifying faster
+    if (sm2Group && !EC_GROUP_precompute_mult(sm2Group, NULL))
+    {
+        CRYPTO_LOG(WARNING) << "[SM2] Error Of Precompute SM2 Generator Multiples";
+    }
+    return sm2Group;
+}
+
+/// the group is created once and only read afterwards, so it is shared by all threads
+const EC_GROUP* getSM2Group()
+{
+    static std::unique_ptr<EC_GROUP, decltype(&EC_GROUP_free)> s_group{
+        createSM2Group(), &EC_GROUP_free};
+    return s_group.get();
+}
+
+/// the key copies the group, the precomputed multiples are shared by reference
+EC_KEY* newSM2Key()
+{
+    const EC_GROUP* sm2Group = getSM2Group();
+    if (!sm2Group)
+    {
+        return NULL;
+    }
+    EC_KEY* sm2Key = EC_KEY_new();
+    if (sm2Key && EC_KEY_set_group(sm2Key, sm2Group) == 0)
+    {
+        EC_KEY_free(sm2Key);
+        return NULL;
+    }
+    return sm2Key;
+}
+}  // namespace
+
 bool SM2::genKey()
 {
     bool lresult = false;
@@ -128,7 +168,12 @@ bool SM2::sign(
 
     res = &start;
     BN_hex2bn(&res, (const char*)privateKey.c_str());
-    sm2Key = EC_KEY_new_by_curve_name(NID_sm2);
+    sm2Key = newSM2Key();
+    if (sm2Key == NULL)
+    {
+        CRYPTO_LOG(ERROR) << "[SM2::sign] Error Of Create SM2 Key";
+        goto err;
+    }
     EC_KEY_set_private_key(sm2Key, res);
 
     zValueLen = sizeof(zValue);
@@ -193,7 +238,7 @@ int SM2::verify(const string& _signData, int, const char* originalData, int orig
     SM3_CTX sm3Ctx;
     EC_KEY* sm2Key = NULL;
     EC_POINT* pubPoint = NULL;
-    EC_GROUP* sm2Group = NULL;
+    const EC_GROUP* sm2Group = NULL;
     ECDSA_SIG* signData = NULL;
     unsigned char zValue[SM3_DIGEST_LENGTH];
     size_t zValueLen = SM3_DIGEST_LENGTH;
@@ -201,7 +246,7 @@ int SM2::verify(const string& _signData, int, const char* originalData, int orig
     string s = _signData.substr(64, 64);
     // LOG(DEBUG)<<"r:"<<r<<" s:"<<s;
 
-    sm2Group = EC_GROUP_new_by_curve_name(NID_sm2);
+    sm2Group = getSM2Group();
     if (sm2Group == NULL)
     {
         CRYPTO_LOG(ERROR) << "[SM2::veify] ERROR of Verify EC_GROUP_new_by_curve_namee";
@@ -220,7 +265,7 @@ int SM2::verify(const string& _signData, int, const char* originalData, int orig
         goto err;
     }
 
-    sm2Key = EC_KEY_new_by_curve_name(NID_sm2);
+    sm2Key = newSM2Key();
 
     if (sm2Key == NULL)
     {
@@ -273,8 +318,6 @@ err:
         EC_POINT_free(pubPoint);
     if (signData)
         ECDSA_SIG_free(signData);
-    if (sm2Group)
-        EC_GROUP_free(sm2Group);
     return lresult;
 }
 
@@ -293,8 +336,8 @@ string SM2::priToPub(const string& pri)
     // LOG(DEBUG)<<"pri:"<<pri;
     res = &start;
     BN_hex2bn(&res, (const char*)pri.c_str());
-    sm2Key = EC_KEY_new_by_curve_name(NID_sm2);
-    if (!EC_KEY_set_private_key(sm2Key, res))
+    sm2Key = newSM2Key();
+    if (!sm2Key || !EC_KEY_set_private_key(sm2Key, res))
     {
         CRYPTO_LOG(ERROR) << "[SM2::priToPub] Error PriToPub EC_KEY_set_private_key";
         goto err;
@@ -42,10 +42,9 @@ void SM4::decrypt(const unsigned char* in, unsigned char* out)
 void SM4::cbcEncrypt(
     const unsigned char* in, unsigned char* out, size_t length, unsigned char* ivec, const int enc)
 {
-    unsigned char* iv = (unsigned char*)malloc(16);
+    unsigned char iv[16];
     std::memcpy(iv, ivec, 16);
     ::SM4_cbc_encrypt(in, out, length, &key, iv, enc);
-    free(iv);
 }
 
 SM4& SM4::getInstance()
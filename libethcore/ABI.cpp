@@ -23,6 +23,7 @@
 
 #include "ABI.h"
 #include <libdevcore/FixedHash.h>
+#include <cstring>
 
 using namespace std;
 using namespace dev;
@@ -31,6 +32,47 @@ using namespace dev::eth::abi;
 
 const int ContractABI::MAX_BYTE_LENGTH;
 
+namespace
+{
+// the 32 bytes of a slot are moved limb by limb instead of byte by byte through shifts of u256
+typedef boost::multiprecision::limb_type Limb;
+const unsigned c_limbs = 32 / sizeof(Limb);
+
+void toSlot(u256 const& _in, byte* _out)
+{
+    auto const& backend = _in.backend();
+    memset(_out, 0, 32);
+    for (unsigned i = 0; i < backend.size() && i < c_limbs; ++i)
+    {
+        Limb limb = backend.limbs()[i];
+        byte* end = _out + 32 - i * sizeof(Limb);
+        for (unsigned j = 1; j <= sizeof(Limb); ++j, limb >>= 8)
+        {
+            *(end - j) = (byte)limb;
+        }
+    }
+}
+
+u256 fromSlot(byte const* _in)
+{
+    u256 ret;
+    auto& backend = ret.backend();
+    backend.resize(c_limbs, c_limbs);
+    for (unsigned i = 0; i < c_limbs; ++i)
+    {
+        Limb limb = 0;
+        byte const* begin = _in + 32 - (i + 1) * sizeof(Limb);
+        for (unsigned j = 0; j < sizeof(Limb); ++j)
+        {
+            limb = (limb << 8) | begin[j];
+        }
+        backend.limbs()[i] = limb;
+    }
+    backend.normalize();
+    return ret;
+}
+}  // namespace
+
 bool ContractABI::abiOutByFuncSelector(
     bytesConstRef _data, const std::vector<std::string>& _allTypes, std::vector<std::string>& _out)
 {
@@ -78,67 +120,66 @@ bool ContractABI::abiOutByFuncSelector(
 }
 
 // unsigned integer type uint256.
-bytes ContractABI::serialise(const int& _in)
+void ContractABI::encode(const int& _in, byte* _out)
 {
-    return serialise((s256)_in);
+    encode((s256)_in, _out);
 }
 
 // unsigned integer type uint256.
-bytes ContractABI::serialise(const u256& _in)
+void ContractABI::encode(const u256& _in, byte* _out)
 {
-    return h256(_in).asBytes();
+    toSlot(_in, _out);
 }
 
 // two’s complement signed integer type int256.
-bytes ContractABI::serialise(const s256& _in)
+void ContractABI::encode(const s256& _in, byte* _out)
 {
-    return h256(_in.convert_to<u256>()).asBytes();
+    encode(_in.convert_to<u256>(), _out);
 }
 
 // equivalent to uint8 restricted to the values 0 and 1. For computing the function selector,
 // bool is used
-bytes ContractABI::serialise(const bool& _in)
+void ContractABI::encode(const bool& _in, byte* _out)
 {
-    return h256(u256(_in ? 1 : 0)).asBytes();
+    memset(_out, 0, MAX_BYTE_LENGTH);
+    _out[MAX_BYTE_LENGTH - 1] = _in ? 1 : 0;
 }
 
 // equivalent to uint160, except for the assumed interpretation and language typing. For
 // computing the function selector, address is used.
 // bool is used.
-bytes ContractABI::serialise(const Address& _in)
+void ContractABI::encode(const Address& _in, byte* _out)
 {
-    return bytes(12, 0) + _in.asBytes();
+    memset(_out, 0, MAX_BYTE_LENGTH - Address::size);
+    _in.ref().copyTo(bytesRef(_out + MAX_BYTE_LENGTH - Address::size, Address::size));
 }
 
 // binary type of 32 bytes
-bytes ContractABI::serialise(const string32& _in)
+void ContractABI::encode(const string32& _in, byte* _out)
 {
-    bytes ret(32, 0);
-    bytesConstRef((byte const*)_in.data(), 32).populate(bytesRef(&ret));
-    return ret;
+    memcpy(_out, _in.data(), MAX_BYTE_LENGTH);
 }
 
-// dynamic sized unicode string assumed to be UTF-8 encoded.
-bytes ContractABI::serialise(const std::string& _in)
+// dynamic sized unicode string assumed to be UTF-8 encoded, padded with zeros to whole slots
+void ContractABI::encode(bytesConstRef _in, byte* _out)
 {
-    bytes ret;
-    ret = h256(u256(_in.size())).asBytes();
-    ret.resize(ret.size() + (_in.size() + 31) / MAX_BYTE_LENGTH * MAX_BYTE_LENGTH);
-    bytesConstRef(&_in).populate(bytesRef(&ret).cropped(32));
-    return ret;
+    encode(u256(_in.size()), _out);
+    auto size = encodedSize(_in) - MAX_BYTE_LENGTH;
+    memcpy(_out + MAX_BYTE_LENGTH, _in.data(), _in.size());
+    memset(_out + MAX_BYTE_LENGTH + _in.size(), 0, size - _in.size());
 }
 
 void ContractABI::deserialise(s256& out, std::size_t _offset)
 {
     validOffset(_offset + MAX_BYTE_LENGTH - 1);
 
-    u256 u = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
-    if (u > u256("0x8fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"))
+    static const u256 c_maxPositive(
+        "0x8fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+    u256 u = fromSlot(data.data() + _offset);
+    if (u > c_maxPositive)
     {
-        auto r =
-            (dev::u256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff") - u) +
-            1;
-        out = s256("-" + r.str());
+        auto r = (~u) + 1;
+        out = -r.convert_to<s256>();
     }
     else
     {
@@ -150,14 +191,14 @@ void ContractABI::deserialise(u256& _out, std::size_t _offset)
 {
     validOffset(_offset + MAX_BYTE_LENGTH - 1);
 
-    _out = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
+    _out = fromSlot(data.data() + _offset);
 }
 
 void ContractABI::deserialise(bool& _out, std::size_t _offset)
 {
     validOffset(_offset + MAX_BYTE_LENGTH - 1);
 
-    u256 ret = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
+    u256 ret = fromSlot(data.data() + _offset);
     _out = ret > 0 ? true : false;
 }
 
@@ -179,8 +220,17 @@ void ContractABI::deserialise(std::string& _out, std::size_t _offset)
 {
     validOffset(_offset + MAX_BYTE_LENGTH - 1);
 
-    u256 len = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
+    u256 len = fromSlot(data.data() + _offset);
     validOffset(_offset + MAX_BYTE_LENGTH + (std::size_t)len - 1);
     auto result = data.cropped(_offset + MAX_BYTE_LENGTH, static_cast<size_t>(len));
     _out.assign((const char*)result.data(), result.size());
 }
+
+void ContractABI::deserialise(bytesConstRef& _out, std::size_t _offset)
+{
+    validOffset(_offset + MAX_BYTE_LENGTH - 1);
+
+    u256 len = fromSlot(data.data() + _offset);
+    validOffset(_offset + MAX_BYTE_LENGTH + (std::size_t)len - 1);
+    _out = data.cropped(_offset + MAX_BYTE_LENGTH, static_cast<size_t>(len));
+}
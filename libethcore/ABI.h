@@ -71,6 +71,13 @@ struct ABIElementType<string32> : std::true_type
 {
 };
 
+// a view of the bytes of a string in the data, decoded without a copy and valid as long as the
+// data is
+template <>
+struct ABIElementType<bytesConstRef> : std::true_type
+{
+};
+
 // check if T type of string
 template <class T>
 struct ABIStringType : std::false_type
@@ -82,6 +89,11 @@ struct ABIStringType<std::string> : std::true_type
 {
 };
 
+template <>
+struct ABIStringType<bytesConstRef> : std::true_type
+{
+};
+
 // check if type of static array
 template <class T>
 struct ABIStaticArray : std::false_type
@@ -206,11 +218,8 @@ class ContractABI
 {
 private:
     static const int MAX_BYTE_LENGTH = 32;
-    // encode or decode offset
+    // decode offset
     std::size_t offset{0};
-    // encode temp bytes
-    bytes fixed;
-    bytes dynamic;
 
     // decode data
     bytesConstRef data;
@@ -238,43 +247,89 @@ private:
     }
 
 public:
+    // the encoding of a value in a buffer of its own
+    template <class T>
+    bytes serialise(const T& _in)
+    {
+        bytes out(encodedSize(_in));
+        encode(_in, out.data());
+        return out;
+    }
+
+    // the size of the encoding of a value, one slot for every static element type
+    template <class T>
+    static std::size_t encodedSize(const T&)
+    {
+        return MAX_BYTE_LENGTH;
+    }
+    static std::size_t encodedSize(const std::string& _in)
+    {
+        return encodedSize(bytesConstRef(&_in));
+    }
+    static std::size_t encodedSize(bytesConstRef _in)
+    {
+        return MAX_BYTE_LENGTH +
+               (_in.size() + MAX_BYTE_LENGTH - 1) / MAX_BYTE_LENGTH * MAX_BYTE_LENGTH;
+    }
+    template <class T, std::size_t N>
+    static std::size_t encodedSize(const std::array<T, N>& _in)
+    {
+        return elementsSize(_in);
+    }
+    template <class T>
+    static std::size_t encodedSize(const std::vector<T>& _in)
+    {
+        return MAX_BYTE_LENGTH + elementsSize(_in);
+    }
+
+    // writes the encodedSize(_in) bytes of the encoding of a value at _out
     template <class T>
-    bytes serialise(const T& _t)
+    static void encode(const T& _in, byte* _out)
     {  // unsupport type
-        (void)_t;
+        (void)_in;
+        (void)_out;
         static_assert(ABIElementType<T>::value, "ABI not support type.");
-        return bytes{};
     }
     // unsigned integer type int.
-    bytes serialise(const int& _in);
+    static void encode(const int& _in, byte* _out);
 
     // unsigned integer type uint256.
-    bytes serialise(const u256& _in);
+    static void encode(const u256& _in, byte* _out);
 
     // two’s complement signed integer type int256.
-    bytes serialise(const s256& _in);
+    static void encode(const s256& _in, byte* _out);
 
     // equivalent to uint8 restricted to the values 0 and 1. For computing the function selector,
     // bool is used
-    bytes serialise(const bool& _in);
+    static void encode(const bool& _in, byte* _out);
 
     // equivalent to uint160, except for the assumed interpretation and language typing. For
     // computing the function selector, address is used.
-    // bool is used.
-    bytes serialise(const Address& _in);
+    static void encode(const Address& _in, byte* _out);
 
     // binary type of 32 bytes
-    bytes serialise(const string32& _in);
+    static void encode(const string32& _in, byte* _out);
 
     // dynamic sized unicode string assumed to be UTF-8 encoded.
-    bytes serialise(const std::string& _in);
+    static void encode(const std::string& _in, byte* _out)
+    {
+        encode(bytesConstRef(&_in), _out);
+    }
+    static void encode(bytesConstRef _in, byte* _out);
 
     // static array
     template <class T, std::size_t N>
-    bytes serialise(const std::array<T, N>& _in);
+    static void encode(const std::array<T, N>& _in, byte* _out)
+    {
+        encodeElements(_in, _out);
+    }
     // dynamic array
     template <class T>
-    bytes serialise(const std::vector<T>& _in);
+    static void encode(const std::vector<T>& _in, byte* _out)
+    {
+        encode(u256(_in.size()), _out);
+        encodeElements(_in, _out + MAX_BYTE_LENGTH);
+    }
 
     template <class T>
     void deserialise(const T& _t, std::size_t _offset)
@@ -296,6 +351,8 @@ public:
 
     void deserialise(std::string& _out, std::size_t _offset);
 
+    void deserialise(bytesConstRef& _out, std::size_t _offset);
+
     // static array
     template <class T, std::size_t N>
     void deserialise(std::array<T, N>& _out, std::size_t _offset);
@@ -304,25 +361,68 @@ public:
     void deserialise(std::vector<T>& _out, std::size_t _offset);
 
 private:
-    inline void abiInAux() { return; }
+    template <class C>
+    static std::size_t elementsSize(const C& _in)
+    {
+        std::size_t size =
+            ABIDynamicType<typename C::value_type>::value ? _in.size() * MAX_BYTE_LENGTH : 0;
+        for (auto const& e : _in)
+        {
+            size += encodedSize(e);
+        }
+        return size;
+    }
+
+    // the elements of an array, a dynamic element is placed after the offsets of all of them
+    template <class C>
+    static void encodeElements(const C& _in, byte* _out)
+    {
+        if (!ABIDynamicType<typename C::value_type>::value)
+        {
+            for (auto const& e : _in)
+            {
+                encode(e, _out);
+                _out += encodedSize(e);
+            }
+            return;
+        }
+
+        std::size_t tail = _in.size() * MAX_BYTE_LENGTH;
+        for (std::size_t i = 0; i < _in.size(); ++i)
+        {
+            encode(u256(tail), _out + i * MAX_BYTE_LENGTH);
+            encode(_in[i], _out + tail);
+            tail += encodedSize(_in[i]);
+        }
+    }
+
+    static std::size_t tailSize() { return 0; }
 
     template <class T, class... U>
-    void abiInAux(T const& _t, U const&... _u)
+    static std::size_t tailSize(T const& _t, U const&... _u)
     {
-        bytes out = serialise(_t);
+        return (ABIDynamicType<T>::value ? encodedSize(_t) : 0) + tailSize(_u...);
+    }
 
+    static void abiInAux(byte*, byte*, std::size_t) {}
+
+    // writes the head of an argument at _head, or its offset there and itself at _tail
+    // bytes from _start if it is dynamic
+    template <class T, class... U>
+    static void abiInAux(byte* _start, byte* _head, std::size_t _tail, T const& _t, U const&... _u)
+    {
         if (ABIDynamicType<T>::value)
-        {  // dynamic type
-            dynamic += out;
-            fixed += serialise((u256)offset);
-            offset += out.size();
+        {
+            encode(u256(_tail), _head);
+            encode(_t, _start + _tail);
+            _tail += encodedSize(_t);
         }
         else
-        {  // static type
-            fixed += out;
+        {
+            encode(_t, _head);
         }
 
-        abiInAux(_u...);
+        abiInAux(_start, _head + Offset<T>::value * MAX_BYTE_LENGTH, _tail, _u...);
     }
 
     void abiOutAux() { return; }
@@ -376,14 +476,17 @@ public:
     template <class... T>
     bytes abiIn(const std::string& _sig, T const&... _t)
     {
-        offset = Offset<T...>::value * MAX_BYTE_LENGTH;
-        fixed.clear();
-        dynamic.clear();
-
-        abiInAux(_t...);
-
-        return _sig.empty() ? fixed + dynamic :
-                              sha3(_sig).ref().cropped(0, 4).toBytes() + fixed + dynamic;
+        // the size of the heads is known at compile time, the whole encoding is written into
+        // one buffer sized up front
+        std::size_t headSize = Offset<T...>::value * MAX_BYTE_LENGTH;
+        std::size_t selectorSize = _sig.empty() ? 0 : 4;
+        bytes out(selectorSize + headSize + tailSize(_t...));
+        if (!_sig.empty())
+        {
+            sha3(_sig).ref().cropped(0, 4).copyTo(bytesRef(out.data(), selectorSize));
+        }
+        abiInAux(out.data() + selectorSize, out.data() + selectorSize, headSize, _t...);
+        return out;
     }
 
     template <class... T>
@@ -393,53 +496,6 @@ public:
     }
 };
 
-// a fixed-length array of elements of the given type.
-template <class T, std::size_t N>
-bytes ContractABI::serialise(const std::array<T, N>& _in)
-{
-    bytes offset_bytes;
-    bytes content;
-
-    auto length = N * MAX_BYTE_LENGTH;
-
-    for (const auto& e : _in)
-    {
-        bytes out = serialise(e);
-        content += out;
-        if (ABIDynamicType<T>::value)
-        {  // dynamic
-            offset_bytes += serialise(static_cast<u256>(length));
-            length += out.size();
-        }
-    }
-
-    return offset_bytes + content;
-}
-
-// a variable-length array of elements of the given type.
-template <class T>
-bytes ContractABI::serialise(const std::vector<T>& _in)
-{
-    bytes offset_bytes;
-    bytes content;
-
-    auto length = _in.size() * MAX_BYTE_LENGTH;
-
-    offset_bytes += serialise(static_cast<u256>(_in.size()));
-    for (const auto& t : _in)
-    {
-        bytes out = serialise(t);
-        content += out;
-        if (ABIDynamicType<T>::value)
-        {  // dynamic
-            offset_bytes += serialise(static_cast<u256>(length));
-            length += out.size();
-        }
-    }
-
-    return offset_bytes + content;
-}
-
 template <class T, std::size_t N>
 void ContractABI::deserialise(std::array<T, N>& _out, std::size_t _offset)
 {
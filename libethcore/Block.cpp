@@ -32,6 +32,29 @@ namespace dev
 {
 namespace eth
 {
+namespace
+{
+/// decode the items of an rlp list in parallel, only the offsets of the items are found serially
+template <typename T, typename Decode>
+void decodeList(RLP const& _list, std::vector<T>& _objects, Decode const& _decode)
+{
+    std::vector<bytesConstRef> items;
+    items.reserve(_list.itemCount());
+    for (auto const& item : _list)
+    {
+        items.push_back(item.data());
+    }
+    _objects.resize(items.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, items.size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                _decode(_objects[i], RLP(items[i]));
+            }
+        });
+}
+}  // namespace
+
 Block::Block(
     bytesConstRef _data, CheckTransaction const _option, bool _withReceipt, bool _withTxHash)
 {
@@ -44,6 +67,12 @@ Block::Block(
     decode(ref(_data), _option, _withReceipt, _withTxHash);
 }
 
+Block::Block(std::shared_ptr<bytes> _data, CheckTransaction const _option, bool _withReceipt,
+    bool _withTxHash)
+{
+    decode(_data, _option, _withReceipt, _withTxHash);
+}
+
 Block::Block(Block const& _block)
   : m_blockHeader(_block.blockHeader()),
     m_transactions(_block.transactions()),
@@ -53,7 +82,12 @@ Block::Block(Block const& _block)
     m_tReceiptsCache(_block.m_tReceiptsCache),
     m_transRootCache(_block.m_transRootCache),
     m_receiptRootCache(_block.m_receiptRootCache)
-{}
+{
+    Guard l(_block.x_encoded);
+    m_encoded = _block.m_encoded;
+    m_encodedHeaderHash = _block.m_encodedHeaderHash;
+    m_encodedVersion = _block.m_encodedVersion;
+}
 
 Block& Block::operator=(Block const& _block)
 {
@@ -68,9 +102,58 @@ Block& Block::operator=(Block const& _block)
     m_tReceiptsCache = _block.m_tReceiptsCache;
     m_transRootCache = _block.m_transRootCache;
     m_receiptRootCache = _block.m_receiptRootCache;
+    if (this != &_block)
+    {
+        std::shared_ptr<bytes> encoded;
+        h256 headerHash;
+        VERSION version;
+        {
+            Guard l(_block.x_encoded);
+            encoded = _block.m_encoded;
+            headerHash = _block.m_encodedHeaderHash;
+            version = _block.m_encodedVersion;
+        }
+        Guard l(x_encoded);
+        m_encoded = encoded;
+        m_encodedHeaderHash = headerHash;
+        m_encodedVersion = version;
+    }
     return *this;
 }
 
+std::shared_ptr<bytes> Block::encoded() const
+{
+    auto headerHash = m_blockHeader.hash();
+    Guard l(x_encoded);
+    if (m_encoded &&
+        (m_encodedHeaderHash != headerHash || m_encodedVersion != g_BCOSConfig.version()))
+    {
+        m_encoded.reset();
+    }
+    return m_encoded;
+}
+
+void Block::keepEncoded(std::shared_ptr<bytes> _encoded) const
+{
+    auto headerHash = m_blockHeader.hash();
+    Guard l(x_encoded);
+    m_encoded = std::move(_encoded);
+    m_encodedHeaderHash = headerHash;
+    m_encodedVersion = g_BCOSConfig.version();
+}
+
+std::shared_ptr<bytes> Block::rlpP() const
+{
+    auto out = encoded();
+    if (!out)
+    {
+        out = std::make_shared<bytes>();
+        encode(*out);
+        keepEncoded(out);
+    }
+    return out;
+}
+
 /**
  * @brief : generate block using specified params
  *
@@ -81,6 +164,16 @@ Block& Block::operator=(Block const& _block)
  */
 void Block::encode(bytes& _out) const
 {
+    if (auto out = encoded())
+    {
+        _out = *out;
+        return;
+    }
+    if (g_BCOSConfig.version() >= V2_2_0)
+    {
+        encodeV3(_out);
+        return;
+    }
     if (g_BCOSConfig.version() >= RC2_VERSION)
     {
         encodeRC2(_out);
@@ -90,22 +183,20 @@ void Block::encode(bytes& _out) const
     m_blockHeader.verify();
     calTransactionRoot(false);
     calReceiptRoot(false);
-    bytes headerData;
-    m_blockHeader.encode(headerData);
-    /// get block RLPStream
-    RLPStream block_stream;
-    block_stream.appendList(5);
-    // append block header
-    block_stream.appendRaw(headerData);
-    // append transaction list
-    block_stream.appendRaw(m_txsCache);
-    // append transactionReceipts list
-    block_stream.appendRaw(m_tReceiptsCache);
-    // append block hash
-    block_stream.append(m_blockHeader.hash());
-    // append sig_list
-    block_stream.appendVector(m_sigList);
-    block_stream.swapOut(_out);
+    auto hash = m_blockHeader.hash();
+    rlpEncode(_out, [&](RLPStream& block_stream) {
+        block_stream.appendList(5);
+        // append block header
+        m_blockHeader.streamRLP(block_stream);
+        // append transaction list
+        block_stream.appendRaw(m_txsCache);
+        // append transactionReceipts list
+        block_stream.appendRaw(m_tReceiptsCache);
+        // append block hash
+        block_stream.append(hash);
+        // append sig_list
+        block_stream.appendVector(m_sigList);
+    });
 }
 
 void Block::encodeRC2(bytes& _out) const
@@ -113,22 +204,51 @@ void Block::encodeRC2(bytes& _out) const
     m_blockHeader.verify();
     calTransactionRoot(false);
     calReceiptRoot(false);
-    bytes headerData;
-    m_blockHeader.encode(headerData);
-    /// get block RLPStream
-    RLPStream block_stream;
-    block_stream.appendList(5);
-    // append block header
-    block_stream.appendRaw(headerData);
-    // append transaction list
-    block_stream.append(ref(m_txsCache));
-    // append block hash
-    block_stream.append(m_blockHeader.hash());
-    // append sig_list
-    block_stream.appendVector(m_sigList);
-    // append transactionReceipts list
-    block_stream.appendRaw(m_tReceiptsCache);
-    block_stream.swapOut(_out);
+    auto hash = m_blockHeader.hash();
+    rlpEncode(_out, [&](RLPStream& block_stream) {
+        block_stream.appendList(5);
+        // append block header
+        m_blockHeader.streamRLP(block_stream);
+        // append transaction list
+        block_stream.append(ref(m_txsCache));
+        // append block hash
+        block_stream.append(hash);
+        // append sig_list
+        block_stream.appendVector(m_sigList);
+        // append transactionReceipts list
+        block_stream.appendRaw(m_tReceiptsCache);
+    });
+}
+
+void Block::encodeV3(bytes& _out) const
+{
+    m_blockHeader.verify();
+    calTransactionRoot(false);
+    calReceiptRoot(false);
+    auto hash = m_blockHeader.hash();
+    /// the receipt root is still calculated from the list
+    ReadGuard l(x_txReceiptsCache);
+    RLP receipts(ref(m_tReceiptsCache));
+    std::vector<bytesConstRef> receiptsRLPs;
+    receiptsRLPs.reserve(receipts.itemCount());
+    for (auto const& receipt : receipts)
+    {
+        receiptsRLPs.push_back(receipt.data());
+    }
+    bytes receiptsData = TxsParallelParser::encode(receiptsRLPs);
+    rlpEncode(_out, [&](RLPStream& block_stream) {
+        block_stream.appendList(5);
+        // append block header
+        m_blockHeader.streamRLP(block_stream);
+        // append transaction list
+        block_stream.append(ref(m_txsCache));
+        // append block hash
+        block_stream.append(hash);
+        // append sig_list
+        block_stream.appendVector(m_sigList);
+        // append transactionReceipts
+        block_stream.append(ref(receiptsData));
+    });
 }
 
 
@@ -142,21 +262,31 @@ void Block::calTransactionRoot(bool update) const
     }
 
     WriteGuard l(x_txsCache);
-    RLPStream txs;
-    txs.appendList(m_transactions.size());
     if (m_txsCache == bytes())
     {
+        std::vector<bytes> txsRLPs(m_transactions.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_transactions.size()),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    m_transactions[i].encode(txsRLPs[i]);
+                }
+            });
+
+        rlpEncode(m_txsCache, [&](RLPStream& txs) {
+            txs.appendList(txsRLPs.size());
+            for (auto const& txRLP : txsRLPs)
+            {
+                txs.appendRaw(txRLP);
+            }
+        });
         BytesMap txsMapCache;
         for (size_t i = 0; i < m_transactions.size(); i++)
         {
             RLPStream s;
             s << i;
-            bytes trans_data;
-            m_transactions[i].encode(trans_data);
-            txs.appendRaw(trans_data);
-            txsMapCache.insert(std::make_pair(s.out(), trans_data));
+            txsMapCache.insert(std::make_pair(s.out(), std::move(txsRLPs[i])));
         }
-        txs.swapOut(m_txsCache);
         m_transRootCache = hash256(txsMapCache);
     }
     if (update == true)
@@ -190,19 +320,29 @@ void Block::calReceiptRoot(bool update) const
     WriteGuard l(x_txReceiptsCache);
     if (m_tReceiptsCache == bytes())
     {
-        RLPStream txReceipts;
-        txReceipts.appendList(m_transactionReceipts.size());
+        std::vector<bytes> receiptsRLPs(m_transactionReceipts.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_transactionReceipts.size()),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    m_transactionReceipts[i].encode(receiptsRLPs[i]);
+                }
+            });
+
+        rlpEncode(m_tReceiptsCache, [&](RLPStream& txReceipts) {
+            txReceipts.appendList(receiptsRLPs.size());
+            for (auto const& receiptRLP : receiptsRLPs)
+            {
+                txReceipts.appendRaw(receiptRLP);
+            }
+        });
         BytesMap mapCache;
         for (size_t i = 0; i < m_transactionReceipts.size(); i++)
         {
             RLPStream s;
             s << i;
-            bytes tranReceipts_data;
-            m_transactionReceipts[i].encode(tranReceipts_data);
-            txReceipts.appendRaw(tranReceipts_data);
-            mapCache.insert(std::make_pair(s.out(), tranReceipts_data));
+            mapCache.insert(std::make_pair(s.out(), std::move(receiptsRLPs[i])));
         }
-        txReceipts.swapOut(m_tReceiptsCache);
         m_receiptRootCache = hash256(mapCache);
     }
     if (update == true)
@@ -223,22 +363,19 @@ void Block::calReceiptRootRC2(bool update) const
             tbb::blocked_range<size_t>(0, receiptsNum), [&](const tbb::blocked_range<size_t>& _r) {
                 for (size_t i = _r.begin(); i != _r.end(); ++i)
                 {
-                    RLPStream s;
-                    s << i;
-                    dev::bytes receiptRLP;
-                    m_transactionReceipts[i].encode(receiptRLP);
-                    receiptsRLPs[i] = receiptRLP;
+                    m_transactionReceipts[i].encode(receiptsRLPs[i]);
                 }
             });
 
         // auto record_time = utcTime();
-        RLPStream txReceipts;
-        txReceipts.appendList(receiptsNum);
-        for (size_t i = 0; i < receiptsNum; ++i)
-        {
-            txReceipts.appendRaw(receiptsRLPs[i]);
-        }
-        txReceipts.swapOut(m_tReceiptsCache);
+        // the list is the concatenated receipts, keccak of the whole list stays sequential
+        rlpEncode(m_tReceiptsCache, [&](RLPStream& txReceipts) {
+            txReceipts.appendList(receiptsNum);
+            for (auto const& receiptRLP : receiptsRLPs)
+            {
+                txReceipts.appendRaw(receiptRLP);
+            }
+        });
         // auto appenRLP_time_cost = utcTime() - record_time;
         // record_time = utcTime();
 
@@ -261,9 +398,28 @@ void Block::calReceiptRootRC2(bool update) const
  * @brief : decode specified data of block into Block class
  * @param _block : the specified data of block
  */
+void Block::decode(std::shared_ptr<bytes> _block, CheckTransaction const _option,
+    bool _withReceipt, bool _withTxHash)
+{
+    decode(ref(*_block), _option, _withReceipt, _withTxHash);
+    /// the receipts skipped would be lost by the encodings of the block, and the bytes trailing
+    /// the block kept by them
+    if ((_withReceipt || g_BCOSConfig.version() < RC2_VERSION || m_transactions.empty()) &&
+        RLP(ref(*_block)).actualSize() == _block->size())
+    {
+        keepEncoded(_block);
+    }
+}
+
 void Block::decode(
     bytesConstRef _block_bytes, CheckTransaction const _option, bool _withReceipt, bool _withTxHash)
 {
+    noteEncodingChange();
+    if (g_BCOSConfig.version() >= V2_2_0)
+    {
+        decodeV3(_block_bytes, _option, _withReceipt, _withTxHash);
+        return;
+    }
     if (g_BCOSConfig.version() >= RC2_VERSION)
     {
         decodeRC2(_block_bytes, _option, _withReceipt, _withTxHash);
@@ -277,23 +433,15 @@ void Block::decode(
     m_blockHeader.populate(block_rlp[0]);
     /// get transaction list
     RLP transactions_rlp = block_rlp[1];
-
-    m_transactions.resize(transactions_rlp.itemCount());
-    for (size_t i = 0; i < transactions_rlp.itemCount(); i++)
-    {
-        m_transactions[i].decode(transactions_rlp[i], _option);
-    }
+    decodeList(transactions_rlp, m_transactions,
+        [_option](Transaction& _tx, RLP const& _rlp) { _tx.decode(_rlp, _option); });
 
     /// get txsCache
     m_txsCache = transactions_rlp.data().toBytes();
 
     /// get transactionReceipt list
-    RLP transactionReceipts_rlp = block_rlp[2];
-    m_transactionReceipts.resize(transactionReceipts_rlp.itemCount());
-    for (size_t i = 0; i < transactionReceipts_rlp.itemCount(); i++)
-    {
-        m_transactionReceipts[i].decode(transactionReceipts_rlp[i]);
-    }
+    decodeList(block_rlp[2], m_transactionReceipts,
+        [](TransactionReceipt& _receipt, RLP const& _rlp) { _receipt.decode(_rlp); });
     /// get hash
     h256 hash = block_rlp[3].toHash<h256>();
     if (hash != m_blockHeader.hash())
@@ -307,6 +455,7 @@ void Block::decode(
 void Block::decodeRC2(
     bytesConstRef _block_bytes, CheckTransaction const _option, bool _withReceipt, bool _withTxHash)
 {
+    noteEncodingChange();
     /// no try-catch to throw exceptions directly
     /// get RLP of block
     RLP block_rlp = BlockHeader::extractBlock(_block_bytes);
@@ -333,13 +482,107 @@ void Block::decodeRC2(
     /// get transactionReceipt list
     if (_withReceipt)
     {
-        RLP transactionReceipts_rlp = block_rlp[4];
-        m_transactionReceipts.resize(transactionReceipts_rlp.itemCount());
-        for (size_t i = 0; i < transactionReceipts_rlp.itemCount(); i++)
+        decodeList(block_rlp[4], m_transactionReceipts,
+            [](TransactionReceipt& _receipt, RLP const& _rlp) { _receipt.decode(_rlp); });
+    }
+}
+
+void Block::decodeV3(
+    bytesConstRef _block_bytes, CheckTransaction const _option, bool _withReceipt, bool _withTxHash)
+{
+    noteEncodingChange();
+    /// no try-catch to throw exceptions directly
+    /// get RLP of block
+    RLP block_rlp = BlockHeader::extractBlock(_block_bytes);
+    /// get block header
+    m_blockHeader.populate(block_rlp[0]);
+    /// get txsCache
+    m_txsCache = block_rlp[1].toBytes();
+
+    /// decode transaction
+    TxsParallelParser::decode(m_transactions, ref(m_txsCache), _option, _withTxHash);
+
+    /// get hash
+    h256 hash = block_rlp[2].toHash<h256>();
+    if (hash != m_blockHeader.hash())
+    {
+        BOOST_THROW_EXCEPTION(ErrorBlockHash() << errinfo_comment("BlockHeader hash error"));
+    }
+    /// get sig_list
+    m_sigList = block_rlp[3].toVector<std::pair<u256, Signature>>();
+
+    /// get transactionReceipts, in parallel as the transactions
+    if (_withReceipt)
+    {
+        bytesConstRef receiptsBytes = block_rlp[4].toBytesConstRef();
+        m_transactionReceipts.resize(TxsParallelParser::count(receiptsBytes));
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_transactionReceipts.size()),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    m_transactionReceipts[i].decode(TxsParallelParser::object(receiptsBytes, i));
+                }
+            });
+    }
+}
+
+bool Block::decodeTransaction(
+    bytesConstRef _block, size_t _index, Transaction& _tx, CheckTransaction const _option)
+{
+    RLP block_rlp = BlockHeader::extractBlock(_block);
+    if (g_BCOSConfig.version() >= RC2_VERSION)
+    {
+        bytesConstRef txsBytes = block_rlp[1].toBytesConstRef();
+        if (_index >= TxsParallelParser::count(txsBytes))
         {
-            m_transactionReceipts[i].decode(transactionReceipts_rlp[i]);
+            return false;
         }
+        _tx.decode(TxsParallelParser::object(txsBytes, _index), _option);
+        return true;
     }
+    RLP transactions_rlp = block_rlp[1];
+    if (_index >= transactions_rlp.itemCount())
+    {
+        return false;
+    }
+    _tx.decode(transactions_rlp[_index], _option);
+    return true;
+}
+
+bool Block::decodeReceipt(bytesConstRef _block, size_t _index, TransactionReceipt& _receipt)
+{
+    RLP block_rlp = BlockHeader::extractBlock(_block);
+    if (g_BCOSConfig.version() >= V2_2_0)
+    {
+        bytesConstRef receiptsBytes = block_rlp[4].toBytesConstRef();
+        if (_index >= TxsParallelParser::count(receiptsBytes))
+        {
+            return false;
+        }
+        _receipt.decode(TxsParallelParser::object(receiptsBytes, _index));
+        return true;
+    }
+    RLP receipts_rlp = block_rlp[g_BCOSConfig.version() >= RC2_VERSION ? 4 : 2];
+    if (_index >= receipts_rlp.itemCount())
+    {
+        return false;
+    }
+    _receipt.decode(receipts_rlp[_index]);
+    return true;
+}
+
+void Block::recoverSenders(std::function<dev::Address(dev::h256 const&)> const& knownSender)
+{
+    // the secp256k1 context is created once and only read by the recoveries, so the workers
+    // share it without locking
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_transactions.size()),
+        [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                setSenderForTransaction(
+                    i, knownSender ? knownSender(m_transactions[i].sha3()) : ZeroAddress);
+            }
+        });
 }
 
 }  // namespace eth
@@ -29,6 +29,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/TrieHash.h>
+#include <functional>
 
 namespace dev
 {
@@ -45,6 +46,10 @@ public:
     explicit Block(bytes const& _data,
         CheckTransaction const _option = CheckTransaction::Everything, bool _withReceipt = true,
         bool _withTxHash = false);
+    /// the block keeps _data as its encoding while it's unchanged, see rlpP
+    explicit Block(std::shared_ptr<bytes> _data,
+        CheckTransaction const _option = CheckTransaction::Everything, bool _withReceipt = true,
+        bool _withTxHash = false);
     /// copy constructor
     Block(Block const& _block);
     /// assignment operator
@@ -68,8 +73,11 @@ public:
     explicit operator bool() const { return bool(m_blockHeader); }
 
     ///-----encode functions
+    /// a copy of the encoding kept by rlpP or by the decoding if the block is unchanged since
     void encode(bytes& _out) const;
     void encodeRC2(bytes& _out) const;
+    /// like encodeRC2, the receipts are indexed by TxsParallelParser instead of a RLP list
+    void encodeV3(bytes& _out) const;
 
     ///-----decode functions
     void decode(bytesConstRef _block, CheckTransaction const _option = CheckTransaction::Everything,
@@ -77,6 +85,22 @@ public:
     void decodeRC2(bytesConstRef _block,
         CheckTransaction const _option = CheckTransaction::Everything, bool _withReceipt = true,
         bool _withTxHash = false);
+    void decodeV3(bytesConstRef _block,
+        CheckTransaction const _option = CheckTransaction::Everything, bool _withReceipt = true,
+        bool _withTxHash = false);
+    /// decode and keep _block as the encoding of the block while it's unchanged, unless the
+    /// receipts it holds are skipped
+    void decode(std::shared_ptr<bytes> _block,
+        CheckTransaction const _option = CheckTransaction::Everything, bool _withReceipt = true,
+        bool _withTxHash = false);
+
+    /// decode the _index-th transaction of an encoded block without decoding the others
+    /// @returns false if the block has no such transaction
+    static bool decodeTransaction(bytesConstRef _block, size_t _index, Transaction& _tx,
+        CheckTransaction const _option = CheckTransaction::None);
+    /// decode the _index-th receipt of an encoded block without decoding the others
+    /// @returns false if the block has no such receipt
+    static bool decodeReceipt(bytesConstRef _block, size_t _index, TransactionReceipt& _receipt);
 
     /// @returns the RLP serialisation of this block.
     bytes rlp() const
@@ -86,12 +110,12 @@ public:
         return out;
     }
 
-    std::shared_ptr<bytes> rlpP() const
-    {
-        std::shared_ptr<bytes> out = std::make_shared<bytes>();
-        encode(*out);
-        return out;
-    }
+    /// The encoding is kept and shared by the following calls, and the copies of the block, until
+    /// the transactions, the receipts, the signatures or the header change, so that a block
+    /// read from the chain or cached is served without encoding it again. Never modified.
+    std::shared_ptr<bytes> rlpP() const;
+    /// keep _encoded, the encoding of the block as it is, for rlpP and encode
+    void keepEncoded(std::shared_ptr<bytes> _encoded) const;
 
     ///-----get interfaces
     Transactions const& transactions() const { return m_transactions; }
@@ -144,6 +168,7 @@ public:
     void inline setSigList(std::vector<std::pair<u256, Signature>> const& _sigList)
     {
         m_sigList = _sigList;
+        noteEncodingChange();
     }
     /// get hash of block header
     h256 blockHeaderHash() { return m_blockHeader.hash(); }
@@ -215,6 +240,7 @@ public:
             totalGas += receipt.gasUsed();
             receipt.setGasUsed(totalGas);
         }
+        noteEncodingChange();
     }
 
     void setStateRootToAllReceipt(h256 const& _stateRoot)
@@ -256,21 +282,46 @@ public:
         }
     }
 
+    /**
+     * @brief: recover the senders of all transactions across the TBB workers, throws
+     * InvalidSignature if a signature can't be recovered
+     *
+     * @param knownSender: returns the sender of a transaction verified before by its hash, or
+     * ZeroAddress to recover it from the signature
+     */
+    void recoverSenders(
+        std::function<dev::Address(dev::h256 const&)> const& knownSender = nullptr);
+
 private:
     /// callback this function when transaction has been changed
     void noteChange()
     {
-        WriteGuard l_txscache(x_txsCache);
-        m_txsCache = bytes();
+        {
+            WriteGuard l_txscache(x_txsCache);
+            m_txsCache = bytes();
+        }
+        noteEncodingChange();
     }
 
     /// callback this function when transaction receipt has been changed
     void noteReceiptChange()
     {
-        WriteGuard l_receipt(x_txReceiptsCache);
-        m_tReceiptsCache = bytes();
+        {
+            WriteGuard l_receipt(x_txReceiptsCache);
+            m_tReceiptsCache = bytes();
+        }
+        noteEncodingChange();
     }
 
+    /// the header is checked by its hash instead, header() hands out a mutable reference
+    void noteEncodingChange()
+    {
+        Guard l(x_encoded);
+        m_encoded.reset();
+    }
+    /// the encoding kept if the block is unchanged since, or null
+    std::shared_ptr<bytes> encoded() const;
+
 private:
     /// block header of the block (field 0)
     mutable BlockHeader m_blockHeader;
@@ -290,6 +341,13 @@ private:
 
     mutable dev::h256 m_transRootCache;
     mutable dev::h256 m_receiptRootCache;
+
+    /// the encoding of the block, valid while the header hash and the version it was encoded
+    /// with are the same
+    mutable Mutex x_encoded;
+    mutable std::shared_ptr<bytes> m_encoded;
+    mutable dev::h256 m_encodedHeaderHash;
+    mutable VERSION m_encodedVersion = RC1_VERSION;
 };
 }  // namespace eth
 }  // namespace dev
@@ -139,11 +139,14 @@ h256 BlockHeader::hash() const
 
 void BlockHeader::encode(bytes& _header) const
 {
-    RLPStream _s;
+    rlpEncode(_header, [this](RLPStream& _s) { streamRLP(_s); });
+}
+
+void BlockHeader::streamRLP(RLPStream& _s) const
+{
     unsigned basicFieldsCnt = BasicFields;
     _s.appendList(basicFieldsCnt);
     BlockHeader::streamRLPFields(_s);
-    _s.swapOut(_header);
 }
 void BlockHeader::streamRLPFields(RLPStream& _s) const
 {
@@ -108,6 +108,8 @@ public:
     /// populate block header from parent
     void populateFromParent(BlockHeader const& parent);
     void encode(bytes& _header) const;
+    /// append the header to _s as encode writes it
+    void streamRLP(RLPStream& _s) const;
     void decode(bytesConstRef& _header_data);
     void clear();
 
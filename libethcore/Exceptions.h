@@ -66,6 +66,7 @@ DEV_SIMPLE_EXCEPTION(TransactionRefused);
 DEV_SIMPLE_EXCEPTION(TransactionAlreadyInChain);
 DEV_SIMPLE_EXCEPTION(InconsistentTransactionSha3);
 DEV_SIMPLE_EXCEPTION(P2pEnqueueTransactionFailed);
+DEV_SIMPLE_EXCEPTION(TxPoolJournalFailed);
 
 /// state trie related
 DEV_SIMPLE_EXCEPTION(InvalidTransactionsRoot);
@@ -84,6 +85,7 @@ DEV_SIMPLE_EXCEPTION_RLP(ErrorBlockHash);
 
 /// block execution related
 DEV_SIMPLE_EXCEPTION(BlockExecutionFailed);
+DEV_SIMPLE_EXCEPTION(MispredictedTxAccess);
 
 /// sync related
 DEV_SIMPLE_EXCEPTION(InvalidBlockDownloadQueuePiorityInput);
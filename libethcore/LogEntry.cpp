@@ -24,6 +24,10 @@
 
 #include <libdevcore/RLP.h>
 #include <libdevcrypto/Hash.h>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace dev
 {
@@ -51,5 +55,57 @@ LogBloom LogEntry::bloom() const
     return ret;
 }
 
+void orBloom(LogBloom& _bloom, LogBloom const& _other)
+{
+    byte* out = _bloom.data();
+    byte const* in = _other.data();
+#if defined(__SSE2__)
+    for (size_t i = 0; i < LogBloom::size; i += 16)
+    {
+        __m128i value = _mm_or_si128(
+            _mm_loadu_si128((__m128i const*)(out + i)), _mm_loadu_si128((__m128i const*)(in + i)));
+        _mm_storeu_si128((__m128i*)(out + i), value);
+    }
+#else
+    for (size_t i = 0; i < LogBloom::size; i += 8)
+    {
+        uint64_t a, b;
+        memcpy(&a, out + i, 8);
+        memcpy(&b, in + i, 8);
+        a |= b;
+        memcpy(out + i, &a, 8);
+    }
+#endif
+}
+
+bool bloomContains(LogBloom const& _bloom, LogBloom const& _part)
+{
+    byte const* bloom = _bloom.data();
+    byte const* part = _part.data();
+#if defined(__SSE2__)
+    for (size_t i = 0; i < LogBloom::size; i += 16)
+    {
+        __m128i value = _mm_loadu_si128((__m128i const*)(part + i));
+        __m128i masked = _mm_and_si128(_mm_loadu_si128((__m128i const*)(bloom + i)), value);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(masked, value)) != 0xffff)
+        {
+            return false;
+        }
+    }
+#else
+    for (size_t i = 0; i < LogBloom::size; i += 8)
+    {
+        uint64_t a, b;
+        memcpy(&a, bloom + i, 8);
+        memcpy(&b, part + i, 8);
+        if ((a & b) != b)
+        {
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
 }  // namespace eth
 }  // namespace dev
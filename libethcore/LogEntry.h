@@ -90,11 +90,16 @@ struct LocalisedLogEntry : public LogEntry
 
 using LocalisedLogEntries = std::vector<LocalisedLogEntry>;
 
+/// _bloom |= _other a vector register at a time
+void orBloom(LogBloom& _bloom, LogBloom const& _other);
+/// whether all the bits of _part are set in _bloom
+bool bloomContains(LogBloom const& _bloom, LogBloom const& _part);
+
 inline LogBloom bloom(LogEntries const& _logs)
 {
     LogBloom ret;
     for (auto const& l : _logs)
-        ret |= l.bloom();
+        orBloom(ret, l.bloom());
     return ret;
 }
 
@@ -0,0 +1,130 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief the logs asked for by their addresses and topics
+ *
+ * @file LogFilter.cpp
+ */
+
+#include "LogFilter.h"
+#include <libdevcrypto/Hash.h>
+#include <algorithm>
+
+namespace dev
+{
+namespace eth
+{
+namespace
+{
+template <typename T>
+LogBlooms valueBlooms(std::set<T> const& _values)
+{
+    LogBlooms blooms;
+    for (auto const& value : _values)
+    {
+        LogBloom bloom;
+        bloom.shiftBloom<3>(sha3(value.ref()));
+        blooms.push_back(bloom);
+    }
+    return blooms;
+}
+}  // namespace
+
+LogFilter::Blooms LogFilter::blooms() const
+{
+    Blooms blooms;
+    /// an empty set matches anything
+    if (!addresses.empty())
+    {
+        blooms.anyOf.push_back(valueBlooms(addresses));
+    }
+    for (auto const& values : topics)
+    {
+        if (!values.empty())
+        {
+            blooms.anyOf.push_back(valueBlooms(values));
+        }
+    }
+    return blooms;
+}
+
+bool LogFilter::Blooms::mayMatch(LogBloom const& _bloom) const
+{
+    for (auto const& values : anyOf)
+    {
+        if (std::none_of(values.begin(), values.end(),
+                [&](LogBloom const& _value) { return bloomContains(_bloom, _value); }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogFilter::matches(LogEntry const& _log) const
+{
+    if (!addresses.empty() && !addresses.count(_log.address))
+    {
+        return false;
+    }
+    if (topics.size() > _log.topics.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < topics.size(); ++i)
+    {
+        if (!topics[i].empty() && !topics[i].count(_log.topics[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LogFilter::match(Block const& _block, LocalisedLogEntries& _logs) const
+{
+    match(blooms(), _block, _logs);
+}
+
+void LogFilter::match(Blooms const& _blooms, Block const& _block, LocalisedLogEntries& _logs) const
+{
+    auto const& transactions = _block.transactions();
+    auto const& receipts = _block.transactionReceipts();
+    if (!_blooms.mayMatch(bloom(receipts)))
+    {
+        return;
+    }
+    for (size_t i = 0; i < receipts.size() && i < transactions.size(); ++i)
+    {
+        if (!_blooms.mayMatch(receipts[i].bloom()))
+        {
+            continue;
+        }
+        auto const& logs = receipts[i].log();
+        for (size_t j = 0; j < logs.size(); ++j)
+        {
+            if (matches(logs[j]))
+            {
+                _logs.push_back(LocalisedLogEntry(logs[j], _block.headerHash(),
+                    _block.blockHeader().number(), transactions[i].sha3(), i, j));
+            }
+        }
+    }
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,62 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief the logs asked for by their addresses and topics
+ *
+ * @file LogFilter.h
+ */
+#pragma once
+
+#include "Block.h"
+#include "LogEntry.h"
+#include "TransactionReceipt.h"
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+/// A log matches if its address is one of the addresses and each of its topics is one of the
+/// topics at the same position, an empty set matching anything.
+struct LogFilter
+{
+    std::set<Address> addresses;
+    std::vector<std::set<h256>> topics;
+
+    /// The blooms of the addresses and of the topics at each position, hashed once to test the
+    /// blooms of many receipts and blocks.
+    struct Blooms
+    {
+        /// a bloom matches if it holds one of each set
+        std::vector<LogBlooms> anyOf;
+
+        /// false if no log of _bloom can match, the logs are only checked otherwise
+        bool mayMatch(LogBloom const& _bloom) const;
+    };
+    Blooms blooms() const;
+
+    bool mayMatch(LogBloom const& _bloom) const { return blooms().mayMatch(_bloom); }
+    bool matches(LogEntry const& _log) const;
+    /// append the logs of the receipts of _block matching, the receipts are skipped at once if
+    /// the bloom of the block doesn't match
+    void match(Block const& _block, LocalisedLogEntries& _logs) const;
+    void match(Blooms const& _blooms, Block const& _block, LocalisedLogEntries& _logs) const;
+};
+
+}  // namespace eth
+}  // namespace dev
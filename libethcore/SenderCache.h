@@ -0,0 +1,111 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the senders recovered from transaction signatures
+ * @author: ancelmo
+ * @date: 2019-09-20
+ */
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/FixedHashMap.h>
+#include <libdevcore/Guards.h>
+#include <algorithm>
+#include <array>
+#include <deque>
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief Thread-safe cache from the hash of a signed transaction to its sender. The hash covers
+ * the signature, so the sender of a hash never changes. The cache is split into shards locked
+ * separately, a full shard drops its oldest sender.
+ */
+class SenderCache
+{
+public:
+    SenderCache(size_t _capacity = c_defaultCapacity)
+      : m_shardCapacity(std::max<size_t>(_capacity / c_shards, 1))
+    {}
+
+    /// @return the sender recovered before, ZeroAddress if the transaction is unknown
+    Address get(h256 const& _txHash) const
+    {
+        auto& shard = getShard(_txHash);
+        Guard l(shard.lock);
+        auto it = shard.senders.find(_txHash);
+        return it == shard.senders.end() ? ZeroAddress : it->second;
+    }
+
+    void insert(h256 const& _txHash, Address const& _sender)
+    {
+        auto& shard = getShard(_txHash);
+        Guard l(shard.lock);
+        if (!shard.senders.emplace(_txHash, _sender).second)
+        {
+            return;
+        }
+        shard.order.push_back(_txHash);
+        if (shard.order.size() > m_shardCapacity)
+        {
+            shard.senders.erase(shard.order.front());
+            shard.order.pop_front();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t size = 0;
+        for (auto& shard : m_shards)
+        {
+            Guard l(shard.lock);
+            size += shard.senders.size();
+        }
+        return size;
+    }
+
+    static SenderCache& instance()
+    {
+        static SenderCache cache;
+        return cache;
+    }
+
+private:
+    // about 100 bytes per transaction
+    static const size_t c_defaultCapacity = 256 * 1024;
+    static const size_t c_shards = 16;
+
+    struct Shard
+    {
+        mutable Mutex lock;
+        FixedHashMap<h256, Address> senders;
+        // hashes in the order they are inserted
+        std::deque<h256> order;
+    };
+
+    Shard& getShard(h256 const& _txHash) const { return m_shards[_txHash[0] % c_shards]; }
+
+    size_t m_shardCapacity;
+    mutable std::array<Shard, c_shards> m_shards;
+};
+
+}  // namespace eth
+}  // namespace dev
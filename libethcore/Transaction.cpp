@@ -22,6 +22,8 @@
 #include "Transaction.h"
 #include "EVMSchedule.h"
 #include "Exceptions.h"
+#include "SenderCache.h"
+#include <algorithm>
 #include <libconfig/GlobalConfigure.h>
 #include <libdevcore/vector_ref.h>
 #include <libdevcrypto/Common.h>
@@ -39,7 +41,7 @@ Transaction::Transaction(bytesConstRef _rlpData, CheckTransaction _checkSig)
 
 void Transaction::decode(bytesConstRef tx_bytes, CheckTransaction _checkSig)
 {
-    m_rlpBuffer.assign(tx_bytes.data(), tx_bytes.data() + tx_bytes.size());
+    m_rlpBuffer = std::make_shared<bytes const>(tx_bytes.begin(), tx_bytes.end());
     RLP const rlp(tx_bytes);
     decode(rlp, _checkSig);
 }
@@ -76,7 +78,8 @@ void Transaction::decodeRC1(RLP const& rlp, CheckTransaction _checkSig)
             BOOST_THROW_EXCEPTION(InvalidTransactionFormat()
                                   << errinfo_comment("rc1 transaction data RLP must be an array"));
 
-        m_data = rlp[6].toBytes();
+        m_data = std::make_shared<bytes const>(rlp[6].toBytes());
+        m_zeroDataBytes = countZeroBytes(*m_data);
 
         // v -> rlp[7].toInt<NumberVType>() - VBase;  // 7
         // r -> rlp[8].toInt<u256>();             // 8
@@ -123,7 +126,8 @@ void Transaction::decodeRC2(RLP const& rlp, CheckTransaction _checkSig)
             BOOST_THROW_EXCEPTION(InvalidTransactionFormat()
                                   << errinfo_comment("rc2 transaction data RLP must be an array"));
 
-        m_data = rlp[6].toBytes();
+        m_data = std::make_shared<bytes const>(rlp[6].toBytes());
+        m_zeroDataBytes = countZeroBytes(*m_data);
         m_chainId = rlp[7].toInt<u256>();
         m_groupId = rlp[8].toInt<u256>();
         m_extraData = rlp[9].toBytes();
@@ -168,10 +172,18 @@ Address const& Transaction::sender() const
         if (!m_vrs)
             BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
 
-        auto p = recover(*m_vrs, sha3(WithoutSignature));
-        if (!p)
-            BOOST_THROW_EXCEPTION(InvalidSignature());
-        m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+        // the txpool, the block decoding and the sync verify the same transaction, only the
+        // first of them recovers the sender
+        auto txHash = sha3();
+        m_sender = SenderCache::instance().get(txHash);
+        if (!m_sender)
+        {
+            auto p = recover(*m_vrs, sha3(WithoutSignature));
+            if (!p)
+                BOOST_THROW_EXCEPTION(InvalidSignature());
+            m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+            SenderCache::instance().insert(txHash, m_sender);
+        }
     }
     return m_sender;
 }
@@ -199,50 +211,42 @@ void Transaction::encode(bytes& _trans, IncludeSignature _sig) const
 
 void Transaction::encodeRC1(bytes& _trans, IncludeSignature _sig) const
 {
-    RLPStream _s;
     if (m_type == NullTransaction)
         return;
-    _s.appendList((_sig ? c_sigCount : 0) + c_fieldCountRC1WithOutSig);
-    _s << m_nonce << m_gasPrice << m_gas << m_blockLimit;
-    if (m_type == MessageCall)
-        _s << m_receiveAddress;
-    else
-        _s << "";
-    _s << m_value << m_data;
-
-    if (_sig)
-    {
-        if (!m_vrs)
-            BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
-
-        m_vrs->encode(_s);
-    }
-
-    _s.swapOut(_trans);
+    if (_sig && !m_vrs)
+        BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
+    rlpEncode(_trans, [&](RLPStream& _s) {
+        _s.appendList((_sig ? c_sigCount : 0) + c_fieldCountRC1WithOutSig);
+        _s << m_nonce << m_gasPrice << m_gas << m_blockLimit;
+        if (m_type == MessageCall)
+            _s << m_receiveAddress;
+        else
+            _s << "";
+        _s << m_value << data();
+
+        if (_sig)
+            m_vrs->encode(_s);
+    });
 }
 
 void Transaction::encodeRC2(bytes& _trans, IncludeSignature _sig) const
 {
-    RLPStream _s;
     if (m_type == NullTransaction)
         return;
-    _s.appendList((_sig ? c_sigCount : 0) + c_fieldCountRC2WithOutSig);
-    _s << m_nonce << m_gasPrice << m_gas << m_blockLimit;
-    if (m_type == MessageCall)
-        _s << m_receiveAddress;
-    else
-        _s << "";
-    _s << m_value << m_data << m_chainId << m_groupId << m_extraData;
-
-    if (_sig)
-    {
-        if (!m_vrs)
-            BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
-
-        m_vrs->encode(_s);
-    }
-
-    _s.swapOut(_trans);
+    if (_sig && !m_vrs)
+        BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
+    rlpEncode(_trans, [&](RLPStream& _s) {
+        _s.appendList((_sig ? c_sigCount : 0) + c_fieldCountRC2WithOutSig);
+        _s << m_nonce << m_gasPrice << m_gas << m_blockLimit;
+        if (m_type == MessageCall)
+            _s << m_receiveAddress;
+        else
+            _s << "";
+        _s << m_value << data() << m_chainId << m_groupId << m_extraData;
+
+        if (_sig)
+            m_vrs->encode(_s);
+    });
 }
 
 static const u256 c_secp256k1n(
@@ -255,6 +259,19 @@ void Transaction::checkLowS() const
     m_vrs->check();
 }
 
+int64_t Transaction::countZeroBytes(bytes const& _data)
+{
+    return std::count(_data.begin(), _data.end(), 0);
+}
+
+int64_t Transaction::baseGasRequired(EVMSchedule const& _es) const
+{
+    int64_t g = isCreation() ? _es.txCreateGas : _es.txGas;
+    int64_t size = data().size();
+    return g + m_zeroDataBytes * _es.txDataZeroGas +
+           (size - m_zeroDataBytes) * _es.txDataNonZeroGas;
+}
+
 int64_t Transaction::baseGasRequired(
     bool _contractCreation, bytesConstRef _data, EVMSchedule const& _es)
 {
@@ -273,6 +290,13 @@ h256 Transaction::sha3(IncludeSignature _sig) const
     if (_sig == WithSignature && m_hashWith)
         return m_hashWith;
 
+    if (_sig == WithSignature && m_rlpBuffer)
+    {
+        // the decoded transaction is hashed as it was received, without encoding it again
+        m_hashWith = dev::sha3(*m_rlpBuffer);
+        return m_hashWith;
+    }
+
     bytes s;
     encode(s, _sig);
 
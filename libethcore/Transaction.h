@@ -74,9 +74,9 @@ public:
         m_receiveAddress(_dest),
         m_gasPrice(_gasPrice),
         m_gas(_gas),
-        m_data(_data),
+        m_data(std::make_shared<bytes const>(_data)),
+        m_zeroDataBytes(countZeroBytes(_data)),
         m_rpcCallback(nullptr),
-        m_rlpBuffer(bytes()),
         m_chainId(_chainId),
         m_groupId(_groupId)
     {}
@@ -89,9 +89,9 @@ public:
         m_value(_value),
         m_gasPrice(_gasPrice),
         m_gas(_gas),
-        m_data(_data),
+        m_data(std::make_shared<bytes const>(_data)),
+        m_zeroDataBytes(countZeroBytes(_data)),
         m_rpcCallback(nullptr),
-        m_rlpBuffer(bytes()),
         m_chainId(_chainId),
         m_groupId(_groupId)
     {}
@@ -109,7 +109,7 @@ public:
     {
         return m_type == _c.m_type &&
                (m_type == ContractCreation || m_receiveAddress == _c.m_receiveAddress) &&
-               m_value == _c.m_value && m_data == _c.m_data;
+               m_value == _c.m_value && data() == _c.data();
     }
     /// Checks inequality of transactions.
     bool operator!=(Transaction const& _c) const { return !operator==(_c); }
@@ -141,12 +141,18 @@ public:
     void encode(bytes& _trans, IncludeSignature _sig = WithSignature) const;
     void decode(bytesConstRef tx_bytes, CheckTransaction _checkSig = CheckTransaction::Everything);
     void decode(RLP const& rlp, CheckTransaction _checkSig = CheckTransaction::Everything);
+    /// @returns the bytes held by the transaction: the object, its data and its encoding
+    size_t capacity() const
+    {
+        return sizeof(Transaction) + (m_data ? m_data->size() : 0) +
+               (m_rlpBuffer ? m_rlpBuffer->size() : 0);
+    }
     /// @returns the RLP serialisation of this transaction.
     bytes rlp(IncludeSignature _sig = WithSignature) const
     {
-        if (m_rlpBuffer != bytes())
+        if (_sig == WithSignature && m_rlpBuffer)
         {
-            return m_rlpBuffer;
+            return *m_rlpBuffer;
         }
         bytes out;
         encode(out, _sig);
@@ -179,7 +185,7 @@ public:
 
     /// @returns the data associated with this (message-call) transaction. Synonym
     /// for initCode().
-    bytes const& data() const { return m_data; }
+    bytes const& data() const { return m_data ? *m_data : NullBytes; }
 
     /// @returns the transaction-count of the sender.
     u256 nonce() const { return m_nonce; }
@@ -190,7 +196,7 @@ public:
         clearSignature();
         m_nonce = _n;
         m_hashWith = h256(0);
-        m_rlpBuffer = bytes();
+        m_rlpBuffer.reset();
     }
 
     void setBlockLimit(u256 const& _blockLimit)
@@ -198,7 +204,7 @@ public:
         clearSignature();
         m_blockLimit = _blockLimit;
         m_hashWith = h256(0);
-        m_rlpBuffer = bytes();
+        m_rlpBuffer.reset();
     }
 
     /// @returns the latest block number to be packaged for transaction.
@@ -225,13 +231,11 @@ public:
         m_vrs = sig;
         m_hashWith = h256(0);
         m_sender = Address();
-        m_rlpBuffer = bytes();
-    }
-    /// @returns amount of gas required for the basic payment.
-    int64_t baseGasRequired(EVMSchedule const& _es) const
-    {
-        return baseGasRequired(isCreation(), &m_data, _es);
+        m_rlpBuffer.reset();
     }
+    /// @returns amount of gas required for the basic payment, from the zero bytes of the data
+    /// counted once when it is set.
+    int64_t baseGasRequired(EVMSchedule const& _es) const;
 
     /// Get the fee associated for a transaction with the given data.
     static int64_t baseGasRequired(
@@ -256,6 +260,8 @@ protected:
                            ///< used.
     };
 
+    static int64_t countZeroBytes(bytes const& _data);
+
     static bool isZeroSignature(u256 const& _r, u256 const& _s) { return !_r && !_s; }
 
     void encodeRC1(bytes& _trans, IncludeSignature _sig = WithSignature) const;
@@ -283,8 +289,10 @@ protected:
                                     ///< to GAS.
     u256 m_gas;    ///< The total gas to convert, paid for from sender's account. Any
                    ///< unused gas gets refunded once the contract is ended.
-    bytes m_data;  ///< The data associated with the transaction, or the
-                   ///< initialiser if it's a creation transaction.
+    std::shared_ptr<bytes const> m_data;  ///< The data associated with the transaction, or
+                                          ///< the initialiser if it's a creation transaction.
+                                          ///< Shared by the copies of the transaction.
+    int64_t m_zeroDataBytes = 0;  ///< The zero bytes of m_data, for the intrinsic gas.
     boost::optional<SignatureStruct> m_vrs;  ///< The signature of the transaction.
                                              ///< Encodes the sender.
     mutable h256 m_hashWith;                 ///< Cached hash of transaction with signature.
@@ -294,8 +302,9 @@ protected:
 
     RPCCallback m_rpcCallback;
 
-    bytes m_rlpBuffer;  /// < The buffer to cache origin RLP sequence. It will be reused when the tx
-                        /// < needs to be encocoded again;
+    /// < The buffer to cache origin RLP sequence. It will be reused when the tx needs to be
+    /// < encoded or hashed again, and is shared by the copies of the transaction.
+    std::shared_ptr<bytes const> m_rlpBuffer;
 
     u256 m_chainId;     /// < The scenario to which the transaction belongs.
     u256 m_groupId;     /// < The group to which the transaction belongs.
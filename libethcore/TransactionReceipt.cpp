@@ -122,3 +122,13 @@ std::ostream& dev::eth::operator<<(std::ostream& _out, TransactionReceipt const&
     _out << "Bloom: " << _r.bloom() << "\n";
     return _out;
 }
+
+LogBloom dev::eth::bloom(TransactionReceipts const& _receipts)
+{
+    LogBloom ret;
+    for (auto const& receipt : _receipts)
+    {
+        orBloom(ret, receipt.bloom());
+    }
+    return ret;
+}
@@ -57,16 +57,14 @@ public:
 
     void encode(bytes& receipt) const
     {
-        RLPStream s;
-        streamRLP(s);
-        s.swapOut(receipt);
+        rlpEncode(receipt, [this](RLPStream& _s) { streamRLP(_s); });
     }
 
     bytes rlp() const
     {
-        RLPStream s;
-        streamRLP(s);
-        return s.out();
+        bytes receipt;
+        encode(receipt);
+        return receipt;
     }
 
     void decode(bytesConstRef receiptsBytes);
@@ -88,6 +86,10 @@ private:
 
 using TransactionReceipts = std::vector<TransactionReceipt>;
 
+/// the bloom of a block, the union of the blooms of its receipts, each computed by the worker
+/// executing the transaction
+LogBloom bloom(TransactionReceipts const& _receipts);
+
 std::ostream& operator<<(std::ostream& _out, eth::TransactionReceipt const& _r);
 
 class LocalisedTransactionReceipt : public TransactionReceipt
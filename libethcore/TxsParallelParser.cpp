@@ -50,7 +50,7 @@ bytes TxsParallelParser::encode(Transactions& _txs)
                 offsets[i + 1] = txByte.size();
 
                 // record bytes in txRLPs for caculating all transaction bytes
-                txRLPs[i] = txByte;
+                txRLPs[i] = std::move(txByte);
             }
         });
 
@@ -66,8 +66,17 @@ bytes TxsParallelParser::encode(Transactions& _txs)
     for (size_t i = 0; i < offsets.size(); ++i)
         ret += toBytes(offsets[i]);
 
-    for (size_t i = 0; i < txNum; ++i)
-        ret += txRLPs[i];
+    // copy the transactions to their offsets in parallel
+    size_t objectStart = ret.size();
+    ret.resize(objectStart + offsets[txNum]);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, txNum), [&](const tbb::blocked_range<size_t>& _r) {
+            for (Offset_t i = _r.begin(); i < _r.end(); ++i)
+            {
+                std::copy(
+                    txRLPs[i].begin(), txRLPs[i].end(), ret.begin() + objectStart + offsets[i]);
+            }
+        });
 
     // std::cout << "tx encode:" << toHex(ret) << std::endl;
     return ret;
@@ -75,7 +84,18 @@ bytes TxsParallelParser::encode(Transactions& _txs)
 
 bytes TxsParallelParser::encode(std::vector<bytes> const& _txs)
 {
-    Offset_t txNum = _txs.size();
+    std::vector<bytesConstRef> objects;
+    objects.reserve(_txs.size());
+    for (auto const& txByte : _txs)
+    {
+        objects.push_back(ref(txByte));
+    }
+    return encode(objects);
+}
+
+bytes TxsParallelParser::encode(std::vector<bytesConstRef> const& _objects)
+{
+    Offset_t txNum = _objects.size();
     if (txNum == 0)
         return bytes();
 
@@ -86,10 +106,10 @@ bytes TxsParallelParser::encode(std::vector<bytes> const& _txs)
     // encode tx and caculate offset
     for (Offset_t i = 0; i < txNum; ++i)
     {
-        bytes const& txByte = _txs[i];
+        bytesConstRef txByte = _objects[i];
         offsets[i] = offset;
         offset += txByte.size();
-        txBytes += txByte;
+        txBytes.insert(txBytes.end(), txByte.begin(), txByte.end());
     }
     offsets[txNum] = offset;  // write the end
 
@@ -148,6 +168,8 @@ void TxsParallelParser::decode(
         {
             tbb::parallel_for(tbb::blocked_range<Offset_t>(0, txNum),
                 [&](const tbb::blocked_range<Offset_t>& _r) {
+                    std::vector<bytesConstRef> txRLPs;
+                    txRLPs.reserve(_r.size());
                     for (Offset_t i = _r.begin(); i != _r.end(); ++i)
                     {
                         Offset_t offset = offsets[i];
@@ -156,11 +178,26 @@ void TxsParallelParser::decode(
                         if (offset > maxOffset)
                             throwInvalidBlockFormat("offset > maxOffset");
 
-                        _txs[i].decode(txBytes.cropped(offset, size), _checkSig);
-                        if (_withHash)
+                        // the sender is looked up by the hash, so it is recovered after hashing
+                        txRLPs.push_back(txBytes.cropped(offset, size));
+                        _txs[i].decode(txRLPs.back(),
+                            _checkSig == CheckTransaction::Everything ? CheckTransaction::Cheap :
+                                                                        _checkSig);
+                    }
+                    if (_withHash)
+                    {
+                        // the transactions of the range are hashed together
+                        auto txHashes = dev::sha3Batch(txRLPs);
+                        for (Offset_t i = _r.begin(); i != _r.end(); ++i)
+                        {
+                            _txs[i].updateTransactionHashWithSig(txHashes[i - _r.begin()]);
+                        }
+                    }
+                    for (Offset_t i = _r.begin(); i != _r.end(); ++i)
+                    {
+                        if (_checkSig == CheckTransaction::Everything)
                         {
-                            dev::h256 txHash = dev::sha3(txBytes.cropped(offset, size));
-                            _txs[i].updateTransactionHashWithSig(txHash);
+                            _txs[i].sender();
                         } /*
                          LOG(DEBUG) << LOG_BADGE("DECODE") << LOG_DESC("decode tx:") << LOG_KV("i",
                          i)
@@ -181,5 +218,30 @@ void TxsParallelParser::decode(
     }
 }
 
+size_t TxsParallelParser::count(bytesConstRef _bytes)
+{
+    if (_bytes.size() == 0)
+        return 0;
+    if (_bytes.size() < sizeof(Offset_t))
+        throwInvalidBlockFormat("bytesSize < sizeof(Offset_t)");
+    return fromBytes(_bytes.cropped(0));
+}
+
+bytesConstRef TxsParallelParser::object(bytesConstRef _bytes, size_t _index)
+{
+    size_t txNum = count(_bytes);
+    if (_index >= txNum)
+        throwInvalidBlockFormat("index >= txNum");
+    size_t objectStart = sizeof(Offset_t) * (txNum + 2);
+    if (objectStart >= _bytes.size())
+        throwInvalidBlockFormat("objectStart >= bytesSize");
+
+    Offset_t offset = fromBytes(_bytes.cropped(sizeof(Offset_t) * (_index + 1)));
+    Offset_t end = fromBytes(_bytes.cropped(sizeof(Offset_t) * (_index + 2)));
+    if (offset > end || end > _bytes.size() - objectStart)
+        throwInvalidBlockFormat("offset > end || end > objectsSize");
+    return _bytes.cropped(objectStart + offset, end - offset);
+}
+
 }  // namespace eth
 }  // namespace dev
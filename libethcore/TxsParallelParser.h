@@ -45,9 +45,15 @@ class TxsParallelParser
 public:
     static bytes encode(Transactions& _txs);
     static bytes encode(std::vector<bytes> const& _txs);
+    static bytes encode(std::vector<bytesConstRef> const& _objects);
     static void decode(Transactions& _txs, bytesConstRef _bytes,
         CheckTransaction _checkSig = CheckTransaction::Everything, bool _withHash = false);
 
+    /// @returns the number of objects encoded in _bytes
+    static size_t count(bytesConstRef _bytes);
+    /// @returns the _index-th object of _bytes, the others are not decoded
+    static bytesConstRef object(bytesConstRef _bytes, size_t _index);
+
 private:
     static inline bytes toBytes(Offset_t _num)
     {
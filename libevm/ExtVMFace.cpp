@@ -228,6 +228,15 @@ evmc_context_fn_table const fnTable = {
 ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address const& _myAddress, Address const& _caller,
     Address const& _origin, u256 const& _value, u256 const& _gasPrice, bytesConstRef _data,
     bytes _code, h256 const& _codeHash, unsigned _depth, bool _isCreate, bool _staticCall)
+  : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data,
+        std::make_shared<bytes const>(std::move(_code)), _codeHash, _depth, _isCreate,
+        _staticCall)
+{}
+
+ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address const& _myAddress, Address const& _caller,
+    Address const& _origin, u256 const& _value, u256 const& _gasPrice, bytesConstRef _data,
+    std::shared_ptr<bytes const> _code, h256 const& _codeHash, unsigned _depth, bool _isCreate,
+    bool _staticCall)
   : evmc_context{&fnTable},
     m_envInfo(_envInfo),
     m_myAddress(_myAddress),
@@ -106,6 +106,9 @@ struct CallParameters
     OnOpFunc onOp;
 };
 
+/// Creates an instance of an EVMC VM, the same as evmc_create_fn of evmc/loader.h
+using EVMCCreateFn = evmc_instance* (*)();
+
 /// the information related to the EVM
 class EnvInfo
 {
@@ -149,12 +152,17 @@ public:
     void setPrecompiledEngine(
         std::shared_ptr<dev::blockverifier::ExecutiveContext> executiveEngine);
 
+    /// @return the VM executing the code, nullptr for the VM of the --vm option
+    EVMCCreateFn evmcCreateFn() const { return m_evmcCreateFn; }
+    void setEVMCCreateFn(EVMCCreateFn _evmcCreateFn) { m_evmcCreateFn = _evmcCreateFn; }
+
 
 private:
     BlockHeader m_headerInfo;
     CallBackFunction m_numberHash;
     u256 m_gasUsed;
     std::shared_ptr<dev::blockverifier::ExecutiveContext> m_executiveEngine;
+    EVMCCreateFn m_evmcCreateFn = nullptr;
 };
 
 /// Represents a call result.
@@ -196,6 +204,11 @@ public:
     ExtVMFace(EnvInfo const& _envInfo, Address const& _myAddress, Address const& _caller,
         Address const& _origin, u256 const& _value, u256 const& _gasPrice, bytesConstRef _data,
         bytes _code, h256 const& _codeHash, unsigned _depth, bool _isCreate, bool _staticCall);
+    /// the code shared with the state, not copied
+    ExtVMFace(EnvInfo const& _envInfo, Address const& _myAddress, Address const& _caller,
+        Address const& _origin, u256 const& _value, u256 const& _gasPrice, bytesConstRef _data,
+        std::shared_ptr<bytes const> _code, h256 const& _codeHash, unsigned _depth,
+        bool _isCreate, bool _staticCall);
 
     virtual ~ExtVMFace() = default;
 
@@ -257,7 +270,7 @@ public:
     u256 const& value() { return m_value; }
     u256 const& gasPrice() { return m_gasPrice; }
     bytesConstRef const& data() { return m_data; }
-    bytes const& code() { return m_code; }
+    bytes const& code() { return *m_code; }
     h256 const& codeHash() { return m_codeHash; }
     u256 const& salt() { return m_salt; }
     SubState& sub() { return m_sub; }
@@ -271,7 +284,7 @@ public:
     void setValue(u256 const& _value) { m_value = _value; }
     void setGasePrice(u256 const& _gasPrice) { m_gasPrice = _gasPrice; }
     void setData(bytesConstRef _data) { m_data = _data; }
-    void setCode(bytes& _code) { m_code = _code; }
+    void setCode(bytes& _code) { m_code = std::make_shared<bytes const>(_code); }
     void setCodeHash(h256 const& _codeHash) { m_codeHash = _codeHash; }
     void setSalt(u256 const& _salt) { m_salt = _salt; }
     void setSub(SubState _sub) { m_sub = _sub; }
@@ -289,14 +302,14 @@ private:
     Address m_origin;  ///< Original transactor.
     u256 m_value;      ///< Value (in Wei) that was passed to this address.
     u256 m_gasPrice;   ///< Price of gas (that we already paid).
-    bytesConstRef m_data;       ///< Current input data.
-    bytes m_code;               ///< Current code that is executing.
-    h256 m_codeHash;            ///< SHA3 hash of the executing code
-    u256 m_salt;                ///< Values used in new address construction by CREATE2
-    SubState m_sub;             ///< Sub-band VM state (suicides, refund counter, logs).
-    unsigned m_depth = 0;       ///< Depth of the present call.
-    bool m_isCreate = false;    ///< Is this a CREATE call?
-    bool m_staticCall = false;  ///< Throw on state changing.
+    bytesConstRef m_data;                 ///< Current input data.
+    std::shared_ptr<bytes const> m_code;  ///< Current code that is executing.
+    h256 m_codeHash;                      ///< SHA3 hash of the executing code
+    u256 m_salt;                          ///< Values used in new address construction by CREATE2
+    SubState m_sub;                       ///< Sub-band VM state (suicides, refund counter, logs).
+    unsigned m_depth = 0;                 ///< Depth of the present call.
+    bool m_isCreate = false;              ///< Is this a CREATE call?
+    bool m_staticCall = false;            ///< Throw on state changing.
 };
 
 /**
@@ -27,6 +27,8 @@
 #include <libinterpreter/interpreter.h>
 
 #include <evmc/loader.h>
+#include <libdevcore/Guards.h>
+#include <map>
 
 #ifdef ETH_EVMJIT
 #include <evmjit.h>
@@ -75,20 +77,14 @@ VMKindTableEntry vmKindsTable[] = {
 #endif
     {VMKind::Interpreter, "interpreter"}};
 
-void setVMKind(const std::string& _name)
+/// The EVMC DLLs loaded for groups, by name or path.
+std::map<std::string, evmc_create_fn> g_loadedVMs;
+Mutex x_loadedVMs;
+
+evmc_create_fn loadEVMC(const std::string& _name)
 {
-    for (auto& entry : vmKindsTable)
-    {
-        // Try to find a match in the table of VMs.
-        if (_name == entry.name)
-        {
-            g_kind = entry.kind;
-            return;
-        }
-    }
-    // If not match for predefined VM names, try loading it as an EVMC DLL.
     evmc_loader_error_code ec;
-    g_evmcCreateFn = evmc_load(_name.c_str(), &ec);
+    evmc_create_fn createFn = evmc_load(_name.c_str(), &ec);
     switch (ec)
     {
     case EVMC_LOADER_SUCCESS:
@@ -104,6 +100,29 @@ void setVMKind(const std::string& _name)
             std::system_error(std::error_code(static_cast<int>(ec), std::generic_category()),
                 "loading " + _name + " failed"));
     }
+
+    auto instance = createFn();
+    if (!instance || instance->abi_version != EVMC_ABI_VERSION)
+        BOOST_THROW_EXCEPTION(std::system_error(std::make_error_code(std::errc::invalid_argument),
+            "loading " + _name + " failed: EVMC ABI version mismatch"));
+    if (instance->destroy)
+        instance->destroy(instance);
+    return createFn;
+}
+
+void setVMKind(const std::string& _name)
+{
+    for (auto& entry : vmKindsTable)
+    {
+        // Try to find a match in the table of VMs.
+        if (_name == entry.name)
+        {
+            g_kind = entry.kind;
+            return;
+        }
+    }
+    // If not match for predefined VM names, try loading it as an EVMC DLL.
+    g_evmcCreateFn = loadEVMC(_name);
     g_kind = VMKind::DLL;
 }
 }  // namespace
@@ -199,5 +218,26 @@ std::unique_ptr<VMFace> VMFactory::create(VMKind _kind)
         return std::unique_ptr<VMFace>(new EVMC{evmc_create_interpreter()});
     }
 }
+
+std::unique_ptr<VMFace> VMFactory::create(EVMCCreateFn _createFn)
+{
+    if (!_createFn)
+        return create(g_kind);
+    return std::unique_ptr<VMFace>(new EVMC{_createFn()});
+}
+
+EVMCCreateFn VMFactory::load(std::string const& _name)
+{
+    if (_name.empty() || _name == "interpreter")
+        return nullptr;
+
+    Guard l(x_loadedVMs);
+    auto it = g_loadedVMs.find(_name);
+    if (it != g_loadedVMs.end())
+        return it->second;
+    auto createFn = loadEVMC(_name);
+    g_loadedVMs[_name] = createFn;
+    return createFn;
+}
 }  // namespace eth
 }  // namespace dev
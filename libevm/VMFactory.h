@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "ExtVMFace.h"
 #include "VMFace.h"
 
 #include <boost/program_options/options_description.hpp>
@@ -59,6 +60,13 @@ public:
 
     /// Creates a VM instance of the kind provided.
     static std::unique_ptr<VMFace> create(VMKind _kind);
+
+    /// Creates a VM instance of an EVMC VM, of the global kind if _createFn is nullptr.
+    static std::unique_ptr<VMFace> create(EVMCCreateFn _createFn);
+
+    /// Loads the EVMC DLL of a VM given by name or path, ones loaded before are reused.
+    /// @return nullptr for the interpreter, throws if the DLL can't be loaded
+    static EVMCCreateFn load(std::string const& _name);
 };
 }  // namespace eth
 }  // namespace dev
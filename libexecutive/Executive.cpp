@@ -73,12 +73,14 @@ void Executive::verifyTransaction(
     uint64_t txGasLimit = m_envInfo.precompiledEngine()->txGasLimit();
     // The gas limit is dynamic, not fixed.
     // Pre calculate the gas needed for execution
-    if ((_ir & ImportRequirements::TransactionBasic) &&
-        _t.baseGasRequired(schedule) > (bigint)txGasLimit)
+    if (!(_ir & ImportRequirements::TransactionBasic))
+        return;
+    int64_t baseGasRequired = _t.baseGasRequired(schedule);
+    if (baseGasRequired > (bigint)txGasLimit)
     {
         m_excepted = TransactionException::OutOfGasIntrinsic;
-        BOOST_THROW_EXCEPTION(OutOfGasIntrinsic() << RequirementError(
-                                  (bigint)(_t.baseGasRequired(schedule)), (bigint)txGasLimit));
+        BOOST_THROW_EXCEPTION(OutOfGasIntrinsic()
+                              << RequirementError((bigint)baseGasRequired, (bigint)txGasLimit));
     }
 }
 
@@ -161,10 +163,10 @@ bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address co
             m_gas = _p.gas;
             if (m_s->addressHasCode(_p.codeAddress))
             {
-                bytes const& c = m_s->code(_p.codeAddress);
+                auto c = m_s->sharedCode(_p.codeAddress);
                 h256 codeHash = m_s->codeHash(_p.codeAddress);
                 m_ext = make_shared<ExtVM>(m_s, m_envInfo, _p.receiveAddress, _p.senderAddress,
-                    _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash, m_depth, false,
+                    _origin, _p.apparentValue, _gasPrice, _p.data, c, codeHash, m_depth, false,
                     _p.staticCall);
             }
         }
@@ -228,10 +230,10 @@ bool Executive::callRC2(CallParameters const& _p, u256 const& _gasPrice, Address
     }
     else if (m_s->addressHasCode(_p.codeAddress))
     {
-        bytes const& c = m_s->code(_p.codeAddress);
+        auto c = m_s->sharedCode(_p.codeAddress);
         h256 codeHash = m_s->codeHash(_p.codeAddress);
         m_ext = make_shared<ExtVM>(m_s, m_envInfo, _p.receiveAddress, _p.senderAddress, _origin,
-            _p.apparentValue, _gasPrice, _p.data, &c, codeHash, m_depth, false, _p.staticCall);
+            _p.apparentValue, _gasPrice, _p.data, c, codeHash, m_depth, false, _p.staticCall);
     }
     else
     {
@@ -332,7 +334,7 @@ bool Executive::go(OnOpFunc const& _onOp)
         try
         {
             // Create VM instance. Force Interpreter if tracing requested.
-            auto vm = VMFactory::create();
+            auto vm = VMFactory::create(m_envInfo.evmcCreateFn());
             if (m_isCreation)
             {
                 m_s->clearStorage(m_ext->myAddress());
@@ -59,6 +59,19 @@ public:
         assert(m_s->addressInUse(_myAddress));
     }
 
+    /// Full constructor of a call, running the code shared with the state.
+    ExtVM(std::shared_ptr<StateFace> _s, dev::eth::EnvInfo const& _envInfo,
+        Address const& _myAddress, Address const& _caller, Address const& _origin,
+        u256 const& _value, u256 const& _gasPrice, bytesConstRef _data,
+        std::shared_ptr<bytes const> _code, h256 const& _codeHash, unsigned _depth,
+        bool _isCreate, bool _staticCall)
+      : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data,
+            std::move(_code), _codeHash, _depth, _isCreate, _staticCall),
+        m_s(_s)
+    {
+        assert(m_s->addressInUse(_myAddress));
+    }
+
     /// Read storage location.
     u256 store(u256 const& _n) final { return m_s->storage(myAddress(), _n); }
 
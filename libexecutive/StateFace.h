@@ -109,6 +109,14 @@ public:
     ///          other account. Do not keep it.
     virtual bytes const code(Address const& _addr) const = 0;
 
+    /// Get the code of an account without copying it, the code may be shared with the other
+    /// executions of the same code and is kept as long as needed.
+    /// @returns empty bytes if no account exists at that address.
+    virtual std::shared_ptr<bytes const> sharedCode(Address const& _addr) const
+    {
+        return std::make_shared<bytes const>(code(_addr));
+    }
+
     /// Get the code hash of an account.
     /// @returns EmptySHA3 if no account exists at that address or if there is no code associated
     /// with the address.
@@ -156,6 +164,10 @@ public:
     /// Clear state's cache
     virtual void clear() = 0;
 
+    /// Write the changes cached by the executing transaction, called before the transaction
+    /// leaves its undo log.
+    virtual void flush() = 0;
+
     /// Check authority
     virtual bool checkAuthority(Address const& _origin, Address const& _contract) const = 0;
 };
@@ -53,7 +53,6 @@ static bool canRotate()
  * @param pt: ptree that contains the log configuration
  * @param channel: channel name
  * @param logType: log prefix
- * @ TODO: improve the log flush performance
  */
 void LogInitializer::initLog(
     boost::property_tree::ptree const& pt, std::string const& channel, std::string const& logType)
@@ -70,9 +69,10 @@ void LogInitializer::initLog(
     /// set rotation size MB
     uint64_t rotation_size = pt.get<uint64_t>("log.max_log_file_size", 200) * 1048576;
     sink->locked_backend()->set_rotation_size(rotation_size);
-    /// set auto-flush according to log configuration
+    /// the writer thread of the sink writes the records in batches through the buffer of the
+    /// file, which is flushed every c_logFlushMilliseconds if log.flush is set
+    sink->locked_backend()->auto_flush(false);
     bool need_flush = pt.get<bool>("log.flush", true);
-    sink->locked_backend()->auto_flush(need_flush);
     /// set file format
     /// log-level|timestamp |[g:groupId] message
     sink->set_formatter(
@@ -94,6 +94,19 @@ void LogInitializer::initLog(
     m_sinks.push_back(sink);
     bool enable_log = pt.get<bool>("log.enable", true);
     boost::log::core::get()->set_logging_enabled(enable_log);
+    if (channel == dev::FileLogger)
+    {
+        /// the records filtered out are skipped by LOG before they are built
+        dev::g_fileLogLevel = enable_log ? (int)log_level : (int)boost::log::trivial::fatal + 1;
+    }
+    if (need_flush)
+    {
+        {
+            std::lock_guard<std::mutex> l(x_flush);
+            m_flushedSinks.push_back(sink);
+        }
+        startFlushing();
+    }
     // add attributes
     boost::log::add_common_attributes();
 }
@@ -120,9 +133,41 @@ unsigned LogInitializer::getLogLevel(std::string const& levelStr)
     return boost::log::trivial::severity_level::info;
 }
 
+void LogInitializer::startFlushing()
+{
+    std::lock_guard<std::mutex> l(x_flush);
+    if (m_flushing)
+        return;
+    m_flushing = true;
+    m_flushThread = std::make_shared<std::thread>([this]() {
+        dev::pthread_setThreadName("LogFlush");
+        std::unique_lock<std::mutex> l(x_flush);
+        while (!m_flushStopped.wait_for(l, std::chrono::milliseconds(c_logFlushMilliseconds),
+            [this]() { return !m_flushing; }))
+        {
+            for (auto const& sink : m_flushedSinks)
+                sink->locked_backend()->flush();
+        }
+    });
+}
+
+void LogInitializer::stopFlushing()
+{
+    {
+        std::lock_guard<std::mutex> l(x_flush);
+        m_flushing = false;
+        m_flushedSinks.clear();
+    }
+    m_flushStopped.notify_all();
+    if (m_flushThread && m_flushThread->joinable())
+        m_flushThread->join();
+    m_flushThread.reset();
+}
+
 /// stop and remove all sinks after the program exit
 void LogInitializer::stopLogging()
 {
+    stopFlushing();
     for (auto const& sink : m_sinks)
         stopLogging(sink);
     m_sinks.clear();
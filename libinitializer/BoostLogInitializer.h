@@ -27,21 +27,35 @@
 #include <boost/log/expressions.hpp>
 #include <boost/log/expressions/formatters/named_scope.hpp>
 #include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/bounded_fifo_queue.hpp>
+#include <boost/log/sinks/drop_on_overflow.hpp>
 #include <boost/log/sinks/text_file_backend.hpp>
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/file.hpp>
 #include <boost/shared_ptr.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 namespace dev
 {
 namespace initializer
 {
+/// the records queued for the writer of a sink, the records over are dropped rather than block
+/// the threads logging
+static const size_t c_logQueueRecords = 100000;
+/// the ms between two flushes of the files with log.flush on
+static const unsigned c_logFlushMilliseconds = 100;
+
 class LogInitializer
 {
 public:
     typedef std::shared_ptr<LogInitializer> Ptr;
-    typedef boost::log::sinks::asynchronous_sink<boost::log::sinks::text_file_backend> sink_t;
+    typedef boost::log::sinks::asynchronous_sink<boost::log::sinks::text_file_backend,
+        boost::log::sinks::bounded_fifo_queue<c_logQueueRecords,
+            boost::log::sinks::drop_on_overflow>>
+        sink_t;
     virtual ~LogInitializer() { stopLogging(); }
     LogInitializer() {}
     void initLog(boost::property_tree::ptree const& _pt,
@@ -56,7 +70,17 @@ public:
 
 private:
     void stopLogging(boost::shared_ptr<sink_t> sink);
+    /// flush the files of the sinks periodically, rather than after each record
+    void startFlushing();
+    void stopFlushing();
+
     std::vector<boost::shared_ptr<sink_t>> m_sinks;
+    /// the sinks flushed by m_flushThread
+    std::vector<boost::shared_ptr<sink_t>> m_flushedSinks;
+    std::mutex x_flush;
+    std::condition_variable m_flushStopped;
+    bool m_flushing = false;
+    std::shared_ptr<std::thread> m_flushThread;
 };
 }  // namespace initializer
 }  // namespace dev
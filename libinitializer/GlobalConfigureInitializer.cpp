@@ -22,6 +22,11 @@
 
 
 #include "GlobalConfigureInitializer.h"
+#include <libdevcore/Affinity.h>
+#include <libdevcore/Allocator.h>
+#include <libdevcore/Executor.h>
+#include <libdevcore/Tracing.h>
+#include <libstorage/RocksDBEnv.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -103,6 +108,13 @@ void dev::initializer::initGlobalConfig(const boost::property_tree::ptree& _pt)
 
     g_BCOSConfig.diskEncryption.cipherDataKey =
         _pt.get<std::string>(sectionName + ".cipher_data_key", "");
+    int64_t keyCacheTTL = _pt.get<int64_t>(sectionName + ".key_cache_ttl", 0);
+    if (keyCacheTTL < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set " + sectionName + ".key_cache_ttl to positive!"));
+    }
+    g_BCOSConfig.diskEncryption.keyCacheTTL = keyCacheTTL * 1000;
 
     /// compress related option, default enable
     bool enableCompress = _pt.get<bool>("p2p.enable_compress", true);
@@ -117,6 +129,74 @@ void dev::initializer::initGlobalConfig(const boost::property_tree::ptree& _pt)
     }
     g_BCOSConfig.setChainId(chainId);
 
+    /// the spans of the blocks, written to a file by the exportTrace RPC
+    bool enableTrace = _pt.get<bool>("trace.enable", false);
+    int64_t traceCapacity = _pt.get<int64_t>("trace.capacity", c_traceCapacity);
+    if (traceCapacity <= 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            ForbidNegativeValue() << errinfo_comment("Please set trace.capacity to positive!"));
+    }
+    std::string tracePath = _pt.get<std::string>("trace.path", "./trace");
+    g_tracer.configure(enableTrace, traceCapacity, tracePath);
+
+    /// the cores of the threads of each group, of the network and of the storage, before any
+    /// thread is started to inherit the free cores
+    std::map<int, std::vector<unsigned>> groupCores;
+    std::vector<unsigned> networkCores;
+    std::vector<unsigned> storageCores;
+    if (auto affinity = _pt.get_child_optional("affinity"))
+    {
+        for (auto const& it : *affinity)
+        {
+            auto cores = CPUAffinity::parseCores(it.second.data());
+            if (boost::starts_with(it.first, "group."))
+            {
+                int groupID = 0;
+                if (!boost::conversion::try_lexical_convert(it.first.substr(6), groupID))
+                {
+                    BOOST_THROW_EXCEPTION(InvalidCoreList()
+                                          << errinfo_comment("Invalid affinity." + it.first));
+                }
+                groupCores[groupID] = cores;
+            }
+            else if (it.first == "network")
+            {
+                networkCores = cores;
+            }
+            else if (it.first == "storage")
+            {
+                storageCores = cores;
+            }
+        }
+    }
+    g_cpuAffinity.configure(groupCores, networkCores, storageCores);
+
+    /// the workers running the tasks of the pools of all modules and groups, 0 for one per core
+    int64_t executorThreads = _pt.get<int64_t>("executor.threads", 0);
+    if (executorThreads < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue()
+                              << errinfo_comment("Please set executor.threads to positive!"));
+    }
+    bool pinThreads = _pt.get<bool>("executor.pin_threads", false);
+    g_executor.configure(executorThreads, pinThreads);
+
+    /// the tables of the caches of the storage and the blocks on transparent huge pages
+    bool cacheHugePages = _pt.get<bool>("memory.cache_huge_pages", false);
+    setCacheHugePages(cacheHugePages);
+
+    /// the memory and the background writes of the rocksdb of all groups, 0 for each db its own
+    int64_t rocksDBMemory = _pt.get<int64_t>("rocksdb.memory_budget", 0);
+    int64_t rocksDBRateLimit = _pt.get<int64_t>("rocksdb.rate_limit", 0);
+    if (rocksDBMemory < 0 || rocksDBRateLimit < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set rocksdb.memory_budget and rocksdb.rate_limit to "
+                                  "positive!"));
+    }
+    g_rocksDBEnv.configure(rocksDBMemory * 1024 * 1024, rocksDBRateLimit * 1024 * 1024);
+
     if (g_BCOSConfig.diskEncryption.enable)
     {
         INITIALIZER_LOG(INFO) << LOG_BADGE("initKeyManager")
@@ -130,5 +210,15 @@ void dev::initializer::initGlobalConfig(const boost::property_tree::ptree& _pt)
                           << LOG_KV("enableCompress", g_BCOSConfig.compressEnabled())
                           << LOG_KV("compatibilityVersion", version)
                           << LOG_KV("versionNumber", g_BCOSConfig.version())
-                          << LOG_KV("chainId", g_BCOSConfig.chainId());
+                          << LOG_KV("chainId", g_BCOSConfig.chainId())
+                          << LOG_KV("enableTrace", enableTrace)
+                          << LOG_KV("traceCapacity", traceCapacity)
+                          << LOG_KV("tracePath", tracePath)
+                          << LOG_KV("executorThreads", g_executor.threads())
+                          << LOG_KV("pinThreads", pinThreads)
+                          << LOG_KV("cpuAffinity", g_cpuAffinity.enabled())
+                          << LOG_KV("allocator", allocatorName())
+                          << LOG_KV("cacheHugePages", cacheHugePages)
+                          << LOG_KV("rocksDBMemoryBudget", rocksDBMemory)
+                          << LOG_KV("rocksDBRateLimit", rocksDBRateLimit);
 }
@@ -34,6 +34,7 @@ public:
     {
         g_keyCenter->setIpPort(
             g_BCOSConfig.diskEncryption.keyCenterIP, g_BCOSConfig.diskEncryption.keyCenterPort);
+        g_keyCenter->setCacheTTL(g_BCOSConfig.diskEncryption.keyCacheTTL);
     }
 };
 
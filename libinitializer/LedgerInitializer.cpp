@@ -21,10 +21,14 @@
  */
 
 #include "LedgerInitializer.h"
+#include <libdevcore/Allocator.h>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <set>
 
 using namespace dev;
 using namespace std;
@@ -38,11 +42,43 @@ void LedgerInitializer::initConfig(boost::property_tree::ptree const& _pt)
     auto groupConfigPath = _pt.get<string>("group.group_config_path", "conf/");
     assert(m_p2pService);
     m_ledgerManager = make_shared<LedgerManager>();
+    /// the groups share the workers and the cache budget of the process
+    auto threads = _pt.get<int>("scheduler.threads", 0);
+    auto cacheBudget = _pt.get<int64_t>("scheduler.cache_budget", 0);
+    if (threads < 0 || cacheBudget < 0)
+    {
+        BOOST_THROW_EXCEPTION(InitLedgerConfigFailed() << errinfo_comment(
+                                  "Please set scheduler.threads and scheduler.cache_budget to "
+                                  "positive !"));
+    }
+    auto groupScheduler = make_shared<GroupScheduler>(threads, cacheBudget * 1024 * 1024);
+    /// the budget tuned by the memory of the process and the misses of the caches
+    if (_pt.get<bool>("scheduler.cache_auto_tune", false))
+    {
+        auto minBudget = _pt.get<int64_t>("scheduler.cache_min_budget", 32);
+        /// half of the memory the process may take by default
+        auto maxBudget =
+            _pt.get<int64_t>("scheduler.cache_max_budget", processMemoryLimit() / 2 / 1024 / 1024);
+        auto memoryPercent =
+            _pt.get<int>("scheduler.cache_memory_percent", c_defaultCacheMemoryPercent);
+        if (minBudget < 0 || maxBudget <= 0 || minBudget > maxBudget || memoryPercent <= 0 ||
+            memoryPercent > 100)
+        {
+            BOOST_THROW_EXCEPTION(InitLedgerConfigFailed() << errinfo_comment(
+                                      "Please set scheduler.cache_min_budget no more than "
+                                      "scheduler.cache_max_budget and "
+                                      "scheduler.cache_memory_percent in (0, 100] !"));
+        }
+        groupScheduler->setCacheTuning(
+            minBudget * 1024 * 1024, maxBudget * 1024 * 1024, memoryPercent);
+    }
+    m_ledgerManager->setGroupScheduler(groupScheduler);
     map<GROUP_ID, h512s> groudID2NodeList;
-    bool succ = true;
     try
     {
         LOG(INFO) << LOG_BADGE("LedgerInitializer") << LOG_KV("groupConfigPath", groupConfigPath);
+        /// the groups are inited concurrently, each opens its own DB and loads its own chain
+        vector<pair<GROUP_ID, string>> groupConfigs;
         fs::path path(groupConfigPath);
         if (fs::is_directory(path))
         {
@@ -62,25 +98,51 @@ void LedgerInitializer::initConfig(boost::property_tree::ptree const& _pt)
                             << LOG_KV("configFile", iter->path().string());
                         continue;
                     }
-                    succ = initLedger(groupID, m_groupDataDir, iter->path().string());
-                    if (!succ)
-                    {
-                        INITIALIZER_LOG(ERROR)
-                            << LOG_BADGE("LedgerInitializer") << LOG_DESC("initSingleGroup failed")
-                            << LOG_KV("configFile", iter->path().string());
-                        ERROR_OUTPUT << LOG_BADGE("LedgerInitializer")
-                                     << LOG_DESC("initSingleGroup failed")
-                                     << LOG_KV("configFile", iter->path().string()) << endl;
-                        BOOST_THROW_EXCEPTION(InitLedgerConfigFailed());
-                    }
-                    groudID2NodeList[groupID] = m_ledgerManager->getParamByGroupId(groupID)
-                                                    ->mutableConsensusParam()
-                                                    .sealerList;
-                    LOG(INFO) << LOG_BADGE("LedgerInitializer init group succ")
-                              << LOG_KV("groupID", groupID);
+                    groupConfigs.push_back(make_pair(groupID, iter->path().string()));
+                }
+            }
+        }
+        vector<shared_ptr<LedgerInterface>> ledgers(groupConfigs.size());
+        set<GROUP_ID> groupIDs;
+        for (auto const& config : groupConfigs)
+        {
+            if (!groupIDs.insert(config.first).second)
+            {
+                INITIALIZER_LOG(ERROR) << "[initSingleLedger] Group already inited [GroupId]:  "
+                                       << std::to_string(config.first);
+                BOOST_THROW_EXCEPTION(InitLedgerConfigFailed());
+            }
+        }
+        auto startTime = utcTime();
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, groupConfigs.size(), 1),
+            [&](tbb::blocked_range<size_t> const& _range) {
+                for (size_t i = _range.begin(); i != _range.end(); ++i)
+                {
+                    ledgers[i] = initLedger(
+                        groupConfigs[i].first, m_groupDataDir, groupConfigs[i].second);
                 }
+            });
+        for (size_t i = 0; i < groupConfigs.size(); ++i)
+        {
+            auto groupID = groupConfigs[i].first;
+            if (!ledgers[i])
+            {
+                INITIALIZER_LOG(ERROR)
+                    << LOG_BADGE("LedgerInitializer") << LOG_DESC("initSingleGroup failed")
+                    << LOG_KV("configFile", groupConfigs[i].second);
+                ERROR_OUTPUT << LOG_BADGE("LedgerInitializer") << LOG_DESC("initSingleGroup failed")
+                             << LOG_KV("configFile", groupConfigs[i].second) << endl;
+                BOOST_THROW_EXCEPTION(InitLedgerConfigFailed());
             }
+            m_ledgerManager->insertLedger(groupID, ledgers[i]);
+            groudID2NodeList[groupID] =
+                m_ledgerManager->getParamByGroupId(groupID)->mutableConsensusParam().sealerList;
+            LOG(INFO) << LOG_BADGE("LedgerInitializer init group succ")
+                      << LOG_KV("groupID", groupID);
         }
+        INITIALIZER_LOG(INFO) << LOG_BADGE("LedgerInitializer") << LOG_DESC("init groups")
+                              << LOG_KV("groups", groupConfigs.size())
+                              << LOG_KV("timeCost", utcTime() - startTime);
         m_p2pService->setGroupID2NodeList(groudID2NodeList);
     }
     catch (exception& e)
@@ -103,22 +165,23 @@ void LedgerInitializer::initConfig(boost::property_tree::ptree const& _pt)
     }
 }
 
-bool LedgerInitializer::initLedger(
+std::shared_ptr<LedgerInterface> LedgerInitializer::initLedger(
     dev::GROUP_ID const& _groupId, std::string const& _dataDir, std::string const& configFileName)
 {
     if (m_ledgerManager->isLedgerExist(_groupId))
     {
         INITIALIZER_LOG(ERROR) << "[initSingleLedger] Group already inited [GroupId]:  "
                                << std::to_string(_groupId);
-        return false;
+        return nullptr;
     }
     std::shared_ptr<LedgerInterface> ledger =
         std::make_shared<Ledger>(m_p2pService, _groupId, m_keyPair, _dataDir);
     INITIALIZER_LOG(INFO) << "[initSingleLedger] [GroupId]:  " << std::to_string(_groupId);
     ledger->setChannelRPCServer(m_channelRPCServer);
-    bool succ = ledger->initLedger(configFileName);
-    if (!succ)
-        return false;
-    m_ledgerManager->insertLedger(_groupId, ledger);
-    return true;
+    ledger->setGroupScheduler(m_ledgerManager->groupScheduler());
+    if (!ledger->initLedger(configFileName))
+    {
+        return nullptr;
+    }
+    return ledger;
 }
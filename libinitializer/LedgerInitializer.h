@@ -67,7 +67,8 @@ public:
     }
 
 private:
-    bool initLedger(dev::GROUP_ID const& _groupId, std::string const& _dataDir = "data",
+    /// the ledger of _groupId inited, null on failure, called concurrently for the groups
+    std::shared_ptr<LedgerInterface> initLedger(dev::GROUP_ID const& _groupId, std::string const& _dataDir = "data",
         std::string const& configFileName = "");
     std::shared_ptr<LedgerManager> m_ledgerManager;
     std::shared_ptr<dev::p2p::P2PInterface> m_p2pService;
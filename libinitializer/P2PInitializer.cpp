@@ -28,6 +28,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <algorithm>
+#include <thread>
 
 using namespace dev;
 using namespace dev::p2p;
@@ -123,6 +125,22 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
 
         auto asioInterface = std::make_shared<dev::network::ASIOInterface>();
         asioInterface->setIOService(std::make_shared<ba::io_service>());
+        /// the sessions are spread over an io_service per core by default, 1 to run them all on
+        /// the io_service of the host
+        size_t ioThreads = _pt.get<size_t>("p2p.io_threads", 0);
+        if (ioThreads == 0)
+        {
+            ioThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (ioThreads > 1)
+        {
+            std::vector<std::shared_ptr<ba::io_service>> ioServices;
+            for (size_t i = 0; i < ioThreads; ++i)
+            {
+                ioServices.push_back(std::make_shared<ba::io_service>(1));
+            }
+            asioInterface->setSessionIOServices(ioServices);
+        }
         asioInterface->setSSLContext(m_SSLContext);
         asioInterface->setType(dev::network::ASIOInterface::SSL);
 
@@ -142,7 +160,7 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
         host->setSessionFactory(std::make_shared<dev::network::SessionFactory>());
         host->setMessageFactory(messageFactory);
         host->setHostPort(listenIP, listenPort);
-        host->setThreadPool(std::make_shared<ThreadPool>("P2P", 4));
+        host->setThreadPool(std::make_shared<ThreadPool>("P2P", 4, TaskPriority::High));
         host->setCRL(certBlacklist);
 
         m_p2pService = std::make_shared<Service>();
@@ -150,6 +168,10 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
         m_p2pService->setStaticNodes(nodes);
         m_p2pService->setKeyPair(m_keyPair);
         m_p2pService->setP2PMessageFactory(messageFactory);
+        m_p2pService->setGroupThreads(_pt.get<size_t>("p2p.group_threads", 2));
+        /// in KB per second, the consensus is never limited
+        m_p2pService->setTrafficLimits(_pt.get<uint64_t>("p2p.sync_bandwidth", 0) * 1024,
+            _pt.get<uint64_t>("p2p.gossip_bandwidth", 0) * 1024);
         m_p2pService->start();
     }
     catch (std::exception& e)
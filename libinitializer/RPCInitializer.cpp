@@ -21,6 +21,7 @@
  */
 
 #include "RPCInitializer.h"
+#include <libdevcore/CommonJS.h>
 
 using namespace dev;
 using namespace dev::initializer;
@@ -76,6 +77,23 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
         exit(1);
     }
 
+    /// the queries of both servers share the pools
+    auto queryExecutor = std::make_shared<rpc::QueryExecutor>(
+        _pt.get<size_t>("rpc.query_threads", rpc::c_queryThreads),
+        _pt.get<size_t>("rpc.call_threads", rpc::c_callThreads),
+        _pt.get<size_t>("rpc.max_pending_queries", rpc::c_maxPendingQueries));
+    /// in MB, 0 to disable the cache
+    size_t responseCacheSize = _pt.get<size_t>(
+        "rpc.response_cache_size", rpc::c_responseCacheBytes / (1024 * 1024));
+    rpc::ResponseCache::Ptr responseCache;
+    if (responseCacheSize > 0)
+    {
+        responseCache = std::make_shared<rpc::ResponseCache>(responseCacheSize * 1024 * 1024);
+        m_cacheWarmer = std::make_shared<ThreadPool>("RPCCacheWarm", 1, TaskPriority::Low);
+    }
+
+    m_eventPusher = std::make_shared<ThreadPool>("ChannelEvent", 1, TaskPriority::Low);
+
     try
     {
 #if 0
@@ -98,7 +116,9 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
 #endif
 
         auto rpcEntity = new rpc::Rpc(m_ledgerManager, m_p2pService);
+        rpcEntity->setResponseCache(responseCache);
         m_channelRPCHttpServer = new ModularServer<rpc::Rpc>(rpcEntity);
+        m_channelRPCHttpServer->setQueryExecutor(queryExecutor);
         m_channelRPCHttpServer->addConnector(m_channelRPCServer.get());
         // TODO: StartListening() will throw exception, catch it and give more specific help
         if (!m_channelRPCHttpServer->StartListening())
@@ -114,6 +134,9 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
 
         m_channelRPCServer->setCallbackSetter(
             std::bind(&rpc::Rpc::setCurrentTransactionCallback, rpcEntity, std::placeholders::_1));
+        auto ledgerManager = m_ledgerManager;
+        m_channelRPCServer->setBlockChainGetter(
+            [ledgerManager](int _groupID) { return ledgerManager->blockChain(_groupID); });
 
         for (auto it : m_ledgerManager->getGroupList())
         {
@@ -141,15 +164,88 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
             });
 
             m_channelRPCServer->addHandler(handler);
+
+            /// the events are gathered off the commit, one block after another
+            auto eventPusher = m_eventPusher;
+            m_blockHandlers.push_back(blockChain->onReady(
+                [groupID, blockChain, channelRPCServer, eventPusher](int64_t number) {
+                    auto c = channelRPCServer.lock();
+                    if (!c)
+                    {
+                        return;
+                    }
+                    bool logs = c->eventSubscribed(groupID, true);
+                    if (!logs && !c->eventSubscribed(groupID, false))
+                    {
+                        return;
+                    }
+                    eventPusher->enqueue([groupID, blockChain, channelRPCServer, number, logs]() {
+                        auto c = channelRPCServer.lock();
+                        auto block = blockChain->getBlockByNumber(number);
+                        if (!c || !block)
+                        {
+                            return;
+                        }
+                        dev::eth::TransactionReceipts receipts;
+                        if (logs)
+                        {
+                            for (auto const& tx : block->transactions())
+                            {
+                                receipts.push_back(
+                                    blockChain->getTransactionReceiptByHash(tx.sha3()));
+                            }
+                        }
+                        c->pushEvents(groupID, *block, receipts);
+                    });
+                }));
+
+            if (responseCache)
+            {
+                /// the new block is cached ahead of the explorers asking for it
+                auto cacheWarmer = m_cacheWarmer;
+                m_blockHandlers.push_back(blockChain->onReady(
+                    [groupID, responseCache, cacheWarmer, rpcEntity](int64_t number) {
+                        responseCache->onBlockCommitted(groupID);
+                        cacheWarmer->enqueue([groupID, rpcEntity, number]() {
+                            try
+                            {
+                                rpcEntity->getBlockByNumber(groupID, toJS(number), false);
+                                rpcEntity->getBlockByNumber(groupID, toJS(number), true);
+                            }
+                            catch (std::exception& e)
+                            {
+                                INITIALIZER_LOG(WARNING)
+                                    << LOG_BADGE("RPCInitializer") << LOG_DESC("warm cache failed")
+                                    << LOG_KV("groupID", groupID) << LOG_KV("number", number)
+                                    << LOG_KV("what", e.what());
+                            }
+                        });
+                    }));
+            }
         }
 
         /// init httpListenPort
         ///< Donot to set destructions, the ModularServer will destruct.
         rpcEntity = new rpc::Rpc(m_ledgerManager, m_p2pService);
-        m_safeHttpServer.reset(
-            new SafeHttpServer(listenIP, httpListenPort), [](SafeHttpServer* p) { (void)p; });
+        rpcEntity->setResponseCache(responseCache);
         m_jsonrpcHttpServer = new ModularServer<rpc::Rpc>(rpcEntity);
-        m_jsonrpcHttpServer->addConnector(m_safeHttpServer.get());
+        m_jsonrpcHttpServer->setQueryExecutor(queryExecutor);
+        /// "asio" for the keep-alive server on Beast, which may serve WebSocket too
+        std::string httpServer = _pt.get<std::string>("rpc.http_server", "microhttpd");
+        if (httpServer == "asio")
+        {
+            m_jsonrpcHttpServer->addConnector(new HttpServer(listenIP, httpListenPort,
+                _pt.get<size_t>("rpc.http_threads", 4),
+                _pt.get<size_t>("rpc.max_http_connections", c_maxHttpConnections),
+                _pt.get<bool>("rpc.enable_websocket", false)));
+        }
+        else
+        {
+            m_safeHttpServer.reset(
+                new SafeHttpServer(listenIP, httpListenPort), [](SafeHttpServer* p) { (void)p; });
+            m_jsonrpcHttpServer->addConnector(m_safeHttpServer.get());
+        }
+        INITIALIZER_LOG(INFO) << LOG_BADGE("RPCInitializer") << LOG_KV("httpServer", httpServer);
         // TODO: StartListening() will throw exception, catch it and give more specific help
         if (!m_jsonrpcHttpServer->StartListening())
         {
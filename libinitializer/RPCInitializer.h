@@ -27,6 +27,7 @@
 #include <libledger/LedgerManager.h>
 #include <libp2p/P2PInterface.h>
 #include <librpc/Rpc.h>
+#include <librpc/HttpServer.h>
 #include <librpc/SafeHttpServer.h>
 
 namespace dev
@@ -42,6 +43,16 @@ public:
 
     void stop()
     {
+        /// the cache warmer calls the rpc of the channel server, the event pusher its sessions
+        m_blockHandlers.clear();
+        if (m_cacheWarmer)
+        {
+            m_cacheWarmer->stop();
+        }
+        if (m_eventPusher)
+        {
+            m_eventPusher->stop();
+        }
         /// stop channel first
         if (m_channelRPCHttpServer)
         {
@@ -85,6 +96,9 @@ private:
     ChannelRPCServer::Ptr m_channelRPCServer;
     ModularServer<>* m_channelRPCHttpServer;
     ModularServer<>* m_jsonrpcHttpServer;
+    ThreadPool::Ptr m_cacheWarmer;
+    ThreadPool::Ptr m_eventPusher;
+    std::vector<dev::eth::Handler<int64_t>> m_blockHandlers;
 };
 
 }  // namespace initializer
@@ -177,6 +177,7 @@ void SecureInitializer::initConfig(const boost::property_tree::ptree& pt)
         }
         sslContext->set_verify_mode(boost::asio::ssl::context_base::verify_peer |
                                     boost::asio::ssl::verify_fail_if_no_peer_cert);
+        enableSessionResumption(sslContext, "FISCO-BCOS");
 
         m_sslContexts[Usage::Default] = sslContext;
     }
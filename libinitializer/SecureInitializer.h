@@ -25,6 +25,7 @@
 #include "Common.h"
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
+#include <algorithm>
 #include <map>
 
 namespace bas = boost::asio::ssl;
@@ -38,6 +39,24 @@ DEV_SIMPLE_EXCEPTION(PrivateKeyNotExists);
 DEV_SIMPLE_EXCEPTION(CertificateError);
 DEV_SIMPLE_EXCEPTION(CertificateNotExists);
 
+/// the lifetime of the cached ssl sessions in seconds, a resumed session skips the certificate
+/// verification so the lifetime bounds how long an expired certificate is accepted
+static const long c_sslSessionTimeout = 3600;
+
+/// cache the sessions and issue session tickets, so that the reconnections of the nodes and the
+/// sdks resume their sessions instead of doing a full handshake
+inline void enableSessionResumption(
+    std::shared_ptr<boost::asio::ssl::context> _sslContext, std::string const& _sessionIDContext)
+{
+    SSL_CTX* ctx = _sslContext->native_handle();
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_set_timeout(ctx, c_sslSessionTimeout);
+    /// the sessions can't be resumed without a session id context when the peers are verified
+    SSL_CTX_set_session_id_context(ctx, (const unsigned char*)_sessionIDContext.data(),
+        std::min<size_t>(_sessionIDContext.size(), SSL_MAX_SID_CTX_LENGTH));
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+}
+
 class SecureInitializer : public std::enable_shared_from_this<SecureInitializer>
 {
 public:
@@ -328,11 +328,13 @@ void SecureInitializer::initConfig(const boost::property_tree::ptree& pt)
     try
     {
         ConfigResult gmConfig = initGmConfig(pt);
+        enableSessionResumption(gmConfig.sslContext, "FISCO-BCOS-GM");
         m_key = gmConfig.keyPair;
         m_sslContexts[Usage::Default] = gmConfig.sslContext;
         m_sslContexts[Usage::ForP2P] = gmConfig.sslContext;
 
         ConfigResult originConfig = initOriginConfig(pt);
+        enableSessionResumption(originConfig.sslContext, "FISCO-BCOS");
         m_sslContexts[Usage::ForRPC] = originConfig.sslContext;
     }
     catch (Exception& e)
@@ -0,0 +1,104 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the interpreter analysis of contract code
+ * @author: ancelmo
+ * @date: 2019-09-16
+ */
+
+#pragma once
+
+#include "VM.h"
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <list>
+#include <unordered_map>
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief Thread-safe cache from code hash to the analysis of the code. Deployed code never
+ * changes, so an analysis stays valid as long as it is cached. Once the analyzed code exceeds
+ * the capacity, the least recently used analysis is removed.
+ */
+class CodeAnalysisCache
+{
+public:
+    CodeAnalysisCache(size_t _capacity = c_defaultCapacity) : m_capacity(_capacity) {}
+
+    CodeAnalysis::Ptr get(h256 const& _codeHash)
+    {
+        Guard g(x_cache);
+        auto it = m_index.find(_codeHash);
+        if (it == m_index.end())
+            return nullptr;
+
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->second;
+    }
+
+    void store(h256 const& _codeHash, CodeAnalysis::Ptr _analysis)
+    {
+        Guard g(x_cache);
+        auto it = m_index.find(_codeHash);
+        if (it != m_index.end())
+        {
+            m_size -= it->second->second->code.size();
+            m_lru.erase(it->second);
+            m_index.erase(it);
+        }
+
+        m_lru.emplace_front(_codeHash, _analysis);
+        m_index[_codeHash] = m_lru.begin();
+        m_size += _analysis->code.size();
+
+        while (m_size > m_capacity && m_lru.size() > 1)
+        {
+            auto& last = m_lru.back();
+            m_size -= last.second->code.size();
+            m_index.erase(last.first);
+            m_lru.pop_back();
+        }
+    }
+
+    size_t size() const
+    {
+        Guard g(x_cache);
+        return m_lru.size();
+    }
+
+    static CodeAnalysisCache& instance()
+    {
+        static CodeAnalysisCache cache;
+        return cache;
+    }
+
+private:
+    // bytes of analyzed code
+    static const size_t c_defaultCapacity = 64 * 1024 * 1024;
+
+    size_t m_capacity;
+    size_t m_size = 0;
+    mutable Mutex x_cache;
+    std::list<std::pair<h256, CodeAnalysis::Ptr>> m_lru;
+    std::unordered_map<h256, std::list<std::pair<h256, CodeAnalysis::Ptr>>::iterator> m_index;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -26,6 +26,7 @@
 #include "libdevcrypto/Hash.h"
 
 #include <include/BuildInfo.h>
+#include <chrono>
 
 namespace
 {
@@ -39,11 +40,40 @@ void delete_output(const evmc_result* result)
     delete[] result->output_data;
 }
 
+// The VMs of the finished executions of the thread, reused with their stack and memory by the
+// next ones. A nested call takes a VM of its own while the one of its caller is in use.
+class FramePool
+{
+public:
+    std::unique_ptr<dev::eth::VM> acquire()
+    {
+        if (m_frames.empty())
+            return std::unique_ptr<dev::eth::VM>{new dev::eth::VM};
+        auto vm = std::move(m_frames.back());
+        m_frames.pop_back();
+        return vm;
+    }
+
+    void release(std::unique_ptr<dev::eth::VM> _vm, dev::bytes&& _mem)
+    {
+        if (m_frames.size() >= c_maxFrames)
+            return;
+        _vm->reset(std::move(_mem));
+        m_frames.push_back(std::move(_vm));
+    }
+
+private:
+    static const size_t c_maxFrames = 16;
+    std::vector<std::unique_ptr<dev::eth::VM>> m_frames;
+};
+
+thread_local FramePool t_framePool;
+
 evmc_result execute(evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
     const evmc_message* _msg, uint8_t const* _code, size_t _codeSize) noexcept
 {
     (void)_instance;
-    std::unique_ptr<dev::eth::VM> vm{new dev::eth::VM};
+    auto vm = t_framePool.acquire();
 
     evmc_result result = {};
     dev::owning_bytes_ref output;
@@ -106,6 +136,8 @@ evmc_result execute(evmc_instance* _instance, evmc_context* _context, evmc_revis
         result.output_size = output.size();
         result.release = delete_output;
     }
+    // the output is copied, its buffer is the memory of the next execution
+    t_framePool.release(std::move(vm), output.takeBytes());
 
     return result;
 }
@@ -236,12 +268,21 @@ void VM::logGasMem()
 
 void VM::fetchInstruction()
 {
+    // the constant gas of a basic block is charged on entering it, its instructions are metered
+    // one by one if the gas left doesn't cover it, so that they fail as they would otherwise
+    if (uint32_t blockGas = m_blockGas[m_PC])
+    {
+        m_blockCharged = m_io_gas >= blockGas;
+        if (m_blockCharged)
+            m_io_gas -= blockGas;
+    }
+
     m_OP = Instruction(m_code[m_PC]);
     auto const metric = c_metrics[static_cast<size_t>(m_OP)];
     adjustStack(metric.num_stack_arguments, metric.num_stack_returned_items);
 
     // FEES...
-    m_runGas = metric.gas_cost;
+    m_runGas = m_blockCharged && c_constantGas[static_cast<size_t>(m_OP)] ? 0 : metric.gas_cost;
     m_newMemSize = m_mem.size();
     m_copyMemSize = 0;
 }
@@ -272,6 +313,18 @@ owning_bytes_ref VM::exec(evmc_context* _context, evmc_revision _rev, const evmc
     m_pCode = _code;
     m_codeSize = _codeSize;
 
+    struct ProfileGuard
+    {
+        VM& vm;
+        ~ProfileGuard()
+        {
+            if (vm.m_profile)
+                vm.stopProfile();
+        }
+    } profileGuard{*this};
+    if (VMProfiler::instance().enabled())
+        startProfile();
+
     // trampoline to minimize depth of call stack when calling out
     m_bounce = &VM::initEntry;
     do
@@ -281,6 +334,96 @@ owning_bytes_ref VM::exec(evmc_context* _context, evmc_revision _rev, const evmc
     return std::move(m_output);
 }
 
+void VM::reset(bytes&& _mem)
+{
+    // the buffers grown by a memory hungry execution are not kept
+    static const size_t c_maxBufferSize = 1024 * 1024;
+    if (_mem.capacity() > m_mem.capacity())
+        m_mem = std::move(_mem);
+    if (m_mem.capacity() > c_maxBufferSize)
+        bytes().swap(m_mem);
+    m_mem.clear();
+    if (m_returnData.capacity() > c_maxBufferSize)
+        bytes().swap(m_returnData);
+    m_returnData.clear();
+    m_output = owning_bytes_ref();
+
+    m_context = nullptr;
+    m_message = nullptr;
+    m_tx_context = boost::none;
+    m_bounce = nullptr;
+    m_nSteps = 0;
+    m_pCode = nullptr;
+    m_codeSize = 0;
+    m_analysis.reset();
+    m_code = nullptr;
+    m_blockGas = nullptr;
+    m_blockCharged = false;
+    m_pool = nullptr;
+    m_PC = 0;
+    m_SP = m_SPP = m_stackEnd;
+    m_io_gas = 0;
+    m_runGas = 0;
+    m_newMemSize = 0;
+    m_copyMemSize = 0;
+    m_profile.reset();
+    m_profileRunning = false;
+}
+
+namespace
+{
+// ns taken by the executions called out to on the thread, the caller subtracts them from the
+// time of the opcode that called out
+thread_local uint64_t t_calleeTime = 0;
+
+uint64_t profileClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
+
+void VM::startProfile()
+{
+    m_profile.reset(new ContractProfile);
+    m_profile->executions = 1;
+    m_profileStart = m_profileLast = profileClock();
+    m_profileCallees = m_profileCalleesAtStart = t_calleeTime;
+}
+
+void VM::profileOperation()
+{
+    auto now = profileClock();
+    auto callees = t_calleeTime;
+    if (m_profileRunning)
+    {
+        auto category = static_cast<size_t>(opCategory(static_cast<uint8_t>(m_profileOP)));
+        m_profile->categoryTime[category] += now - m_profileLast - (callees - m_profileCallees);
+    }
+    auto op = static_cast<uint8_t>(m_OP);
+    ++m_profile->ops[op];
+    ++m_profile->categoryOps[static_cast<size_t>(opCategory(op))];
+    m_profileOP = m_OP;
+    m_profileRunning = true;
+    m_profileLast = now;
+    m_profileCallees = callees;
+}
+
+void VM::stopProfile()
+{
+    auto now = profileClock();
+    if (m_profileRunning)
+    {
+        auto category = static_cast<size_t>(opCategory(static_cast<uint8_t>(m_profileOP)));
+        m_profile->categoryTime[category] +=
+            now - m_profileLast - (t_calleeTime - m_profileCallees);
+    }
+    VMProfiler::instance().record(fromEvmC(m_message->destination), *m_profile);
+    m_profile.reset();
+    t_calleeTime = m_profileCalleesAtStart + (now - m_profileStart);
+}
+
 //
 // main interpreter loop and switch
 //
@@ -1387,7 +1530,6 @@ void VM::interpretCases()
 
             CASE(JUMPDEST)
         {
-            m_runGas = VMSchedule::jumpdestGas;
             ON_OP();
             updateIOGas();
         }
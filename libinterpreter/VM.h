@@ -23,6 +23,7 @@
 #pragma once
 
 #include "VMConfig.h"
+#include "VMProfile.h"
 
 #include <libdevcore/Common.h>
 #include <libethcore/Exceptions.h>
@@ -32,6 +33,7 @@
 #include <evmc/instructions.h>
 
 #include <boost/optional.hpp>
+#include <memory>
 
 namespace dev
 {
@@ -65,6 +67,22 @@ struct VMSchedule
     static constexpr int64_t callNewAccount = 25000;
 };
 
+// Code of a contract decoded for the interpreter. It only depends on the code, so the executions
+// of the same code can share it
+struct CodeAnalysis
+{
+    typedef std::shared_ptr<CodeAnalysis const> Ptr;
+
+    // code padded with zero bytes, with synthetic ops of user code made invalid
+    bytes code;
+    // constant pool
+    std::vector<u256> pool;
+    // whether each pc of the original code is a jump destination
+    std::vector<bool> jumpDests;
+    // the constant gas of the instructions of each basic block at its first pc, 0 elsewhere
+    std::vector<uint32_t> blockGas;
+};
+
 class VM
 {
 public:
@@ -73,6 +91,10 @@ public:
     owning_bytes_ref exec(evmc_context* _context, evmc_revision _rev, const evmc_message* _msg,
         uint8_t const* _code, size_t _codeSize);
 
+    // clear the state of the last execution for the next one, keeping the stack and the larger
+    // of the memory buffer and _mem
+    void reset(bytes&& _mem);
+
     uint64_t m_io_gas = 0;
 
 private:
@@ -82,9 +104,11 @@ private:
     boost::optional<evmc_tx_context> m_tx_context;
 
     static std::array<evmc_instruction_metrics, 256> c_metrics;
+    // whether the gas of an instruction is the constant of its metrics, charged by its block
+    static std::array<bool, 256> c_constantGas;
     static void initMetrics();
     static u256 exp256(u256 _base, u256 _exponent);
-    void copyCode(int);
+    static CodeAnalysis::Ptr analyze(uint8_t const* _code, size_t _codeSize);
     typedef void (VM::*MemFnPtr)();
     MemFnPtr m_bounce = nullptr;
     uint64_t m_nSteps = 0;
@@ -97,8 +121,12 @@ private:
 
     uint8_t const* m_pCode = nullptr;
     size_t m_codeSize = 0;
-    // space for code
-    bytes m_code;
+    // decoded code, m_code and m_pool point into it
+    CodeAnalysis::Ptr m_analysis;
+    byte const* m_code = nullptr;
+    uint32_t const* m_blockGas = nullptr;
+    // the constant gas of the current basic block was charged on entering it
+    bool m_blockCharged = false;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -109,7 +137,7 @@ private:
     size_t stackSize() { return m_stackEnd - m_SP; }
 
     // constant pool
-    std::vector<u256> m_pool;
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -124,7 +152,6 @@ private:
 
     // initialize interpreter
     void initEntry();
-    void optimize();
 
     // interpreter loop & switch
     void interpretCases();
@@ -147,11 +174,26 @@ private:
     void throwDisallowedStateChange();
     void throwBufferOverrun(bigint const& _enfOfAccess);
 
+    // profile of the execution when profiling is on, see VMProfiler
+    std::unique_ptr<ContractProfile> m_profile;
+    Instruction m_profileOP = Instruction::STOP;
+    bool m_profileRunning = false;
+    uint64_t m_profileStart = 0;
+    uint64_t m_profileLast = 0;
+    uint64_t m_profileCallees = 0;
+    uint64_t m_profileCalleesAtStart = 0;
+    void startProfile();
+    void profileOperation();
+    void stopProfile();
+
     std::vector<uint64_t> m_beginSubs;
-    std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
 
-    void onOperation() {}
+    void onOperation()
+    {
+        if (m_profile)
+            profileOperation();
+    }
     void adjustStack(int _removed, int _added);
     uint64_t gasForMem(u512 const& _size);
     void updateIOGas();
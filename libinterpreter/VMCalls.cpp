@@ -96,9 +96,8 @@ int64_t VM::verifyJumpDest(u256 const& _dest, bool _throw)
     if (_dest <= 0x7FFFFFFFFFFFFFFF)
     {
         // check for within bounds and to a jump destination
-        // use binary search of array because hashtable collisions are exploitable
         uint64_t pc = uint64_t(_dest);
-        if (std::binary_search(m_jumpDests.begin(), m_jumpDests.end(), pc))
+        if (pc < m_analysis->jumpDests.size() && m_analysis->jumpDests[pc])
             return pc;
     }
     if (_throw)
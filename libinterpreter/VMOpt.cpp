@@ -20,13 +20,93 @@
  * @record copy from aleth, this is a default VM
  */
 
+#include "CodeAnalysisCache.h"
 #include "VM.h"
 
 namespace dev
 {
 namespace eth
 {
+namespace
+{
+// The instructions whose cases charge the gas of their metrics and nothing else, without reading
+// the gas left or jumping. Those of a basic block are charged at once on entering it.
+bool isConstantGas(Instruction _op)
+{
+    auto op = (byte)_op;
+    if (((byte)Instruction::PUSH1 <= op && op <= (byte)Instruction::PUSH32) ||
+        ((byte)Instruction::DUP1 <= op && op <= (byte)Instruction::DUP16) ||
+        ((byte)Instruction::SWAP1 <= op && op <= (byte)Instruction::SWAP16))
+        return true;
+
+    switch (_op)
+    {
+    case Instruction::ADD:
+    case Instruction::MUL:
+    case Instruction::SUB:
+    case Instruction::DIV:
+    case Instruction::SDIV:
+    case Instruction::MOD:
+    case Instruction::SMOD:
+    case Instruction::ADDMOD:
+    case Instruction::MULMOD:
+    case Instruction::SIGNEXTEND:
+    case Instruction::LT:
+    case Instruction::GT:
+    case Instruction::SLT:
+    case Instruction::SGT:
+    case Instruction::EQ:
+    case Instruction::ISZERO:
+    case Instruction::AND:
+    case Instruction::OR:
+    case Instruction::XOR:
+    case Instruction::NOT:
+    case Instruction::BYTE:
+    case Instruction::SHL:
+    case Instruction::SHR:
+    case Instruction::SAR:
+    case Instruction::ADDRESS:
+    case Instruction::ORIGIN:
+    case Instruction::CALLER:
+    case Instruction::CALLVALUE:
+    case Instruction::CALLDATALOAD:
+    case Instruction::CALLDATASIZE:
+    case Instruction::CODESIZE:
+    case Instruction::GASPRICE:
+    case Instruction::RETURNDATASIZE:
+    case Instruction::EXTCODEHASH:
+    case Instruction::COINBASE:
+    case Instruction::TIMESTAMP:
+    case Instruction::NUMBER:
+    case Instruction::DIFFICULTY:
+    case Instruction::GASLIMIT:
+    case Instruction::POP:
+    case Instruction::PC:
+    case Instruction::MSIZE:
+    case Instruction::JUMPDEST:
+    case Instruction::JUMP:
+    case Instruction::JUMPI:
+    case Instruction::PUSHC:
+    case Instruction::JUMPC:
+    case Instruction::JUMPCI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// A basic block ends with a jump or with an instruction metered on its own, e.g. one expanding
+// memory, calling out or reading the gas left, so that it sees the gas it would see when every
+// instruction is metered on its own.
+bool endsBlock(Instruction _op)
+{
+    return !isConstantGas(_op) || _op == Instruction::JUMP || _op == Instruction::JUMPI ||
+           _op == Instruction::JUMPC || _op == Instruction::JUMPCI;
+}
+}  // namespace
+
 std::array<evmc_instruction_metrics, 256> VM::c_metrics{{}};
+std::array<bool, 256> VM::c_constantGas{{}};
 void VM::initMetrics()
 {
     static bool done = []() noexcept
@@ -39,47 +119,50 @@ void VM::initMetrics()
         c_metrics[uint8_t(Instruction::PUSHC)] = c_metrics[uint8_t(Instruction::PUSH1)];
         c_metrics[uint8_t(Instruction::JUMPC)] = c_metrics[uint8_t(Instruction::JUMP)];
         c_metrics[uint8_t(Instruction::JUMPCI)] = c_metrics[uint8_t(Instruction::JUMPI)];
+        c_metrics[uint8_t(Instruction::JUMPDEST)].gas_cost = VMSchedule::jumpdestGas;
+
+        for (size_t op = 0; op < c_constantGas.size(); ++op)
+            c_constantGas[op] = isConstantGas(Instruction(op));
         return true;
     }
     ();
     (void)done;
 }
 
-void VM::copyCode(int _extraBytes)
+CodeAnalysis::Ptr VM::analyze(uint8_t const* _code, size_t _codeSize)
 {
+    auto analysis = std::make_shared<CodeAnalysis>();
+    auto& code = analysis->code;
+    auto& jumpDests = analysis->jumpDests;
+
     // Copy code so that it can be safely modified and extend code by
-    // _extraBytes zero bytes to allow reading virtual data at the end
+    // 33 zero bytes to allow reading virtual data at the end
     // of the code without bounds checks.
-    auto extendedSize = m_codeSize + _extraBytes;
-    m_code.reserve(extendedSize);
-    m_code.assign(m_pCode, m_pCode + m_codeSize);
-    m_code.resize(extendedSize);
-}
+    code.reserve(_codeSize + 33);
+    code.assign(_code, _code + _codeSize);
+    code.resize(_codeSize + 33);
 
-void VM::optimize()
-{
-    copyCode(33);
-
-    size_t const nBytes = m_codeSize;
+    size_t const nBytes = _codeSize;
 
     // build a table of jump destinations for use in verifyJumpDest
 
     TRACE_STR(1, "Build JUMPDEST table")
+    jumpDests.resize(nBytes, false);
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
         TRACE_OP(2, pc, op);
 
         // make synthetic ops in user code trigger invalid instruction if run
         if (op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI)
         {
             TRACE_OP(1, pc, op);
-            m_code[pc] = (byte)Instruction::INVALID;
+            code[pc] = (byte)Instruction::INVALID;
         }
 
         if (op == Instruction::JUMPDEST)
         {
-            m_jumpDests.push_back(pc);
+            jumpDests[pc] = true;
         }
         else if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
         {
@@ -87,23 +170,42 @@ void VM::optimize()
         }
     }
 
+    // the optimizations below replace instructions by ones of the same gas and length
+    TRACE_STR(1, "Sum the constant gas of the basic blocks")
+    auto& blockGas = analysis->blockGas;
+    blockGas.resize(code.size(), 0);
+    size_t block = 0;
+    for (size_t pc = 0; pc < nBytes; ++pc)
+    {
+        Instruction op = Instruction(code[pc]);
+        // only a jump destination can be jumped to
+        if (op == Instruction::JUMPDEST)
+            block = pc;
+        if (isConstantGas(op))
+            blockGas[block] += c_metrics[(byte)op].gas_cost;
+        if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
+            pc += (byte)op - (byte)Instruction::PUSH1 + 1;
+        if (endsBlock(op))
+            block = pc + 1;
+    }
+
 #ifdef EVM_DO_FIRST_PASS_OPTIMIZATION
 
     TRACE_STR(1, "Do first pass optimizations")
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
         u256 val = 0;
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
 
         if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
         {
             byte nPush = (byte)op - (byte)Instruction::PUSH1 + 1;
 
             // decode pushed bytes to integral value
-            val = m_code[pc + 1];
+            val = code[pc + 1];
             for (uint64_t i = pc + 2, n = nPush; --n; ++i)
             {
-                val = (val << 8) | m_code[i];
+                val = (val << 8) | code[i];
             }
 
 #if EVM_USE_CONSTANT_POOL
@@ -113,16 +215,16 @@ void VM::optimize()
             // followed by one byte count of remaining pushed bytes
             if (5 < nPush)
             {
-                uint16_t pool_off = m_pool.size();
+                uint16_t pool_off = analysis->pool.size();
                 TRACE_VAL(1, "stash", val);
                 TRACE_VAL(1, "... in pool at offset", pool_off);
-                m_pool.push_back(val);
+                analysis->pool.push_back(val);
 
                 TRACE_PRE_OPT(1, pc, op);
-                m_code[pc] = byte(op = Instruction::PUSHC);
-                m_code[pc + 3] = nPush - 2;
-                m_code[pc + 2] = pool_off & 0xff;
-                m_code[pc + 1] = pool_off >> 8;
+                code[pc] = byte(op = Instruction::PUSHC);
+                code[pc + 3] = nPush - 2;
+                code[pc + 2] = pool_off & 0xff;
+                code[pc + 1] = pool_off >> 8;
                 TRACE_POST_OPT(1, pc, op);
             }
 
@@ -130,18 +232,17 @@ void VM::optimize()
 
 #if EVM_REPLACE_CONST_JUMP
             // replace JUMP or JUMPI to constant location with JUMPC or JUMPCI
-            // verifyJumpDest is M = log(number of jump destinations)
-            // outer loop is N = number of bytes in code array
-            // so complexity is N log M, worst case is N log N
+            // the jump destination table is a bitmap, so the check is constant time
             size_t i = pc + nPush + 1;
-            op = Instruction(m_code[i]);
+            op = Instruction(code[i]);
+            bool isJumpDest = val < jumpDests.size() && jumpDests[size_t(val)];
             if (op == Instruction::JUMP)
             {
                 TRACE_VAL(1, "Replace const JUMP with JUMPC to", val)
                 TRACE_PRE_OPT(1, i, op);
 
-                if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPC);
+                if (isJumpDest)
+                    code[i] = byte(op = Instruction::JUMPC);
 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -150,8 +251,8 @@ void VM::optimize()
                 TRACE_VAL(1, "Replace const JUMPI with JUMPCI to", val)
                 TRACE_PRE_OPT(1, i, op);
 
-                if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPCI);
+                if (isJumpDest)
+                    code[i] = byte(op = Instruction::JUMPCI);
 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -162,6 +263,8 @@ void VM::optimize()
     }
     TRACE_STR(1, "Finished optimizations")
 #endif
+
+    return analysis;
 }
 
 
@@ -172,7 +275,25 @@ void VM::initEntry()
 {
     m_bounce = &VM::interpretCases;
     initMetrics();
-    optimize();
+
+    // init code runs once, only deployed code is worth caching
+    h256 codeHash(m_message->code_hash.bytes, h256::ConstructFromPointer);
+    bool cacheable = m_message->kind != EVMC_CREATE && codeHash != h256();
+    if (cacheable)
+    {
+        m_analysis = CodeAnalysisCache::instance().get(codeHash);
+        if (m_analysis && m_analysis->jumpDests.size() != m_codeSize)
+            m_analysis = nullptr;
+    }
+    if (!m_analysis)
+    {
+        m_analysis = analyze(m_pCode, m_codeSize);
+        if (cacheable)
+            CodeAnalysisCache::instance().store(codeHash, m_analysis);
+    }
+    m_code = m_analysis->code.data();
+    m_pool = m_analysis->pool.data();
+    m_blockGas = m_analysis->blockGas.data();
 }
 
 
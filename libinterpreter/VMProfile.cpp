@@ -0,0 +1,111 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the opcodes executed by the interpreter and their time for each contract, recorded
+ * when profiling is on
+ * @author: ancelmo
+ * @date: 2019-11-25
+ */
+
+#include "VMProfile.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+OpCategory dev::eth::opCategory(uint8_t _op)
+{
+    if (_op == 0x00)
+        return OpCategory::Halt;
+    if (_op <= 0x0b)
+        return OpCategory::Arithmetic;
+    if (_op >= 0x10 && _op <= 0x1d)
+        return OpCategory::Logic;
+    if (_op == 0x20)
+        return OpCategory::Sha3;
+    if (_op >= 0x30 && _op <= 0x3f)
+        return OpCategory::Environment;
+    if (_op >= 0x40 && _op <= 0x45)
+        return OpCategory::Block;
+    if (_op == 0x50 || (_op >= 0x60 && _op <= 0x9f) || _op == 0xac)
+        return OpCategory::Stack;
+    if (_op >= 0x51 && _op <= 0x53)
+        return OpCategory::Memory;
+    if (_op == 0x54 || _op == 0x55)
+        return OpCategory::Storage;
+    if ((_op >= 0x56 && _op <= 0x5b) || _op == 0xad || _op == 0xae ||
+        (_op >= 0xb0 && _op <= 0xbf))
+        return OpCategory::Flow;
+    if (_op >= 0xa0 && _op <= 0xa4)
+        return OpCategory::Log;
+    if (_op == 0xf0 || _op == 0xf1 || _op == 0xf2 || _op == 0xf4 || _op == 0xf5 || _op == 0xfa)
+        return OpCategory::Call;
+    if (_op == 0xf3 || _op == 0xfd || _op == 0xff)
+        return OpCategory::Halt;
+    return OpCategory::Other;
+}
+
+char const* dev::eth::opCategoryName(OpCategory _category)
+{
+    static char const* const c_names[] = {"arithmetic", "logic", "sha3", "environment", "block",
+        "stack", "memory", "storage", "flow", "log", "call", "halt", "other"};
+    return _category < OpCategory::Count ? c_names[static_cast<size_t>(_category)] : "";
+}
+
+uint64_t ContractProfile::time() const
+{
+    uint64_t time = 0;
+    for (auto categoryTime : categoryTime)
+        time += categoryTime;
+    return time;
+}
+
+void ContractProfile::merge(ContractProfile const& _other)
+{
+    executions += _other.executions;
+    for (size_t i = 0; i < ops.size(); ++i)
+        ops[i] += _other.ops[i];
+    for (size_t i = 0; i < c_opCategories; ++i)
+    {
+        categoryOps[i] += _other.categoryOps[i];
+        categoryTime[i] += _other.categoryTime[i];
+    }
+}
+
+VMProfiler& VMProfiler::instance()
+{
+    static VMProfiler s_profiler;
+    return s_profiler;
+}
+
+void VMProfiler::record(Address const& _contract, ContractProfile const& _profile)
+{
+    lock_guard<mutex> l(x_contracts);
+    m_contracts[_contract].merge(_profile);
+}
+
+map<Address, ContractProfile> VMProfiler::contracts() const
+{
+    lock_guard<mutex> l(x_contracts);
+    return m_contracts;
+}
+
+void VMProfiler::reset()
+{
+    lock_guard<mutex> l(x_contracts);
+    m_contracts.clear();
+}
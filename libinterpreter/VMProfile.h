@@ -0,0 +1,90 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the opcodes executed by the interpreter and their time for each contract, recorded
+ * when profiling is on
+ * @author: ancelmo
+ * @date: 2019-11-25
+ */
+
+#pragma once
+#include <libdevcore/Address.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace dev
+{
+namespace eth
+{
+enum class OpCategory : uint8_t
+{
+    Arithmetic,
+    Logic,
+    Sha3,
+    Environment,
+    Block,
+    Stack,
+    Memory,
+    Storage,
+    Flow,
+    Log,
+    Call,
+    Halt,
+    Other,
+    Count
+};
+
+static const size_t c_opCategories = static_cast<size_t>(OpCategory::Count);
+
+OpCategory opCategory(uint8_t _op);
+char const* opCategoryName(OpCategory _category);
+
+struct ContractProfile
+{
+    uint64_t executions = 0;
+    std::array<uint64_t, 256> ops{};
+    std::array<uint64_t, c_opCategories> categoryOps{};
+    // ns spent in the opcodes of each category, the time of a call excludes the callee
+    std::array<uint64_t, c_opCategories> categoryTime{};
+
+    uint64_t time() const;
+    void merge(ContractProfile const& _other);
+};
+
+/// The profiles of the contracts executed by the interpreter of the process, by the address of
+/// the account the code runs for
+class VMProfiler
+{
+public:
+    static VMProfiler& instance();
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool _enabled) { m_enabled = _enabled; }
+
+    void record(Address const& _contract, ContractProfile const& _profile);
+    std::map<Address, ContractProfile> contracts() const;
+    void reset();
+
+private:
+    std::atomic<bool> m_enabled = {false};
+    mutable std::mutex x_contracts;
+    std::map<Address, ContractProfile> m_contracts;
+};
+}  // namespace eth
+}  // namespace dev
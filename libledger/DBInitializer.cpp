@@ -23,8 +23,12 @@
  */
 #include "DBInitializer.h"
 #include "LedgerParam.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/db.h"
+#include "rocksdb/filter_policy.h"
 #include "rocksdb/options.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/table.h"
 #include <libconfig/GlobalConfigure.h>
 #include <libdevcore/Common.h>
 #include <libmptstate/MPTStateFactory.h>
@@ -33,8 +37,11 @@
 #include <libstorage/LevelDBStorage.h>
 #include <libstorage/MemoryTableFactoryFactory.h>
 #include <libstorage/MemoryTableFactoryFactory2.h>
+#include <libstorage/RocksDBEnv.h>
 #include <libstorage/RocksDBStorage.h>
 #include <libstorage/SQLStorage.h>
+#include <libstorage/StoragePruner.h>
+#include <libstorage/TieredStorage.h>
 #include <libstorage/ZdbStorage.h>
 #include <libstoragestate/StorageStateFactory.h>
 
@@ -71,6 +78,10 @@ void DBInitializer::initStorageDB()
     {
         initRocksDBStorage();
     }
+    else if (!dev::stringCmpIgnoreCase(m_param->mutableStorageParam().type, "Tiered"))
+    {
+        initTieredStorage();
+    }
     else
     {
         DBInitializer_LOG(ERROR) << LOG_DESC("Unsupported dbType")
@@ -119,7 +130,7 @@ void DBInitializer::initLevelDBStorage()
         std::shared_ptr<dev::db::BasicLevelDB> leveldb_handler =
             std::shared_ptr<dev::db::BasicLevelDB>(pleveldb);
         leveldbStorage->setDB(leveldb_handler);
-        m_storage = leveldbStorage;
+        m_storage = createStatsStorage(leveldbStorage);
 
         auto tableFactoryFactory = std::make_shared<dev::storage::MemoryTableFactoryFactory>();
         tableFactoryFactory->setStorage(m_storage);
@@ -137,13 +148,52 @@ void DBInitializer::initLevelDBStorage()
 void DBInitializer::initTableFactory2(Storage::Ptr _backend)
 {
     auto cachedStorage = std::make_shared<CachedStorage>();
-    cachedStorage->setBackend(_backend);
+    cachedStorage->setBackend(createStatsStorage(_backend));
     cachedStorage->setMaxCapacity(
         m_param->mutableStorageParam().maxCapacity * 1024 * 1024);  // Bytes
     cachedStorage->setMaxForwardBlock(m_param->mutableStorageParam().maxForwardBlock);
+    cachedStorage->setMaxForwardBytes(
+        (int64_t)m_param->mutableStorageParam().maxForwardCapacity * 1024 * 1024);  // Bytes
+    cachedStorage->setMaxMergeBlock(m_param->mutableStorageParam().maxMergeBlock);
+    cachedStorage->setCacheShards(m_param->mutableStorageParam().cacheShards);
+    if (dev::stringCmpIgnoreCase(m_param->mutableStorageParam().cachePolicy, "lru") == 0)
+    {
+        cachedStorage->setCachePolicy(CachedStorage::LRU);
+    }
+    else
+    {
+        cachedStorage->setCachePolicy(CachedStorage::CLOCK);
+    }
+    cachedStorage->setCacheAdmission(m_param->mutableStorageParam().cacheAdmission);
+    if (m_param->mutableStorageParam().wal)
+    {
+        cachedStorage->setWAL(std::make_shared<BlockWAL>(m_param->baseDir() + "/wal"));
+    }
+    if (m_param->mutableStorageParam().blockTableCapacity > 0)
+    {
+        // block tables are scanned by sync, keep them from evicting the state
+        for (auto& table : {SYS_HASH_2_BLOCK, SYS_NUMBER_2_HASH, SYS_TX_HASH_2_BLOCK,
+                 SYS_BLOCK_2_NONCES})
+        {
+            cachedStorage->setTableQuota(
+                table, (int64_t)m_param->mutableStorageParam().blockTableCapacity * 1024 * 1024);
+        }
+    }
+
+    if (m_param->mutableStorageParam().warmKeys > 0)
+    {
+        cachedStorage->setHotKeys(
+            m_param->baseDir() + "/hot_keys", m_param->mutableStorageParam().warmKeys);
+    }
 
     cachedStorage->init();
 
+    if (m_param->mutableStorageParam().warmKeys > 0)
+    {
+        // the blocks executed first after a restart would wait for the backend
+        cachedStorage->warmUp(m_param->mutableStorageParam().warmKeysPerSecond);
+    }
+
     auto tableFactoryFactory = std::make_shared<dev::storage::MemoryTableFactoryFactory2>();
     tableFactoryFactory->setStorage(cachedStorage);
 
@@ -166,29 +216,95 @@ void DBInitializer::initSQLStorage()
         exit(1);
     });
     sqlStorage->setMaxRetry(m_param->mutableStorageParam().maxRetry);
+    sqlStorage->setBinaryProtocol(m_param->mutableStorageParam().binaryProtocol);
     initTableFactory2(sqlStorage);
 }
 
 void DBInitializer::initRocksDBStorage()
 {
     DBInitializer_LOG(INFO) << LOG_BADGE("initRocksDBStorage");
+    auto rocksdbStorage = createRocksDBStorage();
+    m_rocksDBStorage = std::dynamic_pointer_cast<RocksDBStorage>(rocksdbStorage);
+    m_rocksDBStorage->setBulkLoadPath(
+        m_param->baseDir() + "/sst", m_param->baseDir() + "/checkpoint");
+    initTableFactory2(rocksdbStorage);
+    initStoragePruner(rocksdbStorage);
+}
+
+/// prune the rocksdb behind the cache, the data pruned goes to a rocksdb of its own if any
+void DBInitializer::initStoragePruner(Storage::Ptr _backend)
+{
+    auto const& storageParam = m_param->mutableStorageParam();
+    if (storageParam.retainBlocks == 0 && storageParam.retainStateBlocks == 0)
+    {
+        return;
+    }
+    DBInitializer_LOG(INFO) << LOG_BADGE("initStoragePruner")
+                            << LOG_KV("retainBlocks", storageParam.retainBlocks)
+                            << LOG_KV("retainStateBlocks", storageParam.retainStateBlocks)
+                            << LOG_KV("archivePath", storageParam.pruneArchivePath);
+    m_pruner = std::make_shared<StoragePruner>();
+    m_pruner->setBackend(_backend);
+    if (!storageParam.pruneArchivePath.empty())
+    {
+        m_pruner->setArchive(createRocksDBStorage(storageParam.pruneArchivePath));
+    }
+    m_pruner->setRetainBlocks(storageParam.retainBlocks);
+    m_pruner->setRetainStateBlocks(storageParam.retainStateBlocks);
+    m_pruner->setKeysPerSecond(storageParam.pruneKeysPerSecond);
+    m_pruner->init();
+}
+
+Storage::Ptr DBInitializer::createRocksDBStorage(std::string const& _path)
+{
     /// open and init the levelDB
     rocksdb::Options options;
     rocksdb::DB* db = nullptr;
     try
     {
-        m_param->mutableStorageParam().path = m_param->mutableStorageParam().path + "/RocksDB";
-        boost::filesystem::create_directories(m_param->mutableStorageParam().path);
+        auto path = _path;
+        if (path.empty())
+        {
+            m_param->mutableStorageParam().path = m_param->mutableStorageParam().path + "/RocksDB";
+            path = m_param->mutableStorageParam().path;
+        }
+        boost::filesystem::create_directories(path);
         options.IncreaseParallelism();
         options.OptimizeLevelStyleCompaction();
         options.create_if_missing = true;
         options.max_open_files = 1000;
         options.compression = rocksdb::kSnappyCompression;
+        g_rocksDBEnv.apply(options);
         rocksdb::Status status;
 
+        // the column families of an existing db decide the layout, only new db follow the config
+        std::vector<std::string> existFamilies;
+        bool columnFamily = m_param->mutableStorageParam().columnFamily;
+        if (rocksdb::DB::ListColumnFamilies(options, path, &existFamilies).ok())
+        {
+            if (columnFamily != (existFamilies.size() > 1))
+            {
+                DBInitializer_LOG(WARNING)
+                    << LOG_DESC("The column family layout of existing db can't be changed")
+                    << LOG_KV("columnFamilies", existFamilies.size());
+            }
+            columnFamily = existFamilies.size() > 1;
+        }
+
         // Not to use disk encryption
-        DBInitializer_LOG(DEBUG) << LOG_DESC("open rocks handler");
-        status = rocksdb::DB::Open(options, m_param->mutableStorageParam().path, &db);
+        DBInitializer_LOG(DEBUG) << LOG_DESC("open rocks handler")
+                                 << LOG_KV("columnFamily", columnFamily);
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
+        if (columnFamily)
+        {
+            options.create_missing_column_families = true;
+            status = rocksdb::DB::Open(
+                options, path, columnFamilyDescriptors(options, existFamilies), &handles, &db);
+        }
+        else
+        {
+            status = rocksdb::DB::Open(options, path, &db);
+        }
 
         if (!status.ok())
         {
@@ -200,7 +316,12 @@ void DBInitializer::initRocksDBStorage()
         rocksDB.reset(db);
 
         rocksdbStorage->setDB(rocksDB);
-        initTableFactory2(rocksdbStorage);
+        rocksdbStorage->setColumnFamilies(handles);
+        if (g_BCOSConfig.diskEncryption.enable)
+        {
+            rocksdbStorage->setDataKey(rocksDBDataKey(*rocksDB, handles));
+        }
+        return rocksdbStorage;
     }
     catch (std::exception& e)
     {
@@ -208,11 +329,123 @@ void DBInitializer::initRocksDBStorage()
                                  << LOG_KV("EINFO", boost::diagnostic_information(e));
         BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment("initRocksDBStorage failed"));
     }
+
+    return Storage::Ptr();
+}
+
+/// the data key of an encrypted rocksdb, the cipher data key is kept in the db as
+/// EncryptedLevelDB does, so that a db is opened neither with another key nor without one
+dev::bytes DBInitializer::rocksDBDataKey(
+    rocksdb::DB& _db, std::vector<rocksdb::ColumnFamilyHandle*> const& _handles)
+{
+    auto cipherDataKey = g_BCOSConfig.diskEncryption.cipherDataKey;
+    std::string keyOfDatabase;
+    auto status = _db.Get(rocksdb::ReadOptions(), c_cipherDataKeyName, &keyOfDatabase);
+    if (status.IsNotFound())
+    {
+        auto families = _handles;
+        families.push_back(_db.DefaultColumnFamily());
+        for (auto family : families)
+        {
+            std::unique_ptr<rocksdb::Iterator> it(_db.NewIterator(rocksdb::ReadOptions(), family));
+            it->SeekToFirst();
+            if (it->Valid())
+            {
+                BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment(
+                                          "Database type ERROR! This DB is not encrypted"));
+            }
+        }
+        if (cipherDataKey.empty())
+        {
+            BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment(
+                                      "Please set cipherDataKey when enable disk encryption"));
+        }
+        status = _db.Put(rocksdb::WriteOptions(), c_cipherDataKeyName, cipherDataKey);
+        DBInitializer_LOG(DEBUG) << LOG_DESC("First creation encrypted rocksdb")
+                                 << LOG_KV("cipherDataKey", cipherDataKey);
+    }
+    if (!status.ok())
+    {
+        BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment(status.ToString()));
+    }
+    if (!keyOfDatabase.empty() && keyOfDatabase != cipherDataKey)
+    {
+        BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment(
+                                  "Configure CipherDataKey ERROR! It is not the key of the "
+                                  "database " +
+                                  keyOfDatabase));
+    }
+    auto dataKey = g_keyCenter->getDataKey(cipherDataKey);
+    if (dataKey.empty())
+    {
+        BOOST_THROW_EXCEPTION(OpenLevelDBFailed() << errinfo_comment("Get dataKey failed"));
+    }
+    return dataKey;
+}
+
+/// block tables are appended by hash or number and read by point lookup, they get a bigger
+/// write buffer, a small block cache of their own and prefix bloom, state tables keep the
+/// shared cache and the level style compaction of the default family
+std::vector<rocksdb::ColumnFamilyDescriptor> DBInitializer::columnFamilyDescriptors(
+    rocksdb::Options const& options, std::vector<std::string> const& existFamilies)
+{
+    // the groups of a node with a memory budget share one cache
+    std::shared_ptr<rocksdb::Cache> stateCache = g_rocksDBEnv.blockCache();
+    std::shared_ptr<rocksdb::Cache> blockCache = stateCache;
+    if (!stateCache)
+    {
+        stateCache = rocksdb::NewLRUCache(128 * 1024 * 1024);
+        blockCache = rocksdb::NewLRUCache(32 * 1024 * 1024);
+    }
+
+    std::vector<std::string> names{rocksdb::kDefaultColumnFamilyName};
+    names.insert(names.end(), RocksDBStorage::columnFamilyNames().begin(),
+        RocksDBStorage::columnFamilyNames().end());
+    for (auto& name : existFamilies)
+    {
+        // all families in the db must be opened
+        if (std::find(names.begin(), names.end(), name) == names.end())
+        {
+            names.push_back(name);
+        }
+    }
+
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+    for (auto& name : names)
+    {
+        rocksdb::ColumnFamilyOptions familyOptions(options);
+        rocksdb::BlockBasedTableOptions tableOptions;
+        tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+        tableOptions.cache_index_and_filter_blocks = true;
+        if (RocksDBStorage::isAppendOnly(name))
+        {
+            tableOptions.block_cache = blockCache;
+            // keys are table name + "_" + hash or number
+            familyOptions.prefix_extractor.reset(
+                rocksdb::NewCappedPrefixTransform(name.size() + 1 + 8));
+            familyOptions.memtable_prefix_bloom_size_ratio = 0.1;
+            familyOptions.write_buffer_size = 128 * 1024 * 1024;
+            familyOptions.target_file_size_base = 128 * 1024 * 1024;
+            familyOptions.level_compaction_dynamic_level_bytes = true;
+        }
+        else
+        {
+            tableOptions.block_cache = stateCache;
+        }
+        familyOptions.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+        descriptors.push_back(rocksdb::ColumnFamilyDescriptor(name, familyOptions));
+    }
+    return descriptors;
 }
 
 void DBInitializer::initZdbStorage()
 {
     DBInitializer_LOG(INFO) << LOG_BADGE("initStorageDB") << LOG_BADGE("initZdbStorage");
+    initTableFactory2(createZdbStorage());
+}
+
+Storage::Ptr DBInitializer::createZdbStorage()
+{
     auto zdbStorage = std::make_shared<ZdbStorage>();
     ZDBConfig zdbConfig{m_param->mutableStorageParam().dbType, m_param->mutableStorageParam().dbIP,
         m_param->mutableStorageParam().dbPort, m_param->mutableStorageParam().dbUsername,
@@ -225,6 +458,7 @@ void DBInitializer::initZdbStorage()
     sqlconnpool->InitConnectionPool(zdbConfig);
 
     auto sqlAccess = std::make_shared<SQLBasicAccess>();
+    sqlAccess->setCommitConnections(m_param->mutableStorageParam().commitConnections);
     zdbStorage->SetSqlAccess(sqlAccess);
     zdbStorage->setConnPool(sqlconnpool);
 
@@ -235,7 +469,34 @@ void DBInitializer::initZdbStorage()
         exit(1);
     });
 
-    initTableFactory2(zdbStorage);
+    return zdbStorage;
+}
+
+/// state and recent blocks in rocksdb, block tables of older blocks in mysql
+void DBInitializer::initTieredStorage()
+{
+    DBInitializer_LOG(INFO) << LOG_BADGE("initStorageDB") << LOG_BADGE("initTieredStorage")
+                            << LOG_KV("hotBlocks", m_param->mutableStorageParam().hotBlocks);
+    auto tieredStorage = std::make_shared<TieredStorage>();
+    tieredStorage->setHotStorage(createRocksDBStorage());
+    tieredStorage->setColdStorage(createZdbStorage());
+    tieredStorage->setHotBlocks(m_param->mutableStorageParam().hotBlocks);
+    tieredStorage->init();
+
+    initTableFactory2(tieredStorage);
+}
+
+Storage::Ptr DBInitializer::createStatsStorage(Storage::Ptr _backend)
+{
+    if (!m_param->mutableStorageParam().stats)
+    {
+        return _backend;
+    }
+
+    m_statsStorage = std::make_shared<StatsStorage>();
+    m_statsStorage->setBackend(_backend);
+    m_statsStorage->setSlowThreshold(m_param->mutableStorageParam().slowThreshold);
+    return m_statsStorage;
 }
 
 /// create ExecutiveContextFactory
@@ -267,29 +528,36 @@ void DBInitializer::createStateFactory(dev::h256 const& genesisHash)
     else if (dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "storage") ==
              0)  /// default is storage state
         createStorageState();
+    else if (dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "compact") == 0)
+        createStorageState(true);
     else
     {
         DBInitializer_LOG(WARNING)
             << LOG_BADGE("createStateFactory")
-            << LOG_DESC("only support storage and mpt now, create storage by default");
+            << LOG_DESC("only support storage, compact and mpt now, create storage by default");
         createStorageState();
     }
     DBInitializer_LOG(DEBUG) << LOG_BADGE("createStateFactory SUCC");
 }
 
 /// TOCHECK: create the stateStorage with AMDB
-void DBInitializer::createStorageState()
+void DBInitializer::createStorageState(bool _compact)
 {
-    m_stateFactory = std::make_shared<StorageStateFactory>(u256(0x0));
-    DBInitializer_LOG(DEBUG) << LOG_DESC("createStorageState SUCC");
+    m_stateFactory = std::make_shared<StorageStateFactory>(u256(0x0), _compact);
+    DBInitializer_LOG(DEBUG) << LOG_DESC("createStorageState SUCC") << LOG_KV("compact", _compact);
 }
 
 /// create the mptState
 void DBInitializer::createMptState(dev::h256 const& genesisHash)
 {
-    m_stateFactory = std::make_shared<MPTStateFactory>(
-        u256(0x0), m_param->baseDir(), genesisHash, WithExisting::Trust);
-    DBInitializer_LOG(DEBUG) << LOG_DESC("createMptState SUCC");
+    auto const& storageParam = m_param->mutableStorageParam();
+    m_stateFactory = std::make_shared<MPTStateFactory>(u256(0x0), m_param->baseDir(), genesisHash,
+        WithExisting::Trust, storageParam.mptNodeCache * 1024 * 1024,
+        storageParam.retainStateBlocks, storageParam.mptFlatState);
+    DBInitializer_LOG(DEBUG) << LOG_DESC("createMptState SUCC")
+                             << LOG_KV("nodeCache", storageParam.mptNodeCache)
+                             << LOG_KV("retainStateBlocks", storageParam.retainStateBlocks)
+                             << LOG_KV("flatState", storageParam.mptFlatState);
 }
 
 }  // namespace ledger
@@ -30,12 +30,26 @@
 #include <libexecutive/StateFactoryInterface.h>
 #include <libstorage/MemoryTableFactory.h>
 #include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/StatsStorage.h>
 #include <libstorage/Storage.h>
 #include <memory>
 
+namespace rocksdb
+{
+class ColumnFamilyHandle;
+class DB;
+struct ColumnFamilyDescriptor;
+struct Options;
+}  // namespace rocksdb
+
 #define DBInitializer_LOG(LEVEL) LOG(LEVEL) << "[DBINITIALIZER] "
 namespace dev
 {
+namespace storage
+{
+class RocksDBStorage;
+class StoragePruner;
+}
 namespace ledger
 {
 class DBInitializer
@@ -58,6 +72,13 @@ public:
 
     dev::storage::TableFactoryFactory::Ptr tableFactoryFactory() { return m_tableFactoryFactory; };
     dev::storage::Storage::Ptr storage() const { return m_storage; }
+    /// null if storage.stats is off
+    dev::storage::StatsStorage::Ptr statsStorage() const { return m_statsStorage; }
+    /// null unless the storage is rocksdb
+    std::shared_ptr<dev::storage::RocksDBStorage> rocksDBStorage() const
+    {
+        return m_rocksDBStorage;
+    }
     std::shared_ptr<dev::executive::StateFactoryInterface> stateFactory() { return m_stateFactory; }
     std::shared_ptr<dev::blockverifier::ExecutiveContextFactory> executiveContextFactory() const
     {
@@ -81,17 +102,31 @@ private:
     void initSQLStorage();
     void initTableFactory2(dev::storage::Storage::Ptr _backend);
     void initRocksDBStorage();
+    /// the rocksdb at _path, at the storage path of the group by default
+    dev::storage::Storage::Ptr createRocksDBStorage(std::string const& _path = "");
+    void initStoragePruner(dev::storage::Storage::Ptr _backend);
+    std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilyDescriptors(
+        rocksdb::Options const& options, std::vector<std::string> const& existFamilies);
+    dev::bytes rocksDBDataKey(
+        rocksdb::DB& _db, std::vector<rocksdb::ColumnFamilyHandle*> const& _handles);
 
-    void createStorageState();
+    void createStorageState(bool _compact = false);
     void createMptState(dev::h256 const& genesisHash);
 
     void initZdbStorage();
+    dev::storage::Storage::Ptr createZdbStorage();
+    void initTieredStorage();
+    /// record the access of the backend if storage.stats is on
+    dev::storage::Storage::Ptr createStatsStorage(dev::storage::Storage::Ptr _backend);
 
 
 private:
     std::shared_ptr<LedgerParamInterface> m_param;
     std::shared_ptr<dev::executive::StateFactoryInterface> m_stateFactory;
     dev::storage::Storage::Ptr m_storage = nullptr;
+    dev::storage::StatsStorage::Ptr m_statsStorage = nullptr;
+    std::shared_ptr<dev::storage::StoragePruner> m_pruner;
+    std::shared_ptr<dev::storage::RocksDBStorage> m_rocksDBStorage;
     std::shared_ptr<dev::blockverifier::ExecutiveContextFactory> m_executiveContextFactory;
     std::shared_ptr<ChannelRPCServer> m_channelRPCServer;
 
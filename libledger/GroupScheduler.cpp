@@ -0,0 +1,415 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the threads and the cache memory shared by the groups of a process
+ * @file: GroupScheduler.cpp
+ */
+#include "GroupScheduler.h"
+#include <libdevcore/Affinity.h>
+#include <libdevcore/Allocator.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/easylog.h>
+#include <libstorage/CachedStorage.h>
+#include <time.h>
+
+#define SCHEDULER_LOG(LEVEL) LOG(LEVEL) << LOG_BADGE("GROUPSCHEDULER")
+
+using namespace dev;
+using namespace dev::ledger;
+
+namespace
+{
+/// nanoseconds of CPU time of the calling thread
+uint64_t threadCPUTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/// when the thread entered the arena observed
+thread_local std::map<void const*, uint64_t> t_entryTime;
+#if defined(__linux__)
+/// the cores of the thread before it entered the arena observed
+thread_local std::map<void const*, cpu_set_t> t_entryCores;
+#endif
+}  // namespace
+
+void GroupScheduler::ArenaObserver::on_scheduler_entry(bool)
+{
+    t_entryTime[this] = threadCPUTime();
+#if defined(__linux__)
+    if (!m_cores.empty())
+    {
+        cpu_set_t cpus;
+        if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0)
+        {
+            t_entryCores[this] = cpus;
+        }
+        CPUAffinity::bindThread(m_cores);
+    }
+#endif
+}
+
+void GroupScheduler::ArenaObserver::on_scheduler_exit(bool _isWorker)
+{
+#if defined(__linux__)
+    auto cores = t_entryCores.find(this);
+    if (cores != t_entryCores.end())
+    {
+        /// a TBB worker may have been started by a thread of a group and inherited its cores,
+        /// it goes back to the free cores, a thread entering the arena to the cores it had
+        if (_isWorker)
+        {
+            CPUAffinity::bindThread(g_cpuAffinity.freeCores());
+        }
+        else
+        {
+            pthread_setaffinity_np(pthread_self(), sizeof(cores->second), &cores->second);
+        }
+        t_entryCores.erase(cores);
+    }
+#else
+    (void)_isWorker;
+#endif
+    auto it = t_entryTime.find(this);
+    if (it == t_entryTime.end())
+    {
+        return;
+    }
+    m_cpuTime += threadCPUTime() - it->second;
+    t_entryTime.erase(it);
+}
+
+GroupScheduler::GroupScheduler(unsigned _threads, int64_t _cacheBudget)
+  : m_threads(_threads > 0 ? _threads : std::max(std::thread::hardware_concurrency(), 1u)),
+    m_cacheBudget(_cacheBudget)
+{}
+
+std::shared_ptr<tbb::task_arena> GroupScheduler::addGroup(
+    dev::GROUP_ID _groupID, unsigned _weight, unsigned _maxConcurrency)
+{
+    WriteGuard l(x_groups);
+    auto& group = m_groups[_groupID];
+    group.weight = std::max(_weight, 1u);
+    group.maxConcurrency = _maxConcurrency;
+    /// initialized by start()
+    group.arena = std::make_shared<tbb::task_arena>();
+    return group.arena;
+}
+
+void GroupScheduler::setCachedStorage(
+    dev::GROUP_ID _groupID, std::shared_ptr<dev::storage::CachedStorage> _cachedStorage)
+{
+    WriteGuard l(x_groups);
+    m_groups[_groupID].cachedStorage = _cachedStorage;
+}
+
+void GroupScheduler::start()
+{
+    {
+        WriteGuard l(x_groups);
+        if (m_running)
+        {
+            return;
+        }
+        m_running = true;
+        unsigned totalWeight = 0;
+        for (auto const& it : m_groups)
+        {
+            totalWeight += it.second.weight;
+        }
+        for (auto& it : m_groups)
+        {
+            auto& group = it.second;
+            if (!group.arena)
+            {
+                continue;
+            }
+            /// the share of the workers by weight, a worker at least
+            unsigned concurrency =
+                std::max((m_threads * group.weight + totalWeight / 2) / totalWeight, 1u);
+            if (group.maxConcurrency > 0)
+            {
+                concurrency = std::min(concurrency, group.maxConcurrency);
+            }
+            group.arena->initialize(concurrency);
+            /// the cores reserved for the group, or the free ones if others are reserved
+            auto cores = g_cpuAffinity.groupCores(it.first);
+            if (cores.empty())
+            {
+                cores = g_cpuAffinity.freeCores();
+            }
+            group.observer = std::make_shared<ArenaObserver>(*group.arena, cores);
+            group.observer->observe(true);
+            SCHEDULER_LOG(INFO) << LOG_DESC("group arena") << LOG_KV("groupID", it.first)
+                                << LOG_KV("weight", group.weight)
+                                << LOG_KV("concurrency", concurrency)
+                                << LOG_KV("threads", m_threads)
+                                << LOG_KV("cores", cores.size());
+        }
+    }
+    if (cacheTuning() && m_cacheBudget <= 0)
+    {
+        /// the tuning starts from the capacities of the groups
+        ReadGuard l(x_groups);
+        int64_t budget = 0;
+        for (auto const& it : m_groups)
+        {
+            if (it.second.cachedStorage)
+            {
+                budget += it.second.cachedStorage->maxCapacity();
+            }
+        }
+        m_cacheBudget = std::max(m_minCacheBudget, std::min(budget, m_maxCacheBudget));
+    }
+    if (m_cacheBudget <= 0)
+    {
+        return;
+    }
+    rebalanceCache();
+    m_rebalanceThread = std::make_shared<std::thread>([this]() {
+        pthread_setThreadName("GroupScheduler");
+        std::unique_lock<std::mutex> l(x_stop);
+        while (!m_stopped.wait_for(l, std::chrono::seconds(c_cacheRebalanceSeconds),
+            [this]() { return !m_running; }))
+        {
+            l.unlock();
+            if (cacheTuning())
+            {
+                tuneCache(processResidentBytes(), processMemoryLimit());
+            }
+            else
+            {
+                rebalanceCache();
+            }
+            l.lock();
+        }
+    });
+}
+
+void GroupScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> l(x_stop);
+        WriteGuard ll(x_groups);
+        m_running = false;
+    }
+    m_stopped.notify_all();
+    if (m_rebalanceThread && m_rebalanceThread->joinable())
+    {
+        m_rebalanceThread->join();
+    }
+    m_rebalanceThread.reset();
+}
+
+void GroupScheduler::rebalanceCache()
+{
+    WriteGuard l(x_groups);
+    uint64_t totalWeight = 0;
+    uint64_t totalDemand = 0;
+    std::map<dev::GROUP_ID, uint64_t> demands;
+    for (auto& it : m_groups)
+    {
+        auto& group = it.second;
+        if (!group.cachedStorage)
+        {
+            continue;
+        }
+        uint64_t misses = group.cachedStorage->queryTimes() - group.cachedStorage->hitTimes();
+        uint64_t demand = group.weight * (misses - std::min(misses, group.lastMisses));
+        group.lastMisses = misses;
+        demands[it.first] = demand;
+        totalWeight += group.weight;
+        totalDemand += demand;
+    }
+    if (totalWeight == 0)
+    {
+        return;
+    }
+
+    int64_t half = m_cacheBudget / 2;
+    for (auto const& it : demands)
+    {
+        auto& group = m_groups[it.first];
+        int64_t budget = half * group.weight / (int64_t)totalWeight;
+        if (totalDemand > 0)
+        {
+            budget += (int64_t)((double)(m_cacheBudget - half) * it.second / totalDemand);
+        }
+        else
+        {
+            budget += (m_cacheBudget - half) * group.weight / (int64_t)totalWeight;
+        }
+        group.cachedStorage->setMaxCapacity(budget);
+        SCHEDULER_LOG(DEBUG) << LOG_DESC("rebalanceCache") << LOG_KV("groupID", it.first)
+                             << LOG_KV("budget", budget)
+                             << LOG_KV("capacity", group.cachedStorage->capacity())
+                             << LOG_KV("demand", it.second);
+    }
+}
+
+void GroupScheduler::setCacheTuning(
+    int64_t _minBudget, int64_t _maxBudget, unsigned _memoryPercent)
+{
+    m_minCacheBudget = std::max(_minBudget, (int64_t)0);
+    m_maxCacheBudget = std::max(_maxBudget, m_minCacheBudget);
+    m_cacheMemoryPercent = std::min(std::max(_memoryPercent, 1u), 100u);
+    if (m_cacheBudget > 0)
+    {
+        m_cacheBudget =
+            std::max(m_minCacheBudget, std::min(m_cacheBudget.load(), m_maxCacheBudget));
+    }
+    SCHEDULER_LOG(INFO) << LOG_DESC("setCacheTuning") << LOG_KV("minBudget", m_minCacheBudget)
+                        << LOG_KV("maxBudget", m_maxCacheBudget)
+                        << LOG_KV("memoryPercent", m_cacheMemoryPercent);
+}
+
+void GroupScheduler::tuneCache(uint64_t _resident, uint64_t _limit)
+{
+    int64_t capacity = 0;
+    uint64_t queries = 0;
+    uint64_t misses = 0;
+    uint64_t backendLatency = 0;
+    {
+        ReadGuard l(x_groups);
+        for (auto const& it : m_groups)
+        {
+            auto const& cachedStorage = it.second.cachedStorage;
+            if (!cachedStorage)
+            {
+                continue;
+            }
+            auto groupQueries = cachedStorage->queryTimes();
+            capacity += cachedStorage->capacity();
+            queries += groupQueries;
+            misses += groupQueries - cachedStorage->hitTimes();
+            backendLatency = std::max(backendLatency, cachedStorage->lastBackendLatency());
+        }
+    }
+    uint64_t recentQueries = queries - std::min(queries, m_lastQueries);
+    uint64_t recentMisses = misses - std::min(misses, m_lastMisses);
+    m_lastQueries = queries;
+    m_lastMisses = misses;
+
+    int64_t budget = m_cacheBudget;
+    /// the memory left under the share of the limit, negative when the process is over it,
+    /// nothing to grow into if the limit is unknown
+    int64_t headroom =
+        _limit > 0 ? (int64_t)(_limit / 100 * m_cacheMemoryPercent) - (int64_t)_resident : 0;
+    std::string decision = "hold";
+    if (headroom < 0)
+    {
+        /// give back what is over, a quarter at least to get out of the pressure quickly
+        budget -= std::max(budget / 4, -headroom);
+        decision = "shrink";
+    }
+    else if (capacity >= budget / 10 * 9 && recentMisses * 100 > recentQueries && headroom > 0)
+    {
+        /// the caches are full and more than 1% of the queries read the backend, which costs
+        /// more while it is slow, half of the headroom is left to the rest of the process
+        int64_t step = backendLatency >= c_slowBackendLatency ? budget / 2 : budget / 4;
+        budget += std::min(std::max(step, (int64_t)1024 * 1024), headroom / 2);
+        decision = "grow";
+    }
+    budget = std::max(m_minCacheBudget, std::min(budget, m_maxCacheBudget));
+    if (budget == m_cacheBudget)
+    {
+        decision = "hold";
+    }
+
+    SCHEDULER_LOG(INFO) << LOG_DESC("tuneCache") << LOG_KV("decision", decision)
+                        << LOG_KV("budget", m_cacheBudget) << LOG_KV("newBudget", budget)
+                        << LOG_KV("capacity", capacity) << LOG_KV("resident", _resident)
+                        << LOG_KV("limit", _limit) << LOG_KV("queries", recentQueries)
+                        << LOG_KV("misses", recentMisses)
+                        << LOG_KV("backendLatency", backendLatency);
+    g_metrics
+        .counter("bcos_cache_tune_decisions", "the tuning decisions of the cache budget",
+            {{"decision", decision}})
+        .inc();
+    g_metrics.gauge("bcos_cache_budget_bytes", "the bytes cached by all groups").set(budget);
+    g_metrics.gauge("bcos_process_resident_bytes", "the resident set of the process")
+        .set(_resident);
+    g_metrics.gauge("bcos_process_memory_limit_bytes", "the memory the process may take")
+        .set(_limit);
+
+    m_cacheBudget = budget;
+    rebalanceCache();
+
+    ReadGuard l(x_groups);
+    for (auto const& it : m_groups)
+    {
+        auto const& cachedStorage = it.second.cachedStorage;
+        if (!cachedStorage)
+        {
+            continue;
+        }
+        /// a cache overshooting its share between two clears, or under memory pressure, is
+        /// cleared more often, one well under its share less
+        auto interval = cachedStorage->clearInterval();
+        auto groupCapacity = cachedStorage->capacity();
+        auto maxCapacity = cachedStorage->maxCapacity();
+        auto newInterval = interval;
+        if (groupCapacity > maxCapacity / 4 * 5 || headroom < 0)
+        {
+            newInterval = std::max(interval / 2, c_minClearInterval);
+        }
+        else if (groupCapacity < maxCapacity / 2)
+        {
+            newInterval = std::min(interval * 2, c_maxClearInterval);
+        }
+        if (newInterval != interval)
+        {
+            cachedStorage->setClearInterval(newInterval);
+            SCHEDULER_LOG(INFO) << LOG_DESC("tuneCache clear interval")
+                                << LOG_KV("groupID", it.first) << LOG_KV("interval", interval)
+                                << LOG_KV("newInterval", newInterval)
+                                << LOG_KV("capacity", groupCapacity)
+                                << LOG_KV("maxCapacity", maxCapacity);
+        }
+        g_metrics
+            .gauge("bcos_cache_clear_interval_ms", "the ms between two clears of the cache",
+                {{"group", std::to_string(it.first)}})
+            .set(newInterval);
+    }
+}
+
+Json::Value GroupScheduler::groupStats(dev::GROUP_ID _groupID) const
+{
+    ReadGuard l(x_groups);
+    auto it = m_groups.find(_groupID);
+    if (it == m_groups.end())
+    {
+        return Json::Value();
+    }
+    auto const& group = it->second;
+    Json::Value stats;
+    stats["weight"] = group.weight;
+    stats["concurrency"] = group.observer ? group.arena->max_concurrency() : 0;
+    stats["cpuTime"] = Json::UInt64(group.observer ? group.observer->cpuTime() / 1000000 : 0);
+    if (group.cachedStorage)
+    {
+        auto queries = group.cachedStorage->queryTimes();
+        stats["cacheBudget"] = Json::Int64(group.cachedStorage->maxCapacity());
+        stats["cacheClearInterval"] = Json::UInt64(group.cachedStorage->clearInterval());
+        stats["cacheCapacity"] = Json::Int64(group.cachedStorage->capacity());
+        stats["cacheHitRate"] =
+            queries > 0 ? (double)group.cachedStorage->hitTimes() / queries : 0.0;
+    }
+    return stats;
+}
@@ -0,0 +1,146 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the threads and the cache memory shared by the groups of a process
+ * @file: GroupScheduler.h
+ */
+#pragma once
+#include <json/json.h>
+#include <libdevcore/Guards.h>
+#include <libethcore/Protocol.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+class CachedStorage;
+}
+namespace ledger
+{
+/// the weight of a group not configured
+static const unsigned c_defaultGroupWeight = 1;
+/// seconds between two splits of the cache budget
+static const unsigned c_cacheRebalanceSeconds = 10;
+/// the share of the memory limit of the process the tuning keeps it under, in percent
+static const unsigned c_defaultCacheMemoryPercent = 80;
+/// the bounds the tuning keeps the interval between two clears of a cache in, in ms
+static const uint64_t c_minClearInterval = 100;
+static const uint64_t c_maxClearInterval = 5000;
+/// ms of a backend commit from which the tuning grows the budget twice as fast
+static const uint64_t c_slowBackendLatency = 500;
+
+/// The groups of a process execute their blocks on the TBB workers of the process, each in an
+/// arena of its own bounded by its weight, and share one cache budget split between their
+/// CachedStorages. The CPU time spent in the arena of a group is accounted to it.
+class GroupScheduler
+{
+public:
+    typedef std::shared_ptr<GroupScheduler> Ptr;
+
+    /// _threads the workers shared by the groups, 0 for one per core, _cacheBudget the bytes
+    /// cached by all groups, 0 to leave the capacity of each group as configured
+    GroupScheduler(unsigned _threads = 0, int64_t _cacheBudget = 0);
+    ~GroupScheduler() { stop(); }
+
+    /// the arena the blocks of _groupID are executed in, at most _maxConcurrency workers or no
+    /// limit with 0, its concurrency is set by start()
+    std::shared_ptr<tbb::task_arena> addGroup(
+        dev::GROUP_ID _groupID, unsigned _weight, unsigned _maxConcurrency);
+    /// the cache of _groupID bounded by the budget
+    void setCachedStorage(
+        dev::GROUP_ID _groupID, std::shared_ptr<dev::storage::CachedStorage> _cachedStorage);
+
+    /// size the arenas of the groups added and split the cache budget periodically
+    void start();
+    void stop();
+
+    /// {weight, concurrency, cpuTime in ms, cacheBudget, cacheCapacity, cacheHitRate,
+    /// cacheClearInterval in ms}, null for a group not added
+    Json::Value groupStats(dev::GROUP_ID _groupID) const;
+
+    /// split the budget between the caches, half by weight and the other half by weight times
+    /// the misses since the last split
+    void rebalanceCache();
+
+    /// tune the budget before each split within [_minBudget, _maxBudget] bytes: shrink it while
+    /// the process is over _memoryPercent of its memory limit, grow it while the caches are full
+    /// and miss with memory to spare, and clear a cache more often while it overshoots its share
+    /// and less while it is well under, must be called before start()
+    void setCacheTuning(int64_t _minBudget, int64_t _maxBudget, unsigned _memoryPercent);
+    bool cacheTuning() const { return m_maxCacheBudget > 0; }
+    int64_t cacheBudget() const { return m_cacheBudget; }
+
+    /// one tuning step with the resident bytes and the memory limit of the process, the limit 0
+    /// if unknown, followed by a split, logged and counted in bcos_cache_tune_decisions
+    void tuneCache(uint64_t _resident, uint64_t _limit);
+
+private:
+    /// the CPU time of the threads while they work in the arena, bound to _cores meanwhile
+    /// unless empty
+    class ArenaObserver : public tbb::task_scheduler_observer
+    {
+    public:
+        ArenaObserver(tbb::task_arena& _arena, std::vector<unsigned> const& _cores)
+          : tbb::task_scheduler_observer(_arena), m_cores(_cores)
+        {}
+        void on_scheduler_entry(bool) override;
+        void on_scheduler_exit(bool) override;
+        uint64_t cpuTime() const { return m_cpuTime; }
+
+    private:
+        std::atomic<uint64_t> m_cpuTime = {0};
+        std::vector<unsigned> m_cores;
+    };
+
+    struct Group
+    {
+        unsigned weight = c_defaultGroupWeight;
+        unsigned maxConcurrency = 0;
+        std::shared_ptr<tbb::task_arena> arena;
+        std::shared_ptr<ArenaObserver> observer;
+        std::shared_ptr<dev::storage::CachedStorage> cachedStorage;
+        uint64_t lastMisses = 0;
+    };
+
+    unsigned m_threads;
+    std::atomic<int64_t> m_cacheBudget;
+    int64_t m_minCacheBudget = 0;
+    /// 0 without tuning
+    int64_t m_maxCacheBudget = 0;
+    unsigned m_cacheMemoryPercent = c_defaultCacheMemoryPercent;
+    /// the queries and the misses of all caches at the last tuning
+    uint64_t m_lastQueries = 0;
+    uint64_t m_lastMisses = 0;
+    mutable SharedMutex x_groups;
+    std::map<dev::GROUP_ID, Group> m_groups;
+
+    bool m_running = false;
+    std::mutex x_stop;
+    std::condition_variable m_stopped;
+    std::shared_ptr<std::thread> m_rebalanceThread;
+};
+}  // namespace ledger
+}  // namespace dev
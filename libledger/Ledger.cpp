@@ -31,7 +31,11 @@
 #include <libconsensus/raft/RaftSealer.h>
 #include <libdevcore/OverlayDB.h>
 #include <libdevcore/easylog.h>
+#include <libevm/VMFactory.h>
+#include <libinterpreter/VMProfile.h>
 #include <libprecompiled/Common.h>
+#include <libstorage/CachedStorage.h>
+#include <libstorage/RocksDBStorage.h>
 #include <libsync/SyncInterface.h>
 #include <libsync/SyncMaster.h>
 #include <libtxpool/TxPool.h>
@@ -59,6 +63,14 @@ bool Ledger::initLedger(const std::string& _configFilePath)
 #endif
     Ledger_LOG(INFO) << LOG_DESC("LedgerConstructor") << LOG_KV("configPath", _configFilePath)
                      << LOG_KV("baseDir", m_param->baseDir());
+    /// the time of each phase of the startup in ms, logged once the ledger is inited
+    auto phaseTime = utcTime();
+    std::vector<std::pair<std::string, uint64_t>> phaseTimes;
+    auto endPhase = [&](std::string const& _phase) {
+        auto now = utcTime();
+        phaseTimes.push_back(std::make_pair(_phase, now - phaseTime));
+        phaseTime = now;
+    };
     /// The file group.X.genesis is required, otherwise the program terminates.
     /// load genesis config of group
     initGenesisConfig(_configFilePath);
@@ -74,6 +86,7 @@ bool Ledger::initLedger(const std::string& _configFilePath)
     initIniConfig(iniConfigFileName);
     if (!m_param)
         return false;
+    endPhase("config");
     /// init dbInitializer
     Ledger_LOG(INFO) << LOG_BADGE("initLedger") << LOG_BADGE("DBInitializer");
     m_dbInitializer = std::make_shared<dev::ledger::DBInitializer>(m_param);
@@ -84,10 +97,18 @@ bool Ledger::initLedger(const std::string& _configFilePath)
     m_dbInitializer->initStorageDB();
     /// set group ID for storage
     m_dbInitializer->storage()->setGroupID(m_groupId);
+    auto cachedStorage =
+        std::dynamic_pointer_cast<dev::storage::CachedStorage>(m_dbInitializer->storage());
+    if (m_groupScheduler && cachedStorage)
+    {
+        m_groupScheduler->setCachedStorage(m_groupId, cachedStorage);
+    }
+    endPhase("storage");
     /// init the DB
     bool ret = initBlockChain(genesisParam);
     if (!ret)
         return false;
+    endPhase("blockChain");
     dev::h256 genesisHash = m_blockChain->getBlockByNumber(0)->headerHash();
     m_dbInitializer->initState(genesisHash);
     if (!m_dbInitializer->stateFactory())
@@ -99,8 +120,30 @@ bool Ledger::initLedger(const std::string& _configFilePath)
     std::shared_ptr<BlockChainImp> blockChain =
         std::dynamic_pointer_cast<BlockChainImp>(m_blockChain);
     blockChain->setStateFactory(m_dbInitializer->stateFactory());
+    endPhase("state");
     /// init blockVerifier, txPool, sync and consensus
-    return (initBlockVerifier() && initTxPool() && initSync() && consensusInitFactory());
+    if (!initBlockVerifier())
+        return false;
+    endPhase("blockVerifier");
+    /// the nonces of the recent blocks are loaded by the txPool in the background
+    if (!initTxPool())
+        return false;
+    endPhase("txPool");
+    if (!initSync())
+        return false;
+    endPhase("sync");
+    if (!consensusInitFactory())
+        return false;
+    endPhase("consensus");
+
+    std::stringstream phases;
+    for (auto const& phase : phaseTimes)
+    {
+        phases << LOG_KV(phase.first, phase.second);
+    }
+    Ledger_LOG(INFO) << LOG_BADGE("initLedger") << LOG_DESC("startup phases in ms")
+                     << phases.str();
+    return true;
 }
 
 /**
@@ -167,17 +210,40 @@ void Ledger::initIniConfig(std::string const& iniConfigFileName)
 
 void Ledger::initTxExecuteConfig(ptree const& pt)
 {
-    if (dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "storage") == 0)
+    if (dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "storage") == 0 ||
+        dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "compact") == 0)
     {
         m_param->mutableTxParam().enableParallel =
             pt.get<bool>("tx_execute.enable_parallel", false);
+        m_param->mutableTxParam().optimistic = pt.get<bool>("tx_execute.optimistic", false);
     }
     else
     {
         m_param->mutableTxParam().enableParallel = false;
+        m_param->mutableTxParam().optimistic = false;
     }
+    m_param->mutableTxParam().vm = pt.get<std::string>("tx_execute.vm", "interpreter");
+    auto weight = pt.get<int>("tx_execute.weight", c_defaultGroupWeight);
+    auto maxConcurrency = pt.get<int>("tx_execute.max_concurrency", 0);
+    if (weight <= 0 || maxConcurrency < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            ForbidNegativeValue() << errinfo_comment(
+                "Please set tx_execute.weight and tx_execute.max_concurrency to positive !"));
+    }
+    m_param->mutableTxParam().weight = weight;
+    m_param->mutableTxParam().maxConcurrency = maxConcurrency;
+    m_param->mutableTxParam().profile = pt.get<bool>("tx_execute.profile", false);
+    m_param->mutableTxParam().profilePath = pt.get<std::string>("tx_execute.profile_path", "");
+    m_param->mutableTxParam().evmProfile = pt.get<bool>("tx_execute.evm_profile", false);
     Ledger_LOG(DEBUG) << LOG_BADGE("InitTxExecuteConfig")
-                      << LOG_KV("enableParallel", m_param->mutableTxParam().enableParallel);
+                      << LOG_KV("enableParallel", m_param->mutableTxParam().enableParallel)
+                      << LOG_KV("optimistic", m_param->mutableTxParam().optimistic)
+                      << LOG_KV("vm", m_param->mutableTxParam().vm)
+                      << LOG_KV("weight", weight) << LOG_KV("maxConcurrency", maxConcurrency)
+                      << LOG_KV("profile", m_param->mutableTxParam().profile)
+                      << LOG_KV("profilePath", m_param->mutableTxParam().profilePath)
+                      << LOG_KV("evmProfile", m_param->mutableTxParam().evmProfile);
 }
 
 void Ledger::initTxPoolConfig(ptree const& pt)
@@ -191,13 +257,35 @@ void Ledger::initTxPoolConfig(ptree const& pt)
             BOOST_THROW_EXCEPTION(
                 ForbidNegativeValue() << errinfo_comment("Please set tx_pool.limit to positive !"));
         }
+        m_param->mutableTxPoolParam().maxTxsPerSender =
+            pt.get<int64_t>("tx_pool.max_txs_per_sender", 0);
+        if (m_param->mutableTxPoolParam().maxTxsPerSender < 0)
+        {
+            BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                      "Please set tx_pool.max_txs_per_sender to positive !"));
+        }
+        m_param->mutableTxPoolParam().memoryLimit = pt.get<int64_t>("tx_pool.memory_limit", 0);
+        if (m_param->mutableTxPoolParam().memoryLimit < 0)
+        {
+            BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                      "Please set tx_pool.memory_limit to positive !"));
+        }
+        m_param->mutableTxPoolParam().enableJournal =
+            pt.get<bool>("tx_pool.enable_journal", false);
 
         Ledger_LOG(DEBUG) << LOG_BADGE("initTxPoolConfig")
-                          << LOG_KV("txPoolLimit", m_param->mutableTxPoolParam().txPoolLimit);
+                          << LOG_KV("txPoolLimit", m_param->mutableTxPoolParam().txPoolLimit)
+                          << LOG_KV("maxTxsPerSender",
+                                 m_param->mutableTxPoolParam().maxTxsPerSender)
+                          << LOG_KV("memoryLimit", m_param->mutableTxPoolParam().memoryLimit)
+                          << LOG_KV("enableJournal", m_param->mutableTxPoolParam().enableJournal);
     }
     catch (std::exception& e)
     {
         m_param->mutableTxPoolParam().txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
+        m_param->mutableTxPoolParam().maxTxsPerSender = 0;
+        m_param->mutableTxPoolParam().memoryLimit = 0;
+        m_param->mutableTxPoolParam().enableJournal = false;
         Ledger_LOG(WARNING) << LOG_BADGE("txPoolLimit") << LOG_DESC("txPoolLimit invalid");
     }
 }
@@ -233,6 +321,34 @@ void Ledger::initConsensusIniConfig(ptree const& pt)
     {
         m_param->mutableConsensusParam().blockSizeIncreaseRatio = 0.5;
     }
+    /// pack a wider transaction DAG
+    m_param->mutableConsensusParam().maxTxsPerCritical =
+        pt.get<int64_t>("consensus.max_txs_per_critical", 0);
+    if (m_param->mutableConsensusParam().maxTxsPerCritical < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set consensus.max_txs_per_critical to positive !"));
+    }
+    m_param->mutableConsensusParam().compactPrepare =
+        pt.get<bool>("consensus.compact_prepare", false);
+    m_param->mutableConsensusParam().broadcastTreeWidth =
+        pt.get<int64_t>("consensus.broadcast_tree_width", 0);
+    if (m_param->mutableConsensusParam().broadcastTreeWidth < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set consensus.broadcast_tree_width to positive !"));
+    }
+    m_param->mutableConsensusParam().enablePipeline =
+        pt.get<bool>("consensus.enable_pipeline", false);
+    m_param->mutableConsensusParam().speculativeExecution =
+        pt.get<bool>("consensus.speculative_execution", false);
+    m_param->mutableConsensusParam().targetBlockLatency =
+        pt.get<int64_t>("consensus.target_block_latency", 0);
+    if (m_param->mutableConsensusParam().targetBlockLatency < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set consensus.target_block_latency to positive !"));
+    }
     Ledger_LOG(DEBUG) << LOG_BADGE("initConsensusIniConfig")
                       << LOG_KV("maxTTL", std::to_string(m_param->mutableConsensusParam().maxTTL))
                       << LOG_KV("minBlockGenerationTime",
@@ -240,7 +356,17 @@ void Ledger::initConsensusIniConfig(ptree const& pt)
                       << LOG_KV("enablDynamicBlockSize",
                              m_param->mutableConsensusParam().enableDynamicBlockSize)
                       << LOG_KV("blockSizeIncreaseRatio",
-                             m_param->mutableConsensusParam().blockSizeIncreaseRatio);
+                             m_param->mutableConsensusParam().blockSizeIncreaseRatio)
+                      << LOG_KV("maxTxsPerCritical",
+                             m_param->mutableConsensusParam().maxTxsPerCritical)
+                      << LOG_KV("compactPrepare", m_param->mutableConsensusParam().compactPrepare)
+                      << LOG_KV("broadcastTreeWidth",
+                             m_param->mutableConsensusParam().broadcastTreeWidth)
+                      << LOG_KV("enablePipeline", m_param->mutableConsensusParam().enablePipeline)
+                      << LOG_KV("speculativeExecution",
+                             m_param->mutableConsensusParam().speculativeExecution)
+                      << LOG_KV("targetBlockLatency",
+                             m_param->mutableConsensusParam().targetBlockLatency);
 }
 
 
@@ -330,6 +456,72 @@ void Ledger::initSyncConfig(ptree const& pt)
         m_param->mutableSyncParam().idleWaitMs = SYNC_IDLE_WAIT_DEFAULT;
         Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig") << LOG_DESC("idleWaitMs invalid");
     }
+
+    try
+    {
+        m_param->mutableSyncParam().snapshotInterval =
+            pt.get<int64_t>("sync.snapshot_interval", 0);
+        if (m_param->mutableSyncParam().snapshotInterval < 0)
+        {
+            BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                      "Please set sync.snapshot_interval to non-negative !"));
+        }
+        m_param->mutableSyncParam().snapshotSync = pt.get<bool>("sync.snapshot_sync", false);
+
+        auto const& syncParam = m_param->mutableSyncParam();
+        Ledger_LOG(DEBUG) << LOG_BADGE("initSyncConfig")
+                          << LOG_KV("snapshotInterval", syncParam.snapshotInterval)
+                          << LOG_KV("snapshotSync", syncParam.snapshotSync);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableSyncParam().snapshotInterval = 0;
+        m_param->mutableSyncParam().snapshotSync = false;
+        Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig")
+                            << LOG_DESC("snapshot config invalid, snapshot disabled");
+    }
+
+    try
+    {
+        m_param->mutableSyncParam().headerFirst = pt.get<bool>("sync.header_first", false);
+        Ledger_LOG(DEBUG) << LOG_BADGE("initSyncConfig")
+                          << LOG_KV("headerFirst", m_param->mutableSyncParam().headerFirst);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableSyncParam().headerFirst = false;
+        Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig")
+                            << LOG_DESC("header_first invalid, header-first disabled");
+    }
+
+    try
+    {
+        auto& syncParam = m_param->mutableSyncParam();
+        syncParam.stateDiffBlocks = pt.get<int64_t>("sync.state_diff_blocks", 0);
+        if (syncParam.stateDiffBlocks < 0)
+        {
+            BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                      "Please set sync.state_diff_blocks to non-negative !"));
+        }
+        syncParam.stateDiff = pt.get<bool>("sync.state_diff", false);
+        /// the diffs are checked by the incremental table hash, the mpt state has no tables
+        if (dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "mpt") == 0 ||
+            g_BCOSConfig.version() < V2_1_0)
+        {
+            syncParam.stateDiffBlocks = 0;
+            syncParam.stateDiff = false;
+        }
+        Ledger_LOG(DEBUG) << LOG_BADGE("initSyncConfig")
+                          << LOG_KV("stateDiffBlocks", syncParam.stateDiffBlocks)
+                          << LOG_KV("stateDiff", syncParam.stateDiff);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableSyncParam().stateDiffBlocks = 0;
+        m_param->mutableSyncParam().stateDiff = false;
+        Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig")
+                            << LOG_DESC("state diff config invalid, state diff disabled");
+    }
 }
 
 /// init db related configurations:
@@ -366,6 +558,120 @@ void Ledger::initDBConfig(ptree const& pt)
                                   "Please set storage.max_forward_block to positive !"));
     }
 
+    m_param->mutableStorageParam().maxForwardCapacity =
+        pt.get<int>("storage.max_forward_capacity", 256);
+    if (m_param->mutableStorageParam().maxForwardCapacity < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.max_forward_capacity to positive !"));
+    }
+
+    m_param->mutableStorageParam().maxMergeBlock = pt.get<int>("storage.max_merge_block", 5);
+    if (m_param->mutableStorageParam().maxMergeBlock < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.max_merge_block to positive !"));
+    }
+
+    m_param->mutableStorageParam().cacheShards = pt.get<int>("storage.cache_shards", 0);
+    if (m_param->mutableStorageParam().cacheShards < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue()
+                              << errinfo_comment("Please set storage.cache_shards to positive !"));
+    }
+
+    m_param->mutableStorageParam().cachePolicy =
+        pt.get<std::string>("storage.cache_policy", "clock");
+    if (dev::stringCmpIgnoreCase(m_param->mutableStorageParam().cachePolicy, "clock") != 0 &&
+        dev::stringCmpIgnoreCase(m_param->mutableStorageParam().cachePolicy, "lru") != 0)
+    {
+        Ledger_LOG(WARNING) << LOG_BADGE("initDBConfig")
+                            << LOG_DESC("Unsupported storage.cache_policy, use clock")
+                            << LOG_KV("cachePolicy", m_param->mutableStorageParam().cachePolicy);
+        m_param->mutableStorageParam().cachePolicy = "clock";
+    }
+
+    m_param->mutableStorageParam().columnFamily = pt.get<bool>("storage.column_family", false);
+
+    m_param->mutableStorageParam().cacheAdmission = pt.get<bool>("storage.cache_admission", true);
+    m_param->mutableStorageParam().blockTableCapacity =
+        pt.get<int>("storage.block_table_capacity", 32);
+    if (m_param->mutableStorageParam().blockTableCapacity < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.block_table_capacity to positive !"));
+    }
+
+    m_param->mutableStorageParam().binaryProtocol = pt.get<bool>("storage.binary_protocol", true);
+
+    m_param->mutableStorageParam().wal = pt.get<bool>("storage.wal", false);
+
+    m_param->mutableStorageParam().stats = pt.get<bool>("storage.stats", true);
+    m_param->mutableStorageParam().slowThreshold = pt.get<int64_t>("storage.slow_threshold", 1000);
+    if (m_param->mutableStorageParam().slowThreshold < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.slow_threshold to positive !"));
+    }
+
+    m_param->mutableStorageParam().logIndex = pt.get<bool>("storage.log_index", false);
+
+    m_param->mutableStorageParam().hotBlocks = pt.get<int64_t>("storage.hot_blocks", 10000);
+    if (m_param->mutableStorageParam().hotBlocks < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue()
+                              << errinfo_comment("Please set storage.hot_blocks to positive !"));
+    }
+
+    auto& storageParam = m_param->mutableStorageParam();
+    storageParam.retainBlocks = pt.get<int64_t>("storage.retain_blocks", 0);
+    storageParam.retainStateBlocks = pt.get<int64_t>("storage.retain_state_blocks", 0);
+    storageParam.pruneKeysPerSecond = pt.get<int64_t>("storage.prune_keys_per_second", 1000);
+    storageParam.pruneArchivePath = pt.get<std::string>("storage.prune_archive_path", "");
+    storageParam.mptNodeCache = pt.get<int64_t>("storage.mpt_node_cache", 64);
+    if (storageParam.mptNodeCache < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.mpt_node_cache to positive !"));
+    }
+    storageParam.mptFlatState = pt.get<bool>("storage.mpt_flat_state", true);
+    storageParam.bulkLoadBlocks = pt.get<int64_t>("storage.bulk_load_blocks", 0);
+    if (storageParam.bulkLoadBlocks < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.bulk_load_blocks to positive !"));
+    }
+    storageParam.warmKeys = pt.get<int64_t>("storage.warm_keys", 0);
+    storageParam.warmKeysPerSecond = pt.get<int64_t>("storage.warm_keys_per_second", 20000);
+    if (storageParam.warmKeys < 0 || storageParam.warmKeysPerSecond < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            ForbidNegativeValue() << errinfo_comment(
+                "Please set storage.warm_keys and storage.warm_keys_per_second to positive !"));
+    }
+    storageParam.blockStore = pt.get<bool>("storage.block_store", false);
+    storageParam.blockStoreSegment = pt.get<int64_t>("storage.block_store_segment", 10000);
+    if (storageParam.blockStoreSegment <= 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.block_store_segment to positive !"));
+    }
+    if (storageParam.retainBlocks < 0 || storageParam.retainStateBlocks < 0 ||
+        storageParam.pruneKeysPerSecond <= 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.retain_blocks, storage.retain_state_blocks "
+                                  "and storage.prune_keys_per_second to positive !"));
+    }
+    /// the nonces of the blocks in the block limit are loaded by the txPool
+    if (storageParam.retainBlocks > 0 && storageParam.retainBlocks < c_minRetainBlocks)
+    {
+        BOOST_THROW_EXCEPTION(
+            ForbidNegativeValue() << errinfo_comment(
+                "Please set storage.retain_blocks to 0 or at least " +
+                std::to_string(c_minRetainBlocks) + " !"));
+    }
+
     if (m_param->mutableStorageParam().maxRetry <= 0)
     {
         m_param->mutableStorageParam().maxRetry = 100;
@@ -383,6 +689,13 @@ void Ledger::initDBConfig(ptree const& pt)
     m_param->mutableStorageParam().dbCharset = pt.get<std::string>("storage.db_charset", "utf8mb4");
     m_param->mutableStorageParam().initConnections = pt.get<int>("storage.init_connections", 15);
     m_param->mutableStorageParam().maxConnections = pt.get<int>("storage.max_connections", 50);
+    m_param->mutableStorageParam().commitConnections =
+        pt.get<int>("storage.commit_connections", 1);
+    if (m_param->mutableStorageParam().commitConnections <= 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.commit_connections to positive !"));
+    }
 
     Ledger_LOG(DEBUG) << LOG_BADGE("initDBConfig")
                       << LOG_KV("storageDB", m_param->mutableStorageParam().type)
@@ -393,7 +706,35 @@ void Ledger::initDBConfig(ptree const& pt)
                       << LOG_KV("dbport", m_param->mutableStorageParam().dbPort)
                       << LOG_KV("dbcharset", m_param->mutableStorageParam().dbCharset)
                       << LOG_KV("initconnections", m_param->mutableStorageParam().initConnections)
-                      << LOG_KV("maxconnections", m_param->mutableStorageParam().maxConnections);
+                      << LOG_KV("maxconnections", m_param->mutableStorageParam().maxConnections)
+                      << LOG_KV("commitConnections",
+                             m_param->mutableStorageParam().commitConnections)
+                      << LOG_KV("cacheShards", m_param->mutableStorageParam().cacheShards)
+                      << LOG_KV("maxForwardCapacity",
+                             m_param->mutableStorageParam().maxForwardCapacity)
+                      << LOG_KV("maxMergeBlock", m_param->mutableStorageParam().maxMergeBlock)
+                      << LOG_KV("cachePolicy", m_param->mutableStorageParam().cachePolicy)
+                      << LOG_KV("columnFamily", m_param->mutableStorageParam().columnFamily)
+                      << LOG_KV("cacheAdmission", m_param->mutableStorageParam().cacheAdmission)
+                      << LOG_KV("blockTableCapacity",
+                             m_param->mutableStorageParam().blockTableCapacity)
+                      << LOG_KV("binaryProtocol", m_param->mutableStorageParam().binaryProtocol)
+                      << LOG_KV("wal", m_param->mutableStorageParam().wal)
+                      << LOG_KV("stats", m_param->mutableStorageParam().stats)
+                      << LOG_KV("slowThreshold", m_param->mutableStorageParam().slowThreshold)
+                      << LOG_KV("logIndex", m_param->mutableStorageParam().logIndex)
+                      << LOG_KV("hotBlocks", m_param->mutableStorageParam().hotBlocks)
+                      << LOG_KV("retainBlocks", storageParam.retainBlocks)
+                      << LOG_KV("retainStateBlocks", storageParam.retainStateBlocks)
+                      << LOG_KV("pruneKeysPerSecond", storageParam.pruneKeysPerSecond)
+                      << LOG_KV("pruneArchivePath", storageParam.pruneArchivePath)
+                      << LOG_KV("mptNodeCache", storageParam.mptNodeCache)
+                      << LOG_KV("mptFlatState", storageParam.mptFlatState)
+                      << LOG_KV("bulkLoadBlocks", storageParam.bulkLoadBlocks)
+                      << LOG_KV("warmKeys", storageParam.warmKeys)
+                      << LOG_KV("warmKeysPerSecond", storageParam.warmKeysPerSecond)
+                      << LOG_KV("blockStore", storageParam.blockStore)
+                      << LOG_KV("blockStoreSegment", storageParam.blockStoreSegment);
 }
 
 /// init tx related configurations
@@ -436,6 +777,35 @@ void Ledger::initGenesisMark(GenesisBlockParam& genesisParam)
 }
 
 /// init txpool
+Json::Value Ledger::checkpoint(std::string const& _name)
+{
+    /// only the rocksdb behind the cache copies itself online
+    if (!m_dbInitializer || !m_dbInitializer->rocksDBStorage())
+        return Json::Value();
+    auto start = utcTime();
+    auto path = boost::filesystem::path(m_param->baseDir()) / "snapshot" / _name;
+    if (boost::filesystem::exists(path))
+        BOOST_THROW_EXCEPTION(dev::storage::StorageException(
+            -1, "checkpoint " + path.string() + " exists already"));
+    boost::filesystem::create_directories(path);
+
+    auto storagePath =
+        path / boost::filesystem::path(m_param->mutableStorageParam().path).filename();
+    auto number = m_dbInitializer->storage()->checkpoint(storagePath.string());
+    /// the committed prepare backed up is at the number of the checkpoint or later, a node
+    /// started from the copy syncs the blocks before it
+    if (consensus())
+        consensus()->exportBackup(path.string());
+
+    Json::Value response;
+    response["Path"] = boost::filesystem::absolute(path).string();
+    response["BlockNumber"] = (Json::Int64)number;
+    response["TimeCost"] = (Json::UInt64)(utcTime() - start);
+    Ledger_LOG(INFO) << LOG_BADGE("checkpoint") << LOG_KV("path", path.string())
+                     << LOG_KV("number", number) << LOG_KV("timecost", utcTime() - start);
+    return response;
+}
+
 bool Ledger::initTxPool()
 {
     dev::PROTOCOL_ID protocol_id = getGroupProtoclID(m_groupId, ProtocolID::TxPool);
@@ -446,9 +816,19 @@ bool Ledger::initTxPool()
         Ledger_LOG(ERROR) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool Failed");
         return false;
     }
-    m_txPool = std::make_shared<dev::txpool::TxPool>(
+    auto txPool = std::make_shared<dev::txpool::TxPool>(
         m_service, m_blockChain, protocol_id, m_param->mutableTxPoolParam().txPoolLimit);
+    txPool->setMaxTxsPerSender(m_param->mutableTxPoolParam().maxTxsPerSender);
+    txPool->setMemoryLimit(m_param->mutableTxPoolParam().memoryLimit * 1024 * 1024);
+    m_txPool = txPool;
     m_txPool->setMaxBlockLimit(g_BCOSConfig.c_blockLimit);
+    if (m_param->mutableTxPoolParam().enableJournal)
+    {
+        /// loaded first, the committed transactions of the journal are refused by their hashes
+        txPool->loadCommittedTxs(m_param->baseDir() + "/txpool.committed");
+        txPool->loadJournal(
+            std::make_shared<dev::txpool::TxPoolJournal>(m_param->baseDir() + "/txpool.journal"));
+    }
     Ledger_LOG(DEBUG) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool SUCC");
     return true;
 }
@@ -471,9 +851,33 @@ bool Ledger::initBlockVerifier()
     std::shared_ptr<BlockVerifier> blockVerifier = std::make_shared<BlockVerifier>(enableParallel);
     /// set params for blockverifier
     blockVerifier->setExecutiveContextFactory(m_dbInitializer->executiveContextFactory());
+    blockVerifier->setOptimisticExecution(m_param->mutableTxParam().optimistic);
+    blockVerifier->setProfile(
+        m_param->mutableTxParam().profile, m_param->mutableTxParam().profilePath);
+    if (m_param->mutableTxParam().evmProfile)
+    {
+        /// the interpreter is shared by the groups, a group cannot turn the profiling off
+        dev::eth::VMProfiler::instance().setEnabled(true);
+    }
+    try
+    {
+        blockVerifier->setEVMCCreateFn(dev::eth::VMFactory::load(m_param->mutableTxParam().vm));
+    }
+    catch (std::exception& e)
+    {
+        Ledger_LOG(ERROR) << LOG_BADGE("initLedger") << LOG_BADGE("initBlockVerifier Failed")
+                          << LOG_KV("vm", m_param->mutableTxParam().vm)
+                          << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return false;
+    }
     std::shared_ptr<BlockChainImp> blockChain =
         std::dynamic_pointer_cast<BlockChainImp>(m_blockChain);
     blockVerifier->setNumberHash(boost::bind(&BlockChainImp::numberHash, blockChain, _1));
+    if (m_groupScheduler)
+    {
+        blockVerifier->setTaskArena(m_groupScheduler->addGroup(m_groupId,
+            m_param->mutableTxParam().weight, m_param->mutableTxParam().maxConcurrency));
+    }
     m_blockVerifier = blockVerifier;
     Ledger_LOG(DEBUG) << LOG_BADGE("initLedger") << LOG_BADGE("initBlockVerifier SUCC");
     return true;
@@ -491,6 +895,24 @@ bool Ledger::initBlockChain(GenesisBlockParam& _genesisParam)
     std::shared_ptr<BlockChainImp> blockChain = std::make_shared<BlockChainImp>();
     blockChain->setStateStorage(m_dbInitializer->storage());
     blockChain->setTableFactoryFactory(m_dbInitializer->tableFactoryFactory());
+    blockChain->setLogIndex(m_param->mutableStorageParam().logIndex);
+    blockChain->setStateDiffCapacity(m_param->mutableSyncParam().stateDiffBlocks);
+    if (m_param->mutableStorageParam().blockStore)
+    {
+        auto blockStore = std::make_shared<BlockStore>(m_param->baseDir() + "/blockstore",
+            m_param->mutableStorageParam().blockStoreSegment);
+        try
+        {
+            blockStore->open();
+        }
+        catch (std::exception const& e)
+        {
+            Ledger_LOG(ERROR) << LOG_BADGE("initLedger") << LOG_DESC("open block store failed")
+                              << LOG_KV("EINFO", boost::diagnostic_information(e));
+            return false;
+        }
+        blockChain->setBlockStore(blockStore);
+    }
     m_blockChain = blockChain;
     bool ret = m_blockChain->checkAndBuildGenesisBlock(_genesisParam);
     if (!ret)
@@ -533,6 +955,7 @@ std::shared_ptr<Sealer> Ledger::createPBFTSealer()
 
     pbftSealer->setEnableDynamicBlockSize(m_param->mutableConsensusParam().enableDynamicBlockSize);
     pbftSealer->setBlockSizeIncreaseRatio(m_param->mutableConsensusParam().blockSizeIncreaseRatio);
+    pbftSealer->setMaxTxsPerCritical(m_param->mutableConsensusParam().maxTxsPerCritical);
 
     /// set params for PBFTEngine
     std::shared_ptr<PBFTEngine> pbftEngine =
@@ -543,6 +966,16 @@ std::shared_ptr<Sealer> Ledger::createPBFTSealer()
 
     pbftEngine->setOmitEmptyBlock(g_BCOSConfig.c_omitEmptyBlock);
     pbftEngine->setMaxTTL(m_param->mutableConsensusParam().maxTTL);
+    pbftEngine->setCompactPrepare(m_param->mutableConsensusParam().compactPrepare);
+    pbftEngine->setBroadcastTreeWidth(m_param->mutableConsensusParam().broadcastTreeWidth);
+    pbftEngine->setEnablePipeline(m_param->mutableConsensusParam().enablePipeline);
+    /// the writes of the parent are laid over the storage, the mpt state has none
+    pbftEngine->setSpeculativeExecution(
+        m_param->mutableConsensusParam().enablePipeline &&
+        m_param->mutableConsensusParam().speculativeExecution &&
+        dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "mpt") != 0);
+    pbftEngine->blockSizeController().setTargetLatency(
+        m_param->mutableConsensusParam().targetBlockLatency);
     return pbftSealer;
 }
 
@@ -618,8 +1051,40 @@ bool Ledger::initSync()
     }
     dev::PROTOCOL_ID protocol_id = getGroupProtoclID(m_groupId, ProtocolID::BlockSync);
     dev::h256 genesisHash = m_blockChain->getBlockByNumber(int64_t(0))->headerHash();
-    m_sync = std::make_shared<SyncMaster>(m_service, m_txPool, m_blockChain, m_blockVerifier,
-        protocol_id, m_keyPair.pub(), genesisHash, m_param->mutableSyncParam().idleWaitMs);
+    auto syncMaster = std::make_shared<SyncMaster>(m_service, m_txPool, m_blockChain,
+        m_blockVerifier, protocol_id, m_keyPair.pub(), genesisHash,
+        m_param->mutableSyncParam().idleWaitMs);
+    /// the dumps and the restore need a storage that scans its keys in order
+    auto storage = m_dbInitializer->storage();
+    if (m_param->mutableSyncParam().snapshotInterval > 0)
+    {
+        syncMaster->setSnapshotStore(std::make_shared<SnapshotStore>(storage, m_blockChain,
+                                         m_param->baseDir() + "/snapshot", m_groupId),
+            m_param->mutableSyncParam().snapshotInterval);
+    }
+    if (m_param->mutableSyncParam().snapshotSync && m_blockChain->number() == 0)
+    {
+        syncMaster->setSnapshotImporter(
+            std::make_shared<SnapshotImporter>(storage, m_blockChain, m_groupId));
+    }
+    /// the blocks merged by the cache are ingested as sst files while the node is far behind
+    auto rocksDBStorage = m_dbInitializer->rocksDBStorage();
+    if (m_param->mutableStorageParam().bulkLoadBlocks > 0 && rocksDBStorage)
+    {
+        syncMaster->setBulkLoadHandler(
+            [rocksDBStorage](bool _bulkLoad) { rocksDBStorage->setBulkLoad(_bulkLoad); },
+            m_param->mutableStorageParam().bulkLoadBlocks);
+    }
+    /// the bodies are checked against the transactionsRoot, the hash of the bodies from RC2 on
+    if (m_param->mutableSyncParam().headerFirst && g_BCOSConfig.version() >= RC2_VERSION)
+    {
+        syncMaster->enableHeaderFirst();
+    }
+    if (m_param->mutableSyncParam().stateDiff)
+    {
+        syncMaster->enableStateDiff();
+    }
+    m_sync = syncMaster;
     Ledger_LOG(DEBUG) << LOG_BADGE("initLedger") << LOG_DESC("initSync SUCC");
     return true;
 }
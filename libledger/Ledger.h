@@ -23,6 +23,7 @@
  */
 #pragma once
 #include "DBInitializer.h"
+#include "GroupScheduler.h"
 #include "LedgerInterface.h"
 #include "LedgerParam.h"
 #include "LedgerParamInterface.h"
@@ -120,11 +121,27 @@ public:
     std::shared_ptr<dev::sync::SyncInterface> sync() const override { return m_sync; }
     virtual dev::GROUP_ID const& groupId() const override { return m_groupId; }
     std::shared_ptr<LedgerParamInterface> getParam() const override { return m_param; }
+    Json::Value storageStats() const override
+    {
+        if (m_dbInitializer && m_dbInitializer->statsStorage())
+        {
+            return m_dbInitializer->statsStorage()->statistics();
+        }
+        return Json::Value();
+    }
+
+    /// the copy is placed in snapshot/_name of the group data, the storage as the last directory
+    /// of its path and the consensus backup as in the group data, to be copied into a new node
+    Json::Value checkpoint(std::string const& _name) override;
 
     virtual void setChannelRPCServer(ChannelRPCServer::Ptr channelRPCServer) override
     {
         m_channelRPCServer = channelRPCServer;
     }
+    void setGroupScheduler(GroupScheduler::Ptr _groupScheduler) override
+    {
+        m_groupScheduler = _groupScheduler;
+    }
 
 protected:
     /// load genesis config of group
@@ -175,6 +192,7 @@ protected:
 
     std::shared_ptr<dev::ledger::DBInitializer> m_dbInitializer = nullptr;
     ChannelRPCServer::Ptr m_channelRPCServer;
+    GroupScheduler::Ptr m_groupScheduler;
 };
 }  // namespace ledger
 }  // namespace dev
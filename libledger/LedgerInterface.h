@@ -35,6 +35,8 @@ namespace dev
 {
 namespace ledger
 {
+class GroupScheduler;
+
 class LedgerInterface
 {
 public:
@@ -52,6 +54,11 @@ public:
     virtual std::shared_ptr<dev::sync::SyncInterface> sync() const = 0;
     virtual dev::GROUP_ID const& groupId() const = 0;
     virtual std::shared_ptr<LedgerParamInterface> getParam() const = 0;
+    /// statistics of the storage backend, null if they are not recorded
+    virtual Json::Value storageStats() const { return Json::Value(); }
+    /// copy the storage and the consensus backup online into a directory named _name, null if
+    /// the storage can't be copied online
+    virtual Json::Value checkpoint(std::string const&) { return Json::Value(); }
     virtual void startAll() = 0;
     virtual void stopAll() = 0;
     virtual dev::KeyPair const& keyPair() const { return m_keyPair; };
@@ -59,6 +66,11 @@ public:
     {
         (void)channelRPCServer;
     };
+    /// the scheduler of the groups sharing the process, set before initLedger
+    virtual void setGroupScheduler(std::shared_ptr<GroupScheduler> _groupScheduler)
+    {
+        (void)_groupScheduler;
+    }
 
 protected:
     dev::KeyPair m_keyPair;
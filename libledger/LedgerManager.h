@@ -22,6 +22,7 @@
  * @date: 2018-10-23
  */
 #pragma once
+#include "GroupScheduler.h"
 #include "Ledger.h"
 #include "LedgerInterface.h"
 #include <libethcore/Protocol.h>
@@ -100,6 +101,10 @@ public:
     /// start all the ledgers that have been created
     virtual void startAll()
     {
+        if (m_groupScheduler)
+        {
+            m_groupScheduler->start();
+        }
         for (auto item : m_ledgerMap)
         {
             if (!item.second)
@@ -116,6 +121,23 @@ public:
                 continue;
             item.second->stopAll();
         }
+        if (m_groupScheduler)
+        {
+            m_groupScheduler->stop();
+        }
+    }
+    /// the scheduler of the groups sharing the process, set before the ledgers are inited
+    void setGroupScheduler(GroupScheduler::Ptr _groupScheduler)
+    {
+        m_groupScheduler = _groupScheduler;
+    }
+    GroupScheduler::Ptr groupScheduler() const { return m_groupScheduler; }
+    /// get the resources of the group in the process, null if it isn't scheduled
+    Json::Value groupStats(dev::GROUP_ID const& groupId)
+    {
+        if (!m_ledgerMap.count(groupId) || !m_groupScheduler)
+            return Json::Value();
+        return m_groupScheduler->groupStats(groupId);
     }
     /// get pointer of txPool by group id
     std::shared_ptr<dev::txpool::TxPoolInterface> txPool(dev::GROUP_ID const& groupId)
@@ -154,6 +176,20 @@ public:
             return nullptr;
         return m_ledgerMap[groupId]->sync();
     }
+    /// get statistics of the storage backend by group id
+    Json::Value storageStats(dev::GROUP_ID const& groupId)
+    {
+        if (!m_ledgerMap.count(groupId))
+            return Json::Value();
+        return m_ledgerMap[groupId]->storageStats();
+    }
+    /// copy the storage of the group online, null if it can't be copied
+    Json::Value checkpoint(dev::GROUP_ID const& groupId, std::string const& name)
+    {
+        if (!m_ledgerMap.count(groupId))
+            return Json::Value();
+        return m_ledgerMap[groupId]->checkpoint(name);
+    }
     /// get ledger params by group id
     std::shared_ptr<LedgerParamInterface> getParamByGroupId(dev::GROUP_ID const& groupId)
     {
@@ -177,6 +213,7 @@ private:
 
     /// map used to store the mappings between groupId and created ledger objects
     std::map<dev::GROUP_ID, std::shared_ptr<LedgerInterface>> m_ledgerMap;
+    GroupScheduler::Ptr m_groupScheduler;
 };
 }  // namespace ledger
 }  // namespace dev
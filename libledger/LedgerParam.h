@@ -36,6 +36,12 @@ namespace ledger
 struct TxPoolParam
 {
     int64_t txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
+    /// the most transactions of a sender in a block, 0 for no limit
+    int64_t maxTxsPerSender = 0;
+    /// the most megabytes of the pending transactions, 0 for no limit
+    int64_t memoryLimit = 0;
+    /// journal the pending transactions to reload them on restart
+    bool enableJournal = false;
 };
 struct ConsensusParam
 {
@@ -53,6 +59,18 @@ struct ConsensusParam
     bool enableDynamicBlockSize = true;
     /// block size increase ratio
     float blockSizeIncreaseRatio = 0.5;
+    /// the most transactions of a block sharing a critical field, 0 for no limit
+    int64_t maxTxsPerCritical = 0;
+    /// broadcast the prepare with the transaction hashes instead of the transactions
+    bool compactPrepare = false;
+    /// children of each sealer in the tree relaying the pbft messages, 0 to broadcast them
+    int64_t broadcastTreeWidth = 0;
+    /// propose the next block while the current one is in its commit phase
+    bool enablePipeline = false;
+    /// the leader executes its pipelined block before the parent is saved
+    bool speculativeExecution = false;
+    /// latency from the prepare to the saved block the block size is tuned to(ms), 0 to disable
+    int64_t targetBlockLatency = 0;
 };
 
 struct AMDBParam
@@ -67,6 +85,16 @@ struct SyncParam
 {
     /// TODO: syncParam related
     signed idleWaitMs = SYNC_IDLE_WAIT_DEFAULT;
+    /// blocks between two dumps of the state served to the new nodes, 0 disables the dumps
+    int64_t snapshotInterval = 0;
+    /// a new node restores the state snapshot of the peers instead of replaying the blocks
+    bool snapshotSync = false;
+    /// long ranges are downloaded header first with the bodies fetched from all the peers
+    bool headerFirst = false;
+    /// the state diffs of the latest blocks kept and served to the observers, 0 keeps none
+    int64_t stateDiffBlocks = 0;
+    /// the state diffs of the blocks downloaded are committed instead of executing the blocks
+    bool stateDiff = false;
 };
 
 /// modification 2019.03.20: add timeStamp field to GenesisParam
@@ -85,6 +113,8 @@ struct StorageParam
     std::string topic;
     size_t timeout;
     int maxRetry;
+    // negotiate the binary protocol with the amdb proxy, json is used if it's not supported
+    bool binaryProtocol;
     // MB
     int maxCapacity;
 
@@ -98,8 +128,61 @@ struct StorageParam
     std::string dbCharset;
     uint32_t initConnections;
     uint32_t maxConnections;
+    // connections a block is committed with in parallel, 1 means one transaction
+    int commitConnections;
     int maxForwardBlock;
+    // MB of the blocks waiting for the backend, 0 means only bounded by maxForwardBlock
+    int maxForwardCapacity;
+    // consecutive blocks merged into one backend commit
+    int maxMergeBlock;
+    // shards of the cache index, 0 means one shard per hardware thread
+    int cacheShards;
+    // eviction policy of the cache, clock or lru
+    std::string cachePolicy;
+    // place block tables and contract tables of rocksdb in column families of their own
+    bool columnFamily;
+    // keys accessed once are evicted first
+    bool cacheAdmission;
+    // MB of the cache each block table may use, 0 means unbounded
+    int blockTableCapacity;
+    // log blocks locally before they reach the backend, replayed into it on restart
+    bool wal;
+    // blocks kept in rocksdb by the tiered storage before their block tables move to mysql
+    int64_t hotBlocks;
+    // record the latency and the access of each table of the backend
+    bool stats;
+    // ms, backend operations slower than it are logged, 0 means not logged
+    int64_t slowThreshold;
+    // index the logs of the committed blocks by address and topic for getLogs
+    bool logIndex = false;
+    // only for rocksdb, blocks whose bodies are kept, 0 keeps all
+    int64_t retainBlocks = 0;
+    // only for rocksdb and the mpt state, blocks the deleted rows or trie nodes are kept for, 0
+    // keeps all
+    int64_t retainStateBlocks = 0;
+    // only for the mpt state, MB of the trie nodes read from the db cached in memory
+    int64_t mptNodeCache = 64;
+    // only for the mpt state, the accounts and the storage of the latest state are read from flat
+    // entries instead of the trie
+    bool mptFlatState = true;
+    // keys pruned a second at most
+    int64_t pruneKeysPerSecond = 1000;
+    // rocksdb the data pruned is moved to, empty drops it
+    std::string pruneArchivePath;
+    // only for rocksdb, blocks behind the peers to load the blocks as sst files, 0 disables it
+    int64_t bulkLoadBlocks = 0;
+    // keep the committed blocks in segment files too and read them from there first
+    bool blockStore = false;
+    // the most recently used keys of the cache saved to disk and fetched again on start, 0
+    // disables it
+    int64_t warmKeys = 0;
+    // keys fetched a second at most by the warm-up, 0 means unlimited
+    int64_t warmKeysPerSecond = 20000;
+    // blocks of each segment of the block store
+    int64_t blockStoreSegment = 10000;
 };
+/// the blocks kept at least by pruning, the nonces of the block limit are read from them
+static const int64_t c_minRetainBlocks = 1000;
 struct StateParam
 {
     std::string type;
@@ -108,6 +191,18 @@ struct TxParam
 {
     int64_t txGasLimit;
     bool enableParallel = false;
+    // execute transactions of no parallel tags along the keys of a speculative execution
+    bool optimistic = false;
+    // name of the built-in VM or path of an EVMC VM to execute contracts
+    std::string vm = "interpreter";
+    // share of the workers of the process, and the workers at most with 0 for no limit
+    unsigned weight = 1;
+    unsigned maxConcurrency = 0;
+    // log what limits the parallelism of each block, and write its trace to profilePath
+    bool profile = false;
+    std::string profilePath;
+    // count the opcodes and time the opcode categories of each contract, for the whole process
+    bool evmProfile = false;
 };
 class LedgerParam : public LedgerParamInterface
 {
@@ -150,9 +150,9 @@ void MPTState::commit()
     m_state.commit();
 }
 
-void MPTState::dbCommit(h256 const&, int64_t)
+void MPTState::dbCommit(h256 const&, int64_t _blockNumber)
 {
-    m_state.db().commit();
+    m_state.db().commit(_blockNumber);
 }
 
 void MPTState::setRoot(h256 const& _root)
@@ -190,6 +190,11 @@ void MPTState::clear()
     m_state.cacheClear();
 }
 
+void MPTState::flush()
+{
+    // the changes stay in the cache of the state until commit()
+}
+
 bool MPTState::checkAuthority(Address const&, Address const&) const
 {
     return true;
@@ -122,6 +122,8 @@ public:
 
     void clear() override;
 
+    void flush() override;
+
     bool checkAuthority(Address const& _origin, Address const& _contract) const override;
 
     State& getState();
@@ -38,10 +38,17 @@ class MPTStateFactory : public dev::executive::StateFactoryInterface
 {
 public:
     MPTStateFactory(u256 const& _accountStartNonce, boost::filesystem::path const& _basePath,
-        h256 const& _genesisHash, WithExisting _we)
+        h256 const& _genesisHash, WithExisting _we,
+        size_t _nodeCacheCapacity = TrieNodeCache::c_defaultCapacity, int64_t _retainBlocks = 0,
+        bool _flatState = false)
       : m_accountStartNonce(_accountStartNonce), m_basePath(_basePath), m_genesisHash(_genesisHash)
     {
         m_db = MPTState::openDB(m_basePath, m_genesisHash, _we);
+        // the states share the cache of the nodes, prune the nodes of older blocks and read the
+        // latest state from the flat entries
+        m_db.setNodeCacheCapacity(_nodeCacheCapacity);
+        m_db.setRetainBlocks(_retainBlocks);
+        m_db.setFlatState(_flatState);
     };
     virtual ~MPTStateFactory(){};
     virtual std::shared_ptr<dev::executive::StateFace> getState(
@@ -28,6 +28,8 @@
 #include <libdevcore/TrieHash.h>
 #include <libdevcore/easylog.h>
 #include <libsecurity/EncryptedLevelDB.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <boost/filesystem.hpp>
 #include <boost/timer.hpp>
 
@@ -38,13 +40,30 @@ using namespace dev::mptstate;
 namespace fs = boost::filesystem;
 namespace devdb = dev::db;
 
+namespace
+{
+/// the keys of the flat state, the address of an account, then the hash of a key of its storage
+std::string flatKey(Address const& _address)
+{
+    return std::string((char const*)_address.data(), Address::size);
+}
+
+std::string flatKey(Address const& _address, h256 const& _hashedKey)
+{
+    return flatKey(_address) + std::string((char const*)_hashedKey.data(), h256::size);
+}
+}  // namespace
+
 State::State(u256 const& _accountStartNonce, OverlayDB const& _db, BaseState _bs)
   : m_db(_db), m_state(&m_db), m_accountStartNonce(_accountStartNonce)
 {
     if (_bs != BaseState::PreExisting)
+    {
         // Initialise to the state entailed by the genesis block; this guarantees the trie is built
         // correctly.
         m_state.init();
+        m_db.openFlat(m_state.root());
+    }
 }
 
 State::State(State const& _s)
@@ -167,7 +186,7 @@ Account* State::account(Address const& _addr)
         return nullptr;
 
     // Populate basic info.
-    string stateBack = m_state.at(_addr);
+    string stateBack = accountRLP(_addr);
     if (stateBack.empty())
     {
         m_nonExistingAccountsCache.insert(_addr);
@@ -189,6 +208,49 @@ Account* State::account(Address const& _addr)
     return &i.first->second;
 }
 
+std::string State::accountRLP(Address const& _addr) const
+{
+    string ret;
+    if (m_db.lookupFlat(flatKey(_addr), ret))
+        return ret;
+    return m_state.at(_addr);
+}
+
+void State::commitFlat()
+{
+    // the storage of the accounts killed or cleared leaves the flat state, a contract cleared
+    // for a new code has no storage root
+    for (auto const& i : m_cache)
+    {
+        auto const& account = i.second;
+        if (!account.isDirty() || (account.isAlive() && (account.baseRoot() != EmptyTrie ||
+                                                            account.codeHash() == EmptySHA3)))
+            continue;
+        string const stateBack = accountRLP(i.first);
+        if (stateBack.empty())
+            continue;
+        h256 const root = RLP(stateBack)[2].toHash<h256>();
+        if (root == EmptyTrie)
+            continue;
+        GenericTrieDB<OverlayDB> storageDB(&m_db, root);
+        for (auto it = storageDB.begin(); it != storageDB.end(); ++it)
+            m_db.insertFlat(flatKey(i.first, h256((*it).first)), string());
+    }
+
+    unordered_map<Address, bytes> accounts;
+    m_touched += dev::mptstate::commit(m_cache, m_state, &accounts);
+    for (auto const& i : accounts)
+    {
+        m_db.insertFlat(flatKey(i.first), asString(i.second));
+        if (i.second.empty())
+            continue;
+        for (auto const& j : m_cache.at(i.first).storageOverlay())
+            m_db.insertFlat(flatKey(i.first, sha3(h256(j.first))),
+                j.second ? asString(rlp(j.second)) : string());
+    }
+    m_db.setFlatRoot(m_state.root());
+}
+
 void State::clearCacheIfTooLarge() const
 {
     // TODO: Find a good magic number
@@ -214,7 +276,10 @@ void State::commit()
 {
     // Remove empty accounts by default
     removeEmptyAccounts();
-    m_touched += dev::mptstate::commit(m_cache, m_state);
+    if (m_db.flatState())
+        commitFlat();
+    else
+        m_touched += dev::mptstate::commit(m_cache, m_state);
     m_changeLog.clear();
     m_cache.clear();
     m_unchangedCacheEntries.clear();
@@ -299,6 +364,7 @@ void State::setRoot(h256 const& _r)
     m_nonExistingAccountsCache.clear();
     //  m_touched.clear();
     m_state.setRoot(_r);
+    m_db.openFlat(_r);
 }
 
 bool State::addressInUse(Address const& _id) const
@@ -449,10 +515,16 @@ u256 State::storage(Address const& _id, u256 const& _key)
         if (mit != a->storageOverlay().end())
             return mit->second;
 
-        // Not in the storage cache - go to the DB.
-        SecureTrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_db),
-            a->baseRoot());  // promise we won't change the overlay! :)
-        string payload = memdb.at(_key);
+        // Not in the storage cache - go to the flat state, or to the DB. The flat state may
+        // still hold the storage cleared since the last commit.
+        string payload;
+        if (a->baseRoot() != EmptyTrie &&
+            !m_db.lookupFlat(flatKey(_id, sha3(h256(_key))), payload))
+        {
+            SecureTrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_db),
+                a->baseRoot());  // promise we won't change the overlay! :)
+            payload = memdb.at(_key);
+        }
         u256 ret = payload.size() ? RLP(payload).toInt<u256>() : 0;
         a->setStorage(_key, ret);
         return ret;
@@ -519,7 +591,7 @@ map<h256, pair<u256, u256>> State::storage(Address const& _id) const
 
 h256 State::storageRoot(Address const& _id) const
 {
-    string s = m_state.at(_id);
+    string s = accountRLP(_id);
     if (s.size())
     {
         RLP r(s);
@@ -741,29 +813,37 @@ std::ostream& dev::mptstate::operator<<(std::ostream& _out, State const& _s)
 #endif
 
 template <class DB>
-AddressHash dev::mptstate::commit(AccountMap const& _cache, SecureTrieDB<Address, DB>& _state)
-{
-    AddressHash ret;
-    for (auto const& i : _cache)
-        if (i.second.isDirty())
-        {
-            if (!i.second.isAlive())
-                _state.remove(i.first);
-            else
+AddressHash dev::mptstate::commit(AccountMap const& _cache, SecureTrieDB<Address, DB>& _state,
+    std::unordered_map<Address, bytes>* _accounts)
+{
+    vector<AccountMap::const_iterator> dirty;
+    for (auto it = _cache.begin(); it != _cache.end(); ++it)
+        if (it->second.isDirty())
+            dirty.push_back(it);
+
+    // the storage tries and the code of the accounts are written concurrently, the db guards
+    // itself, and the trie doesn't depend on the order of the updates
+    vector<bytes> encoded(dirty.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, dirty.size()),
+        [&](tbb::blocked_range<size_t> const& _range) {
+            for (size_t k = _range.begin(); k < _range.end(); ++k)
             {
+                auto const& account = dirty[k]->second;
+                if (!account.isAlive())
+                    continue;
                 RLPStream s(4);
-                s << i.second.nonce() << i.second.balance();
+                s << account.nonce() << account.balance();
 
-                if (i.second.storageOverlay().empty())
+                if (account.storageOverlay().empty())
                 {
                     // for programming debug
-                    assert(i.second.baseRoot());
-                    s.append(i.second.baseRoot());
+                    assert(account.baseRoot());
+                    s.append(account.baseRoot());
                 }
                 else
                 {
-                    SecureTrieDB<h256, DB> storageDB(_state.db(), i.second.baseRoot());
-                    for (auto const& j : i.second.storageOverlay())
+                    SecureTrieDB<h256, DB> storageDB(_state.db(), account.baseRoot());
+                    for (auto const& j : account.storageOverlay())
                         if (j.second)
                             storageDB.insert(j.first, rlp(j.second));
                         else
@@ -773,26 +853,37 @@ AddressHash dev::mptstate::commit(AccountMap const& _cache, SecureTrieDB<Address
                     s.append(storageDB.root());
                 }
 
-                if (i.second.hasNewCode())
+                if (account.hasNewCode())
                 {
-                    h256 ch = i.second.codeHash();
+                    h256 ch = account.codeHash();
                     // Store the size of the code
-                    CodeSizeCache::instance().store(ch, i.second.code().size());
-                    _state.db()->insert(ch, &i.second.code());
+                    CodeSizeCache::instance().store(ch, account.code().size());
+                    _state.db()->insert(ch, &account.code());
                     s << ch;
                 }
                 else
-                    s << i.second.codeHash();
-
-                _state.insert(i.first, &s.out());
+                    s << account.codeHash();
+                encoded[k] = s.out();
             }
-            ret.insert(i.first);
-        }
+        });
+
+    // the account trie is updated in turn
+    AddressHash ret;
+    for (size_t k = 0; k < dirty.size(); ++k)
+    {
+        if (!dirty[k]->second.isAlive())
+            _state.remove(dirty[k]->first);
+        else
+            _state.insert(dirty[k]->first, &encoded[k]);
+        ret.insert(dirty[k]->first);
+        if (_accounts)
+            (*_accounts)[dirty[k]->first] = move(encoded[k]);
+    }
     return ret;
 }
 
 
-template AddressHash dev::mptstate::commit<OverlayDB>(
-    AccountMap const& _cache, SecureTrieDB<Address, OverlayDB>& _state);
-template AddressHash dev::mptstate::commit<MemoryDB>(
-    AccountMap const& _cache, SecureTrieDB<Address, MemoryDB>& _state);
+template AddressHash dev::mptstate::commit<OverlayDB>(AccountMap const& _cache,
+    SecureTrieDB<Address, OverlayDB>& _state, std::unordered_map<Address, bytes>* _accounts);
+template AddressHash dev::mptstate::commit<MemoryDB>(AccountMap const& _cache,
+    SecureTrieDB<Address, MemoryDB>& _state, std::unordered_map<Address, bytes>* _accounts);
@@ -345,6 +345,13 @@ private:
     /// Purges non-modified entries in m_cache if it grows too large.
     void clearCacheIfTooLarge() const;
 
+    /// @returns the rlp of the account at the given address from the flat state if it is kept,
+    /// from the trie otherwise, empty if the account does not exist.
+    std::string accountRLP(Address const& _addr) const;
+
+    /// Commits the cache to the trie and to the flat state.
+    void commitFlat();
+
     void createAccount(Address const& _address, Account const&& _account);
 
     OverlayDB m_db;                                        ///< Our overlay for the state tree.
@@ -367,8 +374,10 @@ private:
 
 std::ostream& operator<<(std::ostream& _out, State const& _s);
 
+/// @param _accounts if not null, the rlp of each account committed, empty for the killed ones
 template <class DB>
-AddressHash commit(AccountMap const& _cache, SecureTrieDB<Address, DB>& _state);
+AddressHash commit(AccountMap const& _cache, SecureTrieDB<Address, DB>& _state,
+    std::unordered_map<Address, bytes>* _accounts = nullptr);
 
 }  // namespace mptstate
 }  // namespace dev
@@ -26,6 +26,10 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/beast/websocket/ssl.hpp>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace ba = boost::asio;
 namespace bi = ba::ip;
@@ -61,6 +65,17 @@ public:
         m_ioService = ioService;
     }
 
+    /// the io_services the sessions are spread over, each is run by a thread of its own so that
+    /// the ssl work of the peers runs on several cores; the sessions share ioService() if empty
+    virtual std::vector<std::shared_ptr<ba::io_service>> const& sessionIOServices()
+    {
+        return m_sessionIOServices;
+    }
+    virtual void setSessionIOServices(std::vector<std::shared_ptr<ba::io_service>> _ioServices)
+    {
+        m_sessionIOServices = _ioServices;
+    }
+
     virtual std::shared_ptr<ba::ssl::context> sslContext() { return m_sslContext; }
     virtual void setSSLContext(std::shared_ptr<ba::ssl::context> sslContext)
     {
@@ -75,11 +90,31 @@ public:
 
     virtual std::shared_ptr<SocketFace> newSocket(NodeIPEndpoint nodeIPEndpoint = NodeIPEndpoint())
     {
-        std::shared_ptr<SocketFace> m_socket =
-            std::make_shared<Socket>(*m_ioService, *m_sslContext, nodeIPEndpoint);
+        std::shared_ptr<SocketFace> m_socket = std::make_shared<Socket>(
+            sessionIOService(nodeIPEndpoint), *m_sslContext, nodeIPEndpoint);
         return m_socket;
     }
 
+    /// the io_service a socket runs on for its lifetime, the connections to a peer are pinned to
+    /// the same one by its endpoint and the accepted ones take the io_services in turn
+    virtual ba::io_service& sessionIOService(NodeIPEndpoint const& nodeIPEndpoint)
+    {
+        if (m_sessionIOServices.empty())
+        {
+            return *m_ioService;
+        }
+        size_t index = 0;
+        if (nodeIPEndpoint.address.is_unspecified())
+        {
+            index = m_nextIOService++;
+        }
+        else
+        {
+            index = std::hash<std::string>()(nodeIPEndpoint.name());
+        }
+        return *m_sessionIOServices[index % m_sessionIOServices.size()];
+    }
+
     virtual std::shared_ptr<bi::tcp::acceptor> acceptor() { return m_acceptor; }
 
     virtual void init(std::string listenHost, uint16_t listenPort)
@@ -104,6 +139,10 @@ public:
         }
 
         m_ioService->stop();
+        for (auto const& ioService : m_sessionIOServices)
+        {
+            ioService->stop();
+        }
     }
 
     virtual void reset()
@@ -131,7 +170,8 @@ public:
         boost::asio::mutable_buffers_1 buffers, ReadWriteHandler handler)
     {
         auto type = m_type;
-        m_ioService->post([type, socket, buffers, handler]() {
+        /// the operations of a socket run on its own io_service
+        socket->ref().get_io_service().post([type, socket, buffers, handler]() {
             if (socket->isConnected())
             {
                 switch (type)
@@ -157,6 +197,36 @@ public:
         });
     }
 
+    /// write the buffers in one operation, the socket gathers them
+    virtual void asyncWrite(std::shared_ptr<SocketFace> socket,
+        std::vector<boost::asio::const_buffer> const& buffers, ReadWriteHandler handler)
+    {
+        auto type = m_type;
+        socket->ref().get_io_service().post([type, socket, buffers, handler]() {
+            if (socket->isConnected())
+            {
+                switch (type)
+                {
+                case TCP_ONLY:
+                {
+                    ba::async_write(socket->ref(), buffers, handler);
+                    break;
+                }
+                case SSL:
+                {
+                    ba::async_write(socket->sslref(), buffers, handler);
+                    break;
+                }
+                case WEBSOCKET:
+                {
+                    socket->wsref().async_write(buffers, handler);
+                    break;
+                }
+                }
+            }
+        });
+    }
+
     virtual void asyncRead(std::shared_ptr<SocketFace> socket,
         boost::asio::mutable_buffers_1 buffers, ReadWriteHandler handler)
     {
@@ -227,6 +297,8 @@ public:
 
 protected:
     std::shared_ptr<ba::io_service> m_ioService;
+    std::vector<std::shared_ptr<ba::io_service>> m_sessionIOServices;
+    std::atomic<size_t> m_nextIOService = {0};
     std::shared_ptr<ba::io_service::strand> m_strand;
     std::shared_ptr<bi::tcp::acceptor> m_acceptor;
     std::shared_ptr<ba::ssl::context> m_sslContext;
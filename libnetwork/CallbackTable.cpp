@@ -0,0 +1,160 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file CallbackTable.cpp
+ *  @brief the callbacks of the requests waiting for their responses and their timeouts
+ */
+
+#include "CallbackTable.h"
+#include <libdevcore/Assertions.h>
+#include <algorithm>
+
+using namespace dev;
+using namespace dev::network;
+
+CallbackTable::CallbackTable(size_t _slots) : m_slots(_slots), m_mask(_slots - 1)
+{
+    assertThrow(
+        (_slots & m_mask) == 0, Exception, "the slots of the callbacks must be a power of 2");
+}
+
+void CallbackTable::add(uint32_t _seq, ResponseCallback::Ptr const& _callback)
+{
+    _callback->seq = _seq;
+    ResponseCallback::Ptr empty;
+    if (std::atomic_compare_exchange_strong(&m_slots[_seq & m_mask], &empty, _callback))
+    {
+        ++m_size;
+        return;
+    }
+    Guard l(x_overflow);
+    m_overflow[_seq] = _callback;
+    m_overflowSize = m_overflow.size();
+}
+
+ResponseCallback::Ptr CallbackTable::get(uint32_t _seq)
+{
+    auto callback = std::atomic_load(&m_slots[_seq & m_mask]);
+    if (callback && callback->seq == _seq)
+    {
+        return callback;
+    }
+    if (m_overflowSize == 0)
+    {
+        return nullptr;
+    }
+    Guard l(x_overflow);
+    auto it = m_overflow.find(_seq);
+    return it != m_overflow.end() ? it->second : nullptr;
+}
+
+ResponseCallback::Ptr CallbackTable::take(uint32_t _seq)
+{
+    auto& slot = m_slots[_seq & m_mask];
+    auto callback = std::atomic_load(&slot);
+    /// the failed swap reloads the slot, it may have been taken or reused meanwhile
+    while (callback && callback->seq == _seq)
+    {
+        if (std::atomic_compare_exchange_strong(&slot, &callback, ResponseCallback::Ptr()))
+        {
+            --m_size;
+            return callback;
+        }
+    }
+    if (m_overflowSize == 0)
+    {
+        return nullptr;
+    }
+    Guard l(x_overflow);
+    auto it = m_overflow.find(_seq);
+    if (it == m_overflow.end())
+    {
+        return nullptr;
+    }
+    callback = it->second;
+    m_overflow.erase(it);
+    m_overflowSize = m_overflow.size();
+    return callback;
+}
+
+std::vector<ResponseCallback::Ptr> CallbackTable::takeAll()
+{
+    std::vector<ResponseCallback::Ptr> callbacks;
+    for (auto& slot : m_slots)
+    {
+        auto callback = std::atomic_exchange(&slot, ResponseCallback::Ptr());
+        if (callback)
+        {
+            --m_size;
+            callbacks.push_back(callback);
+        }
+    }
+    Guard l(x_overflow);
+    for (auto const& it : m_overflow)
+    {
+        callbacks.push_back(it.second);
+    }
+    m_overflow.clear();
+    m_overflowSize = 0;
+    return callbacks;
+}
+
+TimingWheel::TimingWheel(uint64_t _tick, size_t _slots) : m_tick(_tick), m_slots(_slots) {}
+
+void TimingWheel::add(uint64_t _timeout, std::function<void()> const& _handler)
+{
+    uint64_t ticks = std::max<uint64_t>(1, (_timeout + m_tick - 1) / m_tick);
+    Guard l(x_slots);
+    /// the slot is passed (ticks - 1) / slots times before it expires
+    m_slots[(m_current + ticks) % m_slots.size()].push_back(
+        Timeout{(ticks - 1) / m_slots.size(), _handler});
+    ++m_size;
+}
+
+void TimingWheel::tick()
+{
+    std::vector<std::function<void()>> expired;
+    {
+        Guard l(x_slots);
+        m_current = (m_current + 1) % m_slots.size();
+        std::vector<Timeout> remaining;
+        for (auto& timeout : m_slots[m_current])
+        {
+            if (timeout.rounds == 0)
+            {
+                expired.push_back(std::move(timeout.handler));
+            }
+            else
+            {
+                --timeout.rounds;
+                remaining.push_back(std::move(timeout));
+            }
+        }
+        m_slots[m_current].swap(remaining);
+        m_size -= expired.size();
+    }
+    /// the handlers may add timeouts
+    for (auto const& handler : expired)
+    {
+        handler();
+    }
+}
+
+size_t TimingWheel::size()
+{
+    Guard l(x_slots);
+    return m_size;
+}
@@ -0,0 +1,104 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file CallbackTable.h
+ *  @brief the callbacks of the requests waiting for their responses and their timeouts
+ */
+
+#pragma once
+
+#include "SessionFace.h"
+#include <libdevcore/Guards.h>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace dev
+{
+namespace network
+{
+/// slots of the callback table of a session, a power of 2
+static const size_t c_callbackSlots = 1024;
+/// the interval the timing wheel of the host turns in milliseconds, and its number of slots
+static const uint64_t c_timingWheelTick = 10;
+static const size_t c_timingWheelSlots = 512;
+
+/// The callbacks of a session waiting for their responses. The callback of a request is kept in
+/// the slot indexed by its seq, so that it's found and taken out by an atomic load and a
+/// compare-and-swap rather than a lookup under a lock. The seqs are increasing, the slot of a
+/// request is only taken when c_callbackSlots later requests are still waiting, then the callback
+/// goes to an overflow map.
+class CallbackTable
+{
+public:
+    explicit CallbackTable(size_t _slots = c_callbackSlots);
+
+    void add(uint32_t _seq, ResponseCallback::Ptr const& _callback);
+    ResponseCallback::Ptr get(uint32_t _seq);
+    /// remove the callback and return it, null if the response or the timeout already took it, so
+    /// that a callback is called only once
+    ResponseCallback::Ptr take(uint32_t _seq);
+    std::vector<ResponseCallback::Ptr> takeAll();
+
+    size_t size() const { return m_size + m_overflowSize; }
+
+private:
+    std::vector<ResponseCallback::Ptr> m_slots;
+    size_t m_mask;
+    std::atomic<size_t> m_size = {0};
+
+    Mutex x_overflow;
+    std::unordered_map<uint32_t, ResponseCallback::Ptr> m_overflow;
+    std::atomic<size_t> m_overflowSize = {0};
+};
+
+/// A hashed timing wheel turned by one timer of the host, so that a request with a timeout costs
+/// a push into the slot of its expiry tick instead of an asio timer. The timeouts aren't
+/// cancelled, a request answered in time is already out of the callback table when its timeout
+/// expires.
+class TimingWheel
+{
+public:
+    typedef std::shared_ptr<TimingWheel> Ptr;
+
+    TimingWheel(uint64_t _tick = c_timingWheelTick, size_t _slots = c_timingWheelSlots);
+
+    /// call _handler on the tick _timeout milliseconds from now, rounded up to a tick
+    void add(uint64_t _timeout, std::function<void()> const& _handler);
+    /// advance one tick and call the expired handlers
+    void tick();
+
+    uint64_t tickInterval() const { return m_tick; }
+    size_t size();
+
+private:
+    struct Timeout
+    {
+        /// the turns of the wheel left before it expires
+        uint64_t rounds;
+        std::function<void()> handler;
+    };
+
+    uint64_t m_tick;
+    Mutex x_slots;
+    std::vector<std::vector<Timeout>> m_slots;
+    size_t m_current = 0;
+    size_t m_size = 0;
+};
+
+}  // namespace network
+}  // namespace dev
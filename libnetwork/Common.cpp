@@ -27,6 +27,65 @@ using namespace std;
 using namespace dev;
 using namespace dev::network;
 
+BufferPool::Ptr BufferPool::instance()
+{
+    /// the payloads of the messages up to 64KB, the bigger ones are rare
+    static BufferPool::Ptr pool = std::make_shared<BufferPool>(4096, 64 * 1024);
+    return pool;
+}
+
+std::shared_ptr<bytes> BufferPool::get(size_t _size)
+{
+    std::unique_ptr<bytes> buffer;
+    {
+        Guard l(x_buffers);
+        if (!m_buffers.empty())
+        {
+            buffer = std::move(m_buffers.back());
+            m_buffers.pop_back();
+        }
+    }
+    if (!buffer)
+    {
+        buffer.reset(new bytes());
+    }
+    buffer->clear();
+    buffer->reserve(_size);
+    /// the buffer outliving the pool is freed
+    std::weak_ptr<BufferPool> pool = shared_from_this();
+    return std::shared_ptr<bytes>(buffer.release(), [pool](bytes* _buffer) {
+        auto p = pool.lock();
+        if (p)
+        {
+            p->release(_buffer);
+        }
+        else
+        {
+            delete _buffer;
+        }
+    });
+}
+
+size_t BufferPool::size()
+{
+    Guard l(x_buffers);
+    return m_buffers.size();
+}
+
+void BufferPool::release(bytes* _buffer)
+{
+    std::unique_ptr<bytes> buffer(_buffer);
+    if (buffer->capacity() > m_maxBufferSize)
+    {
+        return;
+    }
+    Guard l(x_buffers);
+    if (m_buffers.size() < m_maxBuffers)
+    {
+        m_buffers.push_back(std::move(buffer));
+    }
+}
+
 namespace dev
 {
 std::ostream& operator<<(std::ostream& _out, NodeIPEndpoint const& _ep)
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -97,6 +99,24 @@ enum P2PExceptionType
     ALL,
 };
 
+/// the queued messages of a session are written in the order of their priorities
+enum MessagePriority
+{
+    GossipPriority = 0,
+    SyncPriority,
+    ConsensusPriority,
+    MessagePriorityCount
+};
+
+/// bytes gathered into one write of a session
+static const size_t c_maxWriteBytes = 256 * 1024;
+/// the messages smaller than it are copied together into batches of at most a TLS record, since
+/// the ssl stream makes a record and a socket write of each buffer of a gathered write
+static const size_t c_batchMessageBytes = 1024;
+static const size_t c_maxBatchBytes = 16 * 1024;
+/// bytes queued to be written to a session, the gossip messages beyond it are dropped
+static const size_t c_maxWriteQueueBytes = 32 * 1024 * 1024;
+
 enum PacketDecodeStatus
 {
     PACKET_ERROR = -1,
@@ -120,6 +140,61 @@ struct NodeInfo
     std::string nodeName;
 };
 
+/// The number and the time cost of the TLS handshakes of a server or a host. A resumed handshake
+/// reuses the master secret of an earlier session and skips the certificate exchange and the
+/// key exchange (SM2 under GM TLS), so it only costs symmetric cryptography.
+class HandshakeStat
+{
+public:
+    void record(uint64_t _timeCost, bool _resumed)
+    {
+        ++m_count;
+        if (_resumed)
+        {
+            ++m_resumed;
+        }
+        m_timeCost += _timeCost;
+    }
+    uint64_t count() const { return m_count; }
+    uint64_t resumed() const { return m_resumed; }
+    /// in microseconds
+    uint64_t averageTimeCost() const { return m_count ? m_timeCost / m_count : 0; }
+
+private:
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_resumed{0};
+    std::atomic<uint64_t> m_timeCost{0};
+};
+
+/// Recycles the payloads of the received messages. A payload taken from the pool goes back to it
+/// when the last message holding it is released, so the buffers are allocated once per peak of
+/// messages in flight instead of once per message.
+class BufferPool : public std::enable_shared_from_this<BufferPool>
+{
+public:
+    typedef std::shared_ptr<BufferPool> Ptr;
+
+    /// buffers larger than _maxBufferSize are freed instead of pooled
+    BufferPool(size_t _maxBuffers, size_t _maxBufferSize)
+      : m_maxBuffers(_maxBuffers), m_maxBufferSize(_maxBufferSize)
+    {}
+    /// the pool of the payloads of all the sessions
+    static Ptr instance();
+
+    /// an empty buffer with room for _size bytes
+    std::shared_ptr<bytes> get(size_t _size);
+    /// buffers waiting to be reused
+    size_t size();
+
+private:
+    void release(bytes* _buffer);
+
+    size_t m_maxBuffers;
+    size_t m_maxBufferSize;
+    Mutex x_buffers;
+    std::vector<std::unique_ptr<bytes>> m_buffers;
+};
+
 class Message : public std::enable_shared_from_this<Message>
 {
 public:
@@ -131,8 +206,17 @@ public:
     virtual uint32_t seq() = 0;
 
     virtual bool isRequestPacket() = 0;
+    virtual MessagePriority priority() { return SyncPriority; }
 
     virtual void encode(bytes& buffer) = 0;
+    /// the encoded message, a message sent to several sessions may hand them the same buffer so
+    /// it mustn't be modified
+    virtual std::shared_ptr<bytes> encodedData()
+    {
+        auto data = std::make_shared<bytes>();
+        encode(*data);
+        return data;
+    }
     virtual ssize_t decode(const byte* buffer, size_t size) = 0;
 };
 
@@ -36,6 +36,7 @@
  */
 #include "Host.h"
 
+#include <libdevcore/Affinity.h>
 #include <libdevcore/Assertions.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonIO.h>
@@ -106,7 +107,7 @@ void Host::startAccept(boost::system::error_code boost_error)
                 m_asioInterface->setVerifyCallback(socket, newVerifyCallback(endpointPublicKey));
                 m_asioInterface->asyncHandshake(socket, ba::ssl::stream_base::server,
                     boost::bind(&Host::handshakeServer, shared_from_this(), ba::placeholders::error,
-                        endpointPublicKey, socket));
+                        endpointPublicKey, socket, utcTimeUs()));
 
                 startAccept();
             },
@@ -143,79 +144,17 @@ std::function<bool(bool, boost::asio::ssl::verify_context&)> Host::newVerifyCall
                 HOST_LOG(ERROR) << LOG_DESC("Get cert failed");
                 return preverified;
             }
-
-            int crit = 0;
-            BASIC_CONSTRAINTS* basic =
-                (BASIC_CONSTRAINTS*)X509_get_ext_d2i(cert, NID_basic_constraints, &crit, NULL);
-            if (!basic)
-            {
-                HOST_LOG(ERROR) << LOG_DESC("Get ca basic failed");
-                return preverified;
-            }
-            /// ignore ca
-            if (basic->ca)
-            {
-                // ca or agency certificate
-                HOST_LOG(TRACE) << LOG_DESC("Ignore CA certificate");
-                return preverified;
-            }
-            EVP_PKEY* evpPublicKey = X509_get_pubkey(cert);
-            if (!evpPublicKey)
-            {
-                HOST_LOG(ERROR) << LOG_DESC("Get evpPublicKey failed");
-                return preverified;
-            }
-
-            ec_key_st* ecPublicKey = EVP_PKEY_get1_EC_KEY(evpPublicKey);
-            if (!ecPublicKey)
+            /// the CA certificates in the chain are ignored
+            std::string nodeInfo = host->certNodeInfo(cert);
+            if (nodeInfo.empty())
             {
-                HOST_LOG(ERROR) << LOG_DESC("Get ecPublicKey failed");
                 return preverified;
             }
-            /// get public key of the certificate
-            const EC_POINT* ecPoint = EC_KEY_get0_public_key(ecPublicKey);
-            if (!ecPoint)
+            nodeIDOut->assign(nodeInfo);
+            if (host->isBlacklisted(nodeInfo))
             {
-                HOST_LOG(ERROR) << LOG_DESC("Get ecPoint failed");
-                return preverified;
-            }
-
-            std::shared_ptr<char> hex =
-                std::shared_ptr<char>(EC_POINT_point2hex(EC_KEY_get0_group(ecPublicKey), ecPoint,
-                                          EC_KEY_get_conv_form(ecPublicKey), NULL),
-                    [](char* p) { OPENSSL_free(p); });
-
-            if (hex)
-            {
-                nodeIDOut->assign(hex.get());
-                if (nodeIDOut->find("04") == 0)
-                {
-                    /// remove 04
-                    nodeIDOut->erase(0, 2);
-                }
-            }
-
-            /// check nodeID in certBlacklist, only filter by nodeID.
-            const std::vector<std::string>& certBlacklist = host->certBlacklist();
-            std::string nodeID = boost::to_upper_copy(*nodeIDOut);
-            if (find(certBlacklist.begin(), certBlacklist.end(), nodeID) != certBlacklist.end())
-            {
-                HOST_LOG(INFO) << LOG_DESC("NodeID in certificate rejected list")
-                               << LOG_KV("nodeID", nodeID.substr(0, 4));
                 return false;
             }
-            /// append cert-name and issuer name after node ID
-            /// get subject name
-            const char* certName = X509_NAME_oneline(X509_get_subject_name(cert), NULL, 0);
-            /// get issuer name
-            const char* issuerName = X509_NAME_oneline(X509_get_issuer_name(cert), NULL, 0);
-            /// format: {nodeID}#{issuer-name}#{cert-name}
-            nodeIDOut->append("#");
-            nodeIDOut->append(issuerName);
-            nodeIDOut->append("#");
-            nodeIDOut->append(certName);
-            OPENSSL_free((void*)certName);
-            OPENSSL_free((void*)issuerName);
             return preverified;
         }
         catch (std::exception& e)
@@ -226,6 +165,162 @@ std::function<bool(bool, boost::asio::ssl::verify_context&)> Host::newVerifyCall
     };
 }
 
+/**
+ * @brief: obtain the node info from the certificate of a node
+ * @return std::string: {nodeID}#{issuer-name}#{cert-name}, empty for the CA certificates and the
+ * certificates without an EC public key
+ */
+std::string Host::certNodeInfo(X509* cert)
+{
+    int crit = 0;
+    BASIC_CONSTRAINTS* basic =
+        (BASIC_CONSTRAINTS*)X509_get_ext_d2i(cert, NID_basic_constraints, &crit, NULL);
+    if (!basic)
+    {
+        HOST_LOG(ERROR) << LOG_DESC("Get ca basic failed");
+        return std::string();
+    }
+    /// ignore ca
+    bool isCA = basic->ca;
+    BASIC_CONSTRAINTS_free(basic);
+    if (isCA)
+    {
+        // ca or agency certificate
+        HOST_LOG(TRACE) << LOG_DESC("Ignore CA certificate");
+        return std::string();
+    }
+    std::shared_ptr<EVP_PKEY> evpPublicKey(
+        X509_get_pubkey(cert), [](EVP_PKEY* p) { EVP_PKEY_free(p); });
+    if (!evpPublicKey)
+    {
+        HOST_LOG(ERROR) << LOG_DESC("Get evpPublicKey failed");
+        return std::string();
+    }
+
+    std::shared_ptr<ec_key_st> ecPublicKey(
+        EVP_PKEY_get1_EC_KEY(evpPublicKey.get()), [](ec_key_st* p) { EC_KEY_free(p); });
+    if (!ecPublicKey)
+    {
+        HOST_LOG(ERROR) << LOG_DESC("Get ecPublicKey failed");
+        return std::string();
+    }
+    /// get public key of the certificate
+    const EC_POINT* ecPoint = EC_KEY_get0_public_key(ecPublicKey.get());
+    if (!ecPoint)
+    {
+        HOST_LOG(ERROR) << LOG_DESC("Get ecPoint failed");
+        return std::string();
+    }
+
+    std::shared_ptr<char> hex =
+        std::shared_ptr<char>(EC_POINT_point2hex(EC_KEY_get0_group(ecPublicKey.get()), ecPoint,
+                                  EC_KEY_get_conv_form(ecPublicKey.get()), NULL),
+            [](char* p) { OPENSSL_free(p); });
+    if (!hex)
+    {
+        return std::string();
+    }
+    std::string nodeInfo(hex.get());
+    if (nodeInfo.find("04") == 0)
+    {
+        /// remove 04
+        nodeInfo.erase(0, 2);
+    }
+    /// append cert-name and issuer name after node ID
+    /// get subject name
+    const char* certName = X509_NAME_oneline(X509_get_subject_name(cert), NULL, 0);
+    /// get issuer name
+    const char* issuerName = X509_NAME_oneline(X509_get_issuer_name(cert), NULL, 0);
+    /// format: {nodeID}#{issuer-name}#{cert-name}
+    nodeInfo.append("#");
+    nodeInfo.append(issuerName);
+    nodeInfo.append("#");
+    nodeInfo.append(certName);
+    OPENSSL_free((void*)certName);
+    OPENSSL_free((void*)issuerName);
+    return nodeInfo;
+}
+
+/// check nodeID in certBlacklist, only filter by nodeID.
+bool Host::isBlacklisted(std::string const& nodeInfo)
+{
+    const std::vector<std::string>& blacklist = certBlacklist();
+    std::string nodeID = boost::to_upper_copy(nodeInfo.substr(0, nodeInfo.find('#')));
+    if (find(blacklist.begin(), blacklist.end(), nodeID) != blacklist.end())
+    {
+        HOST_LOG(INFO) << LOG_DESC("NodeID in certificate rejected list")
+                       << LOG_KV("nodeID", nodeID.substr(0, 4));
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief: the certificates aren't verified again when a session is resumed, the node info is
+ *         obtained from the certificate of the peer kept by the session instead
+ * @return bool: false if the node info can't be obtained or the node is rejected
+ */
+bool Host::onHandshakeSucceed(std::shared_ptr<SocketFace> socket,
+    std::shared_ptr<std::string>& endpointPublicKey, uint64_t startTime)
+{
+    SSL* ssl = socket->sslref().native_handle();
+    bool resumed = SSL_session_reused(ssl);
+    m_handshakeStat.record(utcTimeUs() - startTime, resumed);
+    HOST_LOG(DEBUG) << LOG_DESC("SSL handshake succeed")
+                    << LOG_KV("endpoint", socket->nodeIPEndpoint().name())
+                    << LOG_KV("resumed", resumed)
+                    << LOG_KV("timeCost(us)", utcTimeUs() - startTime)
+                    << LOG_KV("handshakes", m_handshakeStat.count())
+                    << LOG_KV("resumedHandshakes", m_handshakeStat.resumed())
+                    << LOG_KV("avgTimeCost(us)", m_handshakeStat.averageTimeCost());
+    if (resumed && endpointPublicKey->empty())
+    {
+        std::shared_ptr<X509> cert(
+            SSL_get_peer_certificate(ssl), [](X509* p) { X509_free(p); });
+        if (cert)
+        {
+            std::string nodeInfo = certNodeInfo(cert.get());
+            if (!nodeInfo.empty() && !isBlacklisted(nodeInfo))
+            {
+                endpointPublicKey->assign(nodeInfo);
+            }
+        }
+    }
+    return !endpointPublicKey->empty();
+}
+
+/// the session of the last connection to the endpoint, resumed by the next connection
+void Host::resumeSSLSession(std::shared_ptr<SocketFace> socket, NodeIPEndpoint const& endpoint)
+{
+    Guard l(x_sslSessions);
+    auto it = m_sslSessions.find(endpoint.name());
+    if (it != m_sslSessions.end())
+    {
+        SSL_set_session(socket->sslref().native_handle(), it->second.get());
+    }
+}
+
+void Host::saveSSLSession(std::shared_ptr<SocketFace> socket, NodeIPEndpoint const& endpoint)
+{
+    std::shared_ptr<SSL_SESSION> session(SSL_get1_session(socket->sslref().native_handle()),
+        [](SSL_SESSION* p) { SSL_SESSION_free(p); });
+    Guard l(x_sslSessions);
+    if (session)
+    {
+        m_sslSessions[endpoint.name()] = session;
+    }
+    else
+    {
+        m_sslSessions.erase(endpoint.name());
+    }
+}
+
+void Host::eraseSSLSession(NodeIPEndpoint const& endpoint)
+{
+    Guard l(x_sslSessions);
+    m_sslSessions.erase(endpoint.name());
+}
+
 /**
  * @brief: obtain the common name from the subject of certificate
  *
@@ -283,9 +378,11 @@ void Host::obtainNodeInfo(NodeInfo& info, std::string const& node_info)
  * @param error: error information triggered in the procedure of ssl handshake
  * @param endpointPublicKey: public key obtained from certificate during handshake
  * @param socket: socket related to the endpoint of the connected client
+ * @param startTime: the time the ssl handshake started, in microseconds
  */
 void Host::handshakeServer(const boost::system::error_code& error,
-    std::shared_ptr<std::string>& endpointPublicKey, std::shared_ptr<SocketFace> socket)
+    std::shared_ptr<std::string>& endpointPublicKey, std::shared_ptr<SocketFace> socket,
+    uint64_t startTime)
 {
     if (error)
     {
@@ -296,7 +393,7 @@ void Host::handshakeServer(const boost::system::error_code& error,
         socket->close();
         return;
     }
-    if (endpointPublicKey->empty())
+    if (!onHandshakeSucceed(socket, endpointPublicKey, startTime))
     {
         HOST_LOG(WARNING) << LOG_DESC("handshakeServer get nodeID failed")
                           << LOG_KV("endpoint", socket->nodeIPEndpoint().name());
@@ -361,8 +458,10 @@ void Host::start()
     {
         m_run = true;
         m_asioInterface->init(m_listenHost, m_listenPort);
+        startTimingWheel();
         m_hostThread = std::make_shared<std::thread>([&] {
             dev::pthread_setThreadName("io_service");
+            g_cpuAffinity.bindThread("io_service");
             while (haveNetwork())
             {
                 try
@@ -384,9 +483,45 @@ void Host::start()
 
             HOST_LOG(INFO) << "Host exit";
         });
+        for (auto const& ioService : m_asioInterface->sessionIOServices())
+        {
+            m_sessionThreads.push_back(std::make_shared<std::thread>([this, ioService] {
+                dev::pthread_setThreadName("io_session");
+                g_cpuAffinity.bindThread("io_session");
+                /// keep the io_service running while no session is on it
+                ba::io_service::work work(*ioService);
+                while (haveNetwork())
+                {
+                    try
+                    {
+                        ioService->run();
+                    }
+                    catch (std::exception& e)
+                    {
+                        HOST_LOG(WARNING) << LOG_DESC("Exception in session io thread:")
+                                          << boost::diagnostic_information(e);
+                    }
+                }
+            }));
+        }
     }
 }
 
+void Host::startTimingWheel()
+{
+    auto timer = m_asioInterface->newTimer(m_timingWheel->tickInterval());
+    auto host = std::weak_ptr<Host>(shared_from_this());
+    timer->async_wait([host, timer](boost::system::error_code const& error) {
+        auto self = host.lock();
+        if (!self || !self->haveNetwork() || error == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        self->m_timingWheel->tick();
+        self->startTimingWheel();
+    });
+}
+
 /**
  * @brief : connect to the server
  * @param _nodeIPEndpoint : the endpoint of the connected server
@@ -413,7 +548,7 @@ void Host::asyncConnect(NodeIPEndpoint const& _nodeIPEndpoint,
 
     /// if async connect timeout, close the socket directly
     auto connect_timer = std::make_shared<boost::asio::deadline_timer>(
-        *(m_asioInterface->ioService()), boost::posix_time::milliseconds(m_connectTimeThre));
+        socket->ref().get_io_service(), boost::posix_time::milliseconds(m_connectTimeThre));
     connect_timer->async_wait([=](const boost::system::error_code& error) {
         /// return when cancel has been called
         if (error == boost::asio::error::operation_aborted)
@@ -458,10 +593,13 @@ void Host::asyncConnect(NodeIPEndpoint const& _nodeIPEndpoint,
                 /// get the public key of the server during handshake
                 std::shared_ptr<std::string> endpointPublicKey = std::make_shared<std::string>();
                 m_asioInterface->setVerifyCallback(socket, newVerifyCallback(endpointPublicKey));
+                /// resume the last session to the node to skip the key exchange
+                resumeSSLSession(socket, _nodeIPEndpoint);
                 /// call handshakeClient after handshake succeed
                 m_asioInterface->asyncHandshake(socket, ba::ssl::stream_base::client,
                     boost::bind(&Host::handshakeClient, shared_from_this(), ba::placeholders::error,
-                        socket, endpointPublicKey, callback, _nodeIPEndpoint, connect_timer));
+                        socket, endpointPublicKey, callback, _nodeIPEndpoint, connect_timer,
+                        utcTimeUs()));
             }
         });
 }
@@ -472,11 +610,13 @@ void Host::asyncConnect(NodeIPEndpoint const& _nodeIPEndpoint,
  * @param socket : ssl socket
  * @param endpointPublicKey: public key of the server obtained from the certificate
  * @param _nodeIPEndpoint : endpoint of the server to connect
+ * @param startTime: the time the ssl handshake started, in microseconds
  */
 void Host::handshakeClient(const boost::system::error_code& error,
     std::shared_ptr<SocketFace> socket, std::shared_ptr<std::string>& endpointPublicKey,
     std::function<void(NetworkException, NodeInfo const&, std::shared_ptr<SessionFace>)> callback,
-    NodeIPEndpoint _nodeIPEndpoint, std::shared_ptr<boost::asio::deadline_timer> timerPtr)
+    NodeIPEndpoint _nodeIPEndpoint, std::shared_ptr<boost::asio::deadline_timer> timerPtr,
+    uint64_t startTime)
 {
     timerPtr->cancel();
     erasePendingConns(_nodeIPEndpoint);
@@ -486,6 +626,8 @@ void Host::handshakeClient(const boost::system::error_code& error,
                           << LOG_KV("endpoint", _nodeIPEndpoint.name())
                           << LOG_KV("errorValue", error.value())
                           << LOG_KV("message", error.message());
+        /// the cached session may be rejected by the node, fall back to a full handshake
+        eraseSSLSession(_nodeIPEndpoint);
 
         if (socket->isConnected())
         {
@@ -493,13 +635,15 @@ void Host::handshakeClient(const boost::system::error_code& error,
         }
         return;
     }
-    if (endpointPublicKey->empty())
+    if (!onHandshakeSucceed(socket, endpointPublicKey, startTime))
     {
         HOST_LOG(WARNING) << LOG_DESC("handshakeClient get nodeID failed")
                           << LOG_KV("endpoint", socket->nodeIPEndpoint().name());
+        eraseSSLSession(_nodeIPEndpoint);
         socket->close();
         return;
     }
+    saveSSLSession(socket, _nodeIPEndpoint);
 
     if (m_run)
     {
@@ -520,5 +664,10 @@ void Host::stop()
     m_run = false;
     m_asioInterface->stop();
     m_hostThread->join();
+    for (auto const& thread : m_sessionThreads)
+    {
+        thread->join();
+    }
+    m_sessionThreads.clear();
     m_threadPool->stop();
 }
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "ASIOInterface.h"
+#include "CallbackTable.h"
 #include "Common.h"
 #include "Session.h"
 #include "SessionFace.h"
@@ -113,15 +114,36 @@ public:
     }
     virtual const std::vector<std::string>& certBlacklist() const { return m_certBlacklist; }
 
+    /// the ssl handshakes of the connections accepted and connected
+    HandshakeStat const& handshakeStat() const { return m_handshakeStat; }
+
+    /// the timeouts of the requests of all the sessions
+    virtual TimingWheel::Ptr timingWheel() const { return m_timingWheel; }
+
 private:
     /// called by 'startedWorking' to accept connections
     void startAccept(boost::system::error_code ec = boost::system::error_code());
+    /// turn the timing wheel every tick on the io_service of the host
+    void startTimingWheel();
     /// functions called after openssl handshake,
     /// maily to get node id and verify whether the certificate has been expired
     /// @return: node id of the connected peer
     std::function<bool(bool, boost::asio::ssl::verify_context&)> newVerifyCallback(
         std::shared_ptr<std::string> nodeIDOut);
 
+    /// obtain {nodeID}#{issuer-name}#{cert-name} from a node certificate, empty for the CA ones
+    std::string certNodeInfo(X509* cert);
+    bool isBlacklisted(std::string const& nodeInfo);
+    /// record the handshake and obtain the node info of a resumed session from the peer
+    /// certificate, since the verify callback isn't called when a session is resumed
+    bool onHandshakeSucceed(std::shared_ptr<SocketFace> socket,
+        std::shared_ptr<std::string>& endpointPublicKey, uint64_t startTime);
+
+    /// the client side of the session resumption, the sessions are cached by endpoint
+    void resumeSSLSession(std::shared_ptr<SocketFace> socket, NodeIPEndpoint const& endpoint);
+    void saveSSLSession(std::shared_ptr<SocketFace> socket, NodeIPEndpoint const& endpoint);
+    void eraseSSLSession(NodeIPEndpoint const& endpoint);
+
     /// obtain the common name from the subject:
     /// the subject format is: /CN=xx/O=xxx/OU=xxx/ commonly
     std::string obtainCommonNameFromSubject(std::string const& subject);
@@ -133,7 +155,8 @@ private:
     /// informations(client version, caps, etc),start peer session and start accepting procedure
     /// repeatedly
     void handshakeServer(const boost::system::error_code& error,
-        std::shared_ptr<std::string>& endpointPublicKey, std::shared_ptr<SocketFace> socket);
+        std::shared_ptr<std::string>& endpointPublicKey, std::shared_ptr<SocketFace> socket,
+        uint64_t startTime);
 
     void startPeerSession(NodeInfo const& nodeInfo, std::shared_ptr<SocketFace> const& socket,
         std::function<void(NetworkException, NodeInfo const&, std::shared_ptr<SessionFace>)>
@@ -143,7 +166,8 @@ private:
         std::shared_ptr<std::string>& endpointPublicKey,
         std::function<void(NetworkException, NodeInfo const&, std::shared_ptr<SessionFace>)>
             callback,
-        NodeIPEndpoint _nodeIPEndpoint, std::shared_ptr<boost::asio::deadline_timer> timerPtr);
+        NodeIPEndpoint _nodeIPEndpoint, std::shared_ptr<boost::asio::deadline_timer> timerPtr,
+        uint64_t startTime);
 
     void erasePendingConns(NodeIPEndpoint const& _nodeIPEndpoint)
     {
@@ -167,6 +191,11 @@ private:
     int m_connectTimeThre = 50000;
     std::set<std::string> m_pendingConns;
     Mutex x_pendingConns;
+    /// the last ssl session to each endpoint connected
+    std::map<std::string, std::shared_ptr<SSL_SESSION>> m_sslSessions;
+    Mutex x_sslSessions;
+    HandshakeStat m_handshakeStat;
+    TimingWheel::Ptr m_timingWheel = std::make_shared<TimingWheel>();
 
     MessageFactory::Ptr m_messageFactory;
 
@@ -179,6 +208,8 @@ private:
     bool m_run = false;
 
     std::shared_ptr<std::thread> m_hostThread;
+    /// run the io_services of the sessions
+    std::vector<std::shared_ptr<std::thread>> m_sessionThreads;
 
     // certificate rejected list of nodeID
     std::vector<std::string> m_certBlacklist;
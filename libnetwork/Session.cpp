@@ -32,15 +32,16 @@
 #include <libdevcore/CommonJS.h>
 #include <libdevcore/Exceptions.h>
 #include <libdevcore/easylog.h>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 
 using namespace dev;
 using namespace dev::network;
 
 Session::Session(size_t _bufferSize) : bufferSize(_bufferSize)
 {
-    m_recvBuffer.resize(bufferSize);
-    m_seq2Callback = std::make_shared<std::unordered_map<uint32_t, ResponseCallback::Ptr>>();
+    m_data.resize(bufferSize);
 }
 
 Session::~Session()
@@ -93,28 +94,27 @@ void Session::asyncSendMessage(Message::Ptr message, Options options, CallbackFu
     {
         auto handler = std::make_shared<ResponseCallback>();
         handler->callbackFunc = callback;
+        addSeqCallback(message->seq(), handler);
         if (options.timeout > 0)
         {
-            std::shared_ptr<boost::asio::deadline_timer> timeoutHandler =
-                server->asioInterface()->newTimer(options.timeout);
-
-            auto session = std::weak_ptr<Session>(shared_from_this());
-            timeoutHandler->async_wait(boost::bind(&Session::onTimeout, shared_from_this(),
-                boost::asio::placeholders::error, message->seq()));
-
-            handler->timeoutHandler = timeoutHandler;
             handler->m_startTime = utcTime();
+            auto session = std::weak_ptr<Session>(shared_from_this());
+            uint32_t seq = message->seq();
+            server->timingWheel()->add(options.timeout, [session, seq]() {
+                auto s = session.lock();
+                if (s)
+                {
+                    s->onTimeout(seq);
+                }
+            });
         }
-        addSeqCallback(message->seq(), handler);
     }
     SESSION_LOG(TRACE) << LOG_DESC("Session asyncSendMessage")
-                       << LOG_KV("seq2Callback.size", m_seq2Callback->size());
-    std::shared_ptr<bytes> p_buffer = std::make_shared<bytes>();
-    message->encode(*p_buffer);
-    send(p_buffer);
+                       << LOG_KV("callbacks", m_callbacks.size());
+    send(message->encodedData(), message->priority());
 }
 
-void Session::send(std::shared_ptr<bytes> _msg)
+void Session::send(std::shared_ptr<bytes> _msg, MessagePriority _priority)
 {
     if (!actived())
     {
@@ -124,17 +124,27 @@ void Session::send(std::shared_ptr<bytes> _msg)
     if (!m_socket->isConnected())
         return;
 
-    SESSION_LOG(TRACE) << "send" << LOG_KV("writeQueue size", m_writeQueue.size());
     {
         Guard l(x_writeQueue);
-
-        m_writeQueue.push(make_pair(_msg, u256(utcTime())));
+        /// the gossip is dropped rather than queued behind a slow peer, the peers recover it
+        if (_priority == GossipPriority &&
+            m_writeQueueBytes + _msg->size() > c_maxWriteQueueBytes)
+        {
+            SESSION_LOG(DEBUG) << LOG_DESC("drop gossip message for the write queue is full")
+                               << LOG_KV("queuedBytes", m_writeQueueBytes)
+                               << LOG_KV("endpoint", nodeIPEndpoint().name());
+            return;
+        }
+        m_writeQueue[_priority].push_back(_msg);
+        m_writeQueueBytes += _msg->size();
+        SESSION_LOG(TRACE) << "send" << LOG_KV("queuedBytes", m_writeQueueBytes);
     }
 
     write();
 }
 
-void Session::onWrite(boost::system::error_code ec, std::size_t, std::shared_ptr<bytes>)
+void Session::onWrite(boost::system::error_code ec, std::size_t,
+    std::shared_ptr<std::vector<std::shared_ptr<bytes>>> buffers)
 {
     if (!actived())
     {
@@ -153,6 +163,10 @@ void Session::onWrite(boost::system::error_code ec, std::size_t, std::shared_ptr
         }
         {
             Guard l(x_writeQueue);
+            for (auto const& buffer : *buffers)
+            {
+                m_writeQueueBytes -= buffer->size();
+            }
             if (m_writing)
             {
                 m_writing = false;
@@ -186,33 +200,64 @@ void Session::write()
             return;
         }
 
-        m_writing = true;
-
-        std::pair<std::shared_ptr<bytes>, u256> task;
-        u256 enter_time = u256(0);
-
-        if (m_writeQueue.empty())
+        auto buffers = std::make_shared<std::vector<std::shared_ptr<bytes>>>();
+        /// the small messages in a row are batched into one buffer, written as one TLS record,
+        /// the receiver decodes them one after another as usual
+        std::shared_ptr<bytes> batch;
+        size_t size = 0;
+        bool full = false;
+        for (int priority = ConsensusPriority; priority >= GossipPriority && !full; --priority)
+        {
+            auto& queue = m_writeQueue[priority];
+            while (!queue.empty())
+            {
+                auto const& buffer = queue.front();
+                /// a buffer larger than the limit is written alone
+                if (size > 0 && size + buffer->size() > c_maxWriteBytes)
+                {
+                    full = true;
+                    break;
+                }
+                size += buffer->size();
+                if (buffer->size() >= c_batchMessageBytes)
+                {
+                    batch.reset();
+                    buffers->push_back(buffer);
+                }
+                else
+                {
+                    if (!batch || batch->size() + buffer->size() > c_maxBatchBytes)
+                    {
+                        batch = std::make_shared<bytes>();
+                        batch->reserve(c_maxBatchBytes);
+                        buffers->push_back(batch);
+                    }
+                    batch->insert(batch->end(), buffer->begin(), buffer->end());
+                }
+                queue.pop_front();
+            }
+        }
+        if (buffers->empty())
         {
-            m_writing = false;
             return;
         }
+        m_writing = true;
+        std::vector<boost::asio::const_buffer> gathered;
+        for (auto const& buffer : *buffers)
+        {
+            gathered.push_back(boost::asio::buffer(*buffer));
+        }
 
-        task = m_writeQueue.top();
-        m_writeQueue.pop();
-
-        enter_time = task.second;
         auto session = shared_from_this();
-        auto buffer = task.first;
-
         auto server = m_server.lock();
         if (server && server->haveNetwork())
         {
             if (m_socket->isConnected())
             {
-                // asio::buffer referecne buffer, so buffer need alive before asio::buffer be used
-                server->asioInterface()->asyncWrite(m_socket, boost::asio::buffer(*buffer),
+                // the gathered buffers are kept alive by the handler until they're written
+                server->asioInterface()->asyncWrite(m_socket, gathered,
                     boost::bind(&Session::onWrite, session, boost::asio::placeholders::error,
-                        boost::asio::placeholders::bytes_transferred, buffer));
+                        boost::asio::placeholders::bytes_transferred, buffers));
             }
             else
             {
@@ -254,26 +299,19 @@ void Session::drop(DisconnectReason _reason)
     }
 
     SESSION_LOG(INFO) << "drop, call and erase all callbackFunc in this session!";
-    RecursiveGuard l(x_seq2Callback);
-    for (auto& it : *m_seq2Callback)
+    for (auto const& callback : m_callbacks.takeAll())
     {
-        if (it.second->timeoutHandler)
-        {
-            it.second->timeoutHandler->cancel();
-        }
-        if (it.second->callbackFunc)
+        if (callback->callbackFunc)
         {
-            SESSION_LOG(TRACE) << "drop, call callbackFunc by seq" << LOG_KV("seq", it.first);
+            SESSION_LOG(TRACE) << "drop, call callbackFunc by seq" << LOG_KV("seq", callback->seq);
             if (server)
             {
-                auto callback = it.second;
                 server->threadPool()->enqueue([callback, errorCode, errorMsg]() {
                     callback->callbackFunc(NetworkException(errorCode, errorMsg), Message::Ptr());
                 });
             }
         }
     }
-    clearSeqCallback();
 
     if (server && m_messageHandler)
     {
@@ -400,19 +438,19 @@ void Session::doRead()
                     s->drop(TCPError);
                     return;
                 }
-                s->m_data.insert(s->m_data.end(), s->m_recvBuffer.begin(),
-                    s->m_recvBuffer.begin() + bytesTransferred);
+                s->m_dataEnd += bytesTransferred;
 
                 while (true)
                 {
                     Message::Ptr message = s->m_messageFactory->buildMessage();
-                    ssize_t result = message->decode(s->m_data.data(), s->m_data.size());
+                    ssize_t result = message->decode(
+                        s->m_data.data() + s->m_dataBegin, s->m_dataEnd - s->m_dataBegin);
                     if (result > 0)
                     {
                         /// SESSION_LOG(TRACE) << "Decode success: " << result;
                         NetworkException e(P2PExceptionType::Success, "Success");
                         s->onMessage(e, message);
-                        s->m_data.erase(s->m_data.begin(), s->m_data.begin() + result);
+                        s->m_dataBegin += result;
                     }
                     else if (result == 0)
                     {
@@ -434,8 +472,10 @@ void Session::doRead()
 
         if (m_socket->isConnected())
         {
-            server->asioInterface()->asyncReadSome(
-                m_socket, boost::asio::buffer(m_recvBuffer, m_recvBuffer.size()), asyncRead);
+            reserveRead();
+            server->asioInterface()->asyncReadSome(m_socket,
+                boost::asio::buffer(m_data.data() + m_dataEnd, m_data.size() - m_dataEnd),
+                asyncRead);
         }
         else
         {
@@ -446,6 +486,33 @@ void Session::doRead()
     }
 }
 
+void Session::reserveRead()
+{
+    if (m_dataBegin == m_dataEnd)
+    {
+        m_dataBegin = m_dataEnd = 0;
+        /// give back the room taken by a large message
+        if (m_data.size() > bufferSize * 16)
+        {
+            bytes(bufferSize).swap(m_data);
+        }
+    }
+    if (m_data.size() - m_dataEnd >= bufferSize)
+    {
+        return;
+    }
+    if (m_dataBegin > 0)
+    {
+        std::memmove(m_data.data(), m_data.data() + m_dataBegin, m_dataEnd - m_dataBegin);
+        m_dataEnd -= m_dataBegin;
+        m_dataBegin = 0;
+    }
+    if (m_data.size() - m_dataEnd < bufferSize)
+    {
+        m_data.resize(std::max(m_data.size() * 2, m_dataEnd + bufferSize));
+    }
+}
+
 bool Session::checkRead(boost::system::error_code _ec)
 {
     if (_ec && _ec.category() != boost::asio::error::get_misc_category() &&
@@ -465,32 +532,19 @@ void Session::onMessage(NetworkException const& e, Message::Ptr message)
     auto server = m_server.lock();
     if (m_actived && server && server->haveNetwork())
     {
-        ResponseCallback::Ptr callbackPtr = getCallbackBySeq(message->seq());
-        if (callbackPtr && !message->isRequestPacket())
+        /// taken out of the table so that its timeout finds nothing to call
+        ResponseCallback::Ptr callbackPtr;
+        if (!message->isRequestPacket())
+        {
+            callbackPtr = m_callbacks.take(message->seq());
+        }
+        if (callbackPtr)
         {
             /// SESSION_LOG(TRACE) << "Found callbackPtr: " << message->seq();
-
-            if (callbackPtr->timeoutHandler)
+            auto callback = callbackPtr->callbackFunc;
+            if (callback)
             {
-                callbackPtr->timeoutHandler->cancel();
-            }
-
-            if (callbackPtr->callbackFunc)
-            {
-                auto callback = callbackPtr->callbackFunc;
-                if (callback)
-                {
-                    auto self = std::weak_ptr<Session>(shared_from_this());
-                    server->threadPool()->enqueue([e, callback, self, message]() {
-                        callback(e, message);
-
-                        auto s = self.lock();
-                        if (s)
-                        {
-                            s->removeSeqCallback(message->seq());
-                        }
-                    });
-                }
+                server->threadPool()->enqueue([e, callback, message]() { callback(e, message); });
             }
         }
         else
@@ -513,23 +567,16 @@ void Session::onMessage(NetworkException const& e, Message::Ptr message)
     }
 }
 
-void Session::onTimeout(const boost::system::error_code& error, uint32_t seq)
+void Session::onTimeout(uint32_t seq)
 {
-    if (error)
-    {
-        SESSION_LOG(TRACE) << "timer cancel" << error;
-        return;
-    }
-
     auto server = m_server.lock();
     if (!server)
         return;
-    ResponseCallback::Ptr callbackPtr = getCallbackBySeq(seq);
+    ResponseCallback::Ptr callbackPtr = m_callbacks.take(seq);
     if (!callbackPtr)
         return;
-    server->threadPool()->enqueue([=]() {
+    server->threadPool()->enqueue([callbackPtr]() {
         NetworkException e(P2PExceptionType::NetworkTimeout, "NetworkTimeout");
         callbackPtr->callbackFunc(e, Message::Ptr());
-        removeSeqCallback(seq);
     });
 }
@@ -24,7 +24,6 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
-#include <boost/heap/priority_queue.hpp>
 #include <array>
 #include <deque>
 #include <memory>
@@ -32,6 +31,7 @@
 #include <set>
 #include <utility>
 
+#include "CallbackTable.h"
 #include "Common.h"
 #include "SessionFace.h"
 
@@ -61,6 +61,12 @@ public:
 
     virtual bool actived() const override;
 
+    virtual size_t writeQueueBytes() const override
+    {
+        Guard l(x_writeQueue);
+        return m_writeQueueBytes;
+    }
+
     virtual std::weak_ptr<Host> host() { return m_server; }
     virtual void setHost(std::weak_ptr<Host> host) { m_server = host; }
 
@@ -86,40 +92,25 @@ public:
 
     virtual void addSeqCallback(uint32_t seq, ResponseCallback::Ptr callback)
     {
-        RecursiveGuard l(x_seq2Callback);
-        m_seq2Callback->insert(std::make_pair(seq, callback));
-    }
-    virtual void removeSeqCallback(uint32_t seq)
-    {
-        RecursiveGuard l(x_seq2Callback);
-        m_seq2Callback->erase(seq);
-    }
-    virtual void clearSeqCallback()
-    {
-        RecursiveGuard l(x_seq2Callback);
-        m_seq2Callback->clear();
+        m_callbacks.add(seq, callback);
     }
+    virtual void removeSeqCallback(uint32_t seq) { m_callbacks.take(seq); }
+    virtual void clearSeqCallback() { m_callbacks.takeAll(); }
 
-    ResponseCallback::Ptr getCallbackBySeq(uint32_t seq)
-    {
-        RecursiveGuard l(x_seq2Callback);
-        auto it = m_seq2Callback->find(seq);
-        if (it != m_seq2Callback->end())
-        {
-            return it->second;
-        }
-        else
-        {
-            return NULL;
-        }
-    }
+    ResponseCallback::Ptr getCallbackBySeq(uint32_t seq) { return m_callbacks.get(seq); }
 
 private:
-    void send(std::shared_ptr<bytes> _msg);
+    void send(std::shared_ptr<bytes> _msg, MessagePriority _priority);
 
     void doRead();
-    std::vector<byte> m_data;  ///< Buffer for ingress packet data.
-    std::vector<byte> m_recvBuffer;
+    /// make room for a read after the undecoded bytes
+    void reserveRead();
+    /// Buffer for ingress packet data, the socket reads into it after the undecoded bytes in
+    /// [m_dataBegin, m_dataEnd) and the messages are decoded in place. The undecoded bytes are
+    /// moved to the front only when there's no room left for a read.
+    std::vector<byte> m_data;
+    size_t m_dataBegin = 0;
+    size_t m_dataEnd = 0;
     const size_t bufferSize;
 
     /// Drop the connection for the reason @a _r.
@@ -128,11 +119,14 @@ private:
     /// Check error code after reading and drop peer if error code.
     bool checkRead(boost::system::error_code _ec);
 
-    void onTimeout(const boost::system::error_code& error, uint32_t seq);
+    /// called by the timing wheel of the host, the request may have been answered meanwhile
+    void onTimeout(uint32_t seq);
 
     /// Perform a single round of the write operation. This could end up calling itself
     /// asynchronously.
-    void onWrite(boost::system::error_code ec, std::size_t length, std::shared_ptr<bytes> buffer);
+    void onWrite(boost::system::error_code ec, std::size_t length,
+        std::shared_ptr<std::vector<std::shared_ptr<bytes>>> buffers);
+    /// gather the queued buffers up to c_maxWriteBytes into one write, the higher priorities first
     void write();
 
     /// call by doRead() to deal with mesage
@@ -143,29 +137,19 @@ private:
 
     MessageFactory::Ptr m_messageFactory;
 
-    class QueueCompare
-    {
-    public:
-        bool operator()(const std::pair<std::shared_ptr<bytes>, u256>&,
-            const std::pair<std::shared_ptr<bytes>, u256>&) const
-        {
-            return false;
-        }
-    };
-
-    boost::heap::priority_queue<std::pair<std::shared_ptr<bytes>, u256>,
-        boost::heap::compare<QueueCompare>, boost::heap::stable<true>>
-        m_writeQueue;
+    /// the buffers waiting to be written, one FIFO per priority
+    std::array<std::deque<std::shared_ptr<bytes>>, MessagePriorityCount> m_writeQueue;
+    /// bytes queued and being written, the gossip messages beyond c_maxWriteQueueBytes are dropped
+    size_t m_writeQueueBytes = 0;
     bool m_writing = false;
-    Mutex x_writeQueue;
+    mutable Mutex x_writeQueue;
 
     mutable Mutex x_info;
 
     bool m_actived = false;
 
     ///< A call B, the function to call after the response is received by A.
-    mutable RecursiveMutex x_seq2Callback;
-    std::shared_ptr<std::unordered_map<uint32_t, ResponseCallback::Ptr>> m_seq2Callback;
+    CallbackTable m_callbacks;
 
     std::function<void(NetworkException, SessionFace::Ptr, Message::Ptr)> m_messageHandler;
     uint64_t m_shutDownTimeThres = 50000;
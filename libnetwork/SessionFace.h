@@ -43,7 +43,8 @@ struct ResponseCallback : public std::enable_shared_from_this<ResponseCallback>
 
     uint64_t m_startTime;
     CallbackFunc callbackFunc;
-    std::shared_ptr<boost::asio::deadline_timer> timeoutHandler;
+    /// the seq of the request, to tell it from the other requests of its slot
+    uint32_t seq = 0;
 };
 
 class SessionFace
@@ -68,6 +69,8 @@ public:
     virtual NodeIPEndpoint nodeIPEndpoint() const = 0;
 
     virtual bool actived() const = 0;
+    /// bytes queued and being written to the peer
+    virtual size_t writeQueueBytes() const = 0;
 };
 }  // namespace network
 }  // namespace dev
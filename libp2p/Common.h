@@ -28,11 +28,26 @@ using NodeIDs = std::vector<NodeID>;
 #define P2PMSG_LOG(LEVEL) LOG(LEVEL) << "[P2P][P2PMessage] "
 #define SERVICE_LOG(LEVEL) LOG(LEVEL) << "[P2P][Service] "
 
+/// the link to a peer seen from this node
+struct PeerStat
+{
+    /// the smoothed round trip time of the heartbeats in milliseconds, 0 before the first one
+    uint64_t rtt = 0;
+    uint64_t inBytes = 0;
+    uint64_t inMessages = 0;
+    /// bytes per second received during the last heartbeat interval
+    uint64_t inRate = 0;
+    uint64_t outBytes = 0;
+    uint64_t outMessages = 0;
+    size_t writeQueueBytes = 0;
+};
+
 struct P2PSessionInfo
 {
     dev::network::NodeInfo nodeInfo;
     dev::network::NodeIPEndpoint nodeIPEndpoint;
     std::set<std::string> topics;
+    PeerStat stat;
     P2PSessionInfo(dev::network::NodeInfo const& _nodeInfo,
         dev::network::NodeIPEndpoint const& _nodeIPEndpoint, std::set<std::string> const& _topics)
     {
@@ -23,6 +23,7 @@
 #include <libdevcore/FixedHash.h>
 #include <libnetwork/SessionFace.h>
 #include <libp2p/Common.h>
+#include <libp2p/P2PTraffic.h>
 #include <memory>
 
 #define CallbackFuncWithSession                                                               \
@@ -75,6 +76,10 @@ public:
     virtual P2PSessionInfos sessionInfosByProtocolID(PROTOCOL_ID _protocolID) const = 0;
 
     virtual bool isConnected(NodeID const& _nodeID) const = 0;
+    /// bytes queued to be written to the node, 0 if it isn't connected
+    virtual size_t writeQueueBytes(NodeID const& _nodeID) const = 0;
+    /// the traffic of each (group, module) since the node started
+    virtual TrafficStats trafficStats() = 0;
 
     virtual std::vector<std::string> topics() = 0;
 
@@ -22,6 +22,7 @@
 
 #include "P2PMessage.h"
 #include "Common.h"
+#include <cstdlib>
 
 using namespace dev;
 using namespace dev::p2p;
@@ -43,6 +44,34 @@ void P2PMessage::encode(bytes& buffer)
     buffer.insert(buffer.end(), m_buffer->begin(), m_buffer->end());
 }
 
+std::shared_ptr<bytes> P2PMessage::encodedData()
+{
+    if (m_dirty || !m_encoded)
+    {
+        /// a new buffer, the old one may still be queued by the sessions
+        auto encoded = std::make_shared<bytes>();
+        encoded->reserve(HEADER_LENGTH + m_buffer->size());
+        encode(*encoded);
+        m_encoded = encoded;
+        m_dirty = false;
+    }
+    return m_encoded;
+}
+
+dev::network::MessagePriority P2PMessage::priority()
+{
+    if (m_prioritySet)
+    {
+        return m_priority;
+    }
+    auto module = dev::eth::getGroupAndProtocol(abs(m_protocolID)).second;
+    if (module == dev::eth::ProtocolID::PBFT || module == dev::eth::ProtocolID::Raft)
+    {
+        return dev::network::ConsensusPriority;
+    }
+    return dev::network::SyncPriority;
+}
+
 ssize_t P2PMessage::decode(const byte* buffer, size_t size)
 {
     if (size < HEADER_LENGTH)
@@ -52,6 +81,10 @@ ssize_t P2PMessage::decode(const byte* buffer, size_t size)
 
     int32_t offset = 0;
     m_length = ntohl(*((uint32_t*)&buffer[offset]));
+    if (m_length < HEADER_LENGTH)
+    {
+        return dev::network::PACKET_ERROR;
+    }
 
     /*if (m_length > MAX_LENGTH)
     {
@@ -69,7 +102,7 @@ ssize_t P2PMessage::decode(const byte* buffer, size_t size)
     m_packetType = ntohs(*((PACKET_TYPE*)&buffer[offset]));
     offset += 2;
     m_seq = ntohl(*((uint32_t*)&buffer[offset]));
-    ///< TODO: assign to std::move
+    m_buffer = dev::network::BufferPool::instance()->get(m_length - HEADER_LENGTH);
     m_buffer->assign(&buffer[HEADER_LENGTH], &buffer[HEADER_LENGTH] + m_length - HEADER_LENGTH);
 
     return m_length;
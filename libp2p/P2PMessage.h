@@ -73,7 +73,17 @@ public:
     /// binary number of the packet is 1 or 0
     virtual bool isRequestPacket() override { return !((m_protocolID & 0x8000) == 0x8000); }
 
+    /// the consensus messages are written first unless a priority is set
+    virtual dev::network::MessagePriority priority() override;
+    virtual void setPriority(dev::network::MessagePriority _priority)
+    {
+        m_priority = _priority;
+        m_prioritySet = true;
+    }
+
     virtual void encode(bytes& buffer) override;
+    /// encoded once until the message is modified, the multicast and the broadcast share it
+    virtual std::shared_ptr<bytes> encodedData() override;
 
     /// < If the decoding is successful, the length of the decoded data is returned; otherwise, 0 is
     /// returned.
@@ -99,6 +109,9 @@ protected:
     uint32_t m_seq = 0;               ///< the message identify
     std::shared_ptr<bytes> m_buffer;  ///< message data
     bool m_dirty = true;
+    std::shared_ptr<bytes> m_encoded;
+    dev::network::MessagePriority m_priority = dev::network::SyncPriority;
+    bool m_prioritySet = false;
 };
 enum AMOPPacketType
 {
@@ -28,7 +28,18 @@ using namespace dev;
 using namespace dev::p2p;
 using namespace dev::compress;
 
+CompressStats& dev::p2p::compressStats()
+{
+    static CompressStats stats;
+    return stats;
+}
+
 void P2PMessageRC2::encode(bytes& buffer)
+{
+    buffer = *encodedData();
+}
+
+std::shared_ptr<bytes> P2PMessageRC2::encodedData()
 {
     /// re-encode when m_cache is dirty
     if (dirty())
@@ -44,7 +55,7 @@ void P2PMessageRC2::encode(bytes& buffer)
             encode(m_buffer);
         }
     }
-    buffer = *m_cache;
+    return m_cache;
 }
 
 /**
@@ -55,8 +66,10 @@ void P2PMessageRC2::encode(bytes& buffer)
  */
 void P2PMessageRC2::encode(std::shared_ptr<bytes> encodeBuffer)
 {
-    m_cache->clear();  ///< It is not allowed to be assembled outside.
+    /// a new cache, the old one may still be queued by the sessions it was sent to
+    m_cache = std::make_shared<bytes>();
     m_length = HEADER_LENGTH + encodeBuffer->size();
+    m_cache->reserve(m_length);
 
     uint32_t length = htonl(m_length);
     VERSION_TYPE versionType = htons(m_version);
@@ -76,8 +89,13 @@ void P2PMessageRC2::encode(std::shared_ptr<bytes> encodeBuffer)
 /// compress the data to be sended
 bool P2PMessageRC2::compress(std::shared_ptr<bytes> compressData)
 {
-    if (!g_BCOSConfig.compressEnabled() || m_buffer->size() <= g_BCOSConfig.c_compressThreshold)
+    if (!g_BCOSConfig.compressEnabled())
+    {
+        return false;
+    }
+    if (m_buffer->size() <= g_BCOSConfig.c_compressThreshold)
     {
+        compressStats().skipped++;
         return false;
     }
     /// the packet has already been encoded
@@ -85,11 +103,19 @@ bool P2PMessageRC2::compress(std::shared_ptr<bytes> compressData)
     {
         return false;
     }
+    auto startTime = utcTimeUs();
     size_t compressSize = SnappyCompress::compress(ref(*m_buffer), *compressData);
-    if (compressSize < 1)
+    auto& stats = compressStats();
+    stats.compressTimeUs += utcTimeUs() - startTime;
+    /// the incompressible data is sent as it is
+    if (compressSize < 1 || compressSize >= m_buffer->size())
     {
+        stats.skipped++;
         return false;
     }
+    stats.compressed++;
+    stats.originBytes += m_buffer->size();
+    stats.compressedBytes += compressSize;
     m_version |= dev::eth::CompressFlag;
     return true;
 }
@@ -103,6 +129,10 @@ ssize_t P2PMessageRC2::decode(const byte* buffer, size_t size)
 
     int32_t offset = 0;
     m_length = ntohl(*((uint32_t*)&buffer[offset]));
+    if (m_length < HEADER_LENGTH)
+    {
+        return dev::network::PACKET_ERROR;
+    }
 
     if (size < m_length)
     {
@@ -121,18 +151,30 @@ ssize_t P2PMessageRC2::decode(const byte* buffer, size_t size)
     offset += sizeof(m_packetType);
     m_seq = ntohl(*((uint32_t*)&buffer[offset]));
 
-    /// the data has been compressed
-    if (g_BCOSConfig.compressEnabled() &&
-        ((m_version & dev::eth::CompressFlag) == dev::eth::CompressFlag))
+    m_buffer = dev::network::BufferPool::instance()->get(m_length - HEADER_LENGTH);
+    /// the data has been compressed, the flag of each message tells the receiver to uncompress
+    /// it even if the receiver doesn't compress its own messages
+    if ((m_version & dev::eth::CompressFlag) == dev::eth::CompressFlag)
     {
-        /// uncompress data
-        SnappyCompress::uncompress(
+        auto startTime = utcTimeUs();
+        size_t uncompressSize = SnappyCompress::uncompress(
             bytesConstRef((const byte*)(&buffer[HEADER_LENGTH]), m_length - HEADER_LENGTH),
             *m_buffer);
+        auto& stats = compressStats();
+        stats.uncompressTimeUs += utcTimeUs() - startTime;
+        if (uncompressSize < 1)
+        {
+            stats.uncompressFailed++;
+            return dev::network::PACKET_ERROR;
+        }
+        stats.uncompressed++;
+        stats.receivedBytes += m_length - HEADER_LENGTH;
+        stats.uncompressedBytes += uncompressSize;
+        /// the message is forwarded uncompressed unless it's compressed again
+        m_version &= ~dev::eth::CompressFlag;
     }
     else
     {
-        ///< TODO: assign to std::move
         m_buffer->assign(&buffer[HEADER_LENGTH], &buffer[HEADER_LENGTH] + m_length - HEADER_LENGTH);
     }
     return m_length;
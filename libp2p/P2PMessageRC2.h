@@ -22,11 +22,31 @@
 #pragma once
 
 #include "P2PMessage.h"
+#include <atomic>
 
 namespace dev
 {
 namespace p2p
 {
+/// compression of the messages of the node since it started, shared by all the groups
+struct CompressStats
+{
+    /// messages sent compressed, the bytes before and after and the time spent
+    std::atomic<uint64_t> compressed = {0};
+    std::atomic<uint64_t> originBytes = {0};
+    std::atomic<uint64_t> compressedBytes = {0};
+    std::atomic<uint64_t> compressTimeUs = {0};
+    /// messages sent raw, under the threshold or not shrunk by compression
+    std::atomic<uint64_t> skipped = {0};
+    /// compressed messages received, the bytes before and after and the time spent
+    std::atomic<uint64_t> uncompressed = {0};
+    std::atomic<uint64_t> receivedBytes = {0};
+    std::atomic<uint64_t> uncompressedBytes = {0};
+    std::atomic<uint64_t> uncompressTimeUs = {0};
+    std::atomic<uint64_t> uncompressFailed = {0};
+};
+CompressStats& compressStats();
+
 class P2PMessageRC2 : public P2PMessage
 {
 public:
@@ -44,6 +64,7 @@ public:
 
     virtual ~P2PMessageRC2() {}
     void encode(bytes& buffer) override;
+    std::shared_ptr<bytes> encodedData() override;
     /// < If the decoding is successful, the length of the decoded data is returned; otherwise, 0 is
     /// returned.
     ssize_t decode(const byte* buffer, size_t size) override;
@@ -58,6 +58,15 @@ void P2PSession::heartBeat()
     auto service = m_service.lock();
     if (service && service->actived())
     {
+        uint64_t now = utcTime();
+        if (m_lastHeartBeat > 0 && now > m_lastHeartBeat)
+        {
+            uint64_t inBytes = m_inBytes;
+            m_inRate = (inBytes - m_lastInBytes) * 1000 / (now - m_lastHeartBeat);
+            m_lastInBytes = inBytes;
+        }
+        m_lastHeartBeat = now;
+
         if (m_session && m_session->actived())
         {
             SESSION_LOG(TRACE) << LOG_DESC("P2PSession onHeartBeat")
@@ -72,8 +81,19 @@ void P2PSession::heartBeat()
             std::string s = boost::lexical_cast<std::string>(service->topicSeq());
             buffer->assign(s.begin(), s.end());
             message->setBuffer(buffer);
-            std::shared_ptr<bytes> msgBuf = std::make_shared<bytes>();
-            m_session->asyncSendMessage(message);
+            message->setSeq(service->p2pMessageFactory()->newSeq());
+
+            auto self = std::weak_ptr<P2PSession>(shared_from_this());
+            dev::network::Options option;
+            option.timeout = HEARTBEAT_INTERVEL;
+            m_session->asyncSendMessage(message, option,
+                [self, now](NetworkException e, dev::network::Message::Ptr) {
+                    auto session = self.lock();
+                    if (session)
+                    {
+                        session->onHeartBeatResponse(e, now);
+                    }
+                });
         }
 
         auto self = std::weak_ptr<P2PSession>(shared_from_this());
@@ -94,6 +114,45 @@ void P2PSession::heartBeat()
     }
 }
 
+void P2PSession::onHeartBeatResponse(NetworkException e, uint64_t sendTime)
+{
+    if (e.errorCode())
+    {
+        return;
+    }
+    onRTT(utcTime() - sendTime);
+}
+
+PeerStat P2PSession::stat()
+{
+    PeerStat stat;
+    stat.rtt = m_rtt;
+    stat.inBytes = m_inBytes;
+    stat.inMessages = m_inMessages;
+    stat.inRate = m_inRate;
+    stat.outBytes = m_outBytes;
+    stat.outMessages = m_outMessages;
+    if (m_session)
+    {
+        stat.writeQueueBytes = m_session->writeQueueBytes();
+    }
+    return stat;
+}
+
+void P2PSession::setTopics(uint32_t seq, std::shared_ptr<std::set<std::string> > topics)
+{
+    {
+        std::lock_guard<std::mutex> lock(x_topic);
+        m_topicSeq = seq;
+        m_topics = topics;
+    }
+    auto service = m_service.lock();
+    if (service)
+    {
+        service->onTopicsUpdated(shared_from_this(), *topics);
+    }
+}
+
 void P2PSession::onTopicMessage(P2PMessage::Ptr message)
 {
     auto service = m_service.lock();
@@ -102,10 +161,28 @@ void P2PSession::onTopicMessage(P2PMessage::Ptr message)
     {
         try
         {
+            /// the responses arriving after their timeouts
+            if (!message->isRequestPacket())
+            {
+                SESSION_LOG(TRACE) << LOG_DESC("Ignore the topic response timed out")
+                                   << LOG_KV("seq", message->seq());
+                return;
+            }
             switch (message->packetType())
             {
             case AMOPPacketType::SendTopicSeq:
             {
+                /// answer the heartbeat to give its rtt
+                if (message->seq() != 0)
+                {
+                    auto response = std::dynamic_pointer_cast<P2PMessage>(
+                        service->p2pMessageFactory()->buildMessage());
+                    response->setProtocolID(-((PROTOCOL_ID)dev::eth::ProtocolID::Topic));
+                    response->setPacketType(AMOPPacketType::SendTopicSeq);
+                    response->setBuffer(std::make_shared<bytes>());
+                    response->setSeq(message->seq());
+                    m_session->asyncSendMessage(response, dev::network::Options(), CallbackFunc());
+                }
                 std::string s((const char*)message->buffer()->data(), message->buffer()->size());
                 auto topicSeq = boost::lexical_cast<uint32_t>(s);
 
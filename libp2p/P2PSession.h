@@ -24,6 +24,7 @@
 #include <libnetwork/Common.h>
 #include <libnetwork/SessionFace.h>
 #include <libp2p/Common.h>
+#include <atomic>
 #include <memory>
 
 namespace dev
@@ -69,14 +70,28 @@ public:
 
     virtual void onTopicMessage(std::shared_ptr<P2PMessage> message);
 
-    virtual void setTopics(uint32_t seq, std::shared_ptr<std::set<std::string> > topics)
+    /// the topics of the peer, indexed by the service to route the AMOP messages
+    virtual void setTopics(uint32_t seq, std::shared_ptr<std::set<std::string> > topics);
+
+    virtual void onReceived(size_t bytes)
     {
-        std::lock_guard<std::mutex> lock(x_topic);
-        m_topicSeq = seq;
-        m_topics = topics;
+        m_inBytes += bytes;
+        ++m_inMessages;
+    }
+    virtual void onSent(size_t bytes)
+    {
+        m_outBytes += bytes;
+        ++m_outMessages;
     }
+    /// the smoothed rtt moves 1/8 of the way to each sample, as the srtt of TCP
+    virtual void onRTT(uint64_t rtt) { m_rtt = m_rtt == 0 ? rtt : (m_rtt * 7 + rtt) / 8; }
+    virtual PeerStat stat();
 
 private:
+    /// the heartbeats carry a seq and the peers answering them give the rtt, the peers of older
+    /// versions ignore the seq and their heartbeats time out quietly
+    void onHeartBeatResponse(NetworkException e, uint64_t sendTime);
+
     dev::network::SessionFace::Ptr m_session;
     /// NodeID m_nodeID;
     dev::network::NodeInfo m_nodeInfo;
@@ -88,6 +103,16 @@ private:
     std::shared_ptr<boost::asio::deadline_timer> m_timer;
     bool m_run = false;
 
+    std::atomic<uint64_t> m_rtt = {0};
+    std::atomic<uint64_t> m_inBytes = {0};
+    std::atomic<uint64_t> m_inMessages = {0};
+    std::atomic<uint64_t> m_inRate = {0};
+    std::atomic<uint64_t> m_outBytes = {0};
+    std::atomic<uint64_t> m_outMessages = {0};
+    /// the received bytes and the time of the last heartbeat, for the receiving rate
+    uint64_t m_lastInBytes = 0;
+    uint64_t m_lastHeartBeat = 0;
+
     const uint32_t HEARTBEAT_INTERVEL = 5000;
 };
 
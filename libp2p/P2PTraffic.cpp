@@ -0,0 +1,116 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file P2PTraffic.cpp
+ *  @brief the traffic of each (group, module) and its bandwidth shaping
+ */
+
+#include "P2PTraffic.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace dev;
+using namespace dev::p2p;
+using namespace dev::network;
+
+bool TokenBucket::consume(uint64_t _bytes, uint64_t _now)
+{
+    if (_now > m_lastTime)
+    {
+        if (m_lastTime > 0)
+        {
+            m_tokens = std::min<double>(
+                m_rate, m_tokens + (double)m_rate * (_now - m_lastTime) / 1000);
+        }
+        m_lastTime = _now;
+    }
+    if (m_tokens <= 0)
+    {
+        return false;
+    }
+    m_tokens -= _bytes;
+    return true;
+}
+
+void P2PTraffic::setLimits(uint64_t _syncLimit, uint64_t _gossipLimit)
+{
+    Guard l(x_traffic);
+    m_syncLimit = _syncLimit;
+    m_gossipLimit = _gossipLimit;
+    m_buckets.clear();
+}
+
+uint64_t P2PTraffic::limit(MessagePriority _priority) const
+{
+    switch (_priority)
+    {
+    case SyncPriority:
+        return m_syncLimit;
+    case GossipPriority:
+        return m_gossipLimit;
+    default:
+        return 0;
+    }
+}
+
+void P2PTraffic::onReceived(PROTOCOL_ID _protocolID, size_t _bytes)
+{
+    Guard l(x_traffic);
+    auto& stat = m_stats[std::abs(_protocolID)];
+    stat.inBytes += _bytes;
+    ++stat.inMessages;
+}
+
+void P2PTraffic::onSent(PROTOCOL_ID _protocolID, size_t _bytes)
+{
+    Guard l(x_traffic);
+    auto& stat = m_stats[std::abs(_protocolID)];
+    stat.outBytes += _bytes;
+    ++stat.outMessages;
+}
+
+bool P2PTraffic::trySend(
+    PROTOCOL_ID _protocolID, size_t _bytes, MessagePriority _priority, uint64_t _now)
+{
+    Guard l(x_traffic);
+    PROTOCOL_ID protocolID = std::abs(_protocolID);
+    auto& stat = m_stats[protocolID];
+    uint64_t rate = limit(_priority);
+    if (rate > 0)
+    {
+        auto group = dev::eth::getGroupAndProtocol(protocolID).first;
+        auto key = std::make_pair(group, _priority);
+        auto it = m_buckets.find(key);
+        if (it == m_buckets.end())
+        {
+            it = m_buckets.insert(std::make_pair(key, TokenBucket(rate))).first;
+        }
+        if (!it->second.consume(_bytes, _now))
+        {
+            ++stat.shapedMessages;
+            return false;
+        }
+    }
+    stat.outBytes += _bytes;
+    ++stat.outMessages;
+    return true;
+}
+
+TrafficStats P2PTraffic::stats()
+{
+    Guard l(x_traffic);
+    return m_stats;
+}
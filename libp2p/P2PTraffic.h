@@ -0,0 +1,93 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file P2PTraffic.h
+ *  @brief the traffic of each (group, module) and its bandwidth shaping
+ */
+
+#pragma once
+
+#include <libdevcore/Guards.h>
+#include <libethcore/Protocol.h>
+#include <libnetwork/Common.h>
+#include <map>
+
+namespace dev
+{
+namespace p2p
+{
+/// the payload bytes and the messages of a (group, module) since the node started
+struct TrafficStat
+{
+    uint64_t inBytes = 0;
+    uint64_t inMessages = 0;
+    uint64_t outBytes = 0;
+    uint64_t outMessages = 0;
+    /// messages not sent since the module was over its bandwidth
+    uint64_t shapedMessages = 0;
+};
+/// key is the protocol id of the group and the module, always positive
+using TrafficStats = std::map<PROTOCOL_ID, TrafficStat>;
+
+/// Filled with _rate bytes per second up to one second of traffic. A message is let through while
+/// the bucket isn't empty and may overdraw it, so the messages larger than the rate still pass.
+class TokenBucket
+{
+public:
+    explicit TokenBucket(uint64_t _rate = 0) : m_rate(_rate), m_tokens(_rate) {}
+
+    /// take _bytes from the bucket at _now in milliseconds, false if it's empty
+    bool consume(uint64_t _bytes, uint64_t _now);
+
+private:
+    uint64_t m_rate;
+    double m_tokens;
+    uint64_t m_lastTime = 0;
+};
+
+/// Counts the traffic of each (group, module) in both directions and limits the bandwidth the
+/// sync and the gossip of a group take, so that they can't starve the consensus of the groups
+/// sharing the link. The consensus messages are never shaped.
+class P2PTraffic
+{
+public:
+    typedef std::shared_ptr<P2PTraffic> Ptr;
+
+    /// bytes per second the sync and the gossip of each group may send, 0 for no limit
+    void setLimits(uint64_t _syncLimit, uint64_t _gossipLimit);
+
+    void onReceived(PROTOCOL_ID _protocolID, size_t _bytes);
+    /// count a message sent, no matter its priority
+    void onSent(PROTOCOL_ID _protocolID, size_t _bytes);
+    /// count a message to send if its group has bandwidth left for its priority, false if the
+    /// message is shaped and shouldn't be sent
+    bool trySend(PROTOCOL_ID _protocolID, size_t _bytes,
+        dev::network::MessagePriority _priority, uint64_t _now);
+
+    TrafficStats stats();
+
+private:
+    uint64_t limit(dev::network::MessagePriority _priority) const;
+
+    Mutex x_traffic;
+    TrafficStats m_stats;
+    std::map<std::pair<GROUP_ID, dev::network::MessagePriority>, TokenBucket> m_buckets;
+    uint64_t m_syncLimit = 0;
+    uint64_t m_gossipLimit = 0;
+};
+
+}  // namespace p2p
+}  // namespace dev
@@ -87,7 +87,97 @@ void Service::stop()
 
         /// clear sessions
         m_sessions.clear();
+
+        WriteGuard gl(x_groupDispatchers);
+        for (auto const& it : m_groupDispatchers)
+        {
+            it.second->stop();
+        }
+        m_groupDispatchers.clear();
+    }
+}
+
+Service::GroupDispatcher::Ptr Service::groupDispatcher(GROUP_ID _groupID)
+{
+    {
+        ReadGuard l(x_groupDispatchers);
+        auto it = m_groupDispatchers.find(_groupID);
+        if (it != m_groupDispatchers.end())
+        {
+            return it->second;
+        }
+    }
+    WriteGuard l(x_groupDispatchers);
+    auto it = m_groupDispatchers.find(_groupID);
+    if (it != m_groupDispatchers.end())
+    {
+        return it->second;
+    }
+    auto dispatcher = std::make_shared<GroupDispatcher>(std::make_shared<dev::ThreadPool>(
+        "P2P-g" + std::to_string(_groupID), m_groupThreads, dev::TaskPriority::High));
+    m_groupDispatchers.insert(std::make_pair(_groupID, dispatcher));
+    return dispatcher;
+}
+
+void Service::GroupDispatcher::dispatch(std::function<void()> _request)
+{
+    if (!m_requests.tryPush(std::move(_request)))
+    {
+        // the ring is full, the request is only moved when it's pushed
+        m_pool->enqueue(std::move(_request));
+        return;
+    }
+    // pairs with the fence of a drainer leaving, either it sees the request or this sees it left
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (acquireDrainer())
+    {
+        auto self = shared_from_this();
+        m_pool->enqueue([self]() { self->drain(); });
+    }
+}
+
+bool Service::GroupDispatcher::acquireDrainer()
+{
+    auto drainers = m_drainers.load();
+    while (drainers < m_pool->size())
+    {
+        if (m_drainers.compare_exchange_weak(drainers, drainers + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Service::GroupDispatcher::drain()
+{
+    std::vector<std::function<void()>> requests;
+    m_requests.tryPopBatch(std::back_inserter(requests), c_batchSize);
+    for (auto& request : requests)
+    {
+        try
+        {
+            request();
+        }
+        catch (std::exception const& e)
+        {
+            SERVICE_LOG(ERROR) << LOG_DESC("handle request failed")
+                               << LOG_KV("what", boost::diagnostic_information(e));
+        }
     }
+    if (m_requests.size() == 0)
+    {
+        m_drainers--;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // a request pushed meanwhile may have found the drainers all busy
+        if (m_requests.size() == 0 || !acquireDrainer())
+        {
+            return;
+        }
+    }
+    // go on with the next batch behind the tasks of the other queues
+    auto self = shared_from_this();
+    m_pool->enqueue([self]() { self->drain(); });
 }
 
 void Service::heartBeat()
@@ -134,6 +224,15 @@ void Service::heartBeat()
     {
         RecursiveGuard l(x_sessions);
         SERVICE_LOG(INFO) << LOG_DESC("heartBeat") << LOG_KV("connected count", m_sessions.size());
+        for (auto const& it : m_sessions)
+        {
+            auto stat = it.second->stat();
+            SERVICE_LOG(INFO) << LOG_DESC("heartBeat peer") << LOG_KV("nodeID", it.first.abridged())
+                              << LOG_KV("rtt", stat.rtt) << LOG_KV("inRate", stat.inRate)
+                              << LOG_KV("inMessages", stat.inMessages)
+                              << LOG_KV("outMessages", stat.outMessages)
+                              << LOG_KV("writeQueueBytes", stat.writeQueueBytes);
+        }
     }
 
     auto self = std::weak_ptr<Service>(shared_from_this());
@@ -213,6 +312,8 @@ void Service::onConnect(dev::network::NetworkException e, dev::network::NodeInfo
     updateStaticNodes(session->socket(), nodeID);
     if (it != m_sessions.end())
     {
+        /// the topics of the new session are requested again
+        m_topicIndex.remove(nodeID);
         it->second = p2pSession;
     }
     else
@@ -234,6 +335,7 @@ void Service::onDisconnect(dev::network::NetworkException e, P2PSession::Ptr p2p
                            << LOG_KV("endpoint", p2pSession->session()->nodeIPEndpoint().name());
 
         m_sessions.erase(it);
+        m_topicIndex.remove(p2pSession->nodeID());
         if (e.errorCode() == dev::network::P2PExceptionType::DuplicateSession)
             return;
         SERVICE_LOG(WARNING) << LOG_DESC("onDisconnect") << LOG_KV("errorCode", e.errorCode())
@@ -270,6 +372,8 @@ void Service::onMessage(dev::network::NetworkException e, dev::network::SessionF
         /// SERVICE_LOG(TRACE) << "Service onMessage: " << message->seq();
 
         auto p2pMessage = std::dynamic_pointer_cast<P2PMessage>(message);
+        m_traffic->onReceived(p2pMessage->protocolID(), p2pMessage->buffer()->size());
+        p2pSession->onReceived(p2pMessage->buffer()->size());
 
         // AMOP topic message, redirect to p2psession
         if (abs(p2pMessage->protocolID()) == dev::eth::ProtocolID::Topic)
@@ -292,9 +396,17 @@ void Service::onMessage(dev::network::NetworkException e, dev::network::SessionF
 
             if (callback)
             {
-                m_host->threadPool()->enqueue([callback, p2pSession, p2pMessage, e]() {
+                auto request = [callback, p2pSession, p2pMessage, e]() {
                     callback(e, p2pSession, p2pMessage);
-                });
+                };
+                if (m_groupThreads == 0)
+                {
+                    m_host->threadPool()->enqueue(std::move(request));
+                    return;
+                }
+                /// a group busy with its requests doesn't hold back the others
+                auto group = dev::eth::getGroupAndProtocol(abs(p2pMessage->protocolID())).first;
+                groupDispatcher(group)->dispatch(std::move(request));
             }
             else
             {
@@ -392,6 +504,8 @@ void Service::asyncSendMessageByNodeID(NodeID nodeID, P2PMessage::Ptr message,
             auto session = it->second;
             if (callback)
             {
+                session->onSent(message->buffer()->size());
+                m_traffic->onSent(message->protocolID(), message->buffer()->size());
                 session->session()->asyncSendMessage(message, options,
                     [session, callback](
                         dev::network::NetworkException e, dev::network::Message::Ptr message) {
@@ -404,6 +518,17 @@ void Service::asyncSendMessageByNodeID(NodeID nodeID, P2PMessage::Ptr message,
             }
             else
             {
+                /// only the messages nobody waits for are shaped, the sync and the gossip
+                /// recover the lost ones by themselves
+                if (!m_traffic->trySend(message->protocolID(), message->buffer()->size(),
+                        message->priority(), utcTime()))
+                {
+                    SERVICE_LOG(TRACE) << LOG_DESC("Message shaped, over the bandwidth")
+                                       << LOG_KV("protocolID", message->protocolID())
+                                       << LOG_KV("nodeID", nodeID.abridged());
+                    return;
+                }
+                session->onSent(message->buffer()->size());
                 session->session()->asyncSendMessage(message, options, nullptr);
             }
         }
@@ -676,6 +801,7 @@ P2PSessionInfos Service::sessionInfos()
         {
             infos.push_back(P2PSessionInfo(
                 i.second->nodeInfo(), i.second->session()->nodeIPEndpoint(), (i.second->topics())));
+            infos.back().stat = i.second->stat();
         }
     }
     catch (std::exception& e)
@@ -724,23 +850,24 @@ P2PSessionInfos Service::sessionInfosByProtocolID(PROTOCOL_ID _protocolID) const
     return infos;
 }
 
+void Service::onTopicsUpdated(P2PSession::Ptr _session, std::set<std::string> const& _topics)
+{
+    RecursiveGuard l(x_sessions);
+    /// the topics of a replaced session are outdated
+    auto it = m_sessions.find(_session->nodeID());
+    if (it != m_sessions.end() && it->second == _session)
+    {
+        m_topicIndex.update(_session->nodeID(), _topics);
+    }
+}
+
 NodeIDs Service::getPeersByTopic(std::string const& topic)
 {
     NodeIDs nodeList;
     try
     {
-        RecursiveGuard l(x_sessions);
-        auto s = m_sessions;
-        for (auto const& it : s)
-        {
-            for (auto& j : it.second->topics())
-            {
-                if (j == topic)
-                {
-                    nodeList.push_back(it.first);
-                }
-            }
-        }
+        auto peers = m_topicIndex.find(topic);
+        nodeList.assign(peers.begin(), peers.end());
     }
     catch (std::exception& e)
     {
@@ -763,3 +890,14 @@ bool Service::isConnected(NodeID const& nodeID) const
     }
     return false;
 }
+
+size_t Service::writeQueueBytes(NodeID const& nodeID) const
+{
+    RecursiveGuard l(x_sessions);
+    auto it = m_sessions.find(nodeID);
+    if (it != m_sessions.end() && it->second->session())
+    {
+        return it->second->session()->writeQueueBytes();
+    }
+    return 0;
+}
@@ -30,7 +30,9 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Exceptions.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/concurrent_queue.h>
 #include <libnetwork/Host.h>
+#include <libp2p/TopicIndex.h>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -94,6 +96,8 @@ public:
     P2PSessionInfos sessionInfosByProtocolID(PROTOCOL_ID _protocolID) const override;
 
     bool isConnected(NodeID const& nodeID) const override;
+    size_t writeQueueBytes(NodeID const& nodeID) const override;
+    TrafficStats trafficStats() override { return m_traffic->stats(); }
 
     h512s getNodeListByGroupID(GROUP_ID groupID) override { return m_groupID2NodeList[groupID]; }
     void setGroupID2NodeList(std::map<GROUP_ID, h512s> _groupID2NodeList) override
@@ -132,13 +136,56 @@ public:
         m_p2pMessageFactory = _p2pMessageFactory;
     }
 
+    /// threads of the executor of each group the requests of the group are handled on, 0 to
+    /// handle the requests of all the groups on the thread pool of the host
+    virtual void setGroupThreads(size_t _groupThreads) { m_groupThreads = _groupThreads; }
+    /// bytes per second the sync and the gossip of each group may send, 0 for no limit
+    virtual void setTrafficLimits(uint64_t _syncLimit, uint64_t _gossipLimit)
+    {
+        m_traffic->setLimits(_syncLimit, _gossipLimit);
+    }
+
     virtual KeyPair keyPair() { return m_alias; }
     virtual void setKeyPair(KeyPair keyPair) { m_alias = keyPair; }
     void updateStaticNodes(
         std::shared_ptr<dev::network::SocketFace> const& _s, NodeID const& nodeId);
+    /// index the topics received from a peer
+    virtual void onTopicsUpdated(P2PSession::Ptr _session, std::set<std::string> const& _topics);
 
 private:
+    /**
+     * @brief The requests of a group wait in a lock-free ring, drained in batches by at most the
+     * size of the pool of the group at a time, so that a request costs the lock of the executor
+     * only when a drainer is started instead of each time.
+     */
+    class GroupDispatcher : public std::enable_shared_from_this<GroupDispatcher>
+    {
+    public:
+        typedef std::shared_ptr<GroupDispatcher> Ptr;
+        /// the requests the ring holds, the pool takes the others directly
+        static const size_t c_capacity = 4096;
+        /// the requests a drainer runs before it gives its worker back to the executor
+        static const size_t c_batchSize = 64;
+
+        explicit GroupDispatcher(dev::ThreadPool::Ptr _pool)
+          : m_pool(std::move(_pool)), m_requests(c_capacity)
+        {}
+        void dispatch(std::function<void()> _request);
+        void stop() { m_pool->stop(); }
+
+    private:
+        /// false if the pool already runs as many drainers as its size
+        bool acquireDrainer();
+        void drain();
+
+        dev::ThreadPool::Ptr m_pool;
+        MPMCQueue<std::function<void()>> m_requests;
+        std::atomic<size_t> m_drainers = {0};
+    };
+
     NodeIDs getPeersByTopic(std::string const& topic);
+    /// the dispatcher of the group, created on the first request of the group
+    GroupDispatcher::Ptr groupDispatcher(GROUP_ID _groupID);
 
     bool isSessionInNodeIDList(NodeID const& targetNodeID, NodeIDs const& nodeIDs);
 
@@ -153,6 +200,8 @@ private:
     std::atomic<uint32_t> m_topicSeq = {0};
     std::shared_ptr<std::vector<std::string>> m_topics;
     RecursiveMutex x_topics;
+    /// the peers subscribing each topic
+    TopicIndex<NodeID> m_topicIndex;
 
     ///< key is the group that the node joins
     ///< value is the list of node members for the group
@@ -172,6 +221,12 @@ private:
 
     std::shared_ptr<boost::asio::deadline_timer> m_timer;
 
+    size_t m_groupThreads = 0;
+    std::map<GROUP_ID, GroupDispatcher::Ptr> m_groupDispatchers;
+    SharedMutex x_groupDispatchers;
+
+    P2PTraffic::Ptr m_traffic = std::make_shared<P2PTraffic>();
+
     bool m_run = false;
 };
 
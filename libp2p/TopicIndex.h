@@ -0,0 +1,163 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file TopicIndex.h
+ *  @brief the subscribers of each AMOP topic
+ */
+
+#pragma once
+
+#include <libdevcore/Guards.h>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace dev
+{
+namespace p2p
+{
+/// a topic ending with it subscribes all the topics starting with the part before it
+static const char c_topicWildcard = '*';
+
+/// The inverted index from the AMOP topics to their subscribers, the peers of a node or the sdks
+/// connected to it, so that routing a message looks its topic up instead of scanning the topics
+/// of every subscriber. The subscriptions are updated by the difference between the old and the
+/// new topics of a subscriber.
+template <typename Key>
+class TopicIndex
+{
+public:
+    /// replace the topics of _key
+    void update(Key const& _key, std::set<std::string> const& _topics)
+    {
+        WriteGuard l(x_index);
+        auto& topics = m_topics[_key];
+        for (auto const& topic : topics)
+        {
+            if (!_topics.count(topic))
+            {
+                erase(topic, _key);
+            }
+        }
+        for (auto const& topic : _topics)
+        {
+            if (!topics.count(topic))
+            {
+                insert(topic, _key);
+            }
+        }
+        topics = _topics;
+        if (topics.empty())
+        {
+            m_topics.erase(_key);
+        }
+    }
+    void remove(Key const& _key) { update(_key, std::set<std::string>()); }
+
+    /// the subscribers of _topic, by its name or by a wildcard matching it
+    std::set<Key> find(std::string const& _topic) const
+    {
+        ReadGuard l(x_index);
+        std::set<Key> keys;
+        auto it = m_exact.find(_topic);
+        if (it != m_exact.end())
+        {
+            keys.insert(it->second.begin(), it->second.end());
+        }
+        /// only the lengths of the prefixes subscribed are looked up
+        for (auto const& length : m_prefixLengths)
+        {
+            if (length.first > _topic.size())
+            {
+                break;
+            }
+            auto prefixIt = m_prefixes.find(_topic.substr(0, length.first));
+            if (prefixIt != m_prefixes.end())
+            {
+                keys.insert(prefixIt->second.begin(), prefixIt->second.end());
+            }
+        }
+        return keys;
+    }
+
+    /// the topics subscribed by any subscriber, the wildcards included
+    std::set<std::string> topics() const
+    {
+        ReadGuard l(x_index);
+        std::set<std::string> topics;
+        for (auto const& it : m_exact)
+        {
+            topics.insert(it.first);
+        }
+        for (auto const& it : m_prefixes)
+        {
+            topics.insert(it.first + c_topicWildcard);
+        }
+        return topics;
+    }
+
+private:
+    static bool isWildcard(std::string const& _topic)
+    {
+        return !_topic.empty() && _topic.back() == c_topicWildcard;
+    }
+
+    void insert(std::string const& _topic, Key const& _key)
+    {
+        if (!isWildcard(_topic))
+        {
+            m_exact[_topic].insert(_key);
+            return;
+        }
+        std::string prefix = _topic.substr(0, _topic.size() - 1);
+        if (m_prefixes[prefix].insert(_key).second)
+        {
+            ++m_prefixLengths[prefix.size()];
+        }
+    }
+
+    void erase(std::string const& _topic, Key const& _key)
+    {
+        bool wildcard = isWildcard(_topic);
+        auto& index = wildcard ? m_prefixes : m_exact;
+        std::string name = wildcard ? _topic.substr(0, _topic.size() - 1) : _topic;
+        auto it = index.find(name);
+        if (it == index.end() || !it->second.erase(_key))
+        {
+            return;
+        }
+        if (it->second.empty())
+        {
+            index.erase(it);
+        }
+        if (wildcard && --m_prefixLengths[name.size()] == 0)
+        {
+            m_prefixLengths.erase(name.size());
+        }
+    }
+
+    mutable SharedMutex x_index;
+    std::map<Key, std::set<std::string>> m_topics;
+    std::unordered_map<std::string, std::set<Key>> m_exact;
+    /// the wildcards by the prefix before the wildcard character
+    std::unordered_map<std::string, std::set<Key>> m_prefixes;
+    /// the number of subscriptions of the prefixes of each length
+    std::map<size_t, size_t> m_prefixLengths;
+};
+
+}  // namespace p2p
+}  // namespace dev
@@ -37,9 +37,9 @@ const char* const CNS_METHOD_SLT_STR2 = "selectByNameAndVersion(string,string)";
 
 CNSPrecompiled::CNSPrecompiled()
 {
-    name2Selector[CNS_METHOD_INS_STR4] = getFuncSelector(CNS_METHOD_INS_STR4);
-    name2Selector[CNS_METHOD_SLT_STR] = getFuncSelector(CNS_METHOD_SLT_STR);
-    name2Selector[CNS_METHOD_SLT_STR2] = getFuncSelector(CNS_METHOD_SLT_STR2);
+    registerMethod(CNS_METHOD_INS_STR4, &CNSPrecompiled::insertCall);
+    registerMethod(CNS_METHOD_SLT_STR, &CNSPrecompiled::selectByNameCall);
+    registerMethod(CNS_METHOD_SLT_STR2, &CNSPrecompiled::selectByNameAndVersionCall);
 }
 
 
@@ -54,134 +54,148 @@ bytes CNSPrecompiled::call(
     PRECOMPILED_LOG(TRACE) << LOG_BADGE("CNSPrecompiled") << LOG_DESC("call")
                            << LOG_KV("param", toHex(param));
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CNSPrecompiled") << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
+    }
+
+    return out;
+}
 
+void CNSPrecompiled::insertCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // insert(string,string,string,string)
+    // insert(name, version, address, abi), 4 fields in table, the key of table is name field
     dev::eth::ContractABI abi;
-    bytes out;
+    std::string contractName, contractVersion, contractAddress, contractAbi;
+    abi.abiOut(data, contractName, contractVersion, contractAddress, contractAbi);
+    context->invalidateSystemReads(SYS_CNS);
+    Table::Ptr table = openTable(context, SYS_CNS);
 
-    if (func == name2Selector[CNS_METHOD_INS_STR4])
+    // check exist or not
+    bool exist = false;
+    auto entries = table->select(contractName, table->newCondition());
+    if (entries.get())
     {
-        // insert(string,string,string,string)
-        // insert(name, version, address, abi), 4 fields in table, the key of table is name field
-        std::string contractName, contractVersion, contractAddress, contractAbi;
-        abi.abiOut(data, contractName, contractVersion, contractAddress, contractAbi);
-        Table::Ptr table = openTable(context, SYS_CNS);
-
-        // check exist or not
-        bool exist = false;
-        auto entries = table->select(contractName, table->newCondition());
-        if (entries.get())
+        for (size_t i = 0; i < entries->size(); i++)
         {
-            for (size_t i = 0; i < entries->size(); i++)
+            auto entry = entries->get(i);
+            if (!entry)
+                continue;
+            if (entry->getField(SYS_CNS_FIELD_VERSION) == contractVersion)
             {
-                auto entry = entries->get(i);
-                if (!entry)
-                    continue;
-                if (entry->getField(SYS_CNS_FIELD_VERSION) == contractVersion)
-                {
-                    exist = true;
-                    break;
-                }
+                exist = true;
+                break;
             }
         }
-        int result = 0;
-        if (exist)
+    }
+    int result = 0;
+    if (exist)
+    {
+        PRECOMPILED_LOG(WARNING)
+            << LOG_BADGE("CNSPrecompiled") << LOG_DESC("address and version exist");
+        result = CODE_ADDRESS_AND_VERSION_EXIST;
+    }
+    else
+    {
+        // do insert
+        auto entry = table->newEntry();
+        entry->setField(SYS_CNS_FIELD_NAME, contractName);
+        entry->setField(SYS_CNS_FIELD_VERSION, contractVersion);
+        entry->setField(SYS_CNS_FIELD_ADDRESS, contractAddress);
+        entry->setField(SYS_CNS_FIELD_ABI, contractAbi);
+        int count = table->insert(contractName, entry, std::make_shared<AccessOptions>(origin));
+        if (count == storage::CODE_NO_AUTHORIZED)
         {
-            PRECOMPILED_LOG(WARNING)
-                << LOG_BADGE("CNSPrecompiled") << LOG_DESC("address and version exist");
-            result = CODE_ADDRESS_AND_VERSION_EXIST;
+            PRECOMPILED_LOG(DEBUG) << LOG_BADGE("CNSPrecompiled") << LOG_DESC("permission denied");
+            result = storage::CODE_NO_AUTHORIZED;
         }
         else
         {
-            // do insert
-            auto entry = table->newEntry();
-            entry->setField(SYS_CNS_FIELD_NAME, contractName);
-            entry->setField(SYS_CNS_FIELD_VERSION, contractVersion);
-            entry->setField(SYS_CNS_FIELD_ADDRESS, contractAddress);
-            entry->setField(SYS_CNS_FIELD_ABI, contractAbi);
-            int count = table->insert(contractName, entry, std::make_shared<AccessOptions>(origin));
-            if (count == storage::CODE_NO_AUTHORIZED)
-            {
-                PRECOMPILED_LOG(DEBUG)
-                    << LOG_BADGE("CNSPrecompiled") << LOG_DESC("permission denied");
-                result = storage::CODE_NO_AUTHORIZED;
-            }
-            else
-            {
-                PRECOMPILED_LOG(DEBUG)
-                    << LOG_BADGE("CNSPrecompiled") << LOG_DESC("insert successfully");
-                result = count;
-            }
+            PRECOMPILED_LOG(DEBUG)
+                << LOG_BADGE("CNSPrecompiled") << LOG_DESC("insert successfully");
+            result = count;
         }
-        getErrorCodeOut(out, result);
     }
-    else if (func == name2Selector[CNS_METHOD_SLT_STR])
+    getErrorCodeOut(out, result);
+}
+
+void CNSPrecompiled::selectByNameCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // selectByName(string) returns(string)
+    // Cursor is not considered.
+    dev::eth::ContractABI abi;
+    std::string contractName;
+    abi.abiOut(data, contractName);
+    if (context->getSystemRead(SYS_CNS, contractName, CNS_METHOD_SLT_STR, out))
     {
-        // selectByName(string) returns(string)
-        // Cursor is not considered.
-        std::string contractName;
-        abi.abiOut(data, contractName);
-        Table::Ptr table = openTable(context, SYS_CNS);
+        return;
+    }
+    Table::Ptr table = openTable(context, SYS_CNS);
 
-        Json::Value CNSInfos(Json::arrayValue);
-        auto entries = table->select(contractName, table->newCondition());
-        if (entries.get())
+    Json::Value CNSInfos(Json::arrayValue);
+    auto entries = table->select(contractName, table->newCondition());
+    if (entries.get())
+    {
+        for (size_t i = 0; i < entries->size(); i++)
         {
-            for (size_t i = 0; i < entries->size(); i++)
+            auto entry = entries->get(i);
+            if (!entry)
+                continue;
+            Json::Value CNSInfo;
+            CNSInfo[SYS_CNS_FIELD_NAME] = contractName;
+            CNSInfo[SYS_CNS_FIELD_VERSION] = entry->getField(SYS_CNS_FIELD_VERSION);
+            CNSInfo[SYS_CNS_FIELD_ADDRESS] = entry->getField(SYS_CNS_FIELD_ADDRESS);
+            CNSInfo[SYS_CNS_FIELD_ABI] = entry->getField(SYS_CNS_FIELD_ABI);
+            CNSInfos.append(CNSInfo);
+        }
+    }
+    Json::FastWriter fastWriter;
+    std::string str = fastWriter.write(CNSInfos);
+    out = abi.abiIn("", str);
+    context->cacheSystemRead(SYS_CNS, contractName, CNS_METHOD_SLT_STR, out);
+}
+
+void CNSPrecompiled::selectByNameAndVersionCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // selectByNameAndVersion(string,string) returns(string)
+    dev::eth::ContractABI abi;
+    std::string contractName, contractVersion;
+    abi.abiOut(data, contractName, contractVersion);
+    auto query = CNS_METHOD_SLT_STR2 + contractVersion;
+    if (context->getSystemRead(SYS_CNS, contractName, query, out))
+    {
+        return;
+    }
+    Table::Ptr table = openTable(context, SYS_CNS);
+
+    Json::Value CNSInfos(Json::arrayValue);
+    auto entries = table->select(contractName, table->newCondition());
+    if (entries.get())
+    {
+        for (size_t i = 0; i < entries->size(); i++)
+        {
+            auto entry = entries->get(i);
+            if (contractVersion == entry->getField(SYS_CNS_FIELD_VERSION))
             {
-                auto entry = entries->get(i);
-                if (!entry)
-                    continue;
                 Json::Value CNSInfo;
                 CNSInfo[SYS_CNS_FIELD_NAME] = contractName;
                 CNSInfo[SYS_CNS_FIELD_VERSION] = entry->getField(SYS_CNS_FIELD_VERSION);
                 CNSInfo[SYS_CNS_FIELD_ADDRESS] = entry->getField(SYS_CNS_FIELD_ADDRESS);
                 CNSInfo[SYS_CNS_FIELD_ABI] = entry->getField(SYS_CNS_FIELD_ABI);
                 CNSInfos.append(CNSInfo);
+                // Only one
+                break;
             }
         }
-        Json::FastWriter fastWriter;
-        std::string str = fastWriter.write(CNSInfos);
-        out = abi.abiIn("", str);
-    }
-    else if (func == name2Selector[CNS_METHOD_SLT_STR2])
-    {
-        // selectByNameAndVersion(string,string) returns(string)
-        std::string contractName, contractVersion;
-        abi.abiOut(data, contractName, contractVersion);
-        Table::Ptr table = openTable(context, SYS_CNS);
-
-        Json::Value CNSInfos(Json::arrayValue);
-        auto entries = table->select(contractName, table->newCondition());
-        if (entries.get())
-        {
-            for (size_t i = 0; i < entries->size(); i++)
-            {
-                auto entry = entries->get(i);
-                if (contractVersion == entry->getField(SYS_CNS_FIELD_VERSION))
-                {
-                    Json::Value CNSInfo;
-                    CNSInfo[SYS_CNS_FIELD_NAME] = contractName;
-                    CNSInfo[SYS_CNS_FIELD_VERSION] = entry->getField(SYS_CNS_FIELD_VERSION);
-                    CNSInfo[SYS_CNS_FIELD_ADDRESS] = entry->getField(SYS_CNS_FIELD_ADDRESS);
-                    CNSInfo[SYS_CNS_FIELD_ABI] = entry->getField(SYS_CNS_FIELD_ABI);
-                    CNSInfos.append(CNSInfo);
-                    // Only one
-                    break;
-                }
-            }
-        }
-        Json::FastWriter fastWriter;
-        std::string str = fastWriter.write(CNSInfos);
-        out = abi.abiIn("", str);
     }
-    else
-    {
-        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CNSPrecompiled") << LOG_DESC("call undefined function")
-                               << LOG_KV("func", func);
-    }
-
-    return out;
+    Json::FastWriter fastWriter;
+    std::string str = fastWriter.write(CNSInfos);
+    out = abi.abiIn("", str);
+    context->cacheSystemRead(SYS_CNS, contractName, query, out);
 }
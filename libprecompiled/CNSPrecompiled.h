@@ -50,6 +50,14 @@ public:
 
     bytes call(std::shared_ptr<dev::blockverifier::ExecutiveContext> context, bytesConstRef param,
         Address const& origin = Address()) override;
+
+private:
+    void insertCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void selectByNameCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void selectByNameAndVersionCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
 };
 
 }  // namespace precompiled
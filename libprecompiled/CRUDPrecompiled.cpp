@@ -41,10 +41,10 @@ const char* const CRUD_METHOD_SELECT_STR = "select(string,string,string,string)"
 
 CRUDPrecompiled::CRUDPrecompiled()
 {
-    name2Selector[CRUD_METHOD_INSERT_STR] = getFuncSelector(CRUD_METHOD_INSERT_STR);
-    name2Selector[CRUD_METHOD_REMOVE_STR] = getFuncSelector(CRUD_METHOD_REMOVE_STR);
-    name2Selector[CRUD_METHOD_UPDATE_STR] = getFuncSelector(CRUD_METHOD_UPDATE_STR);
-    name2Selector[CRUD_METHOD_SELECT_STR] = getFuncSelector(CRUD_METHOD_SELECT_STR);
+    registerMethod(CRUD_METHOD_INSERT_STR, &CRUDPrecompiled::insertCall);
+    registerMethod(CRUD_METHOD_REMOVE_STR, &CRUDPrecompiled::removeCall);
+    registerMethod(CRUD_METHOD_UPDATE_STR, &CRUDPrecompiled::updateCall);
+    registerMethod(CRUD_METHOD_SELECT_STR, &CRUDPrecompiled::selectCall);
 }
 
 std::string CRUDPrecompiled::toString()
@@ -57,156 +57,156 @@ bytes CRUDPrecompiled::call(
 {
     PRECOMPILED_LOG(TRACE) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("call")
                            << LOG_KV("param", toHex(param));
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
 
-    dev::eth::ContractABI abi;
     bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled")
+                               << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
+        dev::eth::ContractABI abi;
+        out = abi.abiIn("", u256(CODE_UNKNOW_FUNCTION_CALL));
+    }
 
-    if (func == name2Selector[CRUD_METHOD_INSERT_STR])
-    {  // insert(string tableName, string key, string entry, string optional)
-        std::string tableName, key, entryStr, optional;
-        abi.abiOut(data, tableName, key, entryStr, optional);
-        tableName = storage::USER_TABLE_PREFIX + tableName;
-        Table::Ptr table = openTable(context, tableName);
-        if (table)
-        {
-            Entry::Ptr entry = table->newEntry();
-            int parseEntryResult = parseEntry(entryStr, entry);
-            if (parseEntryResult != CODE_SUCCESS)
-            {
-                out = abi.abiIn("", u256(parseEntryResult));
-                return out;
-            }
+    return out;
+}
 
-            int result = table->insert(key, entry, std::make_shared<AccessOptions>(origin));
-            out = abi.abiIn("", u256(result));
-        }
-        else
+void CRUDPrecompiled::insertCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{  // insert(string tableName, string key, string entry, string optional)
+    dev::eth::ContractABI abi;
+    std::string tableName, key, entryStr, optional;
+    abi.abiOut(data, tableName, key, entryStr, optional);
+    tableName = storage::USER_TABLE_PREFIX + tableName;
+    Table::Ptr table = openTable(context, tableName);
+    if (table)
+    {
+        Entry::Ptr entry = table->newEntry();
+        int parseEntryResult = parseEntry(entryStr, entry);
+        if (parseEntryResult != CODE_SUCCESS)
         {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
-                                   << LOG_KV("tableName", tableName);
-            out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+            out = abi.abiIn("", u256(parseEntryResult));
+            return;
         }
 
-        return out;
+        int result = table->insert(key, entry, std::make_shared<AccessOptions>(origin));
+        out = abi.abiIn("", u256(result));
     }
-    if (func == name2Selector[CRUD_METHOD_UPDATE_STR])
-    {  // update(string tableName, string key, string entry, string condition, string optional)
-        std::string tableName, key, entryStr, conditionStr, optional;
-        abi.abiOut(data, tableName, key, entryStr, conditionStr, optional);
-        tableName = storage::USER_TABLE_PREFIX + tableName;
-        Table::Ptr table = openTable(context, tableName);
-        if (table)
+    else
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
+                               << LOG_KV("tableName", tableName);
+        out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+    }
+}
+
+void CRUDPrecompiled::updateCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{  // update(string tableName, string key, string entry, string condition, string optional)
+    dev::eth::ContractABI abi;
+    std::string tableName, key, entryStr, conditionStr, optional;
+    abi.abiOut(data, tableName, key, entryStr, conditionStr, optional);
+    tableName = storage::USER_TABLE_PREFIX + tableName;
+    Table::Ptr table = openTable(context, tableName);
+    if (table)
+    {
+        Entry::Ptr entry = table->newEntry();
+        int parseEntryResult = parseEntry(entryStr, entry);
+        if (parseEntryResult != CODE_SUCCESS)
         {
-            Entry::Ptr entry = table->newEntry();
-            int parseEntryResult = parseEntry(entryStr, entry);
-            if (parseEntryResult != CODE_SUCCESS)
-            {
-                out = abi.abiIn("", u256(parseEntryResult));
-                return out;
-            }
-            Condition::Ptr condition = table->newCondition();
-            int parseConditionResult = parseCondition(conditionStr, condition);
-            if (parseConditionResult != CODE_SUCCESS)
-            {
-                out = abi.abiIn("", u256(parseConditionResult));
-                return out;
-            }
-            int result =
-                table->update(key, entry, condition, std::make_shared<AccessOptions>(origin));
-            out = abi.abiIn("", u256(result));
+            out = abi.abiIn("", u256(parseEntryResult));
+            return;
         }
-        else
+        Condition::Ptr condition = table->newCondition();
+        int parseConditionResult = parseCondition(conditionStr, condition);
+        if (parseConditionResult != CODE_SUCCESS)
         {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
-                                   << LOG_KV("tableName", tableName);
-            out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+            out = abi.abiIn("", u256(parseConditionResult));
+            return;
         }
-
-        return out;
+        int result = table->update(key, entry, condition, std::make_shared<AccessOptions>(origin));
+        out = abi.abiIn("", u256(result));
     }
-    if (func == name2Selector[CRUD_METHOD_REMOVE_STR])
-    {  // remove(string tableName, string key, string condition, string optional)
-        std::string tableName, key, conditionStr, optional;
-        abi.abiOut(data, tableName, key, conditionStr, optional);
-        tableName = storage::USER_TABLE_PREFIX + tableName;
-        Table::Ptr table = openTable(context, tableName);
-        if (table)
-        {
-            Condition::Ptr condition = table->newCondition();
-            int parseConditionResult = parseCondition(conditionStr, condition);
-            if (parseConditionResult != CODE_SUCCESS)
-            {
-                out = abi.abiIn("", u256(parseConditionResult));
-                return out;
-            }
-            int result = table->remove(key, condition, std::make_shared<AccessOptions>(origin));
-            out = abi.abiIn("", u256(result));
-        }
-        else
+    else
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
+                               << LOG_KV("tableName", tableName);
+        out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+    }
+}
+
+void CRUDPrecompiled::removeCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{  // remove(string tableName, string key, string condition, string optional)
+    dev::eth::ContractABI abi;
+    std::string tableName, key, conditionStr, optional;
+    abi.abiOut(data, tableName, key, conditionStr, optional);
+    tableName = storage::USER_TABLE_PREFIX + tableName;
+    Table::Ptr table = openTable(context, tableName);
+    if (table)
+    {
+        Condition::Ptr condition = table->newCondition();
+        int parseConditionResult = parseCondition(conditionStr, condition);
+        if (parseConditionResult != CODE_SUCCESS)
         {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
-                                   << LOG_KV("tableName", tableName);
-            out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+            out = abi.abiIn("", u256(parseConditionResult));
+            return;
         }
+        int result = table->remove(key, condition, std::make_shared<AccessOptions>(origin));
+        out = abi.abiIn("", u256(result));
+    }
+    else
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
+                               << LOG_KV("tableName", tableName);
+        out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
+    }
+}
 
-        return out;
+void CRUDPrecompiled::selectCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{  // select(string tableName, string key, string condition, string optional)
+    dev::eth::ContractABI abi;
+    std::string tableName, key, conditionStr, optional;
+    abi.abiOut(data, tableName, key, conditionStr, optional);
+    if (tableName != storage::SYS_TABLES)
+    {
+        tableName = storage::USER_TABLE_PREFIX + tableName;
     }
-    if (func == name2Selector[CRUD_METHOD_SELECT_STR])
-    {  // select(string tableName, string key, string condition, string optional)
-        std::string tableName, key, conditionStr, optional;
-        abi.abiOut(data, tableName, key, conditionStr, optional);
-        if (tableName != storage::SYS_TABLES)
+    Table::Ptr table = openTable(context, tableName);
+    if (table)
+    {
+        Condition::Ptr condition = table->newCondition();
+        int parseConditionResult = parseCondition(conditionStr, condition);
+        if (parseConditionResult != CODE_SUCCESS)
         {
-            tableName = storage::USER_TABLE_PREFIX + tableName;
+            out = abi.abiIn("", u256(parseConditionResult));
+            return;
         }
-        Table::Ptr table = openTable(context, tableName);
-        if (table)
+        auto entries = table->select(key, condition);
+        Json::Value records = Json::Value(Json::arrayValue);
+        if (entries)
         {
-            Condition::Ptr condition = table->newCondition();
-            int parseConditionResult = parseCondition(conditionStr, condition);
-            if (parseConditionResult != CODE_SUCCESS)
-            {
-                out = abi.abiIn("", u256(parseConditionResult));
-                return out;
-            }
-            auto entries = table->select(key, condition);
-            Json::Value records = Json::Value(Json::arrayValue);
-            if (entries)
+            for (size_t i = 0; i < entries->size(); i++)
             {
-                for (size_t i = 0; i < entries->size(); i++)
+                auto entry = entries->get(i);
+                Json::Value record;
+                for (auto iter = entry->begin(); iter != entry->end(); iter++)
                 {
-                    auto entry = entries->get(i);
-                    Json::Value record;
-                    for (auto iter = entry->begin(); iter != entry->end(); iter++)
-                    {
-                        record[iter->first] = iter->second;
-                    }
-                    records.append(record);
+                    record[iter->first] = iter->second;
                 }
+                records.append(record);
             }
-
-            auto str = records.toStyledString();
-            out = abi.abiIn("", str);
-        }
-        else
-        {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
-                                   << LOG_KV("tableName", tableName);
-            out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
         }
 
-        return out;
+        auto str = records.toStyledString();
+        out = abi.abiIn("", str);
     }
     else
     {
-        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled")
-                               << LOG_DESC("call undefined function") << LOG_KV("func", func);
-        out = abi.abiIn("", u256(CODE_UNKNOW_FUNCTION_CALL));
-
-        return out;
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("CRUDPrecompiled") << LOG_DESC("table open error")
+                               << LOG_KV("tableName", tableName);
+        out = abi.abiIn("", u256(CODE_TABLE_NOT_EXIST));
     }
 }
 
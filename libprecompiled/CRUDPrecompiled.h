@@ -54,6 +54,14 @@ public:
         bytesConstRef param, Address const& origin = Address());
 
 private:
+    void insertCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void updateCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void removeCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void selectCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
     int parseEntry(const std::string& entryStr, storage::Entry::Ptr& entry);
     int parseCondition(const std::string& conditionStr, storage::Condition::Ptr& condition);
 };
@@ -47,6 +47,7 @@ enum PrecompiledError : int
     CODE_PARSE_ENTRY_ERROR = -51500,
 
     // DagTransferPrecompiled -51499 ~ -51400
+    CODE_INVALID_BATCH_SIZE = -51407,
     CODE_INVALID_OPENTALBLE_FAILED = -51406,
     CODE_INVALID_BALANCE_OVERFLOW = -51405,
     CODE_INVALID_INSUFFICIENT_BALANCE = -51404,
@@ -47,9 +47,9 @@ const char* const CSS_METHOD_REMOVE = "remove(string)";
 
 ConsensusPrecompiled::ConsensusPrecompiled()
 {
-    name2Selector[CSS_METHOD_ADD_SEALER] = getFuncSelector(CSS_METHOD_ADD_SEALER);
-    name2Selector[CSS_METHOD_ADD_SER] = getFuncSelector(CSS_METHOD_ADD_SER);
-    name2Selector[CSS_METHOD_REMOVE] = getFuncSelector(CSS_METHOD_REMOVE);
+    registerMethod(CSS_METHOD_ADD_SEALER, &ConsensusPrecompiled::addSealerCall);
+    registerMethod(CSS_METHOD_ADD_SER, &ConsensusPrecompiled::addObserverCall);
+    registerMethod(CSS_METHOD_REMOVE, &ConsensusPrecompiled::removeCall);
 }
 
 bytes ConsensusPrecompiled::call(
@@ -58,113 +58,54 @@ bytes ConsensusPrecompiled::call(
     PRECOMPILED_LOG(TRACE) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("call")
                            << LOG_KV("param", toHex(param));
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
-
-    dev::eth::ContractABI abi;
-    bytes out;
-    int count = 0;
-
     showConsensusTable(context);
 
-    int result = 0;
-    if (func == name2Selector[CSS_METHOD_ADD_SEALER])
+    bytes out;
+    if (!dispatch(context, param, origin, out))
     {
-        // addSealer(string)
-        std::string nodeID;
-        abi.abiOut(data, nodeID);
-        // Uniform lowercase nodeID
-        boost::to_lower(nodeID);
-
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("addSealer func")
-                               << LOG_KV("nodeID", nodeID);
-        if (nodeID.size() != 128u)
-        {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
-                                   << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
-            result = CODE_INVALID_NODEID;
-        }
-        else
-        {
-            storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
+                               << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
+        getErrorCodeOut(out, 0);
+    }
+    return out;
+}
 
-            auto condition = table->newCondition();
-            condition->EQ(NODE_KEY_NODEID, nodeID);
-            auto entries = table->select(PRI_KEY, condition);
-            auto entry = table->newEntry();
-            entry->setField(NODE_TYPE, NODE_TYPE_SEALER);
-            entry->setField(PRI_COLUMN, PRI_KEY);
-            entry->setField(NODE_KEY_ENABLENUM,
-                boost::lexical_cast<std::string>(context->blockInfo().number + 1));
+void ConsensusPrecompiled::addSealerCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // addSealer(string)
+    dev::eth::ContractABI abi;
+    int count = 0;
+    int result = 0;
+    std::string nodeID;
+    abi.abiOut(data, nodeID);
+    // Uniform lowercase nodeID
+    boost::to_lower(nodeID);
 
-            if (entries.get())
-            {
-                if (entries->size() == 0u)
-                {
-                    entry->setField(NODE_KEY_NODEID, nodeID);
-                    count = table->insert(PRI_KEY, entry, std::make_shared<AccessOptions>(origin));
-                    if (count == storage::CODE_NO_AUTHORIZED)
-                    {
-                        PRECOMPILED_LOG(DEBUG)
-                            << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
-                        result = storage::CODE_NO_AUTHORIZED;
-                    }
-                    else
-                    {
-                        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
-                                               << LOG_DESC("addSealer successfully");
-                        result = count;
-                    }
-                }
-                else
-                {
-                    count = table->update(
-                        PRI_KEY, entry, condition, std::make_shared<AccessOptions>(origin));
-                    if (count == storage::CODE_NO_AUTHORIZED)
-                    {
-                        PRECOMPILED_LOG(DEBUG)
-                            << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
-                        result = storage::CODE_NO_AUTHORIZED;
-                    }
-                    else
-                    {
-                        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
-                                               << LOG_DESC("addSealer successfully");
-                        result = count;
-                    }
-                }
-            }
-        }
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("addSealer func")
+                           << LOG_KV("nodeID", nodeID);
+    if (nodeID.size() != 128u)
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
+                               << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
+        result = CODE_INVALID_NODEID;
     }
-    else if (func == name2Selector[CSS_METHOD_ADD_SER])
+    else
     {
-        // addObserver(string)
-        std::string nodeID;
-        abi.abiOut(data, nodeID);
-        // Uniform lowercase nodeID
-        boost::to_lower(nodeID);
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("addObserver func")
-                               << LOG_KV("nodeID", nodeID);
-        if (nodeID.size() != 128u)
-        {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
-                                   << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
-            result = CODE_INVALID_NODEID;
-        }
-        else
-        {
-            storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
+        storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
 
-            auto condition = table->newCondition();
-            condition->EQ(NODE_KEY_NODEID, nodeID);
-            auto entries = table->select(PRI_KEY, condition);
-            auto entry = table->newEntry();
-            entry->setField(NODE_TYPE, NODE_TYPE_OBSERVER);
-            entry->setField(PRI_COLUMN, PRI_KEY);
-            entry->setField(NODE_KEY_ENABLENUM,
-                boost::lexical_cast<std::string>(context->blockInfo().number + 1));
+        auto condition = table->newCondition();
+        condition->EQ(NODE_KEY_NODEID, nodeID);
+        auto entries = table->select(PRI_KEY, condition);
+        auto entry = table->newEntry();
+        entry->setField(NODE_TYPE, NODE_TYPE_SEALER);
+        entry->setField(PRI_COLUMN, PRI_KEY);
+        entry->setField(NODE_KEY_ENABLENUM,
+            boost::lexical_cast<std::string>(context->blockInfo().number + 1));
 
+        if (entries.get())
+        {
             if (entries->size() == 0u)
             {
                 entry->setField(NODE_KEY_NODEID, nodeID);
@@ -178,11 +119,11 @@ bytes ConsensusPrecompiled::call(
                 else
                 {
                     PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
-                                           << LOG_DESC("addObserver successfully insert");
+                                           << LOG_DESC("addSealer successfully");
                     result = count;
                 }
             }
-            else if (!checkIsLastSealer(table, nodeID))
+            else
             {
                 count = table->update(
                     PRI_KEY, entry, condition, std::make_shared<AccessOptions>(origin));
@@ -195,66 +136,136 @@ bytes ConsensusPrecompiled::call(
                 else
                 {
                     PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
-                                           << LOG_DESC("addObserver successfully update");
+                                           << LOG_DESC("addSealer successfully");
                     result = count;
                 }
             }
-            else
-            {
-                result = CODE_LAST_SEALER;
-            }
         }
     }
-    else if (func == name2Selector[CSS_METHOD_REMOVE])
+    getErrorCodeOut(out, result);
+}
+
+void ConsensusPrecompiled::addObserverCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // addObserver(string)
+    dev::eth::ContractABI abi;
+    int count = 0;
+    int result = 0;
+    std::string nodeID;
+    abi.abiOut(data, nodeID);
+    // Uniform lowercase nodeID
+    boost::to_lower(nodeID);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("addObserver func")
+                           << LOG_KV("nodeID", nodeID);
+    if (nodeID.size() != 128u)
     {
-        // remove(string)
-        std::string nodeID;
-        abi.abiOut(data, nodeID);
-        // Uniform lowercase nodeID
-        boost::to_lower(nodeID);
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("remove func")
-                               << LOG_KV("nodeID", nodeID);
-        if (nodeID.size() != 128u)
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
+                               << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
+        result = CODE_INVALID_NODEID;
+    }
+    else
+    {
+        storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
+
+        auto condition = table->newCondition();
+        condition->EQ(NODE_KEY_NODEID, nodeID);
+        auto entries = table->select(PRI_KEY, condition);
+        auto entry = table->newEntry();
+        entry->setField(NODE_TYPE, NODE_TYPE_OBSERVER);
+        entry->setField(PRI_COLUMN, PRI_KEY);
+        entry->setField(NODE_KEY_ENABLENUM,
+            boost::lexical_cast<std::string>(context->blockInfo().number + 1));
+
+        if (entries->size() == 0u)
         {
-            PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
-                                   << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
-            result = CODE_INVALID_NODEID;
+            entry->setField(NODE_KEY_NODEID, nodeID);
+            count = table->insert(PRI_KEY, entry, std::make_shared<AccessOptions>(origin));
+            if (count == storage::CODE_NO_AUTHORIZED)
+            {
+                PRECOMPILED_LOG(DEBUG)
+                    << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
+                result = storage::CODE_NO_AUTHORIZED;
+            }
+            else
+            {
+                PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
+                                       << LOG_DESC("addObserver successfully insert");
+                result = count;
+            }
         }
-        else
+        else if (!checkIsLastSealer(table, nodeID))
         {
-            storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
-
-            if (!checkIsLastSealer(table, nodeID))
+            count = table->update(
+                PRI_KEY, entry, condition, std::make_shared<AccessOptions>(origin));
+            if (count == storage::CODE_NO_AUTHORIZED)
             {
-                auto condition = table->newCondition();
-                condition->EQ(NODE_KEY_NODEID, nodeID);
-                count = table->remove(PRI_KEY, condition, std::make_shared<AccessOptions>(origin));
-                if (count == storage::CODE_NO_AUTHORIZED)
-                {
-                    PRECOMPILED_LOG(DEBUG)
-                        << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
-                    result = storage::CODE_NO_AUTHORIZED;
-                }
-                else
-                {
-                    PRECOMPILED_LOG(DEBUG)
-                        << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("remove successfully");
-                    result = count;
-                }
+                PRECOMPILED_LOG(DEBUG)
+                    << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
+                result = storage::CODE_NO_AUTHORIZED;
             }
             else
             {
-                result = CODE_LAST_SEALER;
+                PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled")
+                                       << LOG_DESC("addObserver successfully update");
+                result = count;
             }
         }
+        else
+        {
+            result = CODE_LAST_SEALER;
+        }
     }
-    else
+    getErrorCodeOut(out, result);
+}
+
+void ConsensusPrecompiled::removeCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // remove(string)
+    dev::eth::ContractABI abi;
+    int count = 0;
+    int result = 0;
+    std::string nodeID;
+    abi.abiOut(data, nodeID);
+    // Uniform lowercase nodeID
+    boost::to_lower(nodeID);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("remove func")
+                           << LOG_KV("nodeID", nodeID);
+    if (nodeID.size() != 128u)
     {
         PRECOMPILED_LOG(ERROR) << LOG_BADGE("ConsensusPrecompiled")
-                               << LOG_DESC("call undefined function") << LOG_KV("func", func);
+                               << LOG_DESC("nodeID length error") << LOG_KV("nodeID", nodeID);
+        result = CODE_INVALID_NODEID;
+    }
+    else
+    {
+        storage::Table::Ptr table = openTable(context, SYS_CONSENSUS);
+
+        if (!checkIsLastSealer(table, nodeID))
+        {
+            auto condition = table->newCondition();
+            condition->EQ(NODE_KEY_NODEID, nodeID);
+            count = table->remove(PRI_KEY, condition, std::make_shared<AccessOptions>(origin));
+            if (count == storage::CODE_NO_AUTHORIZED)
+            {
+                PRECOMPILED_LOG(DEBUG)
+                    << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("permission denied");
+                result = storage::CODE_NO_AUTHORIZED;
+            }
+            else
+            {
+                PRECOMPILED_LOG(DEBUG)
+                    << LOG_BADGE("ConsensusPrecompiled") << LOG_DESC("remove successfully");
+                result = count;
+            }
+        }
+        else
+        {
+            result = CODE_LAST_SEALER;
+        }
     }
     getErrorCodeOut(out, result);
-    return out;
 }
 
 void ConsensusPrecompiled::showConsensusTable(ExecutiveContext::Ptr context)
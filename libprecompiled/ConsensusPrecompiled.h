@@ -55,6 +55,12 @@ public:
         bytesConstRef param, Address const& origin = Address());
 
 private:
+    void addSealerCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void addObserverCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void removeCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
     void showConsensusTable(std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
     bool checkIsLastSealer(std::shared_ptr<storage::Table> table, std::string const& nodeID);
 };
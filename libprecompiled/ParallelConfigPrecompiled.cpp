@@ -54,10 +54,10 @@ const string PARA_VALUE_NAMES = PARA_SELECTOR + "," + PARA_FUNC_NAME + "," + PAR
 
 ParallelConfigPrecompiled::ParallelConfigPrecompiled()
 {
-    name2Selector[PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT] =
-        getFuncSelector(PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT);
-    name2Selector[PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR] =
-        getFuncSelector(PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR);
+    registerMethod(PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT,
+        &ParallelConfigPrecompiled::registerParallelFunction);
+    registerMethod(PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR,
+        &ParallelConfigPrecompiled::unregisterParallelFunction);
 }
 
 string ParallelConfigPrecompiled::toString()
@@ -68,25 +68,12 @@ string ParallelConfigPrecompiled::toString()
 bytes ParallelConfigPrecompiled::call(
     dev::blockverifier::ExecutiveContext::Ptr context, bytesConstRef param, Address const& origin)
 {
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
-
-    ContractABI abi;
     bytes out;
-
-    if (func == name2Selector[PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT])
-    {
-        registerParallelFunction(context, data, origin, out);
-    }
-    else if (func == name2Selector[PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR])
-    {
-        unregisterParallelFunction(context, data, origin, out);
-    }
-    else
+    if (!dispatch(context, param, origin, out))
     {
         PRECOMPILED_LOG(ERROR) << LOG_BADGE("ParallelConfigPrecompiled")
-                               << LOG_DESC("call undefined function") << LOG_KV("func", func);
+                               << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
     }
     return out;
 }
@@ -39,9 +39,9 @@ const char* const AUP_METHOD_QUE = "queryByName(string)";
 
 PermissionPrecompiled::PermissionPrecompiled()
 {
-    name2Selector[AUP_METHOD_INS] = getFuncSelector(AUP_METHOD_INS);
-    name2Selector[AUP_METHOD_REM] = getFuncSelector(AUP_METHOD_REM);
-    name2Selector[AUP_METHOD_QUE] = getFuncSelector(AUP_METHOD_QUE);
+    registerMethod(AUP_METHOD_INS, &PermissionPrecompiled::insertCall);
+    registerMethod(AUP_METHOD_REM, &PermissionPrecompiled::removeCall);
+    registerMethod(AUP_METHOD_QUE, &PermissionPrecompiled::queryByNameCall);
 }
 
 std::string PermissionPrecompiled::toString()
@@ -55,119 +55,131 @@ bytes PermissionPrecompiled::call(
     PRECOMPILED_LOG(TRACE) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("call")
                            << LOG_KV("param", toHex(param));
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("PermissionPrecompiled")
+                               << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void PermissionPrecompiled::insertCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // insert(string tableName,string addr)
     dev::eth::ContractABI abi;
-    bytes out;
     int result = 0;
-    if (func == name2Selector[AUP_METHOD_INS])
+    std::string tableName, addr;
+    abi.abiOut(data, tableName, addr);
+    addPrefixToUserTable(tableName);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("insert func")
+                           << LOG_KV("tableName", tableName) << LOG_KV("address", addr);
+    context->invalidateSystemReads(SYS_ACCESS_TABLE);
+    Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
+
+    auto condition = table->newCondition();
+    condition->EQ(SYS_AC_ADDRESS, addr);
+    auto entries = table->select(tableName, condition);
+    if (entries->size() != 0u)
     {
-        // insert(string tableName,string addr)
-        std::string tableName, addr;
-        abi.abiOut(data, tableName, addr);
-        addPrefixToUserTable(tableName);
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("insert func")
-                               << LOG_KV("tableName", tableName) << LOG_KV("address", addr);
-        Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
-
-        auto condition = table->newCondition();
-        condition->EQ(SYS_AC_ADDRESS, addr);
-        auto entries = table->select(tableName, condition);
-        if (entries->size() != 0u)
-        {
-            PRECOMPILED_LOG(WARNING)
-                << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("tableName and address exist");
-            result = CODE_TABLE_AND_ADDRESS_EXIST;
-        }
-        else
-        {
-            auto entry = table->newEntry();
-            entry->setField(SYS_AC_TABLE_NAME, tableName);
-            entry->setField(SYS_AC_ADDRESS, addr);
-            entry->setField(SYS_AC_ENABLENUM,
-                boost::lexical_cast<std::string>(context->blockInfo().number + 1));
-            int count = table->insert(tableName, entry, std::make_shared<AccessOptions>(origin));
-            result = count;
-            PRECOMPILED_LOG(DEBUG)
-                << LOG_BADGE("PermissionPrecompiled")
-                << LOG_KV("insert_success", (count == storage::CODE_NO_AUTHORIZED ? false : true));
-        }
-        getErrorCodeOut(out, result);
+        PRECOMPILED_LOG(WARNING)
+            << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("tableName and address exist");
+        result = CODE_TABLE_AND_ADDRESS_EXIST;
     }
-    else if (func == name2Selector[AUP_METHOD_REM])
+    else
     {
-        // remove(string tableName,string addr)
-        std::string tableName, addr;
-        abi.abiOut(data, tableName, addr);
-        addPrefixToUserTable(tableName);
+        auto entry = table->newEntry();
+        entry->setField(SYS_AC_TABLE_NAME, tableName);
+        entry->setField(SYS_AC_ADDRESS, addr);
+        entry->setField(SYS_AC_ENABLENUM,
+            boost::lexical_cast<std::string>(context->blockInfo().number + 1));
+        int count = table->insert(tableName, entry, std::make_shared<AccessOptions>(origin));
+        result = count;
+        PRECOMPILED_LOG(DEBUG)
+            << LOG_BADGE("PermissionPrecompiled")
+            << LOG_KV("insert_success", (count == storage::CODE_NO_AUTHORIZED ? false : true));
+    }
+    getErrorCodeOut(out, result);
+}
 
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("remove func")
-                               << LOG_KV("tableName", tableName) << LOG_KV("address", addr);
+void PermissionPrecompiled::removeCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // remove(string tableName,string addr)
+    dev::eth::ContractABI abi;
+    int result = 0;
+    std::string tableName, addr;
+    abi.abiOut(data, tableName, addr);
+    addPrefixToUserTable(tableName);
 
-        Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("remove func")
+                           << LOG_KV("tableName", tableName) << LOG_KV("address", addr);
 
-        auto condition = table->newCondition();
-        condition->EQ(SYS_AC_ADDRESS, addr);
-        auto entries = table->select(tableName, condition);
-        if (entries->size() == 0u)
-        {
-            PRECOMPILED_LOG(WARNING) << LOG_BADGE("PermissionPrecompiled")
-                                     << LOG_DESC("tableName and address does not exist");
-            result = CODE_TABLE_AND_ADDRESS_NOT_EXIST;
-        }
-        else
-        {
-            int count =
-                table->remove(tableName, condition, std::make_shared<AccessOptions>(origin));
-            result = count;
-            PRECOMPILED_LOG(DEBUG)
-                << LOG_BADGE("PermissionPrecompiled")
-                << LOG_KV("remove_success", (count == storage::CODE_NO_AUTHORIZED ? false : true));
-        }
-        getErrorCodeOut(out, result);
+    context->invalidateSystemReads(SYS_ACCESS_TABLE);
+    Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
+
+    auto condition = table->newCondition();
+    condition->EQ(SYS_AC_ADDRESS, addr);
+    auto entries = table->select(tableName, condition);
+    if (entries->size() == 0u)
+    {
+        PRECOMPILED_LOG(WARNING) << LOG_BADGE("PermissionPrecompiled")
+                                 << LOG_DESC("tableName and address does not exist");
+        result = CODE_TABLE_AND_ADDRESS_NOT_EXIST;
     }
-    else if (func == name2Selector[AUP_METHOD_QUE])
+    else
     {
-        // queryByName(string table_name)
-        std::string tableName;
-        abi.abiOut(data, tableName);
-        addPrefixToUserTable(tableName);
-
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("queryByName func")
-                               << LOG_KV("tableName", tableName);
+        int count = table->remove(tableName, condition, std::make_shared<AccessOptions>(origin));
+        result = count;
+        PRECOMPILED_LOG(DEBUG)
+            << LOG_BADGE("PermissionPrecompiled")
+            << LOG_KV("remove_success", (count == storage::CODE_NO_AUTHORIZED ? false : true));
+    }
+    getErrorCodeOut(out, result);
+}
 
-        Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
+void PermissionPrecompiled::queryByNameCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // queryByName(string table_name)
+    dev::eth::ContractABI abi;
+    std::string tableName;
+    abi.abiOut(data, tableName);
+    addPrefixToUserTable(tableName);
 
-        auto condition = table->newCondition();
-        auto entries = table->select(tableName, condition);
-        Json::Value AuthorityInfos(Json::arrayValue);
-        if (entries)
-        {
-            for (size_t i = 0; i < entries->size(); i++)
-            {
-                auto entry = entries->get(i);
-                if (!entry)
-                    continue;
-                Json::Value AuthorityInfo;
-                AuthorityInfo[SYS_AC_TABLE_NAME] = tableName;
-                AuthorityInfo[SYS_AC_ADDRESS] = entry->getField(SYS_AC_ADDRESS);
-                AuthorityInfo[SYS_AC_ENABLENUM] = entry->getField(SYS_AC_ENABLENUM);
-                AuthorityInfos.append(AuthorityInfo);
-            }
-        }
-        Json::FastWriter fastWriter;
-        std::string str = fastWriter.write(AuthorityInfos);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PermissionPrecompiled") << LOG_DESC("queryByName func")
+                           << LOG_KV("tableName", tableName);
 
-        out = abi.abiIn("", str);
+    if (context->getSystemRead(SYS_ACCESS_TABLE, tableName, AUP_METHOD_QUE, out))
+    {
+        return;
     }
-    else
+    Table::Ptr table = openTable(context, SYS_ACCESS_TABLE);
+
+    auto condition = table->newCondition();
+    auto entries = table->select(tableName, condition);
+    Json::Value AuthorityInfos(Json::arrayValue);
+    if (entries)
     {
-        PRECOMPILED_LOG(ERROR) << LOG_BADGE("PermissionPrecompiled")
-                               << LOG_DESC("call undefined function") << LOG_KV("func", func);
+        for (size_t i = 0; i < entries->size(); i++)
+        {
+            auto entry = entries->get(i);
+            if (!entry)
+                continue;
+            Json::Value AuthorityInfo;
+            AuthorityInfo[SYS_AC_TABLE_NAME] = tableName;
+            AuthorityInfo[SYS_AC_ADDRESS] = entry->getField(SYS_AC_ADDRESS);
+            AuthorityInfo[SYS_AC_ENABLENUM] = entry->getField(SYS_AC_ENABLENUM);
+            AuthorityInfos.append(AuthorityInfo);
+        }
     }
-    return out;
+    Json::FastWriter fastWriter;
+    std::string str = fastWriter.write(AuthorityInfos);
+
+    out = abi.abiIn("", str);
+    context->cacheSystemRead(SYS_ACCESS_TABLE, tableName, AUP_METHOD_QUE, out);
 }
 
 void PermissionPrecompiled::addPrefixToUserTable(std::string& table_name)
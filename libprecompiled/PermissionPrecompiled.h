@@ -51,6 +51,12 @@ public:
         bytesConstRef param, Address const& origin = Address());
 
 protected:
+    void insertCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void removeCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
+    void queryByNameCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
     void addPrefixToUserTable(std::string& tableName);
 };
 
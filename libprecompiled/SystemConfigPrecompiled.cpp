@@ -36,7 +36,7 @@ const char* const SYSCONFIG_METHOD_SET_STR = "setValueByKey(string,string)";
 
 SystemConfigPrecompiled::SystemConfigPrecompiled()
 {
-    name2Selector[SYSCONFIG_METHOD_SET_STR] = getFuncSelector(SYSCONFIG_METHOD_SET_STR);
+    registerMethod(SYSCONFIG_METHOD_SET_STR, &SystemConfigPrecompiled::setValueByKeyCall);
 }
 
 bytes SystemConfigPrecompiled::call(
@@ -45,86 +45,85 @@ bytes SystemConfigPrecompiled::call(
     PRECOMPILED_LOG(TRACE) << LOG_BADGE("SystemConfigPrecompiled") << LOG_DESC("call")
                            << LOG_KV("param", toHex(param));
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        PRECOMPILED_LOG(ERROR) << LOG_BADGE("SystemConfigPrecompiled")
+                               << LOG_DESC("call undefined function")
+                               << LOG_KV("func", getParamFunc(param));
+        getErrorCodeOut(out, 0);
+    }
+    return out;
+}
 
+void SystemConfigPrecompiled::setValueByKeyCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // setValueByKey(string,string)
     dev::eth::ContractABI abi;
-    bytes out;
     int count = 0;
     int result = 0;
-    if (func == name2Selector[SYSCONFIG_METHOD_SET_STR])
-    {
-        // setValueByKey(string,string)
-        std::string configKey, configValue;
-        abi.abiOut(data, configKey, configValue);
-        // Uniform lowercase configKey
-        boost::to_lower(configKey);
-        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
-                               << LOG_DESC("setValueByKey func") << LOG_KV("configKey", configKey)
-                               << LOG_KV("configValue", configValue);
+    std::string configKey, configValue;
+    abi.abiOut(data, configKey, configValue);
+    // Uniform lowercase configKey
+    boost::to_lower(configKey);
+    PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
+                           << LOG_DESC("setValueByKey func") << LOG_KV("configKey", configKey)
+                           << LOG_KV("configValue", configValue);
 
-        if (!checkValueValid(configKey, configValue))
-        {
-            PRECOMPILED_LOG(DEBUG)
-                << LOG_BADGE("SystemConfigPrecompiled")
-                << LOG_DESC("SystemConfigPrecompiled set invalid value")
-                << LOG_KV("configKey", configKey) << LOG_KV("configValue", configValue);
-            getErrorCodeOut(out, CODE_INVALID_CONFIGURATION_VALUES);
-            return out;
-        }
+    if (!checkValueValid(configKey, configValue))
+    {
+        PRECOMPILED_LOG(DEBUG)
+            << LOG_BADGE("SystemConfigPrecompiled")
+            << LOG_DESC("SystemConfigPrecompiled set invalid value")
+            << LOG_KV("configKey", configKey) << LOG_KV("configValue", configValue);
+        getErrorCodeOut(out, CODE_INVALID_CONFIGURATION_VALUES);
+        return;
+    }
 
-        storage::Table::Ptr table = openTable(context, SYS_CONFIG);
+    storage::Table::Ptr table = openTable(context, SYS_CONFIG);
 
-        auto condition = table->newCondition();
-        auto entries = table->select(configKey, condition);
-        auto entry = table->newEntry();
-        entry->setField(SYSTEM_CONFIG_KEY, configKey);
-        entry->setField(SYSTEM_CONFIG_VALUE, configValue);
-        entry->setField(SYSTEM_CONFIG_ENABLENUM,
-            boost::lexical_cast<std::string>(context->blockInfo().number + 1));
+    auto condition = table->newCondition();
+    auto entries = table->select(configKey, condition);
+    auto entry = table->newEntry();
+    entry->setField(SYSTEM_CONFIG_KEY, configKey);
+    entry->setField(SYSTEM_CONFIG_VALUE, configValue);
+    entry->setField(SYSTEM_CONFIG_ENABLENUM,
+        boost::lexical_cast<std::string>(context->blockInfo().number + 1));
 
-        if (entries->size() == 0u)
+    if (entries->size() == 0u)
+    {
+        count = table->insert(configKey, entry, std::make_shared<AccessOptions>(origin));
+        if (count == storage::CODE_NO_AUTHORIZED)
         {
-            count = table->insert(configKey, entry, std::make_shared<AccessOptions>(origin));
-            if (count == storage::CODE_NO_AUTHORIZED)
-            {
-                PRECOMPILED_LOG(DEBUG)
-                    << LOG_BADGE("SystemConfigPrecompiled") << LOG_DESC("permission denied");
-                result = storage::CODE_NO_AUTHORIZED;
-            }
-            else
-            {
-                PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
-                                       << LOG_DESC("setValueByKey successfully");
-                result = count;
-            }
+            PRECOMPILED_LOG(DEBUG)
+                << LOG_BADGE("SystemConfigPrecompiled") << LOG_DESC("permission denied");
+            result = storage::CODE_NO_AUTHORIZED;
         }
         else
         {
-            count =
-                table->update(configKey, entry, condition, std::make_shared<AccessOptions>(origin));
-            if (count == storage::CODE_NO_AUTHORIZED)
-            {
-                PRECOMPILED_LOG(DEBUG)
-                    << LOG_BADGE("SystemConfigPrecompiled") << LOG_DESC("permission denied");
-                result = storage::CODE_NO_AUTHORIZED;
-            }
-            else
-            {
-                PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
-                                       << LOG_DESC("update value by key successfully");
-                result = count;
-            }
+            PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
+                                   << LOG_DESC("setValueByKey successfully");
+            result = count;
         }
     }
     else
     {
-        PRECOMPILED_LOG(ERROR) << LOG_BADGE("SystemConfigPrecompiled")
-                               << LOG_DESC("call undefined function") << LOG_KV("func", func);
+        count = table->update(configKey, entry, condition, std::make_shared<AccessOptions>(origin));
+        if (count == storage::CODE_NO_AUTHORIZED)
+        {
+            PRECOMPILED_LOG(DEBUG)
+                << LOG_BADGE("SystemConfigPrecompiled") << LOG_DESC("permission denied");
+            result = storage::CODE_NO_AUTHORIZED;
+        }
+        else
+        {
+            PRECOMPILED_LOG(DEBUG) << LOG_BADGE("SystemConfigPrecompiled")
+                                   << LOG_DESC("update value by key successfully");
+            result = count;
+        }
     }
     getErrorCodeOut(out, result);
-    return out;
 }
 
 bool SystemConfigPrecompiled::checkValueValid(std::string const& key, std::string const& value)
@@ -54,6 +54,8 @@ public:
         bytesConstRef param, Address const& origin = Address());
 
 private:
+    void setValueByKeyCall(std::shared_ptr<dev::blockverifier::ExecutiveContext> context,
+        bytesConstRef data, Address const& origin, bytes& out);
     bool checkValueValid(std::string const& key, std::string const& value);
 };
 
@@ -24,6 +24,8 @@
 #include <libethcore/ABI.h>
 #include <libstorage/EntriesPrecompiled.h>
 #include <libstorage/TableFactoryPrecompiled.h>
+#include <map>
+#include <set>
 
 using namespace dev;
 using namespace dev::blockverifier;
@@ -38,6 +40,8 @@ contract DagTransfer{
     function userDraw(string user, uint256 balance) public returns(uint256);
     function userBalance(string user) public constant returns(uint256,uint256);
     function userTransfer(string user_a, string user_b, uint256 amount) public returns(uint256);
+    function userBatchTransfer(string[] user_a, string[] user_b, uint256[] amount) public
+        returns(uint256);
 }
 */
 const std::string DAG_TRANSFER = "_dag_transfer_";
@@ -46,6 +50,8 @@ const char* const DAG_TRANSFER_METHOD_SAV_STR_UINT = "userSave(string,uint256)";
 const char* const DAG_TRANSFER_METHOD_DRAW_STR_UINT = "userDraw(string,uint256)";
 const char* const DAG_TRANSFER_METHOD_TRS_STR2_UINT = "userTransfer(string,string,uint256)";
 const char* const DAG_TRANSFER_METHOD_BAL_STR = "userBalance(string)";
+const char* const DAG_TRANSFER_METHOD_BATCH_TRS_STR2_UINT =
+    "userBatchTransfer(string[],string[],uint256[])";
 
 // fields of table '_dag_transfer_'
 const std::string DAG_TRANSFER_FIELD_NAME = "user_name";
@@ -53,15 +59,13 @@ const std::string DAG_TRANSFER_FIELD_BALANCE = "user_balance";
 
 DagTransferPrecompiled::DagTransferPrecompiled()
 {
-    name2Selector[DAG_TRANSFER_METHOD_ADD_STR_UINT] =
-        getFuncSelector(DAG_TRANSFER_METHOD_ADD_STR_UINT);
-    name2Selector[DAG_TRANSFER_METHOD_SAV_STR_UINT] =
-        getFuncSelector(DAG_TRANSFER_METHOD_SAV_STR_UINT);
-    name2Selector[DAG_TRANSFER_METHOD_DRAW_STR_UINT] =
-        getFuncSelector(DAG_TRANSFER_METHOD_DRAW_STR_UINT);
-    name2Selector[DAG_TRANSFER_METHOD_TRS_STR2_UINT] =
-        getFuncSelector(DAG_TRANSFER_METHOD_TRS_STR2_UINT);
-    name2Selector[DAG_TRANSFER_METHOD_BAL_STR] = getFuncSelector(DAG_TRANSFER_METHOD_BAL_STR);
+    registerMethod(DAG_TRANSFER_METHOD_ADD_STR_UINT, &DagTransferPrecompiled::userAddCall);
+    registerMethod(DAG_TRANSFER_METHOD_SAV_STR_UINT, &DagTransferPrecompiled::userSaveCall);
+    registerMethod(DAG_TRANSFER_METHOD_DRAW_STR_UINT, &DagTransferPrecompiled::userDrawCall);
+    registerMethod(DAG_TRANSFER_METHOD_TRS_STR2_UINT, &DagTransferPrecompiled::userTransferCall);
+    registerMethod(DAG_TRANSFER_METHOD_BAL_STR, &DagTransferPrecompiled::userBalanceCall);
+    registerMethod(
+        DAG_TRANSFER_METHOD_BATCH_TRS_STR2_UINT, &DagTransferPrecompiled::userBatchTransferCall);
 }
 
 bool DagTransferPrecompiled::invalidUserName(const std::string& strUserName)
@@ -70,6 +74,12 @@ bool DagTransferPrecompiled::invalidUserName(const std::string& strUserName)
     return strUserName.empty();
 }
 
+std::string DagTransferPrecompiled::getParallelTable()
+{
+    // the user name tags are the keys of the dag transfer table
+    return DAG_TRANSFER;
+}
+
 std::vector<std::string> DagTransferPrecompiled::getParallelTag(bytesConstRef param)
 {
     // parse function name
@@ -127,6 +137,31 @@ std::vector<std::string> DagTransferPrecompiled::getParallelTag(bytesConstRef pa
             results.push_back(toUser);
         }
     }
+    else if (func == name2Selector[DAG_TRANSFER_METHOD_BATCH_TRS_STR2_UINT])
+    {  // userBatchTransfer(string[],string[],uint256[])
+        std::vector<std::string> fromUsers, toUsers;
+        std::vector<dev::u256> amounts;
+
+        abi.abiOut(data, fromUsers, toUsers, amounts);
+        // every user touched by the batch is a tag, if params is invalid , parallel process can
+        // be done
+        if (fromUsers.size() == toUsers.size() && fromUsers.size() == amounts.size() &&
+            fromUsers.size() <= c_maxBatchTransfers)
+        {
+            std::set<std::string> users;
+            for (size_t i = 0; i < fromUsers.size(); ++i)
+            {
+                if (invalidUserName(fromUsers[i]) || invalidUserName(toUsers[i]))
+                {
+                    users.clear();
+                    break;
+                }
+                users.insert(fromUsers[i]);
+                users.insert(toUsers[i]);
+            }
+            results.assign(users.begin(), users.end());
+        }
+    }
     else if (func == name2Selector[DAG_TRANSFER_METHOD_BAL_STR])
     {
         // query interface has no parallel processing conflict.
@@ -163,41 +198,10 @@ bytes DagTransferPrecompiled::call(
     // PRECOMPILED_LOG(TRACE) << LOG_BADGE("DagTransferPrecompiled") << LOG_DESC("call")
     //                       << LOG_KV("param", toHex(param));
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
-
-    bytes out;
     // user_name user_balance 2 fields in table, the key of table is user_name field
-    if (func == name2Selector[DAG_TRANSFER_METHOD_ADD_STR_UINT])
-    {  // userAdd(string,uint256)
-        userAddCall(context, data, origin, out);
-    }
-    else if (func == name2Selector[DAG_TRANSFER_METHOD_SAV_STR_UINT])
-    {  // userSave(string,uint256)
-        userSaveCall(context, data, origin, out);
-    }
-    else if (func == name2Selector[DAG_TRANSFER_METHOD_DRAW_STR_UINT])
-    {  // userDraw(string,uint256)
-        userDrawCall(context, data, origin, out);
-    }
-    else if (func == name2Selector[DAG_TRANSFER_METHOD_TRS_STR2_UINT])
-    {  // userTransfer(string,string,uint256)
-        userTransferCall(context, data, origin, out);
-    }
-    else if (func == name2Selector[DAG_TRANSFER_METHOD_BAL_STR])
-    {  // userBalance(string user)
-        userBalanceCall(context, data, origin, out);
-    }
-    else
-    {
-        // PRECOMPILED_LOG(ERROR) << LOG_BADGE("DagTransferPrecompiled") << LOG_DESC("error func")
-        //                       << LOG_KV("func", func);
-    }
-
-    // PRECOMPILED_LOG(TRACE) << LOG_BADGE("DagTransferPrecompiled") << LOG_DESC("call")
-    //                       << LOG_DESC("end");
-
+    // an undefined function returns nothing
+    bytes out;
+    dispatch(context, param, origin, out);
     return out;
 }
 
@@ -584,3 +588,155 @@ void DagTransferPrecompiled::userTransferCall(
 
     out = abi.abiIn("", u256(ret));
 }
+
+void DagTransferPrecompiled::userBatchTransferCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    std::vector<std::string> fromUsers, toUsers;
+    std::vector<dev::u256> amounts;
+    dev::eth::ContractABI abi;
+    abi.abiOut(data, fromUsers, toUsers, amounts);
+
+    std::string strErrorMsg;
+    int ret = 0;
+
+    do
+    {
+        // parameters check
+        if (fromUsers.size() != toUsers.size() || fromUsers.size() != amounts.size() ||
+            fromUsers.size() > c_maxBatchTransfers)
+        {
+            strErrorMsg = "invalid batch size";
+            ret = CODE_INVALID_BATCH_SIZE;
+            break;
+        }
+
+        std::vector<std::string> users;
+        std::map<std::string, size_t> userIndex;
+        for (size_t i = 0; i < fromUsers.size() && ret == 0; ++i)
+        {
+            if (invalidUserName(fromUsers[i]) || invalidUserName(toUsers[i]))
+            {
+                strErrorMsg = "invalid user name";
+                ret = CODE_INVALID_USER_NAME;
+            }
+            else if (amounts[i] == 0)
+            {
+                strErrorMsg = "invalid amount";
+                ret = CODE_INVALID_AMOUNT;
+            }
+            for (auto user : {&fromUsers[i], &toUsers[i]})
+            {
+                if (userIndex.insert(std::make_pair(*user, users.size())).second)
+                {
+                    users.push_back(*user);
+                }
+            }
+        }
+        if (ret != 0 || users.empty())
+        {
+            break;
+        }
+
+        Table::Ptr table = openTable(context, origin);
+        if (!table)
+        {
+            strErrorMsg = "openTable failed.";
+            ret = CODE_INVALID_OPENTALBLE_FAILED;
+            break;
+        }
+
+        if (!table->checkAuthority(origin))
+        {  // permission denied
+            strErrorMsg = "permission denied";
+            ret = CODE_NO_AUTHORIZED;
+            break;
+        }
+
+        // resolve all users with one select, the transfers are applied to their balances in
+        // memory and written back only if all of them succeed
+        auto userEntries = table->batchSelect(users);
+        std::vector<bool> exists(users.size());
+        std::vector<dev::u256> balances(users.size());
+        for (size_t i = 0; i < users.size(); ++i)
+        {
+            exists[i] = userEntries[i] && userEntries[i]->size() > 0u;
+            if (exists[i])
+            {  // only one record for every user
+                balances[i] =
+                    dev::u256(userEntries[i]->get(0)->getField(DAG_TRANSFER_FIELD_BALANCE));
+            }
+        }
+
+        std::vector<bool> touched(users.size());
+        for (size_t i = 0; i < fromUsers.size(); ++i)
+        {
+            // transfer self, do nothing
+            if (fromUsers[i] == toUsers[i])
+            {
+                continue;
+            }
+
+            auto from = userIndex[fromUsers[i]];
+            auto to = userIndex[toUsers[i]];
+            if (!exists[from] && !touched[from])
+            {
+                strErrorMsg = "from user not exist";
+                ret = CODE_INVALID_USER_NOT_EXIST;
+                break;
+            }
+            if (balances[from] < amounts[i])
+            {
+                strErrorMsg = "from user insufficient balance";
+                ret = CODE_INVALID_INSUFFICIENT_BALANCE;
+                break;
+            }
+            // overflow check
+            if (balances[to] + amounts[i] < balances[to])
+            {
+                strErrorMsg = "to user balance overflow.";
+                ret = CODE_INVALID_BALANCE_OVERFLOW;
+                break;
+            }
+
+            balances[from] -= amounts[i];
+            balances[to] += amounts[i];
+            touched[from] = true;
+            touched[to] = true;
+        }
+        if (ret != 0)
+        {
+            break;
+        }
+
+        // update the balance info of the touched users, the to users not exist are added
+        auto options = std::make_shared<AccessOptions>(origin);
+        for (size_t i = 0; i < users.size(); ++i)
+        {
+            if (!touched[i])
+            {
+                continue;
+            }
+            auto entry = table->newEntry();
+            entry->setField(DAG_TRANSFER_FIELD_NAME, users[i]);
+            entry->setField(DAG_TRANSFER_FIELD_BALANCE, balances[i].str());
+            if (exists[i])
+            {
+                table->update(users[i], entry, table->newCondition(), options);
+            }
+            else
+            {
+                table->insert(users[i], entry, options);
+            }
+        }
+    } while (0);
+
+    if (ret != 0)
+    {
+        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("DagTransferPrecompiled")
+                               << LOG_DESC("userBatchTransfer failed")
+                               << LOG_KV("transfers", fromUsers.size()) << LOG_KV("ret", ret)
+                               << LOG_KV("msg", strErrorMsg);
+    }
+    out = abi.abiIn("", u256(ret));
+}
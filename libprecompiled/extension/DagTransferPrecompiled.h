@@ -50,6 +50,7 @@ public:
     // is this precompiled need parallel processing, default false.
     virtual bool isParallelPrecompiled() override { return true; }
     virtual std::vector<std::string> getParallelTag(bytesConstRef param) override;
+    virtual std::string getParallelTable() override;
 
 protected:
     std::shared_ptr<storage::Table> openTable(
@@ -67,6 +68,11 @@ public:
         Address const& origin, bytes& out);
     void userTransferCall(dev::blockverifier::ExecutiveContext::Ptr context, bytesConstRef data,
         Address const& origin, bytes& out);
+    void userBatchTransferCall(dev::blockverifier::ExecutiveContext::Ptr context,
+        bytesConstRef data, Address const& origin, bytes& out);
+
+    // the most transfers of one userBatchTransfer call
+    static const size_t c_maxBatchTransfers = 1000;
 };
 
 }  // namespace precompiled
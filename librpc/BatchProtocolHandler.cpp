@@ -0,0 +1,96 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file BatchProtocolHandler.cpp
+ * @brief the JSON-RPC batches dispatched in parallel
+ */
+
+#include "BatchProtocolHandler.h"
+#include "Common.h"
+#include <libdevcore/easylog.h>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace dev;
+using namespace dev::rpc;
+
+BatchProtocolHandler::BatchProtocolHandler(jsonrpc::IProtocolHandler* _handler, size_t _threads)
+  : m_handler(_handler),
+    m_threadPool(std::make_shared<ThreadPool>("RPCBatch", _threads, TaskPriority::Low))
+{}
+
+void BatchProtocolHandler::HandleRequest(std::string const& _request, std::string& _response)
+{
+    Json::Reader reader;
+    Json::Value batch;
+    /// the malformed requests and the single calls are answered by the wrapped handler
+    if (!reader.parse(_request, batch, false) || !batch.isArray() || batch.size() < 2)
+    {
+        m_handler->HandleRequest(_request, _response);
+        return;
+    }
+
+    Json::FastWriter writer;
+    std::vector<std::string> requests;
+    for (auto const& call : batch)
+    {
+        requests.push_back(writer.write(call));
+    }
+    std::vector<std::string> responses(requests.size());
+    std::mutex x_pending;
+    std::condition_variable pendingEmpty;
+    size_t pending = requests.size();
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        m_threadPool->enqueue([&, i]() {
+            try
+            {
+                m_handler->HandleRequest(requests[i], responses[i]);
+            }
+            catch (std::exception& e)
+            {
+                RPC_LOG(ERROR) << LOG_BADGE("BatchProtocolHandler") << LOG_DESC("call failed")
+                               << LOG_KV("index", i) << LOG_KV("what", e.what());
+            }
+            std::lock_guard<std::mutex> l(x_pending);
+            if (--pending == 0)
+            {
+                pendingEmpty.notify_one();
+            }
+        });
+    }
+    {
+        Executor::Blocking blocking;
+        std::unique_lock<std::mutex> l(x_pending);
+        pendingEmpty.wait(l, [&]() { return pending == 0; });
+    }
+
+    /// the notifications have no response, nor has a batch of them only
+    std::string joined;
+    for (auto& response : responses)
+    {
+        while (!response.empty() && response.back() == '\n')
+        {
+            response.pop_back();
+        }
+        if (!response.empty())
+        {
+            joined += (joined.empty() ? "[" : ",") + response;
+        }
+    }
+    _response = joined.empty() ? joined : joined + "]\n";
+}
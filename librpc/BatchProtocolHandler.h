@@ -0,0 +1,58 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file BatchProtocolHandler.h
+ * @brief the JSON-RPC batches dispatched in parallel
+ */
+
+#pragma once
+
+#include <jsonrpccpp/common/procedure.h>
+#include <jsonrpccpp/server/iprotocolhandler.h>
+#include <libdevcore/ThreadPool.h>
+#include <memory>
+#include <string>
+
+namespace dev
+{
+namespace rpc
+{
+/// threads calling the methods of the batches
+static const size_t c_batchThreads = 8;
+
+/// Wraps the protocol handler of the server. The calls of a JSON-RPC batch are independent, so
+/// each of them is handled by the wrapped handler on a thread of its own and the responses are
+/// joined in the order of the calls. A single call goes straight to the wrapped handler.
+class BatchProtocolHandler : public jsonrpc::IProtocolHandler
+{
+public:
+    /// takes ownership of _handler
+    explicit BatchProtocolHandler(
+        jsonrpc::IProtocolHandler* _handler, size_t _threads = c_batchThreads);
+
+    void AddProcedure(jsonrpc::Procedure const& _procedure) override
+    {
+        m_handler->AddProcedure(_procedure);
+    }
+    void HandleRequest(std::string const& _request, std::string& _response) override;
+
+private:
+    std::unique_ptr<jsonrpc::IProtocolHandler> m_handler;
+    ThreadPool::Ptr m_threadPool;
+};
+
+}  // namespace rpc
+}  // namespace dev
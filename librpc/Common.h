@@ -34,6 +34,13 @@ namespace rpc
 enum RPCExceptionType : int
 {
     Success = 0,
+    NoCheckpoint = -40016,
+    InvalidCheckpointName = -40015,
+    NoTrace = -40014,
+    NoGroupResources = -40013,
+    TooManyLogs = -40012,
+    Busy = -40011,
+    NoStorageStats = -40010,
     InvalidRequest = -40009,
     InvalidSystemConfig = -40008,
     NoView = -40007,
@@ -47,6 +54,11 @@ enum RPCExceptionType : int
 
 extern std::map<int, std::string> RPCMsg;
 
+/// the logs getLogs returns at most
+static const size_t c_maxLogs = 10000;
+/// the pending transactions getPendingTransactionsPage returns at most
+static const size_t c_maxPendingPage = 1000;
+
 
 }  // namespace rpc
 }  // namespace dev
@@ -0,0 +1,336 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file HttpServer.cpp
+ *  @brief the JSON-RPC endpoint served over HTTP/1.1 and WebSocket by asio, and the metrics of
+ *  the process at GET /metrics
+ */
+
+#include "HttpServer.h"
+#include "Common.h"
+#include <libdevcore/Allocator.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/easylog.h>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/optional.hpp>
+
+using namespace dev;
+using tcp = boost::asio::ip::tcp;
+namespace http = boost::beast::http;
+namespace websocket = boost::beast::websocket;
+
+namespace
+{
+/// the frames of a connection upgraded to WebSocket, each a JSON-RPC request
+class WebsocketConnection : public std::enable_shared_from_this<WebsocketConnection>
+{
+public:
+    WebsocketConnection(
+        HttpServer* _server, boost::asio::io_service& _ioService, tcp::socket _socket)
+      : m_server(_server), m_ws(std::move(_socket)), m_strand(_ioService.get_executor())
+    {}
+    ~WebsocketConnection() { m_server->release(); }
+
+    void run(http::request<http::string_body> const& _upgrade)
+    {
+        auto self = shared_from_this();
+        m_ws.async_accept(_upgrade,
+            boost::asio::bind_executor(m_strand, [self](boost::system::error_code _error) {
+                if (!_error)
+                {
+                    self->read();
+                }
+            }));
+    }
+
+private:
+    void read()
+    {
+        auto self = shared_from_this();
+        m_ws.async_read(m_buffer, boost::asio::bind_executor(m_strand,
+                                      [self](boost::system::error_code _error, size_t) {
+                                          if (!_error)
+                                          {
+                                              self->onRead();
+                                          }
+                                      }));
+    }
+
+    void onRead()
+    {
+        m_response = m_server->handle(boost::beast::buffers_to_string(m_buffer.data()));
+        m_buffer.consume(m_buffer.size());
+        m_ws.text(true);
+        auto self = shared_from_this();
+        m_ws.async_write(boost::asio::buffer(m_response),
+            boost::asio::bind_executor(m_strand, [self](boost::system::error_code _error, size_t) {
+                if (!_error)
+                {
+                    self->read();
+                }
+            }));
+    }
+
+    HttpServer* m_server;
+    websocket::stream<tcp::socket> m_ws;
+    boost::asio::strand<boost::asio::io_service::executor_type> m_strand;
+    boost::beast::flat_buffer m_buffer;
+    std::string m_response;
+};
+
+/// The requests of a kept alive connection. The next request is read once the response to the
+/// last one is written, so that the requests pipelined are answered in order.
+class HttpConnection : public std::enable_shared_from_this<HttpConnection>
+{
+public:
+    HttpConnection(HttpServer* _server, boost::asio::io_service& _ioService, tcp::socket _socket)
+      : m_server(_server),
+        m_ioService(_ioService),
+        m_socket(std::move(_socket)),
+        m_strand(_ioService.get_executor()),
+        m_timer(_ioService)
+    {}
+    ~HttpConnection()
+    {
+        if (!m_upgraded)
+        {
+            m_server->release();
+        }
+    }
+
+    void read()
+    {
+        m_parser.emplace();
+        m_parser->body_limit(c_maxHttpBodyBytes);
+        m_timer.expires_after(std::chrono::seconds(c_httpIdleSeconds));
+        auto self = shared_from_this();
+        m_timer.async_wait(
+            boost::asio::bind_executor(m_strand, [self](boost::system::error_code _error) {
+                if (_error != boost::asio::error::operation_aborted)
+                {
+                    boost::system::error_code ignored;
+                    self->m_socket.close(ignored);
+                }
+            }));
+        http::async_read(m_socket, m_buffer, *m_parser,
+            boost::asio::bind_executor(m_strand, [self](boost::system::error_code _error, size_t) {
+                self->m_timer.cancel();
+                if (!_error)
+                {
+                    self->onRead();
+                }
+            }));
+    }
+
+private:
+    void onRead()
+    {
+        auto request = m_parser->release();
+        if (m_server->websocket() && websocket::is_upgrade(request))
+        {
+            /// the connection is counted by the WebSocket from now on
+            m_upgraded = true;
+            std::make_shared<WebsocketConnection>(m_server, m_ioService, std::move(m_socket))
+                ->run(request);
+            return;
+        }
+
+        auto response = std::make_shared<http::response<http::string_body> >();
+        response->version(request.version());
+        response->keep_alive(request.keep_alive());
+        response->set(http::field::access_control_allow_origin, m_server->allowedOrigin());
+        if (request.method() == http::verb::post)
+        {
+            response->result(http::status::ok);
+            response->set(http::field::content_type, "application/json");
+            response->body() = m_server->handle(request.body());
+        }
+        else if (request.method() == http::verb::get && request.target() == "/metrics")
+        {
+            response->result(http::status::ok);
+            response->set(http::field::content_type, "text/plain; version=0.0.4");
+            updateAllocatorMetrics();
+            response->body() = g_metrics.prometheus();
+        }
+        else if (request.method() == http::verb::options)
+        {
+            response->result(http::status::ok);
+            response->set(http::field::allow, "GET, POST, OPTIONS");
+            response->set(http::field::access_control_allow_headers,
+                "origin, content-type, accept");
+        }
+        else
+        {
+            response->result(http::status::method_not_allowed);
+            response->body() = "Not allowed HTTP Method";
+        }
+        response->prepare_payload();
+
+        auto self = shared_from_this();
+        http::async_write(m_socket, *response,
+            boost::asio::bind_executor(
+                m_strand, [self, response](boost::system::error_code _error, size_t) {
+                    if (_error)
+                    {
+                        return;
+                    }
+                    if (response->need_eof())
+                    {
+                        boost::system::error_code ignored;
+                        self->m_socket.shutdown(tcp::socket::shutdown_send, ignored);
+                        return;
+                    }
+                    self->read();
+                }));
+    }
+
+    HttpServer* m_server;
+    boost::asio::io_service& m_ioService;
+    tcp::socket m_socket;
+    boost::asio::strand<boost::asio::io_service::executor_type> m_strand;
+    boost::asio::steady_timer m_timer;
+    boost::beast::flat_buffer m_buffer;
+    boost::optional<http::request_parser<http::string_body> > m_parser;
+    bool m_upgraded = false;
+};
+}  // namespace
+
+HttpServer::HttpServer(std::string const& _address, int _port, size_t _threads,
+    size_t _maxConnections, bool _websocket)
+  : m_address(_address),
+    m_port(_port),
+    m_threads(std::max<size_t>(_threads, 1)),
+    m_maxConnections(_maxConnections),
+    m_websocket(_websocket)
+{}
+
+bool HttpServer::StartListening()
+{
+    if (m_running)
+    {
+        return true;
+    }
+    try
+    {
+        m_ioService = std::make_shared<boost::asio::io_service>();
+        m_acceptor = std::make_shared<tcp::acceptor>(*m_ioService);
+        tcp::endpoint endpoint(boost::asio::ip::make_address(m_address), m_port);
+        m_acceptor->open(endpoint.protocol());
+        m_acceptor->set_option(tcp::acceptor::reuse_address(true));
+        m_acceptor->bind(endpoint);
+        m_acceptor->listen();
+    }
+    catch (std::exception& e)
+    {
+        RPC_LOG(ERROR) << LOG_BADGE("HttpServer") << LOG_DESC("listen failed")
+                       << LOG_KV("address", m_address) << LOG_KV("port", m_port)
+                       << LOG_KV("what", e.what());
+        return false;
+    }
+    accept();
+    for (size_t i = 0; i < m_threads; ++i)
+    {
+        auto ioService = m_ioService;
+        m_workers.emplace_back([ioService]() {
+            pthread_setThreadName("HttpServer");
+            ioService->run();
+        });
+    }
+    m_running = true;
+    RPC_LOG(INFO) << LOG_BADGE("HttpServer") << LOG_DESC("listening")
+                  << LOG_KV("address", m_address) << LOG_KV("port", m_port)
+                  << LOG_KV("threads", m_threads) << LOG_KV("websocket", m_websocket);
+    return true;
+}
+
+bool HttpServer::StopListening()
+{
+    if (!m_running)
+    {
+        return true;
+    }
+    m_running = false;
+    m_ioService->stop();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+    m_acceptor.reset();
+    m_ioService.reset();
+    return true;
+}
+
+std::string HttpServer::handle(std::string const& _request)
+{
+    std::string response;
+    auto handler = GetHandler();
+    if (!handler)
+    {
+        return "No client conneciton handler found";
+    }
+    try
+    {
+        handler->HandleRequest(_request, response);
+    }
+    catch (std::exception& e)
+    {
+        return std::string("ERROR while handleRequest:") + e.what();
+    }
+    return response;
+}
+
+bool HttpServer::acquire()
+{
+    if (++m_connections > m_maxConnections)
+    {
+        --m_connections;
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::accept()
+{
+    auto socket = std::make_shared<tcp::socket>(*m_ioService);
+    m_acceptor->async_accept(*socket, [this, socket](boost::system::error_code _error) {
+        if (_error == boost::asio::error::operation_aborted || !m_acceptor->is_open())
+        {
+            return;
+        }
+        if (!_error)
+        {
+            if (acquire())
+            {
+                std::make_shared<HttpConnection>(this, *m_ioService, std::move(*socket))
+                    ->read();
+            }
+            else
+            {
+                RPC_LOG(WARNING) << LOG_BADGE("HttpServer") << LOG_DESC("too many connections")
+                                 << LOG_KV("max", m_maxConnections);
+                boost::system::error_code ignored;
+                socket->close(ignored);
+            }
+        }
+        accept();
+    });
+}
@@ -0,0 +1,81 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file HttpServer.h
+ *  @brief the JSON-RPC endpoint served over HTTP/1.1 and WebSocket by asio
+ */
+
+#pragma once
+
+#include "jsonrpccpp/server/abstractserverconnector.h"
+#include <boost/asio.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+/// the connections served at once, the others are closed on accept
+static const size_t c_maxHttpConnections = 1024;
+/// a connection idle longer is closed
+static const size_t c_httpIdleSeconds = 60;
+/// the body of a request at most, a large sendRawTransactions batch included
+static const size_t c_maxHttpBodyBytes = 32 * 1024 * 1024;
+
+/// An alternative to SafeHttpServer on Boost.Beast. The connections are kept alive and the
+/// requests pipelined on them are answered in order; a connection upgraded to WebSocket takes a
+/// JSON-RPC request per text frame and answers with a frame.
+class HttpServer : public jsonrpc::AbstractServerConnector
+{
+public:
+    HttpServer(std::string const& _address, int _port, size_t _threads = 4,
+        size_t _maxConnections = c_maxHttpConnections, bool _websocket = false);
+    virtual ~HttpServer() { StopListening(); }
+
+    bool StartListening() override;
+    bool StopListening() override;
+
+    void setAllowedOrigin(std::string const& _origin) { m_allowedOrigin = _origin; }
+    std::string const& allowedOrigin() const { return m_allowedOrigin; }
+    bool websocket() const { return m_websocket; }
+
+    /// the response to _request, handled by the ModularServer
+    std::string handle(std::string const& _request);
+
+    /// false if the connection would go beyond the limit, release() once it closes otherwise
+    bool acquire();
+    void release() { --m_connections; }
+
+private:
+    void accept();
+
+    std::string m_address;
+    int m_port;
+    size_t m_threads;
+    size_t m_maxConnections;
+    bool m_websocket;
+    std::string m_allowedOrigin = "*";
+
+    std::shared_ptr<boost::asio::io_service> m_ioService;
+    std::shared_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_connections = {0};
+    bool m_running = false;
+};
+
+}  // namespace dev
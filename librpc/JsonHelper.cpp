@@ -24,6 +24,7 @@
 #include <libdevcore/easylog.h>
 #include <libethcore/CommonJS.h>
 #include <libethcore/Transaction.h>
+#include <tbb/parallel_for.h>
 
 using namespace std;
 using namespace dev::eth;
@@ -32,6 +33,24 @@ namespace dev
 {
 namespace rpc
 {
+namespace
+{
+h256 toTopic(Json::Value const& _topic)
+{
+    if (!_topic.isString())
+    {
+        BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("topic"));
+    }
+    std::string topic = _topic.asString();
+    auto b = fromHex(topic.substr(0, 2) == "0x" ? topic.substr(2) : topic, WhenError::Throw);
+    if (b.size() != h256::size)
+    {
+        BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("topic " + topic));
+    }
+    return h256(b);
+}
+}  // namespace
+
 Json::Value toJson(
     Transaction const& _t, std::pair<h256, unsigned> _location, BlockNumber _blockNumber)
 {
@@ -53,6 +72,51 @@ Json::Value toJson(
     return res;
 }
 
+Json::Value toJson(Transactions const& _txs, h256 const& _blockHash, BlockNumber _blockNumber)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs.size()), [&](tbb::blocked_range<size_t> const& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                _txs[i].safeSender();
+            }
+        });
+    std::vector<Json::Value> txs(_txs.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs.size()), [&](tbb::blocked_range<size_t> const& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                txs[i] = toJson(_txs[i], std::make_pair(_blockHash, (unsigned)i), _blockNumber);
+            }
+        });
+    Json::Value res(Json::arrayValue);
+    res.resize(_txs.size());
+    for (unsigned i = 0; i < _txs.size(); ++i)
+    {
+        res[i].swap(txs[i]);
+    }
+    return res;
+}
+
+Json::Value toJsonHashes(Transactions const& _txs)
+{
+    std::vector<std::string> hashes(_txs.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs.size()), [&](tbb::blocked_range<size_t> const& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                hashes[i] = toJS(_txs[i].sha3());
+            }
+        });
+    Json::Value res(Json::arrayValue);
+    res.resize(_txs.size());
+    for (unsigned i = 0; i < _txs.size(); ++i)
+    {
+        res[i] = std::move(hashes[i]);
+    }
+    return res;
+}
+
 TransactionSkeleton toTransactionSkeleton(Json::Value const& _json)
 {
     TransactionSkeleton ret;
@@ -92,6 +156,93 @@ TransactionSkeleton toTransactionSkeleton(Json::Value const& _json)
     return ret;
 }
 
+LogFilter toLogFilter(Json::Value const& _json)
+{
+    LogFilter filter;
+    Json::Value const& addresses = _json["addresses"];
+    if (addresses.isString())
+    {
+        filter.addresses.insert(jsToAddress(addresses.asString()));
+    }
+    else if (addresses.isArray())
+    {
+        for (auto const& address : addresses)
+        {
+            filter.addresses.insert(jsToAddress(address.asString()));
+        }
+    }
+    Json::Value const& topics = _json["topics"];
+    if (!topics.isNull() && !topics.isArray())
+    {
+        BOOST_THROW_EXCEPTION(WrongFieldType() << errinfo_comment("topics"));
+    }
+    for (auto const& position : topics)
+    {
+        std::set<h256> values;
+        if (position.isArray())
+        {
+            for (auto const& topic : position)
+            {
+                values.insert(toTopic(topic));
+            }
+        }
+        else if (!position.isNull())
+        {
+            values.insert(toTopic(position));
+        }
+        filter.topics.push_back(values);
+    }
+    return filter;
+}
+
+Json::Value toJson(LocalisedLogEntry const& _log)
+{
+    Json::Value res;
+    res["blockNumber"] = toJS(_log.blockNumber);
+    res["blockHash"] = toJS(_log.blockHash);
+    res["transactionHash"] = toJS(_log.transactionHash);
+    res["transactionIndex"] = toJS(_log.transactionIndex);
+    res["logIndex"] = toJS(_log.logIndex);
+    res["address"] = toJS(_log.address);
+    res["topics"] = Json::Value(Json::arrayValue);
+    for (auto const& topic : _log.topics)
+    {
+        res["topics"].append(toJS(topic));
+    }
+    res["data"] = toJS(_log.data);
+    return res;
+}
+
+Json::Value toJson(LocalisedTransactionReceipt const& _receipt)
+{
+    Json::Value res;
+    res["transactionHash"] = toJS(_receipt.hash());
+    res["transactionIndex"] = toJS(_receipt.transactionIndex());
+    res["blockNumber"] = toJS(_receipt.blockNumber());
+    res["blockHash"] = toJS(_receipt.blockHash());
+    res["from"] = toJS(_receipt.from());
+    res["to"] = toJS(_receipt.to());
+    res["gasUsed"] = toJS(_receipt.gasUsed());
+    res["contractAddress"] = toJS(_receipt.contractAddress());
+    res["logs"] = Json::Value(Json::arrayValue);
+    for (auto const& log : _receipt.log())
+    {
+        Json::Value entry;
+        entry["address"] = toJS(log.address);
+        entry["topics"] = Json::Value(Json::arrayValue);
+        for (auto const& topic : log.topics)
+        {
+            entry["topics"].append(toJS(topic));
+        }
+        entry["data"] = toJS(log.data);
+        res["logs"].append(entry);
+    }
+    res["logsBloom"] = toJS(_receipt.bloom());
+    res["status"] = toJS(_receipt.status());
+    res["output"] = toJS(_receipt.outputBytes());
+    return res;
+}
+
 }  // namespace rpc
 
 }  // namespace dev
@@ -22,6 +22,7 @@
 
 #include <json/json.h>
 #include <libethcore/Common.h>
+#include <libethcore/LogFilter.h>
 
 namespace dev
 {
@@ -29,7 +30,18 @@ namespace rpc
 {
 Json::Value toJson(dev::eth::Transaction const& _t, std::pair<h256, unsigned> _location,
     dev::eth::BlockNumber _blockNumber);
+/// the transactions of a block, their senders are recovered and they are serialized in parallel
+Json::Value toJson(dev::eth::Transactions const& _txs, h256 const& _blockHash,
+    dev::eth::BlockNumber _blockNumber);
+/// the hashes of the transactions of a block, hashed in parallel
+Json::Value toJsonHashes(dev::eth::Transactions const& _txs);
 dev::eth::TransactionSkeleton toTransactionSkeleton(Json::Value const& _json);
+/// {"addresses": an address or [...], "topics": [a topic, [topics] or null, ...]}, throws on a
+/// malformed address or topic
+dev::eth::LogFilter toLogFilter(Json::Value const& _json);
+Json::Value toJson(dev::eth::LocalisedLogEntry const& _log);
+/// the receipt pushed to the sdk which sent the transaction
+Json::Value toJson(dev::eth::LocalisedTransactionReceipt const& _receipt);
 
 }  // namespace rpc
 
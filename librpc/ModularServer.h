@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "BatchProtocolHandler.h"
+#include "QueryExecutor.h"
 #include <jsonrpccpp/common/exception.h>
 #include <jsonrpccpp/common/procedure.h>
 #include <jsonrpccpp/server/abstractserverconnector.h>
@@ -85,9 +87,11 @@ template <class... Is>
 class ModularServer : public jsonrpc::IProcedureInvokationHandler
 {
 public:
+    /// the calls of a batch are handled in parallel
     ModularServer()
-      : m_handler(jsonrpc::RequestHandlerFactory::createProtocolHandler(
-            jsonrpc::JSONRPC_SERVER_V2, *this))
+      : m_handler(new rpc::BatchProtocolHandler(
+            jsonrpc::RequestHandlerFactory::createProtocolHandler(
+                jsonrpc::JSONRPC_SERVER_V2, *this)))
     {
         m_handler->AddProcedure(jsonrpc::Procedure(
             "rpc_modules", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL));
@@ -145,11 +149,18 @@ public:
         return m_connectors.at(_i).get();
     }
 
+    /// the methods run on the pools of _queryExecutor instead of the threads of the connectors
+    void setQueryExecutor(rpc::QueryExecutor::Ptr _queryExecutor)
+    {
+        m_queryExecutor = _queryExecutor;
+    }
+
 protected:
     std::vector<std::unique_ptr<jsonrpc::AbstractServerConnector>> m_connectors;
     std::unique_ptr<jsonrpc::IProtocolHandler> m_handler;
     /// Mapping for implemented modules, to be filled by subclasses during construction.
     Json::Value m_implementedModules;
+    rpc::QueryExecutor::Ptr m_queryExecutor;
 };
 
 template <class I, class... Is>
@@ -188,7 +199,15 @@ public:
         {
             try
             {
-                (m_interface.get()->*(pointer->second))(_input, _output);
+                auto method = [&]() { (m_interface.get()->*(pointer->second))(_input, _output); };
+                if (this->m_queryExecutor)
+                {
+                    this->m_queryExecutor->execute(_proc.GetProcedureName(), method);
+                }
+                else
+                {
+                    method();
+                }
             }
             catch (jsonrpc::JsonRpcException& e)
             {
@@ -0,0 +1,73 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file QueryExecutor.cpp
+ * @brief the bounded pools running the read-only RPC methods
+ */
+
+#include "QueryExecutor.h"
+#include "Common.h"
+#include <jsonrpccpp/common/exception.h>
+#include <libdevcore/easylog.h>
+#include <future>
+
+using namespace dev;
+using namespace dev::rpc;
+
+QueryExecutor::QueryExecutor(size_t _queryThreads, size_t _callThreads, size_t _maxPending)
+  : m_maxPending(_maxPending)
+{
+    m_queries.threadPool =
+        std::make_shared<ThreadPool>("RPCQuery", _queryThreads, TaskPriority::Low);
+    m_calls.threadPool = std::make_shared<ThreadPool>("RPCCall", _callThreads, TaskPriority::Low);
+}
+
+void QueryExecutor::execute(std::string const& _method, std::function<void()> const& _f)
+{
+    /// the transactions are sent on the thread of the request, which holds their receipt callback
+    if (_method == "sendRawTransaction" || _method == "sendRawTransactions")
+    {
+        _f();
+        return;
+    }
+    execute(_method == "call" ? m_calls : m_queries, _f);
+}
+
+void QueryExecutor::execute(Pool& _pool, std::function<void()> const& _f)
+{
+    if (++_pool.pending > m_maxPending)
+    {
+        --_pool.pending;
+        RPC_LOG(WARNING) << LOG_BADGE("QueryExecutor") << LOG_DESC("reject the query, busy")
+                         << LOG_KV("maxPending", m_maxPending);
+        BOOST_THROW_EXCEPTION(jsonrpc::JsonRpcException(
+            RPCExceptionType::Busy, RPCMsg[RPCExceptionType::Busy]));
+    }
+    auto pool = &_pool;
+    auto task = std::make_shared<std::packaged_task<void()>>([_f, pool]() {
+        /// leaves the pool before the caller wakes up, thrown or not
+        struct Pending
+        {
+            ~Pending() { --pool->pending; }
+            Pool* pool;
+        } pending{pool};
+        _f();
+    });
+    auto result = task->get_future();
+    _pool.threadPool->enqueue([task]() { (*task)(); });
+    Executor::Blocking blocking;
+    result.get();
+}
@@ -0,0 +1,71 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file QueryExecutor.h
+ * @brief the bounded pools running the read-only RPC methods
+ */
+
+#pragma once
+
+#include <libdevcore/ThreadPool.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace dev
+{
+namespace rpc
+{
+/// default threads of the getters and of the calls
+static const size_t c_queryThreads = 8;
+static const size_t c_callThreads = 4;
+/// default methods queued or running in a pool before the next ones are rejected as busy
+static const size_t c_maxPendingQueries = 1024;
+
+/// Runs the read-only RPC methods on pools of a bounded size, apart from the calls executing
+/// contracts, so that however many connections query the node, the queries taking the locks of
+/// the blockchain and the storage are limited, and a flood of them is rejected at once as busy
+/// instead of queuing up. The methods sending transactions run on the thread of the request.
+class QueryExecutor
+{
+public:
+    typedef std::shared_ptr<QueryExecutor> Ptr;
+
+    QueryExecutor(size_t _queryThreads = c_queryThreads, size_t _callThreads = c_callThreads,
+        size_t _maxPending = c_maxPendingQueries);
+
+    /// run _method on its pool and wait for it, the exceptions are thrown to the caller
+    void execute(std::string const& _method, std::function<void()> const& _f);
+
+    size_t pendingQueries() const { return m_queries.pending; }
+    size_t pendingCalls() const { return m_calls.pending; }
+
+private:
+    struct Pool
+    {
+        ThreadPool::Ptr threadPool;
+        std::atomic<size_t> pending = {0};
+    };
+    void execute(Pool& _pool, std::function<void()> const& _f);
+
+    Pool m_queries;
+    Pool m_calls;
+    size_t m_maxPending;
+};
+
+}  // namespace rpc
+}  // namespace dev
@@ -0,0 +1,119 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file ResponseCache.cpp
+ * @brief the LRU of the RPC responses
+ */
+
+#include "ResponseCache.h"
+
+using namespace dev;
+using namespace dev::rpc;
+
+static std::string cacheKey(int _groupID, std::string const& _method, std::string const& _params)
+{
+    return std::to_string(_groupID) + '\0' + _method + '\0' + _params;
+}
+
+bool ResponseCache::get(
+    int _groupID, std::string const& _method, std::string const& _params, Json::Value& _response)
+{
+    Guard l(x_cache);
+    auto it = m_index.find(cacheKey(_groupID, _method, _params));
+    if (it == m_index.end())
+    {
+        return false;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    _response = it->second->response;
+    return true;
+}
+
+void ResponseCache::put(int _groupID, std::string const& _method, std::string const& _params,
+    Json::Value const& _response, bool _mutable)
+{
+    /// the size as the response is written to the client
+    size_t bytes = Json::FastWriter().write(_response).size();
+    if (bytes > m_maxBytes)
+    {
+        return;
+    }
+    auto key = cacheKey(_groupID, _method, _params);
+    Guard l(x_cache);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        erase(it->second);
+    }
+    m_entries.push_front(Entry{key, _groupID, _mutable, _response, bytes});
+    m_index[key] = m_entries.begin();
+    if (_mutable)
+    {
+        m_mutableKeys[_groupID].insert(key);
+    }
+    m_bytes += bytes;
+    while (m_bytes > m_maxBytes)
+    {
+        erase(std::prev(m_entries.end()));
+    }
+}
+
+void ResponseCache::onBlockCommitted(int _groupID)
+{
+    Guard l(x_cache);
+    auto it = m_mutableKeys.find(_groupID);
+    if (it == m_mutableKeys.end())
+    {
+        return;
+    }
+    auto keys = std::move(it->second);
+    m_mutableKeys.erase(it);
+    for (auto const& key : keys)
+    {
+        auto entry = m_index.find(key);
+        if (entry != m_index.end())
+        {
+            erase(entry->second);
+        }
+    }
+}
+
+void ResponseCache::erase(std::list<Entry>::iterator _it)
+{
+    if (_it->isMutable)
+    {
+        auto keys = m_mutableKeys.find(_it->groupID);
+        if (keys != m_mutableKeys.end())
+        {
+            keys->second.erase(_it->key);
+        }
+    }
+    m_bytes -= _it->bytes;
+    m_index.erase(_it->key);
+    m_entries.erase(_it);
+}
+
+size_t ResponseCache::size() const
+{
+    Guard l(x_cache);
+    return m_entries.size();
+}
+
+size_t ResponseCache::bytes() const
+{
+    Guard l(x_cache);
+    return m_bytes;
+}
@@ -0,0 +1,81 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @file ResponseCache.h
+ * @brief the LRU of the RPC responses
+ */
+
+#pragma once
+
+#include <json/json.h>
+#include <libdevcore/Guards.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace dev
+{
+namespace rpc
+{
+/// default bytes of the responses cached
+static const size_t c_responseCacheBytes = 64 * 1024 * 1024;
+
+/// The responses of the RPC queries by (group, method, params), evicted by the least recently
+/// used when their serialized size is over the limit. A response of the committed blocks never
+/// changes and stays until evicted. A response depending on the latest block is put as mutable
+/// and dropped when the next block of its group is committed.
+class ResponseCache
+{
+public:
+    typedef std::shared_ptr<ResponseCache> Ptr;
+
+    explicit ResponseCache(size_t _maxBytes = c_responseCacheBytes) : m_maxBytes(_maxBytes) {}
+
+    bool get(int _groupID, std::string const& _method, std::string const& _params,
+        Json::Value& _response);
+    void put(int _groupID, std::string const& _method, std::string const& _params,
+        Json::Value const& _response, bool _mutable = false);
+    /// drop the mutable responses of _groupID
+    void onBlockCommitted(int _groupID);
+
+    size_t size() const;
+    size_t bytes() const;
+
+private:
+    struct Entry
+    {
+        std::string key;
+        int groupID;
+        bool isMutable;
+        Json::Value response;
+        size_t bytes;
+    };
+    void erase(std::list<Entry>::iterator _it);
+
+    size_t m_maxBytes;
+    mutable Mutex x_cache;
+    /// the most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    std::map<int, std::set<std::string>> m_mutableKeys;
+    size_t m_bytes = 0;
+};
+
+}  // namespace rpc
+}  // namespace dev
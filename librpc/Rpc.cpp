@@ -27,11 +27,17 @@
 #include <jsonrpccpp/server.h>
 #include <libconfig/GlobalConfigure.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Common.h>
 #include <libethcore/CommonJS.h>
+#include <libethcore/Instruction.h>
 #include <libethcore/Transaction.h>
 #include <libexecutive/ExecutionResult.h>
+#include <libinterpreter/VMProfile.h>
+#include <libstorage/AccessSet.h>
+#include <libp2p/P2PMessageRC2.h>
 #include <libsync/SyncStatus.h>
 #include <libtxpool/TxPoolInterface.h>
 #include <boost/algorithm/hex.hpp>
@@ -45,6 +51,20 @@ using namespace dev::ledger;
 static const int64_t maxTransactionGasLimit = 0x7fffffffffffffff;
 static const int64_t gasPrice = 1;
 
+static Json::Value pendingTransactionToJson(Transaction const& _tx)
+{
+    Json::Value txJson;
+    txJson["from"] = toJS(_tx.from());
+    txJson["gas"] = toJS(_tx.gas());
+    txJson["gasPrice"] = toJS(_tx.gasPrice());
+    txJson["hash"] = toJS(_tx.sha3());
+    txJson["input"] = toJS(_tx.data());
+    txJson["nonce"] = toJS(_tx.nonce());
+    txJson["to"] = toJS(_tx.to());
+    txJson["value"] = toJS(_tx.value());
+    return txJson;
+}
+
 std::map<int, std::string> dev::rpc::RPCMsg{{RPCExceptionType::Success, "Success"},
     {RPCExceptionType::GroupID, "GroupID does not exist"},
     {RPCExceptionType::JsonParse, "Response json parse error"},
@@ -55,7 +75,15 @@ std::map<int, std::string> dev::rpc::RPCMsg{{RPCExceptionType::Success, "Success
     {RPCExceptionType::NoView, "Only pbft consensus supports the view property"},
     {RPCExceptionType::InvalidSystemConfig, "Invalid System Config"},
     {RPCExceptionType::InvalidRequest,
-        "Don't send request to this node who doesn't belong to the group"}};
+        "Don't send request to this node who doesn't belong to the group"},
+    {RPCExceptionType::NoStorageStats, "Storage stats are off, set storage.stats to true"},
+    {RPCExceptionType::Busy, "The node is busy with the queries, try again later"},
+    {RPCExceptionType::TooManyLogs, "Too many logs matched, narrow the range of blocks"},
+    {RPCExceptionType::NoGroupResources, "The group isn't scheduled"},
+    {RPCExceptionType::NoTrace, "Tracing is off, set trace.enable to true"},
+    {RPCExceptionType::InvalidCheckpointName,
+        "The checkpoint name may only have letters, digits, '_', '-' and '.'"},
+    {RPCExceptionType::NoCheckpoint, "Only the rocksdb storage can be copied online"}};
 
 Rpc::Rpc(std::shared_ptr<dev::ledger::LedgerManager> _ledgerManager,
     std::shared_ptr<dev::p2p::P2PInterface> _service)
@@ -278,6 +306,58 @@ Json::Value Rpc::getConsensusStatus(int _groupID)
     }
 }
 
+Json::Value Rpc::getStorageStats(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getStorageStats") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        auto stats = ledgerManager()->storageStats(_groupID);
+        if (stats.isNull())
+            BOOST_THROW_EXCEPTION(JsonRpcException(
+                RPCExceptionType::NoStorageStats, RPCMsg[RPCExceptionType::NoStorageStats]));
+
+        return stats;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getGroupResources(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getGroupResources") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        auto stats = ledgerManager()->groupStats(_groupID);
+        if (stats.isNull())
+            BOOST_THROW_EXCEPTION(JsonRpcException(RPCExceptionType::NoGroupResources,
+                RPCMsg[RPCExceptionType::NoGroupResources]));
+
+        return stats;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
 Json::Value Rpc::getSyncStatus(int _groupID)
 {
     try
@@ -408,6 +488,308 @@ Json::Value Rpc::getNodeIDList(int _groupID)
     }
 }
 
+Json::Value Rpc::getCompressStats(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getCompressStats") << LOG_DESC("request");
+
+        checkRequest(_groupID);
+        auto& stats = dev::p2p::compressStats();
+        Json::Value response(Json::objectValue);
+        response["enabled"] = g_BCOSConfig.compressEnabled();
+        response["threshold"] = (Json::UInt64)g_BCOSConfig.c_compressThreshold;
+
+        Json::Value sent(Json::objectValue);
+        uint64_t originBytes = stats.originBytes;
+        uint64_t compressedBytes = stats.compressedBytes;
+        sent["compressed"] = (Json::UInt64)stats.compressed.load();
+        sent["skipped"] = (Json::UInt64)stats.skipped.load();
+        sent["originBytes"] = (Json::UInt64)originBytes;
+        sent["compressedBytes"] = (Json::UInt64)compressedBytes;
+        sent["ratio"] = compressedBytes > 0 ? (double)originBytes / compressedBytes : 0.0;
+        sent["timeUs"] = (Json::UInt64)stats.compressTimeUs.load();
+        response["sent"] = sent;
+
+        Json::Value received(Json::objectValue);
+        uint64_t receivedBytes = stats.receivedBytes;
+        uint64_t uncompressedBytes = stats.uncompressedBytes;
+        received["uncompressed"] = (Json::UInt64)stats.uncompressed.load();
+        received["failed"] = (Json::UInt64)stats.uncompressFailed.load();
+        received["compressedBytes"] = (Json::UInt64)receivedBytes;
+        received["originBytes"] = (Json::UInt64)uncompressedBytes;
+        received["ratio"] = receivedBytes > 0 ? (double)uncompressedBytes / receivedBytes : 0.0;
+        received["timeUs"] = (Json::UInt64)stats.uncompressTimeUs.load();
+        response["received"] = received;
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getTrafficStats(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getTrafficStats") << LOG_DESC("request");
+
+        checkRequest(_groupID);
+        Json::Value response = Json::Value(Json::arrayValue);
+
+        /// the traffic of all the groups, to compare the groups sharing the links
+        auto stats = service()->trafficStats();
+        for (auto const& it : stats)
+        {
+            auto groupAndModule = dev::eth::getGroupAndProtocol(it.first);
+            Json::Value traffic;
+            traffic["GroupID"] = groupAndModule.first;
+            traffic["ModuleID"] = groupAndModule.second;
+            traffic["InBytes"] = (Json::UInt64)it.second.inBytes;
+            traffic["InMessages"] = (Json::UInt64)it.second.inMessages;
+            traffic["OutBytes"] = (Json::UInt64)it.second.outBytes;
+            traffic["OutMessages"] = (Json::UInt64)it.second.outMessages;
+            traffic["ShapedMessages"] = (Json::UInt64)it.second.shapedMessages;
+            response.append(traffic);
+        }
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getPeerStats(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getPeerStats") << LOG_DESC("request");
+
+        checkRequest(_groupID);
+        Json::Value response = Json::Value(Json::arrayValue);
+
+        auto sessions = service()->sessionInfos();
+        for (auto const& it : sessions)
+        {
+            Json::Value peer;
+            peer["NodeID"] = it.nodeInfo.nodeID.hex();
+            peer["IPAndPort"] = it.nodeIPEndpoint.name();
+            peer["RTT"] = (Json::UInt64)it.stat.rtt;
+            peer["InBytes"] = (Json::UInt64)it.stat.inBytes;
+            peer["InMessages"] = (Json::UInt64)it.stat.inMessages;
+            peer["InRate"] = (Json::UInt64)it.stat.inRate;
+            peer["OutBytes"] = (Json::UInt64)it.stat.outBytes;
+            peer["OutMessages"] = (Json::UInt64)it.stat.outMessages;
+            peer["WriteQueueBytes"] = (Json::UInt64)it.stat.writeQueueBytes;
+            response.append(peer);
+        }
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getMetrics(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getMetrics") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        Json::Value response = Json::Value(Json::arrayValue);
+
+        auto group = std::to_string(_groupID);
+        for (auto const& sample : g_metrics.samples())
+        {
+            auto it = sample.labels.find("group");
+            if (it != sample.labels.end() && it->second != group)
+            {
+                continue;
+            }
+            Json::Value metric;
+            metric["Name"] = sample.name;
+            metric["Type"] = sample.type;
+            metric["Labels"] = Json::Value(Json::objectValue);
+            for (auto const& label : sample.labels)
+            {
+                metric["Labels"][label.first] = label.second;
+            }
+            metric["Value"] = sample.value;
+            if (sample.type == "histogram")
+            {
+                metric["Count"] = (Json::UInt64)sample.count;
+                for (auto const& q : sample.quantiles)
+                {
+                    std::ostringstream quantile;
+                    quantile << q.first;
+                    metric["Quantiles"][quantile.str()] = (Json::UInt64)q.second;
+                }
+            }
+            response.append(metric);
+        }
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getEvmProfile(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getEvmProfile") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        auto contracts = dev::eth::VMProfiler::instance().contracts();
+        std::vector<std::pair<Address, dev::eth::ContractProfile const*>> sorted;
+        for (auto const& contract : contracts)
+        {
+            sorted.emplace_back(contract.first, &contract.second);
+        }
+        std::sort(sorted.begin(), sorted.end(),
+            [](std::pair<Address, dev::eth::ContractProfile const*> const& _a,
+                std::pair<Address, dev::eth::ContractProfile const*> const& _b) {
+                return _a.second->time() > _b.second->time();
+            });
+
+        Json::Value response = Json::Value(Json::arrayValue);
+        for (auto const& contract : sorted)
+        {
+            auto const& profile = *contract.second;
+            Json::Value item;
+            item["Address"] = "0x" + contract.first.hex();
+            item["Executions"] = (Json::UInt64)profile.executions;
+            item["TimeNs"] = (Json::UInt64)profile.time();
+            item["Categories"] = Json::Value(Json::objectValue);
+            for (size_t i = 0; i < dev::eth::c_opCategories; ++i)
+            {
+                if (profile.categoryOps[i] == 0)
+                {
+                    continue;
+                }
+                auto name = dev::eth::opCategoryName(static_cast<dev::eth::OpCategory>(i));
+                item["Categories"][name]["Ops"] = (Json::UInt64)profile.categoryOps[i];
+                item["Categories"][name]["TimeNs"] = (Json::UInt64)profile.categoryTime[i];
+            }
+            item["Opcodes"] = Json::Value(Json::objectValue);
+            for (size_t op = 0; op < profile.ops.size(); ++op)
+            {
+                if (profile.ops[op] > 0)
+                {
+                    auto info = dev::eth::instructionInfo(static_cast<dev::eth::Instruction>(op));
+                    item["Opcodes"][info.name] = (Json::UInt64)profile.ops[op];
+                }
+            }
+            response.append(item);
+        }
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::exportTrace(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("exportTrace") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        if (!g_tracer.enabled())
+            BOOST_THROW_EXCEPTION(
+                JsonRpcException(RPCExceptionType::NoTrace, RPCMsg[RPCExceptionType::NoTrace]));
+
+        Json::Value response;
+        response["Spans"] = (Json::UInt64)g_tracer.spans(_groupID).size();
+        response["File"] = g_tracer.exportTrace(_groupID);
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::checkpoint(int _groupID, const std::string& _name)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("checkpoint") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID) << LOG_KV("name", _name);
+
+        checkRequest(_groupID);
+        /// the name stays a directory of the group data
+        bool valid = !_name.empty() && _name != "." && _name != "..";
+        for (auto c : _name)
+            valid = valid && (isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.');
+        if (!valid)
+            BOOST_THROW_EXCEPTION(JsonRpcException(RPCExceptionType::InvalidCheckpointName,
+                RPCMsg[RPCExceptionType::InvalidCheckpointName]));
+
+        auto response = ledgerManager()->checkpoint(_groupID, _name);
+        if (response.isNull())
+            BOOST_THROW_EXCEPTION(JsonRpcException(
+                RPCExceptionType::NoCheckpoint, RPCMsg[RPCExceptionType::NoCheckpoint]));
+
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
 Json::Value Rpc::getGroupPeers(int _groupID)
 {
     try
@@ -477,11 +859,16 @@ Json::Value Rpc::getBlockByHash(
 
         checkRequest(_groupID);
         Json::Value response;
+        std::string params = _blockHash + (_includeTransactions ? ",true" : ",false");
+        if (m_responseCache && m_responseCache->get(_groupID, "getBlockByHash", params, response))
+        {
+            return response;
+        }
 
         auto blockchain = ledgerManager()->blockChain(_groupID);
 
         h256 hash = jsToFixed<32>(_blockHash);
-        auto block = blockchain->getBlockByHash(hash);
+        auto block = blockchain->getBlockByHashNoReceipts(hash);
         if (!block)
             BOOST_THROW_EXCEPTION(
                 JsonRpcException(RPCExceptionType::BlockHash, RPCMsg[RPCExceptionType::BlockHash]));
@@ -507,16 +894,19 @@ Json::Value Rpc::getBlockByHash(
         response["gasUsed"] = toJS(block->header().gasUsed());
         response["timestamp"] = toJS(block->header().timestamp());
         const Transactions& transactions = block->transactions();
-        response["transactions"] = Json::Value(Json::arrayValue);
-        for (unsigned i = 0; i < transactions.size(); i++)
+        if (_includeTransactions)
+        {
+            response["transactions"] = toJson(transactions, hash, block->header().number());
+        }
+        else
         {
-            if (_includeTransactions)
-                response["transactions"].append(
-                    toJson(transactions[i], std::make_pair(hash, i), block->header().number()));
-            else
-                response["transactions"].append(toJS(transactions[i].sha3()));
+            response["transactions"] = toJsonHashes(transactions);
         }
 
+        if (m_responseCache)
+        {
+            m_responseCache->put(_groupID, "getBlockByHash", params, response);
+        }
         return response;
     }
     catch (JsonRpcException& e)
@@ -544,9 +934,14 @@ Json::Value Rpc::getBlockByNumber(
         Json::Value response;
 
         BlockNumber number = jsToBlockNumber(_blockNumber);
+        std::string params = std::to_string(number) + (_includeTransactions ? ",true" : ",false");
+        if (m_responseCache && m_responseCache->get(_groupID, "getBlockByNumber", params, response))
+        {
+            return response;
+        }
         auto blockchain = ledgerManager()->blockChain(_groupID);
 
-        auto block = blockchain->getBlockByNumber(number);
+        auto block = blockchain->getBlockByNumberNoReceipts(number);
         if (!block)
             BOOST_THROW_EXCEPTION(JsonRpcException(
                 RPCExceptionType::BlockNumberT, RPCMsg[RPCExceptionType::BlockNumberT]));
@@ -574,16 +969,20 @@ Json::Value Rpc::getBlockByNumber(
         response["gasUsed"] = toJS(block->header().gasUsed());
         response["timestamp"] = toJS(block->header().timestamp());
         const Transactions& transactions = block->transactions();
-        response["transactions"] = Json::Value(Json::arrayValue);
-        for (unsigned i = 0; i < transactions.size(); i++)
+        if (_includeTransactions)
+        {
+            response["transactions"] =
+                toJson(transactions, block->headerHash(), block->header().number());
+        }
+        else
         {
-            if (_includeTransactions)
-                response["transactions"].append(toJson(transactions[i],
-                    std::make_pair(block->headerHash(), i), block->header().number()));
-            else
-                response["transactions"].append(toJS(transactions[i].sha3()));
+            response["transactions"] = toJsonHashes(transactions);
         }
 
+        if (m_responseCache)
+        {
+            m_responseCache->put(_groupID, "getBlockByNumber", params, response);
+        }
         return response;
     }
     catch (JsonRpcException& e)
@@ -631,6 +1030,11 @@ Json::Value Rpc::getTransactionByHash(int _groupID, const std::string& _transact
 
         checkRequest(_groupID);
         Json::Value response;
+        if (m_responseCache &&
+            m_responseCache->get(_groupID, "getTransactionByHash", _transactionHash, response))
+        {
+            return response;
+        }
         auto blockchain = ledgerManager()->blockChain(_groupID);
 
         h256 hash = jsToFixed<32>(_transactionHash);
@@ -650,6 +1054,10 @@ Json::Value Rpc::getTransactionByHash(int _groupID, const std::string& _transact
         response["transactionIndex"] = toJS(tx.transactionIndex());
         response["value"] = toJS(tx.value());
 
+        if (m_responseCache)
+        {
+            m_responseCache->put(_groupID, "getTransactionByHash", _transactionHash, response);
+        }
         return response;
     }
     catch (JsonRpcException& e)
@@ -779,6 +1187,11 @@ Json::Value Rpc::getTransactionReceipt(int _groupID, const std::string& _transac
 
         checkRequest(_groupID);
         Json::Value response;
+        if (m_responseCache &&
+            m_responseCache->get(_groupID, "getTransactionReceipt", _transactionHash, response))
+        {
+            return response;
+        }
 
         auto blockchain = ledgerManager()->blockChain(_groupID);
 
@@ -810,6 +1223,10 @@ Json::Value Rpc::getTransactionReceipt(int _groupID, const std::string& _transac
         response["status"] = toJS(txReceipt.status());
         response["output"] = toJS(txReceipt.outputBytes());
 
+        if (m_responseCache)
+        {
+            m_responseCache->put(_groupID, "getTransactionReceipt", _transactionHash, response);
+        }
         return response;
     }
     catch (JsonRpcException& e)
@@ -838,19 +1255,9 @@ Json::Value Rpc::getPendingTransactions(int _groupID)
 
         response = Json::Value(Json::arrayValue);
         Transactions transactions = txPool->pendingList();
-        for (size_t i = 0; i < transactions.size(); ++i)
+        for (auto const& tx : transactions)
         {
-            auto tx = transactions[i];
-            Json::Value txJson;
-            txJson["from"] = toJS(tx.from());
-            txJson["gas"] = toJS(tx.gas());
-            txJson["gasPrice"] = toJS(tx.gasPrice());
-            txJson["hash"] = toJS(tx.sha3());
-            txJson["input"] = toJS(tx.data());
-            txJson["nonce"] = toJS(tx.nonce());
-            txJson["to"] = toJS(tx.to());
-            txJson["value"] = toJS(tx.value());
-            response.append(txJson);
+            response.append(pendingTransactionToJson(tx));
         }
 
         return response;
@@ -889,6 +1296,36 @@ std::string Rpc::getPendingTxSize(int _groupID)
     }
 }
 
+Json::Value Rpc::getTxPoolStatus(int _groupID)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getTxPoolStatus") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID);
+
+        checkRequest(_groupID);
+        auto txPool = ledgerManager()->txPool(_groupID);
+
+        Json::Value response;
+        auto status = txPool->status();
+        response["pendingTxSize"] = toJS(status.current);
+        response["droppedTxSize"] = toJS(status.dropped);
+        response["memory"] = toJS(status.memory);
+        response["pendingReceipts"] = toJS(status.pendingNotifications);
+        response["notifyTimeCost"] = toJS(status.notifyTimeCost);
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
 std::string Rpc::getCode(int _groupID, const std::string& _address)
 {
     try
@@ -897,9 +1334,20 @@ std::string Rpc::getCode(int _groupID, const std::string& _address)
                       << LOG_KV("address", _address);
 
         checkRequest(_groupID);
+        Json::Value response;
+        if (m_responseCache && m_responseCache->get(_groupID, "getCode", _address, response))
+        {
+            return response.asString();
+        }
         auto blockChain = ledgerManager()->blockChain(_groupID);
 
-        return toJS(blockChain->getCode(jsToAddress(_address)));
+        /// the code of an address may be deployed by the next block
+        std::string code = toJS(blockChain->getCode(jsToAddress(_address)));
+        if (m_responseCache)
+        {
+            m_responseCache->put(_groupID, "getCode", _address, Json::Value(code), true);
+        }
+        return code;
     }
     catch (JsonRpcException& e)
     {
@@ -961,16 +1409,35 @@ Json::Value Rpc::call(int _groupID, const Json::Value& request)
                 RPCExceptionType::BlockNumberT, RPCMsg[RPCExceptionType::BlockNumberT]));
 
         TransactionSkeleton txSkeleton = toTransactionSkeleton(request);
+        /// a call of the latest block is answered once until the next block is committed
+        std::string params = toJS(blockNumber) + ',' + txSkeleton.from.hex() + ',' +
+                             txSkeleton.to.hex() + ',' + toJS(txSkeleton.value) + ',' +
+                             toHex(txSkeleton.data);
+        Json::Value response;
+        if (m_responseCache && m_responseCache->get(_groupID, "call", params, response))
+        {
+            return response;
+        }
+
         Transaction tx(txSkeleton.value, gasPrice, maxTransactionGasLimit, txSkeleton.to,
             txSkeleton.data, txSkeleton.nonce);
         auto blockHeader = block->header();
         tx.forceSender(txSkeleton.from);
-        auto executionResult = blockverfier->executeTransaction(blockHeader, tx);
+        /// the keys accessed by the call, its writes are dropped with its context
+        dev::storage::AccessSet accessSet;
+        auto executionResult = [&]() {
+            dev::storage::AccessSet::Scope accessSetScope(m_responseCache ? &accessSet : nullptr);
+            return blockverfier->executeTransaction(blockHeader, tx);
+        }();
 
-        Json::Value response;
         response["currentBlockNumber"] = toJS(blockNumber);
         response["status"] = toJS(executionResult.second.status());
         response["output"] = toJS(executionResult.second.outputBytes());
+        /// a call writing the state is not a query, it is not answered from the cache
+        if (m_responseCache && accessSet.writes().empty())
+        {
+            m_responseCache->put(_groupID, "call", params, response, true);
+        }
         return response;
     }
     catch (JsonRpcException& e)
@@ -1000,37 +1467,8 @@ std::string Rpc::sendRawTransaction(int _groupID, const std::string& _rlp)
         auto currentTransactionCallback = m_currentTransactionCallback.get();
         if (currentTransactionCallback)
         {
-            auto transactionCallback = *currentTransactionCallback;
-            tx.setRpcCallback([transactionCallback](LocalisedTransactionReceipt::Ptr receipt) {
-                Json::Value response;
-
-                response["transactionHash"] = toJS(receipt->hash());
-                response["transactionIndex"] = toJS(receipt->transactionIndex());
-                response["blockNumber"] = toJS(receipt->blockNumber());
-                response["blockHash"] = toJS(receipt->blockHash());
-                response["from"] = toJS(receipt->from());
-                response["to"] = toJS(receipt->to());
-                response["gasUsed"] = toJS(receipt->gasUsed());
-                response["contractAddress"] = toJS(receipt->contractAddress());
-                response["logs"] = Json::Value(Json::arrayValue);
-                for (unsigned int i = 0; i < receipt->log().size(); ++i)
-                {
-                    Json::Value log;
-                    log["address"] = toJS(receipt->log()[i].address);
-                    log["topics"] = Json::Value(Json::arrayValue);
-                    for (unsigned int j = 0; j < receipt->log()[i].topics.size(); ++j)
-                        log["topics"].append(toJS(receipt->log()[i].topics[j]));
-                    log["data"] = toJS(receipt->log()[i].data);
-                    response["logs"].append(log);
-                }
-                response["logsBloom"] = toJS(receipt->bloom());
-                response["status"] = toJS(receipt->status());
-                response["output"] = toJS(receipt->outputBytes());
-
-                auto receiptContent = response.toStyledString();
-
-                transactionCallback(receiptContent);
-            });
+            /// the receipt is encoded by the channel off the thread notifying it
+            tx.setRpcCallback(*currentTransactionCallback);
         }
         std::pair<h256, Address> ret = txPool->submit(tx);
 
@@ -1046,3 +1484,143 @@ std::string Rpc::sendRawTransaction(int _groupID, const std::string& _rlp)
             JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
     }
 }
+
+Json::Value Rpc::sendRawTransactions(int _groupID, const Json::Value& _rlps)
+{
+    try
+    {
+        RPC_LOG(TRACE) << LOG_BADGE("sendRawTransactions") << LOG_DESC("request")
+                       << LOG_KV("groupID", _groupID) << LOG_KV("size", _rlps.size());
+
+        checkRequest(_groupID);
+        checkTxReceive(_groupID);
+
+        auto txPool = ledgerManager()->txPool(_groupID);
+
+        std::vector<bytes> txsBytes;
+        for (auto const& rlp : _rlps)
+        {
+            txsBytes.push_back(jsToBytes(rlp.asString(), OnFailed::Throw));
+        }
+        std::vector<bytesConstRef> txsRef;
+        for (auto const& txBytes : txsBytes)
+        {
+            txsRef.push_back(ref(txBytes));
+        }
+        auto results = txPool->batchImport(txsRef);
+
+        Json::Value response = Json::Value(Json::arrayValue);
+        for (size_t i = 0; i < txsBytes.size(); ++i)
+        {
+            Json::Value result;
+            result["transactionHash"] = toJS(sha3(txsBytes[i]));
+            result["status"] = (int)results[i];
+            response.append(result);
+        }
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getLogs(int _groupID, const std::string& _fromBlock, const std::string& _toBlock,
+    const Json::Value& _filter)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getLogs") << LOG_DESC("request") << LOG_KV("groupID", _groupID)
+                      << LOG_KV("fromBlock", _fromBlock) << LOG_KV("toBlock", _toBlock);
+
+        checkRequest(_groupID);
+        auto blockchain = ledgerManager()->blockChain(_groupID);
+        int64_t from = (_fromBlock == "earliest") ? 0 : jsToBlockNumber(_fromBlock);
+        int64_t to = (_toBlock == "latest" || _toBlock.empty()) ? blockchain->number() :
+                                                                 jsToBlockNumber(_toBlock);
+
+        auto logs = blockchain->getLogs(toLogFilter(_filter), from, to);
+        if (logs.size() > c_maxLogs)
+        {
+            BOOST_THROW_EXCEPTION(JsonRpcException(
+                RPCExceptionType::TooManyLogs, RPCMsg[RPCExceptionType::TooManyLogs]));
+        }
+
+        Json::Value response(Json::arrayValue);
+        for (auto const& log : logs)
+        {
+            response.append(toJson(log));
+        }
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
+
+Json::Value Rpc::getPendingTransactionsPage(int _groupID, const std::string& _cursor, int _count)
+{
+    try
+    {
+        RPC_LOG(INFO) << LOG_BADGE("getPendingTransactionsPage") << LOG_DESC("request")
+                      << LOG_KV("groupID", _groupID) << LOG_KV("cursor", _cursor)
+                      << LOG_KV("count", _count);
+
+        checkRequest(_groupID);
+        if (_count <= 0 || (size_t)_count > c_maxPendingPage)
+        {
+            BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS,
+                "count should be in (0, " + std::to_string(c_maxPendingPage) + "]"));
+        }
+        /// "<hash of the last transaction>:<its import time>", empty for the first page
+        h256 after;
+        u256 afterTime;
+        if (!_cursor.empty())
+        {
+            auto separator = _cursor.find(':');
+            if (separator == std::string::npos)
+            {
+                BOOST_THROW_EXCEPTION(
+                    JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS, "invalid cursor"));
+            }
+            after = jsToFixed<32>(_cursor.substr(0, separator));
+            afterTime = jsToU256(_cursor.substr(separator + 1));
+        }
+
+        auto txPool = ledgerManager()->txPool(_groupID);
+        Transactions transactions = txPool->pendingList(after, afterTime, _count);
+
+        Json::Value response;
+        response["transactions"] = Json::Value(Json::arrayValue);
+        for (auto const& tx : transactions)
+        {
+            response["transactions"].append(pendingTransactionToJson(tx));
+        }
+        /// the cursor stays put on an empty page, the transactions imported later follow it
+        response["cursor"] = transactions.empty() ?
+                                 _cursor :
+                                 toJS(transactions.back().sha3()) + ":" +
+                                     toString(transactions.back().importTime());
+        return response;
+    }
+    catch (JsonRpcException& e)
+    {
+        throw e;
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
+    }
+}
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "ResponseCache.h"
 #include "RpcFace.h"
 #include <libdevcrypto/Common.h>
 #include <libledger/LedgerInterface.h>
@@ -63,12 +64,30 @@ public:
     // sync part
     Json::Value getSyncStatus(int _groupID) override;
 
+    // storage part
+    Json::Value getStorageStats(int _groupID) override;
+    Json::Value getGroupResources(int _groupID) override;
+
     // p2p part
     Json::Value getClientVersion() override;
     Json::Value getPeers(int _groupID) override;
     Json::Value getGroupPeers(int _groupID) override;
     Json::Value getGroupList() override;
     Json::Value getNodeIDList(int _groupID) override;
+    Json::Value getCompressStats(int _groupID) override;
+    Json::Value getTrafficStats(int _groupID) override;
+    Json::Value getPeerStats(int _groupID) override;
+    /// the metrics of the group and of the process, a histogram by its quantiles
+    Json::Value getMetrics(int _groupID) override;
+    /// the opcodes and their time for each contract the interpreter of the node executed since
+    /// tx_execute.evm_profile turned the profiling on, the slowest contract first
+    Json::Value getEvmProfile(int _groupID) override;
+    /// write the spans of the recent blocks of the group to a chrome://tracing file under
+    /// trace.path, return the file and the spans written
+    Json::Value exportTrace(int _groupID) override;
+    /// copy the storage and the consensus backup of the group online into snapshot/_name of the
+    /// group data, without stopping the node, return the copy and the number of its latest block
+    Json::Value checkpoint(int _groupID, const std::string& _name) override;
 
     // block part
     Json::Value getBlockByHash(
@@ -86,23 +105,35 @@ public:
     Json::Value getTransactionReceipt(int _groupID, const std::string& _transactionHash) override;
     Json::Value getPendingTransactions(int _groupID) override;
     std::string getPendingTxSize(int _groupID) override;
+    Json::Value getTxPoolStatus(int _groupID) override;
     std::string getCode(int _groupID, const std::string& address) override;
     Json::Value getTotalTransactionCount(int _groupID) override;
     Json::Value call(int _groupID, const Json::Value& request) override;
     std::string sendRawTransaction(int _groupID, const std::string& _rlp) override;
-
-    void setCurrentTransactionCallback(
-        std::function<void(const std::string& receiptContext)>* callback)
+    /// the transactions are imported as a batch, their receipts aren't pushed to the sdk
+    Json::Value sendRawTransactions(int _groupID, const Json::Value& _rlps) override;
+    /// _toBlock may be "latest", the filter is {"addresses": [...], "topics": [[...], ...]}
+    Json::Value getLogs(int _groupID, const std::string& _fromBlock, const std::string& _toBlock,
+        const Json::Value& _filter) override;
+    /// {"transactions": [...], "cursor": "<hash>:<import time>" of the last one}
+    Json::Value getPendingTransactionsPage(
+        int _groupID, const std::string& _cursor, int _count) override;
+
+    void setCurrentTransactionCallback(dev::eth::RPCCallback* callback)
     {
         m_currentTransactionCallback.reset(callback);
     }
     void clearCurrentTransactionCallback() { m_currentTransactionCallback.reset(NULL); }
 
+    /// the responses of the committed blocks and the transactions in them are cached
+    void setResponseCache(ResponseCache::Ptr _responseCache) { m_responseCache = _responseCache; }
+
 protected:
     std::shared_ptr<dev::ledger::LedgerManager> ledgerManager() { return m_ledgerManager; }
     std::shared_ptr<dev::ledger::LedgerManager> m_ledgerManager;
     std::shared_ptr<dev::p2p::P2PInterface> service() { return m_service; }
     std::shared_ptr<dev::p2p::P2PInterface> m_service;
+    ResponseCache::Ptr m_responseCache;
 
 private:
     bool isValidNodeId(dev::bytes const& precompileData,
@@ -111,8 +142,7 @@ private:
 
     /// transaction callback related
     std::function<std::function<void>()> setTransactionCallbackFactory();
-    boost::thread_specific_ptr<std::function<void(const std::string& receiptContext)> >
-        m_currentTransactionCallback;
+    boost::thread_specific_ptr<dev::eth::RPCCallback> m_currentTransactionCallback;
 
     void checkRequest(int _groupID);
     void checkTxReceive(int _groupID);
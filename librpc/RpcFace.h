@@ -58,6 +58,14 @@ public:
                                    jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
             &dev::rpc::RpcFace::getSyncStatusI);
 
+        this->bindAndAddMethod(jsonrpc::Procedure("getStorageStats", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getStorageStatsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getGroupResources",
+                                   jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",
+                                   jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getGroupResourcesI);
+
         this->bindAndAddMethod(jsonrpc::Procedure("getClientVersion", jsonrpc::PARAMS_BY_POSITION,
                                    jsonrpc::JSON_OBJECT, NULL),
             &dev::rpc::RpcFace::getClientVersionI);
@@ -73,6 +81,28 @@ public:
         this->bindAndAddMethod(jsonrpc::Procedure("getNodeIDList", jsonrpc::PARAMS_BY_POSITION,
                                    jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
             &dev::rpc::RpcFace::getNodeIDListI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getCompressStats", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getCompressStatsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getTrafficStats", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getTrafficStatsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getPeerStats", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getPeerStatsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getMetrics", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_ARRAY, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getMetricsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getEvmProfile", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_ARRAY, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getEvmProfileI);
+        this->bindAndAddMethod(jsonrpc::Procedure("exportTrace", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::exportTraceI);
+        this->bindAndAddMethod(jsonrpc::Procedure("checkpoint", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, "param2",
+                                   jsonrpc::JSON_STRING, NULL),
+            &dev::rpc::RpcFace::checkpointI);
 
         this->bindAndAddMethod(jsonrpc::Procedure("getBlockByHash", jsonrpc::PARAMS_BY_POSITION,
                                    jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, "param2",
@@ -112,6 +142,9 @@ public:
         this->bindAndAddMethod(jsonrpc::Procedure("getPendingTxSize", jsonrpc::PARAMS_BY_POSITION,
                                    jsonrpc::JSON_STRING, "param1", jsonrpc::JSON_INTEGER, NULL),
             &dev::rpc::RpcFace::getPendingTxSizeI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getTxPoolStatus", jsonrpc::PARAMS_BY_POSITION,
+                                   jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getTxPoolStatusI);
         this->bindAndAddMethod(
             jsonrpc::Procedure("call", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",
                 jsonrpc::JSON_INTEGER, "param2", jsonrpc::JSON_OBJECT, NULL),
@@ -121,6 +154,10 @@ public:
                                    jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, "param2",
                                    jsonrpc::JSON_STRING, NULL),
             &dev::rpc::RpcFace::sendRawTransactionI);
+        this->bindAndAddMethod(jsonrpc::Procedure("sendRawTransactions",
+                                   jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",
+                                   jsonrpc::JSON_INTEGER, "param2", jsonrpc::JSON_ARRAY, NULL),
+            &dev::rpc::RpcFace::sendRawTransactionsI);
 
         this->bindAndAddMethod(
             jsonrpc::Procedure("getCode", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
@@ -130,6 +167,16 @@ public:
             jsonrpc::Procedure("getTotalTransactionCount", jsonrpc::PARAMS_BY_POSITION,
                 jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL),
             &dev::rpc::RpcFace::getTotalTransactionCountI);
+        this->bindAndAddMethod(
+            jsonrpc::Procedure("getLogs", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
+                "param1", jsonrpc::JSON_INTEGER, "param2", jsonrpc::JSON_STRING, "param3",
+                jsonrpc::JSON_STRING, "param4", jsonrpc::JSON_OBJECT, NULL),
+            &dev::rpc::RpcFace::getLogsI);
+        this->bindAndAddMethod(jsonrpc::Procedure("getPendingTransactionsPage",
+                                   jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",
+                                   jsonrpc::JSON_INTEGER, "param2", jsonrpc::JSON_STRING, "param3",
+                                   jsonrpc::JSON_INTEGER, NULL),
+            &dev::rpc::RpcFace::getPendingTransactionsPageI);
     }
 
     inline virtual void getSystemConfigByKeyI(const Json::Value& request, Json::Value& response)
@@ -137,6 +184,23 @@ public:
         response = this->getSystemConfigByKey(
             boost::lexical_cast<int>(request[0u].asString()), request[1u].asString());
     }
+    inline virtual void sendRawTransactionsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->sendRawTransactions(
+            boost::lexical_cast<int>(request[0u].asString()), request[1u]);
+    }
+    inline virtual void getLogsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getLogs(boost::lexical_cast<int>(request[0u].asString()),
+            request[1u].asString(), request[2u].asString(), request[3u]);
+    }
+    inline virtual void getPendingTransactionsPageI(
+        const Json::Value& request, Json::Value& response)
+    {
+        response = this->getPendingTransactionsPage(
+            boost::lexical_cast<int>(request[0u].asString()), request[1u].asString(),
+            request[2u].asInt());
+    }
     inline virtual void getBlockNumberI(const Json::Value& request, Json::Value& response)
     {
         response = this->getBlockNumber(boost::lexical_cast<int>(request[0u].asString()));
@@ -163,6 +227,16 @@ public:
         response = this->getSyncStatus(boost::lexical_cast<int>(request[0u].asString()));
     }
 
+    inline virtual void getStorageStatsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getStorageStats(boost::lexical_cast<int>(request[0u].asString()));
+    }
+
+    inline virtual void getGroupResourcesI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getGroupResources(boost::lexical_cast<int>(request[0u].asString()));
+    }
+
     inline virtual void getClientVersionI(const Json::Value&, Json::Value& response)
     {
         response = this->getClientVersion();
@@ -183,6 +257,35 @@ public:
     {
         response = this->getNodeIDList(boost::lexical_cast<int>(request[0u].asString()));
     }
+    inline virtual void getCompressStatsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getCompressStats(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void getTrafficStatsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getTrafficStats(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void getPeerStatsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getPeerStats(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void getMetricsI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getMetrics(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void getEvmProfileI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getEvmProfile(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void exportTraceI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->exportTrace(boost::lexical_cast<int>(request[0u].asString()));
+    }
+    inline virtual void checkpointI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->checkpoint(
+            boost::lexical_cast<int>(request[0u].asString()), request[1u].asString());
+    }
 
     inline virtual void getBlockByHashI(const Json::Value& request, Json::Value& response)
     {
@@ -232,6 +335,10 @@ public:
     {
         response = this->getPendingTxSize(boost::lexical_cast<int>(request[0u].asString()));
     }
+    inline virtual void getTxPoolStatusI(const Json::Value& request, Json::Value& response)
+    {
+        response = this->getTxPoolStatus(boost::lexical_cast<int>(request[0u].asString()));
+    }
     inline virtual void getCodeI(const Json::Value& request, Json::Value& response)
     {
         response =
@@ -264,12 +371,24 @@ public:
     // sync part
     virtual Json::Value getSyncStatus(int param1) = 0;
 
+    // storage part
+    virtual Json::Value getStorageStats(int param1) = 0;
+    // the workers, the CPU time and the cache of the group in the process
+    virtual Json::Value getGroupResources(int param1) = 0;
+
     // p2p part
     virtual Json::Value getClientVersion() = 0;
     virtual Json::Value getPeers(int param1) = 0;
     virtual Json::Value getGroupPeers(int param1) = 0;
     virtual Json::Value getGroupList() = 0;
     virtual Json::Value getNodeIDList(int param1) = 0;
+    virtual Json::Value getCompressStats(int param1) = 0;
+    virtual Json::Value getTrafficStats(int param1) = 0;
+    virtual Json::Value getPeerStats(int param1) = 0;
+    virtual Json::Value getMetrics(int param1) = 0;
+    virtual Json::Value getEvmProfile(int param1) = 0;
+    virtual Json::Value exportTrace(int param1) = 0;
+    virtual Json::Value checkpoint(int param1, const std::string& param2) = 0;
 
     // block part
     virtual Json::Value getBlockByHash(int param1, const std::string& param2, bool param3) = 0;
@@ -292,6 +411,9 @@ public:
     virtual Json::Value getPendingTransactions(int param1) = 0;
     /// @return size about PendingTransactions.
     virtual std::string getPendingTxSize(int param1) = 0;
+    /// @return the pending and dropped transactions, the memory and the receipts waiting to be
+    /// notified of the transaction pool.
+    virtual Json::Value getTxPoolStatus(int param1) = 0;
     /// Returns code at a given address.
     virtual std::string getCode(int param1, const std::string& param2) = 0;
     /// Returns the count of transactions and blocknumber.
@@ -300,6 +422,13 @@ public:
     virtual Json::Value call(int param1, const Json::Value& param2) = 0;
     /// Creates new message call transaction or a contract creation for signed transactions.
     virtual std::string sendRawTransaction(int param1, const std::string& param2) = 0;
+    virtual Json::Value sendRawTransactions(int param1, const Json::Value& param2) = 0;
+    /// Returns the logs of a range of blocks matching the addresses and the topics.
+    virtual Json::Value getLogs(int param1, const std::string& param2, const std::string& param3,
+        const Json::Value& param4) = 0;
+    /// Returns a page of the pending transactions in the import order after a cursor.
+    virtual Json::Value getPendingTransactionsPage(
+        int param1, const std::string& param2, int param3) = 0;
 };
 
 }  // namespace rpc
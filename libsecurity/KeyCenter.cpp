@@ -164,6 +164,26 @@ Json::Value KeyCenterHttpClient::callMethod(const string& _method, Json::Value _
     return res;
 }
 
+namespace
+{
+/// the attempts of a fetch from the key manager and the ms between them
+const int c_fetchAttempts = 3;
+const uint64_t c_fetchRetryInterval = 1000;
+}  // namespace
+
+KeyCenter::~KeyCenter()
+{
+    {
+        lock_guard<mutex> l(x_cache);
+        m_stopRefresh = true;
+    }
+    m_refreshSignal.notify_all();
+    if (m_refresher.joinable())
+    {
+        m_refresher.join();
+    }
+}
+
 const bytes KeyCenter::getDataKey(const std::string& _cipherDataKey)
 {
     if (_cipherDataKey.empty())
@@ -172,50 +192,155 @@ const bytes KeyCenter::getDataKey(const std::string& _cipherDataKey)
         BOOST_THROW_EXCEPTION(KeyCenterDataKeyError());
     }
 
-    if (m_lastQueryCipherDataKey == _cipherDataKey)
+    auto fresh = [&](bytes& _dataKey) {
+        lock_guard<mutex> l(x_cache);
+        auto it = m_cache.find(_cipherDataKey);
+        if (it == m_cache.end())
+        {
+            return false;
+        }
+        _dataKey = it->second.dataKey;
+        return m_cacheTTL == 0 || utcTime() - it->second.fetchedAt < m_cacheTTL;
+    };
+    bytes dataKey;
+    if (fresh(dataKey))
     {
-        return m_lastRcvDataKey;
+        return dataKey;
     }
 
+    // the groups opening their db at once wait for a single round trip
+    lock_guard<mutex> l(x_fetch);
+    if (fresh(dataKey))
+    {
+        return dataKey;
+    }
+    try
+    {
+        auto fetched = fetchWithRetry(_cipherDataKey);
+        cache(_cipherDataKey, fetched);
+        return fetched;
+    }
+    catch (exception& e)
+    {
+        if (dataKey.empty())
+        {
+            throw;
+        }
+        // the data stays readable while the key manager is away
+        KC_LOG(WARNING) << LOG_DESC("Refetch datakey failed, use the cached one")
+                        << LOG_KV("reason", e.what());
+        return dataKey;
+    }
+}
 
-    string dataKeyBytesStr;
+bytes KeyCenter::fetchDataKey(const std::string& _cipherDataKey)
+{
     try
     {
-        // connect
-        KeyCenterHttpClient kcclient(m_ip, m_port);
-        kcclient.connect();
+        if (!m_client)
+        {
+            m_client.reset(new KeyCenterHttpClient(m_ip, m_port));
+            m_client->connect();
+        }
 
         // send and receive
         Json::Value params(Json::arrayValue);
         params.append(_cipherDataKey);
-        Json::Value rsp = kcclient.callMethod("decDataKey", params);
+        Json::Value rsp = m_client->callMethod("decDataKey", params);
 
         // parse respond
         int error = rsp["error"].asInt();
-        dataKeyBytesStr = rsp["dataKey"].asString();
+        string dataKeyBytesStr = rsp["dataKey"].asString();
         string info = rsp["info"].asString();
         if (error)
         {
             KC_LOG(DEBUG) << LOG_DESC("Get datakey exception") << LOG_KV("keycentr info", info);
             BOOST_THROW_EXCEPTION(KeyCenterConnectionError() << errinfo_comment(info));
         }
-
-        // update query cache
-        m_lastQueryCipherDataKey = _cipherDataKey;
-        bytes readableDataKey = fromHex(dataKeyBytesStr);
-        m_lastRcvDataKey = uniformDataKey(readableDataKey);
-
-        // close
-        kcclient.close();
+        return uniformDataKey(fromHex(dataKeyBytesStr));
     }
     catch (exception& e)
     {
-        clearCache();
+        // a new connection for the next fetch, the key manager may have closed this one
+        m_client.reset();
         KC_LOG(DEBUG) << LOG_DESC("Get datakey exception") << LOG_KV("reason", e.what());
         BOOST_THROW_EXCEPTION(KeyCenterConnectionError() << errinfo_comment(e.what()));
     }
+}
+
+bytes KeyCenter::fetchWithRetry(const std::string& _cipherDataKey)
+{
+    for (int attempt = 1;; ++attempt)
+    {
+        try
+        {
+            return fetchDataKey(_cipherDataKey);
+        }
+        catch (exception& e)
+        {
+            if (attempt >= c_fetchAttempts)
+            {
+                throw;
+            }
+            KC_LOG(WARNING) << LOG_DESC("Get datakey failed, retry") << LOG_KV("attempt", attempt)
+                            << LOG_KV("reason", e.what());
+            this_thread::sleep_for(chrono::milliseconds(c_fetchRetryInterval));
+        }
+    }
+}
 
-    return m_lastRcvDataKey;
+void KeyCenter::cache(const std::string& _cipherDataKey, const bytes& _dataKey)
+{
+    lock_guard<mutex> l(x_cache);
+    m_cache[_cipherDataKey] = CachedKey{_dataKey, utcTime()};
+    if (m_cacheTTL > 0 && !m_refresher.joinable() && !m_stopRefresh)
+    {
+        m_refresher = thread([this]() { refresh(); });
+    }
+}
+
+void KeyCenter::refresh()
+{
+    pthread_setThreadName("keyRefresh");
+    unique_lock<mutex> l(x_cache);
+    while (!m_stopRefresh)
+    {
+        uint64_t ttl = m_cacheTTL;
+        m_refreshSignal.wait_for(l, chrono::milliseconds(max(ttl / 2, (uint64_t)1)));
+        if (m_stopRefresh || ttl == 0)
+        {
+            continue;
+        }
+        vector<string> expiring;
+        for (auto const& it : m_cache)
+        {
+            if (utcTime() - it.second.fetchedAt >= ttl / 2)
+            {
+                expiring.push_back(it.first);
+            }
+        }
+        l.unlock();
+        for (auto const& cipherDataKey : expiring)
+        {
+            try
+            {
+                lock_guard<mutex> fetch(x_fetch);
+                cache(cipherDataKey, fetchDataKey(cipherDataKey));
+            }
+            catch (exception& e)
+            {
+                KC_LOG(WARNING) << LOG_DESC("Refresh datakey failed, keep the cached one")
+                                << LOG_KV("reason", e.what());
+            }
+        }
+        l.lock();
+    }
+}
+
+void KeyCenter::clearCache()
+{
+    lock_guard<mutex> l(x_cache);
+    m_cache.clear();
 }
 
 const std::string KeyCenter::generateCipherDataKey()
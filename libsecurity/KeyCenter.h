@@ -29,9 +29,14 @@
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace Json
 {
@@ -67,31 +72,52 @@ public:
     using Ptr = std::shared_ptr<KeyCenter>;
 
     KeyCenter(){};
-    virtual ~KeyCenter(){};
+    virtual ~KeyCenter();
+    /// the data key of the cipher data key, from the cache if it's there, else from the key
+    /// manager once for all the callers asking for it at the same time
     virtual const dev::bytes getDataKey(const std::string& _cipherDataKey);
     virtual const std::string generateCipherDataKey();
     void setIpPort(const std::string& _ip, int _port);
     const std::string url() { return m_ip + ":" + std::to_string(m_port); }
+    /// keep the data keys for _ttl ms, refetched in the background after half of it so that the
+    /// readers don't wait for the key manager, for the lifetime of the node if 0
+    void setCacheTTL(uint64_t _ttl) { m_cacheTTL = _ttl; }
 
     static std::shared_ptr<KeyCenter> instance();
 
-    void clearCache()
-    {
-        m_lastQueryCipherDataKey.clear();
-        m_lastRcvDataKey.clear();
-    }
+    void clearCache();
+
+protected:
+    /// the data key decrypted by the key manager, over the connection shared by the groups
+    virtual dev::bytes fetchDataKey(const std::string& _cipherDataKey);
+    dev::bytes uniformDataKey(const dev::bytes& _readableDataKey);
 
 private:
+    struct CachedKey
+    {
+        dev::bytes dataKey;
+        /// ms since the epoch
+        uint64_t fetchedAt;
+    };
+
+    dev::bytes fetchWithRetry(const std::string& _cipherDataKey);
+    void cache(const std::string& _cipherDataKey, const dev::bytes& _dataKey);
+    void refresh();
+
     std::string m_ip;
     int m_port;
     std::string m_url;
 
-    // Query cache
-    std::string m_lastQueryCipherDataKey;
-    dev::bytes m_lastRcvDataKey;
+    std::atomic<uint64_t> m_cacheTTL = {0};
+    std::mutex x_cache;
+    std::map<std::string, CachedKey> m_cache;
+    /// one fetch at a time, on the connection kept to the key manager
+    std::mutex x_fetch;
+    std::unique_ptr<KeyCenterHttpClient> m_client;
 
-protected:
-    dev::bytes uniformDataKey(const dev::bytes& _readableDataKey);
+    std::thread m_refresher;
+    std::condition_variable m_refreshSignal;
+    bool m_stopRefresh = false;
 };
 
 #define g_keyCenter KeyCenter::instance()  // Only one keycenter in a node
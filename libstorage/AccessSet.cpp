@@ -0,0 +1,83 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file AccessSet.cpp
+ *  @author ancelmo
+ *  @date 20190910
+ */
+
+#include "AccessSet.h"
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+thread_local AccessSet* t_accessSet = nullptr;
+}
+
+AccessSet::Scope::Scope(AccessSet* _accessSet) : m_previous(t_accessSet)
+{
+    t_accessSet = _accessSet;
+}
+
+AccessSet::Scope::~Scope()
+{
+    t_accessSet = m_previous;
+}
+
+AccessSet* AccessSet::current()
+{
+    return t_accessSet;
+}
+
+void AccessSet::read(const std::string& _table, const std::string& _key)
+{
+    auto key = field(_table, _key);
+    if (m_writes.find(key) == m_writes.end())
+    {
+        m_reads.insert(key);
+    }
+}
+
+void AccessSet::write(const std::string& _table, const std::string& _key)
+{
+    auto key = field(_table, _key);
+    m_reads.erase(key);
+    m_writes.insert(key);
+}
+
+bool AccessSet::coveredBy(const AccessSet& _other) const
+{
+    for (auto& key : m_writes)
+    {
+        if (_other.m_writes.find(key) == _other.m_writes.end())
+        {
+            return false;
+        }
+    }
+
+    for (auto& key : m_reads)
+    {
+        if (_other.m_reads.find(key) == _other.m_reads.end() &&
+            _other.m_writes.find(key) == _other.m_writes.end())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
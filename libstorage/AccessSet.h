@@ -0,0 +1,84 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file AccessSet.h
+ *  @author ancelmo
+ *  @date 20190910
+ */
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+
+namespace dev
+{
+namespace storage
+{
+/// Keys of the tables read and written by one transaction. Like the change log, a set is bound
+/// to the executing thread and the memory tables record every access while it is bound. A
+/// written key is not recorded as read, a write conflicts with reads and writes anyway.
+class AccessSet
+{
+public:
+    using Ptr = std::shared_ptr<AccessSet>;
+
+    /// Binds a set to the calling thread, nullptr stops recording until the scope exits
+    class Scope
+    {
+    public:
+        Scope(AccessSet* _accessSet);
+        ~Scope();
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        AccessSet* m_previous;
+    };
+
+    /// @return the set bound to the calling thread, nullptr if there is none
+    static AccessSet* current();
+
+    void read(const std::string& _table, const std::string& _key);
+    void write(const std::string& _table, const std::string& _key);
+
+    const std::set<std::string>& reads() const { return m_reads; }
+    const std::set<std::string>& writes() const { return m_writes; }
+
+    /// @return true if every key read or written here is accessed by _other, and every key
+    /// written here is written by _other
+    bool coveredBy(const AccessSet& _other) const;
+
+    void clear()
+    {
+        m_reads.clear();
+        m_writes.clear();
+    }
+
+    /// @return the recorded form of a key, table names never contain '\0'
+    static std::string field(const std::string& _table, const std::string& _key)
+    {
+        return _table + '\0' + _key;
+    }
+
+private:
+    std::set<std::string> m_reads;
+    std::set<std::string> m_writes;
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -0,0 +1,395 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file BlockWAL.cpp
+ *  @author ancelmo
+ *  @date 20190905
+ */
+
+#include "BlockWAL.h"
+#include "Common.h"
+#include "StorageException.h"
+#include <fcntl.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/easylog.h>
+#include <unistd.h>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <iomanip>
+
+using namespace dev;
+using namespace dev::storage;
+
+// length and crc32 of the payload, both little endian
+static const size_t c_recordHeaderSize = 8;
+
+static uint32_t crc32(bytesConstRef data)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    return crc.checksum();
+}
+
+static void putUint32(byte* out, uint32_t value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        out[i] = (byte)(value >> (i * 8));
+    }
+}
+
+static uint32_t getUint32(const byte* in)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        value |= (uint32_t)in[i] << (i * 8);
+    }
+    return value;
+}
+
+class BlockWAL::File
+{
+public:
+    File(const std::string& path) : m_path(path)
+    {
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (m_fd < 0)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Open wal segment failed: " + path));
+        }
+    }
+
+    ~File() { ::close(m_fd); }
+
+    void write(const bytes& data)
+    {
+        size_t offset = 0;
+        while (offset < data.size())
+        {
+            auto size = ::write(m_fd, data.data() + offset, data.size() - offset);
+            if (size < 0)
+            {
+                BOOST_THROW_EXCEPTION(StorageException(-1, "Write wal segment failed: " + m_path));
+            }
+            offset += size;
+        }
+    }
+
+    void sync()
+    {
+        if (::fdatasync(m_fd) != 0)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Sync wal segment failed: " + m_path));
+        }
+    }
+
+private:
+    std::string m_path;
+    int m_fd = -1;
+};
+
+BlockWAL::BlockWAL(const std::string& path, size_t segmentSize)
+  : m_path(path), m_segmentSize(segmentSize)
+{}
+
+BlockWAL::~BlockWAL() {}
+
+void BlockWAL::open(int64_t num, std::function<void(Block&)> replay)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    boost::filesystem::create_directories(m_path);
+
+    std::map<int64_t, std::string> files;
+    for (boost::filesystem::directory_iterator it(m_path);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        int64_t first = 0;
+        if (it->path().extension() == ".wal" &&
+            boost::conversion::try_lexical_convert(it->path().stem().string(), first))
+        {
+            files.insert(std::make_pair(first, it->path().string()));
+        }
+    }
+
+    bool torn = false;
+    size_t replayed = 0;
+    for (auto& file : files)
+    {
+        if (torn)
+        {
+            // nothing after a torn record was acknowledged
+            boost::filesystem::remove(file.second);
+            continue;
+        }
+
+        std::ifstream in(file.second, std::ios::binary);
+        bytes data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        size_t offset = 0;
+        int64_t last = -1;
+        while (offset < data.size())
+        {
+            if (data.size() - offset < c_recordHeaderSize)
+            {
+                torn = true;
+                break;
+            }
+
+            auto size = getUint32(&data[offset]);
+            auto crc = getUint32(&data[offset + 4]);
+            if (data.size() - offset - c_recordHeaderSize < size)
+            {
+                torn = true;
+                break;
+            }
+
+            auto payload = bytesConstRef(&data[offset + c_recordHeaderSize], size);
+            if (crc32(payload) != crc)
+            {
+                torn = true;
+                break;
+            }
+
+            Block block;
+            decode(payload, block);
+            last = block.num;
+            if (block.num > num)
+            {
+                replay(block);
+                ++replayed;
+            }
+
+            offset += c_recordHeaderSize + size;
+        }
+
+        if (torn)
+        {
+            STORAGE_LOG(WARNING) << LOG_BADGE("BlockWAL") << LOG_DESC("Cut off torn record")
+                                 << LOG_KV("segment", file.second) << LOG_KV("offset", offset);
+            boost::filesystem::resize_file(file.second, offset);
+        }
+
+        if (last < 0)
+        {
+            boost::filesystem::remove(file.second);
+        }
+        else
+        {
+            m_segments[file.first] = last;
+        }
+    }
+
+    STORAGE_LOG(INFO) << LOG_BADGE("BlockWAL") << LOG_DESC("open") << LOG_KV("path", m_path)
+                      << LOG_KV("segments", m_segments.size()) << LOG_KV("num", num)
+                      << LOG_KV("replayed", replayed);
+}
+
+void BlockWAL::append(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    auto payload = encode(hash, num, datas);
+    bytes record(c_recordHeaderSize);
+    putUint32(&record[0], (uint32_t)payload.size());
+    putUint32(&record[4], crc32(ref(payload)));
+    record.insert(record.end(), payload.begin(), payload.end());
+
+    uint64_t seq = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (!m_file || m_fileSize >= m_segmentSize)
+        {
+            rollOver(num);
+        }
+
+        m_file->write(record);
+        m_fileSize += record.size();
+        m_segments[m_fileNum] = num;
+        seq = ++m_written;
+    }
+
+    sync(seq);
+}
+
+void BlockWAL::truncate(int64_t num)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    for (auto it = m_segments.begin(); it != m_segments.end();)
+    {
+        if (it->first != m_fileNum && it->second <= num)
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove(segmentPath(it->first), error);
+            it = m_segments.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t BlockWAL::segments()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    return m_segments.size();
+}
+
+bytes BlockWAL::encode(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    auto encodeEntries = [](RLPStream& stream, Entries::Ptr entries) {
+        stream.appendList(entries->size());
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            auto entry = entries->get(i);
+            std::vector<std::string> fields;
+            for (auto fieldIt : *entry)
+            {
+                fields.push_back(fieldIt.first);
+                fields.push_back(fieldIt.second);
+            }
+
+            stream.appendList(5);
+            stream << u256(entry->getID()) << u256(entry->num())
+                   << (unsigned)entry->getStatus() << (unsigned)entry->force() << fields;
+        }
+    };
+
+    RLPStream stream(3);
+    stream << hash << u256(num);
+    stream.appendList(datas.size());
+    for (auto& data : datas)
+    {
+        stream.appendList(5);
+        stream << data->info->name << data->info->key << data->info->fields;
+        encodeEntries(stream, data->dirtyEntries);
+        encodeEntries(stream, data->newEntries);
+    }
+
+    return stream.out();
+}
+
+void BlockWAL::decode(bytesConstRef data, Block& block)
+{
+    auto decodeEntries = [](const RLP& rlp, Entries::Ptr entries) {
+        for (size_t i = 0; i < rlp.itemCount(); ++i)
+        {
+            auto entryRLP = rlp[i];
+            auto entry = std::make_shared<Entry>();
+            entry->setID(entryRLP[0].toInt<uint64_t>());
+            entry->setNum(entryRLP[1].toInt<uint32_t>());
+            entry->setStatus((int)entryRLP[2].toInt<unsigned>());
+            entry->setForce(entryRLP[3].toInt<unsigned>() != 0);
+            auto fields = entryRLP[4].toVector<std::string>();
+            for (size_t j = 0; j + 1 < fields.size(); j += 2)
+            {
+                entry->setField(fields[j], fields[j + 1]);
+            }
+            entries->addEntry(entry);
+        }
+    };
+
+    RLP rlp(data);
+    block.hash = rlp[0].toHash<h256>();
+    block.num = (int64_t)rlp[1].toInt<u256>();
+    block.datas.clear();
+    for (auto tableRLP : rlp[2])
+    {
+        auto tableData = std::make_shared<TableData>();
+        tableData->info->name = tableRLP[0].toString();
+        tableData->info->key = tableRLP[1].toString();
+        tableData->info->fields = tableRLP[2].toVector<std::string>();
+        decodeEntries(tableRLP[3], tableData->dirtyEntries);
+        decodeEntries(tableRLP[4], tableData->newEntries);
+        block.datas.push_back(tableData);
+    }
+}
+
+std::string BlockWAL::segmentPath(int64_t num)
+{
+    std::stringstream ss;
+    ss << m_path << "/" << std::setw(20) << std::setfill('0') << num << ".wal";
+    return ss.str();
+}
+
+void BlockWAL::rollOver(int64_t num)
+{
+    if (m_file)
+    {
+        // records of the old segment are durable before any later record is
+        m_file->sync();
+    }
+
+    m_file = std::make_shared<File>(segmentPath(num));
+    m_fileNum = num;
+    m_fileSize = 0;
+
+    // the new segment must survive a crash as well
+    auto dir = ::open(m_path.c_str(), O_RDONLY);
+    if (dir >= 0)
+    {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+
+void BlockWAL::sync(uint64_t seq)
+{
+    std::unique_lock<std::mutex> lock(m_syncMutex);
+    while (m_synced < seq)
+    {
+        if (m_syncing)
+        {
+            m_syncSignal.wait(lock);
+            continue;
+        }
+
+        // the leader syncs all records written so far, followers wait for it
+        m_syncing = true;
+        uint64_t written = 0;
+        std::shared_ptr<File> file;
+        {
+            std::lock_guard<std::mutex> writeLock(m_writeMutex);
+            written = m_written;
+            file = m_file;
+        }
+        lock.unlock();
+
+        std::exception_ptr error;
+        try
+        {
+            file->sync();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        m_syncing = false;
+        if (!error)
+        {
+            m_synced = std::max(m_synced, written);
+        }
+        m_syncSignal.notify_all();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
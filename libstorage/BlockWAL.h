@@ -0,0 +1,94 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file BlockWAL.h
+ *  @author ancelmo
+ *  @date 20190905
+ */
+#pragma once
+
+#include "Table.h"
+#include <libdevcore/FixedHash.h>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace dev
+{
+namespace storage
+{
+/// Append-only log of the table data of each block, it makes the blocks committed to the cache
+/// durable before they reach the backend. Records are appended to segment files named by the
+/// first block they hold, each record is its length, its crc32 and the rlp of the block.
+/// Appends return once the record is on disk, appends waiting at the same time share one
+/// fdatasync.
+class BlockWAL
+{
+public:
+    typedef std::shared_ptr<BlockWAL> Ptr;
+
+    struct Block
+    {
+        h256 hash;
+        int64_t num = 0;
+        std::vector<TableData::Ptr> datas;
+    };
+
+    /// segments are rolled over once they exceed segmentSize bytes
+    BlockWAL(const std::string& path, size_t segmentSize = 64 * 1024 * 1024);
+    virtual ~BlockWAL();
+
+    /// must be called before the first append, calls replay with the blocks after num in the
+    /// order they were appended, a torn record left by a crash ends the log and is cut off
+    virtual void open(int64_t num, std::function<void(Block&)> replay);
+    virtual void append(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas);
+    /// remove the segments whose blocks are all at most num, the segment being appended stays
+    virtual void truncate(int64_t num);
+
+    size_t segments();
+
+    static bytes encode(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas);
+    static void decode(bytesConstRef data, Block& block);
+
+private:
+    class File;
+
+    std::string segmentPath(int64_t num);
+    void rollOver(int64_t num);
+    void sync(uint64_t seq);
+
+    std::string m_path;
+    size_t m_segmentSize;
+
+    // protect the current segment and the segments
+    std::mutex m_writeMutex;
+    std::shared_ptr<File> m_file;
+    int64_t m_fileNum = -1;
+    size_t m_fileSize = 0;
+    // first block of each segment to the last one
+    std::map<int64_t, int64_t> m_segments;
+    uint64_t m_written = 0;
+
+    std::mutex m_syncMutex;
+    std::condition_variable m_syncSignal;
+    uint64_t m_synced = 0;
+    bool m_syncing = false;
+};
+
+}  // namespace storage
+
+}  // namespace dev
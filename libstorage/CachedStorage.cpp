@@ -21,22 +21,36 @@
 
 #include "CachedStorage.h"
 #include "StorageException.h"
+#include <libdevcore/Affinity.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/Executor.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcore/easylog.h>
 #include <tbb/concurrent_unordered_set.h>
 #include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <thread>
 
 using namespace dev;
 using namespace dev::storage;
 
+namespace
+{
+// hot keys fetched by one batch select when the cache is warmed up
+const size_t c_warmUpBatchSize = 200;
+}  // namespace
+
 Cache::Cache()
 {
-    m_entries = std::make_shared<Entries>();
+    m_entries = makeShared<Entries>();
     m_num.store(0);
+    m_referenced.store(true);
 }
 
 std::string Cache::key()
@@ -62,6 +76,7 @@ Entries* Cache::entriesPtr()
 void Cache::setEntries(Entries::Ptr entries)
 {
     m_entries = entries;
+    m_indices.clear();
 }
 
 uint64_t Cache::num() const
@@ -87,6 +102,20 @@ bool Cache::empty()
 void Cache::setEmpty(bool empty)
 {
     m_empty = empty;
+    if (empty)
+    {
+        m_indices.clear();
+    }
+}
+
+bool Cache::referenced() const
+{
+    return m_referenced;
+}
+
+void Cache::setReferenced(bool referenced)
+{
+    m_referenced.store(referenced);
 }
 
 TableInfo::Ptr Cache::tableInfo()
@@ -99,24 +128,241 @@ void Cache::setTableInfo(TableInfo::Ptr tableInfo)
     m_tableInfo = tableInfo;
 }
 
+void Cache::saveVersion(int64_t num, int64_t oldestSnapshot, bool loaded)
+{
+    // called before every modification of the entries
+    m_indices.clear();
+
+    if (oldestSnapshot < 0)
+    {
+        m_versions.clear();
+        return;
+    }
+
+    // drop the versions no snapshot can see
+    if ((int64_t)m_num.load() <= oldestSnapshot)
+    {
+        m_versions.clear();
+    }
+    while (m_versions.size() > 1 && (int64_t)m_versions[1].first <= oldestSnapshot)
+    {
+        m_versions.pop_front();
+    }
+
+    if ((int64_t)m_num.load() >= num)
+    {
+        // already saved by the block
+        return;
+    }
+
+    Entries::Ptr entries;
+    if (loaded)
+    {
+        // cached entries are immutable, copying the pointers is enough
+        entries = makeShared<Entries>();
+        entries->shallowFrom(m_entries);
+    }
+    m_versions.push_back(std::make_pair(m_num.load(), entries));
+}
+
+bool Cache::version(int64_t num, Entries::Ptr& entries)
+{
+    if ((int64_t)m_num.load() <= num)
+    {
+        if (m_empty)
+        {
+            return false;
+        }
+        entries = m_entries;
+        return true;
+    }
+
+    for (auto it = m_versions.rbegin(); it != m_versions.rend(); ++it)
+    {
+        if ((int64_t)it->first <= num)
+        {
+            entries = it->second;
+            return (bool)entries;
+        }
+    }
+
+    return false;
+}
+
+void Cache::clearVersions()
+{
+    m_versions.clear();
+}
+
+EntriesIndex::Ptr Cache::index(const std::string& field)
+{
+    auto it = m_indices.find(field);
+    if (it == m_indices.end())
+    {
+        it = m_indices.emplace(field, std::make_shared<EntriesIndex>(*m_entries, field)).first;
+    }
+    return it->second;
+}
+
+TableStat::TableStat()
+{
+    capacity.store(0);
+    hitTimes.store(0);
+    queryTimes.store(0);
+    quota.store(0);
+}
+
+FrequencySketch::FrequencySketch(size_t width)
+{
+    size_t rowWidth = 1;
+    while (rowWidth < width)
+    {
+        rowWidth <<= 1;
+    }
+
+    m_mask = rowWidth - 1;
+    m_counters.resize(rowWidth * ROWS);
+    for (auto& counter : m_counters)
+    {
+        counter.store(0);
+    }
+    m_additions.store(0);
+    m_samplePeriod = rowWidth * 10;
+}
+
+size_t FrequencySketch::index(size_t hash, size_t row)
+{
+    static const uint64_t seeds[ROWS] = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+
+    uint64_t h = ((uint64_t)hash + seeds[row]) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 32;
+    return row * (m_mask + 1) + (size_t)(h & m_mask);
+}
+
+void FrequencySketch::increment(size_t hash)
+{
+    for (size_t row = 0; row < ROWS; ++row)
+    {
+        auto& counter = m_counters[index(hash, row)];
+        uint8_t count = counter.load();
+        if (count < MAX_COUNT)
+        {
+            // lost increments of racing accesses don't matter to an estimation
+            counter.compare_and_swap((uint8_t)(count + 1), count);
+        }
+    }
+
+    if (++m_additions >= m_samplePeriod)
+    {
+        reset();
+    }
+}
+
+uint32_t FrequencySketch::frequency(size_t hash)
+{
+    uint32_t frequency = MAX_COUNT;
+    for (size_t row = 0; row < ROWS; ++row)
+    {
+        frequency = std::min(frequency, (uint32_t)m_counters[index(hash, row)].load());
+    }
+    return frequency;
+}
+
+void FrequencySketch::reset()
+{
+    tbb::spin_mutex::scoped_lock lock;
+    if (!lock.try_acquire(m_resetMutex))
+    {
+        // halved by another thread
+        return;
+    }
+
+    if (m_additions < m_samplePeriod)
+    {
+        return;
+    }
+
+    for (auto& counter : m_counters)
+    {
+        counter.store(counter.load() >> 1);
+    }
+    m_additions.store(m_additions.load() / 2);
+}
+
+CachedSnapshot::CachedSnapshot(std::shared_ptr<CachedStorage> storage, int64_t num)
+  : m_storage(storage), m_num(num)
+{}
+
+CachedSnapshot::~CachedSnapshot()
+{
+    m_storage->releaseSnapshot(m_num);
+}
+
+Entries::Ptr CachedSnapshot::select(h256 hash, int64_t, TableInfo::Ptr tableInfo,
+    const std::string& key, Condition::Ptr condition)
+{
+    return m_storage->selectSnapshot(m_num, hash, tableInfo, key, condition);
+}
+
+StorageIterator::Ptr CachedSnapshot::scan(
+    TableInfo::Ptr tableInfo, const std::string& begin, const std::string& end, size_t batchSize)
+{
+    return m_storage->scanSnapshot(m_num, tableInfo, begin, end, batchSize);
+}
+
+size_t CachedSnapshot::commit(h256, int64_t, const std::vector<TableData::Ptr>&)
+{
+    BOOST_THROW_EXCEPTION(StorageException(-1, "Commit to a read only snapshot"));
+}
+
+bool CachedSnapshot::onlyDirty()
+{
+    return m_storage->onlyDirty();
+}
+
+CacheShard::CacheShard()
+{
+    mruQueue =
+        std::make_shared<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t>>>();
+    mru = std::make_shared<MRUList>();
+    clockQueue = std::make_shared<tbb::concurrent_queue<std::pair<std::string, std::string>>>();
+    clockHand = mru->end();
+    capacity.store(0);
+}
+
+size_t CacheShard::size()
+{
+    RWMutexScoped lockCache(cachesMutex, false);
+
+    size_t total = 0;
+    for (auto it : caches)
+    {
+        total += it.second->size();
+    }
+    return total;
+}
+
 CachedStorage::CachedStorage()
 {
     CACHED_STORAGE_LOG(INFO) << "Init flushStorage thread";
     m_taskThreadPool = std::make_shared<dev::ThreadPool>("FlushStorage", 1);
 
-    m_mruQueue =
-        std::make_shared<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t>>>();
-    m_mru = std::make_shared<boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string>>>>>>();
+    m_shards.push_back(std::make_shared<CacheShard>());
     m_syncNum.store(0);
     m_commitNum.store(0);
     m_capacity.store(0);
+    m_forwardBytes.store(0);
 
     m_hitTimes.store(0);
     m_queryTimes.store(0);
 
+    m_lastMergedBlocks.store(0);
+    m_lastMergedBytes.store(0);
+    m_lastBackendLatency.store(0);
+
+    m_cachedNum.store(0);
+
     m_running = std::make_shared<tbb::atomic<bool>>();
     m_running->store(true);
 }
@@ -132,20 +378,39 @@ CachedStorage::~CachedStorage()
 Entries::Ptr CachedStorage::select(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
     const std::string& key, Condition::Ptr condition)
 {
-    auto out = std::make_shared<Entries>();
+    auto out = makeShared<Entries>();
 
     auto result = selectNoCondition(hash, num, tableInfo, key, condition);
 
+    // cached entries are never modified in place, commit replaces them, so they are shared with
+    // the caller, which must clone an entry before modifying it
     Cache::Ptr caches = std::get<1>(result);
+    // an index only pays off if it's kept in the cache
+    if (condition && !tableInfo->indices.empty() && !disabled())
+    {
+        auto field = EntriesIndex::indexField(condition, tableInfo->indices);
+        if (!field.empty())
+        {
+            auto entries = caches->entries();
+            for (auto position : caches->index(field)->find(condition))
+            {
+                auto entry = entries->get(position);
+                if (condition->process(entry))
+                {
+                    out->addEntry(entry);
+                }
+            }
+            return out;
+        }
+    }
+
     for (auto entry : *(caches->entries()))
     {
         if (condition && !condition->process(entry))
         {
             continue;
         }
-        auto outEntry = std::make_shared<Entry>();
-        outEntry->copyFrom(entry);
-        out->addEntry(outEntry);
+        out->addEntry(entry);
     }
 
     return out;
@@ -194,86 +459,509 @@ std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr> CachedStorage::selectNo
     return std::make_tuple(std::get<0>(result), caches);
 }
 
-size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+std::vector<Entries::Ptr> CachedStorage::batchSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
 {
-    CACHED_STORAGE_LOG(INFO) << "CachedStorage commit: " << datas.size() << " hash: " << hash
-                             << " num: " << num;
+    std::vector<Entries::Ptr> out;
+    out.reserve(keys.size());
+    fillCaches(hash, num, tableInfo, keys, &out);
 
-    tbb::atomic<size_t> total = 0;
+    return out;
+}
 
-    TIME_RECORD("Process dirty entries");
-    std::shared_ptr<std::vector<TableData::Ptr>> commitDatas =
-        std::make_shared<std::vector<TableData::Ptr>>();
+size_t CachedStorage::prefetch(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    return fillCaches(hash, num, tableInfo, keys, nullptr);
+}
 
-    commitDatas->resize(datas.size());
+CachedSnapshot::Ptr CachedStorage::snapshot()
+{
+    int64_t num = 0;
+    {
+        // wait for the blocks being applied to the cache, no new one starts meanwhile
+        std::unique_lock<std::mutex> lock(x_snapshots);
+        ++m_pinningSnapshots;
+        m_snapshotsCV.wait(lock, [this]() { return m_applyingBlocks == 0; });
+        num = m_cachedNum.load();
+        m_snapshots.insert(num);
+        if (--m_pinningSnapshots == 0)
+        {
+            m_snapshotsCV.notify_all();
+        }
+    }
 
-    ssize_t currentStateIdx = -1;
+    return std::make_shared<CachedSnapshot>(
+        std::dynamic_pointer_cast<CachedStorage>(shared_from_this()), num);
+}
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, datas.size()), [&](const tbb::blocked_range<size_t>& range) {
-            for (size_t idx = range.begin(); idx < range.end(); ++idx)
-            {
-                auto requestData = datas[idx];
-                auto commitData = std::make_shared<TableData>();
-                commitData->info = requestData->info;
-                commitData->dirtyEntries->resize(requestData->dirtyEntries->size());
+void CachedStorage::releaseSnapshot(int64_t num)
+{
+    std::lock_guard<std::mutex> lock(x_snapshots);
+    auto it = m_snapshots.find(num);
+    if (it != m_snapshots.end())
+    {
+        m_snapshots.erase(it);
+    }
+}
 
-                if (currentStateIdx < 0 && commitData->info->name == SYS_CURRENT_STATE)
+size_t CachedStorage::snapshots()
+{
+    std::lock_guard<std::mutex> lock(x_snapshots);
+    return m_snapshots.size();
+}
+
+std::shared_ptr<void> CachedStorage::applyBlock(int64_t& oldest)
+{
+    std::unique_lock<std::mutex> lock(x_snapshots);
+    // the snapshots waiting for the previous block are pinned first
+    m_snapshotsCV.wait(lock, [this]() { return m_pinningSnapshots == 0; });
+    ++m_applyingBlocks;
+    oldest = oldestSnapshot();
+    return std::shared_ptr<void>(nullptr, [this](void*) {
+        std::lock_guard<std::mutex> lock(x_snapshots);
+        if (--m_applyingBlocks == 0)
+        {
+            m_snapshotsCV.notify_all();
+        }
+    });
+}
+
+class CachedStorage::MergeIterator : public StorageIterator
+{
+public:
+    // the latest keys if snapshotNum is negative
+    MergeIterator(CachedStorage::Ptr storage, TableInfo::Ptr tableInfo,
+        StorageIterator::Ptr backend, std::vector<std::string>&& cachedKeys, size_t batchSize,
+        int64_t snapshotNum)
+      : m_storage(storage),
+        m_tableInfo(tableInfo),
+        m_backend(backend),
+        m_cachedKeys(std::move(cachedKeys)),
+        m_batchSize(std::max(batchSize, (size_t)1)),
+        m_snapshotNum(snapshotNum)
+    {}
+
+    bool next(Batch& batch) override
+    {
+        batch.clear();
+        while (batch.size() < m_batchSize)
+        {
+            if (m_backendPos == m_backendBatch.size() && m_backend)
+            {
+                m_backendPos = 0;
+                if (!m_backend->next(m_backendBatch))
                 {
-                    currentStateIdx = idx;
+                    m_backend.reset();
                 }
+            }
 
-                // addtion data
-                std::set<std::string> addtionKey;
-                tbb::spin_mutex addtionKeyMutex;
+            bool backendKey = m_backendPos < m_backendBatch.size();
+            bool cachedKey = m_cachedPos < m_cachedKeys.size();
+            if (!backendKey && !cachedKey)
+            {
+                break;
+            }
 
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, requestData->dirtyEntries->size()),
-                    [&](const tbb::blocked_range<size_t>& rangeEntries) {
-                        for (size_t i = rangeEntries.begin(); i < rangeEntries.end(); ++i)
-                        {
-                            ++total;
+            if (!cachedKey ||
+                (backendKey && m_backendBatch[m_backendPos].first < m_cachedKeys[m_cachedPos]))
+            {
+                if (m_snapshotNum < 0)
+                {
+                    batch.push_back(std::move(m_backendBatch[m_backendPos++]));
+                    continue;
+                }
+                auto& row = m_backendBatch[m_backendPos++];
+                auto entries = snapshotEntries(row.first, row.second, false);
+                if (entries->size() > 0)
+                {
+                    batch.emplace_back(row.first, entries);
+                }
+                continue;
+            }
 
-                            auto entry = requestData->dirtyEntries->get(i);
-                            auto key = entry->getField(requestData->info->key);
-                            auto id = entry->getID();
+            auto& key = m_cachedKeys[m_cachedPos++];
+            Entries::Ptr entries;
+            if (backendKey && m_backendBatch[m_backendPos].first == key)
+            {
+                entries = m_backendBatch[m_backendPos++].second;
+            }
 
-                            ssize_t change = 0;
-                            if (id != 0)
-                            {
-                                auto result = touchCache(requestData->info, key, true);
-                                auto caches = std::get<1>(result);
-                                if (caches->empty())
-                                {
-                                    if (m_backend)
-                                    {
-                                        auto conditionKey = std::make_shared<Condition>();
-                                        conditionKey->EQ(requestData->info->key, key);
-                                        auto backendData = m_backend->select(
-                                            hash, num, requestData->info, key, conditionKey);
+            if (m_snapshotNum >= 0)
+            {
+                entries = snapshotEntries(key, entries, true);
+                if (entries->size() > 0)
+                {
+                    batch.emplace_back(key, entries);
+                }
+                continue;
+            }
 
-                                        CACHED_STORAGE_LOG(DEBUG)
-                                            << requestData->info->name << "-" << key
-                                            << " miss the cache while commit dirty entries";
+            // the cache is newer than the backend, unless the key was evicted meanwhile
+            auto cache = m_storage->findCache(
+                m_storage->getShard(m_tableInfo->name, key), m_tableInfo->name, key);
+            if (cache)
+            {
+                Cache::RWScoped lock(*(cache->mutex()), false);
+                if (!cache->empty())
+                {
+                    entries = makeShared<Entries>();
+                    for (auto entry : *(cache->entries()))
+                    {
+                        if (entry->getStatus() != Entry::Status::DELETED && !entry->deleted())
+                        {
+                            entries->addEntry(entry);
+                        }
+                    }
+                }
+            }
 
-                                        caches->setEntries(backendData);
+            if (entries && entries->size() > 0)
+            {
+                batch.emplace_back(key, entries);
+            }
+        }
 
-                                        size_t totalCapacity = 0;
-                                        for (auto it : *backendData)
-                                        {
-                                            totalCapacity += it->capacity();
-                                        }
-#if 0
-                                        CACHED_STORAGE_LOG(TRACE)
-                                            << "backend capacity: " << requestData->info->name
-                                            << "-" << key << ", capacity: " << totalCapacity;
-#endif
-                                        touchMRU(requestData->info->name, key, totalCapacity);
-                                    }
+        return !batch.empty();
+    }
 
-                                    restoreCache(requestData->info, key, caches);
-                                }
+private:
+    // the version of the cache at the snapshot, else the rows of the backend written before it
+    Entries::Ptr snapshotEntries(const std::string& key, Entries::Ptr backendEntries, bool cached)
+    {
+        auto cache = m_storage->findCache(
+            m_storage->getShard(m_tableInfo->name, key), m_tableInfo->name, key);
+        Entries::Ptr version;
+        if (cache)
+        {
+            Cache::RWScoped lock(*(cache->mutex()), false);
+            if (!cache->version(m_snapshotNum, version))
+            {
+                version.reset();
+            }
+        }
+        if (!version && !backendEntries && cached)
+        {
+            // the cached key was evicted after the backend iterator was created
+            return m_storage->selectSnapshot(
+                m_snapshotNum, h256(), m_tableInfo, key, std::make_shared<Condition>());
+        }
 
-                                caches->setNum(num);
+        auto entries = makeShared<Entries>();
+        auto source = version ? version : backendEntries;
+        if (!source)
+        {
+            return entries;
+        }
+        for (auto entry : *source)
+        {
+            if (entry->getStatus() != Entry::Status::DELETED && !entry->deleted() &&
+                (version || (int64_t)entry->num() <= m_snapshotNum))
+            {
+                entries->addEntry(entry);
+            }
+        }
+        return entries;
+    }
+
+    CachedStorage::Ptr m_storage;
+    TableInfo::Ptr m_tableInfo;
+
+    // reset when exhausted
+    StorageIterator::Ptr m_backend;
+    Batch m_backendBatch;
+    size_t m_backendPos = 0;
+
+    std::vector<std::string> m_cachedKeys;
+    size_t m_cachedPos = 0;
+
+    size_t m_batchSize;
+    int64_t m_snapshotNum;
+};
+
+StorageIterator::Ptr CachedStorage::scan(
+    TableInfo::Ptr tableInfo, const std::string& begin, const std::string& end, size_t batchSize)
+{
+    return scanSnapshot(-1, tableInfo, begin, end, batchSize);
+}
+
+StorageIterator::Ptr CachedStorage::scanSnapshot(int64_t snapshotNum, TableInfo::Ptr tableInfo,
+    const std::string& begin, const std::string& end, size_t batchSize)
+{
+    // the keys of a snapshot not flushed to the backend yet are cached when called, as the caches
+    // modified after the snapshot aren't evicted
+    std::vector<std::string> cachedKeys;
+    for (auto& shard : m_shards)
+    {
+        CacheShard::RWMutexScoped lockCache(shard->cachesMutex, false);
+        auto tableIt = shard->caches.find(tableInfo->name);
+        if (tableIt == shard->caches.end())
+        {
+            continue;
+        }
+
+        for (auto& it : *(tableIt->second))
+        {
+            if (it.first >= begin && (end.empty() || it.first < end))
+            {
+                cachedKeys.push_back(it.first);
+            }
+        }
+    }
+    std::sort(cachedKeys.begin(), cachedKeys.end());
+
+    StorageIterator::Ptr backend;
+    if (m_backend)
+    {
+        backend = m_backend->scan(tableInfo, begin, end, batchSize);
+    }
+
+    return std::make_shared<MergeIterator>(
+        std::static_pointer_cast<CachedStorage>(shared_from_this()), tableInfo, backend,
+        std::move(cachedKeys), batchSize, snapshotNum);
+}
+
+int64_t CachedStorage::oldestSnapshot()
+{
+    if (m_snapshots.empty())
+    {
+        return -1;
+    }
+    return *m_snapshots.begin();
+}
+
+Entries::Ptr CachedStorage::selectSnapshot(int64_t snapshotNum, h256 hash,
+    TableInfo::Ptr tableInfo, const std::string& key, Condition::Ptr condition)
+{
+    auto out = makeShared<Entries>();
+    auto readCache = [&]() {
+        auto result = touchCache(tableInfo, key, false);
+        Entries::Ptr entries;
+        if (!std::get<1>(result) || !std::get<1>(result)->version(snapshotNum, entries))
+        {
+            return false;
+        }
+
+        for (auto entry : *entries)
+        {
+            if (!condition || condition->process(entry))
+            {
+                out->addEntry(entry);
+            }
+        }
+        return true;
+    };
+
+    if (readCache() || !m_backend)
+    {
+        return out;
+    }
+
+    // the cache lock isn't held while reading the backend, so commits are never blocked
+    auto conditionKey = std::make_shared<Condition>();
+    conditionKey->EQ(tableInfo->key, key);
+    auto backendData = m_backend->select(hash, snapshotNum, tableInfo, key, conditionKey);
+
+    // a commit loaded and modified the key meanwhile, the backend may be newer than the snapshot
+    if (readCache())
+    {
+        return out;
+    }
+
+    for (auto entry : *backendData)
+    {
+        // rows of force written keys are inserted after the snapshot
+        if ((int64_t)entry->num() <= snapshotNum && (!condition || condition->process(entry)))
+        {
+            out->addEntry(entry);
+        }
+    }
+
+    return out;
+}
+
+size_t CachedStorage::fillCaches(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+    const std::vector<std::string>& keys, std::vector<Entries::Ptr>* out)
+{
+    // only one cache lock is held at a time, a key filled by commit meanwhile keeps its value
+    std::set<std::string> missKeys;
+    size_t hit = 0;
+    for (auto& key : keys)
+    {
+        auto result = touchCache(tableInfo, key, false);
+        if (!std::get<1>(result) || std::get<1>(result)->empty())
+        {
+            missKeys.insert(key);
+        }
+        else
+        {
+            ++hit;
+        }
+    }
+
+    std::map<std::string, Entries::Ptr> backendDatas;
+    if (m_backend && !missKeys.empty())
+    {
+        std::vector<std::string> backendKeys(missKeys.begin(), missKeys.end());
+        auto backendEntries = m_backend->batchSelect(hash, num, tableInfo, backendKeys);
+        for (size_t i = 0; i < backendKeys.size() && i < backendEntries.size(); ++i)
+        {
+            backendDatas.insert(std::make_pair(backendKeys[i], backendEntries[i]));
+        }
+
+        CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("batchSelect") << LOG_KV("table", tableInfo->name)
+                                  << LOG_KV("keys", keys.size())
+                                  << LOG_KV("miss", backendKeys.size());
+    }
+
+    for (auto& key : keys)
+    {
+        auto result = touchCache(tableInfo, key, true);
+        auto caches = std::get<1>(result);
+
+        if (caches->empty())
+        {
+            auto it = backendDatas.find(key);
+            if (it != backendDatas.end() && it->second)
+            {
+                caches->setEntries(it->second);
+                caches->setEmpty(false);
+
+                size_t totalCapacity = 0;
+                for (auto entryIt : *it->second)
+                {
+                    totalCapacity += entryIt->capacity();
+                }
+                touchMRU(tableInfo->name, key, totalCapacity);
+            }
+            else if (m_backend)
+            {
+                // evicted after the first pass
+                auto conditionKey = std::make_shared<Condition>();
+                conditionKey->EQ(tableInfo->key, key);
+                auto backendData = m_backend->select(hash, num, tableInfo, key, conditionKey);
+                caches->setEntries(backendData);
+                caches->setEmpty(false);
+
+                size_t totalCapacity = 0;
+                for (auto entryIt : *backendData)
+                {
+                    totalCapacity += entryIt->capacity();
+                }
+                touchMRU(tableInfo->name, key, totalCapacity);
+            }
+        }
+        else
+        {
+            touchMRU(tableInfo->name, key, 0);
+        }
+
+        if (out)
+        {
+            // shared with the caller and filtered by the key as in select, the cache keeps the
+            // rows removed by commit
+            auto conditionKey = std::make_shared<Condition>();
+            conditionKey->EQ(tableInfo->key, key);
+            auto entries = makeShared<Entries>();
+            for (auto entry : *(caches->entries()))
+            {
+                if (conditionKey->process(entry))
+                {
+                    entries->addEntry(entry);
+                }
+            }
+            out->push_back(entries);
+        }
+    }
+
+    return hit;
+}
+
+size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    CACHED_STORAGE_LOG(INFO) << "CachedStorage commit: " << datas.size() << " hash: " << hash
+                             << " num: " << num;
+
+    tbb::atomic<size_t> total = 0;
+
+    // snapshots can't be pinned until the block is applied to the cache
+    int64_t oldest = -1;
+    auto applying = applyBlock(oldest);
+
+    TIME_RECORD("Process dirty entries");
+    std::shared_ptr<std::vector<TableData::Ptr>> commitDatas =
+        std::make_shared<std::vector<TableData::Ptr>>();
+
+    commitDatas->resize(datas.size());
+
+    ssize_t currentStateIdx = -1;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, datas.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++idx)
+            {
+                auto requestData = datas[idx];
+                auto commitData = std::make_shared<TableData>();
+                commitData->info = requestData->info;
+                commitData->dirtyEntries->resize(requestData->dirtyEntries->size());
+
+                if (currentStateIdx < 0 && commitData->info->name == SYS_CURRENT_STATE)
+                {
+                    currentStateIdx = idx;
+                }
+
+                // addtion data
+                std::set<std::string> addtionKey;
+                tbb::spin_mutex addtionKeyMutex;
+
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, requestData->dirtyEntries->size()),
+                    [&](const tbb::blocked_range<size_t>& rangeEntries) {
+                        for (size_t i = rangeEntries.begin(); i < rangeEntries.end(); ++i)
+                        {
+                            ++total;
+
+                            auto entry = requestData->dirtyEntries->get(i);
+                            auto key = entry->getField(requestData->info->key);
+                            auto id = entry->getID();
+
+                            ssize_t change = 0;
+                            if (id != 0)
+                            {
+                                auto result = touchCache(requestData->info, key, true);
+                                auto caches = std::get<1>(result);
+                                if (caches->empty())
+                                {
+                                    if (m_backend)
+                                    {
+                                        auto conditionKey = std::make_shared<Condition>();
+                                        conditionKey->EQ(requestData->info->key, key);
+                                        auto backendData = m_backend->select(
+                                            hash, num, requestData->info, key, conditionKey);
+
+                                        CACHED_STORAGE_LOG(DEBUG)
+                                            << requestData->info->name << "-" << key
+                                            << " miss the cache while commit dirty entries";
+
+                                        caches->setEntries(backendData);
+
+                                        size_t totalCapacity = 0;
+                                        for (auto it : *backendData)
+                                        {
+                                            totalCapacity += it->capacity();
+                                        }
+#if 0
+                                        CACHED_STORAGE_LOG(TRACE)
+                                            << "backend capacity: " << requestData->info->name
+                                            << "-" << key << ", capacity: " << totalCapacity;
+#endif
+                                        touchMRU(requestData->info->name, key, totalCapacity);
+                                    }
+
+                                    restoreCache(requestData->info, key, caches);
+                                }
+
+                                caches->saveVersion(num, oldest, true);
+                                caches->setNum(num);
                                 caches->setEmpty(false);
 
                                 auto entryIt = std::lower_bound(caches->entries()->begin(),
@@ -287,25 +975,29 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
                                 {
                                     auto oldSize = (*entryIt)->capacity();
 
+                                    // the cached entry may be shared by selected entries, replace
+                                    // it with a modified copy
+                                    auto cacheEntry = makeShared<Entry>();
+                                    cacheEntry->copyFrom(*entryIt);
                                     for (auto fieldIt : *entry)
                                     {
-                                        (*entryIt)->setField(fieldIt.first, fieldIt.second);
+                                        cacheEntry->setField(fieldIt.first, fieldIt.second);
                                     }
-                                    (*entryIt)->setStatus(entry->getStatus());
+                                    cacheEntry->setStatus(entry->getStatus());
 #if 0
                                     CACHED_STORAGE_LOG(TRACE)
                                         << "update capacity: " << commitData->info->name << "-"
                                         << key << ", from capacity: " << oldSize
-                                        << " to capacity: " << (*entryIt)->capacity();
+                                        << " to capacity: " << cacheEntry->capacity();
 #endif
                                     change = (ssize_t)(
-                                        (ssize_t)(*entryIt)->capacity() - (ssize_t)oldSize);
+                                        (ssize_t)cacheEntry->capacity() - (ssize_t)oldSize);
 
-                                    (*entryIt)->setNum(num);
+                                    cacheEntry->setNum(num);
+                                    *entryIt = cacheEntry;
 
-                                    auto commitEntry = std::make_shared<Entry>();
-                                    commitEntry->copyFrom(*entryIt);
-                                    (*commitData->dirtyEntries)[i] = commitEntry;
+                                    // immutable from now on, written to the backend as it is
+                                    (*commitData->dirtyEntries)[i] = cacheEntry;
 
                                     if (m_backend && !m_backend->onlyDirty())
                                     {
@@ -381,7 +1073,7 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
 
             auto key = commitEntry->getField(commitData->info->key);
 
-            auto cacheEntry = std::make_shared<Entry>();
+            auto cacheEntry = makeShared<Entry>();
             cacheEntry->copyFrom(commitEntry);
 
             if (cacheEntry->force())
@@ -389,6 +1081,7 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
                 auto result = touchCache(commitData->info, key, true);
 
                 auto caches = std::get<1>(result);
+                caches->saveVersion(num, oldest, !caches->empty());
                 caches->setNum(num);
                 caches->entries()->addEntry(cacheEntry);
                 caches->setEmpty(false);
@@ -426,6 +1119,7 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
                     restoreCache(commitData->info, key, caches);
                 }
 
+                caches->saveVersion(num, oldest, true);
                 caches->entries()->addEntry(cacheEntry);
                 caches->setNum(num);
                 caches->setEmpty(false);
@@ -438,6 +1132,9 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
         }
     }
 
+    m_cachedNum.store(num);
+    applying.reset();
+
     if (m_backend)
     {
         TIME_RECORD("Submit commit task");
@@ -460,7 +1157,7 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
             data = (*commitDatas)[currentStateIdx];
         }
 
-        Entry::Ptr idEntry = std::make_shared<Entry>();
+        Entry::Ptr idEntry = makeShared<Entry>();
         idEntry->setID(1);
         idEntry->setNum(num);
         idEntry->setStatus(0);
@@ -470,31 +1167,78 @@ size_t CachedStorage::commit(h256 hash, int64_t num, const std::vector<TableData
         data->dirtyEntries->addEntry(idEntry);
 
         task->datas->push_back(data);
+
+        for (auto it : *task->datas)
+        {
+            for (auto entryIt : *it->dirtyEntries)
+            {
+                task->capacity += entryIt->capacity();
+            }
+            for (auto entryIt : *it->newEntries)
+            {
+                task->capacity += entryIt->capacity();
+            }
+        }
+
         auto backend = m_backend;
         auto self = std::weak_ptr<CachedStorage>(
             std::dynamic_pointer_cast<CachedStorage>(shared_from_this()));
 
+        if (m_wal && !disabled())
+        {
+            try
+            {
+                m_wal->append(hash, num, *task->datas);
+            }
+            catch (std::exception& e)
+            {
+                LOG(FATAL) << "Fail while logging block: " << e.what();
+
+                exit(1);
+            }
+        }
+
         m_commitNum.store(num);
 
         if (!disabled())
         {
-            m_taskThreadPool->enqueue([task, self]() {
+            m_forwardBytes.fetch_and_add(task->capacity);
+            {
+                MutexScoped lock(m_tasksMutex);
+                m_tasks.push_back(task);
+            }
+
+            // every job flushes at least one block, so the queue is drained by the pending jobs
+            m_taskThreadPool->enqueue([self]() {
                 auto storage = self.lock();
                 if (storage)
                 {
-                    storage->commitBackend(task);
+                    storage->flushTasks();
                 }
             });
 
             STORAGE_LOG(INFO) << "Submited block task: " << num
                               << ", current syncd block: " << m_syncNum;
 
+            auto forward = [&]() {
+                return (((size_t)(m_commitNum - m_syncNum) > m_maxForwardBlock) ||
+                           (m_maxForwardBytes > 0 && m_forwardBytes > m_maxForwardBytes &&
+                               m_commitNum > m_syncNum)) &&
+                       m_running->load();
+            };
+            // the consensus commits on its workers, which the flush needs while they wait
+            std::unique_ptr<Executor::Blocking> blocking;
+            if (forward())
+            {
+                blocking.reset(new Executor::Blocking());
+            }
             uint64_t waitCount = 0;
-            while (((size_t)(m_commitNum - m_syncNum) > m_maxForwardBlock) && m_running->load())
+            while (forward())
             {
                 CACHED_STORAGE_LOG(INFO)
                     << "Current block number: " << m_commitNum
-                    << " greater than syncd block number: " << m_syncNum << ", waiting...";
+                    << " greater than syncd block number: " << m_syncNum
+                    << ", forward bytes: " << m_forwardBytes << ", waiting...";
 
                 if (waitCount < 5)
                 {
@@ -528,62 +1272,356 @@ bool CachedStorage::onlyDirty()
     return true;
 }
 
-void CachedStorage::setBackend(Storage::Ptr backend)
-{
-    m_backend = backend;
-}
-
-void CachedStorage::init()
+void CachedStorage::restore(TableInfo::Ptr tableInfo, const StorageIterator::Batch& rows)
 {
-    auto tableInfo = std::make_shared<storage::TableInfo>();
-    tableInfo->name = SYS_CURRENT_STATE;
-    tableInfo->key = SYS_KEY;
-    tableInfo->fields = std::vector<std::string>{"value"};
-
-    auto condition = std::make_shared<Condition>();
-    condition->EQ(SYS_KEY, SYS_KEY_CURRENT_ID);
-
-    // get id from backend
-    auto out = m_backend->select(h256(), 0, tableInfo, SYS_KEY_CURRENT_ID, condition);
-    if (out->size() > 0)
+    if (!m_backend)
     {
-        auto entry = out->get(0);
-        auto numStr = entry->getField(SYS_VALUE);
-        m_ID = boost::lexical_cast<size_t>(numStr);
+        BOOST_THROW_EXCEPTION(StorageException(-1, "CachedStorage restore without backend"));
     }
 
-    if (!disabled())
+    // the flushed blocks must not overwrite the restored keys
     {
-        startClearThread();
+        Executor::Blocking blocking;
+        while (m_commitNum > m_syncNum && m_running->load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
     }
-}
-
-void CachedStorage::stop()
-{
-    STORAGE_LOG(INFO) << "Stoping flushStorage thread";
-    m_running->store(false);
 
-    m_taskThreadPool->stop();
+    m_backend->restore(tableInfo, rows);
 
-    if (m_clearThread)
+    for (auto& row : rows)
     {
-        if (m_clearThread->get_id() != std::this_thread::get_id())
+        auto shard = getShard(tableInfo->name, row.first);
+        RWMutexScoped lockCache(shard->cachesMutex, true);
+        auto tableIt = shard->caches.find(tableInfo->name);
+        if (tableIt == shard->caches.end())
         {
-            m_clearThread->join();
-            m_clearThread.reset();
+            continue;
         }
-        else
+
+        auto keyIt = tableIt->second->find(row.first);
+        if (keyIt == tableIt->second->end())
         {
-            m_clearThread->detach();
+            continue;
         }
-    }
-}
 
-void CachedStorage::clear()
-{
-    RWMutexScoped lockCache(m_cachesMutex, true);
+        int64_t totalCapacity = 0;
+        {
+            Cache::RWScoped cacheLock(*(keyIt->second->mutex()), false);
+            for (auto entryIt : *(keyIt->second->entries()))
+            {
+                totalCapacity += entryIt->capacity();
+            }
+        }
+        tableIt->second->unsafe_erase(keyIt);
+        updateCapacity(shard, tableInfo->name, 0 - totalCapacity);
+    }
+
+    if (tableInfo->name == SYS_CURRENT_STATE)
+    {
+        loadState();
+        m_commitNum.store(m_cachedNum.load());
+        setSyncNum(m_cachedNum.load());
+    }
+
+    CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("restore") << LOG_KV("table", tableInfo->name)
+                              << LOG_KV("keys", rows.size());
+}
+
+int64_t CachedStorage::checkpoint(const std::string& path)
+{
+    if (!m_backend)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "CachedStorage checkpoint without backend"));
+    }
+
+    uint64_t commitNum = m_commitNum;
+    {
+        Executor::Blocking blocking;
+        while (m_syncNum < commitNum && m_running->load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    if (m_syncNum < commitNum)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "CachedStorage stopped before checkpoint"));
+    }
+
+    MutexScoped lock(m_flushMutex);
+    auto start = utcTime();
+    m_backend->checkpoint(path);
+    int64_t syncNum = m_syncNum;
+    CACHED_STORAGE_LOG(INFO) << LOG_BADGE("Checkpoint") << LOG_KV("path", path)
+                             << LOG_KV("num", syncNum) << LOG_KV("commitNum", m_commitNum)
+                             << LOG_KV("timecost", utcTime() - start);
+    return syncNum;
+}
+
+void CachedStorage::setBackend(Storage::Ptr backend)
+{
+    m_backend = backend;
+}
+
+void CachedStorage::init()
+{
+    auto tableInfo = std::make_shared<storage::TableInfo>();
+    tableInfo->name = SYS_CURRENT_STATE;
+    tableInfo->key = SYS_KEY;
+    tableInfo->fields = std::vector<std::string>{"value"};
+
+    if (m_wal && m_backend && !disabled())
+    {
+        // the backend catches up with the logged blocks before anything is read from it
+        auto numberCondition = std::make_shared<Condition>();
+        numberCondition->EQ(SYS_KEY, SYS_KEY_CURRENT_NUMBER);
+        auto out =
+            m_backend->select(h256(), 0, tableInfo, SYS_KEY_CURRENT_NUMBER, numberCondition);
+        int64_t backendNum = -1;
+        if (out->size() > 0)
+        {
+            backendNum = boost::lexical_cast<int64_t>(out->get(0)->getField(SYS_VALUE));
+        }
+
+        int64_t replayedNum = backendNum;
+        m_wal->open(backendNum, [&](BlockWAL::Block& block) {
+            CACHED_STORAGE_LOG(INFO) << LOG_BADGE("BlockWAL") << LOG_DESC("Replay block")
+                                     << LOG_KV("num", block.num);
+            m_backend->commit(block.hash, block.num, block.datas);
+            replayedNum = block.num;
+        });
+        m_wal->truncate(replayedNum);
+    }
 
-    m_caches.clear();
+    loadState();
+
+    if (!disabled())
+    {
+        startClearThread();
+    }
+}
+
+void CachedStorage::loadState()
+{
+    auto tableInfo = std::make_shared<storage::TableInfo>();
+    tableInfo->name = SYS_CURRENT_STATE;
+    tableInfo->key = SYS_KEY;
+    tableInfo->fields = std::vector<std::string>{"value"};
+
+    auto condition = std::make_shared<Condition>();
+    condition->EQ(SYS_KEY, SYS_KEY_CURRENT_ID);
+
+    // get id from backend
+    auto out = m_backend->select(h256(), 0, tableInfo, SYS_KEY_CURRENT_ID, condition);
+    if (out->size() > 0)
+    {
+        auto entry = out->get(0);
+        auto numStr = entry->getField(SYS_VALUE);
+        m_ID = boost::lexical_cast<size_t>(numStr);
+    }
+
+    // snapshots taken before the first commit see the backend
+    auto numberCondition = std::make_shared<Condition>();
+    numberCondition->EQ(SYS_KEY, SYS_KEY_CURRENT_NUMBER);
+    out = m_backend->select(h256(), 0, tableInfo, SYS_KEY_CURRENT_NUMBER, numberCondition);
+    if (out->size() > 0)
+    {
+        m_cachedNum.store(boost::lexical_cast<int64_t>(out->get(0)->getField(SYS_VALUE)));
+    }
+}
+
+void CachedStorage::stop()
+{
+    STORAGE_LOG(INFO) << "Stoping flushStorage thread";
+    m_running->store(false);
+
+    m_taskThreadPool->stop();
+    if (m_backend)
+    {
+        m_backend->stop();
+    }
+
+    if (m_clearThread)
+    {
+        if (m_clearThread->get_id() != std::this_thread::get_id())
+        {
+            m_clearThread->join();
+            m_clearThread.reset();
+        }
+        else
+        {
+            m_clearThread->detach();
+        }
+    }
+
+    if (!m_hotKeysPath.empty())
+    {
+        saveHotKeys();
+    }
+}
+
+void CachedStorage::setHotKeys(const std::string& path, size_t maxKeys, uint64_t interval)
+{
+    m_hotKeysPath = path;
+    m_maxHotKeys = maxKeys;
+    m_hotKeysInterval = interval;
+    m_hotKeysSaved = std::chrono::steady_clock::now();
+}
+
+void CachedStorage::saveHotKeys()
+{
+    if (m_hotKeysPath.empty() || m_maxHotKeys == 0 || disabled())
+    {
+        return;
+    }
+    m_hotKeysSaved = std::chrono::steady_clock::now();
+
+    // one line of the table, its key field and the hex of the key, the most recent first
+    auto tmpPath = m_hotKeysPath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::trunc);
+    size_t keys = 0;
+    size_t shardKeys = (m_maxHotKeys + m_shards.size() - 1) / m_shards.size();
+    for (auto shard : m_shards)
+    {
+        popMRU(shard);
+        size_t count = 0;
+        for (auto it = shard->mru->rbegin();
+             it != shard->mru->rend() && count < shardKeys && keys < m_maxHotKeys; ++it)
+        {
+            auto cache = findCache(shard, it->first, it->second);
+            if (!cache)
+            {
+                continue;
+            }
+            Cache::RWScoped lock(*(cache->mutex()), false);
+            if (cache->empty() || !cache->tableInfo())
+            {
+                continue;
+            }
+            out << it->first << " " << cache->tableInfo()->key << " " << toHex(it->second)
+                << "\n";
+            ++count;
+            ++keys;
+        }
+    }
+    out.close();
+
+    boost::system::error_code error;
+    if (out)
+    {
+        boost::filesystem::rename(tmpPath, m_hotKeysPath, error);
+    }
+    if (!out || error)
+    {
+        CACHED_STORAGE_LOG(WARNING) << LOG_BADGE("HotKeys") << LOG_DESC("Save hot keys failed")
+                                    << LOG_KV("path", m_hotKeysPath)
+                                    << LOG_KV("error", error.message());
+        return;
+    }
+    CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("HotKeys") << LOG_DESC("Save hot keys")
+                              << LOG_KV("keys", keys);
+}
+
+size_t CachedStorage::warmUp(size_t keysPerSecond)
+{
+    if (m_hotKeysPath.empty() || !m_backend || disabled())
+    {
+        return 0;
+    }
+    std::ifstream in(m_hotKeysPath);
+    if (!in)
+    {
+        return 0;
+    }
+
+    std::map<std::pair<std::string, std::string>, std::vector<std::string> > tableKeys;
+    std::string line;
+    size_t keys = 0;
+    while (keys < m_maxHotKeys && std::getline(in, line))
+    {
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of(" "));
+        if (fields.size() != 3 || fields[2].empty())
+        {
+            continue;
+        }
+        auto key = fromHex(fields[2]);
+        if (key.empty())
+        {
+            continue;
+        }
+        tableKeys[std::make_pair(fields[0], fields[1])].push_back(
+            std::string(key.begin(), key.end()));
+        ++keys;
+    }
+
+    std::vector<std::pair<TableInfo::Ptr, std::vector<std::string> > > batches;
+    for (auto& it : tableKeys)
+    {
+        auto tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = it.first.first;
+        tableInfo->key = it.first.second;
+        for (size_t i = 0; i < it.second.size(); i += c_warmUpBatchSize)
+        {
+            auto end = std::min(i + c_warmUpBatchSize, it.second.size());
+            batches.emplace_back(tableInfo,
+                std::vector<std::string>(it.second.begin() + i, it.second.begin() + end));
+        }
+    }
+
+    // every batch waits for its turn so that the keys are fetched at most keysPerSecond
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> scheduled = {0};
+    std::atomic<size_t> fetched = {0};
+    int64_t num = m_syncNum;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, batches.size(), 1),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                if (m_capacity >= m_maxCapacity)
+                {
+                    return;
+                }
+                auto& batch = batches[i];
+                if (keysPerSecond > 0)
+                {
+                    auto before = scheduled.fetch_add(batch.second.size());
+                    std::this_thread::sleep_until(
+                        start + std::chrono::milliseconds(before * 1000 / keysPerSecond));
+                }
+                try
+                {
+                    prefetch(h256(), num, batch.first, batch.second);
+                    fetched += batch.second.size();
+                }
+                catch (std::exception& e)
+                {
+                    CACHED_STORAGE_LOG(WARNING)
+                        << LOG_BADGE("HotKeys") << LOG_DESC("Fetch hot keys failed")
+                        << LOG_KV("table", batch.first->name)
+                        << LOG_KV("error", boost::diagnostic_information(e));
+                }
+            }
+        });
+
+    auto timeCost = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    CACHED_STORAGE_LOG(INFO) << LOG_BADGE("HotKeys") << LOG_DESC("Warm up the cache")
+                             << LOG_KV("keys", keys) << LOG_KV("fetched", fetched.load())
+                             << LOG_KV("capacity", readableCapacity(m_capacity))
+                             << LOG_KV("timeCost", timeCost.count());
+    return fetched;
+}
+
+void CachedStorage::clear()
+{
+    for (auto shard : m_shards)
+    {
+        RWMutexScoped lockCache(shard->cachesMutex, true);
+
+        shard->caches.clear();
+    }
 }
 
 int64_t CachedStorage::syncNum()
@@ -601,28 +1639,97 @@ void CachedStorage::setMaxCapacity(int64_t maxCapacity)
     m_maxCapacity = maxCapacity;
 }
 
+void CachedStorage::setClearInterval(uint64_t clearInterval)
+{
+    m_clearInterval = std::max(clearInterval, (uint64_t)1);
+    // 100 accesses a ms, as 100000 in the default second
+    m_maxPopMRU = m_clearInterval * 100;
+}
+
 void CachedStorage::setMaxForwardBlock(size_t maxForwardBlock)
 {
     m_maxForwardBlock = maxForwardBlock;
 }
 
+void CachedStorage::setMaxForwardBytes(int64_t maxForwardBytes)
+{
+    m_maxForwardBytes = maxForwardBytes;
+}
+
+void CachedStorage::setMaxMergeBlock(size_t maxMergeBlock)
+{
+    m_maxMergeBlock = maxMergeBlock;
+}
+
+void CachedStorage::setCacheShards(size_t cacheShards)
+{
+    if (cacheShards == 0)
+    {
+        cacheShards = std::max(std::thread::hardware_concurrency(), (unsigned int)1);
+    }
+
+    m_shards.clear();
+    for (size_t i = 0; i < cacheShards; ++i)
+    {
+        m_shards.push_back(std::make_shared<CacheShard>());
+    }
+
+    CACHED_STORAGE_LOG(INFO) << LOG_DESC("Set cache shards") << LOG_KV("shards", cacheShards);
+}
+
 size_t CachedStorage::ID()
 {
     return m_ID;
 }
 
+size_t CachedStorage::pipelineDepth()
+{
+    auto commitNum = m_commitNum.load();
+    auto syncNum = m_syncNum.load();
+    return commitNum > syncNum ? commitNum - syncNum : 0;
+}
+
+int64_t CachedStorage::forwardBytes()
+{
+    return m_forwardBytes;
+}
+
+uint64_t CachedStorage::lastMergedBlocks()
+{
+    return m_lastMergedBlocks;
+}
+
+uint64_t CachedStorage::lastMergedBytes()
+{
+    return m_lastMergedBytes;
+}
+
+uint64_t CachedStorage::lastBackendLatency()
+{
+    return m_lastBackendLatency;
+}
+
 void CachedStorage::startClearThread()
 {
     std::weak_ptr<CachedStorage> self(std::dynamic_pointer_cast<CachedStorage>(shared_from_this()));
     auto running = m_running;
     m_clearThread = std::make_shared<std::thread>([running, self]() {
+        pthread_setThreadName("CacheClear");
+        g_cpuAffinity.bindThread("CacheClear");
         while (true)
         {
             auto storage = self.lock();
             if (storage && storage->m_running->load())
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(storage->m_clearInterval));
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(storage->m_clearInterval.load()));
                 storage->checkAndClear();
+                if (!storage->m_hotKeysPath.empty() &&
+                    std::chrono::steady_clock::now() - storage->m_hotKeysSaved >=
+                        std::chrono::milliseconds(storage->m_hotKeysInterval))
+                {
+                    storage->saveHotKeys();
+                }
             }
             else
             {
@@ -632,6 +1739,16 @@ void CachedStorage::startClearThread()
     });
 }
 
+CacheShard::Ptr CachedStorage::getShard(const std::string& table, const std::string& key)
+{
+    if (m_shards.size() == 1)
+    {
+        return m_shards[0];
+    }
+
+    return m_shards[tableKeyHash(table, key) % m_shards.size()];
+}
+
 void CachedStorage::touchMRU(const std::string& table, const std::string& key, ssize_t capacity)
 {
     if (disabled())
@@ -639,20 +1756,37 @@ void CachedStorage::touchMRU(const std::string& table, const std::string& key, s
         return;
     }
 
-    m_mruQueue->push(std::make_tuple(table, key, capacity));
+    auto shard = getShard(table, key);
+    if (m_cachePolicy == CLOCK)
+    {
+        // accesses are recorded by the reference bit, only the capacity is accounted here
+        if (capacity != 0)
+        {
+            updateCapacity(shard, table, capacity);
+        }
+        return;
+    }
+
+    shard->mruQueue->push(std::make_tuple(table, key, capacity));
 }
 
-void CachedStorage::updateMRU(const std::string& table, const std::string& key, ssize_t capacity)
+void CachedStorage::updateMRU(
+    CacheShard::Ptr shard, const std::string& table, const std::string& key, ssize_t capacity)
 {
     if (capacity != 0)
     {
-        updateCapacity(capacity);
+        updateCapacity(shard, table, capacity);
     }
 
-    auto r = m_mru->push_back(std::make_pair(table, key));
+    auto r = shard->mru->push_back(std::make_pair(table, key));
     if (!r.second)
     {
-        m_mru->relocate(m_mru->end(), r.first);
+        shard->mru->relocate(shard->mru->end(), r.first);
+    }
+    else if (!admit(table, key))
+    {
+        // on probation, evicted first unless accessed again
+        shard->mru->relocate(shard->mru->begin(), r.first);
     }
 }
 
@@ -662,18 +1796,49 @@ std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr, bool> CachedStorage::to
     bool hit = true;
 
     ++m_queryTimes;
+    auto stat = tableStat(tableInfo->name);
+    ++stat->queryTimes;
+    if (m_sketch)
+    {
+        m_sketch->increment(tableKeyHash(tableInfo->name, key));
+    }
 
-    auto cache = std::make_shared<Cache>();
-    auto cacheKey = tableInfo->name + "_" + key;
+    auto shard = getShard(tableInfo->name, key);
 
+    Cache::Ptr cache;
     bool inserted = false;
     {
-        RWMutexScoped lockCache(m_cachesMutex, false);
+        RWMutexScoped lockCache(shard->cachesMutex, false);
 
-        auto result = m_caches.insert(std::make_pair(cacheKey, cache));
+        auto tableIt = shard->caches.find(tableInfo->name);
+        if (tableIt == shard->caches.end() && !write)
+        {
+            return std::make_tuple(std::shared_ptr<Cache::RWScoped>(), cache, false);
+        }
+        if (tableIt == shard->caches.end())
+        {
+            tableIt = shard->caches
+                          .insert(std::make_pair(
+                              tableInfo->name, std::make_shared<CacheShard::KeyCaches>()))
+                          .first;
+        }
 
-        cache = result.first->second;
-        inserted = result.second;
+        auto keyIt = tableIt->second->find(key);
+        if (keyIt != tableIt->second->end())
+        {
+            cache = keyIt->second;
+        }
+        else if (!write)
+        {
+            return std::make_tuple(std::shared_ptr<Cache::RWScoped>(), cache, false);
+        }
+        else
+        {
+            auto result = tableIt->second->insert(std::make_pair(key, std::make_shared<Cache>()));
+
+            cache = result.first->second;
+            inserted = result.second;
+        }
     }
 
     auto cacheLock = std::make_shared<Cache::RWScoped>(*(cache->mutex()), write);
@@ -683,11 +1848,22 @@ std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr, bool> CachedStorage::to
 
         cache->setKey(key);
         cache->setTableInfo(tableInfo);
+
+        if (m_cachePolicy == CLOCK && !disabled())
+        {
+            cache->setReferenced(admit(tableInfo->name, key));
+            shard->clockQueue->push(std::make_pair(tableInfo->name, key));
+        }
+    }
+    else if (m_cachePolicy == CLOCK)
+    {
+        cache->setReferenced(true);
     }
 
     if (hit)
     {
         ++m_hitTimes;
+        ++stat->hitTimes;
     }
 
     return std::make_tuple(cacheLock, cache, true);
@@ -701,14 +1877,28 @@ void CachedStorage::restoreCache(TableInfo::Ptr table, const std::string& key, C
      m_caches
      */
 
-    RWMutexScoped lockCache(m_cachesMutex, false);
+    auto shard = getShard(table->name, key);
+    RWMutexScoped lockCache(shard->cachesMutex, false);
+
+    auto tableIt = shard->caches.find(table->name);
+    if (tableIt == shard->caches.end())
+    {
+        tableIt =
+            shard->caches
+                .insert(std::make_pair(table->name, std::make_shared<CacheShard::KeyCaches>()))
+                .first;
+    }
+
+    auto result = tableIt->second->insert(std::make_pair(key, cache));
+    if (result.second && m_cachePolicy == CLOCK && !disabled())
+    {
+        shard->clockQueue->push(std::make_pair(table->name, key));
+    }
 
-    auto cacheKey = table->name + "_" + key;
-    auto result = m_caches.insert(std::make_pair(cacheKey, cache));
     if (!result.second && result.first->second != cache)
     {
-        CACHED_STORAGE_LOG(FATAL) << "Restore cache fail! Cache not equal: " << cacheKey << " "
-                                  << result.first->second << " " << cache;
+        CACHED_STORAGE_LOG(FATAL) << "Restore cache fail! Cache not equal: " << table->name << "-"
+                                  << key << " " << result.first->second << " " << cache;
 
         exit(1);
     }
@@ -716,10 +1906,15 @@ void CachedStorage::restoreCache(TableInfo::Ptr table, const std::string& key, C
 
 void CachedStorage::removeCache(const std::string& table, const std::string& key)
 {
-    auto cacheKey = table + "_" + key;
-    RWMutexScoped lockCache(m_cachesMutex, true);
+    auto shard = getShard(table, key);
+    RWMutexScoped lockCache(shard->cachesMutex, true);
 
-    auto c = m_caches.unsafe_erase(cacheKey);
+    size_t c = 0;
+    auto tableIt = shard->caches.find(table);
+    if (tableIt != shard->caches.end())
+    {
+        c = tableIt->second->unsafe_erase(key);
+    }
 
     if (c != 1)
     {
@@ -736,23 +1931,41 @@ bool CachedStorage::disabled()
 
 void CachedStorage::commitBackend(Task::Ptr task)
 {
+    // the last block of a merged task
+    BlockSpan span("storage.flush", groupID(), task->num, task->hash);
     auto now = std::chrono::system_clock::now();
 
     STORAGE_LOG(INFO) << "Start commit block: " << task->num << " to backend storage";
-    try
     {
-        m_backend->commit(task->hash, task->num, *(task->datas));
+        MutexScoped lock(m_flushMutex);
+        try
+        {
+            m_backend->commit(task->hash, task->num, *(task->datas));
+        }
+        catch (std::exception& e)
+        {
+            LOG(FATAL) << "Fail while commit data: " << e.what();
+
+            exit(1);
+        }
+
+        setSyncNum(task->num);
     }
-    catch (std::exception& e)
+    if (m_wal && !disabled())
     {
-        LOG(FATAL) << "Fail while commit data: " << e.what();
-
-        exit(1);
+        m_wal->truncate(task->num);
     }
 
-    setSyncNum(task->num);
-
     std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - now;
+    m_lastMergedBlocks.store(task->blocks);
+    m_lastMergedBytes.store(task->capacity);
+    m_lastBackendLatency.store(
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    if (!disabled())
+    {
+        m_forwardBytes.fetch_and_add(-task->capacity);
+    }
+
     STORAGE_LOG(INFO)
         << "[g:" << std::to_string(groupID()) << "]"
         << "\n---------------------------------------------------------------------\n"
@@ -761,6 +1974,12 @@ void CachedStorage::commitBackend(Task::Ptr task)
         << "Flush elapsed time: " << std::setiosflags(std::ios::fixed) << std::setprecision(4)
         << elapsed.count() << "s"
         << "\n---------------------------------------------------------------------\n";
+    CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("Commit pipeline") << LOG_KV("num", task->num)
+                              << LOG_KV("mergedBlocks", task->blocks)
+                              << LOG_KV("mergedBytes", task->capacity)
+                              << LOG_KV("pipelineDepth", pipelineDepth())
+                              << LOG_KV("forwardBytes", m_forwardBytes)
+                              << LOG_KV("backendLatency", m_lastBackendLatency);
 
     if (disabled())
     {
@@ -768,39 +1987,287 @@ void CachedStorage::commitBackend(Task::Ptr task)
     }
 }
 
+void CachedStorage::flushTasks()
+{
+    std::vector<Task::Ptr> tasks;
+    {
+        MutexScoped lock(m_tasksMutex);
+
+        // a later force entry replaces the key in the backend, it can't share a batch with an
+        // earlier force entry of the same key
+        std::set<std::string> batchForceKeys;
+        while (!m_tasks.empty() && tasks.size() < std::max(m_maxMergeBlock, (uint64_t)1))
+        {
+            auto task = m_tasks.front();
+            auto keys = forceKeys(task);
+
+            bool conflict = false;
+            for (auto& key : keys)
+            {
+                if (!batchForceKeys.insert(key).second)
+                {
+                    conflict = true;
+                    break;
+                }
+            }
+
+            if (conflict && !tasks.empty())
+            {
+                break;
+            }
+
+            tasks.push_back(task);
+            m_tasks.pop_front();
+        }
+    }
+
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    if (tasks.size() == 1)
+    {
+        commitBackend(tasks[0]);
+    }
+    else
+    {
+        commitBackend(mergeTasks(tasks));
+    }
+}
+
+std::set<std::string> CachedStorage::forceKeys(Task::Ptr task)
+{
+    std::set<std::string> keys;
+    for (auto it : *task->datas)
+    {
+        for (auto entryIt : *it->newEntries)
+        {
+            if (entryIt->force())
+            {
+                keys.insert(it->info->name + "_" + entryIt->getField(it->info->key));
+            }
+        }
+    }
+
+    return keys;
+}
+
+Task::Ptr CachedStorage::mergeTasks(const std::vector<Task::Ptr>& tasks)
+{
+    TIME_RECORD("Merge commit tasks");
+
+    // entries keyed by id, ids are increasing so the maps keep the commit order
+    struct MergedTable
+    {
+        TableInfo::Ptr info;
+        std::map<uint64_t, Entry::Ptr> dirtyEntries;
+        std::map<uint64_t, Entry::Ptr> newEntries;
+    };
+
+    std::vector<MergedTable> tables;
+    std::map<std::string, size_t> name2Table;
+    size_t superseded = 0;
+
+    auto merged = std::make_shared<Task>();
+    merged->hash = tasks.back()->hash;
+    merged->num = tasks.back()->num;
+    merged->datas = std::make_shared<std::vector<TableData::Ptr>>();
+    merged->blocks = 0;
+
+    for (auto task : tasks)
+    {
+        merged->capacity += task->capacity;
+        merged->blocks += task->blocks;
+
+        for (auto data : *task->datas)
+        {
+            auto tableIt = name2Table.find(data->info->name);
+            if (tableIt == name2Table.end())
+            {
+                tableIt = name2Table.insert(std::make_pair(data->info->name, tables.size())).first;
+                tables.push_back(MergedTable());
+            }
+
+            auto& table = tables[tableIt->second];
+            table.info = data->info;
+
+            for (auto entry : *data->dirtyEntries)
+            {
+                // the entry is still new to the backend, write the latest value with the insert
+                auto newIt = table.newEntries.find(entry->getID());
+                if (newIt != table.newEntries.end())
+                {
+                    auto newEntry = makeShared<Entry>();
+                    newEntry->copyFrom(entry);
+                    newEntry->setForce(newIt->second->force());
+                    newIt->second = newEntry;
+                    ++superseded;
+                    continue;
+                }
+
+                auto inserted = table.dirtyEntries.insert(std::make_pair(entry->getID(), entry));
+                if (!inserted.second)
+                {
+                    inserted.first->second = entry;
+                    ++superseded;
+                }
+            }
+
+            for (auto entry : *data->newEntries)
+            {
+                table.newEntries[entry->getID()] = entry;
+            }
+        }
+    }
+
+    for (auto& table : tables)
+    {
+        auto data = std::make_shared<TableData>();
+        data->info = table.info;
+        for (auto& it : table.dirtyEntries)
+        {
+            data->dirtyEntries->addEntry(it.second);
+        }
+        for (auto& it : table.newEntries)
+        {
+            data->newEntries->addEntry(it.second);
+        }
+
+        tbb::parallel_sort(data->dirtyEntries->begin(), data->dirtyEntries->end(),
+            EntryLessNoLock(data->info));
+        tbb::parallel_sort(
+            data->newEntries->begin(), data->newEntries->end(), EntryLessNoLock(data->info));
+
+        merged->datas->push_back(data);
+    }
+
+    CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("Commit pipeline") << LOG_DESC("Merge commit tasks")
+                              << LOG_KV("from", tasks.front()->num) << LOG_KV("to", merged->num)
+                              << LOG_KV("tables", merged->datas->size())
+                              << LOG_KV("superseded", superseded);
+
+    return merged;
+}
+
 void CachedStorage::checkAndClear()
 {
-    uint64_t count = 0;
+    TIME_RECORD("Check and clear");
+
+    auto currentCapacity = m_capacity.load();
+    int64_t oldest = 0;
+    {
+        // a snapshot pinned later sees the flushed caches as they are
+        std::lock_guard<std::mutex> lock(x_snapshots);
+        oldest = oldestSnapshot();
+    }
+    int64_t maxShardCapacity = m_maxCapacity / (int64_t)m_shards.size();
+
+    tbb::atomic<size_t> evicted = 0;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_shards.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                auto shard = m_shards[i];
+
+                if (m_cachePolicy == CLOCK)
+                {
+                    evicted += clearShardClock(shard, maxShardCapacity, oldest);
+                    continue;
+                }
+
+                auto count = popMRU(shard);
+
+                CACHED_STORAGE_LOG(DEBUG)
+                    << "CheckAndClear pop: " << count << " elements" << LOG_KV("shard", i);
+
+                evicted += clearShard(shard, maxShardCapacity, oldest);
+            }
+        });
+
+    if (evicted > 0)
+    {
+        CACHED_STORAGE_LOG(INFO) << "Clear finished, evicted: " << evicted << " entries, "
+                                 << readableCapacity(currentCapacity - m_capacity)
+                                 << ", Current total entries: " << cacheSize()
+                                 << ", Current total mru entries: " << mruSize()
+                                 << ", total capacaity: " << readableCapacity(m_capacity)
+                                 << ", shards: " << m_shards.size();
+
+        CACHED_STORAGE_LOG(DEBUG)
+            << "Cache Status: \n\n"
+            << "\n---------------------------------------------------------------------\n"
+            << "Total query: " << m_queryTimes << "\n"
+            << "Total cache hit: " << m_hitTimes << "\n"
+            << "Total cache miss: " << m_queryTimes - m_hitTimes << "\n"
+            << "Total hit ratio: " << std::setiosflags(std::ios::fixed) << std::setprecision(4)
+            << ((double)m_hitTimes / m_queryTimes) * 100 << "%"
+            << "\n\n"
+            << "Cache capacity: " << readableCapacity(m_capacity) << "\n"
+            << "Cache size: " << mruSize()
+            << "\n---------------------------------------------------------------------\n";
+
+        for (auto& it : m_quotaTables)
+        {
+            CACHED_STORAGE_LOG(DEBUG)
+                << LOG_BADGE("TableQuota") << LOG_KV("table", it.first)
+                << LOG_KV("capacity", readableCapacity(it.second->capacity))
+                << LOG_KV("quota", readableCapacity(it.second->quota))
+                << LOG_KV("query", it.second->queryTimes) << LOG_KV("hit", it.second->hitTimes);
+        }
+    }
+
+    MetricsRegistry::Labels labels = {{"group", std::to_string(groupID())}};
+    g_metrics.gauge("bcos_cache_bytes", "the bytes cached", labels).set(m_capacity);
+    g_metrics.gauge("bcos_cache_max_bytes", "the bytes the cache is bounded by", labels)
+        .set(m_maxCapacity);
+    g_metrics.gauge("bcos_cache_queries", "the queries of the cache since the start", labels)
+        .set(m_queryTimes);
+    g_metrics.gauge("bcos_cache_hits", "the queries hitting the cache since the start", labels)
+        .set(m_hitTimes);
+}
+
+size_t CachedStorage::popMRU(CacheShard::Ptr shard)
+{
+    size_t count = 0;
+    if (m_cachePolicy == CLOCK)
+    {
+        // the keys entered the cache since last sweep join the clock ring
+        std::pair<std::string, std::string> tableKey;
+        while (shard->clockQueue->try_pop(tableKey))
+        {
+            shard->mru->push_back(tableKey);
+            ++count;
+        }
+        return count;
+    }
+
     while (count < m_maxPopMRU)
     {
         std::tuple<std::string, std::string, ssize_t> mru;
-        auto result = m_mruQueue->try_pop(mru);
+        auto result = shard->mruQueue->try_pop(mru);
         if (!result)
         {
             break;
         }
-        updateMRU(std::get<0>(mru), std::get<1>(mru), std::get<2>(mru));
+        updateMRU(shard, std::get<0>(mru), std::get<1>(mru), std::get<2>(mru));
         ++count;
     }
+    return count;
+}
 
-    CACHED_STORAGE_LOG(DEBUG) << "CheckAndClear pop: " << count << " elements";
-
-    TIME_RECORD("Check and clear");
-
+size_t CachedStorage::clearShard(
+    CacheShard::Ptr shard, int64_t maxShardCapacity, int64_t oldestSnapshot)
+{
     bool needClear = false;
-    size_t clearTimes = 0;
-
-    auto currentCapacity = m_capacity.load();
-
-    size_t clearCount = 0;
-    size_t clearThrough = 0;
+    size_t totalEvicted = 0;
     do
     {
         needClear = false;
 
         if (m_syncNum > 0)
         {
-            if (m_capacity > m_maxCapacity && !m_mru->empty())
+            if ((shard->capacity > maxShardCapacity || anyOverQuota()) && !shard->mru->empty())
             {
                 needClear = true;
             }
@@ -808,79 +2275,280 @@ void CachedStorage::checkAndClear()
 
         if (needClear)
         {
-            for (auto it = m_mru->begin(); it != m_mru->end();)
+            size_t evicted = 0;
+            for (auto it = shard->mru->begin(); it != shard->mru->end();)
             {
-                if (m_capacity <= (int64_t)m_maxCapacity || m_mru->empty())
+                bool overCapacity = shard->capacity > maxShardCapacity;
+                if ((!overCapacity && !anyOverQuota()) || shard->mru->empty())
                 {
                     break;
                 }
 
-                ++clearThrough;
-
-                auto tableInfo = std::make_shared<TableInfo>();
-                tableInfo->name = it->first;
+                // only the over quota tables are cleared while the shard is within capacity
+                bool tableOverQuota = overQuota(it->first);
+                if (!overCapacity && !tableOverQuota)
+                {
+                    ++it;
+                    continue;
+                }
 
-                auto result = touchCache(tableInfo, it->second, true);
-                auto cache = std::get<1>(result);
+                // not touchCache, clearing isn't an access
+                auto cache = findCache(shard, it->first, it->second);
+                if (!cache)
+                {
+                    it = shard->mru->erase(it);
+                    continue;
+                }
 
-                if (std::get<2>(result))
+                Cache::RWScoped cacheLock(*(cache->mutex()), true);
+                if (m_syncNum > 0 && evictable(cache, oldestSnapshot))
                 {
-                    if (m_syncNum > 0 && (cache->num() <= m_syncNum))
+                    int64_t totalCapacity = 0;
+                    for (auto entryIt : *(cache->entries()))
                     {
-                        int64_t totalCapacity = 0;
-                        for (auto entryIt : *(cache->entries()))
-                        {
-                            totalCapacity += entryIt->capacity();
-                        }
+                        totalCapacity += entryIt->capacity();
+                    }
 
-                        ++clearCount;
-                        updateCapacity(0 - totalCapacity);
+                    updateCapacity(shard, it->first, 0 - totalCapacity);
 
-                        cache->setEmpty(true);
-                        removeCache(it->first, it->second);
-                        it = m_mru->erase(it);
-                    }
-                    else
-                    {
-                        break;
-                    }
+                    cache->setEmpty(true);
+                    cache->clearVersions();
+                    removeCache(it->first, it->second);
+                    it = shard->mru->erase(it);
+                    ++evicted;
+                    ++totalEvicted;
+                }
+                else if (overCapacity)
+                {
+                    // the rest of this shard hasn't been flushed to backend yet
+                    return totalEvicted;
                 }
                 else
                 {
                     ++it;
                 }
             }
-            ++clearTimes;
+
+            if (evicted == 0)
+            {
+                break;
+            }
         }
     } while (needClear);
 
-    if (clearThrough > 0)
+    return totalEvicted;
+}
+
+size_t CachedStorage::clearShardClock(
+    CacheShard::Ptr shard, int64_t maxShardCapacity, int64_t oldestSnapshot)
+{
+    popMRU(shard);
+
+    if (m_syncNum == 0 || (shard->capacity <= maxShardCapacity && !anyOverQuota()))
     {
-        CACHED_STORAGE_LOG(INFO) << "Clear finished, total: " << clearCount << " entries, "
-                                 << "through: " << clearThrough << " entries, "
-                                 << readableCapacity(currentCapacity - m_capacity)
-                                 << ", Current total entries: " << m_caches.size()
-                                 << ", Current total mru entries: " << m_mru->size()
-                                 << ", total capacaity: " << readableCapacity(m_capacity);
+        return 0;
+    }
 
-        CACHED_STORAGE_LOG(DEBUG)
-            << "Cache Status: \n\n"
-            << "\n---------------------------------------------------------------------\n"
-            << "Total query: " << m_queryTimes << "\n"
-            << "Total cache hit: " << m_hitTimes << "\n"
-            << "Total cache miss: " << m_queryTimes - m_hitTimes << "\n"
-            << "Total hit ratio: " << std::setiosflags(std::ios::fixed) << std::setprecision(4)
-            << ((double)m_hitTimes / m_queryTimes) * 100 << "%"
-            << "\n\n"
-            << "Cache capacity: " << readableCapacity(m_capacity) << "\n"
-            << "Cache size: " << m_mru->size()
-            << "\n---------------------------------------------------------------------\n";
+    // every key gets at most one second chance in a sweep
+    size_t maxSteps = shard->mru->size() * 2;
+    size_t steps = 0;
+    size_t evicted = 0;
+    auto it = shard->clockHand;
+    while ((shard->capacity > maxShardCapacity || anyOverQuota()) && !shard->mru->empty() &&
+           steps < maxSteps)
+    {
+        if (it == shard->mru->end())
+        {
+            it = shard->mru->begin();
+        }
+        ++steps;
+
+        // only the over quota tables are cleared while the shard is within capacity
+        bool tableOverQuota = overQuota(it->first);
+        if (shard->capacity <= maxShardCapacity && !tableOverQuota)
+        {
+            ++it;
+            continue;
+        }
+
+        auto cache = findCache(shard, it->first, it->second);
+        if (!cache)
+        {
+            it = shard->mru->erase(it);
+            continue;
+        }
+
+        Cache::RWScoped cacheLock(*(cache->mutex()), true);
+        if (cache->referenced() && !tableOverQuota)
+        {
+            cache->setReferenced(false);
+            ++it;
+            continue;
+        }
+
+        if (evictable(cache, oldestSnapshot))
+        {
+            int64_t totalCapacity = 0;
+            for (auto entryIt : *(cache->entries()))
+            {
+                totalCapacity += entryIt->capacity();
+            }
+
+            updateCapacity(shard, it->first, 0 - totalCapacity);
+
+            cache->setEmpty(true);
+            cache->clearVersions();
+            removeCache(it->first, it->second);
+            it = shard->mru->erase(it);
+            ++evicted;
+        }
+        else
+        {
+            // not flushed to backend yet, check it next sweep
+            ++it;
+        }
+    }
+    shard->clockHand = it;
+
+    return evicted;
+}
+
+bool CachedStorage::evictable(Cache::Ptr cache, int64_t oldestSnapshot)
+{
+    return cache->num() <= m_syncNum &&
+           (oldestSnapshot < 0 || (int64_t)cache->num() <= oldestSnapshot);
+}
+
+Cache::Ptr CachedStorage::findCache(
+    CacheShard::Ptr shard, const std::string& table, const std::string& key)
+{
+    CacheShard::RWMutexScoped lockCache(shard->cachesMutex, false);
+
+    auto tableIt = shard->caches.find(table);
+    if (tableIt == shard->caches.end())
+    {
+        return Cache::Ptr();
     }
+
+    auto keyIt = tableIt->second->find(key);
+    if (keyIt == tableIt->second->end())
+    {
+        return Cache::Ptr();
+    }
+
+    return keyIt->second;
 }
 
-void CachedStorage::updateCapacity(ssize_t capacity)
+void CachedStorage::updateCapacity(
+    CacheShard::Ptr shard, const std::string& table, ssize_t capacity)
 {
+    shard->capacity.fetch_and_add(capacity);
     m_capacity.fetch_and_add(capacity);
+    tableStat(table)->capacity.fetch_and_add(capacity);
+}
+
+bool CachedStorage::overQuota(const std::string& table)
+{
+    if (m_quotaTables.empty())
+    {
+        return false;
+    }
+
+    auto stat = tableStat(table);
+    return stat->quota > 0 && stat->capacity > stat->quota;
+}
+
+bool CachedStorage::anyOverQuota()
+{
+    for (auto& it : m_quotaTables)
+    {
+        if (it.second->capacity > it.second->quota)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t CachedStorage::tableKeyHash(const std::string& table, const std::string& key)
+{
+    std::hash<std::string> hasher;
+    size_t hash = hasher(table);
+    hash ^= hasher(key) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool CachedStorage::admit(const std::string& table, const std::string& key)
+{
+    if (!m_sketch)
+    {
+        return true;
+    }
+
+    // counted by the access inserting the key
+    return m_sketch->frequency(tableKeyHash(table, key)) > 1;
+}
+
+void CachedStorage::setCacheAdmission(bool admission)
+{
+    if (admission)
+    {
+        m_sketch = std::make_shared<FrequencySketch>();
+    }
+    else
+    {
+        m_sketch.reset();
+    }
+}
+
+void CachedStorage::setTableQuota(const std::string& table, int64_t quota)
+{
+    auto stat = tableStat(table);
+    stat->quota.store(quota);
+
+    for (auto it = m_quotaTables.begin(); it != m_quotaTables.end(); ++it)
+    {
+        if (it->first == table)
+        {
+            m_quotaTables.erase(it);
+            break;
+        }
+    }
+    if (quota > 0)
+    {
+        m_quotaTables.push_back(std::make_pair(table, stat));
+    }
+}
+
+TableStat::Ptr CachedStorage::tableStat(const std::string& table)
+{
+    auto it = m_tableStats.find(table);
+    if (it != m_tableStats.end())
+    {
+        return it->second;
+    }
+
+    return m_tableStats.insert(std::make_pair(table, std::make_shared<TableStat>())).first->second;
+}
+
+size_t CachedStorage::cacheSize()
+{
+    size_t total = 0;
+    for (auto shard : m_shards)
+    {
+        total += shard->size();
+    }
+    return total;
+}
+
+size_t CachedStorage::mruSize()
+{
+    size_t total = 0;
+    for (auto shard : m_shards)
+    {
+        total += shard->mru->size();
+    }
+    return total;
 }
 
 std::string CachedStorage::readableCapacity(size_t num)
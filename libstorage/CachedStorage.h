@@ -21,8 +21,10 @@
 
 #pragma once
 
+#include "BlockWAL.h"
 #include "Storage.h"
 #include "Table.h"
+#include <libdevcore/Allocator.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/ThreadPool.h>
 #include <tbb/concurrent_queue.h>
@@ -35,6 +37,12 @@
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
 
 namespace dev
 {
@@ -64,6 +72,21 @@ public:
     virtual bool empty();
     virtual void setEmpty(bool empty);
 
+    // reference bit of the CLOCK eviction policy
+    virtual bool referenced() const;
+    virtual void setReferenced(bool referenced);
+
+    // keep the entries reachable by snapshots before block num modifies them, loaded is false if
+    // the entries never came from the backend, a negative oldestSnapshot means no snapshot
+    virtual void saveVersion(int64_t num, int64_t oldestSnapshot, bool loaded);
+    // the entries seen by a snapshot of block num, false if they must be read from the backend
+    virtual bool version(int64_t num, Entries::Ptr& entries);
+    virtual void clearVersions();
+
+    // secondary index of a field over the entries, built on first use and dropped whenever the
+    // entries change, the caller must hold the write lock
+    virtual EntriesIndex::Ptr index(const std::string& field);
+
 private:
     RWMutex m_mutex;
 
@@ -74,6 +97,83 @@ private:
     Entries::Ptr m_entries;
     // int64_t m_num;
     tbb::atomic<uint64_t> m_num;
+    tbb::atomic<bool> m_referenced;
+
+    // block number -> entries before the next block modified them, oldest first, null entries
+    // weren't loaded from the backend
+    std::deque<std::pair<uint64_t, Entries::Ptr> > m_versions;
+
+    std::map<std::string, EntriesIndex::Ptr> m_indices;
+};
+
+// cache usage of one table
+class TableStat
+{
+public:
+    typedef std::shared_ptr<TableStat> Ptr;
+    TableStat();
+
+    tbb::atomic<int64_t> capacity;
+    tbb::atomic<uint64_t> hitTimes;
+    tbb::atomic<uint64_t> queryTimes;
+
+    // bytes the table may hold in the cache, 0 means only bounded by the max capacity
+    tbb::atomic<int64_t> quota;
+};
+
+// count-min sketch of 4-bit counters estimating how often a key is accessed, the counters are
+// halved after every sample period so the estimation follows recent accesses (TinyLFU)
+class FrequencySketch
+{
+public:
+    typedef std::shared_ptr<FrequencySketch> Ptr;
+    // counters per row, rounded up to a power of two
+    FrequencySketch(size_t width = 1 << 18);
+
+    void increment(size_t hash);
+    uint32_t frequency(size_t hash);
+
+private:
+    size_t index(size_t hash, size_t row);
+    void reset();
+
+    static const size_t ROWS = 4;
+    static const uint8_t MAX_COUNT = 15;
+
+    size_t m_mask;
+    // read at random on every query, on huge pages if the caches use them
+    std::vector<tbb::atomic<uint8_t>, HugePageAllocator<tbb::atomic<uint8_t> > > m_counters;
+    tbb::atomic<uint64_t> m_additions;
+    uint64_t m_samplePeriod;
+    tbb::spin_mutex m_resetMutex;
+};
+
+class CachedStorage;
+
+// state of a pinned block read from the cache with read locks only, for queries running
+// aside of block execution, the pin is released when the snapshot is destroyed
+class CachedSnapshot : public Storage
+{
+public:
+    typedef std::shared_ptr<CachedSnapshot> Ptr;
+
+    CachedSnapshot(std::shared_ptr<CachedStorage> storage, int64_t num);
+    virtual ~CachedSnapshot();
+
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition = nullptr) override;
+    // the keys as of the pinned block, the iterator must not outlive the snapshot
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
+    // read only, throws StorageException
+    size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    bool onlyDirty() override;
+
+    int64_t num() const { return m_num; }
+
+private:
+    std::shared_ptr<CachedStorage> m_storage;
+    int64_t m_num;
 };
 
 class Task
@@ -84,6 +184,47 @@ public:
     h256 hash;
     int64_t num = 0;
     std::shared_ptr<std::vector<TableData::Ptr> > datas;
+
+    // bytes of the entries in datas, held by the in-flight window until written to the backend
+    int64_t capacity = 0;
+    // blocks merged into this task
+    size_t blocks = 1;
+};
+
+class CacheShard
+{
+public:
+    typedef std::shared_ptr<CacheShard> Ptr;
+
+    typedef tbb::spin_rw_mutex RWMutex;
+    typedef tbb::spin_rw_mutex::scoped_lock RWMutexScoped;
+
+    // key -> cache of one table, tables are split into a second level so that lookups with the
+    // caller's table name and key don't need to build a concatenated string
+    typedef tbb::concurrent_unordered_map<std::string, Cache::Ptr> KeyCaches;
+
+    typedef boost::multi_index_container<std::pair<std::string, std::string>,
+        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::identity<std::pair<std::string, std::string> > > > >
+        MRUList;
+
+    CacheShard();
+
+    size_t size();
+
+    tbb::concurrent_unordered_map<std::string, std::shared_ptr<KeyCaches> > caches;
+    RWMutex cachesMutex;
+
+    // LRU: ordered by last access, fed by mruQueue
+    // CLOCK: the clock ring, fed by clockQueue with keys entering the cache
+    std::shared_ptr<MRUList> mru;
+    std::shared_ptr<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t> > >
+        mruQueue;
+    std::shared_ptr<tbb::concurrent_queue<std::pair<std::string, std::string> > > clockQueue;
+    MRUList::iterator clockHand;
+
+    tbb::atomic<int64_t> capacity;
 };
 
 class CachedStorage : public Storage
@@ -92,6 +233,14 @@ public:
     typedef std::shared_ptr<CachedStorage> Ptr;
     CachedStorage();
 
+    enum CachePolicy
+    {
+        // every access is queued and replayed into an ordered MRU list by the clear thread
+        LRU = 0,
+        // every access only sets the reference bit of the cache, a clock hand sweeps the keys
+        CLOCK
+    };
+
     typedef tbb::spin_rw_mutex RWMutex;
     typedef tbb::spin_rw_mutex::scoped_lock RWMutexScoped;
 
@@ -107,10 +256,42 @@ public:
         int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition = nullptr);
 
+    // keys missing in the cache are fetched from the backend with one batchSelect
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
+    // load the keys into the cache, return the number of keys already cached
+    size_t prefetch(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys);
+
+    // pin the latest block applied to the cache, commits keep the entries it can see
+    CachedSnapshot::Ptr snapshot();
+    // read the key as of the pinned block of a snapshot, missed keys aren't put into the cache
+    Entries::Ptr selectSnapshot(int64_t snapshotNum, h256 hash, TableInfo::Ptr tableInfo,
+        const std::string& key, Condition::Ptr condition = nullptr);
+    size_t snapshots();
+
+    // keys in the cache overlay the backend scan, the cached keys are taken when called, so keys
+    // committed later may be missed
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
+    // scan as of the pinned block of a snapshot
+    StorageIterator::Ptr scanSnapshot(int64_t snapshotNum, TableInfo::Ptr tableInfo,
+        const std::string& begin, const std::string& end, size_t batchSize = 100);
+
     size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
     bool onlyDirty() override;
 
+    // the blocks in flight are flushed before the keys are restored into the backend, the keys
+    // are dropped from the cache and the id and number reloaded when the current state is restored
+    void restore(TableInfo::Ptr tableInfo, const StorageIterator::Batch& rows) override;
+    // the blocks committed when called are flushed, then the backend copies itself between two
+    // flushes, the blocks committed meanwhile wait in the cache
+    int64_t checkpoint(const std::string& path) override;
+
     void setBackend(Storage::Ptr backend);
+    // blocks are logged before they are queued for the backend, init replays the blocks the
+    // backend missed, so the forward window no longer bounds what a crash loses
+    void setWAL(BlockWAL::Ptr wal) { m_wal = wal; }
     void init();
     void stop() override;
 
@@ -119,16 +300,66 @@ public:
     int64_t syncNum();
     void setSyncNum(int64_t syncNum);
 
+    // may be changed while the storage is accessed, the cache is cleared down to it later
     void setMaxCapacity(int64_t maxCapacity);
+    int64_t maxCapacity() const { return m_maxCapacity; }
+    // bytes in the cache, the queries and the cache hits since the start
+    int64_t capacity() { return m_capacity.load(); }
+    uint64_t queryTimes() { return m_queryTimes.load(); }
+    uint64_t hitTimes() { return m_hitTimes.load(); }
+    // ms between two clears, the accesses moved into the mru list each clear are scaled with it
+    void setClearInterval(uint64_t clearInterval);
+    uint64_t clearInterval() const { return m_clearInterval; }
     void setMaxForwardBlock(size_t maxForwardBlock);
+    // bytes of the blocks waiting for the backend, 0 means only bounded by max forward block
+    void setMaxForwardBytes(int64_t maxForwardBytes);
+    // consecutive blocks merged into one backend commit
+    void setMaxMergeBlock(size_t maxMergeBlock);
+    // must be called before the storage is accessed, 0 means one shard per hardware thread
+    void setCacheShards(size_t cacheShards);
+    size_t cacheShards() const { return m_shards.size(); }
+    // must be called before the storage is accessed
+    void setCachePolicy(CachePolicy cachePolicy) { m_cachePolicy = cachePolicy; }
+    CachePolicy cachePolicy() const { return m_cachePolicy; }
+    // keys seen once enter the cache as the first to be evicted, must be called before the
+    // storage is accessed
+    void setCacheAdmission(bool admission);
+    bool cacheAdmission() const { return (bool)m_sketch; }
+    // bytes of the table kept in the cache, keys of a table over quota are evicted first
+    void setTableQuota(const std::string& table, int64_t quota);
+    TableStat::Ptr tableStat(const std::string& table);
+
+    // the most recently used keys, at most maxKeys, are saved to the file every interval ms and
+    // on stop, so that warmUp fetches them again after a restart, must be called before init
+    void setHotKeys(const std::string& path, size_t maxKeys, uint64_t interval = 60000);
+    // saved by the clear thread, callable once it is stopped
+    void saveHotKeys();
+    // fetch the saved hot keys from the backend into the cache before the node takes part in
+    // consensus, in parallel batches of at most keysPerSecond keys a second, 0 means unlimited,
+    // return the keys fetched
+    size_t warmUp(size_t keysPerSecond);
 
     size_t ID();
 
     void startClearThread();
 
+    // commit pipeline metrics
+    size_t pipelineDepth();
+    int64_t forwardBytes();
+    uint64_t lastMergedBlocks();
+    uint64_t lastMergedBytes();
+    // milliseconds of the last backend commit
+    uint64_t lastBackendLatency();
+
 private:
+    class MergeIterator;
+
+    CacheShard::Ptr getShard(const std::string& table, const std::string& key);
+
     void touchMRU(const std::string& table, const std::string& key, ssize_t capacity);
-    void updateMRU(const std::string& table, const std::string& key, ssize_t capacity);
+    void updateMRU(CacheShard::Ptr shard, const std::string& table, const std::string& key,
+        ssize_t capacity);
+    // a read only touch doesn't create the cache of a missing key, the cache is null then
     std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr, bool> touchCache(
         TableInfo::Ptr table, const std::string& key, bool write = false);
     void restoreCache(TableInfo::Ptr table, const std::string& key, Cache::Ptr cache);
@@ -137,39 +368,75 @@ private:
 
     bool disabled();
 
+    // read the id and the number of the latest block from the backend
+    void loadState();
+
+    friend class CachedSnapshot;
+    void releaseSnapshot(int64_t num);
+    // -1 if there is no snapshot, the caller must hold x_snapshots
+    int64_t oldestSnapshot();
+    // held by commit while it applies a block to the cache, sets the oldest pinned block
+    std::shared_ptr<void> applyBlock(int64_t& oldest);
+
+    size_t fillCaches(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys, std::vector<Entries::Ptr>* out);
+
     void commitBackend(Task::Ptr task);
+    void flushTasks();
+    Task::Ptr mergeTasks(const std::vector<Task::Ptr>& tasks);
+    std::set<std::string> forceKeys(Task::Ptr task);
 
     void checkAndClear();
-
-    void updateCapacity(ssize_t capacity);
+    // move the accesses queued since the last clear into the mru list, by the clear thread
+    size_t popMRU(CacheShard::Ptr shard);
+    // both return the caches evicted
+    size_t clearShard(CacheShard::Ptr shard, int64_t maxShardCapacity, int64_t oldestSnapshot);
+    size_t clearShardClock(
+        CacheShard::Ptr shard, int64_t maxShardCapacity, int64_t oldestSnapshot);
+    // flushed to the backend and not modified after any snapshot
+    bool evictable(Cache::Ptr cache, int64_t oldestSnapshot);
+    Cache::Ptr findCache(
+        CacheShard::Ptr shard, const std::string& table, const std::string& key);
+
+    void updateCapacity(CacheShard::Ptr shard, const std::string& table, ssize_t capacity);
+    bool overQuota(const std::string& table);
+    bool anyOverQuota();
+    size_t tableKeyHash(const std::string& table, const std::string& key);
+    // frequently accessed keys are admitted by the sketch
+    bool admit(const std::string& table, const std::string& key);
     std::string readableCapacity(size_t num);
 
-    tbb::concurrent_unordered_map<std::string, Cache::Ptr> m_caches;
-    RWMutex m_cachesMutex;
+    size_t cacheSize();
+    size_t mruSize();
+
+    std::vector<CacheShard::Ptr> m_shards;
 
     Mutex m_commitMutex;
+    // held by a backend commit and the sync number it sets
+    Mutex m_flushMutex;
 
-    std::shared_ptr<boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string> > > > > >
-        m_mru;
-    std::shared_ptr<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t> > >
-        m_mruQueue;
+    // blocks waiting for the flush thread, merged from the front
+    std::deque<Task::Ptr> m_tasks;
+    Mutex m_tasksMutex;
 
     // boost::multi_index
     Storage::Ptr m_backend;
+    BlockWAL::Ptr m_wal;
     uint64_t m_ID = 1;
 
     tbb::atomic<uint64_t> m_syncNum;
     tbb::atomic<uint64_t> m_commitNum;
     tbb::atomic<int64_t> m_capacity;
+    tbb::atomic<int64_t> m_forwardBytes;
 
     // config
     uint64_t m_maxForwardBlock = 10;
-    int64_t m_maxCapacity = 256 * 1024 * 1024;  // default 256MB for cache
-    uint64_t m_maxPopMRU = 100000;
-    uint64_t m_clearInterval = 1000;
+    int64_t m_maxForwardBytes = 256 * 1024 * 1024;  // default 256MB in flight
+    uint64_t m_maxMergeBlock = 5;
+    std::atomic<int64_t> m_maxCapacity = {256 * 1024 * 1024};  // default 256MB for cache
+    std::atomic<uint64_t> m_maxPopMRU = {100000};
+    std::atomic<uint64_t> m_clearInterval = {1000};
+    CachePolicy m_cachePolicy = CLOCK;
 
     dev::ThreadPool::Ptr m_taskThreadPool;
     std::shared_ptr<std::thread> m_clearThread;
@@ -177,7 +444,31 @@ private:
     tbb::atomic<uint64_t> m_hitTimes;
     tbb::atomic<uint64_t> m_queryTimes;
 
+    tbb::concurrent_unordered_map<std::string, TableStat::Ptr> m_tableStats;
+    // tables with a quota
+    std::vector<std::pair<std::string, TableStat::Ptr> > m_quotaTables;
+    FrequencySketch::Ptr m_sketch;
+
+    tbb::atomic<uint64_t> m_lastMergedBlocks;
+    tbb::atomic<uint64_t> m_lastMergedBytes;
+    tbb::atomic<uint64_t> m_lastBackendLatency;
+
     std::shared_ptr<tbb::atomic<bool> > m_running;
+
+    std::string m_hotKeysPath;
+    size_t m_maxHotKeys = 0;
+    uint64_t m_hotKeysInterval = 60000;
+    std::chrono::steady_clock::time_point m_hotKeysSaved;
+
+    // pinned block numbers of the live snapshots, snapshot() waits for the commits applying a
+    // block to the cache, so a snapshot is only pinned between two blocks
+    std::multiset<int64_t> m_snapshots;
+    std::mutex x_snapshots;
+    std::condition_variable m_snapshotsCV;
+    size_t m_applyingBlocks = 0;
+    size_t m_pinningSnapshots = 0;
+    // the latest block applied to the cache
+    tbb::atomic<int64_t> m_cachedNum;
 };
 
 }  // namespace storage
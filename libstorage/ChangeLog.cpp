@@ -0,0 +1,63 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file ChangeLog.cpp
+ *  @author ancelmo
+ *  @date 20190826
+ */
+
+#include "ChangeLog.h"
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+thread_local ChangeLog* t_changeLog = nullptr;
+}
+
+ChangeLog::Scope::Scope(ChangeLog& _changeLog) : m_previous(t_changeLog)
+{
+    t_changeLog = &_changeLog;
+}
+
+ChangeLog::Scope::~Scope()
+{
+    t_changeLog = m_previous;
+}
+
+ChangeLog* ChangeLog::current()
+{
+    return t_changeLog;
+}
+
+void ChangeLog::record(std::shared_ptr<Table> _table, Change::Kind _kind, std::string const& _key,
+    std::vector<Change::Record>& _records)
+{
+    m_changes.emplace_back(_table, _kind, _key, _records);
+}
+
+void ChangeLog::rollback(size_t _savepoint)
+{
+    while (_savepoint < m_changes.size())
+    {
+        // Public MemoryTable API cannot be used here because it will add another
+        // change log entry.
+        auto& change = m_changes.back();
+        change.table->rollback(change);
+        m_changes.pop_back();
+    }
+}
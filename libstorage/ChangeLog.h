@@ -0,0 +1,67 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file ChangeLog.h
+ *  @author ancelmo
+ *  @date 20190826
+ */
+#pragma once
+
+#include "Table.h"
+#include <deque>
+
+namespace dev
+{
+namespace storage
+{
+/// Undo log of one transaction. Savepoints are positions in the log and rolling back undoes
+/// the changes in reverse order. A log is owned by a single transaction, so it is never
+/// shared between threads and needs no locking.
+class ChangeLog
+{
+public:
+    /// Binds a log to the calling thread while a transaction executes. Scopes nest, a task
+    /// stolen by a waiting thread binds its own log and restores the previous one on exit.
+    class Scope
+    {
+    public:
+        Scope(ChangeLog& _changeLog);
+        ~Scope();
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ChangeLog* m_previous;
+    };
+
+    /// @return the log bound to the calling thread, nullptr if there is none
+    static ChangeLog* current();
+
+    void record(std::shared_ptr<Table> _table, Change::Kind _kind, std::string const& _key,
+        std::vector<Change::Record>& _records);
+    size_t savepoint() const { return m_changes.size(); }
+    void rollback(size_t _savepoint);
+    void clear() { m_changes.clear(); }
+    size_t size() const { return m_changes.size(); }
+
+private:
+    // deque allocates in chunks and never relocates the recorded changes when growing
+    std::deque<Change> m_changes;
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -19,6 +19,7 @@
  *  @date 20180921
  */
 #pragma once
+#include <libconfig/GlobalConfigure.h>
 #include <string>
 
 namespace dev
@@ -52,6 +53,9 @@ static const std::string SYS_CONFIG = "_sys_config_";
 static const std::string SYS_ACCESS_TABLE = "_sys_table_access_";
 static const std::string USER_TABLE_PREFIX = "_user_";
 static const std::string SYS_BLOCK_2_NONCES = "_sys_block_2_nonces_";
+/// the optional index of the logs by address, topic0 and block, and the blooms of the blocks
+static const std::string SYS_LOG_INDEX = "_sys_log_index_";
+static const std::string SYS_BLOCK_2_BLOOM = "_sys_block_2_bloom_";
 
 #if 0
 const char* const ID_FIELD = "_id_";
@@ -80,6 +84,7 @@ const int CODE_TABLE_NAME_ALREADY_EXIST = -50001;
 const int CODE_TABLE_NAME_LENGTH_OVERFLOW = -50002;
 const int CODE_TABLE_FILED_LENGTH_OVERFLOW = -50003;
 const int CODE_TABLE_FILED_TOTALLENGTH_OVERFLOW = -50004;
+const int CODE_TABLE_INDEX_FIELD_NOT_EXIST = -50005;
 
 
 inline bool isHashField(const std::string& _key)
@@ -91,5 +96,14 @@ inline bool isHashField(const std::string& _key)
     return false;
 }
 
+/// the value of the block tables holds raw bytes on the chains of 2.3.0 on, the backends that
+/// can't store them as is encode it in hex
+inline bool isBinaryField(const std::string& _table, const std::string& _field)
+{
+    return g_BCOSConfig.version() >= V2_3_0 && _field == SYS_VALUE &&
+           (_table == SYS_HASH_2_BLOCK || _table == SYS_BLOCK_2_NONCES ||
+               _table == SYS_BLOCK_2_BLOOM || _table == SYS_LOG_INDEX);
+}
+
 }  // namespace storage
 }  // namespace dev
@@ -42,16 +42,16 @@ const char* const CONDITION_METHOD_LIMIT_2INT = "limit(int256,int256)";
 
 ConditionPrecompiled::ConditionPrecompiled()
 {
-    name2Selector[CONDITION_METHOD_EQ_STR_INT] = getFuncSelector(CONDITION_METHOD_EQ_STR_INT);
-    name2Selector[CONDITION_METHOD_EQ_STR_STR] = getFuncSelector(CONDITION_METHOD_EQ_STR_STR);
-    name2Selector[CONDITION_METHOD_GE_STR_INT] = getFuncSelector(CONDITION_METHOD_GE_STR_INT);
-    name2Selector[CONDITION_METHOD_GT_STR_INT] = getFuncSelector(CONDITION_METHOD_GT_STR_INT);
-    name2Selector[CONDITION_METHOD_LE_STR_INT] = getFuncSelector(CONDITION_METHOD_LE_STR_INT);
-    name2Selector[CONDITION_METHOD_LT_STR_INT] = getFuncSelector(CONDITION_METHOD_LT_STR_INT);
-    name2Selector[CONDITION_METHOD_NE_STR_INT] = getFuncSelector(CONDITION_METHOD_NE_STR_INT);
-    name2Selector[CONDITION_METHOD_NE_STR_STR] = getFuncSelector(CONDITION_METHOD_NE_STR_STR);
-    name2Selector[CONDITION_METHOD_LIMIT_INT] = getFuncSelector(CONDITION_METHOD_LIMIT_INT);
-    name2Selector[CONDITION_METHOD_LIMIT_2INT] = getFuncSelector(CONDITION_METHOD_LIMIT_2INT);
+    registerMethod(CONDITION_METHOD_EQ_STR_INT, &ConditionPrecompiled::eqIntCall);
+    registerMethod(CONDITION_METHOD_EQ_STR_STR, &ConditionPrecompiled::eqStringCall);
+    registerMethod(CONDITION_METHOD_GE_STR_INT, &ConditionPrecompiled::geCall);
+    registerMethod(CONDITION_METHOD_GT_STR_INT, &ConditionPrecompiled::gtCall);
+    registerMethod(CONDITION_METHOD_LE_STR_INT, &ConditionPrecompiled::leCall);
+    registerMethod(CONDITION_METHOD_LT_STR_INT, &ConditionPrecompiled::ltCall);
+    registerMethod(CONDITION_METHOD_NE_STR_INT, &ConditionPrecompiled::neIntCall);
+    registerMethod(CONDITION_METHOD_NE_STR_STR, &ConditionPrecompiled::neStringCall);
+    registerMethod(CONDITION_METHOD_LIMIT_INT, &ConditionPrecompiled::limitCall);
+    registerMethod(CONDITION_METHOD_LIMIT_2INT, &ConditionPrecompiled::limitRangeCall);
 }
 
 std::string ConditionPrecompiled::toString()
@@ -59,106 +59,135 @@ std::string ConditionPrecompiled::toString()
     return "Condition";
 }
 
-bytes ConditionPrecompiled::call(ExecutiveContext::Ptr, bytesConstRef param, Address const&)
+bytes ConditionPrecompiled::call(
+    ExecutiveContext::Ptr context, bytesConstRef param, Address const& origin)
 {
     STORAGE_LOG(DEBUG) << "call Condition:" << toHex(param);
 
-    // parse function name
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    // ensured by the logic of code
+    assert(m_condition);
 
-    STORAGE_LOG(DEBUG) << "func:" << std::hex << func;
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("ConditionPrecompiled")
+                           << LOG_DESC("call undefined function")
+                           << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void ConditionPrecompiled::eqIntCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // EQ(string,int256)
     dev::eth::ContractABI abi;
+    std::string str;
+    s256 num;
+    abi.abiOut(data, str, num);
 
-    bytes out;
+    m_condition->EQ(str, boost::lexical_cast<std::string>(num));
+}
 
-    // ensured by the logic of code
-    assert(m_condition);
-    if (func == name2Selector[CONDITION_METHOD_EQ_STR_INT])
-    {
-        // EQ(string,int256)
-        std::string str;
-        s256 num;
-        abi.abiOut(data, str, num);
+void ConditionPrecompiled::eqStringCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // EQ(string,string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    std::string value;
+    abi.abiOut(data, str, value);
 
-        m_condition->EQ(str, boost::lexical_cast<std::string>(num));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_EQ_STR_STR])
-    {  // EQ(string,string)
-        std::string str;
-        std::string value;
-        abi.abiOut(data, str, value);
+    m_condition->EQ(str, value);
+}
 
-        m_condition->EQ(str, value);
-    }
-    else if (func == name2Selector[CONDITION_METHOD_GE_STR_INT])
-    {  // GE(string,int256)
-        std::string str;
-        s256 value;
-        abi.abiOut(data, str, value);
+void ConditionPrecompiled::geCall(ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // GE(string,int256)
+    dev::eth::ContractABI abi;
+    std::string str;
+    s256 value;
+    abi.abiOut(data, str, value);
 
-        m_condition->GE(str, boost::lexical_cast<std::string>(value));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_GT_STR_INT])
-    {  // GT(string,int256)
-        std::string str;
-        s256 value;
-        abi.abiOut(data, str, value);
+    m_condition->GE(str, boost::lexical_cast<std::string>(value));
+}
 
-        m_condition->GT(str, boost::lexical_cast<std::string>(value));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_LE_STR_INT])
-    {  // LE(string,int256)
-        std::string str;
-        s256 value;
-        abi.abiOut(data, str, value);
+void ConditionPrecompiled::gtCall(ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // GT(string,int256)
+    dev::eth::ContractABI abi;
+    std::string str;
+    s256 value;
+    abi.abiOut(data, str, value);
 
-        m_condition->LE(str, boost::lexical_cast<std::string>(value));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_LT_STR_INT])
-    {  // LT(string,int256)
-        std::string str;
-        s256 value;
-        abi.abiOut(data, str, value);
+    m_condition->GT(str, boost::lexical_cast<std::string>(value));
+}
 
-        m_condition->LT(str, boost::lexical_cast<std::string>(value));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_NE_STR_INT])
-    {  // NE(string,int256)
-        std::string str;
-        s256 num;
-        abi.abiOut(data, str, num);
+void ConditionPrecompiled::leCall(ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // LE(string,int256)
+    dev::eth::ContractABI abi;
+    std::string str;
+    s256 value;
+    abi.abiOut(data, str, value);
 
-        m_condition->NE(str, boost::lexical_cast<std::string>(num));
-    }
-    else if (func == name2Selector[CONDITION_METHOD_NE_STR_STR])
-    {  // NE(string,string)
-        std::string str;
-        std::string value;
-        abi.abiOut(data, str, value);
+    m_condition->LE(str, boost::lexical_cast<std::string>(value));
+}
 
-        m_condition->NE(str, value);
-    }
-    else if (func == name2Selector[CONDITION_METHOD_LIMIT_INT])
-    {  // limit(int256)
-        s256 num;
-        abi.abiOut(data, num);
+void ConditionPrecompiled::ltCall(ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // LT(string,int256)
+    dev::eth::ContractABI abi;
+    std::string str;
+    s256 value;
+    abi.abiOut(data, str, value);
 
-        m_condition->limit(num.convert_to<size_t>());
-    }
-    else if (func == name2Selector[CONDITION_METHOD_LIMIT_2INT])
-    {  // limit(int256,int256)
-        s256 offset;
-        s256 size;
-        abi.abiOut(data, offset, size);
+    m_condition->LT(str, boost::lexical_cast<std::string>(value));
+}
 
-        m_condition->limit(offset.convert_to<size_t>(), size.convert_to<size_t>());
-    }
-    else
-    {
-        STORAGE_LOG(ERROR) << LOG_BADGE("ConditionPrecompiled")
-                           << LOG_DESC("call undefined function!");
-    }
-    return out;
+void ConditionPrecompiled::neIntCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // NE(string,int256)
+    dev::eth::ContractABI abi;
+    std::string str;
+    s256 num;
+    abi.abiOut(data, str, num);
+
+    m_condition->NE(str, boost::lexical_cast<std::string>(num));
+}
+
+void ConditionPrecompiled::neStringCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // NE(string,string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    std::string value;
+    abi.abiOut(data, str, value);
+
+    m_condition->NE(str, value);
+}
+
+void ConditionPrecompiled::limitCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // limit(int256)
+    dev::eth::ContractABI abi;
+    s256 num;
+    abi.abiOut(data, num);
+
+    m_condition->limit(num.convert_to<size_t>());
+}
+
+void ConditionPrecompiled::limitRangeCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const&, bytes&)
+{
+    // limit(int256,int256)
+    dev::eth::ContractABI abi;
+    s256 offset;
+    s256 size;
+    abi.abiOut(data, offset, size);
+
+    m_condition->limit(offset.convert_to<size_t>(), size.convert_to<size_t>());
 }
\ No newline at end of file
@@ -78,6 +78,26 @@ public:
     dev::storage::Condition::Ptr getCondition() { return m_condition; }
 
 private:
+    void eqIntCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void eqStringCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void geCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void gtCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void leCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void ltCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void neIntCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void neStringCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void limitCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void limitRangeCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
     ExecutiveContext::Ptr m_exeEngine;
     // condition must been setted
     dev::storage::Condition::Ptr m_condition;
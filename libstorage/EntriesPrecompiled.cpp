@@ -32,8 +32,8 @@ const char* const ENTRIES_SIZE = "size()";
 
 EntriesPrecompiled::EntriesPrecompiled()
 {
-    name2Selector[ENTRIES_GET_INT] = getFuncSelector(ENTRIES_GET_INT);
-    name2Selector[ENTRIES_SIZE] = getFuncSelector(ENTRIES_SIZE);
+    registerMethod(ENTRIES_GET_INT, &EntriesPrecompiled::getCall);
+    registerMethod(ENTRIES_SIZE, &EntriesPrecompiled::sizeCall);
 }
 
 std::string dev::blockverifier::EntriesPrecompiled::toString()
@@ -42,39 +42,40 @@ std::string dev::blockverifier::EntriesPrecompiled::toString()
 }
 
 bytes dev::blockverifier::EntriesPrecompiled::call(
-    ExecutiveContext::Ptr context, bytesConstRef param, Address const&)
+    ExecutiveContext::Ptr context, bytesConstRef param, Address const& origin)
 {
     STORAGE_LOG(TRACE) << LOG_BADGE("EntriesPrecompiled") << LOG_DESC("call")
                        << LOG_KV("param", toHex(param));
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("EntriesPrecompiled") << LOG_DESC("call undefined function")
+                           << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void EntriesPrecompiled::getCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // get(int256)
     dev::eth::ContractABI abi;
+    u256 num;
+    abi.abiOut(data, num);
 
-    bytes out;
-
-    if (func == name2Selector[ENTRIES_GET_INT])
-    {  // get(int256)
-        u256 num;
-        abi.abiOut(data, num);
+    Entry::Ptr entry = getEntries()->get(num.convert_to<size_t>());
+    EntryPrecompiled::Ptr entryPrecompiled = std::make_shared<EntryPrecompiled>();
+    entryPrecompiled->setEntry(entry);
+    Address address = context->registerPrecompiled(entryPrecompiled);
 
-        Entry::Ptr entry = getEntries()->get(num.convert_to<size_t>());
-        EntryPrecompiled::Ptr entryPrecompiled = std::make_shared<EntryPrecompiled>();
-        entryPrecompiled->setEntry(entry);
-        Address address = context->registerPrecompiled(entryPrecompiled);
+    out = abi.abiIn("", address);
+}
 
-        out = abi.abiIn("", address);
-    }
-    else if (func == name2Selector[ENTRIES_SIZE])
-    {  // size()
-        u256 c = getEntries()->size();
+void EntriesPrecompiled::sizeCall(ExecutiveContext::Ptr, bytesConstRef, Address const&, bytes& out)
+{
+    // size()
+    dev::eth::ContractABI abi;
+    u256 c = getEntries()->size();
 
-        out = abi.abiIn("", c);
-    }
-    else
-    {
-        STORAGE_LOG(ERROR) << LOG_BADGE("EntriesPrecompiled")
-                           << LOG_DESC("call undefined function!");
-    }
-    return out;
+    out = abi.abiIn("", c);
 }
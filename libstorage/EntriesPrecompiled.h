@@ -58,6 +58,10 @@ public:
     dev::storage::Entries::ConstPtr getEntries() const { return m_entriesConst; }
 
 private:
+    void getCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
+    void sizeCall(ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin,
+        bytes& out);
     dev::storage::Entries::ConstPtr m_entriesConst;
 };
 
@@ -62,16 +62,16 @@ std::string setInt(bytesConstRef _data, std::string& _key, bool _isUint = false)
 
 EntryPrecompiled::EntryPrecompiled()
 {
-    name2Selector[ENTRY_GET_INT] = getFuncSelector(ENTRY_GET_INT);
-    name2Selector[ENTRY_GET_UINT] = getFuncSelector(ENTRY_GET_UINT);
-    name2Selector[ENTRY_SET_STR_INT] = getFuncSelector(ENTRY_SET_STR_INT);
-    name2Selector[ENTRY_SET_STR_UINT] = getFuncSelector(ENTRY_SET_STR_UINT);
-    name2Selector[ENTRY_SET_STR_STR] = getFuncSelector(ENTRY_SET_STR_STR);
-    name2Selector[ENTRY_SET_STR_ADDR] = getFuncSelector(ENTRY_SET_STR_ADDR);
-    name2Selector[ENTRY_GETA_STR] = getFuncSelector(ENTRY_GETA_STR);
-    name2Selector[ENTRY_GETB_STR] = getFuncSelector(ENTRY_GETB_STR);
-    name2Selector[ENTRY_GETB_STR32] = getFuncSelector(ENTRY_GETB_STR32);
-    name2Selector[ENTRY_GET_STR] = getFuncSelector(ENTRY_GET_STR);
+    registerMethod(ENTRY_GET_INT, &EntryPrecompiled::getIntCall);
+    registerMethod(ENTRY_GET_UINT, &EntryPrecompiled::getUIntCall);
+    registerMethod(ENTRY_SET_STR_INT, &EntryPrecompiled::setIntCall);
+    registerMethod(ENTRY_SET_STR_UINT, &EntryPrecompiled::setUIntCall);
+    registerMethod(ENTRY_SET_STR_STR, &EntryPrecompiled::setStringCall);
+    registerMethod(ENTRY_SET_STR_ADDR, &EntryPrecompiled::setAddressCall);
+    registerMethod(ENTRY_GETA_STR, &EntryPrecompiled::getAddressCall);
+    registerMethod(ENTRY_GETB_STR, &EntryPrecompiled::getBytes64Call);
+    registerMethod(ENTRY_GETB_STR32, &EntryPrecompiled::getBytes32Call);
+    registerMethod(ENTRY_GET_STR, &EntryPrecompiled::getStringCall);
 }
 
 std::string EntryPrecompiled::toString()
@@ -79,107 +79,141 @@ std::string EntryPrecompiled::toString()
     return "Entry";
 }
 
-bytes EntryPrecompiled::call(std::shared_ptr<ExecutiveContext>, bytesConstRef param, Address const&)
+bytes EntryPrecompiled::call(
+    std::shared_ptr<ExecutiveContext> context, bytesConstRef param, Address const& origin)
 {
     STORAGE_LOG(TRACE) << LOG_BADGE("EntryPrecompiled") << LOG_DESC("call")
                        << LOG_KV("param", toHex(param));
 
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("EntryPrecompiled") << LOG_DESC("call undefined function")
+                           << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void EntryPrecompiled::getIntCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getInt(string)
     dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
+    s256 num = boost::lexical_cast<s256>(m_entry->getField(str));
+    out = abi.abiIn("", num);
+}
 
-    bytes out;
+void EntryPrecompiled::getUIntCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getUInt(string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
+    u256 num = boost::lexical_cast<u256>(m_entry->getField(str));
+    out = abi.abiIn("", num);
+}
 
-    if (func == name2Selector[ENTRY_GET_INT])
-    {  // getInt(string)
-        std::string str;
-        abi.abiOut(data, str);
-        s256 num = boost::lexical_cast<s256>(m_entry->getField(str));
-        out = abi.abiIn("", num);
-    }
-    else if (func == name2Selector[ENTRY_GET_UINT])
-    {  // getUInt(string)
-        std::string str;
-        abi.abiOut(data, str);
-        u256 num = boost::lexical_cast<u256>(m_entry->getField(str));
-        out = abi.abiIn("", num);
-    }
-    else if (func == name2Selector[ENTRY_SET_STR_INT])
-    {  // set(string,int256)
-        std::string key;
-        std::string value(setInt(data, key));
-        m_entry->setField(key, value);
-    }
-    else if (func == name2Selector[ENTRY_SET_STR_UINT])
-    {  // set(string,uint256)
-        std::string key;
-        std::string value(setInt(data, key, true));
-        m_entry->setField(key, value);
-    }
-    else if (func == name2Selector[ENTRY_SET_STR_STR])
-    {  // set(string,string)
-        std::string str;
-        std::string value;
-        abi.abiOut(data, str, value);
+void EntryPrecompiled::setIntCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes&)
+{
+    // set(string,int256)
+    std::string key;
+    std::string value(setInt(data, key));
+    m_entry->setField(key, value);
+}
 
-        m_entry->setField(str, value);
-    }
-    else if (func == name2Selector[ENTRY_SET_STR_ADDR])
-    {  // set(string,address)
-        std::string str;
-        Address value;
-        abi.abiOut(data, str, value);
+void EntryPrecompiled::setUIntCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes&)
+{
+    // set(string,uint256)
+    std::string key;
+    std::string value(setInt(data, key, true));
+    m_entry->setField(key, value);
+}
 
-        m_entry->setField(str, toHex(value));
-    }
-    else if (func == name2Selector[ENTRY_GETA_STR])
-    {  // getAddress(string)
-        std::string str;
-        abi.abiOut(data, str);
-
-        std::string value = m_entry->getField(str);
-        Address ret = Address(value);
-        out = abi.abiIn("", ret);
-    }
-    else if (func == name2Selector[ENTRY_GETB_STR])
-    {  // getBytes64(string)
-        std::string str;
-        abi.abiOut(data, str);
+void EntryPrecompiled::setStringCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes&)
+{
+    // set(string,string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    std::string value;
+    abi.abiOut(data, str, value);
+
+    m_entry->setField(str, value);
+}
+
+void EntryPrecompiled::setAddressCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes&)
+{
+    // set(string,address)
+    dev::eth::ContractABI abi;
+    std::string str;
+    Address value;
+    abi.abiOut(data, str, value);
 
-        std::string value = m_entry->getField(str);
+    m_entry->setField(str, toHex(value));
+}
 
-        string32 ret0;
-        string32 ret1;
+void EntryPrecompiled::getAddressCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getAddress(string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
 
-        for (unsigned i = 0; i < 32; ++i)
-            ret0[i] = (i < value.size() ? value[i] : 0);
+    std::string value = m_entry->getField(str);
+    Address ret = Address(value);
+    out = abi.abiIn("", ret);
+}
 
-        for (unsigned i = 32; i < 64; ++i)
-            ret1[i - 32] = (i < value.size() ? value[i] : 0);
+void EntryPrecompiled::getBytes64Call(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getBytes64(string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
 
-        out = abi.abiIn("", ret0, ret1);
-    }
-    else if (func == name2Selector[ENTRY_GETB_STR32])
-    {  // getBytes32(string)
-        std::string str;
-        abi.abiOut(data, str);
-
-        std::string value = m_entry->getField(str);
-        dev::string32 s32 = dev::eth::toString32(value);
-        out = abi.abiIn("", s32);
-    }
-    else if (func == name2Selector[ENTRY_GET_STR])
-    {  // getString(string)
-        std::string str;
-        abi.abiOut(data, str);
+    std::string value = m_entry->getField(str);
 
-        std::string value = m_entry->getField(str);
-        out = abi.abiIn("", value);
-    }
-    else
-    {
-        STORAGE_LOG(ERROR) << LOG_BADGE("EntryPrecompiled") << LOG_DESC("call undefined function!");
-    }
-    return out;
+    string32 ret0;
+    string32 ret1;
+
+    for (unsigned i = 0; i < 32; ++i)
+        ret0[i] = (i < value.size() ? value[i] : 0);
+
+    for (unsigned i = 32; i < 64; ++i)
+        ret1[i - 32] = (i < value.size() ? value[i] : 0);
+
+    out = abi.abiIn("", ret0, ret1);
+}
+
+void EntryPrecompiled::getBytes32Call(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getBytes32(string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
+
+    std::string value = m_entry->getField(str);
+    dev::string32 s32 = dev::eth::toString32(value);
+    out = abi.abiIn("", s32);
+}
+
+void EntryPrecompiled::getStringCall(
+    std::shared_ptr<ExecutiveContext>, bytesConstRef data, Address const&, bytes& out)
+{
+    // getString(string)
+    dev::eth::ContractABI abi;
+    std::string str;
+    abi.abiOut(data, str);
+
+    std::string value = m_entry->getField(str);
+    out = abi.abiIn("", value);
 }
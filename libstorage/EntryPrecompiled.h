@@ -67,6 +67,26 @@ public:
     dev::storage::Entry::Ptr getEntry() const { return m_entry; };
 
 private:
+    void getIntCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void getUIntCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void setIntCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void setUIntCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void setStringCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void setAddressCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void getAddressCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void getBytes64Call(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void getBytes32Call(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void getStringCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
     dev::storage::Entry::Ptr m_entry;
 };
 
@@ -71,7 +71,16 @@ Entries::Ptr LevelDBStorage::select(
 
                 for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
                 {
-                    entry->setField(valueIt.key().asString(), valueIt->asString());
+                    auto field = valueIt.key().asString();
+                    if (isBinaryField(tableInfo->name, field))
+                    {
+                        auto data = fromHex(valueIt->asString());
+                        entry->setField(field, std::string(data.begin(), data.end()));
+                    }
+                    else
+                    {
+                        entry->setField(field, valueIt->asString());
+                    }
                 }
                 entry->setStatus(entry->getField(STATUS));
                 if (entry->getStatus() == Entry::Status::NORMAL)
@@ -123,7 +132,10 @@ size_t LevelDBStorage::commitTableDataRange(std::shared_ptr<dev::db::LevelDBWrit
             Json::Value value;
             for (auto& fieldIt : *(dataIt->second->get(i)))
             {
-                value[fieldIt.first] = fieldIt.second;
+                /// json holds text only
+                value[fieldIt.first] = isBinaryField(tableData->tableName, fieldIt.first) ?
+                                           toHex(fieldIt.second) :
+                                           fieldIt.second;
             }
             value["_hash_"] = hash.hex();
             value[NUM_FIELD] = num;
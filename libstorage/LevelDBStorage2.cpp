@@ -20,12 +20,8 @@
  */
 
 #include "LevelDBStorage2.h"
+#include "RowCodec.h"
 #include "Table.h"
-#include "boost/archive/binary_iarchive.hpp"
-#include "boost/archive/binary_oarchive.hpp"
-#include "boost/serialization/map.hpp"
-#include "boost/serialization/serialization.hpp"
-#include "boost/serialization/vector.hpp"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 #include <libdevcore/BasicLevelDB.h>
@@ -34,6 +30,7 @@
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
+#include <algorithm>
 #include <memory>
 #include <thread>
 
@@ -60,42 +57,90 @@ Entries::Ptr LevelDBStorage2::select(
             BOOST_THROW_EXCEPTION(StorageException(-1, "Query leveldb exception:" + s.ToString()));
         }
 
-        Entries::Ptr entries = std::make_shared<Entries>();
-        if (!s.IsNotFound())
+        if (s.IsNotFound())
         {
-            std::vector<std::map<std::string, std::string>> res;
-            stringstream ss(value);
-            boost::archive::binary_iarchive ia(ss);
-            ia >> res;
+            return std::make_shared<Entries>();
+        }
+
+        return decodeEntries(value.data(), value.size(), condition);
+    }
+    catch (std::exception& e)
+    {
+        STORAGE_LEVELDB_LOG(ERROR) << LOG_DESC("Query leveldb exception")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
+        BOOST_THROW_EXCEPTION(e);
+    }
 
-            for (auto it = res.begin(); it != res.end(); ++it)
+    return Entries::Ptr();
+}
+
+std::vector<Entries::Ptr> LevelDBStorage2::batchSelect(
+    h256, int64_t, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    try
+    {
+        // seek the keys in order with one iterator, the iterator only moves forward
+        std::vector<std::pair<std::string, size_t>> entryKeys;
+        entryKeys.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            entryKeys.push_back(std::make_pair(tableInfo->name + "_" + keys[i], i));
+        }
+        std::sort(entryKeys.begin(), entryKeys.end());
+
+        std::vector<Entries::Ptr> result(keys.size());
+        std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(ReadOptions()));
+        for (auto& entryKey : entryKeys)
+        {
+            it->Seek(Slice(entryKey.first));
+            if (it->Valid() && it->key() == Slice(entryKey.first))
             {
-                Entry::Ptr entry = std::make_shared<Entry>();
-
-                for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
-                {
-                    entry->setField(valueIt->first, valueIt->second);
-                }
-                entry->setID(it->at(ID_FIELD));
-                entry->setNum(it->at(NUM_FIELD));
-                if (entry->getStatus() == Entry::Status::NORMAL && condition->process(entry))
-                {
-                    entry->setDirty(false);
-                    entries->addEntry(entry);
-                }
+                result[entryKey.second] =
+                    decodeEntries(it->value().data(), it->value().size(), Condition::Ptr());
             }
+            else
+            {
+                result[entryKey.second] = std::make_shared<Entries>();
+            }
+        }
+
+        if (!it->status().ok())
+        {
+            STORAGE_LEVELDB_LOG(ERROR) << LOG_DESC("Batch query leveldb failed")
+                                       << LOG_KV("status", it->status().ToString());
+
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "Query leveldb exception:" + it->status().ToString()));
         }
 
-        return entries;
+        return result;
     }
     catch (std::exception& e)
     {
-        STORAGE_LEVELDB_LOG(ERROR) << LOG_DESC("Query leveldb exception")
+        STORAGE_LEVELDB_LOG(ERROR) << LOG_DESC("Batch query leveldb exception")
                                    << LOG_KV("msg", boost::diagnostic_information(e));
         BOOST_THROW_EXCEPTION(e);
     }
 
-    return Entries::Ptr();
+    return std::vector<Entries::Ptr>();
+}
+
+Entries::Ptr LevelDBStorage2::decodeEntries(
+    const char* data, size_t size, Condition::Ptr condition)
+{
+    Entries::Ptr entries = std::make_shared<Entries>();
+
+    for (auto& entry : RowCodec::decodeEntries(data, size))
+    {
+        if (entry->getStatus() == Entry::Status::NORMAL &&
+            (!condition || condition->process(entry)))
+        {
+            entry->setDirty(false);
+            entries->addEntry(entry);
+        }
+    }
+
+    return entries;
 }
 
 size_t LevelDBStorage2::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
@@ -118,10 +163,7 @@ size_t LevelDBStorage2::commit(h256 hash, int64_t num, const std::vector<TableDa
             for (auto it : *key2value)
             {
                 std::string entryKey = tableInfo->name + "_" + it.first;
-                stringstream ss;
-                boost::archive::binary_oarchive oa(ss);
-                oa << it.second;
-                batch->insertSlice(Slice(entryKey), Slice(ss.str()));
+                batch->insertSlice(Slice(entryKey), Slice(RowCodec::encode(it.second)));
             }
         }
 
@@ -141,6 +183,117 @@ size_t LevelDBStorage2::commit(h256 hash, int64_t num, const std::vector<TableDa
     return 0;
 }
 
+namespace
+{
+/// move the iterator past the keys of the other tables under the prefix of a table
+void skipExtending(leveldb::Iterator* it, const std::vector<std::string>& others)
+{
+    while (it->Valid())
+    {
+        auto key = it->key();
+        auto other = std::find_if(others.begin(), others.end(),
+            [&](const std::string& prefix) { return key.starts_with(Slice(prefix)); });
+        if (other == others.end())
+        {
+            return;
+        }
+        // '`' follows '_', the keys of the other table are all before <other>`
+        it->Seek(Slice(other->substr(0, other->size() - 1) + "`"));
+    }
+}
+}  // namespace
+
+class LevelDBStorage2::ScanIterator : public StorageIterator
+{
+public:
+    ScanIterator(LevelDBStorage2::Ptr storage, TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize)
+      : m_storage(storage),
+        m_prefix(tableInfo->name + "_"),
+        m_end(end),
+        m_batchSize(std::max(batchSize, (size_t)1))
+    {
+        ReadOptions options;
+        options.fill_cache = false;
+        m_it.reset(m_storage->m_db->NewIterator(options));
+        // listed once the view of the iterator is taken, a table created later has no rows in it
+        m_others = m_storage->extendingPrefixes(tableInfo->name);
+        m_it->Seek(Slice(m_prefix + begin));
+        skipExtending(m_it.get(), m_others);
+    }
+
+    bool next(Batch& batch) override
+    {
+        batch.clear();
+        for (; m_it->Valid() && batch.size() < m_batchSize;
+             m_it->Next(), skipExtending(m_it.get(), m_others))
+        {
+            auto entryKey = m_it->key();
+            if (!entryKey.starts_with(Slice(m_prefix)))
+            {
+                break;
+            }
+
+            std::string key(entryKey.data() + m_prefix.size(), entryKey.size() - m_prefix.size());
+            if (!m_end.empty() && key >= m_end)
+            {
+                break;
+            }
+
+            auto entries = m_storage->decodeEntries(
+                m_it->value().data(), m_it->value().size(), Condition::Ptr());
+            if (entries->size() > 0)
+            {
+                batch.emplace_back(std::move(key), entries);
+            }
+        }
+
+        if (!m_it->status().ok())
+        {
+            STORAGE_LEVELDB_LOG(ERROR) << LOG_DESC("Scan leveldb failed")
+                                       << LOG_KV("status", m_it->status().ToString());
+
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "Scan leveldb exception:" + m_it->status().ToString()));
+        }
+
+        return !batch.empty();
+    }
+
+private:
+    // the iterator must be released before the db
+    LevelDBStorage2::Ptr m_storage;
+    std::unique_ptr<leveldb::Iterator> m_it;
+    std::string m_prefix;
+    std::vector<std::string> m_others;
+    std::string m_end;
+    size_t m_batchSize;
+};
+
+std::vector<std::string> LevelDBStorage2::extendingPrefixes(const std::string& tableName)
+{
+    // the tables are listed in _sys_tables_ by their names, those named <tableName>_<suffix>
+    // keep their keys under the prefix of the table
+    std::string tables = SYS_TABLES + "_" + tableName + "_";
+    ReadOptions options;
+    options.fill_cache = false;
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(options));
+    std::vector<std::string> prefixes;
+    for (it->Seek(Slice(tables)); it->Valid() && it->key().starts_with(Slice(tables)); it->Next())
+    {
+        prefixes.push_back(it->key().ToString().substr(SYS_TABLES.size() + 1) + "_");
+    }
+    return prefixes;
+}
+
+StorageIterator::Ptr LevelDBStorage2::scan(
+    TableInfo::Ptr tableInfo, const std::string& begin, const std::string& end, size_t batchSize)
+{
+    return std::make_shared<ScanIterator>(
+        std::static_pointer_cast<LevelDBStorage2>(shared_from_this()), tableInfo, begin, end,
+        batchSize);
+}
+
 bool LevelDBStorage2::onlyDirty()
 {
     return false;
@@ -184,11 +337,7 @@ void LevelDBStorage2::processNewEntries(h256, int64_t num,
             }
             else
             {
-                std::vector<std::map<std::string, std::string>> res;
-                stringstream ss(value);
-                boost::archive::binary_iarchive ia(ss);
-                ia >> res;
-                it = key2value->emplace(key, res).first;
+                it = key2value->emplace(key, RowCodec::decodeRows(value)).first;
             }
         }
 
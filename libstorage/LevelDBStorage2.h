@@ -41,12 +41,27 @@ public:
 
     Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
     size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    // iterates a consistent view of the db taken when called, the keys of the tables named
+    // <table>_<suffix> share the prefix of the table and are skipped, as are the keys of the
+    // table itself that start with <suffix>_
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
     bool onlyDirty() override;
 
     void setDB(std::shared_ptr<dev::db::BasicLevelDB> db);
 
 private:
+    class ScanIterator;
+
+    /// the key prefixes of the tables in _sys_tables_ named <tableName>_<suffix>
+    std::vector<std::string> extendingPrefixes(const std::string& tableName);
+
+    /// decoded from the buffers of the db without copying the values first
+    Entries::Ptr decodeEntries(const char* data, size_t size, Condition::Ptr condition);
+
     void processNewEntries(h256 hash, int64_t num,
         std::shared_ptr<std::map<std::string, std::vector<std::map<std::string, std::string>>>>
             key2value,
@@ -81,7 +81,7 @@ public:
     }
 
     virtual int update(const std::string& key, Entry::Ptr entry, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) override
     {
         try
         {
@@ -130,7 +130,7 @@ public:
     }
 
     virtual int insert(const std::string& key, Entry::Ptr entry,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>(),
+        AccessOptions::Ptr options = AccessOptions::defaultOptions(),
         bool needSelect = true) override
     {
         try
@@ -179,7 +179,7 @@ public:
     }
 
     virtual int remove(const std::string& key, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) override
     {
         if (options->check && !checkAuthority(options->origin))
         {
@@ -19,6 +19,7 @@
  *  @date 20180921
  */
 #include "MemoryTable2.h"
+#include "AccessSet.h"
 #include "Common.h"
 #include "Table.h"
 #include <arpa/inet.h>
@@ -40,9 +41,28 @@ using namespace dev::precompiled;
 
 Entries::ConstPtr MemoryTable2::select(const std::string& key, Condition::Ptr condition)
 {
+    recordAccess(key, false);
     return selectNoLock(key, condition);
 }
 
+void MemoryTable2::recordAccess(const std::string& key, bool write)
+{
+    auto accessSet = AccessSet::current();
+    if (!accessSet)
+    {
+        return;
+    }
+
+    if (write)
+    {
+        accessSet->write(m_tableInfo->name, key);
+    }
+    else
+    {
+        accessSet->read(m_tableInfo->name, key);
+    }
+}
+
 void MemoryTable2::proccessLimit(
     const Condition::Ptr& condition, const Entries::Ptr& entries, const Entries::Ptr& resultEntries)
 {
@@ -63,52 +83,66 @@ void MemoryTable2::proccessLimit(
     }
 }
 
-Entries::Ptr MemoryTable2::selectNoLock(const std::string& key, Condition::Ptr condition)
+std::vector<Entries::ConstPtr> MemoryTable2::batchSelect(const std::vector<std::string>& keys)
 {
+    std::vector<Entries::ConstPtr> result;
+    result.reserve(keys.size());
     try
     {
-        auto entries = std::make_shared<Entries>();
-        condition->EQ(m_tableInfo->key, key);
+        for (auto& key : keys)
+        {
+            recordAccess(key, false);
+        }
+        std::vector<Entries::Ptr> dbEntries(keys.size());
         if (m_remoteDB)
         {
-            // query remoteDB anyway
-            Entries::Ptr dbEntries =
-                m_remoteDB->select(m_blockHash, m_blockNum, m_tableInfo, key, condition);
-            if (!dbEntries)
-            {
-                return entries;
-            }
-            for (size_t i = 0; i < dbEntries->size(); ++i)
+            dbEntries = m_remoteDB->batchSelect(m_blockHash, m_blockNum, m_tableInfo, keys);
+        }
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            auto condition = newCondition();
+            condition->EQ(m_tableInfo->key, keys[i]);
+            // the remote select filters the rows by the condition, the batch one only by key
+            auto remoteEntries = makeShared<Entries>();
+            if (dbEntries[i])
             {
-                auto entryIt = m_dirty.find(dbEntries->get(i)->getID());
-                if (entryIt != m_dirty.end())
-                {
-                    entries->addEntry(entryIt->second);
-                }
-                else
+                for (auto entry : *dbEntries[i])
                 {
-                    entries->addEntry(dbEntries->get(i));
+                    if (condition->process(entry))
+                    {
+                        remoteEntries->addEntry(entry);
+                    }
                 }
             }
+            result.push_back(mergeEntries(keys[i], condition, remoteEntries));
         }
+        return result;
+    }
+    catch (std::exception& e)
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("MemoryTable2") << LOG_DESC("Table batchSelect failed for")
+                           << LOG_KV("msg", boost::diagnostic_information(e));
+    }
 
-        auto it = m_newEntries.find(key);
-        if (it != m_newEntries.end())
+    return std::vector<Entries::ConstPtr>(keys.size(), makeShared<Entries>());
+}
+
+Entries::Ptr MemoryTable2::selectNoLock(const std::string& key, Condition::Ptr condition)
+{
+    try
+    {
+        condition->EQ(m_tableInfo->key, key);
+        Entries::Ptr dbEntries;
+        if (m_remoteDB)
         {
-            auto indices = processEntries(it->second, condition);
-            for (auto itIndex : indices)
+            // query remoteDB anyway
+            dbEntries = m_remoteDB->select(m_blockHash, m_blockNum, m_tableInfo, key, condition);
+            if (!dbEntries)
             {
-                it->second->get(itIndex)->setTempIndex(itIndex);
-                entries->addEntry(it->second->get(itIndex));
+                return makeShared<Entries>();
             }
         }
-        if (condition->getOffset() >= 0 && condition->getCount() >= 0)
-        {
-            Entries::Ptr resultEntries = std::make_shared<Entries>();
-            proccessLimit(condition, entries, resultEntries);
-            return resultEntries;
-        }
-        return entries;
+        return mergeEntries(key, condition, dbEntries);
     }
     catch (std::exception& e)
     {
@@ -116,12 +150,52 @@ Entries::Ptr MemoryTable2::selectNoLock(const std::string& key, Condition::Ptr c
                            << LOG_KV("msg", boost::diagnostic_information(e));
     }
 
-    return std::make_shared<Entries>();
+    return makeShared<Entries>();
+}
+
+Entries::Ptr MemoryTable2::mergeEntries(
+    const std::string& key, Condition::Ptr condition, Entries::Ptr dbEntries)
+{
+    auto entries = makeShared<Entries>();
+    if (dbEntries)
+    {
+        for (size_t i = 0; i < dbEntries->size(); ++i)
+        {
+            auto entryIt = m_dirty.find(dbEntries->get(i)->getID());
+            if (entryIt != m_dirty.end())
+            {
+                entries->addEntry(entryIt->second);
+            }
+            else
+            {
+                entries->addEntry(dbEntries->get(i));
+            }
+        }
+    }
+
+    auto it = m_newEntries.find(key);
+    if (it != m_newEntries.end())
+    {
+        auto indices = processEntries(it->second, condition);
+        for (auto itIndex : indices)
+        {
+            it->second->get(itIndex)->setTempIndex(itIndex);
+            entries->addEntry(it->second->get(itIndex));
+        }
+    }
+    if (condition->getOffset() >= 0 && condition->getCount() >= 0)
+    {
+        Entries::Ptr resultEntries = makeShared<Entries>();
+        proccessLimit(condition, entries, resultEntries);
+        return resultEntries;
+    }
+    return entries;
 }
 
 int MemoryTable2::update(
     const std::string& key, Entry::Ptr entry, Condition::Ptr condition, AccessOptions::Ptr options)
 {
+    recordAccess(key, true);
     try
     {
         if (options->check && !checkAuthority(options->origin))
@@ -140,13 +214,7 @@ int MemoryTable2::update(
 
         for (size_t i = 0; i < entries->size(); ++i)
         {
-            Entry::Ptr updateEntry = entries->get(i);
-
-            // if id not equals to zero and not in the m_dirty, must be new dirty entry
-            if (updateEntry->getID() != 0 && m_dirty.find(updateEntry->getID()) == m_dirty.end())
-            {
-                m_dirty.insert(std::make_pair(updateEntry->getID(), updateEntry));
-            }
+            Entry::Ptr updateEntry = cloneOnWrite(entries->get(i));
 
             for (auto& it : *(entry))
             {
@@ -159,6 +227,7 @@ int MemoryTable2::update(
                     updateEntry->setField(it.first, it.second);
                 }
             }
+            updateDigest(updateEntry);
         }
 
         m_recorder(shared_from_this(), Change::Update, key, records);
@@ -179,6 +248,7 @@ int MemoryTable2::update(
 int MemoryTable2::insert(
     const std::string& key, Entry::Ptr entry, AccessOptions::Ptr options, bool needSelect)
 {
+    recordAccess(key, true);
     try
     {
         (void)needSelect;
@@ -198,10 +268,11 @@ int MemoryTable2::insert(
 
         if (it == m_newEntries.end())
         {
-            Entries::Ptr entries = std::make_shared<Entries>();
+            Entries::Ptr entries = makeShared<Entries>();
             it = m_newEntries.insert(std::make_pair(key, entries)).first;
         }
         auto iter = it->second->addEntry(entry);
+        updateDigest(entry);
 
         // auto iter = m_newEntries->addEntry(entry);
         Change::Record record(iter);
@@ -225,6 +296,7 @@ int MemoryTable2::insert(
 int MemoryTable2::remove(
     const std::string& key, Condition::Ptr condition, AccessOptions::Ptr options)
 {
+    recordAccess(key, true);
     try
     {
         if (options->check && !checkAuthority(options->origin))
@@ -240,15 +312,10 @@ int MemoryTable2::remove(
         std::vector<Change::Record> records;
         for (size_t i = 0; i < entries->size(); ++i)
         {
-            Entry::Ptr removeEntry = entries->get(i);
+            Entry::Ptr removeEntry = cloneOnWrite(entries->get(i));
 
             removeEntry->setStatus(1);
-
-            // if id not equals to zero and not in the m_dirty, must be new dirty entry
-            if (removeEntry->getID() != 0 && m_dirty.find(removeEntry->getID()) == m_dirty.end())
-            {
-                m_dirty.insert(std::make_pair(removeEntry->getID(), removeEntry));
-            }
+            updateDigest(removeEntry);
 
             records.emplace_back(removeEntry->getTempIndex(), "", "", removeEntry->getID());
         }
@@ -268,11 +335,47 @@ int MemoryTable2::remove(
     return 0;
 }
 
+Entry::Ptr MemoryTable2::cloneOnWrite(Entry::Ptr entry)
+{
+    // if id not equals to zero and not in the m_dirty, must be new dirty entry
+    if (entry->getID() != 0)
+    {
+        auto it = m_dirty.find(entry->getID());
+        if (it != m_dirty.end())
+        {
+            return it->second;
+        }
+
+        // entries selected from the remote db are shared with its cache, modify a copy of them
+        auto dirtyEntry = makeShared<Entry>();
+        dirtyEntry->copyFrom(entry);
+        return m_dirty.insert(std::make_pair(entry->getID(), dirtyEntry)).first->second;
+    }
+
+    return entry;
+}
+
 dev::h256 MemoryTable2::hash()
 {
+    if (m_incrementalHash)
+    {
+        u256 sum = 0;
+        for (auto& accumulator : m_accumulators)
+        {
+            sum += accumulator;
+        }
+
+        if (sum == 0)
+        {
+            return h256();
+        }
+        m_hash = dev::sha256(h256(sum).ref());
+        return m_hash;
+    }
+
+    // the data dumped is kept for commitDB
     if (m_isDirty)
     {
-        m_tableData.reset(new dev::storage::TableData());
         dump();
     }
 
@@ -286,7 +389,7 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
     {
         m_tableData = std::make_shared<dev::storage::TableData>();
         m_tableData->info = m_tableInfo;
-        m_tableData->dirtyEntries = std::make_shared<Entries>();
+        m_tableData->dirtyEntries = makeShared<Entries>();
 
         auto tempEntries = tbb::concurrent_vector<Entry::Ptr>();
 
@@ -297,12 +400,15 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
                     if (!it->second->deleted())
                     {
                         m_tableData->dirtyEntries->addEntry(it->second);
-                        tempEntries.push_back(it->second);
+                        if (!m_incrementalHash)
+                        {
+                            tempEntries.push_back(it->second);
+                        }
                     }
                 }
             });
 
-        m_tableData->newEntries = std::make_shared<Entries>();
+        m_tableData->newEntries = makeShared<Entries>();
         tbb::parallel_for(m_newEntries.range(),
             [&](tbb::concurrent_unordered_map<std::string, Entries::Ptr>::range_type& range) {
                 for (auto it = range.begin(); it != range.end(); ++it)
@@ -314,13 +420,23 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
                                 if (!it->second->get(i)->deleted())
                                 {
                                     m_tableData->newEntries->addEntry(it->second->get(i));
-                                    tempEntries.push_back(it->second->get(i));
+                                    if (!m_incrementalHash)
+                                    {
+                                        tempEntries.push_back(it->second->get(i));
+                                    }
                                 }
                             }
                         });
                 }
             });
 
+        if (m_incrementalHash)
+        {
+            // hashed by the accumulators
+            m_isDirty = false;
+            return m_tableData;
+        }
+
         TIME_RECORD("Sort data");
         tbb::parallel_sort(tempEntries.begin(), tempEntries.end(), EntryLessNoLock(m_tableInfo));
         TIME_RECORD("Submmit data");
@@ -354,6 +470,68 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
     return m_tableData;
 }
 
+void MemoryTable2::updateDigest(Entry::Ptr entry)
+{
+    if (!m_incrementalHash)
+    {
+        return;
+    }
+
+    // rolled back inserts are not hashed, the same as the sorted digest
+    h256 digest = entry->deleted() ? h256() : entryDigest(entry);
+
+    // an entry is only written by one transaction at a time
+    auto& accumulator = m_accumulators.local();
+    auto it = m_digests.find(entry.get());
+    if (it != m_digests.end())
+    {
+        accumulator -= u256(it->second);
+        it->second = digest;
+    }
+    else
+    {
+        m_digests.insert(std::make_pair(entry.get(), digest));
+    }
+    accumulator += u256(digest);
+}
+
+h256 MemoryTable2::hash(TableData const& _data)
+{
+    // the same sum as the accumulators, the entries dumped are the live ones
+    u256 sum = 0;
+    for (auto entries : {_data.dirtyEntries, _data.newEntries})
+    {
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            sum += u256(entryDigest(entries->get(i)));
+        }
+    }
+
+    if (sum == 0)
+    {
+        return h256();
+    }
+    return dev::sha256(h256(sum).ref());
+}
+
+h256 MemoryTable2::entryDigest(Entry::Ptr entry)
+{
+    // same layout as an entry of the sorted digest
+    bytes data;
+    for (auto fieldIt : *(entry))
+    {
+        if (isHashField(fieldIt.first))
+        {
+            data.insert(data.end(), fieldIt.first.begin(), fieldIt.first.end());
+            data.insert(data.end(), fieldIt.second.begin(), fieldIt.second.end());
+        }
+    }
+    char status = (char)entry->getStatus();
+    data.insert(data.end(), &status, &status + sizeof(status));
+
+    return dev::sha256(bytesConstRef(data.data(), data.size()));
+}
+
 void MemoryTable2::rollback(const Change& _change)
 {
 #if 0
@@ -372,6 +550,7 @@ void MemoryTable2::rollback(const Change& _change)
         {
             auto entry = it->second->get(_change.value[0].index);
             entry->setDeleted(true);
+            updateDigest(entry);
         }
         break;
     }
@@ -390,6 +569,7 @@ void MemoryTable2::rollback(const Change& _change)
                 if (it != m_dirty.end())
                 {
                     it->second->setField(record.key, record.oldValue);
+                    updateDigest(it->second);
                 }
             }
             else
@@ -399,6 +579,7 @@ void MemoryTable2::rollback(const Change& _change)
                 {
                     auto entry = it->second->get(record.index);
                     entry->setField(record.key, record.oldValue);
+                    updateDigest(entry);
                 }
             }
         }
@@ -418,6 +599,7 @@ void MemoryTable2::rollback(const Change& _change)
                 if (it != m_dirty.end())
                 {
                     it->second->setStatus(0);
+                    updateDigest(it->second);
                 }
             }
             else
@@ -427,6 +609,7 @@ void MemoryTable2::rollback(const Change& _change)
                 {
                     auto entry = it->second->get(record.index);
                     entry->setStatus(0);
+                    updateDigest(entry);
                 }
             }
         }
@@ -27,8 +27,10 @@
 #include <libdevcore/Guards.h>
 #include <libdevcore/easylog.h>
 #include <libdevcrypto/Hash.h>
+#include <libconfig/GlobalConfigure.h>
 #include <libprecompiled/Common.h>
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/lexical_cast.hpp>
 #include <type_traits>
@@ -46,19 +48,26 @@ public:
 
     Entries::ConstPtr select(const std::string& key, Condition::Ptr condition) override;
 
+    std::vector<Entries::ConstPtr> batchSelect(const std::vector<std::string>& keys) override;
+
     int update(const std::string& key, Entry::Ptr entry, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) override;
 
     int insert(const std::string& key, Entry::Ptr entry,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>(),
+        AccessOptions::Ptr options = AccessOptions::defaultOptions(),
         bool needSelect = true) override;
 
     int remove(const std::string& key, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) override;
 
     h256 hash() override;
 
-    void clear() override { m_dirty.clear(); }
+    void clear() override
+    {
+        m_dirty.clear();
+        m_digests.clear();
+        m_accumulators.clear();
+    }
     bool empty() override
     {
         for (auto iter : m_dirty)
@@ -86,11 +95,24 @@ public:
     }
 
     dev::storage::TableData::Ptr dump() override;
+    /// the incremental hash of the table whose changes were dumped into _data
+    static h256 hash(TableData const& _data);
 
     void rollback(const Change& _change) override;
 
 private:
     Entries::Ptr selectNoLock(const std::string& key, Condition::Ptr condition);
+    // the entries of the key in the remote db overlaid with the dirty and the new entries
+    Entries::Ptr mergeEntries(
+        const std::string& key, Condition::Ptr condition, Entries::Ptr dbEntries);
+    // adds the key to the access set bound to the calling thread
+    void recordAccess(const std::string& key, bool write);
+    // the dirty copy of a selected entry, entries of the remote db are cloned on first write
+    Entry::Ptr cloneOnWrite(Entry::Ptr entry);
+
+    // fold the digest of a written entry into the accumulator in place of its previous one
+    void updateDigest(Entry::Ptr entry);
+    static h256 entryDigest(Entry::Ptr entry);
 
     tbb::concurrent_unordered_map<std::string, Entries::Ptr> m_newEntries;
     tbb::concurrent_unordered_map<uint64_t, Entry::Ptr> m_dirty;
@@ -151,6 +173,13 @@ private:
 
     bool m_isDirty = false;  // mark if the tableData had been dump
     dev::h256 m_hash;
+
+    // the table hash is the sum of the entry digests instead of the digest of the sorted
+    // entries, so it's computed while executing, older versions keep the sorted digest
+    bool m_incrementalHash = g_BCOSConfig.version() >= V2_1_0;
+    tbb::concurrent_unordered_map<Entry*, h256> m_digests;
+    // sums of digests modulo 2^256, one per executing thread
+    tbb::enumerable_thread_specific<u256> m_accumulators;
     dev::storage::TableData::Ptr m_tableData;
 };
 }  // namespace storage
@@ -38,13 +38,13 @@ using namespace std;
 
 const std::vector<string> MemoryTableFactory::c_sysTables = std::vector<string>{SYS_CONSENSUS,
     SYS_TABLES, SYS_ACCESS_TABLE, SYS_CURRENT_STATE, SYS_NUMBER_2_HASH, SYS_TX_HASH_2_BLOCK,
-    SYS_HASH_2_BLOCK, SYS_CNS, SYS_CONFIG, SYS_BLOCK_2_NONCES};
+    SYS_HASH_2_BLOCK, SYS_CNS, SYS_CONFIG, SYS_BLOCK_2_NONCES, SYS_LOG_INDEX, SYS_BLOCK_2_BLOOM};
 
 // according to
 // https://fisco-bcos-documentation.readthedocs.io/zh_CN/release-2.0/docs/design/security_control/permission_control.html
 const std::vector<string> MemoryTableFactory::c_sysNonChangeLogTables =
     std::vector<string>{SYS_CURRENT_STATE, SYS_TX_HASH_2_BLOCK, SYS_NUMBER_2_HASH, SYS_HASH_2_BLOCK,
-        SYS_BLOCK_2_NONCES};
+        SYS_BLOCK_2_NONCES, SYS_LOG_INDEX, SYS_BLOCK_2_BLOOM};
 
 MemoryTableFactory::MemoryTableFactory() : m_blockHash(h256(0)), m_blockNum(0) {}
 
@@ -138,8 +138,10 @@ Table::Ptr MemoryTableFactory::openTable(
 
 Table::Ptr MemoryTableFactory::createTable(const std::string& tableName,
     const std::string& keyField, const std::string& valueField, bool authorityFlag,
-    Address const& _origin, bool isPara)
+    Address const& _origin, bool isPara, const std::string& indexField)
 {
+    // secondary indexes are served by CachedStorage, which only works with MemoryTableFactory2
+    (void)indexField;
     RecursiveGuard l(x_name2Table);
 
     auto sysTable = openTable(SYS_TABLES, authorityFlag);
@@ -328,6 +330,16 @@ storage::TableInfo::Ptr MemoryTableFactory::getSysTableInfo(const std::string& t
         tableInfo->key = "number";
         tableInfo->fields = std::vector<std::string>{SYS_VALUE};
     }
+    else if (tableName == SYS_LOG_INDEX)
+    {
+        tableInfo->key = SYS_KEY;
+        tableInfo->fields = std::vector<std::string>{SYS_VALUE};
+    }
+    else if (tableName == SYS_BLOCK_2_BLOOM)
+    {
+        tableInfo->key = "number";
+        tableInfo->fields = std::vector<std::string>{SYS_VALUE};
+    }
     return tableInfo;
 }
 
@@ -51,7 +51,8 @@ public:
         const std::string& tableName, bool authorityFlag = true, bool isPara = true) override;
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
         const std::string& valueField, bool authorityFlag = true,
-        Address const& _origin = Address(), bool isPara = true) override;
+        Address const& _origin = Address(), bool isPara = true,
+        const std::string& indexField = std::string()) override;
 
     virtual Storage::Ptr stateStorage() { return m_stateStorage; }
     virtual void setStateStorage(Storage::Ptr stateStorage) { m_stateStorage = stateStorage; }
@@ -19,6 +19,7 @@
  *  @date 20180921
  */
 #include "MemoryTableFactory2.h"
+#include "AccessSet.h"
 #include "Common.h"
 #include "MemoryTable2.h"
 #include "StorageException.h"
@@ -32,7 +33,9 @@
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 #include <boost/algorithm/string.hpp>
+#include <map>
 #include <memory>
+#include <set>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -53,6 +56,8 @@ MemoryTableFactory2::MemoryTableFactory2() : m_blockHash(h256(0)), m_blockNum(0)
     m_sysTables.push_back(SYS_CNS);
     m_sysTables.push_back(SYS_CONFIG);
     m_sysTables.push_back(SYS_BLOCK_2_NONCES);
+    m_sysTables.push_back(SYS_LOG_INDEX);
+    m_sysTables.push_back(SYS_BLOCK_2_BLOOM);
 }
 
 
@@ -61,6 +66,17 @@ Table::Ptr MemoryTableFactory2::openTable(
 {
     (void)isPara;
 
+    // Opening depends on the table entry and the permissions of the table whether the table is
+    // cached or not, the reads done by the first open are not recorded, so the access set of a
+    // transaction does not depend on what earlier transactions opened.
+    auto accessSet = AccessSet::current();
+    if (accessSet)
+    {
+        accessSet->read(SYS_TABLES, tableName);
+        accessSet->read(SYS_ACCESS_TABLE, tableName);
+    }
+    AccessSet::Scope accessSetScope(nullptr);
+
     RecursiveGuard l(x_name2Table);
     auto it = m_name2Table.find(tableName);
     if (it != m_name2Table.end())
@@ -86,6 +102,11 @@ Table::Ptr MemoryTableFactory2::openTable(
         tableInfo->key = entry->getField("key_field");
         std::string valueFields = entry->getField("value_field");
         boost::split(tableInfo->fields, valueFields, boost::is_any_of(","));
+        std::string indexFields = entry->getField("index_field");
+        if (!indexFields.empty())
+        {
+            boost::split(tableInfo->indices, indexFields, boost::is_any_of(","));
+        }
     }
     tableInfo->fields.emplace_back(STATUS);
     tableInfo->fields.emplace_back(tableInfo->key);
@@ -124,8 +145,7 @@ Table::Ptr MemoryTableFactory2::openTable(
     memoryTable->setTableInfo(tableInfo);
     memoryTable->setRecorder([&](Table::Ptr _table, Change::Kind _kind, std::string const& _key,
                                  std::vector<Change::Record>& _records) {
-        auto& changeLog = getChangeLog();
-        changeLog.emplace_back(_table, _kind, _key, _records);
+        getChangeLog().record(_table, _kind, _key, _records);
     });
 
     m_name2Table.insert({tableName, memoryTable});
@@ -134,8 +154,27 @@ Table::Ptr MemoryTableFactory2::openTable(
 
 Table::Ptr MemoryTableFactory2::createTable(const std::string& tableName,
     const std::string& keyField, const std::string& valueField, bool authorityFlag,
-    Address const& _origin, bool isPara)
+    Address const& _origin, bool isPara, const std::string& indexField)
 {
+    if (!indexField.empty())
+    {
+        std::vector<std::string> indices;
+        std::vector<std::string> fields;
+        boost::split(indices, indexField, boost::is_any_of(","));
+        boost::split(fields, valueField, boost::is_any_of(","));
+        for (auto& index : indices)
+        {
+            if (find(fields.begin(), fields.end(), index) == fields.end())
+            {
+                STORAGE_LOG(ERROR) << LOG_BADGE("MemoryTableFactory2")
+                                   << LOG_DESC("index field is not a value field")
+                                   << LOG_KV("table name", tableName) << LOG_KV("field", index);
+                BOOST_THROW_EXCEPTION(
+                    StorageException(CODE_TABLE_INDEX_FIELD_NOT_EXIST, "invalid index field"));
+            }
+        }
+    }
+
     auto sysTable = openTable(SYS_TABLES, authorityFlag);
     // To make sure the table exists
     auto tableEntries = sysTable->select(tableName, sysTable->newCondition());
@@ -151,6 +190,10 @@ Table::Ptr MemoryTableFactory2::createTable(const std::string& tableName,
     tableEntry->setField("table_name", tableName);
     tableEntry->setField("key_field", keyField);
     tableEntry->setField("value_field", valueField);
+    if (g_BCOSConfig.version() >= V2_1_0)
+    {
+        tableEntry->setField("index_field", indexField);
+    }
     auto result = sysTable->insert(
         tableName, tableEntry, std::make_shared<AccessOptions>(_origin, authorityFlag));
     if (result == storage::CODE_NO_AUTHORIZED)
@@ -165,8 +208,7 @@ Table::Ptr MemoryTableFactory2::createTable(const std::string& tableName,
 
 size_t MemoryTableFactory2::savepoint()
 {
-    auto& changeLog = getChangeLog();
-    return changeLog.size();
+    return getChangeLog().savepoint();
 }
 
 void MemoryTableFactory2::commit()
@@ -184,7 +226,7 @@ void MemoryTableFactory2::setBlockNum(int64_t blockNum)
     m_blockNum = blockNum;
 }
 
-h256 MemoryTableFactory2::hash()
+std::vector<std::pair<std::string, Table::Ptr> > MemoryTableFactory2::sortedTables() const
 {
     std::vector<std::pair<std::string, Table::Ptr> > tables;
     for (auto it : m_name2Table)
@@ -195,6 +237,12 @@ h256 MemoryTableFactory2::hash()
     tbb::parallel_sort(tables.begin(), tables.end(),
         [](const std::pair<std::string, Table::Ptr>& lhs,
             const std::pair<std::string, Table::Ptr>& rhs) { return lhs.first < rhs.first; });
+    return tables;
+}
+
+h256 MemoryTableFactory2::hash()
+{
+    auto tables = sortedTables();
 
     bytes data;
     data.resize(tables.size() * 32);
@@ -223,44 +271,178 @@ h256 MemoryTableFactory2::hash()
     return m_hash;
 }
 
-std::vector<Change>& MemoryTableFactory2::getChangeLog()
+ChangeLog& MemoryTableFactory2::getChangeLog()
 {
+    auto changeLog = ChangeLog::current();
+    if (changeLog)
+    {
+        return *changeLog;
+    }
     return s_changeLog.local();
 }
 
 void MemoryTableFactory2::rollback(size_t _savepoint)
 {
-    auto& changeLog = getChangeLog();
-    while (_savepoint < changeLog.size())
-    {
-        auto change = changeLog.back();
+    getChangeLog().rollback(_savepoint);
+}
 
-        // Public MemoryTable API cannot be used here because it will add another
-        // change log entry.
-        change.table->rollback(change);
+vector<dev::storage::TableData::Ptr> MemoryTableFactory2::dump(bool _opened)
+{
+    // the tables are dumped in parallel, the data of the tables hashed by hash() is reused
+    auto tables = sortedTables();
+    vector<dev::storage::TableData::Ptr> dumped(tables.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, tables.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (auto i = range.begin(); i != range.end(); ++i)
+            {
+                STORAGE_LOG(TRACE) << "Dumping table: " << tables[i].first;
+                auto tableData = tables[i].second->dump();
+                if (tableData &&
+                    (tableData->dirtyEntries->size() > 0 || tableData->newEntries->size() > 0))
+                {
+                    dumped[i] = tableData;
+                }
+                else if (_opened)
+                {
+                    dumped[i] = make_shared<TableData>();
+                    dumped[i]->info = tables[i].second->tableInfo();
+                }
+            }
+        });
 
-        changeLog.pop_back();
+    if (!m_diff.empty())
+    {
+        return mergeDiff(dumped, _opened);
+    }
+    // in the order of the table names whichever thread dumped them
+    vector<dev::storage::TableData::Ptr> datas;
+    for (auto& tableData : dumped)
+    {
+        if (tableData)
+        {
+            datas.push_back(std::move(tableData));
+        }
     }
+    return datas;
 }
 
-void MemoryTableFactory2::commitDB(dev::h256 const& _blockHash, int64_t _blockNumber)
+vector<TableData::Ptr> MemoryTableFactory2::mergeDiff(
+    vector<TableData::Ptr> const& _dumped, bool _opened)
 {
-    auto start_time = utcTime();
-    auto record_time = utcTime();
-    vector<dev::storage::TableData::Ptr> datas;
-
-    for (auto& dbIt : m_name2Table)
+    map<string, TableData::Ptr> merged;
+    for (auto& data : m_diff)
+    {
+        if (_opened || data->dirtyEntries->size() > 0 || data->newEntries->size() > 0)
+        {
+            merged[data->info->name] = data;
+        }
+    }
+    for (auto& data : _dumped)
     {
-        auto table = std::dynamic_pointer_cast<Table>(dbIt.second);
+        if (!data)
+        {
+            continue;
+        }
+        auto it = merged.find(data->info->name);
+        if (it == merged.end())
+        {
+            merged[data->info->name] = data;
+            continue;
+        }
+        // a table of the diff written again, by the block tables written on commit
+        auto both = make_shared<TableData>();
+        both->info = it->second->info;
+        for (auto from : {it->second, data})
+        {
+            for (size_t i = 0; i < from->dirtyEntries->size(); ++i)
+            {
+                both->dirtyEntries->addEntry(from->dirtyEntries->get(i));
+            }
+            for (size_t i = 0; i < from->newEntries->size(); ++i)
+            {
+                both->newEntries->addEntry(from->newEntries->get(i));
+            }
+        }
+        it->second = both;
+    }
 
-        STORAGE_LOG(TRACE) << "Dumping table: " << dbIt.first;
-        auto tableData = table->dump();
+    vector<TableData::Ptr> datas;
+    for (auto& it : merged)
+    {
+        datas.push_back(it.second);
+    }
+    return datas;
+}
 
-        if (tableData && (tableData->dirtyEntries->size() > 0 || tableData->newEntries->size() > 0))
+void MemoryTableFactory2::applyDiff(vector<TableData::Ptr> const& _diff)
+{
+    // the ids aren't hashed, a dirty entry must update a row of its key in the state, the new
+    // entries are numbered by the storage on commit
+    for (auto& data : _diff)
+    {
+        set<uint64_t> ids;
+        map<string, set<uint64_t> > rows;
+        for (size_t i = 0; i < data->dirtyEntries->size(); ++i)
+        {
+            auto entry = data->dirtyEntries->get(i);
+            auto key = entry->getField(data->info->key);
+            auto it = rows.find(key);
+            if (it == rows.end())
+            {
+                auto condition = make_shared<Condition>();
+                condition->EQ(data->info->key, key);
+                auto entries =
+                    m_stateStorage->select(m_blockHash, m_blockNum, data->info, key, condition);
+                it = rows.insert(make_pair(key, set<uint64_t>())).first;
+                for (size_t j = 0; entries && j < entries->size(); ++j)
+                {
+                    it->second.insert(entries->get(j)->getID());
+                }
+            }
+            if (entry->getID() == 0 || !it->second.count(entry->getID()) ||
+                !ids.insert(entry->getID()).second)
+            {
+                STORAGE_LOG(ERROR) << LOG_BADGE("MemoryTableFactory2")
+                                   << LOG_DESC("Dirty entry of the diff not in the state")
+                                   << LOG_KV("table", data->info->name) << LOG_KV("key", key)
+                                   << LOG_KV("id", entry->getID());
+                BOOST_THROW_EXCEPTION(
+                    StorageException(-1, "dirty entry of the state diff not in the state"));
+            }
+        }
+        for (size_t i = 0; i < data->newEntries->size(); ++i)
         {
-            datas.push_back(tableData);
+            data->newEntries->get(i)->setID(0);
         }
     }
+    m_diff = _diff;
+}
+
+h256 MemoryTableFactory2::hash(vector<TableData::Ptr> const& _opened)
+{
+    // the layout of hash(), the tables dumped with the unchanged ones in the order of their names
+    bytes data(_opened.size() * 32);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _opened.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (auto it = range.begin(); it != range.end(); ++it)
+            {
+                h256 tableHash = MemoryTable2::hash(*_opened[it]);
+                memcpy(&data[it * 32], tableHash.data(), 32);
+            }
+        });
+
+    if (data.empty())
+    {
+        return h256();
+    }
+    return dev::sha256(&data);
+}
+
+void MemoryTableFactory2::commitDB(dev::h256 const& _blockHash, int64_t _blockNumber)
+{
+    auto start_time = utcTime();
+    auto record_time = utcTime();
+    auto datas = dump();
     auto getData_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
@@ -272,6 +454,7 @@ void MemoryTableFactory2::commitDB(dev::h256 const& _blockHash, int64_t _blockNu
     record_time = utcTime();
 
     m_name2Table.clear();
+    m_diff.clear();
     auto clear_time_cost = utcTime() - record_time;
     STORAGE_LOG(DEBUG) << LOG_BADGE("Commit") << LOG_DESC("Commit db time record")
                        << LOG_KV("getDataTimeCost", getData_time_cost)
@@ -292,7 +475,7 @@ storage::TableInfo::Ptr MemoryTableFactory2::getSysTableInfo(const std::string&
     else if (tableName == SYS_TABLES)
     {
         tableInfo->key = "table_name";
-        tableInfo->fields = vector<string>{"key_field", "value_field"};
+        tableInfo->fields = vector<string>{"key_field", "value_field", "index_field"};
     }
     else if (tableName == SYS_ACCESS_TABLE)
     {
@@ -334,6 +517,16 @@ storage::TableInfo::Ptr MemoryTableFactory2::getSysTableInfo(const std::string&
         tableInfo->key = "number";
         tableInfo->fields = std::vector<std::string>{SYS_VALUE};
     }
+    else if (tableName == SYS_LOG_INDEX)
+    {
+        tableInfo->key = SYS_KEY;
+        tableInfo->fields = std::vector<std::string>{SYS_VALUE};
+    }
+    else if (tableName == SYS_BLOCK_2_BLOOM)
+    {
+        tableInfo->key = "number";
+        tableInfo->fields = std::vector<std::string>{SYS_VALUE};
+    }
     return tableInfo;
 }
 
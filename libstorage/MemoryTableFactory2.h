@@ -20,6 +20,7 @@
  */
 #pragma once
 
+#include "ChangeLog.h"
 #include "Common.h"
 #include "MemoryTable.h"
 #include "Storage.h"
@@ -50,7 +51,8 @@ public:
         const std::string& tableName, bool authorityFlag = true, bool isPara = true) override;
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
         const std::string& valueField, bool authorityFlag = true,
-        Address const& _origin = Address(), bool isPara = true) override;
+        Address const& _origin = Address(), bool isPara = true,
+        const std::string& indexField = std::string()) override;
 
     virtual Storage::Ptr stateStorage() { return m_stateStorage; }
     virtual void setStateStorage(Storage::Ptr stateStorage) { m_stateStorage = stateStorage; }
@@ -63,19 +65,35 @@ public:
     virtual void commit() override;
     virtual void rollback(size_t _savepoint) override;
     virtual void commitDB(h256 const& _blockHash, int64_t _blockNumber) override;
+    // the data of the changed tables in the order of their names, what commitDB commits,
+    // _opened dumps the tables opened but unchanged as well, with no entries
+    std::vector<TableData::Ptr> dump(bool _opened = false);
+    // the tables of the state diff of the block, committed by commitDB with the tables written
+    // to this factory instead of executing the block, throws if a dirty entry isn't a row of its
+    // key in the state storage
+    void applyDiff(std::vector<TableData::Ptr> const& _diff);
+    // the dbHash of the tables dumped with the opened ones, the hash() of the factory dumping
+    // them when the table hash is incremental
+    static h256 hash(std::vector<TableData::Ptr> const& _opened);
 
 private:
     storage::TableInfo::Ptr getSysTableInfo(const std::string& tableName);
+    // the opened tables in the order of their names
+    std::vector<std::pair<std::string, Table::Ptr> > sortedTables() const;
     void setAuthorizedAddress(storage::TableInfo::Ptr _tableInfo);
-    std::vector<Change>& getChangeLog();
+    std::vector<TableData::Ptr> mergeDiff(
+        std::vector<TableData::Ptr> const& _dumped, bool _opened);
+    // the log of the executing transaction, or the log of this thread if none is bound
+    ChangeLog& getChangeLog();
     Storage::Ptr m_stateStorage;
     h256 m_blockHash;
     int m_blockNum;
     // this map can't be changed, hash() need ordered data
     tbb::concurrent_unordered_map<std::string, Table::Ptr> m_name2Table;
-    tbb::enumerable_thread_specific<std::vector<Change> > s_changeLog;
+    tbb::enumerable_thread_specific<ChangeLog> s_changeLog;
     h256 m_hash;
     std::vector<std::string> m_sysTables;
+    std::vector<TableData::Ptr> m_diff;
 
     // mutex
     mutable RecursiveMutex x_name2Table;
@@ -34,9 +34,15 @@ class MemoryTableFactoryFactory : public TableFactoryFactory
 {
 public:
     virtual TableFactory::Ptr newTableFactory(dev::h256 hash, int64_t number) override
+    {
+        return newTableFactory(hash, number, m_stroage);
+    }
+
+    virtual TableFactory::Ptr newTableFactory(
+        dev::h256 hash, int64_t number, Storage::Ptr storage) override
     {
         MemoryTableFactory::Ptr tableFactory = std::make_shared<MemoryTableFactory>();
-        tableFactory->setStateStorage(m_stroage);
+        tableFactory->setStateStorage(storage);
         tableFactory->setBlockHash(hash);
         tableFactory->setBlockNum(number);
 
@@ -0,0 +1,75 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file RocksDBEnv.cpp
+ *  @author ancelmo
+ *  @date 20191015
+ */
+
+#include "RocksDBEnv.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/options.h"
+#include "rocksdb/rate_limiter.h"
+#include "rocksdb/table.h"
+#include "rocksdb/write_buffer_manager.h"
+#include <libdevcore/easylog.h>
+
+using namespace dev;
+using namespace dev::storage;
+
+RocksDBEnv& RocksDBEnv::instance()
+{
+    static RocksDBEnv env;
+    return env;
+}
+
+void RocksDBEnv::configure(uint64_t _memoryBytes, uint64_t _bytesPerSecond)
+{
+    m_memoryBytes = _memoryBytes;
+    m_bytesPerSecond = _bytesPerSecond;
+    m_blockCache.reset();
+    m_writeBufferManager.reset();
+    m_rateLimiter.reset();
+    if (_memoryBytes > 0)
+    {
+        m_blockCache = rocksdb::NewLRUCache(_memoryBytes);
+        // the memtables take up to half of the budget, the blocks get the rest and what the
+        // memtables don't use
+        m_writeBufferManager =
+            std::make_shared<rocksdb::WriteBufferManager>(_memoryBytes / 2, m_blockCache);
+    }
+    if (_bytesPerSecond > 0)
+    {
+        m_rateLimiter.reset(rocksdb::NewGenericRateLimiter(_bytesPerSecond));
+    }
+    LOG(INFO) << LOG_BADGE("RocksDBEnv") << LOG_DESC("configure")
+              << LOG_KV("memoryBytes", _memoryBytes) << LOG_KV("bytesPerSecond", _bytesPerSecond);
+}
+
+void RocksDBEnv::apply(rocksdb::Options& _options) const
+{
+    if (m_blockCache)
+    {
+        rocksdb::BlockBasedTableOptions tableOptions;
+        tableOptions.block_cache = m_blockCache;
+        _options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+        _options.write_buffer_manager = m_writeBufferManager;
+    }
+    if (m_rateLimiter)
+    {
+        _options.rate_limiter = m_rateLimiter;
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file RocksDBEnv.h
+ *  @author ancelmo
+ *  @date 20191015
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace rocksdb
+{
+class Cache;
+class RateLimiter;
+class WriteBufferManager;
+struct Options;
+}  // namespace rocksdb
+
+namespace dev
+{
+namespace storage
+{
+/// The resources shared by the rocksdb of all groups of the node. With a memory budget, one block
+/// cache holds the blocks of every db and, through a write buffer manager, is charged for their
+/// memtables too; with a rate limit, one limiter paces the flushes and compactions of every db.
+/// The background threads are those of the default env, already shared. Without a budget or a
+/// limit each db keeps the cache and the pace of its own.
+class RocksDBEnv
+{
+public:
+    static RocksDBEnv& instance();
+
+    /// called once before the groups open their db, 0 for no budget or no limit
+    void configure(uint64_t _memoryBytes, uint64_t _bytesPerSecond);
+
+    /// point the options of a db at the shared resources configured
+    void apply(rocksdb::Options& _options) const;
+
+    /// the block cache shared by all dbs, null without a memory budget
+    std::shared_ptr<rocksdb::Cache> blockCache() const { return m_blockCache; }
+
+    uint64_t memoryBytes() const { return m_memoryBytes; }
+    uint64_t bytesPerSecond() const { return m_bytesPerSecond; }
+
+private:
+    RocksDBEnv() = default;
+
+    uint64_t m_memoryBytes = 0;
+    uint64_t m_bytesPerSecond = 0;
+    std::shared_ptr<rocksdb::Cache> m_blockCache;
+    std::shared_ptr<rocksdb::WriteBufferManager> m_writeBufferManager;
+    std::shared_ptr<rocksdb::RateLimiter> m_rateLimiter;
+};
+
+}  // namespace storage
+}  // namespace dev
+
+#define g_rocksDBEnv dev::storage::RocksDBEnv::instance()
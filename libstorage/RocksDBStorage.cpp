@@ -20,24 +20,26 @@
  */
 
 #include "RocksDBStorage.h"
+#include "RowCodec.h"
 #include "StorageException.h"
 #include "Table.h"
-#include "boost/archive/binary_iarchive.hpp"
-#include "boost/archive/binary_oarchive.hpp"
-#include "boost/serialization/map.hpp"
-#include "boost/serialization/serialization.hpp"
-#include "boost/serialization/vector.hpp"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/utilities/checkpoint.h"
 #include "rocksdb/write_batch.h"
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
+#include <libdevcrypto/AES.h>
+#include <boost/filesystem.hpp>
 #include <tbb/parallel_for.h>
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 using namespace std;
@@ -45,6 +47,16 @@ using namespace dev;
 using namespace dev::storage;
 using namespace rocksdb;
 
+static const string CONTRACT_TABLE_PREFIX = "_contract_data_";
+
+RocksDBStorage::~RocksDBStorage()
+{
+    for (auto handle : m_handles)
+    {
+        m_db->DestroyColumnFamilyHandle(handle);
+    }
+}
+
 Entries::Ptr RocksDBStorage::select(
     h256, int64_t, TableInfo::Ptr tableInfo, const string& key, Condition::Ptr condition)
 {
@@ -54,7 +66,8 @@ Entries::Ptr RocksDBStorage::select(
         entryKey.append("_").append(key);
 
         string value;
-        auto s = m_db->Get(ReadOptions(), Slice(std::move(entryKey)), &value);
+        auto s = m_db->Get(
+            ReadOptions(), columnFamily(tableInfo->name), Slice(std::move(entryKey)), &value);
         if (!s.ok() && !s.IsNotFound())
         {
             STORAGE_ROCKSDB_LOG(ERROR)
@@ -63,85 +76,195 @@ Entries::Ptr RocksDBStorage::select(
             BOOST_THROW_EXCEPTION(StorageException(-1, "Query rocksdb exception:" + s.ToString()));
         }
 
-        Entries::Ptr entries = make_shared<Entries>();
-        if (!s.IsNotFound())
+        if (s.IsNotFound())
         {
-            vector<map<string, string>> res;
-            stringstream ss(value);
-            boost::archive::binary_iarchive ia(ss);
-            ia >> res;
+            return make_shared<Entries>();
+        }
 
-            for (auto it = res.begin(); it != res.end(); ++it)
-            {
-                Entry::Ptr entry = make_shared<Entry>();
+        return decodeEntries(value.data(), value.size(), condition);
+    }
+    catch (exception& e)
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Query rocksdb exception")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
 
-                for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
-                {
-                    entry->setField(valueIt->first, valueIt->second);
-                }
-                entry->setID(it->at(ID_FIELD));
-                entry->setNum(it->at(NUM_FIELD));
+        BOOST_THROW_EXCEPTION(e);
+    }
 
-                auto statusIt = it->find(STATUS);
-                if (statusIt != it->end())
-                {
-                    entry->setStatus(statusIt->second);
-                }
+    return Entries::Ptr();
+}
 
-                if (entry->getStatus() == Entry::Status::NORMAL && condition->process(entry))
-                {
-                    entry->setDirty(false);
-                    entries->addEntry(entry);
-                }
+vector<Entries::Ptr> RocksDBStorage::batchSelect(
+    h256, int64_t, TableInfo::Ptr tableInfo, const vector<string>& keys)
+{
+    try
+    {
+        vector<string> entryKeys;
+        entryKeys.reserve(keys.size());
+        for (auto& key : keys)
+        {
+            entryKeys.push_back(tableInfo->name + "_" + key);
+        }
+
+        vector<Slice> slices(entryKeys.begin(), entryKeys.end());
+        vector<ColumnFamilyHandle*> handles(slices.size(), columnFamily(tableInfo->name));
+        vector<string> values;
+        auto status = m_db->MultiGet(ReadOptions(), handles, slices, &values);
+
+        vector<Entries::Ptr> result;
+        result.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            auto& s = status[i];
+            if (!s.ok() && !s.IsNotFound())
+            {
+                STORAGE_ROCKSDB_LOG(ERROR)
+                    << LOG_DESC("Batch query rocksdb failed") << LOG_KV("status", s.ToString());
+
+                BOOST_THROW_EXCEPTION(
+                    StorageException(-1, "Query rocksdb exception:" + s.ToString()));
+            }
+
+            if (s.IsNotFound())
+            {
+                result.push_back(make_shared<Entries>());
+            }
+            else
+            {
+                result.push_back(
+                    decodeEntries(values[i].data(), values[i].size(), Condition::Ptr()));
             }
         }
 
-        return entries;
+        return result;
     }
     catch (exception& e)
     {
-        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Query rocksdb exception")
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Batch query rocksdb exception")
                                    << LOG_KV("msg", boost::diagnostic_information(e));
 
         BOOST_THROW_EXCEPTION(e);
     }
 
-    return Entries::Ptr();
+    return vector<Entries::Ptr>();
 }
 
-size_t RocksDBStorage::commit(h256 hash, int64_t num, const vector<TableData::Ptr>& datas)
+string RocksDBStorage::encodeRows(const vector<map<string, string>>& rows) const
 {
-    try
+    auto value = RowCodec::encode(rows);
+    if (m_dataKey.empty())
     {
-        auto start_time = utcTime();
+        return value;
+    }
+    return asString(aesCBCEncrypt(
+        bytesConstRef((const unsigned char*)value.data(), value.size()), ref(m_dataKey)));
+}
 
-        auto hex = hash.hex();
-        WriteBatch batch;
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, datas.size()),
-            [&](const tbb::blocked_range<size_t>& range) {
-                for (size_t i = range.begin(); i < range.end(); ++i)
-                {
-                    shared_ptr<map<string, vector<map<string, string>>>> key2value =
-                        make_shared<map<string, vector<map<string, string>>>>();
+vector<map<string, string>> RocksDBStorage::decodeRows(const char* data, size_t size) const
+{
+    if (m_dataKey.empty())
+    {
+        return RowCodec::decodeRows(data, size);
+    }
+    return RowCodec::decodeRows(
+        asString(aesCBCDecrypt(bytesConstRef((const unsigned char*)data, size), ref(m_dataKey))));
+}
+
+Entries::Ptr RocksDBStorage::decodeEntries(
+    const char* data, size_t size, Condition::Ptr condition)
+{
+    Entries::Ptr entries = make_shared<Entries>();
+
+    vector<Entry::Ptr> decoded;
+    if (m_dataKey.empty())
+    {
+        decoded = RowCodec::decodeEntries(data, size);
+    }
+    else
+    {
+        auto value = asString(
+            aesCBCDecrypt(bytesConstRef((const unsigned char*)data, size), ref(m_dataKey)));
+        decoded = RowCodec::decodeEntries(value.data(), value.size());
+    }
 
-                    auto tableInfo = datas[i]->info;
+    for (auto& entry : decoded)
+    {
+        if (entry->getStatus() == Entry::Status::NORMAL &&
+            (!condition || condition->process(entry)))
+        {
+            entry->setDirty(false);
+            entries->addEntry(entry);
+        }
+    }
+
+    return entries;
+}
+
+Entry::Ptr RocksDBStorage::decodeEntry(const map<string, string>& row)
+{
+    Entry::Ptr entry = make_shared<Entry>();
+    for (auto valueIt = row.begin(); valueIt != row.end(); ++valueIt)
+    {
+        entry->setField(valueIt->first, valueIt->second);
+    }
+    entry->setID(row.at(ID_FIELD));
+    entry->setNum(row.at(NUM_FIELD));
+
+    auto statusIt = row.find(STATUS);
+    if (statusIt != row.end())
+    {
+        entry->setStatus(statusIt->second);
+    }
+    return entry;
+}
+
+void RocksDBStorage::encode(int64_t num, const vector<TableData::Ptr>& datas,
+    function<void(ColumnFamilyHandle*, string&&, string&&)> put)
+{
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, datas.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                shared_ptr<map<string, vector<map<string, string>>>> key2value =
+                    make_shared<map<string, vector<map<string, string>>>>();
 
-                    processDirtyEntries(num, key2value, tableInfo, datas[i]->dirtyEntries);
-                    processNewEntries(num, key2value, tableInfo, datas[i]->newEntries);
+                auto tableInfo = datas[i]->info;
+                auto handle = columnFamily(tableInfo->name);
 
-                    for (auto it : *key2value)
+                processDirtyEntries(num, key2value, tableInfo, datas[i]->dirtyEntries);
+                processNewEntries(num, key2value, tableInfo, datas[i]->newEntries);
+
+                for (auto it : *key2value)
+                {
+                    string entryKey = tableInfo->name + "_" + it.first;
+                    auto value = encodeRows(it.second);
                     {
-                        string entryKey = tableInfo->name + "_" + it.first;
-                        stringstream ss;
-                        boost::archive::binary_oarchive oa(ss);
-                        oa << it.second;
-                        {
-                            tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-                            batch.Put(Slice(std::move(entryKey)), Slice(ss.str()));
-                        }
+                        tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
+                        put(handle, std::move(entryKey), std::move(value));
                     }
                 }
-            });
+            }
+        });
+}
+
+size_t RocksDBStorage::commit(h256 hash, int64_t num, const vector<TableData::Ptr>& datas)
+{
+    try
+    {
+        lock_guard<mutex> lock(m_commitMutex);
+        if (m_bulkLoad)
+        {
+            commitSst(num, datas);
+            return datas.size();
+        }
+
+        auto start_time = utcTime();
+
+        auto hex = hash.hex();
+        WriteBatch batch;
+        encode(num, datas, [&batch](ColumnFamilyHandle* handle, string&& key, string&& value) {
+            batch.Put(handle, Slice(key), Slice(value));
+        });
         auto encode_time_cost = utcTime();
 
         WriteOptions options;
@@ -166,6 +289,339 @@ size_t RocksDBStorage::commit(h256 hash, int64_t num, const vector<TableData::Pt
     return 0;
 }
 
+void RocksDBStorage::commitSst(int64_t num, const vector<TableData::Ptr>& datas)
+{
+    auto start_time = utcTime();
+    // the keys of a sst file must be sorted, a file is built for each column family
+    map<ColumnFamilyHandle*, map<string, string>> families;
+    encode(num, datas, [&families](ColumnFamilyHandle* handle, string&& key, string&& value) {
+        families[handle][std::move(key)] = std::move(value);
+    });
+    auto encode_time_cost = utcTime();
+
+    size_t keys = 0;
+    for (auto& family : families)
+    {
+        auto file = m_sstPath + "/" + to_string(num) + "_" + family.first->GetName() + ".sst";
+        SstFileWriter writer(EnvOptions(), m_db->GetOptions(family.first), family.first);
+        auto s = writer.Open(file);
+        for (auto it = family.second.begin(); s.ok() && it != family.second.end(); ++it)
+        {
+            s = writer.Put(Slice(it->first), Slice(it->second));
+        }
+        if (s.ok())
+        {
+            s = writer.Finish();
+        }
+        if (s.ok())
+        {
+            // the file becomes a part of the db, it doesn't go through the memtable and the WAL
+            IngestExternalFileOptions options;
+            options.move_files = true;
+            s = m_db->IngestExternalFile(family.first, {file}, options);
+        }
+        if (!s.ok())
+        {
+            STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Ingest sst failed") << LOG_KV("file", file)
+                                       << LOG_KV("status", s.ToString());
+            boost::filesystem::remove(file);
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Ingest sst exception:" + s.ToString()));
+        }
+        keys += family.second.size();
+    }
+
+    STORAGE_ROCKSDB_LOG(DEBUG) << LOG_BADGE("Commit") << LOG_DESC("Ingest sst")
+                               << LOG_KV("num", num) << LOG_KV("keys", keys)
+                               << LOG_KV("files", families.size())
+                               << LOG_KV("encodeTimeCost", encode_time_cost - start_time)
+                               << LOG_KV("totalTimeCost", utcTime() - start_time);
+}
+
+void RocksDBStorage::setBulkLoad(bool bulkLoad)
+{
+    lock_guard<mutex> lock(m_commitMutex);
+    if (bulkLoad == m_bulkLoad)
+    {
+        return;
+    }
+    if (bulkLoad)
+    {
+        boost::filesystem::create_directories(m_sstPath);
+        m_bulkLoad = true;
+        STORAGE_ROCKSDB_LOG(INFO) << LOG_BADGE("BulkLoad") << LOG_DESC("start")
+                                  << LOG_KV("sstPath", m_sstPath);
+        return;
+    }
+
+    m_bulkLoad = false;
+    if (m_checkpointPath.empty())
+    {
+        return;
+    }
+    // the memtables are flushed by the checkpoint, it is a consistent copy of the db loaded
+    Checkpoint* checkpoint = nullptr;
+    auto s = Checkpoint::Create(m_db.get(), &checkpoint);
+    if (s.ok())
+    {
+        unique_ptr<Checkpoint> holder(checkpoint);
+        boost::filesystem::remove_all(m_checkpointPath);
+        s = checkpoint->CreateCheckpoint(m_checkpointPath, 0);
+    }
+    STORAGE_ROCKSDB_LOG(INFO) << LOG_BADGE("BulkLoad") << LOG_DESC("stop")
+                              << LOG_KV("checkpointPath", m_checkpointPath)
+                              << LOG_KV("status", s.ToString());
+}
+
+namespace
+{
+/// move the iterator past the keys of the other tables under the prefix of a table
+void skipExtending(rocksdb::Iterator* it, const vector<string>& others)
+{
+    while (it->Valid())
+    {
+        auto key = it->key();
+        auto other = find_if(others.begin(), others.end(),
+            [&](const string& prefix) { return key.starts_with(Slice(prefix)); });
+        if (other == others.end())
+        {
+            return;
+        }
+        // '`' follows '_', the keys of the other table are all before <other>`
+        it->Seek(Slice(other->substr(0, other->size() - 1) + "`"));
+    }
+}
+}  // namespace
+
+class RocksDBStorage::ScanIterator : public StorageIterator
+{
+public:
+    ScanIterator(RocksDBStorage::Ptr storage, TableInfo::Ptr tableInfo, const string& begin,
+        const string& end, size_t batchSize)
+      : m_storage(storage),
+        m_prefix(tableInfo->name + "_"),
+        m_end(end),
+        m_batchSize(max(batchSize, (size_t)1))
+    {
+        ReadOptions options;
+        // the prefix extractor of a column family may cover only a part of the table prefix
+        options.total_order_seek = true;
+        options.fill_cache = false;
+        m_it.reset(
+            m_storage->m_db->NewIterator(options, m_storage->columnFamily(tableInfo->name)));
+        // listed once the view of the iterator is taken, a table created later has no rows in it
+        m_others = m_storage->extendingPrefixes(tableInfo->name);
+        m_it->Seek(Slice(m_prefix + begin));
+        skipExtending(m_it.get(), m_others);
+    }
+
+    bool next(Batch& batch) override
+    {
+        batch.clear();
+        for (; m_it->Valid() && batch.size() < m_batchSize;
+             m_it->Next(), skipExtending(m_it.get(), m_others))
+        {
+            auto entryKey = m_it->key();
+            if (!entryKey.starts_with(Slice(m_prefix)))
+            {
+                break;
+            }
+
+            string key(entryKey.data() + m_prefix.size(), entryKey.size() - m_prefix.size());
+            if (!m_end.empty() && key >= m_end)
+            {
+                break;
+            }
+
+            auto entries = m_storage->decodeEntries(
+                m_it->value().data(), m_it->value().size(), Condition::Ptr());
+            if (entries->size() > 0)
+            {
+                batch.emplace_back(std::move(key), entries);
+            }
+        }
+
+        if (!m_it->status().ok())
+        {
+            STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Scan rocksdb failed")
+                                       << LOG_KV("status", m_it->status().ToString());
+
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "Scan rocksdb exception:" + m_it->status().ToString()));
+        }
+
+        return !batch.empty();
+    }
+
+private:
+    // the iterator must be released before the db
+    RocksDBStorage::Ptr m_storage;
+    unique_ptr<rocksdb::Iterator> m_it;
+    string m_prefix;
+    vector<string> m_others;
+    string m_end;
+    size_t m_batchSize;
+};
+
+vector<string> RocksDBStorage::extendingPrefixes(const string& tableName)
+{
+    // the tables are listed in _sys_tables_ by their names, those named <tableName>_<suffix> in
+    // the same column family keep their keys under the prefix of the table
+    auto handle = columnFamily(tableName);
+    string tables = SYS_TABLES + "_" + tableName + "_";
+    ReadOptions options;
+    options.total_order_seek = true;
+    options.fill_cache = false;
+    unique_ptr<rocksdb::Iterator> it(m_db->NewIterator(options, columnFamily(SYS_TABLES)));
+    vector<string> prefixes;
+    for (it->Seek(Slice(tables)); it->Valid() && it->key().starts_with(Slice(tables)); it->Next())
+    {
+        auto name = it->key().ToString().substr(SYS_TABLES.size() + 1);
+        if (columnFamily(name) == handle)
+        {
+            prefixes.push_back(name + "_");
+        }
+    }
+    return prefixes;
+}
+
+StorageIterator::Ptr RocksDBStorage::scan(
+    TableInfo::Ptr tableInfo, const string& begin, const string& end, size_t batchSize)
+{
+    return make_shared<ScanIterator>(
+        static_pointer_cast<RocksDBStorage>(shared_from_this()), tableInfo, begin, end, batchSize);
+}
+
+void RocksDBStorage::remove(TableInfo::Ptr tableInfo, const vector<string>& keys)
+{
+    auto handle = columnFamily(tableInfo->name);
+    WriteBatch batch;
+    for (auto& key : keys)
+    {
+        batch.Delete(handle, Slice(tableInfo->name + "_" + key));
+    }
+
+    WriteOptions options;
+    options.sync = false;
+    // the memtables are flushed once the bulk load ends
+    options.disableWAL = m_bulkLoad;
+    auto s = m_db->Write(options, &batch);
+    if (!s.ok())
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Remove rocksdb failed")
+                                   << LOG_KV("table", tableInfo->name)
+                                   << LOG_KV("status", s.ToString());
+
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Remove rocksdb exception:" + s.ToString()));
+    }
+}
+
+bool RocksDBStorage::prune(TableInfo::Ptr tableInfo, string& key, int64_t num, size_t maxKeys,
+    StorageIterator::Batch& pruned)
+{
+    // a commit between the read and the write of a key here would be overwritten
+    unique_lock<mutex> lock(m_commitMutex, try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return false;
+    }
+
+    auto handle = columnFamily(tableInfo->name);
+    string prefix = tableInfo->name + "_";
+    ReadOptions options;
+    options.total_order_seek = true;
+    options.fill_cache = false;
+    unique_ptr<rocksdb::Iterator> it(m_db->NewIterator(options, handle));
+    auto others = extendingPrefixes(tableInfo->name);
+    WriteBatch batch;
+    size_t keys = 0;
+    for (it->Seek(Slice(prefix + key)), skipExtending(it.get(), others);
+         it->Valid() && it->key().starts_with(Slice(prefix)) && keys < maxKeys;
+         it->Next(), skipExtending(it.get(), others), ++keys)
+    {
+        auto rows = decodeRows(it->value().data(), it->value().size());
+
+        vector<map<string, string>> kept;
+        auto entries = make_shared<Entries>();
+        for (auto& row : rows)
+        {
+            auto entry = decodeEntry(row);
+            if (entry->getStatus() == Entry::Status::DELETED && (int64_t)entry->num() < num)
+            {
+                entries->addEntry(entry);
+            }
+            else
+            {
+                kept.push_back(row);
+            }
+        }
+        if (entries->size() == 0)
+        {
+            continue;
+        }
+
+        if (kept.empty())
+        {
+            batch.Delete(handle, it->key());
+        }
+        else
+        {
+            batch.Put(handle, it->key(), Slice(encodeRows(kept)));
+        }
+        pruned.emplace_back(it->key().ToString().substr(prefix.size()), entries);
+    }
+
+    if (!it->status().ok())
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Prune rocksdb failed")
+                                   << LOG_KV("status", it->status().ToString());
+
+        BOOST_THROW_EXCEPTION(
+            StorageException(-1, "Prune rocksdb exception:" + it->status().ToString()));
+    }
+
+    string next;
+    if (it->Valid() && it->key().starts_with(Slice(prefix)))
+    {
+        next = it->key().ToString().substr(prefix.size());
+    }
+
+    WriteOptions writeOptions;
+    writeOptions.sync = false;
+    writeOptions.disableWAL = m_bulkLoad;
+    auto s = m_db->Write(writeOptions, &batch);
+    if (!s.ok())
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Prune rocksdb failed")
+                                   << LOG_KV("table", tableInfo->name)
+                                   << LOG_KV("status", s.ToString());
+
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Prune rocksdb exception:" + s.ToString()));
+    }
+    key = next;
+    return true;
+}
+
+int64_t RocksDBStorage::checkpoint(const string& path)
+{
+    auto start = utcTime();
+    Checkpoint* checkpoint = nullptr;
+    auto s = Checkpoint::Create(m_db.get(), &checkpoint);
+    if (s.ok())
+    {
+        unique_ptr<Checkpoint> holder(checkpoint);
+        s = checkpoint->CreateCheckpoint(path, 0);
+    }
+    if (!s.ok())
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Create checkpoint failed") << LOG_KV("path", path)
+                                   << LOG_KV("status", s.ToString());
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Create checkpoint failed: " + s.ToString()));
+    }
+    STORAGE_ROCKSDB_LOG(INFO) << LOG_BADGE("Checkpoint") << LOG_KV("path", path)
+                              << LOG_KV("timecost", utcTime() - start);
+    return -1;
+}
+
 bool RocksDBStorage::onlyDirty()
 {
     return false;
@@ -176,6 +632,59 @@ void RocksDBStorage::setDB(shared_ptr<rocksdb::DB> db)
     m_db = db;
 }
 
+void RocksDBStorage::setColumnFamilies(const vector<ColumnFamilyHandle*>& handles)
+{
+    m_handles = handles;
+    for (auto handle : handles)
+    {
+        m_columnFamilies[handle->GetName()] = handle;
+    }
+}
+
+string RocksDBStorage::columnFamilyName(const string& tableName)
+{
+    if (tableName.compare(0, CONTRACT_TABLE_PREFIX.size(), CONTRACT_TABLE_PREFIX) == 0)
+    {
+        return CONTRACT_TABLE_PREFIX;
+    }
+
+    auto& names = columnFamilyNames();
+    if (find(names.begin(), names.end(), tableName) != names.end())
+    {
+        return tableName;
+    }
+
+    return kDefaultColumnFamilyName;
+}
+
+const vector<string>& RocksDBStorage::columnFamilyNames()
+{
+    static const vector<string> names{SYS_HASH_2_BLOCK, SYS_NUMBER_2_HASH, SYS_TX_HASH_2_BLOCK,
+        SYS_BLOCK_2_NONCES, CONTRACT_TABLE_PREFIX};
+    return names;
+}
+
+bool RocksDBStorage::isAppendOnly(const string& columnFamilyName)
+{
+    return columnFamilyName == SYS_HASH_2_BLOCK || columnFamilyName == SYS_NUMBER_2_HASH ||
+           columnFamilyName == SYS_TX_HASH_2_BLOCK || columnFamilyName == SYS_BLOCK_2_NONCES;
+}
+
+ColumnFamilyHandle* RocksDBStorage::columnFamily(const string& tableName)
+{
+    if (m_columnFamilies.empty())
+    {
+        return m_db->DefaultColumnFamily();
+    }
+
+    auto it = m_columnFamilies.find(columnFamilyName(tableName));
+    if (it == m_columnFamilies.end())
+    {
+        return m_db->DefaultColumnFamily();
+    }
+    return it->second;
+}
+
 void RocksDBStorage::processNewEntries(int64_t num,
     shared_ptr<map<string, vector<map<string, string>>>> key2value, TableInfo::Ptr tableInfo,
     Entries::Ptr entries)
@@ -199,7 +708,8 @@ void RocksDBStorage::processNewEntries(int64_t num,
                 entryKey.append("_").append(key);
 
                 string value;
-                auto s = m_db->Get(ReadOptions(), Slice(std::move(entryKey)), &value);
+                auto s = m_db->Get(ReadOptions(), columnFamily(tableInfo->name),
+                    Slice(std::move(entryKey)), &value);
                 if (!s.ok() && !s.IsNotFound())
                 {
                     STORAGE_ROCKSDB_LOG(ERROR)
@@ -215,11 +725,7 @@ void RocksDBStorage::processNewEntries(int64_t num,
                 }
                 else
                 {
-                    vector<map<string, string>> res;
-                    stringstream ss(value);
-                    boost::archive::binary_iarchive ia(ss);
-                    ia >> res;
-                    it = key2value->emplace(key, res).first;
+                    it = key2value->emplace(key, decodeRows(value.data(), value.size())).first;
                 }
             }
         }
@@ -25,11 +25,15 @@
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
 #include <tbb/spin_mutex.h>
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
 
 namespace rocksdb
 {
 class DB;
+class ColumnFamilyHandle;
 }
 namespace dev
 {
@@ -40,16 +44,71 @@ class RocksDBStorage : public Storage
 public:
     typedef std::shared_ptr<RocksDBStorage> Ptr;
 
-    virtual ~RocksDBStorage(){};
+    virtual ~RocksDBStorage();
 
     Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
     size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    // iterates a consistent view of the db taken when called, the keys of the tables named
+    // <table>_<suffix> share the prefix of the table and are skipped, as are the keys of the
+    // table itself that start with <suffix>_
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
+    void remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys) override;
+    bool prune(TableInfo::Ptr tableInfo, std::string& key, int64_t num, size_t maxKeys,
+        StorageIterator::Batch& pruned) override;
+    /// hard links the sst files of all column families and flushes the memtables into path, the
+    /// commits go on meanwhile and are either wholly in the copy or not at all
+    int64_t checkpoint(const std::string& path) override;
     bool onlyDirty() override;
 
     void setDB(std::shared_ptr<rocksdb::DB> db);
+    /// in bulk load each commit is built into sorted sst files ingested by the db, instead of
+    /// going through the memtable and the WAL, for the blocks merged by the cache while a node
+    /// catches up or imports, a checkpoint of the db is taken at checkpointPath once it ends
+    void setBulkLoad(bool bulkLoad);
+    bool bulkLoad() const { return m_bulkLoad; }
+    /// the sst files are built in sstPath, the checkpoint is skipped if checkpointPath is empty
+    void setBulkLoadPath(const std::string& sstPath, const std::string& checkpointPath)
+    {
+        m_sstPath = sstPath;
+        m_checkpointPath = checkpointPath;
+    }
+    /// take the handles returned by opening the db with column families, tables are placed by
+    /// columnFamilyName, the handles are released with the storage
+    void setColumnFamilies(const std::vector<rocksdb::ColumnFamilyHandle*>& handles);
+    /// the values are encrypted with the data key of the disk encryption if it's not empty, on
+    /// the threads encoding the commit
+    void setDataKey(const dev::bytes& dataKey) { m_dataKey = dataKey; }
+
+    /// column family of the table, the default family hosts tables without a family of their own
+    static std::string columnFamilyName(const std::string& tableName);
+    /// column families besides the default one
+    static const std::vector<std::string>& columnFamilyNames();
+    /// block tables, only appended and never updated
+    static bool isAppendOnly(const std::string& columnFamilyName);
 
 private:
+    class ScanIterator;
+
+    rocksdb::ColumnFamilyHandle* columnFamily(const std::string& tableName);
+    /// the key prefixes of the tables in _sys_tables_ named <tableName>_<suffix> in its family
+    std::vector<std::string> extendingPrefixes(const std::string& tableName);
+
+    /// encode the rows of the keys committed, put is called for each key under a lock
+    void encode(int64_t num, const std::vector<TableData::Ptr>& datas,
+        std::function<void(rocksdb::ColumnFamilyHandle*, std::string&&, std::string&&)> put);
+    void commitSst(int64_t num, const std::vector<TableData::Ptr>& datas);
+
+    std::string encodeRows(const std::vector<std::map<std::string, std::string>>& rows) const;
+    /// the values are decoded from the buffers of the db, they are copied only to be decrypted
+    std::vector<std::map<std::string, std::string>> decodeRows(
+        const char* data, size_t size) const;
+    Entries::Ptr decodeEntries(const char* data, size_t size, Condition::Ptr condition);
+    static Entry::Ptr decodeEntry(const std::map<std::string, std::string>& row);
+
     void processNewEntries(int64_t num,
         std::shared_ptr<std::map<std::string, std::vector<std::map<std::string, std::string>>>>
             key2value,
@@ -61,7 +120,15 @@ private:
         TableInfo::Ptr tableInfo, Entries::Ptr entries);
 
     std::shared_ptr<rocksdb::DB> m_db;
+    std::vector<rocksdb::ColumnFamilyHandle*> m_handles;
+    std::map<std::string, rocksdb::ColumnFamilyHandle*> m_columnFamilies;
     tbb::spin_mutex m_writeBatchMutex;
+    // serializes the commits with the rewrites of prune
+    std::mutex m_commitMutex;
+    std::atomic<bool> m_bulkLoad = {false};
+    std::string m_sstPath;
+    std::string m_checkpointPath;
+    dev::bytes m_dataKey;
 };
 
 }  // namespace storage
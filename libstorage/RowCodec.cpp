@@ -0,0 +1,306 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : encoding of the rows of a key in the key-value storages
+ *
+ * @file: RowCodec.cpp
+ */
+
+#include "RowCodec.h"
+#include "StorageException.h"
+#include "boost/archive/binary_iarchive.hpp"
+#include "boost/serialization/map.hpp"
+#include "boost/serialization/serialization.hpp"
+#include "boost/serialization/vector.hpp"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+void fail(const string& reason)
+{
+    BOOST_THROW_EXCEPTION(StorageException(-1, "Invalid row encoding: " + reason));
+}
+
+void putSize(string& out, uint64_t size)
+{
+    while (size >= 0x80)
+    {
+        out.push_back((char)(size | 0x80));
+        size >>= 7;
+    }
+    out.push_back((char)size);
+}
+
+void putString(string& out, const string& value)
+{
+    putSize(out, value.size());
+    out.append(value);
+}
+
+class Reader
+{
+public:
+    Reader(const char* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    uint64_t size()
+    {
+        uint64_t size = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (m_pos == m_end)
+            {
+                fail("truncated");
+            }
+            uint8_t b = (uint8_t)*m_pos++;
+            size |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+            {
+                return size;
+            }
+        }
+        fail("size overflow");
+        return 0;
+    }
+
+    /// a count of items of at least a byte each, so that a corrupted count can't reserve more
+    /// than the value holds
+    size_t count()
+    {
+        auto count = size();
+        if (count > (uint64_t)(m_end - m_pos))
+        {
+            fail("count beyond the value");
+        }
+        return (size_t)count;
+    }
+
+    string str()
+    {
+        auto length = size();
+        if (length > (uint64_t)(m_end - m_pos))
+        {
+            fail("truncated");
+        }
+        string value(m_pos, (size_t)length);
+        m_pos += length;
+        return value;
+    }
+
+    void skip(size_t length) { m_pos += length; }
+    bool done() const { return m_pos == m_end; }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+/// the column index of each field of a row, in the order of the columns
+template <class OnField>
+void readRow(Reader& reader, const vector<string>& columns, OnField onField)
+{
+    auto header = reader.size();
+    size_t fields = (size_t)(header >> 1);
+    if (fields > columns.size())
+    {
+        fail("more fields than columns");
+    }
+    if (header & 1)
+    {
+        if (fields != columns.size())
+        {
+            fail("a full row without every column");
+        }
+        for (size_t i = 0; i < fields; ++i)
+        {
+            onField(i, reader.str());
+        }
+        return;
+    }
+    size_t next = 0;
+    for (size_t i = 0; i < fields; ++i)
+    {
+        auto index = reader.size();
+        if (index < next || index >= columns.size())
+        {
+            fail("column index out of order");
+        }
+        next = (size_t)index + 1;
+        onField((size_t)index, reader.str());
+    }
+}
+
+/// the columns after the header, the value is in this encoding
+vector<string> readColumns(Reader& reader)
+{
+    reader.skip(1);
+    if (reader.size() != RowCodec::c_version)
+    {
+        fail("unknown version");
+    }
+    vector<string> columns(reader.count());
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        columns[i] = reader.str();
+        if (i > 0 && columns[i] <= columns[i - 1])
+        {
+            fail("columns out of order");
+        }
+    }
+    return columns;
+}
+
+RowCodec::Rows decodeArchive(const char* data, size_t size)
+{
+    RowCodec::Rows rows;
+    stringstream ss(string(data, size));
+    boost::archive::binary_iarchive ia(ss);
+    ia >> rows;
+    return rows;
+}
+
+Entry::Ptr makeEntry(Entry::Fields&& fields)
+{
+    auto entry = make_shared<Entry>();
+    entry->setFields(std::move(fields));
+    auto id = entry->find(ID_FIELD);
+    auto num = entry->find(NUM_FIELD);
+    if (id == entry->end() || num == entry->end())
+    {
+        fail("a row without id or num");
+    }
+    entry->setID(id->second);
+    entry->setNum(num->second);
+    auto status = entry->find(STATUS);
+    if (status != entry->end())
+    {
+        entry->setStatus(status->second);
+    }
+    return entry;
+}
+}  // namespace
+
+string RowCodec::encode(const Rows& rows)
+{
+    // the rows of a key share their columns, each name is written once
+    map<string, size_t> columnIndex;
+    size_t bytes = 2;
+    for (auto& row : rows)
+    {
+        for (auto& field : row)
+        {
+            columnIndex.emplace(field.first, 0);
+            bytes += field.second.size() + 2;
+        }
+    }
+    size_t index = 0;
+    for (auto& column : columnIndex)
+    {
+        column.second = index++;
+        bytes += column.first.size() + 1;
+    }
+
+    string out;
+    out.reserve(bytes);
+    out.push_back((char)c_magic);
+    putSize(out, c_version);
+    putSize(out, columnIndex.size());
+    for (auto& column : columnIndex)
+    {
+        putString(out, column.first);
+    }
+    putSize(out, rows.size());
+    for (auto& row : rows)
+    {
+        if (row.size() == columnIndex.size())
+        {
+            putSize(out, (row.size() << 1) | 1);
+            for (auto& field : row)
+            {
+                putString(out, field.second);
+            }
+            continue;
+        }
+        putSize(out, row.size() << 1);
+        for (auto& field : row)
+        {
+            putSize(out, columnIndex[field.first]);
+            putString(out, field.second);
+        }
+    }
+    return out;
+}
+
+RowCodec::Rows RowCodec::decodeRows(const char* data, size_t size)
+{
+    if (isArchive(data, size))
+    {
+        return decodeArchive(data, size);
+    }
+
+    Reader reader(data, size);
+    auto columns = readColumns(reader);
+    Rows rows(reader.count());
+    for (auto& row : rows)
+    {
+        readRow(reader, columns, [&](size_t index, string&& value) {
+            row.emplace_hint(row.end(), columns[index], std::move(value));
+        });
+    }
+    if (!reader.done())
+    {
+        fail("trailing bytes");
+    }
+    return rows;
+}
+
+vector<Entry::Ptr> RowCodec::decodeEntries(const char* data, size_t size)
+{
+    vector<Entry::Ptr> entries;
+    if (isArchive(data, size))
+    {
+        auto rows = decodeArchive(data, size);
+        entries.reserve(rows.size());
+        for (auto& row : rows)
+        {
+            entries.push_back(makeEntry(Entry::Fields(row.begin(), row.end())));
+        }
+        return entries;
+    }
+
+    Reader reader(data, size);
+    auto columns = readColumns(reader);
+    entries.resize(reader.count());
+    for (auto& entry : entries)
+    {
+        Entry::Fields fields;
+        fields.reserve(columns.size());
+        readRow(reader, columns, [&](size_t index, string&& value) {
+            fields.emplace_back(columns[index], std::move(value));
+        });
+        entry = makeEntry(std::move(fields));
+    }
+    if (!reader.done())
+    {
+        fail("trailing bytes");
+    }
+    return entries;
+}
@@ -0,0 +1,66 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : encoding of the rows of a key in the key-value storages
+ *
+ * @file: RowCodec.h
+ */
+#pragma once
+
+#include "Table.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+/**
+ * @brief The rows of a key as the rocksdb and leveldb storages write them. A value starts with
+ * c_magic and the version, then the names of the columns of its rows sorted, each row refers to
+ * them by their index and length-prefixes its values. A row holding every column in order writes
+ * no index at all. The values written by boost::archive before are read as they are.
+ */
+class RowCodec
+{
+public:
+    typedef std::vector<std::map<std::string, std::string>> Rows;
+
+    /// the first byte of a value, an archive starts with the length of its signature
+    static const uint8_t c_magic = 0xfb;
+    static const uint8_t c_version = 1;
+
+    static std::string encode(const Rows& rows);
+    static Rows decodeRows(const char* data, size_t size);
+    static Rows decodeRows(const std::string& value)
+    {
+        return decodeRows(value.data(), value.size());
+    }
+    /// the entries of the rows with their id, num and status, the fields of an entry are
+    /// decoded in the order Entry keeps them instead of being inserted one by one
+    static std::vector<Entry::Ptr> decodeEntries(const char* data, size_t size);
+
+    /// the value is a boost::archive of the versions before this encoding
+    static bool isArchive(const char* data, size_t size)
+    {
+        return size < 2 || (uint8_t)data[0] != c_magic;
+    }
+};
+
+}  // namespace storage
+}  // namespace dev
@@ -21,14 +21,26 @@
 
 #include "SQLBasicAccess.h"
 #include "StorageException.h"
+#include <libdevcore/CommonData.h>
 #include <libdevcore/easylog.h>
+#include <tbb/atomic.h>
+#include <tbb/parallel_for.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <mutex>
 
 using namespace dev::storage;
 using namespace std;
 
+namespace
+{
+// the formatID of the xids of the branches of a block, "BCOS"
+const int c_xidFormat = 0x42434F53;
+}  // namespace
+
 int SQLBasicAccess::Select(h256 hash, int num, const std::string& _table, const std::string& key,
     Condition::Ptr condition, std::vector<std::string>& columns,
     std::vector<std::vector<std::string> >& valueList)
@@ -55,8 +67,7 @@ int SQLBasicAccess::Select(h256 hash, int num, const std::string& _table, const
     }
     TRY
     {
-        PreparedStatement_T _prepareStatement =
-            Connection_prepareStatement(conn, "%s", sql.c_str());
+        PreparedStatement_T _prepareStatement = m_connPool->GetStatement(conn, sql);
         if (condition)
         {
             uint32_t index = 0;
@@ -80,7 +91,10 @@ int SQLBasicAccess::Select(h256 hash, int num, const std::string& _table, const
             std::vector<std::string> value;
             for (int32_t index = 1; index <= columnCnt; ++index)
             {
-                value.push_back(ResultSet_getString(result, index));
+                /// the blobs may hold any byte, null included
+                int size = 0;
+                auto data = (const char*)ResultSet_getBlob(result, index, &size);
+                value.push_back(data ? std::string(data, size) : std::string());
             }
             valueList.push_back(value);
         }
@@ -88,6 +102,7 @@ int SQLBasicAccess::Select(h256 hash, int num, const std::string& _table, const
     CATCH(SQLException)
     {
         SQLBasicAccess_LOG(ERROR) << "select exception:" << Exception_frame.message;
+        m_connPool->DiscardStatements(conn);
         m_connPool->ReturnConnection(conn);
         return 0;
     }
@@ -186,7 +201,7 @@ std::string SQLBasicAccess::BuildCreateTableSql(
     {
         boost::algorithm::replace_all_copy(*it, "\\", "\\\\");
         boost::algorithm::replace_all_copy(*it, "`", "\\`");
-        ss << "`" << *it << "` text,\n";
+        ss << "`" << *it << "` " << (isBinaryField(tablename, *it) ? "longblob" : "text") << ",\n";
     }
     ss << " PRIMARY KEY( `_id_` ),\n";
     ss << " KEY(`" << keyfield << "`),\n";
@@ -327,61 +342,171 @@ int SQLBasicAccess::CommitDo(
     }
     END_TRY;
 
-    volatile int32_t rowCount = 0;
-    m_connPool->BeginTransaction(oConn);
-    TRY
+    if (m_commitConnections <= 1)
     {
-        for (auto it : datas)
-        {
-            auto tableInfo = it->info;
-            std::string strTableName = tableInfo->name;
-            std::vector<std::string> _fieldName;
-            std::vector<std::string> _fieldValue;
-            bool _hasGetField = false;
-
-            this->GetCommitFieldNameAndValue(
-                it->dirtyEntries, hash, strNum, _fieldName, _fieldValue, _hasGetField);
-            this->GetCommitFieldNameAndValue(
-                it->newEntries, hash, strNum, _fieldName, _fieldValue, _hasGetField);
-            /*build commit sql*/
-            std::vector<SQLPlaceHoldItem> sqlList =
-                this->BuildCommitSql(strTableName, _fieldName, _fieldValue);
-            auto itSql = sqlList.begin();
-            auto itValue = _fieldValue.begin();
-            for (; itSql != sqlList.end(); ++itSql)
-            {
-                SQLBasicAccess_LOG(DEBUG) << " commit hash:" << hash.hex() << " num:" << num
-                                          << " commit sql:" << itSql->sql;
+        int ret = CommitTables(oConn, hash, num, datas, errmsg);
+        m_connPool->ReturnConnection(oConn);
+        return ret;
+    }
 
-                PreparedStatement_T preSatement =
-                    Connection_prepareStatement(oConn, "%s", itSql->sql.c_str());
+    m_connPool->ReturnConnection(oConn);
+    return CommitParallel(hash, num, datas, errmsg);
+}
 
-                uint32_t index = 0;
+int SQLBasicAccess::CommitParallel(
+    h256 hash, int num, const std::vector<TableData::Ptr>& datas, string& errmsg)
+{
+    std::vector<TableData::Ptr> markers;
+    auto groups = PartitionTables(datas, m_commitConnections, markers);
+    SQLBasicAccess_LOG(DEBUG) << "parallel commit num:" << num << " groups:" << groups.size()
+                              << " markers:" << markers.size();
 
-                /*
-                    if not set string firstly
-                    need to move itValue to next
-                */
-                if (itValue != _fieldValue.begin() && itValue != _fieldValue.end())
+    if (groups.size() <= 1 || markers.empty())
+    {
+        // nothing to split, or no current state to decide the commit by
+        Connection_T conn = m_connPool->GetConnection();
+        if (conn == NULL)
+        {
+            errmsg = "get connection failed";
+            return -1;
+        }
+        int ret = CommitTables(conn, hash, num, datas, errmsg);
+        m_connPool->ReturnConnection(conn);
+        return ret;
+    }
+
+    /*
+        every group is a branch of an XA transaction prepared on a connection of its own, the
+        block is committed by the transaction of its current state and then its branches are,
+        the branches a crash leaves prepared are finished by RecoverCommits
+    */
+    std::vector<Connection_T> conns(groups.size(), NULL);
+    std::vector<std::string> xids(groups.size());
+    tbb::atomic<int32_t> rowCount;
+    rowCount = 0;
+    tbb::atomic<bool> failed;
+    failed = false;
+    std::mutex errmsgMutex;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                string groupErrmsg;
+                int ret = -1;
+                xids[i] = CommitXid(m_dbName, num, i);
+                Connection_T conn = m_connPool->GetConnection();
+                if (conn == NULL)
                 {
-                    ++itValue;
+                    groupErrmsg = "get connection failed";
                 }
-
-                for (; itValue != _fieldValue.end(); ++itValue)
+                else
                 {
-                    PreparedStatement_setString(preSatement, ++index, itValue->c_str());
-                    SQLBasicAccess_LOG(TRACE) << " index:" << index << " num:" << num
-                                              << " setString:" << itValue->c_str();
-                    if (index == itSql->placeHolerCnt)
+                    ret = PrepareTables(conn, xids[i], hash, num, groups[i], groupErrmsg);
+                    if (ret < 0)
+                    {
+                        m_connPool->ReturnConnection(conn);
+                    }
+                    else
                     {
-                        PreparedStatement_execute(preSatement);
-                        rowCount += (int32_t)PreparedStatement_rowsChanged(preSatement);
-                        break;
+                        conns[i] = conn;
                     }
                 }
+
+                if (ret < 0)
+                {
+                    failed = true;
+                    std::lock_guard<std::mutex> lock(errmsgMutex);
+                    errmsg = groupErrmsg;
+                }
+                else
+                {
+                    rowCount += ret;
+                }
             }
+        });
+
+    int ret = -1;
+    if (!failed)
+    {
+        Connection_T conn = m_connPool->GetConnection();
+        if (conn == NULL)
+        {
+            errmsg = "get connection failed";
+        }
+        else
+        {
+            ret = CommitTables(conn, hash, num, markers, errmsg);
+            m_connPool->ReturnConnection(conn);
         }
     }
+
+    // the prepared branches follow the decision of the current state
+    for (size_t i = 0; i < conns.size(); ++i)
+    {
+        if (conns[i] != NULL)
+        {
+            if (!EndBranch(conns[i], xids[i], ret >= 0))
+            {
+                m_connPool->DiscardStatements(conns[i]);
+            }
+            m_connPool->ReturnConnection(conns[i]);
+        }
+    }
+
+    if (ret < 0)
+    {
+        SQLBasicAccess_LOG(ERROR) << "parallel commit failed num:" << num << " errmsg:" << errmsg;
+        return -1;
+    }
+    return rowCount + ret;
+}
+
+std::vector<std::vector<TableData::Ptr> > SQLBasicAccess::PartitionTables(
+    const std::vector<TableData::Ptr>& _datas, uint32_t _parts,
+    std::vector<TableData::Ptr>& _markers)
+{
+    std::vector<std::pair<size_t, TableData::Ptr> > tables;
+    for (auto it : _datas)
+    {
+        if (it->info->name == SYS_CURRENT_STATE)
+        {
+            _markers.push_back(it);
+        }
+        else
+        {
+            tables.push_back(
+                std::make_pair(it->dirtyEntries->size() + it->newEntries->size(), it));
+        }
+    }
+
+    // the largest tables first, each to the group with the fewest rows
+    std::stable_sort(tables.begin(), tables.end(),
+        [](const std::pair<size_t, TableData::Ptr>& lhs,
+            const std::pair<size_t, TableData::Ptr>& rhs) { return lhs.first > rhs.first; });
+
+    std::vector<std::vector<TableData::Ptr> > groups(
+        std::max<size_t>(1, std::min<size_t>(_parts, tables.size())));
+    std::vector<size_t> groupRows(groups.size(), 0);
+    for (auto& it : tables)
+    {
+        size_t index = std::min_element(groupRows.begin(), groupRows.end()) - groupRows.begin();
+        groups[index].push_back(it.second);
+        groupRows[index] += it.first;
+    }
+
+    if (tables.empty())
+    {
+        groups.clear();
+    }
+    return groups;
+}
+
+int SQLBasicAccess::CommitTables(Connection_T oConn, h256 hash, int num,
+    const std::vector<TableData::Ptr>& datas, string& errmsg)
+{
+    volatile int32_t rowCount = 0;
+    m_connPool->BeginTransaction(oConn);
+    TRY { rowCount = WriteTables(oConn, hash, num, datas); }
     CATCH(SQLException)
     {
         errmsg = Exception_frame.message;
@@ -390,7 +515,7 @@ int SQLBasicAccess::CommitDo(
                                   << " max connetions:" << m_connPool->GetMaxConnections()
                                   << " now connections:" << m_connPool->GetTotalConnections();
         m_connPool->RollBack(oConn);
-        m_connPool->ReturnConnection(oConn);
+        m_connPool->DiscardStatements(oConn);
         return -1;
     }
     END_TRY;
@@ -399,10 +524,201 @@ int SQLBasicAccess::CommitDo(
                              << m_connPool->GetActiveConnections()
                              << " max connections:" << m_connPool->GetMaxConnections();
     m_connPool->Commit(oConn);
-    m_connPool->ReturnConnection(oConn);
     return rowCount;
 }
 
+int SQLBasicAccess::PrepareTables(Connection_T conn, const std::string& xid, h256 hash, int num,
+    const std::vector<TableData::Ptr>& datas, string& errmsg)
+{
+    volatile int32_t rowCount = 0;
+    volatile bool started = false;
+    TRY
+    {
+        Connection_execute(conn, "XA START %s", xid.c_str());
+        started = true;
+        rowCount = WriteTables(conn, hash, num, datas);
+        Connection_execute(conn, "XA END %s", xid.c_str());
+        Connection_execute(conn, "XA PREPARE %s", xid.c_str());
+    }
+    CATCH(SQLException)
+    {
+        errmsg = Exception_frame.message;
+        SQLBasicAccess_LOG(ERROR) << "prepare data exception:" << errmsg << " xid:" << xid;
+        if (started)
+        {
+            // the branch may still be active
+            TRY { Connection_execute(conn, "XA END %s", xid.c_str()); }
+            CATCH(SQLException) {}
+            END_TRY;
+            EndBranch(conn, xid, false);
+        }
+        m_connPool->DiscardStatements(conn);
+        return -1;
+    }
+    END_TRY;
+    return rowCount;
+}
+
+bool SQLBasicAccess::EndBranch(Connection_T conn, const std::string& xid, bool commit)
+{
+    TRY { Connection_execute(conn, "XA %s %s", commit ? "COMMIT" : "ROLLBACK", xid.c_str()); }
+    CATCH(SQLException)
+    {
+        // left prepared to RecoverCommits
+        SQLBasicAccess_LOG(ERROR) << "end branch exception:" << Exception_frame.message
+                                  << " xid:" << xid << " commit:" << commit;
+        return false;
+    }
+    END_TRY;
+    return true;
+}
+
+int32_t SQLBasicAccess::WriteTables(
+    Connection_T conn, h256 hash, int num, const std::vector<TableData::Ptr>& datas)
+{
+    string strNum = to_string(num);
+    int32_t rowCount = 0;
+    for (auto it : datas)
+    {
+        auto tableInfo = it->info;
+        std::string strTableName = tableInfo->name;
+        std::vector<std::string> _fieldName;
+        std::vector<std::string> _fieldValue;
+        bool _hasGetField = false;
+
+        this->GetCommitFieldNameAndValue(
+            it->dirtyEntries, hash, strNum, _fieldName, _fieldValue, _hasGetField);
+        this->GetCommitFieldNameAndValue(
+            it->newEntries, hash, strNum, _fieldName, _fieldValue, _hasGetField);
+        /*build commit sql*/
+        std::vector<SQLPlaceHoldItem> sqlList =
+            this->BuildCommitSql(strTableName, _fieldName, _fieldValue);
+        auto itSql = sqlList.begin();
+        auto itValue = _fieldValue.begin();
+        for (; itSql != sqlList.end(); ++itSql)
+        {
+            SQLBasicAccess_LOG(DEBUG) << " commit hash:" << hash.hex() << " num:" << num
+                                      << " commit sql:" << itSql->sql;
+
+            PreparedStatement_T preSatement = m_connPool->GetStatement(conn, itSql->sql);
+
+            uint32_t index = 0;
+
+            /*
+                if not set string firstly
+                need to move itValue to next
+            */
+            if (itValue != _fieldValue.begin() && itValue != _fieldValue.end())
+            {
+                ++itValue;
+            }
+
+            for (; itValue != _fieldValue.end(); ++itValue)
+            {
+                PreparedStatement_setBlob(
+                    preSatement, ++index, itValue->data(), (int)itValue->size());
+                SQLBasicAccess_LOG(TRACE) << " index:" << index << " num:" << num
+                                          << " setString:" << itValue->c_str();
+                if (index == itSql->placeHolerCnt)
+                {
+                    PreparedStatement_execute(preSatement);
+                    rowCount += (int32_t)PreparedStatement_rowsChanged(preSatement);
+                    break;
+                }
+            }
+        }
+    }
+    return rowCount;
+}
+
+void SQLBasicAccess::RecoverCommits()
+{
+    Connection_T conn = m_connPool->GetConnection();
+    if (conn == NULL)
+    {
+        SQLBasicAccess_LOG(ERROR) << "get connection failed recover commits";
+        throw StorageException(-1, "recover commits get connection failed");
+    }
+
+    TRY
+    {
+        ResultSet_T result = Connection_executeQuery(conn, "select database()");
+        auto dbName = ResultSet_next(result) ? ResultSet_getString(result, 1) : NULL;
+        m_dbName = dbName ? dbName : "";
+
+        // the last block committed, by the transaction of its current state
+        int64_t committed = -1;
+        string sql = "select `" + SYS_VALUE + "` from `" + SYS_CURRENT_STATE + "` where `" +
+                     SYS_KEY + "` = '" + SYS_KEY_CURRENT_NUMBER + "' and `" + STATUS +
+                     "` = 0 order by `" + NUM_FIELD + "` desc limit 1";
+        result = Connection_executeQuery(conn, "%s", sql.c_str());
+        if (ResultSet_next(result))
+        {
+            auto value = ResultSet_getString(result, 1);
+            if (!value || !boost::conversion::try_lexical_convert(value, committed))
+            {
+                committed = -1;
+            }
+        }
+
+        std::vector<std::pair<std::string, int64_t> > branches;
+        result = Connection_executeQuery(conn, "XA RECOVER");
+        while (ResultSet_next(result))
+        {
+            int size = 0;
+            auto data = (const char*)ResultSet_getBlob(result, 4, &size);
+            int64_t num = CommitXidNum(m_dbName, ResultSet_getInt(result, 1),
+                ResultSet_getInt(result, 2), data ? std::string(data, size) : std::string());
+            if (num >= 0)
+            {
+                std::string bqual(data + ResultSet_getInt(result, 2), data + size);
+                branches.push_back(std::make_pair(bqual, num));
+            }
+        }
+
+        for (auto& it : branches)
+        {
+            string xid = "X'" + toHex(m_dbName) + "',X'" + toHex(it.first) + "'," +
+                         to_string(c_xidFormat);
+            SQLBasicAccess_LOG(INFO) << "recover branch xid:" << xid << " num:" << it.second
+                                     << " committed:" << committed;
+            Connection_execute(conn, "XA %s %s", it.second <= committed ? "COMMIT" : "ROLLBACK",
+                xid.c_str());
+        }
+    }
+    CATCH(SQLException)
+    {
+        SQLBasicAccess_LOG(ERROR) << "recover commits exception:" << Exception_frame.message;
+        m_connPool->ReturnConnection(conn);
+        throw StorageException(-1, string("recover commits failed:") + Exception_frame.message);
+    }
+    END_TRY;
+    m_connPool->ReturnConnection(conn);
+}
+
+std::string SQLBasicAccess::CommitXid(const std::string& _dbName, int _num, size_t _group)
+{
+    return "X'" + toHex(_dbName) + "',X'" + toHex(to_string(_num) + "." + to_string(_group)) +
+           "'," + to_string(c_xidFormat);
+}
+
+int64_t SQLBasicAccess::CommitXidNum(
+    const std::string& _dbName, int _formatID, int _gtridLength, const std::string& _data)
+{
+    if (_formatID != c_xidFormat || _gtridLength < 0 || size_t(_gtridLength) != _dbName.size() ||
+        _data.compare(0, _gtridLength, _dbName) != 0)
+    {
+        return -1;
+    }
+    int64_t num = -1;
+    auto bqual = _data.substr(_gtridLength);
+    if (!boost::conversion::try_lexical_convert(bqual.substr(0, bqual.find('.')), num))
+    {
+        return -1;
+    }
+    return num;
+}
+
 
 std::vector<SQLPlaceHoldItem> SQLBasicAccess::BuildCommitSql(const std::string& _table,
     const std::vector<std::string>& _fieldName, const std::vector<std::string>& _fieldValue)
@@ -418,15 +734,25 @@ std::vector<SQLPlaceHoldItem> SQLBasicAccess::BuildCommitSql(const std::string&
         THROW(SQLException, "PreparedStatement_executeQuery");
     }
     uint32_t columnSize = _fieldName.size();
-    std::string sqlHeader = "replace into ";
+    /*
+        the rows are updated in place by _id_, unlike replace into which deletes and inserts
+        them again with all their indexes
+    */
+    std::string sqlHeader = "insert into ";
+    std::string sqlTrailer = " on duplicate key update ";
     sqlHeader.append(_table).append("(");
     auto it = _fieldName.begin();
     for (; it != _fieldName.end(); ++it)
     {
         sqlHeader.append("`").append(*it).append("`").append(",");
+        if (*it != ID_FIELD)
+        {
+            sqlTrailer.append("`").append(*it).append("`=values(`").append(*it).append("`),");
+        }
     }
     sqlHeader = sqlHeader.substr(0, sqlHeader.size() - 1);
     sqlHeader.append(") values");
+    sqlTrailer = sqlTrailer.substr(0, sqlTrailer.size() - 1);
 
     SQLBasicAccess_LOG(INFO) << "table name:" << _table << "field size:" << _fieldName.size()
                              << " value size:" << _fieldValue.size();
@@ -456,6 +782,7 @@ std::vector<SQLPlaceHoldItem> SQLBasicAccess::BuildCommitSql(const std::string&
             if (placeHolderCnt >= maxPlaceHolderCnt)
             {
                 sql = sql.substr(0, sql.size() - 1);
+                sql.append(sqlTrailer);
                 SQLPlaceHoldItem item;
                 item.sql = sql;
                 item.placeHolerCnt = placeHolderCnt;
@@ -468,6 +795,7 @@ std::vector<SQLPlaceHoldItem> SQLBasicAccess::BuildCommitSql(const std::string&
     if (placeHolderCnt > 0)
     {
         sql = sql.substr(0, sql.size() - 1);
+        sql.append(sqlTrailer);
         SQLPlaceHoldItem item;
         item.sql = sql;
         item.placeHolerCnt = placeHolderCnt;
@@ -54,6 +54,25 @@ public:
         std::vector<std::vector<std::string> >& vecValueList);
     virtual int Commit(h256 hash, int num, const std::vector<TableData::Ptr>& datas);
 
+    /*
+        split tables into at most _parts groups of close row counts, the marker table
+        _sys_current_state_ is kept out of the groups and committed after all of them
+    */
+    static std::vector<std::vector<TableData::Ptr> > PartitionTables(
+        const std::vector<TableData::Ptr>& _datas, uint32_t _parts,
+        std::vector<TableData::Ptr>& _markers);
+
+    /*
+        finishes the branches a crash left prepared, committed if their block is the current
+        number of _sys_current_state_ or older and rolled back otherwise, before any select
+    */
+    virtual void RecoverCommits();
+    /// the xid of the branch of group _group of block _num, the database name is its gtrid
+    static std::string CommitXid(const std::string& _dbName, int _num, size_t _group);
+    /// the block of a branch listed by XA RECOVER, -1 if it's no branch of _dbName
+    static int64_t CommitXidNum(
+        const std::string& _dbName, int _formatID, int _gtridLength, const std::string& _data);
+
 private:
     std::string BuildQuerySql(const std::string& table, Condition::Ptr condition);
     std::string GenerateConditionSql(const std::string& strPrefix,
@@ -71,13 +90,31 @@ private:
         bool& _hasGetField);
 
     int CommitDo(h256 hash, int num, const std::vector<TableData::Ptr>& datas, std::string& errmsg);
+    int CommitParallel(
+        h256 hash, int num, const std::vector<TableData::Ptr>& datas, std::string& errmsg);
+    int CommitTables(Connection_T conn, h256 hash, int num,
+        const std::vector<TableData::Ptr>& datas, std::string& errmsg);
+    /// writes and prepares datas as the branch xid, rolled back if it fails
+    int PrepareTables(Connection_T conn, const std::string& xid, h256 hash, int num,
+        const std::vector<TableData::Ptr>& datas, std::string& errmsg);
+    bool EndBranch(Connection_T conn, const std::string& xid, bool commit);
+    int32_t WriteTables(
+        Connection_T conn, h256 hash, int num, const std::vector<TableData::Ptr>& datas);
 
 public:
     virtual void ExecuteSql(const std::string& _sql);
     void setConnPool(SQLConnectionPool::Ptr& _connPool);
+    void setCommitConnections(uint32_t _commitConnections)
+    {
+        m_commitConnections = _commitConnections;
+    }
 
 private:
     SQLConnectionPool::Ptr m_connPool;
+    // connections a block is committed with, one means a single transaction
+    uint32_t m_commitConnections = 1;
+    // the gtrid of the branches, set by RecoverCommits
+    std::string m_dbName;
 };
 
 }  // namespace storage
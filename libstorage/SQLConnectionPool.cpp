@@ -30,6 +30,8 @@
 using namespace dev::storage;
 using namespace std;
 
+constexpr std::chrono::seconds SQLConnectionPool::c_maxIdleTime;
+
 bool SQLConnectionPool::InitConnectionPool(const storage::ZDBConfig& _dbConfig)
 {
     if (_dbConfig.dbType == "mysql")
@@ -87,18 +89,77 @@ bool SQLConnectionPool::InitConnectionPool(const storage::ZDBConfig& _dbConfig)
 */
 Connection_T SQLConnectionPool::GetConnection()
 {
+    {
+        std::lock_guard<std::mutex> lock(x_statements);
+        if (!m_idle.empty())
+        {
+            auto connection = m_idle.back().first;
+            m_idle.pop_back();
+            return connection;
+        }
+    }
     return ConnectionPool_getConnection(m_connectionPool);
 }
 
 /*
-    Returns a connection to the pool
+    Returns a connection to the pool, a connection with prepared statements is kept for them
 */
 int SQLConnectionPool::ReturnConnection(const Connection_T& _connection)
 {
-    ConnectionPool_returnConnection(m_connectionPool, _connection);
+    std::lock_guard<std::mutex> lock(x_statements);
+    auto now = std::chrono::steady_clock::now();
+    while (!m_idle.empty() && now - m_idle.front().second > c_maxIdleTime)
+    {
+        releaseConnection(m_idle.front().first);
+        m_idle.pop_front();
+    }
+    auto it = m_statements.find(_connection);
+    if (it == m_statements.end() || it->second.empty())
+    {
+        releaseConnection(_connection);
+        return 0;
+    }
+    m_idle.push_back(std::make_pair(_connection, now));
     return 0;
 }
 
+PreparedStatement_T SQLConnectionPool::GetStatement(
+    const Connection_T& _connection, const std::string& _sql)
+{
+    Statements* statements = nullptr;
+    {
+        // the connection is used by a single thread, only the map is shared
+        std::lock_guard<std::mutex> lock(x_statements);
+        statements = &m_statements[_connection];
+    }
+    auto it = statements->find(_sql);
+    if (it != statements->end())
+    {
+        return it->second;
+    }
+    if (statements->size() >= c_maxStatements)
+    {
+        Connection_clear(_connection);
+        statements->clear();
+    }
+    auto statement = Connection_prepareStatement(_connection, "%s", _sql.c_str());
+    statements->emplace(_sql, statement);
+    return statement;
+}
+
+void SQLConnectionPool::DiscardStatements(const Connection_T& _connection)
+{
+    Connection_clear(_connection);
+    std::lock_guard<std::mutex> lock(x_statements);
+    m_statements.erase(_connection);
+}
+
+void SQLConnectionPool::releaseConnection(const Connection_T& _connection)
+{
+    m_statements.erase(_connection);
+    ConnectionPool_returnConnection(m_connectionPool, _connection);
+}
+
 
 int SQLConnectionPool::BeginTransaction(const Connection_T& _connection)
 {
@@ -126,6 +187,11 @@ inline void dev::storage::errorExitOut(std::stringstream& _exitInfo)
 
 SQLConnectionPool::~SQLConnectionPool()
 {
+    for (auto& it : m_idle)
+    {
+        releaseConnection(it.first);
+    }
+    m_idle.clear();
     ConnectionPool_stop(m_connectionPool);
     ConnectionPool_free(&m_connectionPool);
     URL_free(&m_url);
@@ -22,9 +22,13 @@
 #pragma once
 
 #include <zdb.h>
+#include <chrono>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #define SQLConnectionPool_LOG(LEVEL) LOG(LEVEL) << "[SQLConnectionPool] "
 
@@ -66,11 +70,37 @@ public:
 
     int GetTotalConnections();
 
+    /*
+        the statement of _sql prepared on _connection, prepared once and reused while the
+        connection is kept, the sql is built from the table, the operation and the columns
+    */
+    PreparedStatement_T GetStatement(const Connection_T& _connection, const std::string& _sql);
+    /// frees the statements of a connection whose statement failed
+    void DiscardStatements(const Connection_T& _connection);
+
     void createDataBase(const ZDBConfig& _dbConfig);
 
 private:
+    typedef std::unordered_map<std::string, PreparedStatement_T> Statements;
+
+    /// returns the connection to libzdb, which frees its statements
+    void releaseConnection(const Connection_T& _connection);
+
+    // statements prepared on a connection before they are all freed
+    static const size_t c_maxStatements = 128;
+    // a connection kept idle longer is returned to libzdb, which pings and reaps connections
+    static constexpr std::chrono::seconds c_maxIdleTime{60};
+
     ConnectionPool_T m_connectionPool;
     URL_T m_url;
+
+    /*
+        libzdb frees the statements of a connection returned to it, the connections with
+        statements are kept here when returned, the most recently used is reused first
+    */
+    std::mutex x_statements;
+    std::unordered_map<Connection_T, Statements> m_statements;
+    std::deque<std::pair<Connection_T, std::chrono::steady_clock::time_point> > m_idle;
 };
 
 inline void errorExitOut(std::stringstream& _exitInfo);
@@ -22,18 +22,30 @@
 #include "StorageException.h"
 
 #include <libchannelserver/ChannelRPCServer.h>
+#include <libdevcore/SnappyCompress.h>
 #include <libdevcore/easylog.h>
 
 #include "Common.h"
 #include "SQLStorage.h"
 #include "Table.h"
 #include <libchannelserver/ChannelMessage.h>
+#include <libdevcore/Executor.h>
 #include <libdevcore/FixedHash.h>
+#include <chrono>
+#include <condition_variable>
 
 using namespace dev;
 using namespace std;
 using namespace dev::storage;
 
+// first byte of a binary request or response, json requests start with '{'
+static const byte c_frameBinary = 'B';
+static const byte c_frameSnappy = 'S';
+// binary requests smaller than this aren't compressed
+static const size_t c_compressThreshold = 1024;
+// the pipelined requests waiting for their responses, at most
+static const size_t c_maxOutstanding = 64;
+
 SQLStorage::SQLStorage() {}
 
 Entries::Ptr SQLStorage::select(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
@@ -42,124 +54,283 @@ Entries::Ptr SQLStorage::select(h256 hash, int64_t num, TableInfo::Ptr tableInfo
     try
     {
         LOG(TRACE) << "Query AMOPDB data";
-        Json::Value requestJson;
+        auto data = selectRequest(hash, num, tableInfo, key, condition);
+
+        // the same select of concurrent executors is sent once
+        Entries::Ptr entries;
+        request(ref(data),
+            [&](bytesConstRef response) {
+                return decodeSelect(tableInfo->name, response, entries);
+            },
+            true);
+        return entries;
+    }
+    catch (std::exception& e)
+    {
+        LOG(ERROR) << "Query database error:" << e.what();
 
-        requestJson["op"] = "select";
-        requestJson["params"]["blockHash"] = hash.hex();
-        requestJson["params"]["num"] = num;
-        requestJson["params"]["table"] = tableInfo->name;
-        requestJson["params"]["key"] = key;
+        throw StorageException(-1, std::string("Query database error:") + e.what());
+    }
 
-        if (condition)
+    return Entries::Ptr();
+}
+
+std::vector<Entries::Ptr> SQLStorage::batchSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    if (!m_batchSelect)
+    {
+        return pipelinedSelect(hash, num, tableInfo, keys);
+    }
+
+    Json::Value responseJson;
+    bytes response;
+    Entries::Ptr entries;
+    try
+    {
+        LOG(TRACE) << "Batch query AMOPDB data, keys: " << keys.size();
+        if (binary())
         {
-            for (auto it : *(condition))
-            {
-                Json::Value cond;
-                cond.append(it.first);
-                if (it.second.left.second == it.second.right.second && it.second.left.first &&
-                    it.second.right.first)
-                {
-                    cond.append(Condition::eq);
-                    cond.append(it.second.left.second);
-                }
-                else
-                {
-                    if (it.second.left.second != condition->unlimitedField())
-                    {
-                        if (it.second.left.first)
-                        {
-                            cond.append(Condition::ge);
-                        }
-                        else
-                        {
-                            cond.append(Condition::gt);
-                        }
-                        cond.append(it.second.left.second);
-                    }
+            RLPStream stream(5);
+            stream << std::string("batchSelect") << hash << u256(num) << tableInfo->name << keys;
+            entries = decodeColumns(requestBinary(stream.out(), response));
+        }
+        else
+        {
+            Json::Value requestJson;
 
-                    if (it.second.right.second != condition->unlimitedField())
-                    {
-                        if (it.second.right.first)
-                        {
-                            cond.append(Condition::le);
-                        }
-                        else
-                        {
-                            cond.append(Condition::lt);
-                        }
-                        cond.append(it.second.right.second);
-                    }
-                }
-                // cond.append(it.second.left);
-                // cond.append(it.second.second);
-                requestJson["params"]["condition"].append(cond);
+            requestJson["op"] = "batchSelect";
+            requestJson["params"]["blockHash"] = hash.hex();
+            requestJson["params"]["num"] = num;
+            requestJson["params"]["table"] = tableInfo->name;
+            for (auto& key : keys)
+            {
+                requestJson["params"]["keys"].append(key);
             }
+
+            responseJson = requestDB(requestJson);
+        }
+    }
+    catch (StorageException& e)
+    {
+        if (e.errorCode() != 1)
+        {
+            throw;
         }
 
-        Json::Value responseJson = requestDB(requestJson);
+        // the amdb proxy doesn't support batchSelect, query the keys one by one from now on
+        LOG(WARNING) << "Remote database batch select failed, use select instead: " << e.what();
+        m_batchSelect = false;
 
-        int code = responseJson["code"].asInt();
-        if (code != 0)
+        return pipelinedSelect(hash, num, tableInfo, keys);
+    }
+
+    try
+    {
+        if (!entries)
         {
-            LOG(ERROR) << "Remote database return error:" << code;
+            int code = responseJson["code"].asInt();
+            if (code != 0)
+            {
+                LOG(ERROR) << "Remote database return error:" << code;
 
-            throw StorageException(
-                -1, "Remote database return error:" + boost::lexical_cast<std::string>(code));
+                throw StorageException(
+                    -1, "Remote database return error:" + boost::lexical_cast<std::string>(code));
+            }
+
+            entries = decodeEntries(tableInfo->name, responseJson["result"]);
         }
 
-        std::vector<std::string> columns;
-        for (Json::ArrayIndex i = 0; i < responseJson["result"]["columns"].size(); ++i)
+        // rows of all keys are returned together, group them by the key field
+        std::map<std::string, size_t> key2Index;
+        std::vector<Entries::Ptr> result(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
         {
-            std::string fieldName = responseJson["result"]["columns"].get(i, "").asString();
-            columns.push_back(fieldName);
+            key2Index.insert(std::make_pair(keys[i], i));
+            result[i] = std::make_shared<Entries>();
         }
 
-        Entries::Ptr entries = std::make_shared<Entries>();
-        for (Json::ArrayIndex i = 0; i < responseJson["result"]["data"].size(); ++i)
+        for (auto entry : *entries)
         {
-            Json::Value line = responseJson["result"]["data"].get(i, "");
-            Entry::Ptr entry = std::make_shared<Entry>();
-
-            for (Json::ArrayIndex j = 0; j < line.size(); ++j)
+            auto it = key2Index.find(entry->getField(tableInfo->key));
+            if (it != key2Index.end())
             {
-                std::string fieldValue = line.get(j, "").asString();
-
-                if (columns[j] == ID_FIELD)
-                {
-                    entry->setID(fieldValue);
-                }
-                else if (columns[j] == NUM_FIELD)
-                {
-                    entry->setNum(fieldValue);
-                }
-                else if (columns[j] == STATUS)
-                {
-                    entry->setStatus(fieldValue);
-                }
-                else
-                {
-                    entry->setField(columns[j], fieldValue);
-                }
+                result[it->second]->addEntry(entry);
             }
+        }
+
+        for (auto& it : result)
+        {
+            it->setDirty(false);
+        }
+
+        return result;
+    }
+    catch (std::exception& e)
+    {
+        LOG(ERROR) << "Batch query database error:" << e.what();
+
+        throw StorageException(-1, std::string("Batch query database error:") + e.what());
+    }
+
+    return std::vector<Entries::Ptr>();
+}
 
-            if (entry->getStatus() == 0)
+bytes SQLStorage::selectRequest(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+    const std::string& key, Condition::Ptr condition)
+{
+    auto bounds = conditionBounds(condition);
+
+    if (binary())
+    {
+        RLPStream stream(6);
+        stream << std::string("select") << hash << u256(num) << tableInfo->name << key;
+        stream.appendList(bounds.size());
+        for (auto& it : bounds)
+        {
+            stream.appendList(1 + it.second.size() * 2);
+            stream << it.first;
+            for (auto& bound : it.second)
             {
-                entry->setDirty(false);
-                entries->addEntry(entry);
+                stream << (unsigned)bound.first << bound.second;
             }
         }
 
-        entries->setDirty(false);
-        return entries;
+        return frameBinary(stream.out());
+    }
+
+    Json::Value requestJson;
+
+    requestJson["op"] = "select";
+    requestJson["params"]["blockHash"] = hash.hex();
+    requestJson["params"]["num"] = num;
+    requestJson["params"]["table"] = tableInfo->name;
+    requestJson["params"]["key"] = key;
+
+    for (auto& it : bounds)
+    {
+        Json::Value cond;
+        cond.append(it.first);
+        for (auto& bound : it.second)
+        {
+            cond.append(bound.first);
+            cond.append(bound.second);
+        }
+        requestJson["params"]["condition"].append(cond);
+    }
+
+    std::stringstream ssOut;
+    ssOut << requestJson;
+    auto str = ssOut.str();
+    LOG(TRACE) << "Request AMOPDB:" << str;
+
+    return bytes(str.begin(), str.end());
+}
+
+int SQLStorage::decodeSelect(const std::string& table, bytesConstRef data, Entries::Ptr& entries)
+{
+    if (m_binary)
+    {
+        bytes response;
+        int code = unframeBinary(data, response);
+        if (code == 0)
+        {
+            entries = decodeColumns(RLP(response)[1]);
+        }
+        return code;
+    }
+
+    Json::Value response;
+    int code = parseJson(data, response);
+    if (code == 0)
+    {
+        entries = decodeEntries(table, response["result"]);
+    }
+    return code;
+}
+
+std::vector<Entries::Ptr> SQLStorage::pipelinedSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    try
+    {
+        LOG(TRACE) << "Pipelined query AMOPDB data, keys: " << keys.size();
+        std::vector<bytes> requests;
+        requests.reserve(keys.size());
+        for (auto& key : keys)
+        {
+            auto condition = std::make_shared<Condition>();
+            condition->EQ(tableInfo->key, key);
+            requests.push_back(selectRequest(hash, num, tableInfo, key, condition));
+        }
+
+        std::vector<Entries::Ptr> result(keys.size());
+        requestAll(requests, [&](size_t index, bytesConstRef data) {
+            return decodeSelect(tableInfo->name, data, result[index]);
+        });
+        return result;
     }
     catch (std::exception& e)
     {
-        LOG(ERROR) << "Query database error:" << e.what();
+        LOG(ERROR) << "Batch query database error:" << e.what();
 
-        throw StorageException(-1, std::string("Query database error:") + e.what());
+        throw StorageException(-1, std::string("Batch query database error:") + e.what());
     }
 
-    return Entries::Ptr();
+    return std::vector<Entries::Ptr>();
+}
+
+Entries::Ptr SQLStorage::decodeEntries(const std::string& table, const Json::Value& result)
+{
+    std::vector<std::string> columns;
+    for (Json::ArrayIndex i = 0; i < result["columns"].size(); ++i)
+    {
+        std::string fieldName = result["columns"].get(i, "").asString();
+        columns.push_back(fieldName);
+    }
+
+    Entries::Ptr entries = std::make_shared<Entries>();
+    for (Json::ArrayIndex i = 0; i < result["data"].size(); ++i)
+    {
+        Json::Value line = result["data"].get(i, "");
+        Entry::Ptr entry = std::make_shared<Entry>();
+
+        for (Json::ArrayIndex j = 0; j < line.size(); ++j)
+        {
+            std::string fieldValue = line.get(j, "").asString();
+
+            if (columns[j] == ID_FIELD)
+            {
+                entry->setID(fieldValue);
+            }
+            else if (columns[j] == NUM_FIELD)
+            {
+                entry->setNum(fieldValue);
+            }
+            else if (columns[j] == STATUS)
+            {
+                entry->setStatus(fieldValue);
+            }
+            else if (isBinaryField(table, columns[j]))
+            {
+                auto data = fromHex(fieldValue);
+                entry->setField(columns[j], std::string(data.begin(), data.end()));
+            }
+            else
+            {
+                entry->setField(columns[j], fieldValue);
+            }
+        }
+
+        if (entry->getStatus() == 0)
+        {
+            entry->setDirty(false);
+            entries->addEntry(entry);
+        }
+    }
+
+    entries->setDirty(false);
+    return entries;
 }
 
 size_t SQLStorage::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
@@ -175,6 +346,32 @@ size_t SQLStorage::commit(h256 hash, int64_t num, const std::vector<TableData::P
             return 0;
         }
 
+        if (binary())
+        {
+            size_t tables = 0;
+            for (auto it : datas)
+            {
+                if (it->dirtyEntries->size() + it->newEntries->size() > 0)
+                {
+                    ++tables;
+                }
+            }
+
+            RLPStream stream(4);
+            stream << std::string("commit") << hash << u256(num);
+            stream.appendList(tables);
+            for (auto it : datas)
+            {
+                if (it->dirtyEntries->size() + it->newEntries->size() > 0)
+                {
+                    encodeColumns(stream, it);
+                }
+            }
+
+            bytes response;
+            return requestBinary(stream.out(), response).toInt<size_t>();
+        }
+
         Json::Value requestJson;
 
         requestJson["op"] = "commit";
@@ -195,7 +392,9 @@ size_t SQLStorage::commit(h256 hash, int64_t num, const std::vector<TableData::P
 
                 for (auto fieldIt : *entry)
                 {
-                    value[fieldIt.first] = fieldIt.second;
+                    value[fieldIt.first] = isBinaryField(tableInfo->name, fieldIt.first) ?
+                                               toHex(fieldIt.second) :
+                                               fieldIt.second;
                 }
 
                 value[ID_FIELD] = boost::lexical_cast<std::string>(entry->getID());
@@ -212,7 +411,9 @@ size_t SQLStorage::commit(h256 hash, int64_t num, const std::vector<TableData::P
 
                 for (auto fieldIt : *entry)
                 {
-                    value[fieldIt.first] = fieldIt.second;
+                    value[fieldIt.first] = isBinaryField(tableInfo->name, fieldIt.first) ?
+                                               toHex(fieldIt.second) :
+                                               fieldIt.second;
                 }
 
                 value[ID_FIELD] = boost::lexical_cast<std::string>(entry->getID());
@@ -257,8 +458,62 @@ bool SQLStorage::onlyDirty()
     return true;
 }
 
-Json::Value SQLStorage::requestDB(const Json::Value& value)
+void SQLStorage::request(
+    bytesConstRef data, std::function<int(bytesConstRef)> decode, bool coalesce)
 {
+    if (coalesce)
+    {
+        auto key = data.toString();
+        std::promise<std::shared_ptr<bytes> > promise;
+        std::shared_future<std::shared_ptr<bytes> > response;
+        bool sending = false;
+        {
+            std::lock_guard<std::mutex> lock(x_requests);
+            auto it = m_requests.find(key);
+            if (it == m_requests.end())
+            {
+                response = promise.get_future().share();
+                m_requests.emplace(key, response);
+                sending = true;
+            }
+            else
+            {
+                response = it->second;
+            }
+        }
+
+        if (!sending)
+        {
+            // the code has been checked by the sender of the request
+            decode(ref(*response.get()));
+            return;
+        }
+
+        auto payload = std::make_shared<bytes>();
+        try
+        {
+            request(data, [&](bytesConstRef _response) {
+                payload->assign(_response.begin(), _response.end());
+                return decode(_response);
+            });
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(x_requests);
+                m_requests.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock(x_requests);
+            m_requests.erase(key);
+        }
+        promise.set_value(payload);
+        return;
+    }
+
     int retry = 0;
 
     while (true)
@@ -269,19 +524,12 @@ Json::Value SQLStorage::requestDB(const Json::Value& value)
                 std::make_shared<dev::channel::TopicChannelMessage>();
             request->setType(0x30);
             request->setSeq(m_channelRPCServer->newSeq());
-
-            std::stringstream ssOut;
-            ssOut << value;
-
-            auto str = ssOut.str();
-            LOG(TRACE) << "Request AMOPDB:" << request->seq() << " " << str;
-
             request->setTopic(m_topic);
 
             dev::channel::TopicChannelMessage::Ptr response;
 
             LOG(TRACE) << "Retry Request amdb :" << retry;
-            request->setData((const byte*)str.data(), str.size());
+            request->setData(data.data(), data.size());
             response = m_channelRPCServer->pushChannelMessage(request, m_timeout);
             if (response.get() == NULL || response->result() != 0)
             {
@@ -296,22 +544,7 @@ Json::Value SQLStorage::requestDB(const Json::Value& value)
             std::string topic = response->topic();
             LOG(TRACE) << "Receive topic:" << topic;
 
-            std::stringstream ssIn;
-            std::string jsonStr(response->data(), response->data() + response->dataSize());
-            ssIn << jsonStr;
-
-            LOG(TRACE) << "AMOPDB Response:" << ssIn.str();
-
-            Json::Value responseJson;
-            ssIn >> responseJson;
-
-            auto codeValue = responseJson["code"];
-            if (!codeValue.isInt())
-            {
-                throw StorageException(-1, "undefined amdb error code");
-            }
-
-            int code = codeValue.asInt();
+            int code = decode(bytesConstRef(response->data(), response->dataSize()));
             if (code == 1)
             {
                 throw StorageException(
@@ -323,7 +556,7 @@ Json::Value SQLStorage::requestDB(const Json::Value& value)
                     -1, "amdb code error:" + boost::lexical_cast<std::string>(code));
             }
 
-            return responseJson;
+            return;
         }
         catch (dev::channel::ChannelException& e)
         {
@@ -361,6 +594,396 @@ Json::Value SQLStorage::requestDB(const Json::Value& value)
     }
 }
 
+Json::Value SQLStorage::requestDB(const Json::Value& value)
+{
+    std::stringstream ssOut;
+    ssOut << value;
+
+    auto str = ssOut.str();
+    LOG(TRACE) << "Request AMOPDB:" << str;
+
+    Json::Value responseJson;
+    request(bytesConstRef(str),
+        [&responseJson](bytesConstRef data) -> int { return parseJson(data, responseJson); });
+
+    return responseJson;
+}
+
+void SQLStorage::requestAll(
+    const std::vector<bytes>& datas, std::function<int(size_t, bytesConstRef)> decode)
+{
+    struct Responses
+    {
+        std::mutex mutex;
+        std::condition_variable received;
+        size_t count = 0;
+        std::vector<std::shared_ptr<bytes> > datas;
+    };
+    auto responses = std::make_shared<Responses>();
+    responses->datas.resize(datas.size());
+
+    // the responses are matched to the requests by their seq in the channel session
+    size_t sent = 0;
+    // the responses may be handled by the workers
+    Executor::Blocking blocking;
+    std::unique_lock<std::mutex> lock(responses->mutex);
+    while (responses->count < datas.size())
+    {
+        while (sent < datas.size() && sent - responses->count < c_maxOutstanding)
+        {
+            lock.unlock();
+            auto request = std::make_shared<dev::channel::TopicChannelMessage>();
+            request->setType(0x30);
+            request->setSeq(m_channelRPCServer->newSeq());
+            request->setTopic(m_topic);
+            request->setData(datas[sent].data(), datas[sent].size());
+            auto index = sent++;
+            m_channelRPCServer->asyncPushChannelMessage(m_topic, request,
+                [responses, index](
+                    dev::channel::ChannelException e, dev::channel::Message::Ptr response) {
+                    std::shared_ptr<bytes> data;
+                    try
+                    {
+                        if (e.errorCode() == 0 && response && response->result() == 0)
+                        {
+                            dev::channel::TopicChannelMessage message(response.get());
+                            data = std::make_shared<bytes>(
+                                message.data(), message.data() + message.dataSize());
+                        }
+                    }
+                    catch (std::exception& e)
+                    {
+                        LOG(ERROR) << "Pipelined AMDB response error: " << e.what();
+                    }
+                    std::lock_guard<std::mutex> lock(responses->mutex);
+                    responses->datas[index] = data;
+                    ++responses->count;
+                    responses->received.notify_all();
+                },
+                m_timeout);
+            lock.lock();
+        }
+        // a response lost on the way is requested again below
+        if (!responses->received.wait_for(lock, std::chrono::milliseconds(2 * m_timeout), [&]() {
+                return responses->count == datas.size() ||
+                       (sent < datas.size() && sent - responses->count < c_maxOutstanding);
+            }))
+        {
+            LOG(ERROR) << "Pipelined AMDB requests timeout"
+                       << LOG_KV("waiting", sent - responses->count);
+            break;
+        }
+    }
+    auto received = responses->datas;
+    lock.unlock();
+
+    for (size_t i = 0; i < datas.size(); ++i)
+    {
+        int code = -1;
+        if (received[i])
+        {
+            try
+            {
+                code = decode(i, ref(*received[i]));
+            }
+            catch (StorageException& e)
+            {
+                if (e.errorCode() != -1)
+                {
+                    throw;
+                }
+                LOG(ERROR) << "AMDB error: " << e.what();
+            }
+        }
+        if (code == 1)
+        {
+            throw StorageException(1, "amdb sql error:" + boost::lexical_cast<std::string>(code));
+        }
+        if (code != 0)
+        {
+            request(ref(datas[i]), [&](bytesConstRef data) { return decode(i, data); });
+        }
+    }
+}
+
+int SQLStorage::parseJson(bytesConstRef data, Json::Value& response)
+{
+    std::stringstream ssIn;
+    std::string jsonStr(data.begin(), data.end());
+    ssIn << jsonStr;
+
+    LOG(TRACE) << "AMOPDB Response:" << ssIn.str();
+
+    response = Json::Value();
+    ssIn >> response;
+
+    auto codeValue = response["code"];
+    if (!codeValue.isInt())
+    {
+        throw StorageException(-1, "undefined amdb error code");
+    }
+
+    return codeValue.asInt();
+}
+
+RLP SQLStorage::requestBinary(const bytes& data, bytes& response)
+{
+    auto frame = frameBinary(data);
+    request(ref(frame),
+        [&response](bytesConstRef data) -> int { return unframeBinary(data, response); });
+
+    return RLP(response)[1];
+}
+
+bytes SQLStorage::frameBinary(const bytes& data)
+{
+    bytes frame;
+    if (m_compress && data.size() > c_compressThreshold)
+    {
+        bytes compressed;
+        compress::SnappyCompress::compress(ref(data), compressed);
+        frame.reserve(compressed.size() + 1);
+        frame.push_back(c_frameSnappy);
+        frame.insert(frame.end(), compressed.begin(), compressed.end());
+    }
+    else
+    {
+        frame.reserve(data.size() + 1);
+        frame.push_back(c_frameBinary);
+        frame.insert(frame.end(), data.begin(), data.end());
+    }
+
+    LOG(TRACE) << "Request AMOPDB binary:" << LOG_KV("size", data.size())
+               << LOG_KV("frameSize", frame.size());
+    return frame;
+}
+
+int SQLStorage::unframeBinary(bytesConstRef data, bytes& response)
+{
+    if (data.empty())
+    {
+        throw StorageException(-1, "empty amdb response");
+    }
+
+    if (data[0] == c_frameSnappy)
+    {
+        response.clear();
+        compress::SnappyCompress::uncompress(data.cropped(1), response);
+    }
+    else if (data[0] == c_frameBinary)
+    {
+        response = data.cropped(1).toBytes();
+    }
+    else
+    {
+        throw StorageException(-1, "undefined amdb response frame");
+    }
+
+    // the code is signed, it's encoded as its 32 bits two's complement
+    return (int)(int32_t)RLP(response)[0].toInt<uint32_t>();
+}
+
+bool SQLStorage::binary()
+{
+    if (!m_binaryProtocol)
+    {
+        return false;
+    }
+
+    // negotiated once, an exception leaves the flag unset so the next request tries again
+    std::call_once(m_negotiated, [this]() {
+        Json::Value requestJson;
+        requestJson["op"] = "protocol";
+        requestJson["params"]["protocols"].append("binary");
+        requestJson["params"]["compress"].append("snappy");
+
+        try
+        {
+            auto responseJson = requestDB(requestJson);
+            m_binary = responseJson["result"]["protocol"].asString() == "binary";
+            m_compress = m_binary && responseJson["result"]["compress"].asString() == "snappy";
+        }
+        catch (StorageException& e)
+        {
+            if (e.errorCode() != 1)
+            {
+                throw;
+            }
+
+            // the amdb proxy doesn't know the protocol op, it only speaks json
+            LOG(WARNING) << "Remote database binary protocol unsupported, use json: " << e.what();
+        }
+
+        LOG(INFO) << "Negotiated AMOPDB protocol" << LOG_KV("binary", m_binary)
+                  << LOG_KV("compress", m_compress);
+    });
+
+    return m_binary;
+}
+
+SQLStorage::Bounds SQLStorage::conditionBounds(Condition::Ptr condition)
+{
+    Bounds bounds;
+    if (!condition)
+    {
+        return bounds;
+    }
+
+    for (auto it : *(condition))
+    {
+        std::vector<std::pair<int, std::string> > fieldBounds;
+        if (it.second.left.second == it.second.right.second && it.second.left.first &&
+            it.second.right.first)
+        {
+            fieldBounds.push_back(std::make_pair(Condition::eq, it.second.left.second));
+        }
+        else
+        {
+            if (it.second.left.second != condition->unlimitedField())
+            {
+                fieldBounds.push_back(std::make_pair(
+                    it.second.left.first ? Condition::ge : Condition::gt, it.second.left.second));
+            }
+
+            if (it.second.right.second != condition->unlimitedField())
+            {
+                fieldBounds.push_back(std::make_pair(
+                    it.second.right.first ? Condition::le : Condition::lt, it.second.right.second));
+            }
+        }
+        bounds.push_back(std::make_pair(it.first, fieldBounds));
+    }
+
+    return bounds;
+}
+
+void SQLStorage::encodeColumns(RLPStream& stream, TableData::Ptr data)
+{
+    std::vector<Entries::Ptr> entriesList = {data->dirtyEntries, data->newEntries};
+
+    // union of the fields in first seen order
+    std::vector<std::string> columns;
+    std::set<std::string> seen;
+    size_t rows = 0;
+    for (auto& entries : entriesList)
+    {
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            for (auto fieldIt : *entries->get(i))
+            {
+                if (fieldIt.first != ID_FIELD && fieldIt.first != STATUS &&
+                    seen.insert(fieldIt.first).second)
+                {
+                    columns.push_back(fieldIt.first);
+                }
+            }
+        }
+        rows += entries->size();
+    }
+
+    stream.appendList(3);
+    stream << data->info->name;
+    stream.appendList(columns.size() + 2);
+    for (auto& column : columns)
+    {
+        stream << column;
+    }
+    stream << std::string(ID_FIELD) << std::string(STATUS);
+
+    stream.appendList(columns.size() + 2);
+    for (auto& column : columns)
+    {
+        stream.appendList(rows);
+        for (auto& entries : entriesList)
+        {
+            for (size_t i = 0; i < entries->size(); ++i)
+            {
+                auto entry = entries->get(i);
+                auto fieldIt = entry->find(column);
+                stream << (fieldIt != entry->end() ? fieldIt->second : std::string());
+            }
+        }
+    }
+
+    stream.appendList(rows);
+    for (auto& entries : entriesList)
+    {
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            stream << boost::lexical_cast<std::string>(entries->get(i)->getID());
+        }
+    }
+
+    stream.appendList(rows);
+    for (auto& entries : entriesList)
+    {
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            stream << boost::lexical_cast<std::string>(entries->get(i)->getStatus());
+        }
+    }
+}
+
+Entries::Ptr SQLStorage::decodeColumns(const RLP& result)
+{
+    auto columns = result[0].toVector<std::string>();
+    auto values = result[1];
+    if (values.itemCount() != columns.size())
+    {
+        throw StorageException(-1, "amdb columns mismatch");
+    }
+
+    size_t rows = columns.empty() ? 0 : values[0].itemCount();
+    std::vector<Entry::Ptr> rowEntries(rows);
+    for (auto& entry : rowEntries)
+    {
+        entry = std::make_shared<Entry>();
+    }
+
+    for (size_t j = 0; j < columns.size(); ++j)
+    {
+        auto columnValues = values[j];
+        if (columnValues.itemCount() != rows)
+        {
+            throw StorageException(-1, "amdb rows mismatch");
+        }
+
+        for (size_t i = 0; i < rows; ++i)
+        {
+            auto fieldValue = columnValues[i].toString();
+            if (columns[j] == ID_FIELD)
+            {
+                rowEntries[i]->setID(fieldValue);
+            }
+            else if (columns[j] == NUM_FIELD)
+            {
+                rowEntries[i]->setNum(fieldValue);
+            }
+            else if (columns[j] == STATUS)
+            {
+                rowEntries[i]->setStatus(fieldValue);
+            }
+            else
+            {
+                rowEntries[i]->setField(columns[j], fieldValue);
+            }
+        }
+    }
+
+    Entries::Ptr entries = std::make_shared<Entries>();
+    for (auto& entry : rowEntries)
+    {
+        if (entry->getStatus() == 0)
+        {
+            entry->setDirty(false);
+            entries->addEntry(entry);
+        }
+    }
+
+    entries->setDirty(false);
+    return entries;
+}
+
 void SQLStorage::setTopic(const std::string& topic)
 {
     m_topic = topic;
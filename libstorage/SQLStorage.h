@@ -25,6 +25,11 @@
 #include <json/json.h>
 #include <libchannelserver/ChannelRPCServer.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/RLP.h>
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
 
 namespace dev
 {
@@ -40,27 +45,79 @@ public:
 
     Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
     size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
     bool onlyDirty() override;
 
     virtual void setTopic(const std::string& topic);
     virtual void setChannelRPCServer(dev::ChannelRPCServer::Ptr channelRPCServer);
     virtual void setMaxRetry(int maxRetry);
+    // try the binary protocol, it's negotiated with the amdb proxy on the first request
+    virtual void setBinaryProtocol(bool binaryProtocol) { m_binaryProtocol = binaryProtocol; }
 
     virtual void setFatalHandler(std::function<void(std::exception&)> fatalHandler)
     {
         m_fatalHandler = fatalHandler;
     }
 
+    // bounds of each field of a condition, a bound is an op of Condition::Op with its value
+    typedef std::vector<std::pair<std::string, std::vector<std::pair<int, std::string> > > >
+        Bounds;
+    static Bounds conditionBounds(Condition::Ptr condition);
+
+    // columns of the table data followed by the values of each column, fields missing in an
+    // entry are empty
+    static void encodeColumns(RLPStream& stream, TableData::Ptr data);
+    static Entries::Ptr decodeColumns(const RLP& result);
+
 private:
+    // send data to the amdb proxy until it's delivered, decode returns the amdb code of the
+    // response. With coalesce, the callers sending the same data together share one request and
+    // decode its response each
+    void request(
+        bytesConstRef data, std::function<int(bytesConstRef)> decode, bool coalesce = false);
+    // send the requests together, up to c_maxOutstanding waiting for their responses, decode gets
+    // the index of the request. The failed ones are sent again one by one as request does
+    void requestAll(
+        const std::vector<bytes>& datas, std::function<int(size_t, bytesConstRef)> decode);
     Json::Value requestDB(const Json::Value& value);
+    // the result of the response, the frame byte tells if the data is compressed
+    RLP requestBinary(const bytes& data, bytes& response);
+    bytes frameBinary(const bytes& data);
+    // the amdb code of a binary response, its rlp is put in response
+    static int unframeBinary(bytesConstRef data, bytes& response);
+    // the amdb code of a json response
+    static int parseJson(bytesConstRef data, Json::Value& response);
+    bool binary();
+    // the request of a select and the decoding of its response, in the negotiated protocol
+    bytes selectRequest(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition);
+    int decodeSelect(const std::string& table, bytesConstRef data, Entries::Ptr& entries);
+    // the keys selected by pipelined requests, for the amdb proxies without batchSelect
+    std::vector<Entries::Ptr> pipelinedSelect(
+        h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys);
+    // the binary fields of table come in hex in json
+    Entries::Ptr decodeEntries(const std::string& table, const Json::Value& result);
 
     std::function<void(std::exception&)> m_fatalHandler;
 
     std::string m_topic;
     dev::ChannelRPCServer::Ptr m_channelRPCServer;
     int m_maxRetry = 0;
+    // cleared when the amdb proxy rejects the batchSelect op
+    std::atomic<bool> m_batchSelect = {true};
+
+    bool m_binaryProtocol = false;
+    std::once_flag m_negotiated;
+    // negotiated with the amdb proxy
+    bool m_binary = false;
+    bool m_compress = false;
     size_t m_timeout = 10 * 1000;  // timeout by ms
+
+    // the responses of the coalesced requests in flight, by their data
+    std::map<std::string, std::shared_future<std::shared_ptr<bytes> > > m_requests;
+    std::mutex x_requests;
 };
 
 }  // namespace storage
@@ -0,0 +1,127 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file SpeculativeStorage.cpp
+ *  @author ancelmo
+ *  @date 20191015
+ */
+
+#include "SpeculativeStorage.h"
+#include "Common.h"
+#include <libdevcore/easylog.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+SpeculativeStorage::SpeculativeStorage(Storage::Ptr backend, const vector<TableData::Ptr>& parent)
+  : m_backend(backend)
+{
+    for (auto& data : parent)
+    {
+        auto& table = m_parent[data->info->name];
+        for (auto entry : *data->dirtyEntries)
+        {
+            table.dirty[entry->getID()] = entry;
+        }
+        for (auto entry : *data->newEntries)
+        {
+            table.newKeys.insert(entry->getField(data->info->key));
+        }
+    }
+}
+
+Entries::Ptr SpeculativeStorage::select(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const string& key, Condition::Ptr condition)
+{
+    // the parent may have changed whether a row matches the condition
+    auto conditionKey = make_shared<Condition>();
+    conditionKey->EQ(tableInfo->key, key);
+    auto entries = m_backend->select(hash, num, tableInfo, key, conditionKey);
+    return merge(tableInfo, key, entries, condition);
+}
+
+vector<Entries::Ptr> SpeculativeStorage::batchSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const vector<string>& keys)
+{
+    auto result = m_backend->batchSelect(hash, num, tableInfo, keys);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        result[i] = merge(tableInfo, keys[i], result[i], nullptr);
+    }
+    return result;
+}
+
+size_t SpeculativeStorage::commit(h256 hash, int64_t num, const vector<TableData::Ptr>& datas)
+{
+    return m_backend->commit(hash, num, datas);
+}
+
+StorageIterator::Ptr SpeculativeStorage::scan(
+    TableInfo::Ptr tableInfo, const string& begin, const string& end, size_t batchSize)
+{
+    m_conflicted = true;
+    return m_backend->scan(tableInfo, begin, end, batchSize);
+}
+
+Entries::Ptr SpeculativeStorage::merge(
+    TableInfo::Ptr tableInfo, const string& key, Entries::Ptr entries, Condition::Ptr condition)
+{
+    auto it = m_parent.find(tableInfo->name);
+    if (it == m_parent.end())
+    {
+        if (!entries || !condition)
+        {
+            return entries;
+        }
+        auto out = makeShared<Entries>();
+        for (auto entry : *entries)
+        {
+            if (condition->process(entry))
+            {
+                out->addEntry(entry);
+            }
+        }
+        return out;
+    }
+
+    auto& table = it->second;
+    if (table.newKeys.count(key))
+    {
+        STORAGE_LOG(DEBUG) << LOG_BADGE("SpeculativeStorage")
+                           << LOG_DESC("read the rows inserted by the parent")
+                           << LOG_KV("table", tableInfo->name) << LOG_KV("key", key);
+        m_conflicted = true;
+    }
+    auto out = makeShared<Entries>();
+    if (!entries)
+    {
+        return out;
+    }
+    for (auto entry : *entries)
+    {
+        auto dirtyIt = table.dirty.find(entry->getID());
+        if (dirtyIt != table.dirty.end())
+        {
+            entry = dirtyIt->second;
+        }
+        if (!condition || condition->process(entry))
+        {
+            out->addEntry(entry);
+        }
+    }
+    return out;
+}
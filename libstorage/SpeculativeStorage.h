@@ -0,0 +1,79 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file SpeculativeStorage.h
+ *  @author ancelmo
+ *  @date 20191015
+ */
+#pragma once
+
+#include "Storage.h"
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace dev
+{
+namespace storage
+{
+/// The state of a block executed but not saved yet, its writes laid over the backend, so that the
+/// next block is executed before its parent is saved. The rows the parent updated or deleted are
+/// read in their new version. The rows the parent inserted have no id until the parent is
+/// committed, reading a key with such rows marks the storage conflicted and the speculative
+/// execution is to be dropped. Commits are forwarded to the backend, after the parent.
+class SpeculativeStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<SpeculativeStorage> Ptr;
+
+    /// parent: the data of the tables the parent block changed, as dumped by its table factory
+    SpeculativeStorage(Storage::Ptr backend, const std::vector<TableData::Ptr>& parent);
+    virtual ~SpeculativeStorage(){};
+
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition = nullptr) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
+    size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    /// the rows of the parent aren't scanned, the storage is marked conflicted
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
+    bool onlyDirty() override { return m_backend->onlyDirty(); }
+
+    /// a read may have missed a write of the parent
+    bool conflicted() const { return m_conflicted; }
+
+private:
+    struct ParentTable
+    {
+        /// the rows updated or deleted, by id
+        std::unordered_map<uint64_t, Entry::Ptr> dirty;
+        /// the keys with rows inserted
+        std::unordered_set<std::string> newKeys;
+    };
+
+    /// the rows of the backend replaced by their version in the parent
+    Entries::Ptr merge(TableInfo::Ptr tableInfo, const std::string& key, Entries::Ptr entries,
+        Condition::Ptr condition);
+
+    Storage::Ptr m_backend;
+    std::unordered_map<std::string, ParentTable> m_parent;
+    std::atomic_bool m_conflicted = {false};
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -0,0 +1,61 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StateDiff.cpp
+ *  @author ancelmo
+ *  @date 20191015
+ */
+
+#include "StateDiff.h"
+#include "BlockWAL.h"
+#include "MemoryTableFactory2.h"
+#include "StorageException.h"
+#include <libdevcore/SnappyCompress.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+using namespace dev::compress;
+
+bytes StateDiff::encode() const
+{
+    auto data = BlockWAL::encode(blockHash, number, datas);
+    bytes compressed;
+    if (SnappyCompress::compress(ref(data), compressed) == 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "compress the state diff failed"));
+    }
+    return compressed;
+}
+
+void StateDiff::decode(bytesConstRef _data)
+{
+    bytes data;
+    if (SnappyCompress::uncompress(_data, data) == 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "uncompress the state diff failed"));
+    }
+    BlockWAL::Block block;
+    BlockWAL::decode(ref(data), block);
+    blockHash = block.hash;
+    number = block.num;
+    datas = std::move(block.datas);
+}
+
+h256 StateDiff::dbHash() const
+{
+    return MemoryTableFactory2::hash(datas);
+}
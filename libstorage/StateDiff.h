@@ -0,0 +1,53 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StateDiff.h
+ *  @author ancelmo
+ *  @date 20191015
+ */
+#pragma once
+
+#include "Table.h"
+#include <libdevcore/FixedHash.h>
+
+namespace dev
+{
+namespace storage
+{
+/// The tables the execution of a block changed, the observers commit them instead of executing
+/// the block. All the tables the execution opened are listed in the order of their names, the
+/// unchanged ones with no entries, so that the dbHash of the block is recomputed from them. The
+/// new entries have no id yet, the storage numbers them on commit the same as the sealers did.
+class StateDiff
+{
+public:
+    typedef std::shared_ptr<StateDiff> Ptr;
+
+    h256 blockHash;
+    int64_t number = 0;
+    std::vector<TableData::Ptr> datas;
+
+    /// the record of the block in BlockWAL compressed by snappy
+    bytes encode() const;
+    /// throws if _data is not a diff
+    void decode(bytesConstRef _data);
+    /// the dbHash the header of the block signs, recomputed with the incremental table hash
+    h256 dbHash() const;
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -0,0 +1,317 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StatsStorage.cpp
+ *  @author ancelmo
+ *  @date 20190906
+ */
+
+#include "StatsStorage.h"
+#include "Common.h"
+#include <libdevcore/Common.h>
+#include <libdevcore/easylog.h>
+
+using namespace dev;
+using namespace dev::storage;
+
+static uint64_t micros(const Timer& timer)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(timer.duration()).count();
+}
+
+Histogram::Histogram()
+{
+    m_count.store(0);
+    m_total.store(0);
+    m_max.store(0);
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        m_buckets[i].store(0);
+    }
+}
+
+void Histogram::record(uint64_t value)
+{
+    size_t bucket = 0;
+    while (bucket < BUCKETS - 1 && (value >> bucket) > 0)
+    {
+        ++bucket;
+    }
+
+    m_buckets[bucket].fetch_and_increment();
+    m_count.fetch_and_increment();
+    m_total.fetch_and_add(value);
+
+    auto max = m_max.load();
+    while (value > max)
+    {
+        auto old = m_max.compare_and_swap(value, max);
+        if (old == max)
+        {
+            break;
+        }
+        max = old;
+    }
+}
+
+uint64_t Histogram::percentile(double fraction) const
+{
+    uint64_t count = m_count.load();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t target = (uint64_t)(count * fraction);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        sum += m_buckets[i].load();
+        if (sum > target)
+        {
+            // the last bucket is unbounded, the max is the best bound
+            return i < BUCKETS - 1 ? std::min((uint64_t)1 << i, m_max.load()) : m_max.load();
+        }
+    }
+
+    return m_max.load();
+}
+
+Json::Value Histogram::toJson() const
+{
+    Json::Value value(Json::objectValue);
+    uint64_t count = m_count.load();
+    value["count"] = (Json::UInt64)count;
+    value["avg"] = (Json::UInt64)(count > 0 ? m_total.load() / count : 0);
+    value["max"] = (Json::UInt64)m_max.load();
+    value["p50"] = (Json::UInt64)percentile(0.5);
+    value["p99"] = (Json::UInt64)percentile(0.99);
+
+    // trailing empty buckets are left out
+    size_t last = BUCKETS;
+    while (last > 0 && m_buckets[last - 1].load() == 0)
+    {
+        --last;
+    }
+    value["buckets"] = Json::Value(Json::arrayValue);
+    for (size_t i = 0; i < last; ++i)
+    {
+        value["buckets"].append((Json::UInt64)m_buckets[i].load());
+    }
+
+    return value;
+}
+
+TableAccessStat::TableAccessStat()
+{
+    selects.store(0);
+    selectTime.store(0);
+    rowsRead.store(0);
+    bytesRead.store(0);
+    commits.store(0);
+    rowsWritten.store(0);
+    bytesWritten.store(0);
+}
+
+Json::Value TableAccessStat::toJson() const
+{
+    Json::Value value(Json::objectValue);
+    value["selects"] = (Json::UInt64)selects.load();
+    value["selectTime(us)"] = (Json::UInt64)selectTime.load();
+    value["rowsRead"] = (Json::UInt64)rowsRead.load();
+    value["bytesRead"] = (Json::UInt64)bytesRead.load();
+    value["commits"] = (Json::UInt64)commits.load();
+    value["rowsWritten"] = (Json::UInt64)rowsWritten.load();
+    value["bytesWritten"] = (Json::UInt64)bytesWritten.load();
+    return value;
+}
+
+StatsStorage::StatsStorage()
+  : m_selectLatency(std::make_shared<Histogram>()),
+    m_batchSelectLatency(std::make_shared<Histogram>()),
+    m_commitLatency(std::make_shared<Histogram>()),
+    m_commitRows(std::make_shared<Histogram>())
+{
+    m_bytesRead.store(0);
+    m_bytesWritten.store(0);
+    m_slowOperations.store(0);
+}
+
+Entries::Ptr StatsStorage::select(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+    const std::string& key, Condition::Ptr condition)
+{
+    Timer timer;
+    auto entries = m_backend->select(hash, num, tableInfo, key, condition);
+    auto elapsed = micros(timer);
+
+    m_selectLatency->record(elapsed);
+    auto stat = tableStat(tableInfo->name);
+    stat->selects.fetch_and_increment();
+    stat->selectTime.fetch_and_add(elapsed);
+    recordRead(stat, entries);
+
+    if (slow(elapsed))
+    {
+        m_slowOperations.fetch_and_increment();
+        STORAGE_LOG(WARNING) << LOG_BADGE("StatsStorage") << LOG_DESC("Slow select")
+                             << LOG_KV("table", tableInfo->name) << LOG_KV("key", key)
+                             << LOG_KV("rows", entries->size()) << LOG_KV("time(us)", elapsed);
+    }
+
+    return entries;
+}
+
+std::vector<Entries::Ptr> StatsStorage::batchSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    Timer timer;
+    auto result = m_backend->batchSelect(hash, num, tableInfo, keys);
+    auto elapsed = micros(timer);
+
+    m_batchSelectLatency->record(elapsed);
+    auto stat = tableStat(tableInfo->name);
+    stat->selects.fetch_and_add(keys.size());
+    stat->selectTime.fetch_and_add(elapsed);
+    for (auto& entries : result)
+    {
+        recordRead(stat, entries);
+    }
+
+    if (slow(elapsed))
+    {
+        m_slowOperations.fetch_and_increment();
+        STORAGE_LOG(WARNING) << LOG_BADGE("StatsStorage") << LOG_DESC("Slow batchSelect")
+                             << LOG_KV("table", tableInfo->name)
+                             << LOG_KV("key", keys.empty() ? std::string() : keys[0])
+                             << LOG_KV("keys", keys.size()) << LOG_KV("time(us)", elapsed);
+    }
+
+    return result;
+}
+
+size_t StatsStorage::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    Timer timer;
+    auto count = m_backend->commit(hash, num, datas);
+    auto elapsed = micros(timer);
+
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    for (auto& data : datas)
+    {
+        auto stat = tableStat(data->info->name);
+        stat->commits.fetch_and_increment();
+        for (auto entries : {data->dirtyEntries, data->newEntries})
+        {
+            uint64_t tableBytes = 0;
+            for (size_t i = 0; i < entries->size(); ++i)
+            {
+                tableBytes += entries->get(i)->capacity();
+            }
+            stat->rowsWritten.fetch_and_add(entries->size());
+            stat->bytesWritten.fetch_and_add(tableBytes);
+            rows += entries->size();
+            bytes += tableBytes;
+        }
+    }
+
+    m_commitLatency->record(elapsed);
+    m_commitRows->record(rows);
+    m_bytesWritten.fetch_and_add(bytes);
+
+    if (slow(elapsed))
+    {
+        m_slowOperations.fetch_and_increment();
+        STORAGE_LOG(WARNING) << LOG_BADGE("StatsStorage") << LOG_DESC("Slow commit")
+                             << LOG_KV("num", num) << LOG_KV("tables", datas.size())
+                             << LOG_KV("rows", rows) << LOG_KV("bytes", bytes)
+                             << LOG_KV("time(us)", elapsed);
+    }
+
+    return count;
+}
+
+StorageIterator::Ptr StatsStorage::scan(TableInfo::Ptr tableInfo, const std::string& begin,
+    const std::string& end, size_t batchSize)
+{
+    return m_backend->scan(tableInfo, begin, end, batchSize);
+}
+
+void StatsStorage::remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    m_backend->remove(tableInfo, keys);
+}
+
+int64_t StatsStorage::checkpoint(const std::string& path)
+{
+    return m_backend->checkpoint(path);
+}
+
+bool StatsStorage::onlyDirty()
+{
+    return m_backend->onlyDirty();
+}
+
+void StatsStorage::stop()
+{
+    m_backend->stop();
+}
+
+Json::Value StatsStorage::statistics()
+{
+    Json::Value value(Json::objectValue);
+    value["select(us)"] = m_selectLatency->toJson();
+    value["batchSelect(us)"] = m_batchSelectLatency->toJson();
+    value["commit(us)"] = m_commitLatency->toJson();
+    value["commitRows"] = m_commitRows->toJson();
+    value["bytesRead"] = (Json::UInt64)m_bytesRead.load();
+    value["bytesWritten"] = (Json::UInt64)m_bytesWritten.load();
+    value["slowOperations"] = (Json::UInt64)m_slowOperations.load();
+    value["slowThreshold(ms)"] = (Json::Int64)m_slowThreshold;
+
+    value["tables"] = Json::Value(Json::objectValue);
+    for (auto& it : m_tableStats)
+    {
+        value["tables"][it.first] = it.second->toJson();
+    }
+
+    return value;
+}
+
+TableAccessStat::Ptr StatsStorage::tableStat(const std::string& table)
+{
+    auto it = m_tableStats.find(table);
+    if (it != m_tableStats.end())
+    {
+        return it->second;
+    }
+
+    return m_tableStats.insert(std::make_pair(table, std::make_shared<TableAccessStat>()))
+        .first->second;
+}
+
+void StatsStorage::recordRead(TableAccessStat::Ptr stat, const Entries::Ptr& entries)
+{
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        bytes += entries->get(i)->capacity();
+    }
+
+    stat->rowsRead.fetch_and_add(entries->size());
+    stat->bytesRead.fetch_and_add(bytes);
+    m_bytesRead.fetch_and_add(bytes);
+}
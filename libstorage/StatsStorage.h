@@ -0,0 +1,132 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StatsStorage.h
+ *  @author ancelmo
+ *  @date 20190906
+ */
+#pragma once
+
+#include "Storage.h"
+#include <json/json.h>
+#include <tbb/atomic.h>
+#include <tbb/concurrent_unordered_map.h>
+
+namespace dev
+{
+namespace storage
+{
+// counts of values in power of two buckets, bucket i holds the values in [2^(i-1), 2^i)
+class Histogram
+{
+public:
+    typedef std::shared_ptr<Histogram> Ptr;
+    Histogram();
+
+    void record(uint64_t value);
+    // upper bound of the bucket holding the given fraction of the values
+    uint64_t percentile(double fraction) const;
+    uint64_t count() const { return m_count; }
+
+    Json::Value toJson() const;
+
+    // the last bucket holds all values from 2^(BUCKETS-2)
+    static const size_t BUCKETS = 32;
+
+private:
+    tbb::atomic<uint64_t> m_count;
+    tbb::atomic<uint64_t> m_total;
+    tbb::atomic<uint64_t> m_max;
+    tbb::atomic<uint64_t> m_buckets[BUCKETS];
+};
+
+// backend access of one table
+class TableAccessStat
+{
+public:
+    typedef std::shared_ptr<TableAccessStat> Ptr;
+    TableAccessStat();
+
+    Json::Value toJson() const;
+
+    tbb::atomic<uint64_t> selects;
+    tbb::atomic<uint64_t> selectTime;  // us
+    tbb::atomic<uint64_t> rowsRead;
+    tbb::atomic<uint64_t> bytesRead;
+    tbb::atomic<uint64_t> commits;
+    tbb::atomic<uint64_t> rowsWritten;
+    tbb::atomic<uint64_t> bytesWritten;
+};
+
+/// Forwards every access to a backend and records the latency of each operation in
+/// microseconds, the rows of each commit, the bytes read and written and the access of each
+/// table. Operations slower than the slow threshold are logged with their table and key.
+class StatsStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<StatsStorage> Ptr;
+
+    StatsStorage();
+    virtual ~StatsStorage(){};
+
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition = nullptr) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
+    size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100) override;
+    void remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys) override;
+    int64_t checkpoint(const std::string& path) override;
+    bool onlyDirty() override;
+    void stop() override;
+
+    void setBackend(Storage::Ptr backend) { m_backend = backend; }
+    Storage::Ptr backend() { return m_backend; }
+    /// ms, 0 disables the slow operation log
+    void setSlowThreshold(int64_t slowThreshold) { m_slowThreshold = slowThreshold; }
+
+    Json::Value statistics();
+
+    Histogram::Ptr selectLatency() { return m_selectLatency; }
+    Histogram::Ptr batchSelectLatency() { return m_batchSelectLatency; }
+    Histogram::Ptr commitLatency() { return m_commitLatency; }
+    Histogram::Ptr commitRows() { return m_commitRows; }
+    TableAccessStat::Ptr tableStat(const std::string& table);
+
+private:
+    void recordRead(TableAccessStat::Ptr stat, const Entries::Ptr& entries);
+    bool slow(uint64_t micros)
+    {
+        return m_slowThreshold > 0 && micros >= (uint64_t)m_slowThreshold * 1000;
+    }
+
+    Storage::Ptr m_backend;
+    int64_t m_slowThreshold = 1000;
+
+    Histogram::Ptr m_selectLatency;
+    Histogram::Ptr m_batchSelectLatency;
+    Histogram::Ptr m_commitLatency;
+    Histogram::Ptr m_commitRows;
+    tbb::atomic<uint64_t> m_bytesRead;
+    tbb::atomic<uint64_t> m_bytesWritten;
+    tbb::atomic<uint64_t> m_slowOperations;
+    tbb::concurrent_unordered_map<std::string, TableAccessStat::Ptr> m_tableStats;
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -20,14 +20,30 @@
  */
 #pragma once
 
+#include "StorageException.h"
 #include "Table.h"
 #include <libdevcore/FixedHash.h>
 #include <libethcore/Protocol.h>
+#include <map>
 
 namespace dev
 {
 namespace storage
 {
+// streams the keys of a table in ascending order, only one batch is held in memory
+class StorageIterator
+{
+public:
+    typedef std::shared_ptr<StorageIterator> Ptr;
+    // keys with their entries, deleted entries are left out and keys without entries skipped
+    typedef std::vector<std::pair<std::string, Entries::Ptr> > Batch;
+
+    virtual ~StorageIterator(){};
+
+    // replace batch with the next keys, false if the range is exhausted
+    virtual bool next(Batch& batch) = 0;
+};
+
 class Storage : public std::enable_shared_from_this<Storage>
 {
 public:
@@ -39,6 +55,97 @@ public:
         const std::string& key, Condition::Ptr condition = nullptr) = 0;
     virtual size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) = 0;
 
+    // select the entries of several keys of a table, the result is in the order of keys, backends
+    // override it to fetch all keys in one access
+    virtual std::vector<Entries::Ptr> batchSelect(
+        h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+    {
+        std::vector<Entries::Ptr> result;
+        result.reserve(keys.size());
+        for (auto& key : keys)
+        {
+            auto condition = std::make_shared<Condition>();
+            condition->EQ(tableInfo->key, key);
+            result.push_back(select(hash, num, tableInfo, key, condition));
+        }
+
+        return result;
+    }
+
+    // iterate the keys in [begin, end) of a table, an empty end is unbounded, batches hold up to
+    // batchSize keys, backends without ordered keys throw StorageException
+    virtual StorageIterator::Ptr scan(TableInfo::Ptr tableInfo, const std::string& begin,
+        const std::string& end, size_t batchSize = 100)
+    {
+        (void)tableInfo;
+        (void)begin;
+        (void)end;
+        (void)batchSize;
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Storage doesn't support scan"));
+    }
+
+    // drop keys of a table with all their entries, it bypasses the status of entries and is only
+    // used to move data between backends, backends that can't delete throw StorageException
+    virtual void remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+    {
+        (void)tableInfo;
+        (void)keys;
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Storage doesn't support remove"));
+    }
+
+    // drop the deleted entries written before num from up to maxKeys keys of a table from key on,
+    // the entries dropped are appended to pruned and key is set to the key to go on from or
+    // emptied once the table is done, returns false without pruning anything if it gives way to
+    // a commit in progress, backends that can't prune throw StorageException
+    virtual bool prune(TableInfo::Ptr tableInfo, std::string& key, int64_t num, size_t maxKeys,
+        StorageIterator::Batch& pruned)
+    {
+        (void)tableInfo;
+        (void)key;
+        (void)num;
+        (void)maxKeys;
+        (void)pruned;
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Storage doesn't support prune"));
+    }
+
+    // replace keys of a table with entries restored from a dump, ids, numbers and status of the
+    // entries are kept, the keys are removed and the entries committed at their own numbers
+    virtual void restore(TableInfo::Ptr tableInfo, const StorageIterator::Batch& rows)
+    {
+        std::vector<std::string> keys;
+        std::map<int64_t, TableData::Ptr> datas;
+        for (auto& row : rows)
+        {
+            keys.push_back(row.first);
+            for (size_t i = 0; i < row.second->size(); ++i)
+            {
+                auto entry = row.second->get(i);
+                auto& data = datas[entry->num()];
+                if (!data)
+                {
+                    data = std::make_shared<TableData>();
+                    data->info = tableInfo;
+                }
+                data->newEntries->addEntry(entry);
+            }
+        }
+
+        remove(tableInfo, keys);
+        for (auto& it : datas)
+        {
+            commit(h256(), it.first, {it.second});
+        }
+    }
+
+    // copy a consistent image of the storage to path, which mustn't exist, returns the number of
+    // the latest block in the copy, -1 if the backend doesn't know it, backends that can't copy
+    // themselves online throw StorageException
+    virtual int64_t checkpoint(const std::string& path)
+    {
+        (void)path;
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Storage doesn't support checkpoint"));
+    }
+
     virtual bool onlyDirty() = 0;
 
     void setGroupID(dev::GROUP_ID const& groupID) { m_groupID = groupID; }
@@ -0,0 +1,344 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StoragePruner.cpp
+ *  @brief drops the deleted rows and the block bodies older than a retention window
+ */
+
+#include "StoragePruner.h"
+#include "Common.h"
+#include "StorageException.h"
+#include <libdevcore/easylog.h>
+#include <boost/lexical_cast.hpp>
+#include <map>
+#include <set>
+
+using namespace dev;
+using namespace dev::storage;
+
+const std::string StoragePruner::PRUNE_TABLE = "_sys_prune_";
+
+namespace
+{
+// tables of the blocks, they are only appended and never have deleted rows
+const std::set<std::string> c_blockTables{SYS_HASH_2_BLOCK, SYS_NUMBER_2_HASH,
+    SYS_TX_HASH_2_BLOCK, SYS_BLOCK_2_NONCES, SYS_LOG_INDEX, SYS_BLOCK_2_BLOOM};
+
+TableInfo::Ptr tableInfo(const std::string& name, const std::string& key)
+{
+    auto info = std::make_shared<TableInfo>();
+    info->name = name;
+    info->key = key;
+    info->fields = std::vector<std::string>{SYS_VALUE};
+    return info;
+}
+}  // namespace
+
+StoragePruner::StoragePruner()
+{
+    m_running = std::make_shared<tbb::atomic<bool> >();
+    m_running->store(true);
+}
+
+StoragePruner::~StoragePruner()
+{
+    if (m_running->load())
+    {
+        stop();
+    }
+}
+
+void StoragePruner::init()
+{
+    // the blocks pruned before a restart are not visited again
+    auto out = m_backend->select(h256(), 0, pruneTableInfo(), "block");
+    if (out->size() > 0)
+    {
+        m_prunedBlock = boost::lexical_cast<int64_t>(out->get(0)->getField(SYS_VALUE));
+    }
+
+    STORAGE_LOG(INFO) << LOG_BADGE("StoragePruner") << LOG_DESC("init")
+                      << LOG_KV("prunedBlock", m_prunedBlock)
+                      << LOG_KV("retainBlocks", m_retainBlocks)
+                      << LOG_KV("retainStateBlocks", m_retainStateBlocks)
+                      << LOG_KV("keysPerSecond", m_keysPerSecond)
+                      << LOG_KV("archive", m_archive != nullptr);
+
+    startPruneThread();
+}
+
+void StoragePruner::stop()
+{
+    STORAGE_LOG(INFO) << LOG_BADGE("StoragePruner") << LOG_DESC("Stopping prune thread");
+    m_running->store(false);
+    m_pruneSignal.notify_all();
+
+    if (m_pruneThread)
+    {
+        if (m_pruneThread->get_id() != std::this_thread::get_id())
+        {
+            m_pruneThread->join();
+            m_pruneThread.reset();
+        }
+        else
+        {
+            m_pruneThread->detach();
+        }
+    }
+}
+
+size_t StoragePruner::prune(size_t maxKeys)
+{
+    auto num = committedNum();
+    size_t keys = 0;
+    if (m_retainBlocks > 0)
+    {
+        keys += pruneBlocks(num, maxKeys);
+    }
+    if (m_retainStateBlocks > 0 && keys < maxKeys)
+    {
+        keys += pruneState(num, maxKeys - keys);
+    }
+
+    if (keys > 0)
+    {
+        STORAGE_LOG(DEBUG) << LOG_BADGE("StoragePruner") << LOG_DESC("prune")
+                           << LOG_KV("keys", keys) << LOG_KV("committedNum", num)
+                           << LOG_KV("prunedBlock", m_prunedBlock);
+    }
+    return keys;
+}
+
+size_t StoragePruner::pruneBlocks(int64_t committedNum, size_t maxKeys)
+{
+    auto number2Hash = tableInfo(SYS_NUMBER_2_HASH, "number");
+    auto hash2Block = tableInfo(SYS_HASH_2_BLOCK, "hash");
+    auto block2Nonces = tableInfo(SYS_BLOCK_2_NONCES, "number");
+
+    // the genesis block is read on every start
+    int64_t num = std::max(m_prunedBlock, (int64_t)0);
+    size_t keys = 0;
+    for (; num + 1 <= committedNum - m_retainBlocks && keys < maxKeys && m_running->load(); ++keys)
+    {
+        ++num;
+        auto numKey = boost::lexical_cast<std::string>(num);
+        auto hashes = m_backend->select(h256(), num, number2Hash, numKey);
+        if (hashes->size() == 0)
+        {
+            continue;
+        }
+        auto hashKey = hashes->get(0)->getField(SYS_VALUE);
+
+        if (m_archive)
+        {
+            std::vector<TableData::Ptr> datas;
+            for (auto const& it : {std::make_pair(hash2Block, hashKey),
+                     std::make_pair(block2Nonces, numKey)})
+            {
+                auto data = std::make_shared<TableData>();
+                data->info = it.first;
+                auto rows = m_backend->select(h256(), num, it.first, it.second);
+                for (size_t i = 0; i < rows->size(); ++i)
+                {
+                    data->newEntries->addEntry(rows->get(i));
+                }
+                if (data->newEntries->size() > 0)
+                {
+                    datas.push_back(data);
+                }
+            }
+            // a crash before the keys are removed archives them again, which rewrites the rows
+            if (!datas.empty())
+            {
+                m_archive->commit(h256(hashKey), num, datas);
+            }
+        }
+
+        m_backend->remove(hash2Block, {hashKey});
+        m_backend->remove(block2Nonces, {numKey});
+    }
+
+    if (num > m_prunedBlock)
+    {
+        m_prunedBlock = num;
+        auto data = std::make_shared<TableData>();
+        data->info = pruneTableInfo();
+        auto entry = std::make_shared<Entry>();
+        entry->setField(SYS_KEY, "block");
+        entry->setField(SYS_VALUE, boost::lexical_cast<std::string>(num));
+        entry->setForce(true);
+        data->newEntries->addEntry(entry);
+        m_backend->commit(h256(), num, {data});
+    }
+    return keys;
+}
+
+size_t StoragePruner::pruneState(int64_t committedNum, size_t maxKeys)
+{
+    int64_t num = committedNum - m_retainStateBlocks;
+    if (num <= 0)
+    {
+        return 0;
+    }
+
+    size_t keys = 0;
+    // a batch is small enough not to hold a commit long
+    size_t batchSize = std::min(maxKeys, (size_t)100);
+    while (keys < maxKeys && m_running->load())
+    {
+        if (m_stateTable >= m_stateTables.size())
+        {
+            loadStateTables();
+            if (m_stateTables.empty())
+            {
+                break;
+            }
+        }
+
+        auto table = m_stateTables[m_stateTable];
+        StorageIterator::Batch pruned;
+        if (!m_backend->prune(table, m_stateKey, num, batchSize, pruned))
+        {
+            // a commit is in progress, go on in the next round
+            break;
+        }
+        // only deleted rows are dropped, a crash before they are archived loses them
+        if (m_archive && !pruned.empty())
+        {
+            archive(table, pruned);
+        }
+        keys += batchSize;
+        if (m_stateKey.empty())
+        {
+            ++m_stateTable;
+            if (m_stateTable >= m_stateTables.size())
+            {
+                // all tables are done until the next round
+                break;
+            }
+        }
+    }
+    return keys;
+}
+
+void StoragePruner::archive(TableInfo::Ptr tableInfo, const StorageIterator::Batch& rows)
+{
+    std::map<int64_t, TableData::Ptr> datas;
+    for (auto& row : rows)
+    {
+        for (size_t i = 0; i < row.second->size(); ++i)
+        {
+            auto entry = row.second->get(i);
+            auto& data = datas[entry->num()];
+            if (!data)
+            {
+                data = std::make_shared<TableData>();
+                data->info = tableInfo;
+            }
+            data->newEntries->addEntry(entry);
+        }
+    }
+
+    for (auto& it : datas)
+    {
+        m_archive->commit(h256(), it.first, {it.second});
+    }
+}
+
+int64_t StoragePruner::committedNum()
+{
+    auto out = m_backend->select(
+        h256(), 0, tableInfo(SYS_CURRENT_STATE, SYS_KEY), SYS_KEY_CURRENT_NUMBER);
+    if (out->size() == 0)
+    {
+        return 0;
+    }
+    return boost::lexical_cast<int64_t>(out->get(0)->getField(SYS_VALUE));
+}
+
+void StoragePruner::loadStateTables()
+{
+    m_stateTables.clear();
+    m_stateTable = 0;
+    m_stateKey.clear();
+
+    auto sysTables = std::make_shared<TableInfo>();
+    sysTables->name = SYS_TABLES;
+    sysTables->key = "table_name";
+    sysTables->fields = std::vector<std::string>{"key_field", "value_field", "index_field"};
+    m_stateTables.push_back(sysTables);
+
+    auto it = m_backend->scan(sysTables, "", "");
+    StorageIterator::Batch batch;
+    while (it->next(batch))
+    {
+        for (auto& item : batch)
+        {
+            if (c_blockTables.count(item.first) || item.first == PRUNE_TABLE ||
+                item.second->size() == 0)
+            {
+                continue;
+            }
+            m_stateTables.push_back(
+                tableInfo(item.first, item.second->get(0)->getField("key_field")));
+        }
+    }
+}
+
+TableInfo::Ptr StoragePruner::pruneTableInfo()
+{
+    return tableInfo(PRUNE_TABLE, SYS_KEY);
+}
+
+void StoragePruner::startPruneThread()
+{
+    std::weak_ptr<StoragePruner> self(shared_from_this());
+    auto running = m_running;
+    m_pruneThread = std::make_shared<std::thread>([running, self]() {
+        while (running->load())
+        {
+            auto pruner = self.lock();
+            if (!pruner)
+            {
+                return;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(pruner->m_pruneMutex);
+                pruner->m_pruneSignal.wait_for(
+                    lock, std::chrono::milliseconds(pruner->m_pruneInterval));
+            }
+
+            if (!running->load())
+            {
+                return;
+            }
+
+            try
+            {
+                // the keys of a round are bounded by the rate
+                pruner->prune(std::max(
+                    pruner->m_keysPerSecond * pruner->m_pruneInterval / 1000, (size_t)1));
+            }
+            catch (std::exception& e)
+            {
+                // the progress is kept, the keys are pruned by the next round
+                STORAGE_LOG(ERROR) << LOG_BADGE("StoragePruner") << LOG_DESC("prune failed")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
+            }
+        }
+    });
+}
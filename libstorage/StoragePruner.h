@@ -0,0 +1,98 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file StoragePruner.h
+ *  @brief drops the deleted rows and the block bodies older than a retention window
+ */
+#pragma once
+
+#include "Storage.h"
+#include <tbb/atomic.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace dev
+{
+namespace storage
+{
+/// Prunes a backend that supports scan, remove and prune in the background. The bodies and the
+/// nonces of the blocks older than retainBlocks are removed, the number to hash index and the
+/// transaction index stay, and the rows deleted more than retainStateBlocks blocks ago are
+/// dropped from the state tables. The data pruned is committed to the archive backend first if
+/// there is one. Each round prunes at most keysPerSecond keys a second in small batches that
+/// give way to the commits of the backend.
+class StoragePruner : public std::enable_shared_from_this<StoragePruner>
+{
+public:
+    typedef std::shared_ptr<StoragePruner> Ptr;
+
+    StoragePruner();
+    virtual ~StoragePruner();
+
+    void setBackend(Storage::Ptr backend) { m_backend = backend; }
+    void setArchive(Storage::Ptr archive) { m_archive = archive; }
+    /// blocks whose bodies are kept, 0 keeps all
+    void setRetainBlocks(int64_t retainBlocks) { m_retainBlocks = retainBlocks; }
+    /// blocks the deleted rows are kept for, 0 keeps all
+    void setRetainStateBlocks(int64_t retainStateBlocks)
+    {
+        m_retainStateBlocks = retainStateBlocks;
+    }
+    void setKeysPerSecond(size_t keysPerSecond) { m_keysPerSecond = keysPerSecond; }
+
+    void init();
+    void stop();
+
+    /// prune up to maxKeys keys, returns the keys pruned
+    size_t prune(size_t maxKeys);
+
+    int64_t prunedBlock() const { return m_prunedBlock; }
+
+    static const std::string PRUNE_TABLE;
+
+private:
+    size_t pruneBlocks(int64_t committedNum, size_t maxKeys);
+    size_t pruneState(int64_t committedNum, size_t maxKeys);
+    /// commit the entries to the archive at their own numbers
+    void archive(TableInfo::Ptr tableInfo, const StorageIterator::Batch& rows);
+    int64_t committedNum();
+    /// the tables of the state, reloaded once all of them are pruned
+    void loadStateTables();
+    TableInfo::Ptr pruneTableInfo();
+    void startPruneThread();
+
+    Storage::Ptr m_backend;
+    Storage::Ptr m_archive;
+    int64_t m_retainBlocks = 0;
+    int64_t m_retainStateBlocks = 0;
+    size_t m_keysPerSecond = 1000;
+
+    int64_t m_prunedBlock = 0;
+    std::vector<TableInfo::Ptr> m_stateTables;
+    size_t m_stateTable = 0;
+    std::string m_stateKey;
+
+    std::shared_ptr<tbb::atomic<bool> > m_running;
+    std::shared_ptr<std::thread> m_pruneThread;
+    std::mutex m_pruneMutex;
+    std::condition_variable m_pruneSignal;
+    int64_t m_pruneInterval = 1000;  // ms
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -33,10 +33,39 @@
 #include <tbb/pipeline.h>
 #include <tbb/tbb_thread.h>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 
 using namespace dev::storage;
 
-Entry::Entry() : m_data(std::make_shared<EntryData>())
+AccessOptions::Ptr AccessOptions::defaultOptions()
+{
+    static auto options = std::make_shared<AccessOptions>();
+    return options;
+}
+
+Entry::Fields::iterator Entry::EntryData::lowerBound(const std::string& key)
+{
+    return std::lower_bound(m_fields.begin(), m_fields.end(), key,
+        [](const Fields::value_type& field, const std::string& name) {
+            return field.first < name;
+        });
+}
+
+Entry::Fields::const_iterator Entry::EntryData::find(const std::string& key) const
+{
+    auto it = std::lower_bound(m_fields.begin(), m_fields.end(), key,
+        [](const Fields::value_type& field, const std::string& name) {
+            return field.first < name;
+        });
+    if (it != m_fields.end() && it->first == key)
+    {
+        return it;
+    }
+
+    return m_fields.end();
+}
+
+Entry::Entry() : m_data(makeShared<EntryData>())
 {
     m_data->m_refCount = 1;
     // m_data->m_fields.insert(std::make_pair(STATUS, "0"));
@@ -80,7 +109,7 @@ std::string Entry::getField(const std::string& key) const
 {
     RWMutexScoped lock(m_data->m_mutex, false);
 
-    auto it = m_data->m_fields.find(key);
+    auto it = m_data->find(key);
 
     if (it != m_data->m_fields.end())
     {
@@ -108,9 +137,9 @@ void Entry::setField(const std::string& key, const std::string& value)
 
     auto lock = checkRef();
 
-    auto it = m_data->m_fields.find(key);
+    auto it = m_data->lowerBound(key);
 
-    if (it != m_data->m_fields.end())
+    if (it != m_data->m_fields.end() && it->first == key)
     {
         m_capacity -= (key.size() + it->second.size());
         it->second = value;
@@ -118,7 +147,7 @@ void Entry::setField(const std::string& key, const std::string& value)
     }
     else
     {
-        m_data->m_fields.insert(std::make_pair(key, value));
+        m_data->m_fields.insert(it, std::make_pair(key, value));
         m_capacity += (key.size() + value.size());
     }
 
@@ -126,6 +155,19 @@ void Entry::setField(const std::string& key, const std::string& value)
     m_dirty = true;
 }
 
+void Entry::setFields(Fields&& fields)
+{
+    auto lock = checkRef();
+
+    m_capacity = 0;
+    for (auto& field : fields)
+    {
+        m_capacity += (field.first.size() + field.second.size());
+    }
+    m_data->m_fields = std::move(fields);
+    m_dirty = true;
+}
+
 size_t Entry::getTempIndex() const
 {
     RWMutexScoped lock(m_data->m_mutex, false);
@@ -140,17 +182,17 @@ void Entry::setTempIndex(size_t index)
     m_tempIndex = index;
 }
 
-std::map<std::string, std::string>::const_iterator Entry::find(const std::string& key) const
+Entry::Fields::const_iterator Entry::find(const std::string& key) const
 {
-    return m_data->m_fields.find(key);
+    return m_data->find(key);
 }
 
-std::map<std::string, std::string>::const_iterator Entry::begin() const
+Entry::Fields::const_iterator Entry::begin() const
 {
     return m_data->m_fields.begin();
 }
 
-std::map<std::string, std::string>::const_iterator Entry::end() const
+Entry::Fields::const_iterator Entry::end() const
 {
     return m_data->m_fields.end();
 }
@@ -337,7 +379,7 @@ std::shared_ptr<tbb::spin_rw_mutex::scoped_lock> Entry::checkRef()
     if (m_data->m_refCount > 1)
     {
         auto m_oldData = m_data;
-        m_data = std::make_shared<EntryData>();
+        m_data = makeShared<EntryData>();
 
         m_data->m_refCount = 1;
         m_data->m_fields = m_oldData->m_fields;
@@ -776,3 +818,112 @@ bool Condition::related(Condition::Ptr condition)
 
     return false;
 }
+
+EntriesIndex::EntriesIndex(const Entries& entries, const std::string& field) : m_field(field)
+{
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto entry = entries.get(i);
+        if (!entry)
+        {
+            continue;
+        }
+
+        auto fieldIt = entry->find(field);
+        if (fieldIt == entry->end())
+        {
+            continue;
+        }
+        m_values[fieldIt->second].push_back(i);
+
+        int64_t number = 0;
+        if (fieldIt->second.empty() ||
+            boost::conversion::try_lexical_convert(fieldIt->second, number))
+        {
+            m_numbers.emplace(number, i);
+        }
+    }
+}
+
+std::string EntriesIndex::indexField(
+    const Condition::Ptr& condition, const std::vector<std::string>& indices)
+{
+    std::string rangeField;
+    for (auto it = condition->begin(); it != condition->end(); ++it)
+    {
+        if (std::find(indices.begin(), indices.end(), it->first) == indices.end())
+        {
+            continue;
+        }
+
+        auto& range = it->second;
+        if (range.left.first && range.right.first && range.left.second == range.right.second)
+        {
+            return it->first;
+        }
+        if (rangeField.empty() && (range.left.second != condition->unlimitedField() ||
+                                      range.right.second != condition->unlimitedField()))
+        {
+            rangeField = it->first;
+        }
+    }
+    return rangeField;
+}
+
+std::vector<size_t> EntriesIndex::find(const Condition::Ptr& condition) const
+{
+    std::vector<size_t> positions;
+    auto it = condition->begin();
+    while (it != condition->end() && it->first != m_field)
+    {
+        ++it;
+    }
+    if (it == condition->end())
+    {
+        return positions;
+    }
+
+    auto& range = it->second;
+    if (range.left.first && range.right.first && range.left.second == range.right.second)
+    {
+        auto valueIt = m_values.find(range.left.second);
+        if (valueIt != m_values.end())
+        {
+            positions = valueIt->second;
+        }
+        return positions;
+    }
+
+    // a bound which isn't a number fails Condition::process for every entry
+    auto begin = m_numbers.begin();
+    auto end = m_numbers.end();
+    int64_t bound = 0;
+    if (range.left.second != condition->unlimitedField())
+    {
+        if (!boost::conversion::try_lexical_convert(range.left.second, bound))
+        {
+            return positions;
+        }
+        begin = range.left.first ? m_numbers.lower_bound(bound) : m_numbers.upper_bound(bound);
+    }
+    if (range.right.second != condition->unlimitedField())
+    {
+        if (!boost::conversion::try_lexical_convert(range.right.second, bound))
+        {
+            return positions;
+        }
+        end = range.right.first ? m_numbers.upper_bound(bound) : m_numbers.lower_bound(bound);
+    }
+
+    // both bounds point to the first entry of a number, an empty range may start after its end
+    if (begin == m_numbers.end() || (end != m_numbers.end() && begin->first > end->first))
+    {
+        return positions;
+    }
+    for (auto numberIt = begin; numberIt != end; ++numberIt)
+    {
+        positions.push_back(numberIt->second);
+    }
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
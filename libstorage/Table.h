@@ -23,18 +23,28 @@
 #include <libdevcore/Guards.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/scalable_allocator.h>
 #include <tbb/spin_rw_mutex.h>
 #include <tbb/tbb_allocator.h>
 #include <atomic>
 #include <map>
 #include <memory>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
 {
 namespace storage
 {
+/// Objects created for every executed transaction are allocated from the tbb scalable
+/// allocator, it serves them from per-thread pools instead of contending on the global heap
+template <typename T, typename... Args>
+std::shared_ptr<T> makeShared(Args&&... _args)
+{
+    return std::allocate_shared<T>(tbb::scalable_allocator<T>(), std::forward<Args>(_args)...);
+}
+
 struct TableInfo : public std::enable_shared_from_this<TableInfo>
 {
     typedef std::shared_ptr<TableInfo> Ptr;
@@ -43,6 +53,7 @@ struct TableInfo : public std::enable_shared_from_this<TableInfo>
     std::string key;
     std::vector<std::string> fields;
     std::vector<Address> authorizedAddress;
+    // value fields with a secondary index, declared when the table is created
     std::vector<std::string> indices;
 };
 
@@ -51,6 +62,8 @@ struct AccessOptions : public std::enable_shared_from_this<AccessOptions>
     typedef std::shared_ptr<AccessOptions> Ptr;
     AccessOptions() = default;
     AccessOptions(Address _origin, bool _check = true) : origin(_origin), check(_check) {}
+    /// shared by the calls without options, so they don't allocate on every write
+    static Ptr defaultOptions();
     Address origin;
     bool check = true;
 };
@@ -70,6 +83,10 @@ public:
     typedef tbb::spin_rw_mutex RWMutex;
     typedef tbb::spin_rw_mutex::scoped_lock RWMutexScoped;
 
+    // fields are kept contiguous and sorted by name, entries of a table share the same columns
+    // so a column sits at the same index of every entry, and the order is the same as std::map
+    typedef std::vector<std::pair<std::string, std::string> > Fields;
+
     Entry();
     virtual ~Entry();
 
@@ -79,14 +96,16 @@ public:
 
     virtual std::string getField(const std::string& key) const;
     virtual void setField(const std::string& key, const std::string& value);
+    // replace the fields with fields already sorted by name, as they are decoded from the db
+    virtual void setFields(Fields&& fields);
 
     virtual size_t getTempIndex() const;
     virtual void setTempIndex(size_t index);
 
-    virtual std::map<std::string, std::string>::const_iterator find(const std::string& key) const;
+    virtual Fields::const_iterator find(const std::string& key) const;
 
-    virtual std::map<std::string, std::string>::const_iterator begin() const;
-    virtual std::map<std::string, std::string>::const_iterator end() const;
+    virtual Fields::const_iterator begin() const;
+    virtual Fields::const_iterator end() const;
 
     virtual size_t size() const;
 
@@ -124,8 +143,11 @@ private:
         EntryData(){};
 
         ssize_t m_refCount = 0;
-        std::map<std::string, std::string> m_fields;
+        Fields m_fields;
         RWMutex m_mutex;
+
+        Fields::iterator lowerBound(const std::string& key);
+        Fields::const_iterator find(const std::string& key) const;
     };
 
     std::shared_ptr<RWMutexScoped> checkRef();
@@ -249,6 +271,29 @@ private:
     const std::string UNLIMITED = "_VALUE_UNLIMITED_";
 };
 
+// secondary index of one field over the entries of a key, it narrows the entries a condition
+// has to process, the candidates still have to pass Condition::process
+class EntriesIndex
+{
+public:
+    typedef std::shared_ptr<EntriesIndex> Ptr;
+    EntriesIndex(const Entries& entries, const std::string& field);
+
+    // the indexed field the condition should be looked up by, EQ first, then bounded ranges,
+    // empty if the condition has none
+    static std::string indexField(
+        const Condition::Ptr& condition, const std::vector<std::string>& indices);
+
+    // ascending positions of the entries which may satisfy the condition of the field
+    std::vector<size_t> find(const Condition::Ptr& condition) const;
+
+private:
+    std::string m_field;
+    std::unordered_map<std::string, std::vector<size_t> > m_values;
+    // range conditions compare as int64, see Condition::process
+    std::multimap<int64_t, size_t> m_numbers;
+};
+
 class Table;
 
 struct Change
@@ -291,8 +336,8 @@ public:
     TableData()
     {
         info = std::make_shared<TableInfo>();
-        dirtyEntries = std::make_shared<Entries>();
-        newEntries = std::make_shared<Entries>();
+        dirtyEntries = makeShared<Entries>();
+        newEntries = makeShared<Entries>();
     }
 
     // for memorytable2
@@ -314,15 +359,27 @@ public:
 
     virtual ~Table() = default;
 
-    virtual Entry::Ptr newEntry() { return std::make_shared<Entry>(); }
-    virtual Condition::Ptr newCondition() { return std::make_shared<Condition>(); }
+    virtual Entry::Ptr newEntry() { return makeShared<Entry>(); }
+    virtual Condition::Ptr newCondition() { return makeShared<Condition>(); }
     virtual Entries::ConstPtr select(const std::string& key, Condition::Ptr condition) = 0;
+    // select all entries of several keys, the result is in the order of keys, tables override it
+    // to resolve the keys missing in memory with one access to the storage
+    virtual std::vector<Entries::ConstPtr> batchSelect(const std::vector<std::string>& keys)
+    {
+        std::vector<Entries::ConstPtr> result;
+        result.reserve(keys.size());
+        for (auto& key : keys)
+        {
+            result.push_back(select(key, newCondition()));
+        }
+        return result;
+    }
     virtual int update(const std::string& key, Entry::Ptr entry, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) = 0;
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) = 0;
     virtual int insert(const std::string& key, Entry::Ptr entry,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>(), bool needSelect = true) = 0;
+        AccessOptions::Ptr options = AccessOptions::defaultOptions(), bool needSelect = true) = 0;
     virtual int remove(const std::string& key, Condition::Ptr condition,
-        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) = 0;
+        AccessOptions::Ptr options = AccessOptions::defaultOptions()) = 0;
     virtual bool checkAuthority(Address const& _origin) const = 0;
     virtual h256 hash() = 0;
     virtual void clear() = 0;
@@ -341,6 +398,7 @@ public:
     virtual void setBlockHash(h256 blockHash) = 0;
     virtual void setBlockNum(int blockNum) = 0;
     virtual void setTableInfo(TableInfo::Ptr tableInfo) { m_tableInfo = tableInfo; };
+    virtual TableInfo::Ptr tableInfo() { return m_tableInfo; }
     virtual size_t cacheSize() { return 0; }
 
 protected:
@@ -359,9 +417,10 @@ public:
 
     virtual Table::Ptr openTable(
         const std::string& table, bool authorityFlag = true, bool isPara = true) = 0;
+    // indexField lists the value fields with a secondary index, separated by ','
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
         const std::string& valueField, bool authorityFlag, Address const& _origin = Address(),
-        bool isPara = true) = 0;
+        bool isPara = true, const std::string& indexField = std::string()) = 0;
 
     virtual h256 hash() = 0;
     virtual size_t savepoint() = 0;
@@ -378,6 +437,9 @@ public:
     virtual ~TableFactoryFactory(){};
 
     virtual TableFactory::Ptr newTableFactory(dev::h256 hash, int64_t number) = 0;
+    // a table factory reading and committing through storage instead of the storage of this one
+    virtual TableFactory::Ptr newTableFactory(
+        dev::h256 hash, int64_t number, std::shared_ptr<Storage> storage) = 0;
 };
 
 }  // namespace storage
@@ -40,11 +40,14 @@ using namespace dev::storage;
 
 const char* const TABLE_METHOD_OPT_STR = "openTable(string)";
 const char* const TABLE_METHOD_CRT_STR_STR = "createTable(string,string,string)";
+const char* const TABLE_METHOD_CRT_STR_STR_STR = "createTable(string,string,string,string)";
 
 TableFactoryPrecompiled::TableFactoryPrecompiled()
 {
-    name2Selector[TABLE_METHOD_OPT_STR] = getFuncSelector(TABLE_METHOD_OPT_STR);
-    name2Selector[TABLE_METHOD_CRT_STR_STR] = getFuncSelector(TABLE_METHOD_CRT_STR_STR);
+    registerMethod(TABLE_METHOD_OPT_STR, &TableFactoryPrecompiled::openTableCall);
+    registerMethod(TABLE_METHOD_CRT_STR_STR, &TableFactoryPrecompiled::createTableCall);
+    registerMethod(
+        TABLE_METHOD_CRT_STR_STR_STR, &TableFactoryPrecompiled::createIndexedTableCall);
 }
 
 std::string TableFactoryPrecompiled::toString()
@@ -78,98 +81,135 @@ bytes TableFactoryPrecompiled::call(
     STORAGE_LOG(TRACE) << LOG_BADGE("TableFactoryPrecompiled") << LOG_DESC("call")
                        << LOG_KV("param", toHex(param));
 
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("TableFactoryPrecompiled")
+                           << LOG_DESC("call undefined function")
+                           << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void TableFactoryPrecompiled::openTableCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // openTable(string)
     dev::eth::ContractABI abi;
-    bytes out;
+    string tableName;
+    abi.abiOut(data, tableName);
+    tableName = storage::USER_TABLE_PREFIX + tableName;
+    Address address;
+    auto table = m_memoryTableFactory->openTable(tableName);
+    if (table)
+    {
+        TablePrecompiled::Ptr tablePrecompiled = make_shared<TablePrecompiled>();
+        tablePrecompiled->setTable(table);
+        address = context->registerPrecompiled(tablePrecompiled);
+    }
+    else
+    {
+        STORAGE_LOG(WARNING) << LOG_BADGE("TableFactoryPrecompiled")
+                             << LOG_DESC("Open new table failed")
+                             << LOG_KV("table name", tableName);
+    }
 
-    if (func == name2Selector[TABLE_METHOD_OPT_STR])
-    {  // openTable(string)
-        string tableName;
-        abi.abiOut(data, tableName);
-        tableName = storage::USER_TABLE_PREFIX + tableName;
-        Address address;
-        auto table = m_memoryTableFactory->openTable(tableName);
-        if (table)
-        {
-            TablePrecompiled::Ptr tablePrecompiled = make_shared<TablePrecompiled>();
-            tablePrecompiled->setTable(table);
-            address = context->registerPrecompiled(tablePrecompiled);
-        }
-        else
-        {
-            STORAGE_LOG(WARNING) << LOG_BADGE("TableFactoryPrecompiled")
-                                 << LOG_DESC("Open new table failed")
-                                 << LOG_KV("table name", tableName);
-        }
+    out = abi.abiIn("", address);
+}
 
-        out = abi.abiIn("", address);
-    }
-    else if (func == name2Selector[TABLE_METHOD_CRT_STR_STR])
-    {  // createTable(string,string,string)
-        string tableName;
-        string keyField;
-        string valueFiled;
+void TableFactoryPrecompiled::createTableCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // createTable(string,string,string)
+    dev::eth::ContractABI abi;
+    string tableName;
+    string keyField;
+    string valueFiled;
+    abi.abiOut(data, tableName, keyField, valueFiled);
+    createUserTable(tableName, keyField, valueFiled, string(), origin, out);
+}
 
-        abi.abiOut(data, tableName, keyField, valueFiled);
-        vector<string> fieldNameList;
-        boost::split(fieldNameList, valueFiled, boost::is_any_of(","));
-        for (auto& str : fieldNameList)
-        {
-            boost::trim(str);
-            if (str.size() > 64)
-            {  // mysql TableName and fieldName length limit is 64
-                BOOST_THROW_EXCEPTION(StorageException(
-                    CODE_TABLE_FILED_LENGTH_OVERFLOW, "table field name length overflow 64"));
-            }
-        }
-        valueFiled = boost::join(fieldNameList, ",");
-        if (valueFiled.size() > 1024)
-        {
-            BOOST_THROW_EXCEPTION(StorageException(CODE_TABLE_FILED_TOTALLENGTH_OVERFLOW,
-                "total table field name length overflow 64"));
-        }
+void TableFactoryPrecompiled::createIndexedTableCall(
+    ExecutiveContext::Ptr, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // createTable(string,string,string,string)
+    if (g_BCOSConfig.version() < V2_1_0)
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("TableFactoryPrecompiled")
+                           << LOG_DESC("call undefined function")
+                           << LOG_KV("func", TABLE_METHOD_CRT_STR_STR_STR);
+        return;
+    }
+    dev::eth::ContractABI abi;
+    string tableName;
+    string keyField;
+    string valueFiled;
+    string indexField;
+    // the last parameter lists the value fields with a secondary index
+    abi.abiOut(data, tableName, keyField, valueFiled, indexField);
+    vector<string> indexList;
+    boost::split(indexList, indexField, boost::is_any_of(","));
+    for (auto& str : indexList)
+    {
+        boost::trim(str);
+    }
+    indexField = boost::join(indexList, ",");
+    createUserTable(tableName, keyField, valueFiled, indexField, origin, out);
+}
 
-        tableName = storage::USER_TABLE_PREFIX + tableName;
-        if (tableName.size() > 64)
+void TableFactoryPrecompiled::createUserTable(string tableName, string const& keyField,
+    string valueFiled, string const& indexField, Address const& origin, bytes& out)
+{
+    vector<string> fieldNameList;
+    boost::split(fieldNameList, valueFiled, boost::is_any_of(","));
+    for (auto& str : fieldNameList)
+    {
+        boost::trim(str);
+        if (str.size() > 64)
         {  // mysql TableName and fieldName length limit is 64
-            BOOST_THROW_EXCEPTION(
-                StorageException(CODE_TABLE_NAME_LENGTH_OVERFLOW, "tableName length overflow 64"));
+            BOOST_THROW_EXCEPTION(StorageException(
+                CODE_TABLE_FILED_LENGTH_OVERFLOW, "table field name length overflow 64"));
         }
-        int result = 0;
+    }
+    valueFiled = boost::join(fieldNameList, ",");
+    if (valueFiled.size() > 1024)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(CODE_TABLE_FILED_TOTALLENGTH_OVERFLOW,
+            "total table field name length overflow 64"));
+    }
 
-        if (g_BCOSConfig.version() < RC2_VERSION)
-        {  // RC1 success result is 1
-            result = 1;
-        }
-        try
-        {
-            auto table =
-                m_memoryTableFactory->createTable(tableName, keyField, valueFiled, true, origin);
-            if (!table)
-            {  // table already exist
-                result = CODE_TABLE_NAME_ALREADY_EXIST;
-                /// RC1 table already exist: 0
-                if (g_BCOSConfig.version() < RC2_VERSION)
-                {
-                    result = 0;
-                }
+    tableName = storage::USER_TABLE_PREFIX + tableName;
+    if (tableName.size() > 64)
+    {  // mysql TableName and fieldName length limit is 64
+        BOOST_THROW_EXCEPTION(
+            StorageException(CODE_TABLE_NAME_LENGTH_OVERFLOW, "tableName length overflow 64"));
+    }
+    int result = 0;
+
+    if (g_BCOSConfig.version() < RC2_VERSION)
+    {  // RC1 success result is 1
+        result = 1;
+    }
+    try
+    {
+        auto table = m_memoryTableFactory->createTable(
+            tableName, keyField, valueFiled, true, origin, true, indexField);
+        if (!table)
+        {  // table already exist
+            result = CODE_TABLE_NAME_ALREADY_EXIST;
+            /// RC1 table already exist: 0
+            if (g_BCOSConfig.version() < RC2_VERSION)
+            {
+                result = 0;
             }
         }
-        catch (dev::storage::StorageException& e)
-        {
-            STORAGE_LOG(ERROR) << "Create table failed: " << boost::diagnostic_information(e);
-            result = e.errorCode();
-        }
-        getErrorCodeOut(out, result);
     }
-    else
+    catch (dev::storage::StorageException& e)
     {
-        STORAGE_LOG(ERROR) << LOG_BADGE("TableFactoryPrecompiled")
-                           << LOG_DESC("call undefined function!");
+        STORAGE_LOG(ERROR) << "Create table failed: " << boost::diagnostic_information(e);
+        result = e.errorCode();
     }
-    return out;
+    getErrorCodeOut(out, result);
 }
 
 h256 TableFactoryPrecompiled::hash()
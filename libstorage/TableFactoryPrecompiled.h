@@ -67,6 +67,16 @@ public:
     h256 hash();
 
 private:
+    void openTableCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void createTableCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void createIndexedTableCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    // creates the user table, out holds the error code
+    void createUserTable(std::string tableName, std::string const& keyField,
+        std::string valueFiled, std::string const& indexField, Address const& origin, bytes& out);
+
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
 };
 
@@ -41,12 +41,12 @@ const char* const TABLE_METHOD_UP_STR_2ADD = "update(string,address,address)";
 
 TablePrecompiled::TablePrecompiled()
 {
-    name2Selector[TABLE_METHOD_SLT_STR_ADD] = getFuncSelector(TABLE_METHOD_SLT_STR_ADD);
-    name2Selector[TABLE_METHOD_INS_STR_ADD] = getFuncSelector(TABLE_METHOD_INS_STR_ADD);
-    name2Selector[TABLE_METHOD_NEWCOND] = getFuncSelector(TABLE_METHOD_NEWCOND);
-    name2Selector[TABLE_METHOD_NEWENT] = getFuncSelector(TABLE_METHOD_NEWENT);
-    name2Selector[TABLE_METHOD_RE_STR_ADD] = getFuncSelector(TABLE_METHOD_RE_STR_ADD);
-    name2Selector[TABLE_METHOD_UP_STR_2ADD] = getFuncSelector(TABLE_METHOD_UP_STR_2ADD);
+    registerMethod(TABLE_METHOD_SLT_STR_ADD, &TablePrecompiled::selectCall);
+    registerMethod(TABLE_METHOD_INS_STR_ADD, &TablePrecompiled::insertCall);
+    registerMethod(TABLE_METHOD_NEWCOND, &TablePrecompiled::newConditionCall);
+    registerMethod(TABLE_METHOD_NEWENT, &TablePrecompiled::newEntryCall);
+    registerMethod(TABLE_METHOD_RE_STR_ADD, &TablePrecompiled::removeCall);
+    registerMethod(TABLE_METHOD_UP_STR_2ADD, &TablePrecompiled::updateCall);
 }
 
 std::string TablePrecompiled::toString()
@@ -60,99 +60,115 @@ bytes TablePrecompiled::call(
     STORAGE_LOG(TRACE) << LOG_BADGE("TablePrecompiled") << LOG_DESC("call")
                        << LOG_KV("param", toHex(param));
 
-    uint32_t func = getParamFunc(param);
-    bytesConstRef data = getParamData(param);
+    bytes out;
+    if (!dispatch(context, param, origin, out))
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("TablePrecompiled") << LOG_DESC("call undefined function")
+                           << LOG_KV("func", getParamFunc(param));
+    }
+    return out;
+}
 
+void TablePrecompiled::selectCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const&, bytes& out)
+{
+    // select(string,address)
     dev::eth::ContractABI abi;
+    std::string key;
+    Address conditionAddress;
+    abi.abiOut(data, key, conditionAddress);
 
-    bytes out;
+    ConditionPrecompiled::Ptr conditionPrecompiled =
+        std::dynamic_pointer_cast<ConditionPrecompiled>(context->getPrecompiled(conditionAddress));
+    auto condition = conditionPrecompiled->getCondition();
 
-    if (func == name2Selector[TABLE_METHOD_SLT_STR_ADD])
-    {  // select(string,address)
-        std::string key;
-        Address conditionAddress;
-        abi.abiOut(data, key, conditionAddress);
+    auto entries = m_table->select(key, condition);
+    auto entriesPrecompiled = std::make_shared<EntriesPrecompiled>();
+    entriesPrecompiled->setEntries(entries);
 
-        ConditionPrecompiled::Ptr conditionPrecompiled =
-            std::dynamic_pointer_cast<ConditionPrecompiled>(
-                context->getPrecompiled(conditionAddress));
-        auto condition = conditionPrecompiled->getCondition();
+    auto newAddress = context->registerPrecompiled(entriesPrecompiled);
+    out = abi.abiIn("", newAddress);
+}
+
+void TablePrecompiled::insertCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // insert(string,address)
+    dev::eth::ContractABI abi;
+    std::string key;
+    Address entryAddress;
+    abi.abiOut(data, key, entryAddress);
 
-        auto entries = m_table->select(key, condition);
-        auto entriesPrecompiled = std::make_shared<EntriesPrecompiled>();
-        entriesPrecompiled->setEntries(entries);
+    EntryPrecompiled::Ptr entryPrecompiled =
+        std::dynamic_pointer_cast<EntryPrecompiled>(context->getPrecompiled(entryAddress));
+    auto entry = entryPrecompiled->getEntry();
 
-        auto newAddress = context->registerPrecompiled(entriesPrecompiled);
-        out = abi.abiIn("", newAddress);
-    }
-    else if (func == name2Selector[TABLE_METHOD_INS_STR_ADD])
-    {  // insert(string,address)
-        std::string key;
-        Address entryAddress;
-        abi.abiOut(data, key, entryAddress);
-
-        EntryPrecompiled::Ptr entryPrecompiled =
-            std::dynamic_pointer_cast<EntryPrecompiled>(context->getPrecompiled(entryAddress));
-        auto entry = entryPrecompiled->getEntry();
-
-        int count = m_table->insert(key, entry, std::make_shared<AccessOptions>(origin));
-        out = abi.abiIn("", u256(count));
-    }
-    else if (func == name2Selector[TABLE_METHOD_NEWCOND])
-    {  // newCondition()
-        auto condition = m_table->newCondition();
-        auto conditionPrecompiled = std::make_shared<ConditionPrecompiled>();
-        conditionPrecompiled->setCondition(condition);
-
-        auto newAddress = context->registerPrecompiled(conditionPrecompiled);
-        out = abi.abiIn("", newAddress);
-    }
-    else if (func == name2Selector[TABLE_METHOD_NEWENT])
-    {  // newEntry()
-        auto entry = m_table->newEntry();
-        auto entryPrecompiled = std::make_shared<EntryPrecompiled>();
-        entryPrecompiled->setEntry(entry);
-
-        auto newAddress = context->registerPrecompiled(entryPrecompiled);
-        out = abi.abiIn("", newAddress);
-    }
-    else if (func == name2Selector[TABLE_METHOD_RE_STR_ADD])
-    {  // remove(string,address)
-        std::string key;
-        Address conditionAddress;
-        abi.abiOut(data, key, conditionAddress);
-
-        ConditionPrecompiled::Ptr conditionPrecompiled =
-            std::dynamic_pointer_cast<ConditionPrecompiled>(
-                context->getPrecompiled(conditionAddress));
-        auto condition = conditionPrecompiled->getCondition();
-
-        int count = m_table->remove(key, condition, std::make_shared<AccessOptions>(origin));
-        out = abi.abiIn("", u256(count));
-    }
-    else if (func == name2Selector[TABLE_METHOD_UP_STR_2ADD])
-    {  // update(string,address,address)
-        std::string key;
-        Address entryAddress;
-        Address conditionAddress;
-        abi.abiOut(data, key, entryAddress, conditionAddress);
-
-        EntryPrecompiled::Ptr entryPrecompiled =
-            std::dynamic_pointer_cast<EntryPrecompiled>(context->getPrecompiled(entryAddress));
-        ConditionPrecompiled::Ptr conditionPrecompiled =
-            std::dynamic_pointer_cast<ConditionPrecompiled>(
-                context->getPrecompiled(conditionAddress));
-        auto entry = entryPrecompiled->getEntry();
-        auto condition = conditionPrecompiled->getCondition();
-
-        int count = m_table->update(key, entry, condition, std::make_shared<AccessOptions>(origin));
-        out = abi.abiIn("", u256(count));
-    }
-    else
-    {
-        STORAGE_LOG(ERROR) << LOG_BADGE("TablePrecompiled") << LOG_DESC("call undefined function!");
-    }
-    return out;
+    int count = m_table->insert(key, entry, std::make_shared<AccessOptions>(origin));
+    out = abi.abiIn("", u256(count));
+}
+
+void TablePrecompiled::newConditionCall(
+    ExecutiveContext::Ptr context, bytesConstRef, Address const&, bytes& out)
+{
+    // newCondition()
+    dev::eth::ContractABI abi;
+    auto condition = m_table->newCondition();
+    auto conditionPrecompiled = std::make_shared<ConditionPrecompiled>();
+    conditionPrecompiled->setCondition(condition);
+
+    auto newAddress = context->registerPrecompiled(conditionPrecompiled);
+    out = abi.abiIn("", newAddress);
+}
+
+void TablePrecompiled::newEntryCall(
+    ExecutiveContext::Ptr context, bytesConstRef, Address const&, bytes& out)
+{
+    // newEntry()
+    dev::eth::ContractABI abi;
+    auto entry = m_table->newEntry();
+    auto entryPrecompiled = std::make_shared<EntryPrecompiled>();
+    entryPrecompiled->setEntry(entry);
+
+    auto newAddress = context->registerPrecompiled(entryPrecompiled);
+    out = abi.abiIn("", newAddress);
+}
+
+void TablePrecompiled::removeCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // remove(string,address)
+    dev::eth::ContractABI abi;
+    std::string key;
+    Address conditionAddress;
+    abi.abiOut(data, key, conditionAddress);
+
+    ConditionPrecompiled::Ptr conditionPrecompiled =
+        std::dynamic_pointer_cast<ConditionPrecompiled>(context->getPrecompiled(conditionAddress));
+    auto condition = conditionPrecompiled->getCondition();
+
+    int count = m_table->remove(key, condition, std::make_shared<AccessOptions>(origin));
+    out = abi.abiIn("", u256(count));
+}
+
+void TablePrecompiled::updateCall(
+    ExecutiveContext::Ptr context, bytesConstRef data, Address const& origin, bytes& out)
+{
+    // update(string,address,address)
+    dev::eth::ContractABI abi;
+    std::string key;
+    Address entryAddress;
+    Address conditionAddress;
+    abi.abiOut(data, key, entryAddress, conditionAddress);
+
+    EntryPrecompiled::Ptr entryPrecompiled =
+        std::dynamic_pointer_cast<EntryPrecompiled>(context->getPrecompiled(entryAddress));
+    ConditionPrecompiled::Ptr conditionPrecompiled =
+        std::dynamic_pointer_cast<ConditionPrecompiled>(context->getPrecompiled(conditionAddress));
+    auto entry = entryPrecompiled->getEntry();
+    auto condition = conditionPrecompiled->getCondition();
+
+    int count = m_table->update(key, entry, condition, std::make_shared<AccessOptions>(origin));
+    out = abi.abiIn("", u256(count));
 }
 
 h256 TablePrecompiled::hash()
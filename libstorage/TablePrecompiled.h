@@ -64,6 +64,18 @@ public:
     h256 hash();
 
 private:
+    void selectCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void insertCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void newConditionCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void newEntryCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void removeCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
+    void updateCall(std::shared_ptr<ExecutiveContext> context, bytesConstRef data,
+        Address const& origin, bytes& out);
     std::shared_ptr<storage::Table> m_table;
 };
 
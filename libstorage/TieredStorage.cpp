@@ -0,0 +1,328 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file TieredStorage.cpp
+ *  @author ancelmo
+ *  @date 20190902
+ */
+
+#include "TieredStorage.h"
+#include "Common.h"
+#include "StorageException.h"
+#include <libdevcore/easylog.h>
+#include <boost/lexical_cast.hpp>
+#include <iomanip>
+#include <map>
+
+using namespace dev;
+using namespace dev::storage;
+
+const std::string TieredStorage::MIGRATION_TABLE = "_sys_tiered_migration_";
+
+TieredStorage::TieredStorage()
+  : m_coldTables{SYS_HASH_2_BLOCK, SYS_TX_HASH_2_BLOCK, SYS_BLOCK_2_NONCES}
+{
+    m_committedNum.store(0);
+
+    m_running = std::make_shared<tbb::atomic<bool> >();
+    m_running->store(true);
+}
+
+TieredStorage::~TieredStorage()
+{
+    if (m_running->load())
+    {
+        stop();
+    }
+}
+
+Entries::Ptr TieredStorage::select(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+    const std::string& key, Condition::Ptr condition)
+{
+    auto entries = m_hotStorage->select(hash, num, tableInfo, key, condition);
+    if (entries->size() == 0 && isCold(tableInfo->name))
+    {
+        return m_coldStorage->select(hash, num, tableInfo, key, condition);
+    }
+
+    return entries;
+}
+
+std::vector<Entries::Ptr> TieredStorage::batchSelect(
+    h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::vector<std::string>& keys)
+{
+    auto result = m_hotStorage->batchSelect(hash, num, tableInfo, keys);
+    if (!isCold(tableInfo->name))
+    {
+        return result;
+    }
+
+    std::vector<size_t> missIndexes;
+    std::vector<std::string> missKeys;
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        if (result[i]->size() == 0)
+        {
+            missIndexes.push_back(i);
+            missKeys.push_back(keys[i]);
+        }
+    }
+
+    if (!missKeys.empty())
+    {
+        auto coldResult = m_coldStorage->batchSelect(hash, num, tableInfo, missKeys);
+        for (size_t i = 0; i < missIndexes.size(); ++i)
+        {
+            result[missIndexes[i]] = coldResult[i];
+        }
+    }
+
+    return result;
+}
+
+size_t TieredStorage::commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    // the log is written in the same commit as the keys it records
+    auto migrationData = std::make_shared<TableData>();
+    migrationData->info = migrationTableInfo();
+    auto hashStr = hash.hex();
+    for (auto& data : datas)
+    {
+        if (!isCold(data->info->name))
+        {
+            continue;
+        }
+
+        std::set<std::string> keys;
+        for (auto entries : {data->dirtyEntries, data->newEntries})
+        {
+            for (size_t i = 0; i < entries->size(); ++i)
+            {
+                keys.insert(entries->get(i)->getField(data->info->key));
+            }
+        }
+
+        for (auto& key : keys)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setField(migrationData->info->key, migrationKey(num));
+            entry->setField("table", data->info->name);
+            entry->setField("key_field", data->info->key);
+            entry->setField("key", key);
+            entry->setField("hash", hashStr);
+            migrationData->newEntries->addEntry(entry);
+        }
+    }
+
+    size_t count = 0;
+    if (migrationData->newEntries->size() > 0)
+    {
+        auto hotDatas = datas;
+        hotDatas.push_back(migrationData);
+        count = m_hotStorage->commit(hash, num, hotDatas);
+    }
+    else
+    {
+        count = m_hotStorage->commit(hash, num, datas);
+    }
+
+    if (num > m_committedNum.load())
+    {
+        m_committedNum.store(num);
+        m_migrateSignal.notify_one();
+    }
+
+    return count;
+}
+
+bool TieredStorage::onlyDirty()
+{
+    return m_hotStorage->onlyDirty();
+}
+
+void TieredStorage::init()
+{
+    auto tableInfo = std::make_shared<storage::TableInfo>();
+    tableInfo->name = SYS_CURRENT_STATE;
+    tableInfo->key = SYS_KEY;
+    tableInfo->fields = std::vector<std::string>{"value"};
+
+    // the migration resumes from the blocks committed before a restart
+    auto condition = std::make_shared<Condition>();
+    condition->EQ(SYS_KEY, SYS_KEY_CURRENT_NUMBER);
+    auto out = m_hotStorage->select(h256(), 0, tableInfo, SYS_KEY_CURRENT_NUMBER, condition);
+    if (out->size() > 0)
+    {
+        m_committedNum.store(boost::lexical_cast<int64_t>(out->get(0)->getField(SYS_VALUE)));
+    }
+
+    STORAGE_LOG(INFO) << LOG_BADGE("TieredStorage") << LOG_DESC("init")
+                      << LOG_KV("committedNum", m_committedNum.load())
+                      << LOG_KV("hotBlocks", m_hotBlocks);
+
+    startMigrateThread();
+}
+
+void TieredStorage::stop()
+{
+    STORAGE_LOG(INFO) << LOG_BADGE("TieredStorage") << LOG_DESC("Stopping migrate thread");
+    m_running->store(false);
+    m_migrateSignal.notify_all();
+
+    if (m_migrateThread)
+    {
+        if (m_migrateThread->get_id() != std::this_thread::get_id())
+        {
+            m_migrateThread->join();
+            m_migrateThread.reset();
+        }
+        else
+        {
+            m_migrateThread->detach();
+        }
+    }
+}
+
+size_t TieredStorage::migrate()
+{
+    int64_t limit = m_committedNum.load() - m_hotBlocks;
+    if (limit <= 0)
+    {
+        return 0;
+    }
+
+    auto migrationInfo = migrationTableInfo();
+    auto it = m_hotStorage->scan(migrationInfo, migrationKey(0), migrationKey(limit + 1));
+    size_t blocks = 0;
+    StorageIterator::Batch batch;
+    while (m_running->load() && it->next(batch))
+    {
+        for (auto& item : batch)
+        {
+            int64_t num = boost::lexical_cast<int64_t>(item.first);
+            h256 hash;
+            // table to its key field and keys
+            std::map<std::string, std::pair<std::string, std::vector<std::string> > > tables;
+            for (size_t i = 0; i < item.second->size(); ++i)
+            {
+                auto entry = item.second->get(i);
+                hash = h256(entry->getField("hash"));
+                auto& table = tables[entry->getField("table")];
+                table.first = entry->getField("key_field");
+                table.second.push_back(entry->getField("key"));
+            }
+
+            std::vector<TableData::Ptr> coldDatas;
+            for (auto& table : tables)
+            {
+                auto data = std::make_shared<TableData>();
+                data->info->name = table.first;
+                data->info->key = table.second.first;
+
+                auto rows = m_hotStorage->batchSelect(hash, num, data->info, table.second.second);
+                for (auto& entries : rows)
+                {
+                    for (size_t i = 0; i < entries->size(); ++i)
+                    {
+                        data->newEntries->addEntry(entries->get(i));
+                    }
+                }
+
+                if (data->newEntries->size() > 0)
+                {
+                    coldDatas.push_back(data);
+                }
+            }
+
+            // a crash before the keys are removed copies them again, which rewrites the same rows
+            if (!coldDatas.empty())
+            {
+                m_coldStorage->commit(hash, num, coldDatas);
+            }
+
+            for (auto& data : coldDatas)
+            {
+                m_hotStorage->remove(data->info, tables[data->info->name].second);
+            }
+            m_hotStorage->remove(migrationInfo, {item.first});
+
+            ++blocks;
+        }
+    }
+
+    if (blocks > 0)
+    {
+        STORAGE_LOG(DEBUG) << LOG_BADGE("TieredStorage") << LOG_DESC("migrate")
+                           << LOG_KV("blocks", blocks) << LOG_KV("limit", limit);
+    }
+
+    return blocks;
+}
+
+TableInfo::Ptr TieredStorage::migrationTableInfo()
+{
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = MIGRATION_TABLE;
+    tableInfo->key = "number";
+    tableInfo->fields = std::vector<std::string>{"table", "key_field", "key", "hash"};
+
+    return tableInfo;
+}
+
+std::string TieredStorage::migrationKey(int64_t num)
+{
+    std::stringstream ss;
+    ss << std::setw(20) << std::setfill('0') << num;
+    return ss.str();
+}
+
+void TieredStorage::startMigrateThread()
+{
+    std::weak_ptr<TieredStorage> self(std::dynamic_pointer_cast<TieredStorage>(shared_from_this()));
+    auto running = m_running;
+    m_migrateThread = std::make_shared<std::thread>([running, self]() {
+        while (running->load())
+        {
+            auto storage = self.lock();
+            if (!storage)
+            {
+                return;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(storage->m_migrateMutex);
+                storage->m_migrateSignal.wait_for(
+                    lock, std::chrono::milliseconds(storage->m_migrateInterval));
+            }
+
+            if (!running->load())
+            {
+                return;
+            }
+
+            try
+            {
+                storage->migrate();
+            }
+            catch (std::exception& e)
+            {
+                // the log is kept, the blocks are moved by the next round
+                STORAGE_LOG(ERROR) << LOG_BADGE("TieredStorage") << LOG_DESC("migrate failed")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
+            }
+        }
+    });
+}
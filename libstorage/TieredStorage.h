@@ -0,0 +1,92 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/** @file TieredStorage.h
+ *  @author ancelmo
+ *  @date 20190902
+ */
+#pragma once
+
+#include "Storage.h"
+#include <tbb/atomic.h>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace dev
+{
+namespace storage
+{
+/// Keeps the state and the recent blocks in a hot backend and moves the block tables of old
+/// blocks to a cold backend. Every commit goes to the hot backend together with a migration log
+/// of the cold table keys it wrote, a background thread copies the keys of blocks older than
+/// hotBlocks to the cold backend and then removes them from the hot one, so each key is in at
+/// least one backend at any time. Reads of cold tables fall through to the cold backend.
+class TieredStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<TieredStorage> Ptr;
+
+    TieredStorage();
+    virtual ~TieredStorage();
+
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition = nullptr) override;
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override;
+    size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    bool onlyDirty() override;
+
+    /// the hot backend must support scan and remove
+    void setHotStorage(Storage::Ptr hotStorage) { m_hotStorage = hotStorage; }
+    void setColdStorage(Storage::Ptr coldStorage) { m_coldStorage = coldStorage; }
+    /// blocks kept in the hot backend
+    void setHotBlocks(int64_t hotBlocks) { m_hotBlocks = hotBlocks; }
+    /// tables moved to the cold backend, the block tables by default
+    void setColdTables(const std::set<std::string>& coldTables) { m_coldTables = coldTables; }
+
+    void init();
+    void stop() override;
+
+    /// move the cold keys of all but the latest hotBlocks blocks, returns the blocks moved
+    size_t migrate();
+
+    static const std::string MIGRATION_TABLE;
+
+private:
+    TableInfo::Ptr migrationTableInfo();
+    // keys of the migration log sort by number
+    static std::string migrationKey(int64_t num);
+    bool isCold(const std::string& table) { return m_coldTables.count(table) > 0; }
+    void startMigrateThread();
+
+    Storage::Ptr m_hotStorage;
+    Storage::Ptr m_coldStorage;
+    int64_t m_hotBlocks = 10000;
+    std::set<std::string> m_coldTables;
+    tbb::atomic<int64_t> m_committedNum;
+
+    std::shared_ptr<tbb::atomic<bool> > m_running;
+    std::shared_ptr<std::thread> m_migrateThread;
+    std::mutex m_migrateMutex;
+    std::condition_variable m_migrateSignal;
+    int64_t m_migrateInterval = 1000;  // ms
+};
+
+}  // namespace storage
+
+}  // namespace dev
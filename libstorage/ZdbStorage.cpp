@@ -90,6 +90,7 @@ void ZdbStorage::setConnPool(SQLConnectionPool::Ptr& _connPool)
 {
     m_sqlBasicAcc->setConnPool(_connPool);
     this->initSysTables();
+    m_sqlBasicAcc->RecoverCommits();
 }
 
 void ZdbStorage::SetSqlAccess(SQLBasicAccess::Ptr _sqlBasicAcc)
@@ -145,6 +146,7 @@ void ZdbStorage::createSysTables()
     ss << "`table_name` varchar(128) DEFAULT '',\n";
     ss << "`key_field` varchar(1024) DEFAULT '',\n";
     ss << " `value_field` varchar(1024) DEFAULT '',\n";
+    ss << " `index_field` varchar(1024) DEFAULT '',\n";
     ss << " PRIMARY KEY (`_id_`),\n";
     ss << " UNIQUE KEY `table_name` (`table_name`)\n";
     ss << ") ENGINE=InnoDB AUTO_INCREMENT=62 DEFAULT CHARSET=utf8mb4;";
@@ -245,7 +247,8 @@ void ZdbStorage::createHash2BlockTables()
     ss << " `_num_` int(11) DEFAULT NULL,\n";
     ss << " `_status_` int(11) DEFAULT NULL,\n";
     ss << "`hash` varchar(128) DEFAULT NULL,\n";
-    ss << "`value` longtext,\n";
+    ss << "`value` " << (isBinaryField(SYS_HASH_2_BLOCK, SYS_VALUE) ? "longblob" : "longtext")
+       << ",\n";
     ss << " PRIMARY KEY (`_id_`),\n";
     ss << "KEY `hash` (`hash`)\n";
     ss << ") ENGINE=InnoDB AUTO_INCREMENT=10 DEFAULT CHARSET=utf8mb4;";
@@ -297,7 +300,8 @@ void ZdbStorage::createSysBlock2NoncesTables()
     ss << "`_num_` int(11) DEFAULT NULL,\n";
     ss << "`_status_` int(11) DEFAULT NULL,\n";
     ss << "`number` varchar(128) DEFAULT NULL,\n";
-    ss << " `value` longtext,\n";
+    ss << " `value` "
+       << (isBinaryField(SYS_BLOCK_2_NONCES, SYS_VALUE) ? "longblob" : "longtext") << ",\n";
     ss << "PRIMARY KEY (`_id_`),";
     ss << "KEY `number` (`number`)";
     ss << ") ENGINE=InnoDB AUTO_INCREMENT=6 DEFAULT CHARSET=utf8mb4;";
@@ -310,7 +314,7 @@ void ZdbStorage::insertSysTables()
     ss << "insert ignore into  `_sys_tables_` ( `table_name` , `key_field`, "
           "`value_field`)values "
           "\n";
-    ss << "	('_sys_tables_', 'table_name','key_field,value_field'),\n";
+    ss << "	('_sys_tables_', 'table_name','key_field,value_field,index_field'),\n";
     ss << "	('_sys_consensus_', 'name','type,node_id,enable_num'),\n";
     ss << "	('_sys_table_access_', 'table_name','address,enable_num'),\n";
     ss << "	('_sys_current_state_', 'key','value'),\n";
@@ -0,0 +1,125 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the decoded code of the contracts
+ * @author: ancelmo
+ * @date: 2019-10-15
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace dev
+{
+namespace storagestate
+{
+/**
+ * @brief Thread-safe cache from code hash to the code decoded from the hex of the state, shared
+ * by the states of all groups and by the workers executing transactions in parallel. The code of
+ * a hash never changes, so the code is immutable and shared without copying. The cache is split
+ * into shards locked separately, a shard whose code exceeds its part of the capacity drops the
+ * least recently used code.
+ */
+class CodeCache
+{
+public:
+    typedef std::shared_ptr<bytes const> Code;
+
+    CodeCache(size_t _capacity = c_defaultCapacity)
+      : m_shardCapacity(std::max<size_t>(_capacity / c_shards, 1))
+    {}
+
+    /// @return the code of _codeHash, null if it isn't cached
+    Code get(h256 const& _codeHash)
+    {
+        auto& shard = getShard(_codeHash);
+        Guard l(shard.lock);
+        auto it = shard.index.find(_codeHash);
+        if (it == shard.index.end())
+        {
+            return nullptr;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->second;
+    }
+
+    void store(h256 const& _codeHash, Code const& _code)
+    {
+        auto& shard = getShard(_codeHash);
+        Guard l(shard.lock);
+        if (shard.index.count(_codeHash))
+        {
+            return;
+        }
+        shard.lru.emplace_front(_codeHash, _code);
+        shard.index[_codeHash] = shard.lru.begin();
+        shard.size += _code->size();
+        while (shard.size > m_shardCapacity && shard.lru.size() > 1)
+        {
+            auto& last = shard.lru.back();
+            shard.size -= last.second->size();
+            shard.index.erase(last.first);
+            shard.lru.pop_back();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t size = 0;
+        for (auto& shard : m_shards)
+        {
+            Guard l(shard.lock);
+            size += shard.lru.size();
+        }
+        return size;
+    }
+
+    static CodeCache& instance()
+    {
+        static CodeCache cache;
+        return cache;
+    }
+
+private:
+    // bytes of decoded code
+    static const size_t c_defaultCapacity = 64 * 1024 * 1024;
+    static const size_t c_shards = 16;
+
+    struct Shard
+    {
+        mutable Mutex lock;
+        size_t size = 0;
+        std::list<std::pair<h256, Code>> lru;
+        std::unordered_map<h256, std::list<std::pair<h256, Code>>::iterator> index;
+    };
+
+    Shard& getShard(h256 const& _codeHash) { return m_shards[_codeHash[0] % c_shards]; }
+
+    size_t m_shardCapacity;
+    std::array<Shard, c_shards> m_shards;
+};
+
+}  // namespace storagestate
+}  // namespace dev
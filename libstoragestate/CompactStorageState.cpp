@@ -0,0 +1,288 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : storage state keeping the account in one fixed size record
+ *
+ * @file CompactStorageState.cpp
+ * @author: ancelmo
+ * @date 2019-09-19
+ */
+
+#include "CompactStorageState.h"
+#include "libdevcrypto/Hash.h"
+#include "libethcore/Exceptions.h"
+#include "libstorage/StorageException.h"
+#include "libstorage/Table.h"
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::storagestate;
+using namespace dev::storage;
+
+namespace
+{
+// nonce, balance, code hash and alive flag
+const size_t c_headerSize = 3 * h256::size + 1;
+}  // namespace
+
+std::string AccountHeader::encode() const
+{
+    byte data[c_headerSize];
+    h256(nonce).ref().copyTo(bytesRef(data, h256::size));
+    h256(balance).ref().copyTo(bytesRef(data + h256::size, h256::size));
+    codeHash.ref().copyTo(bytesRef(data + 2 * h256::size, h256::size));
+    data[3 * h256::size] = alive ? 1 : 0;
+    return toHex(bytesConstRef(data, c_headerSize));
+}
+
+AccountHeader AccountHeader::decode(std::string const& _value)
+{
+    auto data = fromHex(_value);
+    if (data.size() != c_headerSize)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "invalid account header"));
+    }
+    AccountHeader header;
+    header.nonce = fromBigEndian<u256>(bytesConstRef(data.data(), h256::size));
+    header.balance = fromBigEndian<u256>(bytesConstRef(data.data() + h256::size, h256::size));
+    header.codeHash = h256(data.data() + 2 * h256::size, h256::ConstructFromPointer);
+    header.alive = data[3 * h256::size] != 0;
+    return header;
+}
+
+bool CompactStorageState::accountNonemptyAndExisting(Address const& _address) const
+{
+    AccountHeader header;
+    if (getHeader(getTable(_address), header))
+    {
+        return header.balance > u256(0) || header.codeHash != EmptySHA3 ||
+               header.nonce != m_accountStartNonce;
+    }
+    return false;
+}
+
+bool CompactStorageState::addressHasCode(Address const& _address) const
+{
+    return codeHash(_address) != EmptySHA3;
+}
+
+u256 CompactStorageState::balance(Address const& _address) const
+{
+    AccountHeader header;
+    if (getHeader(getTable(_address), header))
+    {
+        return header.balance;
+    }
+    return 0;
+}
+
+void CompactStorageState::addBalance(Address const& _address, u256 const& _amount)
+{
+    if (_amount == 0)
+    {
+        return;
+    }
+    auto table = getTable(_address);
+    if (table)
+    {
+        AccountHeader header;
+        if (getHeader(table, header))
+        {
+            header.balance += _amount;
+            setHeader(table, header);
+        }
+    }
+    else
+    {
+        createAccount(_address, requireAccountStartNonce(), _amount);
+    }
+}
+
+void CompactStorageState::subBalance(Address const& _address, u256 const& _amount)
+{
+    auto table = getTable(_address);
+    AccountHeader header;
+    if (!getHeader(table, header))
+    {
+        if (!table)
+        {
+            BOOST_THROW_EXCEPTION(NotEnoughCash());
+        }
+        return;
+    }
+    if (header.balance < _amount)
+        BOOST_THROW_EXCEPTION(NotEnoughCash());
+    header.balance -= _amount;
+    setHeader(table, header);
+}
+
+void CompactStorageState::setBalance(Address const& _address, u256 const& _amount)
+{
+    auto table = getTable(_address);
+    if (table)
+    {
+        AccountHeader header;
+        if (getHeader(table, header))
+        {
+            header.balance = _amount;
+            setHeader(table, header);
+        }
+    }
+    else
+    {
+        createAccount(_address, requireAccountStartNonce(), _amount);
+    }
+}
+
+void CompactStorageState::setCode(Address const& _address, bytes&& _code)
+{
+    auto table = getTable(_address);
+    AccountHeader header;
+    if (getHeader(table, header))
+    {
+        auto entry = table->newEntry();
+        entry->setField(STORAGE_VALUE, toHex(_code));
+        table->update(ACCOUNT_CODE, entry, table->newCondition());
+        header.codeHash = sha3(_code);
+        setHeader(table, header);
+    }
+}
+
+void CompactStorageState::kill(Address _address)
+{
+    auto table = getTable(_address);
+    AccountHeader header;
+    if (getHeader(table, header))
+    {
+        auto entry = table->newEntry();
+        entry->setField(STORAGE_VALUE, "");
+        table->update(ACCOUNT_CODE, entry, table->newCondition());
+        header.nonce = m_accountStartNonce;
+        header.balance = 0;
+        header.codeHash = EmptySHA3;
+        header.alive = false;
+        setHeader(table, header);
+    }
+    clear();
+}
+
+h256 CompactStorageState::codeHash(Address const& _address) const
+{
+    AccountHeader header;
+    if (getHeader(getTable(_address), header))
+    {
+        return header.codeHash;
+    }
+    return EmptySHA3;
+}
+
+void CompactStorageState::incNonce(Address const& _address)
+{
+    auto table = getTable(_address);
+    if (table)
+    {
+        AccountHeader header;
+        if (getHeader(table, header))
+        {
+            ++header.nonce;
+            setHeader(table, header);
+        }
+    }
+    else
+        createAccount(_address, requireAccountStartNonce() + 1);
+}
+
+void CompactStorageState::setNonce(Address const& _address, u256 const& _newNonce)
+{
+    auto table = getTable(_address);
+    if (table)
+    {
+        AccountHeader header;
+        if (getHeader(table, header))
+        {
+            header.nonce = _newNonce;
+            setHeader(table, header);
+        }
+    }
+    else
+        createAccount(_address, _newNonce);
+}
+
+u256 CompactStorageState::getNonce(Address const& _address) const
+{
+    AccountHeader header;
+    if (getHeader(getTable(_address), header))
+    {
+        return header.nonce;
+    }
+    return m_accountStartNonce;
+}
+
+void CompactStorageState::createAccount(
+    Address const& _address, u256 const& _nonce, u256 const& _amount)
+{
+    std::string tableName("_contract_data_" + _address.hex() + "_");
+    auto table = m_memoryTableFactory->createTable(tableName, STORAGE_KEY, STORAGE_VALUE, false);
+    if (!table)
+    {
+        return;
+    }
+    AccountHeader header;
+    header.nonce = _nonce;
+    header.balance = _amount;
+    header.codeHash = EmptySHA3;
+    auto entry = table->newEntry();
+    entry->setField(STORAGE_KEY, ACCOUNT_HEADER);
+    entry->setField(STORAGE_VALUE, header.encode());
+    table->insert(ACCOUNT_HEADER, entry);
+    entry = table->newEntry();
+    entry->setField(STORAGE_KEY, ACCOUNT_CODE);
+    entry->setField(STORAGE_VALUE, "");
+    table->insert(ACCOUNT_CODE, entry);
+}
+
+std::string CompactStorageState::encodeSlot(u256 const& _value) const
+{
+    return toHex(h256(_value).ref());
+}
+
+u256 CompactStorageState::decodeSlot(std::string const& _value) const
+{
+    return fromBigEndian<u256>(h256(_value).ref());
+}
+
+bool CompactStorageState::getHeader(Table::Ptr const& _table, AccountHeader& _header) const
+{
+    if (!_table)
+    {
+        return false;
+    }
+    auto entries = _table->select(ACCOUNT_HEADER, _table->newCondition());
+    if (entries->size() == 0u)
+    {
+        return false;
+    }
+    _header = AccountHeader::decode(entries->get(0)->getField(STORAGE_VALUE));
+    return true;
+}
+
+void CompactStorageState::setHeader(Table::Ptr const& _table, AccountHeader const& _header)
+{
+    auto entry = _table->newEntry();
+    entry->setField(STORAGE_VALUE, _header.encode());
+    _table->update(ACCOUNT_HEADER, entry, _table->newCondition());
+}
@@ -0,0 +1,82 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : storage state keeping the account in one fixed size record
+ *
+ * @file CompactStorageState.h
+ * @author: ancelmo
+ * @date 2019-09-19
+ */
+
+#pragma once
+#include "StorageState.h"
+
+namespace dev
+{
+namespace storagestate
+{
+const char* const ACCOUNT_HEADER = "header";
+
+/// nonce, balance, code hash and alive flag of an account
+struct AccountHeader
+{
+    u256 nonce;
+    u256 balance;
+    h256 codeHash;
+    bool alive = true;
+
+    /// 3 words and the alive flag in hex, fixed width
+    std::string encode() const;
+    static AccountHeader decode(std::string const& _value);
+};
+
+/**
+ * @brief The layout of the state of new chains with state type compact. The account header is
+ * one row of the contract table instead of a row per field, and the storage slots are the 32
+ * bytes of their location and value in hex. Neither is converted from or to decimal strings.
+ */
+class CompactStorageState : public StorageState
+{
+public:
+    CompactStorageState(u256 const& _accountStartNonce) : StorageState(_accountStartNonce) {}
+
+    bool accountNonemptyAndExisting(Address const& _address) const override;
+    bool addressHasCode(Address const& _address) const override;
+    u256 balance(Address const& _address) const override;
+    void addBalance(Address const& _address, u256 const& _amount) override;
+    void subBalance(Address const& _address, u256 const& _value) override;
+    void setBalance(Address const& _address, u256 const& _value) override;
+    void setCode(Address const& _address, bytes&& _code) override;
+    void kill(Address _a) override;
+    h256 codeHash(Address const& _contract) const override;
+    void incNonce(Address const& _address) override;
+    void setNonce(Address const& _address, u256 const& _newNonce) override;
+    u256 getNonce(Address const& _address) const override;
+
+protected:
+    void createAccount(
+        Address const& _address, u256 const& _nonce, u256 const& _amount = u256(0)) override;
+    std::string encodeSlot(u256 const& _value) const override;
+    u256 decodeSlot(std::string const& _value) const override;
+
+private:
+    /// @return false if the account has no table
+    bool getHeader(storage::Table::Ptr const& _table, AccountHeader& _header) const;
+    void setHeader(storage::Table::Ptr const& _table, AccountHeader const& _header);
+};
+}  // namespace storagestate
+}  // namespace dev
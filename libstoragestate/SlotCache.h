@@ -0,0 +1,154 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : storage slots accessed by one transaction
+ * @author: ancelmo
+ * @date: 2019-09-18
+ */
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+#include <libstorage/Table.h>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace dev
+{
+namespace storagestate
+{
+/**
+ * @brief Open addressing hash map from (address, location) to the value of a storage slot.
+ * Slots are kept in a deque, so the pointers returned stay valid while the index grows. The
+ * dirty slots are listed in the order they were first written.
+ */
+class SlotCache
+{
+public:
+    struct Slot
+    {
+        Address address;
+        u256 location;
+        u256 value;
+        // the table of the contract, nullptr if the contract has no table
+        storage::Table::Ptr table;
+        // the location has a row in the table
+        bool exists = false;
+        bool dirty = false;
+    };
+
+    Slot* find(Address const& _address, u256 const& _location)
+    {
+        if (m_index.empty())
+        {
+            return nullptr;
+        }
+        for (size_t i = hash(_address, _location) & mask();; i = (i + 1) & mask())
+        {
+            if (m_index[i] == 0)
+            {
+                return nullptr;
+            }
+            auto& slot = m_slots[m_index[i] - 1];
+            if (slot.location == _location && slot.address == _address)
+            {
+                return &slot;
+            }
+        }
+    }
+
+    /// the slot must not be cached yet
+    Slot& insert(Address const& _address, u256 const& _location)
+    {
+        // keep the load factor under 1/2
+        if ((m_slots.size() + 1) * 2 > m_index.size())
+        {
+            rehash(m_index.empty() ? c_initialCapacity : m_index.size() * 2);
+        }
+        m_slots.emplace_back();
+        auto& slot = m_slots.back();
+        slot.address = _address;
+        slot.location = _location;
+        place(slot, m_slots.size());
+        return slot;
+    }
+
+    void setDirty(Slot& _slot)
+    {
+        if (!_slot.dirty)
+        {
+            _slot.dirty = true;
+            m_dirty.push_back(&_slot);
+        }
+    }
+
+    /// @return the dirty slots, they are clean again after the call
+    std::vector<Slot*> takeDirty()
+    {
+        for (auto slot : m_dirty)
+        {
+            slot->dirty = false;
+        }
+        std::vector<Slot*> dirty;
+        dirty.swap(m_dirty);
+        return dirty;
+    }
+
+    size_t size() const { return m_slots.size(); }
+
+private:
+    static const size_t c_initialCapacity = 64;
+
+    size_t mask() const { return m_index.size() - 1; }
+
+    static size_t hash(Address const& _address, u256 const& _location)
+    {
+        uint64_t address;
+        std::memcpy(&address, _address.data() + Address::size - sizeof(address), sizeof(address));
+        // Fibonacci hashing spreads the small locations solidity assigns to variables
+        return (address ^ (uint64_t)_location.backend().limbs()[0]) * 0x9E3779B97F4A7C15ull >> 16;
+    }
+
+    void place(Slot const& _slot, uint32_t _position)
+    {
+        size_t i = hash(_slot.address, _slot.location) & mask();
+        while (m_index[i] != 0)
+        {
+            i = (i + 1) & mask();
+        }
+        m_index[i] = _position;
+    }
+
+    void rehash(size_t _capacity)
+    {
+        m_index.assign(_capacity, 0);
+        for (size_t i = 0; i < m_slots.size(); ++i)
+        {
+            place(m_slots[i], i + 1);
+        }
+    }
+
+    std::deque<Slot> m_slots;
+    // positions in m_slots plus one, 0 for an empty bucket, the size is a power of 2
+    std::vector<uint32_t> m_index;
+    std::vector<Slot*> m_dirty;
+};
+
+}  // namespace storagestate
+}  // namespace dev
@@ -23,6 +23,7 @@
  */
 
 #include "StorageState.h"
+#include "CodeCache.h"
 #include "libdevcrypto/Hash.h"
 #include "libethcore/Exceptions.h"
 #include "libstorage/Table.h"
@@ -175,38 +176,23 @@ h256 StorageState::storageRoot(Address const& _address) const
 
 u256 StorageState::storage(Address const& _address, u256 const& _key)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto slot = getSlot(slotCache(), _address, _key);
+    if (slot)
     {
-        auto entries = table->select(_key.str(), table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return u256(entries->get(0)->getField(STORAGE_VALUE));
-        }
+        return slot->value;
     }
     return u256(0);
 }
 
 void StorageState::setStorage(Address const& _address, u256 const& _location, u256 const& _value)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto& cache = slotCache();
+    auto slot = getSlot(cache, _address, _location);
+    if (slot)
     {
-        auto entries = table->select(_location.str(), table->newCondition());
-        if (entries->size() == 0u)
-        {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
-            entry->setField(STORAGE_VALUE, _value.str());
-            table->insert(_location.str(), entry);
-        }
-        else
-        {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
-            entry->setField(STORAGE_VALUE, _value.str());
-            table->update(_location.str(), entry, table->newCondition());
-        }
+        // written to the table by flush(), savepoint() or commit()
+        slot->value = _value;
+        cache.setDirty(*slot);
     }
 }
 
@@ -252,18 +238,33 @@ void StorageState::kill(Address _address)
 
 bytes const StorageState::code(Address const& _address) const
 {
-    if (codeHash(_address) == EmptySHA3)
-        return NullBytes;
+    return *sharedCode(_address);
+}
+
+std::shared_ptr<bytes const> StorageState::sharedCode(Address const& _address) const
+{
+    static auto const s_noCode = std::make_shared<bytes const>();
+    auto hash = codeHash(_address);
+    if (hash == EmptySHA3)
+        return s_noCode;
+    auto code = CodeCache::instance().get(hash);
+    if (code)
+        return code;
     auto table = getTable(_address);
     if (table)
     {
         auto entries = table->select(ACCOUNT_CODE, table->newCondition());
         if (entries->size() != 0u)
         {
-            return fromHex(entries->get(0)->getField(STORAGE_VALUE));
+            code = std::make_shared<bytes const>(fromHex(entries->get(0)->getField(STORAGE_VALUE)));
+            // the code is cached by the hash it is checked against, so a code and a hash out of
+            // step can't be served to the other accounts of the hash
+            if (sha3(*code) == hash)
+                CodeCache::instance().store(hash, code);
+            return code;
         }
     }
-    return NullBytes;
+    return s_noCode;
 }
 
 h256 StorageState::codeHash(Address const& _address) const
@@ -282,7 +283,7 @@ h256 StorageState::codeHash(Address const& _address) const
 
 size_t StorageState::codeSize(Address const& _address) const
 {
-    return code(_address).size();
+    return sharedCode(_address)->size();
 }
 
 void StorageState::createContract(Address const& _address)
@@ -350,6 +351,7 @@ h256 StorageState::rootHash(bool needCalculate) const
 
 void StorageState::commit()
 {
+    flush();
     m_memoryTableFactory->commit();
 }
 
@@ -383,17 +385,44 @@ void StorageState::noteAccountStartNonce(u256 const& _actual)
 
 size_t StorageState::savepoint() const
 {
+    // the slots written before the savepoint go to the log, so rolling back undoes the latter
+    auto it = findSlotCache();
+    if (it != m_slotCaches.local().end())
+    {
+        writeSlots(it->second);
+    }
     return m_memoryTableFactory->savepoint();
 }
 
 void StorageState::rollback(size_t _savepoint)
 {
     m_memoryTableFactory->rollback(_savepoint);
+    // the table holds every slot written before the savepoint, read them again
+    auto it = findSlotCache();
+    if (it != m_slotCaches.local().end())
+    {
+        m_slotCaches.local().erase(it);
+    }
 }
 
 void StorageState::clear()
 {
-    // m_cache.clear();
+    flush();
+}
+
+void StorageState::flush()
+{
+    auto& slotCaches = m_slotCaches.local();
+    auto it = findSlotCache();
+    if (it == slotCaches.end())
+    {
+        return;
+    }
+    // removed before writing, a later transaction bound to a log at the same address never
+    // sees the slots even if writing throws
+    SlotCaches flushed;
+    flushed.splice(flushed.begin(), slotCaches, it);
+    writeSlots(flushed.front().second);
 }
 
 bool StorageState::checkAuthority(Address const& _origin, Address const& _contract) const
@@ -440,3 +469,77 @@ inline storage::Table::Ptr StorageState::getTable(Address const& _address) const
     std::string tableName("_contract_data_" + _address.hex() + "_");
     return m_memoryTableFactory->openTable(tableName);
 }
+
+SlotCache::Slot* StorageState::getSlot(
+    SlotCache& _slotCache, Address const& _address, u256 const& _location)
+{
+    auto slot = _slotCache.find(_address, _location);
+    if (slot)
+    {
+        return slot;
+    }
+
+    // a contract without table may be created later in the transaction, so it is not cached
+    auto table = getTable(_address);
+    if (!table)
+    {
+        return nullptr;
+    }
+    auto entries = table->select(encodeSlot(_location), table->newCondition());
+    slot = &_slotCache.insert(_address, _location);
+    slot->table = table;
+    if (entries->size() != 0u)
+    {
+        slot->exists = true;
+        slot->value = decodeSlot(entries->get(0)->getField(STORAGE_VALUE));
+    }
+    return slot;
+}
+
+SlotCache& StorageState::slotCache()
+{
+    auto it = findSlotCache();
+    auto& slotCaches = m_slotCaches.local();
+    if (it != slotCaches.end())
+    {
+        return it->second;
+    }
+    slotCaches.emplace_back(ChangeLog::current(), SlotCache());
+    return slotCaches.back().second;
+}
+
+StorageState::SlotCaches::iterator StorageState::findSlotCache() const
+{
+    // transactions nest only when a waiting thread steals a task, the list is rarely longer
+    // than one
+    auto& slotCaches = m_slotCaches.local();
+    auto changeLog = ChangeLog::current();
+    for (auto it = slotCaches.begin(); it != slotCaches.end(); ++it)
+    {
+        if (it->first == changeLog)
+        {
+            return it;
+        }
+    }
+    return slotCaches.end();
+}
+
+void StorageState::writeSlots(SlotCache& _slotCache) const
+{
+    for (auto slot : _slotCache.takeDirty())
+    {
+        auto key = encodeSlot(slot->location);
+        auto entry = slot->table->newEntry();
+        entry->setField(STORAGE_KEY, key);
+        entry->setField(STORAGE_VALUE, encodeSlot(slot->value));
+        if (slot->exists)
+        {
+            slot->table->update(key, entry, slot->table->newCondition());
+        }
+        else
+        {
+            slot->table->insert(key, entry);
+            slot->exists = true;
+        }
+    }
+}
@@ -23,10 +23,15 @@
  */
 
 #pragma once
+#include "SlotCache.h"
 #include "libexecutive/StateFace.h"
+#include <libstorage/ChangeLog.h>
 #include <libstorage/MemoryTableFactory.h>
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <list>
 #include <string>
+#include <utility>
 
 namespace dev
 {
@@ -116,6 +121,10 @@ public:
     ///          other account. Do not keep it.
     bytes const code(Address const& _address) const override;
 
+    /// Get the code of an account from the code cache of the process, which is filled with the
+    /// code decoded from the table on a miss.
+    std::shared_ptr<bytes const> sharedCode(Address const& _address) const override;
+
     /// Get the code hash of an account.
     /// @returns EmptySHA3 if no account exists at that address or if there is no code associated
     /// with the address.
@@ -164,6 +173,9 @@ public:
     /// Clear state's cache
     void clear() override;
 
+    /// Write the storage slots changed by the executing transaction to its table
+    void flush() override;
+
     bool checkAuthority(Address const& _origin, Address const& _contract) const override;
 
     void setMemoryTableFactory(std::shared_ptr<dev::storage::TableFactory> _memoryTableFactory)
@@ -171,12 +183,27 @@ public:
         m_memoryTableFactory = _memoryTableFactory;
     }
 
-private:
-    void createAccount(Address const& _address, u256 const& _nonce, u256 const& _amount = u256(0));
+protected:
+    virtual void createAccount(
+        Address const& _address, u256 const& _nonce, u256 const& _amount = u256(0));
     std::shared_ptr<dev::storage::Table> getTable(Address const& _address) const;
+    /// @return the key or the value of a storage slot as stored in the table
+    virtual std::string encodeSlot(u256 const& _value) const { return _value.str(); }
+    virtual u256 decodeSlot(std::string const& _value) const { return u256(_value); }
     /// check authority by caller
     u256 m_accountStartNonce;
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
+
+private:
+    typedef std::list<std::pair<dev::storage::ChangeLog*, SlotCache>> SlotCaches;
+    /// @return the slot cached by the executing transaction, nullptr if the contract has no table
+    SlotCache::Slot* getSlot(SlotCache& _slotCache, Address const& _address, u256 const& _location);
+    SlotCache& slotCache();
+    SlotCaches::iterator findSlotCache() const;
+    void writeSlots(SlotCache& _slotCache) const;
+    // the slots of a transaction are cached per undo log, transactions executing in parallel
+    // or nested on a thread never see the slots of each other
+    mutable tbb::enumerable_thread_specific<SlotCaches> m_slotCaches;
 };
 }  // namespace storagestate
 }  // namespace dev
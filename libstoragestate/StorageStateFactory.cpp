@@ -22,6 +22,7 @@
  */
 
 #include "StorageStateFactory.h"
+#include "CompactStorageState.h"
 #include "StorageState.h"
 
 using namespace std;
@@ -31,7 +32,8 @@ using namespace dev::executive;
 std::shared_ptr<StateFace> StorageStateFactory::getState(
     h256 const&, std::shared_ptr<dev::storage::TableFactory> _factory)
 {
-    auto storageState = make_shared<StorageState>(m_accountStartNonce);
+    auto storageState = m_compact ? make_shared<CompactStorageState>(m_accountStartNonce) :
+                                    make_shared<StorageState>(m_accountStartNonce);
     storageState->setMemoryTableFactory(_factory);
     return storageState;
 }
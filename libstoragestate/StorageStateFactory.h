@@ -33,13 +33,17 @@ namespace storagestate
 class StorageStateFactory : public dev::executive::StateFactoryInterface
 {
 public:
-    StorageStateFactory(u256 const& _accountStartNonce) : m_accountStartNonce(_accountStartNonce) {}
+    StorageStateFactory(u256 const& _accountStartNonce, bool _compact = false)
+      : m_accountStartNonce(_accountStartNonce), m_compact(_compact)
+    {}
     virtual ~StorageStateFactory() {}
     std::shared_ptr<dev::executive::StateFace> getState(
         h256 const& _root, std::shared_ptr<dev::storage::TableFactory> _factory) override;
 
 private:
     u256 m_accountStartNonce;
+    // create CompactStorageState for the chains of state type compact
+    bool m_compact;
 };
 }  // namespace storagestate
 }  // namespace dev
@@ -0,0 +1,108 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the encoded blocks served to the syncing peers
+ * @file: BlockRLPCache.cpp
+ */
+
+#include "BlockRLPCache.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+
+std::shared_ptr<bytes> BlockRLPCache::get(GROUP_ID _groupId, int64_t _number, Loader const& _loader)
+{
+    Key key(_groupId, _number);
+    std::promise<std::shared_ptr<bytes>> promise;
+    std::shared_future<std::shared_ptr<bytes>> block;
+    bool reading = false;
+    {
+        Guard l(x_cache);
+        auto it = m_items.find(key);
+        if (it != m_items.end())
+        {
+            if (it->second.loaded)
+            {
+                m_order.splice(m_order.end(), m_order, it->second.order);
+            }
+            block = it->second.block;
+            reading = true;
+        }
+        else
+        {
+            Item item;
+            item.block = promise.get_future().share();
+            item.size = 0;
+            item.loaded = false;
+            m_items.emplace(key, item);
+        }
+    }
+    if (reading)
+    {
+        ++m_hits;
+        return block.get();
+    }
+
+    ++m_misses;
+    std::shared_ptr<bytes> blockRLP;
+    try
+    {
+        blockRLP = _loader();
+    }
+    catch (...)
+    {
+        // the waiting peers get no block, the next request reads it again
+        promise.set_value(nullptr);
+        Guard l(x_cache);
+        m_items.erase(key);
+        throw;
+    }
+    promise.set_value(blockRLP);
+
+    Guard l(x_cache);
+    if (!blockRLP)
+    {
+        m_items.erase(key);
+        return blockRLP;
+    }
+    auto& item = m_items[key];
+    item.loaded = true;
+    item.size = blockRLP->size();
+    item.order = m_order.insert(m_order.end(), key);
+    m_bytes += item.size;
+    while (m_bytes > m_capacity && m_order.size() > 1)
+    {
+        auto evicted = m_items.find(m_order.front());
+        m_bytes -= evicted->second.size;
+        m_items.erase(evicted);
+        m_order.pop_front();
+    }
+    return blockRLP;
+}
+
+size_t BlockRLPCache::size() const
+{
+    Guard l(x_cache);
+    return m_order.size();
+}
+
+size_t BlockRLPCache::byteSize() const
+{
+    Guard l(x_cache);
+    return m_bytes;
+}
@@ -0,0 +1,86 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : cache of the encoded blocks served to the syncing peers
+ * @file: BlockRLPCache.h
+ */
+
+#pragma once
+#include "Common.h"
+#include <libdevcore/Guards.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+
+namespace dev
+{
+namespace sync
+{
+/**
+ * @brief The encoded blocks read for the peers, shared by the sync of all the groups. A committed
+ * block never changes, so it's kept until the byte bound evicts the least recently served one.
+ * The peers asking for a block being read wait for that read instead of reading it again.
+ */
+class BlockRLPCache
+{
+public:
+    using Loader = std::function<std::shared_ptr<bytes>()>;
+
+    BlockRLPCache(size_t _capacity = c_defaultCapacity) : m_capacity(_capacity) {}
+
+    /// the block _number of the group, read by _loader if it's neither cached nor being read,
+    /// null if the loader returns null, which isn't cached
+    std::shared_ptr<bytes> get(GROUP_ID _groupId, int64_t _number, Loader const& _loader);
+
+    size_t size() const;
+    size_t byteSize() const;
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+
+    static BlockRLPCache& instance()
+    {
+        static BlockRLPCache cache;
+        return cache;
+    }
+
+private:
+    static const size_t c_defaultCapacity = 256 * 1024 * 1024;
+
+    using Key = std::pair<GROUP_ID, int64_t>;
+    struct Item
+    {
+        std::shared_future<std::shared_ptr<bytes>> block;
+        /// the position in m_order once the block is read
+        std::list<Key>::iterator order;
+        size_t size;
+        bool loaded;
+    };
+
+    size_t m_capacity;
+    mutable Mutex x_cache;
+    std::map<Key, Item> m_items;
+    /// the keys of the loaded blocks, the least recently served first
+    std::list<Key> m_order;
+    size_t m_bytes = 0;
+    std::atomic<uint64_t> m_hits = {0};
+    std::atomic<uint64_t> m_misses = {0};
+};
+}  // namespace sync
+}  // namespace dev
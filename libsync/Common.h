@@ -53,12 +53,56 @@ static size_t const c_maxDownloadingBlockQueueSize =
     c_maxRequestShards * c_maxRequestBlocks * 2;  // maybe less than 128 is ok
 static size_t const c_maxDownloadingBlockQueueBufferSize = c_maxDownloadingBlockQueueSize;
 
+// adaptive downloading: the request window of a peer is the blocks it sends in
+// c_requestRoundTime, the downloading queue grows with the memory left by the queued blocks
+static int64_t const c_minRequestBlocks = 8;
+static int64_t const c_maxRequestBlocksPerPeer = 512;
+static uint64_t const c_requestRoundTime = 1000;          // ms
+static uint64_t const c_minDownloadStallTimeout = 2000;  // ms
+static size_t const c_maxDownloadingBlocks = 16384;
+static size_t const c_maxDownloadingQueueMemory = 512 * 1024 * 1024;  // bytes
+// blocks taken out of the downloading queue to recover the senders and check the sigList ahead
+static size_t const c_maxPreparingBlocks = 64;
+
+// header-first downloading: the headers of a long range are checked ahead, the bodies are
+// then fetched from all the peers and checked against the transactionsRoot of the headers
+static int64_t const c_minHeaderFirstBlocks = 1024;
+static unsigned const c_maxRequestHeaders = 256;
+static size_t const c_maxHeadersAhead = 16384;
+static uint64_t const c_headerFirstRequestTimeout = 5000;  // ms
+
+// the state snapshot is cut into chunks of about c_snapshotChunkSize bytes, each sent alone
+static size_t const c_snapshotChunkSize = 512 * 1024;
+static size_t const c_maxSnapshotChunksPerPeer = 4;
+static uint64_t const c_snapshotChunkTimeout = 10000;     // ms
+static uint64_t const c_snapshotManifestInterval = 1000;  // ms
+// the blocks are downloaded if no manifest is agreed in time
+static uint64_t const c_snapshotAgreeTimeout = 60000;  // ms
+// peers announcing the same manifest before it's downloaded
+static size_t const c_minSnapshotPeers = 2;
+
+// transaction gossip: the transactions are pushed in full to a few sealers and announced by
+// hash to the others, which request the ones they miss
+static size_t const c_txsBatchSize = 256;  // transactions in a packet
+static size_t const c_minTxsFanout = 2;
+static size_t const c_maxPeerTxsBytes = 4 * 1024 * 1024;  // bytes sent to a peer in a round
+static size_t const c_maxPeerTxsRequests = 4096;  // hashes requested by a peer not served yet
+static uint64_t const c_txsRequestTimeout = 2000;  // ms
+
+// the state diffs of the blocks are requested along with the blocks, a block whose diff isn't
+// received in time is executed
+static uint64_t const c_stateDiffTimeout = 2000;  // ms
+
 static size_t const c_maxReceivedDownloadRequestPerPeer = 8;
 static uint64_t const c_respondDownloadRequestTimeout = 200;  // ms
 
 static unsigned const c_syncPacketIDBase = 1;
 
 static uint64_t const c_maintainBlocksTimeout = 5000;  // ms
+// the status is announced when the block number changes and repeated with a doubling interval
+// while it doesn't, an idle sync thread doubles its wait up to c_maxIdleWaitMs
+static uint64_t const c_maxStatusInterval = 60000;  // ms
+static unsigned const c_maxIdleWaitMs = 3200;
 
 using NodeList = std::set<dev::p2p::NodeID>;
 using NodeID = dev::p2p::NodeID;
@@ -77,6 +121,18 @@ enum SyncPacketType : byte
     TransactionsPacket = 0x01,
     BlocksPacket = 0x02,
     ReqBlocskPacket = 0x03,
+    ReqSnapshotManifestPacket = 0x04,
+    SnapshotManifestPacket = 0x05,
+    ReqSnapshotChunkPacket = 0x06,
+    SnapshotChunkPacket = 0x07,
+    ReqHeadersPacket = 0x08,
+    HeadersPacket = 0x09,
+    ReqBodiesPacket = 0x0a,
+    BodiesPacket = 0x0b,
+    TxsAnnouncePacket = 0x0c,
+    ReqTxsPacket = 0x0d,
+    ReqStateDiffsPacket = 0x0e,
+    StateDiffsPacket = 0x0f,
     PacketCount
 };
 
@@ -23,6 +23,7 @@
 #include "DownloadingBlockQueue.h"
 #include "Common.h"
 #include <libdevcore/easylog.h>
+#include <tbb/parallel_for.h>
 
 using namespace std;
 using namespace dev;
@@ -30,18 +31,22 @@ using namespace dev::eth;
 using namespace dev::sync;
 
 /// Push a block
-void DownloadingBlockQueue::push(RLP const& _rlps)
+void DownloadingBlockQueue::push(RLP const& _rlps, std::shared_ptr<bytes const> _buffer)
 {
     WriteGuard l(x_buffer);
-    if (m_buffer->size() >= c_maxDownloadingBlockQueueBufferSize)
+    if (m_buffer->size() >= c_maxDownloadingBlockQueueBufferSize || m_bufferBytes >= m_maxBytes)
     {
         SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                           << LOG_DESC("DownloadingBlockQueueBuffer is full")
-                          << LOG_KV("queueSize", m_buffer->size());
+                          << LOG_KV("queueSize", m_buffer->size())
+                          << LOG_KV("bufferBytes", m_bufferBytes);
         return;
     }
-    ShardPtr blocksShard = make_shared<DownloadBlocksShard>(0, 0, _rlps.data().toBytes());
+    ShardPtr blocksShard =
+        _buffer ? make_shared<DownloadBlocksShard>(0, 0, _buffer, _rlps.data()) :
+                  make_shared<DownloadBlocksShard>(0, 0, _rlps.data().toBytes());
     m_buffer->emplace_back(blocksShard);
+    m_bufferBytes += blocksShard->blocksBytes.size();
 }
 
 void DownloadingBlockQueue::push(BlockPtrVec _blocks)
@@ -61,7 +66,23 @@ void DownloadingBlockQueue::push(BlockPtrVec _blocks)
     rlpStream.swapOut(*b);
 
     RLP rlps = RLP(ref(*b));
-    push(rlps);
+    push(rlps, b);
+}
+
+void DownloadingBlockQueue::push(std::vector<bytes> const& _blockRLPs)
+{
+    RLPStream rlpStream;
+    rlpStream.appendList(_blockRLPs.size());
+    for (bytes const& blockRLP : _blockRLPs)
+    {
+        rlpStream.append(blockRLP);
+    }
+
+    std::shared_ptr<bytes> b = std::make_shared<bytes>();
+    rlpStream.swapOut(*b);
+
+    RLP rlps = RLP(ref(*b));
+    push(rlps, b);
 }
 
 /// Is the queue empty?
@@ -89,7 +110,15 @@ void DownloadingBlockQueue::pop()
 {
     WriteGuard l(x_blocks);
     if (!m_blocks.empty())
+    {
+        auto it = m_blockBytes.find(m_blocks.top().get());
+        if (it != m_blockBytes.end())
+        {
+            m_queueBytes -= it->second;
+            m_blockBytes.erase(it);
+        }
         m_blocks.pop();
+    }
 }
 
 BlockPtr DownloadingBlockQueue::top(bool isFlushBuffer)
@@ -109,6 +138,7 @@ void DownloadingBlockQueue::clear()
     {
         WriteGuard l(x_buffer);
         m_buffer->clear();
+        m_bufferBytes = 0;
     }
 
     clearQueue();
@@ -119,6 +149,8 @@ void DownloadingBlockQueue::clearQueue()
     WriteGuard l(x_blocks);
     std::priority_queue<BlockPtr, BlockPtrVec, BlockQueueCmp> emptyQueue;
     swap(m_blocks, emptyQueue);  // Does memory leak here ?
+    m_blockBytes.clear();
+    m_queueBytes = 0;
 }
 
 void DownloadingBlockQueue::flushBufferToQueue()
@@ -128,6 +160,7 @@ void DownloadingBlockQueue::flushBufferToQueue()
         WriteGuard l(x_buffer);
         localBuffer = m_buffer;                 //
         m_buffer = make_shared<ShardPtrVec>();  // m_buffer point to a new vector
+        m_bufferBytes = 0;
     }
 
     // pop buffer into queue
@@ -135,12 +168,12 @@ void DownloadingBlockQueue::flushBufferToQueue()
 
     for (ShardPtr blocksShard : *localBuffer)
     {
-        if (m_blocks.size() >= c_maxDownloadingBlockQueueSize)  // TODO not to use size to control
-                                                                // insert
+        if (m_blocks.size() >= m_maxSize || m_queueBytes >= m_maxBytes)
         {
             SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                             << LOG_DESC("DownloadingBlockQueueBuffer is full")
-                            << LOG_KV("queueSize", m_blocks.size());
+                            << LOG_KV("queueSize", m_blocks.size())
+                            << LOG_KV("queueBytes", m_queueBytes);
 
             break;
         }
@@ -150,27 +183,48 @@ void DownloadingBlockQueue::flushBufferToQueue()
                         << LOG_KV("blocksShardSize", blocksShard->blocksBytes.size());
 
 
-        RLP const& rlps = RLP(ref(blocksShard->blocksBytes));
+        RLP const& rlps = RLP(blocksShard->blocksBytes);
         unsigned itemCount = rlps.itemCount();
         size_t successCnt = 0;
-        for (unsigned i = 0; i < itemCount; ++i)
+        // decode the blocks of the shard in parallel
+        std::vector<bytesConstRef> blocksData;
+        for (auto const& item : rlps)
         {
-            try
-            {
-                shared_ptr<Block> block =
-                    make_shared<Block>(rlps[i].toBytes(), CheckTransaction::Everything, false);
-                if (isNewerBlock(block))
+            blocksData.push_back(item.toBytesConstRef());
+        }
+        BlockPtrVec blocks(blocksData.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, blocksData.size()),
+            [&](tbb::blocked_range<size_t> const& _range) {
+                for (size_t i = _range.begin(); i < _range.end(); ++i)
                 {
-                    successCnt++;
-                    m_blocks.push(block);
+                    try
+                    {
+                        // the senders are recovered in batch before execution, skipping the
+                        // transactions verified by the txpool
+                        blocks[i] =
+                            make_shared<Block>(blocksData[i], CheckTransaction::Cheap, false);
+                    }
+                    catch (std::exception& e)
+                    {
+                        SYNC_LOG(WARNING)
+                            << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                            << LOG_DESC("Invalid block RLP") << LOG_KV("reason", e.what())
+                            << LOG_KV("RLPDataSize", blocksData[i].size());
+                    }
                 }
-            }
-            catch (std::exception& e)
+            });
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            if (blocks[i] && isNewerBlock(blocks[i]))
             {
-                SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                  << LOG_DESC("Invalid block RLP") << LOG_KV("reason", e.what())
-                                  << LOG_KV("RLPDataSize", rlps.data().size());
-                continue;
+                successCnt++;
+                m_blocks.push(blocks[i]);
+                size_t blockSize = blocksData[i].size();
+                m_blockBytes[blocks[i].get()] = blockSize;
+                m_queueBytes += blockSize;
+                m_averageBlockSize = m_averageBlockSize == 0 ?
+                                         blockSize :
+                                         (m_averageBlockSize * 7 + blockSize) / 8;
             }
         }
 
@@ -187,8 +241,8 @@ void DownloadingBlockQueue::clearFullQueueIfNotHas(int64_t _blockNumber)
     {
         ReadGuard l(x_blocks);
 
-        if (m_blocks.size() == c_maxDownloadingBlockQueueSize &&
-            m_blocks.top()->header().number() > _blockNumber)
+        if ((m_blocks.size() >= m_maxSize || m_queueBytes >= m_maxBytes) &&
+            !m_blocks.empty() && m_blocks.top()->header().number() > _blockNumber)
             needClear = true;
     }
     if (needClear)
@@ -25,9 +25,11 @@
 #include <libblockchain/BlockChainInterface.h>
 #include <libdevcore/Guards.h>
 #include <libethcore/Block.h>
+#include <atomic>
 #include <climits>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
@@ -38,11 +40,20 @@ class DownloadBlocksShard
 {
 public:
     DownloadBlocksShard(int64_t _fromNumber, int64_t _size, bytes const& _blocksBytes)
-      : fromNumber(_fromNumber), size(_size), blocksBytes(_blocksBytes)
+      : fromNumber(_fromNumber),
+        size(_size),
+        buffer(std::make_shared<bytes const>(_blocksBytes)),
+        blocksBytes(ref(*buffer))
+    {}
+    /// reference _blocksBytes inside _buffer without copying it
+    DownloadBlocksShard(int64_t _fromNumber, int64_t _size, std::shared_ptr<bytes const> _buffer,
+        bytesConstRef _blocksBytes)
+      : fromNumber(_fromNumber), size(_size), buffer(_buffer), blocksBytes(_blocksBytes)
     {}
     int64_t fromNumber;
     int64_t size;
-    bytes blocksBytes;
+    std::shared_ptr<bytes const> buffer;  ///< holds blocksBytes, the received message of a peer
+    bytesConstRef blocksBytes;
 };
 
 struct BlockQueueCmp
@@ -74,8 +85,10 @@ public:
     {}
 
     /// PUsh a block packet
-    void push(RLP const& _rlps);
+    /// _buffer holds _rlps, the blocks are copied if it is null
+    void push(RLP const& _rlps, std::shared_ptr<bytes const> _buffer = nullptr);
     void push(BlockPtrVec _blocks);
+    void push(std::vector<bytes> const& _blockRLPs);
 
     /// Is the queue empty?
     bool empty();
@@ -100,6 +113,17 @@ public:
 
     void clearFullQueueIfNotHas(int64_t _blockNumber);
 
+    /// the most blocks decoded into the queue
+    void setMaxSize(size_t _maxSize) { m_maxSize = _maxSize; }
+    size_t maxSize() const { return m_maxSize; }
+    /// moving average of the encoded size of the queued blocks
+    size_t averageBlockSize() const { return m_averageBlockSize; }
+    /// the most bytes of the encoded blocks held in the buffer and the queue
+    void setMaxBytes(size_t _maxBytes) { m_maxBytes = _maxBytes; }
+    size_t maxBytes() const { return m_maxBytes; }
+    /// the encoded size of the blocks held in the buffer and the queue
+    size_t byteSize() const { return m_bufferBytes + m_queueBytes; }
+
 private:
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
     NodeID m_nodeId;
@@ -109,6 +133,14 @@ private:
     mutable SharedMutex x_blocks;
     mutable SharedMutex x_buffer;
 
+    std::atomic<size_t> m_maxSize = {c_maxDownloadingBlockQueueSize};
+    std::atomic<size_t> m_averageBlockSize = {0};
+    std::atomic<size_t> m_maxBytes = {c_maxDownloadingQueueMemory};
+    std::atomic<size_t> m_bufferBytes = {0};
+    std::atomic<size_t> m_queueBytes = {0};
+    /// the encoded size of each queued block, guarded by x_blocks
+    std::unordered_map<dev::eth::Block const*, size_t> m_blockBytes;
+
 private:
     bool isNewerBlock(std::shared_ptr<dev::eth::Block> _block);
 };
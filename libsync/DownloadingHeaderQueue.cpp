@@ -0,0 +1,265 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the verified headers of header-first downloading waiting for their bodies
+ * @file: DownloadingHeaderQueue.cpp
+ */
+
+#include "DownloadingHeaderQueue.h"
+#include <libdevcrypto/Hash.h>
+#include <libethcore/TxsParallelParser.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::sync;
+
+int64_t DownloadingHeaderQueue::tip()
+{
+    Guard l(x_headers);
+    return m_tipNumber < 0 ? m_blockChain->number() : m_tipNumber;
+}
+
+bool DownloadingHeaderQueue::nextHeaders(
+    int64_t _maxNumber, uint64_t _now, int64_t& _from, unsigned& _size)
+{
+    Guard l(x_headers);
+    if (m_headersRequestTime != 0 && _now < m_headersRequestTime + c_headerFirstRequestTimeout)
+    {
+        return false;
+    }
+    if (m_headers.size() >= c_maxHeadersAhead)
+    {
+        return false;
+    }
+    int64_t tipNumber = m_tipNumber < 0 ? m_blockChain->number() : m_tipNumber;
+    if (tipNumber >= _maxNumber)
+    {
+        return false;
+    }
+    _from = tipNumber + 1;
+    _size = (unsigned)min((int64_t)c_maxRequestHeaders, _maxNumber - tipNumber);
+    m_headersRequestTime = _now;
+    return true;
+}
+
+size_t DownloadingHeaderQueue::onHeaders(NodeID const& _peer, RLP const& _rlps)
+{
+    Guard l(x_headers);
+    m_headersRequestTime = 0;
+    if (m_tipNumber < 0)
+    {
+        m_tipNumber = m_blockChain->number();
+        m_tipHash = m_blockChain->numberHash(m_tipNumber);
+    }
+
+    size_t appended = 0;
+    for (auto const& rlp : _rlps)
+    {
+        if (m_headers.size() >= c_maxHeadersAhead)
+        {
+            break;
+        }
+        HeaderItem item;
+        item.header = BlockHeader(rlp[0].data(), HeaderData);
+        if (item.header.number() != m_tipNumber + 1 || item.header.parentHash() != m_tipHash)
+        {
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Header")
+                            << LOG_DESC("Header not linked to the tip")
+                            << LOG_KV("peer", _peer.abridged())
+                            << LOG_KV("number", item.header.number())
+                            << LOG_KV("tip", m_tipNumber);
+            break;
+        }
+
+        // the sigList is checked with the sealers of the chain head, the headers after a change
+        // of the sealers are verified once the chain reaches the change
+        Block block;
+        block.setBlockHeader(item.header);
+        block.setSigList(rlp[1].toVector<std::pair<u256, Signature>>());
+        if (!m_verify(block))
+        {
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Header")
+                            << LOG_DESC("Header not signed by the sealers")
+                            << LOG_KV("peer", _peer.abridged())
+                            << LOG_KV("number", item.header.number());
+            break;
+        }
+        item.headerRLP = rlp[0].data().toBytes();
+        item.sigListRLP = rlp[1].data().toBytes();
+
+        m_tipNumber = item.header.number();
+        m_tipHash = item.header.hash();
+        m_headers[m_tipNumber] = item;
+        ++appended;
+    }
+
+    if (m_headers.empty())
+    {
+        m_tipNumber = -1;
+    }
+    return appended;
+}
+
+bool DownloadingHeaderQueue::nextBodies(
+    int64_t _maxNumber, int64_t _maxSize, uint64_t _now, int64_t& _from, int64_t& _to)
+{
+    Guard l(x_headers);
+    bool found = false;
+    for (auto& it : m_headers)
+    {
+        HeaderItem& item = it.second;
+        if (it.first > _maxNumber)
+        {
+            break;
+        }
+        bool timeout = _now >= item.requestTime + c_headerFirstRequestTimeout;
+        bool pending = !item.received && (item.requestTime == 0 || timeout);
+        if (!found)
+        {
+            if (!pending)
+            {
+                continue;
+            }
+            found = true;
+            _from = it.first;
+        }
+        else if (!pending || it.first != _to + 1 || it.first - _from >= _maxSize)
+        {
+            break;
+        }
+        _to = it.first;
+        if (item.requestTime == 0)
+        {
+            ++m_requesting;
+        }
+        item.requestTime = _now;
+    }
+    return found;
+}
+
+size_t DownloadingHeaderQueue::onBodies(RLP const& _rlps, std::vector<bytes>& _blockRLPs)
+{
+    // the receipts are produced by executing the blocks
+    bytes emptyReceipts;
+    if (g_BCOSConfig.version() >= V2_2_0)
+    {
+        bytes receiptsData = TxsParallelParser::encode(std::vector<bytesConstRef>());
+        RLPStream receipts;
+        receipts.append(dev::ref(receiptsData));
+        receipts.swapOut(emptyReceipts);
+    }
+    else
+    {
+        emptyReceipts = RLPEmptyList;
+    }
+
+    Guard l(x_headers);
+    size_t mismatched = 0;
+    for (auto const& rlp : _rlps)
+    {
+        auto it = m_headers.find(rlp[0].toInt<int64_t>());
+        if (it == m_headers.end() || it->second.received)
+        {
+            continue;
+        }
+        HeaderItem& item = it->second;
+        if (item.requestTime != 0)
+        {
+            --m_requesting;
+            item.requestTime = 0;
+        }
+        if (sha3(rlp[1].toBytesConstRef()) != item.header.transactionsRoot())
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Body")
+                              << LOG_DESC("Body mismatches the transactionsRoot")
+                              << LOG_KV("number", it->first);
+            ++mismatched;
+            continue;
+        }
+        item.received = true;
+
+        RLPStream block;
+        block.appendList(5);
+        block.appendRaw(item.headerRLP);
+        block.appendRaw(rlp[1].data());
+        block.append(item.header.hash());
+        block.appendRaw(item.sigListRLP);
+        block.appendRaw(emptyReceipts);
+        _blockRLPs.emplace_back();
+        block.swapOut(_blockRLPs.back());
+    }
+    return mismatched;
+}
+
+void DownloadingHeaderQueue::resetBodies(int64_t _from, int64_t _to)
+{
+    Guard l(x_headers);
+    for (auto it = m_headers.lower_bound(_from); it != m_headers.end() && it->first <= _to; ++it)
+    {
+        it->second.received = false;
+    }
+}
+
+void DownloadingHeaderQueue::prune(int64_t _currentNumber)
+{
+    Guard l(x_headers);
+    auto it = m_headers.find(_currentNumber);
+    if (it != m_headers.end() &&
+        it->second.header.hash() != m_blockChain->numberHash(_currentNumber))
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Header")
+                          << LOG_DESC("Headers not on the chain, drop them")
+                          << LOG_KV("number", _currentNumber);
+        m_headers.clear();
+    }
+
+    while (!m_headers.empty() && m_headers.begin()->first <= _currentNumber)
+    {
+        if (m_headers.begin()->second.requestTime != 0)
+        {
+            --m_requesting;
+        }
+        m_headers.erase(m_headers.begin());
+    }
+    if (m_headers.empty())
+    {
+        m_tipNumber = -1;
+        m_requesting = 0;
+    }
+}
+
+void DownloadingHeaderQueue::clear()
+{
+    Guard l(x_headers);
+    m_headers.clear();
+    m_tipNumber = -1;
+    m_headersRequestTime = 0;
+    m_requesting = 0;
+}
+
+size_t DownloadingHeaderQueue::size()
+{
+    Guard l(x_headers);
+    return m_headers.size();
+}
+
+size_t DownloadingHeaderQueue::requesting()
+{
+    Guard l(x_headers);
+    return m_requesting;
+}
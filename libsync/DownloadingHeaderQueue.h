@@ -0,0 +1,98 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the verified headers of header-first downloading waiting for their bodies
+ * @file: DownloadingHeaderQueue.h
+ */
+
+#pragma once
+#include "Common.h"
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/RLP.h>
+#include <libethcore/Block.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace dev
+{
+namespace sync
+{
+/// The headers linked to the chain head and checked by the consensus ahead of their bodies. The
+/// bodies are requested by ranges of verified headers and checked against their transactionsRoot,
+/// which is the hash of the encoded transactions since RC2.
+class DownloadingHeaderQueue
+{
+public:
+    using VerifyHandler = std::function<bool(dev::eth::Block const&)>;
+
+    DownloadingHeaderQueue(std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        VerifyHandler const& _verify, NodeID const& _nodeId)
+      : m_blockChain(_blockChain), m_verify(_verify), m_nodeId(_nodeId)
+    {}
+
+    /// the number of the last verified header, the chain head if there is none
+    int64_t tip();
+    /// the headers to request next, false if a request is in flight and not timed out
+    bool nextHeaders(int64_t _maxNumber, uint64_t _now, int64_t& _from, unsigned& _size);
+    /// append the headers following the tip until one doesn't link or isn't signed by the
+    /// sealers, returns the number of the appended headers
+    size_t onHeaders(NodeID const& _peer, RLP const& _rlps);
+
+    /// the first range of verified headers whose bodies are neither requested nor received,
+    /// the requests timed out are taken over, false if there is none
+    bool nextBodies(int64_t _maxNumber, int64_t _maxSize, uint64_t _now, int64_t& _from,
+        int64_t& _to);
+    /// check the bodies against their headers, the matched blocks are encoded into _blockRLPs
+    /// and the mismatched ones requested again, returns the number of mismatched bodies
+    size_t onBodies(RLP const& _rlps, std::vector<bytes>& _blockRLPs);
+    /// the received bodies in [_from, _to] are requested again, their blocks weren't imported
+    void resetBodies(int64_t _from, int64_t _to);
+
+    /// drop the headers of the imported blocks
+    void prune(int64_t _currentNumber);
+    void clear();
+    /// headers whose blocks aren't imported
+    size_t size();
+    /// bodies requested and not received
+    size_t requesting();
+
+private:
+    struct HeaderItem
+    {
+        dev::eth::BlockHeader header;
+        bytes headerRLP;
+        bytes sigListRLP;
+        uint64_t requestTime = 0;
+        bool received = false;
+    };
+
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    VerifyHandler m_verify;
+    NodeID m_nodeId;
+
+    Mutex x_headers;
+    std::map<int64_t, HeaderItem> m_headers;
+    /// the tip is the chain head while it's -1
+    int64_t m_tipNumber = -1;
+    h256 m_tipHash;
+    uint64_t m_headersRequestTime = 0;
+    size_t m_requesting = 0;
+};
+}  // namespace sync
+}  // namespace dev
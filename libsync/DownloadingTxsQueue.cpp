@@ -27,143 +27,150 @@ using namespace dev;
 using namespace dev::sync;
 using namespace dev::eth;
 
-void DownloadingTxsQueue::push(bytesConstRef _txsBytes, NodeID const& _fromPeer)
+bool DownloadingTxsQueue::push(bytesConstRef _txsBytes, NodeID const& _fromPeer)
 {
-    WriteGuard l(x_buffer);
-    m_buffer->emplace_back(_txsBytes, _fromPeer);
+    if (!m_buffer.tryPush(DownloadTxsShard(_txsBytes, _fromPeer)))
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Tx") << LOG_DESC("Downloading txs queue full, drop shard")
+                          << LOG_KV("peer", _fromPeer.abridged())
+                          << LOG_KV("shards", m_buffer.size());
+        return false;
+    }
+    return true;
 }
 
-void DownloadingTxsQueue::pop2TxPool(
-    std::shared_ptr<dev::txpool::TxPoolInterface> _txPool, dev::eth::CheckTransaction _checkSig)
+h256s DownloadingTxsQueue::markRequested(h256s const& _txHashes, uint64_t _now)
 {
-    auto start_time = utcTime();
-    auto record_time = utcTime();
-    // fetch from buffer
-    std::shared_ptr<std::vector<DownloadTxsShard>> localBuffer = m_buffer;
-    auto moveBuffer_time_cost = utcTime() - record_time;
-    record_time = utcTime();
+    Guard l(x_requested);
+    if (_now - m_pruneTime >= c_txsRequestTimeout)
     {
-        WriteGuard l(x_buffer);
-        m_buffer = std::make_shared<std::vector<DownloadTxsShard>>();
+        for (auto it = m_requested.begin(); it != m_requested.end();)
+        {
+            if (_now - it->second >= c_txsRequestTimeout)
+                it = m_requested.erase(it);
+            else
+                ++it;
+        }
+        m_pruneTime = _now;
     }
-    auto newBuffer_time_cost = utcTime() - record_time;
-    record_time = utcTime();
 
-    if (_txPool->isFull())
-        return;
-    auto isBufferFull_time_cost = utcTime() - record_time;
-    record_time = utcTime();
-
-    for (size_t i = 0; i < localBuffer->size(); ++i)
+    h256s hashes;
+    for (auto const& hash : _txHashes)
     {
-        auto maintainBuffer_start_time = utcTime();
-        // decode
-        dev::eth::Transactions txs;
-        DownloadTxsShard const& txsShard = (*localBuffer)[i];
-        // TODO drop by Txs Shard
+        auto it = m_requested.find(hash);
+        if (it != m_requested.end() && _now - it->second < c_txsRequestTimeout)
+            continue;
+        m_requested[hash] = _now;
+        hashes.push_back(hash);
+    }
+    return hashes;
+}
 
-        NodeID fromPeer = txsShard.fromPeer;
-        auto constructRLP_time_cost = utcTime() - record_time;
-        record_time = utcTime();
+void DownloadingTxsQueue::pop2TxPool(
+    std::shared_ptr<dev::txpool::TxPoolInterface> _txPool, dev::eth::CheckTransaction _checkSig)
+{
+    auto start_time = utcTime();
+    // fetch from buffer
+    auto localBuffer = std::make_shared<std::vector<DownloadTxsShard>>();
+    m_buffer.tryPopBatch(std::back_inserter(*localBuffer), m_buffer.size());
+    if (localBuffer->empty() || _txPool->isFull())
+        return;
 
-        if (g_BCOSConfig.version() >= RC2_VERSION)
-        {
-            RLP const& txsBytesRLP = RLP(ref(txsShard.txsBytes))[0];
-            // std::cout << "decode sync txs " << toHex(txsShard.txsBytes) << std::endl;
-            dev::eth::TxsParallelParser::decode(
-                txs, txsBytesRLP.toBytesConstRef(), _checkSig, true);
-        }
-        else
-        {
-            RLP const& txsBytesRLP = RLP(ref(txsShard.txsBytes));
-            unsigned txNum = txsBytesRLP.itemCount();
-            txs.resize(txNum);
-            for (unsigned j = 0; j < txNum; j++)
+    // decode the shards in parallel, a malformed shard is dropped alone
+    std::vector<Transactions> shardTxs(localBuffer->size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, localBuffer->size()),
+        [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
             {
-                txs[j].decode(txsBytesRLP[j]);
-            }
-        }
-
-        auto decode_time_cost = utcTime() - record_time;
-        record_time = utcTime();
-
-        // parallel verify transaction before import
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, txs.size()), [&](const tbb::blocked_range<size_t>& _r) {
-                for (size_t j = _r.begin(); j != _r.end(); ++j)
+                DownloadTxsShard const& txsShard = (*localBuffer)[i];
+                try
+                {
+                    decodeShard(txsShard, shardTxs[i], _checkSig);
+                }
+                catch (std::exception& e)
                 {
-                    if (!_txPool->txExists(txs[j].sha3()))
-                        txs[j].sender();
+                    SYNC_LOG(WARNING)
+                        << LOG_BADGE("Tx") << LOG_DESC("Invalid transactions RLP received")
+                        << LOG_KV("peer", txsShard.fromPeer.abridged())
+                        << LOG_KV("reason", e.what());
+                    shardTxs[i].clear();
                 }
-            });
+            }
+        });
+    auto decode_time_cost = utcTime() - start_time;
+    auto record_time = utcTime();
 
-        auto verifySig_time_cost = utcTime() - record_time;
-        record_time = utcTime();
+    // import all the shards in one batch, the senders are recovered in parallel by the txpool
+    Transactions txs;
+    std::vector<size_t> offsets;
+    for (auto& shard : shardTxs)
+    {
+        offsets.push_back(txs.size());
+        txs.insert(txs.end(), std::make_move_iterator(shard.begin()),
+            std::make_move_iterator(shard.end()));
+    }
+    offsets.push_back(txs.size());
+    auto importResults = _txPool->batchImport(txs);
+    auto import_time_cost = utcTime() - record_time;
+    record_time = utcTime();
 
-        // import into tx pool
-        size_t successCnt = 0;
+    size_t successCnt = 0;
+    for (size_t i = 0; i < localBuffer->size(); ++i)
+    {
         std::vector<dev::h256> knownTxHash;
-        for (Transaction& tx : txs)
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
         {
-            try
-            {
-                auto importResult = _txPool->import(tx);
-                if (dev::eth::ImportResult::Success == importResult)
-                    successCnt++;
-                else if (dev::eth::ImportResult::AlreadyKnown == importResult)
-                {
-                    SYNC_LOG(TRACE)
-                        << LOG_BADGE("Tx")
-                        << LOG_DESC("Import peer transaction into txPool DUPLICATED from peer")
-                        << LOG_KV("reason", int(importResult))
-                        << LOG_KV("txHash", fromPeer.abridged())
-                        << LOG_KV("peer", std::move(tx.sha3().abridged()));
-                }
-                else
-                {
-                    SYNC_LOG(TRACE)
-                        << LOG_BADGE("Tx")
-                        << LOG_DESC("Import peer transaction into txPool FAILED from peer")
-                        << LOG_KV("reason", int(importResult))
-                        << LOG_KV("txHash", fromPeer.abridged())
-                        << LOG_KV("peer", move(tx.sha3().abridged()));
-                }
-                knownTxHash.push_back(tx.sha3());
-            }
-            catch (std::exception& e)
+            if (dev::eth::ImportResult::Success == importResults[j])
+                successCnt++;
+            else if (dev::eth::ImportResult::AlreadyKnown != importResults[j])
             {
-                SYNC_LOG(WARNING) << LOG_BADGE("Tx") << LOG_DESC("Invalid transaction RLP recieved")
-                                  << LOG_KV("reason", e.what()) << LOG_KV("rlp", toHex(tx.rlp()));
-                continue;
+                SYNC_LOG(TRACE) << LOG_BADGE("Tx")
+                                << LOG_DESC("Import peer transaction into txPool FAILED from peer")
+                                << LOG_KV("reason", int(importResults[j]))
+                                << LOG_KV("txHash", txs[j].sha3().abridged())
+                                << LOG_KV("peer", (*localBuffer)[i].fromPeer.abridged());
             }
+            knownTxHash.push_back(txs[j].sha3());
         }
-        auto import_time_cost = utcTime() - record_time;
-        record_time = utcTime();
-
         if (knownTxHash.size() > 0)
         {
-            _txPool->setTransactionsAreKnownBy(knownTxHash, fromPeer);
+            _txPool->setTransactionsAreKnownBy(knownTxHash, (*localBuffer)[i].fromPeer);
         }
-        auto setTxKnownBy_time_cost = utcTime() - record_time;
-        record_time = utcTime();
+    }
 
-        auto pengdingSize = _txPool->pendingSize();
-        auto getPendingSize_time_cost = utcTime() - record_time;
-        record_time = utcTime();
+    m_drainedTxs = txs.size();
+    m_drainTime = utcTime() - start_time;
+    SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Import peer transactions")
+                    << LOG_KV("import", successCnt) << LOG_KV("rcv", txs.size())
+                    << LOG_KV("shards", localBuffer->size())
+                    << LOG_KV("txPool", _txPool->pendingSize())
+                    << LOG_KV("decodeTimeCost", decode_time_cost)
+                    << LOG_KV("importTimeCost", import_time_cost)
+                    << LOG_KV("setTxKnownByTimeCost", utcTime() - record_time)
+                    << LOG_KV("totalTimeCost", m_drainTime);
+}
 
-        SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Import peer transactions")
-                        << LOG_KV("import", successCnt) << LOG_KV("rcv", txs.size())
-                        << LOG_KV("txPool", pengdingSize) << LOG_KV("peer", fromPeer.abridged())
-                        << LOG_KV("moveBufferTimeCost", moveBuffer_time_cost)
-                        << LOG_KV("newBufferTimeCost", newBuffer_time_cost)
-                        << LOG_KV("isBufferFullTimeCost", isBufferFull_time_cost)
-                        << LOG_KV("constructRLPTimeCost", constructRLP_time_cost)
-                        << LOG_KV("decodTimeCost", decode_time_cost)
-                        << LOG_KV("verifySigTimeCost", verifySig_time_cost)
-                        << LOG_KV("importTimeCost", import_time_cost)
-                        << LOG_KV("setTxKnownByTimeCost", setTxKnownBy_time_cost)
-                        << LOG_KV("getPendingSizeTimeCost", getPendingSize_time_cost)
-                        << LOG_KV("maintainBufferTimeCost", utcTime() - maintainBuffer_start_time)
-                        << LOG_KV("totalTimeCostFromStart", utcTime() - start_time);
+void DownloadingTxsQueue::decodeShard(DownloadTxsShard const& _txsShard,
+    dev::eth::Transactions& _txs, dev::eth::CheckTransaction _checkSig)
+{
+    if (g_BCOSConfig.version() >= RC2_VERSION)
+    {
+        RLP const& txsBytesRLP = RLP(ref(_txsShard.txsBytes))[0];
+        dev::eth::TxsParallelParser::decode(_txs, txsBytesRLP.toBytesConstRef(), _checkSig, true);
     }
+    else
+    {
+        RLP const& txsBytesRLP = RLP(ref(_txsShard.txsBytes));
+        unsigned txNum = txsBytesRLP.itemCount();
+        _txs.resize(txNum);
+        for (unsigned j = 0; j < txNum; j++)
+        {
+            _txs[j].decode(txsBytesRLP[j], _checkSig);
+        }
+    }
+}
+
+size_t DownloadingTxsQueue::bufferSize() const
+{
+    return m_buffer.size();
 }
@@ -24,9 +24,12 @@
 #include "Common.h"
 
 #include <libdevcore/Guards.h>
+#include <libdevcore/concurrent_queue.h>
 #include <libethcore/Transaction.h>
 #include <libethcore/TxsParallelParser.h>
 #include <libtxpool/TxPoolInterface.h>
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
@@ -43,23 +46,46 @@ public:
     NodeID fromPeer;
 };
 
+/// The shards received from the peers wait in a bounded lock-free ring, so that the network
+/// threads pushing them never contend on a lock with the sync thread draining them.
 class DownloadingTxsQueue
 {
 public:
+    /// the shards the ring holds, a shard received when it's full is dropped
+    static const size_t c_maxShards = 1 << 14;
+
     DownloadingTxsQueue(PROTOCOL_ID const&, NodeID const& _nodeId)
-      : m_nodeId(_nodeId), m_buffer(std::make_shared<std::vector<DownloadTxsShard>>())
+      : m_nodeId(_nodeId), m_buffer(c_maxShards)
     {}
-    // push txs bytes in queue
-    void push(bytesConstRef _txsBytes, NodeID const& _fromPeer);
+    // push txs bytes in queue, false if the queue is full
+    bool push(bytesConstRef _txsBytes, NodeID const& _fromPeer);
 
-    // pop all queue into tx pool
+    // pop all queue into tx pool, the shards are decoded in parallel and imported in one batch
     void pop2TxPool(std::shared_ptr<dev::txpool::TxPoolInterface> _txPool,
         dev::eth::CheckTransaction _checkSig = dev::eth::CheckTransaction::None);
 
+    /// shards waiting to be imported
+    size_t bufferSize() const;
+    /// the transactions and time in ms of the last pop2TxPool
+    size_t drainedTxs() const { return m_drainedTxs; }
+    uint64_t drainTime() const { return m_drainTime; }
+
+    /// the announced hashes not requested from any peer in the last c_txsRequestTimeout, they
+    /// are marked requested at _now
+    h256s markRequested(h256s const& _txHashes, uint64_t _now);
+
 private:
+    void decodeShard(DownloadTxsShard const& _txsShard, dev::eth::Transactions& _txs,
+        dev::eth::CheckTransaction _checkSig);
+
     NodeID m_nodeId;
-    std::shared_ptr<std::vector<DownloadTxsShard>> m_buffer;
-    mutable SharedMutex x_buffer;
+    MPMCQueue<DownloadTxsShard> m_buffer;
+    std::atomic<size_t> m_drainedTxs = {0};
+    std::atomic<uint64_t> m_drainTime = {0};
+
+    Mutex x_requested;
+    std::unordered_map<h256, uint64_t> m_requested;
+    uint64_t m_pruneTime = 0;
 };
 
 }  // namespace sync
@@ -0,0 +1,103 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the state diffs downloaded for the blocks to import
+ * @author: ancelmo
+ * @date: 2019-10-15
+ */
+
+#include "StateDiffQueue.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+
+void StateDiffQueue::onRequest(int64_t _from, int64_t _to, uint64_t _now)
+{
+    Guard l(x_items);
+    for (int64_t number = _from; number <= _to; ++number)
+    {
+        auto& item = m_items[number];
+        if (!item.diff)
+        {
+            // requested again, from another peer
+            item.requestTime = _now;
+            item.answered = false;
+        }
+    }
+}
+
+void StateDiffQueue::onDiffs(
+    int64_t _from, int64_t _to, map<int64_t, shared_ptr<bytes const>> const& _diffs)
+{
+    Guard l(x_items);
+    // only the diffs requested are kept, the blocks imported meanwhile are pruned
+    for (auto it = m_items.lower_bound(_from); it != m_items.end() && it->first <= _to; ++it)
+    {
+        if (it->second.diff)
+        {
+            continue;
+        }
+        auto diff = _diffs.find(it->first);
+        it->second.answered = true;
+        if (diff != _diffs.end())
+        {
+            it->second.diff = diff->second;
+        }
+    }
+}
+
+StateDiffQueue::Status StateDiffQueue::take(
+    int64_t _number, uint64_t _now, shared_ptr<bytes const>& _diff)
+{
+    Guard l(x_items);
+    auto it = m_items.find(_number);
+    if (it == m_items.end())
+    {
+        return Status::Missing;
+    }
+    if (it->second.diff)
+    {
+        _diff = it->second.diff;
+        m_items.erase(it);
+        return Status::Ready;
+    }
+    if (!it->second.answered && _now < it->second.requestTime + c_stateDiffTimeout)
+    {
+        return Status::Waiting;
+    }
+    m_items.erase(it);
+    return Status::Missing;
+}
+
+void StateDiffQueue::prune(int64_t _number)
+{
+    Guard l(x_items);
+    m_items.erase(m_items.begin(), m_items.upper_bound(_number));
+}
+
+void StateDiffQueue::clear()
+{
+    Guard l(x_items);
+    m_items.clear();
+}
+
+size_t StateDiffQueue::size() const
+{
+    Guard l(x_items);
+    return m_items.size();
+}
@@ -0,0 +1,73 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the state diffs downloaded for the blocks to import
+ * @author: ancelmo
+ * @date: 2019-10-15
+ */
+
+#pragma once
+#include "Common.h"
+#include <libdevcore/Guards.h>
+#include <map>
+#include <memory>
+
+namespace dev
+{
+namespace sync
+{
+/// The state diffs requested along with the blocks, the blocks whose diff is received are
+/// committed without being executed. A diff not received in c_stateDiffTimeout, or that the peer
+/// doesn't keep, leaves its block to be executed.
+class StateDiffQueue
+{
+public:
+    typedef std::shared_ptr<StateDiffQueue> Ptr;
+
+    enum class Status
+    {
+        Ready,    ///< the diff is received
+        Waiting,  ///< the diff is requested and may still come
+        Missing   ///< the block is to be executed
+    };
+
+    /// the diffs of the blocks _from to _to are requested at _now
+    void onRequest(int64_t _from, int64_t _to, uint64_t _now);
+    /// a peer answered the request of _from to _to with _diffs, the diffs it doesn't keep are
+    /// missing
+    void onDiffs(
+        int64_t _from, int64_t _to, std::map<int64_t, std::shared_ptr<bytes const>> const& _diffs);
+    /// the diff of the block _number is taken out if it's ready
+    Status take(int64_t _number, uint64_t _now, std::shared_ptr<bytes const>& _diff);
+    /// drop the diffs of the blocks up to _number
+    void prune(int64_t _number);
+    void clear();
+    size_t size() const;
+
+private:
+    struct Item
+    {
+        uint64_t requestTime = 0;
+        bool answered = false;
+        std::shared_ptr<bytes const> diff;
+    };
+
+    mutable Mutex x_items;
+    std::map<int64_t, Item> m_items;
+};
+}  // namespace sync
+}  // namespace dev
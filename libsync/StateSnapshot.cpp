@@ -0,0 +1,598 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : dump of all the tables at a block, served to the new nodes in chunks
+ * @file: StateSnapshot.cpp
+ */
+
+#include "StateSnapshot.h"
+#include <libdevcore/CommonIO.h>
+#include <libdevcrypto/Hash.h>
+#include <libstorage/CachedStorage.h>
+#include <libstorage/Common.h>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+using namespace dev::storage;
+using namespace dev::blockchain;
+
+#define SNAPSHOT_LOG(_OBV) \
+    LOG(_OBV) << "[g:" << std::to_string(m_groupId) << "]" << LOG_BADGE("SNAPSHOT")
+
+namespace
+{
+// key fields of the system tables, the other tables are listed in _sys_tables_
+vector<pair<string, string> > const c_sysTables = {{SYS_CONSENSUS, "name"},
+    {SYS_TABLES, "table_name"}, {SYS_ACCESS_TABLE, "table_name"}, {SYS_CURRENT_STATE, SYS_KEY},
+    {SYS_NUMBER_2_HASH, "number"}, {SYS_TX_HASH_2_BLOCK, "hash"}, {SYS_HASH_2_BLOCK, "hash"},
+    {SYS_CNS, "name"}, {SYS_CONFIG, "key"}, {SYS_BLOCK_2_NONCES, "number"}};
+
+size_t const c_scanBatchSize = 100;
+
+TableInfo::Ptr makeTableInfo(string const& _table, string const& _keyField)
+{
+    auto tableInfo = make_shared<TableInfo>();
+    tableInfo->name = _table;
+    tableInfo->key = _keyField;
+    return tableInfo;
+}
+
+bytes encodeRow(string const& _key, Entries::Ptr _entries)
+{
+    RLPStream s(2);
+    s << _key;
+    s.appendList(_entries->size());
+    for (size_t i = 0; i < _entries->size(); ++i)
+    {
+        auto entry = _entries->get(i);
+        vector<pair<string, string> > fields;
+        for (auto& field : *entry)
+        {
+            // the id, number and status are kept aside of the fields, the backends and the cache
+            // don't agree on whether they are fields
+            if (field.first != ID_FIELD && field.first != NUM_FIELD && field.first != STATUS)
+            {
+                fields.push_back(field);
+            }
+        }
+        s.appendList(4) << u256(entry->getID()) << entry->num() << entry->getStatus();
+        s.appendList(fields.size());
+        for (auto& field : fields)
+        {
+            s.appendList(2) << field.first << field.second;
+        }
+    }
+    return s.out();
+}
+}  // namespace
+
+bytes SnapshotManifest::encode() const
+{
+    RLPStream s(3);
+    s << number << blockHash;
+    s.appendList(chunks.size());
+    for (auto& chunk : chunks)
+    {
+        s.appendList(4) << chunk.table << chunk.keyField << chunk.hash << chunk.size;
+    }
+    return s.out();
+}
+
+void SnapshotManifest::decode(RLP const& _rlp)
+{
+    number = _rlp[0].toInt<int64_t>();
+    blockHash = _rlp[1].toHash<h256>(RLP::VeryStrict);
+    chunks.clear();
+    for (auto const& item : _rlp[2])
+    {
+        SnapshotChunk chunk;
+        chunk.table = item[0].toString();
+        chunk.keyField = item[1].toString();
+        chunk.hash = item[2].toHash<h256>(RLP::VeryStrict);
+        chunk.size = item[3].toInt<uint64_t>();
+        chunks.push_back(chunk);
+    }
+}
+
+h256 SnapshotManifest::hash() const
+{
+    return sha3(encode());
+}
+
+bytes dev::sync::encodeSnapshotRows(StorageIterator::Batch const& _rows)
+{
+    RLPStream s(_rows.size());
+    for (auto& row : _rows)
+    {
+        s.appendRaw(encodeRow(row.first, row.second));
+    }
+    return s.out();
+}
+
+StorageIterator::Batch dev::sync::decodeSnapshotRows(bytesConstRef _data)
+{
+    StorageIterator::Batch rows;
+    RLP rlp(_data);
+    for (auto const& row : rlp)
+    {
+        auto entries = makeShared<Entries>();
+        for (auto const& item : row[1])
+        {
+            auto entry = makeShared<Entry>();
+            for (auto const& field : item[3])
+            {
+                entry->setField(field[0].toString(), field[1].toString());
+            }
+            entry->setID(item[0].toInt<uint64_t>());
+            entry->setNum(item[1].toInt<uint32_t>());
+            entry->setStatus(item[2].toInt<int>());
+            entries->addEntry(entry);
+        }
+        rows.emplace_back(row[0].toString(), entries);
+    }
+    return rows;
+}
+
+SnapshotStore::SnapshotStore(Storage::Ptr _storage, shared_ptr<BlockChainInterface> _blockChain,
+    string const& _path, GROUP_ID _groupId)
+  : m_storage(_storage), m_blockChain(_blockChain), m_path(_path), m_groupId(_groupId)
+{
+    load();
+}
+
+SnapshotManifest::Ptr SnapshotStore::build(int64_t _number)
+{
+    auto manifest = make_shared<SnapshotManifest>();
+    auto tmpPath = snapshotPath(_number) + ".tmp";
+    auto start = utcTime();
+    bool dumped = false;
+    CachedSnapshot::Ptr snapshot;
+    auto cachedStorage = dynamic_pointer_cast<CachedStorage>(m_storage);
+    m_blockChain->withCommitLock([&](int64_t _latest) {
+        if (_latest != _number)
+        {
+            return;
+        }
+
+        manifest->number = _number;
+        manifest->blockHash = m_blockChain->numberHash(_number);
+        // the cache pins the block, the tables are dumped while the next blocks are committed
+        if (cachedStorage)
+        {
+            snapshot = cachedStorage->snapshot();
+            if (snapshot->num() == _number)
+            {
+                return;
+            }
+            snapshot.reset();
+        }
+        dump(m_storage, manifest, tmpPath);
+        dumped = true;
+    });
+    if (snapshot)
+    {
+        dump(snapshot, manifest, tmpPath);
+        snapshot.reset();
+        dumped = true;
+    }
+
+    if (!dumped)
+    {
+        SNAPSHOT_LOG(INFO) << LOG_DESC("Skip the dump, the chain has moved past the block")
+                           << LOG_KV("number", _number);
+        return nullptr;
+    }
+
+    auto manifestRLP = manifest->encode();
+    writeFile(tmpPath + "/manifest", manifestRLP);
+    auto path = snapshotPath(_number);
+    boost::filesystem::remove_all(path);
+    boost::filesystem::rename(tmpPath, path);
+
+    SnapshotManifest::Ptr previous;
+    {
+        WriteGuard l(x_manifest);
+        previous = m_manifest;
+        m_manifest = manifest;
+        m_manifestRLP = manifestRLP;
+        m_manifestHash = sha3(manifestRLP);
+    }
+    if (previous && previous->number != _number)
+    {
+        boost::system::error_code error;
+        boost::filesystem::remove_all(snapshotPath(previous->number), error);
+    }
+
+    SNAPSHOT_LOG(INFO) << LOG_DESC("Dump the tables") << LOG_KV("number", _number)
+                       << LOG_KV("chunks", manifest->chunks.size())
+                       << LOG_KV("timeCost", utcTime() - start);
+    return manifest;
+}
+
+void SnapshotStore::dump(
+    Storage::Ptr _storage, SnapshotManifest::Ptr _manifest, string const& _tmpPath)
+{
+    boost::filesystem::remove_all(_tmpPath);
+    boost::filesystem::create_directories(_tmpPath);
+
+    for (auto& tableInfo : tables(_storage))
+    {
+        vector<bytes> rows;
+        size_t size = 0;
+        auto flush = [&]() {
+            RLPStream s(rows.size());
+            for (auto& row : rows)
+            {
+                s.appendRaw(row);
+            }
+            SnapshotChunk chunk;
+            chunk.table = tableInfo->name;
+            chunk.keyField = tableInfo->key;
+            chunk.hash = sha3(s.out());
+            chunk.size = size;
+            writeFile(_tmpPath + "/" + to_string(_manifest->chunks.size()), s.out());
+            _manifest->chunks.push_back(chunk);
+            rows.clear();
+            size = 0;
+        };
+
+        auto it = _storage->scan(tableInfo, "", "", c_scanBatchSize);
+        StorageIterator::Batch batch;
+        while (it->next(batch))
+        {
+            for (auto& row : batch)
+            {
+                rows.push_back(encodeRow(row.first, row.second));
+                size += rows.back().size();
+                if (size >= c_snapshotChunkSize)
+                {
+                    flush();
+                }
+            }
+        }
+        if (!rows.empty())
+        {
+            flush();
+        }
+    }
+}
+
+SnapshotManifest::Ptr SnapshotStore::manifest() const
+{
+    ReadGuard l(x_manifest);
+    return m_manifest;
+}
+
+bytes SnapshotStore::manifestRLP() const
+{
+    ReadGuard l(x_manifest);
+    return m_manifestRLP;
+}
+
+shared_ptr<bytes> SnapshotStore::chunk(h256 const& _manifestHash, size_t _index) const
+{
+    int64_t number;
+    {
+        ReadGuard l(x_manifest);
+        if (!m_manifest || _manifestHash != m_manifestHash || _index >= m_manifest->chunks.size())
+        {
+            return nullptr;
+        }
+        number = m_manifest->number;
+    }
+
+    auto data = make_shared<bytes>(contents(snapshotPath(number) + "/" + to_string(_index)));
+    if (data->empty())
+    {
+        return nullptr;
+    }
+    return data;
+}
+
+void SnapshotStore::load()
+{
+    if (!boost::filesystem::exists(m_path))
+    {
+        boost::filesystem::create_directories(m_path);
+        return;
+    }
+
+    // the latest complete dump, the interrupted ones are left in .tmp directories
+    int64_t latest = -1;
+    for (boost::filesystem::directory_iterator it(m_path);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        try
+        {
+            auto number = boost::lexical_cast<int64_t>(it->path().filename().string());
+            if (number > latest && boost::filesystem::exists(snapshotPath(number) + "/manifest"))
+            {
+                latest = number;
+            }
+        }
+        catch (boost::bad_lexical_cast&)
+        {
+            continue;
+        }
+    }
+    if (latest < 0)
+    {
+        return;
+    }
+
+    auto manifestRLP = contents(snapshotPath(latest) + "/manifest");
+    auto manifest = make_shared<SnapshotManifest>();
+    try
+    {
+        manifest->decode(RLP(manifestRLP));
+    }
+    catch (std::exception& e)
+    {
+        SNAPSHOT_LOG(WARNING) << LOG_DESC("Load manifest failed") << LOG_KV("number", latest)
+                              << LOG_KV("reason", e.what());
+        return;
+    }
+
+    WriteGuard l(x_manifest);
+    m_manifest = manifest;
+    m_manifestRLP = manifestRLP;
+    m_manifestHash = sha3(manifestRLP);
+    SNAPSHOT_LOG(INFO) << LOG_DESC("Load the dump") << LOG_KV("number", latest)
+                       << LOG_KV("chunks", manifest->chunks.size());
+}
+
+vector<TableInfo::Ptr> SnapshotStore::tables(Storage::Ptr _storage)
+{
+    vector<TableInfo::Ptr> tables;
+    set<string> names;
+    for (auto& table : c_sysTables)
+    {
+        tables.push_back(makeTableInfo(table.first, table.second));
+        names.insert(table.first);
+    }
+
+    auto it = _storage->scan(makeTableInfo(SYS_TABLES, "table_name"), "", "", c_scanBatchSize);
+    StorageIterator::Batch batch;
+    while (it->next(batch))
+    {
+        for (auto& row : batch)
+        {
+            if (row.second->size() > 0 && names.insert(row.first).second)
+            {
+                tables.push_back(
+                    makeTableInfo(row.first, row.second->get(0)->getField("key_field")));
+            }
+        }
+    }
+    return tables;
+}
+
+string SnapshotStore::snapshotPath(int64_t _number) const
+{
+    return m_path + "/" + to_string(_number);
+}
+
+SnapshotImporter::SnapshotImporter(
+    Storage::Ptr _storage, shared_ptr<BlockChainInterface> _blockChain, GROUP_ID _groupId)
+  : m_storage(_storage),
+    m_blockChain(_blockChain),
+    m_groupId(_groupId),
+    m_restorePool(make_shared<dev::ThreadPool>(
+        "SyncSnap-" + to_string(_groupId), 2, dev::TaskPriority::Low))
+{}
+
+void SnapshotImporter::onManifest(NodeID const& _peer, SnapshotManifest::Ptr _manifest)
+{
+    auto hash = _manifest->hash();
+    Guard l(x_importer);
+    if (m_agreed)
+    {
+        return;
+    }
+    m_announced[_peer] = hash;
+    m_manifests[hash] = _manifest;
+}
+
+SnapshotManifest::Ptr SnapshotImporter::agreed()
+{
+    int64_t number = m_blockChain->number();
+    Guard l(x_importer);
+    if (m_agreed)
+    {
+        return m_agreed;
+    }
+
+    map<h256, size_t> votes;
+    for (auto& it : m_announced)
+    {
+        votes[it.second]++;
+    }
+
+    h256 best;
+    size_t bestVotes = 0;
+    for (auto& it : votes)
+    {
+        auto manifest = m_manifests[it.first];
+        if (it.second < c_minSnapshotPeers || manifest->number <= number)
+        {
+            continue;
+        }
+        if (it.second > bestVotes ||
+            (it.second == bestVotes && manifest->number > m_manifests[best]->number))
+        {
+            best = it.first;
+            bestVotes = it.second;
+        }
+    }
+    if (bestVotes == 0)
+    {
+        return nullptr;
+    }
+
+    m_agreed = m_manifests[best];
+    m_agreedHash = best;
+    m_received.assign(m_agreed->chunks.size(), false);
+    for (size_t i = 0; i < m_agreed->chunks.size(); ++i)
+    {
+        m_pending.insert(i);
+    }
+    SNAPSHOT_LOG(INFO) << LOG_DESC("Agree on the manifest") << LOG_KV("number", m_agreed->number)
+                       << LOG_KV("hash", best.abridged()) << LOG_KV("peers", bestVotes)
+                       << LOG_KV("chunks", m_agreed->chunks.size());
+    return m_agreed;
+}
+
+h256 SnapshotImporter::agreedHash() const
+{
+    Guard l(x_importer);
+    return m_agreedHash;
+}
+
+vector<size_t> SnapshotImporter::request(NodeID const& _peer, uint64_t _now)
+{
+    vector<size_t> indexes;
+    Guard l(x_importer);
+    auto announced = m_announced.find(_peer);
+    if (!m_agreed || announced == m_announced.end() || announced->second != m_agreedHash)
+    {
+        return indexes;
+    }
+
+    size_t requesting = 0;
+    for (auto it = m_requesting.begin(); it != m_requesting.end();)
+    {
+        if (it->second.time + c_snapshotChunkTimeout < _now)
+        {
+            m_pending.insert(it->first);
+            it = m_requesting.erase(it);
+            continue;
+        }
+        if (it->second.peer == _peer)
+        {
+            ++requesting;
+        }
+        ++it;
+    }
+
+    while (requesting < c_maxSnapshotChunksPerPeer && !m_pending.empty())
+    {
+        auto index = *m_pending.begin();
+        m_pending.erase(m_pending.begin());
+        m_requesting[index] = ChunkRequest{_peer, _now};
+        indexes.push_back(index);
+        ++requesting;
+    }
+    return indexes;
+}
+
+bool SnapshotImporter::onChunk(
+    NodeID const& _peer, h256 const& _manifestHash, size_t _index, shared_ptr<bytes> _data)
+{
+    SnapshotChunk chunk;
+    {
+        Guard l(x_importer);
+        if (!m_agreed || _manifestHash != m_agreedHash || _index >= m_received.size() ||
+            m_received[_index])
+        {
+            return false;
+        }
+        chunk = m_agreed->chunks[_index];
+    }
+
+    if (sha3(*_data) != chunk.hash)
+    {
+        SNAPSHOT_LOG(WARNING) << LOG_DESC("Receive corrupted chunk") << LOG_KV("index", _index)
+                              << LOG_KV("peer", _peer.abridged());
+        Guard l(x_importer);
+        if (!m_received[_index] && m_requesting.erase(_index))
+        {
+            m_pending.insert(_index);
+        }
+        return false;
+    }
+
+    {
+        Guard l(x_importer);
+        if (m_received[_index])
+        {
+            return false;
+        }
+        m_received[_index] = true;
+        m_requesting.erase(_index);
+        m_pending.erase(_index);
+    }
+
+    m_restorePool->enqueue([this, _index, _data]() { restore(_index, _data); });
+    return true;
+}
+
+void SnapshotImporter::restore(size_t _index, shared_ptr<bytes> _data)
+{
+    SnapshotChunk chunk;
+    {
+        Guard l(x_importer);
+        chunk = m_agreed->chunks[_index];
+    }
+
+    try
+    {
+        auto rows = decodeSnapshotRows(ref(*_data));
+        m_storage->restore(makeTableInfo(chunk.table, chunk.keyField), rows);
+        ++m_restored;
+        SNAPSHOT_LOG(DEBUG) << LOG_DESC("Restore chunk") << LOG_KV("index", _index)
+                            << LOG_KV("table", chunk.table) << LOG_KV("keys", rows.size())
+                            << LOG_KV("restored", m_restored.load());
+    }
+    catch (std::exception& e)
+    {
+        SNAPSHOT_LOG(ERROR) << LOG_DESC("Restore chunk failed") << LOG_KV("index", _index)
+                            << LOG_KV("table", chunk.table) << LOG_KV("reason", e.what());
+        // downloaded again, restoring the keys again is harmless
+        Guard l(x_importer);
+        m_received[_index] = false;
+        m_pending.insert(_index);
+    }
+}
+
+bool SnapshotImporter::finished() const
+{
+    Guard l(x_importer);
+    return m_agreed && m_restored == m_agreed->chunks.size();
+}
+
+bool SnapshotImporter::finish()
+{
+    m_blockChain->reload();
+    auto number = m_blockChain->number();
+    auto hash = m_blockChain->numberHash(number);
+    if (number != m_agreed->number || hash != m_agreed->blockHash)
+    {
+        SNAPSHOT_LOG(ERROR) << LOG_DESC("The restored block mismatches the manifest")
+                            << LOG_KV("number", number) << LOG_KV("hash", hash.abridged())
+                            << LOG_KV("manifestNumber", m_agreed->number)
+                            << LOG_KV("manifestHash", m_agreed->blockHash.abridged());
+        return false;
+    }
+
+    SNAPSHOT_LOG(INFO) << LOG_DESC("Restore the snapshot") << LOG_KV("number", number)
+                       << LOG_KV("hash", hash.abridged())
+                       << LOG_KV("chunks", m_agreed->chunks.size());
+    return true;
+}
@@ -0,0 +1,163 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : dump of all the tables at a block, served to the new nodes in chunks
+ * @file: StateSnapshot.h
+ */
+
+#pragma once
+#include "Common.h"
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/ThreadPool.h>
+#include <libstorage/Storage.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace sync
+{
+/// keys of one table in ascending order, a table is cut into several chunks
+struct SnapshotChunk
+{
+    std::string table;
+    std::string keyField;
+    h256 hash;
+    uint64_t size = 0;
+};
+
+/// the chunks of a dump at a block, the peers dumping the same block build the same manifest
+class SnapshotManifest
+{
+public:
+    typedef std::shared_ptr<SnapshotManifest> Ptr;
+
+    int64_t number = -1;
+    h256 blockHash;
+    std::vector<SnapshotChunk> chunks;
+
+    bytes encode() const;
+    /// throws if the rlp is not a manifest
+    void decode(RLP const& _rlp);
+    h256 hash() const;
+};
+
+/// the rows of a chunk, the ids, numbers and status of the entries are kept
+bytes encodeSnapshotRows(dev::storage::StorageIterator::Batch const& _rows);
+dev::storage::StorageIterator::Batch decodeSnapshotRows(bytesConstRef _data);
+
+/// Dumps the tables every few blocks and serves the chunks of the latest dump. The tables are
+/// dumped from a snapshot of the cache pinned at the block, without a cache the blocks aren't
+/// committed while the tables are dumped. The chunks are kept in files under _path.
+class SnapshotStore
+{
+public:
+    typedef std::shared_ptr<SnapshotStore> Ptr;
+
+    SnapshotStore(dev::storage::Storage::Ptr _storage,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        std::string const& _path, GROUP_ID _groupId);
+
+    /// dump the tables at block _number, nothing is dumped if the chain has moved past it
+    SnapshotManifest::Ptr build(int64_t _number);
+    /// the latest dump, null if there is none
+    SnapshotManifest::Ptr manifest() const;
+    bytes manifestRLP() const;
+    /// a chunk of the latest dump, null if _manifestHash isn't the latest one
+    std::shared_ptr<bytes> chunk(h256 const& _manifestHash, size_t _index) const;
+
+private:
+    void load();
+    /// write the chunks of the tables into _tmpPath and list them in the manifest
+    void dump(dev::storage::Storage::Ptr _storage, SnapshotManifest::Ptr _manifest,
+        std::string const& _tmpPath);
+    /// the system tables and the tables listed in _sys_tables_
+    std::vector<dev::storage::TableInfo::Ptr> tables(dev::storage::Storage::Ptr _storage);
+    std::string snapshotPath(int64_t _number) const;
+
+    dev::storage::Storage::Ptr m_storage;
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    std::string m_path;
+    GROUP_ID m_groupId;
+
+    mutable SharedMutex x_manifest;
+    SnapshotManifest::Ptr m_manifest;
+    bytes m_manifestRLP;
+    h256 m_manifestHash;
+};
+
+/// Downloads the chunks of the manifest announced by the most peers and restores them into the
+/// storage. Each chunk is checked against its hash in the manifest before it's restored.
+class SnapshotImporter
+{
+public:
+    typedef std::shared_ptr<SnapshotImporter> Ptr;
+
+    SnapshotImporter(dev::storage::Storage::Ptr _storage,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain, GROUP_ID _groupId);
+    ~SnapshotImporter() { m_restorePool->stop(); }
+
+    void onManifest(NodeID const& _peer, SnapshotManifest::Ptr _manifest);
+    /// the manifest announced by the most peers, at least c_minSnapshotPeers of them, above the
+    /// local block, null if there is none yet
+    SnapshotManifest::Ptr agreed();
+    h256 agreedHash() const;
+    /// chunks to request from the peer, the timed out requests are taken over
+    std::vector<size_t> request(NodeID const& _peer, uint64_t _now);
+    /// verify the chunk and queue it to be restored, false if it isn't expected or is corrupted
+    bool onChunk(NodeID const& _peer, h256 const& _manifestHash, size_t _index,
+        std::shared_ptr<bytes> _data);
+
+    bool finished() const;
+    /// reload the chain, false if the restored block isn't the block of the manifest
+    bool finish();
+    size_t restoredChunks() const { return m_restored; }
+
+private:
+    void restore(size_t _index, std::shared_ptr<bytes> _data);
+
+    struct ChunkRequest
+    {
+        NodeID peer;
+        uint64_t time;
+    };
+
+    dev::storage::Storage::Ptr m_storage;
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    GROUP_ID m_groupId;
+    dev::ThreadPool::Ptr m_restorePool;
+
+    mutable Mutex x_importer;
+    std::map<NodeID, h256> m_announced;
+    std::map<h256, SnapshotManifest::Ptr> m_manifests;
+    SnapshotManifest::Ptr m_agreed;
+    h256 m_agreedHash;
+    /// chunks neither requested nor restored
+    std::set<size_t> m_pending;
+    std::map<size_t, ChunkRequest> m_requesting;
+    /// chunks received and being or already restored
+    std::vector<bool> m_received;
+    std::atomic<size_t> m_restored = {0};
+};
+}  // namespace sync
+}  // namespace dev
@@ -23,6 +23,10 @@
 #include "SyncMaster.h"
 #include <json/json.h>
 #include <libblockchain/BlockChainInterface.h>
+#include <libstorage/StateDiff.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace dev;
@@ -51,6 +55,11 @@ void SyncMaster::printSyncInfo()
                     << m_blockChain->numberHash(m_blockChain->number()) << "\n"
                     << "            Genesis hash: " << m_syncStatus->genesisHash.abridged() << "\n"
                     << "            TxPool size:  " << pendingSize << "\n"
+                    << "            TxsQueue:     " << m_txQueue->bufferSize() << " shards, last "
+                    << m_txQueue->drainedTxs() << " txs in " << m_txQueue->drainTime() << "ms\n"
+                    << "            Block cache:  " << BlockRLPCache::instance().size() << " blocks, "
+                    << BlockRLPCache::instance().hits() << " hits, "
+                    << BlockRLPCache::instance().misses() << " misses\n"
                     << "            Peers size:   " << m_syncStatus->peers().size() << "\n"
                     << "[Peer Info] --------------------------------------------\n"
                     << "    Host: " << m_nodeId.abridged() << "\n"
@@ -116,6 +125,12 @@ void SyncMaster::stop()
 {
     doneWorking();
     stopWorking();
+    m_finalizePool->stop();
+    m_preparePool->stop();
+    if (m_snapshotPool)
+    {
+        m_snapshotPool->stop();
+    }
     // will not restart worker, so terminate it
     terminate();
 }
@@ -135,11 +150,18 @@ void SyncMaster::doWork()
     auto maintainPeersConnection_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
+    // the blocks are downloaded once the snapshot is restored
+    if (maintainSnapshot())
+    {
+        return;
+    }
+
     maintainDownloadingQueueBuffer();
     auto maintainDownloadingQueueBuffer_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
     maintainPeersStatus();
+    maintainBulkLoad();
     auto maintainPeersStatus_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
@@ -159,6 +181,7 @@ void SyncMaster::doWork()
         if (m_needMaintainTransactions && m_newTransactions)
         {
             m_newTransactions = false;
+            m_active = true;
             maintainTransactions();
         }
         maintainTransactions_time_cost = utcTime() - record_time;
@@ -203,21 +226,37 @@ void SyncMaster::workLoop()
 {
     while (workerState() == WorkerState::Started)
     {
+        m_active = false;
         doWork();
         if (idleWaitMs())
         {
-            std::unique_lock<std::mutex> l(x_signalled);
-            m_signalled.wait_for(l, std::chrono::milliseconds(idleWaitMs()));
+            // an idle group backs off, the new blocks, transactions and packets wake it at once
+            if (m_active || isSyncing())
+                m_idleWait = idleWaitMs();
+            else
+                m_idleWait = min(m_idleWait * 2, c_maxIdleWaitMs);
+            waitForWork(m_idleWait);
         }
     }
 }
 
+void SyncMaster::wakeUp()
+{
+    m_idleWait = idleWaitMs();
+    notifyWork();
+}
 
 void SyncMaster::noteSealingBlockNumber(int64_t _number)
 {
-    WriteGuard l(x_currentSealingNumber);
-    m_currentSealingNumber = _number;
-    m_signalled.notify_all();
+    {
+        WriteGuard l(x_currentSealingNumber);
+        if (_number == m_currentSealingNumber)
+            return;
+        m_currentSealingNumber = _number;
+    }
+    // the new status is announced with the wake-up of the new sealing number, the consensus
+    // noting the same number again wakes nothing
+    noteNewBlocks();
 }
 
 bool SyncMaster::isSyncing() const
@@ -234,75 +273,331 @@ bool SyncMaster::isFarSyncing() const
 
 void SyncMaster::maintainTransactions()
 {
-    unordered_map<NodeID, std::vector<size_t>> peerTransactions;
+    // the transactions and hashes sent to each peer in this round, bounded by c_maxPeerTxsBytes
+    // together with the bytes still queued in the session of the peer
+    unordered_map<NodeID, std::vector<bytes>> peerTransactions;
+    unordered_map<NodeID, h256s> peerAnnounces;
+    unordered_map<NodeID, size_t> peerBytes;
+
+    // the transactions requested by the peers are sent first, the ones beyond the bound wait
+    size_t sealers = 0;
+    m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+        if (_p->isSealer)
+            ++sealers;
+        size_t& sentBytes = peerBytes[_p->nodeId];
+        sentBytes = m_service->writeQueueBytes(_p->nodeId);
+        if (0 == _p->txsRequests.size())
+            return true;
+        auto hashes = _p->txsRequests.pop(c_maxSendTransactions);
+        Transactions txs;
+        std::vector<bool> missed(hashes.size(), false);
+        // the transactions sealed since they were announced are skipped
+        for (auto i : m_txPool->fetchTransactions(hashes, txs))
+            missed[i] = true;
+        h256s served;
+        for (size_t i = 0; i < hashes.size(); ++i)
+        {
+            if (missed[i])
+                continue;
+            bytes txRLP = txs[i].rlp(WithSignature);
+            if (sentBytes + txRLP.size() > c_maxPeerTxsBytes)
+            {
+                _p->txsRequests.push(h256s(hashes.begin() + i, hashes.end()));
+                break;
+            }
+            sentBytes += txRLP.size();
+            peerTransactions[_p->nodeId].emplace_back(std::move(txRLP));
+            served.push_back(hashes[i]);
+        }
+        m_txPool->setTransactionsAreKnownBy(served, _p->nodeId);
+        return true;
+    });
 
     auto ts = m_txPool->topTransactionsCondition(c_maxSendTransactions, m_nodeId);
     auto txSize = ts.size();
     auto pendingSize = m_txPool->pendingSize();
 
+    // the new transactions are pushed in full to about sqrt(n) sealers and announced to the
+    // others, fewer are pushed when the transactions pile up; the transactions received from
+    // the peers are only announced
+    size_t fanout = max(c_minTxsFanout, (size_t)std::sqrt(sealers));
+    if (txSize >= c_maxSendTransactions)
+        fanout = max((size_t)1, fanout / 2);
+
     SYNC_LOG(TRACE) << LOG_BADGE("Tx") << LOG_DESC("Transaction need to send ")
-                    << LOG_KV("txs", txSize) << LOG_KV("totalTxs", pendingSize);
+                    << LOG_KV("txs", txSize) << LOG_KV("totalTxs", pendingSize)
+                    << LOG_KV("fanout", fanout);
     UpgradableGuard l(m_txPool->xtransactionKnownBy());
-    for (size_t i = 0; i < ts.size(); ++i)
+    for (auto const& t : ts)
     {
-        auto const& t = ts[i];
-        NodeIDs peers;
-        unsigned _percent = m_txPool->isTransactionKnownBySomeone(t.sha3()) ? 25 : 100;
-
-        peers = m_syncStatus->randomSelection(_percent, [&](std::shared_ptr<SyncPeerStatus> _p) {
-            bool unsent = !m_txPool->isTransactionKnownBy(t.sha3(), m_nodeId);
-            bool isSealer = _p->isSealer;
-            return isSealer && unsent && !m_txPool->isTransactionKnownBy(t.sha3(), _p->nodeId);
+        h256 const& txHash = t.sha3();
+        bool received = m_txPool->isTransactionKnownBySomeone(txHash);
+        NodeIDs peers = m_syncStatus->randomSelection(100, [&](shared_ptr<SyncPeerStatus> _p) {
+            return _p->isSealer && !m_txPool->isTransactionKnownBy(txHash, _p->nodeId);
         });
-        if (0 == peers.size())
-            return;
         UpgradeGuard ul(l);
-        m_txPool->setTransactionIsKnownBy(t.sha3(), m_nodeId);
+        m_txPool->setTransactionIsKnownBy(txHash, m_nodeId);
+        bytes txRLP;
+        size_t pushed = 0;
         for (auto const& p : peers)
         {
-            peerTransactions[p].push_back(i);
-            m_txPool->setTransactionIsKnownBy(t.sha3(), p);
+            size_t& sentBytes = peerBytes[p];
+            if (!received && pushed < fanout)
+            {
+                if (txRLP.empty())
+                    txRLP = t.rlp(WithSignature);
+                if (sentBytes + txRLP.size() <= c_maxPeerTxsBytes)
+                {
+                    sentBytes += txRLP.size();
+                    peerTransactions[p].push_back(txRLP);
+                    m_txPool->setTransactionIsKnownBy(txHash, p);
+                    ++pushed;
+                    continue;
+                }
+            }
+            // the peers past the bound in this round learn the transaction from the others
+            if (sentBytes + h256::size > c_maxPeerTxsBytes)
+                continue;
+            sentBytes += h256::size;
+            peerAnnounces[p].push_back(txHash);
+            m_txPool->setTransactionIsKnownBy(txHash, p);
         }
     }
 
     m_syncStatus->foreachPeerRandom([&](shared_ptr<SyncPeerStatus> _p) {
-        std::vector<bytes> txRLPs;
-        unsigned txsSize = peerTransactions[_p->nodeId].size();
-        if (0 == txsSize)
-            return true;  // No need to send
-
-        for (auto const& i : peerTransactions[_p->nodeId])
-            txRLPs.emplace_back(ts[i].rlp(WithSignature));
+        auto const& txRLPs = peerTransactions[_p->nodeId];
+        for (size_t i = 0; i < txRLPs.size(); i += c_txsBatchSize)
+        {
+            std::vector<bytes> batch(
+                txRLPs.begin() + i, txRLPs.begin() + min(i + c_txsBatchSize, txRLPs.size()));
+            SyncTransactionsPacket packet;
+            packet.encode(batch);
 
-        SyncTransactionsPacket packet;
-        packet.encode(txRLPs);
+            auto msg = packet.toMessage(m_protocolId);
+            m_service->asyncSendMessageByNodeID(
+                _p->nodeId, msg, CallbackFuncWithSession(), Options());
 
-        auto msg = packet.toMessage(m_protocolId);
-        m_service->asyncSendMessageByNodeID(_p->nodeId, msg, CallbackFuncWithSession(), Options());
+            SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Send transaction to peer")
+                            << LOG_KV("txNum", batch.size())
+                            << LOG_KV("toNodeId", _p->nodeId.abridged())
+                            << LOG_KV("messageSize(B)", msg->buffer()->size());
+        }
 
-        SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Send transaction to peer")
-                        << LOG_KV("txNum", int(txsSize))
-                        << LOG_KV("toNodeId", _p->nodeId.abridged())
-                        << LOG_KV("messageSize(B)", msg->buffer()->size());
+        auto const& txHashes = peerAnnounces[_p->nodeId];
+        if (!txHashes.empty())
+        {
+            SyncTxsAnnouncePacket packet;
+            packet.encode(txHashes);
+            m_service->asyncSendMessageByNodeID(
+                _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+            SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Announce transactions to peer")
+                            << LOG_KV("txNum", txHashes.size())
+                            << LOG_KV("toNodeId", _p->nodeId.abridged());
+        }
         return true;
     });
 }
 
 void SyncMaster::maintainDownloadingTransactions()
 {
+    if (m_txQueue->bufferSize() > 0)
+        m_active = true;
     m_txQueue->pop2TxPool(m_txPool);
 }
 
-void SyncMaster::maintainBlocks()
+void SyncMaster::setSnapshotStore(SnapshotStore::Ptr _store, int64_t _interval)
+{
+    m_snapshotStore = _store;
+    m_snapshotInterval = _interval;
+    m_snapshotPool = std::make_shared<dev::ThreadPool>("SyncDump-" + std::to_string(m_groupId), 1);
+    m_msgEngine->setSnapshotStore(_store);
+}
+
+void SyncMaster::setSnapshotImporter(SnapshotImporter::Ptr _importer)
 {
-    if (!m_newBlocks && utcTime() <= m_maintainBlocksTimeout)
+    m_snapshotImporter = _importer;
+    m_msgEngine->setSnapshotImporter(_importer);
+}
+
+void SyncMaster::enableHeaderFirst()
+{
+    // the handler is registered by the consensus after the sync is built
+    m_headerQueue = std::make_shared<DownloadingHeaderQueue>(
+        m_blockChain,
+        [this](Block const& _block) { return fp_isConsensusOk && fp_isConsensusOk(_block); },
+        m_nodeId);
+    m_msgEngine->setHeaderQueue(m_headerQueue);
+}
+
+void SyncMaster::enableStateDiff()
+{
+    m_stateDiffQueue = std::make_shared<StateDiffQueue>();
+    m_msgEngine->setStateDiffQueue(m_stateDiffQueue);
+}
+
+void SyncMaster::requestStateDiffs(
+    NodeID const& _peer, int64_t _from, int64_t _to, uint64_t _now)
+{
+    if (!m_stateDiffQueue)
+    {
         return;
+    }
+    SyncReqStateDiffsPacket packet;
+    packet.encode(_from, _to - _from + 1);
+    m_stateDiffQueue->onRequest(_from, _to, _now);
+    m_service->asyncSendMessageByNodeID(
+        _peer, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+}
 
-    m_newBlocks = false;
-    m_maintainBlocksTimeout = utcTime() + c_maintainBlocksTimeout;
+ExecutiveContext::Ptr SyncMaster::applyStateDiff(
+    Block& _block, BlockInfo const& _parent, bytes const& _diff)
+{
+    try
+    {
+        dev::storage::StateDiff stateDiff;
+        stateDiff.decode(ref(_diff));
+        return m_blockVerifier->applyStateDiff(_block, _parent, stateDiff);
+    }
+    catch (std::exception& e)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("StateDiff")
+                          << LOG_DESC("Invalid state diff, execute the block")
+                          << LOG_KV("number", _block.header().number())
+                          << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return nullptr;
+    }
+}
 
+void SyncMaster::maintainBulkLoad()
+{
+    if (!m_bulkLoadHandler)
+    {
+        return;
+    }
+    // the bulk load ends within half the distance it starts at, not to switch at the edge
+    int64_t behind = m_syncStatus->knownHighestNumber - m_blockChain->number();
+    bool bulkLoading =
+        m_bulkLoading ? behind > m_bulkLoadBlocks / 2 : behind > m_bulkLoadBlocks;
+    if (bulkLoading == m_bulkLoading)
+    {
+        return;
+    }
+    m_bulkLoading = bulkLoading;
+    SYNC_LOG(INFO) << LOG_BADGE("BulkLoad") << LOG_KV("bulkLoading", bulkLoading)
+                   << LOG_KV("behind", behind)
+                   << LOG_KV("knownHighestNumber", m_syncStatus->knownHighestNumber);
+    m_bulkLoadHandler(bulkLoading);
+}
 
+void SyncMaster::noteSnapshotBlock(int64_t _number)
+{
+    if (!m_snapshotStore || m_snapshotInterval <= 0 || _number <= 0 ||
+        _number % m_snapshotInterval != 0 || m_buildingSnapshot.exchange(true))
+    {
+        return;
+    }
+
+    auto store = m_snapshotStore;
+    m_snapshotPool->enqueue([this, store, _number]() {
+        try
+        {
+            store->build(_number);
+        }
+        catch (std::exception& e)
+        {
+            SYNC_LOG(ERROR) << LOG_BADGE("Snapshot") << LOG_DESC("Dump the tables failed")
+                            << LOG_KV("number", _number) << LOG_KV("reason", e.what());
+        }
+        m_buildingSnapshot = false;
+    });
+}
+
+bool SyncMaster::maintainSnapshot()
+{
+    if (!m_snapshotImporter)
+    {
+        return false;
+    }
+
+    auto now = utcTime();
+    if (m_snapshotStartTime == 0)
+    {
+        m_snapshotStartTime = now;
+    }
+
+    auto manifest = m_snapshotImporter->agreed();
+    if (!manifest)
+    {
+        if (now > m_snapshotStartTime + c_snapshotAgreeTimeout)
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                              << LOG_DESC("No manifest agreed by the peers, download the blocks");
+            m_snapshotImporter.reset();
+            return false;
+        }
+
+        if (now >= m_lastManifestRequestTime + c_snapshotManifestInterval)
+        {
+            m_lastManifestRequestTime = now;
+            m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+                SyncReqSnapshotManifestPacket packet;
+                packet.encode();
+                m_service->asyncSendMessageByNodeID(_p->nodeId, packet.toMessage(m_protocolId),
+                    CallbackFuncWithSession(), Options());
+                return true;
+            });
+        }
+        return true;
+    }
+
+    if (m_snapshotImporter->finished())
+    {
+        if (!m_snapshotImporter->finish())
+        {
+            SYNC_LOG(FATAL) << LOG_BADGE("Snapshot") << LOG_DESC("Restore the snapshot failed");
+            exit(1);
+        }
+        SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Restore the snapshot")
+                       << LOG_KV("number", manifest->number)
+                       << LOG_KV("timeCost", now - m_snapshotStartTime);
+        m_snapshotImporter.reset();
+        noteNewBlocks();
+        return false;
+    }
+
+    auto manifestHash = m_snapshotImporter->agreedHash();
+    m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+        for (auto index : m_snapshotImporter->request(_p->nodeId, now))
+        {
+            SyncReqSnapshotChunkPacket packet;
+            packet.encode(manifestHash, index);
+            m_service->asyncSendMessageByNodeID(
+                _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        }
+        return true;
+    });
+    return true;
+}
+
+void SyncMaster::maintainBlocks()
+{
+    uint64_t now = utcTime();
+    if (!m_newBlocks && now <= m_maintainBlocksTimeout)
+        return;
+    m_newBlocks = false;
+
+    // the status is announced when the number changes, the unchanged status is repeated less
+    // and less often
     int64_t number = m_blockChain->number();
+    bool changed = (number != m_statusNumber);
+    if (!changed && now <= m_maintainBlocksTimeout)
+        return;
+    m_statusInterval =
+        changed ? c_maintainBlocksTimeout : min(m_statusInterval * 2, c_maxStatusInterval);
+    m_maintainBlocksTimeout = now + m_statusInterval;
+    m_statusNumber = number;
+    m_active = true;
+
     h256 const& currentHash = m_blockChain->numberHash(number);
 
     // Just broadcast status
@@ -370,11 +665,38 @@ void SyncMaster::maintainPeersStatus()
         }
     }
 
-    // Skip downloading if last if not timeout
-
+    // Reassign the ranges of the stalled peers at once, otherwise skip downloading until the
+    // requests in flight are answered or timeout
     uint64_t currentTime = utcTime();
-    if (((int64_t)currentTime - (int64_t)m_lastDownloadingRequestTime) <
-        (int64_t)c_eachBlockDownloadingRequestTimeout * (m_maxRequestNumber - currentNumber))
+    bool stalled = false;
+    bool busy = false;
+    m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+        if (_p->download.checkStall(currentTime))
+        {
+            stalled = true;
+            SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_DESC("Peer stalled")
+                              << LOG_KV("peer", _p->nodeId.abridged())
+                              << LOG_KV("rtt", _p->download.rtt())
+                              << LOG_KV("window", _p->download.requestWindow());
+        }
+        busy = busy || _p->download.busy();
+        return true;
+    });
+
+    // Long ranges are downloaded header first until the headers ahead are all imported, a peer
+    // is asked again once its own request is answered instead of waiting for all of them
+    int64_t requestBase = max(currentNumber, preparingNumber());
+    if (m_headerQueue &&
+        (maxPeerNumber - requestBase > c_minHeaderFirstBlocks || m_headerQueue->size() > 0))
+    {
+        noteDownloadingBegin();
+        maintainHeadersAndBodies(maxPeerNumber, currentTime);
+        return;
+    }
+
+    if (!stalled && busy &&
+        ((int64_t)currentTime - (int64_t)m_lastDownloadingRequestTime) <
+            (int64_t)c_eachBlockDownloadingRequestTimeout * (m_maxRequestNumber - currentNumber))
     {
         SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_DESC("Waiting for peers' blocks")
                         << LOG_KV("currentNumber", currentNumber)
@@ -387,15 +709,27 @@ void SyncMaster::maintainPeersStatus()
     // Start download
     noteDownloadingBegin();
 
+    // The queue holds more blocks when the blocks are small
+    DownloadingBlockQueue& bq = m_syncStatus->bq();
+    size_t maxQueueSize = c_maxDownloadingBlockQueueSize;
+    size_t blockSize = bq.averageBlockSize();
+    if (blockSize > 0)
+    {
+        maxQueueSize = max(c_maxDownloadingBlockQueueSize,
+            min(c_maxDownloadingBlocks, c_maxDownloadingQueueMemory / blockSize));
+    }
+    bq.setMaxSize(maxQueueSize);
+
     // Choose to use min number in blockqueue or max peer number
-    int64_t maxRequestNumber = maxPeerNumber;
-    BlockPtr topBlock = m_syncStatus->bq().top();
+    int64_t maxRequestNumber = min(maxPeerNumber, currentNumber + (int64_t)maxQueueSize);
+    BlockPtr topBlock = bq.top(true);
     if (nullptr != topBlock)
     {
         int64_t minNumberInQueue = topBlock->header().number();
-        maxRequestNumber = min(maxPeerNumber, minNumberInQueue - 1);
+        maxRequestNumber = min(maxRequestNumber, minNumberInQueue - 1);
     }
-    if (currentNumber >= maxRequestNumber)
+    // the blocks taken out of the queue to prepare are not requested again
+    if (requestBase >= maxRequestNumber)
     {
         SYNC_LOG(TRACE) << LOG_BADGE("Download")
                         << LOG_DESC("No need to sync when blocks are already in queue")
@@ -404,62 +738,172 @@ void SyncMaster::maintainPeersStatus()
         return;  // no need to send request block packet
     }
 
-    // Sharding by c_maxRequestBlocks to request blocks
-    size_t shardNumber =
-        (maxRequestNumber - currentNumber + c_maxRequestBlocks - 1) / c_maxRequestBlocks;
-    size_t shard = 0;
+    auto peers = downloadPeers(currentNumber, currentTime);
 
+    // Sharding by the window of each peer, one shard per peer in turn and at least
+    // c_maxRequestShards shards a round, the ranges in flight are skipped
+    size_t maxShards = max(c_maxRequestShards, peers.size());
+    size_t shard = 0;
+    int64_t from = requestBase + 1;
     m_maxRequestNumber = 0;  // each request turn has new m_maxRequestNumber
-    while (shard < shardNumber && shard < c_maxRequestShards)
+    while (shard < maxShards && from <= maxRequestNumber && !peers.empty())
     {
-        bool thisTurnFound = false;
-        m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
-            if (m_syncStatus->knownHighestNumber <= 0 ||
-                _p->number != m_syncStatus->knownHighestNumber)
+        int64_t rangeEnd = 0;
+        bool inFlight = false;
+        for (auto const& peer : peers)
+        {
+            if (peer->download.requesting(from, rangeEnd))
             {
-                // Only send request to nodes which are not syncing(has max number)
-                return true;
+                inFlight = true;
+                break;
             }
+        }
+        if (inFlight)
+        {
+            m_maxRequestNumber = max(m_maxRequestNumber, rangeEnd);
+            from = rangeEnd + 1;
+            continue;
+        }
 
+        bool thisTurnFound = false;
+        for (size_t i = 0; i < peers.size(); ++i)
+        {
+            auto peer = peers[(shard + i) % peers.size()];
             // shard: [from, to]
-            int64_t from = currentNumber + 1 + shard * c_maxRequestBlocks;
-            int64_t to = min(from + c_maxRequestBlocks - 1, maxRequestNumber);
-            if (_p->number < to)
-                return true;  // exit, to next peer
+            int64_t to = min(from + peer->download.requestWindow() - 1, maxRequestNumber);
+            if (peer->number < to)
+                continue;  // to next peer
 
             // found a peer
             thisTurnFound = true;
             SyncReqBlockPacket packet;
             unsigned size = to - from + 1;
             packet.encode(from, size);
+            peer->download.onRequest(from, to, currentTime);
             m_service->asyncSendMessageByNodeID(
-                _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+                peer->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+            requestStateDiffs(peer->nodeId, from, to, currentTime);
 
             // update max request number
             m_maxRequestNumber = max(m_maxRequestNumber, to);
 
             SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
                             << LOG_DESC("Request blocks") << LOG_KV("frm", from) << LOG_KV("to", to)
-                            << LOG_KV("peer", _p->nodeId.abridged());
-
-            ++shard;  // shard move
-
-            return shard < shardNumber && shard < c_maxRequestShards;
-        });
+                            << LOG_KV("peer", peer->nodeId.abridged())
+                            << LOG_KV("throughput", peer->download.throughput())
+                            << LOG_KV("rtt", peer->download.rtt());
+            from = to + 1;
+            break;
+        }
+        ++shard;  // shard move
 
         if (!thisTurnFound)
         {
-            int64_t from = currentNumber + shard * c_maxRequestBlocks;
-            int64_t to = min(from + c_maxRequestBlocks - 1, maxRequestNumber);
-
             SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Request")
                               << LOG_DESC("Couldn't find any peers to request blocks")
-                              << LOG_KV("from", from) << LOG_KV("to", to);
+                              << LOG_KV("from", from) << LOG_KV("maxRequest", maxRequestNumber);
             break;
         }
     }
 }
 
+std::vector<std::shared_ptr<SyncPeerStatus>> SyncMaster::downloadPeers(
+    int64_t _currentNumber, uint64_t _now)
+{
+    // The available peers ordered by throughput, the unmeasured ones are tried first
+    std::vector<std::shared_ptr<SyncPeerStatus>> peers;
+    m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
+        if (_p->number > _currentNumber && _p->download.available(_now))
+        {
+            peers.emplace_back(_p);
+        }
+        return true;
+    });
+    std::stable_sort(peers.begin(), peers.end(),
+        [](std::shared_ptr<SyncPeerStatus> const& _a, std::shared_ptr<SyncPeerStatus> const& _b) {
+            double a = _a->download.throughput();
+            double b = _b->download.throughput();
+            return (a <= 0 && b > 0) || (a > 0 && b > 0 && a > b);
+        });
+    return peers;
+}
+
+void SyncMaster::maintainHeadersAndBodies(int64_t _maxPeerNumber, uint64_t _now)
+{
+    int64_t currentNumber = m_blockChain->number();
+    m_headerQueue->prune(currentNumber);
+
+    // The queue is bounded by the bytes of the blocks, not by their count
+    DownloadingBlockQueue& bq = m_syncStatus->bq();
+    bq.setMaxSize(c_maxDownloadingBlocks);
+
+    // The received blocks missing below the queue were dropped, they are requested again
+    int64_t requestBase = max(currentNumber, preparingNumber());
+    BlockPtr topBlock = bq.top(true);
+    int64_t queuedNumber = topBlock ? topBlock->header().number() : m_headerQueue->tip() + 1;
+    if (queuedNumber > requestBase + 1)
+    {
+        m_headerQueue->resetBodies(requestBase + 1, queuedNumber - 1);
+    }
+
+    // The headers are small, a random peer holding all of them sends them
+    int64_t from = 0;
+    unsigned size = 0;
+    if (m_headerQueue->nextHeaders(_maxPeerNumber, _now, from, size))
+    {
+        int64_t to = from + size - 1;
+        m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
+            if (_p->number < to)
+            {
+                return true;
+            }
+            SyncReqHeadersPacket packet;
+            packet.encode(from, size);
+            m_service->asyncSendMessageByNodeID(
+                _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                            << LOG_DESC("Request headers") << LOG_KV("frm", from)
+                            << LOG_KV("to", to) << LOG_KV("peer", _p->nodeId.abridged());
+            return false;
+        });
+    }
+
+    // The bodies of the verified headers are fetched from each available peer by its window,
+    // the bodies in flight and the queued blocks are kept within the bytes of the queue
+    size_t blockSize = bq.averageBlockSize();
+    m_maxRequestNumber = 0;
+    for (auto const& peer : downloadPeers(currentNumber, _now))
+    {
+        if (bq.byteSize() + m_headerQueue->requesting() * blockSize >= bq.maxBytes())
+        {
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_DESC("Downloading queue is full")
+                            << LOG_KV("queueBytes", bq.byteSize())
+                            << LOG_KV("requesting", m_headerQueue->requesting());
+            break;
+        }
+        int64_t to = 0;
+        if (!m_headerQueue->nextBodies(
+                peer->number, peer->download.requestWindow(), _now, from, to))
+        {
+            continue;
+        }
+
+        SyncReqBodiesPacket packet;
+        packet.encode(from, to - from + 1);
+        peer->download.onRequest(from, to, _now);
+        m_service->asyncSendMessageByNodeID(
+            peer->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        requestStateDiffs(peer->nodeId, from, to, _now);
+        m_maxRequestNumber = max(m_maxRequestNumber, to);
+
+        SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                        << LOG_DESC("Request bodies") << LOG_KV("frm", from) << LOG_KV("to", to)
+                        << LOG_KV("peer", peer->nodeId.abridged())
+                        << LOG_KV("throughput", peer->download.throughput())
+                        << LOG_KV("rtt", peer->download.rtt());
+    }
+}
+
 bool SyncMaster::maintainDownloadingQueue()
 {
     int64_t currentNumber = m_blockChain->number();
@@ -467,16 +911,45 @@ bool SyncMaster::maintainDownloadingQueue()
     if (currentNumber >= m_syncStatus->knownHighestNumber)
     {
         bq.clear();
+        m_preparingBlocks.clear();
+        if (m_headerQueue)
+        {
+            m_headerQueue->clear();
+        }
+        if (m_stateDiffQueue)
+        {
+            m_stateDiffQueue->clear();
+        }
         return true;
     }
 
-    // pop block in sequence and ignore block which number is lower than currentNumber +1
-    BlockPtr topBlock = bq.top();
-    while (topBlock != nullptr && topBlock->header().number() <= (m_blockChain->number() + 1))
+    // import the prepared blocks in sequence, the blocks ahead are prepared meanwhile
+    prepareDownloadedBlocks();
+    while (!m_preparingBlocks.empty())
     {
+        PreparingBlock preparing = m_preparingBlocks.front();
+        BlockPtr topBlock = preparing.block;
+        if (topBlock->header().number() > m_blockChain->number() + 1)
+        {
+            break;
+        }
+        // the block waits for its diff and the blocks after it in turn
+        std::shared_ptr<bytes const> stateDiff;
+        if (m_stateDiffQueue &&
+            m_stateDiffQueue->take(topBlock->header().number(), utcTime(), stateDiff) ==
+                StateDiffQueue::Status::Waiting)
+        {
+            break;
+        }
+        m_preparingBlocks.pop_front();
+        bool imported = false;
         try
         {
-            if (isNewBlock(topBlock))
+            // prepared with the sealers of this block, otherwise check it again in sequence
+            waitPrepared(preparing);
+            bool prepared = preparing.batch->prepared[preparing.index] &&
+                            preparing.batch->sealers == m_blockChain->sealerList();
+            if (isNewBlock(topBlock, !prepared))
             {
                 auto record_time = utcTime();
                 auto parentBlock =
@@ -486,8 +959,21 @@ bool SyncMaster::maintainDownloadingQueue()
                 auto getBlockByNumber_time_cost = utcTime() - record_time;
                 record_time = utcTime();
 
+                if (!prepared)
+                {
+                    m_txPool->verifyAndSetSenderForBlock(*topBlock);
+                }
+                auto recoverSenders_time_cost = utcTime() - record_time;
+                record_time = utcTime();
+
+                // the diff checked against the dbHash signed by the sealers is committed as is
                 ExecutiveContext::Ptr exeCtx =
-                    m_blockVerifier->executeBlock(*topBlock, parentBlockInfo);
+                    stateDiff ? applyStateDiff(*topBlock, parentBlockInfo, *stateDiff) : nullptr;
+                bool diffApplied = exeCtx != nullptr;
+                if (!exeCtx)
+                {
+                    exeCtx = m_blockVerifier->executeBlock(*topBlock, parentBlockInfo);
+                }
                 auto executeBlock_time_cost = utcTime() - record_time;
                 record_time = utcTime();
 
@@ -496,17 +982,27 @@ bool SyncMaster::maintainDownloadingQueue()
                 record_time = utcTime();
                 if (ret == CommitResult::OK)
                 {
-                    m_txPool->dropBlockTrans(*topBlock);
-                    auto dropBlockTrans_time_cost = utcTime() - record_time;
-                    SYNC_LOG(INFO) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                   << LOG_DESC("Download block commit")
-                                   << LOG_KV("number", topBlock->header().number())
-                                   << LOG_KV("txs", topBlock->transactions().size())
-                                   << LOG_KV("hash", topBlock->headerHash().abridged())
-                                   << LOG_KV("getBlockByNumberTimeCost", getBlockByNumber_time_cost)
-                                   << LOG_KV("executeBlockTimeCost", executeBlock_time_cost)
-                                   << LOG_KV("commitBlockTimeCost", commitBlock_time_cost)
-                                   << LOG_KV("dropBlockTransTimeCost", dropBlockTrans_time_cost);
+                    imported = true;
+                    auto txPool = m_txPool;
+                    m_finalizePool->enqueue([txPool, topBlock, getBlockByNumber_time_cost,
+                                                recoverSenders_time_cost, executeBlock_time_cost,
+                                                commitBlock_time_cost, diffApplied]() {
+                        auto record_time = utcTime();
+                        txPool->dropBlockTrans(*topBlock);
+                        auto dropBlockTrans_time_cost = utcTime() - record_time;
+                        SYNC_LOG(INFO)
+                            << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                            << LOG_DESC("Download block commit")
+                            << LOG_KV("number", topBlock->header().number())
+                            << LOG_KV("txs", topBlock->transactions().size())
+                            << LOG_KV("hash", topBlock->headerHash().abridged())
+                            << LOG_KV("getBlockByNumberTimeCost", getBlockByNumber_time_cost)
+                            << LOG_KV("recoverSendersTimeCost", recoverSenders_time_cost)
+                            << LOG_KV("stateDiff", diffApplied)
+                            << LOG_KV("executeBlockTimeCost", executeBlock_time_cost)
+                            << LOG_KV("commitBlockTimeCost", commitBlock_time_cost)
+                            << LOG_KV("dropBlockTransTimeCost", dropBlockTrans_time_cost);
+                    });
                 }
                 else
                 {
@@ -535,12 +1031,21 @@ bool SyncMaster::maintainDownloadingQueue()
                             << LOG_KV("hash", topBlock->headerHash().abridged());
         }
 
-        bq.pop();
-        topBlock = bq.top();
+        // the blocks after a block not imported are downloaded again
+        if (!imported && topBlock->header().number() == m_blockChain->number() + 1)
+        {
+            m_preparingBlocks.clear();
+        }
+        prepareDownloadedBlocks();
     }
 
 
     currentNumber = m_blockChain->number();
+    if (m_stateDiffQueue)
+    {
+        // the diffs of the blocks imported from elsewhere, by the consensus
+        m_stateDiffQueue->prune(currentNumber);
+    }
     // has this request turn finished ?
     if (currentNumber >= m_maxRequestNumber)
         m_lastDownloadingRequestTime = 0;  // reset it to trigger request immediately
@@ -673,6 +1178,7 @@ void SyncMaster::maintainBlockRequest()
         DownloadRequestQueue& reqQueue = _p->reqQueue;
         if (reqQueue.empty())
             return true;  // no need to respeond
+        m_active = true;
 
         // Just select one peer per maintain
         reqQueue.disablePush();  // drop push at this time
@@ -688,7 +1194,9 @@ void SyncMaster::maintainBlockRequest()
             for (; number < numberLimit && utcTime() <= timeout; number++)
             {
                 auto start_get_block_time = utcTime();
-                shared_ptr<bytes> blockRLP = m_blockChain->getBlockRLPByNumber(number);
+                // the peers syncing the same range are served from the same reads
+                shared_ptr<bytes> blockRLP = BlockRLPCache::instance().get(m_groupId, number,
+                    [&]() { return m_blockChain->getBlockRLPByNumber(number); });
                 if (!blockRLP)
                 {
                     SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
@@ -729,7 +1237,102 @@ void SyncMaster::maintainBlockRequest()
     });
 }
 
-bool SyncMaster::isNewBlock(BlockPtr _block)
+/**
+ * @brief: take the next blocks in sequence out of the downloading queue and prepare them as a
+ *         batch on the prepare thread, once half of the prepared blocks are imported
+ */
+void SyncMaster::prepareDownloadedBlocks()
+{
+    if (m_preparingBlocks.size() > c_maxPreparingBlocks / 2)
+    {
+        return;
+    }
+    DownloadingBlockQueue& bq = m_syncStatus->bq();
+    int64_t nextNumber = max(m_blockChain->number(), preparingNumber()) + 1;
+    auto batch = make_shared<PreparingBatch>();
+    for (BlockPtr top = bq.top(); top != nullptr && m_preparingBlocks.size() < c_maxPreparingBlocks;
+         top = bq.top())
+    {
+        int64_t number = top->header().number();
+        if (number > nextNumber)
+        {
+            break;
+        }
+        bq.pop();
+        // the block has been imported or taken already
+        if (number < nextNumber)
+        {
+            continue;
+        }
+        m_preparingBlocks.push_back(PreparingBlock{top, batch, batch->blocks.size()});
+        batch->blocks.push_back(top);
+        nextNumber++;
+    }
+    if (batch->blocks.empty())
+    {
+        return;
+    }
+    batch->prepared.resize(batch->blocks.size(), 0);
+    // the batch may be prepared by the sync thread first
+    m_preparePool->enqueue([this, batch]() {
+        if (!batch->claimed.exchange(true))
+        {
+            prepareBatch(batch);
+        }
+    });
+}
+
+/// recover the senders and check the sigList of the blocks of the batch in parallel
+void SyncMaster::prepareBatch(std::shared_ptr<PreparingBatch> _batch)
+{
+    auto record_time = utcTime();
+    try
+    {
+        _batch->sealers = m_blockChain->sealerList();
+    }
+    catch (std::exception const&)
+    {
+        // the sealers differ when imported, the blocks are checked again
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _batch->blocks.size()),
+        [&](tbb::blocked_range<size_t> const& _range) {
+            for (size_t i = _range.begin(); i < _range.end(); ++i)
+            {
+                try
+                {
+                    Block& block = *_batch->blocks[i];
+                    m_txPool->verifyAndSetSenderForBlock(block);
+                    _batch->prepared[i] = !fp_isConsensusOk || fp_isConsensusOk(block);
+                }
+                catch (std::exception const&)
+                {
+                    // checked again and reported when imported
+                    _batch->prepared[i] = 0;
+                }
+            }
+        });
+    _batch->done.set_value();
+    SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                    << LOG_DESC("Prepare downloaded blocks")
+                    << LOG_KV("from", _batch->blocks.front()->header().number())
+                    << LOG_KV("size", _batch->blocks.size())
+                    << LOG_KV("timeCost", utcTime() - record_time);
+}
+
+void SyncMaster::waitPrepared(PreparingBlock const& _preparing)
+{
+    auto batch = _preparing.batch;
+    if (!batch->claimed.exchange(true))
+    {
+        prepareBatch(batch);
+        return;
+    }
+    // the batch is being prepared by the prepare thread
+    Executor::Blocking blocking;
+    batch->ready.wait();
+}
+
+bool SyncMaster::isNewBlock(BlockPtr _block, bool _checkConsensus)
 {
     if (_block == nullptr)
         return false;
@@ -758,7 +1361,7 @@ bool SyncMaster::isNewBlock(BlockPtr _block)
     }
 
     // check block sealerlist sig
-    if (fp_isConsensusOk && !(fp_isConsensusOk)(*_block))
+    if (_checkConsensus && fp_isConsensusOk && !(fp_isConsensusOk)(*_block))
     {
         SYNC_LOG(ERROR) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                         << LOG_DESC("Ignore illegal block")
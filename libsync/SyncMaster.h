@@ -21,15 +21,20 @@
  */
 
 #pragma once
+#include "BlockRLPCache.h"
 #include "Common.h"
+#include "DownloadingHeaderQueue.h"
 #include "DownloadingTxsQueue.h"
 #include "RspBlockReq.h"
+#include "StateDiffQueue.h"
+#include "StateSnapshot.h"
 #include "SyncInterface.h"
 #include "SyncMsgEngine.h"
 #include "SyncStatus.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <libblockverifier/BlockVerifierInterface.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/Common.h>
 #include <libethcore/Exceptions.h>
@@ -37,6 +42,9 @@
 #include <libnetwork/Session.h>
 #include <libp2p/P2PInterface.h>
 #include <libtxpool/TxPoolInterface.h>
+#include <atomic>
+#include <deque>
+#include <future>
 #include <vector>
 
 
@@ -69,14 +77,24 @@ public:
             std::make_shared<SyncMasterStatus>(_blockChain, _protocolId, _genesisHash, _nodeId);
         m_msgEngine = std::make_shared<SyncMsgEngine>(_service, _txPool, _blockChain, m_syncStatus,
             m_txQueue, _protocolId, _nodeId, _genesisHash);
+        m_msgEngine->setActivityHandler([this]() { this->noteActivity(); });
+        m_idleWait = _idleWaitMs;
 
         // signal registration
         m_tqReady = m_txPool->onReady([&]() { this->noteNewTransactions(); });
-        m_blockSubmitted = m_blockChain->onReady([&](int64_t) { this->noteNewBlocks(); });
+        m_blockSubmitted = m_blockChain->onReady([&](int64_t _number) {
+            this->noteNewBlocks();
+            this->noteSnapshotBlock(_number);
+        });
 
         /// set thread name
         std::string threadName = "Sync-" + std::to_string(m_groupId);
         setName(threadName);
+
+        m_finalizePool =
+            std::make_shared<dev::ThreadPool>("SyncFin-" + std::to_string(m_groupId), 1);
+        m_preparePool =
+            std::make_shared<dev::ThreadPool>("SyncPre-" + std::to_string(m_groupId), 1);
     }
 
     virtual ~SyncMaster() { stop(); };
@@ -113,13 +131,21 @@ public:
     void noteNewTransactions()
     {
         m_newTransactions = true;
-        // m_signalled.notify_all();
+        // the transactions are batched by the idle wait, a backed off thread is woken
+        noteActivity();
     }
 
     void noteNewBlocks()
     {
         m_newBlocks = true;
-        m_signalled.notify_all();  // awake doWork
+        wakeUp();  // awake doWork
+    }
+
+    /// wake the thread if it backed off while idle
+    void noteActivity()
+    {
+        if (m_idleWait > idleWaitMs())
+            wakeUp();
     }
 
     void noteDownloadingBegin()
@@ -144,6 +170,24 @@ public:
 
     std::shared_ptr<SyncMsgEngine> msgEngine() { return m_msgEngine; }
 
+    /// dump the state every _interval blocks and serve it to the peers, called before start
+    void setSnapshotStore(SnapshotStore::Ptr _store, int64_t _interval);
+    /// restore the state snapshot agreed by the peers before the blocks are downloaded, called
+    /// before start
+    void setSnapshotImporter(SnapshotImporter::Ptr _importer);
+    /// download the headers of long ranges ahead of the bodies, called before start
+    void enableHeaderFirst();
+    /// request the state diffs of the blocks along with them and commit the diffs instead of
+    /// executing the blocks, called before start
+    void enableStateDiff();
+    /// _handler is called with true once the node is more than _blocks behind the peers and
+    /// with false once it catches up, called before start
+    void setBulkLoadHandler(std::function<void(bool)> _handler, int64_t _blocks)
+    {
+        m_bulkLoadHandler = _handler;
+        m_bulkLoadBlocks = _blocks;
+    }
+
 private:
     /// p2p service handler
     std::shared_ptr<dev::p2p::P2PInterface> m_service;
@@ -171,18 +215,20 @@ private:
     int64_t m_currentSealingNumber = 0;
 
     // Internal coding variable
-    /// mutex to access m_signalled
-    Mutex x_signalled;
     /// mutex to protect m_currentSealingNumber
     mutable SharedMutex x_currentSealingNumber;
 
-    /// signal to notify all thread to work
-    std::condition_variable m_signalled;
+    /// the wait of the next round, doubled while the rounds do nothing
+    std::atomic<unsigned> m_idleWait = {0};
+    /// whether the round sent or handled anything
+    bool m_active = false;
 
     // sync state
     bool m_newTransactions = false;
     bool m_newBlocks = false;
     uint64_t m_maintainBlocksTimeout = 0;
+    uint64_t m_statusInterval = c_maintainBlocksTimeout;
+    int64_t m_statusNumber = -1;
     bool m_needMaintainTransactions = false;
 
 
@@ -190,9 +236,61 @@ private:
     dev::eth::Handler<> m_tqReady;
     dev::eth::Handler<int64_t> m_blockSubmitted;
 
+    // Downloaded blocks go through stages: execute, commit into the cache, which makes the state
+    // visible to the next block while the backend persists it, and finalize. Finalizing drops
+    // the transactions from the txpool in block order on this single thread, the next block is
+    // executed meanwhile.
+    dev::ThreadPool::Ptr m_finalizePool;
+
+    // Before the execution, the senders and the sigList of the blocks ahead are checked in
+    // parallel by batch on m_preparePool. A batch not started yet when its first block is
+    // imported is prepared by the sync thread itself.
+    struct PreparingBatch
+    {
+        BlockPtrVec blocks;
+        /// whether the senders are recovered and the consensus check passed
+        std::vector<char> prepared;
+        /// the sealers when the sigList is checked
+        dev::h512s sealers;
+        std::atomic_bool claimed = {false};
+        std::promise<void> done;
+        std::shared_future<void> ready = done.get_future().share();
+    };
+    struct PreparingBlock
+    {
+        BlockPtr block;
+        std::shared_ptr<PreparingBatch> batch;
+        size_t index;
+    };
+    dev::ThreadPool::Ptr m_preparePool;
+    std::deque<PreparingBlock> m_preparingBlocks;
+
+    // The dumps are built on m_snapshotPool right after the blocks at multiples of the interval
+    // are committed, so the peers dump the same blocks and build the same manifests.
+    SnapshotStore::Ptr m_snapshotStore;
+    int64_t m_snapshotInterval = 0;
+    std::atomic_bool m_buildingSnapshot = {false};
+    dev::ThreadPool::Ptr m_snapshotPool;
+    // no block is downloaded until the snapshot is restored or no manifest is agreed in time
+    SnapshotImporter::Ptr m_snapshotImporter;
+    uint64_t m_snapshotStartTime = 0;
+    uint64_t m_lastManifestRequestTime = 0;
+
+    // Header-first downloading: the headers are checked ahead and the bodies fetched from all
+    // the peers, null if it's disabled
+    std::shared_ptr<DownloadingHeaderQueue> m_headerQueue;
+
+    // the state diffs requested with the blocks, null if the blocks are all executed
+    StateDiffQueue::Ptr m_stateDiffQueue;
+
     // verify handler to check downloading block
     std::function<bool(dev::eth::Block const&)> fp_isConsensusOk = nullptr;
 
+    // the storage loads the blocks in bulk while the node is far behind
+    std::function<void(bool)> m_bulkLoadHandler = nullptr;
+    int64_t m_bulkLoadBlocks = 0;
+    bool m_bulkLoading = false;
+
 public:
     void maintainTransactions();
     void maintainDownloadingTransactions();
@@ -202,9 +300,33 @@ public:
     void maintainDownloadingQueueBuffer();
     void maintainPeersConnection();
     void maintainBlockRequest();
+    /// return true while the snapshot is being restored
+    bool maintainSnapshot();
+    /// request the headers ahead and the bodies of the verified headers
+    void maintainHeadersAndBodies(int64_t _maxPeerNumber, uint64_t _now);
+    /// switch the bulk load of the storage by the distance to the peers
+    void maintainBulkLoad();
 
 private:
-    bool isNewBlock(BlockPtr _block);
+    bool isNewBlock(BlockPtr _block, bool _checkConsensus = true);
+    void wakeUp();
+    /// the peers to download from ordered by throughput, the unmeasured ones first
+    std::vector<std::shared_ptr<SyncPeerStatus>> downloadPeers(
+        int64_t _currentNumber, uint64_t _now);
+    /// request the state diffs of the blocks _from to _to requested from the peer
+    void requestStateDiffs(NodeID const& _peer, int64_t _from, int64_t _to, uint64_t _now);
+    /// the context committing the diff of the block, null if the diff is invalid
+    std::shared_ptr<dev::blockverifier::ExecutiveContext> applyStateDiff(dev::eth::Block& _block,
+        dev::blockverifier::BlockInfo const& _parent, bytes const& _diff);
+    void prepareDownloadedBlocks();
+    void prepareBatch(std::shared_ptr<PreparingBatch> _batch);
+    void waitPrepared(PreparingBlock const& _preparing);
+    int64_t preparingNumber() const
+    {
+        return m_preparingBlocks.empty() ? 0 :
+                                           m_preparingBlocks.back().block->header().number();
+    }
+    void noteSnapshotBlock(int64_t _number);
     void printSyncInfo();
 };
 
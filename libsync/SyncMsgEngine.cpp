@@ -66,10 +66,15 @@ void SyncMsgEngine::messageHandler(
 
     bool ok = interpret(packet);
     if (!ok)
+    {
         SYNC_ENGINE_LOG(WARNING) << LOG_BADGE("Rcv") << LOG_BADGE("Packet")
                                  << LOG_DESC("Reject packet")
                                  << LOG_KV("reason", "illegal packet type")
                                  << LOG_KV("packetType", int(packet.packetType));
+        return;
+    }
+    if (m_onActivity)
+        m_onActivity();
 }
 
 bool SyncMsgEngine::checkSession(std::shared_ptr<dev::p2p::P2PSession> _session)
@@ -115,6 +120,42 @@ bool SyncMsgEngine::interpret(SyncMsgPacket const& _packet)
         case ReqBlocskPacket:
             onPeerRequestBlocks(_packet);
             break;
+        case ReqSnapshotManifestPacket:
+            onPeerRequestSnapshotManifest(_packet);
+            break;
+        case SnapshotManifestPacket:
+            onPeerSnapshotManifest(_packet);
+            break;
+        case ReqSnapshotChunkPacket:
+            onPeerRequestSnapshotChunk(_packet);
+            break;
+        case SnapshotChunkPacket:
+            onPeerSnapshotChunk(_packet);
+            break;
+        case ReqHeadersPacket:
+            onPeerRequestHeaders(_packet);
+            break;
+        case HeadersPacket:
+            onPeerHeaders(_packet);
+            break;
+        case ReqBodiesPacket:
+            onPeerRequestBodies(_packet);
+            break;
+        case BodiesPacket:
+            onPeerBodies(_packet);
+            break;
+        case TxsAnnouncePacket:
+            onPeerTxsAnnounce(_packet);
+            break;
+        case ReqTxsPacket:
+            onPeerRequestTxs(_packet);
+            break;
+        case ReqStateDiffsPacket:
+            onPeerRequestStateDiffs(_packet);
+            break;
+        case StateDiffsPacket:
+            onPeerStateDiffs(_packet);
+            break;
         default:
             return false;
         }
@@ -191,6 +232,62 @@ void SyncMsgEngine::onPeerTransactions(SyncMsgPacket const& _packet)
                            << LOG_KV("packetSize(B)", rlps.data().size());
 }
 
+void SyncMsgEngine::onPeerTxsAnnounce(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (m_syncStatus->state == SyncState::Downloading || rlp.itemCount() != 1)
+    {
+        return;
+    }
+
+    // the peer has the announced transactions, they aren't sent back to it
+    auto txHashes = rlp[0].toVector<h256>();
+    h256s known;
+    h256s missed;
+    for (auto const& hash : txHashes)
+    {
+        if (m_txPool->txExists(hash))
+            known.push_back(hash);
+        else
+            missed.push_back(hash);
+    }
+    if (!known.empty())
+    {
+        m_txPool->setTransactionsAreKnownBy(known, _packet.nodeId);
+    }
+    // the transactions requested from another peer are waited for
+    missed = m_txQueue->markRequested(missed, utcTime());
+    if (missed.empty())
+    {
+        return;
+    }
+
+    SyncReqTxsPacket packet;
+    packet.encode(missed);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Request announced txs")
+                           << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("announced", txHashes.size())
+                           << LOG_KV("requested", missed.size());
+}
+
+void SyncMsgEngine::onPeerRequestTxs(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (!peerStatus || rlp.itemCount() != 1)
+    {
+        return;
+    }
+    // served by maintainTransactions within the bytes bound of the peer
+    auto txHashes = rlp[0].toVector<h256>();
+    size_t queued = peerStatus->txsRequests.push(txHashes);
+    SYNC_ENGINE_LOG(TRACE) << LOG_BADGE("Tx") << LOG_DESC("Receive txs request")
+                           << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("requested", txHashes.size()) << LOG_KV("queued", queued);
+}
+
 void SyncMsgEngine::onPeerBlocks(SyncMsgPacket const& _packet)
 {
     RLP const& rlps = _packet.rlp();
@@ -199,7 +296,13 @@ void SyncMsgEngine::onPeerBlocks(SyncMsgPacket const& _packet)
                            << LOG_DESC("Receive peer block packet")
                            << LOG_KV("packetSize(B)", rlps.data().size());
 
-    m_syncStatus->bq().push(rlps);
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (peerStatus)
+    {
+        peerStatus->download.onBlocks(rlps.itemCount(), utcTime());
+    }
+    // the blocks are decoded from the received message, not from a copy of it
+    m_syncStatus->bq().push(rlps, _packet.buffer());
 }
 
 void SyncMsgEngine::onPeerRequestBlocks(SyncMsgPacket const& _packet)
@@ -228,6 +331,279 @@ void SyncMsgEngine::onPeerRequestBlocks(SyncMsgPacket const& _packet)
         peerStatus->reqQueue.push(from, (int64_t)size);
 }
 
+void SyncMsgEngine::onPeerRequestSnapshotManifest(SyncMsgPacket const& _packet)
+{
+    if (!m_snapshotStore || !m_snapshotStore->manifest())
+    {
+        return;
+    }
+
+    SyncSnapshotManifestPacket packet;
+    packet.encode(m_snapshotStore->manifestRLP());
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+}
+
+void SyncMsgEngine::onPeerSnapshotManifest(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (!m_snapshotImporter || rlp.itemCount() != 1)
+    {
+        return;
+    }
+
+    auto manifest = std::make_shared<SnapshotManifest>();
+    manifest->decode(rlp[0]);
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Receive manifest")
+                           << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("number", manifest->number)
+                           << LOG_KV("chunks", manifest->chunks.size());
+    m_snapshotImporter->onManifest(_packet.nodeId, manifest);
+}
+
+void SyncMsgEngine::onPeerRequestSnapshotChunk(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (!m_snapshotStore || rlp.itemCount() != 2)
+    {
+        return;
+    }
+
+    auto manifestHash = rlp[0].toHash<h256>(RLP::VeryStrict);
+    size_t index = rlp[1].toInt<size_t>();
+    auto chunk = m_snapshotStore->chunk(manifestHash, index);
+    if (!chunk)
+    {
+        SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Request unknown chunk")
+                               << LOG_KV("peer", _packet.nodeId.abridged())
+                               << LOG_KV("manifest", manifestHash.abridged())
+                               << LOG_KV("index", index);
+        return;
+    }
+
+    SyncSnapshotChunkPacket packet;
+    packet.encode(manifestHash, index, *chunk);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+}
+
+void SyncMsgEngine::onPeerSnapshotChunk(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (!m_snapshotImporter || rlp.itemCount() != 3)
+    {
+        return;
+    }
+
+    auto manifestHash = rlp[0].toHash<h256>(RLP::VeryStrict);
+    size_t index = rlp[1].toInt<size_t>();
+    auto chunk = std::make_shared<bytes>(rlp[2].toBytes());
+    m_snapshotImporter->onChunk(_packet.nodeId, manifestHash, index, chunk);
+}
+
+void SyncMsgEngine::onPeerRequestHeaders(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    // the headers and bodies are cut from the block RLP of RC2 on
+    if (rlp.itemCount() != 2 || g_BCOSConfig.version() < RC2_VERSION)
+    {
+        return;
+    }
+
+    int64_t from = rlp[0].toInt<int64_t>();
+    unsigned size = min(rlp[1].toInt<unsigned>(), c_maxRequestHeaders);
+    int64_t to = min(from + (int64_t)size - 1, m_blockChain->number());
+
+    std::vector<bytes> headerRLPs;
+    size_t payload = 0;
+    for (int64_t number = from; number <= to && payload < c_maxPayload; ++number)
+    {
+        auto blockRLP = BlockRLPCache::instance().get(
+            m_groupId, number, [&]() { return m_blockChain->getBlockRLPByNumber(number); });
+        if (!blockRLP)
+        {
+            break;
+        }
+        RLP block(ref(*blockRLP));
+        RLPStream header;
+        header.appendList(2).appendRaw(block[0].data()).appendRaw(block[3].data());
+        headerRLPs.emplace_back();
+        header.swapOut(headerRLPs.back());
+        payload += headerRLPs.back().size();
+    }
+
+    SyncHeadersPacket packet;
+    packet.encode(headerRLPs);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Header")
+                           << LOG_DESC("Send headers") << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("from", from) << LOG_KV("headers", headerRLPs.size());
+}
+
+void SyncMsgEngine::onPeerHeaders(SyncMsgPacket const& _packet)
+{
+    if (!m_headerQueue)
+    {
+        return;
+    }
+
+    RLP const& rlps = _packet.rlp();
+    size_t appended = m_headerQueue->onHeaders(_packet.nodeId, rlps);
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Header")
+                           << LOG_DESC("Receive headers")
+                           << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("headers", rlps.itemCount()) << LOG_KV("verified", appended)
+                           << LOG_KV("tip", m_headerQueue->tip());
+}
+
+void SyncMsgEngine::onPeerRequestBodies(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 2 || g_BCOSConfig.version() < RC2_VERSION)
+    {
+        return;
+    }
+
+    int64_t from = rlp[0].toInt<int64_t>();
+    unsigned size = min(rlp[1].toInt<unsigned>(), (unsigned)c_maxRequestBlocksPerPeer);
+    int64_t to = min(from + (int64_t)size - 1, m_blockChain->number());
+
+    // at least one body is sent even if it's larger than the payload
+    std::vector<bytes> bodyRLPs;
+    size_t payload = 0;
+    for (int64_t number = from; number <= to && payload < c_maxPayload; ++number)
+    {
+        auto blockRLP = BlockRLPCache::instance().get(
+            m_groupId, number, [&]() { return m_blockChain->getBlockRLPByNumber(number); });
+        if (!blockRLP)
+        {
+            break;
+        }
+        RLP block(ref(*blockRLP));
+        if (!bodyRLPs.empty() && payload + block[1].data().size() > c_maxPayload)
+        {
+            break;
+        }
+        RLPStream body;
+        body.appendList(2) << number;
+        body.appendRaw(block[1].data());
+        bodyRLPs.emplace_back();
+        body.swapOut(bodyRLPs.back());
+        payload += bodyRLPs.back().size();
+    }
+
+    SyncBodiesPacket packet;
+    packet.encode(bodyRLPs);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Body")
+                           << LOG_DESC("Send bodies") << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("from", from) << LOG_KV("bodies", bodyRLPs.size())
+                           << LOG_KV("bytes", payload);
+}
+
+void SyncMsgEngine::onPeerBodies(SyncMsgPacket const& _packet)
+{
+    if (!m_headerQueue)
+    {
+        return;
+    }
+
+    RLP const& rlps = _packet.rlp();
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (peerStatus)
+    {
+        peerStatus->download.onBlocks(rlps.itemCount(), utcTime());
+    }
+
+    std::vector<bytes> blockRLPs;
+    size_t mismatched = m_headerQueue->onBodies(rlps, blockRLPs);
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Body")
+                           << LOG_DESC("Receive bodies")
+                           << LOG_KV("peer", _packet.nodeId.abridged())
+                           << LOG_KV("bodies", rlps.itemCount())
+                           << LOG_KV("mismatched", mismatched)
+                           << LOG_KV("packetSize(B)", rlps.data().size());
+    if (!blockRLPs.empty())
+    {
+        m_syncStatus->bq().push(blockRLPs);
+    }
+}
+
+void SyncMsgEngine::onPeerRequestStateDiffs(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 2)
+    {
+        return;
+    }
+
+    int64_t from = rlp[0].toInt<int64_t>();
+    unsigned size = min(rlp[1].toInt<unsigned>(), (unsigned)c_maxRequestBlocksPerPeer);
+    int64_t to = min(from + (int64_t)size - 1, m_blockChain->number());
+
+    // the blocks answered are the ones up to the payload, a diff not kept is skipped
+    std::vector<bytes> diffRLPs;
+    size_t payload = 0;
+    int64_t answered = from - 1;
+    for (int64_t number = from; number <= to; ++number)
+    {
+        auto diff = m_blockChain->getStateDiff(number);
+        if (diff && payload + diff->size() > c_maxPayload)
+        {
+            if (!diffRLPs.empty())
+            {
+                break;
+            }
+            diff = nullptr;
+        }
+        if (diff)
+        {
+            RLPStream item;
+            item.appendList(2) << number;
+            item.append(*diff);
+            diffRLPs.emplace_back();
+            item.swapOut(diffRLPs.back());
+            payload += diffRLPs.back().size();
+        }
+        answered = number;
+    }
+
+    SyncStateDiffsPacket packet;
+    packet.encode(from, answered, diffRLPs);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("StateDiff")
+                           << LOG_DESC("Send state diffs")
+                           << LOG_KV("peer", _packet.nodeId.abridged()) << LOG_KV("from", from)
+                           << LOG_KV("to", answered) << LOG_KV("diffs", diffRLPs.size())
+                           << LOG_KV("bytes", payload);
+}
+
+void SyncMsgEngine::onPeerStateDiffs(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (!m_stateDiffQueue || rlp.itemCount() != 3)
+    {
+        return;
+    }
+
+    int64_t from = rlp[0].toInt<int64_t>();
+    int64_t to = rlp[1].toInt<int64_t>();
+    std::map<int64_t, std::shared_ptr<bytes const>> diffs;
+    for (auto const& item : rlp[2])
+    {
+        diffs[item[0].toInt<int64_t>()] = std::make_shared<bytes const>(item[1].toBytes());
+    }
+    m_stateDiffQueue->onDiffs(from, to, diffs);
+    SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("StateDiff")
+                           << LOG_DESC("Receive state diffs")
+                           << LOG_KV("peer", _packet.nodeId.abridged()) << LOG_KV("from", from)
+                           << LOG_KV("to", to) << LOG_KV("diffs", diffs.size())
+                           << LOG_KV("packetSize(B)", rlp.data().size());
+}
+
 void DownloadBlocksContainer::batchAndSend(BlockPtr _block)
 {
     // TODO: thread safe
@@ -21,9 +21,13 @@
  */
 
 #pragma once
+#include "BlockRLPCache.h"
 #include "Common.h"
+#include "DownloadingHeaderQueue.h"
 #include "DownloadingTxsQueue.h"
 #include "RspBlockReq.h"
+#include "StateDiffQueue.h"
+#include "StateSnapshot.h"
 #include "SyncMsgPacket.h"
 #include "SyncStatus.h"
 #include <libblockchain/BlockChainInterface.h>
@@ -66,6 +70,20 @@ public:
     void messageHandler(dev::p2p::NetworkException _e,
         std::shared_ptr<dev::p2p::P2PSession> _session, dev::p2p::P2PMessage::Ptr _msg);
 
+    /// set before the messages are handled
+    void setSnapshotStore(SnapshotStore::Ptr _store) { m_snapshotStore = _store; }
+    void setSnapshotImporter(SnapshotImporter::Ptr _importer) { m_snapshotImporter = _importer; }
+    void setHeaderQueue(std::shared_ptr<DownloadingHeaderQueue> _headerQueue)
+    {
+        m_headerQueue = _headerQueue;
+    }
+    void setStateDiffQueue(StateDiffQueue::Ptr _stateDiffQueue)
+    {
+        m_stateDiffQueue = _stateDiffQueue;
+    }
+    /// called after each packet is handled, to wake the sync thread backed off while idle
+    void setActivityHandler(std::function<void()> const& _handler) { m_onActivity = _handler; }
+
 public:
     bool needCheckPacketInGroup = true;
 
@@ -79,6 +97,18 @@ private:
     void onPeerTransactions(SyncMsgPacket const& _packet);
     void onPeerBlocks(SyncMsgPacket const& _packet);
     void onPeerRequestBlocks(SyncMsgPacket const& _packet);
+    void onPeerRequestSnapshotManifest(SyncMsgPacket const& _packet);
+    void onPeerSnapshotManifest(SyncMsgPacket const& _packet);
+    void onPeerRequestSnapshotChunk(SyncMsgPacket const& _packet);
+    void onPeerSnapshotChunk(SyncMsgPacket const& _packet);
+    void onPeerRequestHeaders(SyncMsgPacket const& _packet);
+    void onPeerHeaders(SyncMsgPacket const& _packet);
+    void onPeerRequestBodies(SyncMsgPacket const& _packet);
+    void onPeerBodies(SyncMsgPacket const& _packet);
+    void onPeerTxsAnnounce(SyncMsgPacket const& _packet);
+    void onPeerRequestTxs(SyncMsgPacket const& _packet);
+    void onPeerRequestStateDiffs(SyncMsgPacket const& _packet);
+    void onPeerStateDiffs(SyncMsgPacket const& _packet);
 
 private:
     // Outside data
@@ -87,6 +117,11 @@ private:
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
     std::shared_ptr<SyncMasterStatus> m_syncStatus;
     std::shared_ptr<DownloadingTxsQueue> m_txQueue;
+    SnapshotStore::Ptr m_snapshotStore;
+    SnapshotImporter::Ptr m_snapshotImporter;
+    std::shared_ptr<DownloadingHeaderQueue> m_headerQueue;
+    StateDiffQueue::Ptr m_stateDiffQueue;
+    std::function<void()> m_onActivity;
 
     // Internal data
     PROTOCOL_ID m_protocolId;
@@ -43,6 +43,7 @@ bool SyncMsgPacket::decode(
 
     packetType = (SyncPacketType)(RLP(frame.cropped(0, 1)).toInt<unsigned>() - c_syncPacketIDBase);
     nodeId = _session->nodeID();
+    m_buffer = _msg->buffer();
     m_rlp = RLP(frame.cropped(1));
 
     return true;
@@ -56,6 +57,12 @@ P2PMessage::Ptr SyncMsgPacket::toMessage(PROTOCOL_ID _protocolId)
     m_rlpStream.swapOut(*b);
     msg->setBuffer(b);
     msg->setProtocolID(_protocolId);
+    /// the transactions are written after the blocks and may be dropped by a congested session
+    if (packetType == TransactionsPacket || packetType == TxsAnnouncePacket ||
+        packetType == ReqTxsPacket)
+    {
+        msg->setPriority(dev::network::GossipPriority);
+    }
     return msg;
 }
 
@@ -70,6 +77,7 @@ bool SyncMsgPacket::checkPacket(bytesConstRef _msg)
 
 RLPStream& SyncMsgPacket::prep(RLPStream& _s, unsigned _id, unsigned _args)
 {
+    packetType = (SyncPacketType)_id;
     return _s.appendRaw(bytes(1, _id + c_syncPacketIDBase)).appendList(_args);
 }
 
@@ -125,3 +133,85 @@ void SyncReqBlockPacket::encode(int64_t _from, unsigned _size)
     m_rlpStream.clear();
     prep(m_rlpStream, ReqBlocskPacket, 2) << _from << _size;
 }
+
+void SyncReqSnapshotManifestPacket::encode()
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqSnapshotManifestPacket, 0);
+}
+
+void SyncSnapshotManifestPacket::encode(dev::bytes const& _manifestRLP)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, SnapshotManifestPacket, 1).appendRaw(_manifestRLP, 1);
+}
+
+void SyncReqSnapshotChunkPacket::encode(h256 const& _manifestHash, size_t _index)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqSnapshotChunkPacket, 2) << _manifestHash << _index;
+}
+
+void SyncSnapshotChunkPacket::encode(
+    h256 const& _manifestHash, size_t _index, dev::bytes const& _chunk)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, SnapshotChunkPacket, 3) << _manifestHash << _index;
+    m_rlpStream.append(_chunk);
+}
+
+void SyncReqHeadersPacket::encode(int64_t _from, unsigned _size)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqHeadersPacket, 2) << _from << _size;
+}
+
+void SyncHeadersPacket::encode(std::vector<dev::bytes> const& _headerRLPs)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, HeadersPacket, _headerRLPs.size());
+    for (bytes const& bs : _headerRLPs)
+        m_rlpStream.appendRaw(bs);
+}
+
+void SyncReqBodiesPacket::encode(int64_t _from, unsigned _size)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqBodiesPacket, 2) << _from << _size;
+}
+
+void SyncBodiesPacket::encode(std::vector<dev::bytes> const& _bodyRLPs)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, BodiesPacket, _bodyRLPs.size());
+    for (bytes const& bs : _bodyRLPs)
+        m_rlpStream.appendRaw(bs);
+}
+
+void SyncTxsAnnouncePacket::encode(h256s const& _txHashes)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, TxsAnnouncePacket, 1).appendVector(_txHashes);
+}
+
+void SyncReqTxsPacket::encode(h256s const& _txHashes)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqTxsPacket, 1).appendVector(_txHashes);
+}
+
+void SyncReqStateDiffsPacket::encode(int64_t _from, unsigned _size)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqStateDiffsPacket, 2) << _from << _size;
+}
+
+void SyncStateDiffsPacket::encode(
+    int64_t _from, int64_t _to, std::vector<dev::bytes> const& _diffRLPs)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, StateDiffsPacket, 3) << _from << _to;
+    m_rlpStream.appendList(_diffRLPs.size());
+    for (bytes const& bs : _diffRLPs)
+        m_rlpStream.appendRaw(bs);
+}
@@ -63,14 +63,17 @@ public:
     std::shared_ptr<dev::p2p::P2PMessage> toMessage(PROTOCOL_ID _protocolId);
 
     RLP const& rlp() const { return m_rlp; }
+    /// @returns the buffer of the decoded message, rlp() points into it
+    std::shared_ptr<bytes> buffer() const { return m_buffer; }
 
 public:
     SyncPacketType packetType;
     NodeID nodeId;
 
 protected:
-    RLP m_rlp;              /// The result of decode
-    RLPStream m_rlpStream;  // The result of encode
+    RLP m_rlp;                        /// The result of decode
+    std::shared_ptr<bytes> m_buffer;  /// The message m_rlp is decoded from
+    RLPStream m_rlpStream;            // The result of encode
     std::shared_ptr<dev::p2p::P2PMessageFactory> m_p2pFactory;
 
 private:
@@ -108,6 +111,95 @@ public:
     void encode(int64_t _from, unsigned _size);
 };
 
+class SyncReqSnapshotManifestPacket : public SyncMsgPacket
+{
+public:
+    SyncReqSnapshotManifestPacket() { packetType = ReqSnapshotManifestPacket; }
+    void encode();
+};
+
+class SyncSnapshotManifestPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotManifestPacket() { packetType = SnapshotManifestPacket; }
+    void encode(dev::bytes const& _manifestRLP);
+};
+
+class SyncReqSnapshotChunkPacket : public SyncMsgPacket
+{
+public:
+    SyncReqSnapshotChunkPacket() { packetType = ReqSnapshotChunkPacket; }
+    void encode(h256 const& _manifestHash, size_t _index);
+};
+
+class SyncSnapshotChunkPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotChunkPacket() { packetType = SnapshotChunkPacket; }
+    void encode(h256 const& _manifestHash, size_t _index, dev::bytes const& _chunk);
+};
+
+class SyncReqHeadersPacket : public SyncMsgPacket
+{
+public:
+    SyncReqHeadersPacket() { packetType = ReqHeadersPacket; }
+    void encode(int64_t _from, unsigned _size);
+};
+
+class SyncHeadersPacket : public SyncMsgPacket
+{
+public:
+    SyncHeadersPacket() { packetType = HeadersPacket; }
+    /// each item is the list of a block header and its sigList
+    void encode(std::vector<dev::bytes> const& _headerRLPs);
+};
+
+class SyncReqBodiesPacket : public SyncMsgPacket
+{
+public:
+    SyncReqBodiesPacket() { packetType = ReqBodiesPacket; }
+    void encode(int64_t _from, unsigned _size);
+};
+
+class SyncBodiesPacket : public SyncMsgPacket
+{
+public:
+    SyncBodiesPacket() { packetType = BodiesPacket; }
+    /// each item is the list of a block number and the transactions of the block
+    void encode(std::vector<dev::bytes> const& _bodyRLPs);
+};
+
+class SyncTxsAnnouncePacket : public SyncMsgPacket
+{
+public:
+    SyncTxsAnnouncePacket() { packetType = TxsAnnouncePacket; }
+    void encode(h256s const& _txHashes);
+};
+
+/// the transactions are sent back in a TransactionsPacket
+class SyncReqTxsPacket : public SyncMsgPacket
+{
+public:
+    SyncReqTxsPacket() { packetType = ReqTxsPacket; }
+    void encode(h256s const& _txHashes);
+};
+
+class SyncReqStateDiffsPacket : public SyncMsgPacket
+{
+public:
+    SyncReqStateDiffsPacket() { packetType = ReqStateDiffsPacket; }
+    void encode(int64_t _from, unsigned _size);
+};
+
+class SyncStateDiffsPacket : public SyncMsgPacket
+{
+public:
+    SyncStateDiffsPacket() { packetType = StateDiffsPacket; }
+    /// the diffs of the blocks _from to _to the peer keeps, each the list of a block number and
+    /// its encoded diff
+    void encode(int64_t _from, int64_t _to, std::vector<dev::bytes> const& _diffRLPs);
+};
+
 
 }  // namespace sync
 }  // namespace dev
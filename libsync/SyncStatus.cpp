@@ -31,6 +31,143 @@ using namespace dev::p2p;
 using namespace dev::blockchain;
 using namespace dev::txpool;
 
+static double movingAverage(double _average, double _sample)
+{
+    return _average <= 0 ? _sample : 0.8 * _average + 0.2 * _sample;
+}
+
+void PeerDownloadStatus::onRequest(int64_t _from, int64_t _to, uint64_t _now)
+{
+    Guard l(x_status);
+    if (m_pending <= 0)
+    {
+        m_requestTime = _now;
+        m_lastActiveTime = _now;
+        m_received = 0;
+        m_responded = false;
+    }
+    m_ranges.emplace_back(_from, _to);
+    m_pending += _to - _from + 1;
+}
+
+void PeerDownloadStatus::onBlocks(size_t _count, uint64_t _now)
+{
+    Guard l(x_status);
+    if (m_pending <= 0)
+    {
+        return;  // the blocks of a stalled request
+    }
+    if (!m_responded)
+    {
+        m_rtt = movingAverage(m_rtt, _now - m_requestTime);
+        m_responded = true;
+    }
+    m_lastActiveTime = _now;
+    m_received += _count;
+    m_pending -= _count;
+    if (m_pending > 0)
+    {
+        return;
+    }
+    // the requests are all answered, resize the window to the blocks sent in a round
+    uint64_t elapsed = std::max<uint64_t>(1, _now - m_requestTime);
+    m_throughput = movingAverage(m_throughput, 1000.0 * m_received / elapsed);
+    m_window = std::min(c_maxRequestBlocksPerPeer,
+        std::max(c_minRequestBlocks, (int64_t)(m_throughput * c_requestRoundTime / 1000)));
+    m_ranges.clear();
+    m_pending = 0;
+}
+
+bool PeerDownloadStatus::checkStall(uint64_t _now)
+{
+    Guard l(x_status);
+    uint64_t timeout = std::max<uint64_t>(c_minDownloadStallTimeout, 4 * m_rtt);
+    if (m_pending <= 0 || _now - m_lastActiveTime <= timeout)
+    {
+        return false;
+    }
+    m_ranges.clear();
+    m_pending = 0;
+    m_stallTime = _now;
+    m_window = std::max(c_minRequestBlocks, m_window / 2);
+    return true;
+}
+
+bool PeerDownloadStatus::busy() const
+{
+    Guard l(x_status);
+    return m_pending > 0;
+}
+
+bool PeerDownloadStatus::available(uint64_t _now) const
+{
+    Guard l(x_status);
+    return m_stallTime == 0 || _now - m_stallTime > c_minDownloadStallTimeout;
+}
+
+bool PeerDownloadStatus::requesting(int64_t _number, int64_t& _rangeEnd) const
+{
+    Guard l(x_status);
+    for (auto const& range : m_ranges)
+    {
+        if (range.first <= _number && _number <= range.second)
+        {
+            _rangeEnd = range.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t PeerDownloadStatus::requestWindow() const
+{
+    Guard l(x_status);
+    return m_window;
+}
+
+double PeerDownloadStatus::throughput() const
+{
+    Guard l(x_status);
+    return m_throughput;
+}
+
+double PeerDownloadStatus::rtt() const
+{
+    Guard l(x_status);
+    return m_rtt;
+}
+
+size_t PeerTxsRequests::push(h256s const& _txHashes)
+{
+    Guard l(x_hashes);
+    size_t queued = 0;
+    for (auto const& hash : _txHashes)
+    {
+        if (m_hashes.size() >= c_maxPeerTxsRequests)
+        {
+            break;
+        }
+        m_hashes.push_back(hash);
+        ++queued;
+    }
+    return queued;
+}
+
+h256s PeerTxsRequests::pop(size_t _size)
+{
+    Guard l(x_hashes);
+    size_t size = min(_size, m_hashes.size());
+    h256s hashes(m_hashes.begin(), m_hashes.begin() + size);
+    m_hashes.erase(m_hashes.begin(), m_hashes.begin() + size);
+    return hashes;
+}
+
+size_t PeerTxsRequests::size() const
+{
+    Guard l(x_hashes);
+    return m_hashes.size();
+}
+
 bool SyncMasterStatus::hasPeer(NodeID const& _id)
 {
     ReadGuard l(x_peerStatus);
@@ -31,6 +31,7 @@
 #include <libnetwork/Session.h>
 #include <libp2p/P2PInterface.h>
 #include <libtxpool/TxPoolInterface.h>
+#include <deque>
 #include <map>
 #include <queue>
 #include <set>
@@ -50,6 +51,58 @@ struct SyncStatus
     h256 knownLatestHash;
 };
 
+/// throughput, round trip time and in-flight ranges of the blocks downloaded from a peer, updated
+/// by the sync thread on requesting and by the message handler on receiving the blocks
+class PeerDownloadStatus
+{
+public:
+    /// the blocks [_from, _to] are requested from the peer
+    void onRequest(int64_t _from, int64_t _to, uint64_t _now);
+    /// _count blocks are received from the peer
+    void onBlocks(size_t _count, uint64_t _now);
+    /// give up the in-flight ranges if the peer sends nothing in the stall timeout, the peer is
+    /// skipped for a while and its window halved, return true if the peer just stalled
+    bool checkStall(uint64_t _now);
+
+    bool busy() const;
+    bool available(uint64_t _now) const;
+    /// whether _number is in a range in flight
+    bool requesting(int64_t _number, int64_t& _rangeEnd) const;
+    int64_t requestWindow() const;
+    double throughput() const;
+    double rtt() const;
+
+private:
+    mutable Mutex x_status;
+    std::vector<std::pair<int64_t, int64_t>> m_ranges;
+    int64_t m_pending = 0;
+    size_t m_received = 0;
+    uint64_t m_requestTime = 0;
+    uint64_t m_lastActiveTime = 0;
+    uint64_t m_stallTime = 0;
+    bool m_responded = false;
+    /// moving averages of the round trip time in ms and the blocks received per second
+    double m_rtt = 0;
+    double m_throughput = 0;
+    int64_t m_window = c_maxRequestBlocks;
+};
+
+/// hashes of the transactions requested by a peer, served by the sync thread in the next rounds
+/// and bounded so that a peer can't queue the whole txpool
+class PeerTxsRequests
+{
+public:
+    /// the hashes beyond c_maxPeerTxsRequests are dropped, returns the number queued
+    size_t push(h256s const& _txHashes);
+    /// take at most _size hashes in the order they were requested
+    h256s pop(size_t _size);
+    size_t size() const;
+
+private:
+    mutable Mutex x_hashes;
+    std::deque<h256> m_hashes;
+};
+
 class SyncPeerStatus
 {
 public:
@@ -83,6 +136,8 @@ public:
     h256 genesisHash;
     h256 latestHash;
     DownloadRequestQueue reqQueue;
+    PeerDownloadStatus download;
+    PeerTxsRequests txsRequests;
     bool isSealer = false;
 };
 
@@ -0,0 +1,221 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : filter of the hashes of the recently committed transactions
+ * @file: CommittedTxFilter.cpp
+ */
+#include "CommittedTxFilter.h"
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/RLP.h>
+#include <cstring>
+
+using namespace dev;
+using namespace dev::txpool;
+
+CommittedTxFilter::CommittedTxFilter(size_t _capacity) : m_capacity(std::max<size_t>(_capacity, 1))
+{
+    /// the buckets are filled to 90% at most, cuckoo filters of 4 slots a bucket reach 95%
+    size_t buckets = 1;
+    while (buckets * c_bucketSlots * 9 < m_capacity * 10)
+    {
+        buckets <<= 1;
+    }
+    m_bucketMask = buckets - 1;
+    m_current.slots.assign(buckets * c_bucketSlots, 0);
+    m_previous.slots.assign(buckets * c_bucketSlots, 0);
+}
+
+uint64_t CommittedTxFilter::fingerprint(h256 const& _txHash) const
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | _txHash[i];
+    }
+    /// 0 marks an empty slot
+    return value ? value : 1;
+}
+
+size_t CommittedTxFilter::bucket(h256 const& _txHash) const
+{
+    uint64_t value = 0;
+    for (size_t i = 8; i < 16; ++i)
+    {
+        value = (value << 8) | _txHash[i];
+    }
+    return value & m_bucketMask;
+}
+
+size_t CommittedTxFilter::altBucket(size_t _bucket, uint64_t _fingerprint) const
+{
+    /// the alternate of the alternate is the bucket itself, so a kicked out fingerprint moves
+    /// without its hash
+    return (_bucket ^ ((_fingerprint * 0xC6A4A7935BD1E995ULL) >> 32)) & m_bucketMask;
+}
+
+bool CommittedTxFilter::find(
+    Generation const& _generation, size_t _bucket, uint64_t _fingerprint) const
+{
+    auto begin = _generation.slots.begin() + _bucket * c_bucketSlots;
+    return std::find(begin, begin + c_bucketSlots, _fingerprint) != begin + c_bucketSlots;
+}
+
+bool CommittedTxFilter::put(Generation& _generation, size_t _bucket, uint64_t _fingerprint)
+{
+    for (size_t i = _bucket * c_bucketSlots; i < (_bucket + 1) * c_bucketSlots; ++i)
+    {
+        if (_generation.slots[i] == 0)
+        {
+            _generation.slots[i] = _fingerprint;
+            ++_generation.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CommittedTxFilter::rotate()
+{
+    std::swap(m_previous, m_current);
+    std::fill(m_current.slots.begin(), m_current.slots.end(), 0);
+    m_current.size = 0;
+}
+
+void CommittedTxFilter::insert(h256 const& _txHash)
+{
+    auto fp = fingerprint(_txHash);
+    auto first = bucket(_txHash);
+    auto second = altBucket(first, fp);
+    WriteGuard l(x_filter);
+    if (find(m_current, first, fp) || find(m_current, second, fp))
+    {
+        return;
+    }
+    if (m_current.size >= m_capacity)
+    {
+        rotate();
+    }
+    if (put(m_current, first, fp) || put(m_current, second, fp))
+    {
+        return;
+    }
+    /// kick the fingerprints to their alternate buckets until one finds an empty slot
+    auto index = (m_random & 1) ? first : second;
+    for (size_t kicks = 0; kicks < c_maxKicks; ++kicks)
+    {
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        std::swap(fp, m_current.slots[index * c_bucketSlots + m_random % c_bucketSlots]);
+        index = altBucket(index, fp);
+        if (put(m_current, index, fp))
+        {
+            return;
+        }
+    }
+    /// too crowded, the fingerprint left over starts the next generation
+    rotate();
+    put(m_current, index, fp);
+}
+
+bool CommittedTxFilter::contains(h256 const& _txHash) const
+{
+    auto fp = fingerprint(_txHash);
+    auto first = bucket(_txHash);
+    auto second = altBucket(first, fp);
+    ReadGuard l(x_filter);
+    return find(m_current, first, fp) || find(m_current, second, fp) ||
+           find(m_previous, first, fp) || find(m_previous, second, fp);
+}
+
+size_t CommittedTxFilter::size() const
+{
+    ReadGuard l(x_filter);
+    return m_current.size + m_previous.size;
+}
+
+int64_t CommittedTxFilter::number() const
+{
+    ReadGuard l(x_filter);
+    return m_number;
+}
+
+void CommittedTxFilter::setNumber(int64_t _number)
+{
+    WriteGuard l(x_filter);
+    m_number = _number;
+}
+
+void CommittedTxFilter::save(std::string const& _path) const
+{
+    /// [capacity, number + 1, size, slots, size, slots] of the newer generation first, the slots
+    /// in the byte order of the node
+    RLPStream stream(6);
+    {
+        ReadGuard l(x_filter);
+        stream << (u256)m_capacity << (u256)(m_number + 1);
+        for (auto generation : {&m_current, &m_previous})
+        {
+            stream << (u256)generation->size;
+            stream << bytesConstRef((byte const*)generation->slots.data(),
+                generation->slots.size() * sizeof(uint64_t));
+        }
+    }
+    writeFile(_path, stream.out(), true);
+}
+
+bool CommittedTxFilter::load(std::string const& _path)
+{
+    auto data = contents(_path);
+    if (data.empty())
+    {
+        return false;
+    }
+    try
+    {
+        RLP rlp(data);
+        if (!rlp.isList() || rlp.itemCount() != 6 || rlp[0].toInt<size_t>() != m_capacity)
+        {
+            return false;
+        }
+        Generation current;
+        Generation previous;
+        size_t index = 2;
+        for (auto generation : {&current, &previous})
+        {
+            generation->size = rlp[index].toInt<size_t>();
+            auto slots = rlp[index + 1].toBytesConstRef();
+            if (slots.size() != m_current.slots.size() * sizeof(uint64_t))
+            {
+                return false;
+            }
+            generation->slots.resize(m_current.slots.size());
+            std::memcpy(generation->slots.data(), slots.data(), slots.size());
+            index += 2;
+        }
+        WriteGuard l(x_filter);
+        m_number = rlp[1].toInt<int64_t>() - 1;
+        m_current = std::move(current);
+        m_previous = std::move(previous);
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : filter of the hashes of the recently committed transactions
+ * @file: CommittedTxFilter.h
+ */
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace txpool
+{
+/// Hashes of the recently committed transactions, so that a transaction submitted again is refused
+/// before its nonce is checked, without waiting for the nonces loaded from the storage after a
+/// restart. A cuckoo filter of 64 bits fingerprints, 8 bytes a hash instead of a hash set node, and
+/// a false positive needs a hash with the first 8 bytes of a committed one in the same buckets,
+/// only a sender grinding the hash of its own transaction gets one. The hashes are kept in two
+/// generations, the older is dropped when the newer is full. Hashes missing in the filter are
+/// still refused by the nonce check.
+class CommittedTxFilter
+{
+public:
+    typedef std::shared_ptr<CommittedTxFilter> Ptr;
+
+    /// _capacity: the hashes of a generation
+    explicit CommittedTxFilter(size_t _capacity);
+
+    void insert(h256 const& _txHash);
+    bool contains(h256 const& _txHash) const;
+    /// the hashes in both generations
+    size_t size() const;
+
+    /// the last block whose transactions were inserted
+    int64_t number() const;
+    void setNumber(int64_t _number);
+
+    /// write the filter to _path by a temporary file
+    void save(std::string const& _path) const;
+    /// @returns false if _path is missing, malformed or saved with another capacity
+    bool load(std::string const& _path);
+
+private:
+    struct Generation
+    {
+        std::vector<uint64_t> slots;
+        size_t size = 0;
+    };
+
+    static const size_t c_bucketSlots = 4;
+    static const size_t c_maxKicks = 500;
+
+    uint64_t fingerprint(h256 const& _txHash) const;
+    size_t bucket(h256 const& _txHash) const;
+    size_t altBucket(size_t _bucket, uint64_t _fingerprint) const;
+    bool find(Generation const& _generation, size_t _bucket, uint64_t _fingerprint) const;
+    bool put(Generation& _generation, size_t _bucket, uint64_t _fingerprint);
+    /// the newer generation becomes the older one
+    void rotate();
+
+    size_t m_capacity;
+    size_t m_bucketMask;
+    Generation m_current;
+    Generation m_previous;
+    int64_t m_number = -1;
+    /// picks the slot to kick out
+    uint64_t m_random = 0x9E3779B97F4A7C15ULL;
+    mutable SharedMutex x_filter;
+};
+}  // namespace txpool
+}  // namespace dev
@@ -33,9 +33,23 @@ namespace txpool
 {
 void TransactionNonceCheck::init()
 {
-    m_startblk = 0;
-    m_endblk = 0;
-    updateCache(true);
+    WriteGuard l(m_lock);
+    try
+    {
+        Timer timer;
+        m_startblk = 0;
+        m_endblk = 0;
+        moveWindow(true, nullptr);
+        NONCECHECKER_LOG(INFO) << LOG_DESC("init") << LOG_KV("cacheSize", m_cache.size())
+                               << LOG_KV("blkNumber", m_blockNumber)
+                               << LOG_KV("costTime", timer.elapsed() * 1000);
+    }
+    catch (...)
+    {
+        NONCECHECKER_LOG(WARNING)
+            << LOG_DESC("init: load nonce cache failed")
+            << LOG_KV("EINFO", boost::current_exception_diagnostic_information());
+    }
 }
 bool TransactionNonceCheck::isBlockLimitOk(Transaction const& _tx)
 {
@@ -58,115 +72,112 @@ bool TransactionNonceCheck::ok(Transaction const& _transaction, bool _needinsert
     return isNonceOk(_transaction, _needinsert);
 }
 
-void TransactionNonceCheck::getNonceAndUpdateCache(
-    NonceVec& nonceVec, int64_t const& blockNumber, bool const& update)
+void TransactionNonceCheck::updateCache(bool _rebuild)
 {
-    if (m_blockNonceCache.count(blockNumber))
+    waitWarmed();
+    WriteGuard l(m_lock);
+    try
     {
-        nonceVec = m_blockNonceCache[blockNumber];
-        NONCECHECKER_LOG(TRACE) << LOG_DESC("updateCache: getNonceAndUpdateCache cache hit ")
-                                << LOG_KV("blockNumber", blockNumber)
-                                << LOG_KV("nonceSize", nonceVec.size())
-                                << LOG_KV("nonceCacheSize", m_blockNonceCache.size());
+        Timer timer;
+        moveWindow(_rebuild, nullptr);
+        NONCECHECKER_LOG(DEBUG) << LOG_DESC("updateCache") << LOG_KV("cacheSize", m_cache.size())
+                                << LOG_KV("costTime", timer.elapsed() * 1000);
     }
-    /// block cache hit
-    else if (m_blockChain->number() == blockNumber)
+    catch (...)
     {
-        std::shared_ptr<Block> pBlock = m_blockChain->getBlockByNumber(blockNumber);
-        if (pBlock)
-        {
-            nonceVec = pBlock->getAllNonces();
-            NONCECHECKER_LOG(TRACE)
-                << LOG_DESC("updateCache: getNonceAndUpdateCache block cache hit ")
-                << LOG_KV("blockNumber", blockNumber) << LOG_KV("nonceSize", nonceVec.size())
-                << LOG_KV("nonceCacheSize", m_blockNonceCache.size());
-        }
+        // should not happen as exceptions
+        NONCECHECKER_LOG(WARNING)
+            << LOG_DESC("updateCache: update nonce cache failed")
+            << LOG_KV("EINFO", boost::current_exception_diagnostic_information());
     }
-    else
+}
+
+void TransactionNonceCheck::updateCache(Block const& _block)
+{
+    waitWarmed();
+    WriteGuard l(m_lock);
+    try
     {
-        m_blockChain->getNonces(nonceVec, blockNumber);
-        NONCECHECKER_LOG(TRACE) << LOG_DESC("updateCache: getNonceAndUpdateCache cache miss ")
-                                << LOG_KV("blockNumber", blockNumber)
-                                << LOG_KV("nonceSize", nonceVec.size())
-                                << LOG_KV("nonceCacheSize", m_blockNonceCache.size());
+        Timer timer;
+        moveWindow(false, &_block);
+        NONCECHECKER_LOG(DEBUG) << LOG_DESC("updateCache for committed block")
+                                << LOG_KV("blkNumber", _block.blockHeader().number())
+                                << LOG_KV("cacheSize", m_cache.size())
+                                << LOG_KV("costTime", timer.elapsed() * 1000);
     }
-    if (update && m_blockNonceCache.size() < m_maxBlockLimit)
+    catch (...)
     {
-        m_blockNonceCache[blockNumber] = nonceVec;
+        // should not happen as exceptions
+        NONCECHECKER_LOG(WARNING)
+            << LOG_DESC("updateCache: update nonce cache failed")
+            << LOG_KV("EINFO", boost::current_exception_diagnostic_information());
     }
 }
 
-void TransactionNonceCheck::updateCache(bool _rebuild)
+void TransactionNonceCheck::moveWindow(bool _rebuild, Block const* _block)
 {
-    WriteGuard l(m_lock);
-    {
-        try
-        {
-            Timer timer;
-            m_blockNumber = m_blockChain->number();
-            int64_t lastnumber = m_blockNumber;
-            int64_t prestartblk = m_startblk;
-            int64_t preendblk = m_endblk;
+    m_blockNumber = m_blockChain->number();
+    int64_t prestartblk = m_startblk;
+    int64_t preendblk = m_endblk;
 
-            m_endblk = lastnumber;
-            if (lastnumber > m_maxBlockLimit)
-            {
-                m_startblk = lastnumber - m_maxBlockLimit;
-            }
-            else
-            {
-                m_startblk = 0;
-            }
+    m_endblk = m_blockNumber;
+    if (m_blockNumber > m_maxBlockLimit)
+    {
+        m_startblk = m_blockNumber - m_maxBlockLimit;
+    }
+    else
+    {
+        m_startblk = 0;
+    }
 
-            NONCECHECKER_LOG(TRACE)
-                << LOG_DESC("updateCache") << LOG_KV("rebuild", _rebuild)
-                << LOG_KV("startBlk", m_startblk) << LOG_KV("endBlk", m_endblk)
-                << LOG_KV("prestartBlk", prestartblk) << LOG_KV("preEndBlk", preendblk);
-            if (_rebuild)
+    NONCECHECKER_LOG(TRACE) << LOG_DESC("updateCache") << LOG_KV("rebuild", _rebuild)
+                            << LOG_KV("startBlk", m_startblk) << LOG_KV("endBlk", m_endblk)
+                            << LOG_KV("prestartBlk", prestartblk) << LOG_KV("preEndBlk", preendblk);
+    /// the ring is resized when the block limit changes
+    if (_rebuild || m_blockNonces.size() != m_maxBlockLimit + 1)
+    {
+        m_cache.clear();
+        m_blockNonces.assign(m_maxBlockLimit + 1, std::make_pair(-1, NonceVec()));
+        preendblk = 0;
+    }
+    else
+    {
+        /// erase the expired nonces
+        for (auto i = prestartblk; i < std::min(m_startblk, preendblk + 1); i++)
+        {
+            auto& slot = m_blockNonces[i % m_blockNonces.size()];
+            if (slot.first != i)
             {
-                m_cache.clear();
-                preendblk = 0;
+                slot.second.clear();
+                m_blockChain->getNonces(slot.second, i);
             }
-            else
+            for (auto const& nonce : slot.second)
             {
-                /// erase the expired nonces
-                for (auto i = prestartblk; i < m_startblk; i++)
-                {
-                    NonceVec nonce_vec;
-                    getNonceAndUpdateCache(nonce_vec, i, false);
-                    for (auto nonce : nonce_vec)
-                    {
-                        m_cache.erase(nonce);
-                    }
-                    /// erase the expired nonces from cache since it can't be touched forever
-                    if (m_blockNonceCache.count(i))
-                    {
-                        m_blockNonceCache.erase(i);
-                    }
-                }
+                m_cache.erase(nonce);
             }
-            /// insert the nonces of a new block
-            for (auto i = std::max(preendblk + 1, m_startblk); i <= m_endblk; i++)
-            {
-                NonceVec nonce_vec;
-                getNonceAndUpdateCache(nonce_vec, i);
-                for (auto nonce : nonce_vec)
-                {
-                    m_cache.insert(nonce);
-                }
-            }  // for
-            NONCECHECKER_LOG(DEBUG)
-                << LOG_DESC("updateCache") << LOG_KV("cacheSize", m_cache.size())
-                << LOG_KV("costTime", timer.elapsed() * 1000);
+            slot.first = -1;
+            slot.second.clear();
+        }
+    }
+    /// insert the nonces of the new blocks
+    for (auto i = std::max(preendblk + 1, m_startblk); i <= m_endblk; i++)
+    {
+        auto& slot = m_blockNonces[i % m_blockNonces.size()];
+        slot.first = i;
+        slot.second.clear();
+        if (_block && _block->blockHeader().number() == i)
+        {
+            slot.second = _block->getAllNonces();
         }
-        catch (...)
+        else
         {
-            // should not happen as exceptions
-            NONCECHECKER_LOG(WARNING)
-                << LOG_DESC("updateCache: update nonce cache failed")
-                << LOG_KV("EINFO", boost::current_exception_diagnostic_information());
+            m_blockChain->getNonces(slot.second, i);
+        }
+        for (auto const& nonce : slot.second)
+        {
+            m_cache.insert(nonce);
         }
     }
-}  // fun
+}
 }  // namespace txpool
 }  // namespace dev
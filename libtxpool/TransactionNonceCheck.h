@@ -25,6 +25,7 @@
 #include "CommonTransactionNonceCheck.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <boost/timer.hpp>
+#include <future>
 #include <thread>
 
 using namespace dev::eth;
@@ -44,33 +45,49 @@ public:
     TransactionNonceCheck(std::shared_ptr<dev::blockchain::BlockChainInterface> const& _blockChain)
       : CommonTransactionNonceCheck(), m_blockChain(_blockChain)
     {
-        init();
+        m_blockNumber = m_blockChain->number();
+        /// the nonces of the last blocks are loaded in the background not to hold the startup,
+        /// the checks wait for them
+        m_warmed = std::async(std::launch::async, [this]() { init(); }).share();
     }
-    ~TransactionNonceCheck() {}
+    ~TransactionNonceCheck() { waitWarmed(); }
+    /// load the nonces of the blocks in the window
     void init();
     bool ok(dev::eth::Transaction const& _transaction, bool _needinsert = false);
+    bool isNonceOk(dev::eth::Transaction const& _trans, bool needInsert = false) override
+    {
+        waitWarmed();
+        return CommonTransactionNonceCheck::isNonceOk(_trans, needInsert);
+    }
     void updateCache(bool _rebuild = false);
+    /// update the cache after _block is committed, its nonces are not read from the DB
+    void updateCache(dev::eth::Block const& _block);
     unsigned const& maxBlockLimit() const { return m_maxBlockLimit; }
     void setBlockLimit(unsigned const& limit) { m_maxBlockLimit = limit; }
 
     bool isBlockLimitOk(dev::eth::Transaction const& _trans);
 
-    void getNonceAndUpdateCache(
-        NonceVec& nonceVec, int64_t const& blockNumber, bool const& update = true);
-
 private:
+    /// move the window to the current block, _block is the block just committed or null
+    void moveWindow(bool _rebuild, dev::eth::Block const* _block);
+    void waitWarmed()
+    {
+        if (m_warmed.valid())
+        {
+            m_warmed.wait();
+        }
+    }
+
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
-    std::vector<NonceVec> nonce_vec;
-    /// cache the block nonce to in case of accessing the DB to get nonces of given block frequently
-    /// key: block number
-    /// value: all the nonces of a given block
-    /// we cache at most m_maxBlockLimit entries(occuppy about 32KB)
-    std::map<int64_t, NonceVec> m_blockNonceCache;
+    /// ring of the nonces of the blocks in [m_startblk, m_endblk], block i is in the slot
+    /// i % size with its number, so the expired nonces are erased without accessing the DB
+    std::vector<std::pair<int64_t, NonceVec>> m_blockNonces;
 
     int64_t m_startblk;
     int64_t m_endblk;
     unsigned m_maxBlockLimit = 1000;
     int64_t m_blockNumber;
+    std::shared_future<void> m_warmed;
 };
 }  // namespace txpool
 }  // namespace dev
@@ -28,6 +28,22 @@
 using namespace std;
 using namespace dev::p2p;
 using namespace dev::eth;
+namespace
+{
+/// the journal is not rewritten below this size
+const uint64_t c_minJournalCompactSize = 64 * 1024 * 1024;
+
+/// the transactions managing the chain: system config, consensus and permission
+bool isSystemTransaction(Transaction const& _tx)
+{
+    if (_tx.isCreation())
+        return false;
+    auto to = _tx.receiveAddress();
+    return to == dev::Address(0x1000) || to == dev::Address(0x1003) ||
+           to == dev::Address(0x1005);
+}
+}  // namespace
+
 namespace dev
 {
 namespace txpool
@@ -124,21 +140,30 @@ ImportResult TxPool::import(bytesConstRef _txBytes, IfDropped _ik)
 ImportResult TxPool::import(Transaction& _tx, IfDropped)
 {
     _tx.setImportTime(u256(utcTime()));
+    /// recover the sender before locking, the imports only wait for each other to be checked
+    /// against the queue and inserted
+    if (!isFull())
+    {
+        try
+        {
+            _tx.sender();
+        }
+        catch (std::exception& e)
+        {
+            TXPOOL_LOG(ERROR) << "[Import] invalid signature, tx = " << _tx.sha3().abridged();
+            return ImportResult::Malformed;
+        }
+    }
     UpgradableGuard l(m_lock);
     /// check the txpool size
-    if (m_txsQueue.size() >= m_limit)
+    if (isFull(_tx))
     {
-        auto callback = _tx.rpcCallback();
-        if (callback)
+        UpgradeGuard ul(l);
+        if (!evictForMemory(_tx))
         {
-            dev::eth::LocalisedTransactionReceipt::Ptr receipt =
-                std::make_shared<dev::eth::LocalisedTransactionReceipt>(
-                    executive::TransactionException::TxPoolIsFull);
-
-            m_callbackPool.enqueue([callback, receipt] { callback(receipt); });
+            notifyTxPoolIsFull(_tx);
+            return ImportResult::TransactionPoolIsFull;
         }
-
-        return ImportResult::TransactionPoolIsFull;
     }
     /// check the verify result(nonce && signature check)
     ImportResult verify_ret = verify(_tx);
@@ -154,38 +179,174 @@ ImportResult TxPool::import(Transaction& _tx, IfDropped)
     return verify_ret;
 }
 
-void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
+std::vector<ImportResult> TxPool::batchImport(Transactions& _txs)
 {
-    auto trans_num = block.getTransactionSize();
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, trans_num), [&](const tbb::blocked_range<size_t>& _r) {
-            for (size_t i = _r.begin(); i != _r.end(); i++)
-            {
-                h256 txHash = block.transactions()[i].sha3();
+    std::vector<ImportResult> results(_txs.size(), ImportResult::Success);
+    importTransactions(_txs, results);
+    return results;
+}
 
-                /// force sender for the transaction
-                ReadGuard l(m_lock);
-                auto p_tx = m_txsHash.find(txHash);
-                l.unlock();
+std::vector<ImportResult> TxPool::batchImport(std::vector<bytesConstRef> const& _txsBytes)
+{
+    Transactions txs(_txsBytes.size());
+    std::vector<ImportResult> results(_txsBytes.size(), ImportResult::Success);
+    decodeTransactions(_txsBytes, txs, results);
+    importTransactions(txs, results);
+    return results;
+}
 
-                if (p_tx != m_txsHash.end())
+void TxPool::decodeTransactions(std::vector<bytesConstRef> const& _txsBytes, Transactions& _txs,
+    std::vector<ImportResult>& _results)
+{
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _txsBytes.size()),
+        [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                try
                 {
-                    block.setSenderForTransaction(i, p_tx->second->sender());
+                    _txs[i].decode(_txsBytes[i], CheckTransaction::None);
+                    if (sha3(_txsBytes[i]) != _txs[i].sha3())
+                        _results[i] = ImportResult::Malformed;
                 }
-                /// verify the transaction
-                else
+                catch (std::exception& e)
                 {
-                    block.setSenderForTransaction(i);
+                    TXPOOL_LOG(ERROR) << LOG_DESC("import transaction failed")
+                                      << LOG_KV("EINFO", boost::diagnostic_information(e));
+                    _results[i] = ImportResult::Malformed;
                 }
             }
         });
 }
 
+void TxPool::importTransactions(Transactions& _txs, std::vector<ImportResult>& _results)
+{
+    /// the known transactions need no sender
+    {
+        ReadGuard l(m_lock);
+        for (size_t i = 0; i < _txs.size(); ++i)
+        {
+            if (_results[i] == ImportResult::Success && m_txsHash.count(_txs[i].sha3()))
+                _results[i] = ImportResult::AlreadyKnown;
+        }
+    }
+    auto importTime = u256(utcTime());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs.size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                if (_results[i] != ImportResult::Success)
+                    continue;
+                /// the transactions reloaded from the journal keep their import time
+                if (_txs[i].importTime() == 0)
+                    _txs[i].setImportTime(importTime);
+                try
+                {
+                    _txs[i].sender();
+                }
+                catch (std::exception& e)
+                {
+                    TXPOOL_LOG(ERROR)
+                        << "[Import] invalid signature, tx = " << _txs[i].sha3().abridged();
+                    _results[i] = ImportResult::Malformed;
+                }
+            }
+        });
+    size_t inserted = 0;
+    {
+        WriteGuard l(m_lock);
+        for (size_t i = 0; i < _txs.size(); ++i)
+        {
+            if (_results[i] != ImportResult::Success)
+                continue;
+            if (isFull(_txs[i]) && !evictForMemory(_txs[i]))
+            {
+                notifyTxPoolIsFull(_txs[i]);
+                _results[i] = ImportResult::TransactionPoolIsFull;
+                continue;
+            }
+            _results[i] = verify(_txs[i]);
+            if (_results[i] == ImportResult::Success && insert(_txs[i]))
+            {
+                m_commonNonceCheck->insertCache(_txs[i]);
+                inserted++;
+            }
+        }
+    }
+    if (inserted > 0)
+        m_onReady();
+}
+
+void TxPool::notifyTxPoolIsFull(Transaction const& _tx)
+{
+    auto callback = _tx.rpcCallback();
+    if (callback)
+    {
+        dev::eth::LocalisedTransactionReceipt::Ptr receipt =
+            std::make_shared<dev::eth::LocalisedTransactionReceipt>(
+                executive::TransactionException::TxPoolIsFull);
+
+        m_callbackPool.enqueue([callback, receipt] { callback(receipt); });
+    }
+}
+
+/**
+ * @brief : evict the latest transactions larger than _tx to make room for it under the memory
+ * limit, the system transactions are kept
+ * @return : false if the count limit is reached or not enough bytes can be freed
+ */
+bool TxPool::evictForMemory(Transaction const& _tx)
+{
+    if (m_memoryLimit == 0 || m_txsQueue.size() >= m_limit)
+        return false;
+    auto required = m_txsMemory + txMemory(_tx) - m_memoryLimit;
+    uint64_t freed = 0;
+    std::vector<TransactionQueue::iterator> evicted;
+    for (auto it = m_txsQueue.end(); it != m_txsQueue.begin() && freed < required;)
+    {
+        --it;
+        if (it->capacity() <= _tx.capacity() || isSystemTransaction(*it))
+            continue;
+        freed += txMemory(*it);
+        evicted.push_back(it);
+    }
+    if (freed < required)
+        return false;
+    dev::eth::LocalisedTransactionReceipt::Ptr receipt =
+        std::make_shared<dev::eth::LocalisedTransactionReceipt>(
+            executive::TransactionException::TxPoolIsFull);
+    WriteGuard l(x_transactionKnownBy);
+    for (auto it : evicted)
+    {
+        auto txHash = it->sha3();
+        auto nonceKey = m_commonNonceCheck->generateKey(*it);
+        TXPOOL_LOG(DEBUG) << LOG_DESC("evict tx: the memory limit reached")
+                          << LOG_KV("hash", txHash.abridged()) << LOG_KV("size", it->capacity());
+        removeTrans(txHash, true, receipt);
+        m_commonNonceCheck->delCache(nonceKey);
+        removeTransactionKnowBy(txHash);
+    }
+    return true;
+}
+
+void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
+{
+    /// the transactions in the pool have been verified, force their senders
+    block.recoverSenders([&](h256 const& txHash) -> Address {
+        ReadGuard l(m_lock);
+        auto p_tx = m_txsHash.find(txHash);
+        if (p_tx != m_txsHash.end())
+        {
+            return p_tx->second->sender();
+        }
+        return ZeroAddress;
+    });
+}
+
 bool TxPool::txExists(dev::h256 const& txHash)
 {
     ReadGuard l(m_lock);
     /// can't submit to the transaction pull, return false
-    if (m_txsQueue.size() >= m_limit)
+    if (isFull())
         return true;
     if (m_txsHash.count(txHash))
     {
@@ -216,6 +377,13 @@ ImportResult TxPool::verify(Transaction& trans, IfDropped _drop_policy, bool _ne
                           << LOG_KV("hash", tx_hash.abridged());
         return ImportResult::AlreadyKnown;
     }
+    /// the transaction has been committed, refused without waiting for the nonces of the chain
+    if (m_committedTxs->contains(tx_hash))
+    {
+        TXPOOL_LOG(TRACE) << LOG_DESC("Verify: already committed tx")
+                          << LOG_KV("hash", tx_hash.abridged());
+        return ImportResult::AlreadyInChain;
+    }
     /// the transaction has been dropped before
     if (m_dropped.count(tx_hash) && _drop_policy == IfDropped::Ignore)
     {
@@ -290,8 +458,12 @@ bool TxPool::removeTrans(h256 const& _txHash, bool needTriggerCallback,
         TxCallback callback{p_tx->second->rpcCallback(), pReceipt};
         m_callbackPool.enqueue([callback] { callback.call(callback.pReceipt); });
     }
+    m_txsMemory -= txMemory(*p_tx->second);
+    if (m_journal)
+        m_journal->remove(_txHash);
     m_txsQueue.erase(p_tx->second);
     m_txsHash.erase(p_tx);
+    m_systemTxs.erase(_txHash);
     return true;
 }
 
@@ -308,6 +480,19 @@ bool TxPool::insert(Transaction const& _tx)
     }
     TransactionQueue::iterator p_tx = m_txsQueue.emplace(_tx).first;
     m_txsHash[tx_hash] = p_tx;
+    m_txsMemory += txMemory(_tx);
+    if (m_journal)
+        m_journal->append(_tx);
+    if (isSystemTransaction(_tx))
+    {
+        m_systemTxs.insert(tx_hash);
+    }
+    /// the import time is set before locking, an import can land before the sealing cursor
+    auto importTime = static_cast<uint64_t>(_tx.importTime());
+    if (importTime < m_sealingCursor)
+    {
+        m_sealingCursor = importTime;
+    }
     return true;
 }
 
@@ -339,47 +524,121 @@ bool TxPool::drop(h256 const& _txHash)
 }
 
 dev::eth::LocalisedTransactionReceipt::Ptr TxPool::constructTransactionReceipt(
-    Transaction const& tx, TransactionReceipt const& receipt, Block const& block, unsigned index)
+    Transaction const& tx, TransactionReceipt const& receipt, h256 const& blockHash,
+    BlockNumber blockNumber, unsigned index)
 {
     dev::eth::LocalisedTransactionReceipt::Ptr pTxReceipt =
-        std::make_shared<LocalisedTransactionReceipt>(receipt, tx.sha3(),
-            block.blockHeader().hash(), block.blockHeader().number(), tx.safeSender(),
-            tx.receiveAddress(), index, receipt.gasUsed(), receipt.contractAddress());
+        std::make_shared<LocalisedTransactionReceipt>(receipt, tx.sha3(), blockHash, blockNumber,
+            tx.safeSender(), tx.receiveAddress(), index, receipt.gasUsed(),
+            receipt.contractAddress());
     return pTxReceipt;
 }
 
-bool TxPool::removeBlockKnowTrans(Block const& block)
+bool TxPool::removeBlockKnowTrans(h256s const& _txHashes)
 {
-    if (block.getTransactionSize() == 0)
+    if (_txHashes.empty())
         return true;
     WriteGuard l(x_transactionKnownBy);
-    for (auto const& trans : block.transactions())
+    for (auto const& hash : _txHashes)
     {
-        removeTransactionKnowBy(trans.sha3());
+        removeTransactionKnowBy(hash);
     }
     return true;
 }
 
-bool TxPool::dropTransactions(Block const& block, bool)
+bool TxPool::dropTransactions(Block const& block, h256s const& _txHashes)
 {
-    if (block.getTransactionSize() == 0)
+    if (_txHashes.empty())
         return true;
-    WriteGuard l(m_lock);
-    bool succ = true;
-    for (size_t i = 0; i < block.transactions().size(); i++)
+    /// the callbacks of the block are taken out of the pool with the transactions, their receipts
+    /// are constructed and notified by a single task off the commit path
+    auto notification = std::make_shared<BlockNotification>();
+    h256s removed;
+    removed.reserve(_txHashes.size());
     {
-        LocalisedTransactionReceipt::Ptr pReceipt = nullptr;
-        if (block.transactionReceipts().size() > i)
+        /// only the erases are under the lock, the journal records of the removed transactions are
+        /// written after it
+        WriteGuard l(m_lock);
+        uint64_t memory = 0;
+        for (size_t i = 0; i < _txHashes.size(); i++)
         {
-            pReceipt = constructTransactionReceipt(
-                block.transactions()[i], block.transactionReceipts()[i], block, i);
+            auto p_tx = m_txsHash.find(_txHashes[i]);
+            if (p_tx == m_txsHash.end())
+                continue;
+            if (p_tx->second->rpcCallback() && i < block.transactionReceipts().size())
+            {
+                notification->callbacks.push_back(p_tx->second->rpcCallback());
+                notification->indexes.push_back(i);
+            }
+            memory += txMemory(*p_tx->second);
+            m_txsQueue.erase(p_tx->second);
+            m_txsHash.erase(p_tx);
+            if (!m_systemTxs.empty())
+                m_systemTxs.erase(_txHashes[i]);
+            removed.push_back(_txHashes[i]);
         }
-        if (removeTrans(block.transactions()[i].sha3(), true, pReceipt) == false)
-            succ = false;
+        m_txsMemory -= memory;
+    }
+    bool succ = removed.size() == _txHashes.size();
+    if (m_journal && !removed.empty())
+        m_journal->remove(removed);
+    if (notification->callbacks.empty())
+        return succ;
+    notification->blockHash = block.blockHeader().hash();
+    notification->blockNumber = block.blockHeader().number();
+    for (auto index : notification->indexes)
+    {
+        notification->transactions.push_back(block.transactions()[index]);
+        notification->receipts.push_back(block.transactionReceipts()[index]);
     }
+    m_pendingNotifications += notification->callbacks.size();
+    m_pendingNotifyBlocks++;
+    auto self = std::weak_ptr<TxPool>(shared_from_this());
+    m_callbackPool.enqueue([self, notification] {
+        auto txPool = self.lock();
+        if (txPool)
+            txPool->notifyReceipts(*notification);
+    });
     return succ;
 }
 
+/// construct the receipts of a block in parallel and call back the clients in the block order
+void TxPool::notifyReceipts(BlockNotification const& _notification)
+{
+    auto start = utcTime();
+    std::vector<LocalisedTransactionReceipt::Ptr> receipts(_notification.callbacks.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, receipts.size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                receipts[i] = constructTransactionReceipt(_notification.transactions[i],
+                    _notification.receipts[i], _notification.blockHash, _notification.blockNumber,
+                    _notification.indexes[i]);
+            }
+        });
+    for (size_t i = 0; i < receipts.size(); i++)
+    {
+        try
+        {
+            _notification.callbacks[i](receipts[i]);
+        }
+        catch (std::exception& e)
+        {
+            TXPOOL_LOG(WARNING) << LOG_DESC("notify receipt failed")
+                                << LOG_KV("hash", receipts[i]->hash().abridged())
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        }
+    }
+    m_pendingNotifications -= receipts.size();
+    m_pendingNotifyBlocks--;
+    m_notifyTimeCost = utcTime() - start;
+    TXPOOL_LOG(DEBUG) << LOG_DESC("notifyReceipts") << LOG_KV("number", _notification.blockNumber)
+                      << LOG_KV("receipts", receipts.size())
+                      << LOG_KV("pendingReceipts", m_pendingNotifications)
+                      << LOG_KV("pendingBlocks", m_pendingNotifyBlocks)
+                      << LOG_KV("timecost", m_notifyTimeCost);
+}
+
 // TODO: drop a block when it has been committed failed
 bool TxPool::handleBadBlock(Block const&)
 {
@@ -392,15 +651,103 @@ bool TxPool::handleBadBlock(Block const&)
 bool TxPool::dropBlockTrans(Block const& block)
 {
     /// update the nonce check related to block chain
-    m_txNonceCheck->updateCache(false);
-    bool ret = dropTransactions(block, true);
+    m_txNonceCheck->updateCache(block);
+    /// the hashes are resolved once, before any lock is taken
+    h256s txHashes;
+    txHashes.reserve(block.transactions().size());
+    for (auto const& tx : block.transactions())
+    {
+        txHashes.push_back(tx.sha3());
+        m_committedTxs->insert(txHashes.back());
+    }
+    m_committedTxs->setNumber(block.blockHeader().number());
+    bool ret = dropTransactions(block, txHashes);
     /// remove the information of known transactions from map
-    removeBlockKnowTrans(block);
+    removeBlockKnowTrans(txHashes);
     /// remove the nonce check related to txpool
     m_commonNonceCheck->delCache(block.transactions());
+    flushJournal();
     return ret;
 }
 
+void TxPool::loadJournal(TxPoolJournal::Ptr _journal)
+{
+    auto records = _journal->load();
+    {
+        WriteGuard l(m_lock);
+        m_journal = _journal;
+    }
+    if (records.empty())
+        return;
+    std::vector<bytesConstRef> txsBytes;
+    for (auto const& record : records)
+        txsBytes.push_back(ref(record.rlp));
+    Transactions txs(records.size());
+    std::vector<ImportResult> results(records.size(), ImportResult::Success);
+    decodeTransactions(txsBytes, txs, results);
+    for (size_t i = 0; i < txs.size(); i++)
+        txs[i].setImportTime(records[i].importTime);
+    /// the expired and the committed transactions fail the nonce and block limit checks
+    importTransactions(txs, results);
+    flushJournal();
+    TXPOOL_LOG(INFO) << LOG_DESC("loadJournal") << LOG_KV("journaled", records.size())
+                     << LOG_KV("imported", std::count(results.begin(), results.end(),
+                                               ImportResult::Success));
+}
+
+void TxPool::loadCommittedTxs(std::string const& _path)
+{
+    m_committedTxsPath = _path;
+    if (!m_committedTxs->load(_path))
+    {
+        TXPOOL_LOG(INFO) << LOG_DESC("loadCommittedTxs: no committed transactions")
+                         << LOG_KV("path", _path);
+        return;
+    }
+    /// the transactions of the blocks committed after the save are refused by the nonce check
+    TXPOOL_LOG(INFO) << LOG_DESC("loadCommittedTxs") << LOG_KV("size", m_committedTxs->size())
+                     << LOG_KV("number", m_committedTxs->number())
+                     << LOG_KV("chainNumber", m_blockChain->number());
+}
+
+void TxPool::saveCommittedTxs()
+{
+    if (m_committedTxsPath.empty())
+        return;
+    try
+    {
+        m_committedTxs->save(m_committedTxsPath);
+    }
+    catch (std::exception& e)
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC("saveCommittedTxs failed")
+                            << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
+void TxPool::flushJournal()
+{
+    if (!m_journal)
+        return;
+    try
+    {
+        /// a journal of mostly removed transactions is rewritten with the pending ones
+        if (m_journal->size() > std::max(c_minJournalCompactSize, uint64_t(4 * m_txsMemory)))
+        {
+            ReadGuard l(m_lock);
+            Transactions pending(m_txsQueue.begin(), m_txsQueue.end());
+            m_journal->compact(pending);
+            return;
+        }
+        m_journal->flush();
+    }
+    catch (std::exception& e)
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC("flushJournal failed")
+                            << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
 /**
  * @brief Get top transactions from the queue
  *
@@ -418,45 +765,92 @@ dev::eth::Transactions TxPool::topTransactions(uint64_t const& _limit)
 Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, bool _updateAvoid)
 {
     uint64_t limit = min(m_limit, _limit);
-    uint64_t txCnt = 0;
     Transactions ret;
     std::vector<dev::h256> invalidBlockLimitTxs;
     std::vector<dev::eth::NonceKeyType> nonceKeyCache;
     {
-        UpgradableGuard l(m_lock);
-        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
-        {
+        /// the sealing cursor and the sender counts belong to the block being sealed
+        std::unique_lock<Mutex> sealingLock(x_sealingCursor, std::defer_lock);
+        if (_updateAvoid)
+            sealingLock.lock();
+        /// @return false if the sender has used its quota of the block
+        auto pack = [&](Transaction const& _tx, bool _system) -> bool {
             /// check block limit and nonce again when obtain transactions
-            if (false == m_txNonceCheck->isBlockLimitOk(*it))
+            if (false == m_txNonceCheck->isBlockLimitOk(_tx))
             {
-                invalidBlockLimitTxs.push_back(it->sha3());
-                nonceKeyCache.push_back(m_commonNonceCheck->generateKey(*it));
-                continue;
+                invalidBlockLimitTxs.push_back(_tx.sha3());
+                nonceKeyCache.push_back(m_commonNonceCheck->generateKey(_tx));
+                return true;
             }
-            if (!_avoid.count(it->sha3()))
+            if (_avoid.count(_tx.sha3()))
+                return true;
+            if (_updateAvoid && !_system && m_maxTxsPerSender > 0)
             {
-                ret.push_back(*it);
-                txCnt++;
-                if (_updateAvoid)
-                    _avoid.insert(it->sha3());
+                auto& packed = m_sealingSenders[_tx.sender()];
+                if (packed >= m_maxTxsPerSender)
+                    return false;
+                packed++;
             }
+            ret.push_back(_tx);
+            if (_updateAvoid)
+                _avoid.insert(_tx.sha3());
+            return true;
+        };
+
+        /// shared with the imports, they wait only to insert
+        ReadGuard l(m_lock);
+        /// the system transactions go first, they are few
+        std::vector<TransactionQueue::iterator> systemTxs;
+        for (auto const& txHash : m_systemTxs)
+        {
+            systemTxs.push_back(m_txsHash.find(txHash)->second);
         }
-        if (invalidBlockLimitTxs.size() > 0)
+        std::sort(systemTxs.begin(), systemTxs.end(),
+            [](TransactionQueue::iterator const& _a, TransactionQueue::iterator const& _b) {
+                return _a->importTime() < _b->importTime();
+            });
+        for (size_t i = 0; ret.size() < limit && i < systemTxs.size(); ++i)
         {
-            UpgradeGuard ul(l);
-            for (auto txHash : invalidBlockLimitTxs)
-            {
-                removeTrans(txHash);
-                m_dropped.insert(txHash);
-            }
+            pack(*systemTxs[i], true);
+        }
+
+        auto it = m_txsQueue.begin();
+        if (_updateAvoid && m_sealingCursor > 0)
+        {
+            /// skip the transactions packed before, the ones imported at the same time as the
+            /// last packed are checked against the avoid set
+            Transaction cursor;
+            cursor.setImportTime(u256(m_sealingCursor.load()));
+            it = m_txsQueue.upper_bound(cursor);
+        }
+        /// the cursor stops at the first transaction deferred to the next block
+        bool deferred = false;
+        for (; ret.size() < limit && it != m_txsQueue.end(); it++)
+        {
+            if (isSystemTransaction(*it))
+                continue;
+            if (!pack(*it, false))
+                deferred = true;
+            if (_updateAvoid && !deferred)
+                m_sealingCursor = static_cast<uint64_t>(it->importTime());
         }
-        /// delete cached invalid nonce
-        if (nonceKeyCache.size() > 0)
+    }
+    if (invalidBlockLimitTxs.size() > 0)
+    {
+        /// removeTrans skips the transactions removed since they were read
+        WriteGuard l(m_lock);
+        for (auto txHash : invalidBlockLimitTxs)
         {
-            for (auto key : nonceKeyCache)
-                m_commonNonceCheck->delCache(key);
+            removeTrans(txHash);
+            m_dropped.insert(txHash);
         }
     }
+    /// delete cached invalid nonce
+    if (nonceKeyCache.size() > 0)
+    {
+        for (auto key : nonceKeyCache)
+            m_commonNonceCheck->delCache(key);
+    }
 
     if (invalidBlockLimitTxs.size() > 0)
     {
@@ -506,6 +900,33 @@ Transactions TxPool::pendingList() const
     return ret;
 }
 
+Transactions TxPool::pendingList(h256 const& _after, u256 const& _afterTime, size_t _limit) const
+{
+    ReadGuard l(m_lock);
+    auto it = m_txsQueue.begin();
+    if (_after)
+    {
+        auto last = m_txsHash.find(_after);
+        if (last != m_txsHash.end())
+        {
+            it = std::next(last->second);
+        }
+        else
+        {
+            /// the first imported at _afterTime or later
+            Transaction cursor;
+            cursor.setImportTime(_afterTime);
+            it = m_txsQueue.upper_bound(cursor);
+        }
+    }
+    Transactions ret;
+    for (; it != m_txsQueue.end() && ret.size() < _limit; ++it)
+    {
+        ret.push_back(*it);
+    }
+    return ret;
+}
+
 /// get current transaction num
 size_t TxPool::pendingSize()
 {
@@ -520,24 +941,49 @@ TxPoolStatus TxPool::status() const
     ReadGuard l(m_lock);
     status.current = m_txsQueue.size();
     status.dropped = m_dropped.size();
+    status.memory = m_txsMemory;
+    status.pendingNotifications = m_pendingNotifications;
+    status.notifyTimeCost = m_notifyTimeCost;
+    ReadGuard l_trans(x_transactionKnownBy);
+    status.memory += m_transactionKnownBy.memory();
     return status;
 }
 
+std::vector<size_t> TxPool::fetchTransactions(h256s const& _hashes, Transactions& _txs)
+{
+    _txs.resize(_hashes.size());
+    std::vector<size_t> missed;
+    ReadGuard l(m_lock);
+    for (size_t i = 0; i < _hashes.size(); i++)
+    {
+        auto p_tx = m_txsHash.find(_hashes[i]);
+        if (p_tx == m_txsHash.end())
+            missed.push_back(i);
+        else
+            _txs[i] = *p_tx->second;
+    }
+    return missed;
+}
+
 /// Clear the queue
 void TxPool::clear()
 {
     WriteGuard l(m_lock);
     m_txsQueue.clear();
     m_txsHash.clear();
+    m_systemTxs.clear();
+    m_txsMemory = 0;
     m_dropped.clear();
     WriteGuard l_trans(x_transactionKnownBy);
     m_transactionKnownBy.clear();
+    m_knownByIndex.clear();
 }
 
 /// Set transaction is known by a node
 void TxPool::setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId)
 {
-    m_transactionKnownBy[_txHash].insert(_nodeId);
+    auto index = knownByIndex(_nodeId);
+    m_transactionKnownBy[_txHash].set(index);
 }
 
 /// set transactions is known by a node
@@ -545,19 +991,51 @@ void TxPool::setTransactionsAreKnownBy(
     std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId)
 {
     WriteGuard l(x_transactionKnownBy);
+    auto index = knownByIndex(_nodeId);
     for (auto const& tx_hash : _txHashVec)
     {
-        m_transactionKnownBy[tx_hash].insert(_nodeId);
+        m_transactionKnownBy[tx_hash].set(index);
     }
 }
 
+/// Is the transaction is known by the node
+bool TxPool::isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId)
+{
+    auto index = m_knownByIndex.find(_nodeId);
+    if (index == m_knownByIndex.end())
+        return false;
+    auto p = m_transactionKnownBy.find(_txHash);
+    if (p == m_transactionKnownBy.end())
+        return false;
+    return p->second.test(index->second);
+}
+
 /// Is the transaction is known by someone
 bool TxPool::isTransactionKnownBySomeone(h256 const& _txHash)
 {
     auto p = m_transactionKnownBy.find(_txHash);
     if (p == m_transactionKnownBy.end())
         return false;
-    return !p->second.empty();
+    return p->second.any();
+}
+
+/// the bit of the node in the known-by sets, numbered the first time the node is seen
+size_t TxPool::knownByIndex(h512 const& _nodeId)
+{
+    auto p = m_knownByIndex.find(_nodeId);
+    if (p != m_knownByIndex.end())
+        return p->second;
+    if (m_knownByIndex.size() >= c_maxKnownByNodes)
+    {
+        /// forgetting who knows the transactions only sends them again
+        TXPOOL_LOG(DEBUG) << LOG_DESC("reset the known-by sets: too many nodes")
+                          << LOG_KV("nodes", m_knownByIndex.size());
+        m_knownByIndex.clear();
+        m_transactionKnownBy.clear();
+    }
+    size_t index = m_knownByIndex.size();
+    m_knownByIndex.emplace(_nodeId, index);
+    return index;
 }
 
 // Remove the record of transaction know by some peers
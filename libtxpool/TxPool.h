@@ -22,9 +22,12 @@
  * @date: 2018-09-23
  */
 #pragma once
+#include "CommittedTxFilter.h"
 #include "TransactionNonceCheck.h"
 #include "TxPoolInterface.h"
+#include "TxPoolJournal.h"
 #include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/FixedHashMap.h>
 #include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
@@ -32,6 +35,8 @@
 #include <libethcore/Protocol.h>
 #include <libethcore/Transaction.h>
 #include <libp2p/P2PInterface.h>
+#include <atomic>
+#include <bitset>
 
 using namespace dev::eth;
 using namespace dev::p2p;
@@ -48,6 +53,12 @@ struct TxPoolStatus
 {
     size_t current;
     size_t dropped;
+    /// bytes of the pending transactions and the known-by sets
+    size_t memory;
+    /// receipts of the committed blocks not yet notified to the clients
+    size_t pendingNotifications;
+    /// milliseconds to notify the receipts of the last block
+    uint64_t notifyTimeCost;
 };
 
 class TxPoolNonceManager
@@ -79,10 +90,16 @@ public:
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
         m_txNonceCheck = std::make_shared<TransactionNonceCheck>(m_blockChain);
         m_commonNonceCheck = std::make_shared<CommonTransactionNonceCheck>();
+        /// a generation holds the transactions of a full pool at least
+        m_committedTxs = std::make_shared<CommittedTxFilter>(std::max<uint64_t>(_limit, 100000));
     }
     void setMaxBlockLimit(unsigned const& limit) { m_txNonceCheck->setBlockLimit(limit); }
     unsigned const& maxBlockLimit() { return m_txNonceCheck->maxBlockLimit(); }
-    virtual ~TxPool() { clear(); }
+    virtual ~TxPool()
+    {
+        saveCommittedTxs();
+        clear();
+    }
 
     /**
      * @brief submit a transaction through RPC/web3sdk
@@ -110,32 +127,48 @@ public:
     dev::eth::Transactions topTransactions(uint64_t const& _limit) override;
     dev::eth::Transactions topTransactions(
         uint64_t const& _limit, h256Hash& _avoid, bool _updateAvoid = false) override;
+    void resetSealingCursor() override
+    {
+        Guard l(x_sealingCursor);
+        m_sealingCursor = 0;
+        m_sealingSenders.clear();
+    }
+    /// recover the senders in parallel, then check and insert all under one lock
+    std::vector<ImportResult> batchImport(dev::eth::Transactions& _txs) override;
+    std::vector<ImportResult> batchImport(std::vector<bytesConstRef> const& _txsBytes) override;
     dev::eth::Transactions topTransactionsCondition(
         uint64_t const& _limit, dev::h512 const& _nodeId) override;
 
     /// get all transactions(maybe blocksync module need this interface)
     dev::eth::Transactions pendingList() const override;
+    /// only the page is copied under the lock
+    dev::eth::Transactions pendingList(
+        h256 const& _after, u256 const& _afterTime, size_t _limit) const override;
     /// get current transaction num
     size_t pendingSize() override;
 
     /// @returns the status of the transaction queue.
     TxPoolStatus status() const override;
+    std::vector<size_t> fetchTransactions(
+        h256s const& _hashes, dev::eth::Transactions& _txs) override;
 
     /// protocol id used when register handler to p2p module
     virtual PROTOCOL_ID const& getProtocolId() const override { return m_protocolId; }
     void setTxPoolLimit(uint64_t const& _limit) { m_limit = _limit; }
+    /// the most bytes of the pending transactions, 0 for no limit
+    void setMemoryLimit(uint64_t const& _memoryLimit) { m_memoryLimit = _memoryLimit; }
+    /// journal the pending transactions to _journal, and import the ones left in it
+    void loadJournal(TxPoolJournal::Ptr _journal);
+    /// load the hashes of the recently committed transactions from _path, saved there on exit
+    void loadCommittedTxs(std::string const& _path);
+    /// the most transactions of a sender to seal in a block, 0 for no limit
+    void setMaxTxsPerSender(uint64_t const& _max) { m_maxTxsPerSender = _max; }
 
     /// Set transaction is known by a node
     void setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId) override;
 
     /// Is the transaction is known by the node ?
-    bool isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId) override
-    {
-        auto p = m_transactionKnownBy.find(_txHash);
-        if (p == m_transactionKnownBy.end())
-            return false;
-        return p->second.find(_nodeId) != p->second.end();
-    }
+    bool isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId) override;
     void setTransactionsAreKnownBy(
         std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId) override;
     /// Is the transaction is known by someone
@@ -149,7 +182,8 @@ public:
     bool isFull() override
     {
         // UpgradableGuard l(m_lock);
-        return m_txsQueue.size() >= m_limit;
+        return m_txsQueue.size() >= m_limit ||
+               (m_memoryLimit > 0 && m_txsMemory >= m_memoryLimit);
     }
 
 protected:
@@ -171,18 +205,52 @@ protected:
     /// interface for filter check
     virtual u256 filterCheck(const Transaction&) const { return u256(0); };
     void clear();
-    bool dropTransactions(dev::eth::Block const& block, bool needNotify = false);
-    bool removeBlockKnowTrans(dev::eth::Block const& block);
+    /// _txHashes: the hashes of the transactions of block
+    bool dropTransactions(dev::eth::Block const& block, h256s const& _txHashes);
+    bool removeBlockKnowTrans(h256s const& _txHashes);
 
 private:
+    /// the receipts of a committed block waiting for their callbacks
+    struct BlockNotification
+    {
+        h256 blockHash;
+        dev::eth::BlockNumber blockNumber;
+        std::vector<dev::eth::RPCCallback> callbacks;
+        std::vector<unsigned> indexes;
+        dev::eth::Transactions transactions;
+        dev::eth::TransactionReceipts receipts;
+    };
     dev::eth::LocalisedTransactionReceipt::Ptr constructTransactionReceipt(
         dev::eth::Transaction const& tx, dev::eth::TransactionReceipt const& receipt,
-        dev::eth::Block const& block, unsigned index);
+        h256 const& blockHash, dev::eth::BlockNumber blockNumber, unsigned index);
+    void notifyReceipts(BlockNotification const& _notification);
 
     bool removeTrans(h256 const& _txHash, bool needTriggerCallback = false,
         dev::eth::LocalisedTransactionReceipt::Ptr pReceipt = nullptr);
     bool insert(dev::eth::Transaction const& _tx);
+    /// import the transactions whose result is still Success
+    void importTransactions(dev::eth::Transactions& _txs, std::vector<ImportResult>& _results);
+    void notifyTxPoolIsFull(dev::eth::Transaction const& _tx);
+    /// decode the transactions in parallel, the malformed ones are marked in _results
+    void decodeTransactions(std::vector<bytesConstRef> const& _txsBytes,
+        dev::eth::Transactions& _txs, std::vector<ImportResult>& _results);
+    /// write the journal, and rewrite it once it is mostly removed transactions
+    void flushJournal();
+    void saveCommittedTxs();
+    /// count and memory limits, _tx is the transaction to import
+    bool isFull(dev::eth::Transaction const& _tx) const
+    {
+        return m_txsQueue.size() >= m_limit ||
+               (m_memoryLimit > 0 && m_txsMemory + txMemory(_tx) > m_memoryLimit);
+    }
+    bool evictForMemory(dev::eth::Transaction const& _tx);
+    static size_t txMemory(dev::eth::Transaction const& _tx)
+    {
+        /// the nodes of the queue and the hash map
+        return _tx.capacity() + sizeof(h256) + 8 * sizeof(void*);
+    }
     void removeTransactionKnowBy(h256 const& _txHash);
+    size_t knownByIndex(h512 const& _nodeId);
     bool inline txPoolNonceCheck(dev::eth::Transaction const& tx)
     {
         if (!m_commonNonceCheck->isNonceOk(tx, true))
@@ -202,6 +270,10 @@ private:
     std::shared_ptr<CommonTransactionNonceCheck> m_commonNonceCheck;
     /// Max number of pending transactions
     uint64_t m_limit;
+    /// Max bytes of the pending transactions
+    uint64_t m_memoryLimit = 0;
+    /// bytes of the pending transactions and their entries in the queue and the hash map
+    std::atomic<uint64_t> m_txsMemory = {0};
     mutable SharedMutex m_lock;
     /// protocolId
     PROTOCOL_ID m_protocolId;
@@ -209,14 +281,34 @@ private:
     /// transaction queue
     using TransactionQueue = std::set<dev::eth::Transaction, transactionCompare>;
     TransactionQueue m_txsQueue;
-    std::unordered_map<h256, TransactionQueue::iterator> m_txsHash;
+    FixedHashMap<h256, TransactionQueue::iterator> m_txsHash;
+    /// the hashes of the system transactions, sealed before the others
+    h256Hash m_systemTxs;
+    /// import time of the last transaction scanned by topTransactions with _updateAvoid, the
+    /// transactions imported before are in the avoid set of the sealer or dropped
+    std::atomic<uint64_t> m_sealingCursor = {0};
+    /// transactions of each sender packed into the block being sealed
+    std::unordered_map<Address, uint64_t> m_sealingSenders;
+    uint64_t m_maxTxsPerSender = 0;
+    Mutex x_sealingCursor;
     /// hash of dropped transactions
-    h256Hash m_dropped;
+    FixedHashSet<h256> m_dropped;
+    /// hash of the recently committed transactions
+    CommittedTxFilter::Ptr m_committedTxs;
+    std::string m_committedTxsPath;
     /// Transaction is known by some peers
     mutable SharedMutex x_transactionKnownBy;
-    std::unordered_map<h256, std::unordered_set<h512>> m_transactionKnownBy;
+    /// a bit per node instead of the node ids, the nodes are numbered in m_knownByIndex
+    static const size_t c_maxKnownByNodes = 256;
+    FixedHashMap<h256, std::bitset<c_maxKnownByNodes>> m_transactionKnownBy;
+    std::unordered_map<h512, size_t> m_knownByIndex;
 
     dev::ThreadPool m_callbackPool;
+    TxPoolJournal::Ptr m_journal;
+    /// backpressure of the receipt notifications
+    std::atomic<size_t> m_pendingNotifications = {0};
+    std::atomic<size_t> m_pendingNotifyBlocks = {0};
+    std::atomic<uint64_t> m_notifyTimeCost = {0};
 };
 }  // namespace txpool
 }  // namespace dev
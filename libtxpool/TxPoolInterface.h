@@ -26,6 +26,7 @@
 #include <libethcore/Common.h>
 #include <libethcore/Protocol.h>
 #include <libethcore/Transaction.h>
+#include <algorithm>
 namespace dev
 {
 namespace txpool
@@ -55,6 +56,9 @@ public:
     virtual dev::eth::Transactions topTransactions(uint64_t const& _limit) = 0;
     virtual dev::eth::Transactions topTransactions(
         uint64_t const& _limit, h256Hash& _avoid, bool _updateAvoid = false) = 0;
+    /// topTransactions with _updateAvoid resumes after the last transaction it returned, start
+    /// from the beginning of the queue again when the avoid set has been reset
+    virtual void resetSealingCursor() {}
 
     /// param 1: the transaction limit
     /// param 2: the node id
@@ -65,6 +69,27 @@ public:
 
     /// get all current transactions(maybe blocksync module need this interface)
     virtual dev::eth::Transactions pendingList() const = 0;
+    /// up to _limit transactions in the import order after _after, imported at _afterTime, or
+    /// from the first with a zero _after; if _after has left the queue meanwhile, the page
+    /// starts at the transactions imported in the same millisecond, which may repeat
+    virtual dev::eth::Transactions pendingList(
+        h256 const& _after, u256 const& _afterTime, size_t _limit) const
+    {
+        auto all = pendingList();
+        auto it = all.begin();
+        if (_after)
+        {
+            auto last = std::find_if(all.begin(), all.end(),
+                [&](dev::eth::Transaction const& _tx) { return _tx.sha3() == _after; });
+            it = (last != all.end()) ? last + 1 :
+                                       std::find_if(all.begin(), all.end(),
+                                           [&](dev::eth::Transaction const& _tx) {
+                                               return _tx.importTime() >= _afterTime;
+                                           });
+        }
+        size_t size = std::min<size_t>(_limit, all.end() - it);
+        return dev::eth::Transactions(it, it + size);
+    }
     /// get current transaction num
     virtual size_t pendingSize() = 0;
 
@@ -86,9 +111,40 @@ public:
         dev::eth::Transaction& _tx, dev::eth::IfDropped _ik = dev::eth::IfDropped::Ignore) = 0;
     virtual dev::eth::ImportResult import(
         bytesConstRef _txBytes, dev::eth::IfDropped _ik = dev::eth::IfDropped::Ignore) = 0;
+    /// import a batch of transactions, the results are in the order of the transactions
+    virtual std::vector<dev::eth::ImportResult> batchImport(dev::eth::Transactions& _txs)
+    {
+        std::vector<dev::eth::ImportResult> results;
+        for (auto& tx : _txs)
+        {
+            results.push_back(import(tx));
+        }
+        return results;
+    }
+    virtual std::vector<dev::eth::ImportResult> batchImport(
+        std::vector<bytesConstRef> const& _txsBytes)
+    {
+        std::vector<dev::eth::ImportResult> results;
+        for (auto const& txBytes : _txsBytes)
+        {
+            results.push_back(import(txBytes));
+        }
+        return results;
+    }
     /// @returns the status of the transaction queue.
     virtual TxPoolStatus status() const = 0;
 
+    /// fill _txs with the transactions of _hashes in the queue
+    /// @returns the indexes of the hashes not in the queue
+    virtual std::vector<size_t> fetchTransactions(h256s const& _hashes, dev::eth::Transactions& _txs)
+    {
+        _txs.resize(_hashes.size());
+        std::vector<size_t> missed(_hashes.size());
+        for (size_t i = 0; i < _hashes.size(); i++)
+            missed[i] = i;
+        return missed;
+    }
+
     /// protocol id used when register handler to p2p module
     virtual PROTOCOL_ID const& getProtocolId() const = 0;
 
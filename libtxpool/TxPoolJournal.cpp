@@ -0,0 +1,285 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : journal of the pending transactions
+ * @file: TxPoolJournal.cpp
+ */
+#include "TxPoolJournal.h"
+#include "TxPool.h"
+#include <fcntl.h>
+#include <libdevcore/RLP.h>
+#include <libethcore/Exceptions.h>
+#include <unistd.h>
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+
+// length and crc32 of the payload, both little endian
+static const size_t c_recordHeaderSize = 8;
+// the buffered records are written once they exceed this size
+static const size_t c_maxBufferSize = 1024 * 1024;
+
+static uint32_t crc32(bytesConstRef data)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    return crc.checksum();
+}
+
+static void putUint32(byte* out, uint32_t value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        out[i] = (byte)(value >> (i * 8));
+    }
+}
+
+static uint32_t getUint32(const byte* in)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        value |= (uint32_t)in[i] << (i * 8);
+    }
+    return value;
+}
+
+static bytes encodeImport(Transaction const& tx)
+{
+    RLPStream stream(3);
+    stream << 0u;
+    stream.appendRaw(tx.rlp());
+    stream << tx.importTime();
+    return stream.out();
+}
+
+static void putRecord(bytes& out, bytes const& payload)
+{
+    auto offset = out.size();
+    out.resize(offset + c_recordHeaderSize);
+    putUint32(&out[offset], (uint32_t)payload.size());
+    putUint32(&out[offset + 4], crc32(ref(payload)));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+static int openJournal(std::string const& path, int flags)
+{
+    auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | flags, 0644);
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            TxPoolJournalFailed() << errinfo_comment("Open txpool journal failed: " + path));
+    }
+    return fd;
+}
+
+TxPoolJournal::TxPoolJournal(std::string const& _path) : m_path(_path) {}
+
+TxPoolJournal::~TxPoolJournal()
+{
+    try
+    {
+        flush();
+    }
+    catch (std::exception& e)
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC("flush txpool journal failed")
+                            << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+}
+
+std::vector<TxPoolJournal::Record> TxPoolJournal::load()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ifstream in(m_path, std::ios::binary);
+    bytes data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::vector<Record> records;
+    std::unordered_map<h256, size_t> indexes;
+    size_t offset = 0;
+    size_t removed = 0;
+    while (data.size() - offset >= c_recordHeaderSize)
+    {
+        auto size = getUint32(&data[offset]);
+        auto crc = getUint32(&data[offset + 4]);
+        if (data.size() - offset - c_recordHeaderSize < size)
+        {
+            break;
+        }
+        auto payload = bytesConstRef(&data[offset + c_recordHeaderSize], size);
+        if (crc32(payload) != crc)
+        {
+            break;
+        }
+        offset += c_recordHeaderSize + size;
+
+        RLP rlp(payload);
+        if (rlp[0].toInt<unsigned>() == 0)
+        {
+            auto txRLP = rlp[1].toBytesConstRef();
+            indexes[sha3(txRLP)] = records.size();
+            records.push_back(Record{txRLP.toBytes(), rlp[2].toInt<u256>()});
+        }
+        else
+        {
+            auto it = indexes.find(rlp[1].toHash<h256>());
+            if (it != indexes.end())
+            {
+                records[it->second].rlp.clear();
+                indexes.erase(it);
+                removed++;
+            }
+        }
+    }
+    if (offset < data.size())
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC("cut off torn txpool journal record")
+                            << LOG_KV("path", m_path) << LOG_KV("offset", offset);
+    }
+    records.erase(std::remove_if(records.begin(), records.end(),
+                      [](Record const& _record) { return _record.rlp.empty(); }),
+        records.end());
+
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+    m_fd = openJournal(m_path, O_TRUNC);
+    m_buffer.clear();
+    m_size = 0;
+    TXPOOL_LOG(INFO) << LOG_DESC("load txpool journal") << LOG_KV("path", m_path)
+                     << LOG_KV("transactions", records.size()) << LOG_KV("removed", removed);
+    return records;
+}
+
+void TxPoolJournal::append(Transaction const& _tx)
+{
+    appendRecord(encodeImport(_tx));
+}
+
+void TxPoolJournal::remove(h256 const& _txHash)
+{
+    RLPStream stream(2);
+    stream << 1u << _txHash;
+    appendRecord(stream.out());
+}
+
+void TxPoolJournal::remove(h256s const& _txHashes)
+{
+    bytes records;
+    for (auto const& hash : _txHashes)
+    {
+        RLPStream stream(2);
+        stream << 1u << hash;
+        putRecord(records, stream.out());
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffer.insert(m_buffer.end(), records.begin(), records.end());
+    if (m_buffer.size() >= c_maxBufferSize)
+    {
+        write(m_buffer);
+        m_buffer.clear();
+    }
+}
+
+void TxPoolJournal::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    write(m_buffer);
+    m_buffer.clear();
+}
+
+void TxPoolJournal::compact(Transactions const& _txs)
+{
+    bytes records;
+    for (auto const& tx : _txs)
+    {
+        putRecord(records, encodeImport(tx));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // the new journal replaces the old one at once, a crash leaves either of them
+    auto compactPath = m_path + ".compact";
+    auto fd = openJournal(compactPath, O_TRUNC);
+    std::swap(fd, m_fd);
+    write(records);
+    if (std::rename(compactPath.c_str(), m_path.c_str()) != 0)
+    {
+        std::swap(fd, m_fd);
+        ::close(fd);
+        BOOST_THROW_EXCEPTION(
+            TxPoolJournalFailed() << errinfo_comment("Compact txpool journal failed: " + m_path));
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    m_buffer.clear();
+    m_size = records.size();
+}
+
+uint64_t TxPoolJournal::size()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size + m_buffer.size();
+}
+
+void TxPoolJournal::appendRecord(bytes const& _payload)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    putRecord(m_buffer, _payload);
+    if (m_buffer.size() >= c_maxBufferSize)
+    {
+        write(m_buffer);
+        m_buffer.clear();
+    }
+}
+
+void TxPoolJournal::write(bytes const& _data)
+{
+    if (_data.empty())
+    {
+        return;
+    }
+    if (m_fd < 0)
+    {
+        m_fd = openJournal(m_path, 0);
+    }
+    size_t offset = 0;
+    while (offset < _data.size())
+    {
+        auto size = ::write(m_fd, _data.data() + offset, _data.size() - offset);
+        if (size < 0)
+        {
+            BOOST_THROW_EXCEPTION(
+                TxPoolJournalFailed() << errinfo_comment("Write txpool journal failed: " + m_path));
+        }
+        offset += size;
+    }
+    m_size += _data.size();
+}
@@ -0,0 +1,74 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : journal of the pending transactions
+ * @file: TxPoolJournal.h
+ */
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <libethcore/Transaction.h>
+#include <mutex>
+
+namespace dev
+{
+namespace txpool
+{
+/// Journal of the pending transactions, a restarted node reloads its backlog from it. Records are
+/// appended to a single file, each is its length, its crc32 and the rlp of [0, transaction,
+/// import time] for an imported transaction or [1, hash] for a removed one. Records are buffered
+/// until flush, a crash loses the records after the last flush and the clients resubmit them.
+class TxPoolJournal
+{
+public:
+    typedef std::shared_ptr<TxPoolJournal> Ptr;
+
+    struct Record
+    {
+        bytes rlp;
+        u256 importTime;
+    };
+
+    TxPoolJournal(std::string const& _path);
+    virtual ~TxPoolJournal();
+
+    /// @returns the transactions not removed in the order they were imported, a torn record ends
+    /// the journal. The journal is emptied, the transactions imported again are appended again.
+    virtual std::vector<Record> load();
+    virtual void append(dev::eth::Transaction const& _tx);
+    virtual void remove(h256 const& _txHash);
+    /// the records are encoded before locking
+    virtual void remove(h256s const& _txHashes);
+    /// write the buffered records
+    virtual void flush();
+    /// rewrite the journal with the given transactions only
+    virtual void compact(dev::eth::Transactions const& _txs);
+    /// bytes of the journal, written and buffered
+    uint64_t size();
+
+private:
+    void appendRecord(bytes const& _payload);
+    void write(bytes const& _data);
+
+    std::string m_path;
+    std::mutex m_mutex;
+    int m_fd = -1;
+    bytes m_buffer;
+    uint64_t m_size = 0;
+};
+}  // namespace txpool
+}  // namespace dev
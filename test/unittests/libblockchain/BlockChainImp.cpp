@@ -279,6 +279,20 @@ BOOST_AUTO_TEST_CASE(getBlockRLPByNumber)
     BOOST_CHECK(bptr->rlp() == *bRLPptr);
 }
 
+BOOST_AUTO_TEST_CASE(getBlockNoReceipts)
+{
+    auto block = m_blockChainImp->getBlockByHashNoReceipts(h256(c_commonHashPrefix));
+    auto full = m_blockChainImp->getBlockByHash(h256(c_commonHashPrefix));
+    BOOST_CHECK(block->header().hash() == full->header().hash());
+    BOOST_CHECK_EQUAL(block->transactions().size(), full->transactions().size());
+    for (size_t i = 0; i < block->transactions().size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(block->transactions()[i].sha3(), full->transactions()[i].sha3());
+    }
+    BOOST_CHECK(m_blockChainImp->getBlockByNumberNoReceipts(m_blockChainImp->number() + 1) ==
+                nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(getLocalisedTxByHash)
 {
     Transaction tx = m_blockChainImp->getLocalisedTxByHash(h256(c_commonHashPrefix));
@@ -304,6 +318,10 @@ BOOST_AUTO_TEST_CASE(getLocalisedTxReceiptByHash)
         m_blockChainImp->getLocalisedTxReceiptByHash(h256(c_commonHashPrefix));
 
     BOOST_CHECK_EQUAL(localisedTxReceipt.hash(), h256(c_commonHashPrefix));
+    // only the header, the transaction and the receipt are decoded from the stored block
+    BOOST_CHECK_EQUAL(localisedTxReceipt.blockHash(), m_fakeBlock->getBlock().headerHash());
+    BOOST_CHECK_EQUAL(localisedTxReceipt.blockNumber(), 0);
+    BOOST_CHECK_EQUAL(localisedTxReceipt.from(), m_fakeBlock->m_transaction[0].from());
 }
 
 BOOST_AUTO_TEST_CASE(commitBlock)
@@ -336,6 +354,31 @@ BOOST_AUTO_TEST_CASE(commitBlock)
     BOOST_CHECK_EQUAL(m_blockChainImp->totalTransactionCount().second, 2);
 }
 
+BOOST_AUTO_TEST_CASE(binaryBlockTables)
+{
+    auto version = g_BCOSConfig.version();
+    auto supportedVersion = g_BCOSConfig.supportedVersion();
+    g_BCOSConfig.setSupportedVersion("2.3.0", V2_3_0);
+
+    auto fakeBlock = std::make_shared<FakeBlock>(10);
+    auto& block = fakeBlock->getBlock();
+    block.header().setNumber(m_blockChainImp->number() + 1);
+    block.header().setParentHash(m_blockChainImp->numberHash(m_blockChainImp->number()));
+    BOOST_CHECK(m_blockChainImp->commitBlock(block, m_executiveContext) == CommitResult::OK);
+
+    /// the block is stored as raw bytes and read back by a chain without it in the cache
+    bytes blockRLP;
+    block.encode(blockRLP);
+    auto hash = block.blockHeader().hash();
+    BOOST_CHECK(m_mockTable->m_fakeStorage[SYS_HASH_2_BLOCK][hash.hex()]->getField(SYS_VALUE) ==
+                std::string(blockRLP.begin(), blockRLP.end()));
+    auto blockChain = std::make_shared<MockBlockChainImp>();
+    blockChain->setMemoryTableFactory(mockMemoryTableFactory);
+    BOOST_CHECK(*blockChain->getBlockRLPByHash(hash) == blockRLP);
+
+    g_BCOSConfig.setSupportedVersion(supportedVersion, version);
+}
+
 BOOST_AUTO_TEST_CASE(query)
 {
     dev::h512s sealerList = m_blockChainImp->sealerList();
@@ -344,6 +387,34 @@ BOOST_AUTO_TEST_CASE(query)
     BOOST_CHECK_EQUAL(observerList.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(blockCache)
+{
+    std::vector<std::shared_ptr<FakeBlock>> blocks;
+    for (uint64_t i = 1; i <= 3; ++i)
+    {
+        blocks.push_back(std::make_shared<FakeBlock>(5, KeyPair::create().secret(), i));
+    }
+    // room for two of the blocks only
+    auto blockRLP = blocks[0]->getBlock().rlpP();
+    BlockCache cache(5 * blockRLP->size());
+    cache.add(blocks[0]->getBlock(), blockRLP);
+    cache.add(blocks[1]->getBlock());
+
+    auto entry = cache.get(int64_t(1));
+    BOOST_CHECK(entry.rlp == blockRLP);
+    BOOST_CHECK_EQUAL(entry.block->headerHash(), blocks[0]->getBlock().headerHash());
+    entry = cache.get(blocks[1]->getBlock().headerHash());
+    BOOST_CHECK(*entry.rlp == blocks[1]->getBlock().rlp());
+    BOOST_CHECK_EQUAL(cache.hits(), 2);
+
+    cache.add(blocks[2]->getBlock());
+    BOOST_CHECK(!cache.get(int64_t(1)).block);
+    BOOST_CHECK(!cache.get(blocks[0]->getBlock().headerHash()).block);
+    BOOST_CHECK(cache.get(int64_t(3)).block);
+    BOOST_CHECK_EQUAL(cache.misses(), 2);
+    BOOST_CHECK_LE(cache.cachedBytes(), 5 * blockRLP->size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
@@ -0,0 +1,114 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+/**
+ * @brief
+ *
+ * @file BlockStore.cpp
+ */
+
+#include <libblockchain/BlockStore.h>
+#include <libdevcore/FixedHash.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace dev;
+using namespace dev::blockchain;
+
+namespace test_BlockStore
+{
+struct BlockStoreFixture
+{
+    BlockStoreFixture()
+    {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+                   .string();
+    }
+    ~BlockStoreFixture() { boost::filesystem::remove_all(path); }
+
+    bytes blockRLP(int64_t num) { return bytes(100 + num, (byte)num); }
+
+    std::string path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(BlockStoreTest, BlockStoreFixture)
+
+BOOST_AUTO_TEST_CASE(appendAndGet)
+{
+    auto store = std::make_shared<BlockStore>(path, 4);
+    store->open();
+    BOOST_CHECK_EQUAL(store->number(), -1);
+    for (int64_t num = 1; num <= 10; ++num)
+    {
+        auto rlp = blockRLP(num);
+        store->append(num, h256(num), ref(rlp));
+    }
+    /// not after the last block
+    auto rlp = blockRLP(20);
+    store->append(5, h256(20), ref(rlp));
+    store->waitSealed();
+
+    BOOST_CHECK_EQUAL(store->number(), 10);
+    BOOST_CHECK_EQUAL(store->segments(), 3);
+    BOOST_CHECK_EQUAL(store->sealedSegments(), 2);
+    for (int64_t num = 1; num <= 10; ++num)
+    {
+        BOOST_CHECK(*store->get(num) == blockRLP(num));
+        BOOST_CHECK(*store->get(h256(num)) == blockRLP(num));
+    }
+    BOOST_CHECK(!store->get(0));
+    BOOST_CHECK(!store->get(11));
+    BOOST_CHECK(!store->get(h256(20)));
+}
+
+BOOST_AUTO_TEST_CASE(reopen)
+{
+    {
+        auto store = std::make_shared<BlockStore>(path, 4);
+        store->open();
+        for (int64_t num = 0; num <= 5; ++num)
+        {
+            auto rlp = blockRLP(num);
+            store->append(num, h256(num), ref(rlp));
+        }
+    }
+    /// a torn block at the end of the segment appended
+    {
+        std::ofstream index(path + "/00000000000000000004.index", std::ios::app);
+        index << "torn";
+    }
+
+    auto store = std::make_shared<BlockStore>(path, 4);
+    store->open();
+    BOOST_CHECK_EQUAL(store->number(), 5);
+    BOOST_CHECK_EQUAL(store->sealedSegments(), 1);
+    BOOST_CHECK(*store->get(3) == blockRLP(3));
+    BOOST_CHECK(*store->get(h256(5)) == blockRLP(5));
+
+    /// the blocks skipped are missing
+    auto rlp = blockRLP(9);
+    store->append(9, h256(9), ref(rlp));
+    store->waitSealed();
+    BOOST_CHECK_EQUAL(store->sealedSegments(), 2);
+    BOOST_CHECK(!store->get(6));
+    BOOST_CHECK(*store->get(5) == blockRLP(5));
+    BOOST_CHECK(*store->get(9) == blockRLP(9));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_BlockStore
@@ -23,6 +23,8 @@
 #include <leveldb/db.h>
 #include <libblockchain/BlockChainImp.h>
 #include <libblockverifier/BlockVerifier.h>
+#include <libdevcore/BasicLevelDB.h>
+#include <libdevcore/LevelDB.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/ABI.h>
 #include <libethcore/PrecompiledContract.h>
@@ -32,10 +34,15 @@
 #include <libledger/DBInitializer.h>
 #include <libledger/LedgerManager.h>
 #include <libmptstate/MPTStateFactory.h>
+#include <libstorage/CachedStorage.h>
 #include <libstorage/LevelDBStorage.h>
+#include <libstorage/LevelDBStorage2.h>
+#include <libstorage/MemoryTableFactoryFactory2.h>
+#include <libstoragestate/StorageStateFactory.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <test/unittests/libethcore/FakeBlock.h>
 #include <unistd.h>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <chrono>
 #include <ctime>
@@ -51,6 +58,7 @@ using namespace dev::blockchain;
 using namespace dev::storage;
 using namespace dev::mptstate;
 using namespace dev::executive;
+using namespace dev::storagestate;
 
 namespace dev
 {
@@ -220,6 +228,115 @@ public:
     }
 };
 
+/// a chain whose state is in the tables of MemoryTableFactory2, which the optimistic execution
+/// needs, the transactions to the tables have no parallel tags
+class FakeVerifierWithTables
+{
+public:
+    FakeVerifierWithTables(bool _enablePara, bool _optimistic)
+      : m_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+    {
+        auto levelDB = std::make_shared<LevelDBStorage2>();
+        levelDB->setDB(std::make_shared<dev::db::BasicLevelDB>(
+            dev::db::LevelDB::defaultDBOptions(), m_path.string()));
+        m_storage = std::make_shared<CachedStorage>();
+        m_storage->setBackend(levelDB);
+        m_storage->init();
+        auto tableFactoryFactory = std::make_shared<MemoryTableFactoryFactory2>();
+        tableFactoryFactory->setStorage(m_storage);
+
+        m_blockChain = std::make_shared<BlockChainImp>();
+        m_blockChain->setStateStorage(m_storage);
+        m_blockChain->setTableFactoryFactory(tableFactoryFactory);
+        GenesisBlockParam initParam = {"", dev::h512s(), dev::h512s(), "consensusType",
+            "storageType", "stateType", 5000, 300000000, 0};
+        BOOST_CHECK(m_blockChain->checkAndBuildGenesisBlock(initParam));
+
+        auto executiveContextFactory = std::make_shared<ExecutiveContextFactory>();
+        executiveContextFactory->setStateStorage(m_storage);
+        executiveContextFactory->setStateFactory(std::make_shared<StorageStateFactory>(u256(0x0)));
+        executiveContextFactory->setTableFactoryFactory(tableFactoryFactory);
+
+        m_blockVerifier = std::make_shared<BlockVerifier>(_enablePara);
+        m_blockVerifier->setExecutiveContextFactory(executiveContextFactory);
+        m_blockVerifier->setOptimisticExecution(_optimistic);
+        m_blockVerifier->setNumberHash(
+            boost::bind(&BlockChainImp::numberHash, m_blockChain, _1));
+    }
+
+    ~FakeVerifierWithTables()
+    {
+        m_storage->stop();
+        boost::filesystem::remove_all(m_path);
+    }
+
+    static Transaction tableTx(Address const& _dest, bytes const& _data, size_t _nonce)
+    {
+        Transaction tx(u256(0), u256(0), u256(10000000), _dest, _data, u256(_nonce));
+        tx.setBlockLimit(250);
+        tx.forceSender(Address(0x2333));
+        return tx;
+    }
+
+    static Transaction createTableTx(std::string const& _table, size_t _nonce)
+    {
+        dev::eth::ContractABI abi;
+        return tableTx(Address(0x1001),
+            abi.abiIn("createTable(string,string,string)", _table, std::string("name"),
+                std::string("value")),
+            _nonce);
+    }
+
+    static Transaction insertTx(std::string const& _table, std::string const& _key,
+        std::string const& _value, size_t _nonce)
+    {
+        dev::eth::ContractABI abi;
+        return tableTx(Address(0x1002),
+            abi.abiIn("insert(string,string,string,string)", _table, _key,
+                "{\"name\":\"" + _key + "\",\"value\":\"" + _value + "\"}", std::string("")),
+            _nonce);
+    }
+
+    /// executes and commits a block of _txs on the last block
+    Block executeBlock(Transactions const& _txs)
+    {
+        auto parentBlock = m_blockChain->getBlockByNumber(m_blockChain->number());
+        BlockInfo parentBlockInfo(parentBlock->header().hash(), parentBlock->header().number(),
+            parentBlock->header().stateRoot());
+        Block block;
+        block.header().setNumber(parentBlockInfo.number + 1);
+        block.header().setParentHash(parentBlockInfo.hash);
+        block.setTransactions(_txs);
+        for (auto& tx : block.transactions())
+            tx.sender();
+        block.calTransactionRoot();
+        auto exeCtx = m_blockVerifier->executeBlock(block, parentBlockInfo);
+        m_blockChain->commitBlock(block, exeCtx);
+        return block;
+    }
+
+private:
+    boost::filesystem::path m_path;
+    CachedStorage::Ptr m_storage;
+    std::shared_ptr<BlockChainImp> m_blockChain;
+    std::shared_ptr<BlockVerifier> m_blockVerifier;
+};
+
+void checkSameExecution(Block const& _serial, Block const& _optimistic)
+{
+    BOOST_CHECK_EQUAL(
+        _serial.blockHeader().stateRoot(), _optimistic.blockHeader().stateRoot());
+    BOOST_CHECK_EQUAL(
+        _serial.blockHeader().receiptsRoot(), _optimistic.blockHeader().receiptsRoot());
+    BOOST_REQUIRE_EQUAL(
+        _serial.transactionReceipts().size(), _optimistic.transactionReceipts().size());
+    for (size_t i = 0; i < _serial.transactionReceipts().size(); ++i)
+    {
+        BOOST_CHECK(
+            _serial.transactionReceipts()[i].rlp() == _optimistic.transactionReceipts()[i].rlp());
+    }
+}
+
 class BlockVerifierFixture : public TestOutputHelperFixture
 {
 public:
@@ -245,6 +362,58 @@ BOOST_AUTO_TEST_CASE(executeBlockTest)
 
 BOOST_AUTO_TEST_CASE(executeTransactionTest) {}
 
+BOOST_AUTO_TEST_CASE(optimisticExecuteBlockTest)
+{
+    FakeVerifierWithTables serialExe(false, false);
+    FakeVerifierWithTables optimisticExe(true, true);
+
+    Transactions createTxs{FakeVerifierWithTables::createTableTx("t_opt", 0)};
+    checkSameExecution(serialExe.executeBlock(createTxs), optimisticExe.executeBlock(createTxs));
+
+    // the inserts of a key depend on each other, the keys are independent
+    Transactions insertTxs;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        insertTxs.push_back(FakeVerifierWithTables::insertTx(
+            "t_opt", "k" + to_string(i % 4), "v" + to_string(i), i));
+    }
+    auto serialBlock = serialExe.executeBlock(insertTxs);
+    auto optimisticBlock = optimisticExe.executeBlock(insertTxs);
+    checkSameExecution(serialBlock, optimisticBlock);
+    for (auto& receipt : optimisticBlock.transactionReceipts())
+    {
+        u256 inserted = 0;
+        dev::eth::ContractABI abi;
+        abi.abiOut(bytesConstRef(&receipt.outputBytes()), inserted);
+        BOOST_CHECK_EQUAL(inserted, u256(1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(optimisticMispredictTest)
+{
+    FakeVerifierWithTables serialExe(false, false);
+    FakeVerifierWithTables optimisticExe(true, true);
+
+    // on the parent state the inserts find no table, executed after the transaction creating it
+    // they access its rows, out of their speculative execution, and the block is executed again
+    // in serial
+    Transactions txs{FakeVerifierWithTables::createTableTx("t_new", 0),
+        FakeVerifierWithTables::insertTx("t_new", "k0", "v0", 1),
+        FakeVerifierWithTables::insertTx("t_new", "k1", "v1", 2),
+        FakeVerifierWithTables::insertTx("t_new", "k0", "v2", 3)};
+    auto serialBlock = serialExe.executeBlock(txs);
+    auto optimisticBlock = optimisticExe.executeBlock(txs);
+    checkSameExecution(serialBlock, optimisticBlock);
+    for (size_t i = 1; i < txs.size(); ++i)
+    {
+        u256 inserted = 0;
+        dev::eth::ContractABI abi;
+        auto const& output = optimisticBlock.transactionReceipts()[i].outputBytes();
+        abi.abiOut(bytesConstRef(&output), inserted);
+        BOOST_CHECK_EQUAL(inserted, u256(1));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
@@ -21,6 +21,7 @@
  */
 
 #include <libblockverifier/DAG.h>
+#include <libblockverifier/DAGScheduler.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
@@ -172,6 +173,80 @@ BOOST_AUTO_TEST_CASE(DAGPopConsumeTest)
     BOOST_CHECK_EQUAL(topSet.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(DAGLevelTest)
+{
+    DAG dag;
+    dag.init(9);
+    dag.addEdge(0, 1);
+    dag.addEdge(1, 2);
+    dag.addEdge(4, 5);
+    dag.addEdge(2, 4);
+    dag.addEdge(3, 4);
+    dag.addEdge(0, 3);
+    dag.addEdge(6, 7);
+    dag.generate();
+
+    // levels: {0, 6, 8}, {1, 3, 7}, {2}, {4}, {5}
+    BOOST_CHECK_EQUAL(dag.roots().size(), 3);
+    BOOST_CHECK_EQUAL(dag.width(), 3);
+    BOOST_CHECK_EQUAL(dag.criticalPath(), 5);
+    BOOST_CHECK(dag.levelWidths() == IDs({3, 3, 1, 1, 1}));
+    BOOST_CHECK(dag.longestPath() == IDs({0, 1, 2, 4, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(DAGSchedulerTest)
+{
+    ID size = 1000;
+    DAG dag;
+    dag.init(size);
+    std::vector<std::pair<ID, ID>> edges;
+    for (ID id = 1; id < size; ++id)
+    {
+        if (id % 7 == 0)
+            edges.emplace_back(id - 7 + id % 3, id);
+        if (id % 5 == 0)
+            edges.emplace_back(id - 1, id);
+    }
+    for (auto& edge : edges)
+        dag.addEdge(edge.first, edge.second);
+    dag.generate();
+
+    std::vector<std::atomic<int>> runs(size);
+    std::vector<ID> order(size);
+    std::atomic<ID> sequence(0);
+    for (auto& run : runs)
+        run = 0;
+
+    DAGScheduler scheduler(4);
+    auto stats = scheduler.run(dag, [&](ID _id) {
+        ++runs[_id];
+        order[_id] = sequence++;
+    });
+
+    BOOST_CHECK_EQUAL(stats.workers, 4);
+    BOOST_CHECK_EQUAL(stats.width, dag.width());
+    for (ID id = 0; id < size; ++id)
+        BOOST_CHECK_EQUAL(runs[id], 1);
+    for (auto& edge : edges)
+        BOOST_CHECK(order[edge.first] < order[edge.second]);
+
+    // the first exception stops the scheduling
+    DAG chain;
+    chain.init(100);
+    for (ID id = 1; id < 100; ++id)
+        chain.addEdge(id - 1, id);
+    chain.generate();
+    ID ran = 0;
+    BOOST_CHECK_THROW(scheduler.run(chain,
+                          [&](ID _id) {
+                              if (_id == 50)
+                                  throw std::runtime_error("execute failed");
+                              ++ran;
+                          }),
+        std::runtime_error);
+    BOOST_CHECK_EQUAL(ran, 50);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
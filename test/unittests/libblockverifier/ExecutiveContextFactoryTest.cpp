@@ -0,0 +1,164 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : unitest for the precompileds and the tx gas limit set by ExecutiveContextFactory
+ */
+
+#include <libblockverifier/ExecutiveContextFactory.h>
+#include <libprecompiled/ParallelConfigPrecompiled.h>
+#include <libprecompiled/SystemConfigPrecompiled.h>
+#include <libstorage/MemoryTableFactoryFactory.h>
+#include <libstoragestate/StorageStateFactory.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <test/unittests/libstorage/MemoryStorage.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::blockverifier;
+using namespace dev::storage;
+using namespace dev::storagestate;
+using namespace dev::precompiled;
+
+namespace dev
+{
+namespace test
+{
+/// a storage holding the tx_gas_limit config, counting the selects of it
+class GasLimitStorage : public MemoryStorage
+{
+public:
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition) override
+    {
+        if (tableInfo->name != SYS_CONFIG || key != "tx_gas_limit")
+        {
+            return MemoryStorage::select(hash, num, tableInfo, key, condition);
+        }
+        ++selects;
+        auto entry = std::make_shared<Entry>();
+        entry->setField(SYS_KEY, key);
+        entry->setField("value", txGasLimit);
+        entry->setField("enable_num", "0");
+        auto entries = std::make_shared<Entries>();
+        entries->addEntry(entry);
+        return entries;
+    }
+
+    std::string txGasLimit = "1000000";
+    size_t selects = 0;
+};
+
+class ExecutiveContextFactoryFixture : TestOutputHelperFixture
+{
+public:
+    ExecutiveContextFactoryFixture() : TestOutputHelperFixture()
+    {
+        storage = std::make_shared<GasLimitStorage>();
+        auto tableFactoryFactory = std::make_shared<MemoryTableFactoryFactory>();
+        tableFactoryFactory->setStorage(storage);
+        factory.setStateStorage(storage);
+        factory.setStateFactory(std::make_shared<StorageStateFactory>(h256(0)));
+        factory.setTableFactoryFactory(tableFactoryFactory);
+    }
+
+    ExecutiveContext::Ptr createContext(
+        h256 const& hash, int64_t number, Storage::Ptr stateStorage = nullptr)
+    {
+        auto context = std::make_shared<ExecutiveContext>();
+        factory.initExecutiveContext(
+            BlockInfo(hash, number, h256(0), stateStorage), h256(0), context);
+        return context;
+    }
+
+    std::shared_ptr<GasLimitStorage> storage;
+    ExecutiveContextFactory factory;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ExecutiveContextFactoryTest, ExecutiveContextFactoryFixture)
+
+BOOST_AUTO_TEST_CASE(sharedPrecompiled)
+{
+    auto context = createContext(h256(1), 1);
+    auto otherContext = createContext(h256(2), 2);
+
+    BOOST_CHECK(std::dynamic_pointer_cast<SystemConfigPrecompiled>(
+        context->getPrecompiled(Address(0x1000))));
+    BOOST_CHECK(std::dynamic_pointer_cast<ParallelConfigPrecompiled>(
+        context->getPrecompiled(Address(0x1006))));
+    // the system precompileds are built once for all the contexts
+    for (int address = 0x1000; address <= 0x1006; ++address)
+    {
+        BOOST_REQUIRE(context->getPrecompiled(Address(address)));
+        if (address != 0x1001)
+        {
+            BOOST_CHECK(context->getPrecompiled(Address(address)) ==
+                        otherContext->getPrecompiled(Address(address)));
+        }
+    }
+    // the table factory precompiled holds the tables of its block
+    BOOST_CHECK(
+        context->getPrecompiled(Address(0x1001)) != otherContext->getPrecompiled(Address(0x1001)));
+    BOOST_CHECK(!context->getPrecompiled(Address(0x1007)));
+
+    // a precompiled registered in a context is not seen by the others
+    auto registered = context->registerPrecompiled(std::make_shared<ParallelConfigPrecompiled>());
+    BOOST_CHECK(context->getPrecompiled(registered));
+    BOOST_CHECK(!otherContext->getPrecompiled(registered));
+}
+
+BOOST_AUTO_TEST_CASE(txGasLimit)
+{
+    auto context = createContext(h256(1), 1);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 1000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 1u);
+
+    // the limit of the same block is read once
+    storage->txGasLimit = "2000000";
+    context = createContext(h256(1), 1);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 1000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 1u);
+
+    // another block number reads it again
+    context = createContext(h256(1), 2);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 2000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 2u);
+
+    // so does another block hash at the same number
+    storage->txGasLimit = "3000000";
+    context = createContext(h256(2), 2);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 3000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 3u);
+    context = createContext(h256(2), 2);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 3000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 3u);
+
+    // the limit read from a storage of the block is neither cached nor taken from the cache
+    auto stateStorage = std::make_shared<GasLimitStorage>();
+    stateStorage->txGasLimit = "4000000";
+    context = createContext(h256(2), 2, stateStorage);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 4000000u);
+    BOOST_CHECK_EQUAL(stateStorage->selects, 1u);
+    context = createContext(h256(2), 2);
+    BOOST_CHECK_EQUAL(context->txGasLimit(), 3000000u);
+    BOOST_CHECK_EQUAL(storage->selects, 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
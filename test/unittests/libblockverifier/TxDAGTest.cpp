@@ -168,6 +168,173 @@ BOOST_AUTO_TEST_CASE(NormalAndParallelTxDAGTest)
     BOOST_CHECK_EQUAL(exeTrans[5].sha3(), trans[5].sha3());
 }
 
+BOOST_AUTO_TEST_CASE(ExecuteAllTxDAGTest)
+{
+    shared_ptr<TxDAG> txDag = make_shared<TxDAG>();
+    ExecutiveContext::Ptr executiveContext = createCtx();
+
+    Transactions trans;
+    trans.emplace_back(createParallelTransferTx("A", "B", 100));
+    trans.emplace_back(createParallelTransferTx("C", "D", 100));
+    trans.emplace_back(createParallelTransferTx("E", "F", 100));
+    trans.emplace_back(createParallelTransferTx("A", "D", 100));
+    trans.emplace_back(createParallelTransferTx("D", "F", 100));
+
+    txDag->init(executiveContext, trans, 0);
+
+    std::mutex x_exeIds;
+    std::vector<ID> exeIds;
+    txDag->setTxExecuteFunc([&](Transaction const&, ID _txId) {
+        Guard l(x_exeIds);
+        exeIds.push_back(_txId);
+        return true;
+    });
+
+    auto stats = txDag->executeAll(4);
+    BOOST_CHECK(txDag->hasFinished());
+    BOOST_CHECK_EQUAL(stats.workers, 4);
+    BOOST_CHECK_EQUAL(stats.width, 3);
+    BOOST_CHECK_EQUAL(stats.criticalPath, 3);
+
+    BOOST_CHECK_EQUAL(exeIds.size(), 5);
+    auto position = [&](ID _id) {
+        return std::find(exeIds.begin(), exeIds.end(), _id) - exeIds.begin();
+    };
+    BOOST_CHECK(position(0) < position(3));
+    BOOST_CHECK(position(1) < position(3));
+    BOOST_CHECK(position(3) < position(4));
+    BOOST_CHECK(position(2) < position(4));
+}
+
+BOOST_AUTO_TEST_CASE(AccessSetTxDAGTest)
+{
+    shared_ptr<TxDAG> txDag = make_shared<TxDAG>();
+
+    Transactions trans;
+    std::vector<storage::AccessSet::Ptr> accessSets;
+    auto addTx = [&](std::vector<string> const& _reads, std::vector<string> const& _writes) {
+        trans.emplace_back(createNormalTx());
+        auto accessSet = make_shared<storage::AccessSet>();
+        for (auto& key : _reads)
+            accessSet->read("t_test", key);
+        for (auto& key : _writes)
+            accessSet->write("t_test", key);
+        accessSets.push_back(accessSet);
+    };
+    addTx({"A"}, {"B"});  // 0
+    addTx({"A"}, {"C"});  // 1
+    addTx({}, {"A"});     // 2, after the reads of 0 and 1
+    addTx({"B"}, {});     // 3, after the write of 0
+    addTx({"D"}, {});     // 4
+    trans.emplace_back(createNormalTx());
+    accessSets.push_back(nullptr);  // 5, after all
+    addTx({"E"}, {});               // 6, after 5
+
+    txDag->init(trans, accessSets, 0);
+    BOOST_CHECK_EQUAL(txDag->normalTxsNumber(), 1);
+
+    std::mutex x_exeIds;
+    std::vector<ID> exeIds;
+    txDag->setTxExecuteFunc([&](Transaction const&, ID _txId) {
+        Guard l(x_exeIds);
+        exeIds.push_back(_txId);
+        return true;
+    });
+
+    auto stats = txDag->executeAll(4);
+    BOOST_CHECK(txDag->hasFinished());
+    BOOST_CHECK_EQUAL(stats.width, 3);
+    BOOST_CHECK_EQUAL(stats.criticalPath, 4);
+
+    BOOST_CHECK_EQUAL(exeIds.size(), 7);
+    auto position = [&](ID _id) {
+        return std::find(exeIds.begin(), exeIds.end(), _id) - exeIds.begin();
+    };
+    BOOST_CHECK(position(0) < position(2));
+    BOOST_CHECK(position(1) < position(2));
+    BOOST_CHECK(position(0) < position(3));
+    for (ID id = 0; id < 5; ++id)
+        BOOST_CHECK(position(id) < position(5));
+    BOOST_CHECK(position(5) < position(6));
+}
+
+BOOST_AUTO_TEST_CASE(BarrierAndSharedFieldTxDAGTest)
+{
+    shared_ptr<TxDAG> txDag = make_shared<TxDAG>();
+    auto profile = make_shared<DAGProfile>();
+    txDag->setProfile(profile);
+    ExecutiveContext::Ptr executiveContext = createCtx();
+
+    Transactions trans;
+    trans.emplace_back(createParallelTransferTx("A", "A", 100));  // 0, a field twice
+    trans.emplace_back(createParallelTransferTx("B", "C", 100));  // 1
+    trans.emplace_back(createNormalTx());                         // 2, after 0 and 1
+    trans.emplace_back(createParallelTransferTx("A", "B", 100));  // 3, after 2
+    trans.emplace_back(createParallelTransferTx("C", "D", 100));  // 4, after 2
+    trans.emplace_back(createParallelTransferTx("A", "C", 100));  // 5, after 3 and 4
+
+    txDag->init(executiveContext, trans, 0);
+    BOOST_CHECK(profile->levelWidths == IDs({2, 1, 2, 1}));
+    BOOST_CHECK(profile->criticalPath == IDs({0, 2, 3, 5}));
+    BOOST_CHECK(profile->barriers == IDs({2}));
+
+    Transactions exeTrans;
+    txDag->setTxExecuteFunc([&](Transaction const& _tr, ID) {
+        exeTrans.emplace_back(_tr);
+        return true;
+    });
+    while (!txDag->hasFinished())
+    {
+        txDag->executeUnit();
+    }
+    BOOST_CHECK_EQUAL(exeTrans.size(), trans.size());
+    BOOST_CHECK_EQUAL(exeTrans[2].sha3(), trans[2].sha3());
+    BOOST_CHECK_EQUAL(exeTrans[5].sha3(), trans[5].sha3());
+}
+
+BOOST_AUTO_TEST_CASE(ProfileTxDAGTest)
+{
+    shared_ptr<TxDAG> txDag = make_shared<TxDAG>();
+    auto profile = make_shared<DAGProfile>();
+    txDag->setProfile(profile);
+
+    Transactions trans;
+    std::vector<storage::AccessSet::Ptr> accessSets;
+    auto addTx = [&](std::vector<string> const& _writes) {
+        trans.emplace_back(createNormalTx());
+        auto accessSet = make_shared<storage::AccessSet>();
+        for (auto& key : _writes)
+            accessSet->write("t_test", key);
+        accessSets.push_back(accessSet);
+    };
+    addTx({"A"});  // 0
+    addTx({"A"});  // 1, after 0
+    addTx({"B"});  // 2
+    addTx({"A"});  // 3, after 1
+    trans.emplace_back(createNormalTx());
+    accessSets.push_back(nullptr);  // 4, after all
+
+    txDag->init(trans, accessSets, 0);
+    BOOST_CHECK(profile->levelWidths == IDs({2, 1, 1, 1}));
+    BOOST_CHECK(profile->criticalPath == IDs({0, 1, 3, 4}));
+    BOOST_CHECK(profile->barriers == IDs({4}));
+    auto widths = profile->widthHistogram();
+    BOOST_CHECK_EQUAL(widths[1], 3);
+    BOOST_CHECK_EQUAL(widths[2], 1);
+    auto fields = profile->topFields(1);
+    BOOST_CHECK_EQUAL(fields.size(), 1);
+    BOOST_CHECK_EQUAL(fields[0].second, 4);
+
+    txDag->setTxExecuteFunc([&](Transaction const&, ID) { return true; });
+    txDag->executeAll(2);
+    BOOST_CHECK_EQUAL(profile->spans.size(), 5);
+    BOOST_CHECK_EQUAL(profile->busyTime.size(), 2);
+    BOOST_CHECK_EQUAL(profile->idleTime.size(), 2);
+    auto trace = profile->chromeTrace(trans);
+    BOOST_CHECK(trace.find("\"traceEvents\"") != string::npos);
+    BOOST_CHECK(trace.find("0x" + trans[4].sha3().hex()) != string::npos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
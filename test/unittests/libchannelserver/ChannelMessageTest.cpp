@@ -0,0 +1,84 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the framing of the channel messages
+ *
+ * @file ChannelMessageTest.cpp
+ */
+
+#include <libchannelserver/ChannelMessage.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::channel;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(ChannelMessageTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testDecodeInPlace)
+{
+    bytes buffer;
+    for (int i = 0; i < 3; ++i)
+    {
+        TopicChannelMessage message;
+        message.setType(0x30);
+        message.setSeq(std::string(31, 'a') + std::to_string(i));
+        message.setTopic("topic");
+        std::string data = "data" + std::to_string(i);
+        message.setData((const byte*)data.data(), data.size());
+        message.encode(buffer);
+    }
+
+    /// the messages are decoded one after another from the same buffer, the last one partly
+    size_t offset = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        TopicChannelMessage message;
+        ssize_t result = message.decode(buffer.data() + offset, buffer.size() - offset);
+        BOOST_CHECK_GT(result, 0);
+        offset += result;
+        BOOST_CHECK_EQUAL(message.seq(), std::string(31, 'a') + std::to_string(i));
+        BOOST_CHECK_EQUAL(message.topic(), "topic");
+        BOOST_CHECK_EQUAL(std::string((char*)message.data(), message.dataSize()),
+            "data" + std::to_string(i));
+    }
+    BOOST_CHECK_EQUAL(offset, buffer.size());
+    TopicChannelMessage partial;
+    BOOST_CHECK_EQUAL(partial.decode(buffer.data(), 10), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testTopicLength)
+{
+    TopicChannelMessage message;
+    message.setType(0x12);
+    BOOST_CHECK_THROW(message.topic(), ChannelException);
+    message.setType(0x30);
+    BOOST_CHECK_THROW(message.dataSize(), ChannelException);
+    byte length = 10;
+    ChannelMessage raw;
+    raw.setType(0x30);
+    raw.setData(&length, 1);
+    TopicChannelMessage truncated(&raw);
+    BOOST_CHECK_THROW(truncated.data(), ChannelException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
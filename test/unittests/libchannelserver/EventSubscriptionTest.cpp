@@ -0,0 +1,136 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the subscriptions of the blocks and the logs
+ *
+ * @file EventSubscriptionTest.cpp
+ */
+
+#include <libchannelserver/EventSubscription.h>
+#include <libdevcore/CommonJS.h>
+#include <libdevcrypto/Common.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::channel;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(EventSubscriptionTest, TestOutputHelperFixture)
+
+static Transaction fakeTransaction(u256 const& _nonce)
+{
+    Transaction tx(0, 0, 0, Address(0x1), bytes(), _nonce);
+    tx.updateSignature(
+        SignatureStruct(dev::sign(KeyPair::create().secret(), tx.sha3(WithoutSignature))));
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(testEventFilter)
+{
+    Address address(0x1234);
+    h256 topic(0x56);
+    Json::Value root;
+    root["groupID"] = 1;
+    root["type"] = "log";
+    root["addresses"].append(toJS(address));
+    root["topics"].append(Json::Value());
+    root["topics"].append(toJS(topic));
+    auto filter = EventFilter::fromJson(root);
+    BOOST_CHECK_EQUAL(filter.groupID, 1);
+    BOOST_CHECK(filter.logs);
+    BOOST_CHECK_EQUAL(filter.addresses.size(), 1);
+    BOOST_CHECK_EQUAL(filter.topics.size(), 2);
+    BOOST_CHECK(filter.topics[0].empty());
+
+    LogEntry matched(address, h256s{h256(0x78), topic}, bytes());
+    LogEntry otherTopic(address, h256s{h256(0x78), h256(0x79)}, bytes());
+    LogEntry otherAddress(Address(0x4321), h256s{h256(0x78), topic}, bytes());
+    LogEntry fewTopics(address, h256s{h256(0x78)}, bytes());
+    BOOST_CHECK(filter.matches(matched));
+    BOOST_CHECK(!filter.matches(otherTopic));
+    BOOST_CHECK(!filter.matches(otherAddress));
+    BOOST_CHECK(!filter.matches(fewTopics));
+    BOOST_CHECK(filter.mayMatch(matched.bloom()));
+    BOOST_CHECK(!filter.mayMatch(LogBloom()));
+
+    root["topics"][1] = "0x12";
+    BOOST_CHECK_THROW(EventFilter::fromJson(root), Exception);
+    root["type"] = "tx";
+    BOOST_CHECK_THROW(EventFilter::fromJson(root), Exception);
+    BOOST_CHECK_THROW(EventFilter::fromJson(Json::Value("1")), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(testEvents)
+{
+    Address address(0x1234);
+    Block block;
+    block.appendTransaction(fakeTransaction(1));
+    block.appendTransaction(fakeTransaction(2));
+    TransactionReceipts receipts;
+    receipts.push_back(TransactionReceipt());
+    receipts.push_back(TransactionReceipt(h256(), 0,
+        LogEntries{LogEntry(Address(0x4321), h256s(), bytes()),
+            LogEntry(address, h256s{h256(0x56)}, bytes{1})},
+        executive::TransactionException::None, bytes()));
+
+    EventSubscription<int> subscription;
+    EventFilter blocks;
+    blocks.groupID = 1;
+    EventFilter logs;
+    logs.groupID = 1;
+    logs.logs = true;
+    logs.addresses.insert(address);
+    auto blockID = subscription.subscribe(1, blocks);
+    auto logID = subscription.subscribe(2, logs);
+    subscription.subscribe(3, logs);
+    BOOST_CHECK(subscription.subscribed(1, true));
+    BOOST_CHECK(!subscription.subscribed(2, false));
+
+    auto events = subscription.events(1, block, receipts);
+    BOOST_CHECK_EQUAL(events.size(), 3);
+    BOOST_CHECK_EQUAL(events[1].size(), 1);
+    BOOST_CHECK_EQUAL(events[1][0]["type"].asString(), "block");
+    BOOST_CHECK_EQUAL(events[1][0]["filterID"].asUInt64(), blockID);
+    BOOST_CHECK_EQUAL(events[1][0]["transactionCount"].asString(), "0x2");
+    BOOST_CHECK_EQUAL(events[2].size(), 1);
+    BOOST_CHECK_EQUAL(events[2][0]["filterID"].asUInt64(), logID);
+    BOOST_CHECK_EQUAL(events[2][0]["transactionHash"].asString(),
+        toJS(block.transactions()[1].sha3()));
+    BOOST_CHECK_EQUAL(events[2][0]["logIndex"].asString(), "0x1");
+    BOOST_CHECK_EQUAL(events[2][0]["data"].asString(), "0x01");
+    BOOST_CHECK(subscription.events(2, block, receipts).empty());
+
+    BOOST_CHECK(subscription.unsubscribe(2, logID));
+    BOOST_CHECK(!subscription.unsubscribe(2, logID));
+    subscription.remove(3);
+    BOOST_CHECK(!subscription.subscribed(1, true));
+    BOOST_CHECK_EQUAL(subscription.events(1, block, receipts).size(), 1);
+
+    for (size_t i = 0; i < c_maxSubscriptions; ++i)
+    {
+        BOOST_CHECK(subscription.subscribe(4, blocks) != 0);
+    }
+    BOOST_CHECK_EQUAL(subscription.subscribe(4, blocks), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
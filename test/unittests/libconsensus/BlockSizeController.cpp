@@ -0,0 +1,85 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for BlockSizeController.h
+ * @file: BlockSizeController.cpp
+ */
+#include <libconsensus/pbft/BlockSizeController.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev::consensus;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(BlockSizeControllerTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testMaxBlockTxs)
+{
+    BlockSizeController controller;
+    BOOST_CHECK(!controller.enabled());
+    controller.setTargetLatency(1000);
+    BOOST_CHECK(controller.enabled());
+    /// no sample yet
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 5000);
+
+    /// 1ms per transaction, 200ms collecting the signatures and 100ms saving the block
+    controller.onExecuted(100, 100);
+    controller.onSigned(200);
+    controller.onCommitted(100);
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 700);
+    BOOST_CHECK(controller.maxBlockTxs(500) == 500);
+    BOOST_CHECK(controller.sealingInterval(500) == 500);
+    BOOST_CHECK(controller.sealingInterval(1000) == 700);
+
+    /// the averages move towards the slower samples
+    controller.onSigned(1200);
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 500);
+    /// the consensus alone exceeds the target
+    for (size_t i = 0; i < 20; i++)
+    {
+        controller.onSigned(2000);
+    }
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 1);
+    BOOST_CHECK(controller.sealingInterval(500) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testDisabled)
+{
+    BlockSizeController controller;
+    /// the samples are still tracked but the configured limits are kept
+    controller.onExecuted(100, 1000);
+    controller.onSigned(2000);
+    controller.onCommitted(1000);
+    BOOST_CHECK(!controller.enabled());
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 5000);
+    BOOST_CHECK(controller.sealingInterval(500) == 500);
+    BOOST_CHECK(controller.sealingInterval(0) == 0);
+
+    /// disabled again after having tuned the block
+    controller.setTargetLatency(1000);
+    BOOST_CHECK(controller.sealingInterval(500) == 0);
+    controller.setTargetLatency(0);
+    BOOST_CHECK(controller.maxBlockTxs(5000) == 5000);
+    BOOST_CHECK(controller.sealingInterval(500) == 500);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -153,6 +153,17 @@ BOOST_AUTO_TEST_CASE(testPrepareReq)
     checkPBFTMsg(new_req, key_pair2, fake_block.m_block.blockHeader().number(), 2, 135,
         new_req.timestamp, fake_block.m_block.header().hash());
     BOOST_CHECK(new_req.timestamp >= tmp_req.timestamp);
+
+    /// test the compact block of a prepare
+    bytes compact = PrepareReq::encodeCompactBlock(fake_block.m_block);
+    BOOST_CHECK(compact.size() < fake_block.m_blockData.size());
+    BlockHeader header;
+    h256s hashes;
+    PrepareReq::decodeCompactBlock(ref(compact), header, hashes);
+    BOOST_CHECK(header.hash() == fake_block.m_block.header().hash());
+    BOOST_CHECK(hashes.size() == fake_block.m_block.getTransactionSize());
+    for (size_t i = 0; i < hashes.size(); i++)
+        BOOST_CHECK(hashes[i] == fake_block.m_block.transaction(i).sha3());
 }
 
 /// test SignReq and CommitReq
@@ -199,6 +199,14 @@ public:
         return PBFTEngine::handlePrepareMsg(prepareReq, ip);
     }
     void setOmitEmpty(bool value) { m_omitEmptyBlock = value; }
+    void onPrepareExecuted(PrepareReq const& prepareReq, Sealing& workingSealing)
+    {
+        return PBFTEngine::onPrepareExecuted(prepareReq, workingSealing, "", Timer());
+    }
+    bool reuseExecutedBlock(Sealing& sealing, PrepareReq const& req)
+    {
+        return PBFTEngine::reuseExecutedBlock(sealing, req);
+    }
 
     /// handle sign
     bool handleSignMsg(SignReq& sign_req, PBFTMsgPacket const& pbftMsg)
@@ -217,6 +225,19 @@ public:
         std::ostringstream oss;
         return PBFTEngine::isValidSignReq(req, oss);
     }
+    dev::h512s relayTargets(IDXTYPE const& root, std::unordered_set<h512> const& connected) const
+    {
+        return PBFTEngine::relayTargets(root, connected);
+    }
+    void verifySignsInBatch(std::vector<PBFTMsgPacket> const& packets)
+    {
+        PBFTEngine::verifySignsInBatch(packets);
+    }
+    bool isVerifiedSign(PBFTMsg const& req)
+    {
+        return PBFTEngine::takeVerifiedSign(
+            PBFTEngine::signatureKey(getSealerByIndex(req.idx), req));
+    }
     CheckResult isValidCommitReq(CommitReq const& req) const
     {
         std::ostringstream oss;
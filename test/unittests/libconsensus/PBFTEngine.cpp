@@ -559,6 +559,68 @@ BOOST_AUTO_TEST_CASE(testHandleCommitMsg)
     CheckBlockChain(fake_pbft, block_number + 1);
 }
 
+/// test relayTargets
+BOOST_AUTO_TEST_CASE(testRelayTargets)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(7, ProtocolID::PBFT);
+    auto const& sealers = fake_pbft.m_sealerList;
+    std::unordered_set<h512> connected(sealers.begin(), sealers.end());
+    fake_pbft.consensus()->setBroadcastTreeWidth(2);
+
+    /// the root sends to its two children
+    fake_pbft.consensus()->setNodeIdx(3);
+    BOOST_CHECK(fake_pbft.consensus()->relayTargets(3, connected) ==
+                h512s({sealers[4], sealers[5]}));
+    /// the first child of the root relays to the 3rd and 4th sealers counted from the root
+    fake_pbft.consensus()->setNodeIdx(4);
+    BOOST_CHECK(fake_pbft.consensus()->relayTargets(3, connected) ==
+                h512s({sealers[6], sealers[0]}));
+    /// leaf
+    fake_pbft.consensus()->setNodeIdx(6);
+    BOOST_CHECK(fake_pbft.consensus()->relayTargets(3, connected).empty());
+    /// the children of a disconnected child are sent to instead
+    fake_pbft.consensus()->setNodeIdx(3);
+    connected.erase(sealers[4]);
+    auto targets = fake_pbft.consensus()->relayTargets(3, connected);
+    BOOST_CHECK(std::set<h512>(targets.begin(), targets.end()) ==
+                std::set<h512>({sealers[5], sealers[6], sealers[0]}));
+}
+
+/// test verifySignsInBatch
+BOOST_AUTO_TEST_CASE(testVerifySignsInBatch)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(4, ProtocolID::PBFT);
+    PrepareReq prepareReq;
+    prepareReq.height = 1;
+    prepareReq.block_hash = sha3("block");
+    std::vector<PBFTMsgPacket> packets;
+    std::vector<PBFTMsg> reqs;
+    for (IDXTYPE i = 0; i < 3; i++)
+    {
+        SignReq signReq(prepareReq, KeyPair(fake_pbft.m_secrets[i]), i);
+        PBFTMsgPacket packet;
+        packet.packet_id = SignReqPacket;
+        signReq.encode(packet.data);
+        packets.push_back(packet);
+        reqs.push_back(signReq);
+    }
+    /// signed by the key of another sealer
+    CommitReq commitReq(prepareReq, KeyPair(fake_pbft.m_secrets[0]), 3);
+    PBFTMsgPacket packet;
+    packet.packet_id = CommitReqPacket;
+    commitReq.encode(packet.data);
+    packets.push_back(packet);
+
+    fake_pbft.consensus()->verifySignsInBatch(packets);
+    for (auto const& req : reqs)
+    {
+        BOOST_CHECK(fake_pbft.consensus()->isVerifiedSign(req));
+        /// each verified signature is taken once
+        BOOST_CHECK(!fake_pbft.consensus()->isVerifiedSign(req));
+    }
+    BOOST_CHECK(!fake_pbft.consensus()->isVerifiedSign(commitReq));
+}
+
 BOOST_AUTO_TEST_CASE(testShouldSeal)
 {
     FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
@@ -753,6 +815,51 @@ BOOST_AUTO_TEST_CASE(testCheckBlock)
     BOOST_CHECK(fake_pbft.consensus()->checkBlock(invalid_block.m_block) == false);
 }
 
+/// test the reuse of the block executed for a raw prepare proposed again after a view change
+BOOST_AUTO_TEST_CASE(testReuseExecutedBlock)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(4, ProtocolID::PBFT);
+    fake_pbft.consensus()->resetConfig();
+    int64_t height = fake_pbft.consensus()->blockChain()->number() + 1;
+    FakeBlock block(4, KeyPair::create().secret(), height);
+    h256 blockHash = block.m_block.blockHeader().hash();
+    KeyPair key_pair = KeyPair::create();
+    VIEWTYPE view = fake_pbft.consensus()->view();
+    PrepareReq rawReq(key_pair, height, view, 0, sha3("rawPrepare"));
+
+    /// nothing executed yet
+    Sealing sealing;
+    BOOST_CHECK(fake_pbft.consensus()->reuseExecutedBlock(sealing, rawReq) == false);
+
+    Sealing executed;
+    executed.block = block.m_block;
+    executed.p_execContext = std::make_shared<ExecutiveContext>();
+    ExecutiveContext::Ptr context = executed.p_execContext;
+    fake_pbft.consensus()->onPrepareExecuted(rawReq, executed);
+
+    /// the same raw block proposed by the next leader: reuse the block and its context
+    PrepareReq sameReq(key_pair, height, view + 1, 1, rawReq.block_hash);
+    BOOST_CHECK(fake_pbft.consensus()->reuseExecutedBlock(sealing, sameReq) == true);
+    BOOST_CHECK(sealing.p_execContext == context);
+    BOOST_CHECK(sealing.block.blockHeader().hash() == blockHash);
+
+    /// another raw block at the same height: re-execute
+    Sealing otherSealing;
+    PrepareReq otherReq(key_pair, height, view + 1, 1, sha3("otherPrepare"));
+    BOOST_CHECK(fake_pbft.consensus()->reuseExecutedBlock(otherSealing, otherReq) == false);
+    BOOST_CHECK(otherSealing.p_execContext == nullptr);
+
+    /// the same raw hash at another height: re-execute
+    PrepareReq nextReq(key_pair, height + 1, view + 1, 1, rawReq.block_hash);
+    BOOST_CHECK(fake_pbft.consensus()->reuseExecutedBlock(otherSealing, nextReq) == false);
+    BOOST_CHECK(otherSealing.p_execContext == nullptr);
+
+    /// the parent has been committed since: the executed block is stale
+    fake_pbft.consensus()->mutableHighest().setNumber(height);
+    BOOST_CHECK(fake_pbft.consensus()->reuseExecutedBlock(otherSealing, sameReq) == false);
+    BOOST_CHECK(otherSealing.p_execContext == nullptr);
+}
+
 /// test handleMsg
 BOOST_AUTO_TEST_CASE(testHandleMsg)
 {
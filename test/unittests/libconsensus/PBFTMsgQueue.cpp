@@ -0,0 +1,96 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for PBFTMsgQueue.h
+ * @file: PBFTMsgQueue.cpp
+ */
+#include <libconsensus/pbft/PBFTMsgQueue.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev::consensus;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(PBFTMsgQueueTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testPopByPriority)
+{
+    PBFTMsgQueue queue;
+    BOOST_CHECK(!queue.tryPop(0).first);
+    for (auto packetId : {ViewChangeReqPacket, PrepareReqPacket, SignReqPacket, CommitReqPacket,
+             ViewChangeReqPacket, CommitReqPacket})
+    {
+        PBFTMsgPacket packet;
+        packet.packet_id = packetId;
+        queue.push(packet);
+    }
+    BOOST_CHECK(queue.size() == 6);
+    BOOST_CHECK(queue.size(ViewChangeReqPacket) == 2);
+    BOOST_CHECK(queue.size(CommitReqPacket) == 2);
+
+    std::vector<uint8_t> popped;
+    for (auto ret = queue.tryPop(0); ret.first; ret = queue.tryPop(0))
+    {
+        popped.push_back(ret.second.packet_id);
+    }
+    std::vector<uint8_t> expected{CommitReqPacket, CommitReqPacket, SignReqPacket,
+        PrepareReqPacket, ViewChangeReqPacket, ViewChangeReqPacket};
+    BOOST_CHECK(popped == expected);
+    BOOST_CHECK(queue.size() == 0);
+    BOOST_CHECK(queue.size(CommitReqPacket) == 0);
+
+    queue.onDiscard(SignReqPacket);
+    Json::Value status(Json::arrayValue);
+    queue.status(status);
+    BOOST_CHECK(status.size() == PBFTPacketCount);
+    BOOST_CHECK(status[SignReqPacket]["discarded"].asUInt64() == 1);
+    BOOST_CHECK(status[SignReqPacket]["queued"].asUInt64() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPopBatchAndDiscard)
+{
+    PBFTMsgQueue queue;
+    PBFTMsgPacket packet;
+    packet.packet_id = PrepareReqPacket;
+    for (size_t i = 0; i < PBFTMsgQueue::c_capacity; i++)
+    {
+        BOOST_CHECK(queue.push(packet));
+    }
+    BOOST_CHECK(!queue.push(packet));
+    packet.packet_id = SignReqPacket;
+    BOOST_CHECK(queue.push(packet));
+    BOOST_CHECK(queue.size() == PBFTMsgQueue::c_capacity + 1);
+
+    std::vector<PBFTMsgPacket> packets;
+    BOOST_CHECK(queue.popBatch(packets, 3) == 3);
+    BOOST_CHECK(packets[0].packet_id == SignReqPacket);
+    BOOST_CHECK(packets[2].packet_id == PrepareReqPacket);
+    BOOST_CHECK(queue.size() == PBFTMsgQueue::c_capacity - 2);
+    BOOST_CHECK(queue.size(PrepareReqPacket) == PBFTMsgQueue::c_capacity - 2);
+    BOOST_CHECK(queue.size(SignReqPacket) == 0);
+
+    Json::Value status(Json::arrayValue);
+    queue.status(status);
+    BOOST_CHECK(status[PrepareReqPacket]["discarded"].asUInt64() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
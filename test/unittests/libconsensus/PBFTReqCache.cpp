@@ -98,7 +98,7 @@ BOOST_AUTO_TEST_CASE(testSigListSetting)
     {
         KeyPair key = KeyPair::create();
         /// fake commit req from faked prepare req
-        CommitReq commit_req(prepare_req, key, prepare_req.idx);
+        CommitReq commit_req(prepare_req, key, i);
         req_cache.addCommitReq(commit_req);
         BOOST_CHECK(req_cache.isExistCommit(commit_req));
     }
@@ -114,12 +114,40 @@ BOOST_AUTO_TEST_CASE(testSigListSetting)
     BOOST_CHECK(block.sigList().size() == node_num);
     std::vector<std::pair<u256, Signature>> sig_list = block.sigList();
     /// check the signature
-    for (auto& item : sig_list)
+    for (size_t i = 0; i < sig_list.size(); i++)
     {
-        auto p = dev::recover(item.second, prepare_req.block_hash);
+        BOOST_CHECK(sig_list[i].first == u256(i));
+        auto p = dev::recover(sig_list[i].second, prepare_req.block_hash);
         BOOST_CHECK(!!p);
     }
 }
+/// test the requests of a sealer count once
+BOOST_AUTO_TEST_CASE(testVoteOfSealer)
+{
+    PBFTReqCache req_cache;
+    KeyPair key_pair;
+    PrepareReq prepare_req = FakePrepareReq(key_pair);
+    SignReq sign_req(prepare_req, KeyPair::create(), 70);
+    req_cache.addSignReq(sign_req);
+    BOOST_CHECK(req_cache.isExistSign(sign_req));
+    /// another signature of the same sealer replaces the former
+    SignReq sign_req2(prepare_req, KeyPair::create(), 70);
+    req_cache.addSignReq(sign_req2);
+    BOOST_CHECK(req_cache.getSigCacheSize(prepare_req.block_hash) == 1);
+    BOOST_CHECK(!req_cache.isExistSign(sign_req));
+    BOOST_CHECK(req_cache.isExistSign(sign_req2));
+    SignReq sign_req3(prepare_req, KeyPair::create(), 3);
+    req_cache.addSignReq(sign_req3);
+    BOOST_CHECK(req_cache.getSigCacheSize(prepare_req.block_hash) == 2);
+    /// the requests of another view are removed by the prepare
+    sign_req3.view = prepare_req.view + 1;
+    req_cache.addSignReq(sign_req3);
+    BOOST_CHECK(req_cache.getSigCacheSize(prepare_req.block_hash) == 2);
+    req_cache.addPrepareReq(prepare_req);
+    BOOST_CHECK(req_cache.getSigCacheSize(prepare_req.block_hash) == 1);
+    BOOST_CHECK(!req_cache.isExistSign(sign_req3));
+    BOOST_CHECK(req_cache.isExistSign(sign_req2));
+}
 /// test collectGarbage
 BOOST_AUTO_TEST_CASE(testCollectGarbage)
 {
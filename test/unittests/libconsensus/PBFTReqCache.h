@@ -52,10 +52,12 @@ void FakeInvalidReq(PrepareReq& prepare_req, PBFTReqCache& reqCache, S& cache, B
         prepare_req.block_hash = highest.hash();
         prepare_req.height = highest.number();
     }
+    /// the requests of a sealer replace each other, each is faked by a sealer of its own
+    IDXTYPE idx = 0;
     /// fake invalid block height
     for (size_t i = 0; i < invalidHeightNum; i++)
     {
-        T req(prepare_req, KeyPair::create(), prepare_req.idx);
+        T req(prepare_req, KeyPair::create(), idx++);
         /// update height of req
         req.height -= (i + 1);
         reqCache.addReq(req, cache);
@@ -64,13 +66,13 @@ void FakeInvalidReq(PrepareReq& prepare_req, PBFTReqCache& reqCache, S& cache, B
     /// fake invalid hash
     for (size_t i = 0; i < invalidHash; i++)
     {
-        T req(prepare_req, KeyPair::create(), prepare_req.idx);
+        T req(prepare_req, KeyPair::create(), idx++);
         req.block_hash = invalid_hash;
         reqCache.addReq(req, cache);
     }
     for (size_t i = 0; i < validNum; i++)
     {
-        T req(prepare_req, KeyPair::create(), prepare_req.idx);
+        T req(prepare_req, KeyPair::create(), idx++);
         req.height += 1;
         reqCache.addReq(req, cache);
         BOOST_CHECK(
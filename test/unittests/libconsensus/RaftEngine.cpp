@@ -64,6 +64,7 @@ public:
         std::function<void(NetworkException, std::shared_ptr<SessionFace>, Message::Ptr)>) override
     {}
     bool actived() const override { return true; }
+    size_t writeQueueBytes() const override { return 0; }
     std::shared_ptr<SocketFace> socket() override { return nullptr; }
 
 private:
@@ -0,0 +1,99 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the cores the threads are bound to
+ *
+ * @file: Affinity.cpp
+ */
+
+#include <libdevcore/Affinity.h>
+#include <libdevcore/Exceptions.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(AffinityTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(parseCores)
+{
+    unsigned cores = max<unsigned>(thread::hardware_concurrency(), 1);
+    BOOST_CHECK(CPUAffinity::parseCores("").empty());
+    BOOST_CHECK(CPUAffinity::parseCores("0") == vector<unsigned>({0}));
+    BOOST_CHECK(CPUAffinity::parseCores(" 0 , 0-0 ") == vector<unsigned>({0}));
+    BOOST_CHECK(CPUAffinity::parseCores("0-" + to_string(cores - 1)).size() == cores);
+
+    BOOST_CHECK_THROW(CPUAffinity::parseCores(to_string(cores)), InvalidCoreList);
+    BOOST_CHECK_THROW(CPUAffinity::parseCores("a"), InvalidCoreList);
+    BOOST_CHECK_THROW(CPUAffinity::parseCores("0-"), InvalidCoreList);
+    if (cores > 1)
+    {
+        BOOST_CHECK_THROW(CPUAffinity::parseCores("1-0"), InvalidCoreList);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(coresOf)
+{
+    unsigned cores = thread::hardware_concurrency();
+    if (cores < 3)
+    {
+        return;
+    }
+    vector<unsigned> all;
+    for (unsigned core = 0; core < cores; ++core)
+    {
+        all.push_back(core);
+    }
+
+    g_cpuAffinity.configure({}, {}, {});
+    BOOST_CHECK(!g_cpuAffinity.enabled());
+    BOOST_CHECK(g_cpuAffinity.coresOf("PBFT-1").empty());
+    BOOST_CHECK(!g_cpuAffinity.bindThread("io_service"));
+
+    g_cpuAffinity.configure({{1, {1}}, {2, {}}}, {0}, {});
+    BOOST_CHECK(g_cpuAffinity.enabled());
+    BOOST_CHECK(g_cpuAffinity.coresOf("PBFT-1") == vector<unsigned>({1}));
+    BOOST_CHECK(g_cpuAffinity.coresOf("Sync-1") == vector<unsigned>({1}));
+    // a group without cores and a thread of no group are left where they are
+    BOOST_CHECK(g_cpuAffinity.coresOf("PBFT-2").empty());
+    BOOST_CHECK(g_cpuAffinity.coresOf("Executor").empty());
+    BOOST_CHECK(g_cpuAffinity.coresOf("io_service") == vector<unsigned>({0}));
+    BOOST_CHECK(g_cpuAffinity.coresOf("io_session") == vector<unsigned>({0}));
+    auto free = g_cpuAffinity.freeCores();
+    BOOST_CHECK_EQUAL(free.size(), cores - 2);
+    BOOST_CHECK_EQUAL(free.front(), 2);
+    // the storage threads take the free cores without cores of their own
+    BOOST_CHECK(g_cpuAffinity.coresOf("rocksdb:low0") == free);
+    BOOST_CHECK(g_cpuAffinity.coresOf("CacheClear") == free);
+
+    // all reserved, the other threads share them
+    g_cpuAffinity.configure({{1, all}}, {}, {});
+    BOOST_CHECK(g_cpuAffinity.freeCores() == all);
+
+    g_cpuAffinity.configure({}, {}, {});
+    CPUAffinity::bindThread(all);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
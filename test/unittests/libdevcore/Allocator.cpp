@@ -0,0 +1,83 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the allocator stats and the huge pages of the caches
+ *
+ * @file: Allocator.cpp
+ */
+
+#include <libdevcore/Allocator.h>
+#include <libdevcore/Metrics.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(AllocatorTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(stats)
+{
+    BOOST_CHECK(string(allocatorName()).size() > 0);
+    auto before = allocatorStats();
+    unique_ptr<char[]> block(new char[8 << 20]);
+    fill(block.get(), block.get() + (8 << 20), 1);
+    auto after = allocatorStats();
+    BOOST_CHECK_GT(after.resident, 0u);
+    if (before.allocated > 0)
+    {
+        BOOST_CHECK_GE(after.allocated, before.allocated + (8 << 20));
+    }
+
+    updateAllocatorMetrics();
+    BOOST_CHECK(g_metrics.prometheus().find("bcos_allocator_resident_bytes") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(hugePages)
+{
+    typedef vector<uint8_t, HugePageAllocator<uint8_t>> Table;
+    setCacheHugePages(false);
+    BOOST_CHECK(!cacheHugePages());
+    Table table(4 << 20);
+    BOOST_CHECK_EQUAL(adviseHugePages(table.data(), table.size()), 0u);
+
+    setCacheHugePages(true);
+    Table huge(3 << 20, 7);
+    BOOST_CHECK_EQUAL((uintptr_t)huge.data() % c_hugePageSize, 0u);
+    BOOST_CHECK_EQUAL(huge[(3 << 20) - 1], 7);
+    // only the whole huge pages inside are advised, if the kernel has them at all
+    auto advised = adviseHugePages(huge.data() + 1, huge.size() - 1);
+    BOOST_CHECK(advised == 0 || advised == c_hugePageSize);
+    // small tables and the ones allocated before are freed as they were allocated
+    Table small(100, 1);
+    table.clear();
+    table.shrink_to_fit();
+    setCacheHugePages(false);
+    huge.clear();
+    huge.shrink_to_fit();
+    BOOST_CHECK_EQUAL(small[99], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
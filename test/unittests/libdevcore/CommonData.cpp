@@ -22,6 +22,7 @@
  */
 #include <libdevcore/CommonData.h>
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/FixedHash.h>
 #include <libdevcore/vector_ref.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
@@ -36,6 +37,49 @@ namespace test
 {
 BOOST_FIXTURE_TEST_SUITE(CommonDataTests, TestOutputHelperFixture)
 
+/// the vectorized hex conversion against a byte at a time, at every length around the vectors
+BOOST_AUTO_TEST_CASE(testHexVectorized)
+{
+    static char const* digits = "0123456789abcdef";
+    std::srand(std::time(nullptr));
+    for (size_t size = 0; size < 200; ++size)
+    {
+        bytes data(size);
+        std::string expected;
+        for (auto& b : data)
+        {
+            b = std::rand() % 256;
+            expected.push_back(digits[b >> 4]);
+            expected.push_back(digits[b & 0x0f]);
+        }
+        BOOST_CHECK_EQUAL(toHex(data), expected);
+        BOOST_CHECK_EQUAL(toHex(bytesConstRef(&data)), expected);
+        BOOST_CHECK_EQUAL(toHexPrefixed(data), "0x" + expected);
+        BOOST_CHECK_EQUAL(toHex(data.begin(), data.end(), "0x"), "0x" + expected);
+        BOOST_CHECK(fromHex(expected) == data);
+        BOOST_CHECK(fromHex("0x" + expected) == data);
+        std::string upper = expected;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        BOOST_CHECK(fromHex(upper, WhenError::Throw) == data);
+
+        // a bad char is found wherever it is
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\xff', '\0'})
+            {
+                std::string invalid = expected;
+                invalid[i] = bad;
+                BOOST_CHECK(fromHex(invalid).empty());
+            }
+        }
+    }
+    BOOST_CHECK(fromHex("abc") == bytes({0x0a, 0xbc}));
+    BOOST_CHECK_EQUAL(toHex(std::string("A\x69")), "4169");
+    h256 hash = h256::random();
+    BOOST_CHECK_EQUAL(toHex(hash), toHex(hash.ref()));
+    BOOST_CHECK(h256(toHexPrefixed(hash)) == hash);
+}
+
 /// test toHex && fromHex && isHex && isHash
 BOOST_AUTO_TEST_CASE(testHex)
 {
@@ -59,6 +103,7 @@ BOOST_AUTO_TEST_CASE(testHex)
     }
     // fromHex Exception
     BOOST_REQUIRE_NO_THROW(fromHex("0934xyz", WhenError::DontThrow));
+    BOOST_CHECK(fromHex("0934xyz", WhenError::DontThrow).empty());
     BOOST_CHECK_THROW(fromHex("0934xyz", WhenError::Throw), BadHexCharacter);
     // isHex && isHash
     BOOST_CHECK(isHex("0934xyz") == false);
@@ -41,6 +41,13 @@ BOOST_AUTO_TEST_CASE(test_toJS)
     BOOST_CHECK(toJS(b) == "0xffff0000bbbaaaa");
     BOOST_CHECK(toJS(c) == "0x913ffc283");
     BOOST_CHECK(toJS(d) == "0xff00efbc");
+
+    // the integers are written as the stream writes them
+    BOOST_CHECK(toJS(0) == "0x0");
+    BOOST_CHECK(toJS(int64_t(-1)) == "0xffffffffffffffff");
+    BOOST_CHECK(toJS(unsigned(255)) == "0xff");
+    BOOST_CHECK(toJS(u256(0)) == "0x0");
+    BOOST_CHECK(toJS(u256(256)) == "0x100");
 }
 
 BOOST_AUTO_TEST_CASE(test_jsToBytes)
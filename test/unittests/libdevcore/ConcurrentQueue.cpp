@@ -0,0 +1,185 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the lock-free rings
+ *
+ * @file: ConcurrentQueue.cpp
+ */
+
+#include <libdevcore/concurrent_queue.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(ConcurrentQueueTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(bounds)
+{
+    MPMCQueue<int> mpmc(5);
+    SPSCQueue<int> spsc(5);
+    BOOST_CHECK_EQUAL(mpmc.capacity(), 8u);
+    BOOST_CHECK_EQUAL(spsc.capacity(), 8u);
+    vector<int> items{0, 1, 2, 3, 4, 5};
+    BOOST_CHECK_EQUAL(mpmc.tryPushBatch(items.begin(), items.end()), 6u);
+    BOOST_CHECK_EQUAL(spsc.tryPushBatch(items.begin(), items.end()), 6u);
+    BOOST_CHECK_EQUAL(mpmc.tryPushBatch(items.begin(), items.end()), 2u);
+    BOOST_CHECK_EQUAL(spsc.tryPushBatch(items.begin(), items.end()), 2u);
+    BOOST_CHECK(!mpmc.tryPush(9));
+    BOOST_CHECK(!spsc.tryPush(9));
+    BOOST_CHECK_EQUAL(mpmc.size(), 8u);
+
+    vector<int> popped;
+    BOOST_CHECK_EQUAL(mpmc.tryPopBatch(back_inserter(popped), 3), 3u);
+    int item = -1;
+    BOOST_CHECK(mpmc.tryPop(item));
+    BOOST_CHECK_EQUAL(item, 3);
+    BOOST_CHECK_EQUAL(mpmc.tryPopBatch(back_inserter(popped), 10), 4u);
+    BOOST_CHECK(popped == vector<int>({0, 1, 2, 4, 5, 0, 1}));
+    BOOST_CHECK(!mpmc.tryPop(item));
+    BOOST_CHECK(!mpmc.pop(item, 10));
+
+    popped.clear();
+    BOOST_CHECK_EQUAL(spsc.tryPopBatch(back_inserter(popped), 10), 8u);
+    BOOST_CHECK(popped == vector<int>({0, 1, 2, 3, 4, 5, 0, 1}));
+    BOOST_CHECK(!spsc.pop(item, 10));
+}
+
+BOOST_AUTO_TEST_CASE(destroyItemsLeft)
+{
+    auto item = make_shared<int>(1);
+    {
+        MPMCQueue<shared_ptr<int>> mpmc(4);
+        SPSCQueue<shared_ptr<int>> spsc(4);
+        mpmc.tryPush(item);
+        spsc.tryPush(item);
+        BOOST_CHECK_EQUAL(item.use_count(), 3);
+    }
+    BOOST_CHECK_EQUAL(item.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(spscOrder)
+{
+    SPSCQueue<uint64_t> queue(64);
+    const uint64_t count = 200000;
+    thread producer([&]() {
+        vector<uint64_t> batch;
+        for (uint64_t i = 0; i < count;)
+        {
+            if (i % 3 == 0)
+            {
+                i += queue.tryPush(i) ? 1 : 0;
+                continue;
+            }
+            batch.clear();
+            for (uint64_t j = i; j < min(count, i + 5); ++j)
+                batch.push_back(j);
+            i += queue.tryPushBatch(batch.begin(), batch.end());
+        }
+    });
+    uint64_t expected = 0;
+    vector<uint64_t> popped;
+    while (expected < count)
+    {
+        popped.clear();
+        uint64_t item;
+        if (queue.pop(item, 1000))
+            popped.push_back(item);
+        queue.tryPopBatch(back_inserter(popped), 7);
+        for (auto value : popped)
+            BOOST_REQUIRE_EQUAL(value, expected++);
+    }
+    producer.join();
+}
+
+BOOST_AUTO_TEST_CASE(mpmcStress)
+{
+    MPMCQueue<uint64_t> queue(128);
+    const uint64_t perProducer = 50000;
+    const size_t producers = 3;
+    const size_t consumers = 3;
+    atomic<uint64_t> sum = {0};
+    atomic<uint64_t> popped = {0};
+    vector<thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p]() {
+            vector<uint64_t> batch;
+            for (uint64_t i = 1; i <= perProducer;)
+            {
+                if (i % 2)
+                {
+                    i += queue.tryPush(i + p * perProducer) ? 1 : 0;
+                    continue;
+                }
+                batch.clear();
+                for (uint64_t j = i; j < min(perProducer + 1, i + 4); ++j)
+                    batch.push_back(j + p * perProducer);
+                i += queue.tryPushBatch(batch.begin(), batch.end());
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&]() {
+            vector<uint64_t> batch;
+            while (popped < producers * perProducer)
+            {
+                batch.clear();
+                uint64_t item;
+                if (queue.pop(item, 10))
+                    batch.push_back(item);
+                queue.tryPopBatch(back_inserter(batch), 5);
+                for (auto value : batch)
+                    sum += value;
+                popped += batch.size();
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    uint64_t total = producers * perProducer;
+    BOOST_CHECK_EQUAL(popped.load(), total);
+    BOOST_CHECK_EQUAL(sum.load(), total * (total + 1) / 2);
+    BOOST_CHECK_EQUAL(queue.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(wakeParked)
+{
+    MPMCQueue<int> queue(8);
+    thread producer([&]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        queue.tryPush(7);
+    });
+    int item = 0;
+    auto start = chrono::steady_clock::now();
+    BOOST_CHECK(queue.pop(item, 5000));
+    BOOST_CHECK_EQUAL(item, 7);
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(4));
+    producer.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
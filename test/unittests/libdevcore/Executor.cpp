@@ -0,0 +1,220 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the executor shared by the task queues
+ *
+ * @file: Executor.cpp
+ */
+
+#include <libdevcore/Executor.h>
+#include <libdevcore/ThreadPool.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+/// the most tasks running at once
+class Concurrency
+{
+public:
+    void enter()
+    {
+        auto running = ++m_running;
+        auto most = m_most.load();
+        while (running > most && !m_most.compare_exchange_weak(most, running))
+        {
+        }
+    }
+    void leave() { --m_running; }
+    size_t most() const { return m_most; }
+
+private:
+    std::atomic<size_t> m_running = {0};
+    std::atomic<size_t> m_most = {0};
+};
+
+BOOST_FIXTURE_TEST_SUITE(ExecutorTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(serialQueue)
+{
+    auto queue = g_executor.queue("testSerial", TaskPriority::Normal);
+    vector<int> order;
+    Concurrency concurrency;
+    promise<void> done;
+    for (int i = 0; i < 1000; ++i)
+    {
+        queue->post([&, i]() {
+            concurrency.enter();
+            order.push_back(i);
+            concurrency.leave();
+            if (i == 999)
+            {
+                done.set_value();
+            }
+        });
+    }
+    done.get_future().wait();
+    BOOST_CHECK_EQUAL(concurrency.most(), 1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        BOOST_CHECK_EQUAL(order[i], i);
+    }
+    BOOST_CHECK_GE(g_metrics
+                       .counter("bcos_executor_tasks", "the tasks run by the queue",
+                           {{"queue", "testSerial"}})
+                       .value(),
+        999);
+}
+
+BOOST_AUTO_TEST_CASE(concurrencyOfQueue)
+{
+    ThreadPool pool("testConcurrent", 2, TaskPriority::High);
+    Concurrency concurrency;
+    std::atomic<int> left = {20};
+    promise<void> done;
+    for (int i = 0; i < 20; ++i)
+    {
+        pool.enqueue([&]() {
+            concurrency.enter();
+            this_thread::sleep_for(chrono::milliseconds(5));
+            concurrency.leave();
+            if (--left == 0)
+            {
+                done.set_value();
+            }
+        });
+    }
+    done.get_future().wait();
+    BOOST_CHECK_LE(concurrency.most(), 2);
+
+    // the low tasks leave half of the workers to the others
+    auto low = g_executor.queue("testLow", TaskPriority::Low, 64);
+    Concurrency lowConcurrency;
+    left = 64;
+    promise<void> lowDone;
+    for (int i = 0; i < 64; ++i)
+    {
+        low->post([&]() {
+            lowConcurrency.enter();
+            this_thread::sleep_for(chrono::milliseconds(2));
+            lowConcurrency.leave();
+            if (--left == 0)
+            {
+                lowDone.set_value();
+            }
+        });
+    }
+    lowDone.get_future().wait();
+    BOOST_CHECK_LE(lowConcurrency.most(), max<size_t>(g_executor.threads() / 2, 1));
+}
+
+BOOST_AUTO_TEST_CASE(stop)
+{
+    auto queue = g_executor.queue("testStop", TaskPriority::Normal);
+    std::atomic<int> executed = {0};
+    promise<void> started;
+    queue->post([&]() {
+        started.set_value();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        ++executed;
+    });
+    for (int i = 0; i < 10; ++i)
+    {
+        queue->post([&]() { ++executed; });
+    }
+    started.get_future().wait();
+    // waits for the running task, drops the others
+    queue->stop();
+    BOOST_CHECK_EQUAL(executed, 1);
+    queue->post([&]() { ++executed; });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    BOOST_CHECK_EQUAL(executed, 1);
+
+    // a task stopping its own queue doesn't wait for itself
+    auto self = g_executor.queue("testStopSelf", TaskPriority::Normal);
+    promise<void> stopped;
+    self->post([&]() {
+        self->stop();
+        stopped.set_value();
+    });
+    BOOST_CHECK(stopped.get_future().wait_for(chrono::seconds(30)) == future_status::ready);
+}
+
+BOOST_AUTO_TEST_CASE(blocking)
+{
+    // every low worker waits for a task of another low queue
+    size_t waiting = g_executor.threads() * 2;
+    auto outer = g_executor.queue("testOuter", TaskPriority::Low, waiting);
+    auto inner = g_executor.queue("testInner", TaskPriority::Low, waiting);
+    std::atomic<size_t> left = {waiting};
+    promise<void> done;
+    for (size_t i = 0; i < waiting; ++i)
+    {
+        outer->post([&]() {
+            promise<void> innerDone;
+            inner->post([&]() { innerDone.set_value(); });
+            {
+                Executor::Blocking blocking;
+                innerDone.get_future().wait();
+            }
+            if (--left == 0)
+            {
+                done.set_value();
+            }
+        });
+    }
+    BOOST_CHECK(done.get_future().wait_for(chrono::seconds(30)) == future_status::ready);
+}
+
+BOOST_AUTO_TEST_CASE(blockingHigh)
+{
+    // every worker runs a high task waiting for the serial normal queue, as the consensus
+    // waits for the flush of the storage
+    size_t waiting = g_executor.threads();
+    auto high = g_executor.queue("testHighWaiting", TaskPriority::High, waiting);
+    auto normal = g_executor.queue("testNormalAwaited", TaskPriority::Normal);
+    auto left = make_shared<std::atomic<size_t> >(waiting);
+    auto done = make_shared<promise<void> >();
+    for (size_t i = 0; i < waiting; ++i)
+    {
+        high->post([normal, left, done]() {
+            auto normalDone = make_shared<promise<void> >();
+            normal->post([normalDone]() { normalDone->set_value(); });
+            {
+                Executor::Blocking blocking;
+                normalDone->get_future().wait();
+            }
+            if (--*left == 0)
+            {
+                done->set_value();
+            }
+        });
+    }
+    BOOST_CHECK(done->get_future().wait_for(chrono::seconds(30)) == future_status::ready);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
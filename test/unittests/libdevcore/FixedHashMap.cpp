@@ -0,0 +1,155 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the open addressing map and set of FixedHash
+ *
+ * @file: FixedHashMap.cpp
+ */
+
+#include <libdevcore/FixedHashMap.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(FixedHashMapTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(sameAsUnorderedMap)
+{
+    FixedHashMap<h256, size_t> map;
+    unordered_map<h256, size_t> expected;
+    mt19937 random(7);
+    vector<h256> keys;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        // keys sharing their first word probe past each other
+        h256 key = h256::random();
+        if (i % 5 == 0 && !keys.empty())
+        {
+            key = keys[random() % keys.size()];
+            key[31] ^= 1;
+        }
+        keys.push_back(key);
+    }
+    for (size_t round = 0; round < 20000; ++round)
+    {
+        auto const& key = keys[random() % keys.size()];
+        if (random() % 3 == 0)
+        {
+            BOOST_CHECK_EQUAL(map.erase(key), expected.erase(key));
+        }
+        else
+        {
+            map[key] += round;
+            expected[key] += round;
+        }
+        BOOST_CHECK_EQUAL(map.size(), expected.size());
+    }
+    for (auto const& key : keys)
+    {
+        auto it = map.find(key);
+        auto expectedIt = expected.find(key);
+        BOOST_CHECK_EQUAL(it == map.end(), expectedIt == expected.end());
+        if (it != map.end() && expectedIt != expected.end())
+        {
+            BOOST_CHECK_EQUAL(it->second, expectedIt->second);
+        }
+    }
+    size_t iterated = 0;
+    for (auto const& entry : map)
+    {
+        BOOST_CHECK_EQUAL(expected.at(entry.first), entry.second);
+        ++iterated;
+    }
+    BOOST_CHECK_EQUAL(iterated, expected.size());
+
+    BOOST_CHECK(!map.emplace(map.begin()->first, 0).second);
+    map.erase(map.find(map.begin()->first));
+    BOOST_CHECK_EQUAL(map.size(), expected.size() - 1);
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+    BOOST_CHECK_EQUAL(map.count(keys[0]), 0);
+}
+
+BOOST_AUTO_TEST_CASE(set)
+{
+    FixedHashSet<h256> set;
+    BOOST_CHECK_EQUAL(set.count(h256()), 0);
+    BOOST_CHECK(set.insert(h256()).second);
+    BOOST_CHECK(!set.insert(h256()).second);
+    BOOST_CHECK(set.insert(h256(1)).second);
+    BOOST_CHECK_EQUAL(set.size(), 2);
+    BOOST_CHECK_EQUAL(set.erase(h256()), 1);
+    BOOST_CHECK_EQUAL(set.count(h256()), 0);
+    BOOST_CHECK(*set.begin() == h256(1));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent)
+{
+    ConcurrentFixedHashMap<h256, size_t> map;
+    vector<vector<h256>> keys(4);
+    for (auto& threadKeys : keys)
+    {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            threadKeys.push_back(h256::random());
+        }
+    }
+    vector<thread> threads;
+    for (size_t t = 0; t < keys.size(); ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < keys[t].size(); ++i)
+            {
+                map.insert(keys[t][i], i);
+                if (i % 2)
+                {
+                    map.erase(keys[t][i]);
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL(map.size(), 2000);
+    size_t value = 0;
+    BOOST_CHECK(map.get(keys[1][10], value));
+    BOOST_CHECK_EQUAL(value, 10);
+    BOOST_CHECK(!map.get(keys[1][11], value));
+    BOOST_CHECK(!map.insert(keys[1][10], 0));
+
+    ConcurrentFixedHashSet<h256> set;
+    BOOST_CHECK(set.insert(keys[0][0]));
+    BOOST_CHECK(set.count(keys[0][0]));
+    set.clear();
+    BOOST_CHECK_EQUAL(set.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,102 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief the unit test of the metrics registry
+ *
+ * @file Metrics.cpp
+ */
+
+#include <libdevcore/Metrics.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <vector>
+
+using namespace dev;
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(Metrics, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(counterFromThreads)
+{
+    auto& counter = g_metrics.counter("test_counter", "a counter", {{"group", "1"}});
+    BOOST_CHECK_EQUAL(&counter, &g_metrics.counter("test_counter", "", {{"group", "1"}}));
+    BOOST_CHECK_NE(&counter, &g_metrics.counter("test_counter", "", {{"group", "2"}}));
+    vector<thread> threads;
+    for (int i = 0; i < 16; ++i)
+    {
+        threads.emplace_back([&counter]() {
+            for (int j = 0; j < 1000; ++j)
+            {
+                counter.inc();
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL(counter.value(), 16000);
+    BOOST_CHECK_THROW(g_metrics.gauge("test_counter", ""), MetricTypeMismatch);
+}
+
+BOOST_AUTO_TEST_CASE(histogramBuckets)
+{
+    for (uint64_t v : {0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 100ull, 12345ull, ~0ull})
+    {
+        auto b = Histogram::bucket(v);
+        BOOST_CHECK(b < c_histogramBuckets);
+        BOOST_CHECK(Histogram::upperBound(b) >= v);
+        /// within 25% of the value
+        BOOST_CHECK(Histogram::upperBound(b) - v <= v / 4);
+        if (b > 0)
+        {
+            BOOST_CHECK(Histogram::upperBound(b - 1) < v);
+        }
+    }
+
+    Histogram histogram;
+    for (uint64_t v = 1; v <= 100; ++v)
+    {
+        histogram.observe(v);
+    }
+    auto snapshot = histogram.snapshot();
+    BOOST_CHECK_EQUAL(snapshot.count, 100);
+    BOOST_CHECK_EQUAL(snapshot.sum, 5050);
+    BOOST_CHECK(snapshot.quantile(0.5) >= 50 && snapshot.quantile(0.5) <= 55);
+    BOOST_CHECK(snapshot.quantile(0.99) >= 99 && snapshot.quantile(0.99) <= 111);
+}
+
+BOOST_AUTO_TEST_CASE(prometheusText)
+{
+    g_metrics.gauge("test_gauge", "a gauge", {{"name", "a\"b"}}).set(-3);
+    g_metrics.histogram("test_histogram", "a histogram").observe(10);
+    auto text = g_metrics.prometheus();
+    BOOST_CHECK(text.find("# TYPE test_gauge gauge\n") != string::npos);
+    BOOST_CHECK(text.find("test_gauge{name=\"a\\\"b\"} -3\n") != string::npos);
+    BOOST_CHECK(text.find("# TYPE test_histogram summary\n") != string::npos);
+    /// the upper bound of the bucket of 10
+    BOOST_CHECK(text.find("test_histogram{quantile=\"0.5\"} 11\n") != string::npos);
+    BOOST_CHECK(text.find("test_histogram_count 1\n") != string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -107,6 +107,66 @@ BOOST_AUTO_TEST_CASE(testOverlayDBAux)
     boost::filesystem::remove_all(path);
 }
 
+BOOST_AUTO_TEST_CASE(testOverlayDBNodeCache)
+{
+    boost::filesystem::path path("./test_overlay_db.db");
+    std::shared_ptr<dev::db::DatabaseFace> db = std::make_shared<dev::db::LevelDB>(path);
+
+    dev::OverlayDB overlayDB(db);
+    h256 key = dev::sha3("node");
+    overlayDB.insert(key, bytesConstRef("helloworld"));
+    overlayDB.commit();
+
+    // the committed node is read from the cache
+    db->kill(db::Slice(reinterpret_cast<char const*>(key.data()), key.size));
+    BOOST_CHECK(overlayDB.lookup(key) == "helloworld");
+    BOOST_CHECK(dev::OverlayDB(db).lookup(key).empty());
+
+    overlayDB.setNodeCacheCapacity(0);
+    BOOST_CHECK(overlayDB.lookup(key).empty());
+
+    boost::filesystem::remove_all(path);
+}
+
+BOOST_AUTO_TEST_CASE(testOverlayDBPruning)
+{
+    boost::filesystem::path path("./test_overlay_db.db");
+    std::shared_ptr<dev::db::DatabaseFace> db = std::make_shared<dev::db::LevelDB>(path);
+
+    dev::OverlayDB overlayDB(db);
+    overlayDB.setNodeCacheCapacity(0);
+    overlayDB.setRetainBlocks(2);
+    BOOST_CHECK_EQUAL(overlayDB.retainBlocks(), 2);
+
+    h256 first = dev::sha3("first");
+    h256 second = dev::sha3("second");
+    h256 shared = dev::sha3("shared");
+    overlayDB.insert(first, bytesConstRef("first"));
+    overlayDB.insert(shared, bytesConstRef("shared"));
+    overlayDB.insert(shared, bytesConstRef("shared"));
+    overlayDB.commit(1);
+
+    overlayDB.kill(first);
+    overlayDB.kill(shared);
+    overlayDB.insert(second, bytesConstRef("second"));
+    overlayDB.commit(2);
+    overlayDB.commit(3);
+    // the states of the last blocks still read the unreferenced nodes
+    BOOST_CHECK(overlayDB.lookup(first) == "first");
+
+    overlayDB.commit(4);
+    BOOST_CHECK(overlayDB.lookup(first).empty());
+    BOOST_CHECK(overlayDB.lookup(second) == "second");
+    BOOST_CHECK(overlayDB.lookup(shared) == "shared");
+
+    // a db written without the reference counts is never pruned
+    overlayDB.setRetainBlocks(0);
+    overlayDB.setRetainBlocks(2);
+    BOOST_CHECK_EQUAL(overlayDB.retainBlocks(), 0);
+
+    boost::filesystem::remove_all(path);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
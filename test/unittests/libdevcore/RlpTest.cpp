@@ -91,4 +91,42 @@ BOOST_AUTO_TEST_CASE(rlpRandom)
     }
 }
 
+BOOST_AUTO_TEST_CASE(presizedEncoding)
+{
+    // nested lists whose headers take one, two and three bytes
+    auto encode = [](dev::RLPStream& _s) {
+        _s.appendList(6);
+        _s << dev::u256(1024) << std::string(40, 'a');
+        _s.appendList(2) << dev::bytes(300, 7) << 2u;
+        _s.appendList(0);
+        _s.appendList(3) << 0u << dev::bytes(70000, 9) << dev::h256(5);
+        _s.appendRaw(dev::rlpList(1, 2, 3));
+    };
+    dev::RLPStream legacy;
+    encode(legacy);
+    dev::bytes presized;
+    dev::rlpEncode(presized, encode);
+    BOOST_CHECK(presized == legacy.out());
+    BOOST_CHECK_EQUAL(presized.capacity(), presized.size());
+
+    dev::bytes single;
+    dev::rlpEncode(single, [](dev::RLPStream& _s) { _s << std::string("dog"); });
+    BOOST_CHECK(single == dev::rlp(std::string("dog")));
+
+    // the second pass must append what the first measured
+    bool first = true;
+    dev::bytes out;
+    BOOST_CHECK_THROW(dev::rlpEncode(out,
+                          [&](dev::RLPStream& _s) {
+                              _s.appendList(1) << dev::bytes(first ? 10 : 11, 1);
+                              first = false;
+                          }),
+        dev::RLPException);
+    dev::RLPStream measuring;
+    measuring.startMeasuring();
+    measuring << 1u;
+    BOOST_CHECK_EQUAL(measuring.size(), 1u);
+    BOOST_CHECK_THROW(measuring.out(), dev::RLPException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
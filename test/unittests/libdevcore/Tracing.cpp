@@ -0,0 +1,94 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief the unit test of the block spans
+ *
+ * @file Tracing.cpp
+ */
+
+#include <libdevcore/Common.h>
+#include <libdevcore/Tracing.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(Tracing, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(offByDefault)
+{
+    g_tracer.configure(false, 4, "");
+    {
+        BlockSpan span("test.off", 1, 1);
+    }
+    BOOST_CHECK(g_tracer.spans().empty());
+}
+
+BOOST_AUTO_TEST_CASE(ringKeepsTheLastSpans)
+{
+    g_tracer.configure(true, 4, "");
+    for (int64_t number = 1; number <= 6; ++number)
+    {
+        BlockSpan span("test.block", number % 2 + 1, number, h256(number));
+    }
+    auto spans = g_tracer.spans();
+    BOOST_CHECK_EQUAL(spans.size(), 4);
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(spans[i].blockNumber, (int64_t)i + 3);
+        BOOST_CHECK(spans[i].blockHash == h256(i + 3));
+    }
+
+    auto group1 = g_tracer.spans(1);
+    BOOST_CHECK_EQUAL(group1.size(), 2);
+    BOOST_CHECK_EQUAL(group1[0].blockNumber, 4);
+    BOOST_CHECK_EQUAL(group1[1].blockNumber, 6);
+
+    g_tracer.recordSince("test.wait", 1, 7, h256(), utcTimeUs() - 1000);
+    g_tracer.recordSince("test.unknown", 1, 7, h256(), 0);
+    group1 = g_tracer.spans(1);
+    BOOST_CHECK_EQUAL(group1.size(), 3);
+    BOOST_CHECK_EQUAL(group1.back().blockNumber, 7);
+    BOOST_CHECK(group1.back().duration >= 1000);
+
+    g_tracer.clear();
+    BOOST_CHECK(g_tracer.spans().empty());
+    g_tracer.configure(false, c_traceCapacity, "");
+}
+
+BOOST_AUTO_TEST_CASE(chromeTrace)
+{
+    TraceSpan span;
+    span.name = "pbft.execBlock";
+    span.groupId = 2;
+    span.blockNumber = 10;
+    span.start = 100;
+    span.duration = 20;
+    auto trace = Tracer::chromeTrace({span});
+    BOOST_CHECK(trace.find("\"name\":\"pbft.execBlock\"") != string::npos);
+    BOOST_CHECK(trace.find("\"pid\":2,\"tid\":10,\"ts\":100,\"dur\":20") != string::npos);
+    BOOST_CHECK(trace.find("\"hash\":\"\"") != string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -24,6 +24,7 @@
 #include <libdevcore/Worker.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 
 using namespace dev;
 using namespace std;
@@ -52,6 +53,24 @@ private:
     int count = 0;
 };
 
+/// a worker waiting far longer than the test between its rounds
+class TestNotifiedWorker : public Worker
+{
+public:
+    TestNotifiedWorker() : Worker("TestNotifiedWorker", 60 * 1000) {}
+    ~TestNotifiedWorker() { terminate(); }
+    void run() { startWorking(); }
+    void stop() { stopWorking(); }
+    void notify() { notifyWork(); }
+    int rounds() const { return m_rounds; }
+
+protected:
+    void doWork() override { ++m_rounds; }
+
+private:
+    std::atomic<int> m_rounds = {0};
+};
+
 BOOST_FIXTURE_TEST_SUITE(Worker, TestOutputHelperFixture)
 
 BOOST_AUTO_TEST_CASE(testWorker)
@@ -62,6 +81,46 @@ BOOST_AUTO_TEST_CASE(testWorker)
     workerImpl.stop();
 }
 
+BOOST_AUTO_TEST_CASE(testNotifier)
+{
+    Notifier notifier;
+    auto seen = notifier.sequence();
+    auto start = chrono::steady_clock::now();
+    BOOST_CHECK(!notifier.wait(seen, 20));
+    BOOST_CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(10));
+    // a notification before the wait is not lost
+    notifier.notify();
+    BOOST_CHECK(notifier.wait(seen, 60 * 1000));
+    seen = notifier.sequence();
+    thread notifying([&]() {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        notifier.notify();
+    });
+    start = chrono::steady_clock::now();
+    BOOST_CHECK(notifier.wait(seen, 60 * 1000));
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+    notifying.join();
+}
+
+BOOST_AUTO_TEST_CASE(testNotifyWork)
+{
+    TestNotifiedWorker worker;
+    worker.run();
+    for (int i = 1; i <= 3; ++i)
+    {
+        worker.notify();
+        auto start = chrono::steady_clock::now();
+        while (worker.rounds() < i && chrono::steady_clock::now() - start < chrono::seconds(30))
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        BOOST_CHECK_EQUAL(worker.rounds(), i);
+    }
+    // stopping wakes the idle wait as well
+    auto start = chrono::steady_clock::now();
+    worker.stop();
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
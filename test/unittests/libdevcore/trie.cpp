@@ -714,6 +714,26 @@ void perfTestTrie(char const* _name)
     }
 }
 
+BOOST_AUTO_TEST_CASE(parallelHash256)
+{
+    // large enough for the branches of the root to be built concurrently
+    MemoryDB dm;
+    GenericTrieDB<MemoryDB> d(&dm);
+    d.init();
+    BytesMap m;
+    std::vector<bytes> values;
+    for (unsigned i = 0; i < 3000; ++i)
+    {
+        bytes k = rlp(i);
+        bytes v(1 + i % 40, (byte)i);
+        m[k] = v;
+        values.push_back(v);
+        d.insert(k, v);
+    }
+    BOOST_REQUIRE_EQUAL(hash256(m), d.root());
+    BOOST_REQUIRE_EQUAL(orderedTrieRoot(values), d.root());
+}
+
 BOOST_AUTO_TEST_CASE(triePerf)
 {
     if (test::Options::get().all)
@@ -27,7 +27,9 @@
 #include <libdevcrypto/Hash.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
+#include <atomic>
 #include <string>
+#include <thread>
 
 
 using namespace dev;
@@ -48,6 +50,46 @@ BOOST_AUTO_TEST_CASE(GM_testAESen)
     BOOST_CHECK_EQUAL(toHex(_plainData), toHex(dedata));
 }
 // #endif
+
+BOOST_AUTO_TEST_CASE(keySchedules)
+{
+    bytes key1(32, 0x11);
+    bytes key2(32, 0x22);
+    // a block aligned message is padded with a whole block
+    bytes plain(32, 0x33);
+    bytes cipher1 = aesCBCEncrypt(ref(plain), ref(key1));
+    BOOST_CHECK_EQUAL(cipher1.size(), 48u);
+    bytes cipher2 = aesCBCEncrypt(ref(plain), ref(key2));
+    BOOST_CHECK(cipher1 != cipher2);
+    // the schedule of the thread follows the key
+    BOOST_CHECK(aesCBCDecrypt(ref(cipher1), ref(key1)) == plain);
+    BOOST_CHECK(aesCBCDecrypt(ref(cipher2), ref(key2)) == plain);
+    BOOST_CHECK(aesCBCEncrypt(ref(plain), ref(key1)) == cipher1);
+    BOOST_CHECK_THROW(aesCBCDecrypt(ref(plain).cropped(0, 15), ref(key1)), std::exception);
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> failed = {0};
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            bytes key(32, (byte)t);
+            for (size_t i = 0; i < 100; ++i)
+            {
+                bytes data(i, (byte)i);
+                bytes cipher = aesCBCEncrypt(ref(data), ref(key));
+                if (aesCBCDecrypt(ref(cipher), ref(key)) != data)
+                {
+                    ++failed;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(failed, 0u);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
\ No newline at end of file
@@ -162,6 +162,28 @@ BOOST_AUTO_TEST_CASE(testSha3CommonFunc)
                 "75759ba49fdef48a80840b669"
                 "9c4cc25ecb5e60f5dd0bf889381084ca6fc4199");
 }
+
+BOOST_AUTO_TEST_CASE(testSha3Batch)
+{
+    // around the rate of 136 bytes and of different lengths in the same lanes
+    std::vector<bytes> contents;
+    for (size_t size : {0, 1, 31, 135, 136, 137, 271, 272, 300, 1000, 5, 64, 200})
+    {
+        contents.push_back(bytes(size, byte(size)));
+    }
+    std::vector<bytesConstRef> inputs;
+    for (auto const& content : contents)
+    {
+        inputs.push_back(bytesConstRef(&content));
+    }
+    auto hashes = sha3Batch(inputs);
+    BOOST_CHECK_EQUAL(hashes.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        BOOST_CHECK(hashes[i] == sha3(inputs[i]));
+    }
+    BOOST_CHECK(sha3Batch(std::vector<bytesConstRef>()).empty());
+}
 // test sha2
 BOOST_AUTO_TEST_CASE(testSha256)
 {
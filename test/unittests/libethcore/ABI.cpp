@@ -671,6 +671,31 @@ BOOST_AUTO_TEST_CASE(ContractABI_AbiOutString1)
     BOOST_CHECK(allOut[0] == "aaaaaaa");
 }
 
+BOOST_AUTO_TEST_CASE(ContractABI_AbiOutView)
+{
+    std::string s = std::string(40, 'a');
+    std::vector<std::string> v{"b", std::string(33, 'c')};
+    u256 u = 111111111;
+    ContractABI ct;
+    auto in = ct.abiIn("", s, v, u);
+    BOOST_CHECK(in.size() == 3 * 32 + ContractABI::encodedSize(s) + ContractABI::encodedSize(v));
+
+    // the views point into the decoded data
+    bytesConstRef outS;
+    std::vector<bytesConstRef> outV;
+    u256 outU;
+    BOOST_CHECK(ct.abiOut(bytesConstRef(&in), outS, outV, outU));
+    BOOST_CHECK(outS.toString() == s);
+    BOOST_CHECK(outS.data() >= in.data() && outS.data() < in.data() + in.size());
+    BOOST_CHECK(outV.size() == 2);
+    BOOST_CHECK(outV[0].toString() == v[0]);
+    BOOST_CHECK(outV[1].toString() == v[1]);
+    BOOST_CHECK(outU == u);
+
+    // views are encoded as strings
+    BOOST_CHECK(ct.abiIn("", outS, outV, outU) == in);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include <libethcore/Transaction.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
+#include <atomic>
 using namespace dev;
 using namespace dev::eth;
 
@@ -89,6 +90,110 @@ BOOST_AUTO_TEST_CASE(testExceptionCases)
     fake_block.CheckInvalidBlockData(1);
 }
 
+/// test the batch recovery of the senders of a block decoded without them
+BOOST_AUTO_TEST_CASE(testRecoverSenders)
+{
+    Secret sec = KeyPair::create().secret();
+    Address signer = toAddress(toPublic(sec));
+    Address known(0x2333);
+    FakeBlock fake_block(5, sec);
+    h256 txHash = fake_block.m_transaction[0].sha3();
+    std::atomic<size_t> lookups(0);
+    auto knownSender = [&](h256 const& _txHash) -> Address {
+        ++lookups;
+        return _txHash == txHash ? known : ZeroAddress;
+    };
+
+    /// the senders are recovered from the signatures
+    Block block(fake_block.getBlockData(), CheckTransaction::Cheap);
+    block.recoverSenders();
+    for (auto const& tx : block.transactions())
+    {
+        BOOST_CHECK(tx.sender() == signer);
+    }
+
+    /// the senders known by the txpool are forced, not recovered
+    Block knownBlock(fake_block.getBlockData(), CheckTransaction::Cheap);
+    knownBlock.recoverSenders(knownSender);
+    BOOST_CHECK_EQUAL(lookups, 5u);
+    for (auto const& tx : knownBlock.transactions())
+    {
+        BOOST_CHECK(tx.sender() == known);
+    }
+
+    /// the cheap decoding accepts a signature that can't be recovered, the batch recovery
+    /// rejects it even when the senders of the other transactions are known
+    fake_block.fakeInvalidSignature(3);
+    Block invalidBlock(fake_block.getBlockData(), CheckTransaction::Cheap);
+    BOOST_CHECK_THROW(invalidBlock.recoverSenders(), std::exception);
+    Block invalidKnownBlock(fake_block.getBlockData(), CheckTransaction::Cheap);
+    BOOST_CHECK_THROW(invalidKnownBlock.recoverSenders(knownSender), std::exception);
+    BOOST_CHECK_THROW(
+        Block(fake_block.getBlockData(), CheckTransaction::Everything), std::exception);
+}
+
+/// test the receipts indexed by offset and the access to a single transaction
+BOOST_AUTO_TEST_CASE(testIndexedReceipts)
+{
+    auto version = g_BCOSConfig.version();
+    auto supportedVersion = g_BCOSConfig.supportedVersion();
+    g_BCOSConfig.setSupportedVersion("2.2.0", V2_2_0);
+    FakeBlock fake_block(5);
+    bytes blockData = fake_block.getBlockData();
+    Block block(blockData, CheckTransaction::None);
+    checkBlock(block, fake_block, 5, 5);
+    BOOST_CHECK(block.transactionReceipts().size() == 5);
+    BOOST_CHECK(block.receiptRoot() == fake_block.getBlock().receiptRoot());
+    BOOST_CHECK(block.rlp() == blockData);
+
+    Transaction tx;
+    BOOST_CHECK(Block::decodeTransaction(ref(blockData), 3, tx));
+    BOOST_CHECK(tx == fake_block.m_transaction[3]);
+    BOOST_CHECK(Block::decodeTransaction(ref(blockData), 5, tx) == false);
+    TransactionReceipt receipt;
+    BOOST_CHECK(Block::decodeReceipt(ref(blockData), 4, receipt));
+    BOOST_CHECK(receipt.rlp() == fake_block.m_transactionReceipt[4].rlp());
+    BOOST_CHECK(Block::decodeReceipt(ref(blockData), 5, receipt) == false);
+    g_BCOSConfig.setSupportedVersion(supportedVersion, version);
+}
+
+/// test the encoding kept by the block while it's unchanged
+BOOST_AUTO_TEST_CASE(testEncodingKept)
+{
+    auto version = g_BCOSConfig.version();
+    auto supportedVersion = g_BCOSConfig.supportedVersion();
+    g_BCOSConfig.setSupportedVersion("2.2.0", V2_2_0);
+    FakeBlock fake_block(5);
+    auto blockData = std::make_shared<bytes>(fake_block.getBlockData());
+    Block block(blockData, CheckTransaction::None);
+    checkBlock(block, fake_block, 5, 5);
+    BOOST_CHECK(block.rlpP() == blockData);
+    Block copied(block);
+    BOOST_CHECK(copied.rlpP() == blockData);
+
+    /// the header is compared by hash
+    block.header().setTimestamp(block.header().timestamp() + 1);
+    auto encoded = block.rlpP();
+    BOOST_CHECK(encoded != blockData);
+    BOOST_CHECK(*encoded != *blockData);
+    BOOST_CHECK(block.rlpP() == encoded);
+    bytes out;
+    block.encode(out);
+    BOOST_CHECK(out == *encoded);
+    BOOST_CHECK(Block(out, CheckTransaction::None).header().hash() == block.header().hash());
+
+    block.setSigList(std::vector<std::pair<u256, Signature>>());
+    BOOST_CHECK(block.rlpP() != encoded);
+    BOOST_CHECK(copied.rlpP() == blockData);
+    copied.setTransactionReceipts(TransactionReceipts());
+    BOOST_CHECK(copied.rlpP() != blockData);
+
+    /// the receipts skipped are missing from the block
+    Block withoutReceipts(blockData, CheckTransaction::None, false);
+    BOOST_CHECK(withoutReceipts.rlpP() != blockData);
+    g_BCOSConfig.setSupportedVersion(supportedVersion, version);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
@@ -182,6 +182,16 @@ public:
         m_singleTransaction.updateSignature(sig);
     }
 
+    /// replace the signature of a transaction by one passing the cheap check that can't be
+    /// recovered: no point of the curve has x = 5
+    void fakeInvalidSignature(size_t index)
+    {
+        SignatureStruct sig = m_transaction[index].signature();
+        m_transaction[index].updateSignature(SignatureStruct(h256(5), sig.s, sig.v));
+        m_block.setTransactions(m_transaction);
+        m_block.encode(m_blockData);
+    }
+
     void fakeSingleTransactionReceipt()
     {
         h256 root = h256("0x1024");
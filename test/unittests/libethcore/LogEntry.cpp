@@ -22,7 +22,9 @@
  */
 
 #include <libdevcore/RLP.h>
+#include <libdevcrypto/Common.h>
 #include <libethcore/LogEntry.h>
+#include <libethcore/LogFilter.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
@@ -99,6 +101,77 @@ BOOST_AUTO_TEST_CASE(BloomTest)
     // BOOST_CHECK(bl.hex() == compareLb);
 }
 
+BOOST_AUTO_TEST_CASE(LogFilterTest)
+{
+    Address address("ccdeac59d35627b7de09332e819d5159e7bb7250");
+    h256 t1("0x12345678");
+    h256 t2("0x9abcdef0");
+    LogFilter filter;
+    filter.addresses.insert(address);
+    filter.topics.push_back(std::set<h256>());
+    filter.topics.push_back(std::set<h256>{t2});
+
+    LogEntry matched(address, h256s{t1, t2}, bytes());
+    LogEntry otherTopic(address, h256s{t1, t1}, bytes());
+    LogEntry otherAddress(Address(0x1234), h256s{t1, t2}, bytes());
+    BOOST_CHECK(filter.matches(matched));
+    BOOST_CHECK(!filter.matches(otherTopic));
+    BOOST_CHECK(!filter.matches(otherAddress));
+    BOOST_CHECK(!filter.matches(LogEntry(address, h256s{t1}, bytes())));
+    BOOST_CHECK(filter.mayMatch(matched.bloom()));
+    BOOST_CHECK(!filter.mayMatch(LogBloom()));
+
+    Block block;
+    for (u256 nonce = 1; nonce <= 2; ++nonce)
+    {
+        Transaction tx(0, 0, 0, Address(0x1), bytes(), nonce);
+        tx.updateSignature(
+            SignatureStruct(sign(KeyPair::create().secret(), tx.sha3(WithoutSignature))));
+        block.appendTransaction(tx);
+    }
+    block.appendTransactionReceipt(TransactionReceipt(h256(), 0, LogEntries{otherAddress},
+        executive::TransactionException::None, bytes()));
+    block.appendTransactionReceipt(TransactionReceipt(h256(), 0,
+        LogEntries{otherTopic, matched}, executive::TransactionException::None, bytes()));
+    LocalisedLogEntries logs;
+    filter.match(block, logs);
+    BOOST_CHECK_EQUAL(logs.size(), 1);
+    BOOST_CHECK(logs[0].transactionHash == block.transactions()[1].sha3());
+    BOOST_CHECK_EQUAL(logs[0].transactionIndex, 1);
+    BOOST_CHECK_EQUAL(logs[0].logIndex, 1);
+
+    // the block is skipped by the bloom of its receipts
+    LogFilter other;
+    other.addresses.insert(Address(0x5678));
+    BOOST_CHECK(!other.mayMatch(bloom(block.transactionReceipts())));
+    logs.clear();
+    other.match(block, logs);
+    BOOST_CHECK(logs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(BloomOperations)
+{
+    LogEntry first(Address(0x1), h256s{h256("0x12345678")}, bytes());
+    LogEntry second(Address(0x2), h256s{h256("0x9abcdef0")}, bytes());
+    LogBloom bloom = first.bloom();
+    orBloom(bloom, second.bloom());
+    BOOST_CHECK(bloom == (first.bloom() | second.bloom()));
+    BOOST_CHECK(bloom == eth::bloom(LogEntries{first, second}));
+    BOOST_CHECK(bloomContains(bloom, first.bloom()));
+    BOOST_CHECK(bloomContains(bloom, second.bloom()));
+    BOOST_CHECK(bloomContains(bloom, LogBloom()));
+    BOOST_CHECK(!bloomContains(first.bloom(), bloom));
+    BOOST_CHECK(!bloomContains(LogBloom(), first.bloom()));
+
+    TransactionReceipts receipts;
+    receipts.push_back(TransactionReceipt(h256(), 0, LogEntries{first},
+        executive::TransactionException::None, bytes()));
+    receipts.push_back(TransactionReceipt(h256(), 0, LogEntries{second},
+        executive::TransactionException::None, bytes()));
+    BOOST_CHECK(eth::bloom(receipts) == bloom);
+    BOOST_CHECK(eth::bloom(TransactionReceipts()) == LogBloom());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
\ No newline at end of file
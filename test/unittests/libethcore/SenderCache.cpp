@@ -0,0 +1,70 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for the sender cache
+ *
+ * @file SenderCache.cpp
+ * @author: ancelmo
+ * @date 2019-09-20
+ */
+#include <libethcore/SenderCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(SenderCacheTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(getAndInsert)
+{
+    SenderCache cache(1024);
+    h256 txHash(1);
+    BOOST_CHECK(cache.get(txHash) == ZeroAddress);
+
+    cache.insert(txHash, Address(0x100));
+    BOOST_CHECK(cache.get(txHash) == Address(0x100));
+    // the sender of a hash never changes
+    cache.insert(txHash, Address(0x200));
+    BOOST_CHECK(cache.get(txHash) == Address(0x100));
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(dropOldest)
+{
+    // one sender for each of the 16 shards
+    SenderCache cache(16);
+    h256 first("0100000000000000000000000000000000000000000000000000000000000001");
+    h256 second("0100000000000000000000000000000000000000000000000000000000000002");
+    h256 other("0200000000000000000000000000000000000000000000000000000000000001");
+    cache.insert(first, Address(0x100));
+    cache.insert(other, Address(0x300));
+    cache.insert(second, Address(0x200));
+
+    BOOST_CHECK(cache.get(first) == ZeroAddress);
+    BOOST_CHECK(cache.get(second) == Address(0x200));
+    BOOST_CHECK(cache.get(other) == Address(0x300));
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -25,6 +25,7 @@
 #include <libdevcore/Assertions.h>
 #include <libdevcore/CommonJS.h>
 #include <libethcore/CommonJS.h>
+#include <libethcore/EVMSchedule.h>
 #include <libethcore/Transaction.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
@@ -93,6 +94,50 @@ BOOST_AUTO_TEST_CASE(testCreateTxByRLP)
     BOOST_CHECK_NO_THROW(decodeTxRC2.decode(ref(rlpBytes)));
     g_BCOSConfig.setSupportedVersion("2.0.0-rc2", RC2_VERSION);
 }
+
+BOOST_AUTO_TEST_CASE(testDecodedTxCopy)
+{
+    std::string str = "test transaction";
+    Transaction tx(u256(100), u256(0), u256(100000000), Address(0x100),
+        bytes(str.begin(), str.end()));
+    KeyPair sigKeyPair = KeyPair::create();
+    SignatureStruct sig = dev::sign(sigKeyPair.secret(), tx.sha3(WithoutSignature));
+    tx.updateSignature(sig);
+    bytes encodeBytes = tx.rlp();
+
+    Transaction decodeTx(ref(encodeBytes), CheckTransaction::Cheap);
+    Transaction copyTx = decodeTx;
+    BOOST_CHECK(copyTx.data().data() == decodeTx.data().data());
+    BOOST_CHECK(copyTx.rlp() == encodeBytes);
+    BOOST_CHECK(copyTx.sha3() == tx.sha3());
+    // only the signed transaction is cached
+    BOOST_CHECK(copyTx.rlp(WithoutSignature) == tx.rlp(WithoutSignature));
+    BOOST_CHECK(copyTx.rlp(WithoutSignature) != encodeBytes);
+
+    copyTx.setNonce(u256(1));
+    BOOST_CHECK(copyTx.rlp() != encodeBytes);
+    BOOST_CHECK(decodeTx.rlp() == encodeBytes);
+}
+
+BOOST_AUTO_TEST_CASE(testBaseGasRequired)
+{
+    bytes data = {0, 1, 0, 2, 3};
+    Transaction call(u256(0), u256(0), u256(100000000), Address(0x100), data);
+    Transaction create(u256(0), u256(0), u256(100000000), data);
+    EVMSchedule const& schedule = DefaultSchedule;
+    BOOST_CHECK_EQUAL(call.baseGasRequired(schedule),
+        schedule.txGas + 2 * schedule.txDataZeroGas + 3 * schedule.txDataNonZeroGas);
+    BOOST_CHECK_EQUAL(create.baseGasRequired(schedule),
+        Transaction::baseGasRequired(true, ref(data), schedule));
+
+    // the zero bytes are counted again by the decoded transaction
+    KeyPair sigKeyPair = KeyPair::create();
+    SignatureStruct sig = dev::sign(sigKeyPair.secret(), call.sha3(WithoutSignature));
+    call.updateSignature(sig);
+    bytes encodeBytes = call.rlp();
+    Transaction decodeTx(ref(encodeBytes), CheckTransaction::Cheap);
+    BOOST_CHECK_EQUAL(decodeTx.baseGasRequired(schedule), call.baseGasRequired(schedule));
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
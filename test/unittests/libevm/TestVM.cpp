@@ -0,0 +1,54 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief : the EVMC VM library loaded by the tests of VMFactory::load, built as libtestvm apart
+ * from the test binary. It rejects every execution, which runs it on the interpreter instead.
+ */
+
+#include <evmc/evmc.h>
+
+namespace
+{
+void destroy(evmc_instance* _instance)
+{
+    (void)_instance;
+}
+
+evmc_result execute(evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
+    const evmc_message* _msg, uint8_t const* _code, size_t _codeSize) noexcept
+{
+    (void)_instance;
+    (void)_context;
+    (void)_rev;
+    (void)_msg;
+    (void)_code;
+    (void)_codeSize;
+    evmc_result result{};
+    result.status_code = EVMC_REJECTED;
+    return result;
+}
+}  // namespace
+
+extern "C" evmc_instance* evmc_create_testvm() noexcept
+{
+    static evmc_instance s_instance{
+        EVMC_ABI_VERSION, "testvm", "0.0.0", ::destroy, ::execute,
+        nullptr,  // set_tracer
+        nullptr,  // set_option
+    };
+    return &s_instance;
+}
@@ -27,6 +27,7 @@
 #include <libinterpreter/interpreter.h>
 #include <test/tools/libbcos/Options.h>
 #include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace dev;
@@ -86,6 +87,38 @@ BOOST_AUTO_TEST_CASE(testToRevision)
     BOOST_CHECK(EVMC_CONSTANTINOPLE == toRevision(schedule));
 }
 
+/// test the EVMC VM libraries loaded for the groups by tx_execute.vm
+BOOST_AUTO_TEST_CASE(testLoad)
+{
+    BOOST_CHECK(VMFactory::load("interpreter") == nullptr);
+    BOOST_CHECK(VMFactory::load("") == nullptr);
+    /// a library that failed to load isn't kept, the path is opened again
+    boost::filesystem::path dir =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::path path = dir / boost::filesystem::path(TEST_VM_PATH).filename();
+    BOOST_CHECK_THROW(VMFactory::load(path.string()), std::exception);
+    BOOST_CHECK_THROW(VMFactory::load(path.string()), std::exception);
+
+    boost::filesystem::create_directories(dir);
+    boost::filesystem::copy_file(TEST_VM_PATH, path);
+    EVMCCreateFn createFn = VMFactory::load(path.string());
+    BOOST_REQUIRE(createFn != nullptr);
+    BOOST_CHECK_EQUAL(createFn()->name, "testvm");
+    /// the group loading a path loaded before gets its create function without opening it
+    boost::filesystem::remove_all(dir);
+    BOOST_CHECK(VMFactory::load(path.string()) == createFn);
+
+    /// the VM rejects the execution, run on the interpreter instead
+    std::string code_str = "ExtVMFace Test";
+    bytes code(code_str.begin(), code_str.end());
+    EnvInfo env_info = InitEnvInfo::createEnvInfo(u256(300000), u256(300000));
+    CallParameters param = InitCallParams::createRandomCallParams();
+    FakeExtVM fake_ext_vm(env_info, param.codeAddress, param.senderAddress, param.senderAddress,
+        param.valueTransfer, param.gas, param.data, code, sha3(code_str), 0, false, true);
+    u256 io_gas = u256(200000);
+    BOOST_CHECK_NO_THROW(VMFactory::create(createFn)->exec(io_gas, fake_ext_vm, OnOpFunc{}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
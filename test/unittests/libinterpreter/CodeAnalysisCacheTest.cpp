@@ -0,0 +1,87 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file CodeAnalysisCacheTest.cpp
+ * @author: ancelmo
+ * @date 2019-09-16
+ */
+
+#include <libinterpreter/CodeAnalysisCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(CodeAnalysisCacheTest, TestOutputHelperFixture)
+
+static CodeAnalysis::Ptr newAnalysis(size_t _codeSize)
+{
+    auto analysis = make_shared<CodeAnalysis>();
+    analysis->code.resize(_codeSize);
+    return analysis;
+}
+
+BOOST_AUTO_TEST_CASE(getAndStore)
+{
+    CodeAnalysisCache cache(1024);
+    h256 hash(1);
+    BOOST_CHECK(cache.get(hash) == nullptr);
+
+    auto analysis = newAnalysis(100);
+    cache.store(hash, analysis);
+    BOOST_CHECK(cache.get(hash) == analysis);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+
+    auto other = newAnalysis(200);
+    cache.store(hash, other);
+    BOOST_CHECK(cache.get(hash) == other);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(evictLeastRecentlyUsed)
+{
+    CodeAnalysisCache cache(300);
+    cache.store(h256(1), newAnalysis(100));
+    cache.store(h256(2), newAnalysis(100));
+    cache.store(h256(3), newAnalysis(100));
+
+    // 1 becomes the most recently used, 2 is evicted
+    BOOST_CHECK(cache.get(h256(1)) != nullptr);
+    cache.store(h256(4), newAnalysis(100));
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK(cache.get(h256(1)) != nullptr);
+    BOOST_CHECK(cache.get(h256(2)) == nullptr);
+    BOOST_CHECK(cache.get(h256(3)) != nullptr);
+    BOOST_CHECK(cache.get(h256(4)) != nullptr);
+
+    // an analysis larger than the capacity is still kept alone
+    cache.store(h256(5), newAnalysis(1000));
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(cache.get(h256(5)) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
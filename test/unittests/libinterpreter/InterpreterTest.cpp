@@ -135,6 +135,28 @@ BOOST_AUTO_TEST_CASE(addTest)
     BOOST_CHECK(0 == result.status_code);
 }
 
+BOOST_AUTO_TEST_CASE(reusedFrameTest)
+{
+    // The VM of an execution is reused by the next one with empty memory
+    // PUSH1 01 PUSH2 0100 MSTORE STOP
+    // MSIZE PUSH1 00 MSTORE PUSH1 20 PUSH1 00 RETURN
+    dev::eth::EVMSchedule const& schedule = DefaultSchedule;
+    Address destination{KeyPair::create().address()};
+    bytes data;
+    evmc_result result = evmc.execute(schedule, fromHex("60016101005200"), data, destination,
+        destination, 0, 1000000, 0, false, false);
+    BOOST_CHECK(0 == result.status_code);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        result = evmc.execute(schedule, fromHex("5960005260206000f3"), data, destination,
+            destination, 0, 1000000, 0, false, false);
+        BOOST_CHECK(0 == result.status_code);
+        BOOST_CHECK_EQUAL(result.output_size, 32);
+        BOOST_CHECK(u256(0) == fromBigEndian<u256>(bytesConstRef(result.output_data, 32)));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(contractDeployTest)
 {
     /*
@@ -1229,6 +1251,46 @@ BOOST_AUTO_TEST_CASE(errorCodeTest)
     BOOST_CHECK(result.status_code == EVMC_BAD_JUMP_DESTINATION);
 }
 
+BOOST_AUTO_TEST_CASE(blockGasTest)
+{
+    // the constant gas of a basic block is charged on entering it, the gas seen and left must be
+    // the same as when every instruction is metered on its own
+    dev::eth::EVMSchedule const& schedule = DefaultSchedule;
+    bytes data = fromHex("");
+    Address destination{KeyPair::create().address()};
+    Address caller = destination;
+    u256 value = 0;
+    int32_t depth = 0;
+    bool isCreate = false;
+    bool isStaticCall = false;
+
+    // PUSH1 01 PUSH1 02 ADD GAS PUSH1 00 MSTORE PUSH1 20 PUSH1 00 RETURN
+    bytes code = fromHex("60016002015a60005260206000f3");
+    evmc_result result = evmc.execute(
+        schedule, code, data, destination, caller, value, 1000, depth, isCreate, isStaticCall);
+    BOOST_CHECK(result.status_code == EVMC_SUCCESS);
+    u256 gas = 0;
+    for (size_t i = 0; i < 32; i++)
+        gas = (gas << 8) | result.output_data[i];
+    BOOST_CHECK_EQUAL(gas, 1000 - 11);
+    BOOST_CHECK_EQUAL(result.gas_left, 1000 - 26);
+
+    // the gas left doesn't cover the block: PUSH1 01 PUSH1 02 ADD
+    code = fromHex("6001600201");
+    result = evmc.execute(
+        schedule, code, data, destination, caller, value, 8, depth, isCreate, isStaticCall);
+    BOOST_CHECK(result.status_code == EVMC_OUT_OF_GAS);
+
+    // the stack underflows before the gas runs out: PUSH1 01 ADD
+    code = fromHex("600101");
+    result = evmc.execute(
+        schedule, code, data, destination, caller, value, 4, depth, isCreate, isStaticCall);
+    BOOST_CHECK(result.status_code == EVMC_STACK_UNDERFLOW);
+    result = evmc.execute(
+        schedule, code, data, destination, caller, value, 1000, depth, isCreate, isStaticCall);
+    BOOST_CHECK(result.status_code == EVMC_STACK_UNDERFLOW);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,88 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file VMProfileTest.cpp
+ * @author: ancelmo
+ * @date 2019-11-25
+ */
+
+#include <libinterpreter/VMProfile.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(VMProfileTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(categories)
+{
+    BOOST_CHECK(opCategory(0x01) == OpCategory::Arithmetic);  // ADD
+    BOOST_CHECK(opCategory(0x14) == OpCategory::Logic);       // EQ
+    BOOST_CHECK(opCategory(0x20) == OpCategory::Sha3);
+    BOOST_CHECK(opCategory(0x33) == OpCategory::Environment);  // CALLER
+    BOOST_CHECK(opCategory(0x43) == OpCategory::Block);        // NUMBER
+    BOOST_CHECK(opCategory(0x60) == OpCategory::Stack);        // PUSH1
+    BOOST_CHECK(opCategory(0x52) == OpCategory::Memory);       // MSTORE
+    BOOST_CHECK(opCategory(0x55) == OpCategory::Storage);      // SSTORE
+    BOOST_CHECK(opCategory(0x57) == OpCategory::Flow);         // JUMPI
+    BOOST_CHECK(opCategory(0xa1) == OpCategory::Log);          // LOG1
+    BOOST_CHECK(opCategory(0xf1) == OpCategory::Call);         // CALL
+    BOOST_CHECK(opCategory(0xfd) == OpCategory::Halt);         // REVERT
+    BOOST_CHECK(opCategory(0xfe) == OpCategory::Other);        // INVALID
+    BOOST_CHECK_EQUAL(opCategoryName(OpCategory::Storage), "storage");
+}
+
+BOOST_AUTO_TEST_CASE(recordAndMerge)
+{
+    auto& profiler = VMProfiler::instance();
+    profiler.reset();
+
+    ContractProfile profile;
+    profile.executions = 1;
+    profile.ops[0x54] = 2;
+    profile.categoryOps[static_cast<size_t>(OpCategory::Storage)] = 2;
+    profile.categoryTime[static_cast<size_t>(OpCategory::Storage)] = 100;
+    profile.categoryTime[static_cast<size_t>(OpCategory::Stack)] = 20;
+    BOOST_CHECK_EQUAL(profile.time(), 120);
+
+    Address contract(0x1234);
+    profiler.record(contract, profile);
+    profiler.record(contract, profile);
+    profiler.record(Address(0x5678), profile);
+
+    auto contracts = profiler.contracts();
+    BOOST_CHECK_EQUAL(contracts.size(), 2);
+    auto const& merged = contracts[contract];
+    BOOST_CHECK_EQUAL(merged.executions, 2);
+    BOOST_CHECK_EQUAL(merged.ops[0x54], 4);
+    BOOST_CHECK_EQUAL(merged.time(), 240);
+
+    profiler.reset();
+    BOOST_CHECK(profiler.contracts().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -24,6 +24,8 @@
  * @date 2018-10-24
  */
 #include <fisco-bcos/Fake.h>
+#include <libstorage/CachedStorage.h>
+#include <libledger/GroupScheduler.h>
 #include <libledger/Ledger.h>
 #include <libledger/LedgerManager.h>
 #include <test/tools/libutils/Common.h>
@@ -112,6 +114,9 @@ public:
     {
         m_dbInitializer = _dbInitializer;
     }
+
+    bool initRealBlockChain() { return Ledger::initBlockChain(FakeLedger::m_genesisParam); }
+    bool initRealBlockVerifier() { return Ledger::initBlockVerifier(); }
 };
 
 BOOST_FIXTURE_TEST_SUITE(LedgerTest, TestOutputHelperFixture)
@@ -179,6 +184,7 @@ BOOST_AUTO_TEST_CASE(testGensisConfig)
     configurationPath = getTestPath().string() + "/fisco-bcos-data/group.10.ini";
     fakeLedger.initIniConfig(configurationPath);
     BOOST_CHECK(fakeLedger.getParam()->mutableTxPoolParam().txPoolLimit == 150000);
+    BOOST_CHECK(fakeLedger.getParam()->mutableTxPoolParam().memoryLimit == 512);
     BOOST_CHECK(fakeLedger.getParam()->mutableTxParam().enableParallel == true);
     BOOST_CHECK(fakeLedger.getParam()->mutableConsensusParam().maxTTL == 3);
 
@@ -294,6 +300,73 @@ BOOST_AUTO_TEST_CASE(testInitMPTLevelDB)
     BOOST_CHECK_NO_THROW(ledger->initLedger(configurationPath));
 }
 
+/// test the EVMC VM of the group set by tx_execute.vm
+BOOST_AUTO_TEST_CASE(testInitVM)
+{
+    TxPoolFixture txpool_creator;
+    KeyPair key_pair = KeyPair::create();
+    dev::GROUP_ID groupId = 10;
+    FakeLedgerForTest fakeLedger(txpool_creator.m_topicService, groupId, key_pair, "");
+    fakeLedger.init(getTestPath().string() + "/fisco-bcos-data/group.10.genesis");
+    fakeLedger.initIniConfig(getTestPath().string() + "/fisco-bcos-data/group.10.ini");
+    /// the interpreter by default
+    BOOST_CHECK(fakeLedger.getParam()->mutableTxParam().vm == "interpreter");
+
+    boost::property_tree::ptree pt;
+    fakeLedger.initDBConfig(pt);
+    std::shared_ptr<dev::ledger::DBInitializer> dbInitializer =
+        std::make_shared<dev::ledger::DBInitializer>(fakeLedger.getParam());
+    dbInitializer->initStorageDB();
+    dbInitializer->initState(dev::sha3("abc"));
+    fakeLedger.setDBInitializer(dbInitializer);
+    BOOST_REQUIRE(fakeLedger.initRealBlockChain());
+
+    /// all the nodes of a group run the same VM, one that can't be loaded fails the group
+    fakeLedger.getParam()->mutableTxParam().vm = "/not/exist/libvm.so";
+    BOOST_CHECK(fakeLedger.initRealBlockVerifier() == false);
+    BOOST_CHECK(fakeLedger.blockVerifier() == nullptr);
+    fakeLedger.getParam()->mutableTxParam().vm = "interpreter";
+    BOOST_CHECK(fakeLedger.initRealBlockVerifier() == true);
+    BOOST_CHECK(fakeLedger.blockVerifier() != nullptr);
+}
+
+/// test the cache budget tuned by the memory of the process
+BOOST_AUTO_TEST_CASE(testCacheTuning)
+{
+    int64_t MB = 1024 * 1024;
+    auto scheduler = std::make_shared<GroupScheduler>(1);
+    auto cachedStorage = std::make_shared<dev::storage::CachedStorage>();
+    cachedStorage->setMaxCapacity(256 * MB);
+    scheduler->addGroup(1, 1, 0);
+    scheduler->setCachedStorage(1, cachedStorage);
+    scheduler->setCacheTuning(64 * MB, 1024 * MB, 80);
+    BOOST_CHECK(scheduler->cacheTuning());
+    scheduler->start();
+    /// starts from the capacity of the group
+    BOOST_CHECK_EQUAL(scheduler->cacheBudget(), 256 * MB);
+
+    /// memory to spare but nothing missed, the empty cache is cleared less often
+    scheduler->tuneCache(100 * MB, 4096 * MB);
+    BOOST_CHECK_EQUAL(scheduler->cacheBudget(), 256 * MB);
+    BOOST_CHECK_EQUAL(cachedStorage->maxCapacity(), 256 * MB);
+    BOOST_CHECK_EQUAL(cachedStorage->clearInterval(), 2000);
+
+    /// 40MB over 80% of the limit, a quarter is given back at least
+    scheduler->tuneCache(1000 * MB, 1200 * MB);
+    BOOST_CHECK_EQUAL(scheduler->cacheBudget(), 192 * MB);
+    BOOST_CHECK_EQUAL(cachedStorage->maxCapacity(), 192 * MB);
+    BOOST_CHECK_EQUAL(cachedStorage->clearInterval(), 1000);
+
+    /// shrunk down to the min budget at most
+    scheduler->tuneCache(4096 * MB, 1024 * MB);
+    BOOST_CHECK_EQUAL(scheduler->cacheBudget(), 64 * MB);
+    BOOST_CHECK_EQUAL(cachedStorage->clearInterval(), 500);
+    scheduler->tuneCache(4096 * MB, 1024 * MB);
+    BOOST_CHECK_EQUAL(scheduler->cacheBudget(), 64 * MB);
+    BOOST_CHECK_EQUAL(scheduler->groupStats(1)["cacheClearInterval"].asUInt64(), 250);
+    scheduler->stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
@@ -17,9 +17,11 @@
 /// @file
 /// State unit tests.
 
+#include <libdevcore/LevelDB.h>
 #include <libethcore/Block.h>
 #include <libmptstate/Defaults.h>
 #include <libmptstate/State.h>
+#include <tbb/task_arena.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
@@ -47,6 +49,85 @@ BOOST_AUTO_TEST_CASE(LoadAccountCode)
     BOOST_CHECK(std::equal(std::begin(codeData), std::end(codeData), std::begin(loadedCode)));
 }
 
+BOOST_AUTO_TEST_CASE(parallelCommitKeepsTheRoot)
+{
+    auto fill = [](State& _state) {
+        for (unsigned i = 1; i <= 200; ++i)
+        {
+            Address addr{i};
+            _state.addBalance(addr, i);
+            for (unsigned j = 0; j < i % 7; ++j)
+                _state.setStorage(addr, u256(j), u256(i * 1000 + j));
+        }
+        _state.kill(Address{5});
+    };
+    State sequential{0};
+    fill(sequential);
+    tbb::task_arena one(1);
+    one.execute([&]() { sequential.commit(); });
+
+    State parallel{0};
+    fill(parallel);
+    parallel.commit();
+    BOOST_CHECK_EQUAL(parallel.rootHash(), sequential.rootHash());
+    BOOST_CHECK_EQUAL(parallel.storage(Address{20}, u256(5)), u256(20005));
+}
+
+BOOST_AUTO_TEST_CASE(flatStateFollowsTheLatestState)
+{
+    boost::filesystem::path path("./test_flat_state.db");
+    OverlayDB db(std::make_shared<dev::db::LevelDB>(path));
+    db.setFlatState(true);
+    BOOST_CHECK(db.flatState());
+
+    Address a{1};
+    Address b{2};
+    State first(0, db, BaseState::Empty);
+    first.addBalance(a, 10);
+    first.setStorage(a, 1, 11);
+    first.setStorage(a, 2, 12);
+    first.addBalance(b, 5);
+    first.commit();
+    first.db().commit(1);
+    auto firstRoot = first.rootHash();
+
+    State second(0, db);
+    second.setRoot(firstRoot);
+    BOOST_CHECK_EQUAL(second.storage(a, 2), 12);
+    second.setStorage(a, 1, 0);
+    second.setStorage(a, 3, 13);
+    second.kill(b);
+    second.commit();
+    second.db().commit(2);
+
+    State latest(0, db);
+    latest.setRoot(second.rootHash());
+    BOOST_CHECK_EQUAL(latest.balance(a), 10);
+    BOOST_CHECK_EQUAL(latest.storage(a, 1), 0);
+    BOOST_CHECK_EQUAL(latest.storage(a, 2), 12);
+    BOOST_CHECK_EQUAL(latest.storage(a, 3), 13);
+    BOOST_CHECK(!latest.addressInUse(b));
+
+    // the contract overwritten leaves no storage behind
+    latest.clearStorage(a);
+    latest.setCode(a, bytes{1, 2, 3});
+    BOOST_CHECK_EQUAL(latest.storage(a, 3), 0);
+    latest.commit();
+    BOOST_CHECK_EQUAL(latest.storage(a, 2), 0);
+    latest.db().commit(3);
+    State third(0, db);
+    third.setRoot(latest.rootHash());
+    BOOST_CHECK_EQUAL(third.storage(a, 2), 0);
+
+    // an older state reads the trie
+    State old(0, db);
+    old.setRoot(firstRoot);
+    BOOST_CHECK_EQUAL(old.storage(a, 1), 11);
+    BOOST_CHECK_EQUAL(old.balance(b), 5);
+
+    boost::filesystem::remove_all(path);
+}
+
 class AddressRangeTestFixture : public TestOutputHelperFixture
 {
 public:
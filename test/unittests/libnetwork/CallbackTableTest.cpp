@@ -0,0 +1,93 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the callback table and the timing wheel of the sessions
+ *
+ * @file CallbackTableTest.cpp
+ */
+
+#include <libnetwork/CallbackTable.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::network;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(CallbackTableTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testCallbackTable)
+{
+    CallbackTable table(4);
+    std::vector<ResponseCallback::Ptr> callbacks;
+    for (uint32_t seq = 1; seq <= 5; ++seq)
+    {
+        callbacks.push_back(std::make_shared<ResponseCallback>());
+        table.add(seq, callbacks.back());
+    }
+    // the seq 5 shares the slot of the seq 1 and goes to the overflow
+    BOOST_CHECK_EQUAL(table.size(), 5);
+    BOOST_CHECK(table.get(1) == callbacks[0]);
+    BOOST_CHECK(table.get(5) == callbacks[4]);
+    BOOST_CHECK(table.get(9) == nullptr);
+
+    // a callback is taken once, by the response or by the timeout
+    BOOST_CHECK(table.take(1) == callbacks[0]);
+    BOOST_CHECK(table.take(1) == nullptr);
+    BOOST_CHECK(table.take(5) == callbacks[4]);
+    BOOST_CHECK(table.get(5) == nullptr);
+    BOOST_CHECK_EQUAL(table.size(), 3);
+
+    // the freed slot is reused
+    auto callback = std::make_shared<ResponseCallback>();
+    table.add(9, callback);
+    BOOST_CHECK(table.get(9) == callback);
+    BOOST_CHECK_EQUAL(table.takeAll().size(), 4);
+    BOOST_CHECK_EQUAL(table.size(), 0);
+    BOOST_CHECK(table.get(2) == nullptr);
+
+    BOOST_CHECK_THROW(CallbackTable(3), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(testTimingWheel)
+{
+    TimingWheel wheel(10, 4);
+    std::vector<int> expired;
+    wheel.add(5, [&]() { expired.push_back(1); });
+    wheel.add(30, [&]() { expired.push_back(3); });
+    // longer than a turn of the wheel
+    wheel.add(60, [&]() { expired.push_back(6); });
+    BOOST_CHECK_EQUAL(wheel.size(), 3);
+
+    wheel.tick();
+    BOOST_CHECK(expired == std::vector<int>({1}));
+    wheel.tick();
+    wheel.tick();
+    BOOST_CHECK(expired == std::vector<int>({1, 3}));
+    wheel.tick();
+    wheel.tick();
+    BOOST_CHECK_EQUAL(expired.size(), 2);
+    wheel.tick();
+    BOOST_CHECK(expired == std::vector<int>({1, 3, 6}));
+    BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -106,6 +106,22 @@ public:
         });
     }
 
+    void asyncWrite(std::shared_ptr<SocketFace> socket,
+        std::vector<boost::asio::const_buffer> const& buffers, ReadWriteHandler handler) override
+    {
+        m_ioService->post([socket, buffers, handler]() {
+            if (socket->isConnected())
+            {
+                auto fakeSocket = std::dynamic_pointer_cast<FakeSocket>(socket);
+                bytes data(boost::asio::buffer_size(buffers));
+                boost::asio::buffer_copy(boost::asio::buffer(data), buffers);
+                fakeSocket->write(boost::asio::buffer(data));
+                boost::system::error_code ec;
+                handler(ec, data.size());
+            }
+        });
+    }
+
     void asyncRead(
         std::shared_ptr<SocketFace>, boost::asio::mutable_buffers_1, ReadWriteHandler) override
     {}
@@ -112,6 +112,27 @@ BOOST_AUTO_TEST_CASE(ASIOInterface)
     m_asioInterface->ASIOInterface::newSocket();
 }
 
+BOOST_AUTO_TEST_CASE(SessionIOServices)
+{
+    auto asioInterface = std::make_shared<dev::network::ASIOInterface>();
+    asioInterface->setIOService(std::make_shared<ba::io_service>());
+    // the sessions share the io_service of the host by default
+    BOOST_CHECK(&asioInterface->sessionIOService(NodeIPEndpoint()) ==
+                asioInterface->ioService().get());
+
+    std::vector<std::shared_ptr<ba::io_service>> ioServices{
+        std::make_shared<ba::io_service>(), std::make_shared<ba::io_service>()};
+    asioInterface->setSessionIOServices(ioServices);
+    // the connections to a peer stay on the same io_service
+    NodeIPEndpoint peer(boost::asio::ip::address::from_string("127.0.0.1"), 30300, 30300);
+    auto& ioService = asioInterface->sessionIOService(peer);
+    BOOST_CHECK(&ioService == &asioInterface->sessionIOService(peer));
+    BOOST_CHECK(&ioService != asioInterface->ioService().get());
+    // the accepted connections take the io_services in turn
+    BOOST_CHECK(&asioInterface->sessionIOService(NodeIPEndpoint()) !=
+                &asioInterface->sessionIOService(NodeIPEndpoint()));
+}
+
 BOOST_AUTO_TEST_CASE(Hostfunctions)
 {
     BOOST_CHECK(m_port == m_host->listenPort());
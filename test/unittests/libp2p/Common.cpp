@@ -27,7 +27,11 @@
 #include <libdevcore/CommonIO.h>
 
 #include <libdevcore/Assertions.h>
+#include <libconfig/GlobalConfigure.h>
 #include <libp2p/P2PMessage.h>
+#include <libp2p/P2PMessageRC2.h>
+#include <libp2p/P2PTraffic.h>
+#include <libp2p/TopicIndex.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
@@ -152,6 +156,181 @@ BOOST_AUTO_TEST_CASE(testMessage)
     BOOST_CHECK_EQUAL("topic", t);*/
 }
 
+BOOST_AUTO_TEST_CASE(testCompressMessage)
+{
+    bool compress = g_BCOSConfig.compressEnabled();
+    g_BCOSConfig.setCompress(true);
+    uint64_t compressed = compressStats().compressed;
+    uint64_t skipped = compressStats().skipped;
+
+    auto msg = std::make_shared<p2p::P2PMessageRC2>();
+    msg->setProtocolID(2);
+    msg->setPacketType(2);
+    msg->setSeq(1);
+    auto data = std::make_shared<bytes>(4096, 'a');
+    msg->setBuffer(data);
+    bytes buffer;
+    msg->encode(buffer);
+    BOOST_CHECK(buffer.size() < p2p::P2PMessageRC2::HEADER_LENGTH + data->size());
+    BOOST_CHECK_EQUAL(compressStats().compressed, compressed + 1);
+
+    // the receiver uncompresses the flagged message whether it compresses its own or not
+    g_BCOSConfig.setCompress(false);
+    auto message = std::make_shared<p2p::P2PMessageRC2>();
+    BOOST_CHECK(message->decode(buffer.data(), buffer.size()) == (ssize_t)buffer.size());
+    BOOST_CHECK(*message->buffer() == *data);
+    BOOST_CHECK((message->version() & dev::eth::CompressFlag) == 0);
+    BOOST_CHECK(message->seq() == 1);
+
+    // the messages under the threshold are sent raw
+    g_BCOSConfig.setCompress(true);
+    auto small = std::make_shared<p2p::P2PMessageRC2>();
+    small->setBuffer(std::make_shared<bytes>(16, 'a'));
+    small->encode(buffer);
+    BOOST_CHECK_EQUAL(buffer.size(), p2p::P2PMessageRC2::HEADER_LENGTH + 16);
+    BOOST_CHECK_EQUAL(compressStats().skipped, skipped + 1);
+
+    g_BCOSConfig.setCompress(compress);
+}
+
+BOOST_AUTO_TEST_CASE(testBufferPool)
+{
+    auto pool = std::make_shared<BufferPool>(2, 1024);
+    auto buffer = pool->get(16);
+    BOOST_CHECK(buffer->empty());
+    BOOST_CHECK(buffer->capacity() >= 16);
+    bytes* raw = buffer.get();
+    // the buffer goes back to the pool when it's released and is reused
+    buffer.reset();
+    BOOST_CHECK_EQUAL(pool->size(), 1);
+    buffer = pool->get(8);
+    BOOST_CHECK(buffer.get() == raw);
+    BOOST_CHECK_EQUAL(pool->size(), 0);
+
+    // the buffers grown past the limit are freed
+    buffer->resize(4096);
+    buffer.reset();
+    BOOST_CHECK_EQUAL(pool->size(), 0);
+
+    // the payload of a decoded message is taken from the pool of the sessions
+    auto msg = std::make_shared<p2p::P2PMessageRC2>();
+    msg->setBuffer(std::make_shared<bytes>(64, 'a'));
+    bytes data;
+    msg->encode(data);
+    size_t pooled = BufferPool::instance()->size();
+    auto message = std::make_shared<p2p::P2PMessageRC2>();
+    BOOST_CHECK(message->decode(data.data(), data.size()) == (ssize_t)data.size());
+    BOOST_CHECK(*message->buffer() == bytes(64, 'a'));
+    message.reset();
+    BOOST_CHECK_EQUAL(BufferPool::instance()->size(), pooled == 0 ? 1 : pooled);
+}
+
+BOOST_AUTO_TEST_CASE(testSharedEncodedData)
+{
+    for (auto msg : {std::make_shared<p2p::P2PMessage>(),
+             std::dynamic_pointer_cast<p2p::P2PMessage>(std::make_shared<p2p::P2PMessageRC2>())})
+    {
+        msg->setBuffer(std::make_shared<bytes>(64, 'a'));
+        msg->setSeq(1);
+        // the sessions a message is multicast to share one encoded buffer
+        auto encoded = msg->encodedData();
+        BOOST_CHECK(msg->encodedData() == encoded);
+        bytes data;
+        msg->encode(data);
+        BOOST_CHECK(data == *encoded);
+
+        // a modified message is encoded into a new buffer, the queued one is kept as it is
+        bytes queued = *encoded;
+        msg->setSeq(2);
+        auto reencoded = msg->encodedData();
+        BOOST_CHECK(reencoded != encoded);
+        BOOST_CHECK(*encoded == queued);
+        BOOST_CHECK(*reencoded != queued);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testTopicIndex)
+{
+    TopicIndex<int> index;
+    index.update(1, {"a", "b.1"});
+    index.update(2, {"b.*", "a"});
+    index.update(3, {"*"});
+    BOOST_CHECK(index.find("a") == std::set<int>({1, 2, 3}));
+    BOOST_CHECK(index.find("b.1") == std::set<int>({1, 2, 3}));
+    BOOST_CHECK(index.find("b.2") == std::set<int>({2, 3}));
+    BOOST_CHECK(index.find("b") == std::set<int>({3}));
+    BOOST_CHECK(index.topics() == std::set<std::string>({"a", "b.1", "b.*", "*"}));
+
+    // only the topics added and removed are updated
+    index.update(2, {"a", "c"});
+    index.remove(3);
+    BOOST_CHECK(index.find("b.2").empty());
+    BOOST_CHECK(index.find("c") == std::set<int>({2}));
+    BOOST_CHECK(index.find("a") == std::set<int>({1, 2}));
+    index.remove(1);
+    index.remove(2);
+    BOOST_CHECK(index.topics().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testHandshakeStat)
+{
+    HandshakeStat stat;
+    BOOST_CHECK_EQUAL(stat.averageTimeCost(), 0);
+    stat.record(3000, false);
+    stat.record(1000, true);
+    stat.record(2000, true);
+    BOOST_CHECK_EQUAL(stat.count(), 3);
+    BOOST_CHECK_EQUAL(stat.resumed(), 2);
+    BOOST_CHECK_EQUAL(stat.averageTimeCost(), 2000);
+}
+
+BOOST_AUTO_TEST_CASE(testP2PTraffic)
+{
+    // the bucket may be overdrawn while it isn't empty, and is refilled over time
+    TokenBucket bucket(1000);
+    BOOST_CHECK(bucket.consume(1500, 1));
+    BOOST_CHECK(!bucket.consume(1, 1));
+    BOOST_CHECK(!bucket.consume(1, 400));
+    BOOST_CHECK(bucket.consume(1, 600));
+
+    P2PTraffic traffic;
+    traffic.setLimits(1000, 0);
+    PROTOCOL_ID sync = dev::eth::getGroupProtoclID(1, dev::eth::ProtocolID::BlockSync);
+    PROTOCOL_ID pbft = dev::eth::getGroupProtoclID(1, dev::eth::ProtocolID::PBFT);
+    PROTOCOL_ID otherSync = dev::eth::getGroupProtoclID(2, dev::eth::ProtocolID::BlockSync);
+    BOOST_CHECK(traffic.trySend(sync, 2000, SyncPriority, 1));
+    BOOST_CHECK(!traffic.trySend(sync, 100, SyncPriority, 2));
+    // the consensus, the gossip without a limit and the other groups aren't shaped
+    BOOST_CHECK(traffic.trySend(pbft, 2000, ConsensusPriority, 2));
+    BOOST_CHECK(traffic.trySend(sync, 2000, GossipPriority, 2));
+    BOOST_CHECK(traffic.trySend(otherSync, 100, SyncPriority, 2));
+    traffic.onSent(sync, 10);
+    traffic.onReceived(-sync, 300);
+
+    auto stats = traffic.stats();
+    BOOST_CHECK_EQUAL(stats.size(), 3);
+    BOOST_CHECK_EQUAL(stats[sync].outBytes, 4010);
+    BOOST_CHECK_EQUAL(stats[sync].outMessages, 3);
+    BOOST_CHECK_EQUAL(stats[sync].shapedMessages, 1);
+    BOOST_CHECK_EQUAL(stats[sync].inBytes, 300);
+    BOOST_CHECK_EQUAL(stats[sync].inMessages, 1);
+    BOOST_CHECK_EQUAL(stats[pbft].outBytes, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(testMessagePriority)
+{
+    auto msg = std::make_shared<p2p::P2PMessageRC2>();
+    msg->setProtocolID(dev::eth::getGroupProtoclID(1, dev::eth::ProtocolID::PBFT));
+    BOOST_CHECK(msg->priority() == ConsensusPriority);
+    // the responses keep the priority of the module
+    msg->setProtocolID(-dev::eth::getGroupProtoclID(1, dev::eth::ProtocolID::Raft));
+    BOOST_CHECK(msg->priority() == ConsensusPriority);
+    msg->setProtocolID(dev::eth::getGroupProtoclID(1, dev::eth::ProtocolID::BlockSync));
+    BOOST_CHECK(msg->priority() == SyncPriority);
+    msg->setPriority(GossipPriority);
+    BOOST_CHECK(msg->priority() == GossipPriority);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
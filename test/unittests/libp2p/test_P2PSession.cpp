@@ -109,6 +109,25 @@ BOOST_AUTO_TEST_CASE(heartBeat)
     session->heartBeat();
 }
 
+BOOST_AUTO_TEST_CASE(stat)
+{
+    auto session = newSession();
+    session->onReceived(100);
+    session->onReceived(50);
+    session->onSent(30);
+    session->onRTT(80);
+    session->onRTT(160);
+
+    auto stat = session->stat();
+    BOOST_CHECK_EQUAL(stat.inBytes, 150);
+    BOOST_CHECK_EQUAL(stat.inMessages, 2);
+    BOOST_CHECK_EQUAL(stat.outBytes, 30);
+    BOOST_CHECK_EQUAL(stat.outMessages, 1);
+    // the first sample sets the rtt, the next ones move it by 1/8
+    BOOST_CHECK_EQUAL(stat.rtt, 90);
+    BOOST_CHECK_EQUAL(stat.writeQueueBytes, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -0,0 +1,76 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the JSON-RPC batches dispatched in parallel
+ *
+ * @file BatchProtocolHandlerTest.cpp
+ */
+
+#include <librpc/BatchProtocolHandler.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace dev;
+using namespace dev::rpc;
+
+namespace dev
+{
+namespace test
+{
+/// answers a call with its id, the earlier calls are answered later
+class FakeProtocolHandler : public jsonrpc::IProtocolHandler
+{
+public:
+    void AddProcedure(jsonrpc::Procedure const&) override {}
+    void HandleRequest(std::string const& _request, std::string& _response) override
+    {
+        Json::Reader reader;
+        Json::Value call;
+        reader.parse(_request, call);
+        if (!call.isMember("id"))
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 * (3 - call["id"].asInt())));
+        Json::Value response;
+        response["id"] = call["id"];
+        _response = Json::FastWriter().write(response);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(BatchProtocolHandlerTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testBatchRequest)
+{
+    BatchProtocolHandler handler(new FakeProtocolHandler(), 4);
+    std::string response;
+
+    // the responses keep the order of the calls, the notifications have none
+    handler.HandleRequest("[{\"id\":1},{\"method\":\"notify\"},{\"id\":2}]", response);
+    BOOST_CHECK_EQUAL(response, "[{\"id\":1},{\"id\":2}]\n");
+
+    handler.HandleRequest("{\"id\":1}", response);
+    BOOST_CHECK_EQUAL(response, "{\"id\":1}\n");
+
+    handler.HandleRequest("[{\"method\":\"notify\"},{\"method\":\"notify\"}]", response);
+    BOOST_CHECK(response.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -34,6 +34,7 @@
 #include <libexecutive/ExecutionResult.h>
 #include <libledger/LedgerManager.h>
 #include <libp2p/Service.h>
+#include <libstorage/AccessSet.h>
 #include <libsync/SyncInterface.h>
 #include <libtxpool/TxPoolInterface.h>
 #include <test/tools/libutils/Common.h>
@@ -322,13 +323,22 @@ public:
         return m_executiveContext;
     };
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> executeTransaction(
-        const dev::eth::BlockHeader&, dev::eth::Transaction const&) override
+        const dev::eth::BlockHeader&, dev::eth::Transaction const& _t) override
     {
+        ++m_executedTxs;
+        /// a call of data 0x5 writes the state
+        auto accessSet = dev::storage::AccessSet::current();
+        if (accessSet && _t.data() == bytes{0x5})
+        {
+            accessSet->write("t_test", "key");
+        }
         dev::executive::ExecutionResult res;
         dev::eth::TransactionReceipt reciept;
         return std::make_pair(res, reciept);
     }
 
+    std::atomic<size_t> m_executedTxs = {0};
+
 private:
     std::shared_ptr<ExecutiveContext> m_executiveContext;
 };
@@ -400,6 +410,9 @@ public:
         TxPoolStatus status;
         status.current = 1;
         status.dropped = 0;
+        status.memory = 1024;
+        status.pendingNotifications = 0;
+        status.notifyTimeCost = 0;
         return status;
     }
     std::pair<h256, Address> submit(dev::eth::Transaction& _tx) override
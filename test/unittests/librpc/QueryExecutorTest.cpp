@@ -0,0 +1,81 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the bounded pools of the read-only RPC methods
+ *
+ * @file QueryExecutorTest.cpp
+ */
+
+#include <jsonrpccpp/common/exception.h>
+#include <librpc/Common.h>
+#include <librpc/QueryExecutor.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <thread>
+
+using namespace dev;
+using namespace dev::rpc;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(QueryExecutorTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testExecute)
+{
+    QueryExecutor executor(1, 1, 1);
+    int result = 0;
+    executor.execute("getBlockNumber", [&]() { result = 1; });
+    BOOST_CHECK_EQUAL(result, 1);
+    BOOST_CHECK_EQUAL(executor.pendingQueries(), 0);
+
+    // the exceptions of the method reach the caller
+    BOOST_CHECK_THROW(executor.execute("call", []() { throw std::runtime_error("failed"); }),
+        std::runtime_error);
+
+    // a query waits while its pool is full, the calls have their own pool
+    std::promise<void> release;
+    auto blocked = release.get_future().share();
+    std::thread query(
+        [&]() { executor.execute("getBlockNumber", [blocked]() { blocked.wait(); }); });
+    while (executor.pendingQueries() == 0)
+    {
+        std::this_thread::yield();
+    }
+    try
+    {
+        executor.execute("getPeers", []() {});
+        BOOST_FAIL("the query should be rejected");
+    }
+    catch (jsonrpc::JsonRpcException& e)
+    {
+        BOOST_CHECK_EQUAL(e.GetCode(), RPCExceptionType::Busy);
+    }
+    executor.execute("call", [&]() { result = 2; });
+    BOOST_CHECK_EQUAL(result, 2);
+    // the transactions are sent on the thread of the request
+    executor.execute("sendRawTransaction", [&]() { result = 3; });
+    BOOST_CHECK_EQUAL(result, 3);
+
+    release.set_value();
+    query.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
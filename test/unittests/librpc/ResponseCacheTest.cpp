@@ -0,0 +1,70 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for the LRU of the RPC responses
+ *
+ * @file ResponseCacheTest.cpp
+ */
+
+#include <librpc/ResponseCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::rpc;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(ResponseCacheTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testResponseCache)
+{
+    // a response of 13 bytes written: "0123456789"\n
+    Json::Value value("0123456789");
+    Json::Value response;
+    ResponseCache cache(40);
+    cache.put(1, "getBlockByNumber", "1,false", value);
+    cache.put(1, "getBlockByNumber", "2,false", value);
+    cache.put(1, "getBlockByNumber", "3,false", value);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK_EQUAL(cache.bytes(), 39);
+
+    // the least recently used is evicted
+    BOOST_CHECK(cache.get(1, "getBlockByNumber", "1,false", response));
+    BOOST_CHECK(response == value);
+    cache.put(1, "getCode", "0x1", value, true);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK(!cache.get(1, "getBlockByNumber", "2,false", response));
+    BOOST_CHECK(!cache.get(2, "getBlockByNumber", "1,false", response));
+
+    // the mutable responses of the group are dropped by its next block
+    cache.onBlockCommitted(2);
+    BOOST_CHECK(cache.get(1, "getCode", "0x1", response));
+    cache.onBlockCommitted(1);
+    BOOST_CHECK(!cache.get(1, "getCode", "0x1", response));
+    BOOST_CHECK(cache.get(1, "getBlockByNumber", "3,false", response));
+    BOOST_CHECK_EQUAL(cache.bytes(), 26);
+
+    // a response over the limit isn't cached
+    cache.put(1, "getBlockByNumber", "4,true", Json::Value(std::string(100, 'x')));
+    BOOST_CHECK(!cache.get(1, "getBlockByNumber", "4,true", response));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -21,11 +21,16 @@
 #include "FakeModule.h"
 
 #include <jsonrpccpp/common/exception.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/Tracing.h>
 #include <libdevcrypto/Common.h>
 #include <libethcore/CommonJS.h>
+#include <libethcore/Instruction.h>
+#include <libinterpreter/VMProfile.h>
 #include <librpc/Rpc.h>
 #include <test/tools/libutils/Common.h>
 #include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace jsonrpc;
@@ -549,6 +554,16 @@ BOOST_AUTO_TEST_CASE(testSyncPart)
     BOOST_CHECK_THROW(rpc->getSyncStatus(invalidGroup), JsonRpcException);
 }
 
+BOOST_AUTO_TEST_CASE(testStoragePart)
+{
+    // the fake ledger doesn't record storage stats
+    BOOST_CHECK_THROW(rpc->getStorageStats(groupId), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->getStorageStats(invalidGroup), JsonRpcException);
+    // nor is it scheduled
+    BOOST_CHECK_THROW(rpc->getGroupResources(groupId), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->getGroupResources(invalidGroup), JsonRpcException);
+}
+
 BOOST_AUTO_TEST_CASE(testP2pPart)
 {
     Json::Value version = rpc->getClientVersion();
@@ -567,6 +582,59 @@ BOOST_AUTO_TEST_CASE(testP2pPart)
 
     response = rpc->getNodeIDList(groupId);
     BOOST_CHECK(response.size() == 2);
+
+    response = rpc->getCompressStats(groupId);
+    BOOST_CHECK(response["sent"].isMember("ratio"));
+    BOOST_CHECK(response["received"].isMember("timeUs"));
+    BOOST_CHECK_THROW(rpc->getCompressStats(invalidGroup), JsonRpcException);
+
+    response = rpc->getTrafficStats(groupId);
+    BOOST_CHECK(response.isArray());
+    BOOST_CHECK_THROW(rpc->getTrafficStats(invalidGroup), JsonRpcException);
+
+    response = rpc->getPeerStats(groupId);
+    BOOST_CHECK(response.size() == 1);
+    BOOST_CHECK(response[0]["RTT"].asUInt64() == 0);
+    BOOST_CHECK(response[0].isMember("WriteQueueBytes"));
+    BOOST_CHECK_THROW(rpc->getPeerStats(invalidGroup), JsonRpcException);
+
+    g_metrics.counter("bcos_test_requests", "the requests of the test", {{"group", "1"}}).inc();
+    response = rpc->getMetrics(groupId);
+    BOOST_CHECK(response.isArray() && response.size() >= 1);
+    BOOST_CHECK_THROW(rpc->getMetrics(invalidGroup), JsonRpcException);
+
+    dev::eth::ContractProfile profile;
+    profile.executions = 1;
+    profile.ops[static_cast<size_t>(dev::eth::Instruction::SLOAD)] = 2;
+    profile.categoryOps[static_cast<size_t>(dev::eth::OpCategory::Storage)] = 2;
+    profile.categoryTime[static_cast<size_t>(dev::eth::OpCategory::Storage)] = 100;
+    dev::eth::VMProfiler::instance().record(Address(0x1234), profile);
+    response = rpc->getEvmProfile(groupId);
+    BOOST_CHECK(response.isArray() && response.size() >= 1);
+    BOOST_CHECK(response[0]["Categories"]["storage"]["Ops"].asUInt64() >= 2);
+    BOOST_CHECK(response[0]["Opcodes"]["SLOAD"].asUInt64() >= 2);
+    BOOST_CHECK_THROW(rpc->getEvmProfile(invalidGroup), JsonRpcException);
+    dev::eth::VMProfiler::instance().reset();
+
+    BOOST_CHECK_THROW(rpc->exportTrace(groupId), JsonRpcException);
+    auto tracePath = boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("rpc-trace-%%%%%%");
+    g_tracer.configure(true, 16, tracePath.string());
+    {
+        BlockSpan span("test.span", groupId, 1);
+    }
+    response = rpc->exportTrace(groupId);
+    BOOST_CHECK_EQUAL(response["Spans"].asUInt64(), 1);
+    BOOST_CHECK(boost::filesystem::exists(response["File"].asString()));
+    BOOST_CHECK_THROW(rpc->exportTrace(invalidGroup), JsonRpcException);
+    g_tracer.configure(false, c_traceCapacity, "");
+    boost::filesystem::remove_all(tracePath);
+
+    BOOST_CHECK_THROW(rpc->checkpoint(groupId, "../data"), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->checkpoint(groupId, ""), JsonRpcException);
+    // the fake ledger has no rocksdb
+    BOOST_CHECK_THROW(rpc->checkpoint(groupId, "backup-1"), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->checkpoint(invalidGroup, "backup-1"), JsonRpcException);
 }
 
 BOOST_AUTO_TEST_CASE(testGetBlockByHash)
@@ -891,6 +959,17 @@ BOOST_AUTO_TEST_CASE(testGetPendingTxSize)
     BOOST_CHECK_THROW(rpc->getPendingTxSize(invalidGroup), JsonRpcException);
 }
 
+BOOST_AUTO_TEST_CASE(testGetTxPoolStatus)
+{
+    Json::Value response = rpc->getTxPoolStatus(groupId);
+    BOOST_CHECK(response["pendingTxSize"].asString() == "0x1");
+    BOOST_CHECK(response["droppedTxSize"].asString() == "0x0");
+    BOOST_CHECK(response["memory"].asString() == "0x400");
+    BOOST_CHECK(response["pendingReceipts"].asString() == "0x0");
+
+    BOOST_CHECK_THROW(rpc->getTxPoolStatus(invalidGroup), JsonRpcException);
+}
+
 BOOST_AUTO_TEST_CASE(testGetCode)
 {
     std::string address = "0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b";
@@ -929,6 +1008,29 @@ BOOST_AUTO_TEST_CASE(testCall)
     BOOST_CHECK_THROW(rpc->call(invalidGroup, request), JsonRpcException);
 }
 
+BOOST_AUTO_TEST_CASE(testCallCache)
+{
+    auto blockVerifier =
+        std::dynamic_pointer_cast<MockBlockVerifier>(m_ledgerManager->blockVerifier(groupId));
+    rpc->setResponseCache(std::make_shared<ResponseCache>());
+    Json::Value request;
+    request["from"] = "0x" + toHex(toAddress(KeyPair::create().pub()));
+    request["to"] = "0x" + toHex(toAddress(KeyPair::create().pub()));
+    request["data"] = "0x3";
+    size_t executedTxs = blockVerifier->m_executedTxs;
+    rpc->call(groupId, request);
+    Json::Value response = rpc->call(groupId, request);
+    BOOST_CHECK(response["output"].asString() == "0x");
+    BOOST_CHECK_EQUAL(size_t(blockVerifier->m_executedTxs), executedTxs + 1);
+
+    /// a call writing the state runs every time
+    request["data"] = "0x5";
+    rpc->call(groupId, request);
+    rpc->call(groupId, request);
+    BOOST_CHECK_EQUAL(size_t(blockVerifier->m_executedTxs), executedTxs + 3);
+    rpc->setResponseCache(nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(testSendRawTransaction)
 {
 #ifdef FISCO_GM
@@ -965,6 +1067,44 @@ BOOST_AUTO_TEST_CASE(testSendRawTransaction)
     BOOST_CHECK(response == "0x0accad4228274b0d78939f48149767883a6e99c95941baa950156e926f1c96ba");
 
     BOOST_CHECK_THROW(rpc->sendRawTransaction(invalidGroup, rlpStr), JsonRpcException);
+
+    Json::Value rlps(Json::arrayValue);
+    rlps.append(rlpStr);
+    rlps.append(rlpStr);
+    Json::Value results = rpc->sendRawTransactions(groupId, rlps);
+    BOOST_CHECK_EQUAL(results.size(), 2);
+    BOOST_CHECK(results[1]["transactionHash"].asString() == response);
+    BOOST_CHECK_EQUAL(results[1]["status"].asInt(), (int)ImportResult::Success);
+    BOOST_CHECK_THROW(rpc->sendRawTransactions(invalidGroup, rlps), JsonRpcException);
+}
+
+BOOST_AUTO_TEST_CASE(testGetLogs)
+{
+    Json::Value filter;
+    filter["addresses"].append("0x0000000000000000000000000000000000002000");
+    Json::Value response = rpc->getLogs(groupId, "0x0", "latest", filter);
+    BOOST_CHECK(response.isArray());
+    BOOST_CHECK_EQUAL(response.size(), 0);
+
+    filter["topics"].append("0x12");
+    BOOST_CHECK_THROW(rpc->getLogs(groupId, "0x0", "latest", filter), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->getLogs(invalidGroup, "0x0", "latest", filter), JsonRpcException);
+}
+
+BOOST_AUTO_TEST_CASE(testGetPendingTransactionsPage)
+{
+    Json::Value response = rpc->getPendingTransactionsPage(groupId, "", 10);
+    BOOST_CHECK_EQUAL(response["transactions"].size(), 1);
+    std::string cursor = response["cursor"].asString();
+    BOOST_CHECK_EQUAL(cursor.find(response["transactions"][0]["hash"].asString()), 0);
+
+    response = rpc->getPendingTransactionsPage(groupId, cursor, 10);
+    BOOST_CHECK_EQUAL(response["transactions"].size(), 0);
+    BOOST_CHECK_EQUAL(response["cursor"].asString(), cursor);
+
+    BOOST_CHECK_THROW(rpc->getPendingTransactionsPage(groupId, "", 0), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->getPendingTransactionsPage(groupId, "0x12", 10), JsonRpcException);
+    BOOST_CHECK_THROW(rpc->getPendingTransactionsPage(invalidGroup, "", 10), JsonRpcException);
 }
 #endif
 BOOST_AUTO_TEST_SUITE_END()
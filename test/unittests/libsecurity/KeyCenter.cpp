@@ -0,0 +1,104 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the data key cache of the key center
+ *
+ * @file: KeyCenter.cpp
+ */
+
+#include <libsecurity/KeyCenter.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+class CountingKeyCenter : public KeyCenter
+{
+public:
+    atomic<int> fetches = {0};
+    atomic<bool> fail = {false};
+
+protected:
+    bytes fetchDataKey(const std::string& _cipherDataKey) override
+    {
+        ++fetches;
+        this_thread::sleep_for(chrono::milliseconds(10));
+        if (fail)
+        {
+            BOOST_THROW_EXCEPTION(KeyCenterConnectionError());
+        }
+        return asBytes(_cipherDataKey);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(KeyCenterTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(oneFetchForConcurrentCallers)
+{
+    CountingKeyCenter keyCenter;
+    vector<thread> groups;
+    atomic<int> wrong = {0};
+    for (int i = 0; i < 8; ++i)
+    {
+        groups.emplace_back([&]() {
+            if (keyCenter.getDataKey("cipher") != asBytes("cipher"))
+            {
+                ++wrong;
+            }
+        });
+    }
+    for (auto& group : groups)
+    {
+        group.join();
+    }
+    BOOST_CHECK_EQUAL(wrong, 0);
+    BOOST_CHECK_EQUAL(keyCenter.fetches, 1);
+
+    BOOST_CHECK(keyCenter.getDataKey("other") == asBytes("other"));
+    BOOST_CHECK_EQUAL(keyCenter.fetches, 2);
+    BOOST_CHECK_THROW(keyCenter.getDataKey(""), KeyCenterDataKeyError);
+}
+
+BOOST_AUTO_TEST_CASE(refreshedInBackground)
+{
+    CountingKeyCenter keyCenter;
+    keyCenter.setCacheTTL(100);
+    BOOST_CHECK(keyCenter.getDataKey("cipher") == asBytes("cipher"));
+    this_thread::sleep_for(chrono::milliseconds(300));
+    BOOST_CHECK(keyCenter.fetches >= 2);
+
+    // the cached key is served while the key manager is away
+    keyCenter.fail = true;
+    this_thread::sleep_for(chrono::milliseconds(150));
+    BOOST_CHECK(keyCenter.getDataKey("cipher") == asBytes("cipher"));
+
+    keyCenter.clearCache();
+    BOOST_CHECK_THROW(keyCenter.getDataKey("cipher"), KeyCenterConnectionError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
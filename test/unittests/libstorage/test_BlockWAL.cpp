@@ -0,0 +1,159 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file test_BlockWAL.cpp
+ * @author: ancelmo
+ * @date 2019-09-05
+ */
+
+#include <libdevcore/FixedHash.h>
+#include <libstorage/BlockWAL.h>
+#include <libstorage/Table.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_BlockWAL
+{
+struct BlockWALFixture
+{
+    BlockWALFixture()
+    {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+                   .string();
+    }
+    ~BlockWALFixture() { boost::filesystem::remove_all(path); }
+
+    std::vector<TableData::Ptr> blockData(int64_t num)
+    {
+        auto data = std::make_shared<TableData>();
+        data->info->name = "t_test";
+        data->info->key = "Name";
+        data->info->fields.push_back("value");
+
+        auto entry = std::make_shared<Entry>();
+        entry->setID(num);
+        entry->setNum(num);
+        entry->setField("Name", "LiSi");
+        entry->setField("value", std::to_string(num));
+        data->dirtyEntries->addEntry(entry);
+
+        entry = std::make_shared<Entry>();
+        entry->setID(num + 100);
+        entry->setForce(true);
+        entry->setStatus(1);
+        entry->setField("Name", "WangWu");
+        data->newEntries->addEntry(entry);
+
+        return std::vector<TableData::Ptr>{data};
+    }
+
+    std::string path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(BlockWALTest, BlockWALFixture)
+
+BOOST_AUTO_TEST_CASE(replay)
+{
+    auto wal = std::make_shared<BlockWAL>(path);
+    wal->open(0, [](BlockWAL::Block&) { BOOST_CHECK(false); });
+    for (int64_t num = 1; num <= 3; ++num)
+    {
+        wal->append(h256(num), num, blockData(num));
+    }
+    wal.reset();
+
+    std::vector<BlockWAL::Block> blocks;
+    wal = std::make_shared<BlockWAL>(path);
+    wal->open(1, [&](BlockWAL::Block& block) { blocks.push_back(block); });
+    BOOST_REQUIRE_EQUAL(blocks.size(), 2u);
+    BOOST_CHECK_EQUAL(blocks[0].num, 2);
+    BOOST_CHECK_EQUAL(blocks[1].num, 3);
+    BOOST_CHECK(blocks[1].hash == h256(3));
+
+    auto data = blocks[0].datas[0];
+    BOOST_CHECK_EQUAL(data->info->name, "t_test");
+    BOOST_CHECK_EQUAL(data->info->key, "Name");
+    BOOST_CHECK_EQUAL(data->info->fields.size(), 1u);
+    BOOST_CHECK_EQUAL(data->dirtyEntries->size(), 1u);
+    BOOST_CHECK_EQUAL(data->dirtyEntries->get(0)->getID(), 2u);
+    BOOST_CHECK_EQUAL(data->dirtyEntries->get(0)->num(), 2u);
+    BOOST_CHECK_EQUAL(data->dirtyEntries->get(0)->getField("value"), "2");
+    BOOST_CHECK_EQUAL(data->newEntries->size(), 1u);
+    BOOST_CHECK_EQUAL(data->newEntries->get(0)->force(), true);
+    BOOST_CHECK_EQUAL(data->newEntries->get(0)->getStatus(), 1);
+    BOOST_CHECK_EQUAL(data->newEntries->get(0)->getField("Name"), "WangWu");
+}
+
+BOOST_AUTO_TEST_CASE(tornRecord)
+{
+    auto wal = std::make_shared<BlockWAL>(path);
+    wal->open(0, [](BlockWAL::Block&) {});
+    wal->append(h256(1), 1, blockData(1));
+    wal.reset();
+
+    // a crash in the middle of a record
+    for (boost::filesystem::directory_iterator it(path);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        std::ofstream out(it->path().string(), std::ios::binary | std::ios::app);
+        out << "torn";
+    }
+
+    size_t replayed = 0;
+    wal = std::make_shared<BlockWAL>(path);
+    wal->open(0, [&](BlockWAL::Block&) { ++replayed; });
+    BOOST_CHECK_EQUAL(replayed, 1u);
+    wal->append(h256(2), 2, blockData(2));
+    wal.reset();
+
+    replayed = 0;
+    wal = std::make_shared<BlockWAL>(path);
+    wal->open(0, [&](BlockWAL::Block&) { ++replayed; });
+    BOOST_CHECK_EQUAL(replayed, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(truncate)
+{
+    auto wal = std::make_shared<BlockWAL>(path, 1);
+    wal->open(0, [](BlockWAL::Block&) {});
+    for (int64_t num = 1; num <= 3; ++num)
+    {
+        wal->append(h256(num), num, blockData(num));
+    }
+    // every block rolls over a small segment
+    BOOST_CHECK_EQUAL(wal->segments(), 3u);
+
+    wal->truncate(2);
+    BOOST_CHECK_EQUAL(wal->segments(), 1u);
+    wal->truncate(3);
+    BOOST_CHECK_EQUAL(wal->segments(), 1u);
+    wal.reset();
+
+    size_t replayed = 0;
+    wal = std::make_shared<BlockWAL>(path);
+    wal->open(0, [&](BlockWAL::Block&) { ++replayed; });
+    BOOST_CHECK_EQUAL(replayed, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_BlockWAL
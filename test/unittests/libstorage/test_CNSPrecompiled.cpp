@@ -174,6 +174,33 @@ BOOST_AUTO_TEST_CASE(select)
     BOOST_TEST(retJson.size() == 0);
 }
 
+BOOST_AUTO_TEST_CASE(cachedUntilWritten)
+{
+    eth::ContractABI abi;
+    std::string contractName = "Ok";
+    bytes in = abi.abiIn("selectByName(string)", contractName);
+    bytes out = cnsPrecompiled->call(context, bytesConstRef(&in));
+    bytes cached;
+    BOOST_TEST(context->getSystemRead(SYS_CNS, contractName, "selectByName(string)", cached));
+    BOOST_TEST(cached == out);
+
+    // the insert drops the cached result and no result is cached for the rest of the block
+    in = abi.abiIn("insert(string,string,string,string)", contractName, std::string("1.0"),
+        std::string("0x420f853b49838bd3e9466c85a4cc3428c960dde2"), std::string(""));
+    cnsPrecompiled->call(context, bytesConstRef(&in));
+    BOOST_TEST(!context->getSystemRead(SYS_CNS, contractName, "selectByName(string)", cached));
+
+    in = abi.abiIn("selectByName(string)", contractName);
+    out = cnsPrecompiled->call(context, bytesConstRef(&in));
+    BOOST_TEST(!context->getSystemRead(SYS_CNS, contractName, "selectByName(string)", cached));
+    std::string retStr;
+    abi.abiOut(&out, retStr);
+    Json::Value retJson;
+    Json::Reader reader;
+    BOOST_TEST(reader.parse(retStr, retJson) == true);
+    BOOST_TEST(retJson.size() == 1);
+}
+
 BOOST_AUTO_TEST_CASE(toString)
 {
     BOOST_TEST(cnsPrecompiled->toString() == "CNS");
@@ -184,6 +211,7 @@ BOOST_AUTO_TEST_CASE(errFunc)
     eth::ContractABI abi;
     bytes in = abi.abiIn("insert(string)", std::string("test"));
     bytes out = cnsPrecompiled->call(context, bytesConstRef(&in));
+    BOOST_TEST(out.empty());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
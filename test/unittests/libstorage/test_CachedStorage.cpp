@@ -21,15 +21,18 @@
  * @date 2019-04-13
  */
 
+#include <libdevcore/Executor.h>
 #include <libdevcore/FixedHash.h>
 #include <libstorage/CachedStorage.h>
 #include <libstorage/StorageException.h>
 #include <libstorage/Table.h>
 #include <tbb/parallel_for.h>
+#include <boost/filesystem.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <boost/test/unit_test.hpp>
 #include <chrono>
+#include <future>
 #include <thread>
 
 using namespace dev;
@@ -213,6 +216,192 @@ public:
     tbb::concurrent_unordered_map<std::string, Entry::Ptr> tableKey2Entry;
 };
 
+class MockStorageMerge : public Storage
+{
+public:
+    MockStorageMerge()
+    {
+        entered.store(false);
+        released.store(false);
+    }
+
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition) override
+    {
+        (void)hash;
+        (void)num;
+        (void)tableInfo;
+        (void)key;
+        (void)condition;
+
+        return std::make_shared<Entries>();
+    }
+
+    size_t commit(h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas) override
+    {
+        (void)hash;
+
+        entered.store(true);
+        while (!released.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        commitNums.push_back(num);
+        for (auto it : datas)
+        {
+            if (it->info->name == "t_test")
+            {
+                commitDatas.push_back(it);
+            }
+        }
+        return 0;
+    }
+
+    int64_t checkpoint(const std::string& path) override
+    {
+        checkpointPath = path;
+        checkpointCommits = commitNums.size();
+        return -1;
+    }
+
+    bool onlyDirty() override { return true; }
+
+    tbb::atomic<bool> entered;
+    tbb::atomic<bool> released;
+    std::string checkpointPath;
+    size_t checkpointCommits = 0;
+    std::vector<int64_t> commitNums;
+    std::vector<TableData::Ptr> commitDatas;
+};
+
+class MockStorageBatch : public Storage
+{
+public:
+    Entries::Ptr select(h256 hash, int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition) override
+    {
+        (void)hash;
+        (void)num;
+        (void)condition;
+
+        ++selectTimes;
+        auto entries = std::make_shared<Entries>();
+        auto entry = std::make_shared<Entry>();
+        entry->setID(boost::lexical_cast<uint64_t>(key) + 1);
+        entry->setField(tableInfo->key, key);
+        entry->setField("value", "value" + key);
+        entries->addEntry(entry);
+        return entries;
+    }
+
+    std::vector<Entries::Ptr> batchSelect(h256 hash, int64_t num, TableInfo::Ptr tableInfo,
+        const std::vector<std::string>& keys) override
+    {
+        ++batchSelectTimes;
+        batchKeys.push_back(keys);
+        return Storage::batchSelect(hash, num, tableInfo, keys);
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>&) override { return 0; }
+
+    bool onlyDirty() override { return true; }
+
+    size_t selectTimes = 0;
+    size_t batchSelectTimes = 0;
+    std::vector<std::vector<std::string>> batchKeys;
+};
+
+/// a backend slow to commit
+class MockStorageSlow : public Storage
+{
+public:
+    Entries::Ptr select(h256, int64_t, TableInfo::Ptr, const std::string&, Condition::Ptr) override
+    {
+        return std::make_shared<Entries>();
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>&) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ++commitTimes;
+        return 0;
+    }
+
+    bool onlyDirty() override { return true; }
+
+    std::atomic<size_t> commitTimes = {0};
+};
+
+class MockStorageScan : public Storage
+{
+public:
+    typedef std::map<std::string, Entries::Ptr> Data;
+
+    class Iterator : public StorageIterator
+    {
+    public:
+        Iterator(Data::iterator begin, Data::iterator end, size_t batchSize)
+          : m_it(begin), m_end(end), m_batchSize(batchSize)
+        {}
+
+        bool next(Batch& batch) override
+        {
+            batch.clear();
+            for (; m_it != m_end && batch.size() < m_batchSize; ++m_it)
+            {
+                batch.emplace_back(m_it->first, m_it->second);
+            }
+            return !batch.empty();
+        }
+
+    private:
+        Data::iterator m_it;
+        Data::iterator m_end;
+        size_t m_batchSize;
+    };
+
+    MockStorageScan()
+    {
+        for (auto key : {"a", "c", "d"})
+        {
+            auto entries = std::make_shared<Entries>();
+            auto entry = std::make_shared<Entry>();
+            entry->setID(++id);
+            entry->setField("key", key);
+            entry->setField("value", "1");
+            entries->addEntry(entry);
+            data.insert(std::make_pair(key, entries));
+        }
+    }
+
+    Entries::Ptr select(
+        h256, int64_t, TableInfo::Ptr, const std::string& key, Condition::Ptr) override
+    {
+        auto entries = std::make_shared<Entries>();
+        auto it = data.find(key);
+        if (it != data.end())
+        {
+            entries->shallowFrom(it->second);
+        }
+        return entries;
+    }
+
+    StorageIterator::Ptr scan(TableInfo::Ptr, const std::string& begin, const std::string& end,
+        size_t batchSize) override
+    {
+        return std::make_shared<Iterator>(
+            data.lower_bound(begin), end.empty() ? data.end() : data.lower_bound(end), batchSize);
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>&) override { return 0; }
+
+    bool onlyDirty() override { return true; }
+
+    Data data;
+    uint64_t id = 0;
+};
+
 struct CachedStorageFixture
 {
     CachedStorageFixture()
@@ -817,7 +1006,8 @@ BOOST_AUTO_TEST_CASE(commitCheck)
             auto entries = cachedStorage->select(dev::h256(0), idx + 1, userTable,
                 boost::lexical_cast<std::string>(i), std::make_shared<Condition>());
 
-            auto entry = entries->get(0);
+            auto entry = std::make_shared<Entry>();
+            entry->copyFrom(entries->get(0));
             entry->setField("key", boost::lexical_cast<std::string>(i));
             entry->setField("value", "value " + boost::lexical_cast<std::string>(i));
             newUser->addEntry(entry);
@@ -839,6 +1029,801 @@ BOOST_AUTO_TEST_CASE(commitCheck)
     }
 }
 
+BOOST_AUTO_TEST_CASE(shardedCache)
+{
+    cachedStorage->setCacheShards(8);
+    BOOST_TEST(cachedStorage->cacheShards() == 8u);
+    cachedStorage->init();
+    cachedStorage->setBackend(Storage::Ptr());
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->setField("key", boost::lexical_cast<std::string>(i));
+        entry->setField("value", boost::lexical_cast<std::string>(i + 100));
+        data->newEntries->addEntry(entry);
+    }
+
+    std::vector<dev::storage::TableData::Ptr> datas;
+    datas.push_back(data);
+    cachedStorage->commit(dev::h256(0), 99, datas);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, 100), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+            {
+                auto entries = cachedStorage->select(dev::h256(0), 99, tableInfo,
+                    boost::lexical_cast<std::string>(i), std::make_shared<Condition>());
+                BOOST_TEST(entries->size() == 1u);
+                BOOST_TEST(entries->get(0)->getField("value") ==
+                           boost::lexical_cast<std::string>(i + 100));
+            }
+        });
+
+    cachedStorage->setCacheShards(0);
+    BOOST_TEST(cachedStorage->cacheShards() > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(cachePolicy)
+{
+    BOOST_TEST(cachedStorage->cachePolicy() == CachedStorage::CLOCK);
+
+    for (auto policy : {CachedStorage::CLOCK, CachedStorage::LRU})
+    {
+        auto storage = std::make_shared<CachedStorage>();
+        storage->setCachePolicy(policy);
+        storage->setMaxForwardBlock(100);
+        storage->setBackend(Storage::Ptr());
+
+        auto tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = "t_test";
+        tableInfo->key = "key";
+        tableInfo->fields.push_back("value");
+
+        auto data = std::make_shared<dev::storage::TableData>();
+        data->info = tableInfo;
+        auto entry = std::make_shared<Entry>();
+        entry->setField("key", "1");
+        entry->setField("value", "200");
+        data->newEntries->addEntry(entry);
+
+        std::vector<dev::storage::TableData::Ptr> datas;
+        datas.push_back(data);
+        storage->commit(dev::h256(0), 1, datas);
+
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto entries =
+                storage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+            BOOST_TEST(entries->size() == 1u);
+            BOOST_TEST(entries->get(0)->getField("value") == "200");
+        }
+        storage->stop();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(clockSecondChance)
+{
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto backend = std::make_shared<MockStorageBatch>();
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setCacheShards(1);
+    storage->setCachePolicy(CachedStorage::CLOCK);
+    storage->setCacheAdmission(true);
+    storage->setMaxForwardBlock(100);
+    storage->setBackend(backend);
+
+    // read once, every key enters the ring unreferenced
+    for (size_t i = 1; i <= 9; ++i)
+    {
+        storage->select(
+            dev::h256(0), 1, tableInfo, boost::lexical_cast<std::string>(i), nullptr);
+    }
+    // read again, the first key in the ring is referenced
+    storage->select(dev::h256(0), 1, tableInfo, "1", nullptr);
+    BOOST_TEST(backend->selectTimes == 9u);
+
+    int64_t capacity = storage->tableStat("t_test")->capacity;
+    storage->setMaxCapacity(capacity / 3);
+    storage->setSyncNum(1);
+    storage->setClearInterval(10);
+    storage->startClearThread();
+    for (size_t i = 0; i < 100 && storage->tableStat("t_test")->capacity > capacity / 3; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_TEST(storage->tableStat("t_test")->capacity <= capacity / 3);
+
+    // the hand passed the referenced key with a second chance, and evicted the next ones
+    storage->select(dev::h256(0), 1, tableInfo, "1", nullptr);
+    BOOST_TEST(backend->selectTimes == 9u);
+    storage->select(dev::h256(0), 1, tableInfo, "2", nullptr);
+    BOOST_TEST(backend->selectTimes == 10u);
+    storage->stop();
+}
+
+BOOST_AUTO_TEST_CASE(commitOnBusyWorkers)
+{
+    auto backend = std::make_shared<MockStorageSlow>();
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setMaxForwardBlock(1);
+    storage->setBackend(backend);
+
+    // every worker runs a high task, the one committing waits for the flush of the blocks
+    size_t workers = g_executor.threads();
+    auto busy = g_executor.queue("testBusyWorkers", TaskPriority::High, workers);
+    auto committed = std::make_shared<std::atomic<bool> >(false);
+    auto done = std::make_shared<std::promise<void> >();
+    for (size_t i = 1; i < workers; ++i)
+    {
+        busy->post([committed]() {
+            while (!*committed)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    busy->post([storage, committed, done]() {
+        for (int64_t num = 1; num <= 4; ++num)
+        {
+            auto tableData = std::make_shared<TableData>();
+            tableData->info->name = "t_test";
+            tableData->info->key = "Name";
+            tableData->info->fields.push_back("id");
+            auto entry = std::make_shared<Entry>();
+            entry->setField("Name", "node" + boost::lexical_cast<std::string>(num));
+            entry->setField("id", boost::lexical_cast<std::string>(num));
+            tableData->newEntries->addEntry(entry);
+            storage->commit(h256(), num, std::vector<TableData::Ptr>{tableData});
+        }
+        *committed = true;
+        done->set_value();
+    });
+    BOOST_CHECK(
+        done->get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    *committed = true;
+    storage->stop();
+    BOOST_TEST(backend->commitTimes >= 3u);
+}
+
+BOOST_AUTO_TEST_CASE(tableStat)
+{
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setMaxForwardBlock(100);
+    storage->setBackend(Storage::Ptr());
+    storage->setCacheAdmission(true);
+    storage->setTableQuota(SYS_TX_HASH_2_BLOCK, 1024);
+    BOOST_TEST(storage->cacheAdmission());
+    BOOST_TEST(storage->tableStat(SYS_TX_HASH_2_BLOCK)->quota == 1024);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "200");
+    data->newEntries->addEntry(entry);
+    storage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        storage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+    }
+
+    auto stat = storage->tableStat("t_test");
+    BOOST_TEST(stat->queryTimes == 11u);
+    BOOST_TEST(stat->hitTimes == 10u);
+    BOOST_TEST(stat->capacity > 0);
+    BOOST_TEST(stat->quota == 0);
+    BOOST_TEST(storage->tableStat(SYS_TX_HASH_2_BLOCK)->queryTimes == 0u);
+    storage->stop();
+}
+
+BOOST_AUTO_TEST_CASE(frequencySketch)
+{
+    FrequencySketch sketch(1024);
+    std::hash<std::string> hasher;
+    BOOST_TEST(sketch.frequency(hasher("hot")) == 0u);
+
+    for (size_t i = 0; i < 20; ++i)
+    {
+        sketch.increment(hasher("hot"));
+    }
+    sketch.increment(hasher("cold"));
+
+    // 4-bit counters saturate at 15
+    BOOST_TEST(sketch.frequency(hasher("hot")) == 15u);
+    BOOST_TEST(sketch.frequency(hasher("cold")) >= 1u);
+    BOOST_TEST(sketch.frequency(hasher("cold")) < 15u);
+
+    // halved after the sample period
+    for (size_t i = 0; i < 1024 * 10; ++i)
+    {
+        sketch.increment(hasher(std::to_string(i)));
+    }
+    BOOST_TEST(sketch.frequency(hasher("hot")) < 15u);
+}
+
+BOOST_AUTO_TEST_CASE(batchSelect)
+{
+    auto backend = std::make_shared<MockStorageBatch>();
+    cachedStorage->setBackend(backend);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto entries = cachedStorage->select(dev::h256(0), 1, tableInfo, "1", nullptr);
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(backend->selectTimes == 1u);
+
+    std::vector<std::string> keys{"1", "2", "3", "2"};
+    auto result = cachedStorage->batchSelect(dev::h256(0), 1, tableInfo, keys);
+    BOOST_TEST(result.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        BOOST_TEST(result[i]->size() == 1u);
+        BOOST_TEST(result[i]->get(0)->getField("value") == "value" + keys[i]);
+    }
+
+    // only the missed keys are fetched, in one call
+    BOOST_TEST(backend->batchSelectTimes == 1u);
+    BOOST_TEST(backend->batchKeys[0] == std::vector<std::string>({"2", "3"}));
+
+    result = cachedStorage->batchSelect(dev::h256(0), 1, tableInfo, keys);
+    BOOST_TEST(backend->batchSelectTimes == 1u);
+    BOOST_TEST(result[3]->get(0)->getField("value") == "value2");
+
+    auto hit = cachedStorage->prefetch(
+        dev::h256(0), 1, tableInfo, std::vector<std::string>({"1", "4", "5"}));
+    BOOST_TEST(hit == 1u);
+    BOOST_TEST(backend->batchSelectTimes == 2u);
+    BOOST_TEST(backend->batchKeys[1] == std::vector<std::string>({"4", "5"}));
+}
+
+BOOST_AUTO_TEST_CASE(batchSelectRemoved)
+{
+    auto backend = std::make_shared<MockStorageBatch>();
+    cachedStorage->setBackend(backend);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    std::vector<std::string> keys{"1", "2"};
+    auto result = cachedStorage->batchSelect(dev::h256(0), 1, tableInfo, keys);
+    BOOST_TEST(result[1]->size() == 1u);
+
+    // the removed row stays in the cache, neither select nor batchSelect return it
+    auto entry = std::make_shared<Entry>();
+    entry->copyFrom(result[1]->get(0));
+    entry->setStatus(Entry::Status::DELETED);
+    auto data = std::make_shared<TableData>();
+    data->info = tableInfo;
+    data->dirtyEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 2, std::vector<TableData::Ptr>{data});
+
+    auto condition = std::make_shared<Condition>();
+    condition->EQ(tableInfo->key, "2");
+    BOOST_TEST(cachedStorage->select(dev::h256(0), 2, tableInfo, "2", condition)->size() == 0u);
+    result = cachedStorage->batchSelect(dev::h256(0), 2, tableInfo, keys);
+    BOOST_TEST(result[0]->size() == 1u);
+    BOOST_TEST(result[1]->size() == 0u);
+    BOOST_TEST(backend->batchSelectTimes == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(hotKeys)
+{
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    for (auto policy : {CachedStorage::CLOCK, CachedStorage::LRU})
+    {
+        auto backend = std::make_shared<MockStorageBatch>();
+        auto storage = std::make_shared<CachedStorage>();
+        storage->setCachePolicy(policy);
+        storage->setBackend(backend);
+        storage->setHotKeys(path.string(), 2);
+        for (auto key : {"1", "2", "3"})
+        {
+            storage->select(dev::h256(0), 1, tableInfo, key, nullptr);
+        }
+        storage->saveHotKeys();
+        storage->stop();
+
+        // the two most recent keys are fetched again after the restart
+        auto restartedBackend = std::make_shared<MockStorageBatch>();
+        auto restarted = std::make_shared<CachedStorage>();
+        restarted->setCachePolicy(policy);
+        restarted->setBackend(restartedBackend);
+        restarted->setHotKeys(path.string(), 2);
+        BOOST_TEST(restarted->warmUp(1000) == 2u);
+        BOOST_TEST(restartedBackend->batchSelectTimes == 1u);
+        BOOST_TEST(restartedBackend->batchKeys[0] == std::vector<std::string>({"2", "3"}));
+
+        auto selectTimes = restartedBackend->selectTimes;
+        auto entries = restarted->select(dev::h256(0), 1, tableInfo, "3", nullptr);
+        BOOST_TEST(entries->get(0)->getField("value") == "value3");
+        BOOST_TEST(restartedBackend->selectTimes == selectTimes);
+        restarted->stop();
+    }
+
+    // no file, nothing to fetch
+    boost::filesystem::remove(path);
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setBackend(std::make_shared<MockStorageBatch>());
+    storage->setHotKeys(path.string(), 2);
+    BOOST_TEST(storage->warmUp(0) == 0u);
+    storage->setHotKeys("", 0);
+    storage->stop();
+}
+
+BOOST_AUTO_TEST_CASE(sharedEntries)
+{
+    cachedStorage->setBackend(Storage::Ptr());
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "1");
+    data->newEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+
+    auto entries1 =
+        cachedStorage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+    auto entries2 =
+        cachedStorage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+    BOOST_TEST(entries1->get(0) == entries2->get(0));
+
+    data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    entry = std::make_shared<Entry>();
+    entry->setID(entries1->get(0)->getID());
+    entry->setField("key", "1");
+    entry->setField("value", "2");
+    data->dirtyEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 2, std::vector<dev::storage::TableData::Ptr>{data});
+
+    // selected entries are not changed by the commit
+    BOOST_TEST(entries1->get(0)->getField("value") == "1");
+    auto entries3 =
+        cachedStorage->select(dev::h256(0), 2, tableInfo, "1", std::make_shared<Condition>());
+    BOOST_TEST(entries3->get(0)->getField("value") == "2");
+}
+
+BOOST_AUTO_TEST_CASE(snapshot)
+{
+    cachedStorage->setBackend(Storage::Ptr());
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "1");
+    data->newEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+
+    auto snapshot = cachedStorage->snapshot();
+    BOOST_TEST(snapshot->num() == 1);
+    BOOST_TEST(cachedStorage->snapshots() == 1u);
+
+    auto id = cachedStorage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>())
+                  ->get(0)
+                  ->getID();
+
+    // block 2 updates key 1 and inserts key 2
+    data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    entry = std::make_shared<Entry>();
+    entry->setID(id);
+    entry->setField("key", "1");
+    entry->setField("value", "2");
+    data->dirtyEntries->addEntry(entry);
+    entry = std::make_shared<Entry>();
+    entry->setField("key", "2");
+    entry->setField("value", "2");
+    data->newEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 2, std::vector<dev::storage::TableData::Ptr>{data});
+
+    auto entries = snapshot->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "1");
+    entries = snapshot->select(dev::h256(0), 1, tableInfo, "2", std::make_shared<Condition>());
+    BOOST_TEST(entries->size() == 0u);
+
+    auto latest = cachedStorage->snapshot();
+    BOOST_TEST(latest->num() == 2);
+    entries = latest->select(dev::h256(0), 2, tableInfo, "1", std::make_shared<Condition>());
+    BOOST_TEST(entries->get(0)->getField("value") == "2");
+
+    BOOST_CHECK_THROW(snapshot->commit(dev::h256(0), 3, std::vector<dev::storage::TableData::Ptr>{}),
+        StorageException);
+
+    snapshot.reset();
+    latest.reset();
+    BOOST_TEST(cachedStorage->snapshots() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(snapshotDuringCommits)
+{
+    cachedStorage->setBackend(Storage::Ptr());
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "1");
+    data->newEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+    auto id = cachedStorage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>())
+                  ->get(0)
+                  ->getID();
+
+    // every block sets the value of key 1 to its number
+    auto commits = std::async(std::launch::async, [&]() {
+        for (int64_t num = 2; num <= 200; ++num)
+        {
+            auto data = std::make_shared<dev::storage::TableData>();
+            data->info = tableInfo;
+            auto entry = std::make_shared<Entry>();
+            entry->setID(id);
+            entry->setField("key", "1");
+            entry->setField("value", std::to_string(num));
+            data->dirtyEntries->addEntry(entry);
+            cachedStorage->commit(
+                dev::h256(0), num, std::vector<dev::storage::TableData::Ptr>{data});
+        }
+    });
+
+    // a snapshot is pinned between two blocks, never in the middle of one
+    int64_t last = 0;
+    while (last < 200)
+    {
+        auto snapshot = cachedStorage->snapshot();
+        BOOST_REQUIRE(snapshot->num() >= last);
+        last = snapshot->num();
+        auto entries = snapshot->select(
+            dev::h256(0), last, tableInfo, "1", std::make_shared<Condition>());
+        BOOST_REQUIRE(entries->size() == 1u);
+        BOOST_TEST(entries->get(0)->getField("value") == std::to_string(last));
+    }
+    commits.get();
+    BOOST_TEST(cachedStorage->snapshots() == 0u);
+
+    // the misses of the snapshots don't leave empty caches behind
+    auto snapshot = cachedStorage->snapshot();
+    auto hitTimes = cachedStorage->hitTimes();
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto entries =
+            snapshot->select(dev::h256(0), 200, tableInfo, "2", std::make_shared<Condition>());
+        BOOST_TEST(entries->size() == 0u);
+    }
+    BOOST_TEST(cachedStorage->hitTimes() == hitTimes);
+    BOOST_TEST(cachedStorage->select(dev::h256(0), 200, tableInfo, "2", nullptr)->size() == 0u);
+    BOOST_TEST(cachedStorage->hitTimes() == hitTimes);
+}
+
+BOOST_AUTO_TEST_CASE(secondaryIndex)
+{
+    cachedStorage->setBackend(Storage::Ptr());
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields = std::vector<std::string>{"value", "name"};
+    tableInfo->indices = std::vector<std::string>{"value", "name"};
+    auto noIndex = std::make_shared<TableInfo>(*tableInfo);
+    noIndex->indices.clear();
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->setField("key", "k");
+        entry->setField("value", boost::lexical_cast<std::string>(i % 10));
+        entry->setField("name", "n" + boost::lexical_cast<std::string>(i % 7));
+        data->newEntries->addEntry(entry);
+    }
+    cachedStorage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+
+    auto check = [&](Condition::Ptr condition, size_t size) {
+        auto indexed = cachedStorage->select(dev::h256(0), 1, tableInfo, "k", condition);
+        auto scanned = cachedStorage->select(dev::h256(0), 1, noIndex, "k", condition);
+        BOOST_TEST(indexed->size() == size);
+        BOOST_TEST(scanned->size() == size);
+        for (size_t i = 0; i < indexed->size() && i < scanned->size(); ++i)
+        {
+            BOOST_TEST(indexed->get(i)->getID() == scanned->get(i)->getID());
+        }
+    };
+
+    auto condition = std::make_shared<Condition>();
+    condition->EQ("name", "n3");
+    check(condition, 14u);
+    condition->GE("value", "5");
+    check(condition, 6u);
+    condition = std::make_shared<Condition>();
+    condition->GT("value", "2");
+    condition->LE("value", "4");
+    check(condition, 20u);
+    condition = std::make_shared<Condition>();
+    condition->GT("value", "8");
+    condition->LT("value", "3");
+    check(condition, 0u);
+    condition = std::make_shared<Condition>();
+    condition->EQ("value", "x");
+    check(condition, 0u);
+
+    // the index follows the committed changes
+    condition = std::make_shared<Condition>();
+    condition->EQ("value", "0");
+    auto entries = cachedStorage->select(dev::h256(0), 1, tableInfo, "k", condition);
+    data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setID(entries->get(0)->getID());
+    entry->setField("key", "k");
+    entry->setField("value", "10");
+    data->dirtyEntries->addEntry(entry);
+    cachedStorage->commit(dev::h256(0), 2, std::vector<dev::storage::TableData::Ptr>{data});
+    check(condition, 9u);
+    condition = std::make_shared<Condition>();
+    condition->GE("value", "10");
+    check(condition, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    auto backend = std::make_shared<MockStorageScan>();
+    cachedStorage->setBackend(backend);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    // b only exists in the cache, c is newer in the cache
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    for (auto key : {"b", "c"})
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->setField("key", key);
+        entry->setField("value", "2");
+        data->newEntries->addEntry(entry);
+    }
+    cachedStorage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+
+    auto it = cachedStorage->scan(tableInfo, "", "", 2);
+    StorageIterator::Batch batch;
+    BOOST_TEST(it->next(batch));
+    BOOST_TEST(batch.size() == 2u);
+    BOOST_TEST(batch[0].first == "a");
+    BOOST_TEST(batch[1].first == "b");
+    BOOST_TEST(batch[1].second->get(0)->getField("value") == "2");
+    BOOST_TEST(it->next(batch));
+    BOOST_TEST(batch.size() == 2u);
+    BOOST_TEST(batch[0].first == "c");
+    BOOST_TEST(batch[0].second->size() == 2u);
+    BOOST_TEST(batch[1].first == "d");
+    BOOST_TEST(!it->next(batch));
+    BOOST_TEST(batch.empty());
+
+    it = cachedStorage->scan(tableInfo, "b", "d", 10);
+    BOOST_TEST(it->next(batch));
+    BOOST_TEST(batch.size() == 2u);
+    BOOST_TEST(batch[0].first == "b");
+    BOOST_TEST(batch[1].first == "c");
+    BOOST_TEST(!it->next(batch));
+
+    // backends without ordered keys don't support scanning
+    cachedStorage->setBackend(std::make_shared<MockStorageBatch>());
+    BOOST_CHECK_THROW(cachedStorage->scan(tableInfo, "", ""), StorageException);
+}
+
+BOOST_AUTO_TEST_CASE(scanSnapshot)
+{
+    auto backend = std::make_shared<MockStorageScan>();
+    cachedStorage->setBackend(backend);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto commit = [&](int64_t num, std::vector<Entry::Ptr> dirtyEntries,
+                      std::vector<std::string> newKeys) {
+        auto data = std::make_shared<dev::storage::TableData>();
+        data->info = tableInfo;
+        for (auto& entry : dirtyEntries)
+        {
+            data->dirtyEntries->addEntry(entry);
+        }
+        for (auto& key : newKeys)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setField("key", key);
+            entry->setField("value", std::to_string(num));
+            data->newEntries->addEntry(entry);
+        }
+        cachedStorage->commit(dev::h256(0), num, std::vector<dev::storage::TableData::Ptr>{data});
+    };
+    auto keys = [](StorageIterator::Ptr it) {
+        std::vector<std::string> keys;
+        StorageIterator::Batch batch;
+        while (it->next(batch))
+        {
+            for (auto& row : batch)
+            {
+                keys.push_back(row.first + row.second->get(0)->getField("value"));
+            }
+        }
+        return keys;
+    };
+
+    commit(1, {}, {"b"});
+    auto snapshot = cachedStorage->snapshot();
+
+    // block 2 updates a, removes b and inserts e after the snapshot
+    auto condition = std::make_shared<Condition>();
+    auto a = std::make_shared<Entry>();
+    a->copyFrom(cachedStorage->select(dev::h256(0), 1, tableInfo, "a", condition)->get(0));
+    a->setField("value", "2");
+    auto b = std::make_shared<Entry>();
+    b->copyFrom(cachedStorage->select(dev::h256(0), 1, tableInfo, "b", condition)->get(0));
+    b->setStatus(Entry::Status::DELETED);
+    commit(2, {a, b}, {"e"});
+
+    BOOST_TEST(keys(snapshot->scan(tableInfo, "", "", 2)) ==
+               std::vector<std::string>({"a1", "b1", "c1", "d1"}));
+    BOOST_TEST(keys(cachedStorage->scan(tableInfo, "", "", 2)) ==
+               std::vector<std::string>({"a2", "c1", "d1", "e2"}));
+    BOOST_TEST(keys(snapshot->scan(tableInfo, "b", "d", 10)) ==
+               std::vector<std::string>({"b1", "c1"}));
+}
+
+BOOST_AUTO_TEST_CASE(mergeCommit)
+{
+    auto backend = std::make_shared<MockStorageMerge>();
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setBackend(backend);
+    storage->setMaxForwardBlock(100);
+    storage->setMaxMergeBlock(5);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "1");
+    data->newEntries->addEntry(entry);
+
+    storage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+    while (!backend->entered.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto entries = storage->select(dev::h256(0), 1, tableInfo, "1", std::make_shared<Condition>());
+    auto id = entries->get(0)->getID();
+
+    // block 1 is held by the backend, 2 to 4 wait in the pipeline and are written together
+    for (int64_t num = 2; num <= 4; ++num)
+    {
+        data = std::make_shared<dev::storage::TableData>();
+        data->info = tableInfo;
+        entry = std::make_shared<Entry>();
+        entry->setID(id);
+        entry->setField("key", "1");
+        entry->setField("value", boost::lexical_cast<std::string>(num));
+        data->dirtyEntries->addEntry(entry);
+
+        storage->commit(dev::h256(0), num, std::vector<dev::storage::TableData::Ptr>{data});
+    }
+    BOOST_TEST(storage->pipelineDepth() == 4u);
+    BOOST_TEST(storage->forwardBytes() > 0);
+
+    backend->released.store(true);
+    while (storage->syncNum() != 4)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    BOOST_TEST(backend->commitNums.size() == 2u);
+    BOOST_TEST(backend->commitNums[1] == 4);
+    BOOST_TEST(storage->lastMergedBlocks() == 3u);
+    BOOST_TEST(storage->pipelineDepth() == 0u);
+    BOOST_TEST(storage->forwardBytes() == 0);
+
+    auto merged = backend->commitDatas[1];
+    BOOST_TEST(merged->newEntries->size() == 0u);
+    BOOST_TEST(merged->dirtyEntries->size() == 1u);
+    BOOST_TEST(merged->dirtyEntries->get(0)->getField("value") == "4");
+
+    storage->stop();
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint)
+{
+    auto backend = std::make_shared<MockStorageMerge>();
+    auto storage = std::make_shared<CachedStorage>();
+    storage->setBackend(backend);
+    storage->setMaxForwardBlock(100);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto data = std::make_shared<dev::storage::TableData>();
+    data->info = tableInfo;
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "1");
+    entry->setField("value", "1");
+    data->newEntries->addEntry(entry);
+    storage->commit(dev::h256(0), 1, std::vector<dev::storage::TableData::Ptr>{data});
+    while (!backend->entered.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the checkpoint waits for block 1 held by the backend
+    int64_t num = 0;
+    std::thread checkpoint([&]() { num = storage->checkpoint("snapshot"); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_TEST(backend->checkpointPath.empty());
+
+    backend->released.store(true);
+    checkpoint.join();
+    BOOST_TEST(num == 1);
+    BOOST_TEST(backend->checkpointPath == "snapshot");
+    BOOST_TEST(backend->checkpointCommits == 1u);
+
+    storage->stop();
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
 #if 0
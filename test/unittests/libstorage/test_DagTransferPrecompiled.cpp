@@ -69,6 +69,7 @@ struct DagTransferPrecompiledFixture
     std::string userDrawFunc{"userDraw(string,uint256)"};
     std::string userTransferFunc{"userTransfer(string,string,uint256)"};
     std::string userBalanceFunc{"userBalance(string)"};
+    std::string userBatchTransferFunc{"userBatchTransfer(string[],string[],uint256[])"};
 };
 
 BOOST_FIXTURE_TEST_SUITE(test_DagTransferPrecompiled, DagTransferPrecompiledFixture)
@@ -476,6 +477,80 @@ BOOST_AUTO_TEST_CASE(userTransfer)
     BOOST_TEST(CODE_INVALID_BALANCE_OVERFLOW == result);
 }
 
+BOOST_AUTO_TEST_CASE(userBatchTransfer)
+{  // function userBatchTransfer(string[] user_a, string[] user_b, uint256[] amount) public
+   // returns(uint256);
+    Address origin;
+    dev::eth::ContractABI abi;
+    dev::s256 result;
+    dev::u256 balance;
+    bytes out;
+    bytes params;
+
+    std::vector<std::string> from{"user0", "user1", "user0"};
+    std::vector<std::string> to{"user1", "user2", "user2"};
+    std::vector<dev::u256> amounts{100, 150, 10};
+
+    // every distinct user is a tag
+    params = abi.abiIn(userBatchTransferFunc, from, to, amounts);
+    auto vTags = dtPrecompiled->getParallelTag(bytesConstRef(&params));
+    BOOST_TEST((vTags == std::vector<std::string>{"user0", "user1", "user2"}));
+
+    // invalid input, the lengths differ
+    params = abi.abiIn(userBatchTransferFunc, from, to, std::vector<dev::u256>{100, 150});
+    vTags = dtPrecompiled->getParallelTag(bytesConstRef(&params));
+    BOOST_TEST(vTags.empty());
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result);
+    BOOST_TEST(CODE_INVALID_BATCH_SIZE == result);
+
+    // invalid input, a user name empty string
+    params = abi.abiIn(userBatchTransferFunc, from, std::vector<std::string>{"user1", "", "user2"},
+        amounts);
+    vTags = dtPrecompiled->getParallelTag(bytesConstRef(&params));
+    BOOST_TEST(vTags.empty());
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result);
+    BOOST_TEST(CODE_INVALID_USER_NAME == result);
+
+    // from user not exist
+    params = abi.abiIn(userBatchTransferFunc, from, to, amounts);
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result);
+    BOOST_TEST(CODE_INVALID_USER_NOT_EXIST == result);
+
+    // user1 receives 100 from user0 before it sends 150, user2 is added by the batch
+    params = abi.abiIn(userAddFunc, std::string("user0"), dev::u256(200));
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    params = abi.abiIn(userAddFunc, std::string("user1"), dev::u256(50));
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    params = abi.abiIn(userBatchTransferFunc, from, to, amounts);
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result);
+    BOOST_TEST(0 == result);
+
+    std::vector<dev::u256> expected{90, 0, 160};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        params = abi.abiIn(userBalanceFunc, "user" + std::to_string(i));
+        out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+        abi.abiOut(bytesConstRef(&out), result, balance);
+        BOOST_TEST(((result == 0) && (balance == expected[i])));
+    }
+
+    // the batch is all or nothing, the first transfer is not applied when the second fails
+    params = abi.abiIn(userBatchTransferFunc, std::vector<std::string>{"user0", "user1"},
+        std::vector<std::string>{"user2", "user2"}, std::vector<dev::u256>{10, 1});
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result);
+    BOOST_TEST(CODE_INVALID_INSUFFICIENT_BALANCE == result);
+
+    params = abi.abiIn(userBalanceFunc, std::string("user2"));
+    out = dtPrecompiled->call(context, bytesConstRef(&params), origin);
+    abi.abiOut(bytesConstRef(&out), result, balance);
+    BOOST_TEST(((result == 0) && (balance == 160)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_DagTransferPrecompiled
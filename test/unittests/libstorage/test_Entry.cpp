@@ -61,6 +61,33 @@ BOOST_AUTO_TEST_CASE(copyFrom)
     BOOST_TEST(entry2->refCount() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(fields)
+{
+    auto entry1 = std::make_shared<Entry>();
+    entry1->setField("value", "1");
+    entry1->setField("key", "100");
+    entry1->setField("name", "a");
+
+    BOOST_TEST(entry1->size() == 3u);
+    BOOST_TEST(entry1->capacity() == 17);
+    BOOST_TEST((entry1->find("id") == entry1->end()));
+    BOOST_TEST(entry1->find("name")->second == "a");
+
+    // same order as a map so table hashes don't change
+    std::vector<std::string> names;
+    for (auto& it : *entry1)
+    {
+        names.push_back(it.first);
+    }
+    BOOST_TEST(names == std::vector<std::string>({"key", "name", "value"}));
+
+    entry1->setField("name", "abc");
+    BOOST_TEST(entry1->size() == 3u);
+    BOOST_TEST(entry1->getField("name") == "abc");
+    BOOST_TEST(entry1->capacity() == 19);
+    BOOST_TEST(entry1->getField("id") == "");
+}
+
 BOOST_AUTO_TEST_CASE(parallel_copyFrom)
 {
 #if 0
@@ -109,6 +136,20 @@ BOOST_AUTO_TEST_CASE(parallel_copyFrom)
 #endif
 }
 
+BOOST_AUTO_TEST_CASE(makeShared)
+{
+    auto entry1 = dev::storage::makeShared<Entry>();
+    entry1->setField("key", "1");
+    auto entry2 = dev::storage::makeShared<Entry>();
+    entry2->copyFrom(entry1);
+    BOOST_TEST(entry2->getField("key") == "1");
+    BOOST_TEST(entry1->refCount() == 2);
+
+    // writes without options share one default
+    BOOST_TEST(AccessOptions::defaultOptions() == AccessOptions::defaultOptions());
+    BOOST_TEST(AccessOptions::defaultOptions()->check);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_Entry
@@ -0,0 +1,121 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+#include "libstorage/LevelDBStorage2.h"
+#include <libdevcore/BasicLevelDB.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/LevelDB.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_LevelDBStorage2
+{
+struct LevelDBStorage2Fixture
+{
+    LevelDBStorage2Fixture()
+      : path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+    {
+        levelDB = std::make_shared<LevelDBStorage2>();
+        levelDB->setDB(std::make_shared<dev::db::BasicLevelDB>(
+            dev::db::LevelDB::defaultDBOptions(), path.string()));
+    }
+    ~LevelDBStorage2Fixture()
+    {
+        levelDB.reset();
+        boost::filesystem::remove_all(path);
+    }
+
+    void commitKeys(const std::string& table, const std::string& keyField,
+        const std::vector<std::string>& keys)
+    {
+        auto tableData = std::make_shared<TableData>();
+        tableData->info->name = table;
+        tableData->info->key = keyField;
+        tableData->info->fields.push_back("value");
+        for (auto& key : keys)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setField(keyField, key);
+            entry->setField("value", table + key);
+            tableData->newEntries->addEntry(entry);
+        }
+        levelDB->commit(h256(0x01), 1, std::vector<TableData::Ptr>{tableData});
+    }
+
+    std::vector<std::string> scanKeys(const std::string& table, size_t batchSize)
+    {
+        auto tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = table;
+        std::vector<std::string> keys;
+        auto it = levelDB->scan(tableInfo, "", "", batchSize);
+        StorageIterator::Batch batch;
+        while (it->next(batch))
+        {
+            for (auto& row : batch)
+            {
+                BOOST_CHECK_EQUAL(row.second->get(0)->getField("value"), table + row.first);
+                keys.push_back(row.first);
+            }
+        }
+        return keys;
+    }
+
+    boost::filesystem::path path;
+    LevelDBStorage2::Ptr levelDB;
+};
+
+BOOST_FIXTURE_TEST_SUITE(LevelDBStorage2Test, LevelDBStorage2Fixture)
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    // t_x and t_x_y keep their keys under the prefix of t
+    commitKeys(SYS_TABLES, "table_name", {"t", "t_x", "t_x_y", "u"});
+    commitKeys("t", "id", {"1", "2", "3"});
+    commitKeys("t_x", "id", {"1", "2"});
+    commitKeys("t_x_y", "id", {"1"});
+    commitKeys("u", "id", {"1"});
+
+    for (size_t batchSize : {1, 2, 100})
+    {
+        BOOST_CHECK(scanKeys("t", batchSize) == std::vector<std::string>({"1", "2", "3"}));
+        BOOST_CHECK(scanKeys("t_x", batchSize) == std::vector<std::string>({"1", "2"}));
+        BOOST_CHECK(scanKeys("t_x_y", batchSize) == std::vector<std::string>({"1"}));
+        BOOST_CHECK(scanKeys("u", batchSize) == std::vector<std::string>({"1"}));
+    }
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t";
+    auto it = levelDB->scan(tableInfo, "2", "3");
+    StorageIterator::Batch batch;
+    BOOST_CHECK(it->next(batch));
+    BOOST_CHECK_EQUAL(batch.size(), 1u);
+    BOOST_CHECK_EQUAL(batch[0].first, "2");
+    BOOST_CHECK(!it->next(batch));
+
+    // a view taken before a commit doesn't see it
+    it = levelDB->scan(tableInfo, "", "");
+    commitKeys("t", "id", {"4"});
+    BOOST_CHECK(it->next(batch));
+    BOOST_CHECK_EQUAL(batch.size(), 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_LevelDBStorage2
@@ -16,8 +16,10 @@
  */
 
 #include "Common.h"
+#include <libconfig/GlobalConfigure.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/easylog.h>
+#include <libstorage/AccessSet.h>
 #include <libstorage/Common.h>
 #include <libstorage/MemoryTable.h>
 #include <libstorage/MemoryTableFactory2.h>
@@ -25,6 +27,7 @@
 #include <libstorage/Table.h>
 #include <tbb/parallel_for.h>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <string>
 #include <thread>
 #include <vector>
@@ -51,6 +54,21 @@ public:
     bool onlyDirty() override { return false; }
 };
 
+class RecordingDB : public MockAMOPDB
+{
+public:
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>& _datas) override
+    {
+        for (auto& data : _datas)
+        {
+            names.push_back(data->info->name);
+        }
+        return _datas.size();
+    }
+
+    std::vector<std::string> names;
+};
+
 struct MemoryTableFactoryFixture2
 {
     MemoryTableFactoryFixture2()
@@ -242,6 +260,165 @@ BOOST_AUTO_TEST_CASE(setBlockNum)
     memoryDBFactory->setBlockNum(2);
 }
 
+BOOST_AUTO_TEST_CASE(incrementalHash)
+{
+    auto version = g_BCOSConfig.version();
+    auto supportedVersion = g_BCOSConfig.supportedVersion();
+    g_BCOSConfig.setSupportedVersion("2.1.0", V2_1_0);
+
+    auto write = [](dev::storage::MemoryTableFactory2::Ptr factory, const std::vector<std::string>& keys) {
+        factory->createTable("t_test", "key", "value", true, Address(), false);
+        auto table = factory->openTable("t_test", true, false);
+        for (auto& key : keys)
+        {
+            auto entry = table->newEntry();
+            entry->setField("value", "v" + key);
+            table->insert(key, entry);
+        }
+        return table;
+    };
+
+    auto factory1 = std::make_shared<dev::storage::MemoryTableFactory2>();
+    factory1->setStateStorage(std::make_shared<MockAMOPDB>());
+    auto table1 = write(factory1, {"1", "2", "3"});
+
+    auto factory2 = std::make_shared<dev::storage::MemoryTableFactory2>();
+    factory2->setStateStorage(std::make_shared<MockAMOPDB>());
+    auto table2 = write(factory2, {"3", "1", "2"});
+
+    // the digests don't depend on the order of the writes
+    BOOST_TEST(table1->hash() != h256());
+    BOOST_TEST(table1->hash() == table2->hash());
+    BOOST_TEST(factory1->hash() == factory2->hash());
+
+    // updated and rolled back entries are replaced in the accumulator
+    auto hash = table1->hash();
+    auto savepoint = factory1->savepoint();
+    auto entry = table1->newEntry();
+    entry->setField("value", "v4");
+    table1->insert("4", entry);
+    entry = table1->newEntry();
+    entry->setField("value", "updated");
+    table1->update("1", entry, table1->newCondition());
+    BOOST_TEST(table1->hash() != hash);
+    factory1->rollback(savepoint);
+    BOOST_TEST(table1->hash() == hash);
+
+    g_BCOSConfig.setSupportedVersion(supportedVersion, version);
+}
+
+BOOST_AUTO_TEST_CASE(commitDBOrder)
+{
+    auto db = std::make_shared<RecordingDB>();
+    auto factory = std::make_shared<dev::storage::MemoryTableFactory2>();
+    factory->setStateStorage(db);
+    for (auto name : {"t_c", "t_a", "t_b", "t_untouched"})
+    {
+        factory->createTable(name, "key", "value", true, Address(), false);
+    }
+    for (auto name : {"t_c", "t_a", "t_b"})
+    {
+        auto table = factory->openTable(name, true, false);
+        auto entry = table->newEntry();
+        entry->setField("value", name);
+        table->insert("key", entry);
+    }
+    factory->hash();
+    factory->commitDB(h256(0), 1);
+
+    // dumped in parallel, committed in the order of the names
+    BOOST_TEST(std::is_sorted(db->names.begin(), db->names.end()));
+    for (auto name : {"t_a", "t_b", "t_c"})
+    {
+        BOOST_TEST(std::count(db->names.begin(), db->names.end(), name) == 1);
+    }
+    BOOST_TEST(std::count(db->names.begin(), db->names.end(), "t_untouched") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(changeLogScope)
+{
+    memoryDBFactory->createTable("t_test", "key", "value", true, Address(), false);
+    auto table = memoryDBFactory->openTable("t_test", true, false);
+    auto insert = [&](const std::string& key) {
+        auto entry = table->newEntry();
+        entry->setField("value", "v" + key);
+        table->insert(key, entry);
+    };
+
+    // two transactions interleaved on the same thread keep separate undo logs
+    ChangeLog changeLog1;
+    ChangeLog changeLog2;
+    size_t savepoint1 = 0;
+    {
+        ChangeLog::Scope scope1(changeLog1);
+        BOOST_TEST(ChangeLog::current() == &changeLog1);
+        savepoint1 = memoryDBFactory->savepoint();
+        insert("1");
+        {
+            ChangeLog::Scope scope2(changeLog2);
+            BOOST_TEST(ChangeLog::current() == &changeLog2);
+            BOOST_TEST(memoryDBFactory->savepoint() == 0u);
+            insert("2");
+        }
+        BOOST_TEST(ChangeLog::current() == &changeLog1);
+        BOOST_TEST(changeLog1.size() == 1u);
+        BOOST_TEST(changeLog2.size() == 1u);
+
+        memoryDBFactory->rollback(savepoint1);
+    }
+    BOOST_TEST(ChangeLog::current() == nullptr);
+    BOOST_TEST(table->select("1", table->newCondition())->size() == 0u);
+    BOOST_TEST(table->select("2", table->newCondition())->size() == 1u);
+
+    changeLog2.rollback(0);
+    BOOST_TEST(table->select("2", table->newCondition())->size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(accessSetScope)
+{
+    memoryDBFactory->createTable("t_test", "key", "value", true, Address(), false);
+    auto table = memoryDBFactory->openTable("t_test", true, false);
+
+    AccessSet accessSet;
+    {
+        AccessSet::Scope scope(&accessSet);
+        BOOST_TEST(AccessSet::current() == &accessSet);
+
+        // a cached table is a read of its table entry and permissions as well
+        table = memoryDBFactory->openTable("t_test", true, false);
+        table->select("1", table->newCondition());
+        table->select("2", table->newCondition());
+        auto entry = table->newEntry();
+        entry->setField("value", "v2");
+        table->insert("2", entry);
+        table->remove("3", table->newCondition());
+        {
+            AccessSet::Scope pause(nullptr);
+            table->select("4", table->newCondition());
+        }
+    }
+    BOOST_TEST(AccessSet::current() == nullptr);
+    table->select("5", table->newCondition());
+
+    std::set<std::string> reads{AccessSet::field(SYS_TABLES, "t_test"),
+        AccessSet::field(SYS_ACCESS_TABLE, "t_test"), AccessSet::field("t_test", "1")};
+    std::set<std::string> writes{
+        AccessSet::field("t_test", "2"), AccessSet::field("t_test", "3")};
+    BOOST_TEST(accessSet.reads() == reads);
+    BOOST_TEST(accessSet.writes() == writes);
+
+    // a read is covered by a read or a write, a write only by a write
+    AccessSet predicted;
+    predicted.write("t_test", "1");
+    predicted.write("t_test", "2");
+    predicted.write("t_test", "3");
+    predicted.read(SYS_TABLES, "t_test");
+    BOOST_TEST(!accessSet.coveredBy(predicted));
+    predicted.read(SYS_ACCESS_TABLE, "t_test");
+    BOOST_TEST(accessSet.coveredBy(predicted));
+    BOOST_TEST(!predicted.coveredBy(accessSet));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_MemoryTableFactory2
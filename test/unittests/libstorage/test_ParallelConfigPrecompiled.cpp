@@ -24,6 +24,8 @@
 #include <libdevcore/easylog.h>
 #include <libdevcrypto/Common.h>
 #include <libethcore/ABI.h>
+#include <libethcore/ABIParser.h>
+#include <libethcore/Transaction.h>
 #include <libprecompiled/ParallelConfigPrecompiled.h>
 #include <libstorage/MemoryTable.h>
 #include <libstorage/MemoryTableFactoryFactory.h>
@@ -111,6 +113,42 @@ public:
         return parallelConfigPrecompiled->getFuncSelector(_functionName);
     }
 
+    void registerFunction(const Address& _address, const string& _functionName, int _criticalSize)
+    {
+        ContractABI abi;
+        bytes param = abi.abiIn(
+            PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT, _address, _functionName, _criticalSize);
+        BOOST_CHECK(callPrecompiled(ref(param)) == abi.abiIn("", (int)CODE_SUCCESS));
+    }
+
+    Transaction createTx(const Address& _address, bytes const& _data)
+    {
+        Transaction tx(u256(0), u256(0), u256(10000000), _address, _data, u256(utcTime() + rand()));
+        tx.forceSender(Address(0x12345));
+        return tx;
+    }
+
+    // the criticals decoded from all the params of the function, without the cache
+    vector<string> uncachedCriticals(Transaction const& _tx)
+    {
+        uint32_t selector = parallelConfigPrecompiled->getParamFunc(ref(_tx.data()));
+        auto config = parallelConfigPrecompiled->getParallelConfig(
+            context, _tx.receiveAddress(), selector, _tx.sender());
+        BOOST_REQUIRE(config);
+        dev::eth::abi::ABIFunc af;
+        BOOST_REQUIRE(af.parser(config->functionName));
+        vector<string> criticals;
+        ContractABI abi;
+        BOOST_REQUIRE(
+            abi.abiOutByFuncSelector(ref(_tx.data()).cropped(4), af.getParamsType(), criticals));
+        criticals.resize((size_t)config->criticalSize);
+        for (string& critical : criticals)
+        {
+            critical += _tx.receiveAddress().hex();
+        }
+        return criticals;
+    }
+
 public:
     ExecutiveContext::Ptr context;
     TableFactory::Ptr memoryTableFactory;
@@ -164,6 +202,55 @@ BOOST_AUTO_TEST_CASE(registerParallelFunction)
     BOOST_CHECK(hasRegistered(contractAddr, TRANSFER_FUNC) == false);
 }
 
+BOOST_AUTO_TEST_CASE(txCriticals)
+{
+    Address contractAddr = Address(0x23333333);
+    const string TRANSFER_FUNC = "transfer(string,string,uint256)";
+    const string DEPOSIT_FUNC = "deposit(string,uint256,string)";
+    const string SET_FUNC = "set(string)";
+    registerFunction(contractAddr, TRANSFER_FUNC, 2);
+    registerFunction(contractAddr, DEPOSIT_FUNC, 2);
+
+    ContractABI abi;
+    Transaction transferTx =
+        createTx(contractAddr, abi.abiIn(TRANSFER_FUNC, string("alice"), string("bob"), u256(10)));
+    Transaction depositTx = createTx(
+        contractAddr, abi.abiIn(DEPOSIT_FUNC, string("carol"), u256(20), string("memo")));
+
+    // the criticals decoded from the cached head types match the ones of all the params
+    auto criticals = context->getTxCriticals(transferTx);
+    BOOST_REQUIRE(criticals);
+    BOOST_CHECK(*criticals == uncachedCriticals(transferTx));
+    BOOST_CHECK(*criticals ==
+                vector<string>({"alice" + contractAddr.hex(), "bob" + contractAddr.hex()}));
+    criticals = context->getTxCriticals(depositTx);
+    BOOST_REQUIRE(criticals);
+    BOOST_CHECK(*criticals == uncachedCriticals(depositTx));
+    BOOST_CHECK(*criticals ==
+                vector<string>({"carol" + contractAddr.hex(), "20" + contractAddr.hex()}));
+
+    // another call of the function hits the cache, the config is read once per block
+    bytes param = abi.abiIn(PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR, contractAddr, TRANSFER_FUNC);
+    BOOST_CHECK(callPrecompiled(ref(param)) == abi.abiIn("", (int)CODE_SUCCESS));
+    Transaction otherTransferTx =
+        createTx(contractAddr, abi.abiIn(TRANSFER_FUNC, string("bob"), string("dave"), u256(1)));
+    criticals = context->getTxCriticals(otherTransferTx);
+    BOOST_REQUIRE(criticals);
+    BOOST_CHECK(*criticals ==
+                vector<string>({"bob" + contractAddr.hex(), "dave" + contractAddr.hex()}));
+
+    // a function that is not parallel has no criticals, cached as well
+    Transaction setTx = createTx(contractAddr, abi.abiIn(SET_FUNC, string("alice")));
+    BOOST_CHECK(context->getTxCriticals(setTx) == nullptr);
+    registerFunction(contractAddr, SET_FUNC, 1);
+    BOOST_CHECK(context->getTxCriticals(setTx) == nullptr);
+
+    // nor has a contract creation
+    Transaction createContractTx(u256(0), u256(0), u256(10000000), bytes(), u256(utcTime()));
+    createContractTx.forceSender(Address(0x12345));
+    BOOST_CHECK(context->getTxCriticals(createContractTx) == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
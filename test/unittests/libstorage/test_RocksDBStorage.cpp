@@ -50,6 +50,32 @@ struct MockWriteBatch : public rocksdb::WriteBatch
     }
 };
 
+// iterates a copy of the keys taken when created, as the view of a db iterator
+class MockIterator : public rocksdb::Iterator
+{
+public:
+    MockIterator(const std::map<std::string, std::string>& db) : m_db(db), m_it(m_db.end()) {}
+
+    bool Valid() const override { return m_it != m_db.end(); }
+    void SeekToFirst() override { m_it = m_db.begin(); }
+    void SeekToLast() override { m_it = m_db.empty() ? m_db.end() : std::prev(m_db.end()); }
+    void Seek(const Slice& target) override { m_it = m_db.lower_bound(target.ToString()); }
+    void SeekForPrev(const Slice& target) override
+    {
+        m_it = m_db.upper_bound(target.ToString());
+        m_it = m_it == m_db.begin() ? m_db.end() : std::prev(m_it);
+    }
+    void Next() override { ++m_it; }
+    void Prev() override { m_it = m_it == m_db.begin() ? m_db.end() : std::prev(m_it); }
+    Slice key() const override { return Slice(m_it->first); }
+    Slice value() const override { return Slice(m_it->second); }
+    Status status() const override { return Status::OK(); }
+
+private:
+    std::map<std::string, std::string> m_db;
+    std::map<std::string, std::string>::const_iterator m_it;
+};
+
 class MockRocksDB : public rocksdb::DB
 {
 public:
@@ -122,7 +148,7 @@ public:
     {
         return std::vector<Status>();
     }
-    Iterator* NewIterator(const ReadOptions&, ColumnFamilyHandle*) { return nullptr; }
+    Iterator* NewIterator(const ReadOptions&, ColumnFamilyHandle*) { return new MockIterator(db); }
     Status NewIterators(
         const ReadOptions&, const std::vector<ColumnFamilyHandle*>&, std::vector<Iterator*>*)
     {
@@ -232,6 +258,40 @@ struct RocksDBFixture
         entries->addEntry(entry);
         return entries;
     }
+    void commitKeys(const std::string& table, const std::string& keyField,
+        const std::vector<std::string>& keys, int status = Entry::Status::NORMAL)
+    {
+        auto tableData = std::make_shared<dev::storage::TableData>();
+        tableData->info->name = table;
+        tableData->info->key = keyField;
+        tableData->info->fields.push_back("value");
+        for (auto& key : keys)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setField(keyField, key);
+            entry->setField("value", table + key);
+            entry->setStatus(status);
+            tableData->newEntries->addEntry(entry);
+        }
+        rocksDB->commit(h256(0x01), 1, std::vector<dev::storage::TableData::Ptr>{tableData});
+    }
+    std::vector<std::string> scanKeys(const std::string& table, size_t batchSize)
+    {
+        auto tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = table;
+        std::vector<std::string> keys;
+        auto it = rocksDB->scan(tableInfo, "", "", batchSize);
+        StorageIterator::Batch batch;
+        while (it->next(batch))
+        {
+            for (auto& row : batch)
+            {
+                BOOST_CHECK_EQUAL(row.second->get(0)->getField("value"), table + row.first);
+                keys.push_back(row.first);
+            }
+        }
+        return keys;
+    }
     dev::storage::RocksDBStorage::Ptr rocksDB;
 };
 
@@ -280,6 +340,36 @@ BOOST_AUTO_TEST_CASE(commit)
     BOOST_CHECK_EQUAL(entries->size(), 1u);
 }
 
+BOOST_AUTO_TEST_CASE(encrypted)
+{
+    auto mockRocksDB = std::make_shared<MockRocksDB>();
+    auto encrypted = std::make_shared<dev::storage::RocksDBStorage>();
+    encrypted->setDB(mockRocksDB);
+    encrypted->setDataKey(bytes(32, 0x5a));
+    std::vector<dev::storage::TableData::Ptr> datas;
+    dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->info->fields.push_back("id");
+    tableData->newEntries = getEntries();
+    datas.push_back(tableData);
+    BOOST_CHECK_EQUAL(encrypted->commit(h256(0x01), 1, datas), 1u);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    auto entries =
+        encrypted->select(h256(0x01), 1, tableInfo, "LiSi", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("id"), "1");
+
+    // the rows on disk aren't readable without the key
+    auto plain = std::make_shared<dev::storage::RocksDBStorage>();
+    plain->setDB(mockRocksDB);
+    BOOST_CHECK_THROW(
+        plain->select(h256(0x01), 1, tableInfo, "LiSi", std::make_shared<Condition>()),
+        std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
     h256 h(0x01);
@@ -304,6 +394,61 @@ BOOST_AUTO_TEST_CASE(exception)
         rocksDB->select(h, num, tableInfo, key, std::make_shared<Condition>()), boost::exception);
 }
 
+BOOST_AUTO_TEST_CASE(scan)
+{
+    // t_x and t_x_y keep their keys under the prefix of t
+    commitKeys(SYS_TABLES, "table_name", {"t", "t_x", "t_x_y", "u"});
+    commitKeys("t", "id", {"1", "2", "3"});
+    commitKeys("t_x", "id", {"1", "2"});
+    commitKeys("t_x_y", "id", {"1"});
+    commitKeys("u", "id", {"1"});
+
+    for (size_t batchSize : {1, 2, 100})
+    {
+        BOOST_CHECK(scanKeys("t", batchSize) == std::vector<std::string>({"1", "2", "3"}));
+        BOOST_CHECK(scanKeys("t_x", batchSize) == std::vector<std::string>({"1", "2"}));
+        BOOST_CHECK(scanKeys("t_x_y", batchSize) == std::vector<std::string>({"1"}));
+    }
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t";
+    auto it = rocksDB->scan(tableInfo, "2", "3");
+    StorageIterator::Batch batch;
+    BOOST_CHECK(it->next(batch));
+    BOOST_CHECK_EQUAL(batch.size(), 1u);
+    BOOST_CHECK_EQUAL(batch[0].first, "2");
+    BOOST_CHECK(!it->next(batch));
+}
+
+BOOST_AUTO_TEST_CASE(prune)
+{
+    commitKeys(SYS_TABLES, "table_name", {"t", "t_x"});
+    commitKeys("t", "id", {"1"}, Entry::Status::DELETED);
+    commitKeys("t_x", "id", {"1"}, Entry::Status::DELETED);
+
+    // only the deleted key of t itself is pruned with t
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t";
+    std::string key;
+    StorageIterator::Batch pruned;
+    BOOST_CHECK(rocksDB->prune(tableInfo, key, 2, 100, pruned));
+    BOOST_CHECK_EQUAL(pruned.size(), 1u);
+    BOOST_CHECK_EQUAL(pruned[0].first, "1");
+    BOOST_CHECK(key.empty());
+}
+
+BOOST_AUTO_TEST_CASE(columnFamilyName)
+{
+    BOOST_CHECK_EQUAL(RocksDBStorage::columnFamilyName(SYS_HASH_2_BLOCK), SYS_HASH_2_BLOCK);
+    BOOST_CHECK_EQUAL(RocksDBStorage::columnFamilyName(SYS_TX_HASH_2_BLOCK), SYS_TX_HASH_2_BLOCK);
+    BOOST_CHECK_EQUAL(
+        RocksDBStorage::columnFamilyName("_contract_data_0123456789abcdef_"), "_contract_data_");
+    BOOST_CHECK_EQUAL(
+        RocksDBStorage::columnFamilyName(SYS_CURRENT_STATE), rocksdb::kDefaultColumnFamilyName);
+    BOOST_CHECK_EQUAL(RocksDBStorage::isAppendOnly(SYS_NUMBER_2_HASH), true);
+    BOOST_CHECK_EQUAL(RocksDBStorage::isAppendOnly("_contract_data_"), false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_RocksDBStorage
@@ -0,0 +1,120 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief: unit test of the encoding of the rows of the key-value storages
+ *
+ * @file: test_RowCodec.cpp
+ */
+
+#include "boost/archive/binary_oarchive.hpp"
+#include "boost/serialization/map.hpp"
+#include "boost/serialization/vector.hpp"
+#include <libstorage/RowCodec.h>
+#include <libstorage/StorageException.h>
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_RowCodec
+{
+RowCodec::Rows rows()
+{
+    RowCodec::Rows rows(3);
+    rows[0] = {{ID_FIELD, "1"}, {NUM_FIELD, "10"}, {STATUS, "0"}, {"name", "alice"},
+        {"value", string(300, 'v')}};
+    rows[1] = {{ID_FIELD, "2"}, {NUM_FIELD, "11"}, {STATUS, "1"}, {"name", "alice"},
+        {"value", ""}};
+    // a row without some columns of the others
+    rows[2] = {{ID_FIELD, "3"}, {NUM_FIELD, "12"}, {"name", "alice"}};
+    return rows;
+}
+
+string archive(const RowCodec::Rows& rows)
+{
+    stringstream ss;
+    boost::archive::binary_oarchive oa(ss);
+    oa << rows;
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_SUITE(RowCodecTest)
+
+BOOST_AUTO_TEST_CASE(roundTrip)
+{
+    auto value = RowCodec::encode(rows());
+    BOOST_CHECK(!RowCodec::isArchive(value.data(), value.size()));
+    BOOST_CHECK(RowCodec::decodeRows(value) == rows());
+    BOOST_CHECK(RowCodec::decodeRows(RowCodec::encode(RowCodec::Rows())).empty());
+    // the names are written once and there is no archive header
+    BOOST_CHECK_LT(value.size() + 100, archive(rows()).size());
+
+    auto entries = RowCodec::decodeEntries(value.data(), value.size());
+    BOOST_CHECK_EQUAL(entries.size(), 3u);
+    BOOST_CHECK_EQUAL(entries[0]->getID(), 1u);
+    BOOST_CHECK_EQUAL(entries[0]->num(), 10u);
+    BOOST_CHECK_EQUAL(entries[0]->getField("value"), string(300, 'v'));
+    BOOST_CHECK_EQUAL(entries[1]->getStatus(), Entry::Status::DELETED);
+    BOOST_CHECK_EQUAL(entries[2]->getStatus(), Entry::Status::NORMAL);
+    BOOST_CHECK_EQUAL(entries[2]->size(), 3u);
+    BOOST_CHECK(entries[2]->find("value") == entries[2]->end());
+    // the fields are sorted, as setField keeps them
+    auto entry = make_shared<Entry>();
+    auto row = rows()[0];
+    for (auto& field : row)
+    {
+        entry->setField(field.first, field.second);
+    }
+    BOOST_CHECK(Entry::Fields(entry->begin(), entry->end()) ==
+                Entry::Fields(entries[0]->begin(), entries[0]->end()));
+    BOOST_CHECK_EQUAL(entry->capacity(), entries[0]->capacity());
+}
+
+BOOST_AUTO_TEST_CASE(archiveRead)
+{
+    auto value = archive(rows());
+    BOOST_CHECK(RowCodec::isArchive(value.data(), value.size()));
+    BOOST_CHECK(RowCodec::decodeRows(value) == rows());
+    auto entries = RowCodec::decodeEntries(value.data(), value.size());
+    BOOST_CHECK_EQUAL(entries.size(), 3u);
+    BOOST_CHECK_EQUAL(entries[1]->getID(), 2u);
+    BOOST_CHECK_EQUAL(entries[1]->getField("name"), "alice");
+}
+
+BOOST_AUTO_TEST_CASE(corrupted)
+{
+    auto value = RowCodec::encode(rows());
+    for (size_t size = 2; size < value.size(); size += 7)
+    {
+        BOOST_CHECK_THROW(RowCodec::decodeRows(value.substr(0, size)), StorageException);
+    }
+    auto version = value;
+    version[1] = 2;
+    BOOST_CHECK_THROW(RowCodec::decodeRows(version), StorageException);
+    BOOST_CHECK_THROW(RowCodec::decodeRows(value + "x"), StorageException);
+
+    RowCodec::Rows noID(1);
+    noID[0] = {{NUM_FIELD, "1"}};
+    auto encoded = RowCodec::encode(noID);
+    BOOST_CHECK_THROW(RowCodec::decodeEntries(encoded.data(), encoded.size()), StorageException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_RowCodec
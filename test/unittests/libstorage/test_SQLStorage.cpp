@@ -27,6 +27,8 @@
 #include <libstorage/StorageException.h>
 #include <libstorage/Table.h>
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
 
 using namespace dev;
 using namespace dev::storage;
@@ -54,6 +56,11 @@ public:
 
         if (requestJson["op"].asString() == "select")
         {
+            ++selects;
+            if (requestJson["params"]["table"].asString() == "t_slow")
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
             if (requestJson["params"]["table"].asString() == "e")
             {
                 BOOST_THROW_EXCEPTION(StorageException(-1, "mock exception"));
@@ -84,6 +91,11 @@ public:
                 responseJson["result"] = resultJson;
             }
         }
+        else if (requestJson["op"].asString() == "batchSelect")
+        {
+            // an amdb proxy without batchSelect
+            responseJson["code"] = 1;
+        }
         else if (requestJson["op"].asString() == "commit")
         {
             size_t count = 0;
@@ -112,6 +124,16 @@ public:
 
         return response;
     }
+
+    void asyncPushChannelMessage(std::string, dev::channel::Message::Ptr message,
+        std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)> callback,
+        uint32_t timeout) override
+    {
+        auto request = std::make_shared<dev::channel::TopicChannelMessage>(message.get());
+        callback(dev::channel::ChannelException(), pushChannelMessage(request, timeout));
+    }
+
+    std::atomic<size_t> selects = {0};
 };
 
 struct SQLStorageFixture
@@ -119,8 +141,7 @@ struct SQLStorageFixture
     SQLStorageFixture()
     {
         sqlStorage = std::make_shared<dev::storage::SQLStorage>();
-        std::shared_ptr<MockChannelRPCServer> mockChannel =
-            std::make_shared<MockChannelRPCServer>();
+        mockChannel = std::make_shared<MockChannelRPCServer>();
         sqlStorage->setChannelRPCServer(mockChannel);
     }
     Entries::Ptr getEntries()
@@ -133,6 +154,7 @@ struct SQLStorageFixture
         return entries;
     }
     dev::storage::SQLStorage::Ptr sqlStorage;
+    std::shared_ptr<MockChannelRPCServer> mockChannel;
 };
 
 BOOST_FIXTURE_TEST_SUITE(SQLStorageTest, SQLStorageFixture)
@@ -201,6 +223,84 @@ BOOST_AUTO_TEST_CASE(commit)
     BOOST_CHECK_EQUAL(entries->size(), 1u);
 }
 
+BOOST_AUTO_TEST_CASE(pipelinedSelect)
+{
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "Name";
+    auto result = sqlStorage->batchSelect(h256(0x01), 1, tableInfo, {"LiSi", "ZhangSan"});
+    BOOST_CHECK_EQUAL(result.size(), 2u);
+    BOOST_CHECK_EQUAL(result[0]->size(), 1u);
+    BOOST_CHECK_EQUAL(result[1]->size(), 0u);
+    BOOST_CHECK_EQUAL(mockChannel->selects, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(coalescedSelect)
+{
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_slow";
+    tableInfo->key = "Name";
+    std::vector<std::thread> threads;
+    std::atomic<size_t> rows = {0};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]() {
+            rows += sqlStorage->select(h256(0x01), 1, tableInfo, "LiSi", nullptr)->size();
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    // the selects waiting for the first one share its response
+    BOOST_CHECK_EQUAL(rows, 4u);
+    BOOST_CHECK_EQUAL(mockChannel->selects, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(binaryColumns)
+{
+    dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->newEntries = getEntries();
+    Entry::Ptr entry = std::make_shared<Entry>();
+    entry->setField("Name", "WangWu");
+    entry->setField("age", "18");
+    entry->setID(2);
+    tableData->newEntries->addEntry(entry);
+
+    RLPStream stream;
+    SQLStorage::encodeColumns(stream, tableData);
+    auto data = stream.out();
+    RLP rlp(data);
+    BOOST_CHECK_EQUAL(rlp[0].toString(), "t_test");
+    BOOST_CHECK_EQUAL(rlp[1].itemCount(), 5u);
+
+    RLPStream resultStream(2);
+    resultStream.append(rlp[1]);
+    resultStream.append(rlp[2]);
+    auto result = resultStream.out();
+    auto entries = SQLStorage::decodeColumns(RLP(result));
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("Name"), "LiSi");
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("age"), "");
+    BOOST_CHECK_EQUAL(entries->get(1)->getField("age"), "18");
+    BOOST_CHECK_EQUAL(entries->get(1)->getID(), 2u);
+    BOOST_CHECK_EQUAL(entries->dirty(), false);
+
+    auto condition = std::make_shared<Condition>();
+    condition->EQ("id", "1");
+    condition->GE("age", "18");
+    auto bounds = SQLStorage::conditionBounds(condition);
+    BOOST_CHECK_EQUAL(bounds.size(), 2u);
+    for (auto& it : bounds)
+    {
+        BOOST_CHECK_EQUAL(it.second.size(), 1u);
+        BOOST_CHECK_EQUAL(it.second[0].first, it.first == "id" ? Condition::eq : Condition::ge);
+    }
+    BOOST_CHECK_EQUAL(SQLStorage::conditionBounds(Condition::Ptr()).size(), 0u);
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
 #if 0
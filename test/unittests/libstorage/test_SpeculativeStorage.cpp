@@ -0,0 +1,146 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file test_SpeculativeStorage.cpp
+ * @author: ancelmo
+ * @date 2019-10-15
+ */
+
+#include <libdevcore/FixedHash.h>
+#include <libstorage/SpeculativeStorage.h>
+#include <libstorage/Table.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_SpeculativeStorage
+{
+class MockStorage : public Storage
+{
+public:
+    Entries::Ptr select(h256, int64_t, TableInfo::Ptr, const std::string& key,
+        Condition::Ptr) override
+    {
+        // two rows of every key, the ids are unique in the table
+        auto entries = std::make_shared<Entries>();
+        for (uint64_t id = 1; id <= 2; ++id)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setID(key[0] * 10 + id);
+            entry->setField("Name", key);
+            entry->setField("value", "saved");
+            entries->addEntry(entry);
+        }
+        return entries;
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>& datas) override
+    {
+        committed += datas.size();
+        return datas.size();
+    }
+
+    bool onlyDirty() override { return false; }
+
+    size_t committed = 0;
+};
+
+struct SpeculativeStorageFixture
+{
+    SpeculativeStorageFixture()
+    {
+        backend = std::make_shared<MockStorage>();
+
+        tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = "t_test";
+        tableInfo->key = "Name";
+        tableInfo->fields.push_back("value");
+
+        // the parent updated the first row of key "a" and inserted a row of key "b"
+        auto parent = std::make_shared<TableData>();
+        parent->info = tableInfo;
+        auto updated = std::make_shared<Entry>();
+        updated->setID('a' * 10 + 1);
+        updated->setField("Name", "a");
+        updated->setField("value", "updated");
+        parent->dirtyEntries->addEntry(updated);
+        auto inserted = std::make_shared<Entry>();
+        inserted->setField("Name", "b");
+        inserted->setField("value", "inserted");
+        parent->newEntries->addEntry(inserted);
+
+        storage = std::make_shared<SpeculativeStorage>(
+            backend, std::vector<TableData::Ptr>{parent});
+    }
+
+    std::shared_ptr<MockStorage> backend;
+    SpeculativeStorage::Ptr storage;
+    TableInfo::Ptr tableInfo;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SpeculativeStorageTest, SpeculativeStorageFixture)
+
+BOOST_AUTO_TEST_CASE(selectUpdated)
+{
+    auto entries = storage->select(h256(), 1, tableInfo, "a");
+    BOOST_TEST(entries->size() == 2u);
+    BOOST_TEST(entries->get(0)->getField("value") == "updated");
+    BOOST_TEST(entries->get(1)->getField("value") == "saved");
+
+    // the condition is checked on the version of the parent
+    auto condition = std::make_shared<Condition>();
+    condition->EQ("value", "updated");
+    entries = storage->select(h256(), 1, tableInfo, "a", condition);
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getID() == 'a' * 10 + 1u);
+
+    auto batch = storage->batchSelect(h256(), 1, tableInfo, {"a", "c"});
+    BOOST_TEST(batch[0]->get(0)->getField("value") == "updated");
+    BOOST_TEST(batch[1]->get(0)->getField("value") == "saved");
+    BOOST_TEST(!storage->conflicted());
+}
+
+BOOST_AUTO_TEST_CASE(selectOtherTable)
+{
+    auto otherInfo = std::make_shared<TableInfo>();
+    otherInfo->name = "t_other";
+    otherInfo->key = "Name";
+    auto entries = storage->select(h256(), 1, otherInfo, "a");
+    BOOST_TEST(entries->size() == 2u);
+    BOOST_TEST(entries->get(0)->getField("value") == "saved");
+    BOOST_TEST(!storage->conflicted());
+}
+
+BOOST_AUTO_TEST_CASE(selectInserted)
+{
+    storage->select(h256(), 1, tableInfo, "b");
+    BOOST_TEST(storage->conflicted());
+}
+
+BOOST_AUTO_TEST_CASE(commit)
+{
+    auto data = std::make_shared<TableData>();
+    data->info = tableInfo;
+    BOOST_TEST(storage->commit(h256(), 2, {data}) == 1u);
+    BOOST_TEST(backend->committed == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_SpeculativeStorage
@@ -0,0 +1,202 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file test_StateDiff.cpp
+ * @author: ancelmo
+ * @date 2019-10-15
+ */
+
+#include <libconfig/GlobalConfigure.h>
+#include <libdevcore/FixedHash.h>
+#include <libstorage/Common.h>
+#include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/StateDiff.h>
+#include <libstorage/StorageException.h>
+#include <libstorage/Table.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_StateDiff
+{
+class MockStorage : public Storage
+{
+public:
+    Entries::Ptr select(h256, int64_t, TableInfo::Ptr, const std::string& _key,
+        Condition::Ptr) override
+    {
+        auto entries = std::make_shared<Entries>();
+        auto it = rows.find(_key);
+        if (it != rows.end())
+        {
+            entries->addEntry(it->second);
+        }
+        return entries;
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>& _datas) override
+    {
+        committed = _datas;
+        return _datas.size();
+    }
+
+    bool onlyDirty() override { return false; }
+
+    std::vector<TableData::Ptr> committed;
+    std::map<std::string, Entry::Ptr> rows;
+};
+
+struct StateDiffFixture
+{
+    StateDiffFixture()
+    {
+        version = g_BCOSConfig.version();
+        supportedVersion = g_BCOSConfig.supportedVersion();
+        g_BCOSConfig.setSupportedVersion("2.1.0", V2_1_0);
+
+        factory = std::make_shared<MemoryTableFactory2>();
+        factory->setStateStorage(std::make_shared<MockStorage>());
+    }
+    ~StateDiffFixture() { g_BCOSConfig.setSupportedVersion(supportedVersion, version); }
+
+    void insert(MemoryTableFactory2::Ptr _factory, std::string const& _table,
+        std::string const& _key, std::string const& _value)
+    {
+        auto table = _factory->openTable(_table, true, false);
+        auto entry = table->newEntry();
+        entry->setField("value", _value);
+        table->insert(_key, entry);
+    }
+
+    VERSION version;
+    std::string supportedVersion;
+    MemoryTableFactory2::Ptr factory;
+};
+
+BOOST_FIXTURE_TEST_SUITE(StateDiffTest, StateDiffFixture)
+
+BOOST_AUTO_TEST_CASE(dbHash)
+{
+    factory->createTable("t_test", "key", "value", true, Address(), false);
+    insert(factory, "t_test", "1", "v1");
+    insert(factory, "t_test", "2", "v2");
+    // opened but unchanged
+    factory->openTable(SYS_CONFIG);
+    // rolled back
+    auto savepoint = factory->savepoint();
+    insert(factory, "t_test", "3", "v3");
+    factory->rollback(savepoint);
+
+    StateDiff diff;
+    diff.blockHash = h256(0x1234);
+    diff.number = 2;
+    diff.datas = factory->dump(true);
+    BOOST_TEST(diff.datas.size() == 4u);
+
+    auto encoded = diff.encode();
+    StateDiff decoded;
+    decoded.decode(ref(encoded));
+    BOOST_TEST(decoded.blockHash == h256(0x1234));
+    BOOST_TEST(decoded.number == 2);
+    BOOST_TEST(decoded.datas.size() == 4u);
+    BOOST_TEST(decoded.dbHash() != h256());
+    BOOST_TEST(decoded.dbHash() == factory->hash());
+
+    // the unchanged tables are hashed too
+    auto opened = decoded.datas;
+    decoded.datas.erase(decoded.datas.begin());
+    BOOST_TEST(decoded.dbHash() != factory->hash());
+
+    decoded.datas = opened;
+    decoded.datas.back()->newEntries->get(0)->setField("value", "v4");
+    BOOST_TEST(decoded.dbHash() != factory->hash());
+
+    bytes garbage{1, 2, 3};
+    BOOST_CHECK_THROW(decoded.decode(ref(garbage)), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(applyDiff)
+{
+    insert(factory, SYS_CONFIG, "tx_count_limit", "1000");
+    factory->openTable(SYS_CNS);
+    StateDiff diff;
+    diff.datas = factory->dump(true);
+
+    // the block tables are written to the factory applying the diff
+    auto storage = std::make_shared<MockStorage>();
+    auto applying = std::make_shared<MemoryTableFactory2>();
+    applying->setStateStorage(storage);
+    applying->applyDiff(diff.datas);
+    insert(applying, SYS_CONFIG, "tx_gas_limit", "300000000");
+    insert(applying, SYS_CURRENT_STATE, "current_number", "2");
+    applying->commitDB(h256(0x1234), 2);
+
+    // in the order of the names, the tables unchanged aren't committed
+    BOOST_TEST(storage->committed.size() == 2u);
+    BOOST_TEST(storage->committed[0]->info->name == SYS_CONFIG);
+    BOOST_TEST(storage->committed[0]->newEntries->size() == 2u);
+    BOOST_TEST(storage->committed[1]->info->name == SYS_CURRENT_STATE);
+}
+
+BOOST_AUTO_TEST_CASE(tamperedIDs)
+{
+    auto storage = std::make_shared<MockStorage>();
+    for (auto key : {"tx_count_limit", "tx_gas_limit"})
+    {
+        auto row = std::make_shared<Entry>();
+        row->setField(SYS_KEY, key);
+        row->setID(key == std::string("tx_count_limit") ? 1 : 2);
+        storage->rows[key] = row;
+    }
+    auto diff = [](uint64_t _id, std::string const& _key) {
+        auto data = std::make_shared<TableData>();
+        data->info->name = SYS_CONFIG;
+        data->info->key = SYS_KEY;
+        auto entry = std::make_shared<Entry>();
+        entry->setField(SYS_KEY, _key);
+        entry->setField("value", "2000");
+        entry->setID(_id);
+        data->dirtyEntries->addEntry(entry);
+        entry = std::make_shared<Entry>();
+        entry->setField(SYS_KEY, "tx_count_limit");
+        entry->setField("value", "3000");
+        entry->setID(7);
+        data->newEntries->addEntry(entry);
+        return std::vector<TableData::Ptr>{data};
+    };
+
+    auto applying = std::make_shared<MemoryTableFactory2>();
+    applying->setStateStorage(storage);
+    auto datas = diff(1, "tx_count_limit");
+    applying->applyDiff(datas);
+    // numbered by the storage on commit
+    BOOST_TEST(datas[0]->newEntries->get(0)->getID() == 0u);
+
+    // an id not in the state, of a row of another key, missing or repeated
+    BOOST_CHECK_THROW(applying->applyDiff(diff(3, "tx_count_limit")), StorageException);
+    BOOST_CHECK_THROW(applying->applyDiff(diff(2, "tx_count_limit")), StorageException);
+    BOOST_CHECK_THROW(applying->applyDiff(diff(0, "tx_count_limit")), StorageException);
+    datas = diff(1, "tx_count_limit");
+    datas[0]->dirtyEntries->addEntry(datas[0]->dirtyEntries->get(0));
+    BOOST_CHECK_THROW(applying->applyDiff(datas), StorageException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_StateDiff
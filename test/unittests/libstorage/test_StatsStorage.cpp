@@ -0,0 +1,164 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file test_StatsStorage.cpp
+ * @author: ancelmo
+ * @date 2019-09-06
+ */
+
+#include <libdevcore/FixedHash.h>
+#include <libstorage/StatsStorage.h>
+#include <libstorage/Table.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_StatsStorage
+{
+class MockStorage : public Storage
+{
+public:
+    Entries::Ptr select(h256, int64_t, TableInfo::Ptr, const std::string& key,
+        Condition::Ptr) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        auto entries = std::make_shared<Entries>();
+        auto entry = std::make_shared<Entry>();
+        entry->setField("Name", key);
+        entry->setField("value", "1234567890");
+        entries->addEntry(entry);
+        return entries;
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>& datas) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        return datas.size();
+    }
+
+    bool onlyDirty() override { return false; }
+
+    int64_t delay = 0;
+};
+
+struct StatsStorageFixture
+{
+    StatsStorageFixture()
+    {
+        backend = std::make_shared<MockStorage>();
+        stats = std::make_shared<StatsStorage>();
+        stats->setBackend(backend);
+
+        tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = "t_test";
+        tableInfo->key = "Name";
+        tableInfo->fields.push_back("value");
+    }
+
+    std::shared_ptr<MockStorage> backend;
+    StatsStorage::Ptr stats;
+    TableInfo::Ptr tableInfo;
+};
+
+BOOST_FIXTURE_TEST_SUITE(StatsStorageTest, StatsStorageFixture)
+
+BOOST_AUTO_TEST_CASE(histogram)
+{
+    Histogram histogram;
+    BOOST_CHECK_EQUAL(histogram.percentile(0.5), 0u);
+
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        histogram.record(i);
+    }
+    histogram.record(1000000);
+
+    BOOST_CHECK_EQUAL(histogram.count(), 101u);
+    // 50 and 51 are in [32, 64)
+    BOOST_CHECK_EQUAL(histogram.percentile(0.5), 64u);
+    BOOST_CHECK_EQUAL(histogram.percentile(1), 1000000u);
+
+    auto value = histogram.toJson();
+    BOOST_CHECK_EQUAL(value["count"].asUInt64(), 101u);
+    BOOST_CHECK_EQUAL(value["max"].asUInt64(), 1000000u);
+    // 1000000 is in [2^19, 2^20)
+    BOOST_CHECK_EQUAL(value["buckets"].size(), 21u);
+    BOOST_CHECK_EQUAL(value["buckets"][0].asUInt64(), 0u);
+    BOOST_CHECK_EQUAL(value["buckets"][1].asUInt64(), 1u);
+    BOOST_CHECK_EQUAL(value["buckets"][7].asUInt64(), 37u);
+    BOOST_CHECK_EQUAL(value["buckets"][20].asUInt64(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(access)
+{
+    auto entries = stats->select(h256(), 1, tableInfo, "LiSi", nullptr);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    auto result = stats->batchSelect(h256(), 1, tableInfo, {"LiSi", "WangWu"});
+    BOOST_CHECK_EQUAL(result.size(), 2u);
+
+    auto data = std::make_shared<TableData>();
+    data->info = tableInfo;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->setField("Name", "LiSi");
+        entry->setField("value", std::to_string(i));
+        data->newEntries->addEntry(entry);
+    }
+    stats->commit(h256(), 1, std::vector<TableData::Ptr>{data});
+
+    BOOST_CHECK_EQUAL(stats->selectLatency()->count(), 1u);
+    BOOST_CHECK_EQUAL(stats->batchSelectLatency()->count(), 1u);
+    BOOST_CHECK_EQUAL(stats->commitLatency()->count(), 1u);
+    BOOST_CHECK_EQUAL(stats->commitRows()->percentile(1), 3u);
+
+    auto stat = stats->tableStat("t_test");
+    BOOST_CHECK_EQUAL(stat->selects, 3u);
+    BOOST_CHECK_EQUAL(stat->rowsRead, 3u);
+    BOOST_CHECK(stat->bytesRead > 0u);
+    BOOST_CHECK_EQUAL(stat->commits, 1u);
+    BOOST_CHECK_EQUAL(stat->rowsWritten, 3u);
+    BOOST_CHECK(stat->bytesWritten > 0u);
+
+    auto value = stats->statistics();
+    BOOST_CHECK_EQUAL(value["tables"]["t_test"]["rowsWritten"].asUInt64(), 3u);
+    BOOST_CHECK_EQUAL(value["bytesRead"].asUInt64(), stat->bytesRead);
+    BOOST_CHECK_EQUAL(value["slowOperations"].asUInt64(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(slowOperations)
+{
+    stats->setSlowThreshold(1);
+    stats->select(h256(), 1, tableInfo, "LiSi", nullptr);
+    BOOST_CHECK_EQUAL(stats->statistics()["slowOperations"].asUInt64(), 0u);
+
+    backend->delay = 2;
+    stats->select(h256(), 1, tableInfo, "LiSi", nullptr);
+    stats->commit(h256(), 1, std::vector<TableData::Ptr>());
+    BOOST_CHECK_EQUAL(stats->statistics()["slowOperations"].asUInt64(), 2u);
+
+    stats->setSlowThreshold(0);
+    stats->select(h256(), 1, tableInfo, "LiSi", nullptr);
+    BOOST_CHECK_EQUAL(stats->statistics()["slowOperations"].asUInt64(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_StatsStorage
@@ -0,0 +1,249 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief: unit test for StoragePruner
+ * @file: test_StoragePruner.cpp
+ */
+
+#include <libdevcore/FixedHash.h>
+#include <libstorage/Common.h>
+#include <libstorage/StoragePruner.h>
+#include <libstorage/Table.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_StoragePruner
+{
+// keys of each table in order, entries of a key are appended by commit unless forced
+class MockStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<MockStorage> Ptr;
+    typedef std::map<std::string, Entries::Ptr> Data;
+
+    class Iterator : public StorageIterator
+    {
+    public:
+        Iterator(Data::iterator begin, Data::iterator end) : m_it(begin), m_end(end) {}
+
+        bool next(Batch& batch) override
+        {
+            batch.clear();
+            for (; m_it != m_end; ++m_it)
+            {
+                batch.emplace_back(m_it->first, m_it->second);
+            }
+            return !batch.empty();
+        }
+
+    private:
+        Data::iterator m_it;
+        Data::iterator m_end;
+    };
+
+    Entries::Ptr select(
+        h256, int64_t, TableInfo::Ptr tableInfo, const std::string& key, Condition::Ptr) override
+    {
+        auto entries = std::make_shared<Entries>();
+        auto it = tables[tableInfo->name].find(key);
+        if (it != tables[tableInfo->name].end())
+        {
+            entries->shallowFrom(it->second);
+        }
+        return entries;
+    }
+
+    size_t commit(h256, int64_t num, const std::vector<TableData::Ptr>& datas) override
+    {
+        for (auto& data : datas)
+        {
+            auto& table = tables[data->info->name];
+            for (size_t i = 0; i < data->newEntries->size(); ++i)
+            {
+                auto entry = data->newEntries->get(i);
+                auto& keyEntries = table[entry->getField(data->info->key)];
+                if (!keyEntries || entry->force())
+                {
+                    keyEntries = std::make_shared<Entries>();
+                }
+                entry->setNum(num);
+                keyEntries->addEntry(entry);
+            }
+        }
+        return datas.size();
+    }
+
+    StorageIterator::Ptr scan(
+        TableInfo::Ptr tableInfo, const std::string& begin, const std::string& end, size_t) override
+    {
+        auto& table = tables[tableInfo->name];
+        return std::make_shared<Iterator>(
+            table.lower_bound(begin), end.empty() ? table.end() : table.lower_bound(end));
+    }
+
+    void remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys) override
+    {
+        for (auto& key : keys)
+        {
+            tables[tableInfo->name].erase(key);
+        }
+    }
+
+    bool prune(TableInfo::Ptr tableInfo, std::string& key, int64_t num, size_t maxKeys,
+        StorageIterator::Batch& pruned) override
+    {
+        auto& table = tables[tableInfo->name];
+        auto it = table.lower_bound(key);
+        for (size_t keys = 0; it != table.end() && keys < maxKeys; ++keys)
+        {
+            auto kept = std::make_shared<Entries>();
+            auto dropped = std::make_shared<Entries>();
+            for (size_t i = 0; i < it->second->size(); ++i)
+            {
+                auto entry = it->second->get(i);
+                auto deleted = entry->getStatus() == Entry::Status::DELETED;
+                (deleted && (int64_t)entry->num() < num ? dropped : kept)->addEntry(entry);
+            }
+            if (dropped->size() > 0)
+            {
+                pruned.emplace_back(it->first, dropped);
+            }
+            if (kept->size() == 0)
+            {
+                it = table.erase(it);
+                continue;
+            }
+            it->second = kept;
+            ++it;
+        }
+        key = it == table.end() ? "" : it->first;
+        return true;
+    }
+
+    bool onlyDirty() override { return false; }
+
+    std::map<std::string, Data> tables;
+};
+
+struct StoragePrunerFixture
+{
+    StoragePrunerFixture()
+    {
+        backend = std::make_shared<MockStorage>();
+        archive = std::make_shared<MockStorage>();
+        pruner = std::make_shared<StoragePruner>();
+        pruner->setBackend(backend);
+        pruner->setArchive(archive);
+    }
+
+    TableData::Ptr tableData(
+        const std::string& name, const std::string& key, const std::string& value)
+    {
+        auto data = std::make_shared<TableData>();
+        data->info->name = name;
+        data->info->key = name == SYS_CURRENT_STATE ? SYS_KEY : "key";
+        auto entry = std::make_shared<Entry>();
+        entry->setField(data->info->key, key);
+        entry->setField(SYS_VALUE, value);
+        data->newEntries->addEntry(entry);
+        return data;
+    }
+
+    void commitBlock(int64_t num)
+    {
+        auto hash = h256(num).hex();
+        auto number2Hash = tableData(SYS_NUMBER_2_HASH, std::to_string(num), hash);
+        number2Hash->info->key = "number";
+        number2Hash->newEntries->get(0)->setField("number", std::to_string(num));
+        auto hash2Block = tableData(SYS_HASH_2_BLOCK, hash, "block" + std::to_string(num));
+        hash2Block->info->key = "hash";
+        hash2Block->newEntries->get(0)->setField("hash", hash);
+        auto number = tableData(SYS_CURRENT_STATE, SYS_KEY_CURRENT_NUMBER, std::to_string(num));
+        number->newEntries->get(0)->setForce(true);
+        backend->commit(h256(num), num, {number2Hash, hash2Block, number});
+    }
+
+    MockStorage::Ptr backend;
+    MockStorage::Ptr archive;
+    StoragePruner::Ptr pruner;
+};
+
+BOOST_FIXTURE_TEST_SUITE(StoragePrunerTest, StoragePrunerFixture)
+
+BOOST_AUTO_TEST_CASE(pruneBlocks)
+{
+    for (int64_t num = 0; num <= 5; ++num)
+    {
+        commitBlock(num);
+    }
+    pruner->setRetainBlocks(2);
+
+    // the bodies of blocks 1 to 3 go to the archive, the genesis block stays
+    BOOST_CHECK_EQUAL(pruner->prune(100), 3u);
+    BOOST_CHECK_EQUAL(pruner->prunedBlock(), 3);
+    BOOST_CHECK_EQUAL(backend->tables[SYS_HASH_2_BLOCK].size(), 3u);
+    BOOST_CHECK_EQUAL(backend->tables[SYS_HASH_2_BLOCK].count(h256(0).hex()), 1u);
+    BOOST_CHECK_EQUAL(backend->tables[SYS_NUMBER_2_HASH].size(), 6u);
+    BOOST_CHECK_EQUAL(archive->tables[SYS_HASH_2_BLOCK].size(), 3u);
+    BOOST_CHECK_EQUAL(
+        archive->tables[SYS_HASH_2_BLOCK][h256(2).hex()]->get(0)->getField(SYS_VALUE), "block2");
+    BOOST_CHECK_EQUAL(pruner->prune(100), 0u);
+
+    // the progress is kept in the backend
+    commitBlock(6);
+    auto progress = backend->tables[StoragePruner::PRUNE_TABLE]["block"];
+    BOOST_CHECK_EQUAL(progress->size(), 1u);
+    BOOST_CHECK_EQUAL(progress->get(0)->getField(SYS_VALUE), "3");
+    BOOST_CHECK_EQUAL(pruner->prune(100), 1u);
+    BOOST_CHECK_EQUAL(backend->tables[SYS_HASH_2_BLOCK].count(h256(4).hex()), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(pruneState)
+{
+    commitBlock(5);
+    auto sysTable = tableData(SYS_TABLES, "t_test", "");
+    sysTable->info->key = "table_name";
+    sysTable->newEntries->get(0)->setField("table_name", "t_test");
+    sysTable->newEntries->get(0)->setField("key_field", "key");
+    backend->commit(h256(), 0, {sysTable});
+
+    auto state = tableData("t_test", "a", "1");
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "a");
+    entry->setStatus(Entry::Status::DELETED);
+    state->newEntries->addEntry(entry);
+    backend->commit(h256(), 1, {state});
+    state = tableData("t_test", "b", "2");
+    state->newEntries->get(0)->setStatus(Entry::Status::DELETED);
+    backend->commit(h256(), 4, {state});
+
+    // rows deleted before block 3 are dropped
+    pruner->setRetainStateBlocks(2);
+    pruner->prune(100);
+    auto& table = backend->tables["t_test"];
+    BOOST_CHECK_EQUAL(table["a"]->size(), 1u);
+    BOOST_CHECK_EQUAL(table["a"]->get(0)->getStatus(), (int)Entry::Status::NORMAL);
+    BOOST_CHECK_EQUAL(table["b"]->size(), 1u);
+    BOOST_CHECK_EQUAL(archive->tables["t_test"].size(), 1u);
+    BOOST_CHECK_EQUAL(archive->tables["t_test"]["a"]->get(0)->getStatus(),
+        (int)Entry::Status::DELETED);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_StoragePruner
@@ -0,0 +1,202 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file test_TieredStorage.cpp
+ * @author: ancelmo
+ * @date 2019-09-02
+ */
+
+#include <libdevcore/FixedHash.h>
+#include <libstorage/Common.h>
+#include <libstorage/StorageException.h>
+#include <libstorage/Table.h>
+#include <libstorage/TieredStorage.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_TieredStorage
+{
+// keys of each table in order, entries of a key are appended by commit
+class MockStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<MockStorage> Ptr;
+    typedef std::map<std::string, Entries::Ptr> Data;
+
+    class Iterator : public StorageIterator
+    {
+    public:
+        Iterator(Data::iterator begin, Data::iterator end) : m_it(begin), m_end(end) {}
+
+        bool next(Batch& batch) override
+        {
+            batch.clear();
+            for (; m_it != m_end; ++m_it)
+            {
+                batch.emplace_back(m_it->first, m_it->second);
+            }
+            return !batch.empty();
+        }
+
+    private:
+        Data::iterator m_it;
+        Data::iterator m_end;
+    };
+
+    Entries::Ptr select(
+        h256, int64_t, TableInfo::Ptr tableInfo, const std::string& key, Condition::Ptr) override
+    {
+        auto entries = std::make_shared<Entries>();
+        auto it = tables[tableInfo->name].find(key);
+        if (it != tables[tableInfo->name].end())
+        {
+            entries->shallowFrom(it->second);
+        }
+        return entries;
+    }
+
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>& datas) override
+    {
+        for (auto& data : datas)
+        {
+            auto& table = tables[data->info->name];
+            for (auto entries : {data->dirtyEntries, data->newEntries})
+            {
+                for (size_t i = 0; i < entries->size(); ++i)
+                {
+                    auto& keyEntries = table[entries->get(i)->getField(data->info->key)];
+                    if (!keyEntries)
+                    {
+                        keyEntries = std::make_shared<Entries>();
+                    }
+                    keyEntries->addEntry(entries->get(i));
+                }
+            }
+        }
+        return datas.size();
+    }
+
+    StorageIterator::Ptr scan(
+        TableInfo::Ptr tableInfo, const std::string& begin, const std::string& end, size_t) override
+    {
+        auto& table = tables[tableInfo->name];
+        return std::make_shared<Iterator>(
+            table.lower_bound(begin), end.empty() ? table.end() : table.lower_bound(end));
+    }
+
+    void remove(TableInfo::Ptr tableInfo, const std::vector<std::string>& keys) override
+    {
+        for (auto& key : keys)
+        {
+            tables[tableInfo->name].erase(key);
+        }
+    }
+
+    bool onlyDirty() override { return false; }
+
+    std::map<std::string, Data> tables;
+};
+
+struct TieredStorageFixture
+{
+    TieredStorageFixture()
+    {
+        hotStorage = std::make_shared<MockStorage>();
+        coldStorage = std::make_shared<MockStorage>();
+        tieredStorage = std::make_shared<TieredStorage>();
+        tieredStorage->setHotStorage(hotStorage);
+        tieredStorage->setColdStorage(coldStorage);
+        tieredStorage->setHotBlocks(1);
+    }
+
+    void commitBlock(int64_t num)
+    {
+        auto block = std::make_shared<TableData>();
+        block->info->name = SYS_HASH_2_BLOCK;
+        block->info->key = "hash";
+        auto entry = std::make_shared<Entry>();
+        entry->setField("hash", "block" + std::to_string(num));
+        entry->setField("value", std::to_string(num));
+        block->newEntries->addEntry(entry);
+
+        auto state = std::make_shared<TableData>();
+        state->info->name = "t_state";
+        state->info->key = "key";
+        entry = std::make_shared<Entry>();
+        entry->setField("key", "state" + std::to_string(num));
+        state->newEntries->addEntry(entry);
+
+        tieredStorage->commit(h256(num), num, {block, state});
+    }
+
+    TableInfo::Ptr blockTableInfo()
+    {
+        auto tableInfo = std::make_shared<TableInfo>();
+        tableInfo->name = SYS_HASH_2_BLOCK;
+        tableInfo->key = "hash";
+        return tableInfo;
+    }
+
+    MockStorage::Ptr hotStorage;
+    MockStorage::Ptr coldStorage;
+    TieredStorage::Ptr tieredStorage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TieredStorageTest, TieredStorageFixture)
+
+BOOST_AUTO_TEST_CASE(migrate)
+{
+    for (int64_t num = 1; num <= 3; ++num)
+    {
+        commitBlock(num);
+    }
+    BOOST_CHECK_EQUAL(hotStorage->tables[TieredStorage::MIGRATION_TABLE].size(), 3u);
+    BOOST_CHECK_EQUAL(hotStorage->tables[SYS_HASH_2_BLOCK].size(), 3u);
+
+    // blocks older than the latest one move
+    BOOST_CHECK_EQUAL(tieredStorage->migrate(), 2u);
+    BOOST_CHECK_EQUAL(tieredStorage->migrate(), 0u);
+    BOOST_CHECK_EQUAL(hotStorage->tables[TieredStorage::MIGRATION_TABLE].size(), 1u);
+    BOOST_CHECK_EQUAL(hotStorage->tables[SYS_HASH_2_BLOCK].size(), 1u);
+    BOOST_CHECK_EQUAL(coldStorage->tables[SYS_HASH_2_BLOCK].size(), 2u);
+    BOOST_CHECK_EQUAL(hotStorage->tables["t_state"].size(), 3u);
+    BOOST_CHECK_EQUAL(coldStorage->tables.count("t_state"), 0u);
+
+    // reads fall through to the cold backend
+    auto entries = tieredStorage->select(h256(), 0, blockTableInfo(), "block1", nullptr);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("value"), "1");
+
+    auto result = tieredStorage->batchSelect(
+        h256(), 0, blockTableInfo(), {"block1", "block3", "block4", "block2"});
+    BOOST_CHECK_EQUAL(result.size(), 4u);
+    BOOST_CHECK_EQUAL(result[0]->get(0)->getField("value"), "1");
+    BOOST_CHECK_EQUAL(result[1]->get(0)->getField("value"), "3");
+    BOOST_CHECK_EQUAL(result[2]->size(), 0u);
+    BOOST_CHECK_EQUAL(result[3]->get(0)->getField("value"), "2");
+
+    commitBlock(4);
+    BOOST_CHECK_EQUAL(tieredStorage->migrate(), 1u);
+    BOOST_CHECK_EQUAL(coldStorage->tables[SYS_HASH_2_BLOCK].size(), 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_TieredStorage
@@ -152,6 +152,58 @@ BOOST_AUTO_TEST_CASE(commit)
     BOOST_CHECK_EQUAL(c, 1u);
 }
 
+BOOST_AUTO_TEST_CASE(partitionTables)
+{
+    std::vector<dev::storage::TableData::Ptr> datas;
+    for (size_t rows : {5u, 1u, 3u, 2u})
+    {
+        dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+        tableData->info->name = "t_test" + std::to_string(rows);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            tableData->newEntries->addEntry(std::make_shared<Entry>());
+        }
+        datas.push_back(tableData);
+    }
+    dev::storage::TableData::Ptr currentState = std::make_shared<dev::storage::TableData>();
+    currentState->info->name = SYS_CURRENT_STATE;
+    currentState->dirtyEntries->addEntry(std::make_shared<Entry>());
+    datas.push_back(currentState);
+
+    std::vector<dev::storage::TableData::Ptr> markers;
+    auto groups = SQLBasicAccess::PartitionTables(datas, 2, markers);
+    BOOST_CHECK_EQUAL(markers.size(), 1u);
+    BOOST_CHECK_EQUAL(markers[0]->info->name, SYS_CURRENT_STATE);
+    BOOST_CHECK_EQUAL(groups.size(), 2u);
+    // 5 + 1 | 3 + 2
+    BOOST_CHECK_EQUAL(groups[0].size(), 2u);
+    BOOST_CHECK_EQUAL(groups[0][0]->info->name, "t_test5");
+    BOOST_CHECK_EQUAL(groups[0][1]->info->name, "t_test1");
+    BOOST_CHECK_EQUAL(groups[1].size(), 2u);
+
+    markers.clear();
+    groups = SQLBasicAccess::PartitionTables(datas, 8, markers);
+    BOOST_CHECK_EQUAL(groups.size(), 4u);
+
+    markers.clear();
+    groups = SQLBasicAccess::PartitionTables({currentState}, 2, markers);
+    BOOST_CHECK_EQUAL(groups.size(), 0u);
+    BOOST_CHECK_EQUAL(markers.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(commitXid)
+{
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXid("db", 12, 3), "X'6462',X'31322e33',1111707475");
+
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 0x42434F53, 2, "db12.3"), 12);
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 0x42434F53, 2, "db0.0"), 0);
+    // branches of other databases and of other applications are left alone
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 0x42434F53, 3, "db212.3"), -1);
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 0x42434F53, 2, "dc12.3"), -1);
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 1, 2, "db12.3"), -1);
+    BOOST_CHECK_EQUAL(SQLBasicAccess::CommitXidNum("db", 0x42434F53, 2, "dbx.3"), -1);
+}
+
 BOOST_AUTO_TEST_CASE(exception) {}
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,87 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ *
+/**
+ * @brief
+ *
+ * @file CodeCacheTest.cpp
+ * @author: ancelmo
+ * @date 2019-10-15
+ */
+
+#include <libstoragestate/CodeCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storagestate;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(CodeCacheTest, TestOutputHelperFixture)
+
+static CodeCache::Code newCode(size_t _size)
+{
+    return make_shared<bytes const>(_size, 0x60);
+}
+
+BOOST_AUTO_TEST_CASE(getAndStore)
+{
+    CodeCache cache(16 * 1024);
+    h256 hash(1);
+    BOOST_CHECK(cache.get(hash) == nullptr);
+
+    auto code = newCode(100);
+    cache.store(hash, code);
+    BOOST_CHECK(cache.get(hash) == code);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+
+    // the code of a hash never changes, the first one is kept
+    cache.store(hash, newCode(100));
+    BOOST_CHECK(cache.get(hash) == code);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(evictLeastRecentlyUsed)
+{
+    // the hashes below share a shard, which holds 300 bytes
+    CodeCache cache(16 * 300);
+    cache.store(h256(1), newCode(100));
+    cache.store(h256(2), newCode(100));
+    cache.store(h256(3), newCode(100));
+
+    // 1 becomes the most recently used, 2 is evicted
+    BOOST_CHECK(cache.get(h256(1)) != nullptr);
+    cache.store(h256(4), newCode(100));
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK(cache.get(h256(1)) != nullptr);
+    BOOST_CHECK(cache.get(h256(2)) == nullptr);
+    BOOST_CHECK(cache.get(h256(3)) != nullptr);
+    BOOST_CHECK(cache.get(h256(4)) != nullptr);
+
+    // a code larger than the shard is still kept alone
+    cache.store(h256(5), newCode(1000));
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(cache.get(h256(5)) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
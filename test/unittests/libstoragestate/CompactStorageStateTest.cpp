@@ -0,0 +1,127 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+/**
+ * @brief
+ *
+ * @file CompactStorageStateTest.cpp
+ * @author: ancelmo
+ * @date 2019-09-19
+ */
+
+#include "libstoragestate/CompactStorageState.h"
+#include "../libstorage/MemoryStorage.h"
+#include "libdevcrypto/Hash.h"
+#include "libethcore/Exceptions.h"
+#include "libstorage/MemoryTableFactory2.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storagestate;
+
+namespace test_CompactStorageState
+{
+struct CompactStorageStateFixture
+{
+    CompactStorageStateFixture() : m_state(dev::u256(0))
+    {
+        auto storage = std::make_shared<dev::storage::MemoryStorage>();
+        m_tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
+        m_tableFactory->setStateStorage(storage);
+        m_state.setMemoryTableFactory(m_tableFactory);
+    }
+
+    std::string tableValue(Address const& _address, std::string const& _key)
+    {
+        auto table = m_tableFactory->openTable("_contract_data_" + _address.hex() + "_");
+        auto entries = table->select(_key, table->newCondition());
+        return entries->size() == 0u ? std::string() : entries->get(0)->getField(STORAGE_VALUE);
+    }
+
+    std::shared_ptr<dev::storage::MemoryTableFactory2> m_tableFactory;
+    CompactStorageState m_state;
+};
+
+BOOST_FIXTURE_TEST_SUITE(CompactStorageState, CompactStorageStateFixture)
+
+BOOST_AUTO_TEST_CASE(AccountHeaderCodec)
+{
+    AccountHeader header;
+    header.nonce = u256(7);
+    header.balance = u256("0x1234567890abcdef1234567890abcdef");
+    header.codeHash = sha3("code");
+    header.alive = false;
+    auto value = header.encode();
+    BOOST_TEST(value.size() == 2 * (3 * 32 + 1));
+
+    auto decoded = AccountHeader::decode(value);
+    BOOST_TEST(decoded.nonce == header.nonce);
+    BOOST_TEST(decoded.balance == header.balance);
+    BOOST_TEST(decoded.codeHash == header.codeHash);
+    BOOST_TEST(decoded.alive == false);
+    BOOST_CHECK_THROW(AccountHeader::decode("00"), dev::storage::StorageException);
+}
+
+BOOST_AUTO_TEST_CASE(Account)
+{
+    Address addr1(0x100001);
+    BOOST_TEST(m_state.accountNonemptyAndExisting(addr1) == false);
+    m_state.addBalance(addr1, u256(10));
+    m_state.subBalance(addr1, u256(3));
+    BOOST_TEST(m_state.balance(addr1) == u256(7));
+    BOOST_CHECK_THROW(m_state.subBalance(addr1, u256(8)), dev::eth::NotEnoughCash);
+    m_state.incNonce(addr1);
+    m_state.incNonce(addr1);
+    BOOST_TEST(m_state.getNonce(addr1) == u256(2));
+    BOOST_TEST(m_state.accountNonemptyAndExisting(addr1) == true);
+    BOOST_TEST(tableValue(addr1, ACCOUNT_BALANCE) == "");
+
+    auto header = AccountHeader::decode(tableValue(addr1, ACCOUNT_HEADER));
+    BOOST_TEST(header.balance == u256(7));
+    BOOST_TEST(header.nonce == u256(2));
+
+    std::string codeString("aaaaaaaaaaaaa");
+    bytes code(codeString.begin(), codeString.end());
+    BOOST_TEST(m_state.addressHasCode(addr1) == false);
+    m_state.setCode(addr1, bytes(code));
+    BOOST_TEST(m_state.addressHasCode(addr1) == true);
+    BOOST_TEST(m_state.code(addr1) == code);
+    BOOST_TEST(m_state.codeHash(addr1) == sha3(code));
+
+    m_state.kill(addr1);
+    BOOST_TEST(m_state.balance(addr1) == u256(0));
+    BOOST_TEST(m_state.codeHash(addr1) == EmptySHA3);
+    BOOST_TEST(AccountHeader::decode(tableValue(addr1, ACCOUNT_HEADER)).alive == false);
+}
+
+BOOST_AUTO_TEST_CASE(Storage)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    auto savepoint = m_state.savepoint();
+    m_state.setStorage(addr1, u256(123), u256(456));
+    BOOST_TEST(m_state.storage(addr1, u256(123)) == u256(456));
+    m_state.flush();
+    BOOST_TEST(tableValue(addr1, toHex(h256(u256(123)))) == toHex(h256(u256(456))));
+
+    m_state.rollback(savepoint);
+    BOOST_TEST(m_state.storage(addr1, u256(123)) == u256(0));
+    BOOST_TEST(m_state.balance(addr1) == u256(10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_CompactStorageState
@@ -36,11 +36,12 @@ struct StorageStateFixture
     StorageStateFixture() : m_state(dev::u256(0))
     {
         auto storage = std::make_shared<dev::storage::MemoryStorage>();
-        auto tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
-        tableFactory->setStateStorage(storage);
-        m_state.setMemoryTableFactory(tableFactory);
+        m_tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
+        m_tableFactory->setStateStorage(storage);
+        m_state.setMemoryTableFactory(m_tableFactory);
     }
 
+    std::shared_ptr<dev::storage::MemoryTableFactory2> m_tableFactory;
     dev::storagestate::StorageState m_state;
 };
 
@@ -105,6 +106,44 @@ BOOST_AUTO_TEST_CASE(Storage)
     m_state.clearStorage(addr1);
 }
 
+BOOST_AUTO_TEST_CASE(CachedStorage)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    auto table = m_tableFactory->openTable("_contract_data_" + addr1.hex() + "_");
+    auto tableValue = [&](u256 const& _location) {
+        auto entries = table->select(_location.str(), table->newCondition());
+        return entries->size() == 0u ? std::string() :
+                                       entries->get(0)->getField(storagestate::STORAGE_VALUE);
+    };
+
+    // the writes reach the table at the savepoint
+    m_state.setStorage(addr1, u256(1), u256(100));
+    m_state.setStorage(addr1, u256(1), u256(101));
+    BOOST_TEST(tableValue(u256(1)) == "");
+    auto savepoint = m_state.savepoint();
+    BOOST_TEST(tableValue(u256(1)) == "101");
+
+    m_state.setStorage(addr1, u256(1), u256(102));
+    m_state.setStorage(addr1, u256(2), u256(200));
+    BOOST_TEST(m_state.storage(addr1, u256(1)) == u256(102));
+    BOOST_TEST(m_state.storage(addr1, u256(2)) == u256(200));
+    m_state.rollback(savepoint);
+    BOOST_TEST(m_state.storage(addr1, u256(1)) == u256(101));
+    BOOST_TEST(m_state.storage(addr1, u256(2)) == u256(0));
+
+    m_state.setStorage(addr1, u256(2), u256(201));
+    m_state.flush();
+    BOOST_TEST(tableValue(u256(2)) == "201");
+    BOOST_TEST(m_state.storage(addr1, u256(2)) == u256(201));
+
+    // a contract without table has no storage
+    Address addr2(0x100002);
+    m_state.setStorage(addr2, u256(1), u256(100));
+    BOOST_TEST(m_state.storage(addr2, u256(1)) == u256(0));
+    m_state.commit();
+}
+
 BOOST_AUTO_TEST_CASE(Code)
 {
     Address addr1(0x100001);
@@ -128,6 +167,11 @@ BOOST_AUTO_TEST_CASE(Code)
     BOOST_TEST(code.size() == size);
     hasCode = m_state.addressHasCode(addr1);
     BOOST_TEST(hasCode == true);
+    // decoded once and shared by the readers of the same code
+    auto shared = m_state.sharedCode(addr1);
+    BOOST_TEST(*shared == code);
+    BOOST_TEST(m_state.sharedCode(addr1) == shared);
+    BOOST_TEST(m_state.sharedCode(Address(0x100002))->empty());
 }
 
 BOOST_AUTO_TEST_CASE(Nonce)
@@ -0,0 +1,97 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : unit test for the cache of the served blocks
+ * @file: BlockRLPCacheTest.cpp
+ */
+
+#include <libsync/BlockRLPCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(BlockRLPCacheTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(EvictTest)
+{
+    BlockRLPCache cache(300);
+    std::atomic<size_t> reads(0);
+    auto loader = [&]() {
+        ++reads;
+        return make_shared<bytes>(100, 1);
+    };
+    for (int64_t number = 1; number <= 3; ++number)
+    {
+        BOOST_CHECK(cache.get(1, number, loader)->size() == 100);
+    }
+    // the same number of another group is another block
+    BOOST_CHECK(cache.get(2, 1, loader));
+    BOOST_CHECK_EQUAL(reads, 4);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK_EQUAL(cache.byteSize(), 300);
+
+    // block 1 of group 1 is evicted first
+    cache.get(1, 2, loader);
+    cache.get(1, 1, loader);
+    BOOST_CHECK_EQUAL(reads, 5);
+    BOOST_CHECK_EQUAL(cache.hits(), 1);
+    BOOST_CHECK_EQUAL(cache.misses(), 5);
+
+    // the missing blocks aren't cached
+    BOOST_CHECK(!cache.get(1, 100, []() { return shared_ptr<bytes>(); }));
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(CoalesceTest)
+{
+    BlockRLPCache cache;
+    std::atomic<size_t> reads(0);
+    auto loader = [&]() {
+        ++reads;
+        this_thread::sleep_for(chrono::milliseconds(100));
+        return make_shared<bytes>(10, 1);
+    };
+    vector<thread> peers;
+    vector<shared_ptr<bytes>> blocks(4);
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        peers.emplace_back([&, i]() { blocks[i] = cache.get(1, 1, loader); });
+    }
+    for (auto& peer : peers)
+    {
+        peer.join();
+    }
+    BOOST_CHECK_EQUAL(reads, 1);
+    for (auto const& block : blocks)
+    {
+        BOOST_CHECK(block && block == blocks[0]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -116,6 +116,65 @@ BOOST_AUTO_TEST_CASE(AllTest)
         fakeQueue.size() == c_maxDownloadingBlockQueueSize + c_maxDownloadingBlockQueueBufferSize);
 }
 
+BOOST_AUTO_TEST_CASE(CheapDecodeTest)
+{
+    DownloadingBlockQueue fakeQueue;
+    Secret sec = KeyPair::create().secret();
+    FakeBlock validBlock(3, sec, 1);
+    FakeBlock invalidBlock(3, sec, 2);
+    invalidBlock.fakeInvalidSignature(1);
+    fakeQueue.push(vector<bytes>{validBlock.getBlockData(), invalidBlock.getBlockData()});
+    fakeQueue.flushBufferToQueue();
+
+    // the signatures are checked by the batch recovery before execution, not by the decoding
+    BOOST_CHECK(fakeQueue.size() == 2);
+    auto block = fakeQueue.top();
+    BOOST_CHECK(block->header().number() == 1);
+    block->recoverSenders();
+    for (auto const& tx : block->transactions())
+    {
+        BOOST_CHECK(tx.sender() == toAddress(toPublic(sec)));
+    }
+    fakeQueue.pop();
+    block = fakeQueue.top();
+    BOOST_CHECK(block->header().number() == 2);
+    BOOST_CHECK_THROW(block->recoverSenders(), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(BytesTest)
+{
+    DownloadingBlockQueue fakeQueue;
+    auto pushFunc = [&fakeQueue](int start, int end) {
+        vector<shared_ptr<Block>> blocks;
+        for (auto i = start; i < end; ++i)
+        {
+            FakeBlock fakeBlock;
+            fakeBlock.getBlock().header().setNumber(static_cast<int64_t>(i));
+            blocks.emplace_back(make_shared<Block>(fakeBlock.getBlock()));
+        }
+        fakeQueue.push(blocks);
+    };
+
+    pushFunc(0, 2);
+    size_t shardBytes = fakeQueue.byteSize();
+    BOOST_CHECK(shardBytes > 0);
+    fakeQueue.flushBufferToQueue();
+    BOOST_CHECK(fakeQueue.size() == 2);
+    BOOST_CHECK(fakeQueue.byteSize() > 0 && fakeQueue.byteSize() < shardBytes);
+    fakeQueue.pop();
+    fakeQueue.pop();
+    BOOST_CHECK(fakeQueue.byteSize() == 0);
+
+    // the shards are not decoded once the queued blocks reach the bytes of the queue
+    fakeQueue.setMaxBytes(1);
+    pushFunc(0, 2);
+    pushFunc(2, 4);
+    fakeQueue.flushBufferToQueue();
+    BOOST_CHECK(fakeQueue.size() == 2);
+    fakeQueue.clear();
+    BOOST_CHECK(fakeQueue.byteSize() == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
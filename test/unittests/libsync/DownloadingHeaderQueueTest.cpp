@@ -0,0 +1,144 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : unit test for the headers of header-first downloading
+ * @file: DownloadingHeaderQueueTest.cpp
+ */
+
+#include <libsync/DownloadingHeaderQueue.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <test/unittests/libethcore/FakeBlock.h>
+#include <test/unittests/libtxpool/FakeBlockChain.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::sync;
+using namespace dev::test;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(DownloadingHeaderQueueTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(HeadersAndBodiesTest)
+{
+    // the chain holds the genesis block, the blocks 1 to 5 are downloaded
+    auto blockChain = make_shared<FakeBlockChain>(1);
+    vector<Block> blocks;
+    h256 parentHash = blockChain->numberHash(0);
+    for (int64_t i = 1; i <= 5; ++i)
+    {
+        FakeBlock fakeBlock(2, KeyPair::create().secret(), i);
+        Block block = fakeBlock.getBlock();
+        block.header().setNumber(i);
+        block.header().setParentHash(parentHash);
+        block.calTransactionRoot(true);
+        parentHash = block.header().hash();
+        blocks.push_back(block);
+    }
+    RLPStream headers;
+    headers.appendList(blocks.size());
+    for (auto const& block : blocks)
+    {
+        bytes header;
+        block.blockHeader().encode(header);
+        headers.appendList(2).appendRaw(header).appendVector(block.sigList());
+    }
+    bytes headersRLP = headers.out();
+
+    // headers not signed by the sealers aren't appended
+    DownloadingHeaderQueue unsignedQueue(blockChain, [](Block const&) { return false; }, NodeID());
+    BOOST_CHECK_EQUAL(unsignedQueue.onHeaders(NodeID(), RLP(headersRLP)), 0);
+    BOOST_CHECK_EQUAL(unsignedQueue.size(), 0);
+
+    DownloadingHeaderQueue queue(blockChain, [](Block const&) { return true; }, NodeID());
+    int64_t from = 0;
+    unsigned size = 0;
+    BOOST_CHECK(queue.nextHeaders(5, 1000, from, size));
+    BOOST_CHECK_EQUAL(from, 1);
+    BOOST_CHECK_EQUAL(size, 5);
+    // in flight until the headers are received or the request times out
+    BOOST_CHECK(!queue.nextHeaders(5, 1000, from, size));
+    BOOST_CHECK(queue.nextHeaders(5, 1000 + c_headerFirstRequestTimeout, from, size));
+
+    BOOST_CHECK_EQUAL(queue.onHeaders(NodeID(), RLP(headersRLP)), 5);
+    BOOST_CHECK_EQUAL(queue.tip(), 5);
+    BOOST_CHECK_EQUAL(queue.size(), 5);
+    // the headers not linked to the tip are dropped
+    BOOST_CHECK_EQUAL(queue.onHeaders(NodeID(), RLP(headersRLP)), 0);
+    BOOST_CHECK(!queue.nextHeaders(5, 10000, from, size));
+
+    int64_t to = 0;
+    BOOST_CHECK(queue.nextBodies(5, 3, 1000, from, to));
+    BOOST_CHECK_EQUAL(from, 1);
+    BOOST_CHECK_EQUAL(to, 3);
+    BOOST_CHECK(queue.nextBodies(4, 10, 1000, from, to));
+    BOOST_CHECK_EQUAL(from, 4);
+    BOOST_CHECK_EQUAL(to, 4);
+    BOOST_CHECK_EQUAL(queue.requesting(), 4);
+
+    // the body of block 2 doesn't match its transactionsRoot
+    RLPStream bodies;
+    bodies.appendList(3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        bodies.appendList(2) << blocks[i].header().number();
+        if (i == 1)
+        {
+            bodies << bytes();
+        }
+        else
+        {
+            bytes blockRLP = blocks[i].rlp();
+            bodies.appendRaw(RLP(blockRLP)[1].data());
+        }
+    }
+    bytes bodiesRLP = bodies.out();
+    vector<bytes> blockRLPs;
+    BOOST_CHECK_EQUAL(queue.onBodies(RLP(bodiesRLP), blockRLPs), 1);
+    BOOST_CHECK_EQUAL(blockRLPs.size(), 2);
+    BOOST_CHECK_EQUAL(queue.requesting(), 1);
+    Block block(blockRLPs[1], CheckTransaction::None, false);
+    BOOST_CHECK(block.header().hash() == blocks[2].header().hash());
+    BOOST_CHECK_EQUAL(block.transactions().size(), 2);
+    BOOST_CHECK(block.sigList() == blocks[2].sigList());
+
+    // the mismatched body and the body not requested yet are requested next
+    BOOST_CHECK(queue.nextBodies(5, 10, 1000, from, to));
+    BOOST_CHECK_EQUAL(from, 2);
+    BOOST_CHECK_EQUAL(to, 2);
+    BOOST_CHECK(queue.nextBodies(5, 10, 1000, from, to));
+    BOOST_CHECK_EQUAL(from, 5);
+    BOOST_CHECK_EQUAL(to, 5);
+    // the received bodies are requested again if their blocks are dropped
+    queue.resetBodies(1, 1);
+    BOOST_CHECK(queue.nextBodies(5, 10, 1000, from, to));
+    BOOST_CHECK_EQUAL(from, 1);
+    BOOST_CHECK_EQUAL(to, 1);
+
+    queue.clear();
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+    BOOST_CHECK_EQUAL(queue.tip(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -50,6 +50,7 @@ public:
             std::shared_ptr<dev::network::SessionFace>, dev::network::Message::Ptr)>) override
     {}
     bool actived() const override { return true; }
+    size_t writeQueueBytes() const override { return 0; }
 
     virtual std::shared_ptr<dev::network::SocketFace> socket() override
     {
@@ -0,0 +1,100 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : unit test for the encoding of the state snapshot
+ * @file: StateSnapshotTest.cpp
+ */
+
+#include <libdevcrypto/Hash.h>
+#include <libsync/StateSnapshot.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+using namespace dev::storage;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(StateSnapshotTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(ManifestTest)
+{
+    SnapshotManifest manifest;
+    manifest.number = 1000;
+    manifest.blockHash = sha3("block");
+    for (size_t i = 0; i < 3; ++i)
+    {
+        SnapshotChunk chunk;
+        chunk.table = "t_test" + to_string(i);
+        chunk.keyField = "name";
+        chunk.hash = sha3(to_string(i));
+        chunk.size = 1024 * i;
+        manifest.chunks.push_back(chunk);
+    }
+
+    SnapshotManifest decoded;
+    decoded.decode(RLP(manifest.encode()));
+    BOOST_CHECK_EQUAL(decoded.number, 1000);
+    BOOST_CHECK(decoded.blockHash == manifest.blockHash);
+    BOOST_CHECK_EQUAL(decoded.chunks.size(), 3);
+    BOOST_CHECK_EQUAL(decoded.chunks[2].table, "t_test2");
+    BOOST_CHECK(decoded.chunks[1].hash == sha3("1"));
+    BOOST_CHECK_EQUAL(decoded.chunks[2].size, 2048);
+    BOOST_CHECK(decoded.hash() == manifest.hash());
+}
+
+BOOST_AUTO_TEST_CASE(RowsTest)
+{
+    StorageIterator::Batch rows;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto entries = make_shared<Entries>();
+        for (size_t j = 0; j <= i; ++j)
+        {
+            auto entry = make_shared<Entry>();
+            entry->setField("name", "key" + to_string(i));
+            entry->setField("value", "value" + to_string(j));
+            entry->setID(100 + j);
+            entry->setNum(10 + j);
+            entries->addEntry(entry);
+        }
+        rows.emplace_back("key" + to_string(i), entries);
+    }
+
+    auto data = encodeSnapshotRows(rows);
+    auto decoded = decodeSnapshotRows(ref(data));
+    BOOST_CHECK_EQUAL(decoded.size(), 2);
+    BOOST_CHECK_EQUAL(decoded[1].first, "key1");
+    BOOST_CHECK_EQUAL(decoded[1].second->size(), 2);
+    auto entry = decoded[1].second->get(1);
+    BOOST_CHECK_EQUAL(entry->getField("name"), "key1");
+    BOOST_CHECK_EQUAL(entry->getField("value"), "value1");
+    BOOST_CHECK_EQUAL(entry->getID(), 101);
+    BOOST_CHECK_EQUAL(entry->num(), 11);
+    BOOST_CHECK_EQUAL(entry->getStatus(), 0);
+    /// the same rows are encoded to the same bytes on every node
+    BOOST_CHECK(encodeSnapshotRows(decoded) == data);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -218,6 +218,42 @@ BOOST_AUTO_TEST_CASE(MaintainTransactionsTest)
 
     BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 2);
     BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 3);
+
+    // test transaction requested by peer
+    sync->syncStatus()->peerStatus(NodeID(101))->txsRequests.push(h256s{(*txs)[0].sha3()});
+    sync->maintainTransactions();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 3);
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 3);
+    BOOST_CHECK_EQUAL(sync->syncStatus()->peerStatus(NodeID(101))->txsRequests.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MaintainDownloadingTransactionsTest)
+{
+    int64_t currentBlockNumber = 4;
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(currentBlockNumber + 1, 5, NodeID(100));
+    std::shared_ptr<TxPoolInterface> txPool = syncTools.txPool;
+    std::shared_ptr<DownloadingTxsQueue> txQueue = syncTools.txQueue;
+    size_t pendingSize = txPool->pendingSize();
+
+    // the shards of two peers are decoded in parallel and imported in one batch
+    for (size_t i = 0; i < 2; ++i)
+    {
+        shared_ptr<Transactions> txs = fakeTransactions(3, currentBlockNumber);
+        std::vector<bytes> txRLPs;
+        for (auto& tx : *txs)
+            txRLPs.emplace_back(tx.rlp(WithSignature));
+        SyncTransactionsPacket packet;
+        packet.encode(txRLPs);
+        auto msg = packet.toMessage(c_protocolId);
+        bytesConstRef frame = ref(*msg->buffer());
+        txQueue->push(RLP(frame.cropped(1)).data(), NodeID(101 + i));
+    }
+    BOOST_CHECK_EQUAL(txQueue->bufferSize(), 2);
+
+    txQueue->pop2TxPool(txPool);
+    BOOST_CHECK_EQUAL(txQueue->bufferSize(), 0);
+    BOOST_CHECK_EQUAL(txQueue->drainedTxs(), 6);
+    BOOST_CHECK_EQUAL(txPool->pendingSize(), pendingSize + 6);
 }
 
 BOOST_AUTO_TEST_CASE(MaintainBlocksTest)
@@ -236,6 +272,12 @@ BOOST_AUTO_TEST_CASE(MaintainBlocksTest)
     cout << "Msg number: " << service->getAsyncSendSizeByNodeID(NodeID(101)) << endl;
 
     BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 1);
+
+    // the unchanged status isn't announced again on the notifications
+    sync->noteNewBlocks();
+    sync->noteSealingBlockNumber(currentBlockNumber + 1);
+    sync->maintainBlocks();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 1);
 }
 
 BOOST_AUTO_TEST_CASE(MaintainPeersStatusTest)
@@ -111,6 +111,8 @@ public:
     };
 
     bool isConnected(NodeID const&) const override { return true; };
+    size_t writeQueueBytes(NodeID const&) const override { return 0; };
+    TrafficStats trafficStats() override { return TrafficStats(); };
 
     std::vector<std::string> topics() override { return std::vector<std::string>(); };
 
@@ -127,6 +127,9 @@ BOOST_AUTO_TEST_CASE(PacketDecodeTest)
     fakeMessagePtr->setBuffer(bufferPtr);
     isSuccessful = msgPacket.decode(fakeSessionPtr, fakeMessagePtr);
     BOOST_CHECK(isSuccessful == true);
+    // the decoded rlp points into the message
+    BOOST_CHECK(msgPacket.buffer() == bufferPtr);
+    BOOST_CHECK(msgPacket.rlp().data().data() == bufferPtr->data() + 1);
 }
 
 BOOST_AUTO_TEST_CASE(SyncStatusPacketTest)
@@ -149,6 +152,8 @@ BOOST_AUTO_TEST_CASE(SyncTransactionsPacketTest)
 
     txPacket.encode(txRLPs);
     auto msgPtr = txPacket.toMessage(0x02);
+    // the transactions are written after the blocks
+    BOOST_CHECK(msgPtr->priority() == dev::network::GossipPriority);
     txPacket.decode(fakeSessionPtr, msgPtr);
 
     auto rlpTx = txPacket.rlp()[0];
@@ -166,6 +171,7 @@ BOOST_AUTO_TEST_CASE(SyncBlocksPacketTest)
     blockRLPs.push_back(fakeBlock.getBlock().rlp());
     blocksPacket.encode(blockRLPs);
     auto msgPtr = blocksPacket.toMessage(0x03);
+    BOOST_CHECK(msgPtr->priority() == dev::network::SyncPriority);
     blocksPacket.decode(fakeSessionPtr, msgPtr);
     RLP const& rlps = blocksPacket.rlp();
     Block block(rlps[0].toBytes());
@@ -184,6 +190,23 @@ BOOST_AUTO_TEST_CASE(SyncReqBlockPacketTest)
     BOOST_CHECK(rlpReqBlock[1].toInt<unsigned>() == 0x40);
 }
 
+BOOST_AUTO_TEST_CASE(SyncTxsAnnouncePacketTest)
+{
+    h256s txHashes{sha3("tx0"), sha3("tx1")};
+    SyncTxsAnnouncePacket announcePacket;
+    announcePacket.encode(txHashes);
+    auto msgPtr = announcePacket.toMessage(0x03);
+    announcePacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(announcePacket.rlp()[0].toVector<h256>() == txHashes);
+
+    SyncReqTxsPacket reqTxsPacket;
+    reqTxsPacket.encode(txHashes);
+    msgPtr = reqTxsPacket.toMessage(0x03);
+    reqTxsPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(reqTxsPacket.packetType == ReqTxsPacket);
+    BOOST_CHECK(reqTxsPacket.rlp()[0].toVector<h256>() == txHashes);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
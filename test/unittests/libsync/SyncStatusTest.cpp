@@ -182,6 +182,58 @@ BOOST_AUTO_TEST_CASE(RandomSelectionSizeTest)
     BOOST_CHECK_EQUAL(peersSet.size(), 3);
 }
 
+BOOST_AUTO_TEST_CASE(PeerDownloadStatusTest)
+{
+    PeerDownloadStatus download;
+    BOOST_CHECK(!download.busy());
+    BOOST_CHECK_EQUAL(download.requestWindow(), c_maxRequestBlocks);
+
+    // 100 blocks in 500ms
+    download.onRequest(1, 60, 1000);
+    download.onRequest(61, 100, 1000);
+    BOOST_CHECK(download.busy());
+    int64_t rangeEnd = 0;
+    BOOST_CHECK(download.requesting(70, rangeEnd));
+    BOOST_CHECK_EQUAL(rangeEnd, 100);
+    BOOST_CHECK(!download.requesting(101, rangeEnd));
+    download.onBlocks(50, 1100);
+    BOOST_CHECK(download.busy());
+    download.onBlocks(50, 1500);
+    BOOST_CHECK(!download.busy());
+    BOOST_CHECK_EQUAL(download.rtt(), 100);
+    BOOST_CHECK_EQUAL(download.throughput(), 200);
+    BOOST_CHECK_EQUAL(download.requestWindow(), 200);
+
+    // no block in the stall timeout
+    download.onRequest(101, 300, 2000);
+    BOOST_CHECK(!download.checkStall(2000 + c_minDownloadStallTimeout));
+    BOOST_CHECK(download.checkStall(2001 + c_minDownloadStallTimeout));
+    BOOST_CHECK(!download.busy());
+    BOOST_CHECK(!download.requesting(101, rangeEnd));
+    BOOST_CHECK_EQUAL(download.requestWindow(), 100);
+    BOOST_CHECK(!download.available(2001 + c_minDownloadStallTimeout));
+    BOOST_CHECK(download.available(2002 + 2 * c_minDownloadStallTimeout));
+    // the late blocks are ignored
+    download.onBlocks(10, 5000);
+    BOOST_CHECK_EQUAL(download.throughput(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(PeerTxsRequestsTest)
+{
+    PeerTxsRequests requests;
+    h256s txHashes(c_maxPeerTxsRequests + 10);
+    for (size_t i = 0; i < txHashes.size(); ++i)
+        txHashes[i] = h256(i);
+    BOOST_CHECK_EQUAL(requests.push(txHashes), c_maxPeerTxsRequests);
+    BOOST_CHECK_EQUAL(requests.size(), c_maxPeerTxsRequests);
+
+    auto popped = requests.pop(3);
+    BOOST_CHECK_EQUAL(popped.size(), 3);
+    BOOST_CHECK(popped[2] == h256(2));
+    BOOST_CHECK_EQUAL(requests.pop(c_maxPeerTxsRequests).size(), c_maxPeerTxsRequests - 3);
+    BOOST_CHECK_EQUAL(requests.size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
\ No newline at end of file
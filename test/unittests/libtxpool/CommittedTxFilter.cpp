@@ -0,0 +1,102 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : unit test for the filter of the committed transactions
+ * @file: CommittedTxFilter.cpp
+ */
+#include <libtxpool/CommittedTxFilter.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+struct CommittedTxFilterFixture : public TestOutputHelperFixture
+{
+    CommittedTxFilterFixture()
+    {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+                   .string();
+        for (size_t i = 0; i < 3000; i++)
+            hashes.push_back(h256::random());
+    }
+    ~CommittedTxFilterFixture() { boost::filesystem::remove_all(path); }
+
+    std::string path;
+    h256s hashes;
+};
+
+BOOST_FIXTURE_TEST_SUITE(CommittedTxFilterTest, CommittedTxFilterFixture)
+
+BOOST_AUTO_TEST_CASE(testContains)
+{
+    CommittedTxFilter filter(1000);
+    for (size_t i = 0; i < 1000; i++)
+        filter.insert(hashes[i]);
+    /// inserted twice, counted once
+    filter.insert(hashes[0]);
+    BOOST_CHECK(filter.size() == 1000);
+    for (size_t i = 0; i < 1000; i++)
+        BOOST_CHECK(filter.contains(hashes[i]));
+    for (size_t i = 1000; i < 3000; i++)
+        BOOST_CHECK(!filter.contains(hashes[i]));
+}
+
+BOOST_AUTO_TEST_CASE(testRotate)
+{
+    CommittedTxFilter filter(1000);
+    for (auto const& hash : hashes)
+        filter.insert(hash);
+    /// the first generation is dropped, the last two are kept
+    BOOST_CHECK(filter.size() == 2000);
+    for (size_t i = 0; i < 1000; i++)
+        BOOST_CHECK(!filter.contains(hashes[i]));
+    for (size_t i = 1000; i < 3000; i++)
+        BOOST_CHECK(filter.contains(hashes[i]));
+}
+
+BOOST_AUTO_TEST_CASE(testSaveAndLoad)
+{
+    CommittedTxFilter filter(1000);
+    BOOST_CHECK(!filter.load(path));
+    for (size_t i = 0; i < 1500; i++)
+        filter.insert(hashes[i]);
+    filter.setNumber(10);
+    filter.save(path);
+
+    CommittedTxFilter loaded(1000);
+    BOOST_CHECK(loaded.load(path));
+    BOOST_CHECK(loaded.number() == 10);
+    BOOST_CHECK(loaded.size() == 1500);
+    for (size_t i = 0; i < 1500; i++)
+        BOOST_CHECK(loaded.contains(hashes[i]));
+    BOOST_CHECK(!loaded.contains(hashes[2000]));
+
+    /// saved with another capacity
+    CommittedTxFilter other(2000);
+    BOOST_CHECK(!other.load(path));
+    BOOST_CHECK(other.number() == -1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
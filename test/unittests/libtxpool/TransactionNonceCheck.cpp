@@ -0,0 +1,74 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for TransactionNonceCheck
+ * @file: TransactionNonceCheck.cpp
+ * @author: ancelmo
+ * @date: 2019-09-21
+ */
+#include "FakeBlockChain.h"
+#include <libtxpool/TransactionNonceCheck.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+using namespace dev;
+using namespace dev::txpool;
+using namespace dev::blockchain;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(TransactionNonceCheckTest, TestOutputHelperFixture)
+
+Transaction nonceTransaction(u256 const& _nonce)
+{
+    return Transaction(u256(100), u256(0), u256(100000000), Address(), bytes(), _nonce);
+}
+
+BOOST_AUTO_TEST_CASE(slideWindow)
+{
+    /// the transactions of the fake blocks have nonce 2
+    auto blockChain = std::make_shared<FakeBlockChain>(2, 1);
+    TransactionNonceCheck nonceCheck(blockChain);
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(2))));
+
+    auto commit = [&](u256 const& _nonce) {
+        Block block(*blockChain->getBlockByNumber(blockChain->number()));
+        block.setTransactions(Transactions{nonceTransaction(_nonce)});
+        blockChain->commitBlock(block, nullptr);
+        nonceCheck.updateCache(block);
+    };
+    commit(u256(7));
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(7))));
+    BOOST_CHECK(nonceCheck.isNonceOk(nonceTransaction(u256(8))));
+
+    /// keep the nonces of blocks 2 and 3 only
+    nonceCheck.setBlockLimit(1);
+    nonceCheck.updateCache();
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(2))));
+    commit(u256(8));
+    BOOST_CHECK(nonceCheck.isNonceOk(nonceTransaction(u256(2))));
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(7))));
+    commit(u256(9));
+    BOOST_CHECK(nonceCheck.isNonceOk(nonceTransaction(u256(7))));
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(8))));
+    BOOST_CHECK(!nonceCheck.isNonceOk(nonceTransaction(u256(9))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
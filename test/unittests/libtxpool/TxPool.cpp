@@ -120,6 +120,14 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
     m_status = pool_test.m_txPool->status();
     BOOST_CHECK(m_status.current == 4);
     BOOST_CHECK(m_status.dropped == 1);
+    BOOST_CHECK(m_status.memory > 4 * pending_list[1].capacity());
+    /// no larger transaction to evict under the memory limit
+    pool_test.m_txPool->setMemoryLimit(1);
+    BOOST_CHECK(pool_test.m_txPool->isFull());
+    result = pool_test.m_txPool->import(ref(trans_data));
+    BOOST_CHECK(result == ImportResult::TransactionPoolIsFull);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 4);
+    pool_test.m_txPool->setMemoryLimit(0);
 
     /// test topTransactions
     Transactions top_transactions = pool_test.m_txPool->topTransactions(20);
@@ -129,6 +137,26 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
         avoid.insert(pool_test.m_txPool->pendingList()[i].sha3());
     top_transactions = pool_test.m_txPool->topTransactions(20, avoid);
     BOOST_CHECK(top_transactions.size() == 0);
+    /// the sealing cursor resumes after the packed transactions until it is reset
+    h256Hash sealed;
+    top_transactions = pool_test.m_txPool->topTransactions(3, sealed, true);
+    BOOST_CHECK(top_transactions.size() == 3);
+    top_transactions = pool_test.m_txPool->topTransactions(20, sealed, true);
+    BOOST_CHECK(top_transactions.size() == 1);
+    BOOST_CHECK(sealed.size() == 4);
+    sealed.clear();
+    pool_test.m_txPool->resetSealingCursor();
+    top_transactions = pool_test.m_txPool->topTransactions(20, sealed, true);
+    BOOST_CHECK(top_transactions.size() == 4);
+    /// a sender seals at most its quota in a block
+    pool_test.m_txPool->setMaxTxsPerSender(3);
+    sealed.clear();
+    pool_test.m_txPool->resetSealingCursor();
+    top_transactions = pool_test.m_txPool->topTransactions(20, sealed, true);
+    BOOST_CHECK(top_transactions.size() == 3);
+    top_transactions = pool_test.m_txPool->topTransactions(20, sealed, true);
+    BOOST_CHECK(top_transactions.size() == 0);
+    pool_test.m_txPool->setMaxTxsPerSender(0);
     /// check getProtocol id
     BOOST_CHECK(
         pool_test.m_txPool->getProtocolId() == getGroupProtoclID(1, dev::eth::ProtocolID::TxPool));
@@ -136,6 +164,62 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
     pool_test.m_txPool->setMaxBlockLimit(100);
     BOOST_CHECK(pool_test.m_txPool->maxBlockLimit() == 100);
 }
+
+BOOST_AUTO_TEST_CASE(testTransactionKnownBy)
+{
+    TxPoolFixture pool_test(5, 5);
+    h256 txHash(1);
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBySomeone(txHash));
+    pool_test.m_txPool->setTransactionIsKnownBy(txHash, h512(2));
+    pool_test.m_txPool->setTransactionsAreKnownBy({txHash, h256(3)}, h512(4));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBySomeone(txHash));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(txHash, h512(2)));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(h256(3), h512(4)));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(h256(3), h512(2)));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(txHash, h512(5)));
+    /// too many nodes, the known-by sets start again
+    for (unsigned i = 0; i < 256; i++)
+        pool_test.m_txPool->setTransactionIsKnownBy(h256(3), h512(100 + i));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBySomeone(txHash));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(h256(3), h512(355)));
+}
+
+BOOST_AUTO_TEST_CASE(testBatchImport)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transactions transaction_vec =
+        pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+            ->transactions();
+    std::vector<bytes> trans_data(transaction_vec.size() + 1);
+    for (size_t i = 0; i < transaction_vec.size(); i++)
+    {
+        auto& tx = transaction_vec[i];
+        tx.setNonce(tx.nonce() + u256(i) + u256(1));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        SignatureStruct sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(sig);
+        tx.encode(trans_data[i]);
+    }
+    /// the first transaction again, then an invalid encoding
+    trans_data.back() = bytes{0x01, 0x02};
+    std::vector<bytesConstRef> txs_bytes;
+    for (auto const& data : trans_data)
+        txs_bytes.push_back(ref(data));
+    txs_bytes.insert(txs_bytes.end() - 1, ref(trans_data[0]));
+
+    auto results = pool_test.m_txPool->batchImport(txs_bytes);
+    BOOST_CHECK(results.size() == txs_bytes.size());
+    for (size_t i = 0; i < transaction_vec.size(); i++)
+        BOOST_CHECK(results[i] == ImportResult::Success);
+    BOOST_CHECK(results[transaction_vec.size()] == ImportResult::AlreadyKnown);
+    BOOST_CHECK(results.back() == ImportResult::Malformed);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == transaction_vec.size());
+
+    /// the transactions in the pool are known
+    results = pool_test.m_txPool->batchImport(transaction_vec);
+    for (auto result : results)
+        BOOST_CHECK(result == ImportResult::AlreadyKnown);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
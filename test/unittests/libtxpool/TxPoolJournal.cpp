@@ -0,0 +1,134 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2019 fisco-dev contributors.
+ */
+
+/**
+ * @brief : unit test for the journal of the pending transactions
+ * @file: TxPoolJournal.cpp
+ */
+#include <libdevcrypto/Common.h>
+#include <libtxpool/TxPoolJournal.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+struct TxPoolJournalFixture : public TestOutputHelperFixture
+{
+    TxPoolJournalFixture()
+    {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+                   .string();
+        Secret sec = KeyPair::create().secret();
+        for (size_t i = 0; i < 3; i++)
+        {
+            Transaction tx(u256(0), u256(0), u256(3000000), Address(0x100 + i), bytes(64, i),
+                u256(i + 1));
+            tx.updateSignature(SignatureStruct(sign(sec, tx.sha3(WithoutSignature))));
+            tx.setImportTime(u256(1000 + i));
+            txs.push_back(tx);
+        }
+    }
+    ~TxPoolJournalFixture() { boost::filesystem::remove_all(path); }
+
+    std::string path;
+    Transactions txs;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TxPoolJournalTest, TxPoolJournalFixture)
+
+BOOST_AUTO_TEST_CASE(testLoad)
+{
+    {
+        TxPoolJournal journal(path);
+        BOOST_CHECK(journal.load().empty());
+        for (auto const& tx : txs)
+            journal.append(tx);
+        journal.remove(txs[1].sha3());
+        journal.flush();
+        BOOST_CHECK(journal.size() == boost::filesystem::file_size(path));
+    }
+    /// the removed transaction is skipped, the others keep their order and import time
+    TxPoolJournal journal(path);
+    auto records = journal.load();
+    BOOST_CHECK(records.size() == 2);
+    BOOST_CHECK(records[0].rlp == txs[0].rlp());
+    BOOST_CHECK(records[0].importTime == txs[0].importTime());
+    BOOST_CHECK(records[1].rlp == txs[2].rlp());
+    BOOST_CHECK(records[1].importTime == txs[2].importTime());
+    /// the journal is emptied by loading
+    BOOST_CHECK(journal.size() == 0);
+    BOOST_CHECK(journal.load().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testBatchRemove)
+{
+    {
+        TxPoolJournal journal(path);
+        for (auto const& tx : txs)
+            journal.append(tx);
+        journal.remove(h256s{txs[0].sha3(), txs[2].sha3()});
+    }
+    TxPoolJournal journal(path);
+    auto records = journal.load();
+    BOOST_CHECK(records.size() == 1);
+    BOOST_CHECK(records[0].rlp == txs[1].rlp());
+}
+
+BOOST_AUTO_TEST_CASE(testTornRecord)
+{
+    {
+        TxPoolJournal journal(path);
+        for (auto const& tx : txs)
+            journal.append(tx);
+    }
+    /// cut the last record in the middle
+    boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 10);
+    TxPoolJournal journal(path);
+    auto records = journal.load();
+    BOOST_CHECK(records.size() == 2);
+    BOOST_CHECK(records[1].rlp == txs[1].rlp());
+}
+
+BOOST_AUTO_TEST_CASE(testCompact)
+{
+    TxPoolJournal journal(path);
+    for (auto const& tx : txs)
+        journal.append(tx);
+    journal.remove(txs[0].sha3());
+    auto size = journal.size();
+    journal.compact(Transactions{txs[2]});
+    BOOST_CHECK(journal.size() < size);
+    journal.append(txs[1]);
+    journal.flush();
+
+    TxPoolJournal reloaded(path);
+    auto records = reloaded.load();
+    BOOST_CHECK(records.size() == 2);
+    BOOST_CHECK(records[0].rlp == txs[2].rlp());
+    BOOST_CHECK(records[1].rlp == txs[1].rlp());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
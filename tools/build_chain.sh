@@ -49,7 +49,7 @@ Usage:
     -p <Start Port>                     Default 30300,20200,8545 means p2p_port start from 30300, channel_port from 20200, jsonrpc_port from 8545
     -i <Host ip>                        Default 127.0.0.1. If set -i, listen 0.0.0.0
     -v <FISCO-BCOS binary version>      Default get version from https://github.com/FISCO-BCOS/FISCO-BCOS/releases. If set use specificd version binary
-    -s <DB type>                        Default rocksdb. Options can be rocksdb / mysql / external, rocksdb is recommended
+    -s <DB type>                        Default rocksdb. Options can be rocksdb / mysql / external / tiered, rocksdb is recommended
     -d <docker mode>                    Default off. If set -d, build with docker
     -c <Consensus Algorithm>            Default PBFT. If set -c, use Raft
     -m <MPT State type>                 Default storageState. if set -m, use mpt state
@@ -437,6 +437,17 @@ generate_config_ini()
     listen_ip=${listen_ip}
     channel_listen_port=$(( offset + port_start[1] ))
     jsonrpc_listen_port=$(( offset + port_start[2] ))
+    ; threads of the queries and of the contract calls, and the queries waiting before busy
+    ;query_threads=8
+    ;call_threads=4
+    ;max_pending_queries=1024
+    ; MB of the responses of the committed blocks cached, 0 to disable
+    ;response_cache_size=64
+    ; microhttpd, or asio for keep-alive, pipelining and optionally JSON-RPC over WebSocket
+    ;http_server=microhttpd
+    ;http_threads=4
+    ;max_http_connections=1024
+    ;enable_websocket=false
 [p2p]
     listen_ip=0.0.0.0
     listen_port=$(( offset + port_start[0] ))
@@ -444,6 +455,13 @@ generate_config_ini()
     $ip_list
     ;enable/disable network compress
     ;enable_compress=true
+    ; io threads the sessions are spread over, 0 for one per core
+    ;io_threads=0
+    ; threads handling the messages of each group, 0 to share the threads of p2p
+    ;group_threads=2
+    ; KB per second the sync and the transaction gossip of each group may send, 0 for no limit
+    ;sync_bandwidth=0
+    ;gossip_bandwidth=0
 
 [certificate_blacklist]		
     ; crl.0 should be nodeid, nodeid's length is 128 
@@ -453,6 +471,23 @@ generate_config_ini()
     group_data_path=data/
     group_config_path=${conf_path}/
 
+[scheduler]
+    ; the workers the groups execute their blocks on, split by the weights of the groups, 0 for
+    ; one per core
+    ;threads=0
+    ; MB the caches of all groups hold, split by weight and by the misses of each group every
+    ; 10 seconds, 0 to keep storage.max_capacity of each group
+    ;cache_budget=0
+    ; tune the budget every 10 seconds: shrink it while the node is over cache_memory_percent of
+    ; the memory it may take, cgroup limits included, grow it while the caches are full and miss,
+    ; and clear each cache more or less often, starting from cache_budget or the sum of
+    ; storage.max_capacity
+    ;cache_auto_tune=false
+    ; MB the tuned budget is kept in, the max defaults to half of the memory the node may take
+    ;cache_min_budget=32
+    ;cache_max_budget=
+    ;cache_memory_percent=80
+
 [network_security]
     ; directory the certificates located in
     data_path=${conf_path}/
@@ -470,6 +505,8 @@ key_manager_ip=
 ; the Port of key manager
 key_manager_port=
 cipher_data_key=
+; seconds the data keys are cached for and refreshed in the background, 0 for the node lifetime
+key_cache_ttl=0
 
 [chain]
     id=${chain_id}
@@ -483,11 +520,42 @@ cipher_data_key=
     level=${log_level}
     ; MB
     max_log_file_size=200
-    ; control log auto_flush
+    ; flush the log files every 100ms, the records are written in batches by a writer thread
     flush=${auto_flush}
     ; easylog config
     format=%level|%datetime{%Y-%M-%d %H:%m:%s:%g}|%msg
     log_flush_threshold=100
+[trace]
+    ; record the time each block spends in the txpool, the consensus, the execution, the commit
+    ; and the flush of the storage, written to a file under path by the exportTrace RPC
+    ;enable=false
+    ; the spans kept, the oldest are overwritten
+    ;capacity=65536
+    ;path=./trace
+[executor]
+    ; the workers running the tasks of the network, the consensus, the sync, the storage and the
+    ; RPC of all groups, 0 for one per core
+    ;threads=0
+    ; bind the worker i to the core i, to the i-th core reserved for no group nor the network
+    ; if [affinity] reserves some
+    ;pin_threads=false
+[affinity]
+    ; cores as 0-3,6 reserved for the consensus, sync and execution threads of a group and for
+    ; the network I/O threads; the other threads take the cores reserved for neither, the rocksdb
+    ; and cache clear threads too unless storage sets cores of their own
+    ;group.1=2-3
+    ;network=1
+    ;storage=0
+[memory]
+    ; advise the kernel to back the tables of the storage and block caches with transparent huge
+    ; pages, when /sys/kernel/mm/transparent_hugepage/enabled is madvise or always
+    ;cache_huge_pages=false
+[rocksdb]
+    ; MB of the block cache and the memtables shared by the rocksdb of all groups, 0 for a cache
+    ; and memtables of each group's own
+    ;memory_budget=0
+    ; MB/s of the flushes and compactions of all groups, 0 for no limit
+    ;rate_limit=0
 EOF
 }
 
@@ -505,7 +573,7 @@ generate_group_genesis()
     ; the node id of consensusers
     ${node_list}
 [state]
-    ; support mpt/storage
+    ; support mpt/storage/compact, compact stores accounts in one record, only for new chains
     type=${state_type}
 [tx]
     ; transaction gas limit
@@ -526,25 +594,134 @@ function generate_group_ini()
     ; min block generation time(ms), the max block generation time is 1000 ms
     ;min_block_generation_time=500
     ;enable_dynamic_block_size=true
+    ; the most transactions of a block sharing a parallel critical field, the others wait for the
+    ; next block, 0 for no limit
+    ;max_txs_per_critical=0
+    ; broadcast the prepare with the transaction hashes, the other sealers rebuild the block from
+    ; their txpool and fetch the missed transactions from the leader
+    ;compact_prepare=false
+    ; relay the prepare, sign and commit messages along a tree rooted at their generator, each
+    ; sealer sends them to this many children only, 0 to send them to all the sealers
+    ;broadcast_tree_width=0
+    ; the next leader proposes its block once the current one is committed by 2/3 sealers, the
+    ; blocks are still executed in order
+    ;enable_pipeline=false
+    ; the leader executes the block it proposed ahead on the writes of the block being committed,
+    ; requires enable_pipeline
+    ;speculative_execution=false
+    ; the block size and the sealing interval are tuned to keep the latency from the prepare to
+    ; the saved block(ms) within this target, requires enable_dynamic_block_size, 0 to disable
+    ;target_block_latency=0
 [storage]
-    ; storage db type, rocksdb / mysql / external, rocksdb is recommended
+    ; storage db type, rocksdb / mysql / external / tiered, rocksdb is recommended
     type=${storage_type}
     ; max cache memeory, MB
     max_capacity=256
     max_forward_block=10
+    ; max memory of the blocks waiting for the db, MB
+    ;max_forward_capacity=256
+    ; blocks merged into one db commit
+    ;max_merge_block=5
+    ; shards of the cache index, 0 means one shard per cpu core
+    ;cache_shards=0
+    ; cache eviction policy, clock / lru
+    ;cache_policy=clock
+    ; only for rocksdb of new data, block tables and contract tables use column families
+    ;column_family=false
+    ; keys accessed once are evicted first
+    ;cache_admission=true
+    ; max cache memory of each block table, MB, 0 means unbounded
+    ;block_table_capacity=32
+    ; log blocks on local disk before they reach the db, allows a larger max_forward_block
+    ;wal=false
+    ; record db latency and table access, returned by getStorageStats of rpc
+    ;stats=true
+    ; db operations slower than it are logged, ms, 0 means not logged
+    ;slow_threshold=1000
+    ; index the logs of the new blocks by address and topic, served by getLogs of rpc
+    ;log_index=false
     ; only for external
     max_retry=100
     topic=DB
-    ; only for mysql
+    ; binary requests if the amdb proxy supports them, json otherwise
+    ;binary_protocol=true
+    ; only for tiered, blocks kept in rocksdb, block tables of older blocks move to mysql
+    ;hot_blocks=10000
+    ; only for rocksdb, bodies of older blocks are pruned, 0 keeps all, at least 1000 otherwise
+    ;retain_blocks=0
+    ; only for rocksdb and the mpt state, rows or trie nodes deleted more blocks ago are pruned, 0
+    ; keeps all, the mpt state of new chains only
+    ;retain_state_blocks=0
+    ; only for the mpt state, trie nodes read from the db cached in memory, MB
+    ;mpt_node_cache=64
+    ; only for the mpt state of new chains, the latest accounts and storage are read from flat
+    ; entries kept next to the trie
+    ;mpt_flat_state=true
+    ; keys pruned a second at most, pruning gives way to the commits of blocks
+    ;prune_keys_per_second=1000
+    ; a rocksdb the pruned data is moved to, empty drops it
+    ;prune_archive_path=
+    ; only for rocksdb, blocks behind the peers to ingest the synced blocks as sst files, 0 disables
+    ;bulk_load_blocks=0
+    ; keep the blocks in compressed segment files too, blocks are read from them first
+    ;block_store=false
+    ;block_store_segment=10000
+    ; the most recently used keys of the cache saved on disk and fetched again before the node
+    ; joins consensus after a restart, 0 disables it
+    ;warm_keys=0
+    ; keys fetched a second at most by the warm-up, 0 means unlimited
+    ;warm_keys_per_second=20000
+    ; only for mysql and tiered
     db_ip=127.0.0.1
     db_port=3306
     db_username=
     db_passwd=
     db_name=
+    ; commit the tables of a block with this many connections in parallel, as an XA transaction
+    ;commit_connections=1
 [tx_pool]
     limit=150000
+    ; the most transactions of one sender sealed in a block, 0 for no limit
+    ;max_txs_per_sender=0
+    ; the most megabytes of the pending transactions, the larger ones are evicted for the smaller
+    ; ones beyond it, 0 for no limit
+    ;memory_limit=0
+    ; journal the pending transactions to reload them on restart, and save the hashes of the
+    ; recently committed ones to refuse them without waiting for the nonces of the chain
+    ;enable_journal=false
 [tx_execute]
     enable_parallel=${enable_parallel}
+    ; execute transactions without parallel tags in parallel along the keys they accessed in a
+    ; speculative execution, only when enable_parallel is true
+    ;optimistic=false
+    ; the VM executing contracts, interpreter or the path of an EVMC VM library, the same on
+    ; all nodes of the group
+    ;vm=interpreter
+    ; the share of the workers of the process, and the workers at most with 0 for no limit
+    ;weight=1
+    ;max_concurrency=0
+    ; log the DAG width, the critical path, the fields of the most conflicts and the busy and
+    ; idle time of the workers of each parallel block, and write its chrome://tracing trace to
+    ; profile_path/block_<number>.trace.json when profile_path is set
+    ;profile=false
+    ;profile_path=
+    ; count the opcodes and time the opcode categories of each contract executed by the
+    ; interpreter, served by the getEvmProfile RPC, for all groups of the node once a group sets it
+    ;evm_profile=false
+[sync]
+    ; dump the tables every this many blocks and serve the dumps to the new nodes, 0 disables
+    ; the dumps, the blocks aren't committed while the tables are dumped
+    ;snapshot_interval=0
+    ; a new node restores the dump announced by its peers instead of replaying all the blocks
+    ;snapshot_sync=false
+    ; the headers of long ranges are checked ahead and the bodies fetched from all the peers,
+    ; the peers need to support it too
+    ;header_first=false
+    ; the state diffs of the latest blocks kept for the observers, 0 keeps none
+    ;state_diff_blocks=0
+    ; the observer commits the state diffs of its peers checked against the dbHash of the blocks
+    ; instead of executing the blocks, the peers need to keep them
+    ;state_diff=false
 EOF
 }
 